@@ -54,6 +54,8 @@ if(CONAN_INSTALL)
     conan_cmake_configure(
         REQUIRES
             snappy/1.1.9
+            zstd/1.5.5
+            lz4/1.9.4
             nlohmann_json/3.11.2
             libjpeg-turbo/2.1.4
             taskflow/3.6.0
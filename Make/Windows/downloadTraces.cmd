@@ -0,0 +1,5 @@
+@echo off
+set SHELLOPTS=igncr
+pushd "%~dp0"
+bash ../Common/downloadTraces %*
+popd
@@ -0,0 +1,88 @@
+/**
+ * @file Controller/BatchRecorder.cpp
+ *
+ * Implementation of class BatchRecorder.
+ */
+
+#include "BatchRecorder.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Tools/Streams/OutStreams.h"
+#include "Tools/Streams/StreamHandler.h"
+#include <algorithm>
+
+BatchRecorder::BatchRecorder(const std::string& directory, const std::vector<MessageID>& ids) : directory(directory)
+{
+  for (MessageID id : ids)
+    columns[id];
+}
+
+void BatchRecorder::handleMessage(InMessage& message)
+{
+  const MessageID id = message.getMessageID();
+  if (id == idProcessBegin)
+  {
+    message.bin >> process;
+    time = 0;
+  }
+  else if (id == idFrameInfo)
+  {
+    FrameInfo frameInfo;
+    message.bin >> frameInfo;
+    time = frameInfo.time;
+  }
+  else if (id == idProcessFinished)
+  {
+    // FrameInfo might be sent after the representations, so timestamps are set at the end of the frame
+    for (auto& pair : columns)
+    {
+      Column& column = pair.second;
+      std::fill(column.timestamps.begin() + column.frameBegin, column.timestamps.end(), time);
+      column.frameBegin = column.timestamps.size();
+    }
+  }
+  else
+  {
+    auto i = columns.find(id);
+    if (i != columns.end())
+    {
+      Column& column = i->second;
+      column.timestamps.push_back(time);
+      column.processes.push_back(process);
+      const size_t offset = column.data.size();
+      column.data.resize(offset + message.getMessageSize());
+      message.bin.read(column.data.data() + offset, message.getMessageSize());
+      column.offsets.push_back(static_cast<unsigned>(column.data.size()));
+    }
+  }
+  message.resetReadPosition();
+}
+
+bool BatchRecorder::write(const StreamHandler& streamHandler) const
+{
+  bool success = true;
+  for (const auto& pair : columns)
+  {
+    const Column& column = pair.second;
+    const std::string name = ::getName(pair.first) + 2; // skip "id"
+    OutBinaryFile stream(directory + "/" + name + ".col");
+    if (!stream.exists())
+    {
+      success = false;
+      continue;
+    }
+    stream << magic << version << name << streamHandler << static_cast<unsigned>(column.timestamps.size());
+    stream.write(column.timestamps.data(), column.timestamps.size() * sizeof(unsigned));
+    stream.write(column.processes.data(), column.processes.size());
+    stream.write(column.offsets.data(), column.offsets.size() * sizeof(unsigned));
+    stream.write(column.data.data(), column.data.size());
+  }
+  return success;
+}
+
+size_t BatchRecorder::getNumberOfRecords() const
+{
+  size_t records = 0;
+  for (const auto& pair : columns)
+    records += pair.second.timestamps.size();
+  return records;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file Controller/BatchRecorder.h
+ *
+ * Declaration of class BatchRecorder that collects representations sent by a
+ * robot that replays a log file and writes them as columns into files.
+ */
+
+#pragma once
+
+#include "Tools/MessageQueue/InMessage.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class StreamHandler;
+
+/**
+ * @class BatchRecorder
+ *
+ * Records the representations a log replaying robot sends back and writes one
+ * file per representation into a directory. Each file has the layout
+ * | magic | version | name | stream specification | count |
+ * | timestamps[count] | processes[count] | offsets[count + 1] | data |.
+ * The timestamps are the FrameInfo times of the frames in which the
+ * representations were computed, so the outputs of different replays of the
+ * same log can be aligned. The data of record i are the bytes in
+ * [offsets[i], offsets[i + 1]) and can be decoded using the stream
+ * specification.
+ */
+class BatchRecorder
+{
+public:
+  static constexpr unsigned magic = 0x4c4f4342; /**< "BCOL" */
+  static constexpr unsigned version = 1;
+
+  /**
+   * Constructor.
+   * @param directory The directory the files are written to.
+   * @param ids The ids of the representations that are recorded.
+   */
+  BatchRecorder(const std::string& directory, const std::vector<MessageID>& ids);
+
+  /**
+   * Handles a message sent by the robot.
+   * @param message The message. Its read position is reset afterwards.
+   */
+  void handleMessage(InMessage& message);
+
+  /**
+   * Writes all columns to files.
+   * @param streamHandler The specification of the recorded data types.
+   * @return Were all files written successfully?
+   */
+  bool write(const StreamHandler& streamHandler) const;
+
+  /**
+   * Returns the number of records collected so far.
+   * @return The number of records over all representations.
+   */
+  size_t getNumberOfRecords() const;
+
+private:
+  /** The columns of a single representation. */
+  struct Column
+  {
+    std::vector<unsigned> timestamps;
+    std::vector<char> processes;
+    std::vector<unsigned> offsets = std::vector<unsigned>(1, 0);
+    std::vector<char> data;
+    size_t frameBegin = 0; /**< The first record of the current frame that still needs a timestamp. */
+  };
+
+  std::string directory; /**< The directory the files are written to. */
+  std::map<MessageID, Column> columns; /**< The columns of all recorded representations. */
+  char process = 0; /**< The identifier of the process the current frame stems from. */
+  unsigned time = 0; /**< The FrameInfo time of the current frame. */
+};
@@ -0,0 +1,167 @@
+/**
+ * @file Controller/ColumnTable.cpp
+ *
+ * Implementation of class ColumnTable.
+ */
+
+#include "ColumnTable.h"
+#include "Tools/Math/Angle.h"
+#include "Tools/Streams/OutStreams.h"
+#include <cstring>
+
+void ColumnTable::beginRow(int frame, char process)
+{
+  frames.push_back(frame);
+  processes.push_back(process);
+  path.clear();
+  selections.clear();
+}
+
+void ColumnTable::select(const char* name, int type, const char* (*enumToString)(int))
+{
+  selections.push_back({path.size(), enumToString});
+  if (name)
+  {
+    if (!path.empty())
+      path += '.';
+    path += name;
+  }
+  else if (type >= 0)
+    path += "[" + std::to_string(type) + "]";
+}
+
+void ColumnTable::deselect()
+{
+  if (!selections.empty())
+  {
+    path.resize(selections.back().pathLength);
+    selections.pop_back();
+  }
+}
+
+void ColumnTable::outUChar(unsigned char value)
+{
+  const char* (*enumToString)(int) = selections.empty() ? nullptr : selections.back().enumToString;
+  if (!enumToString)
+    add(unsignedCharType, &value, sizeof(value));
+  else
+  {
+    const bool isNew = columns.find(path) == columns.end();
+    Column& column = getColumn(enumType, sizeof(value));
+    if (isNew)
+      for (int i = 0; i < 256 && enumToString(i); ++i)
+        column.enumNames.push_back(enumToString(i));
+    column.data.push_back(static_cast<char>(value));
+    column.valid.push_back(1);
+  }
+}
+
+void ColumnTable::outString(const char* value)
+{
+  Column& column = getColumn(stringType, 0);
+  column.data.insert(column.data.end(), value, value + std::strlen(value));
+  column.offsets.push_back(static_cast<unsigned>(column.data.size()));
+  column.valid.push_back(1);
+}
+
+void ColumnTable::outAngle(const Angle& value)
+{
+  const float f = value;
+  add(floatType, &f, sizeof(f));
+}
+
+void ColumnTable::add(ColumnType type, const void* value, size_t size)
+{
+  Column& column = getColumn(type, size);
+  column.data.insert(column.data.end(), static_cast<const char*>(value), static_cast<const char*>(value) + size);
+  column.valid.push_back(1);
+}
+
+ColumnTable::Column& ColumnTable::getColumn(ColumnType type, size_t elementSize)
+{
+  auto i = columns.find(path);
+  if (i == columns.end())
+  {
+    names.push_back(path);
+    i = columns.emplace(path, Column{type, elementSize, {}, {}, {0}, {}}).first;
+  }
+  Column& column = i->second;
+  pad(column, frames.size() - 1);
+  return column;
+}
+
+void ColumnTable::pad(Column& column, size_t rows)
+{
+  if (column.valid.size() < rows)
+  {
+    const size_t missing = rows - column.valid.size();
+    column.valid.resize(rows, 0);
+    if (column.type == stringType)
+      column.offsets.resize(rows + 1, column.offsets.back());
+    else
+      column.data.resize(column.data.size() + missing * column.elementSize, 0);
+  }
+}
+
+void ColumnTable::append(const ColumnTable& other)
+{
+  const size_t rows = frames.size();
+  for (const std::string& name : other.names)
+  {
+    const Column& source = other.columns.at(name);
+    auto i = columns.find(name);
+    if (i == columns.end())
+    {
+      names.push_back(name);
+      i = columns.emplace(name, Column{source.type, source.elementSize, {}, {}, {0}, source.enumNames}).first;
+    }
+    Column& column = i->second;
+    pad(column, rows);
+    column.data.insert(column.data.end(), source.data.begin(), source.data.end());
+    column.valid.insert(column.valid.end(), source.valid.begin(), source.valid.end());
+    if (column.type == stringType)
+    {
+      const unsigned base = column.offsets.back();
+      for (auto offset = source.offsets.begin() + 1; offset != source.offsets.end(); ++offset)
+        column.offsets.push_back(base + *offset);
+    }
+  }
+  frames.insert(frames.end(), other.frames.begin(), other.frames.end());
+  processes.insert(processes.end(), other.processes.begin(), other.processes.end());
+}
+
+bool ColumnTable::write(const std::string& fileName, const std::string& type) const
+{
+  OutBinaryFile stream(fileName);
+  if (!stream.exists())
+    return false;
+
+  const unsigned rows = static_cast<unsigned>(frames.size());
+  stream << magic << version << type << rows << static_cast<unsigned>(names.size() + 2);
+
+  const std::vector<unsigned char> allValid(rows, 1);
+  stream << std::string("_frame") << static_cast<unsigned char>(intType);
+  stream.write(allValid.data(), rows);
+  stream.write(frames.data(), rows * sizeof(int));
+  stream << std::string("_process") << static_cast<unsigned char>(charType);
+  stream.write(allValid.data(), rows);
+  stream.write(processes.data(), rows);
+
+  for (const std::string& name : names)
+  {
+    Column column = columns.at(name); // padding must not change the table
+    pad(column, rows);
+    stream << name << static_cast<unsigned char>(column.type);
+    if (column.type == enumType)
+    {
+      stream << static_cast<unsigned>(column.enumNames.size());
+      for (const std::string& enumName : column.enumNames)
+        stream << enumName;
+    }
+    stream.write(column.valid.data(), rows);
+    if (column.type == stringType)
+      stream.write(column.offsets.data(), column.offsets.size() * sizeof(unsigned));
+    stream.write(column.data.data(), column.data.size());
+  }
+  return true;
+}
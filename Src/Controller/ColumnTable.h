@@ -0,0 +1,154 @@
+/**
+ * @file Controller/ColumnTable.h
+ *
+ * Declaration of class ColumnTable, a stream that flattens streamed data into
+ * typed columns.
+ */
+
+#pragma once
+
+#include "Tools/Enum.h"
+#include "Tools/Streams/InOut.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ColumnTable
+ *
+ * An output stream that stores every basic value written into it in a column
+ * named after the path of the value, e.g. "pose.translation.x" or
+ * "robots[2].locationOnField.y". Each representation streamed is a row.
+ * Dynamic arrays also store their size in a column named after the array.
+ * Rows that do not contain a value for a column (e.g. elements that are
+ * beyond the size of a dynamic array) are marked as invalid.
+ *
+ * The file written has the layout
+ * | magic | version | type | number of rows | number of columns | column | ... | column |
+ * with each column being
+ * | name | ColumnType | [number of enum constants | constant names] | valid[rows] | data |.
+ * The data are the values in host byte order, rows * size of the type.
+ * Strings are stored as | offsets[rows + 1] | characters |.
+ * The first two columns are "_frame" (int) and "_process" (char).
+ */
+class ColumnTable : public Out
+{
+public:
+  ENUM(ColumnType,
+    boolType,
+    charType,
+    signedCharType,
+    unsignedCharType,
+    shortType,
+    unsignedShortType,
+    intType,
+    unsignedType,
+    int64Type,
+    unsignedInt64Type,
+    floatType,
+    doubleType,
+    stringType,
+    enumType
+  );
+
+  static constexpr unsigned magic = 0x4c4f4354; /**< "TCOL" */
+  static constexpr unsigned version = 1;
+
+  /**
+   * Starts a new row. All values written afterwards belong to this row.
+   * @param frame The number of the frame that contained the data.
+   * @param process The identifier of the process that produced the data.
+   */
+  void beginRow(int frame, char process);
+
+  /**
+   * Appends all rows of another table.
+   * @param other The table whose rows are appended.
+   */
+  void append(const ColumnTable& other);
+
+  /**
+   * Writes the table to a file.
+   * @param fileName The name of the file.
+   * @param type The type of the data in the table.
+   * @return Was the file written successfully?
+   */
+  bool write(const std::string& fileName, const std::string& type) const;
+
+  /**
+   * Returns the number of rows.
+   * @return The number of rows.
+   */
+  size_t getNumberOfRows() const { return frames.size(); }
+
+  void select(const char* name, int type, const char* (*enumToString)(int) = 0) override;
+  void deselect() override;
+  void write(const void*, size_t) override {}
+
+protected:
+  void outBool(bool value) override { add(boolType, &value, sizeof(value)); }
+  void outChar(char value) override { add(charType, &value, sizeof(value)); }
+  void outSChar(signed char value) override { add(signedCharType, &value, sizeof(value)); }
+  void outUChar(unsigned char value) override;
+  void outShort(short value) override { add(shortType, &value, sizeof(value)); }
+  void outUShort(unsigned short value) override { add(unsignedShortType, &value, sizeof(value)); }
+  void outInt(int value) override { add(intType, &value, sizeof(value)); }
+  void outUInt(unsigned int value) override { add(unsignedType, &value, sizeof(value)); }
+  void outInt64(int64_t value) override { add(int64Type, &value, sizeof(value)); }
+  void outUInt64(uint64_t value) override { add(unsignedInt64Type, &value, sizeof(value)); }
+  void outFloat(float value) override { add(floatType, &value, sizeof(value)); }
+  void outDouble(double value) override { add(doubleType, &value, sizeof(value)); }
+  void outString(const char* value) override;
+  void outAngle(const Angle& value) override;
+  void outEndL() override {}
+
+private:
+  /** A single column. Its values are stored densely, one per row. */
+  struct Column
+  {
+    ColumnType type;
+    size_t elementSize;
+    std::vector<char> data; /**< The values or the characters of all strings. */
+    std::vector<unsigned char> valid; /**< Does a row contain a value for this column? */
+    std::vector<unsigned> offsets; /**< The beginning of the string of each row followed by the end. */
+    std::vector<std::string> enumNames; /**< The names of all enum constants. */
+  };
+
+  /** The state of a select(). */
+  struct Selection
+  {
+    size_t pathLength; /**< The length of the path before the select(). */
+    const char* (*enumToString)(int); /**< Function to get the names of the constants of an enum value. */
+  };
+
+  std::vector<int> frames; /**< The frame of each row. */
+  std::vector<char> processes; /**< The process of each row. */
+  std::vector<std::string> names; /**< The names of all columns in the order they were created. */
+  std::unordered_map<std::string, Column> columns; /**< All columns by name. */
+  std::string path; /**< The name of the value that is written next. */
+  std::vector<Selection> selections; /**< The stack of all selects. */
+
+  /**
+   * Returns the column for the current path and adds entries for rows
+   * missing in it.
+   * @param type The type of the column.
+   * @param elementSize The size of its values in bytes.
+   * @return The column.
+   */
+  Column& getColumn(ColumnType type, size_t elementSize);
+
+  /**
+   * Pads a column so that it has a given number of rows.
+   * @param column The column.
+   * @param rows The number of rows.
+   */
+  static void pad(Column& column, size_t rows);
+
+  /**
+   * Adds a value to the column of the current path.
+   * @param type The type of the value.
+   * @param value The address of the value.
+   * @param size The size of the value in bytes.
+   */
+  void add(ColumnType type, const void* value, size_t size);
+};
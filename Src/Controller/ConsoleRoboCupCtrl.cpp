@@ -291,12 +291,22 @@ void ConsoleRoboCupCtrl::executeConsoleCommand(std::string command, RobotConsole
   {
     stream >> buffer;
     if (buffer == "on")
+    {
       gameController.automatic = true;
+      gameController.automaticGame = false;
+    }
+    else if (buffer == "game")
+      gameController.automatic = gameController.automaticGame = true;
     else if (buffer == "off")
-      gameController.automatic = false;
+      gameController.automatic = gameController.automaticGame = false;
     else
       printLn("Syntax Error");
   }
+  else if (buffer == "batch")
+  {
+    if (!startBatch(stream))
+      printLn("Syntax Error");
+  }
   else if (buffer == "call")
   {
     stream >> buffer;
@@ -354,6 +364,8 @@ void ConsoleRoboCupCtrl::executeConsoleCommand(std::string command, RobotConsole
     if (!gameController.handleGlobalConsole(stream))
       printLn("Syntax Error");
   }
+  else if (buffer == "gs")
+    print(gameController.getStatistics());
   else if (buffer == "sc")
   {
     if (!startRemote(stream))
@@ -415,14 +427,16 @@ void ConsoleRoboCupCtrl::help(In& stream)
   list("Initialization commands:", pattern, true);
   list("  sc <name> [<a.b.c.d>] : Starts a TCP connection to a remote robot.", pattern, true);
   list("  sl <name> <file> : Starts a robot reading its inputs from a log file.", pattern, true);
+  list("  batch <pattern> <directory> <representation> {<representation>} : Replays all log files matching the pattern in parallel and writes the representations into column files.", pattern, true);
   list("Global commands:", pattern, true);
-  list("  ar off | on : Switches automatic referee on or off.", pattern, true);
+  list("  ar off | on | game : Switches automatic referee on or off. game also runs the states and halves of a whole game.", pattern, true);
   list("  call <file> : Execute a script file.", pattern, true);
   list("  ci off | on | <fps> : Switch the calculation of images on or off or activate it and set the frame rate.", pattern, true);
   list("  cls : Clear console window.", pattern, true);
   list("  dt off | on | <fps> : Delay time of a simulation step to real time or a certain number of frames per second.", pattern, true);
   list("  echo <text> : Print text into console window. Useful in console.con.", pattern, true);
   list("  gc initial | ready | set | playing | finished | kickOffBlue | kickOffRed | outByBlue | outByRed | gamePlayoff | gameRoundRobin : Set GameController state.", pattern, true);
+  list("  gs : Print the score, set plays, and penalties of both teams.", pattern, true);
   list("  help | ? [<pattern>] : Display this text.", pattern, true);
   list("  robot ? | all | <name> {<name>} : Connect console to a set of active robots. Alternatively, double click on robot.", pattern, true);
   list("  st off | on : Switch simulation of time on or off.", pattern, true);
@@ -442,12 +456,14 @@ void ConsoleRoboCupCtrl::help(In& stream)
   list("  log saveTrueWhistleAudio <file> (<split>): Save true whistle audio data from log.", pattern, true);
   list("  log saveFalseWhistleAudio <file> (<split>): Save false positive whistle audio data from log.", pattern, true);
   list("  log export <file> {<representation ID>}: Export the data in the log to json file, optionally limited to the given representation IDs.", pattern, true);
+  list("  log exportColumns <directory> {<representation ID>}: Export the data in the log to one binary file with typed columns per representation, optionally limited to the given representation IDs.", pattern, true);
   list("  log saveImages [raw] <file> : Save images from log.", pattern, true);
   list("  log saveTiming <file> : Save timing data from log to csv.", pattern, true);
-  list("  log ? [<pattern>] | load <file> | ( keep | remove ) <message> {<message>} | ( keepFrames | removeFrames ) <startFrameId> <endFrameId> : Load, filter, and display information about log file.",
+  list("  log ? [<pattern>] | load <file> [lazy] | ( keep | remove ) <message> {<message>} | ( keepFrames | removeFrames ) <startFrameId> <endFrameId> : Load, filter, and display information about log file.",
       pattern,
       true);
   list("  log start | pause | stop | forward [image] | backward [image] | repeat | goto <number> | cycle | once | fast_forward [image] | fast_rewind [image] : Replay log file.", pattern, true);
+  list("  log sync [off] | time [<ms>] | offset <ms> : Play the logs of all robots that joined on a common timeline. Jump to a time on it or print the current time. Shift this log on it.", pattern, true);
   list("  msg off | on | log <file> | enable | disable : Switch output of text messages on or off. Log text messages to a file. Switch message handling on or off.", pattern, true);
   list("  mr ? [<pattern>] | modules [<pattern>] | save | <representation> ( ? [<pattern>] | <module> | off ) : Send module request.", pattern, true);
   list("  mv <x> <y> <z> [<rotx> <roty> <rotz>] : Move the selected simulated robot to the given position.", pattern, true);
@@ -526,6 +542,11 @@ bool ConsoleRoboCupCtrl::startLogFile(In& stream)
     fileName = fileName + ".log";
   if (fileName[0] != '\\' && fileName[0] != '/' && (fileName.size() < 2 || fileName[1] != ':'))
     fileName = std::string("Logs/") + fileName;
+  return startLogFile(name, fileName);
+}
+
+bool ConsoleRoboCupCtrl::startLogFile(const std::string& name, const std::string& fileName, bool lazy)
+{
   {
     InBinaryFile test(fileName);
     if (!test.exists())
@@ -534,9 +555,11 @@ bool ConsoleRoboCupCtrl::startLogFile(In& stream)
   std::string robotName = std::string(".") + name;
   mode = SystemCall::logfileReplay;
   logFile = fileName;
+  lazyLogFile = lazy;
   this->robotName = robotName.c_str();
   robots.push_back(new Robot(name.c_str()));
   this->robotName = 0;
+  lazyLogFile = false;
   //logFile = "";
   selected.clear();
   RobotConsole* rc = robots.back()->getRobotProcess();
@@ -545,6 +568,62 @@ bool ConsoleRoboCupCtrl::startLogFile(In& stream)
   return true;
 }
 
+bool ConsoleRoboCupCtrl::startBatch(In& stream)
+{
+  std::string pattern, directory;
+  std::vector<std::string> representations;
+  stream >> pattern >> directory;
+  while (!stream.getEof())
+  {
+    std::string representation;
+    stream >> representation;
+    if (!representation.empty())
+      representations.push_back(representation);
+  }
+  if (directory.empty() || representations.empty())
+    return false;
+
+  if (int(pattern.rfind('.')) <= int(pattern.find_last_of("\\/")))
+    pattern = pattern + ".log";
+  if (pattern[0] != '\\' && pattern[0] != '/' && (pattern.size() < 2 || pattern[1] != ':'))
+    pattern = std::string(File::getBHDir()) + "/Config/Logs/" + pattern;
+  if (directory[0] != '\\' && directory[0] != '/' && (directory.size() < 2 || directory[1] != ':'))
+    directory = std::string(File::getBHDir()) + "/Config/Logs/" + directory;
+
+  QString qpattern(pattern.c_str());
+  qpattern.replace("\\", "/");
+  const int lastSlashIdx = qpattern.lastIndexOf('/');
+  QDir qdir(qpattern.left(lastSlashIdx));
+  const QFileInfoList files = qdir.entryInfoList(QStringList(qpattern.mid(lastSlashIdx + 1)), QDir::Files, QDir::Name);
+  if (files.isEmpty())
+  {
+    printLn("No log file matches " + pattern);
+    return true;
+  }
+
+  // Every log file is replayed by a robot of its own, i.e. in threads of its own,
+  // as fast as possible.
+  delayTime = 0;
+  for (const QFileInfo& file : files)
+  {
+    const std::string outputDirectory = directory + "/" + file.completeBaseName().toUtf8().constData();
+    QDir().mkpath(outputDirectory.c_str());
+    std::string name = "Batch" + std::to_string(robots.size() + 1);
+    if (!startLogFile(name, file.absoluteFilePath().toUtf8().constData(), true))
+    {
+      printLn(std::string(file.absoluteFilePath().toUtf8().constData()) + " cannot be opened!");
+      continue;
+    }
+    if (!robots.back()->getRobotProcess()->startBatch(outputDirectory, representations))
+      break;
+    printLn(name + ": " + file.fileName().toUtf8().constData() + " -> " + outputDirectory);
+  }
+  selected.clear();
+  if (!robots.empty())
+    selected.push_back(robots.back()->getRobotProcess());
+  return true;
+}
+
 bool ConsoleRoboCupCtrl::calcImage(In& stream)
 {
   std::string state;
@@ -606,6 +685,7 @@ void ConsoleRoboCupCtrl::createCompletion()
       "ac upper",
       "ar off",
       "ar on",
+      "batch",
       "bc",
       "kick",
       "call",
@@ -616,6 +696,7 @@ void ConsoleRoboCupCtrl::createCompletion()
       "dt off",
       "dt on",
       "echo",
+      "gs",
       "help",
       "jc motion",
       "jc hide",
@@ -650,9 +731,14 @@ void ConsoleRoboCupCtrl::createCompletion()
       "log goto",
       "log fast_forward",
       "log fast_rewind",
+      "log sync",
+      "log sync off",
+      "log time",
+      "log offset",
       "log keepFrames",
       "log removeFrames",
       "log export",
+      "log exportColumns",
       "mr modules",
       "mr save",
       "msg off",
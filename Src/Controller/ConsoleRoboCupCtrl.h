@@ -52,6 +52,12 @@ public:
   */
   const std::string& getLogFile() const { return logFile; }
 
+  /**
+  * The function returns whether the log file played back shall be loaded lazily.
+  * @return Load lazily?
+  */
+  bool isLogFileLazy() const { return lazyLogFile; }
+
   /**
    * Sets a representation.
    * @param representationName The name of the Representation to set.
@@ -177,6 +183,7 @@ public:
 private:
   SystemCall::Mode mode; /**< The mode of the robot currently constructed. */
   std::string logFile; /**< States whether the current robot constructed shall play back a log file. */
+  bool lazyLogFile = false; /**< Shall the log file of the current robot constructed be loaded lazily? */
   ConsoleView* consoleView; /**< The scene graph object that describes the console widget. */
   std::list<RobotConsole*> selected; /**< The currently selected simulated robot. */
   std::list<RemoteRobot*> remoteRobots; /**< The list of all remote robots. */
@@ -241,6 +248,22 @@ private:
   */
   bool startLogFile(In& stream);
 
+  /**
+  * The function starts a robot reading its inputs from a log file.
+  * @param name The name of the robot.
+  * @param fileName The path of the log file.
+  * @param lazy Load the log file lazily.
+  * @return Does the log file exist?
+  */
+  bool startLogFile(const std::string& name, const std::string& fileName, bool lazy = false);
+
+  /**
+  * The function handles the console input for the "batch" command.
+  * @param stream The stream containing the parameters of "batch".
+  * @return Returns true if the parameters were correct.
+  */
+  bool startBatch(In& stream);
+
   /**
    * The function handles the console input for the "ci" command.
    * @param stream The stream containing the parameters of "ci".
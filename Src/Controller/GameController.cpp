@@ -70,6 +70,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
       gameInfo.secsRemaining = durationOfPS;
     gameInfo.state = STATE_INITIAL;
     timeOfLastDropIn = timeWhenHalfStarted = 0;
+    timeWhenStateBegan = SystemCall::getCurrentSystemTime();
     return true;
   }
   else if (command == "ready")
@@ -150,6 +151,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   else if (command == "finished")
   {
     gameInfo.state = STATE_FINISHED;
+    std::cout << getStatistics();
     return true;
   }
   else if (command == "kickOffBlue")
@@ -164,6 +166,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "kickInForRed")
   {
+    ++statistics[TEAM_RED].setPlays[SET_PLAY_KICK_IN];
     placeBallAfterLeavingField(KICK_IN_FOR_RED);
     gameInfo.setPlay = SET_PLAY_KICK_IN;
     gameInfo.kickingTeam = 2;
@@ -172,6 +175,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "kickInForBlue")
   {
+    ++statistics[TEAM_BLUE].setPlays[SET_PLAY_KICK_IN];
     placeBallAfterLeavingField(KICK_IN_FOR_BLUE);
     gameInfo.setPlay = SET_PLAY_KICK_IN;
     gameInfo.kickingTeam = 1;
@@ -180,6 +184,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "cornerKickForRed")
   {
+    ++statistics[TEAM_RED].setPlays[SET_PLAY_CORNER_KICK];
     placeBallAfterLeavingField(CORNER_KICK_FOR_RED);
     gameInfo.setPlay = SET_PLAY_CORNER_KICK;
     gameInfo.kickingTeam = 2;
@@ -188,6 +193,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "cornerKickForBlue")
   {
+    ++statistics[TEAM_BLUE].setPlays[SET_PLAY_CORNER_KICK];
     placeBallAfterLeavingField(CORNER_KICK_FOR_BLUE);
     gameInfo.setPlay = SET_PLAY_CORNER_KICK;
     gameInfo.kickingTeam = 1;
@@ -196,6 +202,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "pushingFreeKickForRed")
   {
+    ++statistics[TEAM_RED].setPlays[SET_PLAY_PUSHING_FREE_KICK];
     gameInfo.setPlay = SET_PLAY_PUSHING_FREE_KICK;
     gameInfo.kickingTeam = 2;
     timeWhenSetPlayStarted = SystemCall::getCurrentSystemTime();
@@ -203,6 +210,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "pushingFreeKickForBlue")
   {
+    ++statistics[TEAM_BLUE].setPlays[SET_PLAY_PUSHING_FREE_KICK];
     gameInfo.setPlay = SET_PLAY_PUSHING_FREE_KICK;
     gameInfo.kickingTeam = 1;
     timeWhenSetPlayStarted = SystemCall::getCurrentSystemTime();
@@ -210,6 +218,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "goalFreeKickForRed")
   {
+    ++statistics[TEAM_RED].setPlays[SET_PLAY_GOAL_KICK];
     placeBallAfterLeavingField(GOAL_FREE_KICK_FOR_RED);
     gameInfo.setPlay = SET_PLAY_GOAL_KICK;
     gameInfo.kickingTeam = 2;
@@ -218,6 +227,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "goalFreeKickForBlue")
   {
+    ++statistics[TEAM_BLUE].setPlays[SET_PLAY_GOAL_KICK];
     placeBallAfterLeavingField(GOAL_FREE_KICK_FOR_BLUE);
     gameInfo.setPlay = SET_PLAY_GOAL_KICK;
     gameInfo.kickingTeam = 1;
@@ -226,6 +236,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "penaltyKickForRed")
   {
+    ++statistics[TEAM_RED].setPlays[SET_PLAY_PENALTY_KICK];
     float penaltyCrossX = fieldDimensions.xPosOpponentPenaltyMark;
     SimulatedRobot::moveBall(Vector3f(penaltyCrossX, 0, 100.f), true);
     gameInfo.setPlay = SET_PLAY_PENALTY_KICK;
@@ -235,6 +246,7 @@ bool GameController::handleGlobalCommand(const std::string& command)
   }
   else if (command == "penaltyKickForBlue")
   {
+    ++statistics[TEAM_BLUE].setPlays[SET_PLAY_PENALTY_KICK];
     float penaltyCrossX = fieldDimensions.xPosOwnPenaltyMark;
     SimulatedRobot::moveBall(Vector3f(penaltyCrossX, 0, 100.f), true);
     gameInfo.setPlay = SET_PLAY_PENALTY_KICK;
@@ -283,6 +295,7 @@ bool GameController::handleRobotCommand(int robot, const std::string& command)
       tr.secsTillUnpenalised = 45;
       if (i)
       {
+        ++statistics[robot * 2 / numOfRobots].penalties[i];
         r.timeWhenPenalized = SystemCall::getCurrentSystemTime();
         if (automatic)
           placeForPenalty(robot, fieldDimensions.xPosOpponentPenaltyMark, fieldDimensions.yPosRightFieldBorder + 100.f, -pi_2);
@@ -553,6 +566,20 @@ void GameController::referee()
     int maxTimeInReady = (gameInfo.setPlay == SET_PLAY_PENALTY_KICK) ? 30000 : 45000;
     switch (gameInfo.state)
     {
+    case STATE_INITIAL:
+      if (automaticGame && Global::getSettings().gameMode != Settings::penaltyShootout)
+      {
+        if (!timeWhenStateBegan)
+          timeWhenStateBegan = SystemCall::getCurrentSystemTime();
+        else if (SystemCall::getTimeSince(timeWhenStateBegan) >= durationOfInitial)
+        {
+          if (gameInfo.firstHalf)
+            kickingTeamOfFirstHalf = gameInfo.kickingTeam;
+          VERIFY(handleGlobalCommand("ready"));
+        }
+      }
+      break;
+
     case STATE_READY:
       if (SystemCall::getTimeSince(timeWhenStateBegan) < 2000)
         timeWhenLastRobotMoved = 0;
@@ -560,7 +587,21 @@ void GameController::referee()
         handleGlobalCommand("set");
       break;
 
+    case STATE_SET:
+      if (automaticGame && SystemCall::getTimeSince(timeWhenStateBegan) >= durationOfSet)
+        VERIFY(handleGlobalCommand("playing"));
+      break;
+
     case STATE_PLAYING:
+      if (automaticGame && Global::getSettings().gameMode != Settings::penaltyShootout)
+      {
+        if (timeWhenHalfStarted && SystemCall::getTimeSince(timeWhenHalfStarted) >= durationOfHalf * 1000)
+        {
+          endHalf();
+          break;
+        }
+        penalizeRobotsLeavingTheField();
+      }
       checkForSetPlayCompletion();
       switch (updateBall())
       {
@@ -601,6 +642,50 @@ void GameController::referee()
   }
 }
 
+void GameController::penalizeRobotsLeavingTheField()
+{
+  // A robot has left the field if both feet are outside the field lines. It may enter its own goal.
+  const float maxX = fieldDimensions.xPosOpponentGroundline + footLength;
+  const float maxY = fieldDimensions.yPosLeftSideline + footLength;
+  for (int i = 0; i < numOfRobots; ++i)
+  {
+    const Robot& r = robots[i];
+    if (!r.simulatedRobot || r.info.penalty != PENALTY_NONE)
+      continue;
+    const Vector2f& position = r.lastPose.translation;
+    const bool inGoal = std::abs(position.y()) < fieldDimensions.yPosLeftGoal && std::abs(position.x()) <= std::abs(fieldDimensions.xPosOpponentGoal);
+    if ((std::abs(position.x()) > maxX || std::abs(position.y()) > maxY) && !inGoal)
+    {
+      std::cout << "Robot " << (i % (numOfRobots / 2) + 1) << " of team " << getTeamNumberOfRobot(i) << " left the field" << std::endl;
+      VERIFY(handleRobotCommand(i, getName(leavingTheField)));
+    }
+  }
+}
+
+void GameController::endHalf()
+{
+  if (gameInfo.firstHalf)
+  {
+    std::cout << "End of first half" << std::endl << getStatistics();
+
+    // All penalties are lifted at half-time. The robots return to the field in the ready state.
+    for (Robot& r : robots)
+      if (r.simulatedRobot && r.info.penalty != PENALTY_NONE && r.info.penalty != PENALTY_SUBSTITUTE)
+      {
+        r.info.penalty = PENALTY_NONE;
+        r.info.secsTillUnpenalised = 0;
+      }
+
+    gameInfo.firstHalf = 0;
+    gameInfo.setPlay = SET_PLAY_NONE;
+    timeWhenSetPlayStarted = -1;
+    VERIFY(handleGlobalCommand(kickingTeamOfFirstHalf == 1 ? "kickOffRed" : "kickOffBlue"));
+    VERIFY(handleGlobalCommand("initial"));
+  }
+  else
+    VERIFY(handleGlobalCommand("finished"));
+}
+
 GameController::BallOut GameController::updateBall()
 {
   BallOut result = NONE;
@@ -940,6 +1025,26 @@ void GameController::setTeamColors(uint8_t firstFieldPlayerColor, uint8_t firstG
   teamInfos[1].goalkeeperColour = secondGoalkeeperColor;
 }
 
+std::string GameController::getStatistics()
+{
+  static const char* setPlayNames[] = {"none", "goalKick", "pushingFreeKick", "cornerKick", "kickIn", "penaltyKick"};
+  static_assert(sizeof(setPlayNames) / sizeof(setPlayNames[0]) == SET_PLAY_PENALTY_KICK + 1, "Set play names do not match");
+
+  SYNC;
+  std::string text;
+  for (int team : {TEAM_BLUE, TEAM_RED})
+  {
+    text += std::string(team == TEAM_BLUE ? "blue" : "red") + ": score " + std::to_string(teamInfos[team].score);
+    for (int setPlay = SET_PLAY_NONE + 1; setPlay <= SET_PLAY_PENALTY_KICK; ++setPlay)
+      text += std::string(", ") + setPlayNames[setPlay] + " " + std::to_string(statistics[team].setPlays[setPlay]);
+    for (int penalty = none + 1; penalty < numOfPenalties; ++penalty)
+      if (statistics[team].penalties[penalty])
+        text += std::string(", ") + getName(static_cast<Penalty>(penalty)) + " " + std::to_string(statistics[team].penalties[penalty]);
+    text += "\n";
+  }
+  return text;
+}
+
 void GameController::addCompletion(std::set<std::string>& completion) const
 {
   static const char* commands[] = {"initial",
@@ -55,12 +55,21 @@ private:
   );
   static const int numOfPenalties = numOfPenaltys; /**< Correct typo. */
 
+  /** Counts what happened to a team during the game, e.g. to compare behaviors in many simulated games. */
+  struct Statistics
+  {
+    unsigned setPlays[SET_PLAY_PENALTY_KICK + 1] = {0}; /**< How often the team was awarded each set play. */
+    unsigned penalties[numOfPenalties] = {0}; /**< How often robots of the team were penalized for each reason. */
+  };
+
   DECLARE_SYNC;
   static const int numOfRobots = MAX_NUM_PLAYERS * 2;
   static const int numOfFieldPlayers = numOfRobots / 2 - 2; // Keeper, Substitute
   static constexpr uint16_t messageBudget = 1200;
   static const int durationOfHalf = 600;
   static const int durationOfPS = 45; /**< duration of one penalty shootout attemp. */
+  static const int durationOfInitial = 3000; /**< The time an automatic game stays in the initial state in ms. */
+  static const int durationOfSet = 5000; /**< The time an automatic game stays in the set state in ms. */
   static const float footLength; /**< foot length for position check and manual placement at center circle. */
   static const float safeDistance; /**< safe distance from penalty areas for manual placement. */
   static const float dropHeight; /**< height at which robots are manually placed so the fall a little bit and recognize it. */
@@ -75,7 +84,9 @@ private:
   unsigned timeWhenStateBegan;
   int minNextMessageCountIncrease = 0;
   int timeWhenSetPlayStarted = -1; /**Time when the current set play started (-1 during SET_PLAY_NONE)*/
+  uint8_t kickingTeamOfFirstHalf = 1; /**< The team that had the kick-off in the first half of an automatic game. */
   Robot robots[numOfRobots];
+  Statistics statistics[2]; /**< The statistics of both teams, indexed like teamInfos. */
 
   /** enum which declares the different types of balls leaving the field */
   enum BallOut
@@ -191,6 +202,12 @@ private:
   /** Moves all players out of the penalty area that are not allowed there during a penalty kick. */
   void removeIllegalPlayersFromPenaltyArea(Vector2f ballPosition);
 
+  /** Penalizes all robots that left the field during an automatic game. */
+  void penalizeRobotsLeavingTheField();
+
+  /** Ends the current half of an automatic game, i.e. starts the second half or finishes the game. */
+  void endHalf();
+
   /**
    * Write the current information of the team to the stream
    * provided.
@@ -201,6 +218,7 @@ private:
 
 public:
   bool automatic; /**< Are the automatic features active? */
+  bool automaticGame = false; /**< Does the automatic referee also run the whole game, i.e. switch the states and halves and penalize robots leaving the field? */
 
   /** Constructor */
   GameController();
@@ -274,6 +292,13 @@ public:
    */
   void writeRobotInfo(int robot, Out& stream);
 
+  /**
+   * Returns a summary of the game so far, i.e. the score, the set plays awarded,
+   * and the penalties of both teams.
+   * @return The summary, one line per team.
+   */
+  std::string getStatistics();
+
   /**
    * Adds all commands of this module to the set of tab completion
    * strings.
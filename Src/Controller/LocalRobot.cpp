@@ -20,8 +20,9 @@ LocalRobot::LocalRobot()
   if (mode == SystemCall::logfileReplay)
   {
     logFile = ((ConsoleRoboCupCtrl*)RoboCupCtrl::controller)->getLogFile();
-    logPlayer.open(logFile.c_str());
-    handleAllMessagesByCycle(logPlayer, annotationInfos);
+    logPlayer.open(logFile.c_str(), ((ConsoleRoboCupCtrl*)RoboCupCtrl::controller)->isLogFileLazy());
+    for (auto& [processIdentifier, annotationInfo] : annotationInfos)
+      annotationInfo.add(logPlayer.annotations[processIdentifier]);
     logPlayer.play();
     puppet = (SimRobotCore2::Body*)RoboCupCtrl::application->resolveObject("RoboCup.puppets." + robotName, SimRobotCore2::body);
     if (puppet)
@@ -130,6 +131,7 @@ void LocalRobot::update()
     {
       if (logAcknowledged && logPlayer.replay())
         logAcknowledged = false;
+      updateBatch();
       if (puppet)
         simulatedRobot.getAndSetJointData(jointRequest, jointSensorData);
     }
@@ -18,26 +18,44 @@
 #include "Platform/BHAssert.h"
 #include "Platform/File.h"
 #include "Tools/MessageQueue/LogFileFormat.h"
+#include "Tools/MessageQueue/LogFileIndex.h"
 #include "Tools/Module/Blackboard.h"
 #include "Tools/Streams/Streamable.h"
 #include "Tools/Debugging/DebugDataStreamer.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <snappy-c.h>
+#include <limits>
 #include <vector>
 #include <list>
 #include <map>
+#include <thread>
 
 using namespace std;
 using json = nlohmann::json;
 
-LogPlayer::LogPlayer(MessageQueue& targetQueue) : targetQueue(targetQueue), streamHandler(nullptr)
+std::mutex LogPlayer::teamMutex;
+std::vector<LogPlayer*> LogPlayer::team;
+
+LogPlayer::LogPlayer(MessageQueue& targetQueue) : targetQueue(targetQueue), streamHandler(nullptr), nextTime(std::numeric_limits<int>::max())
 {
   init();
 }
 
+LogPlayer::~LogPlayer()
+{
+  leaveTeam();
+  stopPrefetching();
+  if (streamHandler)
+    delete streamHandler;
+}
+
 void LogPlayer::init()
 {
+  leaveTeam();
+  stopPrefetching();
   clear();
   stop();
   numberOfFrames = 0;
@@ -51,9 +69,20 @@ void LogPlayer::init()
     streamHandler = nullptr;
   }
   streamSpecificationReplayed = false;
+  blocks.clear();
+  cachedBlocks.clear();
+  lazyFile.reset();
+  messageIDsOffset = 0;
+  codec = LogFileCompression::snappy;
+  deltaEncoded = false;
+  deltaReferences.clear();
+  annotations.clear();
+  frameTimes.clear();
+  gameStateChanges.clear();
+  manualTimeOffset = 0;
 }
 
-bool LogPlayer::open(const char* fileName)
+bool LogPlayer::open(const char* fileName, bool lazy)
 {
   InBinaryFile file(fileName);
   if (file.exists())
@@ -65,6 +94,7 @@ bool LogPlayer::open(const char* fileName)
 
     if (magicByte == logFileMessageIDs)
     {
+      messageIDsOffset = file.getPosition();
       readMessageIDMapping(file);
       file >> magicByte;
     }
@@ -78,28 +108,51 @@ bool LogPlayer::open(const char* fileName)
       file >> magicByte;
     }
 
+    if (magicByte == logFileDeltaEncoded)
+    {
+      deltaEncoded = true;
+      file >> magicByte;
+    }
+
     switch (magicByte)
     {
     case logFileUncompressed: //regular log file
       //file >> *this; // copy data to memory
       mapFile(file); // map data to memory
       break;
+    case logFileCompressedWithCodec: // compressed log file, the codec follows
+    {
+      unsigned char c;
+      file >> c;
+      codec = static_cast<LogFileCompression::Codec>(c);
+      [[fallthrough]];
+    }
     case logFileCompressed: //compressed log file
+      if (lazy && !deltaEncoded) // delta-encoded messages can only be decoded in order
+      {
+        indexBlocks(file);
+        stop();
+        return true;
+      }
       while (!file.eof())
       {
         unsigned compressedSize;
         file >> compressedSize;
-        ASSERT(compressedSize > 0);
+        if (!compressedSize) // the block index follows
+          break;
         std::vector<char> compressedBuffer;
         compressedBuffer.resize(compressedSize);
         file.read(&compressedBuffer[0], (int)compressedSize);
 
         size_t uncompressedSize = 0;
-        snappy_uncompressed_length(&compressedBuffer[0], compressedSize, &uncompressedSize);
+        if (!LogFileCompression::getUncompressedSize(codec, &compressedBuffer[0], compressedSize, uncompressedSize))
+          break;
         std::vector<char> uncompressBuffer;
         uncompressBuffer.resize(uncompressedSize);
-        if (snappy_uncompress(&compressedBuffer[0], compressedSize, &uncompressBuffer[0], &uncompressedSize) != SNAPPY_OK)
+        if (!LogFileCompression::uncompress(codec, &compressedBuffer[0], compressedSize, &uncompressBuffer[0], uncompressedSize))
           break;
+        if (deltaEncoded)
+          resolveDeltaMessages(&uncompressBuffer[0], uncompressedSize);
         InBinaryMemory mem(&uncompressBuffer[0], uncompressedSize);
         mem >> *this;
       }
@@ -132,11 +185,13 @@ void LogPlayer::stop()
   currentFrameNumber = -1;
   state = initial;
   lastImageFrameNumber = -1;
+  nextTime = std::numeric_limits<int>::max();
 }
 
 void LogPlayer::pause()
 {
-  if (getNumberOfMessages() == 0)
+  nextTime = std::numeric_limits<int>::max();
+  if (getNumberOfMessages() == 0 && blocks.empty())
     state = initial;
   else
     state = paused;
@@ -154,7 +209,8 @@ void LogPlayer::stepBackward()
     else
       return;
     currentMessageNumber = frameIndex[currentFrameNumber];
-    queue.setSelectedMessageForReading(currentMessageNumber);
+    if (blocks.empty())
+      queue.setSelectedMessageForReading(currentMessageNumber);
     stepRepeat();
   }
 }
@@ -187,15 +243,13 @@ void LogPlayer::stepForward()
         return;
     }
     replayStreamSpecification();
+    const MessageQueueBase* played;
     do
     {
-      copyMessage(++currentMessageNumber, targetQueue);
-      if (queue.getMessageID() == idImage || queue.getMessageID() == idImageUpper || queue.getMessageID() == idJPEGImage || queue.getMessageID() == idJPEGImageUpper
-          || queue.getMessageID() == idThumbnail || queue.getMessageID() == idThumbnailUpper || queue.getMessageID() == idYoloInput || queue.getMessageID() == idYoloInputUpper
-          || (queue.getMessageID() == idLowFrameRateImage && queue.getMessageSize() > 1000) || (queue.getMessageID() == idLowFrameRateImageUpper && queue.getMessageSize() > 1000)
-          || (queue.getMessageID() == idSequenceImage && queue.getMessageSize() > 1000) || (queue.getMessageID() == idSequenceImageUpper && queue.getMessageSize() > 1000))
+      played = &replayMessage(++currentMessageNumber);
+      if (isImage(played->getMessageID(), played->getMessageSize()))
         lastImageFrameNumber = currentFrameNumber;
-    } while (queue.getMessageID() != idProcessFinished);
+    } while (played->getMessageID() != idProcessFinished);
     ++currentFrameNumber;
   }
 }
@@ -234,8 +288,90 @@ void LogPlayer::gotoFrame(int frame)
   }
 }
 
+void LogPlayer::gotoTime(int time)
+{
+  if (frameTimes.empty())
+    return;
+  // The frames of the threads are interleaved, so their times are not strictly monotonic.
+  int frame = 0;
+  while (frame < numberOfFrames - 1 && getTeamTime(frame) < time)
+    ++frame;
+  gotoFrame(frame);
+}
+
+int LogPlayer::getTime() const
+{
+  return currentFrameNumber >= 0 && currentFrameNumber < static_cast<int>(frameTimes.size()) ? getTeamTime(currentFrameNumber) : 0;
+}
+
+void LogPlayer::joinTeam()
+{
+  std::lock_guard<std::mutex> lock(teamMutex);
+  if (!inTeam && !frameTimes.empty())
+  {
+    inTeam = true;
+    team.push_back(this);
+    synchronizeTeam();
+  }
+}
+
+void LogPlayer::leaveTeam()
+{
+  std::lock_guard<std::mutex> lock(teamMutex);
+  if (inTeam)
+  {
+    inTeam = false;
+    team.erase(std::find(team.begin(), team.end(), this));
+    synchronizeTeam();
+  }
+}
+
+void LogPlayer::setTimeOffset(int offset)
+{
+  manualTimeOffset = offset;
+}
+
+void LogPlayer::synchronizeTeam()
+{
+  if (team.empty())
+    return;
+
+  // The reference log starts at time 0.
+  LogPlayer& reference = *team.front();
+  reference.timeOffset = -static_cast<int>(reference.frameTimes.front());
+  for (LogPlayer* logPlayer : team)
+  {
+    if (logPlayer == &reference)
+      continue;
+
+    // Changes to the same game state are matched in the order of their occurrence.
+    std::vector<int> differences;
+    std::unordered_map<unsigned char, size_t> occurrences;
+    for (const auto& [time, gameState] : logPlayer->gameStateChanges)
+    {
+      size_t occurrence = occurrences[gameState]++;
+      for (const auto& [referenceTime, referenceGameState] : reference.gameStateChanges)
+        if (referenceGameState == gameState && occurrence-- == 0)
+        {
+          differences.push_back(static_cast<int>(referenceTime - time));
+          break;
+        }
+    }
+
+    if (differences.empty())
+      logPlayer->timeOffset = -static_cast<int>(logPlayer->frameTimes.front());
+    else
+    {
+      // The median ignores changes that were only received by some robots.
+      std::nth_element(differences.begin(), differences.begin() + differences.size() / 2, differences.end());
+      logPlayer->timeOffset = reference.timeOffset + differences[differences.size() / 2];
+    }
+  }
+}
+
 bool LogPlayer::save(const char* fileName, const StreamHandler* streamHandler)
 {
+  loadAllBlocks();
   if (state == recording)
     recordStop();
 
@@ -261,6 +397,7 @@ bool LogPlayer::save(const char* fileName, const StreamHandler* streamHandler)
 
 bool LogPlayer::saveImages(const bool raw, const char* fileName)
 {
+  loadAllBlocks();
   int i = 0;
   Image image;
   for (currentMessageNumber = 0; currentMessageNumber < getNumberOfMessages(); currentMessageNumber++)
@@ -337,6 +474,7 @@ bool LogPlayer::saveImages(const bool raw, const char* fileName)
 
 void LogPlayer::recordStart()
 {
+  loadAllBlocks();
   state = recording;
 }
 
@@ -369,26 +507,36 @@ void LogPlayer::handleMessage(InMessage& message)
 
 bool LogPlayer::replay()
 {
+  if (state == playing && inTeam && currentFrameNumber < numberOfFrames - 1)
+  {
+    // Wait until no other log has to play an earlier frame.
+    const int time = getTeamTime(currentFrameNumber + 1);
+    nextTime = time;
+    std::lock_guard<std::mutex> lock(teamMutex);
+    for (const LogPlayer* logPlayer : team)
+      if (logPlayer != this && logPlayer->nextTime < time - syncTolerance)
+        return false;
+  }
+
   if (state == playing)
   {
     if (currentFrameNumber < numberOfFrames - 1)
     {
       replayStreamSpecification();
+      const MessageQueueBase* played;
       do
       {
-        copyMessage(++currentMessageNumber, targetQueue);
-        if (queue.getMessageID() == idImage || queue.getMessageID() == idJPEGImage || queue.getMessageID() == idImageUpper || queue.getMessageID() == idJPEGImageUpper
-            || queue.getMessageID() == idThumbnail || queue.getMessageID() == idThumbnailUpper || queue.getMessageID() == idYoloInput || queue.getMessageID() == idYoloInputUpper
-            || (queue.getMessageID() == idLowFrameRateImage && queue.getMessageSize() > 1000) || (queue.getMessageID() == idLowFrameRateImageUpper && queue.getMessageSize() > 1000)
-            || (queue.getMessageID() == idSequenceImage && queue.getMessageSize() > 1000) || (queue.getMessageID() == idSequenceImageUpper && queue.getMessageSize() > 1000))
+        played = &replayMessage(++currentMessageNumber);
+        if (isImage(played->getMessageID(), played->getMessageSize()))
           lastImageFrameNumber = currentFrameNumber;
-
-      } while (queue.getMessageID() != idProcessFinished && currentMessageNumber < numberOfMessagesWithinCompleteFrames - 1);
+      } while (played->getMessageID() != idProcessFinished && currentMessageNumber < numberOfMessagesWithinCompleteFrames - 1);
       ++currentFrameNumber;
       if (currentFrameNumber == numberOfFrames - 1)
       {
         SystemCall::text2Speech("allright");
-        if (loop) //restart in loop mode
+        if (inTeam) // the other logs continue, so this one waits at its end
+          pause();
+        else if (loop) //restart in loop mode
         {
           gotoFrame(0);
           play();
@@ -403,7 +551,9 @@ bool LogPlayer::replay()
     else
     {
       SystemCall::text2Speech("allright");
-      if (loop) //restart in loop mode
+      if (inTeam)
+        pause();
+      else if (loop) //restart in loop mode
       {
         gotoFrame(0);
         play();
@@ -419,6 +569,7 @@ bool LogPlayer::replay()
 
 void LogPlayer::keep(MessageID* messageIDs)
 {
+  loadAllBlocks();
   stop();
   LogPlayer temp((MessageQueue&)*this);
   temp.setSize(queue.getSize());
@@ -445,6 +596,7 @@ void LogPlayer::keep(MessageID* messageIDs)
 
 void LogPlayer::keep(int startFrame, int endFrame)
 {
+  loadAllBlocks();
   if (startFrame < 0 || startFrame >= numberOfFrames)
     return;
   if (endFrame < 0 || endFrame >= numberOfFrames)
@@ -469,6 +621,7 @@ void LogPlayer::keep(int startFrame, int endFrame)
 
 void LogPlayer::remove(MessageID* messageIDs)
 {
+  loadAllBlocks();
   stop();
   LogPlayer temp((MessageQueue&)*this);
   temp.setSize(queue.getSize());
@@ -493,6 +646,7 @@ void LogPlayer::remove(MessageID* messageIDs)
 
 void LogPlayer::remove(int startFrame, int endFrame)
 {
+  loadAllBlocks();
   if (startFrame < 0 || startFrame >= numberOfFrames)
     return;
   if (endFrame < 0 || endFrame >= numberOfFrames)
@@ -520,6 +674,7 @@ void LogPlayer::remove(int startFrame, int endFrame)
 
 void LogPlayer::statistics(int frequencies[numOfDataMessageIDs], unsigned* sizes, char processIdentifier)
 {
+  loadAllBlocks();
   for (int i = 0; i < numOfDataMessageIDs; ++i)
     frequencies[i] = 0;
   if (sizes)
@@ -552,11 +707,511 @@ void LogPlayer::createFrameIndex()
   queue.createIndex();
   frameIndex.clear();
   frameIndex.reserve(numberOfFrames);
+  frameTimes.clear();
+  frameTimes.reserve(numberOfFrames);
+  annotations.clear();
+  int frame = 0;
+  char processIdentifier = 0;
   for (int i = 0; i < getNumberOfMessages(); ++i)
   {
     queue.setSelectedMessageForReading(i);
-    if (queue.getMessageID() == idProcessBegin)
+    switch (queue.getMessageID())
+    {
+    case idProcessBegin:
       frameIndex.push_back(i);
+      frameTimes.push_back(frameTimes.empty() ? 0 : frameTimes.back()); // in case the frame contains no FrameInfo
+      in.bin >> processIdentifier;
+      break;
+    case idFrameInfo:
+      if (!frameTimes.empty() && queue.getMessageSize() >= static_cast<int>(sizeof(unsigned)))
+        in.bin >> frameTimes.back();
+      break;
+    case idProcessFinished:
+      ++frame;
+      break;
+    case idAnnotation:
+      addAnnotation(in, frame, processIdentifier);
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (inTeam)
+  {
+    std::lock_guard<std::mutex> lock(teamMutex);
+    synchronizeTeam();
+  }
+}
+
+void LogPlayer::addAnnotation(InMessage& message, int frame, char processIdentifier)
+{
+  std::vector<AnnotationInfo::AnnotationData>& threadAnnotations = annotations[processIdentifier == 'd' ? 'c' : processIdentifier];
+  threadAnnotations.emplace_back();
+  AnnotationInfo::read(message, frame, threadAnnotations.back());
+}
+
+void LogPlayer::indexAnnotations(const std::vector<std::tuple<size_t, int, char>>& annotatedBlocks)
+{
+  annotations.clear();
+  for (const auto& [block, firstFrame, firstProcessIdentifier] : annotatedBlocks)
+  {
+    int frame = firstFrame;
+    char processIdentifier = firstProcessIdentifier;
+    CachedBlock& cachedBlock = getBlock(block);
+    for (int i = 0; i < cachedBlock.getNumberOfMessages(); ++i)
+    {
+      cachedBlock.queue.setSelectedMessageForReading(i);
+      if (cachedBlock.queue.getMessageID() == idProcessBegin)
+        cachedBlock.in.bin >> processIdentifier;
+      else if (cachedBlock.queue.getMessageID() == idProcessFinished)
+        ++frame;
+      else if (cachedBlock.queue.getMessageID() == idAnnotation)
+        addAnnotation(cachedBlock.in, frame, processIdentifier);
+    }
+  }
+}
+
+void LogPlayer::indexBlocks(InBinaryFile& file)
+{
+  lazyFile = std::make_unique<File>(file.getFullName(), "r");
+  const char* data = lazyFile->getMemoryMappedFile();
+  const size_t fileSize = lazyFile->getSize();
+  const std::string indexName = file.getFullName() + ".index";
+  const size_t firstBlock = file.getPosition();
+  annotations.clear();
+  frameTimes.clear();
+  gameStateChanges.clear();
+
+  // Use the index written by the logger if every block contains a single frame.
+  {
+    LogFileIndex index;
+    if (index.read(data + firstBlock, fileSize - firstBlock)
+       && std::all_of(index.blocks.begin(), index.blocks.end(), [](const LogFileIndex::Block& block) { return block.numberOfFrames == 1; }))
+    {
+      // the index marks the blocks containing annotations with the id used in the log file
+      unsigned char annotationID = queue.numOfMappedIDs ? static_cast<unsigned char>(numOfDataMessageIDs) : static_cast<unsigned char>(idAnnotation);
+      for (unsigned char i = 0; i < queue.numOfMappedIDs; ++i)
+        if (queue.mappedIDs[i] == idAnnotation)
+          annotationID = i;
+
+      blocks.clear();
+      frameIndex.clear();
+      std::vector<std::tuple<size_t, int, char>> annotatedBlocks;
+      int numOfMessages = 0;
+      for (const LogFileIndex::Block& block : index.blocks)
+      {
+        if (block.contains(annotationID))
+          annotatedBlocks.emplace_back(blocks.size(), static_cast<int>(blocks.size()), 0);
+        if (!frameTimes.empty() && block.gameState != index.blocks[frameTimes.size() - 1].gameState)
+          gameStateChanges.emplace_back(block.firstTimestamp, block.gameState);
+        blocks.push_back({firstBlock + static_cast<size_t>(block.offset) + sizeof(unsigned), block.compressedSize, numOfMessages, block.numberOfMessages});
+        frameIndex.push_back(numOfMessages);
+        frameTimes.push_back(block.firstTimestamp);
+        numOfMessages += block.numberOfMessages;
+      }
+      numberOfFrames = static_cast<int>(index.blocks.size());
+      numberOfMessagesWithinCompleteFrames = numOfMessages;
+      if (!blocks.empty())
+      {
+        indexAnnotations(annotatedBlocks);
+        return;
+      }
+    }
+  }
+
+  // Try the cached index next. It is only valid for a file of the same size.
+  {
+    InBinaryFile index(indexName);
+    if (index.exists())
+    {
+      unsigned version = 0;
+      unsigned long long size = 0;
+      index >> version >> size;
+      if (version == blockIndexVersion && size == fileSize)
+      {
+        unsigned numOfBlocks, numOfFrameBegins;
+        index >> numOfBlocks;
+        blocks.resize(numOfBlocks);
+        for (Block& block : blocks)
+        {
+          unsigned long long offset;
+          index >> offset >> block.compressedSize >> block.firstMessage >> block.numberOfMessages;
+          block.offset = static_cast<size_t>(offset);
+        }
+        index >> numOfFrameBegins;
+        frameIndex.resize(numOfFrameBegins);
+        for (int& message : frameIndex)
+          index >> message;
+        frameTimes.resize(numOfFrameBegins);
+        for (unsigned& time : frameTimes)
+          index >> time;
+        index >> numberOfFrames >> numberOfMessagesWithinCompleteFrames;
+        unsigned numOfThreads;
+        index >> numOfThreads;
+        while (numOfThreads--)
+        {
+          char processIdentifier;
+          unsigned numOfAnnotations;
+          index >> processIdentifier >> numOfAnnotations;
+          std::vector<AnnotationInfo::AnnotationData>& threadAnnotations = annotations[processIdentifier];
+          threadAnnotations.resize(numOfAnnotations);
+          for (AnnotationInfo::AnnotationData& annotation : threadAnnotations)
+            index >> annotation.annotationNumber >> annotation.frame >> annotation.name >> annotation.annotation;
+        }
+        if (blocks.empty() || blocks.back().offset + blocks.back().compressedSize != fileSize || static_cast<int>(frameIndex.size()) < numberOfFrames)
+        {
+          blocks.clear(); // broken, scan the log file again
+          annotations.clear();
+          frameTimes.clear();
+        }
+        else
+          return;
+      }
+    }
+  }
+
+  // Scan the log file. The blocks are decompressed one at a time to count their messages.
+  blocks.clear();
+  frameIndex.clear();
+  numberOfFrames = 0;
+  numberOfMessagesWithinCompleteFrames = 0;
+  int numOfMessages = 0;
+  std::vector<char> buffer;
+  std::vector<std::tuple<size_t, int, char>> annotatedBlocks;
+  char processIdentifier = 0;
+  for (size_t offset = firstBlock; offset + sizeof(unsigned) <= fileSize;)
+  {
+    Block block;
+    std::memcpy(&block.compressedSize, data + offset, sizeof(unsigned));
+    block.offset = offset + sizeof(unsigned);
+    block.firstMessage = numOfMessages;
+    if (!block.compressedSize || block.offset + block.compressedSize > fileSize)
+      break;
+    offset = block.offset + block.compressedSize;
+
+    size_t uncompressedSize = 0;
+    if (!LogFileCompression::getUncompressedSize(codec, data + block.offset, block.compressedSize, uncompressedSize))
+      break;
+    buffer.resize(uncompressedSize);
+    if (!LogFileCompression::uncompress(codec, data + block.offset, block.compressedSize, buffer.data(), uncompressedSize) || uncompressedSize < MessageQueueBase::queueHeaderSize)
+      break;
+
+    const int firstFrame = numberOfFrames;
+    const char firstProcessIdentifier = processIdentifier;
+    bool annotated = false;
+
+    // | used size | number of messages | id (1 byte) | message size (3 bytes) | message | ...
+    for (size_t pos = MessageQueueBase::queueHeaderSize; pos + MessageQueueBase::headerSize <= uncompressedSize;)
+    {
+      const unsigned char rawID = static_cast<unsigned char>(buffer[pos]);
+      const MessageID id = rawID < queue.numOfMappedIDs ? queue.mappedIDs[rawID] : static_cast<MessageID>(rawID);
+      unsigned size = 0;
+      std::memcpy(&size, buffer.data() + pos + 1, 3);
+      if (id == idProcessBegin)
+      {
+        frameIndex.push_back(numOfMessages);
+        frameTimes.push_back(frameTimes.empty() ? 0 : frameTimes.back());
+        if (size && pos + MessageQueueBase::headerSize < uncompressedSize)
+          processIdentifier = buffer[pos + MessageQueueBase::headerSize];
+      }
+      else if (id == idFrameInfo && !frameTimes.empty() && size >= sizeof(unsigned) && pos + MessageQueueBase::headerSize + sizeof(unsigned) <= uncompressedSize)
+        std::memcpy(&frameTimes.back(), buffer.data() + pos + MessageQueueBase::headerSize, sizeof(unsigned)); // the time is the first member
+      else if (id == idAnnotation)
+        annotated = true;
+      ++numOfMessages;
+      if (id == idProcessFinished)
+      {
+        ++numberOfFrames;
+        numberOfMessagesWithinCompleteFrames = numOfMessages;
+      }
+      pos += MessageQueueBase::headerSize + size;
+    }
+    block.numberOfMessages = numOfMessages - block.firstMessage;
+    if (annotated)
+      annotatedBlocks.emplace_back(blocks.size(), firstFrame, firstProcessIdentifier);
+    blocks.push_back(block);
+  }
+
+  if (blocks.empty())
+    return;
+
+  indexAnnotations(annotatedBlocks);
+
+  OutBinaryFile index(indexName);
+  if (index.exists())
+  {
+    index << blockIndexVersion << static_cast<unsigned long long>(fileSize) << static_cast<unsigned>(blocks.size());
+    for (const Block& block : blocks)
+      index << static_cast<unsigned long long>(block.offset) << block.compressedSize << block.firstMessage << block.numberOfMessages;
+    index << static_cast<unsigned>(frameIndex.size());
+    for (int message : frameIndex)
+      index << message;
+    for (unsigned time : frameTimes)
+      index << time;
+    index << numberOfFrames << numberOfMessagesWithinCompleteFrames << static_cast<unsigned>(annotations.size());
+    for (const auto& [processIdentifier, threadAnnotations] : annotations)
+    {
+      index << processIdentifier << static_cast<unsigned>(threadAnnotations.size());
+      for (const AnnotationInfo::AnnotationData& annotation : threadAnnotations)
+        index << annotation.annotationNumber << annotation.frame << annotation.name << annotation.annotation;
+    }
+  }
+}
+
+LogPlayer::CachedBlock& LogPlayer::getBlock(size_t block)
+{
+  if (!cachedBlocks.empty() && cachedBlocks.front().block == block)
+    return cachedBlocks.front();
+
+  for (auto i = cachedBlocks.begin(); i != cachedBlocks.end(); ++i)
+    if (i->block == block)
+    {
+      cachedBlocks.splice(cachedBlocks.begin(), cachedBlocks, i);
+      prefetch(block);
+      return cachedBlocks.front();
+    }
+
+  if (cachedBlocks.size() >= maxCachedBlocks)
+    cachedBlocks.pop_back();
+
+  // Take the block from the prefetch thread if it was requested before.
+  bool prefetched = false;
+  {
+    std::unique_lock<std::mutex> lock(prefetchMutex);
+    prefetchCondition.wait(lock, [&] { return prefetchingBlock != block; });
+    for (auto i = prefetchedBlocks.begin(); i != prefetchedBlocks.end(); ++i)
+      if (i->block == block)
+      {
+        cachedBlocks.splice(cachedBlocks.begin(), prefetchedBlocks, i);
+        prefetched = true;
+        break;
+      }
+  }
+
+  if (!prefetched)
+  {
+    CachedBlock& cachedBlock = cachedBlocks.emplace_front();
+    cachedBlock.block = block;
+    decompressBlock(block, cachedBlock);
+  }
+  prefetch(block);
+  return cachedBlocks.front();
+}
+
+void LogPlayer::prefetch(size_t block)
+{
+  std::lock_guard<std::mutex> lock(prefetchMutex);
+
+  // Earlier requests are obsolete, because the position in the log changed.
+  blocksToPrefetch.clear();
+  for (size_t next = block + 1; next < blocks.size() && next <= block + readAheadBlocks; ++next)
+    if (next != prefetchingBlock
+       && std::none_of(cachedBlocks.begin(), cachedBlocks.end(), [next](const CachedBlock& cachedBlock) { return cachedBlock.block == next; })
+       && std::none_of(prefetchedBlocks.begin(), prefetchedBlocks.end(), [next](const CachedBlock& cachedBlock) { return cachedBlock.block == next; }))
+      blocksToPrefetch.push_back(next);
+
+  // Drop the blocks that were skipped.
+  prefetchedBlocks.remove_if([block](const CachedBlock& cachedBlock) { return cachedBlock.block < block || cachedBlock.block > block + readAheadBlocks; });
+
+  if (!blocksToPrefetch.empty())
+  {
+    if (!prefetchThread.joinable())
+    {
+      prefetchRunning = true;
+      prefetchThread = std::thread(&LogPlayer::prefetchBlocks, this);
+    }
+    prefetchCondition.notify_all();
+  }
+}
+
+void LogPlayer::prefetchBlocks()
+{
+  std::unique_lock<std::mutex> lock(prefetchMutex);
+  while (prefetchRunning)
+  {
+    if (blocksToPrefetch.empty())
+    {
+      prefetchCondition.wait(lock);
+      continue;
+    }
+    const size_t block = prefetchingBlock = blocksToPrefetch.front();
+    blocksToPrefetch.pop_front();
+    lock.unlock();
+
+    // The log file and its block index do not change while the thread is running.
+    std::list<CachedBlock> decompressed;
+    decompressed.emplace_back().block = block;
+    decompressBlock(block, decompressed.back());
+
+    lock.lock();
+    prefetchedBlocks.splice(prefetchedBlocks.end(), decompressed);
+    prefetchingBlock = static_cast<size_t>(-1);
+    prefetchCondition.notify_all();
+  }
+}
+
+void LogPlayer::stopPrefetching()
+{
+  if (prefetchThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(prefetchMutex);
+      prefetchRunning = false;
+      blocksToPrefetch.clear();
+    }
+    prefetchCondition.notify_all();
+    prefetchThread.join();
+  }
+  prefetchedBlocks.clear();
+}
+
+void LogPlayer::decompressBlock(size_t block, CachedBlock& cachedBlock) const
+{
+  const char* data = lazyFile->getMemoryMappedFile();
+  if (messageIDsOffset)
+  {
+    InBinaryMemory stream(data + messageIDsOffset, lazyFile->getSize() - messageIDsOffset);
+    cachedBlock.readMessageIDMapping(stream);
+  }
+
+  const Block& compressed = blocks[block];
+  size_t uncompressedSize = 0;
+  std::vector<char> buffer;
+  if (LogFileCompression::getUncompressedSize(codec, data + compressed.offset, compressed.compressedSize, uncompressedSize))
+  {
+    buffer.resize(uncompressedSize);
+    if (LogFileCompression::uncompress(codec, data + compressed.offset, compressed.compressedSize, buffer.data(), uncompressedSize))
+    {
+      InBinaryMemory stream(buffer.data(), uncompressedSize);
+      stream >> cachedBlock;
+    }
+  }
+  ASSERT(cachedBlock.getNumberOfMessages() == compressed.numberOfMessages);
+}
+
+const MessageQueueBase& LogPlayer::replayMessage(int message)
+{
+  if (blocks.empty())
+  {
+    copyMessage(message, targetQueue);
+    return queue;
+  }
+
+  const auto block = std::upper_bound(blocks.begin(), blocks.end(), message, [](int message, const Block& block) { return message < block.firstMessage; }) - 1;
+  CachedBlock& cachedBlock = getBlock(block - blocks.begin());
+  cachedBlock.copyMessage(message - block->firstMessage, targetQueue);
+  return cachedBlock.queue;
+}
+
+void LogPlayer::resolveDeltaMessages(char* block, size_t& size)
+{
+  if (size < MessageQueueBase::queueHeaderSize)
+    return;
+
+  // Decoded messages are shorter than encoded ones, so the block is compacted in place.
+  char process = 0;
+  size_t read = MessageQueueBase::queueHeaderSize;
+  size_t write = read;
+  while (read + MessageQueueBase::headerSize <= size)
+  {
+    unsigned header;
+    std::memcpy(&header, block + read, sizeof(header));
+    const unsigned char rawID = static_cast<unsigned char>(header & 0xff);
+    const size_t messageSize = header >> 8;
+    if (read + MessageQueueBase::headerSize + messageSize > size)
+      break;
+    const char* data = block + read + MessageQueueBase::headerSize;
+    const MessageID id = rawID < queue.numOfMappedIDs ? queue.mappedIDs[rawID] : MessageID(rawID);
+
+    if (id == idProcessBegin && messageSize)
+      process = *data;
+    else if (id == idDeltaMessage && messageSize >= 2)
+    {
+      const unsigned char originalID = static_cast<unsigned char>(data[0]);
+      const bool keyframe = data[1] != 0;
+      const size_t originalSize = messageSize - 2;
+      std::vector<char>& reference = deltaReferences[static_cast<unsigned char>(process) << 8 | originalID];
+      if (keyframe || reference.size() == originalSize)
+      {
+        if (keyframe)
+          reference.assign(data + 2, data + 2 + originalSize);
+        else
+          for (size_t i = 0; i < originalSize; ++i)
+            reference[i] ^= data[2 + i];
+        header = originalID | static_cast<unsigned>(originalSize) << 8;
+        std::memcpy(block + write, &header, sizeof(header));
+        std::memcpy(block + write + MessageQueueBase::headerSize, reference.data(), originalSize);
+        read += MessageQueueBase::headerSize + messageSize;
+        write += MessageQueueBase::headerSize + originalSize;
+        continue;
+      }
+    }
+
+    if (write != read)
+      std::memmove(block + write, block + read, MessageQueueBase::headerSize + messageSize);
+    read += MessageQueueBase::headerSize + messageSize;
+    write += MessageQueueBase::headerSize + messageSize;
+  }
+
+  // Update the queue header, the number of messages did not change
+  const size_t usedSize = write - MessageQueueBase::queueHeaderSize;
+  unsigned queueHeader[2];
+  std::memcpy(queueHeader, block, sizeof(queueHeader));
+  queueHeader[0] = static_cast<unsigned>(usedSize);
+  queueHeader[1] = (queueHeader[1] & 0x0fffffff) | (static_cast<unsigned>(usedSize >> 4) & 0xf0000000);
+  std::memcpy(block, queueHeader, sizeof(queueHeader));
+  size = write;
+}
+
+void LogPlayer::loadAllBlocks()
+{
+  if (blocks.empty())
+    return;
+
+  const char* data = lazyFile->getMemoryMappedFile();
+  std::vector<char> buffer;
+  for (const Block& block : blocks)
+  {
+    size_t uncompressedSize = 0;
+    if (!LogFileCompression::getUncompressedSize(codec, data + block.offset, block.compressedSize, uncompressedSize))
+      break;
+    buffer.resize(uncompressedSize);
+    if (!LogFileCompression::uncompress(codec, data + block.offset, block.compressedSize, buffer.data(), uncompressedSize))
+      break;
+    InBinaryMemory mem(buffer.data(), uncompressedSize);
+    mem >> *this;
+  }
+
+  // The message numbers remain the same, so playing can continue.
+  stopPrefetching();
+  blocks.clear();
+  cachedBlocks.clear();
+  lazyFile.reset();
+  std::tie(numberOfFrames, numberOfMessagesWithinCompleteFrames) = queue.countFramesAndMessages();
+  createFrameIndex();
+}
+
+bool LogPlayer::isImage(MessageID id, int size)
+{
+  switch (id)
+  {
+  case idImage:
+  case idImageUpper:
+  case idJPEGImage:
+  case idJPEGImageUpper:
+  case idThumbnail:
+  case idThumbnailUpper:
+  case idYoloInput:
+  case idYoloInputUpper:
+    return true;
+  case idLowFrameRateImage:
+  case idLowFrameRateImageUpper:
+  case idSequenceImage:
+  case idSequenceImageUpper:
+    return size > 1000;
+  default:
+    return false;
   }
 }
 
@@ -626,6 +1281,7 @@ bool LogPlayer::saveImage(const Image& image, const char* fileName, int imageNum
 
 bool LogPlayer::writeTimingData(const std::string& fileName)
 {
+  loadAllBlocks();
   stop();
 
   map<unsigned short, string> names; /**<contains a mapping from watch id to watch name */
@@ -800,6 +1456,7 @@ bool LogPlayer::writeAudioFile(const char* fileName, std::vector<int> audioCandi
 
 bool LogPlayer::saveAudioFile(const char* fileName)
 {
+  loadAllBlocks();
   AudioData audioData;
   std::vector<int> audioCandidates;
   for (currentMessageNumber = 0; currentMessageNumber < getNumberOfMessages(); ++currentMessageNumber)
@@ -816,6 +1473,7 @@ bool LogPlayer::saveAudioFile(const char* fileName)
 
 int LogPlayer::saveTrueWhistleAudioFile(const char* fileName, bool split)
 {
+  loadAllBlocks();
   int part = 0;
   AudioData audioData;
   RawGameInfo rawGameInfo;
@@ -987,6 +1645,7 @@ int LogPlayer::saveTrueWhistleAudioFile(const char* fileName, bool split)
 
 int LogPlayer::saveFalseWhistleAudioFile(const char* fileName, bool split)
 {
+  loadAllBlocks();
   int part = 0;
   AudioData audioData;
   RawGameInfo rawGameInfo;
@@ -1164,6 +1823,7 @@ void LogPlayer::replayStreamSpecification()
 
 void LogPlayer::export_data(const std::string& file, const std::list<std::string>& ids)
 {
+  loadAllBlocks();
   std::ofstream f(File::getBHDir() + std::string("/Config/Logs/" + file));
   json jOut;
   for (currentMessageNumber = 0; currentMessageNumber < getNumberOfMessages(); ++currentMessageNumber)
@@ -1200,3 +1860,105 @@ void LogPlayer::export_data(const std::string& file, const std::list<std::string
   }
   f << std::setw(4) << jOut;
 }
+
+int LogPlayer::exportColumns(const std::string& directory, const std::list<std::string>& ids)
+{
+  if (!streamHandler)
+    return -1;
+
+  // Each thread needs its own stream handler, because looking up types changes its string table
+  OutBinarySize specificationSize;
+  specificationSize << *streamHandler;
+  std::vector<char> specification(specificationSize.getSize());
+  OutBinaryMemory specificationStream(specification.data());
+  specificationStream << *streamHandler;
+
+  std::vector<bool> exported(numOfDataMessageIDs, false);
+  for (int i = 0; i < numOfDataMessageIDs; ++i)
+    exported[i] = (ids.empty() || std::find(ids.begin(), ids.end(), ::getName(MessageID(i))) != ids.end())
+                  && streamHandler->specification.find(streamHandler->getString(::getName(MessageID(i)) + 2)) != streamHandler->specification.end();
+
+  // Split the log into contiguous ranges of blocks or frames, one per thread
+  const int numberOfChunks = std::max(1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                                                  static_cast<int>(blocks.empty() ? frameIndex.size() : blocks.size())));
+  const int numberOfParts = blocks.empty() ? static_cast<int>(frameIndex.size()) : static_cast<int>(blocks.size());
+  std::vector<std::vector<ColumnTable>> tables(numberOfChunks);
+  std::vector<std::thread> threads;
+  for (int chunk = 0; chunk < numberOfChunks; ++chunk)
+    threads.emplace_back([this, chunk, numberOfChunks, numberOfParts, &specification, &exported, &tables]
+    {
+      StreamHandler localStreamHandler;
+      InBinaryMemory stream(specification.data(), specification.size());
+      stream >> localStreamHandler;
+
+      std::vector<ColumnTable>& chunkTables = tables[chunk];
+      chunkTables.resize(numOfDataMessageIDs);
+      const int begin = numberOfParts * chunk / numberOfChunks;
+      const int end = numberOfParts * (chunk + 1) / numberOfChunks;
+      if (blocks.empty())
+      {
+        const int first = frameIndex.empty() ? 0 : frameIndex[begin];
+        const int last = frameIndex.empty() || end == numberOfParts ? numberOfMessagesWithinCompleteFrames : frameIndex[end];
+        exportColumns(queue, first, last, begin - 1, localStreamHandler, exported, chunkTables);
+      }
+      else
+        for (int block = begin; block < end; ++block)
+        {
+          CachedBlock cachedBlock;
+          decompressBlock(block, cachedBlock);
+          cachedBlock.queue.createIndex();
+          const int firstMessage = blocks[block].firstMessage;
+          const int frame = static_cast<int>(std::lower_bound(frameIndex.begin(), frameIndex.end(), firstMessage) - frameIndex.begin()) - 1;
+          const int last = std::min(cachedBlock.getNumberOfMessages(), numberOfMessagesWithinCompleteFrames - firstMessage);
+          exportColumns(cachedBlock.queue, 0, last, frame, localStreamHandler, exported, chunkTables);
+        }
+    });
+  for (std::thread& thread : threads)
+    thread.join();
+
+  const std::string path = File::getBHDir() + std::string("/Config/Logs/") + directory;
+  std::error_code error;
+  std::filesystem::create_directories(path, error);
+  int filesWritten = 0;
+  for (int i = 0; i < numOfDataMessageIDs; ++i)
+    if (exported[i])
+    {
+      ColumnTable table;
+      for (std::vector<ColumnTable>& chunkTables : tables)
+      {
+        table.append(chunkTables[i]);
+        chunkTables[i] = ColumnTable();
+      }
+      const char* type = ::getName(MessageID(i)) + 2;
+      if (table.getNumberOfRows() && table.write(path + "/" + type + ".columns", type))
+        ++filesWritten;
+    }
+  return filesWritten;
+}
+
+void LogPlayer::exportColumns(const MessageQueueBase& queue, int first, int last, int frame,
+                              StreamHandler& streamHandler, const std::vector<bool>& exported, std::vector<ColumnTable>& tables)
+{
+  char process = 0;
+  for (int i = first; i < last; ++i)
+  {
+    const char* message = queue.buf + queue.messageIndex[i];
+    const unsigned char rawID = static_cast<unsigned char>(*message);
+    const MessageID id = rawID < queue.numOfMappedIDs ? queue.mappedIDs[rawID] : MessageID(rawID);
+    const size_t size = *reinterpret_cast<const unsigned*>(message) >> 8;
+    const char* data = message + MessageQueueBase::headerSize;
+    if (id == idProcessBegin)
+    {
+      ++frame;
+      process = size ? *data : 0;
+    }
+    else if (id < numOfDataMessageIDs && exported[id])
+    {
+      InBinaryMemory stream(data, size);
+      DebugDataStreamer streamer(streamHandler, stream, ::getName(id) + 2);
+      ColumnTable& table = tables[id];
+      table.beginRow(frame, process);
+      table << streamer;
+    }
+  }
+}
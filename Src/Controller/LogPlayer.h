@@ -8,12 +8,23 @@
 
 #pragma once
 
+#include "ColumnTable.h"
+#include "Representations/AnnotationInfo.h"
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/JPEGImage.h"
+#include "Tools/MessageQueue/LogFileCompression.h"
 #include "Tools/MessageQueue/MessageQueue.h"
 #include "Tools/Streams/StreamHandler.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
 
 /**
 * @class LogPlayer
@@ -33,11 +44,7 @@ public:
   LogPlayer(MessageQueue& targetQueue);
 
   /** Destructor. */
-  ~LogPlayer()
-  {
-    if (streamHandler)
-      delete streamHandler;
-  }
+  ~LogPlayer();
 
   /** Deletes all messages from the queue */
   void init();
@@ -45,9 +52,13 @@ public:
   /**
   * Opens a log file and reads all messages into the queue.
   * @param fileName the name of the file to open
+  * @param lazy Only index the blocks of a compressed log file and decompress them
+  *             while the log is played. The index is cached in a file next to the log.
+  *             Functions that need all messages (e.g. save, keep, statistics) load
+  *             the whole log file first.
   * @return if the reading was successful
   */
-  bool open(const char* fileName);
+  bool open(const char* fileName, bool lazy = false);
 
   /**
   * Plays the queue.
@@ -87,6 +98,37 @@ public:
   /** jumps to given message-number in the queue */
   void gotoFrame(int frame);
 
+  /**
+  * Jumps to the first frame that was logged at or after a time of the team timeline.
+  * @param time The time on the team timeline in ms.
+  */
+  void gotoTime(int time);
+
+  /**
+  * Returns the time of the current frame on the team timeline.
+  * @return The time in ms or 0 if no frame was played yet.
+  */
+  int getTime() const;
+
+  /**
+  * Synchronizes this log with the logs of all other robots that joined, i.e.
+  * they share a timeline and are played in lockstep. The timelines are aligned
+  * by the changes of the game state, which all robots receive from the
+  * GameController at about the same time. If there are none, the logs are
+  * expected to start at the same time.
+  */
+  void joinTeam();
+
+  /** Plays this log independently of the others again. */
+  void leaveTeam();
+
+  /**
+  * Shifts this log on the team timeline, e.g. if the game states were not
+  * logged and the logs did not start at the same time.
+  * @param offset The time in ms that is added to the times of this log.
+  */
+  void setTimeOffset(int offset);
+
   /** Set loop mode. If disabled the logfile is played only once. */
   void setLoop(bool);
 
@@ -119,6 +161,16 @@ public:
   */
   void export_data(const std::string& file, const std::list<std::string>& ids);
 
+  /**
+  * Exports representations into one file per representation in which each
+  * field is stored as a column (see ColumnTable). The log file is decoded by
+  * multiple threads.
+  * @param directory The directory the files are written to, relative to Config/Logs.
+  * @param ids The names of the message ids exported. All if empty.
+  * @return The number of files written or -1 if the log contains no stream specification.
+  */
+  int exportColumns(const std::string& directory, const std::list<std::string>& ids);
+
   /**
   * Writes audio data which should not contain the whistle in the log player queue to a single wav file.
   * @param fileName the name of the file to write
@@ -208,6 +260,7 @@ public:
   LogPlayerState state; /**< The state of the log player. */
   int currentFrameNumber; /**< The number of the current frame. */
   int numberOfFrames; /**< The overall number of frames available. */
+  std::unordered_map<char, std::vector<AnnotationInfo::AnnotationData>> annotations; /**< The annotations of the log file per thread ('c' or 'm'), indexed when it is opened. */
   bool streamSpecificationReplayed; /**< The stream specification has to be replayed once. Already done? */
 
 private:
@@ -218,8 +271,151 @@ private:
   int lastImageFrameNumber; /**< The number of the last frame that contained an image. */
   int replayOffset;
   std::vector<int> frameIndex; /**< The message numbers the frames start at. */
+  std::vector<unsigned> frameTimes; /**< The times the frames were logged at in ms. */
+  std::vector<std::pair<unsigned, unsigned char>> gameStateChanges; /**< The times when the game state changed and the new states. */
   StreamHandler* streamHandler; /**< The stream specification of the log file entries. */
 
+  /** A compressed block of a lazily played log file. */
+  struct Block
+  {
+    size_t offset; /**< The position of the compressed data in the log file. */
+    unsigned compressedSize; /**< The size of the compressed data in bytes. */
+    int firstMessage; /**< The number of the first message of the block in the whole log. */
+    int numberOfMessages; /**< The number of messages in the block. */
+  };
+
+  /** The messages of a decompressed block. */
+  class CachedBlock : public MessageQueue
+  {
+  public:
+    size_t block; /**< The index of the block in blocks. */
+
+    friend class LogPlayer; /**< Allows the log player to copy single messages. */
+  };
+
+  static constexpr size_t maxCachedBlocks = 64; /**< The number of decompressed blocks kept. */
+  static constexpr unsigned blockIndexVersion = 3; /**< The version of the format of the cached block index. */
+
+  std::unique_ptr<File> lazyFile; /**< The memory-mapped log file if it is played lazily. */
+  size_t messageIDsOffset = 0; /**< The position of the message id table in the log file (0 = none). */
+  LogFileCompression::Codec codec = LogFileCompression::snappy; /**< The codec the blocks of the log file were compressed with. */
+  std::vector<Block> blocks; /**< The blocks of the lazy log file. Empty if the whole log file is in the queue. */
+  bool deltaEncoded = false; /**< Does the log file contain delta-encoded messages? */
+  std::unordered_map<unsigned, std::vector<char>> deltaReferences; /**< The last message of each process (bits 8..15) and id (bits 0..7) that was delta-encoded. */
+  std::list<CachedBlock> cachedBlocks; /**< The decompressed blocks, the most recently used first. */
+
+  static constexpr size_t readAheadBlocks = 16; /**< The number of blocks behind the one played that are decompressed in the background. */
+  std::thread prefetchThread; /**< Decompresses the blocks that will be played next. */
+  std::mutex prefetchMutex; /**< Protects the members used by the prefetch thread. */
+  std::condition_variable prefetchCondition; /**< Signals new requests to the prefetch thread and finished blocks to the player. */
+  std::deque<size_t> blocksToPrefetch; /**< The blocks the prefetch thread decompresses next. */
+  std::list<CachedBlock> prefetchedBlocks; /**< The blocks decompressed in the background that were not played yet. */
+  size_t prefetchingBlock = static_cast<size_t>(-1); /**< The block the prefetch thread decompresses right now. */
+  bool prefetchRunning = false; /**< Shall the prefetch thread continue? */
+
+  static constexpr int syncTolerance = 20; /**< A synchronized log is played ahead of the others by at most this time in ms. */
+  static std::mutex teamMutex; /**< Protects the team. */
+  static std::vector<LogPlayer*> team; /**< The log players that are synchronized. The first one is the reference. */
+  bool inTeam = false; /**< Is this log player part of the team? */
+  std::atomic<int> timeOffset{0}; /**< Added to the frame times to get the times on the team timeline. */
+  std::atomic<int> manualTimeOffset{0}; /**< The time offset set by the user. */
+  std::atomic<int> nextTime; /**< The team time of the next frame if playing, INT_MAX otherwise. */
+
+  /**
+   * Determines the blocks and the frame index of a compressed log file from the
+   * cached index or by scanning the file, which is memory-mapped.
+   * @param file The log file, positioned at the first block.
+   */
+  void indexBlocks(InBinaryFile& file);
+
+  /**
+   * Returns the messages of a block. It is decompressed if it is not cached.
+   * @param block The index of the block.
+   * @return The messages of the block.
+   */
+  CachedBlock& getBlock(size_t block);
+
+  /**
+   * Requests the blocks behind a block from the prefetch thread. It is started
+   * if necessary.
+   * @param block The index of the block played.
+   */
+  void prefetch(size_t block);
+
+  /** The main loop of the prefetch thread. */
+  void prefetchBlocks();
+
+  /** Stops the prefetch thread and drops the blocks it decompressed. */
+  void stopPrefetching();
+
+  /**
+   * Determines the time offsets of all logs in the team. Must be called with
+   * the teamMutex locked.
+   */
+  static void synchronizeTeam();
+
+  /**
+   * Returns the time of a frame on the team timeline.
+   * @param frame The number of the frame.
+   * @return The time in ms.
+   */
+  int getTeamTime(int frame) const
+  {
+    return static_cast<int>(frameTimes[frame]) + timeOffset + manualTimeOffset;
+  }
+
+  /**
+   * Decompresses a block of a lazily played log file.
+   * @param block The index of the block.
+   * @param cachedBlock The queue the messages of the block are written to.
+   */
+  void decompressBlock(size_t block, CachedBlock& cachedBlock) const;
+
+  /**
+   * Adds the representations in a range of messages to the tables of their ids.
+   * Does not change the queue, so it can be called from multiple threads.
+   * @param queue The queue containing the messages. It must have an index.
+   * @param first The number of the first message.
+   * @param last The number of the message behind the last one.
+   * @param frame The number of frames that start before the first message minus 1.
+   * @param streamHandler The specification of the representations, used by this thread only.
+   * @param exported Which message ids are exported?
+   * @param tables The tables of all message ids.
+   */
+  static void exportColumns(const MessageQueueBase& queue, int first, int last, int frame,
+                            StreamHandler& streamHandler, const std::vector<bool>& exported, std::vector<ColumnTable>& tables);
+
+  /**
+   * Copies a message to the target queue, either from this queue or from the
+   * block of a lazily played log file that contains it.
+   * @param message The number of the message.
+   * @return The queue the message was copied from. The message is selected for reading.
+   */
+  const MessageQueueBase& replayMessage(int message);
+
+  /**
+   * Replaces all delta-encoded messages in a decompressed block by the original
+   * messages. The blocks must be passed in the order of the log file. Messages
+   * that cannot be decoded remain delta-encoded.
+   * @param block The decompressed block including the queue header.
+   * @param size The size of the block. Is set to its size after decoding.
+   */
+  void resolveDeltaMessages(char* block, size_t& size);
+
+  /**
+   * Reads all blocks of a lazily played log file into the queue.
+   */
+  void loadAllBlocks();
+
+  /**
+   * Returns whether a message contains an image that justifies a stop in
+   * stepImageForward() or stepImageBackward().
+   * @param id The id of the message.
+   * @param size The size of the message in bytes.
+   * @return Is it an image?
+   */
+  static bool isImage(MessageID id, int size);
+
   /**
    * Writes selected audio data in the log player queue to a single wav file.
    * @param fileName the name of the file to write
@@ -229,10 +425,27 @@ private:
   bool writeAudioFile(const char* fileName, std::vector<int> audioCandidates);
 
   /**
-   * Creates the index of the first message numbers of all frames.
+   * Creates the index of the first message numbers of all frames, their times,
+   * and the index of the annotations.
    */
   void createFrameIndex();
 
+  /**
+   * Adds an annotation to the index.
+   * @param message The annotation message.
+   * @param frame The number of frames completed before the annotation.
+   * @param processIdentifier The thread that created the annotation.
+   */
+  void addAnnotation(InMessage& message, int frame, char processIdentifier);
+
+  /**
+   * Adds the annotations in some blocks of a lazily played log file to the index.
+   * @param annotatedBlocks The blocks that contain annotations together with the
+   *                        number of frames completed before each block and the
+   *                        thread that wrote its first message.
+   */
+  void indexAnnotations(const std::vector<std::tuple<size_t, int, char>>& annotatedBlocks);
+
   /**
   * The method expands image file name to its full path and integrates
   * an image number if desired.
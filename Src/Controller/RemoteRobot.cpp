@@ -6,11 +6,16 @@
 
 #include "RemoteRobot.h"
 #include "ConsoleRoboCupCtrl.h"
+#include "Representations/Infrastructure/JPEGImage.h"
+#include "Tools/Streams/StreamHandler.h"
 
 RemoteRobot::RemoteRobot(const char* name, const char* ip)
     : RobotConsole((setGlobals(), theDebugReceiver), theDebugSender), theDebugReceiver(this, "Receiver.MessageQueue.O"), theDebugSender(this, "Sender.MessageQueue.S"),
-      bytesTransfered(0), transferSpeed(0), timeStamp(0)
+      bytesTransfered(0), transferSpeed(0), timeStamp(0), receivedPackages(numOfPackages), decodedPackages(numOfPackages)
 {
+  for (size_t i = 0; i < numOfPackages; ++i)
+    freePackages.push_back(packages.emplace_back(std::make_unique<Package>()).get());
+
   strcpy(this->name, name);
   strcpy(this->ip, ip);
   mode = SystemCall::remoteRobot;
@@ -39,10 +44,19 @@ void RemoteRobot::run()
 
 bool RemoteRobot::main()
 {
-  unsigned char *sendData = 0, *receivedData;
+  unsigned char* sendData = 0;
   int sendSize = 0, receivedSize = 0;
   MessageQueue temp;
 
+  receiveDecodedPackages();
+
+  // If all packages are still being decoded, the robot has to wait.
+  if (freePackages.empty())
+  {
+    SystemCall::sleep(1);
+    return false;
+  }
+
   // If there is something to send, prepare a package
   if (!theDebugSender.isEmpty())
   {
@@ -58,7 +72,8 @@ bool RemoteRobot::main()
   }
 
   // exchange data with the router
-  if (!sendAndReceive(sendData, sendSize, receivedData, receivedSize) && sendSize)
+  Package* package = freePackages.back();
+  if (!sendAndReceive(sendData, sendSize, package->data, receivedSize) && sendSize)
   {
     // sending failed, restore theDebugSender
     SYNC;
@@ -72,19 +87,87 @@ bool RemoteRobot::main()
   if (sendSize)
     delete[] sendData;
 
-  // If a package was received from the router program, add it to receiver queue
+  // If a package was received from the router program, hand it to the decoding thread
   if (receivedSize > 0)
   {
-    SYNC;
-    InBinaryMemory stream(receivedData, receivedSize);
-    stream >> theDebugReceiver;
-    delete[] receivedData;
+    package->size = receivedSize;
+    freePackages.pop_back();
+    receivedPackages.push(&package, 1);
+    packagesReceived.post();
   }
 
   SystemCall::sleep(receivedSize > 0 ? 1 : 20);
   return false;
 }
 
+void RemoteRobot::receiveDecodedPackages()
+{
+  if (!decodedPackages.size())
+    return;
+
+  SYNC;
+  for (std::size_t count = decodedPackages.size(); count; --count)
+  {
+    Package* package = decodedPackages.peek(0, 1)[0];
+    package->messages.moveAllMessages(theDebugReceiver);
+    decodedPackages.consume(1);
+    freePackages.push_back(package);
+  }
+}
+
+void RemoteRobot::decode()
+{
+  Thread<RemoteRobot>::setName(std::string(name) + ".RemoteRobot.decode");
+
+  // The types streamed here are registered in a handler of this thread.
+  StreamHandler streamHandler;
+  Global::theStreamHandler = &streamHandler;
+
+  MessageQueue received;
+  Image image(false);
+  while (decoder.isRunning())
+    if (packagesReceived.wait(100))
+      while (receivedPackages.size())
+      {
+        Package* package = receivedPackages.peek(0, 1)[0];
+        decodePackage(*package, received, image);
+        receivedPackages.consume(1);
+        decodedPackages.push(&package, 1);
+      }
+}
+
+void RemoteRobot::decodePackage(Package& package, MessageQueue& received, Image& image)
+{
+  InBinaryMemory stream(package.data.data(), package.size);
+  stream >> received;
+
+  package.messages.clear();
+  bool compressed = false;
+  received.handleAllMessages([&](InMessage& message) { compressed |= message.getMessageID() == idDebugJPEGImage; });
+  if (!compressed)
+  {
+    package.messages.swapMessages(received);
+    received.clear();
+    return;
+  }
+
+  received.handleAllMessages([&](InMessage& message)
+  {
+    if (message.getMessageID() == idDebugJPEGImage)
+    {
+      std::string id;
+      JPEGImage jpi;
+      message.bin >> id >> jpi;
+      jpi.toImage(image);
+      package.messages.out.bin << id << image;
+      package.messages.out.finishMessage(idDebugImage);
+    }
+    else
+      message >> package.messages;
+  });
+  received.clear();
+}
+
 void RemoteRobot::announceStop()
 {
   {
@@ -127,6 +210,19 @@ void RemoteRobot::update()
   std::string statusText = robotName.mid(robotName.lastIndexOf(".") + 1).toUtf8().constData()
       + (isConnected() ? std::string(": connected to ") + ip + ", " + buf : std::string(": connection lost from ") + ip);
 
+  if (isConnected() && debugConnectionStatusReceived && SystemCall::getTimeSince(debugConnectionStatusReceived) < 3000)
+  {
+    char status[100];
+    sprintf(status, ", robot %.1lf kb/s, latency %u/%u ms", debugConnectionStatus.bytesPerSecond / 1000.f,
+            debugConnectionStatus.latency, debugConnectionStatus.maxLatency);
+    statusText += status;
+    if (debugConnectionStatus.imageInterval > 1 || debugConnectionStatus.imagesDropped)
+    {
+      sprintf(status, ", images 1/%u, %u dropped", debugConnectionStatus.imageInterval, debugConnectionStatus.imagesDropped);
+      statusText += status;
+    }
+  }
+
   if (logPlayer.getNumberOfMessages() != 0)
   {
     sprintf(buf, "%u", logPlayer.numberOfFrames);
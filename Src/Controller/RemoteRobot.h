@@ -6,13 +6,20 @@
 
 #pragma once
 
+#include "Platform/Semaphore.h"
 #include "Tools/Debugging/TcpConnection.h"
+#include "Tools/SPSCRingBuffer.h"
 #include "RobotConsole.h"
 #include "SimulatedRobot.h"
+#include <memory>
+#include <vector>
 
 /**
 * @class RemoteRobot
 * A class representing a process that communicates with a remote robot via TCP.
+* The packages received are decoded by a thread of their own, so the connection
+* keeps being served while debug images are decompressed. The console is only
+* locked to append the decoded messages to its queue.
 */
 class RemoteRobot : public RobotConsole, public TcpConnection, private Thread<RemoteRobot>
 {
@@ -27,6 +34,22 @@ private:
   SimulatedRobot simulatedRobot; /**< The interface to simulated objects. */
   SimRobotCore2::Body* puppet; /**< A pointer to the puppet when there is one. Otherwise 0. */
 
+  /** A package received from the robot. Its buffers are reused for later packages. */
+  struct Package
+  {
+    std::vector<unsigned char> data; /**< The package as received. Only the first size bytes are valid. */
+    int size = 0;
+    MessageQueue messages; /**< The decoded messages. */
+  };
+
+  static constexpr size_t numOfPackages = 16; /**< If all are waiting to be decoded, no further packages are received. */
+  std::vector<std::unique_ptr<Package>> packages; /**< All packages. */
+  std::vector<Package*> freePackages; /**< The packages that can be received to. Only used by the connection thread. */
+  SPSCRingBuffer<Package*> receivedPackages; /**< The packages handed to the decoding thread. */
+  SPSCRingBuffer<Package*> decodedPackages; /**< The packages handed back to the connection thread. */
+  Semaphore packagesReceived; /**< Wakes up the decoding thread. */
+  Thread<RemoteRobot> decoder; /**< The thread that decodes the packages received. */
+
   /**
   * The main loop of the process.
   */
@@ -37,6 +60,25 @@ private:
   */
   void connect();
 
+  /**
+  * The main loop of the thread that decodes the packages received.
+  */
+  void decode();
+
+  /**
+  * The function decodes a package. Compressed debug images are decompressed.
+  * @param package The package. Its messages are filled.
+  * @param received A queue the raw messages are read to.
+  * @param image An image the debug images are decompressed to.
+  */
+  static void decodePackage(Package& package, MessageQueue& received, Image& image);
+
+  /**
+  * The function appends the messages of all packages decoded to the queue of
+  * the console and frees the packages.
+  */
+  void receiveDecodedPackages();
+
   /**
   * The function is called from the framework once in every frame.
   */
@@ -56,13 +98,20 @@ public:
   ~RemoteRobot()
   {
     Thread<RemoteRobot>::stop();
+    decoder.announceStop();
+    packagesReceived.post();
+    decoder.stop();
     setGlobals();
   }
 
   /**
   * The function starts the process.
   */
-  void start() { Thread<RemoteRobot>::start(this, &RemoteRobot::run); }
+  void start()
+  {
+    decoder.start(this, &RemoteRobot::decode);
+    Thread<RemoteRobot>::start(this, &RemoteRobot::run);
+  }
 
   /**
   * The function is called to announce the termination of the process.
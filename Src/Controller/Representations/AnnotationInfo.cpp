@@ -31,20 +31,30 @@ bool AnnotationInfo::handleMessage(InMessage& message, unsigned frameNumber)
   if (message.getMessageID() == idAnnotation)
   {
     timeOfLastMessage = SystemCall::getCurrentSystemTime();
-    {
-      SYNC;
-      newAnnotations.push_back(AnnotationData());
-      AnnotationData& data = newAnnotations.back();
-
-      message.bin >> data.annotationNumber;
-      // compatibility: new log files do not contain frame number
-      if ((data.annotationNumber & 0x80000000) == 0)
-        message.bin >> data.frame;
-      data.annotationNumber &= ~0x80000000;
-      data.frame = frameNumber;
-      message.text >> data.name;
-      data.annotation = message.text.readAll();
-    }
+    SYNC;
+    newAnnotations.emplace_back();
+    read(message, frameNumber, newAnnotations.back());
   }
   return true;
 }
+
+void AnnotationInfo::add(const std::vector<AnnotationData>& annotations)
+{
+  if (annotations.empty())
+    return;
+  timeOfLastMessage = SystemCall::getCurrentSystemTime();
+  SYNC;
+  newAnnotations.insert(newAnnotations.end(), annotations.begin(), annotations.end());
+}
+
+void AnnotationInfo::read(InMessage& message, unsigned frameNumber, AnnotationData& data)
+{
+  message.bin >> data.annotationNumber;
+  // compatibility: new log files do not contain frame number
+  if ((data.annotationNumber & 0x80000000) == 0)
+    message.bin >> data.frame;
+  data.annotationNumber &= ~0x80000000;
+  data.frame = frameNumber;
+  message.text >> data.name;
+  data.annotation = message.text.readAll();
+}
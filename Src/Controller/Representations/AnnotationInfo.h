@@ -29,5 +29,19 @@ public:
   bool handleMessage(InMessage& message);
   bool handleMessage(InMessage& message, unsigned frameNumber);
 
+  /**
+   * Adds annotations that were not received as messages, e.g. from the index of a log file.
+   * @param annotations The annotations.
+   */
+  void add(const std::vector<AnnotationData>& annotations);
+
+  /**
+   * Reads an annotation message.
+   * @param message The message. Its id must be idAnnotation.
+   * @param frameNumber The number of the frame the annotation belongs to.
+   * @param data The annotation read.
+   */
+  static void read(InMessage& message, unsigned frameNumber, AnnotationData& data);
+
   DECLARE_SYNC;
 };
@@ -22,6 +22,8 @@ TimeInfo::TimeInfo(const std::string& name) : processName(name)
 void TimeInfo::reset()
 {
   infos.clear();
+  perfInfos.clear();
+  summaries.clear();
   lastFrameNo = 0;
   lastStartTime = 0;
 }
@@ -78,6 +80,51 @@ bool TimeInfo::handleMessage(InMessage& message)
     lastStartTime = processStartTime;
     return true;
   }
+  else if (message.getMessageID() == idPerfCounters)
+  {
+    unsigned short dataCount;
+    message.bin >> dataCount;
+
+    for (int i = 0; i < dataCount; ++i)
+    {
+      unsigned short watchId;
+      unsigned cycles, instructions, cacheMisses, branchMisses;
+      message.bin >> watchId >> cycles >> instructions >> cacheMisses >> branchMisses;
+      PerfInfo& info = perfInfos[watchId];
+      info.cycles.push_front(static_cast<float>(cycles));
+      info.instructions.push_front(static_cast<float>(instructions));
+      info.cacheMisses.push_front(static_cast<float>(cacheMisses));
+      info.branchMisses.push_front(static_cast<float>(branchMisses));
+    }
+    return true;
+  }
+  else if (message.getMessageID() == idTimingSummary)
+  {
+    timeStamp = SystemCall::getCurrentSystemTime();
+    unsigned windowStart, windowDuration, windowFrames;
+    unsigned short dataCount;
+    message.bin >> windowStart >> windowDuration >> windowFrames >> dataCount;
+
+    summaries.clear();
+    for (int i = 0; i < dataCount; ++i)
+    {
+      unsigned short watchId;
+      string watchName;
+      unsigned median, percentile95, percentile99, maximum;
+      Summary summary;
+      message.bin >> watchId >> watchName >> summary.count >> median >> percentile95 >> percentile99 >> maximum;
+      summary.median = static_cast<float>(median) / 1000.f;
+      summary.percentile95 = static_cast<float>(percentile95) / 1000.f;
+      summary.percentile99 = static_cast<float>(percentile99) / 1000.f;
+      summary.maximum = static_cast<float>(maximum) / 1000.f;
+      summaries[watchId] = summary;
+
+      // The summaries contain all names, so the stop watches are known without receiving their frames.
+      names[watchId] = watchName;
+      infos.emplace(watchId, Info());
+    }
+    return true;
+  }
   else
     return false;
 }
@@ -90,6 +137,14 @@ void TimeInfo::getStatistics(const Info& info, float& minTime, float& maxTime, f
   lastTime = info.front() / 1000.0f;
 }
 
+void TimeInfo::getPerfStatistics(const PerfInfo& info, float& ipc, float& cacheMisses, float& branchMisses) const
+{
+  const float instructions = info.instructions.sum();
+  ipc = info.cycles.sum() != 0.f ? instructions / info.cycles.sum() : 0.f;
+  cacheMisses = instructions != 0.f ? info.cacheMisses.sum() * 1000.f / instructions : 0.f;
+  branchMisses = instructions != 0.f ? info.branchMisses.sum() * 1000.f / instructions : 0.f;
+}
+
 void TimeInfo::getProcessStatistics(float& outAvgFreq) const
 {
   outAvgFreq = processDeltas.sum() != 0.f ? 1000.0f / processDeltas.average() : 0.f;
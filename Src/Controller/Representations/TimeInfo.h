@@ -36,6 +36,29 @@ public:
   typedef RingBufferWithSum<float, ringBufferSize> Info;
   typedef std::unordered_map<unsigned short, Info> Infos;
   Infos infos;
+
+  /** Hardware performance counters of a stop watch. */
+  struct PerfInfo
+  {
+    Info cycles;
+    Info instructions;
+    Info cacheMisses;
+    Info branchMisses;
+  };
+  typedef std::unordered_map<unsigned short, PerfInfo> PerfInfos;
+  PerfInfos perfInfos; /**< Only filled if the robot measures performance counters. */
+
+  /** The percentiles of a stop watch in the last window the robot summarized (in ms). */
+  struct Summary
+  {
+    unsigned count = 0; /**< The number of frames the stop watch ran in. */
+    float median = 0.f;
+    float percentile95 = 0.f;
+    float percentile99 = 0.f;
+    float maximum = 0.f;
+  };
+  typedef std::unordered_map<unsigned short, Summary> Summaries;
+  Summaries summaries; /**< Only filled if timing summaries are requested. */
   unsigned int timeStamp; /**< The time stamp of the last change. */
 
   /**
@@ -72,6 +95,15 @@ public:
   */
   void getStatistics(const Info& info, float& outMinTime, float& outMaxTime, float& outAvgTime, float& outLastTime) const;
 
+  /**
+  * The function returns averaged hardware performance statistics of a certain stop watch.
+  * @param info Performance counters of the stop watch to query.
+  * @param outIPC The average number of instructions per cycle is returned to this variable.
+  * @param outCacheMisses The cache misses per 1000 instructions are returned to this variable.
+  * @param outBranchMisses The branch misses per 1000 instructions are returned to this variable.
+  */
+  void getPerfStatistics(const PerfInfo& info, float& outIPC, float& outCacheMisses, float& outBranchMisses) const;
+
   /**Returns the frequency of the process attached to this time info.
    */
   void getProcessStatistics(float& outAvgFreq) const;
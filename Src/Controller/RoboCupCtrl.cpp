@@ -178,6 +178,10 @@ void RoboCupCtrl::update()
   gameController.referee();
 
   statusText = "";
+
+  // The threads of all robots already compute their frames concurrently. Each robot only waits
+  // until its own previous motion frame was finished before it exchanges data with the simulation,
+  // which must happen in this thread, because the physics and the rendering are not thread-safe.
   for (std::list<Robot*>::iterator i = robots.begin(); i != robots.end(); ++i)
     (*i)->update();
   if (simTime)
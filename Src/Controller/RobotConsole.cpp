@@ -49,6 +49,29 @@ using namespace std;
   if (!poll(p))         \
     return false;
 
+void RobotConsole::Plot::add(float value, size_t capacity)
+{
+  if (points.size() != capacity)
+  {
+    const size_t numOfKept = std::min(numOfPoints, capacity);
+    std::vector<float> resized(capacity);
+    for (size_t i = 0; i < numOfKept; ++i)
+      resized[i] = (*this)[numOfPoints - numOfKept + i];
+    points.swap(resized);
+    first = 0;
+    numOfPoints = numOfKept;
+  }
+  if (!capacity)
+    return;
+  if (numOfPoints < capacity)
+    points[(first + numOfPoints++) % capacity] = value;
+  else
+  {
+    points[first] = value;
+    first = (first + 1) % capacity;
+  }
+}
+
 bool RobotConsole::MapWriter::handleMessage(InMessage& message)
 {
   ASSERT(message.getMessageID() == idDebugDataResponse);
@@ -208,6 +231,9 @@ bool RobotConsole::handleMessage(InMessage& message)
   if (destructed) // if object is already destroyed, abort here
     return true; // avoid further processing of this message
 
+  if (batchRecorder)
+    batchRecorder->handleMessage(message);
+
   if (message.getMessageID() < numOfDataMessageIDs)
   {
     if (logImagesAsJPEGs && message.getMessageID() == idImage)
@@ -412,9 +438,7 @@ bool RobotConsole::handleMessage(InMessage& message)
     float value;
     message.bin >> id >> value;
     Plot& plot = plots[ctrl->translate(id)];
-    plot.points.push_back(value);
-    while (plot.points.size() > maxPlotSize)
-      plot.points.pop_front();
+    plot.add(value, maxPlotSize);
     plot.timeStamp = SystemCall::getCurrentSystemTime();
     return true;
   }
@@ -543,6 +567,8 @@ bool RobotConsole::handleMessage(InMessage& message)
     annotationInfos[processIdentifier == 'd' ? 'c' : processIdentifier].handleMessage(message, frame);
     return true;
   case idStopwatch:
+  case idPerfCounters:
+  case idTimingSummary:
     ASSERT(timeInfos.find(processIdentifier == 'd' ? 'c' : processIdentifier) != timeInfos.end());
     timeInfos.at(processIdentifier == 'd' ? 'c' : processIdentifier).handleMessage(message);
     return true;
@@ -650,6 +676,10 @@ bool RobotConsole::handleMessage(InMessage& message)
     message.bin >> robotHealth;
     robotHealthReceived = SystemCall::getCurrentSystemTime();
     return true;
+  case idDebugConnectionStatus:
+    message.bin >> debugConnectionStatus;
+    debugConnectionStatusReceived = SystemCall::getCurrentSystemTime();
+    return true;
   case idMotionRequest:
     message.bin >> motionRequest;
     motionRequestReceived = SystemCall::getCurrentSystemTime();
@@ -1442,6 +1472,15 @@ bool RobotConsole::log(In& stream, bool first)
     std::string param;
     stream >> param;
 
+    // the logged representations of these modules are still computed, so that they can be benchmarked on the logged data
+    std::set<std::string> replayedModules;
+    for (std::string module = param == "list" ? "" : param; !module.empty(); module.clear(), stream >> module)
+    {
+      if (std::find(moduleInfo.modules.begin(), moduleInfo.modules.end(), module) == moduleInfo.modules.end())
+        return false;
+      replayedModules.insert(module);
+    }
+
     int upperFrequencies[numOfDataMessageIDs];
     int lowerFrequencies[numOfDataMessageIDs];
     int motionFrequencies[numOfDataMessageIDs];
@@ -1461,6 +1500,16 @@ bool RobotConsole::log(In& stream, bool first)
           representation = "Image";
         if (representation == "JPEGImageUpper" || representation == "LowFrameRateImageUpper" || representation == "ThumbnailUpper" || representation == "YoloInputUpper") // || representation == "SequenceImageUpper"
           representation = "ImageUpper";
+        const auto replayedModule = std::find_if(moduleInfo.modules.begin(), moduleInfo.modules.end(),
+            [&](const ModuleInfo::Module& module)
+            {
+              return replayedModules.count(module.name) && std::find(module.representations.begin(), module.representations.end(), representation) != module.representations.end();
+            });
+        if (replayedModule != moduleInfo.modules.end())
+        {
+          commands.push_back(representation + " " + replayedModule->name);
+          continue;
+        }
         bool inCognition = cLog != moduleInfo.modules.end() && std::find(cLog->representations.begin(), cLog->representations.end(), representation) != cLog->representations.end()
             && (upperFrequencies[i] || lowerFrequencies[i]);
         bool inMotion = mLog != moduleInfo.modules.end() && std::find(mLog->representations.begin(), mLog->representations.end(), representation) != mLog->representations.end()
@@ -1490,9 +1539,9 @@ bool RobotConsole::log(In& stream, bool first)
     SYNC;
     if (command == "load")
     {
-      std::string name;
-      stream >> name;
-      if (name.size() == 0)
+      std::string name, option;
+      stream >> name >> option;
+      if (name.size() == 0 || (option != "" && option != "lazy"))
         return false;
       else
       {
@@ -1502,9 +1551,10 @@ bool RobotConsole::log(In& stream, bool first)
           name = std::string("Logs\\") + name;
         logFile = name;
         LogPlayer::LogPlayerState state = logPlayer.state;
-        bool result = logPlayer.open(name.c_str());
+        bool result = logPlayer.open(name.c_str(), option == "lazy");
         if (result)
-          logPlayer.handleAllMessages(annotationInfos['c']);
+          for (auto& [processIdentifier, annotationInfo] : annotationInfos)
+            annotationInfo.add(logPlayer.annotations[processIdentifier]);
         if (result && state == LogPlayer::playing)
           logPlayer.play();
         return result;
@@ -1599,6 +1649,40 @@ bool RobotConsole::log(In& stream, bool first)
       }
       return true;
     }
+    else if (command == "sync")
+    {
+      std::string opt;
+      stream >> opt;
+      if (opt == "off")
+        logPlayer.leaveTeam();
+      else if (opt == "")
+        logPlayer.joinTeam();
+      else
+        return false;
+      return true;
+    }
+    else if (command == "time")
+    {
+      std::string time;
+      stream >> time;
+      if (time == "")
+      {
+        ctrl->printLn("Time " + std::to_string(logPlayer.getTime()) + " ms, frame " + std::to_string(logPlayer.currentFrameNumber + 1));
+        return true;
+      }
+      LogPlayer::LogPlayerState state = logPlayer.state;
+      logPlayer.gotoTime(atoi(time.c_str()));
+      if (state == LogPlayer::playing)
+        logPlayer.play();
+      return true;
+    }
+    else if (command == "offset")
+    {
+      int offset = 0;
+      stream >> offset;
+      logPlayer.setTimeOffset(offset);
+      return true;
+    }
     else if (command == "export")
     {
       std::string name, par;
@@ -1620,6 +1704,27 @@ bool RobotConsole::log(In& stream, bool first)
         return true;
       }
     }
+    else if (command == "exportColumns")
+    {
+      std::string directory, par;
+      std::list<std::string> ids;
+      stream >> directory;
+
+      while (!stream.eof())
+      {
+        stream >> par;
+        ids.push_back(par);
+      }
+
+      if (directory.size() == 0)
+        return false;
+      const int filesWritten = logPlayer.exportColumns(directory, ids);
+      if (filesWritten < 0)
+        ctrl->printLn("The log file contains no stream specification.");
+      else
+        ctrl->printLn(std::to_string(filesWritten) + " files written.");
+      return true;
+    }
   }
   return false;
 }
@@ -2950,6 +3055,54 @@ void RobotConsole::handleKeyEvent(int key, bool pressed)
     ctrl->executeConsoleCommand(joystickButtonCommand[key], this);
 }
 
+bool RobotConsole::startBatch(const std::string& directory, const std::vector<std::string>& representations)
+{
+  std::vector<MessageID> ids;
+  for (const std::string& representation : representations)
+  {
+    int i;
+    for (i = 1; i < numOfDataMessageIDs; ++i)
+      if (representation == ::getName(MessageID(i)) + 2) // skip "id"
+        break;
+    if (i == numOfDataMessageIDs)
+    {
+      ctrl->printLn(representation + " is not a representation with a message id!");
+      return false;
+    }
+    ids.push_back(MessageID(i));
+  }
+
+  SYNC;
+  batchRecorder = std::make_unique<BatchRecorder>(directory, ids);
+  for (const std::string& representation : representations)
+  {
+    debugOut.out.bin << DebugRequest("representation:" + representation, true);
+    debugOut.out.finishMessage(idDebugRequest);
+  }
+  debugOut.out.bin << DebugRequest("representation:FrameInfo", true);
+  debugOut.out.finishMessage(idDebugRequest);
+  debugOut.out.bin << DebugRequest("automated requests:StreamSpecification", true);
+  debugOut.out.finishMessage(idDebugRequest);
+  logPlayer.setLoop(false);
+  logPlayer.stop();
+  logPlayer.play();
+  return true;
+}
+
+void RobotConsole::updateBatch()
+{
+  if (batchRecorder && logAcknowledged && logPlayer.state != LogPlayer::playing)
+  {
+    char buf[33];
+    sprintf(buf, "%u", static_cast<unsigned>(batchRecorder->getNumberOfRecords()));
+    if (batchRecorder->write(streamHandler))
+      ctrl->printLn(robotName.toUtf8().constData() + std::string(": batch finished, ") + buf + " records written");
+    else
+      ctrl->printLn(robotName.toUtf8().constData() + std::string(": batch finished, but the records could not be written"));
+    batchRecorder.reset();
+  }
+}
+
 std::string RobotConsole::getPathForRepresentation(const std::string& representation)
 {
   // Check where the file has to be placed. Search order:
@@ -30,11 +30,13 @@
 #include "Representations/MotionControl/MotionRequest.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/GoalPercept.h"
+#include "Tools/Debugging/DebugConnectionStatus.h"
 #include "Tools/Debugging/DebugDrawings3D.h"
 #include "Tools/Debugging/DebugImages.h"
 #include "Tools/ProcessFramework/Process.h"
 
 #include "AudioPlayer.h"
+#include "BatchRecorder.h"
 #include "LogPlayer.h" // Must be included after Process.h
 #include "Platform/Joystick.h"
 #include "Representations/AnnotationInfo.h"
@@ -123,6 +125,7 @@ protected:
   DrawingManager3D drawingManager3D;
   DebugRequestTable debugRequestTable;
   AudioPlayer audioPlayer;
+  std::unique_ptr<BatchRecorder> batchRecorder; /**< Records representations while the log file is replayed in batch mode. */
   const char* pollingFor = nullptr; /**< The information the console is waiting for. */
   JointRequest jointRequest; /**< The joint angles request received from the robot code. */
   JointSensorData jointSensorData; /**< The most current set of joint angles received from the robot code. */
@@ -164,6 +167,8 @@ protected:
   unsigned teamBallModelReceived = 0; /**< When was the team ball model received from team communication. */
   unsigned teamPlayersModelReceived = 0; /**< When was the team players model received from team communication. */
   unsigned isUprightReceived = 0; /**< When was the fall down state received from team communication. */
+  DebugConnectionStatus debugConnectionStatus; /**< The state of the debug connection measured by the robot. */
+  unsigned debugConnectionStatusReceived = 0; /**< When was the state of the debug connection received. */
   int mrCounter = 0; /**< Counts the number of mr commands. */
   JointCalibration jointCalibration; /**< The joint calibration received from the robot code. */
   RobotDimensions robotDimensions; /**< The robotDimensions received from the robot code. */
@@ -203,10 +208,28 @@ public:
   Drawings* currentFieldDrawings = nullptr;
   Drawings3D* currentDrawings3D = nullptr;
 
+  /** The data points of a plot. They are stored in a ring buffer that holds up to maxPlotSize entries. */
   struct Plot
   {
-    std::list<float> points;
+    std::vector<float> points; /**< The ring buffer. Its size is its capacity. */
+    size_t first = 0; /**< The index of the oldest data point in the ring buffer. */
+    size_t numOfPoints = 0; /**< The number of data points in the ring buffer. */
     unsigned timeStamp = 0;
+
+    /**
+     * Adds a data point. The oldest one is overwritten if the buffer is full.
+     * @param value The new data point.
+     * @param capacity The number of data points to keep. If it changed, the newest points are preserved.
+     */
+    void add(float value, size_t capacity);
+
+    size_t size() const { return numOfPoints; }
+
+    /**
+     * Accesses a data point.
+     * @param i The index of the data point, starting with the oldest one.
+     */
+    float operator[](size_t i) const { return points[(first + i) % points.size()]; }
   };
 
   typedef std::unordered_map<std::string, Plot> Plots;
@@ -354,6 +377,21 @@ public:
   */
   void handleKeyEvent(int key, bool pressed);
 
+  /**
+  * Replays the log file once from the beginning and records the given
+  * representations into column files.
+  * @param directory The directory the files are written to.
+  * @param representations The names of the representations recorded.
+  * @return Were all representations known?
+  */
+  bool startBatch(const std::string& directory, const std::vector<std::string>& representations);
+
+  /**
+  * The method returns whether a batch replay is still running.
+  * @return Still running?
+  */
+  bool isBatchRunning() const { return batchRecorder != nullptr; }
+
   /**
   * The function must be called to exchange data with SimRobot.
   * It sends the motor commands to SimRobot and acquires new sensor data.
@@ -429,6 +467,12 @@ private:
   */
   void triggerProcesses();
 
+  /**
+  * Writes the recorded representations when the batch replay has finished.
+  * Must be called while this object is synchronized.
+  */
+  void updateBatch();
+
   void addColorSpaceViews(const std::string& id, const std::string& name, bool user, bool upperCam);
 
   /**
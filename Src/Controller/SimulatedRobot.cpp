@@ -63,36 +63,12 @@ void SimulatedRobot::init(SimRobot::Object* robot)
   resStream >> cameraResolution;
 
   // build cameraInfo
-  switch (cameraResolution.resolution)
-  {
-  case CameraResolution::Resolutions::upper640:
-    upperCameraInfo.width = 640;
-    upperCameraInfo.height = 480;
-    lowerCameraInfo.width = 320;
-    lowerCameraInfo.height = 240;
-    break;
-  case CameraResolution::Resolutions::lower640:
-    upperCameraInfo.width = 320;
-    upperCameraInfo.height = 240;
-    lowerCameraInfo.width = 640;
-    lowerCameraInfo.height = 480;
-    break;
-  case CameraResolution::Resolutions::both320:
-    upperCameraInfo.width = 320;
-    upperCameraInfo.height = 240;
-    lowerCameraInfo.width = 320;
-    lowerCameraInfo.height = 240;
-    break;
-  case CameraResolution::Resolutions::both640:
-    upperCameraInfo.width = 640;
-    upperCameraInfo.height = 480;
-    lowerCameraInfo.width = 640;
-    lowerCameraInfo.height = 480;
-    break;
-  default:
-    ASSERT(false);
-    break;
-  }
+  const Vector2i upperSize = CameraResolution::getSize(cameraResolution.resolution, true);
+  const Vector2i lowerSize = CameraResolution::getSize(cameraResolution.resolution, false);
+  upperCameraInfo.width = upperSize.x();
+  upperCameraInfo.height = upperSize.y();
+  lowerCameraInfo.width = lowerSize.x();
+  lowerCameraInfo.height = lowerSize.y();
 
   // set opening angle
   upperCameraInfo.openingAngleWidth = cameraIntrinsics.upperOpeningAngleWidth;
@@ -398,13 +374,15 @@ void SimulatedRobot::getCameraInfo(CameraInfo& cameraInfo)
 void SimulatedRobot::getAndSetJointData(const JointRequest& jointRequest, JointSensorData& jointSensorData) //const
 {
   ASSERT(robot);
+  float noise[Joints::numOfJoints];
+  Random::fillNormal(noise, Joints::numOfJoints);
   for (int i = 0; i < Joints::numOfJoints; ++i)
   {
     // Get angles
     if (jointSensors[i])
     {
       float result = static_cast<SimRobotCore2::SensorPort*>(jointSensors[i])->getValue().floatValue - jointCalibration.joints[i].offset;
-      result += sampleNormalDistribution(noiseParams.joints[i]); //Add noise
+      result += noise[i] * noiseParams.joints[i]; //Add noise
       jointDelayBuffer[i].push_front(result);
       jointSensorData.angles[i] = jointDelayBuffer[i].back();
     }
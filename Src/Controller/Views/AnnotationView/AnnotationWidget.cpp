@@ -91,12 +91,14 @@ AnnotationWidget::AnnotationWidget(AnnotationView& view) : view(view), timeOfLas
   stopCheckBox->setText("Stop on Annotation");
   stopCheckBox->setToolTip("Stops the Simulation if a new Annotation arrives which meets the Filter.");
   stopCheckBox->setChecked(settings.value("StopCheckBoxState").toBool());
+  filterEdit->setToolTip("Shows only annotations containing the text. Press Enter to jump to the next one.");
   layout->addSpacing(2);
   layout->addWidget(stopCheckBox);
   layout->addWidget(table);
   layout->setContentsMargins(QMargins());
   this->setLayout(layout);
   QObject::connect(filterEdit, SIGNAL(textChanged(QString)), this, SLOT(filterChanged(QString)));
+  QObject::connect(filterEdit, SIGNAL(returnPressed()), this, SLOT(jumpToNextMatch()));
   table->horizontalHeader()->restoreState(settings.value("HeaderState").toByteArray());
   table->sortItems(settings.value("SortBy").toInt(), (Qt::SortOrder)settings.value("SortOrder").toInt());
   filter = settings.value("Filter").toString();
@@ -203,3 +205,27 @@ void AnnotationWidget::jumpFrame(int row, int column)
     view.logPlayer.gotoFrame(std::max(std::min(frame - 1, view.logPlayer.numberOfFrames - 1), 0));
   }
 }
+
+void AnnotationWidget::jumpToNextMatch()
+{
+  if (SystemCall::getMode() != SystemCall::Mode::logfileReplay)
+    return;
+
+  // the first annotation shown behind the current frame, starting over at the beginning of the log
+  const int current = view.logPlayer.currentFrameNumber + 1;
+  int next = -1;
+  int first = -1;
+  for (int i = 0; i < table->rowCount(); ++i)
+    if (!table->isRowHidden(i))
+    {
+      const int frame = static_cast<int>(static_cast<NumberTableWidgetItem*>(table->item(i, 0))->number);
+      if (frame > current && (next == -1 || frame < next))
+        next = frame;
+      if (first == -1 || frame < first)
+        first = frame;
+    }
+  if (next == -1)
+    next = first;
+  if (next != -1)
+    view.logPlayer.gotoFrame(std::max(std::min(next - 1, view.logPlayer.numberOfFrames - 1), 0));
+}
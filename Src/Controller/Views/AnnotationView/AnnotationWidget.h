@@ -41,4 +41,5 @@ private:
 private slots:
   void filterChanged(const QString& newFilter);
   void jumpFrame(int row, int column);
+  void jumpToNextMatch();
 };
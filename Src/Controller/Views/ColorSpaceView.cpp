@@ -10,6 +10,8 @@
 #include "ColorSpaceView.h"
 #include "Platform/Thread.h"
 #include "Controller/Visualization/OpenGLMethods.h"
+#include "Tools/ColorModelConversions.h"
+#include <algorithm>
 #ifdef MACOS
 #include <OpenGL/OpenGL.h>
 #include <OpenGL/glu.h>
@@ -66,17 +68,115 @@ void ColorSpaceView::updateDisplayLists()
           int(background.y() * 255) ^ 0xc0,
           int(background.z() * 255) ^ 0xc0);
 
-    OpenGLMethods::paintImagePixelsToOpenGLList(*image, colorModel, channel - 1, false, colorsId);
+    if (channel)
+      updateChannelPoints(*image);
+    else
+      updateColorPoints(*image);
     lastTimeStamp = image->timeStamp;
   }
   else
   {
     glNewList(cubeId, GL_COMPILE_AND_EXECUTE);
     glEndList();
-    glNewList(colorsId, GL_COMPILE_AND_EXECUTE);
-    glEndList();
+    points.clear();
     lastTimeStamp = 0;
   }
+  ++pointsVersion;
+}
+
+void ColorSpaceView::updateColorPoints(const Image& image)
+{
+  constexpr int shift = 8 - binBits;
+  constexpr int center = 1 << shift >> 1;
+  constexpr unsigned mask = (1 << binBits) - 1;
+
+  if (binUsed.empty())
+    binUsed.resize(1 << 3 * binBits, 0);
+  for (unsigned bin : usedBins)
+    binUsed[bin] = 0;
+  usedBins.clear();
+
+  for (int y = 0; y < image.height; ++y)
+  {
+    const Image::Pixel* pixel = image[y];
+    for (const Image::Pixel* end = pixel + image.width; pixel < end; ++pixel)
+    {
+      const unsigned bin = (pixel->y >> shift) << 2 * binBits | (pixel->cb >> shift) << binBits | pixel->cr >> shift;
+      if (!binUsed[bin])
+      {
+        binUsed[bin] = 1;
+        usedBins.push_back(bin);
+      }
+    }
+  }
+
+  const float scale = 2.f / 255.f;
+  points.resize(usedBins.size());
+  Point* point = points.data();
+  for (unsigned bin : usedBins)
+  {
+    const unsigned char y = static_cast<unsigned char>((bin >> 2 * binBits) << shift | center);
+    const unsigned char cb = static_cast<unsigned char>(((bin >> binBits) & mask) << shift | center);
+    const unsigned char cr = static_cast<unsigned char>((bin & mask) << shift | center);
+    ColorModelConversions::fromYCbCrToRGB(y, cb, cr, point->r, point->g, point->b);
+    point->a = 255;
+
+    // The axes are the same as the ones of OpenGLMethods::paintImagePixelsToOpenGLList.
+    unsigned char axes[3];
+    switch (colorModel)
+    {
+    case RGB:
+      axes[0] = point->b;
+      axes[1] = point->r;
+      axes[2] = point->g;
+      break;
+    case HSI:
+      ColorModelConversions::fromYCbCrToHSI(y, cb, cr, axes[1], axes[2], axes[0]);
+      break;
+    default:
+      axes[0] = cr;
+      axes[1] = cb;
+      axes[2] = y;
+    }
+    point->x = -1.f + axes[0] * scale;
+    point->y = -1.f + axes[1] * scale;
+    point->z = -1.f + axes[2] * scale;
+    ++point;
+  }
+}
+
+void ColorSpaceView::updateChannelPoints(const Image& image)
+{
+  Image rgbImage(false);
+  rgbImage.convertFromYCbCrToRGB(image);
+
+  const Image* convertedImage = &image;
+  Image hsiImage(false);
+  if (colorModel == RGB)
+    convertedImage = &rgbImage;
+  else if (colorModel == HSI)
+  {
+    hsiImage.convertFromYCbCrToHSI(image);
+    convertedImage = &hsiImage;
+  }
+
+  const float scale = 2.f / 255.f;
+  const int zComponent = channel - 1;
+  points.resize(std::max(image.width - 2, 0) * std::max(image.height - 2, 0));
+  Point* point = points.data();
+  for (int y = 0; y < image.height - 2; ++y)
+    for (int x = 0; x < image.width - 2; ++x)
+    {
+      const Image::Pixel& rgb = rgbImage[y][x];
+      point->x = static_cast<float>(x - image.width / 2) * scale;
+      point->y = static_cast<float>(-y + image.height / 2) * scale;
+      point->z = -0.5f + (*convertedImage)[y][x].channels[zComponent] * scale / 2.f;
+      point->r = rgb.r;
+      point->g = rgb.g;
+      point->b = rgb.b;
+      point->a = 255;
+      ++point;
+    }
 }
 
 bool ColorSpaceView::needsUpdate() const
@@ -12,6 +12,7 @@
 #include "Tools/Enum.h"
 
 class RobotConsole;
+struct Image;
 
 /**
 * @class ColorSpaceView
@@ -76,10 +77,29 @@ protected:
   virtual float getViewDistance() const { return channel ? 5.0f : 8.0f; }
 
 private:
+  static constexpr int binBits = 7; /**< The number of bits per channel distinguished when colors are collected. */
+
+  /**
+  * Fills the points with one point per color bin that occurs in the image.
+  * Only the bins used by the previous image are reset, so the cost only
+  * depends on the size of the image and not on the size of the color space.
+  * @param image The image in YCbCr.
+  */
+  void updateColorPoints(const Image& image);
+
+  /**
+  * Fills the points with one point per pixel of the image. Its height is
+  * the value of the channel displayed.
+  * @param image The image in YCbCr.
+  */
+  void updateChannelPoints(const Image& image);
+
   RobotConsole& console; /**< A reference to the console object. */
   std::string name; /**< The name of the image. */
   ColorModel colorModel; /**< The color model in which the image should be displayed by this view. */
   int channel; /**< The channel to display (1..3) or 0 to display all channels. */
   unsigned lastTimeStamp; /**< The frame number of last image that was drawn. */
   bool upperCam;
+  std::vector<unsigned char> binUsed; /**< Whether a color bin occurs in the current image. */
+  std::vector<unsigned> usedBins; /**< The indices of all color bins that occur in the current image. */
 };
@@ -10,6 +10,7 @@
 #include "PropertyTreeWriter.h"
 #include "Tools/Debugging/DebugDataStreamer.h"
 #include "Tools/MessageQueue/InMessage.h"
+#include "Tools/Streams/InStreams.h"
 
 #include <QEvent>
 
@@ -27,8 +28,17 @@ bool DataView::handleMessage(InMessage& msg, const std::string& type, const std:
       update)
   {
     update = false;
+
+    // most data does not change in every frame, so parsing it and updating the properties is skipped then
+    std::string data(msg.getBytesLeft(), 0);
+    msg.bin.read(&data[0], data.size());
+    if (data == theShownData && type == this->type)
+      return true;
+    theShownData.swap(data);
+
     PropertyTreeCreator creator(*this);
-    DebugDataStreamer streamer(theStreamHandler, msg.bin, type, "value");
+    InBinaryMemory stream(theShownData.data(), theShownData.size());
+    DebugDataStreamer streamer(theStreamHandler, stream, type, "value");
     creator << streamer;
     pTheCurrentRootNode = creator.root;
     this->type = type;
@@ -81,12 +91,14 @@ void DataView::removeWidget()
   SYNC;
   pTheWidget = nullptr;
   theProperties.clear();
+  theShownData.clear();
 }
 
 void DataView::setIgnoreUpdates(bool value)
 {
   SYNC;
   theIgnoreUpdatesFlag = value;
+  theShownData.clear(); // edits must be replaced by the data received
 }
 
 void DataView::setUnchanged()
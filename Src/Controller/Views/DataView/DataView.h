@@ -139,6 +139,7 @@ private:
   PropertiesMapType theProperties;
 
   bool update = false; /**< If the view should be updated. */
+  std::string theShownData; /**< The data currently shown. Messages with the same data are not parsed again. */
 
   /**
    * True if auto-set is enabled.
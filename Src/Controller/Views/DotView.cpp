@@ -6,6 +6,8 @@
 
 #include <QGraphicsSvgItem>
 #include <QGraphicsRectItem>
+#include <QSvgRenderer>
+#include <QRegularExpression>
 #include <QPinchGesture>
 #include <QWheelEvent>
 #include <QDir>
@@ -57,15 +59,20 @@ void DotViewWidget::saveLayout()
   settings.endGroup();
 }
 
-bool DotViewWidget::openSvgFile(const QString& fileName)
+bool DotViewWidget::openSvg(const QByteArray& svg)
 {
   QGraphicsScene* s = scene();
   s->clear();
+  svgItem = nullptr;
+  delete svgRenderer;
+  svgRenderer = new QSvgRenderer(svg, this);
 
-  QGraphicsSvgItem* svgItem = new QGraphicsSvgItem(fileName);
-  if (!svgItem->boundingRect().isValid())
+  svgItem = new QGraphicsSvgItem;
+  svgItem->setSharedRenderer(svgRenderer);
+  if (!svgRenderer->isValid() || !svgItem->boundingRect().isValid())
   {
     delete svgItem;
+    svgItem = nullptr;
     return false;
   }
   svgItem->setFlags(QGraphicsItem::ItemClipsToShape);
@@ -155,19 +162,23 @@ bool DotViewWidget::convertDotFile(const QString& fmt, const QString& src, const
   return exitCode != 0;
 }
 
-bool DotViewWidget::openDotFile(const QString& fileName)
+QByteArray DotViewWidget::layoutDotFile(const QString& fileName)
 {
   // convert dot file into svg
   const QString svgFileName = QDir::temp().filePath("DotView.svg");
   QString cmd = builtDotCommand("svg", fileName, svgFileName);
   int exitCode = QProcess::execute(cmd);
   if (exitCode != 0)
-    return false;
+    return QByteArray();
 
   // load svg file
-  bool result = openSvgFile(svgFileName);
+  QByteArray svg;
+  QFile svgFile(svgFileName);
+  if (svgFile.open(QIODevice::ReadOnly))
+    svg = svgFile.readAll();
+  svgFile.close();
   QFile::remove(svgFileName);
-  return result;
+  return svg;
 }
 
 bool DotViewWidget::saveDotFileContent(const QString& content, const QString& fileName)
@@ -188,22 +199,74 @@ bool DotViewWidget::openDotFileContent(const QString& content)
   if (content.isEmpty())
     return false;
 
-  // generate dot file
-  const QString dotFileName = QDir::temp().filePath("DotView.dot");
-  if (!saveDotFileContent(content, dotFileName))
-    return false;
+  // The layout only depends on the content, so graphs shown before are not laid out again.
+  auto cached = layouts.constFind(content);
+  if (cached == layouts.constEnd())
+  {
+    // generate dot file
+    const QString dotFileName = QDir::temp().filePath("DotView.dot");
+    if (!saveDotFileContent(content, dotFileName))
+      return false;
+
+    // lay out dot fiile
+    const QByteArray svg = layoutDotFile(dotFileName);
+    QFile::remove(dotFileName);
+    if (svg.isEmpty())
+      return false;
+
+    if (layouts.size() >= maxNumOfLayouts)
+      layouts.clear();
+    cached = layouts.insert(content, svg);
+  }
 
-  // open dot fiile
-  bool result = openDotFile(dotFileName);
-  QFile::remove(dotFileName);
-  return result;
+  if (svgItem && *cached == layout)
+  {
+    updateNodeColors();
+    return true;
+  }
+  layout = *cached;
+  return openSvg(applyNodeColors());
+}
+
+QByteArray DotViewWidget::applyNodeColors() const
+{
+  const QHash<QString, QColor> colors = dotViewObject.getNodeColors();
+  if (colors.isEmpty())
+    return layout;
+
+  // dot writes the title of a node right before the shape that is filled.
+  static const QRegularExpression nodeShape("<title>([^<]*)</title>\\s*<(?:polygon|ellipse|path) fill=\"([^\"]*)\"");
+  const QString svg = QString::fromUtf8(layout);
+  QString result;
+  result.reserve(svg.size());
+  qsizetype copied = 0;
+  for (QRegularExpressionMatchIterator i = nodeShape.globalMatch(svg); i.hasNext();)
+  {
+    const QRegularExpressionMatch match = i.next();
+    const auto color = colors.constFind(match.captured(1));
+    if (color == colors.constEnd())
+      continue;
+    result += QStringView(svg).mid(copied, match.capturedStart(2) - copied);
+    result += color->name();
+    copied = match.capturedEnd(2);
+  }
+  result += QStringView(svg).mid(copied);
+  return result.toUtf8();
 }
 
 void DotViewWidget::update()
 {
-  if (!dotViewObject.hasChanged())
-    return;
-  openDotFileContent(dotViewObject.generateDotFileContent());
+  if (dotViewObject.hasChanged())
+    openDotFileContent(dotViewObject.generateDotFileContent());
+  else if (svgItem && dotViewObject.hasHighlightingChanged())
+    updateNodeColors();
+}
+
+void DotViewWidget::updateNodeColors()
+{
+  // The size of the graph does not change, so the scroll and zoom state is kept.
+  svgRenderer->load(applyNodeColors());
+  svgItem->update();
 }
 
 QString DotViewWidget::builtDotCommand(const QString& fmt, const QString& src, const QString& dest) const
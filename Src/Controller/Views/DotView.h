@@ -8,9 +8,14 @@
 
 #include <QString>
 #include <QIcon>
+#include <QColor>
+#include <QHash>
 #include <QGraphicsView>
 #include <SimRobot.h>
 
+class QGraphicsSvgItem;
+class QSvgRenderer;
+
 /**
 * A scene graph object for SimRobot that can be used to open the widget
 */
@@ -36,6 +41,19 @@ protected:
   */
   virtual QString generateDotFileContent() = 0;
 
+  /**
+  * Checks whether the colors returned from a \c getNodeColors call have changed.
+  * In contrast to a change of the content, this does not require a new layout.
+  * @return \c true When \c getNodeColors will return something new
+  */
+  virtual bool hasHighlightingChanged() { return false; }
+
+  /**
+  * Returns fill colors that replace the ones of the nodes in the dot graph
+  * @return The colors per node name. Nodes not contained keep their color.
+  */
+  virtual QHash<QString, QColor> getNodeColors() { return QHash<QString, QColor>(); }
+
 private:
   const QString fullName; /**< The path name to this object in the the scene graph */
   const QIcon icon; /**< The icon used to list this view in the scene graph */
@@ -79,7 +97,13 @@ public:
   virtual void saveLayout();
 
 private:
+  static constexpr int maxNumOfLayouts = 16; /**< The number of layouts kept before the cache is emptied */
+
   DotViewObject& dotViewObject; /**< The DotViewObject that created this widget */
+  QHash<QString, QByteArray> layouts; /**< The svg layouts of the dot graph file contents shown recently */
+  QByteArray layout; /**< The svg layout of the graph currently shown, before the node colors were applied */
+  QGraphicsSvgItem* svgItem = nullptr; /**< The item that shows the graph */
+  QSvgRenderer* svgRenderer = nullptr; /**< The renderer of the item that shows the graph */
 
   /**
   * Destructor; saves the scroll and zoom state and destroys the widget
@@ -110,26 +134,39 @@ private:
   virtual QMenu* createUserMenu() const;
 
   /**
-  * Loads and displays a svg from a file
-  * @param fileName The path of the file
-  * @return Whether the file was loaded successfully
+  * Displays a svg
+  * @param svg The content of the svg file
+  * @return Whether the svg was loaded successfully
   */
-  bool openSvgFile(const QString& fileName);
+  bool openSvg(const QByteArray& svg);
 
   /**
-  * Loads and displays a dot graph from a file
+  * Lays out a dot graph from a file
   * @param fileName The path of the file
-  * @return Whether the file was loaded successfully
+  * @return The content of the resulting svg file. It is empty if the layout failed.
   */
-  bool openDotFile(const QString& fileName);
+  QByteArray layoutDotFile(const QString& fileName);
 
   /**
-  * Loads and displays a dot graph from a string
-  * @param fileName The path of the file
-  * @return Whether the file was loaded successfully
+  * Displays a dot graph from a string. The layout is only computed if the
+  * same content was not shown recently.
+  * @param content The content of the dot graph file
+  * @return Whether the graph was loaded successfully
   */
   bool openDotFileContent(const QString& content);
 
+  /**
+  * Replaces the fill colors of the nodes in the current layout by the ones
+  * of \c DotViewObject::getNodeColors
+  * @return The content of the svg file with the colors applied
+  */
+  QByteArray applyNodeColors() const;
+
+  /**
+  * Shows the current layout with the current node colors
+  */
+  void updateNodeColors();
+
   /**
   * Saves a dot graph
   * @param fileName The path of the file to save the dot graph in
@@ -18,6 +18,7 @@
 
 #include "Controller/RobotConsole.h"
 #include "Controller/RoboCupCtrl.h"
+#include "Controller/Visualization/DrawingCache.h"
 #include "Controller/Visualization/PaintMethods.h"
 #include "Representations/Configuration/FieldDimensions.h"
 #include "Platform/Thread.h"
@@ -61,6 +62,8 @@ private:
   FieldView& fieldView;
   unsigned int lastDrawingsTimeStamp;
   QPainter painter;
+  DrawingCache drawingCache; /**< Keeps the drawings that did not change rasterized. */
+  std::vector<const DebugDrawing*> drawingsToPaint; /**< The drawings of the current paint event in painting order. */
   FieldDimensions fieldDimensions; /**< The field dimensions. */
   float scale;
   float zoom;
@@ -94,22 +97,22 @@ private:
 
   void paintDrawings(QPainter& painter)
   {
-    const QTransform baseTrans(painter.transform());
     const std::list<std::string>& drawings(fieldView.console.fieldViews[fieldView.name]);
+    drawingsToPaint.clear();
     for (std::list<std::string>::const_iterator i = drawings.begin(), end = drawings.end(); i != end; ++i)
     {
       const DebugDrawing& debugDrawingCam(fieldView.console.camFieldDrawings[*i]);
-      PaintMethods::paintDebugDrawing(painter, debugDrawingCam, baseTrans);
+      drawingsToPaint.push_back(&debugDrawingCam);
       if (debugDrawingCam.timeStamp > lastDrawingsTimeStamp)
         lastDrawingsTimeStamp = debugDrawingCam.timeStamp;
 
       const DebugDrawing& debugDrawingMotion(fieldView.console.motionFieldDrawings[*i]);
-      PaintMethods::paintDebugDrawing(painter, debugDrawingMotion, baseTrans);
+      drawingsToPaint.push_back(&debugDrawingMotion);
       if (debugDrawingMotion.timeStamp > lastDrawingsTimeStamp)
         lastDrawingsTimeStamp = debugDrawingMotion.timeStamp;
     }
 
-    painter.setTransform(baseTrans);
+    drawingCache.paint(painter, drawingsToPaint);
   }
 
   bool needsRepaint() const
@@ -63,11 +63,64 @@ ImageWidget::~ImageWidget()
 
   if (imageData)
     delete imageData;
+
+  makeCurrent();
+  if (texture)
+    glDeleteTextures(1, &texture);
+  yCbCrProgram.reset();
+  doneCurrent();
 }
 
-void ImageWidget::paintEvent(QPaintEvent* event)
+void ImageWidget::initializeGL()
+{
+  initializeOpenGLFunctions();
+
+  // The texel of a pixel contains (y of the first half, cb, y, cr). The conversion is the one of copyImage.
+  yCbCrProgram = std::make_unique<QOpenGLShaderProgram>();
+  const bool compiled = yCbCrProgram->addShaderFromSourceCode(QOpenGLShader::Vertex,
+                                                              "#version 120\n"
+                                                              "attribute vec2 position;\n"
+                                                              "attribute vec2 texCoord;\n"
+                                                              "varying vec2 coord;\n"
+                                                              "void main()\n"
+                                                              "{\n"
+                                                              "  coord = texCoord;\n"
+                                                              "  gl_Position = vec4(position, 0.0, 1.0);\n"
+                                                              "}\n")
+                        && yCbCrProgram->addShaderFromSourceCode(QOpenGLShader::Fragment,
+                                                                 "#version 120\n"
+                                                                 "uniform sampler2D image;\n"
+                                                                 "uniform float gain;\n"
+                                                                 "varying vec2 coord;\n"
+                                                                 "void main()\n"
+                                                                 "{\n"
+                                                                 "  vec4 pixel = texture2D(image, coord);\n"
+                                                                 "  float cb = pixel.g - 128.0 / 255.0;\n"
+                                                                 "  float cr = pixel.a - 128.0 / 255.0;\n"
+                                                                 "  vec3 rgb = vec3(pixel.b + 1.40210 * cr, pixel.b - 0.34558 * cb - 0.71448 * cr, pixel.b + 1.77100 * cb);\n"
+                                                                 "  gl_FragColor = vec4(clamp(clamp(rgb, 0.0, 1.0) * gain, 0.0, 1.0), 1.0);\n"
+                                                                 "}\n");
+  yCbCrProgram->bindAttributeLocation("position", 0);
+  yCbCrProgram->bindAttributeLocation("texCoord", 1);
+  if (!compiled || !yCbCrProgram->link())
+  {
+    yCbCrProgram.reset();
+    return;
+  }
+
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void ImageWidget::paintGL()
 {
   painter.begin(this);
+  painter.fillRect(rect(), palette().window());
   paint(painter);
   painter.end();
 }
@@ -102,7 +155,15 @@ void ImageWidget::paint(QPainter& painter)
   painter.setTransform(QTransform(scale, 0, 0, scale, imageXOffset, imageYOffset));
 
   if (image)
-    paintImage(painter, *image);
+  {
+    if (yCbCrProgram)
+    {
+      paintImageGL(painter, *image);
+      lastImageTimeStamp = image->timeStamp;
+    }
+    else
+      paintImage(painter, *image);
+  }
   else
     lastImageTimeStamp = 0;
 
@@ -120,15 +181,15 @@ void ImageWidget::saveLayout()
 
 void ImageWidget::paintDrawings(QPainter& painter)
 {
-  const QTransform baseTrans = painter.transform();
   const std::list<std::string>& drawings = imageView.console.imageViews[imageView.name];
+  drawingsToPaint.clear();
   for (const std::string& drawing : drawings)
   {
     auto& camDrawings = imageView.console.camImageDrawings;
     auto debugDrawing = camDrawings.find(drawing);
     if (debugDrawing != camDrawings.end())
     {
-      PaintMethods::paintDebugDrawing(painter, debugDrawing->second, baseTrans);
+      drawingsToPaint.push_back(&debugDrawing->second);
       if (debugDrawing->second.timeStamp > lastDrawingsTimeStamp)
         lastDrawingsTimeStamp = debugDrawing->second.timeStamp;
     }
@@ -136,12 +197,12 @@ void ImageWidget::paintDrawings(QPainter& painter)
     debugDrawing = motinoDrawings.find(drawing);
     if (debugDrawing != motinoDrawings.end())
     {
-      PaintMethods::paintDebugDrawing(painter, debugDrawing->second, baseTrans);
+      drawingsToPaint.push_back(&debugDrawing->second);
       if (debugDrawing->second.timeStamp > lastDrawingsTimeStamp)
         lastDrawingsTimeStamp = debugDrawing->second.timeStamp;
     }
   }
-  painter.setTransform(baseTrans);
+  drawingCache.paint(painter, drawingsToPaint);
 }
 
 void ImageWidget::copyImage(const Image& srcImage)
@@ -204,6 +265,58 @@ void ImageWidget::paintImage(QPainter& painter, const Image& srcImage)
   painter.drawImage(QRectF(0, 0, imageWidth, imageHeight), *imageData);
 }
 
+void ImageWidget::paintImageGL(QPainter& painter, const Image& srcImage)
+{
+  painter.beginNativePainting();
+
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  if (srcImage.timeStamp != lastTextureTimeStamp || srcImage.width != textureWidth || srcImage.height != textureHeight)
+  {
+    // only the first half of each row belongs to the image
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, srcImage.widthStep);
+    if (srcImage.width != textureWidth || srcImage.height != textureHeight)
+    {
+      textureWidth = srcImage.width;
+      textureHeight = srcImage.height;
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, srcImage[0]);
+    }
+    else
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, textureWidth, textureHeight, GL_RGBA, GL_UNSIGNED_BYTE, srcImage[0]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    lastTextureTimeStamp = srcImage.timeStamp;
+  }
+
+  // the corners of the image are transformed like the drawings and then mapped to normalized device coordinates
+  const QTransform& transform = painter.transform();
+  const QPointF corners[4] = {transform.map(QPointF(0, 0)), transform.map(QPointF(imageWidth, 0)),
+                              transform.map(QPointF(0, imageHeight)), transform.map(QPointF(imageWidth, imageHeight))};
+  GLfloat positions[8];
+  for (int i = 0; i < 4; ++i)
+  {
+    positions[i * 2] = static_cast<GLfloat>(2. * corners[i].x() / width() - 1.);
+    positions[i * 2 + 1] = static_cast<GLfloat>(1. - 2. * corners[i].y() / height());
+  }
+  static const GLfloat texCoords[8] = {0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f};
+
+  glDisable(GL_BLEND);
+  yCbCrProgram->bind();
+  yCbCrProgram->setUniformValue("image", 0);
+  yCbCrProgram->setUniformValue("gain", imageView.gain);
+  glEnableVertexAttribArray(0);
+  glEnableVertexAttribArray(1);
+  glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, positions);
+  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  glDisableVertexAttribArray(0);
+  glDisableVertexAttribArray(1);
+  yCbCrProgram->release();
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  painter.endNativePainting();
+}
+
 bool ImageWidget::needsRepaint() const
 {
   SYNC_WITH(imageView.console);
@@ -415,7 +528,7 @@ bool ImageWidget::event(QEvent* event)
       return true;
     }
   }
-  return QWidget::event(event);
+  return QOpenGLWidget::event(event);
 }
 
 void ImageWidget::wheelEvent(QWheelEvent* event)
@@ -475,6 +588,7 @@ void ImageWidget::saveImg()
   {
     QPixmap pixmap(image->width, image->height);
     QPainter painter(&pixmap);
+    lastImageTimeStamp = 0; // the image might only have been uploaded as a texture so far
     paintImage(painter, *image);
     paintDrawings(painter);
     pixmap.save(fileName, "PNG");
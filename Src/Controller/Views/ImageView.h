@@ -14,6 +14,9 @@
 #include <QPainter>
 #include <QApplication>
 #include <QMouseEvent>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLWidget>
 #include <QWidget>
 #include <QSettings>
 #include <QMenu>
@@ -22,10 +25,12 @@
 #include "Tools/Math/Eigen.h"
 #include "Controller/RobotConsole.h"
 #include "Controller/RoboCupCtrl.h"
+#include "Controller/Visualization/DrawingCache.h"
 #include "Controller/Visualization/PaintMethods.h"
 #include "Controller/ImageViewAdapter.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Platform/Thread.h"
+#include <memory>
 
 class RobotConsole;
 class ImageWidget;
@@ -77,7 +82,12 @@ private:
   friend class ImageWidget;
 };
 
-class ImageWidget : public QWidget, public SimRobot::Widget
+/**
+ * The widget shows the camera image as a texture that is converted from YCbCr by a shader,
+ * so the CPU only uploads the raw image. The debug drawings are painted on top with a QPainter.
+ * If the shader cannot be used, the image is converted on the CPU.
+ */
+class ImageWidget : public QOpenGLWidget, protected QOpenGLFunctions, public SimRobot::Widget
 {
   Q_OBJECT
 public:
@@ -88,12 +98,19 @@ public:
 
 private:
   ImageView& imageView;
-  QImage* imageData;
+  QImage* imageData; /**< The image converted on the CPU, which is only used without shader and for saving. */
+  std::unique_ptr<QOpenGLShaderProgram> yCbCrProgram; /**< Converts the texture to RGB or nullptr if not available. */
+  GLuint texture = 0; /**< The camera image uploaded as it is (4 bytes per pixel). */
+  int textureWidth = 0;
+  int textureHeight = 0;
+  unsigned int lastTextureTimeStamp = 0;
   int imageWidth;
   int imageHeight;
   unsigned int lastImageTimeStamp;
   unsigned int lastDrawingsTimeStamp;
   QPainter painter;
+  DrawingCache drawingCache; /**< Keeps the drawings that did not change rasterized. */
+  std::vector<const DebugDrawing*> drawingsToPaint; /**< The drawings of the current paint event in painting order. */
   QPoint dragStart;
   QPoint dragStartOffset;
   QPoint dragPos;
@@ -102,11 +119,19 @@ private:
   QPoint offset;
   bool headControlMode;
 
-  void paintEvent(QPaintEvent* event);
+  void initializeGL();
+  void paintGL();
   virtual void paint(QPainter& painter);
   void paintDrawings(QPainter& painter);
   void copyImage(const Image& srcImage);
   void paintImage(QPainter& painter, const Image& srcImage);
+
+  /**
+   * Uploads the image if it changed and draws it with the shader.
+   * @param painter The painter of the widget, whose transformation is used.
+   * @param srcImage The image.
+   */
+  void paintImageGL(QPainter& painter, const Image& srcImage);
   bool needsRepaint() const;
   void window2viewport(QPoint& point);
   void mouseMoveEvent(QMouseEvent* event);
@@ -7,9 +7,11 @@
 
 #include "ModuleGraphView.h"
 #include "Controller/RobotConsole.h"
+#include "Platform/SystemCall.h"
 
 #include <sstream>
 #include <algorithm>
+#include <unordered_map>
 
 ModuleGraphViewObject::ModuleGraphViewObject(const QString& fullName, RobotConsole& console, char processIdentifier, ModuleBase::Category category)
     : DotViewObject(fullName), console(console), processIdentifier(processIdentifier), category(category), lastModulInfoTimeStamp(0)
@@ -107,6 +109,67 @@ QString ModuleGraphViewObject::generateDotFileContent()
   return success ? QString(stream.str().c_str()) : QString();
 }
 
+bool ModuleGraphViewObject::hasHighlightingChanged()
+{
+  SYNC_WITH(console);
+  const auto timeInfo = console.timeInfos.find(processIdentifier);
+  return timeInfo != console.timeInfos.end() && timeInfo->second.timeStamp != lastTimeInfoTimeStamp
+         && SystemCall::getRealTimeSince(lastHighlightingTime) >= highlightingInterval;
+}
+
+QHash<QString, QColor> ModuleGraphViewObject::getNodeColors()
+{
+  SYNC_WITH(console);
+  lastHighlightingTime = SystemCall::getRealSystemTime();
+  QHash<QString, QColor> colors;
+  const auto timeInfo = console.timeInfos.find(processIdentifier);
+  if (timeInfo == console.timeInfos.end())
+    return colors;
+  const TimeInfo& t = timeInfo->second;
+  lastTimeInfoTimeStamp = t.timeStamp;
+
+  std::unordered_map<std::string, float> stopwatches;
+  for (const auto& [id, info] : t.infos)
+    if (!info.empty())
+      stopwatches[t.getName(id)] = info.average();
+
+  // A module is timed by its own stopwatch if it has a preexecution and by the stopwatches of its representations.
+  const ModuleInfo& m = console.moduleInfo;
+  std::unordered_map<std::string, float> durations;
+  float maxDuration = 0.f;
+  for (const auto& i : m.modules)
+    if (i.processIdentifier == processIdentifier && (category == ModuleBase::numOfCategories || i.category == category))
+    {
+      float duration = 0.f;
+      bool timed = false;
+      if (const auto s = stopwatches.find(i.name); s != stopwatches.end())
+      {
+        duration += s->second;
+        timed = true;
+      }
+      for (const auto& k : m.config.representationProviders)
+        if (k.provider == i.name)
+          if (const auto s = stopwatches.find(k.representation); s != stopwatches.end())
+          {
+            duration += s->second;
+            timed = true;
+          }
+      if (timed)
+      {
+        durations[i.name] = duration;
+        maxDuration = std::max(maxDuration, duration);
+      }
+    }
+
+  // From the default light yellow of unused time to red for the slowest module.
+  for (const auto& [name, duration] : durations)
+  {
+    const float ratio = maxDuration > 0.f ? duration / maxDuration : 0.f;
+    colors[QString::fromStdString(name)] = QColor(255, static_cast<int>(255.f - 191.f * ratio), static_cast<int>(224.f * (1.f - ratio)));
+  }
+  return colors;
+}
+
 std::string ModuleGraphViewObject::compress(const std::string& s) const
 {
   std::string s2(s);
@@ -30,10 +30,14 @@ public:
   ModuleGraphViewObject(const QString& fullName, RobotConsole& console, char processIdentifier, ModuleBase::Category category = static_cast<ModuleBase::Category>(ModuleBase::numOfCategories));
 
 private:
+  static constexpr int highlightingInterval = 500; /**< The minimum time between two updates of the timing colors in ms. */
+
   RobotConsole& console; /**< A reference to the console object. */
   char processIdentifier; /**< The name of the view. */
   ModuleBase::Category category; /**< The category of the modules of this view. If numOfCategories, show all categories. */
   unsigned int lastModulInfoTimeStamp; /**< Module Info timestamp when the image was created. */
+  unsigned lastTimeInfoTimeStamp = 0; /**< Time Info timestamp when the timing colors were determined. */
+  unsigned lastHighlightingTime = 0; /**< The real time when the timing colors were determined. */
 
   /**
   * The method replaces all ' ' by '_'.
@@ -53,4 +57,17 @@ private:
   * @return The content of the dot graph file
   */
   virtual QString generateDotFileContent();
+
+  /**
+  * Checks whether new timing information arrived since the colors were determined
+  * @return \c true When \c getNodeColors will return something new
+  */
+  virtual bool hasHighlightingChanged();
+
+  /**
+  * Colors the modules by their average execution time relative to the slowest module
+  * shown, i.e. it shows the stopwatches of the modules as a heat map.
+  * @return The colors per module name
+  */
+  virtual QHash<QString, QColor> getNodeColors();
 };
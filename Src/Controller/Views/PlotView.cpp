@@ -250,15 +250,54 @@ void PlotWidget::paint(QPainter& painter)
     bool started = false;
     for (std::list<RobotConsole::Layer>::const_iterator i = plotList.begin(), end = plotList.end(); i != end; ++i)
     {
-      const std::list<float>& list = plotView.console.plots[i->layer].points;
-      int numOfPoints = std::min((int)list.size(), (int)plotView.plotSize);
+      const RobotConsole::Plot& plot = plotView.console.plots[i->layer];
+      int numOfPoints = std::min((int)plot.size(), (int)plotView.plotSize);
       if (numOfPoints > 1)
       {
-        std::list<float>::const_iterator k = list.begin();
-        for (int j = plotView.plotSize - numOfPoints; j < int(plotView.plotSize); ++j)
+        // If there are more points than pixel columns, only the minimum and the maximum of each column are drawn.
+        const bool decimate = plotView.plotSize > 2u * plotRect.width();
+        const int firstPoint = (int)plot.size() - numOfPoints;
+        const int firstIndex = plotView.plotSize - numOfPoints;
+        int column = -1;
+        int minIndex = 0;
+        int maxIndex = 0;
+        float minInColumn = 0.f;
+        float maxInColumn = 0.f;
+        const auto addColumn = [&]
         {
-          const float& value(*(k++));
-          plotView.points[j].ry() = value;
+          decimatedPoints.emplace_back(plotSizeF - 1.f - std::min(minIndex, maxIndex), minIndex < maxIndex ? minInColumn : maxInColumn);
+          if (minIndex != maxIndex)
+            decimatedPoints.emplace_back(plotSizeF - 1.f - std::max(minIndex, maxIndex), minIndex < maxIndex ? maxInColumn : minInColumn);
+        };
+        decimatedPoints.clear();
+
+        for (int j = firstIndex; j < int(plotView.plotSize); ++j)
+        {
+          const float value = plot[firstPoint + j - firstIndex];
+          if (!decimate)
+            plotView.points[j].ry() = value;
+          else
+          {
+            const int currentColumn = int(float(j) * float(plotRect.width()) / plotSizeF);
+            if (currentColumn != column)
+            {
+              if (column >= 0)
+                addColumn();
+              column = currentColumn;
+              minIndex = maxIndex = j;
+              minInColumn = maxInColumn = value;
+            }
+            else if (value < minInColumn)
+            {
+              minIndex = j;
+              minInColumn = value;
+            }
+            else if (value > maxInColumn)
+            {
+              maxIndex = j;
+              maxInColumn = value;
+            }
+          }
           if (started && continousMinMax)
           {
             if (value < plotView.minValue)
@@ -278,7 +317,13 @@ void PlotWidget::paint(QPainter& painter)
         QPen pen(QColor(color.r, color.g, color.b));
         pen.setWidth(0);
         painter.setPen(pen);
-        painter.drawPolyline(plotView.points + (plotView.plotSize - numOfPoints), numOfPoints);
+        if (decimate)
+        {
+          addColumn();
+          painter.drawPolyline(decimatedPoints.data(), (int)decimatedPoints.size());
+        }
+        else
+          painter.drawPolyline(plotView.points + (plotView.plotSize - numOfPoints), numOfPoints);
       }
       unsigned int timeStamp = plotView.console.plots[i->layer].timeStamp;
       if (timeStamp > lastTimeStamp)
@@ -337,14 +382,13 @@ void PlotWidget::determineMinMaxValue()
     const std::list<RobotConsole::Layer>& plotList(plotView.console.plotViews[plotView.name]);
     for (std::list<RobotConsole::Layer>::const_iterator i = plotList.begin(), end = plotList.end(); i != end; ++i)
     {
-      const std::list<float>& list = plotView.console.plots[i->layer].points;
-      int numOfPoints = std::min((int)list.size(), (int)plotView.plotSize);
+      const RobotConsole::Plot& plot = plotView.console.plots[i->layer];
+      int numOfPoints = std::min((int)plot.size(), (int)plotView.plotSize);
       if (numOfPoints > 1)
       {
-        std::list<float>::const_iterator k = list.begin();
-        for (int j = plotView.plotSize - numOfPoints; j < int(plotView.plotSize); ++j)
+        for (int j = (int)plot.size() - numOfPoints; j < (int)plot.size(); ++j)
         {
-          const float& value(*(k++));
+          const float value = plot[j];
           if (started)
           {
             if (value < plotView.minValue)
@@ -418,8 +462,7 @@ void PlotWidget::exportAsGnuplot()
     numOfPlots = (int)plotList.size();
     for (std::list<RobotConsole::Layer>::const_iterator i = plotList.begin(), end = plotList.end(); i != end; ++i)
     {
-      const std::list<float>& list = plotView.console.plots[i->layer].points;
-      int curNumOfPoints = std::min((int)list.size(), (int)plotView.plotSize);
+      int curNumOfPoints = std::min((int)plotView.console.plots[i->layer].size(), (int)plotView.plotSize);
       if (curNumOfPoints < numOfPoints)
         numOfPoints = curNumOfPoints;
     }
@@ -435,10 +478,9 @@ void PlotWidget::exportAsGnuplot()
     int currentPlot = 0;
     for (std::list<RobotConsole::Layer>::const_iterator i = plotList.begin(), end = plotList.end(); i != end; ++i, ++currentPlot)
     {
-      const std::list<float>& list = plotView.console.plots[i->layer].points;
-      std::list<float>::const_reverse_iterator k = list.rbegin();
-      for (int j = numOfPoints - 1; j >= 0; --j)
-        data[j][currentPlot] = *(k++);
+      const RobotConsole::Plot& plot = plotView.console.plots[i->layer];
+      for (int j = 0; j < numOfPoints; ++j)
+        data[j][currentPlot] = plot[plot.size() - numOfPoints + j];
     }
   }
 
@@ -13,6 +13,7 @@
 #include <QPainter>
 #include <QIcon>
 #include <string>
+#include <vector>
 #include <SimRobot.h>
 
 class RobotConsole;
@@ -109,6 +110,7 @@ private:
   PlotWidget*& plotWidget;
   unsigned int lastTimeStamp; /**< Timestamp of the last plot drawing. */
   QPainter painter; /**< The painter used for painting the plot. */
+  std::vector<QPointF> decimatedPoints; /**< A buffer for drawing plots that have more points than pixel columns. */
   QPen blackPen;
   QPen grayPen;
 
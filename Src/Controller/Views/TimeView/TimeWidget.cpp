@@ -30,24 +30,36 @@ struct Row
   NumberTableWidgetItem* max;
   NumberTableWidgetItem* avg;
   NumberTableWidgetItem* last;
+  NumberTableWidgetItem* median;
+  NumberTableWidgetItem* percentile95;
+  NumberTableWidgetItem* percentile99;
+  NumberTableWidgetItem* ipc;
+  NumberTableWidgetItem* cacheMisses;
+  NumberTableWidgetItem* branchMisses;
 };
 
 TimeWidget::TimeWidget(TimeView& timeView) : timeView(timeView), lastTimeInfoTimeStamp(0)
 {
   table = new QTableWidget();
-  table->setColumnCount(5);
+  table->setColumnCount(11);
   QStringList headerNames;
   headerNames
       << "Stopwatch"
       << "Min"
       << "Max"
       << "Avg"
-      << "Last";
+      << "Last"
+      << "Median"
+      << "P95"
+      << "P99"
+      << "IPC"
+      << "Cache MPKI"
+      << "Branch MPKI";
   table->setHorizontalHeaderLabels(headerNames);
   table->verticalHeader()->setVisible(false);
   table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
   table->verticalHeader()->setDefaultSectionSize(15);
-  table->horizontalHeader()->setSectionResizeMode(4, QHeaderView::Stretch);
+  table->horizontalHeader()->setSectionResizeMode(10, QHeaderView::Stretch);
   table->setEditTriggers(QAbstractItemView::NoEditTriggers);
   table->setAlternatingRowColors(true);
   table->setSortingEnabled(true);
@@ -140,6 +152,12 @@ void TimeWidget::update()
         currentRow->max = new NumberTableWidgetItem();
         currentRow->min = new NumberTableWidgetItem();
         currentRow->last = new NumberTableWidgetItem();
+        currentRow->median = new NumberTableWidgetItem();
+        currentRow->percentile95 = new NumberTableWidgetItem();
+        currentRow->percentile99 = new NumberTableWidgetItem();
+        currentRow->ipc = new NumberTableWidgetItem();
+        currentRow->cacheMisses = new NumberTableWidgetItem();
+        currentRow->branchMisses = new NumberTableWidgetItem();
         currentRow->name = new QTableWidgetItem();
         const int rowCount = table->rowCount();
         table->setRowCount(rowCount + 1);
@@ -148,14 +166,41 @@ void TimeWidget::update()
         table->setItem(rowCount, 2, currentRow->max);
         table->setItem(rowCount, 3, currentRow->avg);
         table->setItem(rowCount, 4, currentRow->last);
+        table->setItem(rowCount, 5, currentRow->median);
+        table->setItem(rowCount, 6, currentRow->percentile95);
+        table->setItem(rowCount, 7, currentRow->percentile99);
+        table->setItem(rowCount, 8, currentRow->ipc);
+        table->setItem(rowCount, 9, currentRow->cacheMisses);
+        table->setItem(rowCount, 10, currentRow->branchMisses);
         items[i->first] = currentRow;
       }
-      float minTime = -1, maxTime = -1, avgTime = -1, lastTime = -1;
-      timeView.info.getStatistics(i->second, minTime, maxTime, avgTime, lastTime);
-      currentRow->avg->setText(QString::number(avgTime));
-      currentRow->min->setText(QString::number(minTime));
-      currentRow->max->setText(QString::number(maxTime));
-      currentRow->last->setText(QString::number(lastTime));
+      if (!i->second.empty())
+      {
+        float minTime = -1, maxTime = -1, avgTime = -1, lastTime = -1;
+        timeView.info.getStatistics(i->second, minTime, maxTime, avgTime, lastTime);
+        currentRow->avg->setText(QString::number(avgTime));
+        currentRow->min->setText(QString::number(minTime));
+        currentRow->max->setText(QString::number(maxTime));
+        currentRow->last->setText(QString::number(lastTime));
+      }
+      const auto summary = timeView.info.summaries.find(i->first);
+      if (summary != timeView.info.summaries.end())
+      {
+        currentRow->median->setText(QString::number(summary->second.median));
+        currentRow->percentile95->setText(QString::number(summary->second.percentile95));
+        currentRow->percentile99->setText(QString::number(summary->second.percentile99));
+        if (i->second.empty()) // only the summaries are received
+          currentRow->max->setText(QString::number(summary->second.maximum));
+      }
+      const auto perfInfo = timeView.info.perfInfos.find(i->first);
+      if (perfInfo != timeView.info.perfInfos.end())
+      {
+        float ipc = 0.f, cacheMisses = 0.f, branchMisses = 0.f;
+        timeView.info.getPerfStatistics(perfInfo->second, ipc, cacheMisses, branchMisses);
+        currentRow->ipc->setText(QString::number(ipc));
+        currentRow->cacheMisses->setText(QString::number(cacheMisses));
+        currentRow->branchMisses->setText(QString::number(branchMisses));
+      }
       currentRow->name->setText(QString(name.c_str())); //refresh name every time to eliminate unknown
     }
   }
@@ -11,11 +11,13 @@
 #include "View3D.h"
 #include "Controller/RoboCupCtrl.h"
 
+#include <QOpenGLFunctions>
 #include <QOpenGLWidget>
 #include <QMouseEvent>
 #include <QSettings>
+#include <cstddef>
 
-class View3DWidget : public QOpenGLWidget, public SimRobot::Widget
+class View3DWidget : public QOpenGLWidget, protected QOpenGLFunctions, public SimRobot::Widget
 {
 public:
   View3DWidget(View3D& view3D) : view3D(view3D), dragging(false)
@@ -31,6 +33,12 @@ public:
   virtual ~View3DWidget()
   {
     //saveLayout();
+    if (pointsBuffer)
+    {
+      makeCurrent();
+      glDeleteBuffers(1, &pointsBuffer);
+      doneCurrent();
+    }
   }
 
   virtual void saveLayout()
@@ -42,6 +50,8 @@ public:
   }
 
 private:
+  void initializeGL() { initializeOpenGLFunctions(); }
+
   void resizeGL(int newWidth, int newHeight)
   {
     width = newWidth;
@@ -71,6 +81,17 @@ private:
     if (view3D.needsUpdate())
       view3D.updateDisplayLists();
 
+    if (view3D.pointsVersion != uploadedPointsVersion)
+    {
+      if (!pointsBuffer)
+        glGenBuffers(1, &pointsBuffer);
+      glBindBuffer(GL_ARRAY_BUFFER, pointsBuffer);
+      glBufferData(GL_ARRAY_BUFFER, view3D.points.size() * sizeof(View3D::Point), view3D.points.data(), GL_STREAM_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      numOfPoints = static_cast<GLsizei>(view3D.points.size());
+      uploadedPointsVersion = view3D.pointsVersion;
+    }
+
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
     glClearColor(view3D.background.x(), view3D.background.y(), view3D.background.z(), 1.0f);
@@ -88,6 +109,19 @@ private:
     glCallList(view3D.cubeId);
     glCallList(view3D.colorsId);
 
+    if (numOfPoints)
+    {
+      glBindBuffer(GL_ARRAY_BUFFER, pointsBuffer);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_COLOR_ARRAY);
+      glVertexPointer(3, GL_FLOAT, sizeof(View3D::Point), reinterpret_cast<const void*>(offsetof(View3D::Point, x)));
+      glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(View3D::Point), reinterpret_cast<const void*>(offsetof(View3D::Point, r)));
+      glDrawArrays(GL_POINTS, 0, numOfPoints);
+      glDisableClientState(GL_COLOR_ARRAY);
+      glDisableClientState(GL_VERTEX_ARRAY);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     view3D.lastBackground = view3D.background;
   }
 
@@ -159,6 +193,9 @@ private:
   View3D& view3D;
   bool dragging;
   QPoint dragStart;
+  GLuint pointsBuffer = 0; /**< The vertex buffer containing the points of the view. */
+  GLsizei numOfPoints = 0; /**< The number of points in the vertex buffer. */
+  unsigned uploadedPointsVersion = 0; /**< The version of the points in the vertex buffer. */
 };
 
 View3D::View3D(const QString& fullName, const Vector3f& background) : background(background), fullName(fullName), icon(":/Icons/tag_green.png") {}
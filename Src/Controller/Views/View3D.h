@@ -11,6 +11,7 @@
 #include <QString>
 #include <QIcon>
 #include <SimRobot.h>
+#include <vector>
 
 #include "Tools/Math/Eigen.h"
 
@@ -32,9 +33,29 @@ public:
   View3D(const QString& fullName, const Vector3f& background);
 
 protected:
+  /** A colored point that is drawn from a vertex buffer. */
+  struct Point
+  {
+    float x;
+    float y;
+    float z;
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+  };
+
   unsigned int cubeId = 0;
   unsigned int colorsId = 0;
 
+  /**
+  * Points drawn in addition to the display lists. They are uploaded to a vertex
+  * buffer whenever pointsVersion changes, so large point clouds are not compiled
+  * into a display list vertex by vertex.
+  */
+  std::vector<Point> points;
+  unsigned pointsVersion = 0; /**< Incremented whenever the points were changed. */
+
   /**
   * Update the display lists if required.
   */
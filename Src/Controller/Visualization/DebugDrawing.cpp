@@ -31,6 +31,11 @@ const DebugDrawing& DebugDrawing::operator=(const DebugDrawing& other)
   return *this;
 }
 
+bool DebugDrawing::hasSameElements(const DebugDrawing& other) const
+{
+  return usedSize == other.usedSize && (!usedSize || !memcmp(elements, other.elements, usedSize));
+}
+
 const DebugDrawing& DebugDrawing::operator+=(const DebugDrawing& other)
 {
   int offset = usedSize;
@@ -63,6 +63,9 @@ public:
   /** Adds the contents of another debug drawing to this one. */
   const DebugDrawing& operator+=(const DebugDrawing& other);
 
+  /** Whether another debug drawing consists of exactly the same elements. */
+  bool hasSameElements(const DebugDrawing& other) const;
+
   /** Returns the tip text for a certain coordinate (or 0 if none exists). */
   const char* getTip(int& x, int& y) const;
 
@@ -19,6 +19,8 @@
 #include "Platform/SystemCall.h"
 #include "Representations/Configuration/FieldDimensions.h"
 #include "Representations/Configuration/RobotDimensions.h"
+#include <algorithm>
+#include <cmath>
 
 DebugDrawing3D::DebugDrawing3D() : flip(false), robotConsole(0)
 {
@@ -60,6 +62,7 @@ const DebugDrawing3D& DebugDrawing3D::operator+=(const DebugDrawing3D& other)
   cylinders.insert(cylinders.end(), other.cylinders.begin(), other.cylinders.end());
   partDiscs.insert(partDiscs.end(), other.partDiscs.begin(), other.partDiscs.end());
   images.insert(images.end(), other.images.begin(), other.images.end());
+  batchesValid = false;
   return *this;
 }
 
@@ -117,147 +120,38 @@ void DebugDrawing3D::draw2()
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  // Draw all polygons/triangles.
-  for (const Polygon& p : polygons)
-  {
-    glColor4ub(p.color.r, p.color.g, p.color.b, p.color.a);
-    glBegin(GL_TRIANGLES);
-    glVertex3f(p.points[0].x(), p.points[0].y(), p.points[0].z());
-    glVertex3f(p.points[1].x(), p.points[1].y(), p.points[1].z());
-    glVertex3f(p.points[2].x(), p.points[2].y(), p.points[2].z());
-    glEnd();
-  }
-
-  // Draw all lines.
-  if (!lines.empty())
-  {
-    glPushAttrib(GL_LINE_BIT);
-    for (const Line& l : lines)
-    {
-      glLineWidth(l.width);
-      glColor4ub(l.color.r, l.color.g, l.color.b, l.color.a);
-      glBegin(GL_LINES);
-      glVertex3f(l.points[0].x(), l.points[0].y(), l.points[0].z());
-      glVertex3f(l.points[1].x(), l.points[1].y(), l.points[1].z());
-      glEnd();
-    }
-    glPopAttrib();
-  }
+  if (!batchesValid)
+    updateBatches();
 
-  // Draw all points.
-  if (!dots.empty())
+  if (!batches.empty())
   {
-    glPushAttrib(GL_POINT_BIT);
-    for (const Dot& d : dots)
+    glPushAttrib(GL_LINE_BIT | GL_POINT_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), &vertices[0].point);
+    glNormalPointer(GL_FLOAT, sizeof(Vertex), &vertices[0].normal);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &vertices[0].color);
+    for (size_t i = 0; i < batches.size(); ++i)
     {
-      // Since each point may have a different size we can't handle all
-      // points in a single glBegin(GL_POINTS).
-      // ( glPointSize is not allowed in a glBegin(...). )
-      glPointSize(d.width);
-      glColor4ub(d.color.r, d.color.g, d.color.b, d.color.a);
-      glBegin(GL_POINTS);
-      glVertex3f(d.point.x(), d.point.y(), d.point.z());
-      glEnd();
+      if (i == batchesBeforeSpheres)
+        drawSpheres();
+      const Batch& batch = batches[i];
+      if (batch.normals)
+        glEnableClientState(GL_NORMAL_ARRAY);
+      else
+        glDisableClientState(GL_NORMAL_ARRAY);
+      if (batch.mode == GL_LINES)
+        glLineWidth(batch.size);
+      else if (batch.mode == GL_POINTS)
+        glPointSize(batch.size);
+      glDrawArrays(batch.mode, static_cast<GLint>(batch.first), static_cast<GLsizei>(batch.count));
     }
+    glPopClientAttrib();
     glPopAttrib();
   }
-
-  // draw spheres
-  for (const Sphere& s : spheres)
-  {
-    glColor4ub(s.color.r, s.color.g, s.color.b, s.color.a);
-    glPushMatrix();
-    glTranslatef(s.point.x(), s.point.y(), s.point.z());
-    GLUquadric* q = gluNewQuadric();
-    gluSphere(q, s.radius, 16, 16);
-    gluDeleteQuadric(q);
-    glPopMatrix();
-  }
-
-  // draw ellypsoids
-  for (const Ellipsoid& e : ellipsoids)
-  {
-    glColor4ub(e.color.r, e.color.g, e.color.b, e.color.a);
-    glPushMatrix();
-    glTranslatef(e.pose.translation.x(), e.pose.translation.y(), e.pose.translation.z());
-    AngleAxisf aa(e.pose.rotation);
-    glRotatef(toDegrees(aa.angle()), aa.axis().x(), aa.axis().y(), aa.axis().z());
-    glScalef(e.radii.x(), e.radii.y(), e.radii.z());
-    GLUquadric* q = gluNewQuadric();
-    gluSphere(q, 1, 16, 16);
-    gluDeleteQuadric(q);
-    glPopMatrix();
-  }
-
-  // Draw all quads.
-  for (const Quad& q : quads)
-  {
-    glColor4ub(q.color.r, q.color.g, q.color.b, q.color.a);
-    glBegin(GL_QUADS);
-
-    const Vector3f& p1 = q.points[0];
-    const Vector3f& p2 = q.points[1];
-    const Vector3f& p3 = q.points[2];
-    const Vector3f& p4 = q.points[3];
-    Vector3f u(p2.x() - p1.x(), p2.y() - p1.y(), p2.z() - p1.z());
-    Vector3f v(p3.x() - p1.x(), p3.y() - p1.y(), p3.z() - p1.z());
-    Vector3f n(u.y() * v.z() - u.z() * v.y(), u.z() * v.x() - u.x() * v.z(), u.x() * v.y() - u.y() * v.x());
-    n.normalize();
-
-    glNormal3fv(&n.x());
-    glVertex3fv(&p1.x());
-    glVertex3fv(&p2.x());
-    glVertex3fv(&p3.x());
-    glVertex3fv(&p4.x());
-    glEnd();
-  }
-
-  // draw cylinders
-  for (const Cylinder& c : cylinders)
-  {
-    glColor4ub(c.color.r, c.color.g, c.color.b, c.color.a);
-
-    glPushMatrix();
-    glTranslated(c.point.x(), c.point.y(), c.point.z());
-    if (c.rotation.x() != 0)
-      glRotated(toDegrees(c.rotation.x()), 1, 0, 0);
-    if (c.rotation.y() != 0)
-      glRotated(toDegrees(c.rotation.y()), 0, 1, 0);
-    if (c.rotation.z() != 0)
-      glRotated(toDegrees(c.rotation.z()), 0, 0, 1);
-    glTranslated(0, 0, -c.height / 2);
-    GLUquadric* q = gluNewQuadric();
-    gluCylinder(q, c.baseRadius, c.topRadius, c.height, 16, 1);
-    glRotated(180, 0, 1, 0);
-    if (c.baseRadius > 0.f)
-      gluDisk(q, 0, c.baseRadius, 16, 1);
-    glRotated(180, 0, 1, 0);
-    glTranslated(0, 0, c.height);
-    if (c.topRadius > 0.f)
-      gluDisk(q, 0, c.topRadius, 16, 1);
-    gluDeleteQuadric(q);
-    glPopMatrix();
-  }
-
-  for (const PartDisc& pD : partDiscs)
-  {
-    glColor4ub(pD.color.r, pD.color.g, pD.color.b, pD.color.a);
-
-    glPushMatrix();
-    glTranslated(pD.point.x(), pD.point.y(), pD.point.z());
-    if (pD.rotation.x() != 0)
-      glRotated(toDegrees(pD.rotation.x()), 1, 0, 0);
-    if (pD.rotation.y() != 0)
-      glRotated(toDegrees(pD.rotation.y()), 0, 1, 0);
-    if (pD.rotation.z() != 0)
-      glRotated(toDegrees(pD.rotation.z()), 0, 0, 1);
-
-    GLUquadric* q = gluNewQuadric();
-    gluPartialDisk(q, pD.innerRadius, pD.outerRadius, 16, 10, toDegrees(pD.startAngle), toDegrees(pD.sweeptAngle));
-
-    gluDeleteQuadric(q);
-    glPopMatrix();
-  }
+  if (batchesBeforeSpheres == batches.size())
+    drawSpheres();
 
   // draw 3d images
   if (!images.empty())
@@ -311,8 +205,186 @@ void DebugDrawing3D::draw2()
   glPopMatrix();
 }
 
+void DebugDrawing3D::updateBatches()
+{
+  vertices.clear();
+  batches.clear();
+  batchesBeforeSpheres = 0;
+
+  for (const Polygon& p : polygons)
+    for (const Vector3f& point : p.points)
+      addVertex(GL_TRIANGLES, 0.f, false, point, Vector3f::UnitZ(), p.color);
+
+  for (const Line& l : lines)
+    for (const Vector3f& point : l.points)
+      addVertex(GL_LINES, l.width, false, point, Vector3f::UnitZ(), l.color);
+
+  for (const Dot& d : dots)
+    addVertex(GL_POINTS, d.width, false, d.point, Vector3f::UnitZ(), d.color);
+
+  // Spheres and ellipsoids are drawn here. Everything else is drawn afterwards as before.
+  batchesBeforeSpheres = batches.size();
+
+  for (const Quad& q : quads)
+  {
+    const Vector3f n = (q.points[1] - q.points[0]).cross(q.points[2] - q.points[0]).normalized();
+    for (int i : {0, 1, 2, 0, 2, 3})
+      addVertex(GL_TRIANGLES, 0.f, true, q.points[i], n, q.color);
+  }
+
+  constexpr int slices = 16;
+  for (const Cylinder& c : cylinders)
+  {
+    const Matrix3f rotation = (AngleAxisf(c.rotation.x(), Vector3f::UnitX()) * AngleAxisf(c.rotation.y(), Vector3f::UnitY()) * AngleAxisf(c.rotation.z(), Vector3f::UnitZ())).toRotationMatrix();
+    const Vector3f base = c.point - rotation.col(2) * (c.height / 2.f);
+    const Vector3f top = base + rotation.col(2) * c.height;
+    const float slope = c.height != 0.f ? (c.baseRadius - c.topRadius) / c.height : 0.f;
+    for (int i = 0; i < slices; ++i)
+    {
+      const float angle0 = pi2 * i / slices;
+      const float angle1 = pi2 * (i + 1) / slices;
+      const Vector3f dir0 = rotation * Vector3f(std::cos(angle0), std::sin(angle0), 0.f);
+      const Vector3f dir1 = rotation * Vector3f(std::cos(angle1), std::sin(angle1), 0.f);
+      const Vector3f n0 = dir0 + rotation.col(2) * slope;
+      const Vector3f n1 = dir1 + rotation.col(2) * slope;
+      const Vector3f bottom0 = base + dir0 * c.baseRadius;
+      const Vector3f bottom1 = base + dir1 * c.baseRadius;
+      const Vector3f top0 = top + dir0 * c.topRadius;
+      const Vector3f top1 = top + dir1 * c.topRadius;
+      addVertex(GL_TRIANGLES, 0.f, true, bottom0, n0, c.color);
+      addVertex(GL_TRIANGLES, 0.f, true, bottom1, n1, c.color);
+      addVertex(GL_TRIANGLES, 0.f, true, top1, n1, c.color);
+      addVertex(GL_TRIANGLES, 0.f, true, bottom0, n0, c.color);
+      addVertex(GL_TRIANGLES, 0.f, true, top1, n1, c.color);
+      addVertex(GL_TRIANGLES, 0.f, true, top0, n0, c.color);
+      if (c.baseRadius > 0.f)
+      {
+        const Vector3f n = -rotation.col(2);
+        addVertex(GL_TRIANGLES, 0.f, true, base, n, c.color);
+        addVertex(GL_TRIANGLES, 0.f, true, bottom1, n, c.color);
+        addVertex(GL_TRIANGLES, 0.f, true, bottom0, n, c.color);
+      }
+      if (c.topRadius > 0.f)
+      {
+        const Vector3f n = rotation.col(2);
+        addVertex(GL_TRIANGLES, 0.f, true, top, n, c.color);
+        addVertex(GL_TRIANGLES, 0.f, true, top0, n, c.color);
+        addVertex(GL_TRIANGLES, 0.f, true, top1, n, c.color);
+      }
+    }
+  }
+
+  for (const PartDisc& pD : partDiscs)
+  {
+    const Matrix3f rotation = (AngleAxisf(pD.rotation.x(), Vector3f::UnitX()) * AngleAxisf(pD.rotation.y(), Vector3f::UnitY()) * AngleAxisf(pD.rotation.z(), Vector3f::UnitZ())).toRotationMatrix();
+    const Vector3f n = rotation.col(2);
+
+    // Like gluPartialDisk, angles are measured clockwise from the y axis.
+    float startAngle = pD.startAngle;
+    float sweepAngle = std::min(pD.sweeptAngle, pi2);
+    if (sweepAngle < 0.f)
+    {
+      startAngle += sweepAngle;
+      sweepAngle = -sweepAngle;
+    }
+    for (int i = 0; i < slices; ++i)
+    {
+      const float angle0 = startAngle + sweepAngle * i / slices;
+      const float angle1 = startAngle + sweepAngle * (i + 1) / slices;
+      const Vector3f dir0 = rotation * Vector3f(std::sin(angle0), std::cos(angle0), 0.f);
+      const Vector3f dir1 = rotation * Vector3f(std::sin(angle1), std::cos(angle1), 0.f);
+      const Vector3f inner0 = pD.point + dir0 * pD.innerRadius;
+      const Vector3f inner1 = pD.point + dir1 * pD.innerRadius;
+      const Vector3f outer0 = pD.point + dir0 * pD.outerRadius;
+      const Vector3f outer1 = pD.point + dir1 * pD.outerRadius;
+      addVertex(GL_TRIANGLES, 0.f, true, inner0, n, pD.color);
+      addVertex(GL_TRIANGLES, 0.f, true, inner1, n, pD.color);
+      addVertex(GL_TRIANGLES, 0.f, true, outer1, n, pD.color);
+      addVertex(GL_TRIANGLES, 0.f, true, inner0, n, pD.color);
+      addVertex(GL_TRIANGLES, 0.f, true, outer1, n, pD.color);
+      addVertex(GL_TRIANGLES, 0.f, true, outer0, n, pD.color);
+    }
+  }
+
+  batchesValid = true;
+}
+
+void DebugDrawing3D::addVertex(unsigned mode, float size, bool normals, const Vector3f& point, const Vector3f& normal, ColorRGBA color)
+{
+  if (batches.size() == batchesBeforeSpheres || batches.back().mode != mode || batches.back().size != size || batches.back().normals != normals)
+    batches.push_back({mode, size, normals, vertices.size(), 0});
+  vertices.push_back({point, normal, color});
+  ++batches.back().count;
+}
+
+void DebugDrawing3D::drawSpheres() const
+{
+  if (spheres.empty() && ellipsoids.empty())
+    return;
+
+  // A unit sphere tessellated like gluSphere(q, 1, 16, 16). It is its own normal.
+  static const auto [sphereVertices, sphereIndices] = []
+  {
+    constexpr int slices = 16;
+    constexpr int stacks = 16;
+    std::vector<Vector3f> points;
+    std::vector<GLushort> indices;
+    for (int j = 0; j <= stacks; ++j)
+    {
+      const float phi = pi * j / stacks;
+      for (int i = 0; i <= slices; ++i)
+      {
+        const float theta = pi2 * i / slices;
+        points.emplace_back(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi));
+      }
+    }
+    for (int j = 0; j < stacks; ++j)
+      for (int i = 0; i < slices; ++i)
+      {
+        const GLushort upper = static_cast<GLushort>(j * (slices + 1) + i);
+        const GLushort lower = static_cast<GLushort>(upper + slices + 1);
+        indices.insert(indices.end(), {lower, static_cast<GLushort>(lower + 1), static_cast<GLushort>(upper + 1),
+                                       lower, static_cast<GLushort>(upper + 1), upper});
+      }
+    return std::make_pair(points, indices);
+  }();
+
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_NORMAL_ARRAY);
+  glDisableClientState(GL_COLOR_ARRAY);
+  glVertexPointer(3, GL_FLOAT, sizeof(Vector3f), sphereVertices.data());
+  glNormalPointer(GL_FLOAT, sizeof(Vector3f), sphereVertices.data());
+  const GLsizei numOfIndices = static_cast<GLsizei>(sphereIndices.size());
+
+  for (const Sphere& s : spheres)
+  {
+    glColor4ub(s.color.r, s.color.g, s.color.b, s.color.a);
+    glPushMatrix();
+    glTranslatef(s.point.x(), s.point.y(), s.point.z());
+    glScalef(s.radius, s.radius, s.radius);
+    glDrawElements(GL_TRIANGLES, numOfIndices, GL_UNSIGNED_SHORT, sphereIndices.data());
+    glPopMatrix();
+  }
+
+  for (const Ellipsoid& e : ellipsoids)
+  {
+    glColor4ub(e.color.r, e.color.g, e.color.b, e.color.a);
+    glPushMatrix();
+    glTranslatef(e.pose.translation.x(), e.pose.translation.y(), e.pose.translation.z());
+    AngleAxisf aa(e.pose.rotation);
+    glRotatef(toDegrees(aa.angle()), aa.axis().x(), aa.axis().y(), aa.axis().z());
+    glScalef(e.radii.x(), e.radii.y(), e.radii.z());
+    glDrawElements(GL_TRIANGLES, numOfIndices, GL_UNSIGNED_SHORT, sphereIndices.data());
+    glPopMatrix();
+  }
+
+  glPopClientAttrib();
+}
+
 void DebugDrawing3D::reset()
 {
+  batchesValid = false;
   timeStamp = SystemCall::getCurrentSystemTime();
   lines.clear();
   dots.clear();
@@ -335,6 +407,7 @@ void DebugDrawing3D::quad(const Vector3f* points, float width, ColorRGBA color)
   element.color = color;
   element.width = width;
   quads.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::line(float xStart, float yStart, float zStart, float xEnd, float yEnd, float zEnd, float width, ColorRGBA color)
@@ -345,6 +418,7 @@ void DebugDrawing3D::line(float xStart, float yStart, float zStart, float xEnd,
   element.color = color;
   element.width = width;
   lines.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::line(Vector3f* points, float width, ColorRGBA color)
@@ -355,6 +429,7 @@ void DebugDrawing3D::line(Vector3f* points, float width, ColorRGBA color)
   element.color = color;
   element.width = width;
   lines.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::line(float xStart, float yStart, float zStart, float xEnd, float yEnd, float zEnd)
@@ -370,6 +445,7 @@ void DebugDrawing3D::polygon(const Vector3f* points, float width, ColorRGBA colo
   element.width = width;
   element.color = color;
   polygons.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::dot(Vector3f v, float w, ColorRGBA color)
@@ -379,6 +455,7 @@ void DebugDrawing3D::dot(Vector3f v, float w, ColorRGBA color)
   element.color = color;
   element.width = w;
   dots.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::sphere(Vector3f v, float r, ColorRGBA color)
@@ -388,6 +465,7 @@ void DebugDrawing3D::sphere(Vector3f v, float r, ColorRGBA color)
   element.color = color;
   element.radius = r;
   spheres.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::ellypsoid(const Pose3f& pose, Vector3f radii, ColorRGBA color)
@@ -397,6 +475,7 @@ void DebugDrawing3D::ellypsoid(const Pose3f& pose, Vector3f radii, ColorRGBA col
   element.radii = radii;
   element.color = color;
   ellipsoids.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::cylinder(Vector3f v, Vector3f rot, float baseRadius, float topRadius, float h, ColorRGBA color)
@@ -409,6 +488,7 @@ void DebugDrawing3D::cylinder(Vector3f v, Vector3f rot, float baseRadius, float
   element.topRadius = topRadius;
   element.height = h;
   cylinders.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::partDisc(Vector3f v, Vector3f rot, float innerRadius, float outerRadius, float startAngle, float sweepAngle, ColorRGBA color)
@@ -422,6 +502,7 @@ void DebugDrawing3D::partDisc(Vector3f v, Vector3f rot, float innerRadius, float
   element.sweeptAngle = sweepAngle;
   element.color = color;
   partDiscs.push_back(element);
+  batchesValid = false;
 }
 
 void DebugDrawing3D::image(Vector3f v, Vector3f rot, float w, float h, Image* i)
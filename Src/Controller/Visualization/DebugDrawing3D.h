@@ -288,5 +288,40 @@ private:
   std::vector<PartDisc> partDiscs;
   std::vector<Image3D> images;
 
+  /** A vertex of the geometry that is drawn from vertex arrays. */
+  struct Vertex
+  {
+    Vector3f point;
+    Vector3f normal;
+    ColorRGBA color;
+  };
+
+  /** A range of vertices that is drawn with a single call. */
+  struct Batch
+  {
+    unsigned mode; /**< The OpenGL primitive type. */
+    float size; /**< The line width or point size. */
+    bool normals; /**< Do the vertices provide normals? */
+    size_t first; /**< The index of the first vertex. */
+    size_t count; /**< The number of vertices. */
+  };
+
+  std::vector<Vertex> vertices; /**< The vertices of all batches. */
+  std::vector<Batch> batches; /**< The batches in the order in which they are drawn. */
+  size_t batchesBeforeSpheres = 0; /**< The number of batches that are drawn before the spheres and ellipsoids. */
+  bool batchesValid = false; /**< Do the batches represent the current elements? */
+
+  /** Creates the batches from the elements of this drawing. */
+  void updateBatches();
+
+  /**
+  * Appends a vertex to the current batch or starts a new batch if the vertex
+  * cannot be drawn with the same call as the previous one.
+  */
+  void addVertex(unsigned mode, float size, bool normals, const Vector3f& point, const Vector3f& normal, ColorRGBA color);
+
+  /** Draws all spheres and ellipsoids as instances of the same unit sphere. */
+  void drawSpheres() const;
+
   char* copyImage(const Image& srcImage, int& width, int& height) const;
 };
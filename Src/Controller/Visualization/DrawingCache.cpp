@@ -0,0 +1,61 @@
+/**
+ * @file Controller/Visualization/DrawingCache.cpp
+ * Implementation of class DrawingCache.
+ */
+
+#include <QPainter>
+#include "DrawingCache.h"
+#include "PaintMethods.h"
+
+void DrawingCache::paint(QPainter& painter, const std::vector<const DebugDrawing*>& drawings)
+{
+  const QTransform baseTrans = painter.transform();
+
+  // count the leading drawings that are the same as in the previous call
+  size_t numOfUnchanged = 0;
+  while (numOfUnchanged < drawings.size() && numOfUnchanged < previousDrawings.size() && drawings[numOfUnchanged]->hasSameElements(previousDrawings[numOfUnchanged]))
+    ++numOfUnchanged;
+
+  // the image is outdated if the view was resized, zoomed, or moved, or if one of its drawings changed
+  const QPaintDevice* device = painter.device();
+  const qreal pixelRatio = device->devicePixelRatioF();
+  const QSize size(int(device->width() * pixelRatio), int(device->height() * pixelRatio));
+  if (image.size() != size || image.devicePixelRatio() != pixelRatio || transform != baseTrans || numOfUnchanged < numOfCachedDrawings)
+    numOfCachedDrawings = 0;
+
+  // add drawings that did not change to the image
+  if (numOfUnchanged > numOfCachedDrawings)
+  {
+    if (!numOfCachedDrawings)
+    {
+      if (image.size() != size)
+        image = QImage(size, QImage::Format_ARGB32_Premultiplied);
+      image.setDevicePixelRatio(pixelRatio);
+      image.fill(Qt::transparent);
+      transform = baseTrans;
+    }
+    QPainter imagePainter(&image);
+    imagePainter.setRenderHints(painter.renderHints());
+    for (; numOfCachedDrawings < numOfUnchanged; ++numOfCachedDrawings)
+    {
+      imagePainter.setTransform(transform);
+      PaintMethods::paintDebugDrawing(imagePainter, *drawings[numOfCachedDrawings], transform);
+    }
+  }
+
+  if (numOfCachedDrawings)
+  {
+    painter.setTransform(QTransform());
+    painter.drawImage(0, 0, image);
+  }
+  for (size_t i = numOfCachedDrawings; i < drawings.size(); ++i)
+  {
+    painter.setTransform(baseTrans);
+    PaintMethods::paintDebugDrawing(painter, *drawings[i], baseTrans);
+  }
+  painter.setTransform(baseTrans);
+
+  previousDrawings.resize(drawings.size());
+  for (size_t i = numOfUnchanged; i < drawings.size(); ++i)
+    previousDrawings[i] = *drawings[i];
+}
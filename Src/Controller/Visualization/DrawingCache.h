@@ -0,0 +1,40 @@
+/**
+ * @file Controller/Visualization/DrawingCache.h
+ * Declaration of class DrawingCache.
+ */
+
+#pragma once
+
+#include <QImage>
+#include <QTransform>
+#include <vector>
+
+#include "DebugDrawing.h"
+
+class QPainter;
+
+/**
+ * @class DrawingCache
+ *
+ * Paints a sequence of debug drawings, but keeps the leading drawings that did not change
+ * between two consecutive calls rasterized in an image. Only this image and the drawings
+ * following them have to be painted again. Static layers such as the field lines are
+ * usually drawn first and therefore end up in the cache.
+ */
+class DrawingCache
+{
+public:
+  /**
+   * Paints debug drawings in the given order.
+   * @param painter The graphics context the drawings are painted to. Its transformation is used
+   *                as base transformation. It is restored afterwards.
+   * @param drawings The drawings to paint.
+   */
+  void paint(QPainter& painter, const std::vector<const DebugDrawing*>& drawings);
+
+private:
+  std::vector<DebugDrawing> previousDrawings; /**< Copies of the drawings painted in the previous call. */
+  size_t numOfCachedDrawings = 0; /**< The number of leading drawings rasterized in the image. */
+  QImage image; /**< The rasterized leading drawings. */
+  QTransform transform; /**< The base transformation the image was painted with. */
+};
@@ -8,6 +8,7 @@
 #include "BehaviorControl.h"
 #include "Tools/Streams/InStreams.h"
 #include "Tools/Debugging/Annotation.h"
+#include "Representations/Infrastructure/LoggerStatus.h"
 #include "Modules/BehaviorControl/BehaviorHelper.h"
 
 #ifdef __INTELLISENSE__
@@ -40,10 +41,11 @@ namespace NDBehavior
     /**
      * Executes one behavior cycle.
      * @param roots A set of root options. They must be parameterless.
+     * @param recordActivationGraph Shall the activation graph be filled?
      */
-    void execute(const std::vector<OptionInfos::Option>& roots)
+    void execute(const std::vector<OptionInfos::Option>& roots, bool recordActivationGraph)
     {
-      beginFrame(theFrameInfo.time);
+      beginFrame(theFrameInfo.time, recordActivationGraph);
 
       for (std::vector<Behavior::OptionInfos::Option>::const_iterator i = roots.begin(); i != roots.end(); ++i)
         Cabsl<Behavior>::execute(*i);
@@ -105,7 +107,14 @@ class BehaviorControl : public BehaviorControlBase
     MODIFY("parameters:BehaviorControl", p);
     if (theFrameInfo.time)
     {
-      theBehavior->execute(p.roots);
+      // The graph is only needed if it is sent or logged.
+      bool recordActivationGraph = false;
+      DEBUG_RESPONSE("representation:ActivationGraph")
+        recordActivationGraph = true;
+      Blackboard& blackboard = Blackboard::getInstance();
+      if (!recordActivationGraph && blackboard.exists("LoggerStatus"))
+        recordActivationGraph = static_cast<const LoggerStatus&>(blackboard["LoggerStatus"]).writing;
+      theBehavior->execute(p.roots, recordActivationGraph);
     }
   }
 
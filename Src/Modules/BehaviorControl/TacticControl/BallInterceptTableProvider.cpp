@@ -0,0 +1,53 @@
+/**
+* @file BallInterceptTableProvider.cpp
+*
+* Implementation of class BallInterceptTableProvider.
+*/
+
+#include "BallInterceptTableProvider.h"
+#include "Tools/Modeling/BallPhysics.h"
+
+void BallInterceptTableProvider::update(BallInterceptTable& ballInterceptTable)
+{
+  ballInterceptTable.timeStep = timeStep;
+  ballInterceptTable.maxSpeed = theWalkingEngineParams.speedLimits.xForward * theWalkingEngineParams.speedLimits.speedFactor;
+  ballInterceptTable.maxRotationSpeed = theWalkingEngineParams.speedLimits.rOnly * theWalkingEngineParams.speedLimits.speedFactor;
+  ballInterceptTable.accelerationTime = accelerationTime;
+  ballInterceptTable.reachDistance = reachDistance;
+  ballInterceptTable.interceptIndex = -1;
+  ballInterceptTable.interceptTime = -1.f;
+  ballInterceptTable.valid = theBallSymbols.timeSinceLastSeenByTeam < maxTimeSinceBallSeen && timeStep > 0.f && numOfSamples > 0;
+  if (!ballInterceptTable.valid)
+  {
+    ballInterceptTable.ballPositions.clear();
+    ballInterceptTable.ballVelocities.clear();
+    ballInterceptTable.robotTimes.clear();
+    ballInterceptTable.interceptPosition = theBallSymbols.ballPositionField;
+    return;
+  }
+
+  // the ball symbols are relative to the pose after preview, the walking speed is in m/s
+  const Vector2f robotVelocity = Vector2f(theSpeedInfo.speed.translation * 1000.f).rotate(theRobotPoseAfterPreview.rotation);
+  Vector2f position = theBallSymbols.ballPositionField;
+  Vector2f velocity = Vector2f(theBallSymbols.ballVelocityRelative).rotate(theRobotPoseAfterPreview.rotation);
+
+  ballInterceptTable.ballPositions.resize(numOfSamples);
+  ballInterceptTable.ballVelocities.resize(numOfSamples);
+  ballInterceptTable.robotTimes.resize(numOfSamples);
+  for (unsigned i = 0; i < numOfSamples; ++i)
+  {
+    if (i > 0)
+      BallPhysics::propagateBallPositionAndVelocity(position, velocity, timeStep, theBallModelAfterPreview.friction);
+    ballInterceptTable.ballPositions[i] = position;
+    ballInterceptTable.ballVelocities[i] = velocity;
+    ballInterceptTable.robotTimes[i] = ballInterceptTable.getTimeToReach(theRobotPoseAfterPreview, robotVelocity, position);
+    if (ballInterceptTable.interceptIndex < 0 && ballInterceptTable.robotTimes[i] <= static_cast<float>(i) * timeStep)
+    {
+      ballInterceptTable.interceptIndex = static_cast<int>(i);
+      ballInterceptTable.interceptTime = static_cast<float>(i) * timeStep;
+    }
+  }
+  ballInterceptTable.interceptPosition = ballInterceptTable.ballPositions[ballInterceptTable.interceptIndex >= 0 ? ballInterceptTable.interceptIndex : numOfSamples - 1];
+}
+
+MAKE_MODULE(BallInterceptTableProvider, behaviorControl)
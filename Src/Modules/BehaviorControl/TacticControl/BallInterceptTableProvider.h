@@ -0,0 +1,37 @@
+/**
+* @file BallInterceptTableProvider.h
+*
+* Declaration of class BallInterceptTableProvider, which samples the ball trajectory
+* of the current frame on a fixed time grid for intercept queries.
+*/
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/BehaviorControl/BallInterceptTable.h"
+#include "Representations/BehaviorControl/BallSymbols.h"
+#include "Representations/Modeling/BallModel.h"
+#include "Representations/Modeling/RobotPose.h"
+#include "Representations/MotionControl/SpeedInfo.h"
+#include "Representations/MotionControl/WalkingEngineParams.h"
+
+MODULE(BallInterceptTableProvider,
+  REQUIRES(BallModelAfterPreview),
+  REQUIRES(BallSymbols),
+  REQUIRES(RobotPoseAfterPreview),
+  REQUIRES(SpeedInfo),
+  REQUIRES(WalkingEngineParams),
+  PROVIDES(BallInterceptTable),
+  LOADS_PARAMETERS(,
+    (float)(0.1f) timeStep, /**< The time between two samples (in s). */
+    (unsigned)(40) numOfSamples, /**< The number of samples, i.e. the table covers (numOfSamples - 1) * timeStep seconds. */
+    (int)(2000) maxTimeSinceBallSeen, /**< The table is only filled if the team saw the ball more recently (in ms). */
+    (float)(0.5f) accelerationTime, /**< The time needed to accelerate from standing to full speed (in s). */
+    (float)(150.f) reachDistance /**< The distance to the ball at which it counts as reached (in mm). */
+  )
+);
+
+class BallInterceptTableProvider : public BallInterceptTableProviderBase
+{
+  void update(BallInterceptTable& ballInterceptTable);
+};
@@ -6,6 +6,10 @@
 */
 
 #include "BallSearchProvider.h"
+#include "Tools/Math/Geometry.h"
+#include "Tools/Math/Transformation.h"
+#include <algorithm>
+#include <cmath>
 
 void BallSearchProvider::update(BallSearch& ballsearch)
 {
@@ -26,13 +30,25 @@ void BallSearchProvider::update(BallSearch& ballsearch)
   if (timeSinceBallLastSeen == static_cast<int>(theFrameInfo.time)) //never seen, assume center position
     lastBallPositionField = Vector2f::Zero();
 
+  // the own ball is reset to where it stops rolling
+  Vector2f gridBallPosition = theBallSymbols.ballPositionFieldPredicted;
   for (auto& mate : theTeammateData.teammates)
     if (theFrameInfo.getTimeSince(mate.ballModel.timeWhenLastSeen) < timeSinceBallLastSeen)
     {
       timeSinceBallLastSeen = theFrameInfo.getTimeSince(mate.ballModel.timeWhenLastSeen);
       lastBallPositionField = mate.behaviorData.ballPositionField.cast<float>();
+      gridBallPosition = lastBallPositionField;
     }
 
+  updateGrid(timeSinceBallLastSeen, gridBallPosition);
+  ballsearch.gridOrigin = gridOrigin;
+  ballsearch.gridCellSize = cellSize;
+  ballsearch.gridWidth = gridWidth;
+  ballsearch.gridHeight = gridHeight;
+  ballsearch.gridProbabilities = grid;
+  ballsearch.mostProbablePosition = mostProbablePosition;
+  drawGrid();
+
   // if game state not playing do not search for ball!
   if (theGameInfo.state != STATE_PLAYING)
     return;
@@ -250,9 +266,10 @@ void BallSearchProvider::fillBallSearchPositions(BallSearch& ballsearch)
     break;
   }
 
-  // special case: ballchaser goes to last ball position
+  // special case: ballchaser goes to last (or most probable) ball position
   if (timeSinceBallSearchStarted < 30000)
   {
+    const Vector2f searchCenter = useProbabilityGrid ? mostProbablePosition : lastBallPositionField;
     for (size_t i = 0; i < ballsearch.rolesInBallSearch.size(); i++)
     {
       const BehaviorData::RoleAssignment& role = ballsearch.rolesInBallSearch[i];
@@ -260,16 +277,118 @@ void BallSearchProvider::fillBallSearchPositions(BallSearch& ballsearch)
       {
         ballsearch.ballSearchPositions[i].poses.clear();
         ballsearch.ballSearchPositions[i].poses.push_back(Pose2f(45_deg,
-            std::max(theFieldDimensions.xPosOwnGroundline, std::min(lastBallPositionField.x() + 500.f, theFieldDimensions.xPosOpponentGroundline)),
-            std::max(theFieldDimensions.yPosRightSideline, std::min(lastBallPositionField.y() + 1000.f, theFieldDimensions.yPosLeftSideline))));
+            std::max(theFieldDimensions.xPosOwnGroundline, std::min(searchCenter.x() + 500.f, theFieldDimensions.xPosOpponentGroundline)),
+            std::max(theFieldDimensions.yPosRightSideline, std::min(searchCenter.y() + 1000.f, theFieldDimensions.yPosLeftSideline))));
         ballsearch.ballSearchPositions[i].poses.push_back(Pose2f(-45_deg,
-            std::max(theFieldDimensions.xPosOwnGroundline, std::min(lastBallPositionField.x() + 500.f, theFieldDimensions.xPosOpponentGroundline)),
-            std::min(theFieldDimensions.yPosLeftSideline, std::max(lastBallPositionField.y() - 1000.f, theFieldDimensions.yPosRightSideline))));
+            std::max(theFieldDimensions.xPosOwnGroundline, std::min(searchCenter.x() + 500.f, theFieldDimensions.xPosOpponentGroundline)),
+            std::min(theFieldDimensions.yPosLeftSideline, std::max(searchCenter.y() - 1000.f, theFieldDimensions.yPosRightSideline))));
         ballsearch.ballSearchPositions[i].poses.push_back(Pose2f(175_deg,
-            std::min(theFieldDimensions.xPosOpponentGroundline, std::max(lastBallPositionField.x() - 1000.f, theFieldDimensions.xPosOwnGroundline)),
-            std::max(theFieldDimensions.yPosRightSideline, std::min(lastBallPositionField.y(), theFieldDimensions.yPosLeftSideline))));
+            std::min(theFieldDimensions.xPosOpponentGroundline, std::max(searchCenter.x() - 1000.f, theFieldDimensions.xPosOwnGroundline)),
+            std::max(theFieldDimensions.yPosRightSideline, std::min(searchCenter.y(), theFieldDimensions.yPosLeftSideline))));
+      }
+    }
+  }
+}
+
+void BallSearchProvider::updateGrid(int timeSinceBallLastSeen, const Vector2f& ballPosition)
+{
+  initGrid();
+  const float timeStep = lastGridUpdate ? static_cast<float>(std::clamp(theFrameInfo.getTimeSince(lastGridUpdate), 0, 1000)) / 1000.f : 0.f;
+  lastGridUpdate = theFrameInfo.time;
+
+  if (timeSinceBallLastSeen < ballSeenResetTime)
+    resetGrid(ballPosition);
+  else
+  {
+    // diffusion to the four neighbors, a missing neighbor keeps its share in the cell
+    const float share = std::min(diffusion * timeStep, 1.f) * 0.25f;
+    for (int y = 0; y < gridHeight; ++y)
+      for (int x = 0; x < gridWidth; ++x)
+      {
+        const int i = y * gridWidth + x;
+        const float neighbors = grid[x > 0 ? i - 1 : i] + grid[x < gridWidth - 1 ? i + 1 : i] + grid[y > 0 ? i - gridWidth : i] + grid[y < gridHeight - 1 ? i + gridWidth : i];
+        diffused[i] = grid[i] + share * (neighbors - 4.f * grid[i]);
+      }
+    grid.swap(diffused);
+
+    // negative information: the ball was not seen in the cells that are visible in the images
+    const float maxSquaredDistance = maxObservationDistance * maxObservationDistance;
+    for (int y = 0; y < gridHeight; ++y)
+      for (int x = 0; x < gridWidth; ++x)
+      {
+        const Vector2f relativePosition = Transformation::fieldToRobot(theRobotPose, getCellCenter(x, y));
+        if (relativePosition.squaredNorm() < maxSquaredDistance
+            && (Geometry::ballShouldBeVisibleInImage(relativePosition, theFieldDimensions.ballRadius, theCameraMatrix, theCameraInfo)
+                || Geometry::ballShouldBeVisibleInImage(relativePosition, theFieldDimensions.ballRadius, theCameraMatrixUpper, theCameraInfoUpper)))
+          grid[y * gridWidth + x] *= missedDetectionFactor;
       }
+
+    // normalize and keep a minimum probability everywhere
+    float sum = 0.f;
+    for (const float p : grid)
+      sum += p;
+    const float uniform = std::min(uniformShare * timeStep, 1.f);
+    const float scale = sum > 0.f ? (1.f - uniform) / sum : 0.f;
+    const float offset = (sum > 0.f ? uniform : 1.f) / static_cast<float>(grid.size());
+    for (float& p : grid)
+      p = p * scale + offset;
+  }
+
+  const size_t best = std::max_element(grid.begin(), grid.end()) - grid.begin();
+  mostProbablePosition = getCellCenter(static_cast<int>(best) % gridWidth, static_cast<int>(best) / gridWidth);
+}
+
+void BallSearchProvider::initGrid()
+{
+  const float fieldLength = theFieldDimensions.xPosOpponentGroundline - theFieldDimensions.xPosOwnGroundline;
+  const float fieldWidth = theFieldDimensions.yPosLeftSideline - theFieldDimensions.yPosRightSideline;
+  const float size = std::max(gridCellSize, 100.f);
+  const int width = std::max(static_cast<int>(std::ceil(fieldLength / size)), 1);
+  const int height = std::max(static_cast<int>(std::ceil(fieldWidth / size)), 1);
+  if (width == gridWidth && height == gridHeight && size == cellSize)
+    return;
+
+  gridWidth = width;
+  gridHeight = height;
+  cellSize = size;
+  // the cells are centered on the field
+  gridOrigin = Vector2f(theFieldDimensions.xPosOwnGroundline + (fieldLength - static_cast<float>(width - 1) * size) * 0.5f,
+      theFieldDimensions.yPosRightSideline + (fieldWidth - static_cast<float>(height - 1) * size) * 0.5f);
+  grid.assign(gridWidth * gridHeight, 1.f / static_cast<float>(gridWidth * gridHeight));
+  diffused.resize(grid.size());
+}
+
+void BallSearchProvider::resetGrid(const Vector2f& position)
+{
+  const float factor = -0.5f / std::max(ballPositionDeviation * ballPositionDeviation, 1.f);
+  float sum = 0.f;
+  for (int y = 0; y < gridHeight; ++y)
+    for (int x = 0; x < gridWidth; ++x)
+    {
+      const float p = std::exp((getCellCenter(x, y) - position).squaredNorm() * factor);
+      grid[y * gridWidth + x] = p;
+      sum += p;
     }
+  // a position far outside of the field is distributed uniformly
+  for (float& p : grid)
+    p = sum > 0.f ? p / sum : 1.f / static_cast<float>(grid.size());
+}
+
+void BallSearchProvider::drawGrid() const
+{
+  DECLARE_DEBUG_DRAWING("behavior:BallSearch:grid", "drawingOnField");
+  COMPLEX_DRAWING("behavior:BallSearch:grid")
+  {
+    const float maxProbability = *std::max_element(grid.begin(), grid.end());
+    for (int y = 0; y < gridHeight; ++y)
+      for (int x = 0; x < gridWidth; ++x)
+      {
+        const Vector2f center = getCellCenter(x, y);
+        const unsigned char alpha = static_cast<unsigned char>(200.f * grid[y * gridWidth + x] / maxProbability);
+        FILLED_RECTANGLE("behavior:BallSearch:grid", center.x() - cellSize * 0.5f, center.y() - cellSize * 0.5f, center.x() + cellSize * 0.5f, center.y() + cellSize * 0.5f, 0,
+            Drawings::noPen, ColorRGBA::black, Drawings::solidBrush, ColorRGBA(255, 0, 0, alpha));
+      }
+    CROSS("behavior:BallSearch:grid", mostProbablePosition.x(), mostProbablePosition.y(), 100, 20, Drawings::solidPen, ColorRGBA::red);
   }
 }
 
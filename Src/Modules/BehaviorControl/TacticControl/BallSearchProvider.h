@@ -15,6 +15,8 @@
 #include "Representations/BehaviorControl/BallChaserDecision.h"
 #include "Representations/BehaviorControl/RoleSymbols.h"
 #include "Representations/Configuration/FieldDimensions.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Modeling/RobotPose.h"
 #include "Representations/Infrastructure/TeammateData.h"
 #include "Representations/Infrastructure/FrameInfo.h"
@@ -24,10 +26,15 @@
 
 MODULE(BallSearchProvider,
   REQUIRES(BallSymbols),
+  REQUIRES(CameraInfo),
+  REQUIRES(CameraInfoUpper),
+  REQUIRES(CameraMatrix),
+  REQUIRES(CameraMatrixUpper),
   REQUIRES(FieldDimensions),
   REQUIRES(FrameInfo),
   REQUIRES(GameInfo),
   REQUIRES(GameSymbols),
+  REQUIRES(RobotPose),
   REQUIRES(RobotPoseAfterPreview),
   REQUIRES(RoleSelection),
   REQUIRES(TeammateData),
@@ -39,7 +46,15 @@ MODULE(BallSearchProvider,
   LOADS_PARAMETERS(,
     (int)(10000) timeUntilWholeFieldSearchAfterLost,
     (float)(0.2f) defenseSearchStart,
-    (float)(0.45f) centerSearchStart
+    (float)(0.45f) centerSearchStart,
+    (bool)(true) useProbabilityGrid, /**< Search around the most probable ball position instead of the last one seen. */
+    (float)(500.f) gridCellSize, /**< The edge length of a grid cell (in mm). */
+    (int)(500) ballSeenResetTime, /**< The grid is reset to the ball if it was seen more recently (in ms). */
+    (float)(500.f) ballPositionDeviation, /**< The standard deviation of the ball position after a reset (in mm). */
+    (float)(0.05f) diffusion, /**< The share of a cell that is spread to its neighbors per second. */
+    (float)(0.01f) uniformShare, /**< The share of the probability that is spread over the whole field per second. */
+    (float)(0.7f) missedDetectionFactor, /**< The probability of a visible cell is multiplied by this per image without a ball. */
+    (float)(4000.f) maxObservationDistance /**< Cells are only visible up to this distance (in mm). */
   )
 );
 
@@ -61,10 +76,41 @@ public:
 private:
   void fillBallSearchPositions(BallSearch& ballsearch);
 
+  /**
+  * Updates the probability grid incrementally. If the ball was seen recently, the grid
+  * is reset around it. Otherwise, the probabilities are diffused and the cells that
+  * are visible in the current camera images lose probability.
+  * @param timeSinceBallLastSeen The time since the team saw the ball last (in ms).
+  * @param ballPosition The position of the ball seen last in field coordinates.
+  */
+  void updateGrid(int timeSinceBallLastSeen, const Vector2f& ballPosition);
+
+  /** Resizes and resets the grid if the field dimensions or the cell size were changed. */
+  void initGrid();
+
+  /** Sets the grid to a normal distribution around a position. */
+  void resetGrid(const Vector2f& position);
+
+  Vector2f getCellCenter(int x, int y) const
+  {
+    return gridOrigin + Vector2f(static_cast<float>(x), static_cast<float>(y)) * cellSize;
+  }
+
+  void drawGrid() const;
+
   // members
   unsigned int timeStampBallLostForTeam = 0;
   int defenseInBallSearch = 0;
   int centerInBallSearch = 0;
   int offenseInBallSearch = 0;
   Vector2f lastBallPositionField = Vector2f::Zero();
+
+  std::vector<float> grid; /**< The probabilities of the ball position, row by row. */
+  std::vector<float> diffused; /**< Buffer for the diffusion step. */
+  int gridWidth = 0;
+  int gridHeight = 0;
+  float cellSize = 0.f;
+  Vector2f gridOrigin = Vector2f::Zero();
+  unsigned lastGridUpdate = 0;
+  Vector2f mostProbablePosition = Vector2f::Zero();
 };
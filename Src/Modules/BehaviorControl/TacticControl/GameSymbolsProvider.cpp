@@ -142,8 +142,11 @@ void GameSymbolsProvider::update(GameSymbols& gameSymbols)
 */
 bool GameSymbolsProvider::calcAllowedInOwnGoalArea()
 {
-  std::unordered_set<BehaviorData::RoleAssignment> privilegedRoles = {
-      BehaviorData::keeper, BehaviorData::replacementKeeper, BehaviorData::defenderSingle, BehaviorData::defenderLeft, BehaviorData::defenderRight};
+  const bool hasPrivilegedRole = theRoleSymbols.role == BehaviorData::keeper || theRoleSymbols.role == BehaviorData::replacementKeeper
+      || theRoleSymbols.role == BehaviorData::defenderSingle || theRoleSymbols.role == BehaviorData::defenderLeft || theRoleSymbols.role == BehaviorData::defenderRight;
+  if (!hasPrivilegedRole)
+    return false;
+
   Vector2f goalAreaBottomLeft(theFieldDimensions.xPosOwnGroundline, theFieldDimensions.yPosRightGoalArea);
   Vector2f goalAreaTopRight(theFieldDimensions.xPosOwnGoalArea, theFieldDimensions.yPosLeftGoalArea);
   int numOfTeammatesInGoalArea = 0;
@@ -152,10 +155,9 @@ bool GameSymbolsProvider::calcAllowedInOwnGoalArea()
     if (Geometry::isPointInsideRectangle(goalAreaBottomLeft, goalAreaTopRight, teammate.robotPose.translation))
       numOfTeammatesInGoalArea++;
   }
-  bool hasPrivilegedRole = privilegedRoles.find(theRoleSymbols.role) != privilegedRoles.end();
   bool goalAreaIsOccupied = numOfTeammatesInGoalArea >= 3;
   bool robotIsInGoalArea = Geometry::isPointInsideRectangle(goalAreaBottomLeft, goalAreaTopRight, theRobotPoseAfterPreview.translation);
-  return hasPrivilegedRole && (!goalAreaIsOccupied || robotIsInGoalArea);
+  return !goalAreaIsOccupied || robotIsInGoalArea;
 }
 
 MAKE_MODULE(GameSymbolsProvider, behaviorControl)
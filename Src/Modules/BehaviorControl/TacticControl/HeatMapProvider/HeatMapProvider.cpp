@@ -2,74 +2,117 @@
 #include "Tools/Math/Transformation.h"
 #include <Modules/BehaviorControl/TacticControl/HeatMapProvider/HeatMapUtils.h>
 #include <Modules/BehaviorControl/TacticControl/RoleProvider/Utils/BallUtils.h>
-#include <taskflow/taskflow.hpp>
-#include <taskflow/algorithm/for_each.hpp>
+#include <cmath>
 
 HeatMapProvider::HeatMapProvider() = default;
 
 void draw(std::vector<Vector2f> positionVector, std::vector<float> heatVector);
 
-void HeatMapProvider::execute(tf::Subflow& subflow)
+HeatMapProvider::Input HeatMapProvider::getInput() const
 {
-  const auto [teammateRobots, opponentRobots] = HeatMapUtils::getTeammateAndOtherRobots(theRobotMap);
-
-  subflow
-      .for_each_index(0,
-          HeatMap::CELL_COUNT,
-          1,
-          [&, teammateRobots = teammateRobots, opponentRobots = opponentRobots](const int index)
-          {
-            const Vector2f fieldPosition = HeatMap::indexToField(index, theFieldDimensions);
-
-            if (firstUpdate)
-            {
-              localHeatMapCollection.sidesHeatMap.setHeat(std::pow(HeatMapUtils::getSidesHeat(fieldPosition, theFieldDimensions), 2.f), index, theFieldDimensions);
-              localHeatMapCollection.goalsHeatMap.setHeat(HeatMapUtils::getGoalsHeat(fieldPosition, theFieldDimensions), index, theFieldDimensions);
-            }
-
-            const auto [teammatesKickHeat, teammatesGoalKickHeat] =
-                HeatMapUtils::getRobotHeatForPosition(fieldPosition, teammateRobots, FieldUtils::getOpponentGoalCenter(theFieldDimensions), theFieldDimensions);
-            const auto [opponentsKickHeat, opponentsGoalKickHeat] =
-                HeatMapUtils::getRobotHeatForPosition(fieldPosition, opponentRobots, FieldUtils::getOwnGoalCenter(theFieldDimensions), theFieldDimensions);
-
-
-            if (kickHeatTakeNewPercent > 0.99f)
-            {
-              teammatesKickHeatMap.setHeat(teammatesKickHeat, index, theFieldDimensions);
-              localHeatMapCollection.opponentKickHeatMap.setHeat(opponentsKickHeat, index, theFieldDimensions);
-            }
-            else
-            {
-              teammatesKickHeatMap.updateHeat(kickHeatTakeNewPercent, teammatesKickHeat, index, theFieldDimensions);
-              localHeatMapCollection.opponentKickHeatMap.updateHeat(kickHeatTakeNewPercent, opponentsKickHeat, index, theFieldDimensions);
-            }
-
-            if (goalKickHeatTakeNewPercent > 0.99f)
-            {
-              teammatesGoalKickHeatMap.setHeat(teammatesGoalKickHeat, index, theFieldDimensions);
-              localHeatMapCollection.opponentGoalKickHeatMap.setHeat(opponentsGoalKickHeat, index, theFieldDimensions);
-            }
-            else
-            {
-              teammatesGoalKickHeatMap.updateHeat(goalKickHeatTakeNewPercent, teammatesGoalKickHeat, index, theFieldDimensions);
-              localHeatMapCollection.opponentGoalKickHeatMap.updateHeat(goalKickHeatTakeNewPercent, opponentsGoalKickHeat, index, theFieldDimensions);
-            }
-
-            // Apply instant heat
-            const std::vector<Pose2f> selfPose = {Pose2f(theRobotPose.rotation, theBallSymbols.ballPositionField)}; // Use Ball Position since it's the robots position when he will kick the ball
-            const auto [selfKickHeat, selfGoalKickHeat] = HeatMapUtils::getRobotHeatForPosition(fieldPosition, selfPose, FieldUtils::getOpponentGoalCenter(theFieldDimensions), theFieldDimensions);
-            const float teamKickHeat = std::max(teammatesKickHeatMap.getHeat(index), selfKickHeat);
-            const float teamGoalKickHeat = std::max(teammatesGoalKickHeatMap.getHeat(index), selfGoalKickHeat);
-            localHeatMapCollection.teamKickHeatMap.setHeat(teamKickHeat, index, theFieldDimensions);
-            localHeatMapCollection.teamGoalKickHeatMap.setHeat(teamGoalKickHeat, index, theFieldDimensions);
-          })
-      .name("UpdateHeat [HeatMapProvider]");
+  Input input;
+  input.heatMaps = heatMaps;
+  input.fieldDimensions = theFieldDimensions;
+  auto [teammateRobots, opponentRobots] = HeatMapUtils::getTeammateAndOtherRobots(theRobotMap);
+  input.teammateRobots = std::move(teammateRobots);
+  input.opponentRobots = std::move(opponentRobots);
+  // Use Ball Position since it's the robots position when he will kick the ball
+  input.selfPose = {Pose2f(theRobotPose.rotation, theBallSymbols.ballPositionField)};
+
+  // The heat maps are filtered as if they had been updated in every frame since the last computation.
+  const float frames = static_cast<float>(std::max(framesSinceLastStart, 1u));
+  input.kickHeatTakeNewPercent = kickHeatTakeNewPercent > 0.99f ? kickHeatTakeNewPercent : 1.f - std::pow(1.f - kickHeatTakeNewPercent, frames);
+  input.goalKickHeatTakeNewPercent = goalKickHeatTakeNewPercent > 0.99f ? goalKickHeatTakeNewPercent : 1.f - std::pow(1.f - goalKickHeatTakeNewPercent, frames);
+  input.updateStaticHeat = !staticHeatValid || lastFieldDimensionsUpdate != theFieldDimensions.lastUpdate;
+  input.timestamp = theFrameInfo.time;
+  return input;
+}
+
+HeatMapProvider::HeatMaps HeatMapProvider::compute(const Input& input, const std::atomic<bool>& cancelled)
+{
+  HeatMaps heatMaps = input.heatMaps;
+  for (int indexX = 0; indexX < HeatMap::CELL_COUNT_X && !cancelled; ++indexX)
+    for (int indexY = 0; indexY < HeatMap::CELL_COUNT_Y; ++indexY)
+      updateCell(HeatMap::indexesToIndex(indexX, indexY), input, heatMaps);
+  heatMaps.collection.timestamp = input.timestamp;
+  return heatMaps;
+}
+
+void HeatMapProvider::updateCell(const int index, const Input& input, HeatMaps& heatMaps)
+{
+  const FieldDimensions& theFieldDimensions = input.fieldDimensions;
+  HeatMapCollection& localHeatMapCollection = heatMaps.collection;
+  const Vector2f fieldPosition = HeatMap::indexToField(index, theFieldDimensions);
+
+  if (input.updateStaticHeat)
+  {
+    localHeatMapCollection.sidesHeatMap.setHeat(std::pow(HeatMapUtils::getSidesHeat(fieldPosition, theFieldDimensions), 2.f), index, theFieldDimensions);
+    localHeatMapCollection.goalsHeatMap.setHeat(HeatMapUtils::getGoalsHeat(fieldPosition, theFieldDimensions), index, theFieldDimensions);
+  }
+
+  const auto [teammatesKickHeat, teammatesGoalKickHeat] =
+      HeatMapUtils::getRobotHeatForPosition(fieldPosition, input.teammateRobots, FieldUtils::getOpponentGoalCenter(theFieldDimensions), theFieldDimensions);
+  const auto [opponentsKickHeat, opponentsGoalKickHeat] =
+      HeatMapUtils::getRobotHeatForPosition(fieldPosition, input.opponentRobots, FieldUtils::getOwnGoalCenter(theFieldDimensions), theFieldDimensions);
+
+
+  if (input.kickHeatTakeNewPercent > 0.99f)
+  {
+    heatMaps.teammatesKickHeatMap.setHeat(teammatesKickHeat, index, theFieldDimensions);
+    localHeatMapCollection.opponentKickHeatMap.setHeat(opponentsKickHeat, index, theFieldDimensions);
+  }
+  else
+  {
+    heatMaps.teammatesKickHeatMap.updateHeat(input.kickHeatTakeNewPercent, teammatesKickHeat, index, theFieldDimensions);
+    localHeatMapCollection.opponentKickHeatMap.updateHeat(input.kickHeatTakeNewPercent, opponentsKickHeat, index, theFieldDimensions);
+  }
+
+  if (input.goalKickHeatTakeNewPercent > 0.99f)
+  {
+    heatMaps.teammatesGoalKickHeatMap.setHeat(teammatesGoalKickHeat, index, theFieldDimensions);
+    localHeatMapCollection.opponentGoalKickHeatMap.setHeat(opponentsGoalKickHeat, index, theFieldDimensions);
+  }
+  else
+  {
+    heatMaps.teammatesGoalKickHeatMap.updateHeat(input.goalKickHeatTakeNewPercent, teammatesGoalKickHeat, index, theFieldDimensions);
+    localHeatMapCollection.opponentGoalKickHeatMap.updateHeat(input.goalKickHeatTakeNewPercent, opponentsGoalKickHeat, index, theFieldDimensions);
+  }
+
+  // Apply instant heat
+  const auto [selfKickHeat, selfGoalKickHeat] =
+      HeatMapUtils::getRobotHeatForPosition(fieldPosition, input.selfPose, FieldUtils::getOpponentGoalCenter(theFieldDimensions), theFieldDimensions);
+  const float teamKickHeat = std::max(heatMaps.teammatesKickHeatMap.getHeat(index), selfKickHeat);
+  const float teamGoalKickHeat = std::max(heatMaps.teammatesGoalKickHeatMap.getHeat(index), selfGoalKickHeat);
+  localHeatMapCollection.teamKickHeatMap.setHeat(teamKickHeat, index, theFieldDimensions);
+  localHeatMapCollection.teamGoalKickHeatMap.setHeat(teamGoalKickHeat, index, theFieldDimensions);
 }
 
 void HeatMapProvider::update(HeatMapCollection& heatMapCollection)
 {
-  heatMapCollection = localHeatMapCollection;
-  firstUpdate = false;
+  ++framesSinceLastStart;
+  const bool busy = computation.isBusy();
+  if (computation.fetch(heatMaps))
+    heatMaps.collection.version = computation.getVersion();
+
+  if (!staticHeatValid)
+  {
+    // The first heat maps are computed in this frame, so that they are never empty.
+    heatMaps = compute(getInput(), std::atomic<bool>(false));
+    staticHeatValid = true;
+    lastFieldDimensionsUpdate = theFieldDimensions.lastUpdate;
+    framesSinceLastStart = 0;
+  }
+  else if (lastFieldDimensionsUpdate != theFieldDimensions.lastUpdate)
+  {
+    // A computation based on the old field would be useless.
+    computation.restart(getInput());
+    lastFieldDimensionsUpdate = theFieldDimensions.lastUpdate;
+    framesSinceLastStart = 0;
+  }
+  else if (!busy && computation.start(getInput()))
+    framesSinceLastStart = 0;
+
+  heatMapCollection = heatMaps.collection;
 
   DECLARE_DEBUG_DRAWING(DRAW_HEAT_MAP, "drawingOnField");
   COMPLEX_DRAWING(DRAW_HEAT_MAP)
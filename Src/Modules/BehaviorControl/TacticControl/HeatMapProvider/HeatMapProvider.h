@@ -17,6 +17,7 @@
 #include "Representations/Modeling/DangerMap.h"
 #include "Representations/Modeling/RobotMap.h"
 #include "Representations/Modeling/RobotPose.h"
+#include "Tools/Module/AsyncComputation.h"
 #include "Tools/Module/Module.h"
 #include "Tools/Streams/InStreams.h"
 #include "Representations/Modeling/HeatMapCollection.h"
@@ -30,7 +31,6 @@ MODULE(HeatMapProvider,
   REQUIRES(RobotMap),
   REQUIRES(RobotPose),
   REQUIRES(TeammateData),
-  HAS_PREEXECUTION,
   PROVIDES(HeatMapCollection),
 
   LOADS_PARAMETERS(,
@@ -39,16 +39,57 @@ MODULE(HeatMapProvider,
   )
 );
 
+/**
+ * The heat maps are computed in the background over several frames. Each frame
+ * provides the heat maps completed most recently and starts the next computation
+ * if the previous one is done.
+ */
 class HeatMapProvider : public HeatMapProviderBase
 {
 public:
   HeatMapProvider();
-  void execute(tf::Subflow&);
   void update(HeatMapCollection& heatMapCollection);
 
 private:
-  bool firstUpdate = true;
-  HeatMap teammatesKickHeatMap;
-  HeatMap teammatesGoalKickHeatMap;
-  HeatMapCollection localHeatMapCollection;
+  /** The heat maps, which each computation continues. */
+  struct HeatMaps
+  {
+    HeatMap teammatesKickHeatMap;
+    HeatMap teammatesGoalKickHeatMap;
+    HeatMapCollection collection;
+  };
+
+  /** Everything a computation needs, copied, since it runs while the blackboard changes. */
+  struct Input
+  {
+    HeatMaps heatMaps;
+    FieldDimensions fieldDimensions;
+    std::vector<Pose2f> teammateRobots;
+    std::vector<Pose2f> opponentRobots;
+    std::vector<Pose2f> selfPose;
+    float kickHeatTakeNewPercent; /**< The ratio taken from the new heat, already adapted to the frames since the last computation. */
+    float goalKickHeatTakeNewPercent; /**< The ratio taken from the new goal kick heat, already adapted to the frames since the last computation. */
+    bool updateStaticHeat; /**< Must the heat of the sides and the goals be computed? */
+    unsigned timestamp; /**< The time of the frame the input was taken from. */
+  };
+
+  /**
+   * Computes the heat maps. This runs in the background.
+   * @param input The input.
+   * @param cancelled Was the computation cancelled?
+   * @return The heat maps.
+   */
+  static HeatMaps compute(const Input& input, const std::atomic<bool>& cancelled);
+
+  /** Updates all heat maps at the cell with the given index. */
+  static void updateCell(int index, const Input& input, HeatMaps& heatMaps);
+
+  /** @return The input for the next computation based on the current frame. */
+  Input getInput() const;
+
+  HeatMaps heatMaps; /**< The heat maps completed most recently. */
+  bool staticHeatValid = false; /**< Were the heat of the sides and the goals computed? */
+  unsigned lastFieldDimensionsUpdate = 0;
+  unsigned framesSinceLastStart = 0;
+  AsyncComputation<Input, HeatMaps> computation{&HeatMapProvider::compute};
 };
@@ -69,6 +69,7 @@ public:
 
     float minDistance = MAX_DISTANCE;
     float maxGoalKickHeat = 0.f;
+    const Angle cellPositionToGoalAngle = (goalCenter - cellPosition).angle();
 
     for (const Pose2f& robotPose : robotPoses)
     {
@@ -86,7 +87,6 @@ public:
       }
 
       // find minDistanceToGoalKick
-      const Angle cellPositionToGoalAngle = (goalCenter - cellPosition).angle();
       const Angle robotPositionToCellPositionAngle = (cellPosition - robotPose.translation).angle();
       const Angle angleDiff = MathUtils::getAngleSmallestDiff(cellPositionToGoalAngle, robotPositionToCellPositionAngle);
       const float angleMultiplier = std::pow(std::max(0.f, 1.f - angleDiff / MAX_GOAL_KICK_HEAT_ANGLE), 1 / 2.f);
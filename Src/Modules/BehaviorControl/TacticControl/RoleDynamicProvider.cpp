@@ -184,17 +184,21 @@ void RoleDynamicProvider::findBestRoleAssignment(RoleSymbols& roleSymbols)
   // get total number of possible combinations of assignments
   int possibilities = factorial(playerCount);
 
+  // the walking distance of each player to each role does not depend on the assignment
+  constexpr int numOfPlayerNumbers = MAX_NUM_PLAYERS + 1;
+  std::vector<float> walkDistances(playerCount * numOfPlayerNumbers, 0.f);
+  for (int j = 0; j < playerCount; j++)
+    for (const int playerNumber : playerNumbers)
+      walkDistances[j * numOfPlayerNumbers + playerNumber] = (robotPoses[playerNumber].translation - rolePositions[roles[j]]).norm();
+
+  std::vector<float> currentWalkDistances(playerCount, 0.f); // walking distances for the current assignment
   for (int i = 0; i < possibilities; i++)
   {
     // get next permutation of possible player to position assignments
     std::next_permutation(playerNumbers.begin(), playerNumbers.end());
 
-    std::vector<float> currentWalkDistances(playerCount, 0.f); // walking distances for this assignment
     for (int j = 0; j < playerCount; j++)
-    {
-      Vector2f optPosition = rolePositions[roles[j]];
-      currentWalkDistances.at(j) = (robotPoses[playerNumbers[j]].translation - optPosition).norm();
-    }
+      currentWalkDistances[j] = walkDistances[j * numOfPlayerNumbers + playerNumbers[j]];
 
     std::sort(currentWalkDistances.begin(), currentWalkDistances.end(), std::greater<>());
     for (int p = 0; p < playerCount; p++)
@@ -42,15 +42,19 @@ public:
       const KickWheel& theKickWheel);
 
 private:
-  static std::vector<SelectableDirection> getSelectableDirections(const Vector2f& ballPosition, const Filterer& filterer, const KickWheel& theKickWheel);
+  static std::vector<SelectableDirection> getSelectableDirections(const Vector2f& ballPosition, const Filterer& filterer, const Filterer::OrderedFilters& filters, const KickWheel& theKickWheel);
 
-  static void addSelectableTargets(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer& filterer);
+  static void addSelectableTargets(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer::OrderedFilters& filters);
   static void addSelectableTargetsFromStaticKick(
-      std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer& filterer);
-  static void addSelectableTargetsFromAdjustableKick(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer& filterer);
-  static void addSelectableTargetsForDistance(
-      std::vector<SelectableTarget>& selectableTargets, const float targetDistance, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer& filterer);
+      std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer::OrderedFilters& filters);
+  static void addSelectableTargetsFromAdjustableKick(
+      std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer::OrderedFilters& filters);
+  static void addSelectableTargetsForDistance(std::vector<SelectableTarget>& selectableTargets,
+      const float targetDistance,
+      const SelectableDirection& selectableDirection,
+      const SelectableKick& selectableKick,
+      const Filterer::OrderedFilters& filters);
 
   static std::optional<SelectablePose> getBestSelectablePose(
-      const Pose2f& playerPose, const SelectableTarget& selectableTarget, const Filterer& filterer, const Factors& factors, const TacticSymbols& theTacticSymbols);
+      const Pose2f& playerPose, const SelectableTarget& selectableTarget, const Filterer::OrderedFilters& filters, const Factors& factors, const TacticSymbols& theTacticSymbols);
 };
@@ -15,14 +15,14 @@ std::optional<KickPlan> SelectFunctions::createAndFilterAndSelect(const Pose2f&
     const RobotMap& theRobotMap,
     const TacticSymbols& theTacticSymbols)
 {
-  std::vector<SelectableDirection> selectableDirections = getSelectableDirections(ballPosition, filterer, theKickWheel);
+  const Filterer::OrderedFilters filters = filterer.getEfficientlyOrderedFilters();
+
+  std::vector<SelectableDirection> selectableDirections = getSelectableDirections(ballPosition, filterer, filters, theKickWheel);
   if (selectableDirections.empty())
   {
     return {};
   }
 
-  const std::vector<std::function<bool(SelectableKick&)>> selectableKickFilters = filterer.getEfficientlyOrderedSelectableKickFilters();
-
   std::vector<Vector2f> draw_targets = {};
   std::vector<float> draw_scores = {};
   std::optional<KickPlan> bestKickPlan = {};
@@ -31,7 +31,7 @@ std::optional<KickPlan> SelectFunctions::createAndFilterAndSelect(const Pose2f&
   {
     SelectableKick selectableKick = {kick};
     bool valid = true;
-    for (const auto& filter : selectableKickFilters)
+    for (const auto& filter : filters.kickFilters)
     {
       if (filter(selectableKick))
       {
@@ -47,7 +47,7 @@ std::optional<KickPlan> SelectFunctions::createAndFilterAndSelect(const Pose2f&
     std::vector<SelectableTarget> selectableTargets = {};
     for (const SelectableDirection& selectableDirection : selectableDirections)
     {
-      addSelectableTargets(selectableTargets, selectableDirection, kick, filterer);
+      addSelectableTargets(selectableTargets, selectableDirection, kick, filters);
     }
     if (selectableTargets.empty())
     {
@@ -57,7 +57,7 @@ std::optional<KickPlan> SelectFunctions::createAndFilterAndSelect(const Pose2f&
     std::vector<SelectablePose> selectablePoses = {};
     for (SelectableTarget& selectableTarget : selectableTargets)
     {
-      auto selectablePoseOptional = getBestSelectablePose(playerPose, selectableTarget, filterer, factors, theTacticSymbols);
+      auto selectablePoseOptional = getBestSelectablePose(playerPose, selectableTarget, filters, factors, theTacticSymbols);
       if (selectablePoseOptional.has_value())
       {
         selectablePoses.push_back(selectablePoseOptional.value());
@@ -145,9 +145,9 @@ std::optional<KickPlan> SelectFunctions::filterAndSelect(std::vector<KickPlan>&
     {
       continue;
     }
+    SelectableDirection selectableDirection = {kickPlan.selectablePose.selectableTarget.ballPosition, angle, distanceInfo.distance, distanceInfo.distanceBlocked, distanceInfo.distanceOutside};
     for (const auto& filter : selectableDirectionFilters)
     {
-      SelectableDirection selectableDirection = {kickPlan.selectablePose.selectableTarget.ballPosition, angle, distanceInfo.distance, distanceInfo.distanceBlocked, distanceInfo.distanceOutside};
       if (filter(selectableDirection))
       {
         valid = false;
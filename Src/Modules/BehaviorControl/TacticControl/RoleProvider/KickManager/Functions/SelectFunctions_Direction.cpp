@@ -1,6 +1,6 @@
 #include "SelectFunctions.h"
 
-std::vector<SelectableDirection> SelectFunctions::getSelectableDirections(const Vector2f& ballPosition, const Filterer& filterer, const KickWheel& theKickWheel)
+std::vector<SelectableDirection> SelectFunctions::getSelectableDirections(const Vector2f& ballPosition, const Filterer& filterer, const Filterer::OrderedFilters& filters, const KickWheel& theKickWheel)
 {
   std::vector<SelectableDirection> selectableDirections = {};
   const int max_i = (int)theKickWheel.blockedDistances.size();
@@ -36,7 +36,7 @@ std::vector<SelectableDirection> SelectFunctions::getSelectableDirections(const
     SelectableDirection selectableDirection = {ballPosition, theKickWheel.angles.at(i), distance, distanceBlocked, distanceOutside};
 
     bool remove = false;
-    for (const auto& filter : filterer.getEfficientlyOrderedSelectableDirectionFilters())
+    for (const auto& filter : filters.directionFilters)
     {
       if ((filter)(selectableDirection))
       {
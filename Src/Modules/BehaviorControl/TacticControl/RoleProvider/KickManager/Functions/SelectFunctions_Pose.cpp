@@ -1,7 +1,7 @@
 #include "SelectFunctions.h"
 
 std::optional<SelectablePose> SelectFunctions::getBestSelectablePose(
-    const Pose2f& playerPose, const SelectableTarget& selectableTarget, const Filterer& filterer, const Factors& factors, const TacticSymbols& theTacticSymbols)
+    const Pose2f& playerPose, const SelectableTarget& selectableTarget, const Filterer::OrderedFilters& filters, const Factors& factors, const TacticSymbols& theTacticSymbols)
 {
   const Pose2f pose1 = selectableTarget.selectableKick.kick->getKickPose(selectableTarget.ballPosition, selectableTarget.target, true);
   const Pose2f pose2 = selectableTarget.selectableKick.kick->getKickPose(selectableTarget.ballPosition, selectableTarget.target, false);
@@ -9,7 +9,7 @@ std::optional<SelectablePose> SelectFunctions::getBestSelectablePose(
   SelectablePose selectablePose2 = {playerPose, selectableTarget, pose2, false};
   bool pose1Valid = true;
   bool pose2Valid = true;
-  for (const auto& filter : filterer.getEfficientlyOrderedSelectablePoseFilters())
+  for (const auto& filter : filters.poseFilters)
   {
     if (pose1Valid && filter(selectablePose1))
     {
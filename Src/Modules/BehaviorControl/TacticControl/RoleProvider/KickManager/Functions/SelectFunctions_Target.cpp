@@ -1,18 +1,18 @@
 #include "SelectFunctions.h"
 
-void SelectFunctions::addSelectableTargets(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer& filterer)
+void SelectFunctions::addSelectableTargets(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer::OrderedFilters& filters)
 {
   if (kick->isDistanceAdjustable())
   {
-    addSelectableTargetsFromAdjustableKick(selectableTargets, selectableDirection, kick, filterer);
+    addSelectableTargetsFromAdjustableKick(selectableTargets, selectableDirection, kick, filters);
   }
   else
   {
-    addSelectableTargetsFromStaticKick(selectableTargets, selectableDirection, kick, filterer);
+    addSelectableTargetsFromStaticKick(selectableTargets, selectableDirection, kick, filters);
   }
 }
 
-void SelectFunctions::addSelectableTargetsFromAdjustableKick(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer& filterer)
+void SelectFunctions::addSelectableTargetsFromAdjustableKick(std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, Kick* kick, const Filterer::OrderedFilters& filters)
 {
   const int DISTANCE_STEPS_COUNT = 5;
 
@@ -29,12 +29,12 @@ void SelectFunctions::addSelectableTargetsFromAdjustableKick(std::vector<Selecta
   const float distanceStepSize = maxDistance / DISTANCE_STEPS_COUNT;
   for (float targetDistance = kick->getMinDistance(false, false); targetDistance < maxDistance; targetDistance = targetDistance + distanceStepSize)
   {
-    addSelectableTargetsForDistance(selectableTargets, targetDistance, selectableDirection, kick, filterer);
+    addSelectableTargetsForDistance(selectableTargets, targetDistance, selectableDirection, kick, filters);
   }
 }
 
 void SelectFunctions::addSelectableTargetsFromStaticKick(
-    std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer& filterer)
+    std::vector<SelectableTarget>& selectableTargets, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer::OrderedFilters& filters)
 {
   float targetDistance;
   if (selectableDirection.distanceOutside)
@@ -57,16 +57,16 @@ void SelectFunctions::addSelectableTargetsFromStaticKick(
     targetDistance = std::min(selectableDirection.distance, selectableKick.kick->getRealisticDistance());
   }
 
-  addSelectableTargetsForDistance(selectableTargets, targetDistance, selectableDirection, selectableKick, filterer);
+  addSelectableTargetsForDistance(selectableTargets, targetDistance, selectableDirection, selectableKick, filters);
 }
 
 void SelectFunctions::addSelectableTargetsForDistance(
-    std::vector<SelectableTarget>& selectableTargets, const float targetDistance, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer& filterer)
+    std::vector<SelectableTarget>& selectableTargets, const float targetDistance, const SelectableDirection& selectableDirection, const SelectableKick& selectableKick, const Filterer::OrderedFilters& filters)
 {
   Vector2f targetPosition = selectableDirection.ballPosition + targetDistance * selectableDirection.direction;
   SelectableTarget selectableTarget = {selectableKick, selectableDirection.ballPosition, targetPosition};
   bool remove = false;
-  for (const auto& filter : filterer.getEfficientlyOrderedSelectableTargetFilters())
+  for (const auto& filter : filters.targetFilters)
   {
     if ((filter)(selectableTarget))
     {
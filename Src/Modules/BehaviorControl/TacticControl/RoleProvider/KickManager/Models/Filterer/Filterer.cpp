@@ -1,5 +1,13 @@
 #include "Filterer.h"
 
+[[nodiscard]] Filterer::OrderedFilters Filterer::getEfficientlyOrderedFilters() const
+{
+  return {getEfficientlyOrderedSelectableKickFilters(),
+      getEfficientlyOrderedSelectableDirectionFilters(),
+      getEfficientlyOrderedSelectableTargetFilters(),
+      getEfficientlyOrderedSelectablePoseFilters()};
+}
+
 [[nodiscard]] std::vector<std::function<bool(SelectableKick&)>> Filterer::getEfficientlyOrderedSelectableKickFilters() const
 {
   std::vector<std::function<bool(SelectableKick&)>> efficientlyOrderedFilters = {};
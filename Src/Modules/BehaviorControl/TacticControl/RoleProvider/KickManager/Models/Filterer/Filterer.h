@@ -17,6 +17,18 @@ class Filterer
 {
 
 public:
+  /** The filters of all stages in the order in which they are applied. */
+  struct OrderedFilters
+  {
+    std::vector<std::function<bool(SelectableKick&)>> kickFilters;
+    std::vector<std::function<bool(SelectableDirection&)>> directionFilters;
+    std::vector<std::function<bool(SelectableTarget&)>> targetFilters;
+    std::vector<std::function<bool(SelectablePose&)>> poseFilters;
+  };
+
+  /** Collects the filters of all stages once, so they need not be copied for each candidate. */
+  [[nodiscard]] OrderedFilters getEfficientlyOrderedFilters() const;
+
   [[nodiscard]] std::vector<std::function<bool(SelectableKick&)>> getEfficientlyOrderedSelectableKickFilters() const;
   [[nodiscard]] std::vector<std::function<bool(SelectableDirection&)>> getEfficientlyOrderedSelectableDirectionFilters() const;
   [[nodiscard]] std::vector<std::function<bool(SelectableTarget&)>> getEfficientlyOrderedSelectableTargetFilters() const;
@@ -8,6 +8,7 @@
 #include "Representations/Modeling/RobotMap.h"
 #include "Representations/MotionControl/MotionInfo.h"
 #include "Representations/Sensing/RobotModel.h"
+#include <array>
 #include <optional>
 
 Pose2f KickUtils::getKickPose(const Angle& robotRotation, const Vector2f& ballPosition, const bool mirror, const float afterRotation_optDistanceToBallX, const float afterRotation_optDistanceToBallY)
@@ -90,60 +91,32 @@ float KickUtils::getMinKickToGoalPostDistance(const Vector2f& ballPosition, cons
 {
   const float goalPostRadius = theFieldDimensions.goalPostRadius;
 
-  const Vector2f ownLeftGoalPost = {theFieldDimensions.xPosOwnGoalPost, theFieldDimensions.yPosLeftGoal};
-  const Vector2f ownRightGoalPost = {theFieldDimensions.xPosOwnGoalPost, theFieldDimensions.yPosRightGoal};
-  const Vector2f opponentLeftGoalPost = {theFieldDimensions.xPosOpponentGoalPost, theFieldDimensions.yPosLeftGoal};
-  const Vector2f opponentRightGoalPost = {theFieldDimensions.xPosOpponentGoalPost, theFieldDimensions.yPosRightGoal};
-
-  std::vector<Vector2f> goalPostPositions = {};
-  goalPostPositions.push_back(ownLeftGoalPost);
-  goalPostPositions.push_back(ownRightGoalPost);
-  goalPostPositions.push_back(opponentLeftGoalPost);
-  goalPostPositions.push_back(opponentRightGoalPost);
-
-  return getMinDistance(ballPosition, targetPosition, goalPostPositions) - goalPostRadius;
+  const std::array<Vector2f, 4> goalPostPositions = {Vector2f(theFieldDimensions.xPosOwnGoalPost, theFieldDimensions.yPosLeftGoal),
+      Vector2f(theFieldDimensions.xPosOwnGoalPost, theFieldDimensions.yPosRightGoal),
+      Vector2f(theFieldDimensions.xPosOpponentGoalPost, theFieldDimensions.yPosLeftGoal),
+      Vector2f(theFieldDimensions.xPosOpponentGoalPost, theFieldDimensions.yPosRightGoal)};
+
+  return getMinDistance(ballPosition,
+             targetPosition,
+             goalPostPositions,
+             [](const Vector2f& goalPostPosition) -> const Vector2f&
+             {
+               return goalPostPosition;
+             })
+      - goalPostRadius;
 }
 
 float KickUtils::getMinRobotToKickDistance(const Vector2f& ballPosition, const Vector2f& targetPosition, const RobotMap& theRobotMap)
 {
   const float ROBOT_RADIUS = 140.f / 2.f;
-  std::vector<Vector2f> robotPositions = {};
-  for (auto& robot : theRobotMap.robots)
-  {
-    robotPositions.push_back(robot.pose.translation);
-  }
-  return getMinDistance(ballPosition, targetPosition, robotPositions) - ROBOT_RADIUS;
-}
-
-float KickUtils::getMinDistance(const Vector2f& ballPosition, const Vector2f& targetPosition, const std::vector<Vector2f>& obstacles)
-{
-  // TODO Method is very inefficient
-
-  const Vector2f kickDirection = (targetPosition - ballPosition).normalized();
-
-  Geometry::Line kickLine = {ballPosition, kickDirection};
-  Geometry::Line ballBorder = {ballPosition, Vector2f(kickDirection).rotateRight()};
-  Geometry::Line targetBorder = {targetPosition, Vector2f(kickDirection).rotateLeft()};
-
-  float minDistance = std::numeric_limits<float>::infinity();
-
-  for (const Vector2f& obstacle : obstacles)
-  {
-    float distance = Geometry::distance(targetPosition, obstacle);
-    distance = std::min(distance, Geometry::distance(ballPosition, obstacle));
-
-    if (Geometry::isPointLeftOfLine(obstacle, ballBorder) && Geometry::isPointLeftOfLine(obstacle, targetBorder))
-    {
-      distance = std::min(distance, std::abs(Geometry::getDistanceToLine(kickLine, obstacle)));
-    }
-
-    if (distance < minDistance)
-    {
-      minDistance = distance;
-    }
-  }
-
-  return minDistance;
+  return getMinDistance(ballPosition,
+             targetPosition,
+             theRobotMap.robots,
+             [](const RobotMapEntry& robot) -> const Vector2f&
+             {
+               return robot.pose.translation;
+             })
+      - ROBOT_RADIUS;
 }
 
 float KickUtils::getMinFieldBorderToKickDistance(const Vector2f& ballPosition, const Vector2f& targetPosition, const FieldDimensions& theFieldDimensions)
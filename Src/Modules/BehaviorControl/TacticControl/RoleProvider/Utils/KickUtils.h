@@ -6,6 +6,9 @@
 #include "Representations/Modeling/RobotMap.h"
 #include "Representations/MotionControl/MotionInfo.h"
 #include "Representations/Sensing/RobotModel.h"
+#include "Tools/Math/BHMath.h"
+#include <cmath>
+#include <limits>
 #include <optional>
 
 class KickUtils
@@ -47,5 +50,39 @@ public:
   static bool isBallKicked(const MotionInfo& theMotionInfo);
 
 private:
-  static float getMinDistance(const Vector2f& ballPosition, const Vector2f& targetPosition, const std::vector<Vector2f>& obstacles);
+  /**
+   * Determines the distance of the obstacle closest to the kick from the ball to the target, i.e. the distance
+   * to the line segment between both positions. The obstacles are iterated in place to avoid copying them for
+   * each of the many targets a kick is scored for.
+   * @param obstacles A range of obstacles.
+   * @param getPosition Returns the position of an obstacle.
+   */
+  template <typename Obstacles, typename GetPosition>
+  static float getMinDistance(const Vector2f& ballPosition, const Vector2f& targetPosition, const Obstacles& obstacles, GetPosition getPosition);
 };
+
+template <typename Obstacles, typename GetPosition>
+float KickUtils::getMinDistance(const Vector2f& ballPosition, const Vector2f& targetPosition, const Obstacles& obstacles, GetPosition getPosition)
+{
+  const Vector2f kickDirection = (targetPosition - ballPosition).normalized();
+
+  const Geometry::Line kickLine = {ballPosition, kickDirection};
+  const Geometry::Line ballBorder = {ballPosition, Vector2f(kickDirection).rotateRight()};
+  const Geometry::Line targetBorder = {targetPosition, Vector2f(kickDirection).rotateLeft()};
+
+  // Compare the squared distances and only take the root of the smallest one
+  float minSquaredDistance = std::numeric_limits<float>::infinity();
+
+  for (const auto& obstacle : obstacles)
+  {
+    const Vector2f& position = getPosition(obstacle);
+    float squaredDistance = std::min((targetPosition - position).squaredNorm(), (ballPosition - position).squaredNorm());
+
+    if (Geometry::isPointLeftOfLine(position, ballBorder) && Geometry::isPointLeftOfLine(position, targetBorder))
+      squaredDistance = std::min(squaredDistance, sqr(Geometry::getDistanceToLine(kickLine, position)));
+
+    minSquaredDistance = std::min(minSquaredDistance, squaredDistance);
+  }
+
+  return std::sqrt(minSquaredDistance);
+}
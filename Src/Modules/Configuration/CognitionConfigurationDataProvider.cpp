@@ -101,18 +101,24 @@ void CognitionConfigurationDataProvider::update(USBSettings& usbSettings)
 
 void CognitionConfigurationDataProvider::update(FieldDimensions& fieldDimensions)
 {
+  bool changed = false;
   if (theFieldDimensions)
   {
     fieldDimensions = *theFieldDimensions;
     theFieldDimensions.reset();
+    changed = true;
   }
 
   if ((theUSBStatus.status == USBStatus::MountStatus::readOnly || theUSBStatus.status == USBStatus::MountStatus::readWrite) && lastMountTimestamp != theUSBStatus.mountTimestamp)
   {
     lastMountTimestamp = theUSBStatus.mountTimestamp;
     fieldDimensions.loadFromJsonFile(theUSBStatus.path + "/field_dimensions.json");
+    changed = true;
   }
 
+  if (!changed)
+    reportUnchanged(fieldDimensions);
+
   fieldDimensions.drawPolygons(theOwnTeamInfo.fieldPlayerColour);
 }
 
@@ -132,6 +138,8 @@ void CognitionConfigurationDataProvider::update(RobotDimensions& robotDimensions
     robotDimensions = *theRobotDimensions;
     theRobotDimensions.reset();
   }
+  else
+    reportUnchanged(robotDimensions);
 }
 
 void CognitionConfigurationDataProvider::update(HeadLimits& headLimits)
@@ -141,6 +149,8 @@ void CognitionConfigurationDataProvider::update(HeadLimits& headLimits)
     headLimits = *theHeadLimits;
     theHeadLimits.reset();
   }
+  else
+    reportUnchanged(headLimits);
 }
 
 void CognitionConfigurationDataProvider::update(OdometryCorrectionTables& odometryCorrectionTables)
@@ -150,6 +160,8 @@ void CognitionConfigurationDataProvider::update(OdometryCorrectionTables& odomet
     odometryCorrectionTables = *theOdometryCorrectionTables;
     theOdometryCorrectionTables.reset();
   }
+  else
+    reportUnchanged(odometryCorrectionTables);
 }
 
 void CognitionConfigurationDataProvider::readFieldDimensions()
@@ -0,0 +1,74 @@
+/**
+ * @file Modules/Infrastructure/CameraControlRequestProvider.cpp
+ * This file implements a module that controls the exposure and the white balance
+ * of the cameras from the statistics of the field color samples.
+ */
+
+#include "CameraControlRequestProvider.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+void CameraControlRequestProvider::update(CameraControlRequest& cameraControlRequest)
+{
+  if (!controlExposure && !controlWhiteBalance)
+  {
+    // the controls start from the camera settings again when they are enabled
+    cameraControlRequest = CameraControlRequest();
+    return;
+  }
+
+  // the statistics are not updated if the robot is not upright
+  if (theFallDownState.state != FallDownState::upright || (lastControlTime && theFrameInfo.getTimeSince(lastControlTime) < controlInterval))
+    return;
+  lastControlTime = theFrameInfo.time;
+
+  control(theFieldColors, theCameraSettingsV6, cameraControlRequest.lower);
+  control(theFieldColorsUpper, theCameraSettingsUpperV6, cameraControlRequest.upper);
+}
+
+void CameraControlRequestProvider::control(const FieldColors& fieldColors, const CameraSettingsV6& cameraSettings, CameraControlRequest::Controls& controls) const
+{
+  if (controlExposure && !controls.controlExposure)
+  {
+    controls.exposure = std::clamp(cameraSettings.settings[CameraSettingsV6::Exposure].value, minExposure, maxExposure);
+    controls.gain = std::clamp(cameraSettings.settings[CameraSettingsV6::Gain].value, std::max(minGain, 1), maxGain);
+  }
+  else if (controlExposure && fieldColors.sampleYAvg > 0)
+  {
+    float factor = 1.f;
+    if (fieldColors.clippedRatio > maxClippedRatio)
+      factor = 1.f / maxBrightnessStep;
+    else if (std::abs(targetY - fieldColors.sampleYAvg) > yDeadband)
+      factor = std::clamp(static_cast<float>(targetY) / static_cast<float>(fieldColors.sampleYAvg), 1.f / maxBrightnessStep, maxBrightnessStep);
+
+    // the exposure is raised first, because a higher gain adds noise
+    if (factor != 1.f)
+    {
+      const float brightness = static_cast<float>(controls.exposure) * static_cast<float>(controls.gain) * factor;
+      const int gain = std::max(minGain, 1);
+      controls.exposure = std::clamp(static_cast<int>(std::lround(brightness / static_cast<float>(gain))), std::max(minExposure, 1), maxExposure);
+      controls.gain = std::clamp(static_cast<int>(std::lround(brightness / static_cast<float>(controls.exposure))), gain, maxGain);
+    }
+  }
+  controls.controlExposure = controlExposure;
+
+  if (controlWhiteBalance && !controls.controlWhiteBalance)
+  {
+    const int whiteBalance = cameraSettings.settings[CameraSettingsV6::WhiteBalance].value;
+    controls.whiteBalance = whiteBalance >= minWhiteBalance && whiteBalance <= maxWhiteBalance ? whiteBalance : (minWhiteBalance + maxWhiteBalance) / 2;
+  }
+  else if (controlWhiteBalance && fieldColors.whiteSamples >= minWhiteSamples)
+  {
+    // White looks bluish if the camera assumes a lower color temperature than the actual one.
+    const int difference = fieldColors.whiteCbAvg - fieldColors.whiteCrAvg;
+    if (std::abs(difference) > whiteBalanceDeadband)
+    {
+      const int step = std::clamp(static_cast<int>(static_cast<float>(difference) * whiteBalanceFactor), -maxWhiteBalanceStep, maxWhiteBalanceStep);
+      controls.whiteBalance = std::clamp(controls.whiteBalance + step, minWhiteBalance, maxWhiteBalance);
+    }
+  }
+  controls.controlWhiteBalance = controlWhiteBalance;
+}
+
+MAKE_MODULE(CameraControlRequestProvider, cognitionInfrastructure)
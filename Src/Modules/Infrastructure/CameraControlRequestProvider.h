@@ -0,0 +1,58 @@
+/**
+ * @file Modules/Infrastructure/CameraControlRequestProvider.h
+ * This file declares a module that controls the exposure and the white balance
+ * of the cameras from the statistics of the field color samples, so that lighting
+ * changes during a game do not require recalibrating the camera settings.
+ */
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/CameraSettingsV6.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Perception/FieldColor.h"
+#include "Representations/Sensing/FallDownState.h"
+
+MODULE(CameraControlRequestProvider,
+  REQUIRES(CameraSettingsV6),
+  REQUIRES(CameraSettingsUpperV6),
+  REQUIRES(FallDownState),
+  REQUIRES(FieldColors),
+  REQUIRES(FieldColorsUpper),
+  REQUIRES(FrameInfo),
+  PROVIDES(CameraControlRequest),
+  LOADS_PARAMETERS(,
+    (bool) controlExposure, /**< Control exposure and gain instead of the auto exposure of the cameras? */
+    (bool) controlWhiteBalance, /**< Control the white balance instead of the auto white balance of the cameras? */
+    (int) controlInterval, /**< The time (in ms) between two changes, which must exceed the time the camera needs to apply them. */
+    (int) targetY, /**< The average brightness of the samples below the horizon that is aimed for. */
+    (int) yDeadband, /**< Deviations from targetY up to this are ignored. */
+    (float) maxClippedRatio, /**< If more samples are saturated, the image is made darker regardless of the average. */
+    (float) maxBrightnessStep, /**< The factor the brightness may change by per step. */
+    (int) minExposure, /**< The exposure range used. */
+    (int) maxExposure, /**< Longer exposures blur while walking, so the gain is raised beyond this. */
+    (int) minGain, /**< The gain range used. */
+    (int) maxGain,
+    (int) minWhiteSamples, /**< The number of white samples required to correct the white balance. */
+    (int) whiteBalanceDeadband, /**< Differences between cb and cr of white up to this are ignored. */
+    (float) whiteBalanceFactor, /**< Kelvin per unit of the difference between cb and cr of white. */
+    (int) maxWhiteBalanceStep, /**< The maximum change of the white balance in Kelvin per step. */
+    (int) minWhiteBalance, /**< The white balance range used in Kelvin. */
+    (int) maxWhiteBalance
+  )
+);
+
+class CameraControlRequestProvider : public CameraControlRequestProviderBase
+{
+  unsigned lastControlTime = 0; /**< When was the request changed the last time? */
+
+  void update(CameraControlRequest& cameraControlRequest);
+
+  /**
+   * Determines the next controls of a camera.
+   * @param fieldColors The statistics of the latest image of the camera.
+   * @param cameraSettings The settings the camera currently uses. They initialize the controls.
+   * @param controls The controls that are updated.
+   */
+  void control(const FieldColors& fieldColors, const CameraSettingsV6& cameraSettings, CameraControlRequest::Controls& controls) const;
+};
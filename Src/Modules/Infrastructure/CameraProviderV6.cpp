@@ -11,9 +11,15 @@
 #include "Tools/Streams/InStreams.h"
 #include "Tools/Debugging/Stopwatch.h"
 #include "Tools/Debugging/Annotation.h"
+#include "Tools/ImageProcessing/ImageKernels.h"
 #include "Tools/Settings.h"
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <thread>
+#ifdef CAMERA_INCLUDED
+#include <linux/videodev2.h>
+#endif
 
 CycleLocal<CameraProviderV6*> CameraProviderV6::theInstance(nullptr);
 
@@ -65,8 +71,9 @@ void CameraProviderV6::update(Image& image)
 
   if (lowerCamera->hasImage())
   {
-    image.setResolution(lowerCameraInfo.width, lowerCameraInfo.height);
+    image.setResolution(capturedLowerCameraInfo.width, capturedLowerCameraInfo.height);
     image.setImage(const_cast<unsigned char*>(lowerCamera->getImage()));
+    image.sharedFrame = lowerCamera->getFrame();
     lastImageTimeStampLL = lowerCamera->getTimeStamp();
     if (Global::getSettings().naoVersion == RobotConfig::V6)
     {
@@ -75,6 +82,7 @@ void CameraProviderV6::update(Image& image)
     }
     else
       imageTimeStamp = image.timeStamp = std::max(lastImageTimeStamp + 1, (unsigned)(lowerCamera->getTimeStamp() / 1000 - SystemCall::getSystemTimeBase()));
+    applyControls(lowerCameraSettings, theCameraControlRequest.lower);
     lowerCamera->setSettings(lowerCameraSettings);
     DEBUG_RESPONSE_ONCE("module:CameraProviderV6:DoWhiteBalanceLower") lowerCamera->doAutoWhiteBalance();
     //DEBUG_RESPONSE_ONCE("module:CameraProviderV6:ReadCameraSettingsLower") lowerCamera->readCameraSettings();
@@ -88,6 +96,8 @@ void CameraProviderV6::update(Image& image)
   // This prevents camera reset in case another module provides the images (e.g. ImageLogDataProvider).
   now = SystemCall::getRealSystemTime();
 #endif // CAMERA_INCLUDED
+
+  reduceImage(image, capturedLowerCameraInfo, lowerCameraInfo, reducedLowerImage);
 }
 
 void CameraProviderV6::update(ImageUpper& imageUpper)
@@ -114,10 +124,24 @@ void CameraProviderV6::update(ImageUpper& imageUpper)
 
   DEBUG_RESPONSE_ONCE("module:CameraProviderV6:outputCurrentValuesUpper") upperCamera->outputCurrentValues();
 
+  // In pipelined mode, the frame was started with the lower image only. Modules
+  // that only need the lower image run in parallel while this waits.
+  if (pipelined && !upperCamera->hasImage() && !upperCaptureFailed)
+  {
+    if (!upperCamera->captureNew(3000))
+    {
+      OUTPUT_WARNING("CameraProviderV6: Poll upper failed.");
+      upperCaptureFailed = true;
+    }
+    else if (upperCamera->getTimeStamp() < lastImageTimeStampLLUpper)
+      upperCamera->releaseImage(); // the image order is wrong, keep the old image
+  }
+
   if (upperCamera->hasImage())
   {
-    imageUpper.setResolution(upperCameraInfo.width, upperCameraInfo.height);
+    imageUpper.setResolution(capturedUpperCameraInfo.width, capturedUpperCameraInfo.height);
     imageUpper.setImage(const_cast<unsigned char*>(upperCamera->getImage()));
+    imageUpper.sharedFrame = upperCamera->getFrame();
     //lastImageTimeStampLLUpper is in micro seconds and 64 bit
     lastImageTimeStampLLUpper = upperCamera->getTimeStamp();
     if (Global::getSettings().naoVersion == RobotConfig::V6)
@@ -127,11 +151,12 @@ void CameraProviderV6::update(ImageUpper& imageUpper)
     }
     else
       imageTimeStampUpper = imageUpper.timeStamp = std::max(lastImageUpperTimeStamp + 1, (unsigned)(upperCamera->getTimeStamp() / 1000 - SystemCall::getSystemTimeBase()));
+    applyControls(upperCameraSettings, theCameraControlRequest.upper);
     upperCamera->setSettings(upperCameraSettings);
     DEBUG_RESPONSE_ONCE("module:CameraProviderV6:DoWhiteBalanceUpper") upperCamera->doAutoWhiteBalance();
     //DEBUG_RESPONSE_ONCE("module:CameraProviderV6:ReadCameraSettingsUpperV6") upperCamera->readCameraSettings();
     if (upperCamera->writeCameraSettings())
-      upperCameraSettings = (CameraSettingsUpperV6&)upperCamera->getSettings();
+      static_cast<CameraSettingsV6&>(upperCameraSettings) = upperCamera->getSettings();
   }
 
   ASSERT(imageUpper.timeStamp >= lastImageUpperTimeStamp);
@@ -152,6 +177,8 @@ void CameraProviderV6::update(ImageUpper& imageUpper)
   // */
 
 #endif // CAMERA_INCLUDED
+
+  reduceImage(imageUpper, capturedUpperCameraInfo, upperCameraInfo, reducedUpperImage);
 }
 
 void CameraProviderV6::update(FrameInfo& frameInfo)
@@ -162,11 +189,13 @@ void CameraProviderV6::update(FrameInfo& frameInfo)
 
 void CameraProviderV6::update(CameraInfo& cameraInfo)
 {
+  applyResolutionRequest();
   cameraInfo = lowerCameraInfo;
 }
 
 void CameraProviderV6::update(CameraInfoUpper& cameraInfoUpper)
 {
+  applyResolutionRequest();
   cameraInfoUpper = upperCameraInfo;
 }
 
@@ -187,6 +216,7 @@ void CameraProviderV6::update(CameraIntrinsics& cameraIntrinsics)
 
 void CameraProviderV6::update(CameraResolution& cameraResolution)
 {
+  applyResolutionRequest();
   cameraResolution = this->cameraResolution;
 }
 
@@ -227,37 +257,15 @@ bool CameraProviderV6::readCameraResolution()
 
 void CameraProviderV6::setupCameras()
 {
-  // set resolution
-  switch (cameraResolution.resolution)
-  {
-  case CameraResolution::Resolutions::upper640:
-    upperCameraInfo.width = 640;
-    upperCameraInfo.height = 480;
-    lowerCameraInfo.width = 320;
-    lowerCameraInfo.height = 240;
-    break;
-  case CameraResolution::Resolutions::lower640:
-    upperCameraInfo.width = 320;
-    upperCameraInfo.height = 240;
-    lowerCameraInfo.width = 640;
-    lowerCameraInfo.height = 480;
-    break;
-  case CameraResolution::Resolutions::both320:
-    upperCameraInfo.width = 320;
-    upperCameraInfo.height = 240;
-    lowerCameraInfo.width = 320;
-    lowerCameraInfo.height = 240;
-    break;
-  case CameraResolution::Resolutions::both640:
-    upperCameraInfo.width = 640;
-    upperCameraInfo.height = 480;
-    lowerCameraInfo.width = 640;
-    lowerCameraInfo.height = 480;
-    break;
-  default:
-    ASSERT(false);
-    break;
-  }
+  // set resolution, the images are reduced later by requests only
+  cameraResolution.upperRegionTop = 0.f;
+  capturedCameraResolution = cameraResolution;
+  const Vector2i upperSize = CameraResolution::getSize(cameraResolution.resolution, true);
+  const Vector2i lowerSize = CameraResolution::getSize(cameraResolution.resolution, false);
+  upperCameraInfo.width = upperSize.x();
+  upperCameraInfo.height = upperSize.y();
+  lowerCameraInfo.width = lowerSize.x();
+  lowerCameraInfo.height = lowerSize.y();
 
   // set opening angle
   upperCameraInfo.openingAngleWidth = cameraIntrinsics.upperOpeningAngleWidth;
@@ -272,13 +280,15 @@ void CameraProviderV6::setupCameras()
   // update focal length
   upperCameraInfo.updateFocalLength();
   lowerCameraInfo.updateFocalLength();
+  capturedUpperCameraInfo = upperCameraInfo;
+  capturedLowerCameraInfo = lowerCameraInfo;
 #ifdef CAMERA_INCLUDED
   if (upperCamera != nullptr)
     delete upperCamera;
   if (lowerCamera != nullptr)
     delete lowerCamera;
-  upperCamera = new NaoCameraV6("/dev/video-top", true, upperCameraInfo.width, upperCameraInfo.height, true);
-  lowerCamera = new NaoCameraV6("/dev/video-bottom", false, lowerCameraInfo.width, lowerCameraInfo.height, false);
+  upperCamera = new NaoCameraV6("/dev/video-top", true, capturedUpperCameraInfo.width, capturedUpperCameraInfo.height, true, frameBuffers);
+  lowerCamera = new NaoCameraV6("/dev/video-bottom", false, capturedLowerCameraInfo.width, capturedLowerCameraInfo.height, false, frameBuffers);
   cycleTime = upperCamera->getFrameRate();
   ASSERT(upperCamera->getFrameRate() == lowerCamera->getFrameRate());
 
@@ -294,11 +304,116 @@ void CameraProviderV6::setupCameras()
 #endif
 }
 
+void CameraProviderV6::applyResolutionRequest()
+{
+  int upperWidth = capturedUpperCameraInfo.width;
+  int lowerWidth = capturedLowerCameraInfo.width;
+  const CameraResolution::Resolutions requested = theCameraResolutionRequest.resolution;
+  if (requested != CameraResolution::noRequest && requested != CameraResolution::defaultRes)
+  {
+    const int requestedUpperWidth = CameraResolution::getSize(requested, true).x();
+    const int requestedLowerWidth = CameraResolution::getSize(requested, false).x();
+    if ((requestedUpperWidth > upperWidth || requestedLowerWidth > lowerWidth) && requested != lastRequestedResolution)
+      OUTPUT_WARNING("CameraProviderV6: " << CameraResolution::getName(requested) << " cannot be provided, because the cameras capture "
+                     << CameraResolution::getName(capturedCameraResolution.resolution) << ".");
+    upperWidth = std::min(upperWidth, requestedUpperWidth);
+    lowerWidth = std::min(lowerWidth, requestedLowerWidth);
+  }
+  lastRequestedResolution = requested;
+
+  // At least half of the upper image is kept.
+  const float requestedTop = std::min(std::max(theCameraResolutionRequest.upperRegionTop, 0.f), 0.5f) * static_cast<float>(capturedUpperCameraInfo.height);
+  const int regionTop = static_cast<int>(requestedTop) / regionTopStep * regionTopStep;
+  const CameraResolution::Resolutions resolution = CameraResolution::getResolution(upperWidth, lowerWidth);
+  const int providedTop = static_cast<int>(cameraResolution.upperRegionTop * static_cast<float>(capturedUpperCameraInfo.height) + 0.5f);
+  if (resolution != cameraResolution.resolution || regionTop != providedTop)
+  {
+    cameraResolution.resolution = resolution;
+    cameraResolution.upperRegionTop = static_cast<float>(regionTop) / static_cast<float>(capturedUpperCameraInfo.height);
+    cameraResolution.timestamp = SystemCall::getCurrentSystemTime();
+    setCameraInfo(upperCameraInfo, capturedUpperCameraInfo, capturedUpperCameraInfo.width / upperWidth, regionTop);
+    setCameraInfo(lowerCameraInfo, capturedLowerCameraInfo, capturedLowerCameraInfo.width / lowerWidth, 0);
+  }
+}
+
+void CameraProviderV6::setCameraInfo(CameraInfo& cameraInfo, const CameraInfo& capturedCameraInfo, int scale, int top)
+{
+  cameraInfo.width = capturedCameraInfo.width / scale;
+  cameraInfo.height = (capturedCameraInfo.height - top) / scale;
+  cameraInfo.opticalCenter.x() = capturedCameraInfo.opticalCenter.x() / static_cast<float>(scale);
+  cameraInfo.opticalCenter.y() = (capturedCameraInfo.opticalCenter.y() - static_cast<float>(top)) / static_cast<float>(scale);
+  cameraInfo.updateFocalLength();
+}
+
+void CameraProviderV6::reduceImage(Image& image, const CameraInfo& capturedCameraInfo, const CameraInfo& cameraInfo, Image& reducedImage)
+{
+  // Images that are already reduced or e.g. replayed from a log are not changed.
+  if (image.width != capturedCameraInfo.width || image.height != capturedCameraInfo.height)
+    return;
+
+  const int scale = capturedCameraInfo.width / cameraInfo.width;
+  const int top = capturedCameraInfo.height - cameraInfo.height * scale;
+  if (scale == 1 && top == 0)
+    return;
+
+  if (scale == 1)
+  {
+    // Dropping rows only moves the start of the image, so a camera buffer can still be shared.
+    if (image.isReference)
+    {
+      const std::weak_ptr<const void> sharedFrame = image.sharedFrame;
+      image.setImage(image[top]);
+      image.sharedFrame = sharedFrame;
+    }
+    else
+      std::memmove(image.image, image[top], cameraInfo.height * image.widthStep * sizeof(Image::Pixel));
+    image.setResolution(cameraInfo.width, cameraInfo.height);
+    return;
+  }
+
+  reducedImage.setResolution(cameraInfo.width, cameraInfo.height);
+  ImageKernels::shrinkYCbCr(reinterpret_cast<const unsigned char*>(image[top]), capturedCameraInfo.width, cameraInfo.height * scale, image.widthStep, scale,
+                            reinterpret_cast<unsigned char*>(reducedImage.image), reducedImage.widthStep);
+
+  // Doubling the pixels keeps getFullSizePixel consistent with the downscaled image.
+  for (int y = 0; y < reducedImage.height; ++y)
+  {
+    Image::Pixel* row = reducedImage[y];
+    for (Image::Pixel* p = row; p < row + reducedImage.width; ++p)
+      p->yCbCrPadding = p->y;
+    std::memcpy(row + reducedImage.width, row, reducedImage.width * sizeof(Image::Pixel));
+  }
+
+  if (image.isReference)
+    image.setImage(reducedImage.image);
+  else
+    std::memcpy(image.image, reducedImage.image, reducedImage.height * reducedImage.widthStep * sizeof(Image::Pixel));
+  image.setResolution(cameraInfo.width, cameraInfo.height);
+}
+
+void CameraProviderV6::applyControls(CameraSettingsV6& cameraSettings, const CameraControlRequest::Controls& controls)
+{
+#ifdef CAMERA_INCLUDED
+  if (controls.controlExposure)
+  {
+    cameraSettings.settings[CameraSettingsV6::AutoExposure].value = V4L2_EXPOSURE_MANUAL;
+    cameraSettings.settings[CameraSettingsV6::Exposure].value = controls.exposure;
+    cameraSettings.settings[CameraSettingsV6::Gain].value = controls.gain;
+  }
+  if (controls.controlWhiteBalance)
+  {
+    cameraSettings.settings[CameraSettingsV6::AutoWhiteBalance].value = 0;
+    cameraSettings.settings[CameraSettingsV6::WhiteBalance].value = controls.whiteBalance;
+  }
+  cameraSettings.enforceBounds();
+#endif
+}
+
 bool CameraProviderV6::isFrameDataComplete()
 {
 #ifdef CAMERA_INCLUDED
   if (*theInstance)
-    return (*theInstance)->upperCamera->hasImage() && (*theInstance)->lowerCamera->hasImage();
+    return ((*theInstance)->pipelined || (*theInstance)->upperCamera->hasImage()) && (*theInstance)->lowerCamera->hasImage();
   else
 #endif
     return true;
@@ -321,20 +436,21 @@ void CameraProviderV6::waitForFrameData2()
 
   for (;;)
   {
-    if (upperCamera->hasImage() && lowerCamera->hasImage())
+    if ((pipelined || upperCamera->hasImage()) && lowerCamera->hasImage())
     {
       return;
     }
 
-    bool resetUpper = false;
+    bool resetUpper = upperCaptureFailed;
     bool resetLower = false;
-    if (!lowerCamera->captureNew(timeout))
+    upperCaptureFailed = false;
+    if (!lowerCamera->hasImage() && !lowerCamera->captureNew(timeout))
     {
       BH_TRACE;
       OUTPUT_WARNING("CameraProviderV6: Poll lower failed.");
       resetLower = true;
     }
-    if (!upperCamera->captureNew(timeout))
+    if (!pipelined && !upperCamera->hasImage() && !upperCamera->captureNew(timeout))
     {
       BH_TRACE;
       OUTPUT_WARNING("CameraProviderV6: Poll upper failed.");
@@ -414,7 +530,7 @@ void CameraProviderV6::waitForFrameData2()
     }
     if (resetUpper)
     {
-      upperCamera = new NaoCameraV6("/dev/video-top", true, upperCameraInfo.width, upperCameraInfo.height, true);
+      upperCamera = new NaoCameraV6("/dev/video-top", true, capturedUpperCameraInfo.width, capturedUpperCameraInfo.height, true, frameBuffers);
       upperCamera->readCameraSettings();
       upperCamera->captureNew(timeout);
       imageTimeStampUpper = 0;
@@ -424,7 +540,7 @@ void CameraProviderV6::waitForFrameData2()
 
     if (resetLower)
     {
-      lowerCamera = new NaoCameraV6("/dev/video-bottom", false, lowerCameraInfo.width, lowerCameraInfo.height, false);
+      lowerCamera = new NaoCameraV6("/dev/video-bottom", false, capturedLowerCameraInfo.width, capturedLowerCameraInfo.height, false, frameBuffers);
       lowerCamera->readCameraSettings();
       lowerCamera->captureNew(timeout);
       imageTimeStamp = 0;
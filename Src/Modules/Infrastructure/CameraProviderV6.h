@@ -20,6 +20,10 @@ class NaoCameraV6;
 
 MODULE(CameraProviderV6,
   REQUIRES(Image),
+  REQUIRES(CameraInfo), // the images are reduced to the resolutions of the camera infos
+  REQUIRES(CameraInfoUpper),
+  USES(CameraControlRequest),
+  USES(CameraResolutionRequest),
   PROVIDES_WITHOUT_MODIFY(Image),
   PROVIDES_WITHOUT_MODIFY(ImageUpper),
   PROVIDES(FrameInfo),
@@ -28,13 +32,18 @@ MODULE(CameraProviderV6,
   PROVIDES_WITHOUT_MODIFY(CameraSettingsV6),
   PROVIDES_WITHOUT_MODIFY(CameraSettingsUpperV6),
   PROVIDES(CameraIntrinsics),
-  PROVIDES(CameraResolution)
+  PROVIDES(CameraResolution),
+  LOADS_PARAMETERS(,
+    (bool) pipelined /**< Start a frame as soon as the lower image is there. The upper image is captured while the ImageUpper is provided, so that processing the lower image overlaps with waiting for the upper one. */
+  )
 );
 
 class CameraProviderV6 : public CameraProviderV6Base
 {
 private:
   static CycleLocal<CameraProviderV6*> theInstance; /**< Points to the only instance of this class in this process or is 0 if there is none. */
+  static constexpr unsigned frameBuffers = 5; /**< The frame buffers per camera. Besides the 3 the driver needs, images can be shared across frames (see Image::shareImage). */
+  static constexpr int regionTopStep = 16; /**< The first row of the upper region is a multiple of this. */
 
   NaoCameraV6* upperCamera = nullptr;
   NaoCameraV6* lowerCamera = nullptr;
@@ -43,7 +52,13 @@ private:
   CameraSettingsV6 lowerCameraSettings;
   CameraSettingsUpperV6 upperCameraSettings;
   CameraIntrinsics cameraIntrinsics;
-  CameraResolution cameraResolution;
+  CameraResolution cameraResolution; /**< The resolutions provided. */
+  CameraResolution capturedCameraResolution; /**< The resolutions the cameras capture. */
+  CameraInfo capturedLowerCameraInfo; /**< The lower camera info of the captured images. */
+  CameraInfoUpper capturedUpperCameraInfo; /**< The upper camera info of the captured images. */
+  CameraResolution::Resolutions lastRequestedResolution = CameraResolution::noRequest; /**< Used to only warn once about a request that cannot be applied. */
+  Image reducedLowerImage{false}; /**< The buffer for the lower image if it is downscaled. */
+  ImageUpper reducedUpperImage{false}; /**< The buffer for the upper image if it is downscaled. */
   float cycleTime;
 #ifdef CAMERA_INCLUDED
   unsigned int now;
@@ -55,6 +70,7 @@ private:
   unsigned long long lastImageTimeStampLLUpper;
   unsigned resetCounter = 0;
   unsigned long long firstCameraTimestamp = 0;
+  bool upperCaptureFailed = false; /**< Did capturing the upper image fail while it was provided (in pipelined mode)? */
 #endif
 
 public:
@@ -96,4 +112,40 @@ private:
   bool readCameraResolution();
 
   void setupCameras();
+
+  /**
+   * Determines the resolutions provided from the CameraResolutionRequest and
+   * updates the camera infos accordingly. Only resolutions that can be computed
+   * from the captured images are applied, i.e. the cameras are never restarted.
+   * Calling this method more than once per frame has no further effect.
+   */
+  void applyResolutionRequest();
+
+  /**
+   * Sets a camera info to a downscaled region of the captured image.
+   * @param cameraInfo The camera info that is set.
+   * @param capturedCameraInfo The camera info of the captured images.
+   * @param scale The factor the image is downscaled by.
+   * @param top The first row of the region in the captured image.
+   */
+  static void setCameraInfo(CameraInfo& cameraInfo, const CameraInfo& capturedCameraInfo, int scale, int top);
+
+  /**
+   * Reduces a captured image to the resolution and region of its camera info.
+   * Only dropping rows keeps referencing the camera buffer. Downscaled images are
+   * written to a buffer of this module.
+   * @param image The image. It is left as it is if it does not have the captured size.
+   * @param capturedCameraInfo The camera info of the captured images.
+   * @param cameraInfo The camera info of the image provided.
+   * @param reducedImage The buffer for the downscaled image.
+   */
+  static void reduceImage(Image& image, const CameraInfo& capturedCameraInfo, const CameraInfo& cameraInfo, Image& reducedImage);
+
+  /**
+   * Replaces the automatic controls of a camera by the ones requested.
+   * Controls that are not requested are left as they are.
+   * @param cameraSettings The settings that are changed.
+   * @param controls The controls requested for the camera.
+   */
+  static void applyControls(CameraSettingsV6& cameraSettings, const CameraControlRequest::Controls& controls);
 };
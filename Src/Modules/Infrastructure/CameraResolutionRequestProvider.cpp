@@ -0,0 +1,39 @@
+/**
+ * @file Modules/Infrastructure/CameraResolutionRequestProvider.cpp
+ * This file implements a module that decides at runtime in which resolutions the
+ * images are processed.
+ */
+
+#include "CameraResolutionRequestProvider.h"
+#include <algorithm>
+
+void CameraResolutionRequestProvider::update(CameraResolutionRequest& cameraResolutionRequest)
+{
+  const bool walking = theMotionInfo.motion == MotionRequest::walk && !theMotionInfo.walkRequest.isZeroSpeed();
+  cameraResolutionRequest.resolution = walking ? walkingResolution : standingResolution;
+
+  // Without a field border, the whole image is needed.
+  float regionTop = 0.f;
+  if (cropUpperImage && theCLIPPointsPercept.upperFieldBorderTop >= 0.f && theCameraInfoUpper.height > 0)
+  {
+    // The field border was found in the region provided, which lacks the rows dropped before.
+    const float providedTop = theCameraResolution.upperRegionTop;
+    const float fieldBorderTop = providedTop + theCLIPPointsPercept.upperFieldBorderTop / static_cast<float>(theCameraInfoUpper.height) * (1.f - providedTop);
+    regionTop = std::max(fieldBorderTop - fieldBorderMargin, 0.f);
+  }
+
+  // Larger regions are requested immediately, smaller ones only if they suffice for a while.
+  if (regionTop <= requestedRegionTop || !cropUpperImage)
+  {
+    requestedRegionTop = regionTop;
+    largerRegionTime = theFrameInfo.time;
+  }
+  else if (theFrameInfo.getTimeSince(largerRegionTime) >= shrinkRegionDelay)
+  {
+    requestedRegionTop = regionTop;
+    largerRegionTime = theFrameInfo.time;
+  }
+  cameraResolutionRequest.upperRegionTop = requestedRegionTop;
+}
+
+MAKE_MODULE(CameraResolutionRequestProvider, cognitionInfrastructure)
@@ -0,0 +1,39 @@
+/**
+ * @file Modules/Infrastructure/CameraResolutionRequestProvider.h
+ * This file declares a module that decides at runtime in which resolutions the
+ * images are processed. Perception works on lower resolutions while walking,
+ * and the upper image can be limited to the region below the field border.
+ */
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Infrastructure/CameraResolution.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/MotionControl/MotionInfo.h"
+#include "Representations/Perception/CLIPPointsPercept.h"
+
+MODULE(CameraResolutionRequestProvider,
+  REQUIRES(CameraInfoUpper),
+  REQUIRES(CameraResolution),
+  REQUIRES(CLIPPointsPercept),
+  REQUIRES(FrameInfo),
+  REQUIRES(MotionInfo),
+  PROVIDES(CameraResolutionRequest),
+  LOADS_PARAMETERS(,
+    ((CameraResolution) Resolutions) standingResolution, /**< Requested while the robot does not walk. noRequest keeps the captured resolutions. */
+    ((CameraResolution) Resolutions) walkingResolution, /**< Requested while the robot walks. */
+    (bool) cropUpperImage, /**< Drop the rows of the upper image above the field border? */
+    (float) fieldBorderMargin, /**< The rows kept above the field border as a fraction of the height of the upper image. */
+    (int) shrinkRegionDelay /**< How long (in ms) a smaller upper region must suffice before it is requested. */
+  )
+);
+
+class CameraResolutionRequestProvider : public CameraResolutionRequestProviderBase
+{
+  float requestedRegionTop = 0.f; /**< The upper region requested. */
+  unsigned largerRegionTime = 0; /**< When was a larger upper region required or the region shrunk the last time? */
+
+  void update(CameraResolutionRequest& cameraResolutionRequest);
+};
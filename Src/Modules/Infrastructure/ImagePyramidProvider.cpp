@@ -0,0 +1,8 @@
+/**
+ * @file Modules/Infrastructure/ImagePyramidProvider.cpp
+ * This file implements a module that provides the image pyramids of both cameras.
+ */
+
+#include "ImagePyramidProvider.h"
+
+MAKE_MODULE(ImagePyramidProvider, cognitionInfrastructure)
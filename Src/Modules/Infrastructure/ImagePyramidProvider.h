@@ -0,0 +1,25 @@
+/**
+ * @file Modules/Infrastructure/ImagePyramidProvider.h
+ * This file declares a module that provides the image pyramids of both cameras.
+ * The levels themselves are computed by the pyramids when they are requested.
+ */
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/Image.h"
+#include "Representations/Infrastructure/ImagePyramid.h"
+
+MODULE(ImagePyramidProvider,
+  REQUIRES(Image),
+  REQUIRES(ImageUpper),
+  PROVIDES_WITHOUT_MODIFY(ImagePyramid),
+  PROVIDES_WITHOUT_MODIFY(ImagePyramidUpper)
+);
+
+class ImagePyramidProvider : public ImagePyramidProviderBase
+{
+public:
+  void update(ImagePyramid& imagePyramid) { imagePyramid.setImage(theImage); }
+  void update(ImagePyramidUpper& imagePyramid) { imagePyramid.setImage(theImageUpper); }
+};
@@ -10,6 +10,7 @@
 void LowFrameRateImageProvider::update(LowFrameRateImage& lowFrameRateImage)
 {
   lowFrameRateImage.imageUpdated = false;
+  releaseFrame(lowFrameRateImage);
 
   /*if(perceptsOnly)
   {
@@ -28,6 +29,7 @@ void LowFrameRateImageProvider::update(LowFrameRateImage& lowFrameRateImage)
 void LowFrameRateImageProvider::update(LowFrameRateImageUpper& lowFrameRateImage)
 {
   lowFrameRateImage.imageUpdated = false;
+  releaseFrame((LowFrameRateImage&)lowFrameRateImage);
 
   if (storeNextImage)
   {
@@ -50,12 +52,28 @@ void LowFrameRateImageProvider::logCurrentImage(LowFrameRateImage& lowFrameRateI
     storeNextImage = false;
   }
 }
+
+void LowFrameRateImageProvider::releaseFrame(LowFrameRateImage& lfrImage)
+{
+  // The image is only streamed in the frame it was updated in. Holding on to the
+  // camera buffer any longer would keep it from being queued again.
+  lfrImage.image.frame.reset();
+}
+
 void LowFrameRateImageProvider::updateImage(LowFrameRateImage& lfrImage, bool upper) const
 {
   const Image& image = upper ? (Image&)theImageUpper : theImage;
-  lfrImage.image.setImage(const_cast<Image::Pixel*>(image[0]));
-  lfrImage.image.setResolution(image.width, image.height);
-  lfrImage.image.timeStamp = image.timeStamp;
+  if (image.frame || !image.sharedFrame.expired())
+    lfrImage.image.shareImage(image);
+  else
+  {
+    // Without a camera buffer (e.g. in replay), the image is referenced instead of copied.
+    // This is safe, because it is only streamed or enqueued in this frame.
+    lfrImage.image.setImage(image.image);
+    lfrImage.image.setResolution(image.width, image.height);
+    lfrImage.image.timeStamp = image.timeStamp;
+    lfrImage.image.imageSource = image.imageSource;
+  }
   lfrImage.imageUpdated = true;
 }
 
@@ -41,6 +41,12 @@ private:
   void logCurrentImage(LowFrameRateImage& lowFrameRateImage);
   void updateImage(LowFrameRateImage& lfrImage, bool upper) const;
 
+  /**
+   * Returns the camera buffer shared by the image, which is not streamed anymore.
+   * @param lfrImage The image provided in the previous frame.
+   */
+  static void releaseFrame(LowFrameRateImage& lfrImage);
+
   unsigned lastUpdateTime; /**< Time of last update. */
   unsigned lastUpdateTimeUpper; /**< Time of last update for upper image. */
   bool storeNextImage;
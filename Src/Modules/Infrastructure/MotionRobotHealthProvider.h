@@ -7,7 +7,7 @@
 #pragma once
 
 #include "Tools/Module/Module.h"
-#include "Tools/RingBufferWithSum.h"
+#include "Tools/RingBufferWithStatistics.h"
 #include "Representations/Infrastructure/RobotHealth.h"
 
 MODULE(MotionRobotHealthProvider,
@@ -26,7 +26,7 @@ private:
   */
   void update(MotionRobotHealth& motionRobotHealth);
 
-  RingBufferWithSum<unsigned, 30> timeBuffer; /** Buffered timestamps of previous executions */
+  RingBufferWithStatistics<unsigned, 30> timeBuffer; /** Buffered timestamps of previous executions */
   unsigned lastExecutionTime;
 
 public:
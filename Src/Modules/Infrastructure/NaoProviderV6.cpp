@@ -13,6 +13,7 @@ MAKE_MODULE(NaoProviderV6, motionInfrastructure)
 #include "Tools/Debugging/Modify.h"
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Debugging/Annotation.h"
+#include "Tools/Module/ModuleManager.h"
 #include "Tools/Settings.h"
 
 #include "naodevilsbase/naodevilsbase.h"
@@ -20,6 +21,7 @@ MAKE_MODULE(NaoProviderV6, motionInfrastructure)
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
 #include <numeric>
 
 CycleLocal<NaoProviderV6*> NaoProviderV6::theInstance(nullptr);
@@ -67,7 +69,10 @@ void NaoProviderV6::waitForFrameData()
     firstSensorTimestamp = oldSensorTimestamp;
 
   if (*theInstance)
+  {
     (*theInstance)->naoBody.wait();
+    (*theInstance)->wakeTime = std::chrono::steady_clock::now();
+  }
 
   const int newSensorTimestamp = (*theInstance)->naoBody.getSensors().timestamp;
   const int diffSensorTimestamp = newSensorTimestamp - oldSensorTimestamp;
@@ -75,6 +80,7 @@ void NaoProviderV6::waitForFrameData()
 
   if (firstSensorTimestamp > 0 && diffFirstSensorTimestamp > 10000 && newSensorTimestamp > 0 && oldSensorTimestamp > 0 && diffSensorTimestamp > 0.012f * 1000.f * 1.1f)
   {
+    (*theInstance)->missedFrames += (diffSensorTimestamp + 6) / 12 - 1;
     ANNOTATION("NaoProvider", "Skipped frame(s): Time difference was: " << diffSensorTimestamp << "ms");
     DEBUG_RESPONSE("module:NaoProviderV6:printSkippedFrames")
     OUTPUT_WARNING("NaoProvider: Skipped frame(s)! Time difference was: " << diffSensorTimestamp << "ms");
@@ -152,6 +158,9 @@ void NaoProviderV6::send()
   actuators.sonars[1] = true;
 
   naoBody.closeActuators();
+
+  if (wakeTime != std::chrono::steady_clock::time_point())
+    lastCycleTime = static_cast<unsigned>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wakeTime).count());
 }
 
 void NaoProviderV6::update(FrameInfo& frameInfo)
@@ -160,6 +169,29 @@ void NaoProviderV6::update(FrameInfo& frameInfo)
   frameInfo.cycleTime = 0.012f;
 }
 
+void NaoProviderV6::update(MotionTiming& motionTiming)
+{
+  motionTiming.missedFrames = missedFrames;
+  if (!lastCycleTime)
+    return;
+
+  motionTiming.cycleTime = lastCycleTime;
+  motionTiming.maxCycleTime = std::max(motionTiming.maxCycleTime, lastCycleTime);
+  ++motionTiming.cycleTimeHistogram[std::min(lastCycleTime / MotionTiming::binWidth, static_cast<unsigned>(MotionTiming::numOfBins) - 1)];
+  if (lastCycleTime > cycleBudget)
+  {
+    // the module manager still knows the durations of the frame the cycle time was measured in
+    const char* module;
+    const char* representation;
+    motionTiming.slowestModuleTime = static_cast<unsigned>(ModuleManager::getSlowestUpdate(module, representation));
+    motionTiming.slowestModule = module ? module : "";
+    motionTiming.slowestRepresentation = representation ? representation : "";
+    ++motionTiming.overruns;
+    ANNOTATION("NaoProvider", "Cycle time of " << lastCycleTime << "µs exceeded the budget, slowest was " << motionTiming.slowestModule << " with " << motionTiming.slowestModuleTime << "µs");
+  }
+  lastCycleTime = 0;
+}
+
 void NaoProviderV6::update(FsrSensorData& fsrSensorData)
 {
   const auto& fsr = naoBody.getSensors().fsr;
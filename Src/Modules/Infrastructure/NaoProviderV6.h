@@ -14,6 +14,7 @@
 #include "Representations/Infrastructure/JointAngles.h"
 #include "Representations/Infrastructure/JointRequest.h"
 #include "Representations/Infrastructure/LEDRequest.h"
+#include "Representations/Infrastructure/MotionTiming.h"
 #include "Representations/Infrastructure/RobotInfo.h"
 #include "Representations/Infrastructure/TeamInfo.h"
 #include "Representations/Infrastructure/SensorData/FsrSensorData.h"
@@ -26,6 +27,7 @@
 #include "Tools/Module/Module.h"
 #include "Tools/RingBufferWithSum.h"
 #include "Tools/ProcessFramework/CycleLocal.h"
+#include <chrono>
 
 constexpr unsigned GYRO_BUFFER_LENGTH = static_cast<unsigned>(1.0 * 83);
 
@@ -43,13 +45,15 @@ MODULE(NaoProviderV6,
   PROVIDES(InertialSensorData),
   PROVIDES(JointSensorData),
   PROVIDES(KeyStates),
+  PROVIDES(MotionTiming),
   PROVIDES(SystemSensorData),
   PROVIDES(SonarSensorData),
   USES(WalkCalibration),
   USES(JointRequest), // Will be accessed in send()
   LOADS_PARAMETERS(,
     (Angle)(0.00125_deg) gyroBiasMaxErrorPerFrame,
-    (Angle)(0.25_deg) gyroBiasThresholdForTTS
+    (Angle)(0.25_deg) gyroBiasThresholdForTTS,
+    (unsigned)(12000) cycleBudget /**< The time in µs after waking up within which the joint request should be sent. */
   )
 );
 
@@ -74,6 +78,9 @@ private:
   unsigned setStarted = 0;
   unsigned lastBodyTemperatureReadTime = 0;
   static int firstSensorTimestamp;
+  std::chrono::steady_clock::time_point wakeTime; /**< When did the motion thread wake up for the current sensor data? */
+  unsigned lastCycleTime = 0; /**< The cycle time of the last frame in µs, 0 if it was already provided. */
+  unsigned missedFrames = 0; /**< The number of LoLA frames skipped so far. */
 
   static constexpr std::array<NDData::Joint, Joints::Joint::numOfJoints> jointsToBase = {NDData::Joint::headYaw,
       NDData::Joint::headPitch,
@@ -233,6 +240,7 @@ private:
   void update(InertialSensorData& inertialSensorData);
   void update(JointSensorData& jointSensorData);
   void update(KeyStates& keyStates);
+  void update(MotionTiming& motionTiming);
   void update(SystemSensorData& systemSensorData);
   void update(SonarSensorData& sonarSensorData);
 
@@ -265,6 +273,7 @@ private:
   void update(InertialSensorData& inertialSensorData) {}
   void update(JointSensorData& jointSensorData) {}
   void update(KeyStates& keyStates) {}
+  void update(MotionTiming& motionTiming) {}
   void update(SystemSensorData& systemSensorData) {}
   void update(SonarSensorData& sonarSensorData) {}
   void send();
@@ -4,6 +4,11 @@ MAKE_MODULE(EventManager, cognitionInfrastructure);
 
 void EventManager::update(TeamCommEvents& events)
 {
+  DECLARE_PLOT("module:EventManager:thresholdScale");
+
+  thresholdScale = getThresholdScale();
+  PLOT("module:EventManager:thresholdScale", thresholdScale);
+
   events.sendReasons = getSendReasons();
 
   const Teammate* newestTeammate = theTeammateData.getNewestTeammate();
@@ -139,7 +144,7 @@ bool EventManager::checkForPlayerMoved()
   const bool positionUpdateByAllowedInGoalArea = Geometry::isPointInsideRectangle(goalAreaBottomLeft, goalAreaTopRight, theTeammateData.myself.robotPose.translation)
           != Geometry::isPointInsideRectangle(goalAreaBottomLeft, goalAreaTopRight, theRobotPoseAfterPreview.translation)
       && theFrameInfo.getTimeSince(theTeamCommSenderOutput.dataSentTimestamp) > static_cast<int>(eventConfig.playerMovedEventIntervalGoalArea) && distanceMoved > 300.f;
-  const bool playerMoved = distanceMoved > movedThreshold;
+  const bool playerMoved = distanceMoved > movedThreshold * thresholdScale;
 
   if ((positionUpdateInitial || playerMoved || positionUpdateByAllowedInGoalArea)
       && (theRobotPose.validity > eventConfig.playerMovedEventMinPoseValidity || theTeammateData.myself.sendTimestamp == 0
@@ -189,7 +194,7 @@ bool EventManager::checkForBallMoved()
     if (distance < minBallDistancePerceptToSent)
       minBallDistancePerceptToSent = distance;
   }
-  if (minBallDistancePerceptToSent > eventConfig.ballMovedEventDistance)
+  if (minBallDistancePerceptToSent > eventConfig.ballMovedEventDistance * thresholdScale)
     return true;
 
   return false;
@@ -218,6 +223,16 @@ bool EventManager::checkForTimeResponses()
   return false;
 }
 
+float EventManager::getThresholdScale() const
+{
+  // The budget is ignored outside of READY, SET, and PLAYING anyway
+  if (theGameInfo.state != STATE_READY && theGameInfo.state != STATE_SET && theGameInfo.state != STATE_PLAYING)
+    return 1.f;
+
+  const float missingBudget = 1.f - std::max(0.f, std::min(1.f, theTeammateData.messageBudgetFactor));
+  return std::min(eventConfig.maxThresholdScale, 1.f + missingBudget * eventConfig.thresholdScalePerMissingBudget);
+}
+
 bool EventManager::isTeamEventOldEnough(const std::vector<TeamCommEvents::SendReason>& sendReasons) const
 {
   for (const TeamCommEvents::SendReason sendReason : sendReasons)
@@ -228,7 +243,7 @@ bool EventManager::isTeamEventOldEnough(const std::vector<TeamCommEvents::SendRe
       {
         const Teammate* teammate = theTeammateData.getNewestEventMessage(sendReason);
 
-        if (!teammate || theFrameInfo.getTimeSince(teammate->sendTimestamp) > static_cast<int>(eventInterval.interval))
+        if (!teammate || theFrameInfo.getTimeSince(teammate->sendTimestamp) > static_cast<int>(eventInterval.interval * thresholdScale))
           return true;
       }
     }
@@ -243,7 +258,7 @@ bool EventManager::isLocalEventOldEnough(const std::vector<TeamCommEvents::SendR
   {
     for (const auto& eventInterval : eventIntervals)
     {
-      if (eventInterval.reason == sendReason && !eventInterval.perTeam && theFrameInfo.getTimeSince(newestLocalUpdate[sendReason]) > static_cast<int>(eventInterval.interval))
+      if (eventInterval.reason == sendReason && !eventInterval.perTeam && theFrameInfo.getTimeSince(newestLocalUpdate[sendReason]) > static_cast<int>(eventInterval.interval * thresholdScale))
       {
         return true;
       }
@@ -68,7 +68,9 @@ MODULE(EventManager,
       (float)(0.4f) playerMovedEventMinPoseValidityInitial,
       (unsigned)(20000) goalDetectedMinTimeDiff,
       (float)(1000.f) ballMovedEventDistance,
-      (float)(0.8f) ballMovedMinValidity
+      (float)(0.8f) ballMovedMinValidity,
+      (float)(10.f) thresholdScalePerMissingBudget, /**< How much the distances and intervals grow per missing part of the message budget. */
+      (float)(3.f) maxThresholdScale /**< The maximum factor the distances and intervals are scaled with. */
     );
     ,
     (EventConfig) eventConfig,
@@ -96,8 +98,16 @@ private:
   bool checkForBallchaserFallDown();
   bool checkForTimeResponses();
 
+  /**
+   * Determines how much the distances and intervals that trigger messages are scaled.
+   * If the team has less than one message per second of the game left, drifts of the
+   * positions the teammates know must become bigger before they are worth a message.
+   */
+  float getThresholdScale() const;
+
   // member variables
   std::array<unsigned, TeamCommEvents::SendReason::numOfSendReasons> newestLocalUpdate{0};
   Pose2f lastSendPosition;
+  float thresholdScale = 1.f; /**< The factor for distances and intervals, depending on the remaining message budget. */
   bool wasKickOffInProgress = false;
 };
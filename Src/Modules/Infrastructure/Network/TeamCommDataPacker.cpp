@@ -33,7 +33,40 @@ void TeamCommDataPacker::update(TeamCommOutput& teamCommOutput)
     teammate.speedInfo = SpeedInfoCompressed(theSpeedInfo);
     teammate.localRobotMap = RobotMapCompressed(theLocalRobotMap);
 
-    teamCommOutput = teammate.toTeamCommData();
+    teamCommOutput = teammate.toTeamCommData(getPriorities());
     PLOT("module:TeamCommDataPacker:messageSize", teamCommOutput.data.size());
   }
 }
+
+std::vector<Teammate::Field> TeamCommDataPacker::getPriorities() const
+{
+  // The reasons are always sent, so that the receiver knows why this message was sent.
+  std::vector<Teammate::Field> priorities = {Teammate::teamCommEventsField};
+  for (TeamCommEvents::SendReason reason : theTeamCommEvents.sendReasons)
+  {
+    switch (reason)
+    {
+    case TeamCommEvents::playerMoved:
+    case TeamCommEvents::symmetryLost:
+    case TeamCommEvents::symmetryUpdate:
+      priorities.push_back(Teammate::robotPoseField);
+      break;
+    case TeamCommEvents::ballMoved:
+    case TeamCommEvents::goalDetected:
+      priorities.push_back(Teammate::ballModelField);
+      break;
+    case TeamCommEvents::newRolesAssigned:
+    case TeamCommEvents::newBallchaser:
+    case TeamCommEvents::ballchaserFallDown:
+    case TeamCommEvents::kickOffFinished:
+      priorities.push_back(Teammate::behaviorDataField);
+      break;
+    case TeamCommEvents::timeResponse:
+      priorities.push_back(Teammate::timeSynchronizationField);
+      break;
+    default:
+      break;
+    }
+  }
+  return priorities;
+}
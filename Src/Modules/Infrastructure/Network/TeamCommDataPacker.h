@@ -55,4 +55,11 @@ private:
   * Fills the SPLStandardMessage Header.
   */
   void fillStandardMessage(MessageQueue& queue, TeamCommData& message);
+
+  /**
+  * Determines the fields that are sent first, because they belong to the reasons for
+  * sending this message. If the message does not have room for everything, the other
+  * fields are dropped.
+  */
+  std::vector<Teammate::Field> getPriorities() const;
 };
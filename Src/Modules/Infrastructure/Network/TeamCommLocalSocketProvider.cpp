@@ -1,22 +1,16 @@
 #include "TeamCommLocalSocketProvider.h"
 
 #include "Tools/Build.h"
+#include "Tools/Math/Random.h"
 #include "Tools/Settings.h"
 #include "Tools/Debugging/DebugDrawings.h"
+#include <algorithm>
+#include <cstring>
 
 
 MAKE_MODULE(TeamCommLocalSocketProvider, cognitionInfrastructure);
 
-std::array<std::array<std::optional<std::tuple<unsigned int, TeamCommData>>, MAX_NUM_PLAYERS>, 2> TeamCommLocalSocketProvider::messages;
-std::array<std::array<std::shared_mutex, MAX_NUM_PLAYERS>, 2> TeamCommLocalSocketProvider::mutex;
-
-TeamCommLocalSocketProvider::~TeamCommLocalSocketProvider()
-{
-  ASSERT(theOwnTeamInfo.teamNumber == 1 || theOwnTeamInfo.teamNumber == 2);
-
-  std::unique_lock l(mutex[theOwnTeamInfo.teamNumber - 1][theRobotInfo.number - 1]);
-  messages[theOwnTeamInfo.teamNumber - 1][theRobotInfo.number - 1].reset();
-}
+std::array<TeamCommLocalSocketProvider::Ring, 2> TeamCommLocalSocketProvider::rings;
 
 void TeamCommLocalSocketProvider::update(TeamCommSocket& teamCommSocket)
 {
@@ -31,47 +25,99 @@ void TeamCommLocalSocketProvider::update(TeamCommSocket& teamCommSocket)
   };
 }
 
-bool TeamCommLocalSocketProvider::send(const TeamCommData& teamCommData)
+TeamCommLocalSocketProvider::Ring& TeamCommLocalSocketProvider::getRing() const
 {
   ASSERT(theOwnTeamInfo.teamNumber == 1 || theOwnTeamInfo.teamNumber == 2);
+  return rings[theOwnTeamInfo.teamNumber - 1];
+}
 
-  std::unique_lock l(mutex[theOwnTeamInfo.teamNumber - 1][theRobotInfo.number - 1]);
-  auto& msg = messages[theOwnTeamInfo.teamNumber - 1][theRobotInfo.number - 1];
-  if (msg)
-  {
-    ++std::get<unsigned int>(*msg);
-    std::get<TeamCommData>(*msg) = teamCommData;
-  }
-  else
-  {
-    msg = std::make_tuple<unsigned int, TeamCommData>(1, TeamCommData(teamCommData));
-  }
-
+bool TeamCommLocalSocketProvider::send(const TeamCommData& teamCommData)
+{
+  if (teamCommData.data.size() > TeamCommData::maximumSize)
+    return false;
+
+  Ring& ring = getRing();
+  const unsigned ticket = ring.head.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = ring.slots[ticket % ringSize];
+  slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.sender = theRobotInfo.number;
+  slot.sendTimestamp = SystemCall::getCurrentSystemTime();
+  slot.size = static_cast<unsigned>(teamCommData.data.size());
+  std::memcpy(slot.data.data(), teamCommData.data.data(), slot.size);
+  slot.sequence.store(2 * ticket + 2, std::memory_order_release);
   return true;
 }
 
 std::vector<TeamCommDataReceived> TeamCommLocalSocketProvider::receive()
 {
-  ASSERT(theOwnTeamInfo.teamNumber == 1 || theOwnTeamInfo.teamNumber == 2);
-
-  std::vector<TeamCommDataReceived> ret;
-  auto m = mutex[theOwnTeamInfo.teamNumber - 1].begin();
+  Ring& ring = getRing();
+  const unsigned now = SystemCall::getCurrentSystemTime();
+  const unsigned head = ring.head.load(std::memory_order_acquire);
 
-  const auto& teamMessages = messages[theOwnTeamInfo.teamNumber - 1];
-  for (size_t num = 0; num < teamMessages.size(); ++num)
+  // Messages sent before this robot started or joined its team are not received.
+  if (&ring != readRing)
   {
-    const auto& robotMessage = teamMessages[num];
+    readRing = &ring;
+    nextTicket = head;
+    pendingMessages.clear();
+  }
 
-    std::shared_lock l(*m++);
-    if (robotMessage && std::get<unsigned int>(*robotMessage) != lastMessage[num])
-    {
-      lastMessage[num] = std::get<unsigned int>(*robotMessage);
+  // A reader that fell behind by more than the ring skips the overwritten messages.
+  if (head - nextTicket > ringSize)
+    nextTicket = head - ringSize;
 
-      TeamCommDataReceived& received = ret.emplace_back();
-      received.data = std::get<TeamCommData>(*robotMessage).data;
-      received.receiveTimestamp = SystemCall::getCurrentSystemTime();
+  for (; nextTicket != head; ++nextTicket)
+  {
+    const Slot& slot = ring.slots[nextTicket % ringSize];
+    const unsigned expected = 2 * nextTicket + 2;
+    const unsigned sequence = slot.sequence.load(std::memory_order_acquire);
+    if (static_cast<int>(sequence - expected) < 0)
+      break; // still being written, try again in the next frame
+    else if (sequence != expected)
+      continue; // already overwritten
+
+    PendingMessage pending;
+    const int sender = slot.sender;
+    pending.receiveTimestamp = slot.sendTimestamp;
+    pending.message.data.assign(slot.data.data(), slot.data.data() + std::min<size_t>(slot.size, TeamCommData::maximumSize));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected)
+      continue; // overwritten while it was copied
+
+    // The own messages are looped back without loss and latency.
+    if (sender != theRobotInfo.number)
+    {
+      if (isLost(sender))
+        continue;
+      pending.receiveTimestamp += minLatency + (latencyJitter ? static_cast<unsigned>(random(latencyJitter + 1)) : 0);
     }
+    pendingMessages.emplace_back(std::move(pending));
   }
 
+  std::vector<TeamCommDataReceived> ret;
+  for (auto i = pendingMessages.begin(); i != pendingMessages.end();)
+    if (static_cast<int>(now - i->receiveTimestamp) >= 0)
+    {
+      TeamCommDataReceived& received = ret.emplace_back(std::move(i->message));
+      received.receiveTimestamp = now;
+      i = pendingMessages.erase(i);
+    }
+    else
+      ++i;
+
   return ret;
 }
+
+bool TeamCommLocalSocketProvider::isLost(int sender)
+{
+  if (packetLoss <= 0.f || sender < 1 || sender > MAX_NUM_PLAYERS)
+    return false;
+
+  // The transition probabilities are chosen so that the ratio of lost messages is packetLoss.
+  const float burstLength = std::max(meanBurstLength, 1.f);
+  const float startBurst = std::min(1.f, packetLoss / (burstLength * (1.f - std::min(packetLoss, 0.99f))));
+  bool& inBurst = inLossBurst[sender - 1];
+  inBurst = inBurst ? randomFloat() >= 1.f / burstLength : randomFloat() < startBurst;
+  return inBurst;
+}
@@ -1,6 +1,11 @@
 /**
  * @file TeamCommLocalSocketProvider.h
  * This file provides a TeamCommSocket without network communication.
+ * All instances in the same process share a broadcast ring per team. Sending
+ * and receiving only use atomic operations, so many simulated robots can
+ * communicate without any system calls. Loss and latency of the SPL WiFi
+ * can be simulated. The latency is measured in simulated time, so it also
+ * holds if the simulation runs faster than real time.
  * @author <a href="mailto:aaron.larisch@tu-dortmund.de">Aaron Larisch</a>
  */
 
@@ -12,30 +17,72 @@
 #include "Representations/Infrastructure/RobotInfo.h"
 #include "Representations/Infrastructure/TeamInfo.h"
 #include <array>
-#include <mutex>
-#include <shared_mutex>
-#include <optional>
-#include <tuple>
+#include <atomic>
+#include <vector>
 
 MODULE(TeamCommLocalSocketProvider,
   REQUIRES(RobotInfo),
   REQUIRES(OwnTeamInfo),
-  PROVIDES_WITHOUT_MODIFY(TeamCommSocket)
+  PROVIDES_WITHOUT_MODIFY(TeamCommSocket),
+  LOADS_PARAMETERS(,
+    (float)(0.f) packetLoss, /**< The ratio of the messages of teammates that are lost [0..1). */
+    (float)(1.f) meanBurstLength, /**< The mean number of consecutive messages of a teammate that are lost. */
+    (unsigned)(0) minLatency, /**< The minimum time until a message of a teammate is received in ms. */
+    (unsigned)(0) latencyJitter /**< The maximum time added randomly to the minimum latency in ms. */
+  )
 );
 
 class TeamCommLocalSocketProvider : public TeamCommLocalSocketProviderBase
 {
 private:
+  static constexpr unsigned ringSize = 64; /**< The number of messages buffered per team. Readers that fall behind further skip messages. */
+
+  /**
+   * A message in the ring. It is protected by a sequence lock: The sequence
+   * number is odd while the message is written and 2 * ticket + 2 afterwards.
+   */
+  struct Slot
+  {
+    std::atomic<unsigned> sequence{0};
+    int sender = 0; /**< The number of the player that sent the message. */
+    unsigned sendTimestamp = 0;
+    unsigned size = 0;
+    std::array<char, TeamCommData::maximumSize> data;
+  };
+
+  struct Ring
+  {
+    std::atomic<unsigned> head{0}; /**< The ticket of the next message sent. */
+    std::array<Slot, ringSize> slots;
+  };
+
   // This static is intentional allowing communication between different instances of this module.
-  // In theory, we have to use a queue here, but since all robots are running synchronously, a single buffer per robot is fine.
-  static std::array<std::array<std::optional<std::tuple<unsigned int, TeamCommData>>, MAX_NUM_PLAYERS>, 2> messages;
-  static std::array<std::array<std::shared_mutex, MAX_NUM_PLAYERS>, 2> mutex;
+  static std::array<Ring, 2> rings;
 
-  std::array<unsigned int, MAX_NUM_PLAYERS> lastMessage{0};
+  /** A message that was read from the ring, but is not received yet because of its latency. */
+  struct PendingMessage
+  {
+    unsigned receiveTimestamp;
+    TeamCommDataReceived message;
+  };
 
-public:
-  ~TeamCommLocalSocketProvider();
+  const Ring* readRing = nullptr; /**< The ring messages were received from so far. */
+  unsigned nextTicket = 0; /**< The ticket of the next message read from the ring. */
+  std::vector<PendingMessage> pendingMessages;
+  std::array<bool, MAX_NUM_PLAYERS> inLossBurst{false}; /**< The state of the loss model per sender. */
 
+  /** @return The ring of the own team. */
+  Ring& getRing() const;
+
+  /**
+   * Decides whether a message of a teammate is lost using a Gilbert-Elliott model,
+   * i.e. losses occur in bursts with the given mean length.
+   * @param sender The number of the player that sent the message.
+   * @return Is the message lost?
+   */
+  bool isLost(int sender);
+
+public:
   bool send(const TeamCommData& teamCommData);
 
   std::vector<TeamCommDataReceived> receive();
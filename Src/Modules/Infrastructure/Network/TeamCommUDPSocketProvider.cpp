@@ -6,7 +6,14 @@
 
 MAKE_MODULE(TeamCommUDPSocketProvider, cognitionInfrastructure);
 
-TeamCommUDPSocketProvider::TeamCommUDPSocketProvider() {}
+TeamCommUDPSocketProvider::TeamCommUDPSocketProvider()
+{
+  for (size_t i = 0; i < datagrams.size(); ++i)
+  {
+    datagrams[i].data = buffers[i].data();
+    datagrams[i].len = static_cast<int>(buffers[i].size());
+  }
+}
 
 void TeamCommUDPSocketProvider::update(TeamCommSocket& teamCommSocket)
 {
@@ -70,6 +77,7 @@ void TeamCommUDPSocketProvider::start(int port, const char* subnet)
   socket.setBlocking(false);
   VERIFY(socket.setBroadcast(true));
   VERIFY(socket.bind("0.0.0.0", port));
+  socket.setTimestamps(true);
   socket.setTarget(subnet, port);
   socket.setLoopback(false);
 }
@@ -95,6 +103,49 @@ std::vector<TeamCommDataReceived> TeamCommUDPSocketProvider::receive()
   if (!port)
     return messages; // not started yet
 
+  if (local)
+    return receiveLocal();
+
+  const int received = socket.readBatch(datagrams.data(), maxNumOfTcMessages);
+  messages.reserve(received);
+  for (int i = 0; i < received; ++i)
+  {
+    const UdpComm::Datagram& datagram = datagrams[i];
+    if (datagram.size <= 0)
+      continue;
+
+    TeamCommDataReceived& message = messages.emplace_back();
+    *reinterpret_cast<unsigned int*>(message.remoteIp.data()) = datagram.ip;
+
+    // Check if message is bigger than expected
+    if (datagram.size > static_cast<int>(TeamCommDataReceived::maximumSize))
+    {
+      OUTPUT_WARNING("Received packet with invalid size from " << message.remoteIp[3] << "." << message.remoteIp[2] << "." << message.remoteIp[1] << "." << message.remoteIp[0]);
+      messages.pop_back();
+      continue;
+    }
+
+    message.data.assign(datagram.data, datagram.data + datagram.size);
+
+    // The kernel timestamp is only in the time base of the system time on the robot.
+    // Otherwise, this could be much later than the package was received by the hardware.
+#ifdef TARGET_ROBOT
+    if (datagram.timestamp)
+      message.receiveTimestamp = static_cast<unsigned>(datagram.timestamp - SystemCall::getSystemTimeBase());
+    else
+#endif
+      message.receiveTimestamp = SystemCall::getCurrentSystemTime();
+  }
+
+  if (received == maxNumOfTcMessages)
+    OUTPUT_WARNING("Packet buffer is full, ignoring further ones until the next frame");
+
+  return messages;
+}
+
+std::vector<TeamCommDataReceived> TeamCommUDPSocketProvider::receiveLocal()
+{
+  std::vector<TeamCommDataReceived> messages;
   messages.reserve(maxNumOfTcMessages);
 
   int size = 0;
@@ -105,9 +156,7 @@ std::vector<TeamCommDataReceived> TeamCommUDPSocketProvider::receive()
     // Allocate one byte more than necessary
     message.data.resize(TeamCommDataReceived::maximumSize + 1);
 
-    size = local
-        ? socket.readLocal(message.data.data(), static_cast<int>(message.data.size()))
-        : socket.read(message.data.data(), static_cast<int>(message.data.size()), *reinterpret_cast<unsigned int*>(message.remoteIp.data()));
+    size = socket.readLocal(message.data.data(), static_cast<int>(message.data.size()));
     if (size <= 0)
     {
       messages.pop_back();
@@ -117,22 +166,18 @@ std::vector<TeamCommDataReceived> TeamCommUDPSocketProvider::receive()
     // Check if message is bigger than expected
     if (size > static_cast<int>(TeamCommDataReceived::maximumSize))
     {
-      OUTPUT_WARNING("Received packet with invalid size from " << message.remoteIp[3] << "." << message.remoteIp[2] << "." << message.remoteIp[1] << "." << message.remoteIp[0]);
+      OUTPUT_WARNING("Received packet with invalid size from local host");
       messages.pop_back();
       continue;
     }
 
     // Adjust buffer to actual size
     message.data.resize(size);
-
-    // This could be much later than the package was received by the hardware.
-    // For our time measurements, this should be enough.
     message.receiveTimestamp = SystemCall::getCurrentSystemTime();
 
     if (messages.size() >= maxNumOfTcMessages)
     {
-      OUTPUT_WARNING("Packet buffer is full, ignoring further ones (last from "
-          << message.remoteIp[3] << "." << message.remoteIp[2] << "." << message.remoteIp[1] << "." << message.remoteIp[0] << ")");
+      OUTPUT_WARNING("Packet buffer is full, ignoring further ones");
       return messages;
     }
   } while (size > 0);
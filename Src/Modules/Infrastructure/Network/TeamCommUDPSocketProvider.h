@@ -13,6 +13,7 @@
 #include "Representations/Infrastructure/RobotInfo.h"
 #include "Representations/Infrastructure/TeamInfo.h"
 #include "Tools/Network/UdpComm.h"
+#include <array>
 
 MODULE(TeamCommUDPSocketProvider,
   REQUIRES(RobotInfo),
@@ -29,6 +30,10 @@ private:
 
   static constexpr int maxNumOfTcMessages = MAX_NUM_PLAYERS * 2; // x broadcasting players and substitute + space for delays
 
+  // Allocate one byte more than necessary to detect packages that are too big
+  std::array<std::array<char, TeamCommDataReceived::maximumSize + 1>, maxNumOfTcMessages> buffers; /**< The buffers packages are received in. */
+  std::array<UdpComm::Datagram, maxNumOfTcMessages> datagrams; /**< The packages read from the socket in a single batch. */
+
 public:
   TeamCommUDPSocketProvider();
 
@@ -58,5 +63,11 @@ public:
    */
   std::vector<TeamCommDataReceived> receive();
 
+  /**
+   * The method receives the packages of local communication, which only come from this host.
+   * @return The packages received.
+   */
+  std::vector<TeamCommDataReceived> receiveLocal();
+
   void update(TeamCommSocket& teamCommSocket);
 };
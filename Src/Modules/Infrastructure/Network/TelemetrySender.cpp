@@ -0,0 +1,88 @@
+#include "TelemetrySender.h"
+
+#include "Tools/Build.h"
+#include "Tools/Debugging/Debugging.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+MAKE_MODULE(TelemetrySender, cognitionInfrastructure);
+
+namespace
+{
+  /** Converts a value to an integer type, saturating at the limits of the type. */
+  template<typename T> T saturate(float value)
+  {
+    return static_cast<T>(std::clamp(std::round(value), static_cast<float>(std::numeric_limits<T>::min()),
+                                     static_cast<float>(std::numeric_limits<T>::max())));
+  }
+}
+
+void TelemetrySender::update(TelemetryStatus& telemetryStatus)
+{
+  telemetryStatus.active = enabled && (sendWhileGameControllerConnected || !theGameInfo.controllerConnected);
+  if (!telemetryStatus.active)
+  {
+    socket.reset();
+    return;
+  }
+
+  if (!socket)
+  {
+    socket = std::make_unique<UdpComm>();
+    socket->setBlocking(false);
+    if (!socket->setTarget(group.c_str(), port))
+    {
+      OUTPUT_WARNING("TelemetrySender: Invalid multicast group " << group << "!");
+      enabled = false;
+      socket.reset();
+      return;
+    }
+    socket->setTTL(1); // stay in the local network
+    socket->setLoopback(Build::targetSimulator());
+  }
+
+  if (telemetryStatus.packetsSent && theFrameInfo.getTimeSince(telemetryStatus.lastSendTimestamp) < sendInterval)
+    return;
+
+  TelemetryPacket packet;
+  fill(packet);
+  if (socket->write(reinterpret_cast<const char*>(&packet), sizeof(packet)))
+  {
+    ++telemetryStatus.packetsSent;
+    ++sequence;
+  }
+  // Failed attempts are not retried before the next interval, so a missing network does not cost any time.
+  telemetryStatus.lastSendTimestamp = theFrameInfo.time;
+}
+
+void TelemetrySender::fill(TelemetryPacket& packet) const
+{
+  packet.teamNumber = theOwnTeamInfo.teamNumber;
+  packet.playerNumber = static_cast<uint8_t>(theRobotInfo.number);
+  packet.penalty = theRobotInfo.penalty;
+  packet.sequence = sequence;
+  packet.timestamp = theFrameInfo.time;
+  theRobotHealth.robotName.copy(packet.robotName, sizeof(packet.robotName));
+
+  packet.cognitionFrameRate = saturate<uint16_t>(theRobotHealth.cognitionFrameRate * 10.f);
+  packet.motionFrameRate = saturate<uint16_t>(theRobotHealth.motionFrameRate * 10.f);
+  packet.motionCycleTime = saturate<uint16_t>(static_cast<float>(theMotionTiming.cycleTime));
+  packet.maxMotionCycleTime = saturate<uint16_t>(static_cast<float>(theMotionTiming.maxCycleTime));
+  packet.motionOverruns = theMotionTiming.overruns;
+  packet.missedMotionFrames = theMotionTiming.missedFrames;
+
+  packet.batteryLevel = theRobotHealth.batteryLevel;
+  packet.maxJointTemperature = theRobotHealth.maxJointTemperature;
+  packet.cpuTemperature = theRobotHealth.cpuTemperature;
+  packet.memoryUsage = theRobotHealth.memoryUsage;
+  std::copy(theRobotHealth.load, theRobotHealth.load + 3, packet.load);
+  packet.gameState = theGameInfo.state;
+  packet.totalCurrent = saturate<uint16_t>(theRobotHealth.totalCurrent * 1000.f);
+
+  packet.x = saturate<int16_t>(theRobotPose.translation.x());
+  packet.y = saturate<int16_t>(theRobotPose.translation.y());
+  packet.rotation = saturate<int16_t>(theRobotPose.rotation * 1000.f);
+  packet.validity = saturate<uint8_t>(theRobotPose.validity * 255.f);
+  packet.sideConfidence = static_cast<uint8_t>(theSideConfidence.confidenceState);
+}
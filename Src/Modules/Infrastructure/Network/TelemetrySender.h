@@ -0,0 +1,59 @@
+/**
+ * @file TelemetrySender.h
+ * This module sends a compact telemetry stream to monitoring PCs via UDP multicast.
+ * Each packet is a TelemetryPacket, i.e. it has a fixed size and is filled from
+ * representations that exist anyway. Packets are only sent every sendInterval ms.
+ * Since the rules do not allow additional traffic during official games, the stream
+ * pauses while a GameController is connected unless sendWhileGameControllerConnected is set.
+ */
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Infrastructure/GameInfo.h"
+#include "Representations/Infrastructure/MotionTiming.h"
+#include "Representations/Infrastructure/RobotHealth.h"
+#include "Representations/Infrastructure/RobotInfo.h"
+#include "Representations/Infrastructure/TeamInfo.h"
+#include "Representations/Infrastructure/TelemetryStatus.h"
+#include "Representations/Modeling/RobotPose.h"
+#include "Representations/Modeling/SideConfidence.h"
+#include "Tools/Network/TelemetryPacket.h"
+#include "Tools/Network/UdpComm.h"
+#include <memory>
+
+MODULE(TelemetrySender,
+  REQUIRES(FrameInfo),
+  REQUIRES(GameInfo),
+  REQUIRES(MotionTiming),
+  REQUIRES(OwnTeamInfo),
+  REQUIRES(RobotHealth),
+  REQUIRES(RobotInfo),
+  REQUIRES(RobotPose),
+  REQUIRES(SideConfidence),
+  PROVIDES(TelemetryStatus),
+  LOADS_PARAMETERS(,
+    (bool)(false) enabled, /**< Send the stream at all? */
+    (bool)(false) sendWhileGameControllerConnected, /**< Also send while a GameController is connected, e.g. in test games. */
+    (std::string)("239.255.10.1") group, /**< The multicast group the packets are sent to. */
+    (int)(10010) port, /**< The UDP port the packets are sent to. */
+    (int)(1000) sendInterval /**< The minimum time between two packets in ms. */
+  )
+);
+
+class TelemetrySender : public TelemetrySenderBase
+{
+private:
+  std::unique_ptr<UdpComm> socket; /**< The socket, which only exists while the stream is active. */
+  uint16_t sequence = 0;
+
+  void update(TelemetryStatus& telemetryStatus);
+
+  /**
+   * Fills a packet from the current representations.
+   * @param packet The packet that is filled.
+   */
+  void fill(TelemetryPacket& packet) const;
+};
@@ -4,7 +4,9 @@
 #include "Tools/Settings.h"
 #include "Platform/BHAssert.h"
 #include "Tools/MessageQueue/MessageQueue.h"
+#include "Tools/Math/BHMath.h"
 #include "Representations/Infrastructure/TeammateData.h"
+#include <cmath>
 #include <numeric>
 
 MAKE_MODULE(TimeProvider, cognitionInfrastructure);
@@ -24,6 +26,10 @@ void TimeProvider::execute(tf::Subflow&)
     if (teammate.teamNumber != theOwnTeamInfo.teamNumber)
       continue;
 
+    // every message measures the offset plus its latency
+    if (teammate.playerNumber != theRobotInfo.number && teammate.playerNumber >= 1 && teammate.playerNumber <= MAX_NUM_PLAYERS)
+      oneWays.push_back({teammate.playerNumber, teammate.sendTimestamp, message.receiveTimestamp});
+
     const TimeSynchronization& ts = teammate.timeSynchronization;
 
     // answer on request or never answered before
@@ -61,17 +67,82 @@ void TimeProvider::update(TimeOffsets& timeOffsets)
 
     const int rtt = (resRcvd - reqSent) - (resSent - reqRcvd);
     const int offset = ((reqRcvd - reqSent) + (resSent - resRcvd)) / 2;
+    if (rtt < 0 || playerNum < 1 || playerNum > MAX_NUM_PLAYERS)
+      continue;
 
-    int& bestRTT = timeOffsets.bestRTT[playerNum - 1];
-    int& bestOffset = timeOffsets.bestOffset[playerNum - 1];
+    // The true offset is somewhere within half the round trip time.
+    const double halfRtt = std::max(rtt, 1) / 2.0;
+    const double variance = sqr(halfRtt) / 3.0;
 
-    if (rtt < bestRTT || std::abs(bestOffset - offset) > bestRTT)
+    ClockFilter& filter = filters[playerNum - 1];
+    predict(filter, roundtrip.response.received);
+    if (!filter.initialized || std::abs(offset - filter.state.x()) > halfRtt + 3.0 * std::sqrt(filter.cov(0, 0)))
+      reset(filter, offset, variance, roundtrip.response.received); // e.g. the teammate was restarted
+    else
     {
-      bestRTT = rtt;
-      bestOffset = offset;
+      correct(filter, offset, variance);
+      filter.latency += (halfRtt - filter.latency) * latencyUpdateRatio;
     }
   }
   roundtrips.clear();
+
+  for (const OneWay& oneWay : oneWays)
+  {
+    ClockFilter& filter = filters[oneWay.player - 1];
+    if (!filter.initialized)
+      continue;
+
+    predict(filter, oneWay.received);
+    const double offset = static_cast<int>(oneWay.sent - oneWay.received) + filter.latency;
+    const double variance = sqr(oneWayDeviation);
+
+    // Messages that were delayed, e.g. by retransmissions, are ignored.
+    if (sqr(offset - filter.state.x()) <= 9.0 * (filter.cov(0, 0) + variance))
+      correct(filter, offset, variance);
+  }
+  oneWays.clear();
+
+  const unsigned now = SystemCall::getCurrentSystemTime();
+  for (size_t i = 0; i < filters.size(); ++i)
+    if (filters[i].initialized)
+    {
+      ClockFilter filter = filters[i];
+      predict(filter, now);
+      timeOffsets.bestOffset[i] = static_cast<int>(std::round(filter.state.x()));
+      timeOffsets.bestRTT[i] = std::max(1, static_cast<int>(std::ceil(2.0 * std::sqrt(filter.cov(0, 0)))));
+    }
+}
+
+void TimeProvider::reset(ClockFilter& filter, double offset, double variance, unsigned timestamp) const
+{
+  filter.initialized = true;
+  filter.timestamp = timestamp;
+  filter.state << offset, 0.0;
+  filter.cov << variance, 0.0, 0.0, sqr(initialDriftDeviation);
+  filter.latency = std::sqrt(3.0 * variance);
+}
+
+void TimeProvider::predict(ClockFilter& filter, unsigned timestamp) const
+{
+  const int dt = static_cast<int>(timestamp - filter.timestamp);
+  if (dt <= 0)
+    return;
+
+  Matrix2d a;
+  a << 1.0, dt,
+       0.0, 1.0;
+  filter.state = a * filter.state;
+  filter.cov = a * filter.cov * a.transpose();
+  filter.cov(0, 0) += offsetNoise * dt;
+  filter.cov(1, 1) += driftNoise * dt;
+  filter.timestamp = timestamp;
+}
+
+void TimeProvider::correct(ClockFilter& filter, double offset, double variance)
+{
+  const Vector2d gain = filter.cov.col(0) / (filter.cov(0, 0) + variance);
+  filter.state += gain * (offset - filter.state.x());
+  filter.cov -= gain * filter.cov.row(0);
 }
 
 void TimeProvider::update(TimeSynchronization& timeSynchronization)
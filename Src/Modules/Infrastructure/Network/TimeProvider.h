@@ -1,6 +1,9 @@
 /**
  * @file Modules/Infrastructure/TimeProvider.h
  * This modules provides an NTP-like time synchronization mechanism.
+ * The offset and drift of the clock of each teammate are estimated by a Kalman
+ * filter. It is updated with the round trips and with the send timestamp every
+ * message contains, so the synchronization does not depend on round trips alone.
  * @author <a href="mailto:aaron.larisch@udo.edu">Aaron Larisch</a>
  */
 
@@ -13,8 +16,10 @@
 #include "Representations/Infrastructure/TeamCommData.h"
 #include "Representations/Infrastructure/Time.h"
 #include "Representations/Infrastructure/TeamCommSenderOutput.h"
+#include "Tools/Math/Eigen.h"
 #include <unordered_map>
 #include <array>
+#include <vector>
 
 MODULE(TimeProvider,
   REQUIRES(RobotInfo),
@@ -26,7 +31,12 @@ MODULE(TimeProvider,
   PROVIDES(TimeOffsets),
   PROVIDES(TimeSynchronization),
   LOADS_PARAMETERS(,
-    (int)(50) requestRttThreshold
+    (int)(50) requestRttThreshold, /**< Round trips are requested from teammates whose offset is less certain (in ms). */
+    (double)(0.001) offsetNoise, /**< The variance the offset gains per ms through jitter of the clocks (in ms^2/ms). */
+    (double)(1e-12) driftNoise, /**< The variance the drift gains per ms (in 1/ms). */
+    (double)(1e-4) initialDriftDeviation, /**< The standard deviation of the drift when a filter is started (in ms/ms). */
+    (double)(10.0) oneWayDeviation, /**< The standard deviation of the latency of a single message (in ms). */
+    (double)(0.1) latencyUpdateRatio /**< How much a round trip changes the mean latency [0..1]. */
   )
 );
 
@@ -44,6 +54,46 @@ private:
 
   std::array<unsigned char, MAX_NUM_PLAYERS> answered{false};
 
+  /** A message received from a teammate, which measures the offset plus the latency. */
+  struct OneWay
+  {
+    unsigned char player;
+    unsigned sent; /**< The remote time the message was sent. */
+    unsigned received; /**< The local time the message was received. */
+  };
+  std::vector<OneWay> oneWays; /**< The messages received in this frame. */
+
+  /** The estimate of the clock of a teammate. The offset is remote time - local time. */
+  struct ClockFilter
+  {
+    bool initialized = false;
+    unsigned timestamp = 0; /**< The local time the estimate refers to. */
+    Vector2d state = Vector2d::Zero(); /**< The offset (in ms) and the drift (in ms/ms). */
+    Matrix2d cov = Matrix2d::Zero();
+    double latency = 0.0; /**< The mean latency of a message (in ms), i.e. half the round trip time. */
+  };
+  std::array<ClockFilter, MAX_NUM_PLAYERS> filters;
+
+  /**
+   * Starts the filter of a teammate.
+   * @param filter The filter.
+   * @param offset The offset measured.
+   * @param variance The variance of the offset measured.
+   * @param timestamp The local time of the measurement.
+   */
+  void reset(ClockFilter& filter, double offset, double variance, unsigned timestamp) const;
+
+  /** Moves the estimate of a filter forward to the given local time. */
+  void predict(ClockFilter& filter, unsigned timestamp) const;
+
+  /**
+   * Fuses a measurement of the offset.
+   * @param filter The filter.
+   * @param offset The offset measured.
+   * @param variance The variance of the offset measured.
+   */
+  static void correct(ClockFilter& filter, double offset, double variance);
+
 public:
   void execute(tf::Subflow&);
   void update(TimeOffsets& timeOffsets);
@@ -6,6 +6,7 @@
 
 #include "PortAudioRecorder.h"
 #include "Tools/Settings.h"
+#include "Platform/SystemCall.h"
 
 MAKE_MODULE(PortAudioRecorder, cognitionInfrastructure)
 
@@ -50,7 +51,11 @@ PortAudioRecorder::PortAudioRecorder()
   inputParameters.suggestedLatency = latency;
   inputParameters.hostApiSpecificStreamInfo = nullptr;
 
-  paerr = Pa_OpenStream(&stream, &inputParameters, nullptr, sampleRate, paFramesPerBufferUnspecified, 0, nullptr, nullptr);
+  // the ring is written by the callback, so Cognition frames that take longer do not cause dropped samples
+  sampleRing.reserve(static_cast<std::size_t>(bufferDuration * sampleRate) * inputParameters.channelCount);
+  blockRing.reserve(1024);
+
+  paerr = Pa_OpenStream(&stream, &inputParameters, nullptr, sampleRate, paFramesPerBufferUnspecified, 0, &PortAudioRecorder::callback, this);
   if (paerr != paNoError)
   {
     OUTPUT_ERROR("PortAudioRecorder: Pa_OpenStream failed: " << Pa_GetErrorText(paerr) << "(" << paerr << ")");
@@ -105,12 +110,13 @@ void PortAudioRecorder::update(AudioData& audioData)
     }
   }
 
-  signed long available = Pa_GetStreamReadAvailable(stream);
-  if (available < 0)
-  {
-    OUTPUT_ERROR("PortAudioRecorder: Pa_GetStreamReadAvailable failed: " << Pa_GetErrorText(static_cast<PaError>(available)) << "(" << static_cast<PaError>(available) << ")");
-    return;
-  }
+  const std::size_t channels = inputParameters.channelCount;
+  const unsigned dropped = droppedSamples.exchange(0);
+  if (dropped > 0)
+    OUTPUT_WARNING("PortAudioRecorder: Dropped " << dropped / channels << " samples per channel, since the buffer is full");
+
+  // only whole frames of all channels are read
+  const std::size_t available = sampleRing.size() / channels * channels;
 
   // restart stream if no data is available over a longer period of time
   if (available == 0)
@@ -125,18 +131,44 @@ void PortAudioRecorder::update(AudioData& audioData)
   }
   noDataCount = 0;
 
-  audioData.samples.resize(available * audioData.channels);
-  paerr = Pa_ReadStream(stream, audioData.samples.data(), available);
-  if (paerr != paNoError)
+  // the timestamp of the first sample is derived from the last block that started before it
+  while (blockRing.size() > 0 && blockRing.peek(0, 1)[0].firstSample <= samplesRead)
   {
-    OUTPUT_ERROR("PortAudioRecorder: Pa_ReadStream failed: " << Pa_GetErrorText(paerr) << "(" << paerr << ")");
-    audioData.samples.clear();
+    currentBlock = blockRing.peek(0, 1)[0];
+    blockRing.consume(1);
+  }
+  audioData.timestamp = currentBlock.timestamp + static_cast<unsigned>((samplesRead - currentBlock.firstSample) / channels * 1000 / std::max(1u, audioData.sampleRate));
 
-    // restart stream immediately after timeout
-    if (paerr == paTimedOut)
-      Pa_StopStream(stream);
+  const SPSCRingBuffer<float>::Window window = sampleRing.peek(0, available);
+  audioData.samples.assign(window.first.begin(), window.first.end());
+  audioData.samples.insert(audioData.samples.end(), window.second.begin(), window.second.end());
+  sampleRing.consume(available);
+  samplesRead += available;
+  audioData.isValid = true;
+}
 
-    return;
+int PortAudioRecorder::callback(const void* input, void*, unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags, void* userData)
+{
+  PortAudioRecorder& recorder = *static_cast<PortAudioRecorder*>(userData);
+  const std::size_t channels = recorder.inputParameters.channelCount;
+  if (!input)
+    return paContinue;
+
+  // the first sample was recorded before the callback was called
+  unsigned timestamp = SystemCall::getCurrentSystemTime();
+  if (timeInfo && timeInfo->inputBufferAdcTime > 0. && timeInfo->currentTime > timeInfo->inputBufferAdcTime)
+    timestamp -= static_cast<unsigned>((timeInfo->currentTime - timeInfo->inputBufferAdcTime) * 1000.);
+
+  // only whole frames of all channels are written
+  const std::size_t count = frameCount * channels;
+  const std::size_t fitting = std::min(count, recorder.sampleRing.space() / channels * channels);
+  const Block block = {recorder.sampleRing.written(), timestamp};
+  if (fitting > 0)
+  {
+    recorder.blockRing.push(&block, 1);
+    recorder.sampleRing.push(static_cast<const float*>(input), fitting);
   }
-  audioData.isValid = true;
+  if (fitting < count)
+    recorder.droppedSamples += static_cast<unsigned>(count - fitting);
+  return paContinue;
 }
@@ -10,6 +10,8 @@
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/AudioData.h"
 #include "Representations/Infrastructure/FrameInfo.h"
+#include "Tools/SPSCRingBuffer.h"
+#include <atomic>
 #include <mutex>
 
 MODULE(PortAudioRecorder,
@@ -19,20 +21,37 @@ MODULE(PortAudioRecorder,
     (std::string)("") deviceName, /**< Name of audio device. */
     (unsigned)(4) channels, /**< Number of channels to capture. */
     (unsigned)(22050) sampleRate, /**< Sample rate to capture. */
-    (float)(0.1f) latency 
+    (float)(0.1f) latency,
+    (float)(2.f) bufferDuration /**< Seconds of samples that are buffered if Cognition is delayed. */
   )
 );
 
 class PortAudioRecorder : public PortAudioRecorderBase
 {
 private:
+  /** The samples of a call of the PortAudio callback. */
+  struct Block
+  {
+    std::size_t firstSample = 0; /**< The index of the first sample of all samples written to the ring. */
+    unsigned timestamp = 0; /**< The time when the first sample was recorded. */
+  };
+
   void update(AudioData& audioData);
 
+  /** Called by PortAudio from its own thread to append the captured samples to the ring. */
+  static int callback(const void* input, void* output, unsigned long frameCount, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags, void* userData);
+
   PaStream* stream = nullptr;
   PaStreamParameters inputParameters;
   unsigned noDataCount = 0;
   static std::mutex mutex;
 
+  SPSCRingBuffer<float> sampleRing; /**< The interleaved samples written by the callback. */
+  SPSCRingBuffer<Block> blockRing; /**< The timestamps of the blocks in the sample ring. */
+  Block currentBlock; /**< The last block that started before the next sample read. */
+  std::size_t samplesRead = 0; /**< The number of samples read from the ring so far. */
+  std::atomic<unsigned> droppedSamples = 0; /**< The number of samples the callback could not write since the last frame. */
+
 public:
   PortAudioRecorder();
   ~PortAudioRecorder();
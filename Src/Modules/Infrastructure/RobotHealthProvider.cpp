@@ -15,11 +15,10 @@
 
 RobotHealthProvider::RobotHealthProvider()
     : lastExecutionTime(0), lastRelaxedHealthComputation(0), startBatteryLow(0), lastBatteryLevel(1), batteryVoltageFalling(false), highTemperatureSince(0)
+{
 #ifdef TARGET_ROBOT
-      ,
-      lastWlanCheckedTime(0)
+  systemMonitor = std::make_unique<SystemMonitor>(monitoredThreads, samplingInterval);
 #endif
-{
 }
 
 void RobotHealthProvider::update(RobotHealth& robotHealth)
@@ -49,11 +48,22 @@ void RobotHealthProvider::update(RobotHealth& robotHealth)
     SystemCall::text2Speech(robotName + "CPU temperature at exclamation mark");
   }
 #ifdef TARGET_ROBOT
-  if (theFrameInfo.getTimeSince(lastWlanCheckedTime) > 10 * 1000)
+  // cpu load, memory load, wlan and the threads are sampled in the background
+  if (const SystemMonitor::Snapshot* snapshot = systemMonitor->read())
   {
-    lastWlanCheckedTime = theFrameInfo.time;
-    ASSERT(Global::getSettings().naoVersion == RobotConfig::V6);
-    robotHealth.wlan = NaoBodyV6::getWlanStatus();
+    robotHealth.load[0] = (unsigned char)(snapshot->load[0] * 10.f);
+    robotHealth.load[1] = (unsigned char)(snapshot->load[1] * 10.f);
+    robotHealth.load[2] = (unsigned char)(snapshot->load[2] * 10.f);
+    robotHealth.memoryUsage = (unsigned char)(snapshot->memoryUsage * 100.f);
+    robotHealth.wlan = snapshot->wlan;
+    robotHealth.threadLoads.clear();
+    for (size_t i = 0; i < monitoredThreads.size(); ++i)
+      if (snapshot->threadUsage[i] >= 0.f)
+      {
+        RobotHealth::ThreadLoad& threadLoad = robotHealth.threadLoads.emplace_back();
+        threadLoad.name = monitoredThreads[i];
+        threadLoad.cpuUsage = (unsigned char)std::min(snapshot->threadUsage[i] * 100.f + 0.5f, 255.f);
+      }
   }
 #endif
 
@@ -68,13 +78,15 @@ void RobotHealthProvider::update(RobotHealth& robotHealth)
     robotHealth.jointWithMaxTemperature = static_cast<Joints::Joint>(std::distance(theJointSensorData.temperatures.begin() + 14, maxTemperature));
     robotHealth.totalCurrent = std::accumulate(theJointSensorData.currents.begin(), theJointSensorData.currents.end(), 0.0f);
 
-    // Add cpu load, memory load and robot name:
+#ifndef TARGET_ROBOT
+    // Add cpu load and memory load:
     float memoryUsage, load[3];
     SystemCall::getLoad(memoryUsage, load);
     robotHealth.load[0] = (unsigned char)(load[0] * 10.f);
     robotHealth.load[1] = (unsigned char)(load[1] * 10.f);
     robotHealth.load[2] = (unsigned char)(load[2] * 10.f);
     robotHealth.memoryUsage = (unsigned char)(memoryUsage * 100.f);
+#endif
     robotHealth.robotName = Global::getSettings().robotName;
 
     //battery warning
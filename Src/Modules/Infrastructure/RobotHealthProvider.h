@@ -16,7 +16,8 @@
 #include "Representations/Perception/CLIPFieldLinesPercept.h"
 #include "Representations/Perception/CLIPGoalPercept.h"
 #ifdef TARGET_ROBOT
-#include "Platform/Linux/NaoBodyV6.h"
+#include "Platform/Linux/SystemMonitor.h"
+#include <memory>
 #endif
 
 MODULE(RobotHealthProvider,
@@ -35,7 +36,9 @@ MODULE(RobotHealthProvider,
     (int) temperatureFire,                /**< The temperature that makes the robot complaining stronger about the temperature. */
     (int) temperatureFireExclamationMark, /**< The temperature ... */
     (int) cpuHeat,
-    (bool) enableName                    /**< The robots mentions its name when complaining if true */
+    (bool) enableName,                    /**< The robots mentions its name when complaining if true */
+    (std::vector<std::string>) monitoredThreads, /**< The threads whose CPU usage is determined. */
+    (unsigned)(1000) samplingInterval   /**< The time between two samples of the system load in ms. */
   )
 );
 
@@ -65,7 +68,7 @@ private:
   unsigned highTemperatureSince;
   unsigned highCPUTemperatureSince = 0;
 #ifdef TARGET_ROBOT
-  unsigned int lastWlanCheckedTime;
+  std::unique_ptr<SystemMonitor> systemMonitor; /**< Samples the load in the background. */
 #endif
 
   /** The main function, called every cycle
@@ -10,12 +10,14 @@
 void SequenceImageProvider::update(SequenceImage& lowFrameRateImage)
 {
   lowFrameRateImage.noInSequence = 0;
+  lowFrameRateImage.image.frame.reset(); // the camera buffer can be queued again, since the previous image is not streamed anymore
   logCurrentImage(lowFrameRateImage, false);
 }
 
 void SequenceImageProvider::update(SequenceImageUpper& lowFrameRateImage)
 {
   lowFrameRateImage.noInSequence = 0;
+  lowFrameRateImage.image.frame.reset(); // the camera buffer can be queued again, since the previous image is not streamed anymore
   logCurrentImage((SequenceImage&)lowFrameRateImage, true);
 }
 
@@ -66,9 +68,16 @@ void SequenceImageProvider::logCurrentImage(SequenceImage& lowFrameRateImage, bo
 void SequenceImageProvider::updateImage(SequenceImage& lfrImage, bool upper) const
 {
   const Image& image = upper ? (Image&)theImageUpper : theImage;
-  lfrImage.image.setImage(const_cast<Image::Pixel*>(image[0]));
-  lfrImage.image.setResolution(image.width, image.height);
-  lfrImage.image.timeStamp = image.timeStamp;
+  if (image.frame || !image.sharedFrame.expired())
+    lfrImage.image.shareImage(image);
+  else
+  {
+    // no camera buffer to share, but the source stays valid as long as the sequence image is used
+    lfrImage.image.setImage(image.image);
+    lfrImage.image.setResolution(image.width, image.height);
+    lfrImage.image.timeStamp = image.timeStamp;
+    lfrImage.image.imageSource = image.imageSource;
+  }
   lfrImage.noInSequence = currentCounterOfConsecutiveFrames;
 }
 
@@ -5,11 +5,13 @@
 #pragma once
 
 #include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/ImagePyramid.h"
 #include "Representations/Infrastructure/Thumbnail.h"
 
 MODULE(ThumbnailProvider,
   REQUIRES(Image),
-  REQUIRES(ImageUpper),
+  REQUIRES(ImagePyramid),
+  REQUIRES(ImagePyramidUpper),
   PROVIDES_CONCURRENT_WITHOUT_MODIFY(Thumbnail),
   PROVIDES_CONCURRENT_WITHOUT_MODIFY(ThumbnailUpper),
   LOADS_PARAMETERS(,
@@ -25,11 +27,10 @@ public:
   void update(ThumbnailUpper& thumbnail);
 
 private:
-  void shrinkNxN(const Image& srcImage, Thumbnail::ThumbnailImage& destImage);
-  void shrink8x8SSE(const Image& srcImage, Thumbnail::ThumbnailImage& destImage);
-  void shrink4x4SSE(const Image& srcImage, Thumbnail::ThumbnailImage& destImage);
-
-  void shrinkGrayscaleNxN(const Image& srcImage, Thumbnail::ThumbnailImageGrayscale& destImage);
-  void shrinkGrayscale8x8SSE(const Image& srcImage, Thumbnail::ThumbnailImageGrayscale& destImage);
-  void shrinkGrayscale4x4SSE(const Image& srcImage, Thumbnail::ThumbnailImageGrayscale& destImage);
+  /**
+   * Copies a level of an image pyramid into a thumbnail.
+   * @param imagePyramid The pyramid of the image that is downscaled.
+   * @param thumbnail The thumbnail that is filled.
+   */
+  void shrink(const ImagePyramid& imagePyramid, Thumbnail& thumbnail);
 };
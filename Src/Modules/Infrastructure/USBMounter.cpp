@@ -4,6 +4,7 @@
 #include <thread>
 #include <chrono>
 #include <filesystem>
+#include <sys/stat.h>
 
 USBMounter::USBMounter()
 {
@@ -57,7 +58,7 @@ void USBMounter::update(USBStatus& usbStatus)
     switch (usbStatus.status)
     {
     case USBStatus::MountStatus::inactive:
-      if (theRobotInfo.transitionToFramework > 0.f)
+      if (theRobotInfo.transitionToFramework > 0.f && !formatted.valid())
       {
         usbStatus.status = USBStatus::MountStatus::mounting;
         nextMountStatus = std::async(std::launch::async, &USBMounter::mount, this);
@@ -98,6 +99,14 @@ void USBMounter::formatBehavior()
 
   (keyCombinationPressed ? keyReleasedTime : keyPressedTime) = theFrameInfo.time;
 
+  if (formatted.valid())
+  {
+    if (formatted.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+      return;
+    if (formatted.get())
+      SystemCall::text2Speech("Finished");
+  }
+
   if (theUSBStatus.status != USBStatus::MountStatus::inactive || theRobotInfo.transitionToFramework > 0.f)
   {
     saidFormatUsb = false;
@@ -121,16 +130,13 @@ void USBMounter::formatBehavior()
   {
     SystemCall::text2Speech("Confirmed");
     saidFormatUsb = false;
-    if (system("/usr/bin/format_usb") == 0)
-      SystemCall::text2Speech("Finished");
+    formatted = std::async(std::launch::async, [] { return system("/usr/bin/format_usb") == 0; });
   }
 }
 
 USBStatus::MountStatus USBMounter::checkStatus() const
 {
-  int ret = system(("mountpoint -q \"" + mountPath + "\"").c_str());
-
-  if (ret != 0)
+  if (!isMountPoint())
     return USBStatus::MountStatus::notMounted;
 
   std::cout << "USBMounter: Status: USB stick is mounted!" << std::endl;
@@ -173,6 +179,13 @@ USBStatus::MountStatus USBMounter::checkStatus() const
   return status;
 }
 
+bool USBMounter::isMountPoint() const
+{
+  struct stat path, parent;
+  return stat(mountPath.c_str(), &path) == 0 && stat((mountPath + "/..").c_str(), &parent) == 0
+         && (path.st_dev != parent.st_dev || path.st_ino == parent.st_ino);
+}
+
 USBStatus::MountStatus USBMounter::mount() const
 {
   if (const USBStatus::MountStatus status = checkStatus(); status == USBStatus::MountStatus::readOnly || status == USBStatus::MountStatus::readWrite)
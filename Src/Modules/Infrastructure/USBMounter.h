@@ -35,7 +35,14 @@ private:
   USBStatus::MountStatus unmount() const;
   USBStatus::MountStatus checkStatus() const;
 
+  /**
+   * Checks whether a file system is mounted at the mount path by comparing the
+   * device of the directory with the device of its parent.
+   */
+  bool isMountPoint() const;
+
   std::future<USBStatus::MountStatus> nextMountStatus;
+  std::future<bool> formatted; /**< The result of formatting the USB stick. Valid while it is formatted. */
   USBStatus::MountStatus initialStatus = USBStatus::MountStatus::inactive;
   bool active = false;
 
@@ -0,0 +1,71 @@
+/**
+ * @file Modules/Infrastructure/WarmStartProvider.cpp
+ * This file implements a module that periodically writes the state of the filters to a file
+ * and restores it when the framework is started again.
+ */
+
+#include "WarmStartProvider.h"
+#include "Platform/SystemCall.h"
+#include "Tools/Streams/InStreams.h"
+#include "Tools/Streams/OutStreams.h"
+#include <chrono>
+#include <cstdio>
+
+WarmStartProvider::WarmStartProvider()
+{
+  if (SystemCall::getMode() != SystemCall::physicalRobot)
+    return;
+
+  InBinaryFile stream(filename);
+  if (!stream.exists())
+    return;
+
+  unsigned fileVersion = 0, wallTime = 0;
+  stream >> fileVersion;
+  if (fileVersion != version)
+    return;
+  stream >> wallTime;
+  const unsigned now = getWallTime();
+  if (stream.eof() || wallTime > now || now - wallTime > maxAge)
+    return;
+
+  WarmStart snapshot;
+  stream >> snapshot.robotPoseHypotheses >> snapshot.fieldColors >> snapshot.fieldColorsUpper;
+  snapshot.restored = true;
+  snapshot.age = now - wallTime;
+  restored = snapshot;
+}
+
+void WarmStartProvider::update(WarmStart& warmStart)
+{
+  warmStart = restored;
+
+  // the representations used are the ones of the previous frame, so the first frame has nothing to write
+  if (SystemCall::getMode() == SystemCall::physicalRobot && snapshotInterval > 0
+      && (!lastSnapshot || theFrameInfo.getTimeSince(lastSnapshot) >= snapshotInterval))
+  {
+    if (lastSnapshot)
+      writeSnapshot();
+    lastSnapshot = theFrameInfo.time;
+  }
+}
+
+void WarmStartProvider::writeSnapshot() const
+{
+  // a crash while writing must not leave a partial snapshot behind
+  const std::string temporary = filename + ".tmp";
+  {
+    OutBinaryFile stream(temporary);
+    if (!stream.exists())
+      return;
+    stream << version << getWallTime() << theRobotPoseHypotheses << theFieldColors << theFieldColorsUpper;
+  }
+  std::rename(temporary.c_str(), filename.c_str());
+}
+
+unsigned WarmStartProvider::getWallTime()
+{
+  return static_cast<unsigned>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+MAKE_MODULE(WarmStartProvider, cognitionInfrastructure)
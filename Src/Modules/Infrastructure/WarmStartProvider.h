@@ -0,0 +1,50 @@
+/**
+ * @file Modules/Infrastructure/WarmStartProvider.h
+ * This file declares a module that periodically writes the state of the filters to a file
+ * and restores it when the framework is started again.
+ */
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Infrastructure/WarmStart.h"
+
+MODULE(WarmStartProvider,
+  REQUIRES(FrameInfo),
+  USES(RobotPoseHypotheses),
+  USES(FieldColors),
+  USES(FieldColorsUpper),
+  PROVIDES(WarmStart),
+  LOADS_PARAMETERS(,
+    (std::string)("/dev/shm/warmStart.bin") filename, /**< The file of the snapshot, which should be in memory, so that writing it is cheap. */
+    (int)(1000) snapshotInterval, /**< The time between two snapshots in ms (0 = never). */
+    (unsigned)(20) maxAge /**< Snapshots older than this in s are ignored, because the robot was probably moved. */
+  )
+);
+
+/**
+ * The snapshot is only written and restored on the robot. In the simulator, multiple robots
+ * would share the file and the filters are not restarted without the whole simulation.
+ */
+class WarmStartProvider : public WarmStartProviderBase
+{
+public:
+  /** Constructor. Restores the snapshot. */
+  WarmStartProvider();
+
+private:
+  /** The layout of the snapshot file, which must be changed whenever the streamed representations change. */
+  static constexpr unsigned version = 2;
+
+  void update(WarmStart& warmStart);
+
+  /** Writes a snapshot of the current state. It replaces the previous one atomically. */
+  void writeSnapshot() const;
+
+  /** @return The current time in s since the epoch, which is the same across runs of the framework. */
+  static unsigned getWallTime();
+
+  WarmStart restored; /**< The snapshot restored, which is provided unchanged. */
+  unsigned lastSnapshot = 0; /**< The frame time of the last snapshot. */
+};
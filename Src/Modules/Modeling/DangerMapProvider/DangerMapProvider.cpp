@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include "Tools/Math/Transformation.h"
 #include "DangerMapProvider.h"
 
@@ -14,48 +16,62 @@ void DangerMapProvider::update(DangerMap& dangerMap)
 
 void DangerMapProvider::updateDanger()
 {
-  Vector2f ballPos = Transformation::robotToField(theRobotPose, theBallModel.estimate.position);
+  // Each source only raises the danger of the cells within maxDistanceForUpdate, so only these are visited.
+  // The contributions are added in the same order as before, since adding zero for the cells outside is exact.
+  std::array<float, DangerMap::numOfCells> oldDanger;
+  std::copy(std::begin(localDangerMap.danger), std::end(localDangerMap.danger), oldDanger.begin());
 
-  for (int cellNo = 0; cellNo < DangerMap::numOfCells; cellNo++)
-  {
-    // danger naturally decreases
-    localDangerMap.danger[cellNo] -= dangerUpdateLoss;
+  // danger naturally decreases
+  for (float& danger : localDangerMap.danger)
+    danger -= dangerUpdateLoss;
 
-    // check if ball has been sighted and update..
-    if (theBallModel.timeWhenLastSeen == theFrameInfo.time)
-    {
-      float distance = (getFieldCoordinates(cellNo) - ballPos).norm();
-      localDangerMap.danger[cellNo] += ballDangerUpdate - std::min(ballDangerUpdate, ballDangerUpdate * (distance / maxDistanceForUpdate));
-    }
-    // TODO: team mate ball models
+  // check if ball has been sighted and update..
+  if (theBallModel.timeWhenLastSeen == theFrameInfo.time)
+    addDanger(Transformation::robotToField(theRobotPose, theBallModel.estimate.position), ballDangerUpdate);
+  // TODO: team mate ball models
 
-    // now check for robots
-    // own robot map
-    for (auto& robot : theRobotMap.robots)
-    {
-      if (robot.robotType == RobotEstimate::teammateRobot)
-        continue;
-      float distance = (getFieldCoordinates(cellNo) - robot.pose.translation).norm();
-      localDangerMap.danger[cellNo] += robotDangerUpdate - std::min(robotDangerUpdate, robotDangerUpdate * (distance / maxDistanceForUpdate));
-    }
+  // now check for robots
+  // own robot map
+  for (auto& robot : theRobotMap.robots)
+    if (robot.robotType != RobotEstimate::teammateRobot)
+      addDanger(robot.pose.translation, robotDangerUpdate);
 
-    if (includeTeammateData)
-    {
-      // from team mate data
-      for (auto& mate : theTeammateData.teammates)
-      {
-        for (auto& robot : mate.localRobotMap.robots)
-        {
-          if (robot.robotType == RobotEstimate::teammateRobot)
-            continue;
-          float distance = (getFieldCoordinates(cellNo) - robot.pose.translation).norm();
-          localDangerMap.danger[cellNo] += robotDangerUpdate - std::min(robotDangerUpdate, robotDangerUpdate * (distance / maxDistanceForUpdate));
-        }
-      }
-    }
-    // finally, clip to [0..1]
+  if (includeTeammateData)
+  {
+    // from team mate data
+    for (auto& mate : theTeammateData.teammates)
+      for (auto& robot : mate.localRobotMap.robots)
+        if (robot.robotType != RobotEstimate::teammateRobot)
+          addDanger(robot.pose.translation, robotDangerUpdate);
+  }
+
+  // finally, clip to [0..1]
+  bool changed = false;
+  for (int cellNo = 0; cellNo < DangerMap::numOfCells; cellNo++)
+  {
     localDangerMap.danger[cellNo] = std::max(0.f, std::min(localDangerMap.danger[cellNo], 1.f));
+    changed |= localDangerMap.danger[cellNo] != oldDanger[cellNo];
   }
+  if (changed)
+    localDangerMap.timeWhenChanged = theFrameInfo.time;
+}
+
+void DangerMapProvider::addDanger(const Vector2f& position, const float update)
+{
+  const float xOffset = theFieldDimensions.xPosOpponentGroundline;
+  const float yOffset = theFieldDimensions.yPosLeftSideline;
+  const float stepSize = static_cast<float>(DangerMap::stepSize);
+  const int minX = std::max(0, static_cast<int>(std::floor((position.x() - maxDistanceForUpdate + xOffset) / stepSize)));
+  const int maxX = std::min(DangerMap::numOfCellsX - 1, static_cast<int>(std::floor((position.x() + maxDistanceForUpdate + xOffset) / stepSize)));
+  const int minY = std::max(0, static_cast<int>(std::floor((position.y() - maxDistanceForUpdate + yOffset) / stepSize)));
+  const int maxY = std::min(DangerMap::numOfCellsY - 1, static_cast<int>(std::floor((position.y() + maxDistanceForUpdate + yOffset) / stepSize)));
+  for (int x = minX; x <= maxX; x++)
+    for (int y = minY; y <= maxY; y++)
+    {
+      const int cellNo = x * DangerMap::numOfCellsY + y;
+      float distance = (getFieldCoordinates(cellNo) - position).norm();
+      localDangerMap.danger[cellNo] += update - std::min(update, update * (distance / maxDistanceForUpdate));
+    }
 }
 
 bool DangerMapProvider::isViewBlocked(const RobotMap& robotMap, const Vector2f& pCellOnField, const Pose2f& pose, const float& camAngle)
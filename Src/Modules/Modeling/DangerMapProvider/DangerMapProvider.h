@@ -55,6 +55,9 @@ private:
   // main method
   void updateDanger();
 
+  // raises the danger of the cells around a position, decreasing linearly to zero at maxDistanceForUpdate
+  void addDanger(const Vector2f& position, float update);
+
   // cell has red border, if view to cell is blocked by a robot
   void drawDangerMap()
   {
@@ -0,0 +1,87 @@
+/**
+ * @file FieldLinesDistanceMapProvider.cpp
+ * Implements a module that computes the distances to the field lines on a grid
+ * whenever the field dimensions are loaded.
+ */
+
+#include "FieldLinesDistanceMapProvider.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include <cmath>
+
+void FieldLinesDistanceMapProvider::update(FieldLinesDistanceMap& fieldLinesDistanceMap)
+{
+  DECLARE_DEBUG_DRAWING("module:FieldLinesDistanceMapProvider:distances", "drawingOnField");
+
+  if (fieldLinesDistanceMap.fieldDimensionsUpdate != theFieldDimensions.lastUpdate || lastCellSize != cellSize)
+  {
+    build(fieldLinesDistanceMap);
+    fieldLinesDistanceMap.fieldDimensionsUpdate = theFieldDimensions.lastUpdate;
+    lastCellSize = cellSize;
+  }
+
+  COMPLEX_DRAWING("module:FieldLinesDistanceMapProvider:distances") draw(fieldLinesDistanceMap);
+}
+
+void FieldLinesDistanceMapProvider::build(FieldLinesDistanceMap& fieldLinesDistanceMap) const
+{
+  const Boundaryf& boundary = theFieldDimensions.boundary;
+  fieldLinesDistanceMap.cellSize = std::max(cellSize, 1.f);
+  fieldLinesDistanceMap.origin = Vector2f(boundary.x.min, boundary.y.min);
+  fieldLinesDistanceMap.cellsX = std::max(1, static_cast<int>(std::ceil(boundary.x.getSize() / fieldLinesDistanceMap.cellSize)));
+  fieldLinesDistanceMap.cellsY = std::max(1, static_cast<int>(std::ceil(boundary.y.getSize() / fieldLinesDistanceMap.cellSize)));
+  fieldLinesDistanceMap.cells.resize(fieldLinesDistanceMap.cellsX * fieldLinesDistanceMap.cellsY);
+
+  // The directions and squared lengths are the same for all cells.
+  struct Segment
+  {
+    Vector2f from;
+    Vector2f direction;
+    float sqrLength;
+  };
+  std::vector<Segment> segments;
+  segments.reserve(theFieldDimensions.fieldLines.lines.size());
+  for (const FieldDimensions::LinesTable::Line& line : theFieldDimensions.fieldLines.lines)
+    segments.push_back({line.from, line.to - line.from, (line.to - line.from).squaredNorm()});
+
+  FieldLinesDistanceMap::Cell* cell = fieldLinesDistanceMap.cells.data();
+  for (int y = 0; y < fieldLinesDistanceMap.cellsY; ++y)
+    for (int x = 0; x < fieldLinesDistanceMap.cellsX; ++x, ++cell)
+    {
+      const Vector2f center = fieldLinesDistanceMap.origin + Vector2f(x + 0.5f, y + 0.5f) * fieldLinesDistanceMap.cellSize;
+      float minSqrDistance = std::numeric_limits<float>::max();
+      Vector2f closestOffset = Vector2f::Zero();
+      for (const Segment& segment : segments)
+      {
+        const Vector2f offset = center - segment.from;
+        const float t = segment.sqrLength > 0.f ? std::clamp(offset.dot(segment.direction) / segment.sqrLength, 0.f, 1.f) : 0.f;
+        const Vector2f toCenter = offset - segment.direction * t;
+        const float sqrDistance = toCenter.squaredNorm();
+        if (sqrDistance < minSqrDistance)
+        {
+          minSqrDistance = sqrDistance;
+          closestOffset = toCenter;
+        }
+      }
+      cell->distance = std::sqrt(minSqrDistance);
+      cell->gradient = cell->distance > 0.f ? Vector2f(closestOffset / cell->distance) : Vector2f::Zero();
+    }
+}
+
+void FieldLinesDistanceMapProvider::draw(const FieldLinesDistanceMap& fieldLinesDistanceMap) const
+{
+  if (!fieldLinesDistanceMap.isValid())
+    return;
+  const int step = std::max(1, static_cast<int>(drawingStep / fieldLinesDistanceMap.cellSize));
+  for (int y = step / 2; y < fieldLinesDistanceMap.cellsY; y += step)
+    for (int x = step / 2; x < fieldLinesDistanceMap.cellsX; x += step)
+    {
+      const FieldLinesDistanceMap::Cell& cell = fieldLinesDistanceMap.cells[y * fieldLinesDistanceMap.cellsX + x];
+      const Vector2f center = fieldLinesDistanceMap.origin + Vector2f(x + 0.5f, y + 0.5f) * fieldLinesDistanceMap.cellSize;
+      const unsigned char brightness = static_cast<unsigned char>(std::max(0.f, 255.f - cell.distance * 255.f / 1000.f));
+      const Vector2f tip = center + cell.gradient * (drawingStep * 0.4f);
+      ARROW("module:FieldLinesDistanceMapProvider:distances", center.x(), center.y(), tip.x(), tip.y(),
+            10, Drawings::solidPen, ColorRGBA(brightness, 0, 255 - brightness));
+    }
+}
+
+MAKE_MODULE(FieldLinesDistanceMapProvider, modeling)
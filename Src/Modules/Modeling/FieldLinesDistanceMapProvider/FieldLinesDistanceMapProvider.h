@@ -0,0 +1,36 @@
+/**
+ * @file FieldLinesDistanceMapProvider.h
+ * Declares a module that computes the distances to the field lines on a grid
+ * whenever the field dimensions are loaded.
+ */
+
+#pragma once
+
+#include "Representations/Configuration/FieldDimensions.h"
+#include "Representations/Modeling/FieldLinesDistanceMap.h"
+#include "Tools/Module/Module.h"
+
+MODULE(FieldLinesDistanceMapProvider,
+  REQUIRES(FieldDimensions),
+  PROVIDES_WITHOUT_MODIFY(FieldLinesDistanceMap),
+  LOADS_PARAMETERS(,
+    (float)(40.f) cellSize, /**< The edge length of a cell in mm. */
+    (float)(200.f) drawingStep /**< The distance between the cells drawn in mm. */
+  )
+);
+
+class FieldLinesDistanceMapProvider : public FieldLinesDistanceMapProviderBase
+{
+  float lastCellSize = 0.f; /**< The cell size the map was built with. */
+
+  void update(FieldLinesDistanceMap& fieldLinesDistanceMap);
+
+  /**
+   * Computes the distance and its gradient of each cell to the closest field line.
+   * @param fieldLinesDistanceMap The map that is rebuilt.
+   */
+  void build(FieldLinesDistanceMap& fieldLinesDistanceMap) const;
+
+  /** Draws some of the cells, so the drawing stays small. */
+  void draw(const FieldLinesDistanceMap& fieldLinesDistanceMap) const;
+};
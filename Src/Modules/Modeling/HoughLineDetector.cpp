@@ -1,10 +1,17 @@
 #include "HoughLineDetector.h"
+#include "Platform/SystemCall.h"
+#include "Tools/Math/FastMath.h"
+#include "Tools/SIMD.h"
+#include <limits>
 
 HoughLineDetector::HoughLineDetector() {}
 
-void HoughLineDetector::setParameters(
-    const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking, const unsigned int height, const unsigned int width)
+void HoughLineDetector::setParameters(const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking,
+    const unsigned int height, const unsigned int width, unsigned int coarseAngleStep, unsigned int timeBudget)
 {
+  this->coarseAngleStep = std::max(coarseAngleStep, 1u);
+  this->timeBudget = timeBudget;
+
   if (!initialized || this->anglePrecision != anglePrecision || this->distancePrecision != distancePrecision || this->threshold != minPointsForLine
       || this->thresholdWalking != minPointsForLineWalking || this->height != height || this->width != width)
   {
@@ -23,26 +30,14 @@ void HoughLineDetector::setParameters(
     // initialize Sin & Cos Cache
     sin_cache.resize(circumference);
     cos_cache.resize(circumference);
-
-    // iniatialize Hough-Space-Accumulator
-    houghSpace.resize(circumference);
-
     for (unsigned alpha = 0; alpha < circumference; alpha++)
     {
-      houghSpace[alpha].resize(diagonal);
-      for (unsigned dist = 0; dist < diagonal; dist++)
-      {
-        houghSpace[alpha][dist].count = 0;
-        houghSpace[alpha][dist].alpha = static_cast<float>(alpha);
-        houghSpace[alpha][dist].dist = static_cast<float>(dist);
-        houghSpace[alpha][dist].processed = 0;
-        houghSpace[alpha][dist].points.reserve(30);
-      }
-
       sin_cache[alpha] = std::sin(alpha * pi / semiCircumference);
       cos_cache[alpha] = std::cos(alpha * pi / semiCircumference);
     }
 
+    // iniatialize Hough-Space-Accumulator
+    houghSpace.assign(circumference * diagonal, 0);
     changedHoughPoints.clear();
 
     initialized = true;
@@ -51,29 +46,80 @@ void HoughLineDetector::setParameters(
 
 void HoughLineDetector::reset()
 {
-  //for (unsigned alpha = 0; alpha < circumference; alpha++)
-  //{
-  //  for (unsigned dist = 0; dist < diagonal; dist++)
-  //  {
-  //    houghSpace[alpha][dist].count = 0;
-  //    houghSpace[alpha][dist].alpha = static_cast<float>(alpha);
-  //    houghSpace[alpha][dist].dist = static_cast<float>(dist);
-  //    houghSpace[alpha][dist].processed = 0;
-  //    houghSpace[alpha][dist].points.clear();
-  //  }
-  //}
-
-  for (Vector2i& v : changedHoughPoints)
+  for (unsigned index : changedHoughPoints)
+    houghSpace[index] = 0;
+  changedHoughPoints.clear();
+}
+
+bool HoughLineDetector::getCell(const Vector2i& point, unsigned& alpha, unsigned& dist) const
+{
+  int d = static_cast<int>(point.x() * cos_cache[alpha] + point.y() * sin_cache[alpha]);
+  if (d < 0)
   {
-    const unsigned alpha = v.x();
-    const unsigned dist = v.y();
-    houghSpace[alpha][dist].count = 0;
-    houghSpace[alpha][dist].alpha = static_cast<float>(alpha);
-    houghSpace[alpha][dist].dist = static_cast<float>(dist);
-    houghSpace[alpha][dist].processed = 0;
-    houghSpace[alpha][dist].points.clear();
+    d = -d;
+    alpha += semiCircumference;
   }
-  changedHoughPoints.clear();
+  dist = (d + static_cast<int>(distancePrecision / 2.f)) / distancePrecision;
+  return dist < diagonal;
+}
+
+HoughLineDetector::Peak HoughLineDetector::vote(const std::vector<Vector2i>& points, const std::vector<unsigned>& alphas, uint64_t startTime)
+{
+  // the angles in blocks of four, the padding votes for the cells of the last angle again and is ignored
+  const size_t numOfAlphas = (alphas.size() + 3) & ~size_t(3);
+  std::vector<float> cosines(numOfAlphas), sines(numOfAlphas);
+  for (size_t i = 0; i < numOfAlphas; ++i)
+  {
+    const unsigned alpha = alphas[std::min(i, alphas.size() - 1)];
+    cosines[i] = cos_cache[alpha];
+    sines[i] = sin_cache[alpha];
+  }
+  std::vector<int> distances(numOfAlphas);
+  const int rounding = static_cast<int>(distancePrecision / 2.f);
+
+  for (const Vector2i& point : points)
+  {
+    if (timeBudget && SystemCall::getCurrentThreadTime() - startTime > timeBudget)
+      break;
+
+    // the same computation as getCell(), four angles at once
+    const __m128 x = _mm_set1_ps(static_cast<float>(point.x()));
+    const __m128 y = _mm_set1_ps(static_cast<float>(point.y()));
+    for (size_t i = 0; i < numOfAlphas; i += 4)
+    {
+      const __m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_loadu_ps(&cosines[i])), _mm_mul_ps(y, _mm_loadu_ps(&sines[i])));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&distances[i]), _mm_cvttps_epi32(d));
+    }
+
+    for (size_t i = 0; i < alphas.size(); ++i)
+    {
+      unsigned alpha = alphas[i];
+      int d = distances[i];
+      if (d < 0)
+      {
+        d = -d;
+        alpha += semiCircumference;
+      }
+      const unsigned dist = (d + rounding) / distancePrecision;
+      if (dist >= diagonal)
+        continue;
+      const unsigned index = alpha * diagonal + dist;
+      if (houghSpace[index] < std::numeric_limits<short>::max())
+        ++houghSpace[index];
+      changedHoughPoints.push_back(index);
+    }
+  }
+
+  Peak peak;
+  for (unsigned index : changedHoughPoints)
+  {
+    const unsigned alpha = index / diagonal;
+    const unsigned dist = index % diagonal;
+    const int count = houghSpace[index];
+    if (count > peak.count || (count == peak.count && (alpha < peak.alpha || (alpha == peak.alpha && dist < peak.dist))))
+      peak = {alpha, dist, count};
+  }
+  return peak;
 }
 
 bool HoughLineDetector::execute(const RingBuffer<std::vector<BallPercept>, BALLPERCEPT_BUFFER_LENGTH>& bpr, const CameraMatrix& cameraMatrix, bool isWalking, BallPercept& rollingBall, Vector2f& velocity)
@@ -81,111 +127,90 @@ bool HoughLineDetector::execute(const RingBuffer<std::vector<BallPercept>, BALLP
   if (!initialized || !(bpr.size() >= (isWalking ? thresholdWalking : threshold)))
     return false;
 
-  std::vector<Vector3i> processedHoughPoints;
+  const uint64_t startTime = timeBudget ? SystemCall::getCurrentThreadTime() : 0;
 
+  // Percepts that are too close to one that was already accepted do not vote.
+  std::vector<const BallPercept*> percepts;
+  std::vector<Vector2i> points;
   for (const std::vector<BallPercept>& bpv : bpr)
   {
     for (const BallPercept& p : bpv)
     {
-      for (unsigned alpha = 0; alpha < semiCircumference; alpha++)
+      bool duplicate = false;
+      Vector2a anglesP = getAngles(p.relativePositionOnField, cameraMatrix);
+      for (const BallPercept* other : percepts)
       {
-        int dist;
-        dist = static_cast<int>(getDistanceFromHoughTransform(p.relativePositionOnField.cast<int>().x(), p.relativePositionOnField.cast<int>().y(), alpha));
-
-        int alphaTemp;
-        alphaTemp = alpha;
-        if (dist < 0)
-        {
-          dist = -dist;
-          alphaTemp = semiCircumference + alphaTemp;
-        }
-        dist = (dist + static_cast<int>(distancePrecision / 2.f)) / distancePrecision;
-
-        bool duplicate = false;
-        Vector2a anglesP = getAngles(p.relativePositionOnField, cameraMatrix);
-        for (size_t i = 0; i < houghSpace[alphaTemp][dist].points.size(); i++)
+        float distance = (p.relativePositionOnField - other->relativePositionOnField).norm();
+        Vector2a anglesDiff = getAngles(other->relativePositionOnField, cameraMatrix) - anglesP;
+        Angle angleXDiff = anglesDiff.x();
+        Angle angleYDiff = anglesDiff.y();
+        if ((angleXDiff < 2_deg && angleYDiff < 0.5_deg) || distance < distancePrecision)
         {
-          float distance = (p.relativePositionOnField - (*houghSpace[alphaTemp][dist].points.at(i)).relativePositionOnField).norm();
-          Vector2a anglesHSP = getAngles((*houghSpace[alphaTemp][dist].points.at(i)).relativePositionOnField, cameraMatrix);
-          Vector2a anglesDiff = anglesHSP - anglesP;
-          //float minDistance = p.relativePositionOnField.norm() * 0.02f;
-          //if (isWalking)
-          //{
-          //  minDistance *= 2.f;
-          //}
-
-          //if (distance < std::max(static_cast<float>(distancePrecision), minDistance))
-          Angle angleXDiff = anglesDiff.x();
-          Angle angleYDiff = anglesDiff.y();
-          if ((angleXDiff < 2_deg && angleYDiff < 0.5_deg) || distance < distancePrecision)
-          {
-            duplicate = true;
-            //CIRCLE("module:HoughLineDetector:houghLine", p.relativePositionOnField.x(), p.relativePositionOnField.y(), 50, 2, Drawings::solidPen, ColorRGBA::black, Drawings::solidBrush, ColorRGBA(0, 0, 0, 127));
-            break;
-          }
-        }
-
-
-        if (!duplicate)
-        {
-          houghSpace[alphaTemp][dist].count++;
-          houghSpace[alphaTemp][dist].points.push_back(&p);
-          changedHoughPoints.push_back(Vector2i(alphaTemp, dist));
-
-          if (houghSpace[alphaTemp][dist].processed == 0 && houghSpace[alphaTemp][dist].count >= (isWalking ? threshold * 2 : threshold))
-          {
-            houghSpace[alphaTemp][dist].processed = 1;
-            processedHoughPoints.push_back(Vector3i(alphaTemp, dist, 0));
-          }
+          duplicate = true;
+          break;
         }
       }
+      if (!duplicate)
+      {
+        percepts.push_back(&p);
+        points.push_back(p.relativePositionOnField.cast<int>());
+      }
     }
   }
 
-  for (Vector3i& v : processedHoughPoints)
-    v.z() = houghSpace[v.x()][v.y()].count;
+  // vote for all or every n-th angle and refine around the best one
+  std::vector<unsigned> alphas;
+  for (unsigned alpha = 0; alpha < semiCircumference; alpha += coarseAngleStep)
+    alphas.push_back(alpha);
+  Peak peak = vote(points, alphas, startTime);
+  if (coarseAngleStep > 1 && peak.count > 0)
+  {
+    reset();
+    const unsigned coarseAlpha = peak.alpha % semiCircumference;
+    alphas.clear();
+    for (int offset = 1 - static_cast<int>(coarseAngleStep); offset < static_cast<int>(coarseAngleStep); ++offset)
+      alphas.push_back((coarseAlpha + semiCircumference + offset) % semiCircumference);
+    peak = vote(points, alphas, startTime);
+  }
 
-  std::sort(processedHoughPoints.begin(), processedHoughPoints.end(), sortCoordinates);
+  if (peak.count == 0 || peak.count < static_cast<int>(isWalking ? threshold * 2 : threshold))
+    return false;
 
-  if (processedHoughPoints.size() > 0)
+  // the percepts that voted for the winning cell
+  std::vector<const BallPercept*> linePoints;
+  for (size_t i = 0; i < points.size(); ++i)
   {
-    HoughPoint hp = houghSpace[processedHoughPoints[0].x()][processedHoughPoints[0].y()];
-    std::sort(hp.points.begin(), hp.points.end(), sortBPByTimestamp);
-    rollingBall = *hp.points.back();
-    float timeDiff = abs(static_cast<float>(hp.points.back()->timestamp) - static_cast<float>(hp.points.front()->timestamp));
-    Vector2f distanceDiff = hp.points.back()->relativePositionOnField - hp.points.front()->relativePositionOnField;
-    velocity = (distanceDiff / (timeDiff / 1000.f));
-
-    DEBUG_DRAWING("module:HoughLineDetector:houghLine", "drawingOnField")
-    {
-      CROSS("module:HoughLineDetector:houghLine", rollingBall.relativePositionOnField.x(), rollingBall.relativePositionOnField.y(), 20, 3, Drawings::solidPen, isWalking ? ColorRGBA::red : ColorRGBA::blue);
-      for (const BallPercept* bp : hp.points)
-      {
-        CIRCLE("module:HoughLineDetector:houghLine",
-            bp->relativePositionOnField.x(),
-            bp->relativePositionOnField.y(),
-            50,
-            2,
-            Drawings::solidPen,
-            isWalking ? ColorRGBA::red : ColorRGBA::blue,
-            Drawings::solidBrush,
-            isWalking ? ColorRGBA(255, 0, 0, 127) : ColorRGBA(0, 0, 255, 127));
-      }
-    }
-    return true;
+    unsigned alpha = peak.alpha % semiCircumference;
+    unsigned dist;
+    if (getCell(points[i], alpha, dist) && alpha == peak.alpha && dist == peak.dist)
+      linePoints.push_back(percepts[i]);
   }
-  return false;
-}
+  if (linePoints.empty())
+    return false;
 
-//int HoughLineDetector::getPointfromHessianNormal(const float& x, const float& a, const float& d, const bool& upper)
-//{
-//  float result = -(x * cos_cache[static_cast<unsigned>(std::ceil(a))] - d) / (sin_cache[static_cast<unsigned>(std::ceil(a))]);
-//  return std::min<int>(static_cast<int>(std::abs(result)), this->height);
-//}
+  std::sort(linePoints.begin(), linePoints.end(), sortBPByTimestamp);
+  rollingBall = *linePoints.back();
+  float timeDiff = abs(static_cast<float>(linePoints.back()->timestamp) - static_cast<float>(linePoints.front()->timestamp));
+  Vector2f distanceDiff = linePoints.back()->relativePositionOnField - linePoints.front()->relativePositionOnField;
+  velocity = (distanceDiff / (timeDiff / 1000.f));
 
-int HoughLineDetector::getDistanceFromHoughTransform(const int& x, const int& y, const int& alpha)
-{
-  return static_cast<int>(x * cos_cache[alpha] + y * sin_cache[alpha]);
+  DEBUG_DRAWING("module:HoughLineDetector:houghLine", "drawingOnField")
+  {
+    CROSS("module:HoughLineDetector:houghLine", rollingBall.relativePositionOnField.x(), rollingBall.relativePositionOnField.y(), 20, 3, Drawings::solidPen, isWalking ? ColorRGBA::red : ColorRGBA::blue);
+    for (const BallPercept* bp : linePoints)
+    {
+      CIRCLE("module:HoughLineDetector:houghLine",
+          bp->relativePositionOnField.x(),
+          bp->relativePositionOnField.y(),
+          50,
+          2,
+          Drawings::solidPen,
+          isWalking ? ColorRGBA::red : ColorRGBA::blue,
+          Drawings::solidBrush,
+          isWalking ? ColorRGBA(255, 0, 0, 127) : ColorRGBA(0, 0, 255, 127));
+    }
+  }
+  return true;
 }
 
 double HoughLineDetector::distanceAlpha(const double& a1, const double& a2)
@@ -204,7 +229,7 @@ double HoughLineDetector::distanceDist(const double& d1, const double& d2)
 Vector2a HoughLineDetector::getAngles(const Vector2f& relativePosition, const CameraMatrix& cameraMatrix)
 {
   Vector2a angles;
-  angles.x() = std::atan2(relativePosition.y(), relativePosition.x());
-  angles.y() = std::atan2(cameraMatrix.translation.z(), relativePosition.norm());
+  angles.x() = FastMath::atan2(relativePosition.y(), relativePosition.x());
+  angles.y() = FastMath::atan2(cameraMatrix.translation.z(), relativePosition.norm());
   return angles;
 }
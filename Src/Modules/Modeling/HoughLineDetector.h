@@ -4,66 +4,69 @@
 
 #define BALLPERCEPT_BUFFER_LENGTH 30
 
+/**
+ * Detects a rolling ball as a line in the recent ball percepts with a Hough
+ * transform. The accumulator only holds 16 bit counts. The percepts that
+ * voted for the winning cell are determined afterwards by voting again for
+ * its angle only.
+ */
 class HoughLineDetector
 {
 public:
   HoughLineDetector();
 
-  struct HoughPoint
-  {
-    std::vector<const BallPercept*> points;
-    unsigned count;
-    float alpha;
-    float dist;
-    short processed;
-  };
-
-  //struct HoughLine
-  //{
-  //  std::vector<HoughPoint*> houghPoints;
-  //  float meanAlpha = 0.f;
-  //  float meanDist = 0.f;
-  //  float sumDist = 0.f;
-  //  float sumSinAlpha = 0.f;
-  //  float sumCosAlpha = 0.f;
-  //};
-
-  void setParameters(
-      const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking, const unsigned int height, const unsigned int width);
+  /**
+   * Sets the parameters. The accumulator is only reallocated if they changed.
+   * @param anglePrecision The angular resolution of the accumulator.
+   * @param distancePrecision The distance resolution of the accumulator in mm.
+   * @param minPointsForLine The number of votes required for a line.
+   * @param minPointsForLineWalking The number of votes required for a line while walking.
+   * @param height The length of the field in mm.
+   * @param width The width of the field in mm.
+   * @param coarseAngleStep If greater than 1, only every n-th angle is voted for
+   *                        first and the maximum is refined around the best coarse angle.
+   * @param timeBudget The maximum thread time spent on voting in µs (0 = unlimited).
+   *                   The percepts that were not processed in time are ignored.
+   */
+  void setParameters(const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking,
+      const unsigned int height, const unsigned int width, unsigned int coarseAngleStep = 1, unsigned int timeBudget = 0);
   void reset();
   bool execute(const RingBuffer<std::vector<BallPercept>, BALLPERCEPT_BUFFER_LENGTH>& bpr, const CameraMatrix& cameraMatrix, bool isWalking, BallPercept& rollingBall, Vector2f& velocity);
 
 private:
+  /** A cell of the accumulator with its number of votes. */
+  struct Peak
+  {
+    unsigned alpha = 0;
+    unsigned dist = 0;
+    int count = 0;
+  };
+
   bool initialized = false;
 
-  //int getPointfromHessianNormal(const float& x, const float& a, const float& d, const bool& upper);
-  int getDistanceFromHoughTransform(const int& x, const int& y, const int& alpha);
+  /**
+   * Votes for the cells of some angles of all points.
+   * @param points The positions of the percepts.
+   * @param alphas The angles voted for, all in [0, semiCircumference).
+   * @param startTime The thread time when voting began.
+   * @return The cell with the most votes. Ties are resolved by the smaller angle and then the smaller distance.
+   */
+  Peak vote(const std::vector<Vector2i>& points, const std::vector<unsigned>& alphas, uint64_t startTime);
+
+  /**
+   * Determines the accumulator cell of a point for an angle in [0, semiCircumference).
+   * @param point The point.
+   * @param alpha The angle. An angle in [semiCircumference, circumference) is returned if the distance is negative.
+   * @param dist The distance is returned here.
+   * @return Is the cell inside the accumulator?
+   */
+  bool getCell(const Vector2i& point, unsigned& alpha, unsigned& dist) const;
 
   double distanceAlpha(const double& a1, const double& a2);
   double distanceDist(const double& d1, const double& d2);
 
   Vector2a getAngles(const Vector2f& relativePosition, const CameraMatrix& cameraMatrix);
 
-  static bool sortCoordinates(const Vector3i first, const Vector3i second)
-  {
-    if (first.z() != second.z())
-      return first.z() > second.z();
-    else if (first.x() != second.x())
-      return first.x() < second.x();
-    else
-      return first.y() < second.y();
-  }
-
-  static bool sortBPByDistance(const BallPercept* first, const BallPercept* second)
-  {
-    float distanceFirst = first->relativePositionOnField.norm();
-    float distanceSecond = second->relativePositionOnField.norm();
-    if (distanceFirst > distanceSecond)
-      return false;
-    else
-      return true;
-  }
-
   static bool sortBPByTimestamp(const BallPercept* first, const BallPercept* second)
   {
     if (first->timestamp > second->timestamp)
@@ -77,9 +80,11 @@ private:
   unsigned int width = 0, height = 0;
 
   unsigned int threshold = 0, thresholdWalking = 0;
+  unsigned int coarseAngleStep = 1;
+  unsigned int timeBudget = 0;
 
-  std::vector<Vector2i> changedHoughPoints;
-  std::vector<std::vector<HoughPoint>> houghSpace;
+  std::vector<short> houghSpace; /**< The votes per cell, circumference rows of diagonal distances. */
+  std::vector<unsigned> changedHoughPoints; /**< The indices of the cells that received votes. */
 
   std::vector<float> sin_cache;
   std::vector<float> cos_cache;
@@ -11,6 +11,7 @@
 #pragma once
 
 #include "Tools/Math/Eigen.h"
+#include <array>
 
 // measurement vectors which are elements of a euclidean vector space, e.g. velocity, accelerations
 template <int dim> class Measurement : public Eigen::Matrix<double, dim, 1>
@@ -31,7 +32,7 @@ public:
   }
 
 public:
-  static Measurement calcMean(const std::vector<Measurement, Eigen::aligned_allocator<Measurement>>& states)
+  template <std::size_t n> static Measurement calcMean(const std::array<Measurement, n>& states)
   {
     Measurement mean;
 
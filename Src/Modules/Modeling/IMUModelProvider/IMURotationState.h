@@ -10,6 +10,7 @@
 #pragma once
 
 #include "Tools/Math/Eigen.h"
+#include <array>
 
 // state for rotation and rotational velocity
 template <class M1, /* class M2,*/ int dim, int dim_cov = dim, int rotation_index = 0>
@@ -108,7 +109,7 @@ public: // define arithmetics
 protected:
   // TODO: check whether this concept of averageing can be applied directly on the rotations (average axis and average angle)
   // TODO: adjust maximum of iterations
-  static Eigen::Vector3d averageRotation(std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond>>& rotations, const Eigen::Quaterniond& m)
+  template <std::size_t n> static Eigen::Vector3d averageRotation(const std::array<Eigen::Quaterniond, n>& rotations, const Eigen::Quaterniond& m)
   {
     Eigen::Quaterniond mean(m);
 
@@ -132,27 +133,18 @@ protected:
     //            }
     //        }
 
-    std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>> rotational_differences;
-
     for (int i = 0; i < 10; ++i)
     {
       // calculate difference between the mean and the sigma points rotation by means of a rotation
-      rotational_differences.clear();
-      for (typename std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond>>::iterator j = rotations.begin(); j != rotations.end(); ++j)
-      {
-        Eigen::AngleAxis<double> rotational_difference = Eigen::AngleAxis<double>((*j) * mean.inverse());
-
-        // store as rotation vector representation
-        rotational_differences.push_back(rotational_difference.angle() * rotational_difference.axis());
-      }
-
-      // average difference quaternions in their 3d vectorial representation (length = angle, direction = axis)
+      // and average the difference quaternions in their 3d vectorial representation (length = angle, direction = axis)
+      const Eigen::Quaterniond inverseMean = mean.inverse();
       Eigen::Vector3d averaged_rotational_difference = Eigen::Vector3d::Zero();
-      for (typename std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>>::iterator j = rotational_differences.begin(); j != rotational_differences.end(); ++j)
+      for (const Eigen::Quaterniond& rotation : rotations)
       {
-        averaged_rotational_difference += *j;
+        Eigen::AngleAxis<double> rotational_difference = Eigen::AngleAxis<double>(rotation * inverseMean);
+        averaged_rotational_difference += rotational_difference.angle() * rotational_difference.axis();
       }
-      averaged_rotational_difference = 1.0 / static_cast<double>(rotational_differences.size()) * averaged_rotational_difference;
+      averaged_rotational_difference = 1.0 / static_cast<double>(n) * averaged_rotational_difference;
 
       mean = Eigen::Quaterniond(Eigen::AngleAxis<double>(averaged_rotational_difference.norm(), averaged_rotational_difference.normalized())) * mean;
 
@@ -169,16 +161,16 @@ protected:
   }
 
 public:
-  static RotationState calcMean(std::vector<RotationState, Eigen::aligned_allocator<RotationState>>& states)
+  template <std::size_t n> static RotationState calcMean(const std::array<RotationState, n>& states)
   {
     RotationState mean;
-    std::vector<Eigen::Quaterniond, Eigen::aligned_allocator<Eigen::Quaterniond>> rotations;
+    std::array<Eigen::Quaterniond, n> rotations;
 
     // calculate new state (weighted mean of sigma points)
-    for (typename std::vector<RotationState, Eigen::aligned_allocator<RotationState>>::iterator i = states.begin(); i != states.end(); ++i)
+    for (std::size_t i = 0; i < n; ++i)
     {
-      rotations.push_back((*i).getRotationAsQuaternion());
-      mean += 1.0 / static_cast<double>(states.size()) * (*i);
+      rotations[i] = states[i].getRotationAsQuaternion();
+      mean += 1.0 / static_cast<double>(n) * states[i];
     }
 
     // more correct determination of the mean rotation
@@ -257,14 +249,14 @@ public:
   // HACK: add return type as parameter to enable overloading...
   M1 asMeasurement(const M1& /*z*/) const { return acceleration(); }
 
-  static State calcMean(std::vector<State, Eigen::aligned_allocator<State>>& states)
+  template <std::size_t n> static State calcMean(const std::array<State, n>& states)
   {
     State mean;
 
     // calculate new state (weighted mean of sigma points)
-    for (typename std::vector<State, Eigen::aligned_allocator<State>>::iterator i = states.begin(); i != states.end(); ++i)
+    for (const State& state : states)
     {
-      mean += 1.0 / static_cast<double>(states.size()) * (*i);
+      mean += 1.0 / static_cast<double>(n) * state;
     }
 
     return mean;
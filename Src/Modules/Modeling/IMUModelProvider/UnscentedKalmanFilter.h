@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Tools/Math/Eigen.h"
+#include <array>
 
 template <class S> class UKF
 {
@@ -32,58 +33,57 @@ public:
   template <typename U> void predict(const U& u, double dt)
   {
     // transit the sigma points to the next state
-    for (typename std::vector<S, Eigen::aligned_allocator<S>>::iterator i = sigmaPoints.begin(); i != sigmaPoints.end(); ++i)
+    for (S& sigmaPoint : sigmaPoints)
     {
-      (*i).predict(u, dt);
+      sigmaPoint.predict(u, dt);
     }
 
     S mean = S::calcMean(sigmaPoints);
 
     // calculate new process covariance
-    Eigen::Matrix<double, S::size, 2 * S::size + 1> temp;
-    for (size_t idx = 0; idx < sigmaPoints.size(); ++idx)
+    Eigen::Matrix<double, S::size, numOfSigmaPoints> temp;
+    for (int idx = 0; idx < numOfSigmaPoints; ++idx)
     {
       temp.col(idx) = sigmaPoints[idx] - mean;
     }
 
     state = mean;
-    P = 1.0 / static_cast<double>(sigmaPoints.size()) * (temp) * (temp).transpose() /* + Q*/; // process covariance is applied before the process model (while generating the sigma points)
+    P = 1.0 / static_cast<double>(numOfSigmaPoints) * (temp) * (temp).transpose() /* + Q*/; // process covariance is applied before the process model (while generating the sigma points)
   }
 
   template <typename M, typename Derived> void update(const M& z, const Eigen::MatrixBase<Derived>& R)
   {
-    std::vector<M, Eigen::aligned_allocator<M>> sigmaMeasurements;
-    sigmaMeasurements.reserve(2 * S::size + 1);
+    std::array<M, numOfSigmaPoints> sigmaMeasurements;
 
     // map sigma points to measurement space
-    for (typename std::vector<S, Eigen::aligned_allocator<S>>::iterator i = sigmaPoints.begin(); i != sigmaPoints.end(); ++i)
+    for (int idx = 0; idx < numOfSigmaPoints; ++idx)
     {
-      sigmaMeasurements.push_back((*i).asMeasurement(z));
+      sigmaMeasurements[idx] = sigmaPoints[idx].asMeasurement(z);
     }
 
     // calculate predicted measurement z (weighted mean of sigma points)
     M predicted_z = M::calcMean(sigmaMeasurements);
 
     // calculate current measurement covariance
-    Eigen::Matrix<double, M::size, 2 * S::size + 1> temp;
-    for (size_t idx = 0; idx < sigmaMeasurements.size(); ++idx)
+    Eigen::Matrix<double, M::size, numOfSigmaPoints> temp;
+    for (int idx = 0; idx < numOfSigmaPoints; ++idx)
     {
       temp.col(idx) = sigmaMeasurements[idx] - predicted_z;
     }
-    Eigen::Matrix<double, M::size, M::size> Pzz(1.0 / static_cast<double>(sigmaPoints.size()) * temp * (temp).transpose());
+    Eigen::Matrix<double, M::size, M::size> Pzz(1.0 / static_cast<double>(numOfSigmaPoints) * temp * (temp).transpose());
 
     // calculate state-measurement cross-covariance
-    Eigen::Matrix<double, S::size, 2 * S::size + 1> temp2;
-    for (size_t idx = 0; idx < sigmaPoints.size(); ++idx)
+    Eigen::Matrix<double, S::size, numOfSigmaPoints> temp2;
+    for (int idx = 0; idx < numOfSigmaPoints; ++idx)
     {
       temp2.col(idx) = sigmaPoints[idx] - state;
     }
-    Eigen::Matrix<double, S::size, M::size> Pxz(1.0 / static_cast<double>(sigmaPoints.size()) * temp2 * (temp).transpose());
+    Eigen::Matrix<double, S::size, M::size> Pxz(1.0 / static_cast<double>(numOfSigmaPoints) * temp2 * (temp).transpose());
 
     // apply measurement noise covariance
     Eigen::Matrix<double, M::size, M::size> Pvv = Pzz + R;
-    // calculate kalman gain
-    Eigen::Matrix<double, S::size, M::size> K = Pxz * Pvv.inverse();
+    // calculate kalman gain K = Pxz * Pvv^-1, solved with the cholesky decomposition of the symmetric positive definite Pvv instead of inverting it
+    Eigen::Matrix<double, S::size, M::size> K = Pvv.llt().solve(Pxz.transpose()).transpose();
 
     // calculate new state and covariance
     M z_innovation = z - predicted_z;
@@ -101,7 +101,10 @@ private:
   const double beta = 2;
   const double lambda = alpha * alpha * (S::size + kapa) - S::size;
 
-  std::vector<S, Eigen::aligned_allocator<S>> sigmaPoints;
+  static constexpr int numOfSigmaPoints = 2 * S::size + 1;
+
+  // the number of sigma points is known at compile time, so they are stored without any allocation
+  std::array<S, numOfSigmaPoints> sigmaPoints;
 
   // decomposition object just need to be constructed once
   Eigen::LLT<Eigen::Matrix<double, S::size, S::size>> choleskyDecompositionOfCov; // apply Q befor the process model
@@ -111,8 +114,6 @@ public:
 
   void generateSigmaPoints()
   {
-    sigmaPoints.resize(2 * S::size + 1);
-
     sigmaPoints[2 * S::size] = state;
 
     choleskyDecompositionOfCov.compute(P + Q);
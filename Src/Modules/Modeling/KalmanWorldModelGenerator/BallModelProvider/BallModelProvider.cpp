@@ -105,7 +105,7 @@ void BallModelProvider::execute(tf::Subflow&)
         minPointsForLineDetectionWalking,
         static_cast<unsigned int>(theFieldDimensions.xPosOpponentGroundline * 2.f),
         static_cast<unsigned int>(theFieldDimensions.yPosLeftSideline * 2.f));
-    ransacLineFitter.setParameters(anglePrecisionLineDetection, distancePrecisionLineDetection, minPointsForLineDetection, minPointsForLineDetectionWalking);
+    ransacLineFitter.setParameters(anglePrecisionLineDetection, distancePrecisionLineDetection, minPointsForLineDetection, minPointsForLineDetectionWalking, randomSeedLineDetection);
   }
 
   // --- Filter ---
@@ -180,7 +180,7 @@ void BallModelProvider::sensorUpdate()
 
 void BallModelProvider::sensorUpdateLocal()
 {
-  std::vector<BallPercept> perceptsInThisFrame;
+  perceptsInThisFrame.clear();
 
   // Update the perceptBuffer with the latest odometry
   Pose2f odometryOffset = theOdometryData - m_lastOdometryData;
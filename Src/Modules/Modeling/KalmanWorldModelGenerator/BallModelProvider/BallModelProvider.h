@@ -13,6 +13,7 @@
 // ------------- NAO-Framework includes --------------
 #include "Tools/Module/Module.h"
 #include "Tools/RingBuffer.h"
+#include "Tools/RingBufferWithStatistics.h"
 
 
 // Requires
@@ -97,6 +98,8 @@ MODULE(BallModelProvider,
     (unsigned)(20) distancePrecisionLineDetection,
     (unsigned)(4) minPointsForLineDetection,
     (unsigned)(6) minPointsForLineDetectionWalking,
+    /// If not 0, the line detection is seeded with it to be reproducible when replaying logs
+    (unsigned)(0) randomSeedLineDetection,
     ((JoinedIMUData) InertialDataSource)(JoinedIMUData::inertialSensorData) anglesource,
     (Angle)(0.01_deg) gyroMaxVariance,
     (unsigned)(9) stableInterpolationFrames
@@ -287,8 +290,8 @@ private:
 
 
 private:
-  std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
-  std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
+  std::array<RingBufferWithStatistics<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
+  std::array<RingBufferWithStatistics<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
   bool isStable = false;
   unsigned interpolationCounter = 0;
 
@@ -319,6 +322,7 @@ private:
   HoughLineDetector houghLineDetector;
   RANSACLineFitter ransacLineFitter;
   RingBuffer<std::vector<BallPercept>, BALLPERCEPT_BUFFER_LENGTH> perceptBuffer; // percept buffer for a half second
+  std::vector<BallPercept> perceptsInThisFrame; // reused every frame to avoid allocations
 
   /**
    * Saves the timestamp of the last percept (from the robot with player number
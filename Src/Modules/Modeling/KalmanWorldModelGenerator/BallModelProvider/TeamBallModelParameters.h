@@ -19,5 +19,13 @@ STREAMABLE(TeamBallModelParameters,,
   /// ball model (only other teammates) to believe it is correct.
   /// The remote ball model is only used, if the local ball models 
   /// validity is below \c minValidityForLocalBallModel.
-  (float)(0.5f) minValidityForRemoteBallModel
+  (float)(0.5f) minValidityForRemoteBallModel,
+
+  /// Fuse the chosen hypothesis with all other hypotheses that are valid
+  /// enough and consistent with it by covariance intersection.
+  (bool)(true) fuseHypotheses,
+
+  /// Hypotheses whose squared Mahalanobis distance to the chosen one is
+  /// larger than this are assumed to be a different ball and not fused.
+  (float)(9.f) maxMahalanobisDistanceForFusion
 );
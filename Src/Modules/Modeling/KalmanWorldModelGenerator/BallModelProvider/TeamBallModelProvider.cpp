@@ -6,6 +6,7 @@
 #include "TeamBallModelProvider.h"
 #include "Tools/Math/Transformation.h"
 #include "Tools/Debugging/DebugDrawings.h"
+#include <cmath>
 
 
 // ---------- TeamBallModelProvider methods ----------
@@ -45,6 +46,7 @@ void TeamBallModelProvider::generateTeamBallModel(
   if (bestRemoteHypothesis != nullptr)
     remoteValidity = bestRemoteHypothesis->validity;
 
+  size_t fusedHypothesesCount = 0;
   if (localValidity >= m_teamParameters.minValidityForLocalBallModel)
   {
     // Set valid.
@@ -54,6 +56,8 @@ void TeamBallModelProvider::generateTeamBallModel(
     // Use local ball model.
     m_teamBallModel.isLocalBallModel = true;
     generateTeamBallModelFromBallHypothesis(m_teamBallModel, bestLocalHypothesis, &theRobotPose);
+    if (m_teamParameters.fuseHypotheses)
+      fusedHypothesesCount = fuseHypotheses(m_teamBallModel, bestLocalHypothesis, localMultipleBallModel, remoteMultipleBallModel, theRobotPose);
   }
   else if (remoteValidity >= m_teamParameters.minValidityForRemoteBallModel)
   {
@@ -64,6 +68,8 @@ void TeamBallModelProvider::generateTeamBallModel(
     // Use remote ball model.
     m_teamBallModel.isLocalBallModel = false;
     generateTeamBallModelFromBallHypothesis(m_teamBallModel, bestRemoteHypothesis, nullptr);
+    if (m_teamParameters.fuseHypotheses)
+      fusedHypothesesCount = fuseHypotheses(m_teamBallModel, bestRemoteHypothesis, localMultipleBallModel, remoteMultipleBallModel, theRobotPose);
   }
   else
   {
@@ -86,6 +92,8 @@ void TeamBallModelProvider::generateTeamBallModel(
 
   // Draw debug plots.
   m_plot(localValidity, remoteValidity, localMultipleBallModel.size(), remoteMultipleBallModel.size(), bestLocalHypothesis, bestRemoteHypothesis);
+  DECLARE_PLOT("module:BallModelProvider:fusedHypotheses");
+  PLOT("module:BallModelProvider:fusedHypotheses", fusedHypothesesCount);
 }
 
 void TeamBallModelProvider::generateTeamBallModelFromBallHypothesis(TeamBallModel& teamBallModel, const KalmanPositionHypothesis* hypothesis, const RobotPose* theRobotPose)
@@ -114,6 +122,102 @@ void TeamBallModelProvider::generateTeamBallModelFromBallHypothesis(TeamBallMode
   }
 }
 
+size_t TeamBallModelProvider::fuseHypotheses(TeamBallModel& teamBallModel,
+    const KalmanPositionHypothesis* chosenHypothesis,
+    LocalMultipleBallModel& localMultipleBallModel,
+    RemoteMultipleBallModel& remoteMultipleBallModel,
+    const RobotPose& theRobotPose)
+{
+  size_t count = 0;
+  const auto add = [&](const KalmanPositionHypothesis& hypothesis, bool isLocal)
+  {
+    if (count == maxFusionCandidates)
+      return;
+    FusionCandidate& candidate = m_fusionCandidates[count];
+    const Matrix2f covariance = hypothesis.kalman.positionCovariance();
+    if (isLocal)
+    {
+      // rotate the covariance into global field coordinates
+      const float c = std::cos(theRobotPose.rotation);
+      const float s = std::sin(theRobotPose.rotation);
+      candidate.position = Transformation::robotToField(theRobotPose, hypothesis.kalman.position());
+      candidate.velocity = Transformation::robotToFieldVelocity(theRobotPose, hypothesis.kalman.velocity());
+      candidate.covXX = c * c * covariance(0, 0) - 2.f * c * s * covariance(0, 1) + s * s * covariance(1, 1);
+      candidate.covXY = c * s * (covariance(0, 0) - covariance(1, 1)) + (c * c - s * s) * covariance(0, 1);
+      candidate.covYY = s * s * covariance(0, 0) + 2.f * c * s * covariance(0, 1) + c * c * covariance(1, 1);
+    }
+    else
+    {
+      candidate.position = hypothesis.kalman.position();
+      candidate.velocity = hypothesis.kalman.velocity();
+      candidate.covXX = covariance(0, 0);
+      candidate.covXY = covariance(0, 1);
+      candidate.covYY = covariance(1, 1);
+    }
+    if (candidate.covXX * candidate.covYY - candidate.covXY * candidate.covXY <= 0.f)
+      return;
+
+    // the first candidate is the chosen one, the others must be consistent with it
+    if (count > 0)
+    {
+      const FusionCandidate& chosen = m_fusionCandidates[0];
+      const Vector2f d = candidate.position - chosen.position;
+      const float sXX = chosen.covXX + candidate.covXX;
+      const float sXY = chosen.covXY + candidate.covXY;
+      const float sYY = chosen.covYY + candidate.covYY;
+      const float squaredDistance = (d.x() * d.x() * sYY - 2.f * d.x() * d.y() * sXY + d.y() * d.y() * sXX) / (sXX * sYY - sXY * sXY);
+      if (squaredDistance > m_teamParameters.maxMahalanobisDistanceForFusion)
+        return;
+    }
+    ++count;
+  };
+
+  const KalmanPositionHypothesis* bestLocalHypothesis = localMultipleBallModel.bestHypothesis();
+  const bool chosenIsLocal = chosenHypothesis == bestLocalHypothesis;
+  add(*chosenHypothesis, chosenIsLocal);
+  if (count == 0)
+    return 0;
+  if (!chosenIsLocal && bestLocalHypothesis != nullptr && bestLocalHypothesis->validity >= m_teamParameters.minValidityForLocalBallModel)
+    add(*bestLocalHypothesis, true);
+  for (size_t i = 0; i < remoteMultipleBallModel.size(); ++i)
+  {
+    const KalmanPositionHypothesis& hypothesis = remoteMultipleBallModel[i];
+    if (&hypothesis != chosenHypothesis && hypothesis.validity >= m_teamParameters.minValidityForRemoteBallModel)
+      add(hypothesis, false);
+  }
+  if (count < 2)
+    return count;
+
+  // fast covariance intersection: the weights are inversely proportional to the traces
+  float weightSum = 0.f;
+  for (size_t i = 0; i < count; ++i)
+    weightSum += 1.f / (m_fusionCandidates[i].covXX + m_fusionCandidates[i].covYY);
+
+  float infoXX = 0.f, infoXY = 0.f, infoYY = 0.f;
+  Vector2f infoPosition = Vector2f::Zero();
+  Vector2f velocity = Vector2f::Zero();
+  for (size_t i = 0; i < count; ++i)
+  {
+    const FusionCandidate& candidate = m_fusionCandidates[i];
+    const float weight = 1.f / ((candidate.covXX + candidate.covYY) * weightSum);
+    const float scale = weight / (candidate.covXX * candidate.covYY - candidate.covXY * candidate.covXY);
+    const float iXX = candidate.covYY * scale;
+    const float iXY = -candidate.covXY * scale;
+    const float iYY = candidate.covXX * scale;
+    infoXX += iXX;
+    infoXY += iXY;
+    infoYY += iYY;
+    infoPosition += Vector2f(iXX * candidate.position.x() + iXY * candidate.position.y(), iXY * candidate.position.x() + iYY * candidate.position.y());
+    velocity += candidate.velocity * weight;
+  }
+  const float det = infoXX * infoYY - infoXY * infoXY;
+  if (det <= 0.f)
+    return 1;
+  teamBallModel.position = Vector2f(infoYY * infoPosition.x() - infoXY * infoPosition.y(), infoXX * infoPosition.y() - infoXY * infoPosition.x()) / det;
+  teamBallModel.velocity = velocity;
+  return count;
+}
+
 
 // ---------- Debug methods ----------
 
@@ -22,6 +22,8 @@
 #include "TeamBallModelParameters.h"
 #include "Models/MultipleBallModel.h"
 
+#include <array>
+
 
 class TeamBallModelProvider
 {
@@ -80,6 +82,42 @@ private:
    */
   static void generateTeamBallModelFromBallHypothesis(TeamBallModel& teamBallModel, const KalmanPositionHypothesis* hypothesis, const RobotPose* theRobotPose = nullptr);
 
+  /**
+   * Fuses the hypothesis the \c teamBallModel was generated from with the best
+   * local hypothesis and all remote hypotheses by covariance intersection. The
+   * weights are based on the traces of the position covariances, so the fusion
+   * is linear in the number of hypotheses. The 2x2 matrices are inverted in
+   * closed form. Hypotheses that are not valid enough or too far away from the
+   * chosen one are ignored.
+   * \param [in,out] teamBallModel The team ball model generated from \c chosenHypothesis.
+   * \param [in] chosenHypothesis The hypothesis the team ball model was generated from.
+   * \param [in] localMultipleBallModel All hypotheses of the local ball model.
+   * \param [in] remoteMultipleBallModel All hypotheses of the remote ball model.
+   * \param [in] theRobotPose Used to transform the local hypothesis into global field coordinates.
+   * \return The number of hypotheses fused (including the chosen one).
+   */
+  size_t fuseHypotheses(TeamBallModel& teamBallModel,
+      const KalmanPositionHypothesis* chosenHypothesis,
+      LocalMultipleBallModel& localMultipleBallModel,
+      RemoteMultipleBallModel& remoteMultipleBallModel,
+      const RobotPose& theRobotPose);
+
+  /**
+   * A ball estimate in global field coordinates. Only the three distinct
+   * entries of the symmetric position covariance are stored.
+   */
+  struct FusionCandidate
+  {
+    Vector2f position;
+    Vector2f velocity;
+    float covXX;
+    float covXY;
+    float covYY;
+  };
+
+  /** The maximum number of hypotheses fused, further ones are ignored. */
+  static constexpr size_t maxFusionCandidates = 8;
+
 
   // Debug methods.
 
@@ -112,4 +150,7 @@ private:
    * ball models to team ball model.
    */
   TeamBallModelParameters m_teamParameters;
+
+  /** The hypotheses fused in the current frame, the chosen one first. */
+  std::array<FusionCandidate, maxFusionCandidates> m_fusionCandidates;
 };
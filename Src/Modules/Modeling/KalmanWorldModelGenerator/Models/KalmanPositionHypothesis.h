@@ -71,6 +71,16 @@ public:
    */
   virtual ~KalmanPositionHypothesis(){};
 
+  /**
+   * Copy and move operations. They must be declared explicitly, because the
+   * destructor suppresses the implicit move operations, which would let the
+   * \c MultiKalmanModel copy all percept buffers whenever it reorders its hypotheses.
+   */
+  KalmanPositionHypothesis(const KalmanPositionHypothesis&) = default;
+  KalmanPositionHypothesis(KalmanPositionHypothesis&&) = default;
+  KalmanPositionHypothesis& operator=(const KalmanPositionHypothesis&) = default;
+  KalmanPositionHypothesis& operator=(KalmanPositionHypothesis&&) = default;
+
 
   //MARK: Kalman filter related methods
 
@@ -53,7 +53,7 @@ public:
    * Default constructor creates a new and empty \c MultiKalmanModel object.
    * The default perceptDuration is 1000ms.
    */
-  MultiKalmanModel() {}
+  MultiKalmanModel() { m_hypotheses.reserve(reservedHypotheses); }
 
   /**
    * Constructor setting the perceptDuration.
@@ -64,6 +64,7 @@ public:
   MultiKalmanModel(unsigned perceptDuration)
   {
     m_perceptDuration = perceptDuration;
+    m_hypotheses.reserve(reservedHypotheses);
   }
   
   //MARK: Kalman filter related methods
@@ -242,7 +243,16 @@ private:
    */
   std::size_t updateBestHypothesisIndexIfNecessary();
 
-  void removeHypothesis(size_t index);
+  /**
+   * Removes all hypotheses for which \c remove returns \c true in a single pass.
+   * The order of the remaining hypotheses is preserved and the index of the best
+   * hypothesis is kept up to date, so that \c remove can access the best hypothesis
+   * at any time. Hypotheses before the one currently checked may already have been
+   * moved, so \c remove must only access the hypothesis passed and the best one.
+   * \param [in] remove Is called with each hypothesis and its index and returns
+   *                    whether to remove it.
+   */
+  template <typename Predicate> void removeHypothesesIf(Predicate remove);
   
 public:
   /**
@@ -386,6 +396,9 @@ private:
   /// The duration (in ms) percepts get buffered for identifying the validity of a hypothesis.
   unsigned m_perceptDuration = 1000;
 
+  /// The number of hypotheses memory is reserved for, so that the set usually does not have to grow.
+  static constexpr std::size_t reservedHypotheses = 16;
+
 public:
   ,
   /// Stores a set of kalman hypotheses.
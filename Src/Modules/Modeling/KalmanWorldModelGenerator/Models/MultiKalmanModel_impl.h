@@ -150,23 +150,24 @@ template <typename hypothesis_t, bool towardsOneModel>
 hypothesis_t* MultiKalmanModel<hypothesis_t, towardsOneModel>::findNearestHypothesis(const Vector2f& measuredPosition, float& distance)
 {
   hypothesis_t* nearestHypothesis = nullptr;
-  float minDistance = -1;
+  float minSquaredDistance = -1;
 
   for (size_t i = 0; i < m_hypotheses.size(); i++)
   {
-    // Calculate distance from the perception to the current hypothesis.
-    float currentDistance = Geometry::distance(measuredPosition, m_hypotheses[i].kalman.position());
+    // Calculate squared distance from the perception to the current hypothesis.
+    // The square root is only needed for the nearest one.
+    float currentSquaredDistance = (measuredPosition - m_hypotheses[i].kalman.position()).squaredNorm();
 
     // Check whether the current distance is shorter than the minimum of all
     // previous hypotheses.
-    if (minDistance < 0 || currentDistance < minDistance)
+    if (minSquaredDistance < 0 || currentSquaredDistance < minSquaredDistance)
     {
       nearestHypothesis = &m_hypotheses[i];
-      minDistance = currentDistance;
+      minSquaredDistance = currentSquaredDistance;
     }
   }
 
-  distance = minDistance;
+  distance = minSquaredDistance < 0 ? -1.f : std::sqrt(minSquaredDistance);
   return nearestHypothesis;
 }
 
@@ -262,13 +263,30 @@ template <typename hypothesis_t, bool towardsOneModel> std::size_t MultiKalmanMo
   return m_bestHypothesisIndex;
 }
 
-template <typename hypothesis_t, bool towardsOneModel> void MultiKalmanModel<hypothesis_t, towardsOneModel>::removeHypothesis(size_t index)
+template <typename hypothesis_t, bool towardsOneModel>
+template <typename Predicate>
+void MultiKalmanModel<hypothesis_t, towardsOneModel>::removeHypothesesIf(Predicate remove)
 {
-  m_hypotheses.erase(m_hypotheses.begin() + index);
-  if (m_bestHypothesisIndex == index)
-    m_bestHypothesisIndex = std::numeric_limits<size_t>::max();
-  else if (index < m_bestHypothesisIndex && m_bestHypothesisIndex != std::numeric_limits<size_t>::max())
-    m_bestHypothesisIndex--;
+  // Move the remaining hypotheses to the front instead of erasing the removed ones
+  // one by one, which would shift all following hypotheses each time.
+  size_t numberOfRemaining = 0;
+  for (size_t i = 0; i < m_hypotheses.size(); i++)
+  {
+    if (remove(m_hypotheses[i], i))
+    {
+      if (m_bestHypothesisIndex == i)
+        m_bestHypothesisIndex = std::numeric_limits<size_t>::max();
+      continue;
+    }
+    if (numberOfRemaining != i)
+    {
+      m_hypotheses[numberOfRemaining] = std::move(m_hypotheses[i]);
+      if (m_bestHypothesisIndex == i)
+        m_bestHypothesisIndex = numberOfRemaining;
+    }
+    numberOfRemaining++;
+  }
+  m_hypotheses.erase(m_hypotheses.begin() + numberOfRemaining, m_hypotheses.end());
 }
 
 template <typename hypothesis_t, bool towardsOneModel>
@@ -299,11 +317,11 @@ void MultiKalmanModel<hypothesis_t, towardsOneModel>::cleanUpHypothesesOutsideFi
   // ----- Remove hypotheses outside the field -----
 
   ASSERT(fieldBorderThreshold > 0.f);
-  for (size_t i = 0; i < m_hypotheses.size(); i++)
+  removeHypothesesIf([&](hypothesis_t& hypothesis, size_t i)
   {
     // The check isInsideField requires global field coordinates. Use RobotPose
     // (from last frame) to calculate this.
-    Vector2f globalPos = m_hypotheses[i].kalman.position();
+    Vector2f globalPos = hypothesis.kalman.position();
     if (usesRelativeCoordinates())
       globalPos = Transformation::robotToField(theRobotPose, globalPos);
     // Hypothesis must be outside the field border ...
@@ -318,21 +336,17 @@ void MultiKalmanModel<hypothesis_t, towardsOneModel>::cleanUpHypothesesOutsideFi
       {
         // Do nothing if current hypothesis is the best one.
         if (i != m_bestHypothesisIndex && m_bestHypothesisIndex < m_hypotheses.size())
-        {
-          removeHypothesis(i);
-          i--;
-        }
-        else
-        {
-          Vector2f closestPosOnBorderRel = Transformation::fieldToRobot(theRobotPose, closestPosOnBorder);
-          m_hypotheses[i].kalman.state(0) = closestPosOnBorderRel.x();
-          m_hypotheses[i].kalman.state(1) = closestPosOnBorderRel.y();
-          m_hypotheses[i].kalman.state(2) = 0.f;
-          m_hypotheses[i].kalman.state(3) = 0.f;
-        }
+          return true;
+
+        Vector2f closestPosOnBorderRel = Transformation::fieldToRobot(theRobotPose, closestPosOnBorder);
+        hypothesis.kalman.state(0) = closestPosOnBorderRel.x();
+        hypothesis.kalman.state(1) = closestPosOnBorderRel.y();
+        hypothesis.kalman.state(2) = 0.f;
+        hypothesis.kalman.state(3) = 0.f;
       }
     }
-  }
+    return false;
+  });
 }
 
 template <typename hypothesis_t, bool towardsOneModel>
@@ -361,14 +375,10 @@ void MultiKalmanModel<hypothesis_t, towardsOneModel>::cleanUpHypothesesLowValidi
 
   // Remove hypotheses with too small validity, but do not remove the best one.
   // This ensures, that at least one hypothesis is left (if set was not empty).
-  for (size_t i = 0; i < m_hypotheses.size(); i++)
+  removeHypothesesIf([&](const hypothesis_t& hypothesis, size_t)
   {
-    if (m_hypotheses[i].validity < validityThreshold && m_hypotheses[i].validity < bestValidity)
-    {
-      removeHypothesis(i);
-      i--;
-    }
-  }
+    return hypothesis.validity < validityThreshold && hypothesis.validity < bestValidity;
+  });
 }
 
 template <typename hypothesis_t, bool towardsOneModel>
@@ -381,25 +391,25 @@ void MultiKalmanModel<hypothesis_t, towardsOneModel>::cleanUpHypothesesSimilarTo
   // ----- Clean similar hypotheses (similar to the best one) -----
 
   // Search for hypotheses to remove.
-  for (size_t i = 0; i < m_hypotheses.size(); i++)
+  removeHypothesesIf([&](hypothesis_t& hypothesis, size_t i)
   {
     // Do nothing if current hypothesis is the best one.
-    if (i != m_bestHypothesisIndex && m_bestHypothesisIndex < m_hypotheses.size())
+    if (i == m_bestHypothesisIndex || m_bestHypothesisIndex >= m_hypotheses.size())
+      return false;
+
+    hypothesis_t& best = m_hypotheses[m_bestHypothesisIndex];
+    // Calculate distance and angle (velocity) between best and current hypothesis.
+    float distance = Geometry::distance(best.kalman.position(), hypothesis.kalman.position());
+    float angle = Geometry::angleBetween(best.kalman.velocity(), hypothesis.kalman.velocity());
+    bool smallVelocities = best.kalman.velocity().norm() < minDistanceForSeparateHypotheses / 30.f && hypothesis.kalman.velocity().norm() < minDistanceForSeparateHypotheses / 30.f;
+    // Remove current hypothesis if it is too similar to the best one.
+    if (distance < minDistanceForSeparateHypotheses && (angle < minAngleForSeparateHypotheses || smallVelocities))
     {
-      // Calculate distance and angle (velocity) between best and current hypothesis.
-      float distance = Geometry::distance(m_hypotheses[m_bestHypothesisIndex].kalman.position(), m_hypotheses[i].kalman.position());
-      float angle = Geometry::angleBetween(m_hypotheses[m_bestHypothesisIndex].kalman.velocity(), m_hypotheses[i].kalman.velocity());
-      bool smallVelocities = m_hypotheses[m_bestHypothesisIndex].kalman.velocity().norm() < minDistanceForSeparateHypotheses / 30.f
-          && m_hypotheses[i].kalman.velocity().norm() < minDistanceForSeparateHypotheses / 30.f;
-      // Remove current hypothesis if it is too similar to the best one.
-      if (distance < minDistanceForSeparateHypotheses && (angle < minAngleForSeparateHypotheses || smallVelocities))
-      {
-        m_hypotheses[m_bestHypothesisIndex].merge(m_hypotheses[i]);
-        removeHypothesis(i);
-        i--;
-      }
+      best.merge(hypothesis);
+      return true;
     }
-  }
+    return false;
+  });
 }
 
 template <typename hypothesis_t, bool towardsOneModel> void MultiKalmanModel<hypothesis_t, towardsOneModel>::clear()
@@ -51,6 +51,12 @@ public:
    */
   ~RemoteKalmanPositionHypothesis() override{};
 
+  /** Copy and move operations (see \c KalmanPositionHypothesis). */
+  RemoteKalmanPositionHypothesis(const RemoteKalmanPositionHypothesis&) = default;
+  RemoteKalmanPositionHypothesis(RemoteKalmanPositionHypothesis&&) = default;
+  RemoteKalmanPositionHypothesis& operator=(const RemoteKalmanPositionHypothesis&) = default;
+  RemoteKalmanPositionHypothesis& operator=(RemoteKalmanPositionHypothesis&&) = default;
+
 
   //MARK: Labeling methods
 
@@ -4,7 +4,9 @@
  */
 
 #include "KalmanMultiRobotMapProvider.h"
+#include "Tools/Math/FastMath.h"
 
+#include <taskflow/taskflow.hpp>
 #include <vector>
 
 #define DRAW_MAP(id, map)                                                                                                   \
@@ -176,7 +178,7 @@ void KalmanMultiRobotMapProvider::reset()
 // EXCUTE CODE
 // ==========================
 
-void KalmanMultiRobotMapProvider::execute(tf::Subflow&)
+void KalmanMultiRobotMapProvider::execute(tf::Subflow& subflow)
 {
   // Modify internal params
   modifyInternalParameters();
@@ -188,7 +190,7 @@ void KalmanMultiRobotMapProvider::execute(tf::Subflow&)
   motionUpdate();
 
   // Sensor update (kalman maps)
-  sensorUpdate();
+  sensorUpdate(subflow);
 
   // Prune hypotheses
   pruneHypotheses();
@@ -226,9 +228,9 @@ void KalmanMultiRobotMapProvider::motionUpdate()
   m_mergedKalmanRobotMap.motionUpdate(theFrameInfo.time);
 }
 
-void KalmanMultiRobotMapProvider::sensorUpdate()
+void KalmanMultiRobotMapProvider::sensorUpdate(tf::Subflow& subflow)
 {
-  std::vector<RobotEstimate> perceptsInThisFrame;
+  perceptsInThisFrame.clear();
 
   // Update the perceptBuffer with the latest odometry
   Pose2f odometryOffset = theOdometryData - m_lastOdometryData;
@@ -242,40 +244,7 @@ void KalmanMultiRobotMapProvider::sensorUpdate()
       reOnField.rotate(-odometryOffset.rotation);
     }
   }
-
-  // ===============================
-  // Update local percepts
-  // ===============================
-  for (const RobotEstimate& robot : theRobotsPercept.robots)
-  {
-    perceptsInThisFrame.push_back(robot);
-    // Update sensor
-    performSensorUpdate(
-        sensorUpdateArguments(m_localKalmanRobotMap, kalmanNoiseMatrices)
-            .measuredPositionRelative(robot.locationOnField.translation)
-            .measuredDistance(robot.distance)
-            .desiredRobotType(robot.robotType)
-            .timestamp(theFrameInfo.time)
-            .perceptValidity(robot.validity)
-            .maxAngleDiffToMerge(parameters.localMapParameters.maxAngleDiffToMerge)
-            .maxDistanceForDistanceBasedMerging(parameters.localMapParameters.maxDistanceForDistanceBasedMerging)
-            .maxDistanceToMerge(parameters.localMapParameters.maxDistanceToMerge)
-            .initialValidityForNewHypothesis(parameters.localPercept.hypotheses_initialValidityForNewHypotheses));
-    // Update merged
-    performSensorUpdate(
-        sensorUpdateArguments(m_mergedKalmanRobotMap, kalmanNoiseMatrices)
-            .measuredPositionRelative(robot.locationOnField.translation)
-            .measuredDistance(robot.distance)
-            .desiredRobotType(robot.robotType)
-            .timestamp(theFrameInfo.time)
-            .perceptValidity(robot.validity * parameters.mergedMapParameters.localPerceptInfluence)
-            .maxAngleDiffToMerge(parameters.mergedMapParameters.maxAngleDiffToMerge)
-            .maxDistanceForDistanceBasedMerging(parameters.mergedMapParameters.maxDistanceForDistanceBasedMerging)
-            .maxDistanceToMerge(parameters.mergedMapParameters.maxDistanceToMerge)
-            .initialValidityForNewHypothesis(parameters.localPercept.hypotheses_initialValidityForNewHypotheses),
-        theRobotInfo.number,
-        RemoteKalmanPositionHypothesis::TeammateInfo(robot.validity, theFrameInfo.time));
-  }
+  perceptsInThisFrame.insert(perceptsInThisFrame.end(), theRobotsPercept.robots.begin(), theRobotsPercept.robots.end());
   perceptBuffer.push_front(perceptsInThisFrame);
 
   DEBUG_DRAWING("module:KalmanMultiRobotMapProvider:perceptBuffer", "drawingOnField")
@@ -300,54 +269,53 @@ void KalmanMultiRobotMapProvider::sensorUpdate()
     }
   }
 
+  // The three kalman maps do not depend on each other, so they are updated in parallel.
+  // Each map processes its observations in the same order as a sequential update would.
+  subflow
+      .emplace(
+          [this]()
+          {
+            sensorUpdateLocalMap();
+          })
+      .name("LocalMap [KalmanMultiRobotMapProvider]");
+  subflow
+      .emplace(
+          [this]()
+          {
+            sensorUpdateRemoteMap();
+          })
+      .name("RemoteMap [KalmanMultiRobotMapProvider]");
+  subflow
+      .emplace(
+          [this]()
+          {
+            sensorUpdateMergedMap();
+          })
+      .name("MergedMap [KalmanMultiRobotMapProvider]");
+  subflow.join();
+
+  // Update validities after sensor update
+  updateValidities();
+}
+
+void KalmanMultiRobotMapProvider::sensorUpdateLocalMap()
+{
   // ===============================
-  // Update from teammate positions
+  // Update local percepts
   // ===============================
-  for (const TeammateReceived& teammate : theTeammateData.teammates)
+  for (const RobotEstimate& robot : theRobotsPercept.robots)
   {
-    // Loop over all players which have sent data and are active
-    if (teammate.status == TeammateReceived::Status::FULLY_ACTIVE)
-    {
-      // Calculate distance
-      auto relativePosition = Transformation::fieldToRobot(theRobotPose, teammate.robotPose.translation);
-      float distance = relativePosition.norm();
-
-      // Calculate speed
-      const Pose2f& speed = teammate.speedInfo.speed;
-      auto speed2d = Vector2f(speed.translation.x() * cos(speed.rotation), speed.translation.y() * sin(speed.rotation));
-      auto relativeSpeed = Transformation::robotToFieldVelocity(teammate.robotPose, speed2d);
-
-      // Update remote
-      performSensorUpdate(
-          sensorUpdateArguments(m_remoteKalmanRobotMap, kalmanNoiseMatrices)
-              .measuredPositionRelative(relativePosition)
-              .measuredDistance(distance)
-              .measuredVelocity(&relativeSpeed)
-              .desiredRobotType(RobotEstimate::RobotType::teammateRobot)
-              .timestamp(teammate.sendTimestamp)
-              .perceptValidity(teammate.robotPose.validity * parameters.remoteMapParameters.teammatePositionInfluence)
-              .maxAngleDiffToMerge(parameters.remoteMapParameters.maxAngleDiffToMerge)
-              .maxDistanceForDistanceBasedMerging(parameters.remoteMapParameters.maxDistanceForDistanceBasedMerging)
-              .maxDistanceToMerge(parameters.remoteMapParameters.maxDistanceToMerge)
-              .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
-          teammate.playerNumber,
-          RemoteKalmanPositionHypothesis::TeammateInfo(teammate.robotPose.validity, teammate.sendTimestamp));
-      // Update merged
-      performSensorUpdate(
-          sensorUpdateArguments(m_mergedKalmanRobotMap, kalmanNoiseMatrices)
-              .measuredPositionRelative(relativePosition)
-              .measuredDistance(distance)
-              .measuredVelocity(&relativeSpeed)
-              .desiredRobotType(RobotEstimate::RobotType::teammateRobot)
-              .timestamp(teammate.sendTimestamp)
-              .perceptValidity(teammate.robotPose.validity * parameters.mergedMapParameters.teammatePositionInfluence)
-              .maxAngleDiffToMerge(parameters.mergedMapParameters.maxAngleDiffToMerge)
-              .maxDistanceForDistanceBasedMerging(parameters.mergedMapParameters.maxDistanceForDistanceBasedMerging)
-              .maxDistanceToMerge(parameters.mergedMapParameters.maxDistanceToMerge)
-              .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
-          teammate.playerNumber,
-          RemoteKalmanPositionHypothesis::TeammateInfo(teammate.robotPose.validity, teammate.sendTimestamp));
-    }
+    performSensorUpdate(
+        sensorUpdateArguments(m_localKalmanRobotMap, kalmanNoiseMatrices)
+            .measuredPositionRelative(robot.locationOnField.translation)
+            .measuredDistance(robot.distance)
+            .desiredRobotType(robot.robotType)
+            .timestamp(theFrameInfo.time)
+            .perceptValidity(robot.validity)
+            .maxAngleDiffToMerge(parameters.localMapParameters.maxAngleDiffToMerge)
+            .maxDistanceForDistanceBasedMerging(parameters.localMapParameters.maxDistanceForDistanceBasedMerging)
+            .maxDistanceToMerge(parameters.localMapParameters.maxDistanceToMerge)
+            .initialValidityForNewHypothesis(parameters.localPercept.hypotheses_initialValidityForNewHypotheses));
   }
 
   // ===============================
@@ -377,6 +345,38 @@ void KalmanMultiRobotMapProvider::sensorUpdate()
       CIRCLE("module:KalmanMultiRobotMapProvider:sonarPercept", sonarEstimatePositionOnField.x(), sonarEstimatePositionOnField.y(), 40, 2, Drawings::solidPen, ColorRGBA::yellow, Drawings::solidBrush, ColorRGBA::yellow);
     }
   }
+}
+
+void KalmanMultiRobotMapProvider::sensorUpdateRemoteMap()
+{
+  // ===============================
+  // Update from teammate positions
+  // ===============================
+  for (const TeammateReceived& teammate : theTeammateData.teammates)
+  {
+    // Loop over all players which have sent data and are active
+    if (teammate.status == TeammateReceived::Status::FULLY_ACTIVE)
+    {
+      Vector2f relativePosition, relativeSpeed;
+      float distance;
+      getTeammateMotion(teammate, relativePosition, distance, relativeSpeed);
+
+      performSensorUpdate(
+          sensorUpdateArguments(m_remoteKalmanRobotMap, kalmanNoiseMatrices)
+              .measuredPositionRelative(relativePosition)
+              .measuredDistance(distance)
+              .measuredVelocity(&relativeSpeed)
+              .desiredRobotType(RobotEstimate::RobotType::teammateRobot)
+              .timestamp(teammate.sendTimestamp)
+              .perceptValidity(teammate.robotPose.validity * parameters.remoteMapParameters.teammatePositionInfluence)
+              .maxAngleDiffToMerge(parameters.remoteMapParameters.maxAngleDiffToMerge)
+              .maxDistanceForDistanceBasedMerging(parameters.remoteMapParameters.maxDistanceForDistanceBasedMerging)
+              .maxDistanceToMerge(parameters.remoteMapParameters.maxDistanceToMerge)
+              .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
+          teammate.playerNumber,
+          RemoteKalmanPositionHypothesis::TeammateInfo(teammate.robotPose.validity, teammate.sendTimestamp));
+    }
+  }
 
   // ===============================
   // Update from teammate data
@@ -397,8 +397,6 @@ void KalmanMultiRobotMapProvider::sensorUpdate()
           auto relativePosition = Transformation::fieldToRobot(theRobotPose, robotModel.pose.translation);
           float distance = relativePosition.norm();
 
-          // Update remote
-          Vector2f percept = teammate.robotPose.translation;
           performSensorUpdate(
               sensorUpdateArguments(m_remoteKalmanRobotMap, kalmanNoiseMatrices)
                   .measuredPositionRelative(relativePosition)
@@ -413,23 +411,9 @@ void KalmanMultiRobotMapProvider::sensorUpdate()
                   .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
               teammate.playerNumber,
               RemoteKalmanPositionHypothesis::TeammateInfo(robotModel.validity, teammate.sendTimestamp));
-          // Update merged
-          performSensorUpdate(
-              sensorUpdateArguments(m_mergedKalmanRobotMap, kalmanNoiseMatrices)
-                  .measuredPositionRelative(relativePosition)
-                  .measuredDistance(distance)
-                  // TC: Removed, because not transmitted .measuredVelocity(&robotModel.velocity)
-                  .desiredRobotType(robotModel.robotType)
-                  .timestamp(teammate.sendTimestamp)
-                  .perceptValidity(robotModel.validity * parameters.mergedMapParameters.teammateModelInfluence)
-                  .maxAngleDiffToMerge(parameters.mergedMapParameters.maxAngleDiffToMerge)
-                  .maxDistanceForDistanceBasedMerging(parameters.mergedMapParameters.maxDistanceForDistanceBasedMerging)
-                  .maxDistanceToMerge(parameters.mergedMapParameters.maxDistanceToMerge)
-                  .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
-              teammate.playerNumber,
-              RemoteKalmanPositionHypothesis::TeammateInfo(robotModel.validity, teammate.sendTimestamp));
         }
       }
+      // Note: When re-enabling this, the updates of the merged map belong to sensorUpdateMergedMap.
       //Percepts are currently (as of November 2022) no longer sent around with
       /*
       // ===== Update percepts =====
@@ -508,9 +492,106 @@ void KalmanMultiRobotMapProvider::sensorUpdate()
       */
     }
   }
+}
 
-  // Update validities after sensor update
-  updateValidities();
+void KalmanMultiRobotMapProvider::sensorUpdateMergedMap()
+{
+  // ===============================
+  // Update local percepts
+  // ===============================
+  for (const RobotEstimate& robot : theRobotsPercept.robots)
+  {
+    performSensorUpdate(
+        sensorUpdateArguments(m_mergedKalmanRobotMap, kalmanNoiseMatrices)
+            .measuredPositionRelative(robot.locationOnField.translation)
+            .measuredDistance(robot.distance)
+            .desiredRobotType(robot.robotType)
+            .timestamp(theFrameInfo.time)
+            .perceptValidity(robot.validity * parameters.mergedMapParameters.localPerceptInfluence)
+            .maxAngleDiffToMerge(parameters.mergedMapParameters.maxAngleDiffToMerge)
+            .maxDistanceForDistanceBasedMerging(parameters.mergedMapParameters.maxDistanceForDistanceBasedMerging)
+            .maxDistanceToMerge(parameters.mergedMapParameters.maxDistanceToMerge)
+            .initialValidityForNewHypothesis(parameters.localPercept.hypotheses_initialValidityForNewHypotheses),
+        theRobotInfo.number,
+        RemoteKalmanPositionHypothesis::TeammateInfo(robot.validity, theFrameInfo.time));
+  }
+
+  // ===============================
+  // Update from teammate positions
+  // ===============================
+  for (const TeammateReceived& teammate : theTeammateData.teammates)
+  {
+    // Loop over all players which have sent data and are active
+    if (teammate.status == TeammateReceived::Status::FULLY_ACTIVE)
+    {
+      Vector2f relativePosition, relativeSpeed;
+      float distance;
+      getTeammateMotion(teammate, relativePosition, distance, relativeSpeed);
+
+      performSensorUpdate(
+          sensorUpdateArguments(m_mergedKalmanRobotMap, kalmanNoiseMatrices)
+              .measuredPositionRelative(relativePosition)
+              .measuredDistance(distance)
+              .measuredVelocity(&relativeSpeed)
+              .desiredRobotType(RobotEstimate::RobotType::teammateRobot)
+              .timestamp(teammate.sendTimestamp)
+              .perceptValidity(teammate.robotPose.validity * parameters.mergedMapParameters.teammatePositionInfluence)
+              .maxAngleDiffToMerge(parameters.mergedMapParameters.maxAngleDiffToMerge)
+              .maxDistanceForDistanceBasedMerging(parameters.mergedMapParameters.maxDistanceForDistanceBasedMerging)
+              .maxDistanceToMerge(parameters.mergedMapParameters.maxDistanceToMerge)
+              .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
+          teammate.playerNumber,
+          RemoteKalmanPositionHypothesis::TeammateInfo(teammate.robotPose.validity, teammate.sendTimestamp));
+    }
+  }
+
+  // ===============================
+  // Update from teammate data
+  // ===============================
+  for (const TeammateReceived& teammate : theTeammateData.teammates)
+  {
+    // Loop over all players which have sent data and are active
+    if (teammate.status == TeammateReceived::Status::FULLY_ACTIVE)
+    {
+      for (const auto& robotModel : teammate.localRobotMap.robots)
+      {
+        // Check that is not me
+        if ((robotModel.pose.translation - theRobotPose.translation).norm() > 200)
+        {
+          // Received, locale map of the teammate are in posOnField coordians
+          auto relativePosition = Transformation::fieldToRobot(theRobotPose, robotModel.pose.translation);
+          float distance = relativePosition.norm();
+
+          performSensorUpdate(
+              sensorUpdateArguments(m_mergedKalmanRobotMap, kalmanNoiseMatrices)
+                  .measuredPositionRelative(relativePosition)
+                  .measuredDistance(distance)
+                  // TC: Removed, because not transmitted .measuredVelocity(&robotModel.velocity)
+                  .desiredRobotType(robotModel.robotType)
+                  .timestamp(teammate.sendTimestamp)
+                  .perceptValidity(robotModel.validity * parameters.mergedMapParameters.teammateModelInfluence)
+                  .maxAngleDiffToMerge(parameters.mergedMapParameters.maxAngleDiffToMerge)
+                  .maxDistanceForDistanceBasedMerging(parameters.mergedMapParameters.maxDistanceForDistanceBasedMerging)
+                  .maxDistanceToMerge(parameters.mergedMapParameters.maxDistanceToMerge)
+                  .initialValidityForNewHypothesis(parameters.remoteModel.hypotheses_initialValidityForNewHypotheses),
+              teammate.playerNumber,
+              RemoteKalmanPositionHypothesis::TeammateInfo(robotModel.validity, teammate.sendTimestamp));
+        }
+      }
+    }
+  }
+}
+
+void KalmanMultiRobotMapProvider::getTeammateMotion(const TeammateReceived& teammate, Vector2f& relativePosition, float& distance, Vector2f& relativeSpeed) const
+{
+  // Calculate distance
+  relativePosition = Transformation::fieldToRobot(theRobotPose, teammate.robotPose.translation);
+  distance = relativePosition.norm();
+
+  // Calculate speed
+  const Pose2f& speed = teammate.speedInfo.speed;
+  auto speed2d = Vector2f(speed.translation.x() * cos(speed.rotation), speed.translation.y() * sin(speed.rotation));
+  relativeSpeed = Transformation::robotToFieldVelocity(teammate.robotPose, speed2d);
 }
 
 void KalmanMultiRobotMapProvider::pruneHypotheses()
@@ -677,8 +758,8 @@ void KalmanMultiRobotMapProvider::updateValidities()
 void KalmanMultiRobotMapProvider::getAngles(Vector2a& angles, const Vector2f& relativePosition)
 {
   const CameraMatrix& cameraMatrix = theCameraMatrixUpper;
-  angles.x() = std::atan2(relativePosition.y(), relativePosition.x());
-  angles.y() = std::atan2(cameraMatrix.translation.z(), relativePosition.norm());
+  angles.x() = FastMath::atan2(relativePosition.y(), relativePosition.x());
+  angles.y() = FastMath::atan2(cameraMatrix.translation.z(), relativePosition.norm());
 }
 
 static Angle normalizeAngle(Angle a)
@@ -131,6 +131,8 @@ private:
   MergedKalmanRobotMap m_mergedKalmanRobotMap;
 
   RingBuffer<std::vector<RobotEstimate>, ROBOTPERCEPT_BUFFER_LENGTH> perceptBuffer;
+  // Reused every frame to avoid allocations
+  std::vector<RobotEstimate> perceptsInThisFrame;
 
 
   // Reset the provider
@@ -141,8 +143,14 @@ private:
   void execute(tf::Subflow&) override;
   // Motion update
   void motionUpdate();
-  // Sensor update
-  void sensorUpdate();
+  // Sensor update, which updates the three kalman maps in parallel
+  void sensorUpdate(tf::Subflow& subflow);
+  // Sensor update of the local map from local and sonar percepts
+  void sensorUpdateLocalMap();
+  // Sensor update of the remote map from teammate positions and models
+  void sensorUpdateRemoteMap();
+  // Sensor update of the merged map from local percepts, teammate positions and models
+  void sensorUpdateMergedMap();
   // Prune hypotheses
   void pruneHypotheses();
   // Update robot types
@@ -164,6 +172,9 @@ private:
 
   void getAngles(Vector2a& angles, const Vector2f& relativePosition);
 
+  // Position, distance and velocity of a teammate relative to this robot
+  void getTeammateMotion(const TeammateReceived& teammate, Vector2f& relativePosition, float& distance, Vector2f& relativeSpeed) const;
+
   // Merge hypotheses
   template <typename RobotMap> void mergeHypotheses(RobotMap& robotMap, const Vector2a& mergeAngleDiff, const float mergeDistance);
 
@@ -52,6 +52,12 @@ public:
    */
   ~LocalRobotMapHypothesis() override{};
 
+  /** Copy and move operations (see \c KalmanPositionHypothesis). */
+  LocalRobotMapHypothesis(const LocalRobotMapHypothesis&) = default;
+  LocalRobotMapHypothesis(LocalRobotMapHypothesis&&) = default;
+  LocalRobotMapHypothesis& operator=(const LocalRobotMapHypothesis&) = default;
+  LocalRobotMapHypothesis& operator=(LocalRobotMapHypothesis&&) = default;
+
   /**
    * Updates the given \c RobotMapEntry from this \c RemoteRobotMapHypothesis. The robot map
    * entry object is used in \c RobotMap::robots to represent one robot on the robot map.
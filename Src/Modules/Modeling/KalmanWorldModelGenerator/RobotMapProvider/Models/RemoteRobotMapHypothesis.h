@@ -52,6 +52,12 @@ public:
    */
   ~RemoteRobotMapHypothesis() override{};
 
+  /** Copy and move operations (see \c KalmanPositionHypothesis). */
+  RemoteRobotMapHypothesis(const RemoteRobotMapHypothesis&) = default;
+  RemoteRobotMapHypothesis(RemoteRobotMapHypothesis&&) = default;
+  RemoteRobotMapHypothesis& operator=(const RemoteRobotMapHypothesis&) = default;
+  RemoteRobotMapHypothesis& operator=(RemoteRobotMapHypothesis&&) = default;
+
   /**
    * Updates the given \c RobotMapEntry from this \c RemoteRobotMapHypothesis. The robot map
    * entry object is used in \c RobotMap::robots to represent one robot on the robot map.
@@ -38,6 +38,12 @@ public:
    */
   virtual ~RobotTypeHypothesis(){};
 
+  /** Copy and move operations, as the destructor would suppress the implicit move operations. */
+  RobotTypeHypothesis(const RobotTypeHypothesis&) = default;
+  RobotTypeHypothesis(RobotTypeHypothesis&&) = default;
+  RobotTypeHypothesis& operator=(const RobotTypeHypothesis&) = default;
+  RobotTypeHypothesis& operator=(RobotTypeHypothesis&&) = default;
+
   /**
    * Compares the given type with the \c robotType of \c this. If one of these types
    * is \c unknownRobot they macht even if they are different.
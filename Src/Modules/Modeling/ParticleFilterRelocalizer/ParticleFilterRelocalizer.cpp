@@ -0,0 +1,308 @@
+/**
+ * @file ParticleFilterRelocalizer.cpp
+ * Implements a module that localizes the robot globally with a particle filter.
+ */
+
+#include "ParticleFilterRelocalizer.h"
+#include "Tools/Math/Random.h"
+#include "Tools/Math/sse_mathfun.h"
+#include "Tools/SIMD.h"
+#include <taskflow/taskflow.hpp>
+#include <taskflow/algorithm/for_each.hpp>
+#include <algorithm>
+#include <cmath>
+
+void ParticleFilterRelocalizer::Particles::resize(size_t size)
+{
+  x.resize(size);
+  y.resize(size);
+  rotation.resize(size);
+  weight.resize(size);
+}
+
+void ParticleFilterRelocalizer::execute(tf::Subflow& subflow)
+{
+  DECLARE_DEBUG_DRAWING("module:ParticleFilterRelocalizer:particles", "drawingOnField");
+
+  const Pose2f odometryOffset = theOdometryData - lastOdometryData;
+  lastOdometryData = theOdometryData;
+
+  // Penalized robots are placed somewhere else, so the particles are spread again until they return.
+  const size_t size = (std::max(numOfParticles, 4u) + 3) & ~3u;
+  if (particles.size() != size || lastFieldDimensionsUpdate != theFieldDimensions.lastUpdate || theRobotInfo.penalty != PENALTY_NONE)
+  {
+    initialize();
+    lastFieldDimensionsUpdate = theFieldDimensions.lastUpdate;
+    relocalizationHypotheses.hypotheses.clear();
+    if (theRobotInfo.penalty != PENALTY_NONE)
+      return;
+  }
+
+  predict(odometryOffset);
+
+  if (theFallDownState.state == FallDownState::upright && theFieldLinesDistanceMap.isValid() && samplePoints())
+  {
+    const size_t chunkSize = (std::max(particlesPerTask, 4u) + 3) & ~3u;
+    const int numOfChunks = static_cast<int>((size + chunkSize - 1) / chunkSize);
+    if (numOfChunks < 2 || subflow.executor().num_workers() < 2)
+      score(0, size);
+    else
+    {
+      subflow
+          .for_each_index(0,
+              numOfChunks,
+              1,
+              [this, chunkSize, size](const int chunk)
+              {
+                score(chunk * chunkSize, std::min(size, (chunk + 1) * chunkSize));
+              })
+          .name("ScoreParticles [ParticleFilterRelocalizer]");
+      subflow.join();
+    }
+    resample();
+    createHypotheses();
+    relocalizationHypotheses.timestamp = theFrameInfo.time;
+  }
+
+  COMPLEX_DRAWING("module:ParticleFilterRelocalizer:particles") draw();
+}
+
+void ParticleFilterRelocalizer::initialize()
+{
+  const size_t size = (std::max(numOfParticles, 4u) + 3) & ~3u;
+  particles.resize(size);
+  resampled.resize(size);
+  for (std::vector<float>& buffer : noise)
+    buffer.resize(size);
+  randomize(particles, 0, size);
+  std::fill(particles.weight.begin(), particles.weight.end(), 1.f / static_cast<float>(size));
+}
+
+void ParticleFilterRelocalizer::randomize(Particles& particles, size_t begin, size_t end) const
+{
+  if (begin >= end)
+    return;
+  const Boundaryf& boundary = theFieldDimensions.boundary;
+  Random::fillUniform(particles.x.data() + begin, end - begin, boundary.x.min, boundary.x.max);
+  Random::fillUniform(particles.y.data() + begin, end - begin, boundary.y.min, boundary.y.max);
+  Random::fillUniform(particles.rotation.data() + begin, end - begin, -pi, pi);
+}
+
+void ParticleFilterRelocalizer::predict(const Pose2f& odometryOffset)
+{
+  const size_t size = particles.size();
+  Random::fillNormal(noise[0].data(), size, 0.f, std::max(minTranslationNoise, std::abs(odometryOffset.translation.x()) * translationNoise));
+  Random::fillNormal(noise[1].data(), size, 0.f, std::max(minTranslationNoise, std::abs(odometryOffset.translation.y()) * translationNoise));
+  Random::fillNormal(noise[2].data(), size, 0.f, std::max(static_cast<float>(minRotationNoise), std::abs(odometryOffset.rotation) * rotationNoise));
+
+  const __m128 offsetX = _mm_set1_ps(odometryOffset.translation.x());
+  const __m128 offsetY = _mm_set1_ps(odometryOffset.translation.y());
+  const __m128 offsetRotation = _mm_set1_ps(odometryOffset.rotation);
+  const __m128 twoPi = _mm_set1_ps(pi2);
+  const __m128 invTwoPi = _mm_set1_ps(1.f / pi2);
+  for (size_t i = 0; i < size; i += 4)
+  {
+    __m128 rotation = _mm_loadu_ps(&particles.rotation[i]);
+    __m128 sin, cos;
+    sincos_ps(rotation, &sin, &cos);
+    const __m128 moveX = _mm_add_ps(offsetX, _mm_loadu_ps(&noise[0][i]));
+    const __m128 moveY = _mm_add_ps(offsetY, _mm_loadu_ps(&noise[1][i]));
+    _mm_storeu_ps(&particles.x[i], _mm_add_ps(_mm_loadu_ps(&particles.x[i]), _mm_sub_ps(_mm_mul_ps(cos, moveX), _mm_mul_ps(sin, moveY))));
+    _mm_storeu_ps(&particles.y[i], _mm_add_ps(_mm_loadu_ps(&particles.y[i]), _mm_add_ps(_mm_mul_ps(sin, moveX), _mm_mul_ps(cos, moveY))));
+
+    // Normalize to [-pi..pi] by subtracting the closest multiple of 2 pi.
+    rotation = _mm_add_ps(rotation, _mm_add_ps(offsetRotation, _mm_loadu_ps(&noise[2][i])));
+    rotation = _mm_sub_ps(rotation, _mm_mul_ps(twoPi, _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(rotation, invTwoPi)))));
+    _mm_storeu_ps(&particles.rotation[i], rotation);
+  }
+}
+
+bool ParticleFilterRelocalizer::samplePoints()
+{
+  pointsX.clear();
+  pointsY.clear();
+  for (const CLIPFieldLinesPercept::FieldLine& line : theCLIPFieldLinesPercept.lines)
+    if (line.isPlausible)
+    {
+      const Vector2f direction = line.endOnField - line.startOnField;
+      const int numOfSamples = std::max(1, static_cast<int>(direction.norm() / sampleDistance));
+      for (int i = 0; i < numOfSamples; ++i)
+      {
+        const Vector2f point = line.startOnField + direction * ((static_cast<float>(i) + 0.5f) / static_cast<float>(numOfSamples));
+        pointsX.push_back(point.x());
+        pointsY.push_back(point.y());
+      }
+    }
+
+  // Too many points are thinned out evenly, so all lines still contribute.
+  if (pointsX.size() > maxNumOfPoints)
+  {
+    const size_t numOfPoints = pointsX.size();
+    for (size_t i = 0; i < maxNumOfPoints; ++i)
+    {
+      pointsX[i] = pointsX[i * numOfPoints / maxNumOfPoints];
+      pointsY[i] = pointsY[i * numOfPoints / maxNumOfPoints];
+    }
+    pointsX.resize(maxNumOfPoints);
+    pointsY.resize(maxNumOfPoints);
+  }
+  return !pointsX.empty() && pointsX.size() >= minNumOfPoints;
+}
+
+void ParticleFilterRelocalizer::score(size_t begin, size_t end)
+{
+  const FieldLinesDistanceMap& map = theFieldLinesDistanceMap;
+  const __m128 originX = _mm_set1_ps(map.origin.x());
+  const __m128 originY = _mm_set1_ps(map.origin.y());
+  const __m128 invCellSize = _mm_set1_ps(1.f / map.cellSize);
+  const __m128 maxCellX = _mm_set1_ps(static_cast<float>(map.cellsX - 1));
+  const __m128 maxCellY = _mm_set1_ps(static_cast<float>(map.cellsY - 1));
+  const __m128 cellsX = _mm_set1_ps(static_cast<float>(map.cellsX));
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 exponentFactor = _mm_set1_ps(-0.5f / (distanceDeviation * distanceDeviation));
+  const __m128 minLikelihood = _mm_set1_ps(minPointLikelihood);
+  const __m128 invNumOfPoints = _mm_set1_ps(1.f / static_cast<float>(pointsX.size()));
+  alignas(16) int indices[4];
+
+  for (size_t i = begin; i < end; i += 4)
+  {
+    const __m128 x = _mm_loadu_ps(&particles.x[i]);
+    const __m128 y = _mm_loadu_ps(&particles.y[i]);
+    __m128 sin, cos;
+    sincos_ps(_mm_loadu_ps(&particles.rotation[i]), &sin, &cos);
+    __m128 sum = zero;
+    for (size_t j = 0; j < pointsX.size(); ++j)
+    {
+      const __m128 relX = _mm_set1_ps(pointsX[j]);
+      const __m128 relY = _mm_set1_ps(pointsY[j]);
+      const __m128 pointX = _mm_add_ps(x, _mm_sub_ps(_mm_mul_ps(cos, relX), _mm_mul_ps(sin, relY)));
+      const __m128 pointY = _mm_add_ps(y, _mm_add_ps(_mm_mul_ps(sin, relX), _mm_mul_ps(cos, relY)));
+
+      // The cells are clipped before the conversion, so SSE2 suffices and the indices are exact.
+      const __m128 cellX = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(pointX, originX), invCellSize), zero), maxCellX)));
+      const __m128 cellY = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(pointY, originY), invCellSize), zero), maxCellY)));
+      _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(cellY, cellsX), cellX)));
+      const __m128 distance = _mm_setr_ps(map.cells[indices[0]].distance, map.cells[indices[1]].distance,
+                                          map.cells[indices[2]].distance, map.cells[indices[3]].distance);
+      sum = _mm_add_ps(sum, _mm_max_ps(exp_ps(_mm_mul_ps(_mm_mul_ps(distance, distance), exponentFactor)), minLikelihood));
+    }
+    _mm_storeu_ps(&particles.weight[i], _mm_mul_ps(_mm_loadu_ps(&particles.weight[i]), _mm_mul_ps(sum, invNumOfPoints)));
+  }
+}
+
+void ParticleFilterRelocalizer::resample()
+{
+  const size_t size = particles.size();
+  float sum = 0.f;
+  for (float weight : particles.weight)
+    sum += weight;
+  if (!(sum > 0.f) || !std::isfinite(sum))
+  {
+    initialize();
+    return;
+  }
+
+  float sqrSum = 0.f;
+  for (float& weight : particles.weight)
+  {
+    weight /= sum;
+    sqrSum += weight * weight;
+  }
+  if (1.f / sqrSum >= resamplingThreshold * static_cast<float>(size))
+    return;
+
+  // Low variance resampling of all particles but the random ones
+  const size_t numOfRandomParticles = std::min(size, static_cast<size_t>(randomParticleRatio * static_cast<float>(size) + 0.5f));
+  const size_t numOfKeptParticles = size - numOfRandomParticles;
+  if (numOfKeptParticles > 0)
+  {
+    const float step = 1.f / static_cast<float>(numOfKeptParticles);
+    float target = randomFloat() * step;
+    float cumulativeWeight = particles.weight[0];
+    size_t source = 0;
+    for (size_t i = 0; i < numOfKeptParticles; ++i, target += step)
+    {
+      while (cumulativeWeight < target && source + 1 < size)
+        cumulativeWeight += particles.weight[++source];
+      resampled.x[i] = particles.x[source];
+      resampled.y[i] = particles.y[source];
+      resampled.rotation[i] = particles.rotation[source];
+    }
+  }
+  randomize(resampled, numOfKeptParticles, size);
+  std::fill(resampled.weight.begin(), resampled.weight.end(), 1.f / static_cast<float>(size));
+  std::swap(particles, resampled);
+}
+
+void ParticleFilterRelocalizer::createHypotheses()
+{
+  struct Cluster
+  {
+    float weight = 0.f;
+    float x = 0.f;
+    float y = 0.f;
+    float cos = 0.f;
+    float sin = 0.f;
+
+    void add(const Cluster& other)
+    {
+      weight += other.weight;
+      x += other.x;
+      y += other.y;
+      cos += other.cos;
+      sin += other.sin;
+    }
+  };
+
+  const Boundaryf& boundary = theFieldDimensions.boundary;
+  const float cellSize = std::max(clusterCellSize, 1.f);
+  const int cellsX = std::max(1, static_cast<int>(std::ceil(boundary.x.getSize() / cellSize)));
+  const int cellsY = std::max(1, static_cast<int>(std::ceil(boundary.y.getSize() / cellSize)));
+  std::vector<Cluster> cells(cellsX * cellsY);
+  for (size_t i = 0; i < particles.size(); ++i)
+  {
+    const int x = std::clamp(static_cast<int>((particles.x[i] - boundary.x.min) / cellSize), 0, cellsX - 1);
+    const int y = std::clamp(static_cast<int>((particles.y[i] - boundary.y.min) / cellSize), 0, cellsY - 1);
+    Cluster& cell = cells[y * cellsX + x];
+    const float weight = particles.weight[i];
+    cell.weight += weight;
+    cell.x += particles.x[i] * weight;
+    cell.y += particles.y[i] * weight;
+    cell.cos += std::cos(particles.rotation[i]) * weight;
+    cell.sin += std::sin(particles.rotation[i]) * weight;
+  }
+
+  // The heaviest cell and its neighbors form a cluster. They are removed before the next one is searched.
+  relocalizationHypotheses.hypotheses.clear();
+  while (relocalizationHypotheses.hypotheses.size() < maxNumOfHypotheses)
+  {
+    const auto heaviest = std::max_element(cells.begin(), cells.end(), [](const Cluster& a, const Cluster& b) { return a.weight < b.weight; });
+    const int centerX = static_cast<int>(heaviest - cells.begin()) % cellsX;
+    const int centerY = static_cast<int>(heaviest - cells.begin()) / cellsX;
+    Cluster cluster;
+    for (int y = std::max(0, centerY - 1); y <= std::min(cellsY - 1, centerY + 1); ++y)
+      for (int x = std::max(0, centerX - 1); x <= std::min(cellsX - 1, centerX + 1); ++x)
+      {
+        cluster.add(cells[y * cellsX + x]);
+        cells[y * cellsX + x] = Cluster();
+      }
+    if (cluster.weight < minHypothesisWeight || cluster.weight <= 0.f)
+      break;
+    RelocalizationHypotheses::Hypothesis& hypothesis = relocalizationHypotheses.hypotheses.emplace_back();
+    hypothesis.pose = Pose2f(std::atan2(cluster.sin, cluster.cos), cluster.x / cluster.weight, cluster.y / cluster.weight);
+    hypothesis.weight = cluster.weight;
+  }
+}
+
+void ParticleFilterRelocalizer::draw() const
+{
+  const size_t step = std::max<size_t>(1, particles.size() / 512);
+  for (size_t i = 0; i < particles.size(); i += step)
+  {
+    const float tipX = particles.x[i] + std::cos(particles.rotation[i]) * 100.f;
+    const float tipY = particles.y[i] + std::sin(particles.rotation[i]) * 100.f;
+    LINE("module:ParticleFilterRelocalizer:particles", particles.x[i], particles.y[i], tipX, tipY, 10, Drawings::solidPen, ColorRGBA(255, 0, 255));
+  }
+}
+
+MAKE_MODULE(ParticleFilterRelocalizer, modeling)
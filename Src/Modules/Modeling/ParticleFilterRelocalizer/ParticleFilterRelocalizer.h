@@ -0,0 +1,119 @@
+/**
+ * @file ParticleFilterRelocalizer.h
+ * Declares a module that localizes the robot globally with a particle filter.
+ * It scores the particles against the field line percepts with the distance map
+ * of the field lines. The particles are stored as structure of arrays, so four
+ * of them are moved and scored at once with SSE instructions. The scoring is
+ * split into tasks for the worker threads. The module does not provide the
+ * RobotPose. It only provides the most likely poses as RelocalizationHypotheses,
+ * which the SelfLocator2017 adds as new hypotheses when it lost its position.
+ */
+
+#pragma once
+
+#include "Representations/Configuration/FieldDimensions.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/Infrastructure/RobotInfo.h"
+#include "Representations/MotionControl/OdometryData.h"
+#include "Representations/Modeling/FieldLinesDistanceMap.h"
+#include "Representations/Modeling/RelocalizationHypotheses.h"
+#include "Representations/Perception/CLIPFieldLinesPercept.h"
+#include "Representations/Sensing/FallDownState.h"
+#include "Tools/Module/Module.h"
+#include <vector>
+
+MODULE(ParticleFilterRelocalizer,
+  REQUIRES(CLIPFieldLinesPercept),
+  REQUIRES(FallDownState),
+  REQUIRES(FieldDimensions),
+  REQUIRES(FieldLinesDistanceMap),
+  REQUIRES(FrameInfo),
+  REQUIRES(OdometryData),
+  REQUIRES(RobotInfo),
+  PROVIDES(RelocalizationHypotheses),
+  HAS_PREEXECUTION,
+  LOADS_PARAMETERS(,
+    (unsigned)(2048) numOfParticles, /**< The number of particles. It is rounded up to a multiple of 4. */
+    (unsigned)(512) particlesPerTask, /**< The number of particles scored by a single task. */
+    (float)(150.f) sampleDistance, /**< The distance between the points sampled from the line percepts in mm. */
+    (unsigned)(32) maxNumOfPoints, /**< The maximum number of points sampled from the line percepts. */
+    (unsigned)(4) minNumOfPoints, /**< Fewer points do not result in a measurement update. */
+    (float)(150.f) distanceDeviation, /**< The standard deviation of the distance of a point to the closest field line in mm. */
+    (float)(0.05f) minPointLikelihood, /**< A point is at least this likely, so single false percepts do not remove good particles. */
+    (float)(0.1f) translationNoise, /**< The standard deviation of the translation per mm moved. */
+    (float)(0.1f) rotationNoise, /**< The standard deviation of the rotation per radian turned. */
+    (float)(10.f) minTranslationNoise, /**< The standard deviation of the translation per frame in mm. */
+    (Angle)(1_deg) minRotationNoise, /**< The standard deviation of the rotation per frame. */
+    (float)(0.5f) resamplingThreshold, /**< Resample when the effective number of particles drops below this ratio. */
+    (float)(0.02f) randomParticleRatio, /**< The ratio of particles replaced by random ones when resampling. */
+    (float)(500.f) clusterCellSize, /**< The edge length of the cells the particles are clustered in in mm. */
+    (unsigned)(4) maxNumOfHypotheses, /**< The maximum number of hypotheses provided. */
+    (float)(0.1f) minHypothesisWeight /**< Clusters that have a lower weight are not provided. */
+  )
+);
+
+class ParticleFilterRelocalizer : public ParticleFilterRelocalizerBase
+{
+  /** The particles as structure of arrays, so four of them can be processed at once. */
+  struct Particles
+  {
+    std::vector<float> x; /**< The x coordinates in field coordinates in mm. */
+    std::vector<float> y; /**< The y coordinates in field coordinates in mm. */
+    std::vector<float> rotation; /**< The rotations in radians. */
+    std::vector<float> weight; /**< The weights. Their sum is 1. */
+
+    void resize(size_t size);
+    size_t size() const { return x.size(); }
+  };
+
+  Particles particles;
+  Particles resampled; /**< The target of the resampling, kept to avoid allocations. */
+  std::vector<float> noise[3]; /**< Buffers for the noise of the motion update. */
+  std::vector<float> pointsX; /**< The x coordinates of the points sampled from the line percepts relative to the robot. */
+  std::vector<float> pointsY; /**< The y coordinates of the points sampled from the line percepts relative to the robot. */
+  Pose2f lastOdometryData;
+  unsigned lastFieldDimensionsUpdate = 0;
+  RelocalizationHypotheses relocalizationHypotheses;
+
+  void execute(tf::Subflow& subflow);
+  void update(RelocalizationHypotheses& hypotheses) { hypotheses = relocalizationHypotheses; }
+
+  /** Distributes all particles uniformly on the carpet. */
+  void initialize();
+
+  /**
+   * Replaces particles by ones that are uniformly distributed on the carpet.
+   * @param particles The particles.
+   * @param begin The index of the first particle replaced.
+   * @param end The index after the last particle replaced.
+   */
+  void randomize(Particles& particles, size_t begin, size_t end) const;
+
+  /**
+   * Moves the particles by the odometry offset and adds noise.
+   * @param odometryOffset The odometry offset since the previous frame.
+   */
+  void predict(const Pose2f& odometryOffset);
+
+  /**
+   * Samples points with a fixed distance from the plausible line percepts.
+   * @return Were enough points sampled?
+   */
+  bool samplePoints();
+
+  /**
+   * Multiplies the weights of a range of particles with their likelihoods.
+   * The range must start at a multiple of 4.
+   * @param begin The index of the first particle scored.
+   * @param end The index after the last particle scored.
+   */
+  void score(size_t begin, size_t end);
+
+  /** Normalizes the weights and resamples if the weights are too unevenly distributed. */
+  void resample();
+
+  /** Clusters the particles and creates the hypotheses from the heaviest clusters. */
+  void createHypotheses();
+
+  void draw() const;
+};
@@ -0,0 +1,355 @@
+/**
+ * @file GridPathProvider.cpp
+ * Implementation of a path planner that searches a costmap of the field with D* Lite
+ * (S. Koenig and M. Likhachev, "D* Lite", AAAI 2002).
+ */
+
+#include "GridPathProvider.h"
+#include "Tools/Math/Transformation.h"
+
+void GridPathProvider::update(Path& path)
+{
+  DECLARE_DEBUG_DRAWING("module:GridPathProvider:costs", "drawingOnField");
+  DECLARE_DEBUG_DRAWING("module:GridPathProvider:cells", "drawingOnField");
+
+  if (theMotionRequest.motion == MotionRequest::walk && theMotionRequest.walkRequest.requestType == WalkRequest::destination && !path.wayPoints.empty())
+  {
+    Pose2f destination = theRobotPoseAfterPreview + theMotionRequest.walkRequest.request;
+    collectObstacles(destination);
+    resizeCostmap();
+    updateCosts();
+
+    const int start = getCell(theRobotPoseAfterPreview.translation);
+    const int goal = getCell(destination.translation);
+    if (goal != goalCell)
+      restartSearch(start, goal);
+    else
+    {
+      // The costs of the edges have changed, so the keys must reflect how far the robot has walked since
+      if (start != startCell)
+      {
+        keyModifier += heuristic(startCell, start);
+        startCell = start;
+      }
+      for (const int cell : changedCells)
+      {
+        updateVertex(cell);
+        forEachNeighbor(cell,
+            [this](const int neighbor)
+            {
+              updateVertex(neighbor);
+            });
+      }
+    }
+    computeShortestPath();
+
+    path.reset();
+    buildPath(path, destination);
+
+    path.nearestObstacle = std::numeric_limits<float>::max();
+    for (const Obstacle& obstacle : obstacles)
+    {
+      const float distance = std::abs((obstacle.position - theRobotPoseAfterPreview.translation).norm() - obstacle.radius);
+      if (distance < path.nearestObstacle)
+      {
+        path.nearestObstacle = distance;
+        path.nearestObstaclePosition = obstacle.position;
+        path.nearestObstacleType = obstacle.type;
+      }
+    }
+    for (size_t i = 0; i + 1 < path.wayPoints.size(); ++i)
+      path.length += (path.wayPoints[i + 1].translation - path.wayPoints[i].translation).norm();
+
+    draw();
+  }
+  else
+  {
+    path.reset();
+    path.wayPoints.push_back(theRobotPoseAfterPreview);
+    path.wayPoints.push_back(theRobotPoseAfterPreview);
+  }
+}
+
+void GridPathProvider::collectObstacles(Pose2f& destination)
+{
+  obstacles.clear();
+
+  for (const RobotMapEntry& robot : theRobotMap.robots)
+  {
+    const bool isTeammate = robot.robotType == RobotEstimate::teammateRobot;
+    obstacles.push_back({robot.pose.translation, isTeammate ? teamRobotInfluenceRadius : robotInfluenceRadius, isTeammate ? Path::teamRobot : Path::robot});
+  }
+
+  // The same conditions as in the SimplePathProvider
+  if ((theBallSymbols.timeSinceLastSeen < 2000
+          || (theBallSymbols.timeSinceLastSeenByTeam < 2000 && Transformation::fieldToRobot(theRobotPoseAfterPreview, theBallSymbols.ballPositionField).x() < 0))
+      && (theGameInfo.state == STATE_PLAYING || theBehaviorData.behaviorState >= BehaviorData::BehaviorState::firstCalibrationState)
+      && theBallchaser.kickType != MotionRequest::dribble && theBallSymbols.avoidBall)
+  {
+    const Vector2f ballPosition = Transformation::robotToField(theRobotPoseAfterPreview, theBallModelAfterPreview.estimate.position);
+    const float radius = theGameInfo.setPlay != SET_PLAY_NONE && !theGameSymbols.ownKickOff ? 150.f : ballInfluenceRadius;
+    obstacles.push_back({ballPosition, radius, Path::ball});
+  }
+
+  obstacles.push_back({Vector2f(theFieldDimensions.xPosOpponentGoalPost, theFieldDimensions.yPosLeftGoal), goalPostInfluenceRadius, Path::goalPost});
+  obstacles.push_back({Vector2f(theFieldDimensions.xPosOpponentGoalPost, theFieldDimensions.yPosRightGoal), goalPostInfluenceRadius, Path::goalPost});
+  obstacles.push_back({Vector2f(theFieldDimensions.xPosOwnGoalPost, theFieldDimensions.yPosLeftGoal), goalPostInfluenceRadius, Path::goalPost});
+  obstacles.push_back({Vector2f(theFieldDimensions.xPosOwnGoalPost, theFieldDimensions.yPosRightGoal), goalPostInfluenceRadius, Path::goalPost});
+
+  if (theGameSymbols.avoidCenterCircle)
+  {
+    const float circleSafetyRadius = theFieldDimensions.centerCircleRadius + centerCircleInfluenceRadius;
+    if (destination.translation.norm() < circleSafetyRadius)
+      destination = Pose2f(Angle::normalize(theRobotPoseAfterPreview.translation.angle() + pi), Vector2f(theRobotPoseAfterPreview.translation).normalize(circleSafetyRadius));
+    else
+      obstacles.push_back({Vector2f::Zero(), circleSafetyRadius, Path::centerCircle});
+  }
+
+  if (theGameInfo.setPlay != SET_PLAY_NONE && !theGameSymbols.ownKickOff)
+    obstacles.push_back({theBallSymbols.ballPositionField, setPlayInfluenceRadius, Path::setPlayCircle});
+}
+
+void GridPathProvider::resizeCostmap()
+{
+  const Vector2f newOrigin(theFieldDimensions.xPosOwnFieldBorder, theFieldDimensions.yPosRightFieldBorder);
+  const int newNumOfCellsX = std::max(1, static_cast<int>(std::ceil((theFieldDimensions.xPosOpponentFieldBorder - newOrigin.x()) / cellSize)));
+  const int newNumOfCellsY = std::max(1, static_cast<int>(std::ceil((theFieldDimensions.yPosLeftFieldBorder - newOrigin.y()) / cellSize)));
+  if (newNumOfCellsX == numOfCellsX && newNumOfCellsY == numOfCellsY && newOrigin == origin)
+    return;
+
+  numOfCellsX = newNumOfCellsX;
+  numOfCellsY = newNumOfCellsY;
+  origin = newOrigin;
+  const size_t numOfCells = static_cast<size_t>(numOfCellsX * numOfCellsY);
+  newCosts.assign(numOfCells, 1.f);
+  costs.assign(numOfCells, 1.f);
+  dangerCosts.assign(numOfCells, 0.f);
+  dangerCostsValid = false;
+  g.assign(numOfCells, infinity);
+  rhs.assign(numOfCells, infinity);
+  queuedKeys.assign(numOfCells, Key(infinity, infinity));
+  open.assign(numOfCells, false);
+  changedCells.reserve(numOfCells);
+  pathCells.reserve(numOfCells);
+  goalCell = -1;
+}
+
+void GridPathProvider::updateCosts()
+{
+  if (!dangerCostsValid || theDangerMap.changedSince(timeWhenDangerCostsComputed))
+  {
+    for (size_t cell = 0; cell < dangerCosts.size(); ++cell)
+      dangerCosts[cell] = dangerCost * theDangerMap.getDangerAt(getCellCenter(static_cast<int>(cell)), theFieldDimensions, 0.f);
+    timeWhenDangerCostsComputed = theDangerMap.timeWhenChanged;
+    dangerCostsValid = true;
+  }
+  for (size_t cell = 0; cell < newCosts.size(); ++cell)
+    newCosts[cell] = 1.f + dangerCosts[cell];
+
+  for (const Obstacle& obstacle : obstacles)
+  {
+    const int minX = std::max(0, static_cast<int>((obstacle.position.x() - obstacle.radius - origin.x()) / cellSize));
+    const int maxX = std::min(numOfCellsX - 1, static_cast<int>((obstacle.position.x() + obstacle.radius - origin.x()) / cellSize));
+    const int minY = std::max(0, static_cast<int>((obstacle.position.y() - obstacle.radius - origin.y()) / cellSize));
+    const int maxY = std::min(numOfCellsY - 1, static_cast<int>((obstacle.position.y() + obstacle.radius - origin.y()) / cellSize));
+    for (int x = minX; x <= maxX; ++x)
+      for (int y = minY; y <= maxY; ++y)
+      {
+        const int cell = x * numOfCellsY + y;
+        const float distance = (getCellCenter(cell) - obstacle.position).norm();
+        if (distance < obstacle.radius)
+          newCosts[cell] += obstacleCost * (1.f - distance / obstacle.radius);
+      }
+  }
+
+  // The goals and, if the robot is not allowed to enter it, the own goal area
+  for (int cell = 0; cell < static_cast<int>(newCosts.size()); ++cell)
+  {
+    const Vector2f center = getCellCenter(cell);
+    const bool inGoal = std::abs(center.x()) > theFieldDimensions.xPosOpponentGroundline && std::abs(center.y()) < theFieldDimensions.yPosLeftGoal;
+    const bool inOwnGoalArea = center.x() < theFieldDimensions.xPosOwnGoalArea && std::abs(center.y()) < theFieldDimensions.yPosLeftGoalArea;
+    if (inGoal || (inOwnGoalArea && !theGameSymbols.allowedInGoalArea))
+      newCosts[cell] += forbiddenAreaCost;
+  }
+
+  changedCells.clear();
+  for (int cell = 0; cell < static_cast<int>(costs.size()); ++cell)
+    if (std::abs(newCosts[cell] - costs[cell]) > costChangeThreshold)
+    {
+      costs[cell] = newCosts[cell];
+      changedCells.push_back(cell);
+    }
+}
+
+void GridPathProvider::restartSearch(const int start, const int goal)
+{
+  costs = newCosts;
+  std::fill(g.begin(), g.end(), infinity);
+  std::fill(rhs.begin(), rhs.end(), infinity);
+  std::fill(open.begin(), open.end(), false);
+  queue = decltype(queue)();
+  startCell = start;
+  goalCell = goal;
+  keyModifier = 0.f;
+  rhs[goal] = 0.f;
+  enqueue(goal, calculateKey(goal));
+}
+
+void GridPathProvider::updateVertex(const int cell)
+{
+  if (cell != goalCell)
+  {
+    float minimum = infinity;
+    forEachNeighbor(cell,
+        [&](const int neighbor)
+        {
+          minimum = std::min(minimum, edgeCost(cell, neighbor) + g[neighbor]);
+        });
+    rhs[cell] = minimum;
+  }
+  if (g[cell] != rhs[cell])
+    enqueue(cell, calculateKey(cell));
+  else
+    open[cell] = false;
+}
+
+void GridPathProvider::computeShortestPath()
+{
+  for (int expansions = 0; !queue.empty() && expansions < maxExpansions;)
+  {
+    const QueueEntry top = queue.top();
+    if (!open[top.cell] || top.key != queuedKeys[top.cell])
+    {
+      queue.pop();
+      continue;
+    }
+    if (!(top.key < calculateKey(startCell)) && rhs[startCell] == g[startCell])
+      break;
+
+    queue.pop();
+    ++expansions;
+    const int cell = top.cell;
+    const Key key = calculateKey(cell);
+    if (top.key < key)
+      enqueue(cell, key);
+    else if (g[cell] > rhs[cell])
+    {
+      g[cell] = rhs[cell];
+      open[cell] = false;
+      forEachNeighbor(cell,
+          [this](const int neighbor)
+          {
+            updateVertex(neighbor);
+          });
+    }
+    else
+    {
+      g[cell] = infinity;
+      updateVertex(cell);
+      forEachNeighbor(cell,
+          [this](const int neighbor)
+          {
+            updateVertex(neighbor);
+          });
+    }
+  }
+}
+
+void GridPathProvider::buildPath(Path& path, const Pose2f& destination)
+{
+  path.wayPoints.push_back(theRobotPoseAfterPreview);
+
+  // Follow the cheapest neighbors from the robot to the destination
+  pathCells.clear();
+  if (g[startCell] != infinity)
+  {
+    int cell = startCell;
+    pathCells.push_back(cell);
+    while (cell != goalCell && pathCells.size() < costs.size())
+    {
+      int next = -1;
+      float nextCost = infinity;
+      forEachNeighbor(cell,
+          [&](const int neighbor)
+          {
+            const float cost = edgeCost(cell, neighbor) + g[neighbor];
+            if (cost < nextCost)
+            {
+              nextCost = cost;
+              next = neighbor;
+            }
+          });
+      if (next < 0)
+        break;
+      cell = next;
+      pathCells.push_back(cell);
+    }
+    if (cell != goalCell)
+      pathCells.clear();
+  }
+
+  // Only keep the cells at which the path has to bend, i.e. where a straight line would cost notably more
+  if (pathCells.size() > 2)
+  {
+    size_t anchor = 0;
+    Vector2f anchorPosition = theRobotPoseAfterPreview.translation;
+    const size_t last = pathCells.size() - 1;
+    while (anchor < last)
+    {
+      size_t next = anchor + 1;
+      for (size_t candidate = anchor + 2; candidate <= last; ++candidate)
+      {
+        const Vector2f candidatePosition = candidate == last ? destination.translation : getCellCenter(pathCells[candidate]);
+        const float gridCost = g[pathCells[anchor]] - g[pathCells[candidate]];
+        if (getLineCost(anchorPosition, candidatePosition) > gridCost * (1.f + shortcutCostTolerance))
+          break;
+        next = candidate;
+      }
+      if (next == last)
+        break;
+      anchor = next;
+      anchorPosition = getCellCenter(pathCells[anchor]);
+      path.wayPoints.emplace_back(0.f, anchorPosition);
+    }
+  }
+
+  path.wayPoints.push_back(destination);
+  for (size_t i = 1; i + 1 < path.wayPoints.size(); ++i)
+    path.wayPoints[i].rotation = (path.wayPoints[i + 1].translation - path.wayPoints[i].translation).angle();
+}
+
+float GridPathProvider::getLineCost(const Vector2f& from, const Vector2f& to) const
+{
+  const float length = (to - from).norm();
+  const int steps = std::max(1, static_cast<int>(std::ceil(2.f * length / cellSize)));
+  const Vector2f step = (to - from) / static_cast<float>(steps);
+  float cost = 0.f;
+  for (int i = 0; i < steps; ++i)
+    cost += costs[getCell(from + step * (static_cast<float>(i) + 0.5f))];
+  return cost * length / static_cast<float>(steps) / cellSize;
+}
+
+void GridPathProvider::draw() const
+{
+  COMPLEX_DRAWING("module:GridPathProvider:costs")
+  {
+    for (int cell = 0; cell < static_cast<int>(costs.size()); ++cell)
+      if (costs[cell] > 1.f + costChangeThreshold)
+      {
+        const Vector2f center = getCellCenter(cell);
+        const unsigned char alpha = static_cast<unsigned char>(std::min(200.f, 10.f * costs[cell]));
+        FILLED_RECTANGLE("module:GridPathProvider:costs", center.x() - cellSize / 2.f, center.y() - cellSize / 2.f, center.x() + cellSize / 2.f, center.y() + cellSize / 2.f,
+            0, Drawings::noPen, ColorRGBA::red, Drawings::solidBrush, ColorRGBA(255, 0, 0, alpha));
+      }
+  }
+  COMPLEX_DRAWING("module:GridPathProvider:cells")
+  {
+    for (const int cell : pathCells)
+    {
+      const Vector2f center = getCellCenter(cell);
+      CIRCLE("module:GridPathProvider:cells", center.x(), center.y(), cellSize / 4.f, 0, Drawings::noPen, ColorRGBA::blue, Drawings::solidBrush, ColorRGBA::blue);
+    }
+  }
+}
+
+MAKE_MODULE(GridPathProvider, pathPlanning)
@@ -0,0 +1,189 @@
+/**
+ * @file GridPathProvider.h
+ * Declaration of a path planner that searches a costmap of the field with D* Lite. The costmap is built from
+ * the RobotMap, the ball, the goals, the DangerMap and the rules that forbid certain areas. Since D* Lite
+ * searches from the destination to the robot, the plan is only repaired around the cells whose costs changed
+ * when the robot walks or obstacles move, instead of being recomputed from scratch. Cost changes below a
+ * threshold are ignored, which keeps the path from oscillating in crowded areas. The resulting path has the
+ * same format as the one of the SimplePathProvider, so it can be used by PathToSpeedStable.
+ */
+
+#pragma once
+
+#include "Representations/BehaviorControl/BallSymbols.h"
+#include "Representations/BehaviorControl/BehaviorData.h"
+#include "Representations/BehaviorControl/GameSymbols.h"
+#include "Representations/BehaviorControl/RoleSymbols/Ballchaser.h"
+#include "Representations/Configuration/FieldDimensions.h"
+#include "Representations/Infrastructure/GameInfo.h"
+#include "Representations/Modeling/BallModel.h"
+#include "Representations/Modeling/DangerMap.h"
+#include "Representations/Modeling/Path.h"
+#include "Representations/Modeling/RobotMap.h"
+#include "Representations/Modeling/RobotPose.h"
+#include "Representations/MotionControl/MotionRequest.h"
+#include "Tools/Module/Module.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+MODULE(GridPathProvider,
+  REQUIRES(BallSymbols),
+  REQUIRES(BallModelAfterPreview),
+  REQUIRES(Ballchaser),
+  REQUIRES(BehaviorData),
+  REQUIRES(DangerMap),
+  REQUIRES(FieldDimensions),
+  REQUIRES(GameInfo),
+  REQUIRES(GameSymbols),
+  REQUIRES(MotionRequest),
+  REQUIRES(RobotMap),
+  REQUIRES(RobotPoseAfterPreview),
+  PROVIDES(Path),
+  LOADS_PARAMETERS(,
+    (float)(150.f) cellSize, /**< The edge length of a cell of the costmap in mm. */
+    (float)(200.f) ballInfluenceRadius,
+    (float)(350.f) centerCircleInfluenceRadius,
+    (float)(250.f) goalPostInfluenceRadius,
+    (float)(400.f) robotInfluenceRadius,
+    (float)(500.f) teamRobotInfluenceRadius,
+    (float)(800.f) setPlayInfluenceRadius,
+    (float)(20.f) obstacleCost, /**< The additional cost at the center of an obstacle, which decreases linearly to zero at its influence radius. */
+    (float)(1.f) dangerCost, /**< The additional cost of a cell with the maximum danger. */
+    (float)(100.f) forbiddenAreaCost, /**< The additional cost of the goals and of the own goal area if the robot is not allowed to enter it. */
+    (float)(0.5f) costChangeThreshold, /**< Cells whose cost changed less than this are not updated, so the plan is only repaired for relevant changes. */
+    (float)(0.1f) shortcutCostTolerance, /**< A straight line may replace a part of the grid path if it costs at most this fraction more. */
+    (int)(10000) maxExpansions /**< The maximum number of cells expanded per frame. The search is continued in the next frame if it is not finished. */
+  )
+);
+
+class GridPathProvider : public GridPathProviderBase
+{
+private:
+  /** The key of a cell in the priority queue of D* Lite. */
+  using Key = std::pair<float, float>;
+
+  struct QueueEntry
+  {
+    Key key;
+    int cell;
+
+    bool operator>(const QueueEntry& other) const { return other.key < key; }
+  };
+
+  struct Obstacle
+  {
+    Vector2f position;
+    float radius;
+    Path::ObstacleType type;
+  };
+
+  static constexpr float infinity = std::numeric_limits<float>::infinity();
+
+  // The costmap
+  int numOfCellsX = 0;
+  int numOfCellsY = 0;
+  Vector2f origin = Vector2f::Zero(); /**< The field coordinates of the corner of the first cell. */
+  std::vector<float> newCosts; /**< The costs of the cells computed in this frame. */
+  std::vector<float> costs; /**< The costs of the cells the plan is based on. */
+  std::vector<float> dangerCosts; /**< The costs from the DangerMap, which are only updated when it changed. */
+  unsigned timeWhenDangerCostsComputed = 0;
+  bool dangerCostsValid = false;
+  std::vector<int> changedCells;
+  std::vector<Obstacle> obstacles;
+
+  // The state of D* Lite
+  int startCell = -1;
+  int goalCell = -1; /**< The cell of the destination, -1 if the search has to be restarted. */
+  float keyModifier = 0.f;
+  std::vector<float> g;
+  std::vector<float> rhs;
+  std::vector<Key> queuedKeys; /**< The key each open cell was queued with last. */
+  std::vector<char> open; /**< Is a cell in the priority queue? Outdated entries of the queue are skipped. */
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+
+  std::vector<int> pathCells;
+
+  void update(Path& path);
+
+  /**
+   * Collects the obstacles that are added to the costmap.
+   * @param destination The destination, which is moved out of the center circle if the robot must not enter it.
+   */
+  void collectObstacles(Pose2f& destination);
+
+  /** Adapts the size of the costmap to the field dimensions and the cell size. */
+  void resizeCostmap();
+
+  /** Computes the costs of all cells and collects the cells whose costs changed notably. */
+  void updateCosts();
+
+  void restartSearch(int start, int goal);
+  void updateVertex(int cell);
+  void computeShortestPath();
+
+  /** Builds the waypoints along the planned cells, replacing parts of them by cheap straight lines. */
+  void buildPath(Path& path, const Pose2f& destination);
+
+  /** Determines the cost of the straight line between two positions relative to the cell size. */
+  float getLineCost(const Vector2f& from, const Vector2f& to) const;
+
+  void draw() const;
+
+  Key calculateKey(const int cell) const
+  {
+    const float minimum = std::min(g[cell], rhs[cell]);
+    return {minimum + heuristic(startCell, cell) + keyModifier, minimum};
+  }
+
+  void enqueue(const int cell, const Key& key)
+  {
+    queuedKeys[cell] = key;
+    open[cell] = true;
+    queue.push({key, cell});
+  }
+
+  /**
+   * The octile distance between two cells, which is a lower bound of the cost since no cell costs less than one.
+   * It is slightly reduced, because otherwise rounding errors can break the ties between the keys of the start
+   * and of cells on the optimal path, which ends the search too early.
+   */
+  float heuristic(const int a, const int b) const
+  {
+    const int dx = std::abs(a / numOfCellsY - b / numOfCellsY);
+    const int dy = std::abs(a % numOfCellsY - b % numOfCellsY);
+    return 0.999f * (static_cast<float>(std::max(dx, dy)) + (std::sqrt(2.f) - 1.f) * static_cast<float>(std::min(dx, dy)));
+  }
+
+  float edgeCost(const int a, const int b) const
+  {
+    const bool diagonal = a / numOfCellsY != b / numOfCellsY && a % numOfCellsY != b % numOfCellsY;
+    return (diagonal ? std::sqrt(2.f) : 1.f) * (costs[a] + costs[b]) / 2.f;
+  }
+
+  template <typename Function> void forEachNeighbor(const int cell, Function function) const
+  {
+    const int x = cell / numOfCellsY;
+    const int y = cell % numOfCellsY;
+    for (int nx = std::max(0, x - 1); nx <= std::min(numOfCellsX - 1, x + 1); ++nx)
+      for (int ny = std::max(0, y - 1); ny <= std::min(numOfCellsY - 1, y + 1); ++ny)
+        if (nx != x || ny != y)
+          function(nx * numOfCellsY + ny);
+  }
+
+  int getCell(const Vector2f& position) const
+  {
+    const int x = std::clamp(static_cast<int>((position.x() - origin.x()) / cellSize), 0, numOfCellsX - 1);
+    const int y = std::clamp(static_cast<int>((position.y() - origin.y()) / cellSize), 0, numOfCellsY - 1);
+    return x * numOfCellsY + y;
+  }
+
+  Vector2f getCellCenter(const int cell) const
+  {
+    return origin + Vector2f((static_cast<float>(cell / numOfCellsY) + 0.5f) * cellSize, (static_cast<float>(cell % numOfCellsY) + 0.5f) * cellSize);
+  }
+};
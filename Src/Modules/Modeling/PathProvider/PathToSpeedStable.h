@@ -21,6 +21,7 @@
 #include "Representations/MotionControl/WalkingEngineParams.h"
 #include "SimplePathProvider.h" // for parameters
 #include "Tools/Module/Module.h"
+#include "Tools/RingBufferWithStatistics.h"
 
 MODULE(PathToSpeedStable,
   REQUIRES(BallSymbols),
@@ -84,8 +85,8 @@ public:
   PathToSpeedStable();
 
 private:
-  std::array<RingBufferWithSum<Angle, 12>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
-  std::array<RingBufferWithSum<Angle, 12>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
+  std::array<RingBufferWithStatistics<Angle, 12>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
+  std::array<RingBufferWithStatistics<Angle, 12>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
   PathFollowState state = far;
   bool inDribbling = false;
   bool atBall = false;
@@ -8,6 +8,9 @@
 #include "Predictor.h"
 #include "Tools/Math/Transformation.h"
 #include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Modeling/BallPhysics.h"
+#include "Platform/SystemCall.h"
+#include <algorithm>
 
 /** 
 * The method provides the robot pose after preview.
@@ -27,16 +30,7 @@ void Predictor::update(RobotPoseAfterPreview& robotPoseAfterPreview)
 */
 void Predictor::update(BallModelAfterPreview& ballModelAfterPreview)
 {
-  static_cast<BallModel&>(ballModelAfterPreview) = theBallModel;
-
-  Vector2f position, velocity;
-
-  position = Transformation::robotToField(theRobotPose, theBallModel.estimate.position);
-  velocity = theBallModel.estimate.getVelocityInFieldCoordinates(theRobotPose);
-  ballModelAfterPreview.estimate.setPositionAndVelocityFromFieldCoordinates(position, velocity, (RobotPose&)robotPoseAfterPreview);
-
-  position = Transformation::robotToField(theRobotPose, theBallModel.lastPerception);
-  ballModelAfterPreview.lastPerception = Transformation::fieldToRobot(robotPoseAfterPreview, position);
+  predict(theBallModel, ballModelAfterPreview);
 }
 
 /**
@@ -49,17 +43,26 @@ void Predictor::update(MultipleBallModelAfterPreview& multipleBallModelAfterPrev
 
   for (const BallModel& bm : theMultipleBallModel.ballModels)
   {
-    BallModel lbm = bm;
-    Vector2f position, velocity;
+    multipleBallModelAfterPreview.ballModels.emplace_back();
+    predict(bm, multipleBallModelAfterPreview.ballModels.back());
+  }
+}
 
-    position = Transformation::robotToField(theRobotPose, bm.estimate.position);
-    velocity = bm.estimate.getVelocityInFieldCoordinates(theRobotPose);
-    lbm.estimate.setPositionAndVelocityFromFieldCoordinates(position, velocity, (RobotPose&)robotPoseAfterPreview);
+void Predictor::predict(const BallModel& ballModel, BallModel& ballModelAfterPreview) const
+{
+  ballModelAfterPreview = ballModel;
 
-    position = Transformation::robotToField(theRobotPose, bm.lastPerception);
-    lbm.lastPerception = Transformation::fieldToRobot(robotPoseAfterPreview, position);
-    multipleBallModelAfterPreview.ballModels.push_back(lbm);
-  }
+  Vector2f position, velocity;
+
+  position = Transformation::robotToField(theRobotPose, ballModel.estimate.position);
+  velocity = ballModel.estimate.getVelocityInFieldCoordinates(theRobotPose);
+  // the ball keeps rolling while the frame is processed and the motion request waits for Motion
+  if (latency > 0.f && ballModel.friction < 0.f)
+    BallPhysics::propagateBallPositionAndVelocity(position, velocity, latency, ballModel.friction);
+  ballModelAfterPreview.estimate.setPositionAndVelocityFromFieldCoordinates(position, velocity, (RobotPose&)robotPoseAfterPreview);
+
+  position = Transformation::robotToField(theRobotPose, ballModel.lastPerception);
+  ballModelAfterPreview.lastPerception = Transformation::fieldToRobot(robotPoseAfterPreview, position);
 }
 
 
@@ -68,6 +71,13 @@ void Predictor::execute(tf::Subflow& subflow)
   correctedOdometryOffset = theMotionInfo.offsetToRobotPoseAfterPreview;
   static_cast<Pose2f&>(robotPoseAfterPreview) = theRobotPose + correctedOdometryOffset;
 
+  // The frame time is the time stamp of the image. Only on the robot, it is comparable to the time now.
+  int imageAge = 0;
+  if (SystemCall::getMode() == SystemCall::physicalRobot)
+    imageAge = std::max(SystemCall::getRealTimeSince(theFrameInfo.time), 0);
+  latency = compensateLatency ? static_cast<float>(std::min(imageAge + consumptionDelay, maxLatency)) / 1000.f : 0.f;
+  PLOT("module:Predictor:latency", latency * 1000.f);
+
   PLOT("module:Predictor:robotPose.x", theRobotPose.translation.x());
   PLOT("module:Predictor:robotPose.y", theRobotPose.translation.y());
   PLOT("module:Predictor:robotPose.r", theRobotPose.rotation);
@@ -24,7 +24,12 @@ MODULE(Predictor,
   PROVIDES(RobotPoseAfterPreview),
   PROVIDES(BallModelAfterPreview),
   PROVIDES(MultipleBallModelAfterPreview),
-  HAS_PREEXECUTION
+  HAS_PREEXECUTION,
+  LOADS_PARAMETERS(,
+    (bool)(true) compensateLatency, /**< Propagate the balls by the time from taking the image until the motion request is executed? */
+    (int)(20) consumptionDelay, /**< The time (in ms) from running this module until Motion executes the resulting motion request. */
+    (int)(200) maxLatency /**< The latency (in ms) is limited to this, e.g. after the process was stalled. */
+  )
 );
 
 
@@ -57,7 +62,15 @@ public:
   */
   void execute(tf::Subflow&);
 
+  /**
+  * Converts a ball model to the robot pose after preview and propagates it by the latency.
+  * @param ballModel The ball model relative to the current robot pose.
+  * @param ballModelAfterPreview The ball model that is updated.
+  */
+  void predict(const BallModel& ballModel, BallModel& ballModelAfterPreview) const;
+
   Pose2f correctedOdometryOffset;
+  float latency = 0.f; /**< The time (in s) from taking the current image until the motion request is executed. */
   RobotPoseAfterPreview robotPoseAfterPreview;
 };
 
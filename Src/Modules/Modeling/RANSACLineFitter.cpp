@@ -1,11 +1,12 @@
 #include "RANSACLineFitter.h"
-#include "Tools/Math/Random.h"
+#include "Tools/Math/FastMath.h"
 #include <numeric>
 
 RANSACLineFitter::RANSACLineFitter() {}
 
-void RANSACLineFitter::setParameters(const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking)
+void RANSACLineFitter::setParameters(const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking, unsigned int seed)
 {
+  this->seed = seed;
   if (!initialized || this->anglePrecision != anglePrecision || this->distancePrecision != distancePrecision || this->threshold != minPointsForLine || this->thresholdWalking != minPointsForLineWalking)
   {
     this->anglePrecision = anglePrecision;
@@ -59,77 +60,52 @@ bool RANSACLineFitter::execute(const RingBuffer<std::vector<BallPercept>, BALLPE
     }
   }
 
-  int indexBase = 0;
-  int indexDirection = 0;
-
-  std::vector<const BallPercept*> inliers;
-  unsigned numOfInliers = 0;
-  float summedDistanceInliers = 0.f;
-
-  std::vector<const BallPercept*> outliers;
-  unsigned numOfOutliers = 0;
-  float summedDistanceOutliers = 0.f;
-
   unsigned numOfBPs = static_cast<unsigned>(allBPs.size());
   if (numOfBPs < (isWalking ? thresholdWalking : threshold))
     return false;
 
-  unsigned bestNoOfInliers = 0;
-  Geometry::Line bestLine;
+  // All lines start at the first percept, the others are sampled by descending validity.
+  std::stable_sort(allBPs.begin() + 1, allBPs.end(), [](const BallPercept* first, const BallPercept* second) { return first->validity > second->validity; });
+  std::vector<Vector2f> positions;
+  positions.reserve(numOfBPs);
+  for (const BallPercept* bp : allBPs)
+    positions.push_back(bp->relativePositionOnField);
+
+  if (seed)
+    ransac.seed(seed + allBPs.front()->timestamp);
+  ransac.setPoints(positions);
+  LineRANSAC::Parameters parameters;
+  parameters.maxDistance = static_cast<float>(distancePrecision);
+  parameters.maxIterations = numOfBPs;
+  parameters.fixedBase = true;
+  parameters.progressive = true;
+  const LineRANSAC::Result result = ransac.fit(parameters);
+  if (!result.numOfInliers)
+    return false;
+
+  Geometry::Line bestLine = result.line;
   std::vector<const BallPercept*> bestInliers;
   std::vector<const BallPercept*> bestOutliers;
   float bestSummedDistanceInliers = 0.f;
   float bestSummedDistanceOutliers = 0.f;
 
-  for (unsigned round = 0; round < numOfBPs; round++)
+  std::vector<float> distancesToLine(numOfBPs);
+  Geometry::getDistanceToLine(bestLine, positions, distancesToLine);
+  for (unsigned i = 0; i < numOfBPs; i++)
   {
-    numOfInliers = 0;
-    numOfOutliers = 0;
-    summedDistanceInliers = 0.f;
-    summedDistanceOutliers = 0.f;
-    inliers.clear();
-    outliers.clear();
-
-    //indexBase = random(numOfBPs);
-    indexBase = 0;
-    indexDirection = random(numOfBPs);
-    while (indexBase == indexDirection)
-      indexDirection = random(numOfBPs);
-
-    Geometry::Line testLine;
-    testLine.base = allBPs.at(indexBase)->relativePositionOnField;
-    testLine.direction = allBPs.at(indexDirection)->relativePositionOnField - allBPs.at(indexBase)->relativePositionOnField;
-
-    for (unsigned i = 0; i < numOfBPs; i++)
+    float distanceToLine = std::abs(distancesToLine[i]);
+    if (distanceToLine < static_cast<float>(distancePrecision))
     {
-      float distanceToLine = std::abs(Geometry::getDistanceToLine(testLine, allBPs.at(i)->relativePositionOnField));
-      if (distanceToLine < static_cast<float>(distancePrecision))
-      {
-        summedDistanceInliers += distanceToLine;
-        numOfInliers++;
-        inliers.push_back(allBPs.at(i));
-      }
-      else
-      {
-        summedDistanceOutliers += distanceToLine;
-        numOfOutliers++;
-        outliers.push_back(allBPs.at(i));
-      }
+      bestSummedDistanceInliers += distanceToLine;
+      bestInliers.push_back(allBPs.at(i));
     }
-
-    if (numOfInliers > bestNoOfInliers || (numOfInliers == bestNoOfInliers && summedDistanceInliers < bestSummedDistanceInliers))
+    else
     {
-      bestNoOfInliers = numOfInliers;
-      bestLine = testLine;
-      bestInliers = inliers;
-      bestOutliers = outliers;
-      bestSummedDistanceInliers = summedDistanceInliers;
-      bestSummedDistanceOutliers = summedDistanceOutliers;
+      bestSummedDistanceOutliers += distanceToLine;
+      bestOutliers.push_back(allBPs.at(i));
     }
-
-    if (numOfInliers >= BALLPERCEPT_BUFFER_LENGTH)
-      break;
   }
+  const unsigned bestNoOfInliers = static_cast<unsigned>(bestInliers.size());
 
   float meanDistanceInliers = (bestInliers.size() == 0 ? 0.f : bestSummedDistanceInliers / bestInliers.size());
   float meanDistanceOutliers = (bestOutliers.size() == 0 ? 0.f : bestSummedDistanceOutliers / bestOutliers.size());
@@ -237,7 +213,7 @@ bool RANSACLineFitter::execute(const RingBuffer<std::vector<BallPercept>, BALLPE
 Vector2a RANSACLineFitter::getAngles(const Vector2f& relativePosition, const CameraMatrix& cameraMatrix)
 {
   Vector2a angles;
-  angles.x() = std::atan2(relativePosition.y(), relativePosition.x());
-  angles.y() = std::atan2(cameraMatrix.translation.z(), relativePosition.norm());
+  angles.x() = FastMath::atan2(relativePosition.y(), relativePosition.x());
+  angles.y() = FastMath::atan2(cameraMatrix.translation.z(), relativePosition.norm());
   return angles;
 }
@@ -1,6 +1,7 @@
 #include "Tools/Math/Angle.h"
 #include "Representations/Perception/BallPercept.h"
 #include "Representations/Perception/CameraMatrix.h"
+#include "Tools/Math/LineRANSAC.h"
 
 #define BALLPERCEPT_BUFFER_LENGTH 30
 
@@ -9,7 +10,16 @@ class RANSACLineFitter
 public:
   RANSACLineFitter();
 
-  void setParameters(const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking);
+  /**
+   * Sets the parameters.
+   * @param anglePrecision Percepts seen in about the same direction as another one are ignored.
+   * @param distancePrecision Percepts closer to a line than this are its inliers.
+   * @param minPointsForLine The number of inliers required for a line.
+   * @param minPointsForLineWalking The number of inliers required for a line while walking.
+   * @param seed If not 0, the sampling is seeded with this value and the time stamp of the
+   *             newest percept, so that replaying a log file gives the same results.
+   */
+  void setParameters(const Angle anglePrecision, const unsigned int distancePrecision, unsigned int minPointsForLine, unsigned int minPointsForLineWalking, unsigned int seed = 0);
   void reset();
   bool execute(const RingBuffer<std::vector<BallPercept>, BALLPERCEPT_BUFFER_LENGTH>& bpr, const CameraMatrix& cameraMatrix, bool isWalking, BallPercept& rollingBall, Vector2f& velocity);
 
@@ -18,6 +28,8 @@ private:
   Angle anglePrecision;
   unsigned int distancePrecision = 0;
   unsigned int threshold = 0, thresholdWalking = 0;
+  unsigned int seed = 0;
+  LineRANSAC ransac;
 
   static bool sortDistance(const BallPercept* first, const BallPercept* second, const Vector2f& base)
   {
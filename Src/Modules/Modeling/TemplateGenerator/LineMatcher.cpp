@@ -50,6 +50,7 @@ inline void LineMatcher::preExecuteInit(LineMatchingResult& theLineMatchingResul
   if (!preInitDone || lastFieldDimensionsUpdate != theFieldDimensions.lastUpdate)
   {
     lastFieldDimensionsUpdate = theFieldDimensions.lastUpdate;
+    lastResultValid = false;
 
     // initialize stuff
     fieldLinesX.clear();
@@ -255,11 +256,17 @@ void LineMatcher::execute(LineMatchingResult& theLineMatchingResult)
 
   doGlobalDebugging();
 
+  if (reuseLastResult(theLineMatchingResult))
+    return;
 
   mainDirection = determineMainDirection();
 
   buildLineClusters(theLineMatchingResult);
 
+  searchStart = std::chrono::steady_clock::now();
+  searchSteps = 0;
+  searchAborted = false;
+
   if (linesInMainDirection.size() > 0 && lines90DegreeToMainDirection.size() > 0)
   {
     findPossiblePositions(theLineMatchingResult);
@@ -269,6 +276,41 @@ void LineMatcher::execute(LineMatchingResult& theLineMatchingResult)
     findPossiblePoseIntervals(theLineMatchingResult);
     theLineMatchingResult.onlyObservedOneFieldLine = (linesInMainDirection.size() + lines90DegreeToMainDirection.size()) == 1;
   }
+
+  // an aborted search might have missed poses, so it is not reused
+  lastResultValid = !searchAborted;
+  lastObservations = theLineMatchingResult.observations;
+  lastPoseHypothesis = theLineMatchingResult.poseHypothesis;
+  lastPoseHypothesisIntervals = theLineMatchingResult.poseHypothesisIntervals;
+  lastOnlyObservedOneFieldLine = theLineMatchingResult.onlyObservedOneFieldLine;
+}
+
+bool LineMatcher::reuseLastResult(LineMatchingResult& theLineMatchingResult)
+{
+  if (!lastResultValid || theLineMatchingResult.observations.empty() || theLineMatchingResult.observations.size() != lastObservations.size())
+    return false;
+
+  // the observations are relative to the robot, so the poses only stay the same if the robot did not move
+  const double maxDifference = parameters.maxObservationDifferenceForReuse;
+  for (size_t i = 0; i < lastObservations.size(); i++)
+  {
+    const LineMatchingResult::FieldLine& observation = theLineMatchingResult.observations[i];
+    if ((observation.start - lastObservations[i].start).norm() > maxDifference || (observation.end - lastObservations[i].end).norm() > maxDifference)
+      return false;
+  }
+
+  theLineMatchingResult.poseHypothesis = lastPoseHypothesis;
+  theLineMatchingResult.poseHypothesisIntervals = lastPoseHypothesisIntervals;
+  theLineMatchingResult.onlyObservedOneFieldLine = lastOnlyObservedOneFieldLine;
+  return true;
+}
+
+bool LineMatcher::isSearchTimeExceeded()
+{
+  // reading the clock is not for free, so it is only done every few steps
+  if (!searchAborted && (++searchSteps & 63) == 0)
+    searchAborted = std::chrono::steady_clock::now() - searchStart > std::chrono::microseconds(parameters.maxSearchTime);
+  return searchAborted;
 }
 
 double LineMatcher::determineMainDirection()
@@ -440,31 +482,55 @@ void LineMatcher::findPossiblePositions(LineMatchingResult& theLineMatchingResul
 
   counterForDrawing = 0;
 
-  int conflictingPosition; // needed later when checking possible correspondences
-
   // test for 0°, 90°, 180°, 270° rotation
   Pose2f poseHypothesis(static_cast<float>(-mainDirection));
-  for (int i = 0; i < 4; i++)
+  for (int i = 0; i < 4 && !searchAborted; i++)
   {
     resetToStartingCorrespondences();
-    do
-    {
-      bool isValidCorrespondenceChoice = checkCombinatorialValidityOfCorrespondences(totalNumberOfObservedLines, conflictingPosition);
-      if (isValidCorrespondenceChoice)
-      {
-        isValidCorrespondenceChoice = checkGeometricValidityOfCorrespondences(totalNumberOfObservedLines, conflictingPosition, poseHypothesis);
-        if (isValidCorrespondenceChoice)
-        {
-          conflictingPosition = totalNumberOfObservedLines - 1;
-          addPoseToLineMatchingResult(poseHypothesis, theLineMatchingResult);
-        }
-      }
-    } while (getNextCorrespondenceCombination(totalNumberOfObservedLines, conflictingPosition));
+    std::fill(alreadyAssignedFieldLinesX.begin(), alreadyAssignedFieldLinesX.end(), false);
+    std::fill(alreadyAssignedFieldLinesY.begin(), alreadyAssignedFieldLinesY.end(), false);
+    searchCorrespondences(0, totalNumberOfObservedLines, poseHypothesis, theLineMatchingResult);
     rotateObservationsBy90Degree();
     poseHypothesis.rotation += pi_2;
   }
 }
 
+void LineMatcher::searchCorrespondences(int position, int totalNumberOfObservedLines, Pose2f& poseHypothesis, LineMatchingResult& theLineMatchingResult)
+{
+  if (position == totalNumberOfObservedLines)
+  {
+    addPoseToLineMatchingResult(poseHypothesis, theLineMatchingResult);
+    return;
+  }
+
+  const bool isXLine = correspondenceInMainDirectionClass[position];
+  std::vector<bool>& alreadyAssignedFieldLines = isXLine ? alreadyAssignedFieldLinesX : alreadyAssignedFieldLinesY;
+  const int numberOfFieldLines = isXLine ? numberOfFieldLinesX : numberOfFieldLinesY;
+  for (int fieldLine = 0; fieldLine < numberOfFieldLines && !isSearchTimeExceeded(); fieldLine++)
+  {
+    // each field line can only correspond to one observation
+    if (alreadyAssignedFieldLines[fieldLine])
+      continue;
+    correspondences[position] = fieldLine;
+
+    if (position == 1)
+    {
+      // use the first two correspondences (which are of different classes) to uniquely determine the position
+      // first is always mainDirection which corresponds to x-lines (side line etc.)
+      poseHypothesis.translation.x() = static_cast<float>(lines90DegreeToMainDirection[0].offset - fieldLinesY[correspondences[1]].offset);
+      poseHypothesis.translation.y() = static_cast<float>(fieldLinesX[correspondences[0]].offset - linesInMainDirection[0].offset);
+      if (!doesCorrespondenceFit(0, poseHypothesis) || !doesCorrespondenceFit(1, poseHypothesis))
+        continue;
+    }
+    else if (position > 1 && !doesCorrespondenceFit(position, poseHypothesis))
+      continue;
+
+    alreadyAssignedFieldLines[fieldLine] = true;
+    searchCorrespondences(position + 1, totalNumberOfObservedLines, poseHypothesis, theLineMatchingResult);
+    alreadyAssignedFieldLines[fieldLine] = false;
+  }
+}
+
 void LineMatcher::resetToStartingCorrespondences()
 {
   // The first two should come from different classes.
@@ -528,102 +594,6 @@ void LineMatcher::rotateObservationsBy90Degree()
   }
 }
 
-bool LineMatcher::getNextCorrespondenceCombination(int totalNumberOfObservedLines, int conflictingPosition)
-{
-  // find position to increment
-  int index;
-  for (index = conflictingPosition; index >= 0; index--)
-  {
-    // is it possible to increment this position?
-    if ((correspondenceInMainDirectionClass[index] && correspondences[index] + 1 < numberOfFieldLinesX) // we search for a x-line correspondence
-        || (!correspondenceInMainDirectionClass[index] && correspondences[index] + 1 < numberOfFieldLinesY) // we search for a y-line correspondence
-    )
-    {
-      break; // possible position found!
-    }
-    // else: try the next (more significant, i.e. i--) position
-  }
-  if (index < 0)
-  {
-    // nothing left to increase, we are done.
-    return false;
-  }
-  else
-  {
-    correspondences[index]++;
-    index++;
-
-    // At least we can do something besides the trivial filling up with zeros...
-    // TODO: Think of something clever to avoid double correspondences/associations
-    //       with the previous positions.
-    //       (Checking all the previous fields using alreadyAssignedFieldLinesX seems overkill/inefficient)
-    int i = 0; // mainDirection class
-    int j = 0; // non-mainDirection class
-    for (; index < totalNumberOfObservedLines; index++)
-    {
-      if (correspondenceInMainDirectionClass[index])
-      {
-        correspondences[index] = i;
-        i++;
-      }
-      else
-      {
-        correspondences[index] = j;
-        j++;
-      }
-    }
-    // found another correspondence combination
-    return true;
-  }
-}
-
-bool LineMatcher::checkCombinatorialValidityOfCorrespondences(int totalNumberOfObservedLines, int& conflictingPosition)
-{
-  // reset the "already used" fields
-  for (int i = 0; i < numberOfFieldLinesX; i++)
-  {
-    alreadyAssignedFieldLinesX[i] = false;
-  }
-  for (int i = 0; i < numberOfFieldLinesY; i++)
-  {
-    alreadyAssignedFieldLinesY[i] = false;
-  }
-
-  // check for "double associations" first (i.e. combinatorial validity)
-  for (int i = 0; i < totalNumberOfObservedLines; i++)
-  {
-    if (correspondenceInMainDirectionClass[i])
-    {
-      // test for assignment in x
-      if (alreadyAssignedFieldLinesX[correspondences[i]])
-      {
-        conflictingPosition = i;
-        return false;
-      }
-      else
-      {
-        alreadyAssignedFieldLinesX[correspondences[i]] = true;
-      } // ok so far, test the next one...
-    }
-    else
-    {
-      // test for assignment in y
-      if (alreadyAssignedFieldLinesY[correspondences[i]])
-      {
-        conflictingPosition = i;
-        return false;
-      }
-      else
-      {
-        alreadyAssignedFieldLinesY[correspondences[i]] = true;
-      } // ok so far, test the next one...
-    }
-  }
-  // passed the "double correspondences" test, so this might be a legal combination
-  conflictingPosition = totalNumberOfObservedLines - 1; // last position, just in case somebody uses it even for "return true"
-  return true;
-}
-
 bool LineMatcher::doesObservationFitModel(const AbstractLine& observationInRelativeCoords, const AbstractLine& modelInRelativeCoords)
 {
   // check the distances of the line
@@ -650,51 +620,28 @@ bool LineMatcher::doesObservationFitModel(const AbstractLine& observationInRelat
 }
 
 
-bool LineMatcher::checkGeometricValidityOfCorrespondences(int totalNumberOfObservedLines, int& conflictingPosition, Pose2f& poseHypothesis)
+bool LineMatcher::doesCorrespondenceFit(int position, const Pose2f& poseHypothesis)
 {
-  // use the first two correspondences (which are of different classes) to uniquely determine the position
-  // first is always mainDirection which corresponds to x-lines (side line etc.)
-
-  const AbstractLine& xLineOnField = fieldLinesX[correspondences[0]];
-  const AbstractLine& yLineOnField = fieldLinesY[correspondences[1]];
-  const AbstractLine& xLineObserved = linesInMainDirection[0];
-  const AbstractLine& yLineObserved = lines90DegreeToMainDirection[0];
-
-  poseHypothesis.translation.x() = static_cast<float>(yLineObserved.offset - yLineOnField.offset);
-  poseHypothesis.translation.y() = static_cast<float>(xLineOnField.offset - xLineObserved.offset);
-
-  // now check the geometric plausibility
-  for (int i = 0; i < totalNumberOfObservedLines; i++)
-  {
-    const AbstractLine& observationInRelativeCoords =
-        correspondenceInMainDirectionClass[i] ? linesInMainDirection[correspondenceIndexOfOrigin[i]] : lines90DegreeToMainDirection[correspondenceIndexOfOrigin[i]];
-    AbstractLine modelInRelativeCoords;
-    if (correspondenceInMainDirectionClass[i])
-    { // x line
-      modelInRelativeCoords = fieldLinesX[correspondences[i]];
-      // make is relative
-      modelInRelativeCoords.offset -= poseHypothesis.translation.y();
-      modelInRelativeCoords.min -= poseHypothesis.translation.x();
-      modelInRelativeCoords.max -= poseHypothesis.translation.x();
-    }
-    else
-    { // y line
-      modelInRelativeCoords = fieldLinesY[correspondences[i]];
-      // make is relative
-      modelInRelativeCoords.offset += poseHypothesis.translation.x();
-      modelInRelativeCoords.min -= poseHypothesis.translation.y();
-      modelInRelativeCoords.max -= poseHypothesis.translation.y();
-    }
-    if (!doesObservationFitModel(observationInRelativeCoords, modelInRelativeCoords))
-    {
-      // does not fit. -> Conflict found.
-      conflictingPosition = std::max(i, 1);
-      return false;
-    }
+  const AbstractLine& observationInRelativeCoords = correspondenceInMainDirectionClass[position] ? linesInMainDirection[correspondenceIndexOfOrigin[position]]
+                                                                                                : lines90DegreeToMainDirection[correspondenceIndexOfOrigin[position]];
+  AbstractLine modelInRelativeCoords;
+  if (correspondenceInMainDirectionClass[position])
+  { // x line
+    modelInRelativeCoords = fieldLinesX[correspondences[position]];
+    // make is relative
+    modelInRelativeCoords.offset -= poseHypothesis.translation.y();
+    modelInRelativeCoords.min -= poseHypothesis.translation.x();
+    modelInRelativeCoords.max -= poseHypothesis.translation.x();
   }
-  // passed all tests! Yeah!  :-D
-  conflictingPosition = totalNumberOfObservedLines - 1;
-  return true;
+  else
+  { // y line
+    modelInRelativeCoords = fieldLinesY[correspondences[position]];
+    // make is relative
+    modelInRelativeCoords.offset += poseHypothesis.translation.x();
+    modelInRelativeCoords.min -= poseHypothesis.translation.y();
+    modelInRelativeCoords.max -= poseHypothesis.translation.y();
+  }
+  return doesObservationFitModel(observationInRelativeCoords, modelInRelativeCoords);
 }
 
 void LineMatcher::addPoseToLineMatchingResult(const Pose2f& pose, LineMatchingResult& theLineMatchingResult)
@@ -759,26 +706,14 @@ void LineMatcher::findPossiblePoseIntervals(LineMatchingResult& theLineMatchingR
 
   counterForDrawing = 0;
 
-  int conflictingPosition; // needed later when checking possible correspondences
-
   // test for 0°, 90°, 180°, 270° rotation
   Pose2f poseIntervalHypothesisStart(static_cast<float>(-mainDirection)), poseIntervalHypothesisEnd(static_cast<float>(-mainDirection));
-  for (int i = 0; i < 4; i++)
+  for (int i = 0; i < 4 && !searchAborted; i++)
   {
     resetToStartingCorrespondencesForIntervals();
-    do
-    {
-      bool isValidCorrespondenceChoice = checkCombinatorialValidityOfCorrespondences(totalNumberOfObservedLines, conflictingPosition);
-      if (isValidCorrespondenceChoice)
-      {
-        isValidCorrespondenceChoice = checkGeometricValidityOfCorrespondencesForIntervals(totalNumberOfObservedLines, conflictingPosition, poseIntervalHypothesisStart, poseIntervalHypothesisEnd);
-        if (isValidCorrespondenceChoice)
-        {
-          conflictingPosition = totalNumberOfObservedLines - 1;
-          addPoseIntervalToLineMatchingResult(poseIntervalHypothesisStart, poseIntervalHypothesisEnd, theLineMatchingResult);
-        }
-      }
-    } while (getNextCorrespondenceCombination(totalNumberOfObservedLines, conflictingPosition));
+    std::fill(alreadyAssignedFieldLinesX.begin(), alreadyAssignedFieldLinesX.end(), false);
+    std::fill(alreadyAssignedFieldLinesY.begin(), alreadyAssignedFieldLinesY.end(), false);
+    searchCorrespondencesForIntervals(0, totalNumberOfObservedLines, 0.0, 0.0, 0.0, poseIntervalHypothesisStart, poseIntervalHypothesisEnd, theLineMatchingResult);
     rotateObservationsBy90Degree();
     poseIntervalHypothesisStart.rotation += pi_2;
     poseIntervalHypothesisEnd.rotation += pi_2;
@@ -803,53 +738,76 @@ void LineMatcher::resetToStartingCorrespondencesForIntervals()
   }
 }
 
-bool LineMatcher::checkGeometricValidityOfCorrespondencesForIntervals(int totalNumberOfObservedLines, int& conflictingPosition, Pose2f& poseIntervalHypothesisStart, Pose2f& poseIntervalHypothesisEnd)
+void LineMatcher::searchCorrespondencesForIntervals(int position,
+    int totalNumberOfObservedLines,
+    double positionPerpendicularToLineDirection,
+    double minPositionInLineDirection,
+    double maxPositionInLineDirection,
+    Pose2f& poseIntervalHypothesisStart,
+    Pose2f& poseIntervalHypothesisEnd,
+    LineMatchingResult& theLineMatchingResult)
 {
   // This is relatively easy, we only have to distinguish between the observation classes
   // at the end of this procedure to calculate poseIntervalHypothesisStart/poseIntervalHypothesisEnd.
   // The validity check can mostly be done without that knowledge.
   bool allObservatiosInMainClass = linesInMainDirection.size() > 0;
-  const std::vector<AbstractLine>& lineObservations = allObservatiosInMainClass ? linesInMainDirection : lines90DegreeToMainDirection;
-  int n = static_cast<int>(lineObservations.size());
-  const std::vector<AbstractLine>& fieldLines = allObservatiosInMainClass ? fieldLinesX : fieldLinesY;
-
-  double positionPerpendicularToLineDirection = fieldLines[correspondences[0]].offset - lineObservations[0].offset;
-  double minPositionInLineDirection = fieldLines[correspondences[0]].min - lineObservations[0].min - parameters.absoluteAllowedDistanceErrorForLineClustering;
-  double maxPositionInLineDirection = fieldLines[correspondences[0]].max - lineObservations[0].max + parameters.absoluteAllowedDistanceErrorForLineClustering;
 
-  for (int i = 0; i < n; i++)
+  if (position == totalNumberOfObservedLines)
   {
-    AbstractLine modelInRelativeCoords = fieldLines[correspondences[i]];
-    // make is relative
-    modelInRelativeCoords.offset -= positionPerpendicularToLineDirection;
-
-    if (!doesObservationFitModelForInterval(lineObservations[i], modelInRelativeCoords, minPositionInLineDirection, maxPositionInLineDirection))
+    // build the interval poses
+    if (allObservatiosInMainClass)
     {
-      // does not fit. -> Conflict found.
-      conflictingPosition = i;
-      return false;
+      poseIntervalHypothesisStart.translation.y() = static_cast<float>(positionPerpendicularToLineDirection);
+      poseIntervalHypothesisEnd.translation.y() = static_cast<float>(positionPerpendicularToLineDirection);
+      poseIntervalHypothesisStart.translation.x() = static_cast<float>(minPositionInLineDirection);
+      poseIntervalHypothesisEnd.translation.x() = static_cast<float>(maxPositionInLineDirection);
+    }
+    else
+    {
+      poseIntervalHypothesisStart.translation.x() = static_cast<float>(-positionPerpendicularToLineDirection);
+      poseIntervalHypothesisEnd.translation.x() = static_cast<float>(-positionPerpendicularToLineDirection);
+      poseIntervalHypothesisStart.translation.y() = static_cast<float>(minPositionInLineDirection);
+      poseIntervalHypothesisEnd.translation.y() = static_cast<float>(maxPositionInLineDirection);
     }
+    addPoseIntervalToLineMatchingResult(poseIntervalHypothesisStart, poseIntervalHypothesisEnd, theLineMatchingResult);
+    return;
   }
-  // passed all tests! Yeah!  :-D
 
-  // build the interval poses
-  if (allObservatiosInMainClass)
-  {
-    poseIntervalHypothesisStart.translation.y() = static_cast<float>(positionPerpendicularToLineDirection);
-    poseIntervalHypothesisEnd.translation.y() = static_cast<float>(positionPerpendicularToLineDirection);
-    poseIntervalHypothesisStart.translation.x() = static_cast<float>(minPositionInLineDirection);
-    poseIntervalHypothesisEnd.translation.x() = static_cast<float>(maxPositionInLineDirection);
-  }
-  else
-  {
-    poseIntervalHypothesisStart.translation.x() = static_cast<float>(-positionPerpendicularToLineDirection);
-    poseIntervalHypothesisEnd.translation.x() = static_cast<float>(-positionPerpendicularToLineDirection);
-    poseIntervalHypothesisStart.translation.y() = static_cast<float>(minPositionInLineDirection);
-    poseIntervalHypothesisEnd.translation.y() = static_cast<float>(maxPositionInLineDirection);
-  }
+  const std::vector<AbstractLine>& lineObservations = allObservatiosInMainClass ? linesInMainDirection : lines90DegreeToMainDirection;
+  const std::vector<AbstractLine>& fieldLines = allObservatiosInMainClass ? fieldLinesX : fieldLinesY;
+  std::vector<bool>& alreadyAssignedFieldLines = allObservatiosInMainClass ? alreadyAssignedFieldLinesX : alreadyAssignedFieldLinesY;
+  const AbstractLine& observation = lineObservations[position];
+
+  for (int fieldLine = 0; fieldLine < static_cast<int>(fieldLines.size()) && !isSearchTimeExceeded(); fieldLine++)
+  {
+    // each field line can only correspond to one observation
+    if (alreadyAssignedFieldLines[fieldLine])
+      continue;
+    correspondences[position] = fieldLine;
+
+    // the first correspondence determines the position perpendicular to the lines and the initial interval,
+    // all others can only shrink the interval
+    double perpendicularPosition = positionPerpendicularToLineDirection;
+    double minPosition = minPositionInLineDirection;
+    double maxPosition = maxPositionInLineDirection;
+    if (position == 0)
+    {
+      perpendicularPosition = fieldLines[fieldLine].offset - observation.offset;
+      minPosition = fieldLines[fieldLine].min - observation.min - parameters.absoluteAllowedDistanceErrorForLineClustering;
+      maxPosition = fieldLines[fieldLine].max - observation.max + parameters.absoluteAllowedDistanceErrorForLineClustering;
+    }
 
-  conflictingPosition = totalNumberOfObservedLines - 1;
-  return true;
+    AbstractLine modelInRelativeCoords = fieldLines[fieldLine];
+    // make is relative
+    modelInRelativeCoords.offset -= perpendicularPosition;
+    if (!doesObservationFitModelForInterval(observation, modelInRelativeCoords, minPosition, maxPosition))
+      continue;
+
+    alreadyAssignedFieldLines[fieldLine] = true;
+    searchCorrespondencesForIntervals(
+        position + 1, totalNumberOfObservedLines, perpendicularPosition, minPosition, maxPosition, poseIntervalHypothesisStart, poseIntervalHypothesisEnd, theLineMatchingResult);
+    alreadyAssignedFieldLines[fieldLine] = false;
+  }
 }
 
 bool LineMatcher::doesObservationFitModelForInterval(
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <vector>
 
 #include "Tools/Module/Module.h"
@@ -54,7 +55,9 @@ private:
   STREAMABLE(Parameters,,
     (double)(0.15) relativeAllowedDistanceErrorForLineClustering,
     (double)(200.0) absoluteAllowedDistanceErrorForLineClustering, // for very close lines, the relative distance might be only millimeters
-    (bool)(false) allowPosesOutsideOfCarpet
+    (bool)(false) allowPosesOutsideOfCarpet,
+    (unsigned)(3000) maxSearchTime, // in µs, the poses found so far are provided if the search takes longer
+    (double)(20.0) maxObservationDifferenceForReuse // the result of the last frame is provided if no observed line moved farther (in mm)
   );
 
   Parameters parameters;
@@ -98,12 +101,28 @@ private:
 
   inline void rotateObservationsBy90Degree();
 
-  inline bool getNextCorrespondenceCombination(int totalNumberOfObservedLines, int conflictingPosition);
+  /**
+  * Depth-first search for all correspondences of the observations starting at a position.
+  * The first two positions determine the pose, so every following position can be checked
+  * on its own and a branch is cut as soon as its last correspondence does not fit.
+  */
+  void searchCorrespondences(int position, int totalNumberOfObservedLines, Pose2f& poseHypothesis, LineMatchingResult& theLineMatchingResult);
+  void searchCorrespondencesForIntervals(int position,
+      int totalNumberOfObservedLines,
+      double positionPerpendicularToLineDirection,
+      double minPositionInLineDirection,
+      double maxPositionInLineDirection,
+      Pose2f& poseIntervalHypothesisStart,
+      Pose2f& poseIntervalHypothesisEnd,
+      LineMatchingResult& theLineMatchingResult);
+
+  inline bool doesCorrespondenceFit(int position, const Pose2f& poseHypothesis);
 
-  inline bool checkCombinatorialValidityOfCorrespondences(int totalNumberOfObservedLines, int& conflictingPosition);
+  /** Checks whether the search took longer than allowed, which then stops it. */
+  inline bool isSearchTimeExceeded();
 
-  inline bool checkGeometricValidityOfCorrespondences(int totalNumberOfObservedLines, int& conflictingPosition, Pose2f& poseHypothesis);
-  inline bool checkGeometricValidityOfCorrespondencesForIntervals(int totalNumberOfObservedLines, int& conflictingPosition, Pose2f& poseIntervalHypothesisStart, Pose2f& poseIntervalHypothesisEnd);
+  /** Provides the result of the last frame if the observations did not change. */
+  bool reuseLastResult(LineMatchingResult& theLineMatchingResult);
 
   inline bool doesObservationFitModel(const AbstractLine& observationInRelativeCoords, const AbstractLine& modelInRelativeCoords);
   inline bool doesObservationFitModelForInterval(
@@ -133,6 +152,18 @@ private:
   std::vector<int> mainDirectionClassIndex2correspondenceIndex;
   std::vector<int> notMainDirectionClassIndex2correspondenceIndex;
 
+  // limiting the search
+  std::chrono::steady_clock::time_point searchStart;
+  unsigned int searchSteps = 0;
+  bool searchAborted = false;
+
+  // the last complete result
+  bool lastResultValid = false;
+  std::vector<LineMatchingResult::FieldLine> lastObservations;
+  std::vector<LineMatchingResult::PoseHypothesis> lastPoseHypothesis;
+  std::vector<LineMatchingResult::PoseHypothesisInterval> lastPoseHypothesisIntervals;
+  bool lastOnlyObservedOneFieldLine = false;
+
   // variables for debugging
   int counterForDrawing;
 };
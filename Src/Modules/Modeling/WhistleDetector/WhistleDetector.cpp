@@ -16,10 +16,6 @@
 
 WhistleDetector::WhistleDetector()
 {
-  setup();
-
-  ringPos = 0;
-
   releaseCount = static_cast<unsigned int>(release);
   attackCount = 1;
 
@@ -34,7 +30,24 @@ WhistleDetector::WhistleDetector()
   detectedWhistleFrequency = minFreq + ((maxFreq - minFreq) / 2);
 }
 
+void WhistleDetector::execute(tf::Subflow& subflow)
+{
+  subflow
+      .emplace(
+          [this]()
+          {
+            detect(localWhistle);
+          })
+      .priority(tf::TaskPriority::LOW)
+      .name("WhistleDetector");
+}
+
 void WhistleDetector::update(WhistleDortmund& whistle)
+{
+  whistle = localWhistle;
+}
+
+void WhistleDetector::detect(WhistleDortmund& whistle)
 {
   INIT_DEBUG_IMAGE_BLACK(FFT, DEBUG_WIDTH, DEBUG_HEIGHT);
   DECLARE_PLOT("representation:Whistle:confidence");
@@ -84,8 +97,16 @@ void WhistleDetector::update(WhistleDortmund& whistle)
     whistleFreqBuffer.clear();
   }
 
-  if (oldWhistleNetPath != whistleNetPath)
+  // also registers the model in the first frames, since the inference service is not available in the constructor
+  // and the model is loaded in the background
+  if (oldWhistleNetPath != whistleNetPath || !whistleNet)
     setup();
+  if (!whistleNet)
+    return;
+
+  // the window and the hop size can be changed at runtime
+  spectrum.setup(windowSize, windowSize / std::max(1, hopsPerWindow), getWindow());
+  const std::vector<float>& amplitudes = spectrum.getAmplitudes();
 
   if (!useAdaptiveThreshold)
   {
@@ -103,57 +124,35 @@ void WhistleDetector::update(WhistleDortmund& whistle)
 
     while (audioDataPos < theAudioData.samples.size())
     {
-      while (audioDataPos < theAudioData.samples.size() && samplesLeft > 0)
+      // the spectrum is computed after every hop
+      bool spectrumComputed = false;
+      STOPWATCH("FFT")
       {
-        //S16 to float
-        //buffer[ringPos] = static_cast<float>(theAudioData.samples[audioDataPos])
-        //    / static_cast<float>(std::numeric_limits<short>::max());
-
-        buffer[ringPos] = theAudioData.samples[audioDataPos];
+        while (audioDataPos < theAudioData.samples.size() && !spectrumComputed)
+        {
+          //S16 to float
+          //buffer[ringPos] = static_cast<float>(theAudioData.samples[audioDataPos])
+          //    / static_cast<float>(std::numeric_limits<short>::max());
 
-        audioDataPos += channels;
-        samplesLeft--;
-        ringPos = (ringPos + 1) % windowSize;
+          spectrumComputed = spectrum.addSample(theAudioData.samples[audioDataPos]);
+          audioDataPos += channels;
+        }
       }
 
-      if (samplesLeft == 0)
+      if (spectrumComputed)
       {
         whistle.detectionState = WhistleDortmund::DetectionState::notDetected;
-        samplesLeft = windowSize / 2;
-
-        for (unsigned int i = 0; i < static_cast<unsigned int>(windowSize); i++)
-        {
-          in[i].r = buffer[(i + ringPos) % windowSize];
-          in[i].i = 0.f;
-
-          //apply Hann window
-          if (useHannWindowing)
-            in[i].r *= std::pow(std::sin(pi * i / windowSize), 2.f);
-          else if (useNuttallWindowing)
-            in[i].r *= 0.355768f - 0.487396f * std::sin(1 * pi * i / windowSize) + 0.144232f * std::sin(2 * pi * i / windowSize) - 0.012604f * std::sin(3 * pi * i / windowSize);
-          else //apply Hamming window -> default
-            in[i].r *= (0.54f - 0.46f * std::cos(2.f * pi * i / windowSize));
-        }
 
-        //do FFT analysis
-        STOPWATCH("FFT")
-        {
-          kissFFT(in.data(), out.data());
-        }
-
-        //interpreter->typed_tensor<float>(input_tensor)
-        float* output = nullptr;
+        TfliteInferenceService::Outputs output;
         STOPWATCH("Whistle")
         {
           float prevAmp = 0;
           float ampSum = 0;
           float limitCount = 0;
+          std::copy_n(spectrum.getDecibels().begin(), std::min(nnInput.size(), spectrum.getDecibels().size()), nnInput.begin());
           for (int i = 0; i < ampSize; i++)
           {
-            float amp = std::sqrt((out[i].r * out[i].r) + (out[i].i * out[i].i));
-
-            interpreter->typed_tensor<float>(input_tensor)[i] = 20 * std::log10(amp);
-            amplitudes[i] = amp;
+            const float amp = amplitudes[i];
             gradients[i] = amp - prevAmp;
             prevAmp = amp;
 
@@ -245,14 +244,10 @@ void WhistleDetector::update(WhistleDortmund& whistle)
           }
 
           //do WhistleDetection NN
-          output = interpreter->typed_tensor<float>(output_tensor);
-
-          if (interpreter->Invoke() != kTfLiteOk)
-          {
-            OUTPUT_ERROR("Failed to invoke tflite!");
-          }
+          std::future<TfliteInferenceService::Outputs> result = theTfliteInferenceService.submit(*whistleNet, nnInput.data());
+          output = theTfliteInferenceService.get(result);
         }
-        nnConfidence = *output; //linear
+        nnConfidence = output.empty() ? 0.f : output[0][0]; //linear
         //confidence = std::max(0.f, std::min(1.f, (confidence + 1.f) / 2.f));
 
         //Merge NN, PM and limit information
@@ -405,77 +400,38 @@ void WhistleDetector::update(WhistleDortmund& whistle)
   PLOT("representation:Whistle:maxAmp", currentMaxAmp);
 }
 
-/**
-*   Note that the arrays in and out must have the same size as given by param size
-*/
-void WhistleDetector::kissFFT(kiss_fft_cpx in[], kiss_fft_cpx out[])
-{
-  kiss_fft_cfg cfg;
-
-  if ((cfg = kiss_fft_alloc(windowSize, 0 /*is_inverse_fft*/, NULL, NULL)) != NULL)
-  {
-    kiss_fft(cfg, in, out);
-    free(cfg);
-  }
-  else
-  {
-    OUTPUT_WARNING("Not enough memory for KissFFT?");
-  }
-}
-
 void WhistleDetector::setup()
 {
   // set up tflite
-  std::string filename = std::string(File::getBHDir()) + whistleNetPath;
   oldWhistleNetPath = whistleNetPath;
 
-  // Load the model
-  model = tflite::FlatBufferModel::BuildFromFile(filename.c_str());
+  // Load the model, the inference service reports if it was not found
+  whistleNet = theTfliteInferenceService.loadModel("WhistleDetector", whistleNetPath, TfliteInferenceService::normal);
 
-  if (model == nullptr)
-  {
-    OUTPUT_WARNING("Model not found");
-  }
-  else
+  if (whistleNet)
   {
-    // Build the interpreter
-    tflite::InterpreterBuilder builder(*model, resolver);
-    builder(&interpreter);
-
-    interpreter->SetNumThreads(1);
-
-    // Resize input tensors
-    input_tensor = interpreter->inputs()[0];
-    output_tensor = interpreter->outputs()[0];
-    TfLiteIntArray* input_dims = interpreter->tensor(input_tensor)->dims;
-    //int input_batch = input_dims->data[0];
-    int input_size = input_dims->data[1];
-    int channels = input_dims->data[2];
-
-
-    std::vector<int> new_input;
-    new_input.push_back(1);
-    new_input.push_back(input_size);
-    new_input.push_back(channels);
-    interpreter->ResizeInputTensor(input_tensor, new_input);
-
-    // Allocate memory fore the tensors
-    interpreter->AllocateTensors();
+    // the input has the shape (batchSize, inputSize, channels)
+    const int input_size = whistleNet->inputDims[1];
+    nnInput = std::vector<float>(whistleNet->inputBytes / sizeof(float));
 
     // Setup buffers for pre- and post-processing
     windowSize = (input_size * 2) - 2;
     ampSize = input_size;
 
-    samplesLeft = windowSize / 2;
-    buffer = std::vector<float>(windowSize);
-
-    in = std::vector<kiss_fft_cpx>(windowSize);
-    out = std::vector<kiss_fft_cpx>(windowSize);
-    amplitudes = std::vector<float>(ampSize);
     gradients = std::vector<float>(ampSize);
 
     SET_DEBUG_IMAGE_SIZE(CHROMA, CHROMA_WIDTH, ampSize);
   }
 }
 
+WhistleSpectrum::Window WhistleDetector::getWindow() const
+{
+  if (useHannWindowing)
+    return WhistleSpectrum::Window::hann;
+  else if (useNuttallWindowing)
+    return WhistleSpectrum::Window::nuttall;
+  else //apply Hamming window -> default
+    return WhistleSpectrum::Window::hamming;
+}
+
 MAKE_MODULE(WhistleDetector, modeling)
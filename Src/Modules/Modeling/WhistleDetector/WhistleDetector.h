@@ -1,7 +1,5 @@
 #pragma once
 
-#include <kissfft/kiss_fft.h>
-
 #include "Tools/Module/Module.h"
 #include "Representations/Modeling/WhistleDortmund.h"
 #include "Representations/Infrastructure/FrameInfo.h"
@@ -9,6 +7,7 @@
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/AudioData.h"
 #include "Representations/MotionControl/MotionInfo.h"
+#include "Representations/Perception/TfliteInferenceService.h"
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Debugging/DebugImages.h"
 #include "Platform/SystemCall.h"
@@ -17,14 +16,18 @@
 #include "Tools/RingBufferWithSum.h"
 
 #include "Modules/Perception/TFlite.h"
+#include "WhistleSpectrum.h"
+#include <taskflow/taskflow.hpp>
 
 MODULE(WhistleDetector,
   REQUIRES(FrameInfo),
   REQUIRES(AudioData),
   REQUIRES(MotionInfo),
+  REQUIRES(TfliteInferenceService),
   PROVIDES(WhistleDortmund),
+  HAS_PREEXECUTION,
   LOADS_PARAMETERS(,
-    (std::string) whistleNetPath,
+    (std::string) whistleNetPath, // relative to the directory Config
     (unsigned int) micBrokenThreshold,
     (float) limit,
     (float) threshold,
@@ -39,6 +42,7 @@ MODULE(WhistleDetector,
     (int) attackTimeout, // in ms
     (bool) useHannWindowing,
     (bool) useNuttallWindowing,
+    (int) hopsPerWindow, // A spectrum is computed every windowSize / hopsPerWindow samples
     (int) minFreq, 
     (int) maxFreq,
     (bool) freqCalibration,
@@ -53,11 +57,8 @@ class WhistleDetector : public WhistleDetectorBase
 
   std::string oldWhistleNetPath;
 
-  std::unique_ptr<tflite::Interpreter> interpreter;
-
-  std::unique_ptr<tflite::FlatBufferModel> model;
-  tflite::ops::builtin::BuiltinOpResolver resolver;
-  int input_tensor, output_tensor;
+  const TfliteInferenceService::Model* whistleNet = nullptr;
+  std::vector<float> nnInput;
 
   int chromaPos = 0;
 
@@ -76,7 +77,6 @@ class WhistleDetector : public WhistleDetectorBase
   unsigned int micBrokenCount = 0;
   bool alert = false;
 
-  unsigned int ringPos, samplesLeft;
   unsigned int releaseCount, attackCount;
   int detectedWhistleFrequency = 0;
   RingBufferWithSum<int, 10> whistleFreqBuffer;
@@ -84,9 +84,7 @@ class WhistleDetector : public WhistleDetectorBase
   int currentMaxFreq = 0;
   int oldMinFreq = 0;
   int oldMaxFreq = 0;
-  std::vector<float> buffer;
-  std::vector<kiss_fft_cpx> in, out;
-  std::vector<float> amplitudes;
+  WhistleSpectrum spectrum;
   std::vector<float> gradients;
   RingBufferWithSum<float, 200> maxAmpHist;
 
@@ -94,11 +92,16 @@ class WhistleDetector : public WhistleDetectorBase
   bool detectionProcessed = false;
   bool evaluationStarted = false;
 
+  WhistleDortmund localWhistle;
+
 public:
   WhistleDetector();
   void update(WhistleDortmund& whistle);
-  void kissFFT(kiss_fft_cpx in[], kiss_fft_cpx out[]);
 
 private:
+  /** Runs the detection on the workers with a low priority, since the whistle is not needed as early as the percepts. */
+  void execute(tf::Subflow& subflow);
+  void detect(WhistleDortmund& whistle);
   void setup();
+  WhistleSpectrum::Window getWindow() const;
 };
@@ -0,0 +1,87 @@
+/**
+* @file WhistleSpectrum.cpp
+* Implementation of class WhistleSpectrum.
+*/
+
+#include "WhistleSpectrum.h"
+#include "Tools/Math/Constants.h"
+#include <algorithm>
+#include <cmath>
+
+WhistleSpectrum::~WhistleSpectrum()
+{
+  if (cfg)
+    kiss_fftr_free(cfg);
+}
+
+void WhistleSpectrum::setup(int windowSize, int hopSize, Window window)
+{
+  if (windowSize != this->windowSize)
+  {
+    if (cfg)
+      kiss_fftr_free(cfg);
+    cfg = kiss_fftr_alloc(windowSize, 0 /*is_inverse_fft*/, nullptr, nullptr);
+    this->windowSize = windowSize;
+    this->hopSize = 0;
+    ringPos = 0;
+    samples = std::vector<float>(windowSize);
+    frame.resize(windowSize);
+    spectrum.resize(windowSize / 2 + 1);
+    amplitudes = std::vector<float>(windowSize / 2 + 1);
+    decibels = std::vector<float>(windowSize / 2 + 1);
+    this->window.clear();
+  }
+  if (window != windowType || this->window.empty())
+  {
+    windowType = window;
+    this->window.resize(windowSize);
+    for (int i = 0; i < windowSize; i++)
+    {
+      if (window == Window::hann)
+        this->window[i] = std::pow(std::sin(pi * i / windowSize), 2.f);
+      else if (window == Window::nuttall)
+        this->window[i] = 0.355768f - 0.487396f * std::sin(1 * pi * i / windowSize) + 0.144232f * std::sin(2 * pi * i / windowSize) - 0.012604f * std::sin(3 * pi * i / windowSize);
+      else
+        this->window[i] = 0.54f - 0.46f * std::cos(2.f * pi * i / windowSize);
+    }
+  }
+  hopSize = std::max(1, std::min(hopSize, windowSize));
+  if (hopSize != this->hopSize)
+  {
+    this->hopSize = hopSize;
+    samplesLeft = hopSize;
+  }
+}
+
+bool WhistleSpectrum::addSample(float sample)
+{
+  samples[ringPos] = sample;
+  ringPos = (ringPos + 1) % windowSize;
+  if (--samplesLeft > 0)
+    return false;
+
+  samplesLeft = hopSize;
+  transform();
+  return true;
+}
+
+void WhistleSpectrum::transform()
+{
+  if (!cfg)
+    return;
+
+  // the oldest sample is at ringPos
+  const int firstPart = windowSize - ringPos;
+  for (int i = 0; i < firstPart; i++)
+    frame[i] = samples[ringPos + i] * window[i];
+  for (int i = firstPart; i < windowSize; i++)
+    frame[i] = samples[i - firstPart] * window[i];
+
+  kiss_fftr(cfg, frame.data(), spectrum.data());
+
+  for (size_t i = 0; i < amplitudes.size(); i++)
+  {
+    amplitudes[i] = std::sqrt((spectrum[i].r * spectrum[i].r) + (spectrum[i].i * spectrum[i].i));
+    decibels[i] = 20 * std::log10(amplitudes[i]);
+  }
+}
@@ -0,0 +1,68 @@
+/**
+* @file WhistleSpectrum.h
+* Declaration of class WhistleSpectrum, a streaming short-time Fourier transform of the samples of one microphone.
+* A new window is transformed every hopSize samples. The window function and the plan of the real FFT are only
+* computed if the window changes, so a spectrum only costs the windowing, one real FFT and the magnitudes.
+* The magnitudes and their decibels are shared by the whistle net and the pattern matching.
+*/
+
+#pragma once
+
+#include <kissfft/kiss_fftr.h>
+#include <vector>
+
+class WhistleSpectrum
+{
+public:
+  enum class Window
+  {
+    hamming,
+    hann,
+    nuttall
+  };
+
+  WhistleSpectrum() = default;
+  WhistleSpectrum(const WhistleSpectrum&) = delete;
+  WhistleSpectrum& operator=(const WhistleSpectrum&) = delete;
+  ~WhistleSpectrum();
+
+  /**
+  * Prepares the transform. The samples are discarded if the window size changes.
+  * @param windowSize The number of samples of a window, which must be even.
+  * @param hopSize The number of samples between the starts of two windows.
+  * @param window The window function.
+  */
+  void setup(int windowSize, int hopSize, Window window);
+
+  /**
+  * Adds a sample to the window.
+  * @return Was a new spectrum computed?
+  */
+  bool addSample(float sample);
+
+  int getWindowSize() const { return windowSize; }
+
+  /** The magnitudes of the windowSize / 2 + 1 frequencies of the last spectrum. */
+  const std::vector<float>& getAmplitudes() const { return amplitudes; }
+
+  /** The magnitudes of the last spectrum in decibels. */
+  const std::vector<float>& getDecibels() const { return decibels; }
+
+private:
+  void transform();
+
+  int windowSize = 0;
+  int hopSize = 0;
+  Window windowType = Window::hamming;
+  kiss_fftr_cfg cfg = nullptr;
+
+  std::vector<float> samples; /**< The ring buffer of the last windowSize samples. */
+  unsigned ringPos = 0;
+  int samplesLeft = 0; /**< The number of samples until the next window is transformed. */
+
+  std::vector<float> window; /**< The window function. */
+  std::vector<kiss_fft_scalar> frame; /**< The windowed samples. */
+  std::vector<kiss_fft_cpx> spectrum;
+  std::vector<float> amplitudes;
+  std::vector<float> decibels;
+};
@@ -6,6 +6,8 @@
 //#define LOGGING
 #include "Tools/Debugging/CSVLogger.h"
 #include "Tools/Debugging/Annotation.h"
+#include <taskflow/taskflow.hpp>
+#include <taskflow/algorithm/for_each.hpp>
 
 /*---------------------------- class SelfLocator2017 PUBLIC methods ------------------------------*/
 
@@ -102,7 +104,7 @@ void SelfLocator2017::update(RobotPoseHypothesesCompressed& robotPoseHypotheses)
 }
 
 
-void SelfLocator2017::predictHypotheses()
+void SelfLocator2017::predictAndUpdateHypotheses(tf::Subflow& subflow)
 {
   Pose2f odometryDelta = theOdometryData - lastOdometryData;
   lastOdometryData = theOdometryData;
@@ -121,39 +123,59 @@ void SelfLocator2017::predictHypotheses()
   PLOT("module:SelfLocator2017:gyroThreshold", gyroMaxVariance.toDegrees());
   bool isStable = gyroVariance < gyroMaxVariance ? true : false;
 
-  for (auto& hypothesis : poseHypotheses)
-  {
-    hypothesis->predict(odometryDelta, parameters, isStable);
-  }
+  // predict, fill the matrices for the update and update the state in one pass over each hypothesis
+  forEachHypothesis(subflow,
+      "UpdateHypotheses [SelfLocator2017]",
+      [&](PoseHypothesis2017& hypothesis)
+      {
+        hypothesis.predict(odometryDelta, parameters, isStable);
+        hypothesis.fillCorrectionMatrices(
+            theLineMatchingResult, theCLIPCenterCirclePercept, theCLIPGoalPercept, thePenaltyCrossPercept, theFieldDimensions, theCameraMatrix, theCameraMatrixUpper, parameters);
+        hypothesis.updateStateWithLocalFeaturePerceptionsSpherical(parameters);
+        hypothesis.updateStateWithLocalFeaturePerceptionsInfiniteLines(parameters);
+        hypothesis.updateStateRotationWithLocalFieldLines(theCLIPFieldLinesPercept, parameters);
+      });
 }
 
 
-void SelfLocator2017::updateHypothesesPositionConfidence()
+void SelfLocator2017::updateHypothesesPositionConfidence(tf::Subflow& subflow)
 {
-  bool updateSpherical, updateInfiniteLines, updateWeighted;
-  for (auto& hypothesis : poseHypotheses)
-  {
-    updateSpherical = hypothesis->updatePositionConfidenceWithLocalFeaturePerceptionsSpherical(
-        theLineMatchingResult, theCLIPCenterCirclePercept, theCLIPGoalPercept, thePenaltyCrossPercept, theFieldDimensions, theCameraMatrix, theCameraMatrixUpper, parameters);
-    updateInfiniteLines = hypothesis->updatePositionConfidenceWithLocalFeaturePerceptionsInfiniteLines(theLineMatchingResult, theCLIPCenterCirclePercept, theFieldDimensions, parameters);
-    updateWeighted = hypothesis->updatePositionConfidenceWithLocalFeaturePerceptionsWeighted(
-        theCLIPFieldLinesPercept, theCLIPCenterCirclePercept, theCLIPGoalPercept, thePenaltyCrossPercept, theFieldDimensions, parameters);
-
-    if (!(updateSpherical || updateInfiniteLines || updateWeighted))
-    {
-      // TODO: Negative update as nothing was seen?
-    }
-  }
+  forEachHypothesis(subflow,
+      "UpdatePositionConfidences [SelfLocator2017]",
+      [&](PoseHypothesis2017& hypothesis)
+      {
+        bool updateSpherical, updateInfiniteLines, updateWeighted;
+        updateSpherical = hypothesis.updatePositionConfidenceWithLocalFeaturePerceptionsSpherical(
+            theLineMatchingResult, theCLIPCenterCirclePercept, theCLIPGoalPercept, thePenaltyCrossPercept, theFieldDimensions, theCameraMatrix, theCameraMatrixUpper, parameters);
+        updateInfiniteLines = hypothesis.updatePositionConfidenceWithLocalFeaturePerceptionsInfiniteLines(theLineMatchingResult, theCLIPCenterCirclePercept, theFieldDimensions, parameters);
+        updateWeighted = hypothesis.updatePositionConfidenceWithLocalFeaturePerceptionsWeighted(
+            theCLIPFieldLinesPercept, theCLIPCenterCirclePercept, theCLIPGoalPercept, thePenaltyCrossPercept, theFieldDimensions, fieldLineIndex, parameters);
+
+        if (!(updateSpherical || updateInfiniteLines || updateWeighted))
+        {
+          // TODO: Negative update as nothing was seen?
+        }
+      });
 }
 
-void SelfLocator2017::updateHypothesesState()
+void SelfLocator2017::forEachHypothesis(tf::Subflow& subflow, const char* name, const std::function<void(PoseHypothesis2017&)>& function)
 {
-  for (auto& hypothesis : poseHypotheses)
+  if (poseHypotheses.size() < minHypothesesForParallelUpdate || subflow.executor().num_workers() < 2)
   {
-    hypothesis->updateStateWithLocalFeaturePerceptionsSpherical(parameters);
-    hypothesis->updateStateWithLocalFeaturePerceptionsInfiniteLines(parameters);
-    hypothesis->updateStateRotationWithLocalFieldLines(theCLIPFieldLinesPercept, parameters);
+    for (auto& hypothesis : poseHypotheses)
+      function(*hypothesis);
+    return;
   }
+
+  subflow
+      .for_each(poseHypotheses.begin(),
+          poseHypotheses.end(),
+          [&function](std::unique_ptr<PoseHypothesis2017>& hypothesis)
+          {
+            function(*hypothesis);
+          })
+      .name(name);
+  subflow.join();
 }
 
 void SelfLocator2017::updateHypothesesSymmetryConfidence()
@@ -192,12 +214,15 @@ void SelfLocator2017::updateHypothesesSymmetryConfidence()
 }
 
 
-void SelfLocator2017::execute(tf::Subflow&)
+void SelfLocator2017::execute(tf::Subflow& subflow)
 {
   if (!initialized)
   {
-    addHypothesesOnInitialKickoffPositions();
-    addHypothesesOnManualPositioningPositions();
+    if (!addHypothesesFromWarmStart())
+    {
+      addHypothesesOnInitialKickoffPositions();
+      addHypothesesOnManualPositioningPositions();
+    }
     // Initialize distance with in a way it will cause spawns on 1st fall down
     distanceTraveledFromLastFallDown = parameters.spawning.minDistanceBetweenFallDowns;
     initialized = true;
@@ -219,19 +244,13 @@ void SelfLocator2017::execute(tf::Subflow&)
 
   // Adjust hypotheses positions when field dimensions change
   adjustHypothesesToFieldDimensions();
+  fieldLineIndex.update(theFieldDimensions, fieldLineIndexBinSize);
 
   // Checking whether robot has been picked up (human error detection)
   checkBeingPickedUp();
 
-  // Predict new position
-  predictHypotheses();
-
-  // Fill matrices for update
-  for (auto& hyp : poseHypotheses)
-    hyp->fillCorrectionMatrices(theLineMatchingResult, theCLIPCenterCirclePercept, theCLIPGoalPercept, thePenaltyCrossPercept, theFieldDimensions, theCameraMatrix, theCameraMatrixUpper, parameters);
-
-  // Update state of hypotheses
-  updateHypothesesState();
+  // Predict new position, fill matrices for update and update state of hypotheses
+  predictAndUpdateHypotheses(subflow);
 
   // Evaluate status of localization (OK, Symmetrie lost, Lost)
   evaluateLocalizationState();
@@ -240,7 +259,7 @@ void SelfLocator2017::execute(tf::Subflow&)
   addNewHypotheses();
 
   // Update confidence of hypotheses
-  updateHypothesesPositionConfidence();
+  updateHypothesesPositionConfidence(subflow);
 
   // Update symmetry confidence of each hypothesis
   updateHypothesesSymmetryConfidence();
@@ -906,6 +925,20 @@ void SelfLocator2017::addPenaltyStrikerStartingHypothesis()
   }
 }
 
+bool SelfLocator2017::addHypothesesFromWarmStart()
+{
+  // after a restart of the framework, the robot is most likely where it was before
+  if (!theWarmStart.restored)
+    return false;
+
+  for (const RobotPoseHypothesis& hypothesis : theWarmStart.robotPoseHypotheses.hypotheses)
+    if (hypothesis.validity > 0.f)
+      poseHypotheses.push_back(std::make_unique<PoseHypothesis2017>(hypothesis, hypothesis.validity, hypothesis.sideConfidenceState, theFrameInfo.time, parameters));
+  if (!poseHypotheses.empty())
+    ANNOTATION("SelfLocator2017", "restored " << poseHypotheses.size() << " hypotheses of a snapshot " << theWarmStart.age << " s old");
+  return !poseHypotheses.empty();
+}
+
 void SelfLocator2017::addHypothesesOnInitialPositions(float newPositionConfidence)
 {
   if (Global::getSettings().gameMode != Settings::penaltyShootout && theGameInfo.gamePhase != GAME_PHASE_PENALTYSHOOT)
@@ -1080,6 +1113,25 @@ bool SelfLocator2017::addNewHypothesesFromLandmark()
   return addNewHypothesesFromPenaltyCrossLine() || addNewHypothesesFromCenterCirleAndLine() || addNewHypothesesFromGoal();
 }
 
+bool SelfLocator2017::addNewHypothesesFromRelocalization()
+{
+  // Only hypotheses based on the percepts of this frame are used, which are none if there is no provider
+  if (theRelocalizationHypotheses.timestamp != theFrameInfo.time || theRelocalizationHypotheses.hypotheses.empty())
+    return false;
+
+  std::vector<HypothesisBase> additionalHypotheses;
+  const float bestWeight = theRelocalizationHypotheses.hypotheses.front().weight;
+  for (const RelocalizationHypotheses::Hypothesis& hypothesis : theRelocalizationHypotheses.hypotheses)
+    addPoseToHypothesisVector(hypothesis.pose, additionalHypotheses, parameters.spawning.relocalizationBaseConfidence * hypothesis.weight / bestWeight);
+
+  // Add hypotheses to the system
+  for (auto& hyp : additionalHypotheses)
+  {
+    poseHypotheses.push_back(std::make_unique<PoseHypothesis2017>(hyp.pose, hyp.positionConfidence, hyp.confidenceState, theFrameInfo.time, parameters));
+  }
+  return !additionalHypotheses.empty();
+}
+
 bool SelfLocator2017::addNewHypotheses()
 {
   bool added = false;
@@ -1105,6 +1157,7 @@ bool SelfLocator2017::addNewHypotheses()
       added |= addNewHypothesesFromLineMatches();
       added |= addNewHypothesesFromLandmark();
     }
+    added |= addNewHypothesesFromRelocalization();
     break;
 
   case positionTracking:
@@ -1124,6 +1177,7 @@ bool SelfLocator2017::addNewHypotheses()
     {
       added |= addNewHypothesesFromLineMatches();
       added |= addNewHypothesesFromLandmark();
+      added |= addNewHypothesesFromRelocalization();
     }
     else if (parameters.spawning.landmarkBasedHypothesesSpawn & SelfLocator2017Parameters::Spawning::spawnIfPositionTracking
         && (!bestHyp || bestHyp->getPositionConfidence() < parameters.spawning.spawnUniqueWhilePositionTrackingWhenBestConfidenceBelowThisThreshold))
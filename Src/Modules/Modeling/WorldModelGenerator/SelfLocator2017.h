@@ -13,24 +13,28 @@
 
 //#include <algorithm>
 #include <vector>
+#include <functional>
 #include <memory>
 
 // ------------- NAO-Framework includes --------------
 #include "Representations/Configuration/FieldDimensions.h"
 #include "Tools/Module/Module.h"
 #include "Tools/RingBuffer.h"
+#include "Tools/RingBufferWithStatistics.h"
 #include "Representations/Modeling/RobotMap.h"
 #include "Representations/Modeling/RobotPoseHypotheses.h"
 #include "Representations/Modeling/BallModel.h"
 #include "Representations/Modeling/RemoteBallModel.h"
 #include "Representations/Modeling/SideConfidence.h"
 #include "Representations/Modeling/LineMatchingResult.h"
+#include "Representations/Modeling/RelocalizationHypotheses.h"
 
 #include "Representations/Infrastructure/RobotInfo.h"
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/TeamInfo.h"
 #include "Representations/Infrastructure/GameInfo.h"
 #include "Representations/Infrastructure/TeammateData.h"
+#include "Representations/Infrastructure/WarmStart.h"
 #include "Representations/Infrastructure/SensorData/JointSensorData.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/CenterCirclePercept.h"
@@ -66,6 +70,7 @@ MODULE(SelfLocator2017,
   REQUIRES(GameInfo),
   REQUIRES(OdometryData),
   REQUIRES(LineMatchingResult),
+  REQUIRES(RelocalizationHypotheses),
   REQUIRES(CLIPCenterCirclePercept),
   REQUIRES(CLIPGoalPercept),
   REQUIRES(PenaltyCrossPercept),
@@ -74,6 +79,7 @@ MODULE(SelfLocator2017,
   REQUIRES(CLIPFieldLinesPercept),
   REQUIRES(JointSensorData),
   REQUIRES(RemoteBallModel),
+  REQUIRES(WarmStart),
   USES(LocalRobotMap),
   USES(RemoteRobotMap),
   USES(BehaviorData), // For manual positions, role is required (right now only goalie vs field player)
@@ -86,6 +92,8 @@ MODULE(SelfLocator2017,
   LOADS_PARAMETERS(,
     ((JoinedIMUData)InertialDataSource)(JoinedIMUData::inertialSensorData) anglesource,
     (Angle)(0.01_deg) gyroMaxVariance,
+    (unsigned)(4) minHypothesesForParallelUpdate,
+    (float)(250.f) fieldLineIndexBinSize, /**< The size of the bins of the candidate field lines in mm. */ /**< Fewer hypotheses are updated sequentially, since a task costs more than their update. */
     (PositionsByRules) positionsByRules,
     (SelfLocator2017Parameters) parameters
   )
@@ -137,11 +145,12 @@ public:
 private:
   /* ----------------------------------- private variables here ----------------------------------*/
 
-  std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
-  std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
+  std::array<RingBufferWithStatistics<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
+  std::array<RingBufferWithStatistics<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
 
   bool initialized;
   Vector2f lastFieldSize = Vector2f::Zero();
+  FieldLineIndex2017 fieldLineIndex; /**< The candidate field lines of line percepts, shared by all hypotheses. */
 
   PoseHypotheses poseHypotheses;
 
@@ -192,11 +201,16 @@ private:
   void pruneHypothesesOutsideField();
   void pruneHypothesesOutsideCarpet();
   void pruneHypothesesWithInvalidValues();
-  void predictHypotheses();
-  void updateHypothesesPositionConfidence();
-  void updateHypothesesState();
+  void predictAndUpdateHypotheses(tf::Subflow& subflow);
+  void updateHypothesesPositionConfidence(tf::Subflow& subflow);
   void updateHypothesesSymmetryConfidence();
 
+  /**
+  * Applies a function to each hypothesis. The hypotheses are independent of each other,
+  * so they are distributed over the workers if there are enough of them.
+  */
+  void forEachHypothesis(tf::Subflow& subflow, const char* name, const std::function<void(PoseHypothesis2017&)>& function);
+
   bool addNewHypotheses();
 
   bool addNewHypothesesFromLineMatches(bool onlyAddUnique = false);
@@ -204,10 +218,12 @@ private:
   bool addNewHypothesesFromPenaltyCrossLine();
   bool addNewHypothesesFromCenterCirleAndLine();
   bool addNewHypothesesFromGoal();
+  bool addNewHypothesesFromRelocalization();
 
   void addHypothesesOnManualPositioningPositions();
   void addHypothesesOnInitialKickoffPositions();
   void addPenaltyStrikerStartingHypothesis();
+  bool addHypothesesFromWarmStart();
   void addHypothesesOnInitialPositions(float newPositionConfidence);
   void addHypothesesOnPenaltyPositions(float newPositionConfidence);
 
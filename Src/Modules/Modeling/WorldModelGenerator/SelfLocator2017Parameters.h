@@ -111,6 +111,7 @@ STREAMABLE(SelfLocator2017Parameters,
     (float)(0.8f) centerCircleBaseConfidence,
     (float)(0.8f) penaltyCrossBaseConfidence,
     (float)(0.25f) lineBasedPositionConfidenceWhenPositionTracking,
+    (float)(0.6f) relocalizationBaseConfidence, // of the most likely RelocalizationHypothesis, the others are scaled by their weight
 
     // Time to not spawn if pose is on other side of the field but we are still entering the field (initial or penalized)
     (unsigned int)(15000) limitSpawningToOwnSideTimeout,
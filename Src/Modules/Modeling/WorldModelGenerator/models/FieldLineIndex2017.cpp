@@ -0,0 +1,78 @@
+/**
+ * @file FieldLineIndex2017.cpp
+ *
+ * Implementation of a lookup table of the straight field lines a line percept can correspond to.
+ */
+
+#include "FieldLineIndex2017.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+  // the straight lines of FieldDimensions::fieldLines used for the update of the position confidence
+  const std::array<std::vector<int>, FieldLineIndex2017::numOfOrientations> linesOfOrientation = {{{0, 2, 4, 6, 9}, {1, 3, 5, 7, 8, 10}}};
+  const std::vector<int> noLines;
+} // namespace
+
+void FieldLineIndex2017::update(const FieldDimensions& theFieldDimensions, float binSize)
+{
+  const std::vector<FieldDimensions::LinesTable::Line>& fieldLines = theFieldDimensions.fieldLines.lines;
+  if (binSize == this->binSize && fieldLines.size() == lines.size()
+      && std::equal(fieldLines.begin(),
+          fieldLines.end(),
+          lines.begin(),
+          [](const FieldDimensions::LinesTable::Line& a, const FieldDimensions::LinesTable::Line& b)
+          {
+            return a.from == b.from && a.to == b.to;
+          }))
+    return;
+
+  lines = fieldLines;
+  this->binSize = binSize = std::max(binSize, 1.f);
+
+  for (int orientation = 0; orientation < numOfOrientations; ++orientation)
+  {
+    // horizontal lines are matched if the percept lies within their range of y, vertical lines within their range of x
+    const int axis = orientation == horizontal ? 1 : 0;
+    Bins& bins = this->bins[orientation];
+    bins.lines.clear();
+
+    float min = std::numeric_limits<float>::max();
+    float max = std::numeric_limits<float>::lowest();
+    for (const int index : linesOfOrientation[orientation])
+      if (index < static_cast<int>(lines.size()))
+      {
+        const FieldDimensions::LinesTable::Line& line = lines[index];
+        const float allowedOffset = line.length / 10;
+        min = std::min(min, std::min(line.from[axis], line.to[axis]) - allowedOffset);
+        max = std::max(max, std::max(line.from[axis], line.to[axis]) + allowedOffset);
+      }
+    if (min > max)
+      continue;
+
+    bins.start = min;
+    bins.lines.resize(static_cast<size_t>(std::ceil((max - min) / binSize)) + 1);
+    for (const int index : linesOfOrientation[orientation])
+      if (index < static_cast<int>(lines.size()))
+      {
+        const FieldDimensions::LinesTable::Line& line = lines[index];
+        const float allowedOffset = line.length / 10;
+        const int first = static_cast<int>((std::min(line.from[axis], line.to[axis]) - allowedOffset - min) / binSize);
+        const int last = std::min(static_cast<int>((std::max(line.from[axis], line.to[axis]) + allowedOffset - min) / binSize), static_cast<int>(bins.lines.size()) - 1);
+        for (int bin = first; bin <= last; ++bin)
+          bins.lines[bin].push_back(index);
+      }
+  }
+}
+
+const std::vector<int>& FieldLineIndex2017::getCandidates(Orientation orientation, const Vector2f& perceptCenter) const
+{
+  const Bins& bins = this->bins[orientation];
+  const float position = (orientation == horizontal ? perceptCenter.y() : perceptCenter.x()) - bins.start;
+  if (bins.lines.empty() || position < 0.f)
+    return noLines;
+  const size_t bin = static_cast<size_t>(position / binSize);
+  return bin < bins.lines.size() ? bins.lines[bin] : noLines;
+}
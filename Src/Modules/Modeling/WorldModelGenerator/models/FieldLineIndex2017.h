@@ -0,0 +1,52 @@
+/**
+ * @file FieldLineIndex2017.h
+ *
+ * Declaration of a lookup table of the straight field lines a line percept can correspond to.
+ * The field lines used for the position confidence update are parallel to one of the field axes,
+ * and a percept on the field only matches a line if its center lies within the (slightly extended)
+ * extent of that line. Therefore, the lines of each orientation are binned along their extent,
+ * so that only the lines of the bin that contains the center of a percept have to be checked.
+ * The table is rebuilt whenever the field lines change.
+ */
+
+#pragma once
+
+#include "Representations/Configuration/FieldDimensions.h"
+#include <array>
+#include <vector>
+
+class FieldLineIndex2017
+{
+public:
+  ENUM(Orientation,
+    horizontal, /**< Lines parallel to the y axis, i.e. the ground lines and the penalty area lines. */
+    vertical /**< Lines parallel to the x axis, i.e. the side lines. */
+  );
+
+  /**
+   * Rebuilds the table if the field lines changed since the last call.
+   * @param theFieldDimensions The field dimensions.
+   * @param binSize The size of a bin along the lines in mm.
+   */
+  void update(const FieldDimensions& theFieldDimensions, float binSize);
+
+  /**
+   * Returns the indices of the field lines that may correspond to a percept.
+   * @param orientation The orientation of the percept on the field.
+   * @param perceptCenter The center of the percept in field coordinates.
+   * @return Indices into FieldDimensions::fieldLines, which contain all lines of the given orientation
+   *         whose extended extent contains the center.
+   */
+  const std::vector<int>& getCandidates(Orientation orientation, const Vector2f& perceptCenter) const;
+
+private:
+  struct Bins
+  {
+    float start = 0.f; /**< The coordinate at which the first bin starts. */
+    std::vector<std::vector<int>> lines; /**< The indices of the candidate lines of each bin. */
+  };
+
+  std::array<Bins, numOfOrientations> bins;
+  std::vector<FieldDimensions::LinesTable::Line> lines; /**< The field lines the table was built for. */
+  float binSize = 0.f;
+};
@@ -12,6 +12,7 @@
  */
 
 #include "PoseHypothesis2017.h"
+#include "Tools/Math/FastMath.h"
 #include "Tools/Modeling/PoseGenerator.h"
 
 CycleLocal<std::unique_ptr<PoseHypothesis2017::KalmanStateUpdate>> PoseHypothesis2017::stateUpdate{nullptr};
@@ -392,25 +393,22 @@ bool PoseHypothesis2017::updatePositionConfidenceWithLocalFeaturePerceptionsWeig
     const CLIPGoalPercept& theGoalPercept,
     const PenaltyCrossPercept& thePenaltyCrossPercept,
     const FieldDimensions& theFieldDimensions,
+    const FieldLineIndex2017& fieldLineIndex,
     const SelfLocator2017Parameters& parameters)
 {
   bool update = false;
   Pose2f robotPose;
   getRobotPose(robotPose);
-  static int lh[7] = {0, 2, 4, 6, 9, 12, 15};
-  static int lv[10] = {1, 3, 5, 7, 8, 10, 11, 13, 14, 16};
-  static std::vector<int> linesHorizontal(&lh[0], &lh[0] + 5);
-  static std::vector<int> linesVertical(&lv[0], &lv[0] + 6);
   // LEVEL 1
   if (parameters.sensorUpdate.use1stLevelUpdate)
-    update |= updatePositionConfidenceWithSingleLines(theFieldLinesPercept, theFieldDimensions, parameters, robotPose, linesHorizontal, linesVertical);
+    update |= updatePositionConfidenceWithSingleLines(theFieldLinesPercept, theFieldDimensions, fieldLineIndex, parameters, robotPose);
   // LEVEL 2
   if (parameters.sensorUpdate.use2ndLevelUpdate)
-    update |= updatePositionConfidenceWithLineCrossings(theFieldLinesPercept, theFieldDimensions, parameters, robotPose, linesHorizontal, linesVertical);
+    update |= updatePositionConfidenceWithLineCrossings(theFieldLinesPercept, theFieldDimensions, fieldLineIndex, parameters, robotPose);
   // LEVEL 3
   if (parameters.sensorUpdate.use3rdLevelUpdate)
     update |= updatePositionConfidenceWithLineAndLandmark(
-        theFieldLinesPercept, theCenterCirclePercept, theGoalPercept, thePenaltyCrossPercept, theFieldDimensions, parameters, robotPose, linesHorizontal, linesVertical);
+        theFieldLinesPercept, theCenterCirclePercept, theGoalPercept, thePenaltyCrossPercept, theFieldDimensions, fieldLineIndex, parameters, robotPose);
 
   return update;
 }
@@ -418,10 +416,9 @@ bool PoseHypothesis2017::updatePositionConfidenceWithLocalFeaturePerceptionsWeig
 // LEVEL 1
 bool PoseHypothesis2017::updatePositionConfidenceWithSingleLines(const CLIPFieldLinesPercept& theFieldLinesPercept,
     const FieldDimensions& theFieldDimensions,
+    const FieldLineIndex2017& fieldLineIndex,
     const SelfLocator2017Parameters& parameters,
-    const Pose2f& robotPose,
-    const std::vector<int>& linesHorizontal,
-    const std::vector<int>& linesVertical)
+    const Pose2f& robotPose)
 {
   float correspondence = 0.f;
 
@@ -430,12 +427,23 @@ bool PoseHypothesis2017::updatePositionConfidenceWithSingleLines(const CLIPField
   bool foundMatch = false;
   bool update = false;
   int numOfFailedMatches = 0;
-  for (; percept != perceptEnd; ++percept)
+
+  // the start and end points of all lines in field coordinates
+  std::vector<Vector2f> perceptPoints;
+  perceptPoints.reserve(theFieldLinesPercept.lines.size() * 2);
+  for (const CLIPFieldLinesPercept::FieldLine& line : theFieldLinesPercept.lines)
+  {
+    perceptPoints.push_back(line.startOnField);
+    perceptPoints.push_back(line.endOnField);
+  }
+  Transformation::robotToField(robotPose, perceptPoints, perceptPoints);
+
+  for (std::vector<Vector2f>::const_iterator perceptPoint = perceptPoints.begin(); percept != perceptEnd; ++percept, perceptPoint += 2)
   {
     foundMatch = false;
     correspondence = 0.0;
-    Vector2f perceptFieldStart = Transformation::robotToField(robotPose, (*percept).startOnField);
-    Vector2f perceptFieldEnd = Transformation::robotToField(robotPose, (*percept).endOnField);
+    Vector2f perceptFieldStart = perceptPoint[0];
+    Vector2f perceptFieldEnd = perceptPoint[1];
     //double perceptDistanceRelative = (((*percept).startOnField + (*percept).endOnField)*0.5).abs();
     float angle = (perceptFieldEnd - perceptFieldStart).angle();
     float length = (perceptFieldEnd - perceptFieldStart).norm();
@@ -452,9 +460,9 @@ bool PoseHypothesis2017::updatePositionConfidenceWithSingleLines(const CLIPField
 
       if (isHorizontal)
       {
-        for (std::vector<int>::const_iterator line = linesHorizontal.begin(); line != linesHorizontal.end(); ++line)
+        for (const int line : fieldLineIndex.getCandidates(FieldLineIndex2017::horizontal, perceptCenterField))
         {
-          const FieldDimensions::LinesTable::Line& fieldLine = theFieldDimensions.fieldLines.lines[(*line)];
+          const FieldDimensions::LinesTable::Line& fieldLine = theFieldDimensions.fieldLines.lines[line];
           float allowedOffset = fieldLine.length / 10;
           float minY = std::min(fieldLine.from.y(), fieldLine.to.y()) - allowedOffset;
           float maxY = std::max(fieldLine.from.y(), fieldLine.to.y()) + allowedOffset;
@@ -462,15 +470,15 @@ bool PoseHypothesis2017::updatePositionConfidenceWithSingleLines(const CLIPField
           if (perceptDistance < minDistance && perceptFieldEnd.y() > minY && perceptFieldEnd.y() < maxY && perceptFieldStart.y() > minY && perceptFieldStart.y() < maxY)
           {
             minDistance = perceptDistance;
-            minDistanceID = *line;
+            minDistanceID = line;
           }
         }
       }
       else if (isVertical)
       {
-        for (std::vector<int>::const_iterator line = linesVertical.begin(); line != linesVertical.end(); ++line)
+        for (const int line : fieldLineIndex.getCandidates(FieldLineIndex2017::vertical, perceptCenterField))
         {
-          const FieldDimensions::LinesTable::Line& fieldLine = theFieldDimensions.fieldLines.lines[(*line)];
+          const FieldDimensions::LinesTable::Line& fieldLine = theFieldDimensions.fieldLines.lines[line];
           float allowedOffset = fieldLine.length / 10;
           float minX = std::min(fieldLine.from.x(), fieldLine.to.x()) - allowedOffset;
           float maxX = std::max(fieldLine.from.x(), fieldLine.to.x()) + allowedOffset;
@@ -478,7 +486,7 @@ bool PoseHypothesis2017::updatePositionConfidenceWithSingleLines(const CLIPField
           if (perceptDistance < minDistance && perceptFieldEnd.x() > minX && perceptFieldEnd.x() < maxX && perceptFieldStart.x() > minX && perceptFieldStart.x() < maxX)
           {
             minDistance = perceptDistance;
-            minDistanceID = *line;
+            minDistanceID = line;
           }
         }
       }
@@ -510,10 +518,9 @@ bool PoseHypothesis2017::updatePositionConfidenceWithSingleLines(const CLIPField
 // LEVEL 2
 bool PoseHypothesis2017::updatePositionConfidenceWithLineCrossings(const CLIPFieldLinesPercept& theFieldLinesPercept,
     const FieldDimensions& theFieldDimensions,
+    const FieldLineIndex2017& fieldLineIndex,
     const SelfLocator2017Parameters& parameters,
-    const Pose2f& robotPose,
-    const std::vector<int>& linesHorizontal,
-    const std::vector<int>& linesVertical)
+    const Pose2f& robotPose)
 {
   return false;
 }
@@ -524,10 +531,9 @@ bool PoseHypothesis2017::updatePositionConfidenceWithLineAndLandmark(const CLIPF
     const CLIPGoalPercept& theGoalPercept,
     const PenaltyCrossPercept& thePenaltyCrossPercept,
     const FieldDimensions& theFieldDimensions,
+    const FieldLineIndex2017& fieldLineIndex,
     const SelfLocator2017Parameters& parameters,
-    const Pose2f& robotPose,
-    const std::vector<int>& linesHorizontal,
-    const std::vector<int>& linesVertical)
+    const Pose2f& robotPose)
 {
   if (containsInvalidValues())
     return false;
@@ -986,8 +992,9 @@ void PoseHypothesis2017::calculateInfiniteLineObservation(InfiniteLineObservatio
   const Vector2d poseXY(state[0], state[1]);
   const double dStart = (correspondingFieldLineSegment.start - poseXY).norm();
   const double dEnd = (correspondingFieldLineSegment.end - poseXY).norm();
-  const double angleStart = atan2(observedLine.cameraHeight, dStart);
-  const double angleEnd = atan2(observedLine.cameraHeight, dEnd);
+  // only used for the weight, so an approximation is sufficient
+  const double angleStart = FastMath::atan2(static_cast<float>(observedLine.cameraHeight), static_cast<float>(dStart));
+  const double angleEnd = FastMath::atan2(static_cast<float>(observedLine.cameraHeight), static_cast<float>(dEnd));
   const double fullWeightAngle = parameters.sensorUpdate.maxVerticalAngleFullObservationWeight;
   // Clip
   double weightStart = angleStart / (pi_2 - fullWeightAngle);
@@ -33,6 +33,7 @@
 #include "Tools/Debugging/Modify.h"
 
 #include "Modules/Modeling/WorldModelGenerator/SelfLocator2017Parameters.h"
+#include "FieldLineIndex2017.h"
 #include "PoseKalmanFilter2017.h"
 #include <atomic>
 #include "Tools/ProcessFramework/CycleLocal.h"
@@ -167,6 +168,7 @@ public:
       const CLIPGoalPercept& theGoalPercept,
       const PenaltyCrossPercept& thePenaltyCrossPercept,
       const FieldDimensions& theFieldDimensions,
+      const FieldLineIndex2017& fieldLineIndex,
       const SelfLocator2017Parameters& parameters);
 
   void updateStateRotationWithLocalFieldLines(const CLIPFieldLinesPercept& theFieldLinesPercept, const SelfLocator2017Parameters& parameters);
@@ -237,27 +239,24 @@ private:
   // LEVEL 1
   bool updatePositionConfidenceWithSingleLines(const CLIPFieldLinesPercept& theFieldLinesPercept,
       const FieldDimensions& theFieldDimensions,
+      const FieldLineIndex2017& fieldLineIndex,
       const SelfLocator2017Parameters& parameters,
-      const Pose2f& robotPose,
-      const std::vector<int>& linesHorizontal,
-      const std::vector<int>& linesVertical);
+      const Pose2f& robotPose);
   // LEVEL 2
   bool updatePositionConfidenceWithLineCrossings(const CLIPFieldLinesPercept& theFieldLinesPercept,
       const FieldDimensions& theFieldDimensions,
+      const FieldLineIndex2017& fieldLineIndex,
       const SelfLocator2017Parameters& parameters,
-      const Pose2f& robotPose,
-      const std::vector<int>& linesHorizontal,
-      const std::vector<int>& linesVertical);
+      const Pose2f& robotPose);
   // LEVEL 3
   bool updatePositionConfidenceWithLineAndLandmark(const CLIPFieldLinesPercept& theFieldLinesPercept,
       const CLIPCenterCirclePercept& theCenterCirclePercept,
       const CLIPGoalPercept& theGoalPercept,
       const PenaltyCrossPercept& thePenaltyCrossPercept,
       const FieldDimensions& theFieldDimensions,
+      const FieldLineIndex2017& fieldLineIndex,
       const SelfLocator2017Parameters& parameters,
-      const Pose2f& robotPose,
-      const std::vector<int>& linesHorizontal,
-      const std::vector<int>& linesVertical);
+      const Pose2f& robotPose);
 
   bool findGoalPostMatch(const CLIPGoalPercept::GoalPost& goalPost,
       const CameraMatrix& theCameraMatrix,
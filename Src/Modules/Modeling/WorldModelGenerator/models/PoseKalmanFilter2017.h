@@ -46,26 +46,23 @@ public:
 template <int dim> using SphericalObservationVector = std::vector<SphericalObservation<dim>>;
 template <int dim> using InfiniteLineObservationVector = std::vector<InfiniteLineObservation<dim>>;
 
+/**
+ * The update methods are const and keep their intermediate matrices on the stack, so that
+ * one instance can update several hypotheses in parallel. The matrices have a fixed maximum
+ * size, so no memory is allocated, and the innovation covariance is not inverted, but the
+ * gain is solved for with a Cholesky decomposition, since the covariance is symmetric.
+ */
 template <int stateDim, int nDim> class KalmanStateUpdateObservations2017
 {
 private:
-  Eigen::Matrix<double, nDim, stateDim> measurementModelJacobian_H;
-  Eigen::Matrix<double, stateDim, nDim> measurementModelJacobian_H_transposed;
-  Eigen::Matrix<double, nDim, nDim> innovationCovariance;
+  using MeasurementMatrix = Eigen::Matrix<double, Eigen::Dynamic, stateDim, 0, nDim, stateDim>;
+  using InnovationMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, nDim, nDim>;
+  using MeasurementVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, nDim, 1>;
+
   Eigen::Matrix<double, nDim, nDim> measurementCovariance;
-  Eigen::Matrix<double, stateDim, nDim> kalmanGain;
-  Eigen::Matrix<double, nDim, 1> expectedMeasurement;
-  Eigen::Matrix<double, nDim, 1> tempVector;
-  Eigen::Matrix<double, stateDim, stateDim> tempMatrixOfFullDimension;
 
 public:
-  KalmanStateUpdateObservations2017()
-      : measurementModelJacobian_H(Eigen::Matrix<double, nDim, stateDim>::Zero()), measurementModelJacobian_H_transposed(Eigen::Matrix<double, stateDim, nDim>::Zero()),
-        innovationCovariance(Eigen::Matrix<double, nDim, nDim>::Zero()), measurementCovariance(Eigen::Matrix<double, nDim, nDim>::Zero()),
-        kalmanGain(Eigen::Matrix<double, stateDim, nDim>::Zero()), expectedMeasurement(Eigen::Matrix<double, nDim, 1>::Zero()), tempVector(Eigen::Matrix<double, nDim, 1>::Zero()),
-        tempMatrixOfFullDimension(Eigen::Matrix<double, stateDim, stateDim>::Zero())
-  {
-  }
+  KalmanStateUpdateObservations2017() : measurementCovariance(Eigen::Matrix<double, nDim, nDim>::Zero()) {}
 
   void initMeasurementCovariance(const Matrix2d& singleMeasurementCovariance, double correlationFactorBetweenMeasurements)
   {
@@ -84,39 +81,29 @@ public:
     }
   }
 
-  Eigen::Matrix<double, stateDim, 1> updateWithLocalObservations(const SphericalObservationVector<stateDim>& sphericalObservations, Eigen::Matrix<double, stateDim, stateDim>& covariance)
+  Eigen::Matrix<double, stateDim, 1> updateWithLocalObservations(const SphericalObservationVector<stateDim>& sphericalObservations, Eigen::Matrix<double, stateDim, stateDim>& covariance) const
   {
-    Eigen::Matrix<double, stateDim, 1> movement;
-    const size_t n = 2 * sphericalObservations.size();
-
-    tempVector = Eigen::Matrix<double, nDim, 1>::Zero();
-    measurementModelJacobian_H = Eigen::Matrix<double, nDim, stateDim>::Zero();
-    measurementModelJacobian_H_transposed = Eigen::Matrix<double, stateDim, nDim>::Zero();
-    innovationCovariance = Eigen::Matrix<double, nDim, nDim>::Zero();
-    kalmanGain = Eigen::Matrix<double, stateDim, nDim>::Zero();
-    tempMatrixOfFullDimension = Eigen::Matrix<double, stateDim, stateDim>::Zero();
+    const int n = 2 * static_cast<int>(sphericalObservations.size());
 
+    MeasurementVector innovation(n);
+    MeasurementMatrix measurementModelJacobian_H(n, stateDim);
     for (unsigned int landmarkIndex = 0; landmarkIndex < sphericalObservations.size(); landmarkIndex++)
     {
       const SphericalObservation<stateDim>& observation = sphericalObservations[landmarkIndex];
       const int row = 2 * landmarkIndex;
-      tempVector[row] = (observation.realAngles.x() - observation.nominalAngles.x()) * observation.weight;
-      tempVector[row + 1] = (observation.realAngles.y() - observation.nominalAngles.y()) * observation.weight;
-      measurementModelJacobian_H.block(row, 0, 2, stateDim) = observation.measurementModelJacobian;
+      innovation[row] = (observation.realAngles.x() - observation.nominalAngles.x()) * observation.weight;
+      innovation[row + 1] = (observation.realAngles.y() - observation.nominalAngles.y()) * observation.weight;
+      measurementModelJacobian_H.template middleRows<2>(row) = observation.measurementModelJacobian;
     }
-    measurementModelJacobian_H_transposed.block(0, 0, stateDim, n) = measurementModelJacobian_H.block(0, 0, n, stateDim).transpose();
-    innovationCovariance.block(0, 0, n, n) = measurementModelJacobian_H.block(0, 0, n, stateDim) * covariance * measurementModelJacobian_H_transposed.block(0, 0, stateDim, n);
-    innovationCovariance.block(0, 0, n, n) += measurementCovariance.block(0, 0, n, n);
-    kalmanGain.block(0, 0, stateDim, n) = covariance * (measurementModelJacobian_H_transposed.block(0, 0, stateDim, n) * innovationCovariance.block(0, 0, n, n).inverse());
-    movement = kalmanGain.block(0, 0, stateDim, n) * tempVector.block(0, 0, n, 1);
-    measurementModelJacobian_H.block(0, 0, n, stateDim) *= -1.0;
-    tempMatrixOfFullDimension = kalmanGain.block(0, 0, stateDim, n) * measurementModelJacobian_H.block(0, 0, n, stateDim);
-    for (int i = 0; i < stateDim; i++)
-    {
-      tempMatrixOfFullDimension(i, i) += 1.0;
-    }
-    covariance = tempMatrixOfFullDimension * covariance;
 
+    // K = P * H^T * S^-1 is computed as K^T = S^-1 * (H * P), since P and S are symmetric
+    const MeasurementMatrix hp = measurementModelJacobian_H * covariance;
+    InnovationMatrix innovationCovariance = hp * measurementModelJacobian_H.transpose();
+    innovationCovariance += measurementCovariance.topLeftCorner(n, n);
+    const MeasurementMatrix kalmanGainTransposed = innovationCovariance.ldlt().solve(hp);
+
+    const Eigen::Matrix<double, stateDim, 1> movement = kalmanGainTransposed.transpose() * innovation;
+    covariance -= kalmanGainTransposed.transpose() * hp;
     return movement;
   }
 };
@@ -124,24 +111,14 @@ public:
 template <int stateDim, int nDim> class KalmanStateUpdateInfiniteLines2017
 {
 private:
-  Eigen::Matrix<double, nDim, stateDim> infiniteLineMeasurementModelJacobian_H;
-  Eigen::Matrix<double, stateDim, nDim> infiniteLineMeasurementModelJacobian_H_transposed;
-  Eigen::Matrix<double, nDim, nDim> infiniteLineInnovationCovariance;
+  using MeasurementMatrix = Eigen::Matrix<double, Eigen::Dynamic, stateDim, 0, nDim, stateDim>;
+  using InnovationMatrix = Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, nDim, nDim>;
+  using MeasurementVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, nDim, 1>;
+
   Eigen::Matrix<double, nDim, nDim> infiniteLineMeasurementCovariance;
-  Eigen::Matrix<double, stateDim, nDim> infiniteLineKalmanGain;
-  Eigen::Matrix<double, nDim, 1> infiniteLineExpectedMeasurement;
-  Eigen::Matrix<double, nDim, 1> infiniteLineTempVector;
-  Eigen::Matrix<double, stateDim, stateDim> tempMatrixOfFullDimension;
 
 public:
-  KalmanStateUpdateInfiniteLines2017()
-      : infiniteLineMeasurementModelJacobian_H(Eigen::Matrix<double, nDim, stateDim>::Zero()),
-        infiniteLineMeasurementModelJacobian_H_transposed(Eigen::Matrix<double, stateDim, nDim>::Zero()),
-        infiniteLineInnovationCovariance(Eigen::Matrix<double, nDim, nDim>::Zero()), infiniteLineMeasurementCovariance(Eigen::Matrix<double, nDim, nDim>::Zero()),
-        infiniteLineKalmanGain(Eigen::Matrix<double, stateDim, nDim>::Zero()), infiniteLineExpectedMeasurement(Eigen::Matrix<double, nDim, 1>::Zero()),
-        infiniteLineTempVector(Eigen::Matrix<double, nDim, 1>::Zero()), tempMatrixOfFullDimension(Eigen::Matrix<double, stateDim, stateDim>::Zero())
-  {
-  }
+  KalmanStateUpdateInfiniteLines2017() : infiniteLineMeasurementCovariance(Eigen::Matrix<double, nDim, nDim>::Zero()) {}
 
   void initMeasurementCovarianceInfiniteLine(const Eigen::Matrix<double, stateDim, stateDim>& singleInfiniteLineMeasurementCovariance, double correlationFactorBetweenMeasurements)
   {
@@ -161,43 +138,30 @@ public:
   }
 
   Eigen::Matrix<double, stateDim, 1> updateWithLocalInfiniteLineObservations(
-      const InfiniteLineObservationVector<stateDim>& infiniteLineObservations, Eigen::Matrix<double, stateDim, stateDim>& covariance)
+      const InfiniteLineObservationVector<stateDim>& infiniteLineObservations, Eigen::Matrix<double, stateDim, stateDim>& covariance) const
   {
+    const int n = stateDim * static_cast<int>(infiniteLineObservations.size());
 
-    Eigen::Matrix<double, stateDim, 1> movement;
-    const size_t n = stateDim * infiniteLineObservations.size();
-
-    infiniteLineTempVector = Eigen::Matrix<double, nDim, 1>::Zero();
-    infiniteLineMeasurementModelJacobian_H = Eigen::Matrix<double, nDim, stateDim>::Zero();
-    infiniteLineMeasurementModelJacobian_H_transposed = Eigen::Matrix<double, stateDim, nDim>::Zero();
-    infiniteLineInnovationCovariance = Eigen::Matrix<double, nDim, nDim>::Zero();
-    infiniteLineKalmanGain = Eigen::Matrix<double, stateDim, nDim>::Zero();
-    tempMatrixOfFullDimension = Eigen::Matrix<double, stateDim, stateDim>::Zero();
-
+    MeasurementVector innovation(n);
+    MeasurementMatrix measurementModelJacobian_H(n, stateDim);
     for (unsigned int index = 0; index < infiniteLineObservations.size(); index++)
     {
       const InfiniteLineObservation<stateDim>& observation = infiniteLineObservations[index];
       const int row = 3 * index;
       int sign = (observation.nominalNormals.dot(observation.realNormals) > 0) ? 1 : -1;
-      infiniteLineTempVector[row] = ((sign * observation.realNormals.x()) - observation.nominalNormals.x()) * observation.weight;
-      infiniteLineTempVector[row + 1] = ((sign * observation.realNormals.y()) - observation.nominalNormals.y()) * observation.weight;
-      infiniteLineTempVector[row + 2] = ((sign * observation.realNormals.z()) - observation.nominalNormals.z()) * observation.weight;
-      infiniteLineMeasurementModelJacobian_H.block(row, 0, 3, stateDim) = observation.measurementModelJacobian;
+      innovation[row] = ((sign * observation.realNormals.x()) - observation.nominalNormals.x()) * observation.weight;
+      innovation[row + 1] = ((sign * observation.realNormals.y()) - observation.nominalNormals.y()) * observation.weight;
+      innovation[row + 2] = ((sign * observation.realNormals.z()) - observation.nominalNormals.z()) * observation.weight;
+      measurementModelJacobian_H.template middleRows<3>(row) = observation.measurementModelJacobian;
     }
-    infiniteLineMeasurementModelJacobian_H_transposed.block(0, 0, stateDim, n) = infiniteLineMeasurementModelJacobian_H.block(0, 0, n, stateDim).transpose();
-    infiniteLineInnovationCovariance.block(0, 0, n, n) = infiniteLineMeasurementModelJacobian_H.block(0, 0, n, stateDim) * covariance
-        * infiniteLineMeasurementModelJacobian_H_transposed.block(0, 0, stateDim, n);
-    infiniteLineInnovationCovariance.block(0, 0, n, n) += infiniteLineMeasurementCovariance.block(0, 0, n, n);
-    infiniteLineKalmanGain.block(0, 0, stateDim, n) = covariance
-        * (infiniteLineMeasurementModelJacobian_H_transposed.block(0, 0, stateDim, n) * infiniteLineInnovationCovariance.block(0, 0, n, n).inverse());
-    movement.block(0, 0, stateDim, 1) = infiniteLineKalmanGain.block(0, 0, stateDim, n) * infiniteLineTempVector.block(0, 0, n, 1);
-    infiniteLineMeasurementModelJacobian_H.block(0, 0, n, stateDim) *= -1.0;
-    tempMatrixOfFullDimension = infiniteLineKalmanGain.block(0, 0, stateDim, n) * infiniteLineMeasurementModelJacobian_H.block(0, 0, n, stateDim);
-    for (int i = 0; i < stateDim; i++)
-    {
-      tempMatrixOfFullDimension(i, i) += 1.0;
-    }
-    covariance = tempMatrixOfFullDimension * covariance;
+
+    const MeasurementMatrix hp = measurementModelJacobian_H * covariance;
+    InnovationMatrix innovationCovariance = hp * measurementModelJacobian_H.transpose();
+    innovationCovariance += infiniteLineMeasurementCovariance.topLeftCorner(n, n);
+    const MeasurementMatrix kalmanGainTransposed = innovationCovariance.ldlt().solve(hp);
+
+    const Eigen::Matrix<double, stateDim, 1> movement = kalmanGainTransposed.transpose() * innovation;
+    covariance -= kalmanGainTransposed.transpose() * hp;
     return movement;
   }
 };
@@ -22,6 +22,7 @@
 #include "Representations/Sensing/ZMPModel.h"
 #include "Representations/Infrastructure/JointRequest.h"
 #include "Tools/RingBufferWithSum.h"
+#include "Tools/RingBufferWithStatistics.h"
 #include <algorithm>
 
 constexpr unsigned IMU_BUFFER_LENGTH = static_cast<unsigned>(0.5 * 83);
@@ -101,8 +102,8 @@ private:
   Vector2a fieldInclinationFromConfig = Vector2a::Zero();
   CSConverter2019Base::Parameters csConverterParams;
 
-  std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
-  std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
+  std::array<RingBufferWithStatistics<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersX;
+  std::array<RingBufferWithStatistics<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersY;
   std::array<RingBufferWithSum<Angle, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> gyroDataBuffersZ;
   std::array<RingBufferWithSum<float, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> accDataBuffersX;
   std::array<RingBufferWithSum<float, IMU_BUFFER_LENGTH>, JoinedIMUData::numOfInertialDataSources> accDataBuffersY;
@@ -736,7 +736,6 @@ void CSConverter2019::updateWalkingInfo(WalkingInfo& walkingInfo)
   walkingInfo.onFloor[RIGHT_FOOT] = currentStep.onFloor[RIGHT_FOOT];
   walkingInfo.onFloor[LEFT_FOOT] = currentStep.onFloor[LEFT_FOOT];
 
-  Pose3f limbs[Limbs::numOfLimbs];
   JointAngles jA;
   for (int i = 0; i < 12; i++)
     jA.angles[i + Joints::lHipYawPitch] = curparams.jointCalibration.jointCalibration[i];
@@ -744,14 +743,19 @@ void CSConverter2019::updateWalkingInfo(WalkingInfo& walkingInfo)
     jA.angles[i + Joints::lHipYawPitch] += curparams.jointCalibration.offsetLeft[i];
   for (int i = 0; i < 6; i++)
     jA.angles[i + Joints::rHipYawPitch] += curparams.jointCalibration.offsetRight[i];
-  ForwardKinematic::calculateLegChain(currentStep.onFloor[0], jA, theRobotDimensions, limbs);
-  Pose3f l;
-  if (currentStep.onFloor[0])
-    l = limbs[Limbs::footLeft];
-  else
-    l = limbs[Limbs::footRight];
+  if (!calibrationFootYAnglesValid
+      || !std::equal(jA.angles.begin() + Joints::lHipYawPitch, jA.angles.begin() + Joints::rAnkleRoll + 1, calibrationJointAngles.angles.begin() + Joints::lHipYawPitch))
+  {
+    Pose3f limbs[Limbs::numOfLimbs];
+    ForwardKinematic::calculateLegChain(true, jA, theRobotDimensions, limbs);
+    ForwardKinematic::calculateLegChain(false, jA, theRobotDimensions, limbs);
+    calibrationFootYAngles[LEFT_FOOT] = limbs[Limbs::footLeft].rotation.getYAngle();
+    calibrationFootYAngles[RIGHT_FOOT] = limbs[Limbs::footRight].rotation.getYAngle();
+    calibrationJointAngles = jA;
+    calibrationFootYAnglesValid = true;
+  }
 
-  walkingInfo.desiredBodyRot.y() -= l.rotation.getYAngle(); // Maybe that's a problem
+  walkingInfo.desiredBodyRot.y() -= calibrationFootYAngles[currentStep.onFloor[0] ? LEFT_FOOT : RIGHT_FOOT]; // Maybe that's a problem
   // TODO Check if right
   //walkingInfo.desiredBodyRot.y() -= l.rotation.inverse().getYAngle();
 
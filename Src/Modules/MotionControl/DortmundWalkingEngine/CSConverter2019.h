@@ -173,6 +173,11 @@ private:
   JointAngles jointError_sum, jointError_last;
   float lastComX = 0.f;
 
+  // The y angles of the calibrated feet, which only change together with the joint calibration
+  JointAngles calibrationJointAngles; /**< The leg joint angles defined by the joint calibration the angles were calculated for. */
+  float calibrationFootYAngles[2] = {0.f, 0.f};
+  bool calibrationFootYAnglesValid = false;
+
   //typedef std::list<Footposition *> FootList;
 
   //Point robotPosition; /**< Position of robot body in world coordinate system. */
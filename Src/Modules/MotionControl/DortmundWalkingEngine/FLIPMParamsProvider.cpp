@@ -46,24 +46,33 @@ FLIPMParamsProvider::FLIPMParamsProvider()
 
 void FLIPMParamsProvider::recalculate(Dimension dim)
 {
-  if (dim == X)
-  {
-    if (!xLQRParamsFuture.valid())
-      xLQRParamsFuture = std::async(std::launch::async,
-          [=]
-          {
-            return executeX();
-          });
-  }
-  else if (dim == Y)
-  {
-    if (!yLQRParamsFuture.valid())
-      yLQRParamsFuture = std::async(std::launch::async,
-          [=]
-          {
-            return executeY();
-          });
-  }
+  const FLIPMValues& params = dim == X ? paramsX : paramsY;
+  LQRParams& lqrParams = dim == X ? xLQRParams : yLQRParams;
+  std::future<LQRParams>& lqrParamsFuture = dim == X ? xLQRParamsFuture : yLQRParamsFuture;
+  if (lqrParamsFuture.valid())
+    return;
+
+  for (const LQRParams& cachedParams : cachedLQRParams)
+    if (cachedParams.values.equal(params) && cachedParams.cycleTime == theFrameInfo.cycleTime && cachedParams.gravity == theWalkCalibration.gravity)
+    {
+      lqrParams = cachedParams;
+      return;
+    }
+
+  lqrParamsFuture = std::async(std::launch::async,
+      [this, params, cycleTime = theFrameInfo.cycleTime, gravity = theWalkCalibration.gravity]
+      {
+        return execute(params, cycleTime, gravity);
+      });
+}
+
+void FLIPMParamsProvider::cache(const LQRParams& lqrParams)
+{
+  if (!lqrParams.valid)
+    return;
+  cachedLQRParams.push_front(lqrParams);
+  if (cachedLQRParams.size() > maxNumOfCachedLQRParams)
+    cachedLQRParams.pop_back();
 }
 
 void FLIPMParamsProvider::update(FLIPMControllerParameter& flipmControllerParameter)
@@ -93,6 +102,7 @@ void FLIPMParamsProvider::update(FLIPMControllerParameter& flipmControllerParame
   if (xLQRParamsFuture.valid() && xLQRParamsFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
   {
     xLQRParams = xLQRParamsFuture.get();
+    cache(xLQRParams);
     if (xLQRParams.valid)
     {
       //SystemCall::playSound("allright.wav");
@@ -111,6 +121,7 @@ void FLIPMParamsProvider::update(FLIPMControllerParameter& flipmControllerParame
   if (yLQRParamsFuture.valid() && yLQRParamsFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
   {
     yLQRParams = yLQRParamsFuture.get();
+    cache(yLQRParams);
     if (yLQRParams.valid)
     {
       //SystemCall::playSound("allright.wav");
@@ -171,18 +182,19 @@ void FLIPMParamsProvider::update(FLIPMObserverParameter& flipmObserverParameter)
     flipmObserverParameter.observerParamsY.L = xLQRParams.L;
 }
 
-FLIPMParamsProvider::LQRParams FLIPMParamsProvider::execute(Dimension dim)
+FLIPMParamsProvider::LQRParams FLIPMParamsProvider::execute(const FLIPMValues& params, float cycleTime, float gravity)
 {
-  const FLIPMValues& params = dim == Dimension::X ? paramsX : paramsY;
-
   LQRParams lqrParams;
   lqrParams.clear();
+  lqrParams.values = params;
+  lqrParams.cycleTime = cycleTime;
+  lqrParams.gravity = gravity;
 
-  double dt = theFrameInfo.cycleTime;
+  double dt = cycleTime;
   double dt2 = (dt * dt) / 2;
   double dt3 = (dt * dt * dt) / 6;
   double z_h = params.z_h;
-  double g = theWalkCalibration.gravity;
+  double g = gravity;
 
   double M = params.M;
   double m = params.m;
@@ -7,6 +7,7 @@
 #include "Tools/Streams/RobotParameters.h"
 #include "Tools/Module/Module.h"
 
+#include <deque>
 #include <future>
 
 constexpr unsigned MODEL_STATE_DIM = 6;
@@ -50,6 +51,9 @@ public:
     bool controllable;
     bool observable;
     double calculationTime;
+    FLIPMValues values; /**< The parameters the gains were computed for. */
+    float cycleTime = 0.f; /**< The cycle time the gains were computed for. */
+    float gravity = 0.f; /**< The gravity the gains were computed for. */
 
     void clear()
     {
@@ -84,6 +88,13 @@ protected:
   bool initializedFLIPMParams = false;
   FLIPMParameter lastFLIPMParams;
 
+  /**
+   * The valid gains computed so far, the most recent one first. Switching back to a parameter set
+   * whose gains are in here does not need a recalculation at all.
+   */
+  std::deque<LQRParams> cachedLQRParams;
+  static constexpr size_t maxNumOfCachedLQRParams = 8;
+
   void update(FLIPMParameter& flipmParameter)
   {
     flipmParameter.paramsX = paramsX;
@@ -91,11 +102,22 @@ protected:
   }
   void update(FLIPMControllerParameter& flipmControllerParameter);
   void update(FLIPMObserverParameter& flipmObserverParameter);
+  /**
+   * Provides the gains for the current parameters of a dimension. They are taken from the cache if they
+   * were computed before. Otherwise, they are computed in the background.
+   */
   void recalculate(Dimension dim);
 
-  LQRParams execute(Dimension dim);
-  LQRParams executeX() { return execute(X); }
-  LQRParams executeY() { return execute(Y); }
+  /** Adds valid gains to the cache, replacing the least recently computed ones if it is full. */
+  void cache(const LQRParams& lqrParams);
+
+  /**
+   * Computes the gains. Since this runs in the background, it only works on copies of its inputs.
+   * @param params The parameters of the model.
+   * @param cycleTime The duration of a motion frame in seconds.
+   * @param gravity The gravity in m/s^2.
+   */
+  LQRParams execute(const FLIPMValues& params, float cycleTime, float gravity);
 
   /// Returns absolute elementwise @p tolerance.
   /// Special values (infinities, NaN, etc.) do not compare as equal elements.
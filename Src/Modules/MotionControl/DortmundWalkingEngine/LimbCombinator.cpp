@@ -29,10 +29,7 @@ void LimbCombinator::update(WalkingEngineOutput& walkingEngineOutput)
 
   if (!init || theWalkingEngineParams.outFilterOrder != lastOutFilterOrder)
   {
-    for (int i = 0; i < Joints::numOfJoints; i++)
-    {
-      filter[i].createBuffer(theWalkingEngineParams.outFilterOrder);
-    }
+    filter.reset(std::max(theWalkingEngineParams.outFilterOrder, 1));
 
     lHipPitchTargetAngle.clear();
     rHipPitchTargetAngle.clear();
@@ -44,9 +41,9 @@ void LimbCombinator::update(WalkingEngineOutput& walkingEngineOutput)
     init = true;
   }
 
+  filter.filter(theKinematicOutput.angles, walkingEngineOutput.angles);
   for (int i = 0; i < Joints::numOfJoints; i++)
   {
-    walkingEngineOutput.angles[i] = filter[i].nextValue(theKinematicOutput.angles[i]);
     if (std::isnan((float)walkingEngineOutput.angles[i]))
     {
       OutMapFile map("logs/limbCombinator.cfg");
@@ -14,7 +14,7 @@
 #include "Representations/MotionControl/FootSteps.h"
 #include "Representations/MotionControl/TargetCoM.h"
 #include "Tools/RingBuffer.h"
-#include "Tools/Math/Filter/FastFilter.h"
+#include "Tools/Motion/JointBlending.h"
 #include "Representations/Infrastructure/SensorData/JointSensorData.h"
 #include "Tools/Math/angleerror.hpp"
 
@@ -54,7 +54,7 @@ private:
   void update(WalkingEngineOutput& walkingEngineOutput);
   bool init;
   int lastOutFilterOrder;
-  FastFilter<float> filter[Joints::numOfJoints];
+  JointBlending::MovingAverage filter; /**< Smoothes the angles of all joints. */
 
   RingBuffer<Angle, MAX_DELAY_FRAMES> lHipPitchTargetAngle, rHipPitchTargetAngle;
 };
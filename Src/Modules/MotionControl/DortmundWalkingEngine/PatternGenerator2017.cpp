@@ -195,7 +195,7 @@ void PatternGenerator2017::transitionToWalk()
   {
     localRefZMP2018.zmpWCS.pop_back();
     localRefZMP2018.zmpRCS.pop_back();
-    plannedFootSteps.steps.pop_back();
+    plannedFootSteps.popStep();
   }
   localSteps.reset();
 }
@@ -1632,13 +1632,13 @@ void PatternGenerator2017::createFootStepTrajectory()
       offsetForThisFrame.y = offsetSpline[curStep.singleSupportDurationInFrames - i - 1].y * footDiffRelative.translation.y();
       offsetForThisFrame.z = offsetSpline[curStep.singleSupportDurationInFrames - i - 1].z * walkStepHeight;
       offsetForThisFrame.r = offsetSpline[curStep.singleSupportDurationInFrames - i - 1].r * footDiff.rotation;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].r = lastLeftFootPose2f.rotation + offsetForThisFrame.r;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].r = lastLeftFootPose2f.rotation + offsetForThisFrame.r;
       offsetForThisFrame.rotate2D(lastLeftFootPose2f.rotation);
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].x = lastLeftFootPose2f.translation.x() + offsetForThisFrame.x;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].y = lastLeftFootPose2f.translation.y() + offsetForThisFrame.y;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].z = offsetForThisFrame.z;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].rx = 0.f;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].ry = 0.f;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].x = lastLeftFootPose2f.translation.x() + offsetForThisFrame.x;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].y = lastLeftFootPose2f.translation.y() + offsetForThisFrame.y;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].z = offsetForThisFrame.z;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].rx = 0.f;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].ry = 0.f;
     }
   }
   if (footNum == RIGHT_FOOT)
@@ -1652,13 +1652,13 @@ void PatternGenerator2017::createFootStepTrajectory()
       offsetForThisFrame.y = offsetSpline[curStep.singleSupportDurationInFrames - i - 1].y * footDiffRelative.translation.y();
       offsetForThisFrame.z = offsetSpline[curStep.singleSupportDurationInFrames - i - 1].z * walkStepHeight;
       offsetForThisFrame.r = offsetSpline[curStep.singleSupportDurationInFrames - i - 1].r * footDiff.rotation;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].r = lastRightFootPose2f.rotation + offsetForThisFrame.r;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].r = lastRightFootPose2f.rotation + offsetForThisFrame.r;
       offsetForThisFrame.rotate2D(lastRightFootPose2f.rotation);
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].x = lastRightFootPose2f.translation.x() + offsetForThisFrame.x;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].y = lastRightFootPose2f.translation.y() + offsetForThisFrame.y;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].z = offsetForThisFrame.z;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].rx = 0.f;
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum].ry = 0.f;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].x = lastRightFootPose2f.translation.x() + offsetForThisFrame.x;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].y = lastRightFootPose2f.translation.y() + offsetForThisFrame.y;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].z = offsetForThisFrame.z;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].rx = 0.f;
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum].ry = 0.f;
     }
   }
   if (numCustomStepOffsets > 0)
@@ -1666,7 +1666,7 @@ void PatternGenerator2017::createFootStepTrajectory()
     // we should not have an offset that is too long since we do not reset within custom steps atm
     int numOfOffsetsToAdd = std::min<int>(trajectorySteps, numCustomStepOffsets);
     for (int i = 0; i < numOfOffsetsToAdd; i++)
-      plannedFootSteps.steps.at(numOfSteps - i - 1).footPos[footNum] += lastCustomStepSpline.at(numCustomStepOffsets - i - 1);
+      plannedFootSteps.getStep(numOfSteps - i - 1).footPos[footNum] += lastCustomStepSpline.at(numCustomStepOffsets - i - 1);
   }
 }
 
@@ -1777,20 +1777,20 @@ void PatternGenerator2017::fillFootSteps()
 
   if (useResetPreview && running)
   {
-    bool leftStep = (plannedFootSteps.steps[0].phase == secondSingleSupport || plannedFootSteps.steps[0].phase == secondDoubleSupport);
+    bool leftStep = (plannedFootSteps.getStep(0).phase == secondSingleSupport || plannedFootSteps.getStep(0).phase == secondDoubleSupport);
     if (leftStep)
     {
-      robotPose2fAfterCurrentStep = Pose2f(plannedFootSteps.steps[0].leftFootPose2f);
+      robotPose2fAfterCurrentStep = Pose2f(plannedFootSteps.getStep(0).leftFootPose2f);
       robotPose2fAfterCurrentStep.translate(0.f, -theWalkingEngineParams.footMovement.footYDistance);
     }
     else
     {
-      robotPose2fAfterCurrentStep = Pose2f(plannedFootSteps.steps[0].rightFootPose2f);
+      robotPose2fAfterCurrentStep = Pose2f(plannedFootSteps.getStep(0).rightFootPose2f);
       robotPose2fAfterCurrentStep.translate(0.f, theWalkingEngineParams.footMovement.footYDistance);
     }
   }
 
-  if (useResetPreview && !plannedFootSteps.steps.empty() && !plannedFootSteps.steps[0].customStepRunning)
+  if (useResetPreview && !plannedFootSteps.steps.empty() && !plannedFootSteps.getStep(0).customStepRunning)
   {
     localSteps.robotPoseAfterStep = Point(robotPose2fAfterCurrentStep);
   }
@@ -1898,9 +1898,9 @@ void PatternGenerator2017::updateFootPositions()
     // check for DS phase extension
     if ((currentState == walking || currentState == customSteps) && (slowDSRefZMPUntilFSR || freezeDSRefZMPUntilFSR) && walkingPhaseExtension < maxFramesForDSExtension)
     {
-      const Footposition& nextFootPosition = plannedFootSteps.steps[0];
+      const Footposition& nextFootPosition = plannedFootSteps.getStep(0);
       WalkingPhase nextPhase = nextFootPosition.phase;
-      WalkingPhase overNextPhase = plannedFootSteps.steps[1].phase;
+      WalkingPhase overNextPhase = plannedFootSteps.getStep(1).phase;
       if ((nextPhase == secondDoubleSupport && overNextPhase == firstSingleSupport && supportFootState == rightSupportOnly)
           || (nextPhase == firstDoubleSupport && overNextPhase == secondSingleSupport && supportFootState == leftSupportOnly))
       {
@@ -1942,12 +1942,12 @@ void PatternGenerator2017::updateFootPositions()
       stepsSinceLastCustomStep = 0;
     }
 
-    resetPreviewPossible = plannedFootSteps.steps.size() > 1 && (!plannedFootSteps.steps[0].prependStepRunning || resetPreviewDuringPrependStep)
-        && !plannedFootSteps.steps[0].customStepRunning && (plannedFootSteps.steps[0].phase == firstSingleSupport || plannedFootSteps.steps[0].phase == secondSingleSupport)
-        && (plannedFootSteps.steps[0].singleSupportDurationInFrames > 10 && plannedFootSteps.steps[0].frameInPhase == plannedFootSteps.steps[0].singleSupportDurationInFrames - 10);
+    resetPreviewPossible = plannedFootSteps.steps.size() > 1 && (!plannedFootSteps.getStep(0).prependStepRunning || resetPreviewDuringPrependStep)
+        && !plannedFootSteps.getStep(0).customStepRunning && (plannedFootSteps.getStep(0).phase == firstSingleSupport || plannedFootSteps.getStep(0).phase == secondSingleSupport)
+        && (plannedFootSteps.getStep(0).singleSupportDurationInFrames > 10 && plannedFootSteps.getStep(0).frameInPhase == plannedFootSteps.getStep(0).singleSupportDurationInFrames - 10);
     if (resetPreviewPossible)
     {
-      resetFootPosition = plannedFootSteps.steps[0];
+      resetFootPosition = plannedFootSteps.getStep(0);
     }
     if (walkingPhaseExtension == 0)
     {
@@ -2187,7 +2187,7 @@ void PatternGenerator2017::previewReset()
     {
       float xCorrection = std::min(maxSafetyStepCorrection.x(), comErrorX) / 1000.f;
       ANNOTATION("PatternGenerator2017", "safetyStep triggered with error " << xCorrection);
-      if (plannedFootSteps.steps[0].onFloor[LEFT_FOOT])
+      if (plannedFootSteps.getStep(0).onFloor[LEFT_FOOT])
         rightFootPose2f.translate(xCorrection, 0.f);
       else
         leftFootPose2f.translate(xCorrection, 0.f);
@@ -2196,7 +2196,7 @@ void PatternGenerator2017::previewReset()
     {
       float xCorrection = std::max(-maxSafetyStepCorrection.x(), comErrorX) / 1000.f;
       ANNOTATION("PatternGenerator2017", "safetyStep triggered with error " << xCorrection);
-      if (plannedFootSteps.steps[0].onFloor[LEFT_FOOT])
+      if (plannedFootSteps.getStep(0).onFloor[LEFT_FOOT])
         rightFootPose2f.translate(xCorrection, 0.f);
       else
         leftFootPose2f.translate(xCorrection, 0.f);
@@ -2207,7 +2207,7 @@ void PatternGenerator2017::previewReset()
   lastStep = resetFootPosition;
   lastStep.onFloor[LEFT_FOOT] = true;
   lastStep.onFloor[RIGHT_FOOT] = true;
-  if (plannedFootSteps.steps[0].onFloor[LEFT_FOOT]) // check what the next planned step would have done
+  if (plannedFootSteps.getStep(0).onFloor[LEFT_FOOT]) // check what the next planned step would have done
   {
     robotPose2f = rightFootPose2f;
     robotPose2f.translate(0, theWalkingEngineParams.footMovement.footYDistance);
@@ -2247,7 +2247,7 @@ void PatternGenerator2017::previewReset()
 void PatternGenerator2017::updatePose()
 {
   if (!plannedFootSteps.steps.empty())
-    footPosBuf.push_front(plannedFootSteps.steps[0]);
+    footPosBuf.push_front(plannedFootSteps.getStep(0));
 
   if (!footPosBuf.empty())
   {
@@ -2303,7 +2303,7 @@ void PatternGenerator2017::update(SpeedInfo& speedInfo)
   speedInfo.deceleratedByAcc = decelByAcc;
   speedInfo.currentCustomStep = currentCustomStep;
   if (!plannedFootSteps.empty())
-    speedInfo.currentCustomStep = plannedFootSteps.steps[0].customStepRunning ? plannedFootSteps.steps[0].customStep : WalkRequest::StepRequest::none;
+    speedInfo.currentCustomStep = plannedFootSteps.getStep(0).customStepRunning ? plannedFootSteps.getStep(0).customStep : WalkRequest::StepRequest::none;
 
   speedInfo.lastCustomStep = previousCustomStep;
   speedInfo.lastCustomStepTimestamp = previousCustomStepTimeStamp;
@@ -2311,7 +2311,7 @@ void PatternGenerator2017::update(SpeedInfo& speedInfo)
 
   speedInfo.customStepKickInPreview = customStepKickInPreview;
   if (!plannedFootSteps.empty())
-    speedInfo.stepsSinceLastCustomStep = plannedFootSteps.steps[0].stepsSinceCustomStep;
+    speedInfo.stepsSinceLastCustomStep = plannedFootSteps.getStep(0).stepsSinceCustomStep;
   else
     speedInfo.stepsSinceLastCustomStep = 0;
 
@@ -2439,7 +2439,7 @@ void PatternGenerator2017::draw()
 
   COMPLEX_DRAWING3D("module:PatternGenerator2017:customSteps")
   {
-    //if (!plannedFootSteps.steps.empty() && (plannedFootSteps.steps[0].customStepRunning || plannedFootSteps.steps[0].prependStepRunning))
+    //if (!plannedFootSteps.steps.empty() && (plannedFootSteps.getStep(0).customStepRunning || plannedFootSteps.getStep(0).prependStepRunning))
     if (!plannedFootSteps.steps.empty() && (footPosBuf.back().customStepRunning || footPosBuf.back().prependStepRunning))
     {
       if (debugRobotPose.translation.x() == 0.f && debugRobotPose.translation.y() == 0.f && debugRobotPose.rotation == 0_deg)
@@ -2491,12 +2491,12 @@ void PatternGenerator2017::draw()
 
   COMPLEX_DRAWING3D("module:PatternGenerator2017:feet")
   {
-    const auto& steps = plannedFootSteps.steps;
-    if (!steps.empty())
+    if (!plannedFootSteps.empty())
     {
       int counter = debugStepPos;
-      for (const auto& step : steps)
+      for (int i = 0; i < plannedFootSteps.getNumOfSteps(); ++i)
       {
+        const Footposition& step = plannedFootSteps.getStep(i);
         const bool isSingleSupport = step.phase == firstSingleSupport || step.phase == secondSingleSupport;
         const bool isRight = step.phase == secondDoubleSupport || step.phase == firstSingleSupport;
         const Point& footPos = step.footPos[isRight];
@@ -2518,7 +2518,7 @@ void PatternGenerator2017::draw()
           FOOT3D("module:PatternGenerator2017:feet", foot3f, true, color);
       }
 
-      if (steps[0].phase == firstDoubleSupport || steps[0].phase == secondDoubleSupport)
+      if (plannedFootSteps.getStep(0).phase == firstDoubleSupport || plannedFootSteps.getStep(0).phase == secondDoubleSupport)
         ++debugStepPos;
     }
   }
@@ -14,13 +14,11 @@
 void JointErrorCalc::update(JointError& jointError)
 {
   init(jointError);
-  for (int j = 0; j < Joints::numOfJoints; j++)
-    jointAngleBuffer[currentJointAngleID].angles[j] = theRawJointRequest.angles[j];
-  currentJointAngleID++;
-  currentJointAngleID = currentJointAngleID % 5;
+  requestHistory.push_front(theRawJointRequest.angles);
+  const std::size_t delay = std::min<std::size_t>(std::max(theWalkingEngineParams.jointSensorDelayFrames, 2u) - 2, requestHistory.capacity() - 1);
   for (int i = 0; i < Joints::numOfJoints; i++)
   {
-    jointError.angles[i] = jointAngleBuffer[theWalkingEngineParams.jointSensorDelayFrames - 2].angles[i] - theJointSensorData.angles[i];
+    jointError.angles[i] = requestHistory[delay][i] - theJointSensorData.angles[i];
   }
 
   jointPlayCalc(jointError);
@@ -30,15 +28,9 @@ void JointErrorCalc::init(JointError& jointError)
 {
   if (initialized == false)
   {
-    for (int i = 0; i < 5; i++)
-      for (int j = 0; j < Joints::numOfJoints; j++)
-        jointAngleBuffer[i].angles[j] = theRawJointRequest.angles[j];
+    requestHistory.fill(theRawJointRequest.angles);
     for (std::size_t i = 0; i < JointPlayTrack::numOfJointPlayTracks; i++)
-    {
       bufferValue[i] = 0.f;
-      // TODO is this even needed?
-      bufferRequest[i].clear();
-    }
     initialized = true;
   }
 }
@@ -62,19 +54,17 @@ void JointErrorCalc::jointPlayCalc(JointError& jointError)
   //FOREACH_ENUM(JointPlayTrack, joint)
   for (JointPlayTrack joint = JointPlayTrack::lhyp; joint < JointPlayTrack::numOfJointPlayTracks; joint = JointPlayTrack(joint + 1))
   {
-    // Buffer joint request, because of motion delay
-    bufferRequest[joint].push_front(theRawJointRequest.angles[getJoint(joint)]);
-    if (!bufferRequest[joint].full())
-      continue;
+    // The joint request of 3 frames ago, because of motion delay
+    const Angle request = requestHistory[3][getJoint(joint)];
     if (skipBuffer)
       continue;
     // Filter differences
     // TODO Check if jointPlayList can be deleted. Seems to be just a useless copy
     const Angle useJointPlayOffset = joint == lap || joint == rap ? jointPlayOffset : 0_deg;
     bufferValue[joint] = bufferValue[joint] * (1.f - useLowPassFilterFactor)
-        + (std::abs(theJointSensorData.angles[getJoint(joint)] - bufferRequest[joint].back()) - (maxJointPlay[joint] - useJointPlayOffset)) * useLowPassFilterFactor;
+        + (std::abs(theJointSensorData.angles[getJoint(joint)] - request) - (maxJointPlay[joint] - useJointPlayOffset)) * useLowPassFilterFactor;
     bufferValueShortTerm[joint] = bufferValueShortTerm[joint] * (1.f - lowpassFilterFactor.max)
-        + (std::abs(theJointSensorData.angles[getJoint(joint)] - bufferRequest[joint].back()) - (maxJointPlay[joint] - useJointPlayOffset)) * lowpassFilterFactor.max;
+        + (std::abs(theJointSensorData.angles[getJoint(joint)] - request) - (maxJointPlay[joint] - useJointPlayOffset)) * lowpassFilterFactor.max;
 
     jointPlayList[joint] = bufferValue[joint];
     jointPlaySum += std::max(jointPlayList[joint], 0_deg) * maxJointPlayRatio[joint];
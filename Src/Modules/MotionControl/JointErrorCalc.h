@@ -15,6 +15,7 @@
 #include "Representations/MotionControl/Footpositions.h"
 #include "Representations/MotionControl/FootSteps.h"
 #include "Tools/Joints.h"
+#include "Tools/JointHistory.h"
 #include "Tools/Module/Module.h"
 #include "Tools/Enum.h"
 
@@ -62,16 +63,14 @@ private:
   void update(JointError& jointError);
   void init(JointError& jointError);
   void jointPlayCalc(JointError& jointError);
-  JointAngles jointAngleBuffer[5];
   bool initialized = false;
-  int currentJointAngleID = 0;
 
   // Converts JointPlayTrack into the Joint enum
   Joints::Joint getJoint(JointPlayTrack joint);
 
 
-  // Buffer for the joint request. Needed because of the motion delay, until a request is executed
-  RingBufferWithSum<Angle, 4> bufferRequest[JointPlayTrack::numOfJointPlayTracks];
+  // Buffer for the joint requests of all joints. Needed because of the motion delay, until a request is executed
+  JointHistory<float, 5> requestHistory;
 
   // Filtered values over a long periode of time.
   Angle bufferValue[JointPlayTrack::numOfJointPlayTracks];
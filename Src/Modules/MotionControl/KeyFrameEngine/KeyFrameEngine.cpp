@@ -10,6 +10,7 @@
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Settings.h"
 #include "Platform/File.h"
+#include "Tools/Motion/ForwardKinematic.h"
 #include <sstream>
 #include <iomanip>
 
@@ -65,6 +66,7 @@ void KeyFrameEngine::init(SpecialActionsOutput& specialActionsOutput)
   if (!initialized)
   {
     keyFrameMotions = loadKeyFrameMotions();
+    compileKeyFrameMotions();
     initEngineData(specialActionsOutput);
   }
   // set to current joint angles and default stiffness
@@ -131,6 +133,7 @@ void KeyFrameEngine::update(SpecialActionsOutput& specialActionsOutput)
   DEBUG_RESPONSE_ONCE("loadKeyFrames")
   {
     keyFrameMotions = loadKeyFrameMotions();
+    compileKeyFrameMotions();
   }
   DEBUG_RESPONSE_ONCE("printKeyFrame")
   {
@@ -280,7 +283,7 @@ bool KeyFrameEngine::interpolate(SpecialActionsOutput& specialActionsOutput)
   if (phase == 1.f)
     return true;
   KeyFrameMotion& currentKeyFrameMotion = keyFrameMotions.at(currentKeyFrameMotionIndex);
-  KeyFrameMotion::KeyFrame currentKeyFrame = currentKeyFrameMotion.keyFrames.at(currentKeyFrameIndex);
+  const KeyFrameMotion::KeyFrame& currentKeyFrame = getKeyFrame(currentKeyFrameMotionIndex, currentKeyFrameIndex);
 
   if (!areMotionsPrioritized() && theFallDownState.state == FallDownState::falling)
   {
@@ -289,9 +292,6 @@ bool KeyFrameEngine::interpolate(SpecialActionsOutput& specialActionsOutput)
     chooseFallDownProtection(currentKeyFrame.fallDownProtection, currentKeyFrame.holdFallDownProtection, currentKeyFrame.activateFallDownProtection);
   }
 
-  if (currentKeyFrameMirror)
-    currentKeyFrame.mirror();
-
   if (phase == 0.f)
   {
     keyFrameWasFinished = false;
@@ -301,9 +301,7 @@ bool KeyFrameEngine::interpolate(SpecialActionsOutput& specialActionsOutput)
     }
     else
     {
-      lastKeyFrame = currentKeyFrameMotion.keyFrames.at(currentKeyFrameIndex - 1);
-      if (currentKeyFrameMirror)
-        lastKeyFrame.mirror();
+      lastKeyFrame = getKeyFrame(currentKeyFrameMotionIndex, currentKeyFrameIndex - 1);
     }
     lastKeyFrame = setKeyFrameAngles(lastKeyFrame);
   }
@@ -401,15 +399,19 @@ void KeyFrameEngine::stabilize(SpecialActionsOutput& specialActionsOutput)
   // set desired stance with joint request data from <sensorDelay> frames ago
   // newest data is not set yet, so use current request if sensorDelay == 0
   ASSERT(theWalkingEngineParams.jointSensorDelayFrames <= MAX_DELAY_FRAMES);
+  // only the poses of the legs are used, so the whole robot model including its center of mass is not needed
   RobotModel desiredStance;
-  if (theWalkingEngineParams.jointSensorDelayFrames == 0)
-    desiredStance.setJointData((JointAngles&)specialActionsOutput, theRobotDimensions, theMassCalibration);
-  else
-    desiredStance.setJointData(jointAngleBuffer[(currentJointAngleID + 5 - (theWalkingEngineParams.jointSensorDelayFrames - 1)) % 5], theRobotDimensions, theMassCalibration);
+  const JointAngles& desiredJointAngles = theWalkingEngineParams.jointSensorDelayFrames == 0
+      ? static_cast<const JointAngles&>(specialActionsOutput)
+      : jointAngleBuffer[(currentJointAngleID + 5 - (theWalkingEngineParams.jointSensorDelayFrames - 1)) % 5];
+  ForwardKinematic::calculateLegChain(true, desiredJointAngles, theRobotDimensions, desiredStance.limbs);
+  ForwardKinematic::calculateLegChain(false, desiredJointAngles, theRobotDimensions, desiredStance.limbs);
 
   // get desired gyro with request data from <sensorDelay - 1> frames ago
   RobotModel lastDesiredStance;
-  lastDesiredStance.setJointData(jointAngleBuffer[(currentJointAngleID + 5 - (theWalkingEngineParams.jointSensorDelayFrames - 2)) % 5], theRobotDimensions, theMassCalibration);
+  const JointAngles& lastDesiredJointAngles = jointAngleBuffer[(currentJointAngleID + 5 - (theWalkingEngineParams.jointSensorDelayFrames - 2)) % 5];
+  ForwardKinematic::calculateLegChain(true, lastDesiredJointAngles, theRobotDimensions, lastDesiredStance.limbs);
+  ForwardKinematic::calculateLegChain(false, lastDesiredJointAngles, theRobotDimensions, lastDesiredStance.limbs);
   Angle desiredGyroY = desiredStance.limbs[Limbs::torso].rotation.getYAngle() - lastDesiredStance.limbs[Limbs::torso].rotation.getYAngle();
 
   //Y - using body angle and desired gyro for stabilization
@@ -521,18 +523,30 @@ std::vector<KeyFrameMotion> KeyFrameEngine::loadKeyFrameMotions()
   return keyFrameMotions;
 }
 
+void KeyFrameEngine::compileKeyFrameMotions()
+{
+  motionIndices.fill(-1);
+  mirroredKeyFrames.resize(keyFrameMotions.size());
+  for (int i = 0; i < (int)keyFrameMotions.size(); i++)
+  {
+    const KeyFrameMotion& keyFrameMotion = keyFrameMotions[i];
+    if (keyFrameMotion.keyFrameID >= 0 && keyFrameMotion.keyFrameID < SpecialActionRequest::numOfSpecialActionIDs)
+      motionIndices[keyFrameMotion.keyFrameID] = i;
+    mirroredKeyFrames[i] = keyFrameMotion.keyFrames;
+    for (KeyFrameMotion::KeyFrame& keyFrame : mirroredKeyFrames[i])
+      keyFrame.mirror();
+  }
+}
+
 void KeyFrameEngine::selectActiveMotion(SpecialActionRequest::SpecialActionID id, bool mirror, SpecialActionsOutput& specialActionsOutput)
 {
   const SpecialActionRequest::SpecialActionID defaultMotion = SpecialActionRequest::playDead;
-  bool foundMotion = false;
-  for (int i = 0; i < (int)keyFrameMotions.size(); i++)
-    if (id == keyFrameMotions.at(i).keyFrameID)
-    {
-      currentKeyFrameMotionIndex = i;
-      foundMotion = true;
-    }
+  const bool foundMotion = motionIndices[id] >= 0;
   if (foundMotion)
+  {
+    currentKeyFrameMotionIndex = motionIndices[id];
     specialActionsOutput.executedSpecialAction.specialAction = id;
+  }
   else if (id == defaultMotion)
     specialActionsOutput.executedSpecialAction.specialAction = keyFrameMotions.at(0).keyFrameID; // we should at least have one motion loaded..
   else
@@ -767,6 +781,7 @@ bool KeyFrameEngine::handleMessage2(InMessage& message)
   if (message.getMessageID() == idKeyFrameMotions)
   {
     STREAM_EXT(message.bin, keyFrameMotions);
+    compileKeyFrameMotions();
     return true;
   }
   else
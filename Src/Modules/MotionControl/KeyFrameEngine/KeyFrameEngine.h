@@ -130,6 +130,15 @@ private:
   // select specific KeyFrameMotion, fall back to default (stand) if not found
   void selectActiveMotion(SpecialActionRequest::SpecialActionID id, bool mirror, SpecialActionsOutput& specialActionsOutput);
 
+  // build the lookup table of the motion indices and the mirrored key frames whenever keyFrameMotions changed
+  void compileKeyFrameMotions();
+
+  // the key frame with the given indices in keyFrameMotions, mirrored if the current motion is mirrored
+  const KeyFrameMotion::KeyFrame& getKeyFrame(int motionIndex, int keyFrameIndex) const
+  {
+    return currentKeyFrameMirror ? mirroredKeyFrames.at(motionIndex).at(keyFrameIndex) : keyFrameMotions.at(motionIndex).keyFrames.at(keyFrameIndex);
+  }
+
   std::queue<bool> specialActionMirrorQueue;
   std::queue<unsigned> specialActionTimerQueue;
   std::queue<SpecialActionRequest::SpecialActionID> specialActionIDQueue;
@@ -159,6 +168,8 @@ private:
   bool engineDataReset = false; /* Whether the engine data including phase, angles and sensor buffers was reset. */
   //bool abortMotion = false; /* Whether the current KeyFrameMotion should be aborted. Not used at the moment. */
   std::vector<KeyFrameMotion> keyFrameMotions; // overwritten by loadKeyFrameMotions()
+  std::vector<std::vector<KeyFrameMotion::KeyFrame>> mirroredKeyFrames; /* The mirrored key frames of each KeyFrameMotion, so they are not mirrored in every frame. */
+  std::array<int, SpecialActionRequest::numOfSpecialActionIDs> motionIndices; /* The index in keyFrameMotions of each SpecialActionID, -1 if it was not loaded. */
 
   int currentKeyFrameMotionIndex = 0; /* The index of the active KeyFrameMotion in the vector of all KeyFrameMotions. */
   int currentKeyFrameIndex = -1; /* The index of the active KeyFrame in the vector of all KeyFrames in the current KeyFrameMotion. */
@@ -79,7 +79,10 @@ void KickEngine::update(KickEngineOutput& kickEngineOutput)
 
       if (data.calcJoints(kickEngineOutput, theRobotDimensions, theHeadJointRequest))
       {
-        data.balanceCOM(kickEngineOutput, theRobotDimensions, theMassCalibration, theJoinedIMUData.imuData[anglesource]);
+        STOPWATCH("KickEngine:balanceCOM")
+        {
+          data.balanceCOM(kickEngineOutput, theRobotDimensions, theMassCalibration, theJoinedIMUData.imuData[anglesource]);
+        }
         data.calcJoints(kickEngineOutput, theRobotDimensions, theHeadJointRequest);
         data.mirrorIfNecessary(kickEngineOutput);
       }
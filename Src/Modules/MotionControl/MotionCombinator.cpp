@@ -6,6 +6,7 @@
 */
 
 #include "MotionCombinator.h"
+#include "Tools/Motion/JointBlending.h"
 #include "Tools/SensorData.h"
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Math/RotationMatrix.h"
@@ -133,10 +134,7 @@ void MotionCombinator::update(RawJointRequest& rawJointRequest)
     for (int i = 0; i < MotionRequest::numOfMotions; ++i)
       if (i != theMotionSelection.targetMotion && theMotionSelection.ratios[i] > 0.)
       {
-        interpolate(*jointRequests[i], *jointRequests[theMotionSelection.targetMotion], theMotionSelection.ratios[i], rawJointRequest, interpolateStiffness, Joints::headYaw, Joints::headPitch);
-        interpolate(*jointRequests[i], *jointRequests[theMotionSelection.targetMotion], theMotionSelection.ratios[i], rawJointRequest, interpolateStiffness, Joints::lShoulderPitch, Joints::lHand);
-        interpolate(*jointRequests[i], *jointRequests[theMotionSelection.targetMotion], theMotionSelection.ratios[i], rawJointRequest, interpolateStiffness, Joints::rShoulderPitch, Joints::rHand);
-        interpolate(*jointRequests[i], *jointRequests[theMotionSelection.targetMotion], theMotionSelection.ratios[i], rawJointRequest, interpolateStiffness, Joints::lHipYawPitch, Joints::rAnkleRoll);
+        interpolate(*jointRequests[i], *jointRequests[theMotionSelection.targetMotion], theMotionSelection.ratios[i], rawJointRequest, interpolateStiffness, Joints::headYaw, Joints::rAnkleRoll);
       }
   }
 
@@ -360,41 +358,55 @@ void MotionCombinator::copy(const JointRequest& source, JointRequest& target, co
 void MotionCombinator::interpolate(
     const JointRequest& from, const JointRequest& to, float fromRatio, JointRequest& target, bool interpolateStiffness, const Joints::Joint startJoint, const Joints::Joint endJoint) const
 {
+  // The special values are resolved per joint, the angles are blended by a single kernel afterwards.
+  // Joints that both motions ignore get equal values, so the kernel does not change them.
+  JointBlending::Values f, t, result;
+  for (int i = 0; i < Joints::numOfJoints; ++i)
+  {
+    result[i] = target.angles[i];
+    f[i] = t[i] = 0.f;
+  }
+
   for (int i = startJoint; i <= endJoint; ++i)
   {
-    float f = from.angles[i];
-    float t = to.angles[i];
+    float fAngle = from.angles[i];
+    float tAngle = to.angles[i];
 
-    if (t == JointAngles::ignore && f == JointAngles::ignore)
+    if (tAngle == JointAngles::ignore && fAngle == JointAngles::ignore)
       continue;
 
-    if (t == JointAngles::ignore)
-      t = target.angles[i];
-    if (f == JointAngles::ignore)
-      f = target.angles[i];
+    if (tAngle == JointAngles::ignore)
+      tAngle = target.angles[i];
+    if (fAngle == JointAngles::ignore)
+      fAngle = target.angles[i];
 
-    int fStiffness = f != JointAngles::off ? from.stiffnessData.stiffnesses[i] : 0;
-    int tStiffness = t != JointAngles::off ? to.stiffnessData.stiffnesses[i] : 0;
+    int fStiffness = fAngle != JointAngles::off ? from.stiffnessData.stiffnesses[i] : 0;
+    int tStiffness = tAngle != JointAngles::off ? to.stiffnessData.stiffnesses[i] : 0;
     if (fStiffness == StiffnessData::useDefault)
       fStiffness = theStiffnessSettings.stiffnesses[i];
     if (tStiffness == StiffnessData::useDefault)
       tStiffness = theStiffnessSettings.stiffnesses[i];
 
-    if (t == JointAngles::off || t == JointAngles::ignore)
-      t = lastJointAngles.angles[i];
-    if (f == JointAngles::off || f == JointAngles::ignore)
-      f = lastJointAngles.angles[i];
-    if (target.angles[i] == JointAngles::off || target.angles[i] == JointAngles::ignore)
-      target.angles[i] = lastJointAngles.angles[i];
+    if (tAngle == JointAngles::off || tAngle == JointAngles::ignore)
+      tAngle = lastJointAngles.angles[i];
+    if (fAngle == JointAngles::off || fAngle == JointAngles::ignore)
+      fAngle = lastJointAngles.angles[i];
+    if (result[i] == JointAngles::off || result[i] == JointAngles::ignore)
+      result[i] = lastJointAngles.angles[i];
 
-    ASSERT(target.angles[i] != JointAngles::off && target.angles[i] != JointAngles::ignore);
-    ASSERT(t != JointAngles::off && t != JointAngles::ignore);
-    ASSERT(f != JointAngles::off && f != JointAngles::ignore);
+    ASSERT(result[i] != JointAngles::off && result[i] != JointAngles::ignore);
+    ASSERT(tAngle != JointAngles::off && tAngle != JointAngles::ignore);
+    ASSERT(fAngle != JointAngles::off && fAngle != JointAngles::ignore);
 
-    target.angles[i] += -fromRatio * t + fromRatio * f;
+    f[i] = fAngle;
+    t[i] = tAngle;
     if (interpolateStiffness)
       target.stiffnessData.stiffnesses[i] += int(-fromRatio * float(tStiffness) + fromRatio * float(fStiffness));
     else
       target.stiffnessData.stiffnesses[i] = tStiffness;
   }
+
+  JointBlending::addWeightedDifference(result, f, t, fromRatio);
+  for (int i = startJoint; i <= endJoint; ++i)
+    target.angles[i] = result[i];
 }
@@ -132,21 +132,18 @@ bool NaoKinematic::calcLegJoints(Joints::Joint whichSideJoint0, const Vector3f&
   float right = static_cast<float>((whichSideJoint0 == Joints::lHipYawPitch) ? -1 : 1);
 
 
-  float tiltAngleOfFirstJointAxis = -pi / 2 + right * pi / 4;
+  // The tilt angle of the first joint axis is -pi / 2 + right * pi / 4, i.e. its cosine is right * sqrt(0.5) and its sine is -sqrt(0.5).
+  const float sqrt1_2 = std::sqrt(0.5f);
 
   // Rotate around X to create HipYawPitch axis
   Matrix3f M1 = Matrix3f::Identity();
-  M1(1, 1) = std::cos(tiltAngleOfFirstJointAxis);
-  M1(2, 1) = std::sin(tiltAngleOfFirstJointAxis);
-  M1(1, 2) = -std::sin(tiltAngleOfFirstJointAxis);
-  M1(2, 2) = std::cos(tiltAngleOfFirstJointAxis);
+  M1(1, 1) = right * sqrt1_2;
+  M1(2, 1) = -sqrt1_2;
+  M1(1, 2) = sqrt1_2;
+  M1(2, 2) = right * sqrt1_2;
 
   // When created rotate back
-  Matrix3f M2 = Matrix3f::Identity();
-  M2(1, 1) = std::cos(tiltAngleOfFirstJointAxis);
-  M2(2, 1) = -std::sin(tiltAngleOfFirstJointAxis);
-  M2(1, 2) = std::sin(tiltAngleOfFirstJointAxis);
-  M2(2, 2) = std::cos(tiltAngleOfFirstJointAxis);
+  Matrix3f M2 = M1.transpose();
 
   float rx = rotation.x();
 
@@ -202,17 +199,12 @@ bool NaoKinematic::calcLegJoints(Joints::Joint whichSideJoint0, const Vector3f&
   float t2 = t2a + soll;
 
 
-  tiltAngleOfFirstJointAxis = -pi / 2 + pi / 4;
-
-  M1(1, 1) = std::cos(tiltAngleOfFirstJointAxis);
-  M1(2, 1) = std::sin(tiltAngleOfFirstJointAxis);
-  M1(1, 2) = -std::sin(tiltAngleOfFirstJointAxis);
-  M1(2, 2) = std::cos(tiltAngleOfFirstJointAxis);
-
-  M2(1, 1) = std::cos(tiltAngleOfFirstJointAxis);
-  M2(2, 1) = -std::sin(tiltAngleOfFirstJointAxis);
-  M2(1, 2) = std::sin(tiltAngleOfFirstJointAxis);
-  M2(2, 2) = std::cos(tiltAngleOfFirstJointAxis);
+  // now with the tilt angle -pi / 4
+  M1(1, 1) = sqrt1_2;
+  M1(2, 1) = -sqrt1_2;
+  M1(1, 2) = sqrt1_2;
+  M1(2, 2) = sqrt1_2;
+  M2 = M1.transpose();
 
   // BEGIN R=M1*rotMatrixAroundZ(t0)*M2; R=R*rotMatrixAroundX(ysign*t1)*rotMatrixAroundY(-t2)*rotMatrixAroundY(pi-t3);
   Matrix3f R = Matrix3f::Identity();
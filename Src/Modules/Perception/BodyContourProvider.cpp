@@ -7,53 +7,78 @@
 
 #include "BodyContourProvider.h"
 #include "Tools/Debugging/DebugDrawings3D.h"
+#include "Tools/Math/BHMath.h"
 
 void BodyContourProvider::update(BodyContour& bodyContour)
 {
   DECLARE_DEBUG_DRAWING3D("module:BodyContourProvider:contour", "robot");
-
-  bodyContour.lines.clear();
-
-  robotCameraMatrixInverted = theRobotCameraMatrix.inverse();
-  add(Pose3f(), torso, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::bicepsLeft], shoulder, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::bicepsRight], shoulder, -1, bodyContour);
-  add(theRobotModel.limbs[Limbs::bicepsLeft], upperArm, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::bicepsRight], upperArm, -1, bodyContour);
-  add(theRobotModel.limbs[Limbs::foreArmLeft], lowerArm, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::foreArmRight], lowerArm, -1, bodyContour);
-  add(theRobotModel.limbs[Limbs::foreArmLeft], lowerArm2, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::foreArmRight], lowerArm2, -1, bodyContour);
-  add(theRobotModel.limbs[Limbs::thighLeft], upperLeg1, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::thighRight], upperLeg1, -1, bodyContour);
-  add(theRobotModel.limbs[Limbs::thighLeft], upperLeg2, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::thighRight], upperLeg2, -1, bodyContour);
-  add(theRobotModel.limbs[Limbs::footLeft], foot, 1, bodyContour);
-  add(theRobotModel.limbs[Limbs::footRight], foot, -1, bodyContour);
+  update(bodyContour, false);
 }
 
 void BodyContourProvider::update(BodyContourUpper& bodyContour)
 {
   DECLARE_DEBUG_DRAWING3D("module:BodyContourProvider:contourUpper", "robot");
+  update(bodyContour, true);
+}
+
+void BodyContourProvider::update(BodyContour& bodyContour, bool upper)
+{
+  const CameraInfo& ci = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  const ImageCoordinateSystem& ics = upper ? (ImageCoordinateSystem&)theImageCoordinateSystemUpper : theImageCoordinateSystem;
+  const RobotCameraMatrix& robotCameraMatrix = upper ? (RobotCameraMatrix&)theRobotCameraMatrixUpper : theRobotCameraMatrix;
+  Cache& c = upper ? cacheUpper : cache;
+
+  const Vector2f rollingShutterOffset = ics.offset * (ics.a + ci.height / 2 * ics.b);
+  const Vector2i imageSize(ci.width, ci.height);
+  bool reuse = c.valid && c.imageSize == imageSize && (c.rollingShutterOffset - rollingShutterOffset).cwiseAbs().maxCoeff() <= maxRotationChange
+               && isSimilar(c.robotCameraMatrix, robotCameraMatrix);
+  for (size_t i = 0; reuse && i < limbs.size(); ++i)
+    reuse = isSimilar(c.limbPoses[i], theRobotModel.limbs[limbs[i]]);
+  // the 3-D drawing is only created while the contour is computed
+  if (!upper)
+    COMPLEX_DRAWING3D("module:BodyContourProvider:contour")
+      reuse = false;
 
-  bodyContour.lines.clear();
-
-  robotCameraMatrixInvertedUpper = theRobotCameraMatrixUpper.inverse();
-  add(Pose3f(), torso, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::bicepsLeft], shoulder, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::bicepsRight], shoulder, -1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::bicepsLeft], upperArm, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::bicepsRight], upperArm, -1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::foreArmLeft], lowerArm, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::foreArmRight], lowerArm, -1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::foreArmLeft], lowerArm2, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::foreArmRight], lowerArm2, -1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::thighLeft], upperLeg1, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::thighRight], upperLeg1, -1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::thighLeft], upperLeg2, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::thighRight], upperLeg2, -1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::footLeft], foot, 1, bodyContour, true);
-  add(theRobotModel.limbs[Limbs::footRight], foot, -1, bodyContour, true);
+  if (!reuse)
+  {
+    c.bodyContour.lines.clear();
+
+    Pose3f& inverted = upper ? robotCameraMatrixInvertedUpper : robotCameraMatrixInverted;
+    inverted = robotCameraMatrix.inverse();
+    add(Pose3f(), torso, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::bicepsLeft], shoulder, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::bicepsRight], shoulder, -1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::bicepsLeft], upperArm, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::bicepsRight], upperArm, -1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::foreArmLeft], lowerArm, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::foreArmRight], lowerArm, -1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::foreArmLeft], lowerArm2, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::foreArmRight], lowerArm2, -1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::thighLeft], upperLeg1, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::thighRight], upperLeg1, -1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::thighLeft], upperLeg2, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::thighRight], upperLeg2, -1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::footLeft], foot, 1, c.bodyContour, upper);
+    add(theRobotModel.limbs[Limbs::footRight], foot, -1, c.bodyContour, upper);
+    c.bodyContour.updateColumnBottoms(ci.width, ci.height);
+
+    c.valid = true;
+    c.robotCameraMatrix = robotCameraMatrix;
+    for (size_t i = 0; i < limbs.size(); ++i)
+      c.limbPoses[i] = theRobotModel.limbs[limbs[i]];
+    c.rollingShutterOffset = rollingShutterOffset;
+    c.imageSize = imageSize;
+  }
+
+  bodyContour.lines = c.bodyContour.lines;
+  bodyContour.columnBottoms = c.bodyContour.columnBottoms;
+  bodyContour.columnBottomsHeight = c.bodyContour.columnBottomsHeight;
+}
+
+bool BodyContourProvider::isSimilar(const Pose3f& p1, const Pose3f& p2) const
+{
+  return (p1.translation - p2.translation).squaredNorm() <= sqr(maxTranslationChange)
+         && (p1.rotation - p2.rotation).cwiseAbs().maxCoeff() <= maxRotationChange;
 }
 
 void BodyContourProvider::add(const Pose3f& origin, const std::vector<Vector3f>& c, float sign, BodyContour& bodyContour, bool upper)
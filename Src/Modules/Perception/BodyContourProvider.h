@@ -14,6 +14,7 @@
 #include "Representations/Perception/ImageCoordinateSystem.h"
 #include "Representations/Sensing/RobotModel.h"
 #include "Representations/Perception/BodyContour.h"
+#include <array>
 
 MODULE(BodyContourProvider,
   REQUIRES(CameraInfo),
@@ -33,7 +34,9 @@ MODULE(BodyContourProvider,
     (std::vector<Vector3f>) lowerArm2, /**< The contour of the left lower arm. */
     (std::vector<Vector3f>) upperLeg1, /**< The contour of the left upper leg (part 1). */
     (std::vector<Vector3f>) upperLeg2, /**< The contour of the left upper leg (part 2). */
-    (std::vector<Vector3f>) foot /**< The contour of the left foot. */
+    (std::vector<Vector3f>) foot, /**< The contour of the left foot. */
+    (float)(0.5f) maxTranslationChange, /**< The contour is reused while no pose it depends on moved more than this (in mm). */
+    (Angle)(0.2_deg) maxRotationChange /**< The contour is reused while no pose it depends on rotated more than approximately this. */
   )
 );
 
@@ -45,12 +48,48 @@ MODULE(BodyContourProvider,
 class BodyContourProvider : public BodyContourProviderBase
 {
 private:
+  /** The limbs whose poses the contour depends on besides the torso. */
+  static constexpr std::array<Limbs::Limb, 8> limbs = {Limbs::bicepsLeft, Limbs::bicepsRight, Limbs::foreArmLeft, Limbs::foreArmRight,
+                                                       Limbs::thighLeft, Limbs::thighRight, Limbs::footLeft, Limbs::footRight};
+
+  /**
+   * The contour computed for one camera together with the inputs it was computed
+   * from. While the robot stands or walks, the contour barely changes.
+   */
+  struct Cache
+  {
+    bool valid = false;
+    Pose3f robotCameraMatrix;
+    std::array<Pose3f, limbs.size()> limbPoses;
+    Vector2f rollingShutterOffset = Vector2f::Zero(); /**< The angular offset applied by ImageCoordinateSystem::fromCorrectedApprox. */
+    Vector2i imageSize = Vector2i::Zero();
+    BodyContour bodyContour;
+  };
+
   Pose3f robotCameraMatrixInverted; /**< The inverse of the current robotCameraMatrix. */
   Pose3f robotCameraMatrixInvertedUpper; /**< The inverse of the current robotCameraMatrix. */
+  Cache cache; /**< The contour of the lower camera. */
+  Cache cacheUpper; /**< The contour of the upper camera. */
 
   void update(BodyContour& bodyContour);
   void update(BodyContourUpper& bodyContour);
 
+  /**
+   * The method provides the contour for one camera. It is only recomputed if
+   * one of the poses it depends on or the image changed significantly.
+   * @param bodyContour The contour that is set.
+   * @param upper Is it the contour of the upper camera?
+   */
+  void update(BodyContour& bodyContour, bool upper);
+
+  /**
+   * The method checks whether two poses are within the tolerances of the cache.
+   * @param p1 The first pose.
+   * @param p2 The second pose.
+   * @return Are they similar enough to reuse the contour?
+   */
+  bool isSimilar(const Pose3f& p1, const Pose3f& p2) const;
+
   /**
    * The method projects a point in world coordinates into the image using the precomputed
    * inverse of the robot camera matrix.
@@ -1,8 +1,10 @@
 #include "BallPerceptTools.h"
 
+#include "Tools/Math/FastMath.h"
 #include "Tools/Math/Transformation.h"
 #include "Tools/Debugging/Stopwatch.h"
 #include "Modules/Perception/CNNs/CLIPBallPerceptorCNNs.h"
+#include <cstring>
 
 std::vector<t_cnn_fp> BallPerceptTools::cnns = {cnn_qball::cnn};
 
@@ -44,149 +46,254 @@ std::optional<Vector2f> BallPerceptTools::verifyAndGetBallPositionOnField(
   return posOnField;
 }
 
-std::tuple<bool, BallPatch> BallPerceptTools::checkBallCNNWithPositionTflite(
-    tflite::Interpreter& interpreter, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThreshold)
+std::array<Vector2i, 3> BallPerceptTools::getBallCNNWithPositionPatch(const CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor)
 {
-  const auto [min, max, size] = image.projectIntoImage(spot.position, Vector2i::Constant(static_cast<int>(spot.radiusInImage * 2.f * ballCNNWithPositionZoomOutFactor + 0.5f)));
+  return image.projectIntoImage(spot.position, Vector2i::Constant(static_cast<int>(spot.radiusInImage * 2.f * ballCNNWithPositionZoomOutFactor + 0.5f)));
+}
 
-  unsigned char* input = interpreter.typed_input_tensor<unsigned char>(0);
-  image.copyAndResizeArea<true, false>(min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE}, input);
+void BallPerceptTools::readBallCNNWithPositionResult(const float* output, BallCNNResult& result)
+{
+  result.validity = FastMath::sigmoid(output[0]);
+  result.ballCenter.x() = FastMath::sigmoid(output[1]);
+  result.ballCenter.y() = FastMath::sigmoid(output[2]);
+  result.passedEarlyExit = true;
+}
+
+void BallPerceptTools::setEarlyExitResult(float earlyExitOutput, float ballCNNWithPositionThresholdEarlyExit, BallCNNResult& result)
+{
+  const float earlyExitValidity = FastMath::sigmoid(earlyExitOutput);
+  result.passedEarlyExit = earlyExitValidity >= ballCNNWithPositionThresholdEarlyExit;
+  if (!result.passedEarlyExit)
+  {
+    //result.validity = earlyExitValidity * (ballCNNWithPositionThreshold / ballCNNWithPositionThresholdEarlyExit);
+    result.validity = earlyExitValidity / 100.f;
+    result.ballCenter = Vector2f::Constant(0.5f);
+  }
+}
+
+std::tuple<bool, BallPatch> BallPerceptTools::applyBallCNNWithPositionResult(
+    const BallCNNResult& result, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThreshold, bool earlyExit)
+{
+  const auto [min, max, size] = getBallCNNWithPositionPatch(spot, image, ballCNNWithPositionZoomOutFactor);
+  const Vector2i oldCenter = spot.position;
+
+  spot.validity = result.validity;
+  const Vector2f ballCenter = result.ballCenter * static_cast<float>(size.maxCoeff()); // TODO check if neccessary
+  spot.position = (min.cast<float>() + Vector2f::Constant(0.5f) + ballCenter).cast<int>();
+  spot.verifier = CheckedBallSpot::DetectionVerifier::ballPositionCNN;
 
-  bool returnValue = false;
   BallPatch ballPatch;
-  STOPWATCH_WITH_PLOT("BallCNNPositionTFlite:Invoke")
+  ballPatch.setPatch(image, min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE});
+  ballPatch.fromBallSpot(spot);
+
+  if (earlyExit && result.passedEarlyExit)
   {
-    if (interpreter.Invoke() != kTfLiteOk)
+    if (spot.upper)
     {
-      OUTPUT_ERROR("Failed to invoke tflite!");
+      ARROW("module:CLIPBallPerceptor:ballPosition:Upper", oldCenter.x(), oldCenter.y(), spot.position.x(), spot.position.y(), 1, Drawings::solidPen, ColorRGBA::green);
     }
+    else
+    {
+      ARROW("module:CLIPBallPerceptor:ballPosition:Lower", oldCenter.x(), oldCenter.y(), spot.position.x(), spot.position.y(), 1, Drawings::solidPen, ColorRGBA::green);
+    }
+  }
 
-    float* result = interpreter.typed_output_tensor<float>(0);
-    spot.validity = 1 / (1 + std::exp(-result[0]));
-
-    Vector2f ballCenter;
-    ballCenter.x() = 1 / (1 + std::exp(-result[1]));
-    ballCenter.y() = 1 / (1 + std::exp(-result[2]));
-
-    ballCenter *= static_cast<float>(size.maxCoeff()); // TODO check if neccessary
+  if (spot.validity >= ballCNNWithPositionThreshold)
+  {
+    const ColorRGBA crossColor = earlyExit ? ColorRGBA::black : ColorRGBA::blue;
+    if (spot.upper)
+    {
+      RECTANGLE("module:CLIPBallPerceptor:ballPosition:Upper", min.x(), min.y(), max.x(), max.y(), 3, Drawings::solidPen, ColorRGBA::black);
+      CROSS("module:CLIPBallPerceptor:ballPosition:Upper", spot.position.x(), spot.position.y(), 5, 3, Drawings::solidPen, crossColor);
+      DRAWTEXT("module:CLIPBallPerceptor:ballPosition:Upper", min.x() + 3, max.y(), 15, ColorRGBA::black, spot.validity * 100.f);
+    }
+    else
+    {
+      RECTANGLE("module:CLIPBallPerceptor:ballPosition:Lower", min.x(), min.y(), max.x(), max.y(), 3, Drawings::solidPen, ColorRGBA::black);
+      CROSS("module:CLIPBallPerceptor:ballPosition:Lower", spot.position.x(), spot.position.y(), 5, 3, Drawings::solidPen, crossColor);
+      DRAWTEXT("module:CLIPBallPerceptor:ballPosition:Lower", min.x() + 3, max.y(), 15, ColorRGBA::black, spot.validity * 100.f);
+    }
+    return {true, ballPatch};
+  }
+  return {false, ballPatch};
+}
 
-    spot.position = (min.cast<float>() + Vector2f::Constant(0.5f) + ballCenter).cast<int>();
-    spot.verifier = CheckedBallSpot::DetectionVerifier::ballPositionCNN;
+std::tuple<bool, BallPatch> BallPerceptTools::checkBallCNNWithPositionTflite(
+    tflite::Interpreter& interpreter, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThreshold, BallCNNResult* cnnResult)
+{
+  const auto [min, max, size] = getBallCNNWithPositionPatch(spot, image, ballCNNWithPositionZoomOutFactor);
 
-    ballPatch.setPatch(image, min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE});
-    ballPatch.fromBallSpot(spot);
+  unsigned char* input = interpreter.typed_input_tensor<unsigned char>(0);
+  image.copyAndResizeArea<true, false>(min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE}, input);
 
-    if (spot.validity >= ballCNNWithPositionThreshold)
+  std::tuple<bool, BallPatch> ret;
+  STOPWATCH_WITH_PLOT("BallCNNPositionTFlite:Invoke")
+  {
+    if (!TfliteInferenceSettings::invoke(interpreter, "tflite:ballCNN"))
     {
-      if (spot.upper)
-      {
-        RECTANGLE("module:CLIPBallPerceptor:ballPosition:Upper", min.x(), min.y(), max.x(), max.y(), 3, Drawings::solidPen, ColorRGBA::black);
-        CROSS("module:CLIPBallPerceptor:ballPosition:Upper", spot.position.x(), spot.position.y(), 5, 3, Drawings::solidPen, ColorRGBA::blue);
-        DRAWTEXT("module:CLIPBallPerceptor:ballPosition:Upper", min.x() + 3, max.y(), 15, ColorRGBA::black, spot.validity * 100.f);
-      }
-      else
-      {
-        RECTANGLE("module:CLIPBallPerceptor:ballPosition:Lower", min.x(), min.y(), max.x(), max.y(), 3, Drawings::solidPen, ColorRGBA::black);
-        CROSS("module:CLIPBallPerceptor:ballPosition:Lower", spot.position.x(), spot.position.y(), 5, 3, Drawings::solidPen, ColorRGBA::blue);
-        DRAWTEXT("module:CLIPBallPerceptor:ballPosition:Lower", min.x() + 3, max.y(), 15, ColorRGBA::black, spot.validity * 100.f);
-      }
-      returnValue = true;
+      OUTPUT_ERROR("Failed to invoke tflite!");
     }
-    else
+
+    BallCNNResult result;
+    readBallCNNWithPositionResult(interpreter.typed_output_tensor<float>(0), result);
+    ret = applyBallCNNWithPositionResult(result, spot, image, ballCNNWithPositionZoomOutFactor, ballCNNWithPositionThreshold, false);
+    if (cnnResult)
     {
-      returnValue = false;
+      *cnnResult = result;
+      cnnResult->valid = true;
     }
   }
-  return {returnValue, ballPatch};
+  return ret;
 };
 
 std::tuple<bool, BallPatch> BallPerceptTools::checkBallCNNWithPositionEarlyExitTflite(
-    const std::vector<TfliteInterpreter>& layers, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThresholdEarlyExit, float ballCNNWithPositionThreshold)
+    const std::vector<TfliteInterpreter>& layers, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThresholdEarlyExit, float ballCNNWithPositionThreshold,
+    BallCNNResult* cnnResult)
 {
-  const auto [min, max, size] = image.projectIntoImage(spot.position, Vector2i::Constant(static_cast<int>(spot.radiusInImage * 2.f * ballCNNWithPositionZoomOutFactor + 0.5f)));
-  const Vector2i oldCenter = spot.position;
+  const auto [min, max, size] = getBallCNNWithPositionPatch(spot, image, ballCNNWithPositionZoomOutFactor);
 
   auto& firstInterpreter = layers.at(0).getInterpreter();
   unsigned char* input = firstInterpreter.typed_input_tensor<unsigned char>(0);
   image.copyAndResizeArea<true, false>(min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE}, input);
 
-  bool returnValue = false;
-  BallPatch ballPatch;
+  std::tuple<bool, BallPatch> ret;
   STOPWATCH_WITH_PLOT("BallCNNPositionTFliteEarlyExit:Invoke")
   {
-    if (firstInterpreter.Invoke() != kTfLiteOk)
+    if (!TfliteInferenceSettings::invoke(firstInterpreter, "tflite:splittedBallCNN:earlyExit"))
     {
       OUTPUT_ERROR("Failed to invoke tflite!");
     }
 
-    float* early_exit_result = firstInterpreter.typed_output_tensor<float>(1);
-    float early_exit_validity = 1 / (1 + std::exp(-early_exit_result[0]));
-
-    Vector2f ballCenter;
-    if (early_exit_validity >= ballCNNWithPositionThresholdEarlyExit)
+    BallCNNResult result;
+    setEarlyExitResult(firstInterpreter.typed_output_tensor<float>(1)[0], ballCNNWithPositionThresholdEarlyExit, result);
+    if (result.passedEarlyExit)
     {
       auto& secondInterpreter = layers.at(1).getInterpreter();
-      if (secondInterpreter.Invoke() != kTfLiteOk)
+      if (!TfliteInferenceSettings::invoke(secondInterpreter, "tflite:splittedBallCNN:remaining"))
       {
         OUTPUT_ERROR("Failed to invoke tflite!");
       }
 
-      float* result = secondInterpreter.typed_output_tensor<float>(0);
-      spot.validity = 1 / (1 + std::exp(-result[0]));
-      ballCenter.x() = 1 / (1 + std::exp(-result[1]));
-      ballCenter.y() = 1 / (1 + std::exp(-result[2]));
+      readBallCNNWithPositionResult(secondInterpreter.typed_output_tensor<float>(0), result);
     }
-    else
+    ret = applyBallCNNWithPositionResult(result, spot, image, ballCNNWithPositionZoomOutFactor, ballCNNWithPositionThreshold, true);
+    if (cnnResult)
     {
-      //spot.validity = early_exit_validity * (ballCNNWithPositionThreshold / ballCNNWithPositionThresholdEarlyExit);
-      spot.validity = early_exit_validity / 100.f;
-      ballCenter.x() = 0.5;
-      ballCenter.y() = 0.5;
+      *cnnResult = result;
+      cnnResult->valid = true;
     }
+  }
+  return ret;
+};
 
-    ballCenter *= static_cast<float>(size.maxCoeff());
-
-    spot.position = (min.cast<float>() + Vector2f::Constant(0.5f) + ballCenter).cast<int>();
-    spot.verifier = CheckedBallSpot::DetectionVerifier::ballPositionCNN;
+void BallPerceptTools::runBallCNNWithPositionBatchTflite(tflite::Interpreter& interpreter, const CheckedBallSpot* spots, const int count, const Image& image, const Image& imageUpper,
+    float ballCNNWithPositionZoomOutFactor, BallCNNResult* results)
+{
+  if (!TfliteInterpreter::setBatchSize(interpreter, count))
+  {
+    OUTPUT_ERROR("Failed to resize tflite batch!");
+    return;
+  }
 
-    ballPatch.setPatch(image, min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE});
-    ballPatch.fromBallSpot(spot);
+  unsigned char* input = interpreter.typed_input_tensor<unsigned char>(0);
+  copyBallCNNWithPositionPatches(spots, count, image, imageUpper, ballCNNWithPositionZoomOutFactor, input);
 
-    if (early_exit_validity >= ballCNNWithPositionThresholdEarlyExit)
+  STOPWATCH_WITH_PLOT("BallCNNPositionTFliteBatch:Invoke")
+  {
+    if (!TfliteInferenceSettings::invoke(interpreter, "tflite:ballCNN"))
     {
-      if (spot.upper)
-      {
-        ARROW("module:CLIPBallPerceptor:ballPosition:Upper", oldCenter.x(), oldCenter.y(), spot.position.x(), spot.position.y(), 1, Drawings::solidPen, ColorRGBA::green);
-      }
-      else
-      {
-        ARROW("module:CLIPBallPerceptor:ballPosition:Lower", oldCenter.x(), oldCenter.y(), spot.position.x(), spot.position.y(), 1, Drawings::solidPen, ColorRGBA::green);
-      }
+      OUTPUT_ERROR("Failed to invoke tflite!");
+      return;
     }
+  }
+
+  const float* output = interpreter.typed_output_tensor<float>(0);
+  const int outputSize = static_cast<int>(interpreter.output_tensor(0)->bytes / sizeof(float)) / count;
+  for (int i = 0; i < count; ++i)
+  {
+    readBallCNNWithPositionResult(output + i * outputSize, results[i]);
+    results[i].valid = true;
+  }
+}
+
+void BallPerceptTools::runBallCNNWithPositionEarlyExitBatchTflite(tflite::Interpreter& firstInterpreter, tflite::Interpreter& secondInterpreter, const CheckedBallSpot* spots,
+    const int count, const Image& image, const Image& imageUpper, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThresholdEarlyExit, BallCNNResult* results)
+{
+  if (!TfliteInterpreter::setBatchSize(firstInterpreter, count))
+  {
+    OUTPUT_ERROR("Failed to resize tflite batch!");
+    return;
+  }
+
+  unsigned char* input = firstInterpreter.typed_input_tensor<unsigned char>(0);
+  copyBallCNNWithPositionPatches(spots, count, image, imageUpper, ballCNNWithPositionZoomOutFactor, input);
 
-    if (spot.validity >= ballCNNWithPositionThreshold)
+  // stage 1 decides for the whole batch which patches are processed by stage 2
+  std::vector<int> survivors;
+  survivors.reserve(count);
+  STOPWATCH_WITH_PLOT("BallCNNPositionTFliteEarlyExitBatch:Invoke")
+  {
+    if (!TfliteInferenceSettings::invoke(firstInterpreter, "tflite:splittedBallCNN:earlyExit"))
     {
-      if (spot.upper)
-      {
-        RECTANGLE("module:CLIPBallPerceptor:ballPosition:Upper", min.x(), min.y(), max.x(), max.y(), 3, Drawings::solidPen, ColorRGBA::black);
-        CROSS("module:CLIPBallPerceptor:ballPosition:Upper", spot.position.x(), spot.position.y(), 5, 3, Drawings::solidPen, ColorRGBA::black);
-        DRAWTEXT("module:CLIPBallPerceptor:ballPosition:Upper", min.x() + 3, max.y(), 15, ColorRGBA::black, spot.validity * 100.f);
-      }
-      else
-      {
-        RECTANGLE("module:CLIPBallPerceptor:ballPosition:Lower", min.x(), min.y(), max.x(), max.y(), 3, Drawings::solidPen, ColorRGBA::black);
-        CROSS("module:CLIPBallPerceptor:ballPosition:Lower", spot.position.x(), spot.position.y(), 5, 3, Drawings::solidPen, ColorRGBA::black);
-        DRAWTEXT("module:CLIPBallPerceptor:ballPosition:Lower", min.x() + 3, max.y(), 15, ColorRGBA::black, spot.validity * 100.f);
-      }
-      returnValue = true;
+      OUTPUT_ERROR("Failed to invoke tflite!");
+      return;
     }
-    else
+  }
+  const float* earlyExitOutput = firstInterpreter.typed_output_tensor<float>(1);
+  const int earlyExitOutputSize = static_cast<int>(firstInterpreter.output_tensor(1)->bytes / sizeof(float)) / count;
+  for (int i = 0; i < count; ++i)
+  {
+    setEarlyExitResult(earlyExitOutput[i * earlyExitOutputSize], ballCNNWithPositionThresholdEarlyExit, results[i]);
+    results[i].valid = true;
+    if (results[i].passedEarlyExit)
+      survivors.push_back(i);
+  }
+  if (survivors.empty())
+    return;
+
+  const int survivorCount = static_cast<int>(survivors.size());
+  if (!TfliteInterpreter::setBatchSize(secondInterpreter, survivorCount))
+  {
+    OUTPUT_ERROR("Failed to resize tflite batch!");
+    for (const int i : survivors)
+      results[i].valid = false;
+    return;
+  }
+
+  // the features of the survivors are copied, because stage 2 has its own input tensor
+  const TfLiteTensor* features = firstInterpreter.output_tensor(0);
+  const size_t featureBytes = features->bytes / count;
+  char* secondInput = secondInterpreter.input_tensor(0)->data.raw;
+  for (int j = 0; j < survivorCount; ++j)
+    std::memcpy(secondInput + j * featureBytes, features->data.raw + survivors[j] * featureBytes, featureBytes);
+
+  STOPWATCH_WITH_PLOT("BallCNNPositionTFliteEarlyExitBatch:InvokeRemaining")
+  {
+    if (!TfliteInferenceSettings::invoke(secondInterpreter, "tflite:splittedBallCNN:remaining"))
     {
-      returnValue = false;
+      OUTPUT_ERROR("Failed to invoke tflite!");
+      for (const int i : survivors)
+        results[i].valid = false;
+      return;
     }
   }
-  return {returnValue, ballPatch};
-};
+
+  const float* output = secondInterpreter.typed_output_tensor<float>(0);
+  const int outputSize = static_cast<int>(secondInterpreter.output_tensor(0)->bytes / sizeof(float)) / survivorCount;
+  for (int j = 0; j < survivorCount; ++j)
+    readBallCNNWithPositionResult(output + j * outputSize, results[survivors[j]]);
+}
+
+void BallPerceptTools::copyBallCNNWithPositionPatches(
+    const CheckedBallSpot* spots, const int count, const Image& image, const Image& imageUpper, float ballCNNWithPositionZoomOutFactor, unsigned char* input)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    const Image& spotImage = spots[i].upper ? imageUpper : image;
+    const auto [min, max, size] = getBallCNNWithPositionPatch(spots[i], spotImage, ballCNNWithPositionZoomOutFactor);
+    spotImage.copyAndResizeArea<true, false>(min, size, {CNN_POSITION_SIZE, CNN_POSITION_SIZE}, input + i * CNN_POSITION_SIZE * CNN_POSITION_SIZE * 3);
+  }
+}
 
 std::tuple<bool, BallPatch> BallPerceptTools::checkScanlinesAndCNN(CheckedBallSpot& spot, const Image& image, const float minConfidenceForSpot, const int variant, const float ballCNNWithPositionZoomOutFactor)
 {
@@ -14,6 +14,7 @@
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Configuration/FieldDimensions.h"
 
+#include <array>
 #include <cstdio>
 #include <optional>
 #include <tuple>
@@ -29,14 +30,61 @@ public:
   */
   BallPerceptTools(){};
 
+  /** The result of the ball CNN with position for one patch. */
+  struct BallCNNResult
+  {
+    bool valid = false; /**< Was the CNN run for this patch? */
+    bool passedEarlyExit = true; /**< Was the patch processed by all layers? */
+    float validity = 0.f;
+    Vector2f ballCenter = Vector2f::Constant(0.5f); /**< Relative to the size of the patch. */
+  };
+
   static std::vector<t_cnn_fp> cnns;
 
   static bool applyBallRadiusFromCameraMatrix(BallSpot& ballSpot, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, const float& ballRadius);
   static std::optional<Vector2f> verifyAndGetBallPositionOnField(
       const BallSpot& ballSpot, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, const FieldDimensions& fieldDimensions, bool useRobotPose, const Pose2f& robotPose);
+  /** Runs the ball CNN with position on the patch of a spot. If cnnResult is given, it is set to the raw result. */
   static std::tuple<bool, BallPatch> checkBallCNNWithPositionTflite(
-      tflite::Interpreter& interpreter, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThreshold);
+      tflite::Interpreter& interpreter, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThreshold, BallCNNResult* cnnResult = nullptr);
   static std::tuple<bool, BallPatch> checkBallCNNWithPositionEarlyExitTflite(
-      const std::vector<TfliteInterpreter>& layers, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThresholdEarlyExit, float ballCNNWithPositionThreshold);
+      const std::vector<TfliteInterpreter>& layers, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThresholdEarlyExit, float ballCNNWithPositionThreshold,
+      BallCNNResult* cnnResult = nullptr);
+
+  /**
+  * Applies a result of the ball CNN with position to a spot, like checkBallCNNWithPositionTflite does.
+  * @param earlyExit Was the result computed by the splitted CNN?
+  */
+  static std::tuple<bool, BallPatch> applyBallCNNWithPositionResult(
+      const BallCNNResult& result, CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThreshold, bool earlyExit);
+
+  /**
+  * Runs the ball CNN with position on the patches of several spots with a single invocation.
+  * @param interpreter An interpreter with its own input tensor whose batch size can be changed.
+  * @param spots The spots, each from the image given by its upper flag.
+  * @param count The number of spots.
+  * @param results The results of the spots, which are set to valid if the invocation succeeded.
+  */
+  static void runBallCNNWithPositionBatchTflite(tflite::Interpreter& interpreter, const CheckedBallSpot* spots, const int count, const Image& image, const Image& imageUpper,
+      float ballCNNWithPositionZoomOutFactor, BallCNNResult* results);
+
+  /**
+  * Runs the splitted ball CNN on the patches of several spots. The first layer processes all of them,
+  * the second one only those that passed the early exit.
+  * @param firstInterpreter An interpreter of the first layer whose batch size can be changed.
+  * @param secondInterpreter An interpreter of the second layer with its own input tensor.
+  */
+  static void runBallCNNWithPositionEarlyExitBatchTflite(tflite::Interpreter& firstInterpreter, tflite::Interpreter& secondInterpreter, const CheckedBallSpot* spots, const int count,
+      const Image& image, const Image& imageUpper, float ballCNNWithPositionZoomOutFactor, float ballCNNWithPositionThresholdEarlyExit, BallCNNResult* results);
+
+  /** Returns the upper left corner, the lower right corner, and the size of the patch the ball CNN with position sees for a spot. */
+  static std::array<Vector2i, 3> getBallCNNWithPositionPatch(const CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor);
+
   static std::tuple<bool, BallPatch> checkScanlinesAndCNN(CheckedBallSpot& spot, const Image& image, const float minConfidenceForSpot, const int variant, const float ballCNNWithPositionZoomOutFactor);
+
+private:
+  static void copyBallCNNWithPositionPatches(
+      const CheckedBallSpot* spots, const int count, const Image& image, const Image& imageUpper, float ballCNNWithPositionZoomOutFactor, unsigned char* input);
+  static void readBallCNNWithPositionResult(const float* output, BallCNNResult& result);
+  static void setEarlyExitResult(float earlyExitOutput, float ballCNNWithPositionThresholdEarlyExit, BallCNNResult& result);
 };
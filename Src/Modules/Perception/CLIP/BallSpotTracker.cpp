@@ -0,0 +1,67 @@
+/**
+* @file BallSpotTracker.cpp
+* Implementation of class BallSpotTracker.
+*/
+
+#include "BallSpotTracker.h"
+#include <cstdlib>
+#include <limits>
+
+void BallSpotTracker::getSignature(const CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, Signature& signature)
+{
+  const auto [min, max, size] = BallPerceptTools::getBallCNNWithPositionPatch(spot, image, ballCNNWithPositionZoomOutFactor);
+  image.copyAndResizeArea<false, false>(min, size, {signatureSize, signatureSize}, signature.data());
+}
+
+void BallSpotTracker::startFrame(unsigned time, unsigned maxAge, const std::function<bool(const Entry&, Vector2f&)>& predict)
+{
+  entries.clear();
+  for (Entry& entry : nextEntries)
+    if (time - entry.timeWhenChecked <= maxAge)
+    {
+      entry.predicted = predict(entry, entry.predictedPositionInImage);
+      if (entry.predicted)
+        entries.emplace_back(entry);
+    }
+  nextEntries.clear();
+}
+
+const BallSpotTracker::Entry* BallSpotTracker::find(const CheckedBallSpot& spot, const Signature& signature, float maxOffset, int maxMeanDifference) const
+{
+  const float maxDistance = spot.radiusInImage * maxOffset;
+  int bestDifference = maxMeanDifference * static_cast<int>(signature.size());
+  const Entry* best = nullptr;
+  for (const Entry& entry : entries)
+  {
+    if (entry.upper != spot.upper || std::abs(entry.radiusInImage - spot.radiusInImage) > maxDistance
+        || (entry.predictedPositionInImage - spot.position.cast<float>()).squaredNorm() > maxDistance * maxDistance)
+      continue;
+
+    int difference = 0;
+    for (size_t i = 0; i < signature.size() && difference <= bestDifference; ++i)
+      difference += std::abs(static_cast<int>(entry.signature[i]) - static_cast<int>(signature[i]));
+    if (difference <= bestDifference)
+    {
+      bestDifference = difference;
+      best = &entry;
+    }
+  }
+  return best;
+}
+
+void BallSpotTracker::add(const CheckedBallSpot& spot, const Vector2f& positionOnField, const Signature& signature, const BallPerceptTools::BallCNNResult& result, unsigned timeWhenChecked)
+{
+  Entry& entry = nextEntries.emplace_back();
+  entry.upper = spot.upper;
+  entry.positionOnField = positionOnField;
+  entry.radiusInImage = spot.radiusInImage;
+  entry.signature = signature;
+  entry.result = result;
+  entry.timeWhenChecked = timeWhenChecked;
+}
+
+void BallSpotTracker::clear()
+{
+  entries.clear();
+  nextEntries.clear();
+}
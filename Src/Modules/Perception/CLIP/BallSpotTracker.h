@@ -0,0 +1,66 @@
+/**
+* @file BallSpotTracker.h
+* Declaration of class BallSpotTracker, which remembers the results of the ball CNN with position
+* for the spots of the previous frame. A spot close to the predicted image position of a remembered
+* spot whose patch looks nearly the same reuses the result instead of running the CNN again.
+*/
+
+#pragma once
+
+#include "Modules/Perception/CLIP/BallPerceptTools.h"
+#include <array>
+#include <functional>
+#include <vector>
+
+class BallSpotTracker
+{
+public:
+  static constexpr int signatureSize = 8;
+
+  /** A thumbnail of the y channel of the patch of the ball CNN with position. */
+  using Signature = std::array<unsigned char, signatureSize * signatureSize>;
+
+  struct Entry
+  {
+    bool upper = false;
+    Vector2f positionOnField = Vector2f::Zero(); /**< The spot projected on the plane of the ball center, relative to the robot in the frame the entry was added. */
+    Vector2f predictedPositionInImage = Vector2f::Zero();
+    bool predicted = false; /**< Is predictedPositionInImage valid in this frame? */
+    float radiusInImage = 0.f;
+    Signature signature{};
+    BallPerceptTools::BallCNNResult result;
+    unsigned timeWhenChecked = 0; /**< When the CNN was run for the patch the result belongs to. */
+  };
+
+  /**
+  * Computes the signature of the patch the ball CNN with position would see for a spot.
+  */
+  static void getSignature(const CheckedBallSpot& spot, const Image& image, float ballCNNWithPositionZoomOutFactor, Signature& signature);
+
+  /**
+  * Starts a new frame. The entries added in the previous frame replace the older ones.
+  * Entries whose result was computed more than maxAge ms ago are dropped, so that the CNN is run
+  * regularly for every spot.
+  * @param predict Computes the image position of an entry in this frame. Returns false if it is not visible.
+  */
+  void startFrame(unsigned time, unsigned maxAge, const std::function<bool(const Entry&, Vector2f&)>& predict);
+
+  /**
+  * Searches the entry a spot reuses.
+  * @param maxOffset The maximum distance to the predicted position and the maximum difference of the radius, relative to the radius of the spot.
+  * @param maxMeanDifference The maximum mean absolute difference of the signatures.
+  * @return The entry with the most similar signature or nullptr if there is none.
+  */
+  const Entry* find(const CheckedBallSpot& spot, const Signature& signature, float maxOffset, int maxMeanDifference) const;
+
+  /**
+  * Adds a spot checked in this frame. It can be reused in the next frame.
+  */
+  void add(const CheckedBallSpot& spot, const Vector2f& positionOnField, const Signature& signature, const BallPerceptTools::BallCNNResult& result, unsigned timeWhenChecked);
+
+  void clear();
+
+private:
+  std::vector<Entry> entries; /**< The entries that can be reused in this frame. */
+  std::vector<Entry> nextEntries; /**< The entries added in this frame. */
+};
@@ -9,6 +9,7 @@
 #include "Modules/Perception/CLIP/BallPerceptTools.h"
 #include <taskflow/taskflow.hpp>
 #include <taskflow/algorithm/find.hpp>
+#include <taskflow/algorithm/for_each.hpp>
 #include <taskflow/algorithm/transform.hpp>
 
 void CLIPBallPerceptor::reset()
@@ -48,6 +49,7 @@ void CLIPBallPerceptor::executeDeclares() const
   DECLARE_PLOT("module:CLIPBallPerceptor:ballSpots:lower:processed");
   DECLARE_PLOT("module:CLIPBallPerceptor:sumOfBallSpots");
   DECLARE_PLOT("module:CLIPBallPerceptor:processedBallSpots");
+  DECLARE_PLOT("module:CLIPBallPerceptor:reusedCNNResults");
 }
 
 void CLIPBallPerceptor::execute(tf::Subflow& subflow)
@@ -128,12 +130,69 @@ void CLIPBallPerceptor::execute(tf::Subflow& subflow)
     }
   }
 
+  // the CNN results are looked up by the position of a spot in ballSpots
+  std::vector<BallPerceptTools::BallCNNResult> cnnResults;
+  std::vector<BallSpotTracker::Signature> signatures;
+  std::vector<unsigned> timesWhenChecked;
+  if (useBatchedCNN || spotTracking.enabled)
+    cnnResults.resize(ballSpots.size());
+
+  if (spotTracking.enabled)
+  {
+    STOPWATCH("CLIPBallPerceptor:trackBallSpots")
+    {
+      const float timeSinceLastFrame = static_cast<float>(theFrameInfo.getTimeSince(lastFrameTime)) / 1000.f;
+      const auto predict = [&](const BallSpotTracker::Entry& entry, Vector2f& positionInImage)
+      {
+        Vector2f positionOnField = entry.positionOnField;
+        if ((positionOnField - theBallModel.estimate.position).norm() < spotTracking.maxBallModelDistance)
+          positionOnField = BallPhysics::propagateBallPosition(positionOnField, theBallModel.estimate.velocity, timeSinceLastFrame, theBallModel.friction);
+
+        // the current camera matrix accounts for the motion of the head since the previous frame
+        const CameraMatrix& cameraMatrix = entry.upper ? static_cast<const CameraMatrix&>(theCameraMatrixUpper) : theCameraMatrix;
+        const CameraInfo& cameraInfo = entry.upper ? static_cast<const CameraInfo&>(theCameraInfoUpper) : theCameraInfo;
+        return Transformation::robotToImage(Vector3f(positionOnField.x(), positionOnField.y(), theFieldDimensions.ballRadius), cameraMatrix, cameraInfo, positionInImage);
+      };
+      spotTracker.startFrame(theFrameInfo.time, spotTracking.maxAge, predict);
+
+      signatures.resize(ballSpots.size());
+      timesWhenChecked.assign(ballSpots.size(), theFrameInfo.time);
+      int reused = 0;
+      for (size_t i = 0; i < ballSpots.size(); ++i)
+      {
+        const CheckedBallSpot& spot = ballSpots[i];
+        if (spot.verifier != CheckedBallSpot::DetectionVerifier::ballPositionCNN)
+          continue;
+
+        BallSpotTracker::getSignature(spot, spot.upper ? static_cast<const Image&>(theImageUpper) : theImage, tfliteCNN.ballCNNWithPositionZoomOutFactor, signatures[i]);
+        if (const BallSpotTracker::Entry* entry = spotTracker.find(spot, signatures[i], spotTracking.maxOffset, spotTracking.maxMeanDifference))
+        {
+          cnnResults[i] = entry->result;
+          timesWhenChecked[i] = entry->timeWhenChecked;
+          ++reused;
+        }
+      }
+      PLOT("module:CLIPBallPerceptor:reusedCNNResults", reused);
+    }
+  }
+  else
+    spotTracker.clear();
+  lastFrameTime = theFrameInfo.time;
+
+  tf::Task cnnTask;
+  if (useBatchedCNN)
+    cnnTask = runBatchedCNN(subflow, ballSpots, cnnResults);
+  const auto getCNNResult = [&](const CheckedBallSpot& bs) -> BallPerceptTools::BallCNNResult*
+  {
+    return cnnResults.empty() ? nullptr : &cnnResults[&bs - ballSpots.data()];
+  };
+
   const auto isBallPercept = [&](const CheckedBallSpot& bs)
   {
     CheckedBallSpot spot(bs);
 
     Global::getTimingManager().startTiming("CLIPBallPerceptor:checkBallSpot");
-    const auto [found, ballPatch] = checkBallSpot(spot);
+    const auto [found, ballPatch] = checkBallSpot(spot, getCNNResult(bs));
     Global::getTimingManager().stopTiming("CLIPBallPerceptor:checkBallSpot");
 
     if (enableProcessedBallPatches && ballPatch)
@@ -145,7 +204,7 @@ void CLIPBallPerceptor::execute(tf::Subflow& subflow)
   const auto getBallPercept = [&](const CheckedBallSpot& bs)
   {
     CheckedBallSpot spot(bs);
-    const auto [found, ballPatch] = checkBallSpot(spot);
+    const auto [found, ballPatch] = checkBallSpot(spot, getCNNResult(bs));
     ASSERT(found);
 
     const std::optional<Vector2f> posOnField = verifyAndGetBallPositionOnField(spot);
@@ -178,6 +237,8 @@ void CLIPBallPerceptor::execute(tf::Subflow& subflow)
     };
     tf::Task getTask = subflow.emplace(get).name("GetBallPercept [CLIPBallPerceptor]");
     transformTask.precede(getTask);
+    if (!cnnTask.empty())
+      cnnTask.precede(transformTask);
 
     subflow.join();
   }
@@ -193,10 +254,28 @@ void CLIPBallPerceptor::execute(tf::Subflow& subflow)
     };
     tf::Task getTask = subflow.emplace(get).name("GetBallPercept [CLIPBallPerceptor]");
     findTask.precede(getTask);
+    if (!cnnTask.empty())
+      cnnTask.precede(findTask);
 
     subflow.join();
   }
 
+  // all spots for which the CNN result is known can be reused in the next frame
+  if (spotTracking.enabled)
+  {
+    for (size_t i = 0; i < ballSpots.size(); ++i)
+    {
+      const CheckedBallSpot& spot = ballSpots[i];
+      if (spot.verifier != CheckedBallSpot::DetectionVerifier::ballPositionCNN || !cnnResults[i].valid)
+        continue;
+
+      const ImageToFieldProjection& projection = spot.upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
+      Vector2f positionOnField;
+      if (projection.imageToRobotHorizontalPlane(spot.position.cast<float>(), theFieldDimensions.ballRadius, positionOnField))
+        spotTracker.add(spot, positionOnField, signatures[i], cnnResults[i], timesWhenChecked[i]);
+    }
+  }
+
   enableProcessedBallPatches = false;
   enableMultipleBallPercept = false;
 }
@@ -252,7 +331,7 @@ std::optional<Vector2f> CLIPBallPerceptor::verifyAndGetBallPositionOnField(const
   return BallPerceptTools::verifyAndGetBallPositionOnField(ballSpot, cameraMatrix, cameraInfo, theFieldDimensions, useRobotPose, theRobotPose);
 }
 
-std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkBallSpot(CheckedBallSpot& spot) const
+std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkBallSpot(CheckedBallSpot& spot, BallPerceptTools::BallCNNResult* cnnResult) const
 {
   ColorRGBA brushColor;
   switch (spot.source)
@@ -270,7 +349,7 @@ std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkBallSpot(Chec
 
   Vector2i originalSpotPosition(spot.position);
 
-  std::tuple<bool, std::optional<BallPatch>> ret = checkWithVerifier(spot);
+  std::tuple<bool, std::optional<BallPatch>> ret = checkWithVerifier(spot, cnnResult);
   auto& [fill, ballpatch] = ret;
 
   DEBUG_DRAWING("module:CLIPBallPerceptor:ballSpots:upper", "drawingOnImage")
@@ -333,7 +412,7 @@ std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkBallSpot(Chec
   return ret;
 }
 
-std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkWithVerifier(CheckedBallSpot& spot) const
+std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkWithVerifier(CheckedBallSpot& spot, BallPerceptTools::BallCNNResult* cnnResult) const
 {
   std::tuple<bool, std::optional<BallPatch>> ret = {false, {}};
   auto& [fill, ballPatch] = ret;
@@ -341,7 +420,7 @@ std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::checkWithVerifier(
   switch (spot.verifier)
   {
   case CheckedBallSpot::DetectionVerifier::ballPositionCNN:
-    ret = checkBallCNNWithPosition(spot);
+    ret = checkBallCNNWithPosition(spot, cnnResult);
     fill = fill && applyBallRadiusFromCameraMatrix(spot);
     break;
   case CheckedBallSpot::DetectionVerifier::scanlinesAndCNN:
@@ -407,18 +486,69 @@ bool CLIPBallPerceptor::duplicateBallSpots(std::vector<CheckedBallSpot>& spots,
 }
 
 
-std::tuple<bool, BallPatch> CLIPBallPerceptor::checkBallCNNWithPosition(CheckedBallSpot& spot) const
+tf::Task CLIPBallPerceptor::runBatchedCNN(tf::Subflow& subflow, const std::vector<CheckedBallSpot>& spots, std::vector<BallPerceptTools::BallCNNResult>& results) const
+{
+  // the spots verified by the CNN are not contiguous, so they are copied into batches
+  auto batchSpots = std::make_shared<std::vector<CheckedBallSpot>>();
+  auto batchIndices = std::make_shared<std::vector<size_t>>();
+  for (size_t i = 0; i < spots.size(); ++i)
+    if (spots[i].verifier == CheckedBallSpot::DetectionVerifier::ballPositionCNN && !results[i].valid)
+    {
+      batchSpots->push_back(spots[i]);
+      batchIndices->push_back(i);
+    }
+  if (batchSpots->empty())
+    return tf::Task();
+
+  const int batchSize = std::max(cnnBatchSize, 1);
+  const int numOfBatches = (static_cast<int>(batchSpots->size()) + batchSize - 1) / batchSize;
+  const auto runBatch = [this, batchSpots, batchIndices, batchSize, &results](int batch)
+  {
+    const int first = batch * batchSize;
+    const int count = std::min(batchSize, static_cast<int>(batchSpots->size()) - first);
+    std::vector<BallPerceptTools::BallCNNResult> batchResults(count);
+
+    if (useEarlyExit)
+    {
+      STOPWATCH_WITH_PLOT("CLIPBallPerceptor:TFliteEarlyExitBatch")
+      {
+        BallPerceptTools::runBallCNNWithPositionEarlyExitBatchTflite(theBatchedTfliteInterpreter.splittedBallCNN.at(0).getInterpreter(),
+            theBatchedTfliteInterpreter.splittedBallCNN.at(1).getInterpreter(), batchSpots->data() + first, count, theImage, theImageUpper,
+            tfliteCNN.ballCNNWithPositionZoomOutFactor, tfliteCNN.ballCNNWithPositionThresholdEarlyExit, batchResults.data());
+      }
+    }
+    else
+    {
+      STOPWATCH_WITH_PLOT("CLIPBallPerceptor:TFliteBatch")
+      {
+        BallPerceptTools::runBallCNNWithPositionBatchTflite(theBatchedTfliteInterpreter.ballCNN.getInterpreter(), batchSpots->data() + first, count, theImage, theImageUpper,
+            tfliteCNN.ballCNNWithPositionZoomOutFactor, batchResults.data());
+      }
+    }
+
+    for (int i = 0; i < count; ++i)
+      results[(*batchIndices)[first + i]] = batchResults[i];
+  };
+  return subflow.for_each_index(0, numOfBatches, 1, runBatch).name("BatchedCNN [CLIPBallPerceptor]");
+}
+
+std::tuple<bool, BallPatch> CLIPBallPerceptor::checkBallCNNWithPosition(CheckedBallSpot& spot, BallPerceptTools::BallCNNResult* cnnResult) const
 {
   const Image& image = spot.upper ? (Image&)theImageUpper : theImage;
 
   std::tuple<bool, BallPatch> ret;
 
-  if (useEarlyExit)
+  if (cnnResult && cnnResult->valid)
+  {
+    // computed by runBatchedCNN or reused from the previous frame, other spots are checked on their own below
+    ret = BallPerceptTools::applyBallCNNWithPositionResult(*cnnResult, spot, image, tfliteCNN.ballCNNWithPositionZoomOutFactor, tfliteCNN.ballCNNWithPositionThreshold, useEarlyExit);
+  }
+  else if (useEarlyExit)
   {
     STOPWATCH_WITH_PLOT("CLIPBallPerceptor:TFliteEarlyExit")
     {
       ret = BallPerceptTools::checkBallCNNWithPositionEarlyExitTflite(
-          theSplittedTfliteInterpreter.layers, spot, image, tfliteCNN.ballCNNWithPositionZoomOutFactor, tfliteCNN.ballCNNWithPositionThresholdEarlyExit, tfliteCNN.ballCNNWithPositionThreshold);
+          theSplittedTfliteInterpreter.layers, spot, image, tfliteCNN.ballCNNWithPositionZoomOutFactor, tfliteCNN.ballCNNWithPositionThresholdEarlyExit, tfliteCNN.ballCNNWithPositionThreshold, cnnResult);
     }
   }
   else
@@ -426,7 +556,7 @@ std::tuple<bool, BallPatch> CLIPBallPerceptor::checkBallCNNWithPosition(CheckedB
     STOPWATCH_WITH_PLOT("CLIPBallPerceptor:TFlite")
     {
       ret = BallPerceptTools::checkBallCNNWithPositionTflite(
-          theBallPerceptTfliteInterpreter.getInterpreter(), spot, image, tfliteCNN.ballCNNWithPositionZoomOutFactor, tfliteCNN.ballCNNWithPositionThreshold);
+          theBallPerceptTfliteInterpreter.getInterpreter(), spot, image, tfliteCNN.ballCNNWithPositionZoomOutFactor, tfliteCNN.ballCNNWithPositionThreshold, cnnResult);
     }
   }
 
@@ -519,7 +649,7 @@ std::vector<ScanlinesBallSpot> CLIPBallPerceptor::additionalBallSpotScan() const
   int yStepSize = std::min(ballSize * 2, std::max((imgYStart - imgYEnd) / 10, 5));
   int imgX = imgXStart;
   int imgY = imgYStart;
-  int stepSize = image.height / 240;
+  int stepSize = image.width / 320;
   int stepsX = (imgXEnd - imgXStart) / stepSize;
   int stepsY = (imgYStart - imgYEnd) / stepSize;
 
@@ -681,8 +811,7 @@ std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::verifyBallHull(
       && (scannedCenter - testCircle.center).norm() > std::max<float>(testCircle.radius, (float)(image.height / 80)))
     return ret;
   // clip with body contour
-  int yClipped = static_cast<int>(testCircle.center.y());
-  theBodyContour.clipBottom(static_cast<int>(testCircle.center.x()), yClipped);
+  const int yClipped = std::min(static_cast<int>(testCircle.center.y()), theBodyContour.bottomAt(static_cast<int>(testCircle.center.x()), image.height));
   if (yClipped - 2 > testCircle.center.y())
     return ret;
 
@@ -783,13 +912,14 @@ std::tuple<bool, std::optional<BallPatch>> CLIPBallPerceptor::calcBallSpot2016(C
     const FieldColors& fieldColor = spot.upper ? (FieldColors&)theFieldColorsUpper : theFieldColors;
     const CameraMatrix& cameraMatrix = spot.upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
     const CameraInfo& cameraInfo = spot.upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+    const ImageToFieldProjection& projection = spot.upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
 
     if (image.isOutOfImage(spot.position.x(), spot.position.y(), minDistFromImageBorder))
       return ret;
 
     // theoretical diameter if cameramatrix is correct
     Vector2f posOnField(Vector2f::Zero());
-    if (!Transformation::imageToRobotHorizontalPlane(Vector2f(spot.position.cast<float>()), theFieldDimensions.ballRadius, cameraMatrix, cameraInfo, posOnField))
+    if (!projection.imageToRobotHorizontalPlane(Vector2f(spot.position.cast<float>()), theFieldDimensions.ballRadius, posOnField))
       return ret;
     Geometry::Circle expectedCircle;
     if (!Geometry::calculateBallInImage(posOnField, cameraMatrix, cameraInfo, theFieldDimensions.ballRadius, expectedCircle))
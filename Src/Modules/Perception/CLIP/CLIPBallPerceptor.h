@@ -22,11 +22,15 @@
 #include "Representations/Perception/BallPercept.h"
 #include "Representations/Perception/BallSpots.h"
 #include "Representations/Perception/CLIPFieldLinesPercept.h"
+#include "Representations/Perception/ImageToFieldProjection.h"
 #include "Representations/Modeling/BallModel.h"
 #include "Representations/Modeling/RobotPose.h"
 #include "Representations/MotionControl/MotionInfo.h"
 #include "Representations/Perception/TfliteInterpreter.h"
+#include "Modules/Perception/CLIP/BallPerceptTools.h"
+#include "Modules/Perception/CLIP/BallSpotTracker.h"
 #include <algorithm>
+#include <taskflow/taskflow.hpp>
 #include "stdint.h"
 
 STREAMABLE(MatlabCNN,,
@@ -45,6 +49,14 @@ STREAMABLE(TFLiteCNN,,
     (float)(1.5f) ballCNNWithPositionZoomOutFactor
 );
 
+STREAMABLE(BallSpotTracking,,
+    (bool)(false) enabled, // Reuse the CNN result of a spot of the previous frame if the patch looks the same
+    (unsigned)(300) maxAge, // The CNN is run again for a spot after this many ms
+    (float)(0.25f) maxOffset, // Max distance to the predicted position and max radius difference, relative to the radius
+    (int)(6) maxMeanDifference, // Max mean absolute y difference of the 8x8 thumbnails of the patches
+    (float)(500.f) maxBallModelDistance // Spots closer to the ball model than this (in mm) move with its velocity
+);
+
 MODULE(CLIPBallPerceptor,
   REQUIRES(BodyContour),
   REQUIRES(BodyContourUpper),
@@ -52,6 +64,8 @@ MODULE(CLIPBallPerceptor,
   REQUIRES(CameraInfoUpper),
   REQUIRES(CameraMatrix),
   REQUIRES(CameraMatrixUpper),
+  REQUIRES(ImageToFieldProjection),
+  REQUIRES(ImageToFieldProjectionUpper),
   REQUIRES(CameraIntrinsics),
   REQUIRES(FieldColors),
   REQUIRES(FieldColorsUpper),
@@ -66,6 +80,7 @@ MODULE(CLIPBallPerceptor,
   REQUIRES(MotionInfo),
   REQUIRES(BallPerceptTfliteInterpreter),
   REQUIRES(SplittedTfliteInterpreter),
+  REQUIRES(BatchedTfliteInterpreter),
   USES(BallModel),
   USES(BallPercept),
   PROVIDES(BallPercept),
@@ -92,8 +107,11 @@ MODULE(CLIPBallPerceptor,
     (bool) allowBallObstacleOverlap, // If true, ball percept overlapping with obstacles (goal,robots) will be accepted. Dangerous!
     (int)(50) maxNumberOfHypotheses,
     (bool)(false) useEarlyExit,
+    (bool)(false) useBatchedCNN, // Run the ball CNN with position on all spots of a frame before checking them
+    (int)(16) cnnBatchSize, // Max number of patches per invocation of the batched CNN
     (MatlabCNN) matlabCNN,
-    (TFLiteCNN) tfliteCNN
+    (TFLiteCNN) tfliteCNN,
+    (BallSpotTracking) spotTracking
   )
 );
 
@@ -122,16 +140,31 @@ class CLIPBallPerceptor : public CLIPBallPerceptorBase
 
   bool applyBallRadiusFromCameraMatrix(BallSpot& ballSpot) const;
   std::optional<Vector2f> verifyAndGetBallPositionOnField(const BallSpot& ballSpot) const;
-  [[nodiscard]] std::tuple<bool, std::optional<BallPatch>> checkBallSpot(CheckedBallSpot& spot) const;
-  [[nodiscard]] std::tuple<bool, std::optional<BallPatch>> checkWithVerifier(CheckedBallSpot& spot) const;
-
-  [[nodiscard]] std::tuple<bool, BallPatch> checkBallCNNWithPosition(CheckedBallSpot& spot) const;
+  [[nodiscard]] std::tuple<bool, std::optional<BallPatch>> checkBallSpot(CheckedBallSpot& spot, BallPerceptTools::BallCNNResult* cnnResult = nullptr) const;
+  [[nodiscard]] std::tuple<bool, std::optional<BallPatch>> checkWithVerifier(CheckedBallSpot& spot, BallPerceptTools::BallCNNResult* cnnResult = nullptr) const;
+
+  /**
+  * Runs the ball CNN with position on all spots that are verified by it in batches, which are distributed over the workers.
+  * @param spots The spots of this frame.
+  * @param results The result of each spot. Spots with a valid result are skipped.
+  * @return The task that computes the results.
+  */
+  tf::Task runBatchedCNN(tf::Subflow& subflow, const std::vector<CheckedBallSpot>& spots, std::vector<BallPerceptTools::BallCNNResult>& results) const;
+
+  /**
+  * Checks a spot with the ball CNN with position.
+  * @param cnnResult If valid, it is applied instead of running the CNN. Otherwise, it is set to the result of the CNN.
+  */
+  [[nodiscard]] std::tuple<bool, BallPatch> checkBallCNNWithPosition(CheckedBallSpot& spot, BallPerceptTools::BallCNNResult* cnnResult = nullptr) const;
   [[nodiscard]] std::tuple<bool, std::optional<BallPatch>> checkScanlinesAndCNN(CheckedBallSpot& spot, const float minConfidenceForSpot) const;
 
   BallPercept localBallPercept;
   MultipleBallPercept localMultipleBallPercept;
   std::vector<std::vector<BallPatch>> localProcessedBallPatches;
 
+  BallSpotTracker spotTracker;
+  unsigned lastFrameTime = 0;
+
   bool enableMultipleBallPercept = false;
   bool enableProcessedBallPatches = false;
 
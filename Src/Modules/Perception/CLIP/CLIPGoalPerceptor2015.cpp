@@ -1,6 +1,7 @@
 #include "CLIPGoalPerceptor2015.h"
 #include "Tools/Math/Geometry.h"
 #include "Tools/Math/Transformation.h"
+#include "Tools/SIMD.h"
 
 void CLIPGoalPerceptor2015::update(CLIPGoalPercept& theCLIPGoalPercept)
 {
@@ -57,6 +58,8 @@ void CLIPGoalPerceptor2015::scanForGoalSegments(const bool& upper)
   int scanLineDistance = imageHeight / 48;
   int goalScanStartY = std::max((int)horizon.base.y() - scanLineDistance * 3, 4);
   int goalScanEndY = std::min(std::max(goalScanStartY + scanLineDistance * numberOfScanLines, imageHeight / 5), imageHeight - scanLineDistance - 4);
+  if (scanAboveFieldBorderOnly)
+    goalScanEndY = std::min(goalScanEndY, getLowestFieldBorderY(cameraMatrix, cameraInfo));
 
   int yPos = goalScanStartY;
   while (yPos <= goalScanEndY)
@@ -66,48 +69,125 @@ void CLIPGoalPerceptor2015::scanForGoalSegments(const bool& upper)
   }
 }
 
+int CLIPGoalPerceptor2015::getLowestFieldBorderY(const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo) const
+{
+  if (theRobotPose.validity < minRobotPoseValidityForFieldBorder)
+    return imageHeight;
+
+  const Pose2f fieldToRobot = theRobotPose.inverse();
+  const Vector2f corners[4] = {{theFieldDimensions.xPosOpponentFieldBorder, theFieldDimensions.yPosLeftFieldBorder},
+      {theFieldDimensions.xPosOwnFieldBorder, theFieldDimensions.yPosLeftFieldBorder},
+      {theFieldDimensions.xPosOwnFieldBorder, theFieldDimensions.yPosRightFieldBorder},
+      {theFieldDimensions.xPosOpponentFieldBorder, theFieldDimensions.yPosRightFieldBorder}};
+
+  // below the lowest visible point of the field border, every row shows the carpet
+  float maxY = -1.f;
+  for (int i = 0; i < 4; ++i)
+  {
+    const Vector2f& from = corners[i];
+    const Vector2f& to = corners[(i + 1) % 4];
+    const int steps = std::max(1, static_cast<int>((to - from).norm() / 200.f));
+    for (int j = 0; j <= steps; ++j)
+    {
+      Vector2f pointInImage;
+      if (Transformation::robotToImage(Vector2f(fieldToRobot * (from + (to - from) * (static_cast<float>(j) / steps))), cameraMatrix, cameraInfo, pointInImage)
+          && pointInImage.x() >= 0.f && pointInImage.x() < cameraInfo.width)
+        maxY = std::max(maxY, pointInImage.y());
+    }
+  }
+  return maxY < 0.f ? imageHeight : static_cast<int>(maxY);
+}
+
+void CLIPGoalPerceptor2015::computeGaussRow(const Image& image, const int yPos, const int xStep, const int numOfSamples)
+{
+  // ySamples starts with two copies of the first sample, the state the ring buffer of the scalar scan started with
+  ySamples.resize(numOfSamples + 2);
+  gaussRow.resize(numOfSamples);
+  activeBlocks.resize((numOfSamples + 7) / 8);
+  const Image::Pixel* row = image[yPos] + 4;
+  short* samples = ySamples.data() + 2;
+
+  int k = 0;
+  if (xStep == 1)
+  {
+    // the y channel is the third byte of each pixel
+    const __m128i mask = _mm_set1_epi32(0xff);
+    for (; k + 8 <= numOfSamples; k += 8)
+    {
+      const __m128i y0 = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + k)), 16), mask);
+      const __m128i y1 = _mm_and_si128(_mm_srli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + k + 4)), 16), mask);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + k), _mm_packs_epi32(y0, y1));
+    }
+  }
+  for (; k < numOfSamples; ++k)
+    samples[k] = row[k * xStep].y;
+  ySamples[0] = ySamples[1] = samples[0];
+
+  // gauss[k] = 3 * y[k - 2] - 2 * y[k - 1] - y[k] as the ring buffer was filled twice per sample by the scalar scan
+  const short* y = ySamples.data();
+  const __m128i threshold = _mm_set1_epi16(static_cast<short>(gradientMinDiff));
+  const __m128i negThreshold = _mm_set1_epi16(static_cast<short>(-gradientMinDiff));
+  k = 0;
+  for (; k + 8 <= numOfSamples; k += 8)
+  {
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + k));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + k + 1));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + k + 2));
+    const __m128i gauss = _mm_sub_epi16(_mm_sub_epi16(_mm_add_epi16(a, _mm_add_epi16(a, a)), _mm_add_epi16(b, b)), c);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(gaussRow.data() + k), gauss);
+    const __m128i gradient = _mm_or_si128(_mm_cmpgt_epi16(gauss, threshold), _mm_cmplt_epi16(gauss, negThreshold));
+    activeBlocks[k / 8] = _mm_movemask_epi8(gradient) != 0;
+  }
+  if (k < numOfSamples)
+  {
+    bool active = false;
+    for (; k < numOfSamples; ++k)
+    {
+      gaussRow[k] = static_cast<short>(3 * y[k] - 2 * y[k + 1] - y[k + 2]);
+      active |= gaussRow[k] > gradientMinDiff || gaussRow[k] < -gradientMinDiff;
+    }
+    activeBlocks.back() = active;
+  }
+}
+
 void CLIPGoalPerceptor2015::runSegmentScanLineGauss(const int& yPos, const bool& upper)
 {
   const Image& image = upper ? (Image&)theImageUpper : (Image&)theImage;
 
   const int xStep = std::max(1, imageWidth / 640); // TODO: enough?
-  Image::Pixel p = image[yPos][4];
-  yBuffer.fill(p.y);
-  int lastY = getGauss(yBuffer);
-  int newY = lastY;
+  const int numOfSamples = (imageWidth - 8 - xStep) / xStep + 1;
+  if (numOfSamples <= 0)
+    return;
+  computeGaussRow(image, yPos, xStep, numOfSamples);
+
   bool gradientUp = false;
   bool gradientDown = false;
   bool wasUp = false;
   bool wasDown = false;
   int gradientStart = 4;
-  int yDiff = 0;
 
-  for (int xPos = 4; xPos <= imageWidth - 4 - xStep; xPos += xStep)
+  for (int k = 0; k < numOfSamples; ++k)
   {
-    p = image[yPos][xPos];
-    yBuffer.push_front(p.y);
-    newY = getGauss(yBuffer);
-    yDiff = newY - lastY;
-    //cbDiff = getDiffSum(cbBuffer, p.cb - cbBuffer[0]);
-    //crDiff = getDiffSum(crBuffer, p.cr - crBuffer[0]);
+    // blocks without any gradient do not change the state unless a gradient just ended
+    if (!wasUp && !wasDown && (k & 7) == 0 && !activeBlocks[k / 8])
+    {
+      k += 7;
+      continue;
+    }
 
+    const int xPos = 4 + k * xStep;
+    const int yDiff = gaussRow[k];
     gradientUp = (yDiff > gradientMinDiff);
-    //|| (cbDiff > gradientMinDiff)
-    //|| (crDiff > gradientMinDiff);
     gradientDown = (yDiff < -gradientMinDiff);
-    //|| (cbDiff < -gradientMinDiff)
-    //|| (crDiff < -gradientMinDiff);
-    yBuffer.push_front(p.y);
-    //cbBuffer.add(p.cb);
-    //crBuffer.add(p.cr);
     if ((wasUp && !gradientUp) || (wasDown && !gradientDown))
     {
+      const Image::Pixel& p = image[yPos][xPos];
       int length = std::max(xPos - gradientStart, 2);
       GoalSideSpot gs;
       gs.cb = p.cb;
       gs.cr = p.cr;
       gs.y = p.y;
-      gs.angle = getAngle(xPos - xStep, yPos, length, image);
+      gs.angle = getAngle(xPos - xStep, yPos, length, image, p.y);
       gs.xPos = xPos - length / 2;
       gs.yPos = yPos;
       gs.nextSpot = NULL;
@@ -126,6 +206,7 @@ void CLIPGoalPerceptor2015::runSegmentScanLineGauss(const int& yPos, const bool&
     wasUp = gradientUp;
     wasDown = gradientDown;
   }
+  yBuffer.push_front(ySamples.back());
 }
 
 void CLIPGoalPerceptor2015::runSegmentScanLine(const int& yPos, const bool& upper)
@@ -172,7 +253,7 @@ void CLIPGoalPerceptor2015::runSegmentScanLine(const int& yPos, const bool& uppe
       gs.cb = p.cb;
       gs.cr = p.cr;
       gs.y = p.y;
-      gs.angle = getAngle(xPos - xStep, yPos, length, image);
+      gs.angle = getAngle(xPos - xStep, yPos, length, image, yBuffer[0]);
       gs.xPos = xPos - length / 2;
       gs.yPos = yPos;
       gs.nextSpot = NULL;
@@ -323,7 +404,7 @@ void CLIPGoalPerceptor2015::verifyGoalPosts(CLIPGoalPercept& theCLIPGoalPercept,
     // first check for goal post width - TODO: still necessary?
     // get goal color through width scan
     // then check for bottom of the possible goal posts
-    if (!verifyWidth || scanForGoalPostWidth((*gp), 5 * (imageHeight / 240), upper))
+    if (!verifyWidth || scanForGoalPostWidth((*gp), 5 * (imageWidth / 320), upper))
     {
       if (!verifyWidth)
         (*gp).validity = 0.4f;
@@ -1052,7 +1133,7 @@ int CLIPGoalPerceptor2015::checkForGoalPostColor(const Vector2i& startPoint, con
     {
       if (goalColorCount == 0)
       {
-        float angle = getAngle(checkPoint.x(), checkPoint.y(), 2, image);
+        float angle = getAngle(checkPoint.x(), checkPoint.y(), 2, image, yBuffer[0]);
         if (std::abs(std::abs(angle) - pi_2) > 0.2f)
           goalColorCount--;
       }
@@ -48,7 +48,9 @@ MODULE(CLIPGoalPerceptor2015,
     (int) maxCrDiffOnGoal, /**< Max rb-channel difference allowed while on goal post. */
     (int) gradientMinDiff, /**< Y-channel difference for scan line segmentation. */
     (float) minValidity, /**< Min validity of goal post to be accepted. */
-    (int) numberOfScanLines /**< Number of ScanLines used for goal segment scan. */
+    (int) numberOfScanLines, /**< Number of ScanLines used for goal segment scan. */
+    (bool) scanAboveFieldBorderOnly, /**< If true, no rows below the field border projected with the RobotPose are scanned. */
+    (float) minRobotPoseValidityForFieldBorder /**< Min validity of the RobotPose to use the field border. */
   )
 );
 
@@ -118,6 +120,10 @@ public:
   RingBufferWithSum<int, 5> cbBuffer;
   RingBufferWithSum<int, 5> crBuffer;
 
+  std::vector<short> ySamples; /**< The y values of the samples of the current scan line, preceded by two copies of the first one. */
+  std::vector<short> gaussRow; /**< The smoothed gradient at each sample of the current scan line. */
+  std::vector<unsigned char> activeBlocks; /**< Does each block of 8 samples contain a gradient above gradientMinDiff? */
+
 private:
   void update(CLIPGoalPercept& theCLIPGoalPercept);
 
@@ -130,6 +136,12 @@ private:
   void runSegmentScanLine(const int& yPos, const bool& upper);
   void runSegmentScanLineGauss(const int& yPos, const bool& upper);
 
+  // fills gaussRow and activeBlocks for a scan line with SIMD
+  void computeGaussRow(const Image& image, const int yPos, const int xStep, const int numOfSamples);
+
+  // the lowest row of the field border in the image, or the image height if it is unknown
+  int getLowestFieldBorderY(const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo) const;
+
   void connectGoalSpots(const bool& upper);
 
   void createLinesFromSpots(const bool& upper);
@@ -194,7 +206,8 @@ private:
   int checkForGoalPostColor(const Vector2i& startPoint, const Vector2i& direction, const int& width, const int& optCb, const int& optCr, const int& optY, const bool& upper);
 
   // sobel
-  inline float getAngle(const int xPos, const int yPos, const int length, const Image& image)
+  // yB3 is the y value right of the center, which the scans already know
+  inline float getAngle(const int xPos, const int yPos, const int length, const Image& image, const int yB3)
   {
     const int length2 = length / 2;
     const int x1 = xPos - length;
@@ -208,7 +221,6 @@ private:
     int yA3 = image[y1][xPos].y;
     int yB1 = image[yPos][x1].y;
     //int yB2 = image.image[yPos][x2].y;
-    int yB3 = yBuffer[0];
     int yC1 = image[y3][x1].y;
     int yC2 = image[y3][x2].y;
     int yC3 = image[y3][xPos].y;
@@ -1,5 +1,6 @@
 #include "CLIPLineFinder.h"
 #include "Tools/Math/Transformation.h"
+#include <limits>
 
 // for drawings
 #ifdef USE_FULL_RESOLUTION
@@ -16,6 +17,8 @@ CLIPLineFinder::CLIPLineFinder()
   lineSegments.reserve(100);
   wasReset = false;
   drawUpper = true;
+  pairTests = 0;
+  workLimitHits = 0;
 }
 
 void CLIPLineFinder::reset()
@@ -51,6 +54,96 @@ void CLIPLineFinder::declareDebugDrawings()
   DECLARE_DEBUG_DRAWING("module:CLIPLineFinder:verifyLineSegment", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:CLIPLineFinder:connectPoints:Upper", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:CLIPLineFinder:connectPoints:Lower", "drawingOnImage");
+  DECLARE_PLOT("module:CLIPLineFinder:pairTests:Upper");
+  DECLARE_PLOT("module:CLIPLineFinder:pairTests:Lower");
+  DECLARE_PLOT("module:CLIPLineFinder:workLimitHits");
+}
+
+void CLIPLineFinder::NeighborGrid::clear()
+{
+  entries.clear();
+  alwaysIds.clear();
+}
+
+void CLIPLineFinder::NeighborGrid::add(int id, const Vector2f& position)
+{
+  if (position.allFinite())
+    entries.emplace_back(id, position);
+  else
+    alwaysIds.push_back(id);
+}
+
+void CLIPLineFinder::NeighborGrid::build(float cellSize)
+{
+  const int maxCells = 16384;
+
+  this->cellSize = std::max(cellSize, 1.f);
+  width = 0;
+  height = 0;
+  cellOffsets.clear();
+  cellIds.clear();
+  if (entries.empty())
+    return;
+
+  origin = entries.front().second;
+  Vector2f maxPosition = origin;
+  for (const auto& entry : entries)
+  {
+    origin = origin.cwiseMin(entry.second);
+    maxPosition = maxPosition.cwiseMax(entry.second);
+  }
+  do
+  {
+    width = static_cast<int>((maxPosition.x() - origin.x()) / this->cellSize) + 1;
+    height = static_cast<int>((maxPosition.y() - origin.y()) / this->cellSize) + 1;
+    if (width * height > maxCells)
+      this->cellSize *= 2.f;
+  } while (width * height > maxCells);
+
+  // counting sort by cell keeps the ids of each cell in the order they were added
+  auto cellOf = [&](const Vector2f& position)
+  {
+    const int x = std::min(width - 1, static_cast<int>((position.x() - origin.x()) / this->cellSize));
+    const int y = std::min(height - 1, static_cast<int>((position.y() - origin.y()) / this->cellSize));
+    return y * width + x;
+  };
+  cellOffsets.assign(width * height + 1, 0);
+  for (const auto& entry : entries)
+    cellOffsets[cellOf(entry.second)]++;
+  int offset = 0;
+  for (int& cellOffset : cellOffsets)
+  {
+    const int count = cellOffset;
+    cellOffset = offset;
+    offset += count;
+  }
+  cellIds.resize(entries.size());
+  for (const auto& entry : entries)
+    cellIds[cellOffsets[cellOf(entry.second)]++] = entry.first;
+  for (int cell = width * height; cell > 0; cell--)
+    cellOffsets[cell] = cellOffsets[cell - 1];
+  cellOffsets[0] = 0;
+}
+
+void CLIPLineFinder::NeighborGrid::query(const Vector2f& min, const Vector2f& max, std::vector<int>& ids) const
+{
+  ids = alwaysIds;
+  if (width > 0)
+  {
+    const Vector2f minCell = (min - origin) / cellSize;
+    const Vector2f maxCell = (max - origin) / cellSize;
+    if (maxCell.x() >= 0.f && maxCell.y() >= 0.f && minCell.x() < width && minCell.y() < height)
+    {
+      const int xStart = std::max(0, static_cast<int>(minCell.x()));
+      const int yStart = std::max(0, static_cast<int>(minCell.y()));
+      const int xEnd = std::min(width - 1, static_cast<int>(maxCell.x()));
+      const int yEnd = std::min(height - 1, static_cast<int>(maxCell.y()));
+      for (int y = yStart; y <= yEnd; y++)
+        ids.insert(ids.end(), cellIds.begin() + cellOffsets[y * width + xStart], cellIds.begin() + cellOffsets[y * width + xEnd + 1]);
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 }
 
 bool validityHigher(const CLIPFieldLinesPercept::FieldLine& first, const CLIPFieldLinesPercept::FieldLine& second)
@@ -89,6 +182,7 @@ void CLIPLineFinder::execute(const bool& upper)
 
     lineSegments.clear();
     linePoints.clear();
+    pairTests = 0;
 
 #ifdef USE_FULL_RESOLUTION
     imageWidth = image.resolutionWidth * 2;
@@ -207,30 +301,54 @@ void CLIPLineFinder::execute(const bool& upper)
 
     // TODO?
     correctCenterCircle();
+
+    if (upper)
+      PLOT("module:CLIPLineFinder:pairTests:Upper", pairTests);
+    else
+      PLOT("module:CLIPLineFinder:pairTests:Lower", pairTests);
+    PLOT("module:CLIPLineFinder:workLimitHits", workLimitHits);
   }
 }
 
 void CLIPLineFinder::connectPoints(const bool& upper)
 {
-  int pointNo = 0, pointNoOther = 1;
+  int pointNo = 0;
   int size = static_cast<int>(linePoints.size());
   int closestPoint = -1;
   int closestDistance = 0, dist = 0;
   float distOther = 0.f;
   float closestDistanceOther = 0.f;
   //float maxLineSizeDiff = (float)(imageHeight / 120);
+
+  // only points within maxNoDistLinesImage scan lines in both directions can be connected
+  pointGrid.clear();
+  for (int i = 0; i < size; i++)
+    pointGrid.add(i, Vector2i(linePoints[i].point->scanLineNoV, linePoints[i].point->scanLineNoH).cast<float>());
+  pointGrid.build(static_cast<float>(maxNoDistLinesImage));
+  const Vector2f maxScanLineDist = Vector2f::Constant(static_cast<float>(maxNoDistLinesImage));
+
   while (pointNo < size - 1)
   {
-    pointNoOther = pointNo + 1;
     closestPoint = -1;
     closestDistance = imageWidth;
     closestDistanceOther = (float)imageWidth;
-    while (pointNoOther < size)
+    const CLIPPointsPercept::Point* p = linePoints[pointNo].point;
+    Vector2i scanLineNoP(p->scanLineNoV, p->scanLineNoH);
+
+    // candidates are visited in the same order as when testing all pairs, so the same connections are found
+    pointGrid.query(scanLineNoP.cast<float>() - maxScanLineDist, scanLineNoP.cast<float>() + maxScanLineDist, neighborIds);
+    std::vector<int>::const_iterator candidate = std::upper_bound(neighborIds.begin(), neighborIds.end(), pointNo);
+    pairTests += static_cast<int>(neighborIds.end() - candidate);
+    if (pairTests > maxPointPairTests)
     {
-      const CLIPPointsPercept::Point* p = linePoints[pointNo].point;
+      workLimitHits++;
+      break;
+    }
+    for (; candidate != neighborIds.end(); candidate++)
+    {
+      const int pointNoOther = *candidate;
       const CLIPPointsPercept::Point* pOther = linePoints[pointNoOther].point;
 
-      Vector2i scanLineNoP(p->scanLineNoV, p->scanLineNoH);
       Vector2i scanLineNoPOther(pOther->scanLineNoV, pOther->scanLineNoH);
       int scanLineDist = (scanLineNoPOther - scanLineNoP).norm();
       if (scanLineDist > 0 && scanLineDist <= maxNoDistLinesImage)
@@ -261,8 +379,6 @@ void CLIPLineFinder::connectPoints(const bool& upper)
           }
         }
       }
-
-      pointNoOther++;
     }
     if (closestPoint >= 0 && linePoints[closestPoint].predecessor == -1) //closest point was set to not zero -> connect the 2 points up
     {
@@ -403,11 +519,29 @@ void CLIPLineFinder::connectSegments(const bool& upper)
 {
   const Image& image = upper ? (Image&)theImageUpper : (Image&)theImage;
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   int segNo = 0, segNoOther = 0;
   bool verified = false;
   Vector2f baseCenter(0, 0);
+
+  // segments are only tested for a circle if their start or end point is close enough to its center
+  segmentGrid.clear();
+  for (int id = 0; id < (int)lineSegments.size(); id++)
+  {
+    for (const int point : {lineSegments[id].startPoint, lineSegments[id].endPoint})
+    {
+      Vector2f pointOnField;
+      if (!projection.imageToRobot(linePoints[point].point->inImage, pointOnField))
+        pointOnField = Vector2f::Constant(std::numeric_limits<float>::quiet_NaN());
+      segmentGrid.add(id, pointOnField);
+    }
+  }
+  segmentGrid.build(theFieldDimensions.centerCircleRadius);
+  const Vector2f maxDistToCenter = Vector2f::Constant(theFieldDimensions.centerCircleRadius + 2.f * maxCenterCircleRadiusDiffField);
+  int circleSegmentTests = 0;
+
   // first connect small segments of similar curvature that may lie on a circle
   while (segNo < (int)lineSegments.size() - 1)
   {
@@ -463,15 +597,21 @@ void CLIPLineFinder::connectSegments(const bool& upper)
       }
       baseCenter = newCC.circle.center;
 
-      segNoOther = 0;
+      segmentGrid.query(baseCenter - maxDistToCenter, baseCenter + maxDistToCenter, neighborIds);
+      circleSegmentTests += static_cast<int>(neighborIds.size());
+      pairTests += static_cast<int>(neighborIds.size());
+      if (circleSegmentTests > maxCircleSegmentTests)
+      {
+        workLimitHits++;
+        break;
+      }
+
       verified = false;
-      while (segNoOther < (int)lineSegments.size())
+      for (const int id : neighborIds)
       {
+        segNoOther = id;
         if (segNoOther == segNo || lineSegments[segNoOther].pointNo < 2 || (lineSegments[segNoOther].pointNo >= minPointsForLine && lineSegments[segNoOther].angleSum <= maxAngleSumLineImage))
-        {
-          segNoOther++;
           continue;
-        }
         if (addSegmentPointsToCircle(lineSegments[segNoOther], newCC, upper))
         {
           if (!Geometry::computeCircleOnFieldLevenbergMarquardt(newCC.pointsOnCircle, newCC.circle))
@@ -491,8 +631,6 @@ void CLIPLineFinder::connectSegments(const bool& upper)
         }
         else
           removeSegmentPointsFromCircle(lineSegments[segNoOther], newCC);
-
-        segNoOther++;
       }
 
       // create center circle from start/end and one middle point
@@ -602,13 +740,14 @@ void CLIPLineFinder::connectSegments(const bool& upper)
   // then create field lines and penalty cross from remaining line segments
   segNo = 0;
   bool foundConnection = false;
+  int segmentPairTests = 0;
   while (segNo < (int)lineSegments.size())
   {
     if (lineSegments[segNo].pointNo <= 5 && createPenaltyCross(lineSegments[segNo], upper))
     {
       Vector2f pImage((linePoints[lineSegments[segNo].endPoint].point->inImage + linePoints[lineSegments[segNo].endPoint].point->inImage) * 0.5f);
       Vector2f pField;
-      if (Transformation::imageToRobot(pImage, cameraMatrix, cameraInfo, pField)
+      if (projection.imageToRobot(pImage, pField)
           && (!localPenaltyCrossPercept.penaltyCrossWasSeen || pField.norm() < localPenaltyCrossPercept.pointOnField.cast<float>().norm()))
       {
         // TODO: check if image point has to be scaled with /RES_DIV_FACTOR
@@ -627,9 +766,14 @@ void CLIPLineFinder::connectSegments(const bool& upper)
     foundConnection = false;
     std::vector<CLIPFieldLinesPercept::FieldLine>& lineVector = upper ? (foundLinesUpper) : (foundLines);
 
-    for (int lineNo = 0; lineNo < (int)lineVector.size(); lineNo++)
+    // project the segment once for all lines
+    const Vector2f& imgStart = linePoints[lineSegments[segNo].startPoint].point->inImage;
+    const Vector2f& imgEnd = linePoints[lineSegments[segNo].endPoint].point->inImage;
+    Vector2f startPointField, endPointField;
+    const bool segmentOnField = projection.imageToRobot(imgStart, startPointField) && projection.imageToRobot(imgEnd, endPointField);
+    for (int lineNo = 0; segmentOnField && lineNo < (int)lineVector.size(); lineNo++)
     {
-      if (connectSegmentToFieldLine(linePoints[lineSegments[segNo].startPoint].point->inImage, linePoints[lineSegments[segNo].endPoint].point->inImage, lineVector[lineNo], upper))
+      if (connectSegmentToFieldLine(imgStart, imgEnd, startPointField, endPointField, lineVector[lineNo], upper))
       {
         lineSegments.erase(lineSegments.begin() + segNo);
         foundConnection = true;
@@ -638,11 +782,16 @@ void CLIPLineFinder::connectSegments(const bool& upper)
     }
     if (!foundConnection)
     {
-      if (lineSegments[segNo].pointNo < minPointsForLine)
+      if (lineSegments[segNo].pointNo < minPointsForLine && segmentPairTests <= maxSegmentPairTests)
       {
         segNoOther = segNo + 1;
         while (segNoOther < (int)lineSegments.size())
         {
+          if (lineSegments[segNoOther].pointNo > 1 && ++segmentPairTests > maxSegmentPairTests)
+          {
+            workLimitHits++;
+            break;
+          }
           if (lineSegments[segNoOther].pointNo > 1 && connect2Segments(lineSegments[segNo], lineSegments[segNoOther], upper))
           {
             // we have a connection for these 2 segments -> update point connections and make sure no points have the same successor/predecessor
@@ -807,6 +956,7 @@ void CLIPLineFinder::correctCenterCircle() {}
 void CLIPLineFinder::enhanceFieldLines(const bool& upper)
 {
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   float lineWidth, lastLineWidth;
@@ -815,6 +965,7 @@ void CLIPLineFinder::enhanceFieldLines(const bool& upper)
 
   std::vector<Vector2f> checkPoints;
   checkPoints.clear();
+  std::vector<float> checkDistances;
 
   std::vector<CLIPFieldLinesPercept::FieldLine>& lineVector = upper ? (foundLinesUpper) : (foundLines);
   std::vector<CLIPFieldLinesPercept::FieldLine>::iterator line = lineVector.begin();
@@ -886,14 +1037,14 @@ void CLIPLineFinder::enhanceFieldLines(const bool& upper)
       scanPoint = lastCenter + lineDir;
     }
 
+    Geometry::Line l;
+    l.base = lineEnd;
+    l.direction = lineDir;
+    checkDistances.resize(checkPoints.size());
+    Geometry::getDistanceToLine(l, checkPoints, checkDistances);
     float distSum = 0.0;
-    for (int i = 0; i < (int)checkPoints.size(); i++)
-    {
-      Geometry::Line l;
-      l.base = lineEnd;
-      l.direction = lineDir;
-      distSum += std::abs(Geometry::getDistanceToLine(l, checkPoints[i]));
-    }
+    for (float d : checkDistances)
+      distSum += std::abs(d);
     if (distSum > std::max(3.f, (line->lineWidthStart + line->lineWidthEnd) / 5))
     {
       if (lineLength < 1500.f)
@@ -902,7 +1053,7 @@ void CLIPLineFinder::enhanceFieldLines(const bool& upper)
         line++;
       continue;
     }
-    else if (!checkPoints.empty() && Transformation::imageToRobot(checkPoints.back(), cameraMatrix, cameraInfo, line->endOnField))
+    else if (!checkPoints.empty() && projection.imageToRobot(checkPoints.back(), line->endOnField))
     {
       line->endInImage = checkPoints.back().cast<int>();
       lineEnd = checkPoints.back();
@@ -947,14 +1098,13 @@ void CLIPLineFinder::enhanceFieldLines(const bool& upper)
       scanPoint = lastCenter + lineDir;
     }
 
+    l.base = lineEnd;
+    l.direction = lineDir;
+    checkDistances.resize(checkPoints.size());
+    Geometry::getDistanceToLine(l, checkPoints, checkDistances);
     distSum = 0.f;
-    for (int i = 0; i < (int)checkPoints.size(); i++)
-    {
-      Geometry::Line l;
-      l.base = lineEnd;
-      l.direction = lineDir;
-      distSum += std::abs(Geometry::getDistanceToLine(l, checkPoints[i]));
-    }
+    for (float d : checkDistances)
+      distSum += std::abs(d);
     if (distSum > std::max<float>(3.f, (line->lineWidthStart + line->lineWidthEnd) / 5))
     {
       if (lineLength < 1500.f)
@@ -964,7 +1114,7 @@ void CLIPLineFinder::enhanceFieldLines(const bool& upper)
     }
     else
     {
-      if (!checkPoints.empty() && Transformation::imageToRobot(checkPoints.back(), cameraMatrix, cameraInfo, line->startOnField))
+      if (!checkPoints.empty() && projection.imageToRobot(checkPoints.back(), line->startOnField))
       {
         line->startInImage = checkPoints.back().cast<int>();
         line->lineWidthStart = lastLineWidth;
@@ -1042,6 +1192,7 @@ bool CLIPLineFinder::getLineCenterAndWidth(const Vector2f scanPoint, const Vecto
 bool CLIPLineFinder::addSegmentPointsToCircle(LineSegment& seg, CenterCircle& circle, const bool& upper)
 {
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   int nextPoint = seg.startPoint;
@@ -1072,7 +1223,7 @@ bool CLIPLineFinder::addSegmentPointsToCircle(LineSegment& seg, CenterCircle& ci
       }
     }
     Vector2f pointOnField;
-    if (Transformation::imageToRobot(linePoints[nextPoint].point->inImage, cameraMatrix, cameraInfo, pointOnField))
+    if (projection.imageToRobot(linePoints[nextPoint].point->inImage, pointOnField))
     {
       circle.pointsOnCircle.push_back(pointOnField);
       if (onField && count > 1)
@@ -1147,6 +1298,7 @@ bool CLIPLineFinder::connect2Segments(LineSegment& segA, LineSegment& segB, cons
 {
   // TODO: check for sensible line width diffs
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   if (linePoints[segA.startPoint].point->isVertical != linePoints[segB.startPoint].point->isVertical)
@@ -1227,20 +1379,20 @@ bool CLIPLineFinder::connect2Segments(LineSegment& segA, LineSegment& segB, cons
   distSum += getPoint2LineDistance(linePoints[segA.startPoint].point->inImage, linePoints[segA.endPoint].point->inImage, linePoints[segB.startPoint].point->inImage);
   distSum += getPoint2LineDistance(linePoints[segB.startPoint].point->inImage, linePoints[segB.endPoint].point->inImage, linePoints[segA.startPoint].point->inImage);
   distSum += getPoint2LineDistance(linePoints[segB.startPoint].point->inImage, linePoints[segB.endPoint].point->inImage, linePoints[segA.startPoint].point->inImage);
-  if (distSum < (maxDistSumPointsToLineImage * parameterScale) && Transformation::imageToRobot(newFL.endInImage, cameraMatrix, cameraInfo, newFL.endOnField)
-      && Transformation::imageToRobot(newFL.startInImage, cameraMatrix, cameraInfo, newFL.startOnField))
+  if (distSum < (maxDistSumPointsToLineImage * parameterScale) && projection.imageToRobot(newFL.endInImage, newFL.endOnField)
+      && projection.imageToRobot(newFL.startInImage, newFL.startOnField))
   {
     Vector2f onFieldEndFirst, onFieldStartSecond;
     if (segAFirst && !checkForGreenBetween(linePoints[segA.endPoint].point->inImage, linePoints[segB.startPoint].point->inImage, upper))
     {
-      if (!Transformation::imageToRobot(linePoints[segA.endPoint].point->inImage, cameraMatrix, cameraInfo, onFieldEndFirst)
-          || !Transformation::imageToRobot(linePoints[segB.startPoint].point->inImage, cameraMatrix, cameraInfo, onFieldStartSecond))
+      if (!projection.imageToRobot(linePoints[segA.endPoint].point->inImage, onFieldEndFirst)
+          || !projection.imageToRobot(linePoints[segB.startPoint].point->inImage, onFieldStartSecond))
         OUTPUT_WARNING("CLIPLineFinder : imageToRobot failed in connect2Segments");
     }
     else if (!segAFirst && !checkForGreenBetween(linePoints[segB.endPoint].point->inImage, linePoints[segA.startPoint].point->inImage, upper))
     {
-      if (!Transformation::imageToRobot(linePoints[segB.endPoint].point->inImage, cameraMatrix, cameraInfo, onFieldEndFirst)
-          || !Transformation::imageToRobot(linePoints[segA.startPoint].point->inImage, cameraMatrix, cameraInfo, onFieldStartSecond))
+      if (!projection.imageToRobot(linePoints[segB.endPoint].point->inImage, onFieldEndFirst)
+          || !projection.imageToRobot(linePoints[segA.startPoint].point->inImage, onFieldStartSecond))
         OUTPUT_WARNING("CLIPLineFinder : imageToRobot failed in connect2Segments");
     }
     else
@@ -1293,6 +1445,7 @@ bool CLIPLineFinder::connect2Segments(LineSegment& segA, LineSegment& segB, cons
 bool CLIPLineFinder::createLineFromSingleSegment(const LineSegment& seg, const bool& upper)
 {
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   std::vector<Vector2f> pointsOnLine;
@@ -1308,7 +1461,7 @@ bool CLIPLineFinder::createLineFromSingleSegment(const LineSegment& seg, const b
     Vector2f pField(0, 0);
     if (seg.pointNo < 2 * minPointsForLine)
     {
-      if (!Transformation::imageToRobot(linePoints[point].point->inImage, cameraMatrix, cameraInfo, pField))
+      if (!projection.imageToRobot(linePoints[point].point->inImage, pField))
         return false;
       if (count > 1)
       {
@@ -1340,6 +1493,7 @@ bool CLIPLineFinder::createPenaltyCross(const LineSegment& seg, const bool& uppe
 {
   const Image& image = upper ? (Image&)theImageUpper : theImage;
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
   const FieldColors& fieldColor = upper ? (FieldColorsUpper&)theFieldColorsUpper : theFieldColors;
 
@@ -1356,7 +1510,7 @@ bool CLIPLineFinder::createPenaltyCross(const LineSegment& seg, const bool& uppe
     return false;
 
   Vector2f checkPointOnField;
-  if (Transformation::imageToRobot(checkPoint.x(), checkPoint.y(), cameraMatrix, cameraInfo, checkPointOnField))
+  if (projection.imageToRobot(checkPoint, checkPointOnField))
   {
     float distance = checkPointOnField.norm();
     float distanceFactor = std::max(0.5f, std::min(1.0f, 1.f - (distance / 9000.f)));
@@ -1501,16 +1655,10 @@ void CLIPLineFinder::update(PrePenaltyCrossHypothesesScanlines& thePrePenaltyCro
   thePrePenaltyCrossHypothesesScanlines = pchs;
 }
 
-bool CLIPLineFinder::connectSegmentToFieldLine(const Vector2f& imgStart, const Vector2f& imgEnd, CLIPFieldLinesPercept::FieldLine& line, const bool& upper)
+bool CLIPLineFinder::connectSegmentToFieldLine(
+    const Vector2f& imgStart, const Vector2f& imgEnd, const Vector2f& startPointField, const Vector2f& endPointField, CLIPFieldLinesPercept::FieldLine& line, const bool& upper)
 {
   // TODO: check for sensible line width diffs
-  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
-
-  Vector2f startPointField, endPointField;
-  if (!Transformation::imageToRobot(imgStart, cameraMatrix, cameraInfo, startPointField) || !Transformation::imageToRobot(imgEnd, cameraMatrix, cameraInfo, endPointField))
-    return false;
-
   bool segFirst = (startPointField - line.endOnField).norm() > (startPointField - line.startOnField).norm();
 
   // check for distance between segment and line, also check for distance of points to new line
@@ -1555,6 +1703,7 @@ bool CLIPLineFinder::connectSegmentToFieldLine(const Vector2f& imgStart, const V
 bool CLIPLineFinder::createFieldLine(const std::vector<Vector2f>& pointsOnLine, const float& lineWidthStart, const float& lineWidthEnd, const bool& upper)
 {
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const ImageToFieldProjection& projection = upper ? static_cast<const ImageToFieldProjection&>(theImageToFieldProjectionUpper) : theImageToFieldProjection;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   float biggestError = 0.f, avgError = 0.f;
@@ -1583,7 +1732,7 @@ bool CLIPLineFinder::createFieldLine(const std::vector<Vector2f>& pointsOnLine,
   newFL.validity = 0.f;
   newFL.isPlausible = false;
   newFL.fromUpper = upper;
-  if (!Transformation::imageToRobot(startImage, cameraMatrix, cameraInfo, newFL.startOnField) || !Transformation::imageToRobot(endImage, cameraMatrix, cameraInfo, newFL.endOnField))
+  if (!projection.imageToRobot(startImage, newFL.startOnField) || !projection.imageToRobot(endImage, newFL.endOnField))
     return false;
   float distSum = 0.f;
   Vector2f newFLDir = (newFL.endOnField - newFL.startOnField);
@@ -1669,31 +1818,17 @@ bool CLIPLineFinder::verifyLine(const CLIPFieldLinesPercept::FieldLine& line, co
 
 bool CLIPLineFinder::checkForGreenBetween(const Vector2f& startInImage, const Vector2f& endInImage, const bool& upper)
 {
-  const Image& image = upper ? (Image&)theImageUpper : theImage;
-  const FieldColors& fieldColor = upper ? (FieldColorsUpper&)theFieldColorsUpper : theFieldColors;
+  const CLIPClassifiedPixels& classifiedPixels = upper ? (CLIPClassifiedPixels&)theCLIPClassifiedPixelsUpper : theCLIPClassifiedPixels;
 
   int length = static_cast<int>((endInImage - startInImage).norm());
   int sampleDistance = std::max(length / 10, 3);
   int sampleCount = length / sampleDistance;
-  int steps = 0;
-  int greenCount = 0;
+  int greenCount = 0, whiteCount = 0;
   if (sampleCount < 5)
     return true;
-  Vector2f checkPoint(startInImage);
   Vector2f scanDir(endInImage - startInImage);
   scanDir.normalize((float)sampleDistance);
-  while (steps < sampleCount && !image.isOutOfImage(checkPoint.x(), checkPoint.y(), 2))
-  {
-#ifdef USE_FULL_RESOLUTION
-    Image::YUVPixel p;
-    image.getPixel((unsigned int)checkPoint.x, (unsigned int)checkPoint.y, &p);
-#else
-    Image::Pixel p = image[(unsigned int)checkPoint.y()][(unsigned int)checkPoint.x()];
-#endif
-    greenCount += fieldColor.isPixelFieldColor(p.y, p.cb, p.cr);
-    steps++;
-    checkPoint += scanDir;
-  }
+  const int steps = classifiedPixels.sample(startInImage, scanDir, sampleCount, 2, greenCount, whiteCount);
   if (greenCount >= steps / 2 || steps < 5)
     return true;
   return false;
@@ -1703,39 +1838,18 @@ bool CLIPLineFinder::checkForWhiteBetween(const Vector2f& startInImage, const Ve
 {
   LINE("module:CLIPLineFinder:checkForWhiteBetween", startInImage.x(), startInImage.y(), endInImage.x(), endInImage.y(), 3, Drawings::solidPen, ColorRGBA(138, 43, 226));
 
-  const Image& image = upper ? (Image&)theImageUpper : theImage;
-  const FieldColors& fieldColor = upper ? (FieldColorsUpper&)theFieldColorsUpper : theFieldColors;
+  const CLIPClassifiedPixels& classifiedPixels = upper ? (CLIPClassifiedPixels&)theCLIPClassifiedPixelsUpper : theCLIPClassifiedPixels;
 
   int length = (int)(endInImage - startInImage).norm();
   int sampleDistance = std::max(length / 20, 1);
   int sampleCount = length / sampleDistance;
-  int steps = 0;
-  int greenCount = 0;
+  int greenCount = 0, whiteCount = 0;
   if (sampleCount < 5)
     return true;
-  Vector2f checkPoint(startInImage);
   Vector2f scanDir(endInImage - startInImage);
   scanDir.normalize((float)sampleDistance);
-  int greenWhiteY = fieldColor.fieldColorArray[0].fieldColorOptY;
-  int whiteCount = 0;
-  while (steps < sampleCount && !image.isOutOfImage(checkPoint.x(), checkPoint.y(), 2))
-  {
-#ifdef USE_FULL_RESOLUTION
-    Image::YUVPixel p;
-    image.getPixel((unsigned int)checkPoint.x, (unsigned int)checkPoint.y, &p);
-#else
-    Image::Pixel p = image[(unsigned int)checkPoint.y()][(unsigned int)checkPoint.x()];
-#endif
-    if (fieldColor.isPixelFieldColor(p.y, p.cb, p.cr))
-    {
-      greenCount++;
-      greenWhiteY += p.y;
-    }
-    else if (p.y > (greenWhiteY / (greenCount + 1)) + fieldColor.fieldColorArray[0].lineToFieldColorYThreshold)
-      whiteCount++;
-    steps++;
-    checkPoint += scanDir;
-  }
+  // white is brighter than the field color of the whole image
+  const int steps = classifiedPixels.sample(startInImage, scanDir, sampleCount, 2, greenCount, whiteCount);
   if (greenCount >= steps / 4 && whiteCount >= std::max(lineSize * 0.75f, 1.f))
     return true;
   return false;
@@ -13,7 +13,9 @@
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Perception/CameraMatrix.h"
+#include "Representations/Perception/CLIPClassifiedPixels.h"
 #include "Representations/Perception/CLIPPointsPercept.h"
+#include "Representations/Perception/ImageToFieldProjection.h"
 #include "Representations/Perception/CenterCirclePercept.h"
 #include "Representations/Perception/CLIPFieldLinesPercept.h"
 #include "Representations/Perception/PenaltyCrossPercept.h"
@@ -35,7 +37,11 @@ MODULE(CLIPLineFinder,
   REQUIRES(ImageUpper),
   REQUIRES(CameraMatrix),
   REQUIRES(CameraMatrixUpper),
+  REQUIRES(ImageToFieldProjection),
+  REQUIRES(ImageToFieldProjectionUpper),
   REQUIRES(CLIPPointsPercept),
+  REQUIRES(CLIPClassifiedPixels),
+  REQUIRES(CLIPClassifiedPixelsUpper),
   REQUIRES(FrameInfo),
   REQUIRES(FieldColors),
   REQUIRES(FieldColorsUpper),
@@ -73,7 +79,10 @@ MODULE(CLIPLineFinder,
     (Angle) maxSegmentAngleDiffImage, /** max angle difference between two segments to connect */
     (float) maxValidityDenominator, /**< denominator of image diagonal length for full validity */
     (float)(0.5f) minConfidenceForPenaltyCrossUpper, /**< min confidence threshold for the upper image based on the deviation of the calculated penaltycross size in the image */
-    (float)(0.5f) minConfidenceForPenaltyCrossLower /**< min confidence threshold for the lower image based on the deviation of the calculated penaltycross size in the image */
+    (float)(0.5f) minConfidenceForPenaltyCrossLower, /**< min confidence threshold for the lower image based on the deviation of the calculated penaltycross size in the image */
+    (int)(20000) maxPointPairTests, /**< max # of point pairs tested for a connection per image */
+    (int)(400) maxCircleSegmentTests, /**< max # of segments tested for being part of a center circle candidate per image */
+    (int)(2000) maxSegmentPairTests /**< max # of segment pairs tested for a connection per image */
   )
 );
 
@@ -112,6 +121,33 @@ public:
     bool onCircle;
   };
 
+  /**
+  * Uniform grid over 2D coordinates that is rebuilt every frame to find the neighbor candidates of a position
+  * without testing all pairs. Positions that are not finite are returned by every query.
+  */
+  struct NeighborGrid
+  {
+    void clear();
+    void add(int id, const Vector2f& position);
+    void build(float cellSize);
+
+    /**
+    * Collects all ids whose position may lie within the given rectangle (and maybe some more).
+    * @param min The lower corner of the rectangle.
+    * @param max The upper corner of the rectangle.
+    * @param ids The ids found, sorted ascending and without duplicates.
+    */
+    void query(const Vector2f& min, const Vector2f& max, std::vector<int>& ids) const;
+
+    std::vector<std::pair<int, Vector2f>> entries;
+    std::vector<int> alwaysIds; // ids of positions that are not finite
+    std::vector<int> cellOffsets; // entries of cell i are cellIds[cellOffsets[i]] .. cellIds[cellOffsets[i + 1] - 1]
+    std::vector<int> cellIds;
+    Vector2f origin = Vector2f::Zero();
+    float cellSize = 1.f;
+    int width = 0, height = 0;
+  };
+
   void reset();
 
   void execute(const bool& upper);
@@ -146,6 +182,13 @@ private:
   // for debugging
   bool drawUpper;
 
+  // per frame work
+  NeighborGrid pointGrid; // line points at their scan line numbers
+  NeighborGrid segmentGrid; // segment start and end points on field
+  std::vector<int> neighborIds;
+  int pairTests; // pairs tested in the current image
+  unsigned workLimitHits; // how often one of the max*Tests bounds was hit
+
   // connect points that are close enough
   void connectPoints(const bool& upper);
   // split connected points to fitting line segments
@@ -203,7 +246,8 @@ private:
   bool connect2Segments(LineSegment& segA, LineSegment& segB, const bool& upper);
   bool createLineFromSingleSegment(const LineSegment& seg, const bool& upper);
   bool createPenaltyCross(const LineSegment& seg, const bool& upper);
-  bool connectSegmentToFieldLine(const Vector2f& imgStart, const Vector2f& imgEnd, CLIPFieldLinesPercept::FieldLine& line, const bool& upper);
+  bool connectSegmentToFieldLine(
+      const Vector2f& imgStart, const Vector2f& imgEnd, const Vector2f& startPointField, const Vector2f& endPointField, CLIPFieldLinesPercept::FieldLine& line, const bool& upper);
 
   bool checkForGreenBetween(const Vector2f& startInImage, const Vector2f& endInImage, const bool& upper);
   bool checkForWhiteBetween(const Vector2f& startInImage, const Vector2f& endInImage, const float& lineSize, const bool& upper);
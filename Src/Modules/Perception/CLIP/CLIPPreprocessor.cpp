@@ -7,71 +7,69 @@
 #include "CLIPPreprocessor.h"
 #include "Tools/Streams/InStreams.h"
 #include "Tools/Settings.h"
-#include "Tools/Math/Random.h"
+#include "Tools/ProcessFramework/CycleArena.h"
+#include "Tools/ImageProcessing/ImageKernels.h"
+#include <taskflow/taskflow.hpp>
+#include <taskflow/algorithm/for_each.hpp>
 
 CLIPPreprocessor::CLIPPreprocessor()
 {
-  timeStamp = 0;
-  timeStampUpper = 0;
-  obstaclePointsLow.reserve(100);
-  obstaclePointsHigh.reserve(100);
-  obstaclePointsLeft.reserve(100);
-  obstaclePointsRight.reserve(100);
-  scanLinePixelBuffer.reserve(1280);
-  wasReset = false;
-  initialized = false;
-  lineSizes.resize(Image::maxResolutionHeight);
+  for (ImageScan* scan : {&lowerScan, &upperScan})
+  {
+    scan->obstaclePointsLow.reserve(100);
+    scan->obstaclePointsHigh.reserve(100);
+    scan->obstaclePointsLeft.reserve(100);
+    scan->obstaclePointsRight.reserve(100);
+  }
 }
 
 CLIPPreprocessor::~CLIPPreprocessor() {}
 
 void CLIPPreprocessor::createScanLines()
 {
-  scanLinesHorizontalLower.clear();
-  scanLinesHorizontalUpper.clear();
-  scanLinesVerticalLower.clear();
-  scanLinesVerticalUpper.clear();
+  lowerScan.scanLinesHorizontal.clear();
+  upperScan.scanLinesHorizontal.clear();
+  lowerScan.scanLinesVertical.clear();
+  upperScan.scanLinesVertical.clear();
   //const int imageSizeFactor = imageHeight / 240; unused
-  const int lowerVDistance = theCameraInfo.height / 240 * vScanLineDistanceLower;
-  const int upperVDistance = theCameraInfoUpper.height / 240 * vScanLineDistanceUpper;
-  const int lowerHDistance = theCameraInfo.height / 240 * hScanLineDistanceLower;
-  const int upperHDistance = theCameraInfoUpper.height / 240 * hScanLineDistanceUpper;
+  const int lowerVDistance = theCameraInfo.width / 320 * vScanLineDistanceLower;
+  const int upperVDistance = theCameraInfoUpper.width / 320 * vScanLineDistanceUpper;
+  const int lowerHDistance = theCameraInfo.width / 320 * hScanLineDistanceLower;
+  const int upperHDistance = theCameraInfoUpper.width / 320 * hScanLineDistanceUpper;
   for (int x = 4; x <= theCameraInfo.width - 4; x += lowerVDistance)
   {
-    scanLinesVerticalLower.emplace_back(Vector2i(x, theCameraInfo.height - 4), Vector2i(x, 4), 1, true);
+    lowerScan.scanLinesVertical.emplace_back(Vector2i(x, theCameraInfo.height - 4), Vector2i(x, 4), 1, true);
   }
   for (int x = 4; x <= theCameraInfoUpper.width - 4; x += upperVDistance)
   {
-    scanLinesVerticalUpper.emplace_back(Vector2i(x, theCameraInfoUpper.height - 4), Vector2i(x, 4), 1, true);
+    upperScan.scanLinesVertical.emplace_back(Vector2i(x, theCameraInfoUpper.height - 4), Vector2i(x, 4), 1, true);
   }
   // do not use all, start at horizon!
   for (int y = 4; y <= theCameraInfo.height - 4; y += lowerHDistance)
   {
-    scanLinesHorizontalLower.emplace_back(Vector2i(4, y), Vector2i(theCameraInfo.width - 4, y), 1, true);
+    lowerScan.scanLinesHorizontal.emplace_back(Vector2i(4, y), Vector2i(theCameraInfo.width - 4, y), 1, true);
   }
   for (int y = 4; y <= theCameraInfoUpper.height - 4; y += upperHDistance)
   {
-    scanLinesHorizontalUpper.emplace_back(Vector2i(4, y), Vector2i(theCameraInfoUpper.width - 4, y), 1, true);
+    upperScan.scanLinesHorizontal.emplace_back(Vector2i(4, y), Vector2i(theCameraInfoUpper.width - 4, y), 1, true);
   }
-  scanLinePixelBuffer.clear();
-  for (int i = 0; i < theCameraInfoUpper.width * 2; i++) //assuming imageupper width is max value of all image widths/heights
-    scanLinePixelBuffer.emplace_back();
+  scanLinesImageSize = Vector2i(theCameraInfo.width, theCameraInfo.height);
+  scanLinesImageSizeUpper = Vector2i(theCameraInfoUpper.width, theCameraInfoUpper.height);
   initialized = true;
 }
 
 void CLIPPreprocessor::update(CLIPPointsPercept& theCLIPPointsPercept)
 {
-  wasReset = false;
-  execute(false);
-  execute(true);
   theCLIPPointsPercept = localCLIPPointsPercept;
 }
 
+void CLIPPreprocessor::update(CLIPScanLineSegments& theCLIPScanLineSegments)
+{
+  theCLIPScanLineSegments = localCLIPScanLineSegments;
+}
+
 void CLIPPreprocessor::update(ScanlinesBallSpots& ballSpots)
 {
-  wasReset = false;
-  execute(false);
-  execute(true);
   if (sortBallSpots)
   {
     auto sorting_criteria = [](const auto& a, const auto& b)
@@ -86,7 +84,20 @@ void CLIPPreprocessor::update(ScanlinesBallSpots& ballSpots)
 
 void CLIPPreprocessor::update(ObstacleBasePoints& obstacleBasePoints)
 {
-  wasReset = false;
+  obstacleBasePoints = localObstacleBasePoints;
+}
+
+void CLIPPreprocessor::reset()
+{
+  localCLIPPointsPercept.reset();
+  localCLIPScanLineSegments.clear();
+  localBallSpots.ballSpots.clear();
+  localBallSpots.ballSpotsUpper.clear();
+  localObstacleBasePoints.basePoints.clear();
+}
+
+void CLIPPreprocessor::execute(tf::Subflow& subflow)
+{
   DECLARE_DEBUG_DRAWING("module:CLIPPreprocessor:fieldBorders", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:CLIPPreprocessor:goalSegments", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:CLIPPreprocessor:scanLines", "drawingOnImage");
@@ -98,313 +109,326 @@ void CLIPPreprocessor::update(ObstacleBasePoints& obstacleBasePoints)
   DECLARE_DEBUG_DRAWING("module:CLIPPreprocessor:obstaclePoints:Upper", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:CLIPPreprocessor:fieldHull:Lower", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:CLIPPreprocessor:fieldHull:Upper", "drawingOnImage");
-  execute(false);
-  execute(true);
-  obstacleBasePoints = localObstacleBasePoints;
-}
 
-void CLIPPreprocessor::reset()
-{
-  localCLIPPointsPercept.reset();
-  localBallSpots.ballSpots.clear();
-  localBallSpots.ballSpotsUpper.clear();
-  localObstacleBasePoints.basePoints.clear();
-  obstaclePointsLow.clear();
-  obstaclePointsHigh.clear();
-  obstaclePointsLeft.clear();
-  obstaclePointsRight.clear();
-  fieldBorderRight.base = Vector2f::Zero();
-  fieldBorderRight.direction = Vector2f::Zero();
-  fieldBorderLeft.base = Vector2f::Zero();
-  fieldBorderLeft.direction = Vector2f::Zero();
-  fieldBorderFront.base = Vector2f::Zero();
-  fieldBorderFront.direction = Vector2f::Zero();
-
-  wasReset = true;
+  // The resolutions may change at runtime (see CameraResolutionRequest).
+  if (!initialized || scanLinesImageSize != Vector2i(theCameraInfo.width, theCameraInfo.height)
+      || scanLinesImageSizeUpper != Vector2i(theCameraInfoUpper.width, theCameraInfoUpper.height))
+    createScanLines();
+
+  // The pixels of both images are scanned in parallel, but the upper image is only evaluated
+  // after the lower one, because it is skipped if the field border was found in the lower image.
+  tf::Task lastEvaluation;
+  for (ImageScan* scan : {&lowerScan, &upperScan})
+  {
+    if (!prepareScan(*scan))
+      continue;
+
+    const int numOfLines = static_cast<int>(scan->scanLinesVertical.size() + scan->scanLinesHorizontal.size());
+    const int linesPerTask = std::max(1, scanLinesPerTask);
+    const int numOfBatches = (numOfLines + linesPerTask - 1) / linesPerTask;
+    if (static_cast<int>(scan->buffers.size()) < numOfBatches)
+      scan->buffers.resize(numOfBatches);
+
+    tf::Task scanTask = subflow
+                            .for_each_index(0, numOfBatches, 1,
+                                [this, scan](int batch)
+                                {
+                                  scanLines(*scan, batch);
+                                })
+                            .name(scan->upper ? "ScanUpper [CLIPPreprocessor]" : "ScanLower [CLIPPreprocessor]");
+    tf::Task evaluateTask = subflow
+                                .emplace(
+                                    [this, scan]()
+                                    {
+                                      evaluateScan(*scan);
+                                    })
+                                .name(scan->upper ? "EvaluateUpper [CLIPPreprocessor]" : "EvaluateLower [CLIPPreprocessor]");
+    scanTask.precede(evaluateTask);
+    if (!lastEvaluation.empty())
+      lastEvaluation.precede(evaluateTask);
+    lastEvaluation = evaluateTask;
+  }
+  subflow.join();
+
+  mergeScans();
 }
 
-void CLIPPreprocessor::execute(const bool& upper)
+bool CLIPPreprocessor::prepareScan(ImageScan& scan)
 {
+  const bool& upper = scan.upper;
   const Image& image = upper ? (Image&)theImageUpper : theImage;
   const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
   const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  const FieldColors& fieldColor = upper ? (FieldColors&)theFieldColorsUpper : theFieldColors;
 
-  unsigned actualTimeStamp = upper ? timeStampUpper : timeStamp;
-  if (!initialized)
-    createScanLines();
-  if (actualTimeStamp != image.timeStamp)
-  { // Only process the image once!
-    //OUTPUT(idText,text,"CLIPPreprocessor::execute(): Is actually processed for upper=" << upper);
-    actualTimeStamp = image.timeStamp;
-    if (upper)
-    {
-      timeStampUpper = actualTimeStamp;
-    }
-    else
-    {
-      timeStamp = actualTimeStamp;
-    }
+  scan.updated = false;
+  if (scan.timeStamp == image.timeStamp)
+    return false; // Only process the image once!
+  scan.timeStamp = image.timeStamp;
 
 #ifdef USE_FULL_RESOLUTION
-    imageWidth = image.resolutionWidth * 2;
-    imageHeight = image.resolutionHeight * 2;
+  scan.imageWidth = image.resolutionWidth * 2;
+  scan.imageHeight = image.resolutionHeight * 2;
 #else
-    imageWidth = image.width;
-    imageHeight = image.height;
+  scan.imageWidth = image.width;
+  scan.imageHeight = image.height;
 #endif
 
-    if (!image.shouldBeProcessed())
-      return;
+  if (!image.shouldBeProcessed())
+    return false;
+
+  // The results of both images are replaced as soon as one of them is new.
+  scan.updated = true;
+  scan.points.clear();
+  scan.ballSpots.clear();
+  scan.obstacleBasePoints.clear();
+  scan.segments.clear();
+  scan.fieldBorderTop = -1.f;
+  scan.obstaclePointsLow.clear();
+  scan.obstaclePointsHigh.clear();
+  scan.obstaclePointsLeft.clear();
+  scan.obstaclePointsRight.clear();
+  scan.fieldEndPoints.clear();
+  scan.fieldHull.clear();
+  scan.fieldBorderRight.base = Vector2f::Zero();
+  scan.fieldBorderRight.direction = Vector2f::Zero();
+  scan.fieldBorderLeft.base = Vector2f::Zero();
+  scan.fieldBorderLeft.direction = Vector2f::Zero();
+  scan.fieldBorderFront.base = Vector2f::Zero();
+  scan.fieldBorderFront.direction = Vector2f::Zero();
+
+  // only horizon.base used (thereby assuming it is a straight line to save some calculations)
+  scan.horizon = Geometry::calculateHorizon(cameraMatrix, cameraInfo);
+
+  if (theFallDownState.state != FallDownState::upright || cameraMatrix.isValid == false)
+    return false;
 
-    // only horizon.base used (thereby assuming it is a straight line to save some calculations)
-    horizon = Geometry::calculateHorizon(cameraMatrix, cameraInfo);
+  /*
+  * TODO: remove color jump stuff at least if scanning for black-white ball
+  * TODO: everything is line, field or obstacle -> merge obstacle segments together to check length -> possible balls
+  * TODO: use expected ball size (derive from expected line size)
+  */
 
-    obstaclePointsLow.clear();
-    obstaclePointsHigh.clear();
-    obstaclePointsLeft.clear();
-    obstaclePointsRight.clear();
-    if (!wasReset)
-      reset();
+  // compute relative ball max min values only once per image
+  scan.minBallCr = std::max(3 * fieldColor.fieldColorArray[0].fieldColorOptCr / 2, ballBaseCrValue);
+  scan.minBallCb = (2 * fieldColor.fieldColorArray[0].fieldColorOptCb) / 3;
+  scan.maxBallCb = (3 * fieldColor.fieldColorArray[0].fieldColorOptCb) / 2;
 
-    if (theFallDownState.state != FallDownState::upright || cameraMatrix.isValid == false)
-      return;
+  // the ranges of FieldColors::isPixelFieldColor for ImageKernels::classifyRange
+  CLIPClassifiedPixels::getFieldColorRange(fieldColor.fieldColorArray[0], scan.fieldColorLower, scan.fieldColorUpper);
 
-    //if (wasReset)
-    //  wasReset = false;
+  // reset no of end points and field lines
+  scan.scanLineVNo = 0;
+  scan.scanLineHNo = 0;
 
-    STOPWATCH("CLIPPreprocessor:scanField")
-    {
-      scanField(upper);
-    }
+  // create table of field line widths
+  scan.yStart = std::min<int>(std::max<int>(static_cast<int>(scan.horizon.base.y()), 4), scan.imageHeight);
+  float lineSizeMax = std::max(Geometry::calculateLineSizePrecise(Vector2i(scan.imageWidth / 2, scan.imageHeight), cameraMatrix, cameraInfo, theFieldDimensions.fieldLinesWidth), 2.f);
+  float lineSizeMin = std::max<float>(Geometry::calculateLineSizePrecise(Vector2i(scan.imageWidth / 2, scan.yStart), cameraMatrix, cameraInfo, theFieldDimensions.fieldLinesWidth), 1.f);
+  for (int y = 0; y < scan.yStart; y++)
+    scan.lineSizes[y] = 0;
+  for (int y = scan.yStart; y < scan.imageHeight; y++)
+    scan.lineSizes[y] = lineSizeMin + (lineSizeMax - lineSizeMin) * (static_cast<float>(y - scan.yStart) / (scan.imageHeight - scan.yStart));
+
+  // horizontal scan lines above the horizon are not scanned
+  scan.scanLineNoYStart = 0;
+  while (scan.scanLineNoYStart < static_cast<int>(scan.scanLinesHorizontal.size()) && scan.scanLinesHorizontal[scan.scanLineNoYStart].from.y() < scan.yStart)
+    scan.scanLineNoYStart++;
+  return true;
+}
+
+void CLIPPreprocessor::scanLines(ImageScan& scan, int batch)
+{
+  ScanLineBuffer& buffer = scan.buffers[batch];
+  const int numOfVerticalLines = static_cast<int>(scan.scanLinesVertical.size());
+  const int numOfLines = numOfVerticalLines + static_cast<int>(scan.scanLinesHorizontal.size());
+  const int linesPerTask = std::max(1, scanLinesPerTask);
+  for (int n = batch * linesPerTask; n < std::min(numOfLines, (batch + 1) * linesPerTask); n++)
+  {
+    ScanLine& scanLine = n < numOfVerticalLines ? scan.scanLinesVertical[n] : scan.scanLinesHorizontal[n - numOfVerticalLines];
+    scanLine.scanLineSegments.clear();
+    if (n < numOfVerticalLines || n - numOfVerticalLines >= scan.scanLineNoYStart)
+      processScanLine(scanLine, scan, buffer);
+  }
+}
 
-    // === DEBUG DRAWINGS ===
+void CLIPPreprocessor::evaluateScan(ImageScan& scan)
+{
+  const bool& upper = scan.upper;
+  if (upper && lowerScan.updated && lowerScan.fieldBorderFront.base.x() != 0)
+    return;
 
-    // obstacle points
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:obstaclePoints:Upper")
+  STOPWATCH(upper ? "CLIPPreprocessor:evaluateUpper" : "CLIPPreprocessor:evaluateLower")
+  {
+    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegmentsRaw:Upper")
     {
       if (upper)
-      {
-        for (int i = 0; i < (int)obstaclePointsLow.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Upper", obstaclePointsLow[i].x(), obstaclePointsLow[i].y(), ColorRGBA::orange, ColorRGBA::orange);
-        for (int i = 0; i < (int)obstaclePointsLeft.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Upper", obstaclePointsLeft[i].x(), obstaclePointsLeft[i].y(), ColorRGBA(80, 200, 200), ColorRGBA(80, 200, 200));
-        for (int i = 0; i < (int)obstaclePointsHigh.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Upper", obstaclePointsHigh[i].x(), obstaclePointsHigh[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::yellow);
-        for (int i = 0; i < (int)obstaclePointsRight.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Upper", obstaclePointsRight[i].x(), obstaclePointsRight[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::magenta);
-      }
+        drawScanLineSegments(scan);
     }
 
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:obstaclePoints:Lower")
+    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegmentsRaw:Lower")
     {
       if (!upper)
-      {
-        for (int i = 0; i < (int)obstaclePointsLow.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Lower", obstaclePointsLow[i].x(), obstaclePointsLow[i].y(), ColorRGBA::orange, ColorRGBA::orange);
-        for (int i = 0; i < (int)obstaclePointsLeft.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Lower", obstaclePointsLeft[i].x(), obstaclePointsLeft[i].y(), ColorRGBA(80, 200, 200), ColorRGBA(80, 200, 200));
-        for (int i = 0; i < (int)obstaclePointsHigh.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Lower", obstaclePointsHigh[i].x(), obstaclePointsHigh[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::yellow);
-        for (int i = 0; i < (int)obstaclePointsRight.size(); i++)
-          DOT("module:CLIPPreprocessor:obstaclePoints:Lower", obstaclePointsRight[i].x(), obstaclePointsRight[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::magenta);
-      }
+        drawScanLineSegments(scan);
     }
 
-    // scan lines
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLines")
+    for (int n = 0; n < (int)scan.scanLinesVertical.size(); n++)
     {
-      std::vector<ScanLine>& scanLinesHorizontal = upper ? scanLinesHorizontalUpper : scanLinesHorizontalLower;
-      std::vector<ScanLine>& scanLinesVertical = upper ? scanLinesVerticalUpper : scanLinesVerticalLower;
-      for (std::vector<ScanLine>::const_iterator line = scanLinesHorizontal.begin(); line != scanLinesHorizontal.end(); ++line)
-        LINE("module:CLIPPreprocessor:scanLines", line->from.x(), line->from.y(), line->to.x(), line->to.y(), 1, Drawings::solidPen, ColorRGBA::white);
-      for (std::vector<ScanLine>::const_iterator line = scanLinesVertical.begin(); line != scanLinesVertical.end(); ++line)
-        LINE("module:CLIPPreprocessor:scanLines", line->from.x(), line->from.y(), line->to.x(), line->to.y(), 1, Drawings::solidPen, ColorRGBA::white);
+      classifyScanLineSegments(scan.scanLinesVertical[n], scan);
+      addScanLineSegments(scan.scanLinesVertical[n], true, scan);
+      postProcessScanLine(scan.scanLinesVertical[n], scan);
+      scan.scanLineVNo++;
     }
-    // scan line segments
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegments:Upper")
+
+    // find field border
+    findFieldBorders(scan);
+    if (upper && !scan.fieldHull.empty())
+      scan.fieldBorderTop = std::min_element(scan.fieldHull.begin(), scan.fieldHull.end(),
+                                [](const Vector2f& a, const Vector2f& b)
+                                {
+                                  return a.y() < b.y();
+                                })->y();
+
+    for (int n = scan.scanLineNoYStart; n < (int)scan.scanLinesHorizontal.size(); n++)
     {
-      //y scan lines
-      if (upper)
-        drawScanLineSegments(true);
+      classifyScanLineSegments(scan.scanLinesHorizontal[n], scan);
+      addScanLineSegments(scan.scanLinesHorizontal[n], false, scan);
+      postProcessScanLine(scan.scanLinesHorizontal[n], scan);
+      scan.scanLineHNo++;
     }
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegments:Lower")
+
+    if (useObstacleBasePoints)
     {
-      //y scan lines
-      if (!upper)
-        drawScanLineSegments(false);
+      //addObstaclePercepts(upper);
+      createObstacleBasePoints(scan);
     }
-    // field hull
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:fieldHull:Lower")
+  }
+
+  // === DEBUG DRAWINGS ===
+
+  // obstacle points
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:obstaclePoints:Upper")
+  {
+    if (upper)
     {
-      if (!upper)
-      {
-        drawFieldHull(false);
-      }
+      for (int i = 0; i < (int)scan.obstaclePointsLow.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Upper", scan.obstaclePointsLow[i].x(), scan.obstaclePointsLow[i].y(), ColorRGBA::orange, ColorRGBA::orange);
+      for (int i = 0; i < (int)scan.obstaclePointsLeft.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Upper", scan.obstaclePointsLeft[i].x(), scan.obstaclePointsLeft[i].y(), ColorRGBA(80, 200, 200), ColorRGBA(80, 200, 200));
+      for (int i = 0; i < (int)scan.obstaclePointsHigh.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Upper", scan.obstaclePointsHigh[i].x(), scan.obstaclePointsHigh[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::yellow);
+      for (int i = 0; i < (int)scan.obstaclePointsRight.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Upper", scan.obstaclePointsRight[i].x(), scan.obstaclePointsRight[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::magenta);
     }
-    DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:fieldHull:Upper")
+  }
+
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:obstaclePoints:Lower")
+  {
+    if (!upper)
     {
-      if (upper)
-      {
-        drawFieldHull(upper);
-      }
+      for (int i = 0; i < (int)scan.obstaclePointsLow.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Lower", scan.obstaclePointsLow[i].x(), scan.obstaclePointsLow[i].y(), ColorRGBA::orange, ColorRGBA::orange);
+      for (int i = 0; i < (int)scan.obstaclePointsLeft.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Lower", scan.obstaclePointsLeft[i].x(), scan.obstaclePointsLeft[i].y(), ColorRGBA(80, 200, 200), ColorRGBA(80, 200, 200));
+      for (int i = 0; i < (int)scan.obstaclePointsHigh.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Lower", scan.obstaclePointsHigh[i].x(), scan.obstaclePointsHigh[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::yellow);
+      for (int i = 0; i < (int)scan.obstaclePointsRight.size(); i++)
+        DOT("module:CLIPPreprocessor:obstaclePoints:Lower", scan.obstaclePointsRight[i].x(), scan.obstaclePointsRight[i].y(), ColorRGBA(80, 200, 200), ColorRGBA::magenta);
     }
   }
-}
-
-void CLIPPreprocessor::scanField(const bool& upper)
-{
-  /*
-  * TODO: remove color jump stuff at least if scanning for black-white ball
-  * TODO: everything is line, field or obstacle -> merge obstacle segments together to check length -> possible balls
-  * TODO: use expected ball size (derive from expected line size)
-  */
-  if (upper && fieldBorderFront.base.x() != 0)
-    return;
-
 
-  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
-  const FieldColors& fieldColor = upper ? (FieldColors&)theFieldColorsUpper : theFieldColors;
-  const int imageSizeFactor = imageHeight / 240;
-  const int hScanLineDistance = upper ? imageSizeFactor * hScanLineDistanceUpper : imageSizeFactor * hScanLineDistanceLower;
-  const int vScanLineDistance = upper ? imageSizeFactor * vScanLineDistanceUpper : imageSizeFactor * vScanLineDistanceLower;
-  std::vector<ScanLine>& scanLinesHorizontal = upper ? scanLinesHorizontalUpper : scanLinesHorizontalLower;
-  std::vector<ScanLine>& scanLinesVertical = upper ? scanLinesVerticalUpper : scanLinesVerticalLower;
-
-  //const int goalScanDistanceFromHorizon = std::max(hScanLineDistance*2,imageHeight/15);
-
-  // compute relative ball max min values only once per image
-  minBallCr = std::max(3 * fieldColor.fieldColorArray[0].fieldColorOptCr / 2, ballBaseCrValue);
-  minBallCb = (2 * fieldColor.fieldColorArray[0].fieldColorOptCb) / 3;
-  maxBallCb = (3 * fieldColor.fieldColorArray[0].fieldColorOptCb) / 2;
-
-  // reset no of end points and field lines
-  scanLineVNo = 0;
-  scanLineHNo = 0;
-
-  fieldEndPoints.clear();
-
-  obstaclePointsLow.clear();
-  obstaclePointsHigh.clear();
-  obstaclePointsLeft.clear();
-  obstaclePointsRight.clear();
-
-  // create table of field line widths
-  int yStart = std::min<int>(std::max<int>(static_cast<int>(horizon.base.y()), 4), imageHeight);
-  float lineSizeMax = std::max(Geometry::calculateLineSizePrecise(Vector2i(imageWidth / 2, imageHeight), cameraMatrix, cameraInfo, theFieldDimensions.fieldLinesWidth), 2.f);
-  float lineSizeMin = std::max<float>(Geometry::calculateLineSizePrecise(Vector2i(imageWidth / 2, yStart), cameraMatrix, cameraInfo, theFieldDimensions.fieldLinesWidth), 1.f);
-  for (int y = 0; y < yStart; y++)
-    lineSizes[y] = 0;
-  for (int y = yStart; y < imageHeight; y++)
-    lineSizes[y] = lineSizeMin + (lineSizeMax - lineSizeMin) * (static_cast<float>(y - yStart) / (imageHeight - yStart));
-
-  // y scan lines, has to be the same as in initialization (createFieldLines)
-  int scanLineNo = 0;
-  int maxScanLineNo = (int)scanLinesVertical.size();
-  for (int x = 4; x < imageWidth && scanLineNo < maxScanLineNo; x += vScanLineDistance)
+  // scan lines
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLines")
   {
-    scanLinesVertical[scanLineNo].scanLineSegments.clear();
-    processScanLine(scanLinesVertical[scanLineNo], upper);
-    scanLineNo++;
+    for (std::vector<ScanLine>::const_iterator line = scan.scanLinesHorizontal.begin(); line != scan.scanLinesHorizontal.end(); ++line)
+      LINE("module:CLIPPreprocessor:scanLines", line->from.x(), line->from.y(), line->to.x(), line->to.y(), 1, Drawings::solidPen, ColorRGBA::white);
+    for (std::vector<ScanLine>::const_iterator line = scan.scanLinesVertical.begin(); line != scan.scanLinesVertical.end(); ++line)
+      LINE("module:CLIPPreprocessor:scanLines", line->from.x(), line->from.y(), line->to.x(), line->to.y(), 1, Drawings::solidPen, ColorRGBA::white);
   }
-
-  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegmentsRaw:Upper")
+  // scan line segments
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegments:Upper")
   {
+    //y scan lines
     if (upper)
-      drawScanLineSegments(true);
+      drawScanLineSegments(scan);
   }
-
-  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegmentsRaw:Lower")
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:scanLineSegments:Lower")
   {
+    //y scan lines
     if (!upper)
-      drawScanLineSegments(false);
+      drawScanLineSegments(scan);
   }
-
-  for (int n = 0; n < (int)scanLinesVertical.size(); n++)
+  // field hull
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:fieldHull:Lower")
   {
-    classifyScanLineSegments(scanLinesVertical[n], upper);
-    postProcessScanLine(scanLinesVertical[n], upper);
-    scanLineVNo++;
+    if (!upper)
+    {
+      drawFieldHull(scan);
+    }
   }
-
-  // find field border
-  findFieldBorders();
-
-
-  //goal scan lines (horizontal) not used anymore (since CLIPGoalPerceptor2015).
-  /*int goalScanStartY = std::max((int)horizon.base.y-hScanLineDistance*3, 4);
-  int goalScanEndY = std::min(std::max((int)horizon.base.y+goalScanDistanceFromHorizon*2, imageHeight/5), imageHeight-goalScanDistanceFromHorizon);
-  for (int y = goalScanStartY; y < goalScanEndY; y += hScanLineDistance)
+  DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:fieldHull:Upper")
   {
-    scanLinesHorizontal.push_back(ScanLine(Vector2<short>(4,y),Vector2<short>(imageWidth-4,y),1,true));
-    processScanLine(scanLinesHorizontal.back(),upper,true);
-  }*/
-
-
-  // other horizontal field scan lines
-  //for (int y = goalScanEndY+hScanLineDistance; y < imageHeight-hScanLineDistance; y += hScanLineDistance)
-  scanLineNo = 0;
-  scanLineNoYStart = 0;
-  maxScanLineNo = (int)scanLinesHorizontal.size();
-  for (int y = 4; y < imageHeight && scanLineNo < maxScanLineNo; y += hScanLineDistance)
-  {
-    scanLinesHorizontal[scanLineNo].scanLineSegments.clear();
-    if (y >= yStart)
-      processScanLine(scanLinesHorizontal[scanLineNo], upper);
-    else
-      scanLineNoYStart++;
-    scanLineNo++;
+    if (upper)
+    {
+      drawFieldHull(scan);
+    }
   }
+}
 
-  for (int n = scanLineNoYStart; n < (int)scanLinesHorizontal.size(); n++)
-  {
-    classifyScanLineSegments(scanLinesHorizontal[n], upper);
-    postProcessScanLine(scanLinesHorizontal[n], upper);
-    scanLineHNo++;
-  }
+void CLIPPreprocessor::mergeScans()
+{
+  if (!lowerScan.updated && !upperScan.updated)
+    return;
 
-  if (useObstacleBasePoints)
+  reset();
+  for (ImageScan* scan : {&lowerScan, &upperScan})
   {
-    //addObstaclePercepts(upper);
-    createObstacleBasePoints(upper);
+    if (!scan->updated)
+      continue;
+    (scan->upper ? localCLIPPointsPercept.pointsUpper : localCLIPPointsPercept.points).swap(scan->points);
+    (scan->upper ? localBallSpots.ballSpotsUpper : localBallSpots.ballSpots).swap(scan->ballSpots);
+    (scan->upper ? localCLIPScanLineSegments.upper : localCLIPScanLineSegments.lower) = scan->segments;
+    localObstacleBasePoints.basePoints.insert(localObstacleBasePoints.basePoints.end(), scan->obstacleBasePoints.begin(), scan->obstacleBasePoints.end());
+    if (scan->upper)
+      localCLIPPointsPercept.upperFieldBorderTop = scan->fieldBorderTop;
   }
 }
 
-void CLIPPreprocessor::createObstacleBasePoints(const bool& upper)
+void CLIPPreprocessor::createObstacleBasePoints(ImageScan& scan)
 {
   // look for reasonably sized obstacle point clusters
   // TODO: lying obstacles covered? -> also check RobotDetector
 
-  const int lowerVDistance = theCameraInfo.height / 240 * vScanLineDistanceLower;
-  const int upperVDistance = theCameraInfoUpper.height / 240 * vScanLineDistanceUpper;
-  const int lowerHDistance = theCameraInfo.height / 240 * hScanLineDistanceLower;
-  const int upperHDistance = theCameraInfoUpper.height / 240 * hScanLineDistanceUpper;
-  const int vScanLineDistance = upper ? upperVDistance : lowerVDistance;
-  const int hScanLineDistance = upper ? upperHDistance : lowerHDistance;
-  const int maxScanLineDistance = imageWidth / 20;
+  const int lowerVDistance = theCameraInfo.width / 320 * vScanLineDistanceLower;
+  const int upperVDistance = theCameraInfoUpper.width / 320 * vScanLineDistanceUpper;
+  const int lowerHDistance = theCameraInfo.width / 320 * hScanLineDistanceLower;
+  const int upperHDistance = theCameraInfoUpper.width / 320 * hScanLineDistanceUpper;
+  const int vScanLineDistance = scan.upper ? upperVDistance : lowerVDistance;
+  const int hScanLineDistance = scan.upper ? upperHDistance : lowerHDistance;
+  const int maxScanLineDistance = scan.imageWidth / 20;
 
   // create base points from vertical scan lines
-  const int sizeLow = static_cast<int>(obstaclePointsLow.size());
+  const int sizeLow = static_cast<int>(scan.obstaclePointsLow.size());
   const int maxYDistanceLow = maxScanLineDistance; // TODO
   const int maxScanLineNumberDistance = 2;
   const int maxXDistanceLow = vScanLineDistance * maxScanLineNumberDistance;
-  std::vector<Vector2f> currentObstaclePoints(100);
+  std::pmr::vector<Vector2f> currentObstaclePoints(100, &CycleArena::get());
   // get points on roughly a line close to each other
   for (int firstPoint = 0; firstPoint < sizeLow; firstPoint++)
   {
     int lastFittingSecondPoint = firstPoint;
-    int maxY = obstaclePointsLow[firstPoint].y(); //TODO: what about oulier?(shadows..)
+    int maxY = scan.obstaclePointsLow[firstPoint].y(); //TODO: what about oulier?(shadows..)
     currentObstaclePoints.clear();
-    currentObstaclePoints.emplace_back(obstaclePointsLow[firstPoint].cast<float>());
+    currentObstaclePoints.emplace_back(scan.obstaclePointsLow[firstPoint].cast<float>());
     for (int secondPoint = firstPoint + 1; secondPoint < sizeLow; secondPoint++)
     {
-      if (obstaclePointsLow[secondPoint].x() - obstaclePointsLow[lastFittingSecondPoint].x() > maxXDistanceLow)
+      if (scan.obstaclePointsLow[secondPoint].x() - scan.obstaclePointsLow[lastFittingSecondPoint].x() > maxXDistanceLow)
         break;
-      else if (std::abs(obstaclePointsLow[secondPoint].y() - obstaclePointsLow[lastFittingSecondPoint].y()) <= maxYDistanceLow)
+      else if (std::abs(scan.obstaclePointsLow[secondPoint].y() - scan.obstaclePointsLow[lastFittingSecondPoint].y()) <= maxYDistanceLow)
       {
         lastFittingSecondPoint = secondPoint;
-        currentObstaclePoints.emplace_back(obstaclePointsLow[secondPoint].cast<float>());
-        maxY = std::max(maxY, obstaclePointsLow[secondPoint].y());
+        currentObstaclePoints.emplace_back(scan.obstaclePointsLow[secondPoint].cast<float>());
+        maxY = std::max(maxY, scan.obstaclePointsLow[secondPoint].y());
       }
     }
     firstPoint = lastFittingSecondPoint;
@@ -416,15 +440,15 @@ void CLIPPreprocessor::createObstacleBasePoints(const bool& upper)
       ObstacleBasePoints::ObstacleBasePoint obp;
       obp.pointInImage.x() = (currentObstaclePoints[0].x() + currentObstaclePoints.back().x()) / 2.f;
       obp.pointInImage.y() = static_cast<float>(maxY);
-      obp.upperCam = upper;
+      obp.upperCam = scan.upper;
       obp.certain = false;
       obp.direction = ObstacleBasePoints::ObstacleBasePoint::up;
-      localObstacleBasePoints.basePoints.push_back(obp);
+      scan.obstacleBasePoints.push_back(obp);
     }
   }
 
   // create base points from horizontal scan lines starting at obstacle
-  const int sizeLeft = static_cast<int>(obstaclePointsLeft.size());
+  const int sizeLeft = static_cast<int>(scan.obstaclePointsLeft.size());
   const int maxYDistanceSide = hScanLineDistance * maxScanLineNumberDistance; // TODO
   const int maxXDistanceSide = maxScanLineDistance; // TODO
   currentObstaclePoints.clear();
@@ -432,18 +456,18 @@ void CLIPPreprocessor::createObstacleBasePoints(const bool& upper)
   for (int firstPoint = 0; firstPoint < sizeLeft; firstPoint++)
   {
     int lastFittingSecondPoint = firstPoint;
-    int maxY = obstaclePointsLeft[firstPoint].y(); //TODO: what about oulier?(shadows..)
+    int maxY = scan.obstaclePointsLeft[firstPoint].y(); //TODO: what about oulier?(shadows..)
     currentObstaclePoints.clear();
-    currentObstaclePoints.emplace_back(obstaclePointsLeft[firstPoint].cast<float>());
+    currentObstaclePoints.emplace_back(scan.obstaclePointsLeft[firstPoint].cast<float>());
     for (int secondPoint = firstPoint + 1; secondPoint < sizeLeft; secondPoint++)
     {
-      if (obstaclePointsLeft[secondPoint].y() - obstaclePointsLeft[lastFittingSecondPoint].y() > maxYDistanceSide)
+      if (scan.obstaclePointsLeft[secondPoint].y() - scan.obstaclePointsLeft[lastFittingSecondPoint].y() > maxYDistanceSide)
         break;
-      else if (std::abs(obstaclePointsLeft[secondPoint].x() - obstaclePointsLeft[lastFittingSecondPoint].x()) <= maxXDistanceSide)
+      else if (std::abs(scan.obstaclePointsLeft[secondPoint].x() - scan.obstaclePointsLeft[lastFittingSecondPoint].x()) <= maxXDistanceSide)
       {
         lastFittingSecondPoint = secondPoint;
-        currentObstaclePoints.emplace_back(obstaclePointsLeft[secondPoint].cast<float>());
-        maxY = std::max(maxY, obstaclePointsLeft[secondPoint].y());
+        currentObstaclePoints.emplace_back(scan.obstaclePointsLeft[secondPoint].cast<float>());
+        maxY = std::max(maxY, scan.obstaclePointsLeft[secondPoint].y());
       }
     }
     firstPoint = lastFittingSecondPoint;
@@ -455,32 +479,32 @@ void CLIPPreprocessor::createObstacleBasePoints(const bool& upper)
       ObstacleBasePoints::ObstacleBasePoint obp;
       obp.pointInImage.x() = (currentObstaclePoints[0].x() + currentObstaclePoints.back().x()) / 2.f;
       obp.pointInImage.y() = static_cast<float>(maxY);
-      obp.upperCam = upper;
+      obp.upperCam = scan.upper;
       obp.certain = false;
       obp.direction = ObstacleBasePoints::ObstacleBasePoint::right;
-      localObstacleBasePoints.basePoints.push_back(obp);
+      scan.obstacleBasePoints.push_back(obp);
     }
   }
 
   // create base points from horizontal scan lines ending at obstacle
-  const int sizeRight = static_cast<int>(obstaclePointsRight.size());
+  const int sizeRight = static_cast<int>(scan.obstaclePointsRight.size());
   currentObstaclePoints.clear();
   // get points on roughly a line close to each other
   for (int firstPoint = 0; firstPoint < sizeRight; firstPoint++)
   {
     int lastFittingSecondPoint = firstPoint;
-    int maxY = obstaclePointsRight[firstPoint].y(); //TODO: what about oulier?(shadows..)
+    int maxY = scan.obstaclePointsRight[firstPoint].y(); //TODO: what about oulier?(shadows..)
     currentObstaclePoints.clear();
-    currentObstaclePoints.emplace_back(obstaclePointsRight[firstPoint].cast<float>());
+    currentObstaclePoints.emplace_back(scan.obstaclePointsRight[firstPoint].cast<float>());
     for (int secondPoint = firstPoint + 1; secondPoint < sizeRight; secondPoint++)
     {
-      if (obstaclePointsRight[secondPoint].y() - obstaclePointsRight[lastFittingSecondPoint].y() > maxYDistanceSide)
+      if (scan.obstaclePointsRight[secondPoint].y() - scan.obstaclePointsRight[lastFittingSecondPoint].y() > maxYDistanceSide)
         break;
-      else if (std::abs(obstaclePointsRight[secondPoint].x() - obstaclePointsRight[lastFittingSecondPoint].x()) <= maxXDistanceSide)
+      else if (std::abs(scan.obstaclePointsRight[secondPoint].x() - scan.obstaclePointsRight[lastFittingSecondPoint].x()) <= maxXDistanceSide)
       {
         lastFittingSecondPoint = secondPoint;
-        currentObstaclePoints.emplace_back(obstaclePointsRight[secondPoint].cast<float>());
-        maxY = std::max(maxY, obstaclePointsRight[secondPoint].y());
+        currentObstaclePoints.emplace_back(scan.obstaclePointsRight[secondPoint].cast<float>());
+        maxY = std::max(maxY, scan.obstaclePointsRight[secondPoint].y());
       }
     }
     firstPoint = lastFittingSecondPoint;
@@ -492,18 +516,26 @@ void CLIPPreprocessor::createObstacleBasePoints(const bool& upper)
       ObstacleBasePoints::ObstacleBasePoint obp;
       obp.pointInImage.x() = (currentObstaclePoints[0].x() + currentObstaclePoints.back().x()) / 2.f;
       obp.pointInImage.y() = static_cast<float>(maxY);
-      obp.upperCam = upper;
+      obp.upperCam = scan.upper;
       obp.certain = false;
       obp.direction = ObstacleBasePoints::ObstacleBasePoint::left;
-      localObstacleBasePoints.basePoints.push_back(obp);
+      scan.obstacleBasePoints.push_back(obp);
     }
   }
 }
 
-void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool& upper)
+void CLIPPreprocessor::addScanLineSegments(const ScanLine& scanLine, bool isVertical, ImageScan& scan)
 {
-  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  static_assert(static_cast<int>(numOfScanLineSegmentType) == static_cast<int>(CLIPScanLineSegments::numOfSegmentTypes), "Segment types differ");
+  scan.segments.addLine(isVertical);
+  for (const ScanLineSegment& seg : scanLine.scanLineSegments)
+    scan.segments.addSegment(static_cast<CLIPScanLineSegments::SegmentType>(seg.segmentType), seg.startPointInImage, seg.endPointInImage, seg.avgY, seg.avgCb, seg.avgCr);
+}
+
+void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, ImageScan& scan)
+{
+  const CameraMatrix& cameraMatrix = scan.upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const CameraInfo& cameraInfo = scan.upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   const bool isVertical = scanLine.from.x() == scanLine.to.x();
 
@@ -535,9 +567,9 @@ void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool&
         if (!isVertical)
         {
           if (segNo == 0)
-            obstaclePointsRight.push_back(seg.endPointInImage.cast<int>());
+            scan.obstaclePointsRight.push_back(seg.endPointInImage.cast<int>());
           else
-            obstaclePointsLeft.push_back(seg.startPointInImage.cast<int>());
+            scan.obstaclePointsLeft.push_back(seg.startPointInImage.cast<int>());
         }
       }
     }
@@ -555,14 +587,14 @@ void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool&
         Vector2f linePoint(((seg.endPointInImage.x() + seg.startPointInImage.x())) / 2.f, ((seg.endPointInImage.y() + seg.startPointInImage.y())) / 2.f);
         lastLineSize = (seg.endPointInImage - seg.startPointInImage).norm();
 
-        addLinePoint(linePoint, lastLineSize, isVertical, upper);
+        addLinePoint(linePoint, lastLineSize, isVertical, scan);
       }
     }
     else if (seg.segmentType == ballSegment)
     {
       // do not add ball spots from horizontal scan that are probably too high (HACK, test!)
-      if (((theFieldDimensions.ballType != SimpleFieldDimensions::BallType::orange) || isPixelBallColor(seg.avgY, seg.avgCb, seg.avgCr)) //seg.avgCr*3 > seg.avgCb*4)
-          && (!(upper && (scanLine.from.y() == scanLine.to.y() && seg.startPointInImage.y() < imageHeight / 4))))
+      if (((theFieldDimensions.ballType != SimpleFieldDimensions::BallType::orange) || scan.isPixelBallColor(seg.avgY, seg.avgCb, seg.avgCr)) //seg.avgCr*3 > seg.avgCb*4)
+          && (!(scan.upper && (scanLine.from.y() == scanLine.to.y() && seg.startPointInImage.y() < scan.imageHeight / 4))))
       {
         const ScanLineSegment& prevSegment = scanLine.scanLineSegments.at(std::max(0, segNo - 1));
         const ScanLineSegment& nextSegment = scanLine.scanLineSegments.at(std::min(size - 1, segNo + 1));
@@ -576,7 +608,7 @@ void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool&
                 && (prevSegment.segmentType == unknownSegment || prevSegment.segmentType == fieldSegment || prevSegment.segmentType == lineSegment || prevSegment.segmentType == obstacleSegment))
             || (segNo == 0 && (nextSegment.segmentType == fieldSegment || nextSegment.segmentType == lineSegment || nextSegment.segmentType == obstacleSegment)))
         {
-          addBallSpot(Vector2f(((seg.endPointInImage.x() + seg.startPointInImage.x())) / 2.f, ((seg.endPointInImage.y() + seg.startPointInImage.y())) / 2.f), seg.avgY, seg.avgCb, seg.avgCr, upper);
+          addBallSpot(Vector2f(((seg.endPointInImage.x() + seg.startPointInImage.x())) / 2.f, ((seg.endPointInImage.y() + seg.startPointInImage.y())) / 2.f), seg.avgY, seg.avgCb, seg.avgCr, scan);
         }
       }
     }
@@ -597,7 +629,7 @@ void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool&
         // adding ballspots if field end next??
         if (seg.segmentType == ballSegment && scanLine.scanLineSegments.at(std::max(0, segNo - 1)).segmentType == fieldSegment)
         {
-          addBallSpot(Vector2f(((seg.endPointInImage.x() + seg.startPointInImage.x())) / 2.f, ((seg.endPointInImage.y() + seg.startPointInImage.y())) / 2.f), seg.avgY, seg.avgCb, seg.avgCr, upper);
+          addBallSpot(Vector2f(((seg.endPointInImage.x() + seg.startPointInImage.x())) / 2.f, ((seg.endPointInImage.y() + seg.startPointInImage.y())) / 2.f), seg.avgY, seg.avgCb, seg.avgCr, scan);
         }
         if (lastGreen.x() > 0.5f)
         {
@@ -606,15 +638,15 @@ void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool&
             FieldEndPoint newFEP;
             newFEP.imageCoordinates = lastGreen;
             newFEP.inlier = false;
-            fieldEndPoints.push_back(newFEP);
+            scan.fieldEndPoints.push_back(newFEP);
           }
-          obstaclePointsLow.emplace_back(lastGreen.cast<int>());
+          scan.obstaclePointsLow.emplace_back(lastGreen.cast<int>());
         }
         return;
       }
       /*else // from horizontal scan
       {
-        obstaclePointsLeft.push_back(Vector2i(lastGreen.cast<int>()));
+        scan.obstaclePointsLeft.push_back(Vector2i(lastGreen.cast<int>()));
       }*/
     }
     segNo++;
@@ -627,14 +659,14 @@ void CLIPPreprocessor::postProcessScanLine(const ScanLine& scanLine, const bool&
     FieldEndPoint newFEP;
     newFEP.imageCoordinates = lastGreen;
     newFEP.inlier = false;
-    fieldEndPoints.push_back(newFEP);
+    scan.fieldEndPoints.push_back(newFEP);
   }
 }
 
-void CLIPPreprocessor::classifyScanLineSegments(ScanLine& scanLine, const bool& upper)
+void CLIPPreprocessor::classifyScanLineSegments(ScanLine& scanLine, const ImageScan& scan)
 {
-  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  const CameraMatrix& cameraMatrix = scan.upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const CameraInfo& cameraInfo = scan.upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   const bool isVertical = scanLine.from.x() == scanLine.to.x();
 
@@ -779,42 +811,63 @@ void CLIPPreprocessor::classifyScanLineSegments(ScanLine& scanLine, const bool&
   }
 }
 
-void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
+void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const ImageScan& scan, ScanLineBuffer& buffer)
 {
-  const Image& image = upper ? (Image&)theImageUpper : theImage;
-  const FieldColors& fieldColor = upper ? (FieldColors&)theFieldColorsUpper : theFieldColors;
-  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  const Image& image = scan.upper ? (Image&)theImageUpper : theImage;
+  const FieldColors& fieldColor = scan.upper ? (FieldColors&)theFieldColorsUpper : theFieldColors;
+  const CameraMatrix& cameraMatrix = scan.upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const CameraInfo& cameraInfo = scan.upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
 
   bool isVertical = (scanLine.from.x() == scanLine.to.x());
 
-  int minY = std::max(scanLine.to.y(), std::min(scanLine.from.y(), static_cast<int>(horizon.base.y())));
+  // All pixels of the scan line are contiguous (vertical ones after transposing them)
+  // and their field color is classified at once. They are indexed by their position along the line.
+  const Image::Pixel* linePixels = image[scanLine.from.y()];
+  if (isVertical)
+  {
+    ImageKernels::copyColumn(reinterpret_cast<const unsigned char*>(image[0] + scanLine.from.x()), scan.imageHeight, image.widthStep,
+                             reinterpret_cast<unsigned char*>(buffer.pixels.data()));
+    linePixels = buffer.pixels.data();
+  }
+  ImageKernels::classifyRange(reinterpret_cast<const unsigned char*>(linePixels), isVertical ? scan.imageHeight : scan.imageWidth, scan.fieldColorLower.data(),
+                              scan.fieldColorUpper.data(), buffer.fieldColor.data());
+
+  int minY = std::max(scanLine.to.y(), std::min(scanLine.from.y(), static_cast<int>(scan.horizon.base.y())));
   float scanLineLength = (float)std::max(scanLine.from.y() - minY, scanLine.to.x() - scanLine.from.x());
 
   int imageX = scanLine.from.x();
   int imageY = scanLine.from.y();
+
+  // vertical scan lines start above the robot's own body
+  if (isVertical)
+  {
+    const BodyContour& bodyContour = scan.upper ? (BodyContour&)theBodyContourUpper : theBodyContour;
+    imageY = std::min(imageY, bodyContour.bottomAt(imageX, scan.imageHeight) - 1);
+    if (imageY < minY)
+      return;
+  }
   int stepSize = scanLine.stepSize;
   int zero = 0;
   int& stepSizeY = isVertical ? stepSize : zero;
   int& stepSizeX = isVertical ? zero : stepSize;
   int xNorm = isVertical ? 0 : 1;
   int yNorm = isVertical ? 1 : 0;
-  pixelCount = 0;
+  buffer.pixelCount = 0;
 
   bool isUnknownFieldEnd = (isVertical && scanLine.fullScanLine);
   bool foundField = false;
-  float lastLineSize = (float)(imageWidth / 6);
+  float lastLineSize = (float)(scan.imageWidth / 6);
 
 #ifdef USE_FULL_RESOLUTION
   Image::YUVPixel p;
   image.getPixel(imageX, imageY, &p);
 #else
-  Image::Pixel p = image[imageY][imageX];
+  Image::Pixel p = linePixels[isVertical ? imageY : imageX];
 #endif
   for (int i = 0; i < 3; i++)
-    scanLinePixelBuffer[i] = p;
-  pixelCount = 2; //0-2 have been filled above
-  fieldColorBuffer.fill(0);
+    buffer.pixelBuffer[i] = p;
+  buffer.pixelCount = 2; //0-2 have been filled above
+  buffer.fieldColorBuffer.fill(0);
 
   int colorDiff = 0;
   int yDiff, yDiff2;
@@ -822,17 +875,17 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
 
   int segmentLength = 0;
 
-  lastLineSize = lineSizes[scanLine.from.y()];
-  float lineSizeMin = lineSizes[minY];
-  const int stepSizeMin = std::max<int>(1, std::min<int>(imageHeight / 30, (int)lineSizeMin / 4));
-  const int stepSizeMax = std::max<int>(stepSizeMin, std::min<int>(imageHeight / 30, (int)lastLineSize / 4));
+  lastLineSize = scan.lineSizes[imageY];
+  float lineSizeMin = scan.lineSizes[minY];
+  const int stepSizeMin = std::max<int>(1, std::min<int>(scan.imageHeight / 30, (int)lineSizeMin / 4));
+  const int stepSizeMax = std::max<int>(stepSizeMin, std::min<int>(scan.imageHeight / 30, (int)lastLineSize / 4));
   stepSize = stepSizeMax;
 
   int stepSizeLine = std::max(1, (int)lastLineSize / 20);
   int& stepSizeLineY = isVertical ? stepSizeLine : zero;
   int& stepSizeLineX = isVertical ? zero : stepSizeLine;
 
-  scanLine.scanLineSegments.emplace_back(ScanLineSegment((float)imageX, (float)imageY, 0, lastColorDiff() > minColorDiff, unknownSegment));
+  scanLine.scanLineSegments.emplace_back(ScanLineSegment((float)imageX, (float)imageY, 0, buffer.lastColorDiff() > minColorDiff, unknownSegment));
 
   bool isGradientYUp = false;
 
@@ -852,21 +905,21 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
 #ifdef USE_FULL_RESOLUTION
     image.getPixel(imageX, imageY, &p);
 #else
-    p = image[imageY][imageX];
+    p = linePixels[isVertical ? imageY : imageX];
 #endif
-    scanLinePixelBuffer[++pixelCount] = p;
-    ASSERT(pixelCount > 0 && pixelCount < INT_MAX);
-    ASSERT(static_cast<unsigned>(pixelCount) < scanLinePixelBuffer.size());
+    buffer.pixelBuffer[++buffer.pixelCount] = p;
+    ASSERT(buffer.pixelCount > 0 && buffer.pixelCount < INT_MAX);
+    ASSERT(static_cast<unsigned>(buffer.pixelCount) < buffer.pixelBuffer.size());
 
     float currentscannedRatio = (imageX - scanLine.from.x() + imageY - minY) / (scanLineLength + 1);
     stepSize = (int)(stepSizeMin + currentscannedRatio * (float)(stepSizeMax - stepSizeMin));
 
-    ASSERT(pixelCount <= INT_MAX);
-    yDiff = scanLinePixelBuffer[static_cast<int>(pixelCount) - 1].y - scanLinePixelBuffer[pixelCount].y;
-    yDiff2 = scanLinePixelBuffer[static_cast<int>(pixelCount) - 2].y - scanLinePixelBuffer[pixelCount].y;
-    colorDiff = std::max(lastColorDiff(), lastColorDiff2());
-    fieldColorBuffer.push_front(fieldColor.isPixelFieldColor(scanLinePixelBuffer[pixelCount].y, scanLinePixelBuffer[pixelCount].cb, scanLinePixelBuffer[pixelCount].cr) ? 1 : 0);
-    foundField = foundField || (fieldColorBuffer.sum() > 4 && (100 * scanLine.scanLineSegments[segmentNo].fieldColorCount) / (segmentLength + 1) > 50);
+    ASSERT(buffer.pixelCount <= INT_MAX);
+    yDiff = buffer.pixelBuffer[static_cast<int>(buffer.pixelCount) - 1].y - buffer.pixelBuffer[buffer.pixelCount].y;
+    yDiff2 = buffer.pixelBuffer[static_cast<int>(buffer.pixelCount) - 2].y - buffer.pixelBuffer[buffer.pixelCount].y;
+    colorDiff = std::max(buffer.lastColorDiff(), buffer.lastColorDiff2());
+    buffer.fieldColorBuffer.push_front(buffer.fieldColor[isVertical ? imageY : imageX]);
+    foundField = foundField || (buffer.fieldColorBuffer.sum() > 4 && (100 * scanLine.scanLineSegments[segmentNo].fieldColorCount) / (segmentLength + 1) > 50);
 
     // main state machine
     if (scanLine.scanLineSegments[segmentNo].segmentType == unknownSegment)
@@ -879,7 +932,7 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
         scanLine.scanLineSegments[segmentNo].gradientColorEnd = isGradientColor;
         // search for more precise line start
         // TODO: use full resolution here?
-        int maxY = scanLinePixelBuffer[pixelCount].y;
+        int maxY = buffer.pixelBuffer[buffer.pixelCount].y;
         int localMinY = maxY;
         int maxScanWidth = std::max((3 * stepSize) / 2, 3);
         stepSizeLine = std::max(1, stepSize / 4);
@@ -887,7 +940,7 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
         bool foundHigh, foundLow;
         foundHigh = foundLow = false;
         bool foundEnd = false;
-        int lastY = scanLinePixelBuffer[pixelCount].y;
+        int lastY = buffer.pixelBuffer[buffer.pixelCount].y;
         int linePosX, linePosY, linePosLowX, linePosLowY, linePosHighX, linePosHighY;
 
         linePosX = linePosLowX = linePosHighX = imageX - xNorm;
@@ -898,7 +951,7 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
 #ifdef USE_FULL_RESOLUTION
           image.getPixel(linePosX, linePosY, &p);
 #else
-          p = image[linePosY][linePosX];
+          p = linePixels[isVertical ? linePosY : linePosX];
 #endif
           lastY = p.y;
           if (foundHigh && foundLow)
@@ -986,14 +1039,15 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
 
           while (counter <= maxScanWidth && !image.isOutOfImage(linePosX, linePosY, 2))
           {
+            const int linePos = isVertical ? linePosY : linePosX;
 #ifdef USE_FULL_RESOLUTION
             image.getPixel(linePosX, linePosY, &p);
 #else
-            p = image[(int)linePosY][(int)linePosX];
+            p = linePixels[linePos];
 #endif
             lastY = p.y;
-            scanLinePixelBuffer[++pixelCount] = p;
-            scanLine.scanLineSegments[segmentNo].gradientColorEnd = lastColorDiff() > minColorDiff;
+            buffer.pixelBuffer[++buffer.pixelCount] = p;
+            scanLine.scanLineSegments[segmentNo].gradientColorEnd = buffer.lastColorDiff() > minColorDiff;
 
             if (foundHigh && foundLow)
             {
@@ -1034,16 +1088,16 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
             linePosX += stepSizeLineX;
             linePosY -= stepSizeLineY;
             counter += stepSizeLine;
-            fieldColorCount += stepSizeLine * fieldColor.isPixelFieldColor(p.y, p.cb, p.cr);
+            fieldColorCount += stepSizeLine * buffer.fieldColor[linePos];
           }
           if (foundEnd)
           {
             Vector2f endPoint(((float)(linePosLowX + linePosHighX)) / 2.f, ((float)(linePosLowY + linePosHighY)) / 2.f);
             scanLine.scanLineSegments[segmentNo].endPointInImage = endPoint;
-            lastLineSize = lineSizes[(int)endPoint.y()];
+            lastLineSize = scan.lineSizes[(int)endPoint.y()];
             stepSizeLine = (int)std::max((lastLineSize / 20), 1.f);
 
-            scanLine.scanLineSegments.emplace_back(ScanLineSegment(endPoint.x() + xNorm, endPoint.y() - yNorm, (fieldColorBuffer[0] == 1) * stepSize, isGradientColor, unknownSegment));
+            scanLine.scanLineSegments.emplace_back(ScanLineSegment(endPoint.x() + xNorm, endPoint.y() - yNorm, (buffer.fieldColorBuffer[0] == 1) * stepSize, isGradientColor, unknownSegment));
             segmentNo++;
             segmentLength = stepSize;
 
@@ -1058,12 +1112,12 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
 #ifdef USE_FULL_RESOLUTION
             image.getPixel(imageX, imageY, &p);
 #else
-            p = image[imageY][imageX];
+            p = linePixels[isVertical ? imageY : imageX];
 #endif
-            scanLinePixelBuffer[++pixelCount] = p;
-            scanLine.scanLineSegments[segmentNo].avgY = stepSize * scanLinePixelBuffer[pixelCount].y;
-            scanLine.scanLineSegments[segmentNo].avgCb = stepSize * scanLinePixelBuffer[pixelCount].cb;
-            scanLine.scanLineSegments[segmentNo].avgCr = stepSize * scanLinePixelBuffer[pixelCount].cr;
+            buffer.pixelBuffer[++buffer.pixelCount] = p;
+            scanLine.scanLineSegments[segmentNo].avgY = stepSize * buffer.pixelBuffer[buffer.pixelCount].y;
+            scanLine.scanLineSegments[segmentNo].avgCb = stepSize * buffer.pixelBuffer[buffer.pixelCount].cb;
+            scanLine.scanLineSegments[segmentNo].avgCr = stepSize * buffer.pixelBuffer[buffer.pixelCount].cr;
             continue;
           }
           else
@@ -1100,7 +1154,7 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
           imageY += stepSizeY;
         }
       }
-      else if (segmentLength < imageHeight / 80)
+      else if (segmentLength < scan.imageHeight / 80)
       {
       }
       else if (yDiff > fieldColor.fieldColorArray[0].lineToFieldColorYThreshold / 2 || isGradientColor)
@@ -1141,7 +1195,7 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
     }
     else // possible obstacle segment..
     {
-      if (fieldColorBuffer.sum() > 4)
+      if (buffer.fieldColorBuffer.sum() > 4)
 
       {
         scanLine.scanLineSegments[segmentNo].endPointInImage = Vector2f((float)(imageX - xNorm * stepSize * 2), (float)(imageY + yNorm * stepSize * 2));
@@ -1151,17 +1205,17 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
           scanLine.scanLineSegments[segmentNo].avgCb /= segmentLength;
           scanLine.scanLineSegments[segmentNo].avgCr /= segmentLength;
         }
-        scanLine.scanLineSegments.emplace_back(ScanLineSegment((float)imageX, (float)imageY, fieldColorBuffer.sum() * stepSize, isGradientColor, unknownSegment));
+        scanLine.scanLineSegments.emplace_back(ScanLineSegment((float)imageX, (float)imageY, buffer.fieldColorBuffer.sum() * stepSize, isGradientColor, unknownSegment));
         segmentNo++;
         segmentLength = 0;
       }
     }
 
     segmentLength += stepSize;
-    scanLine.scanLineSegments[segmentNo].avgY += stepSize * scanLinePixelBuffer[pixelCount].y;
-    scanLine.scanLineSegments[segmentNo].avgCb += stepSize * scanLinePixelBuffer[pixelCount].cb;
-    scanLine.scanLineSegments[segmentNo].avgCr += stepSize * scanLinePixelBuffer[pixelCount].cr;
-    scanLine.scanLineSegments[segmentNo].fieldColorCount += fieldColorBuffer[0] * stepSize;
+    scanLine.scanLineSegments[segmentNo].avgY += stepSize * buffer.pixelBuffer[buffer.pixelCount].y;
+    scanLine.scanLineSegments[segmentNo].avgCb += stepSize * buffer.pixelBuffer[buffer.pixelCount].cb;
+    scanLine.scanLineSegments[segmentNo].avgCr += stepSize * buffer.pixelBuffer[buffer.pixelCount].cr;
+    scanLine.scanLineSegments[segmentNo].fieldColorCount += buffer.fieldColorBuffer[0] * stepSize;
     imageX += stepSizeX;
     imageY -= stepSizeY;
   }
@@ -1175,7 +1229,7 @@ void CLIPPreprocessor::processScanLine(ScanLine& scanLine, const bool& upper)
   }
 }
 
-void CLIPPreprocessor::addBallSpot(const Vector2f& point, const int& y, const int& cb, const int& cr, const bool& upper)
+void CLIPPreprocessor::addBallSpot(const Vector2f& point, const int& y, const int& cb, const int& cr, ImageScan& scan)
 {
   ScanlinesBallSpot newBallSpot;
   newBallSpot.position.x() = (int)point.x();
@@ -1183,174 +1237,142 @@ void CLIPPreprocessor::addBallSpot(const Vector2f& point, const int& y, const in
   //newBallSpot.y = y; // TODO BH0215 port: add y back in?
   newBallSpot.cb = cb;
   newBallSpot.cr = cr;
-  newBallSpot.upper = upper;
-  if (upper)
-    localBallSpots.ballSpotsUpper.push_back(newBallSpot);
-  else
-    localBallSpots.ballSpots.push_back(newBallSpot);
+  newBallSpot.upper = scan.upper;
+  scan.ballSpots.push_back(newBallSpot);
 }
 
-void CLIPPreprocessor::addLinePoint(const Vector2f& linePoint, const float& lineSize, bool isVertical, const bool& upper)
+void CLIPPreprocessor::addLinePoint(const Vector2f& linePoint, const float& lineSize, bool isVertical, ImageScan& scan)
 {
   CLIPPointsPercept::Point point;
   point.inImage = linePoint;
   point.onField = Vector2f::Zero();
   point.lineSizeInImage = lineSize;
   //Geometry::calculatePointOnField(linePoint.x,linePoint.y,theCameraMatrix,theimage,point.onField);
-  point.scanLineNoH = scanLineHNo;
-  point.scanLineNoV = scanLineVNo;
+  point.scanLineNoH = scan.scanLineHNo;
+  point.scanLineNoV = scan.scanLineVNo;
   point.isVertical = isVertical;
-  if (upper)
-    localCLIPPointsPercept.pointsUpper.push_back(point);
-  else
-    localCLIPPointsPercept.points.push_back(point);
+  scan.points.push_back(point);
 }
 
-void CLIPPreprocessor::findFieldBorders()
+void CLIPPreprocessor::findFieldBorders(ImageScan& scan)
 {
-  fieldBorderRight.base = Vector2f::Zero();
-  fieldBorderRight.direction = Vector2f::Zero();
-  fieldBorderLeft.base = Vector2f::Zero();
-  fieldBorderLeft.direction = Vector2f::Zero();
-  fieldBorderFront.base = Vector2f::Zero();
-  fieldBorderFront.direction = Vector2f::Zero();
+  scan.fieldBorderRight.base = Vector2f::Zero();
+  scan.fieldBorderRight.direction = Vector2f::Zero();
+  scan.fieldBorderLeft.base = Vector2f::Zero();
+  scan.fieldBorderLeft.direction = Vector2f::Zero();
+  scan.fieldBorderFront.base = Vector2f::Zero();
+  scan.fieldBorderFront.direction = Vector2f::Zero();
 
   // build upper convex hull of field end points
-  fieldHull.clear();
-  if ((int)fieldEndPoints.size() >= fieldBorderMinPoints)
+  scan.fieldHull.clear();
+  if ((int)scan.fieldEndPoints.size() >= fieldBorderMinPoints)
   {
-    fieldHull.push_back(fieldEndPoints[0].imageCoordinates);
-    fieldHull.push_back(fieldEndPoints[1].imageCoordinates);
+    scan.fieldHull.push_back(scan.fieldEndPoints[0].imageCoordinates);
+    scan.fieldHull.push_back(scan.fieldEndPoints[1].imageCoordinates);
   }
   else
     return;
   int size = 0;
-  for (int i = 2; i < (int)fieldEndPoints.size(); i++)
+  for (int i = 2; i < (int)scan.fieldEndPoints.size(); i++)
   {
-    size = static_cast<int>(fieldHull.size());
-    if ((fieldHull[size - 1] - fieldHull[size - 2]).angle() > (fieldEndPoints[i].imageCoordinates - fieldHull[size - 1]).angle())
+    size = static_cast<int>(scan.fieldHull.size());
+    if ((scan.fieldHull[size - 1] - scan.fieldHull[size - 2]).angle() > (scan.fieldEndPoints[i].imageCoordinates - scan.fieldHull[size - 1]).angle())
     {
-      fieldHull.pop_back();
-      size = static_cast<int>(fieldHull.size());
-      if (size > 1 && (fieldHull[size - 1] - fieldHull[size - 2]).angle() > (fieldEndPoints[i].imageCoordinates - fieldHull[size - 1]).angle())
-        fieldHull.pop_back();
+      scan.fieldHull.pop_back();
+      size = static_cast<int>(scan.fieldHull.size());
+      if (size > 1 && (scan.fieldHull[size - 1] - scan.fieldHull[size - 2]).angle() > (scan.fieldEndPoints[i].imageCoordinates - scan.fieldHull[size - 1]).angle())
+        scan.fieldHull.pop_back();
     }
-    fieldHull.push_back(fieldEndPoints[i].imageCoordinates);
+    scan.fieldHull.push_back(scan.fieldEndPoints[i].imageCoordinates);
   }
 
   // try to create line from field end points
-  int indexBase = 0;
-  int indexDirection = 0;
-  int inliers = 0;
-  int outliers = 0;
+  if (fieldBorderRandomSeed)
+    scan.fieldBorderRansac.seed(fieldBorderRandomSeed + scan.timeStamp);
+  LineRANSAC::Parameters parameters;
+  parameters.maxDistance = static_cast<float>(fieldBorderMaxDistance);
+  parameters.maxIterations = 20;
+  parameters.progressive = true;
+  std::vector<Vector2f> samplePoints;
   bool foundLine = true;
-  while ((int)fieldEndPoints.size() >= fieldBorderMinPoints && foundLine)
+  while ((int)scan.fieldEndPoints.size() >= fieldBorderMinPoints && foundLine)
   {
-    int fieldEndPointNo = (int)fieldEndPoints.size();
     foundLine = false;
-    for (int round = 0; round < 20; round++)
+
+    // points on the upper hull are sampled first, points at the top of the image are not sampled
+    samplePoints.clear();
+    for (int pass = 0; pass < 3; pass++)
+      for (const FieldEndPoint& point : scan.fieldEndPoints)
+      {
+        const bool atTop = point.imageCoordinates.y() == 0;
+        const bool onHull = std::find(scan.fieldHull.begin(), scan.fieldHull.end(), point.imageCoordinates) != scan.fieldHull.end();
+        if ((pass == 0 && !atTop && onHull) || (pass == 1 && !atTop && !onHull) || (pass == 2 && atTop))
+          samplePoints.push_back(point.imageCoordinates);
+      }
+    parameters.numOfSamplePoints = static_cast<unsigned>(std::count_if(samplePoints.begin(), samplePoints.end(), [](const Vector2f& point) { return point.y() != 0; }));
+    scan.fieldBorderRansac.setPoints(samplePoints);
+    const LineRANSAC::Result result = scan.fieldBorderRansac.fit(parameters);
+
+    if ((int)result.numOfInliers >= fieldBorderMinPoints)
     {
-      inliers = 0;
-      outliers = 0;
-      indexBase = random(fieldEndPointNo);
-      int tries = 0;
-      while (fieldEndPoints[indexBase].imageCoordinates.y() == 0 && tries < fieldEndPointNo / 2)
+      const Geometry::Line& testLine = result.line;
+      // side determined by direction angle and base
+      if (std::abs(testLine.direction.angle()) < pi_4)
       {
-        indexBase = random(fieldEndPointNo);
-        tries++;
+        scan.fieldBorderFront.base = testLine.base;
+        scan.fieldBorderFront.direction = testLine.direction;
       }
-      if (tries > 19)
-        break;
-      indexDirection = random(fieldEndPointNo);
-      while (indexBase == indexDirection)
-        indexDirection = random(fieldEndPointNo);
-      if (tries > 24)
-        break;
-      Geometry::Line testLine;
-      testLine.base = fieldEndPoints[indexBase].imageCoordinates;
-      testLine.direction = fieldEndPoints[indexDirection].imageCoordinates - fieldEndPoints[indexBase].imageCoordinates;
-      for (int i = 0; i < fieldEndPointNo; i++)
+      else if (testLine.base.x() < scan.imageWidth / 2)
       {
-        int distInImage = (int)Geometry::getDistanceToLine(testLine, fieldEndPoints[i].imageCoordinates);
-        if (distInImage < fieldBorderMaxDistance)
-        {
-          inliers++;
-          fieldEndPoints[i].inlier = true;
-        }
-        else
-        {
-          outliers++;
-          fieldEndPoints[i].inlier = false;
-        }
+        scan.fieldBorderLeft.base = testLine.base;
+        scan.fieldBorderLeft.direction = testLine.direction;
       }
-      if (inliers >= fieldBorderMinPoints)
+      else
       {
-        foundLine = true;
-        // side determined by direction angle and base
-        if (std::abs(testLine.direction.angle()) < pi_4)
-        {
-          fieldBorderFront.base = testLine.base;
-          fieldBorderFront.direction = testLine.direction;
-        }
-        else if (testLine.base.x() < imageWidth / 2)
-        {
-          fieldBorderLeft.base = testLine.base;
-          fieldBorderLeft.direction = testLine.direction;
-        }
-        else
-        {
-          fieldBorderRight.base = testLine.base;
-          fieldBorderRight.direction = testLine.direction;
-        }
-
-        // remove inliers from field end points and try to find next line
-        std::vector<FieldEndPoint>::iterator j = fieldEndPoints.begin();
-
-        while (j != fieldEndPoints.end())
-        {
-          if (j->inlier)
-            j = fieldEndPoints.erase(j);
-          else
-            j++;
-        }
-        break;
+        scan.fieldBorderRight.base = testLine.base;
+        scan.fieldBorderRight.direction = testLine.direction;
       }
+
+      // remove inliers from field end points and try to find next line
+      for (FieldEndPoint& point : scan.fieldEndPoints)
+        point.inlier = std::abs(Geometry::getDistanceToLine(testLine, point.imageCoordinates)) < parameters.maxDistance;
+      foundLine = std::erase_if(scan.fieldEndPoints, [](const FieldEndPoint& point) { return point.inlier; }) > 0;
     }
   }
-  if (fieldBorderFront.base.x() > 1 || fieldBorderRight.base.x() > 1 || fieldBorderLeft.base.x() > 1)
+  if (scan.fieldBorderFront.base.x() > 1 || scan.fieldBorderRight.base.x() > 1 || scan.fieldBorderLeft.base.x() > 1)
   {
     // draw the field border
     DEBUG_RESPONSE("debug drawing:module:CLIPPreprocessor:fieldBorders")
     {
-      if (fieldBorderFront.base.x() > 1)
+      if (scan.fieldBorderFront.base.x() > 1)
       {
         Vector2f fieldBorderFrontLeft = Vector2f::Zero();
         Vector2f fieldBorderFrontRight = Vector2f::Zero();
-        if ((Geometry::getIntersectionOfLines(fieldBorderFront, Geometry::Line(Vector2f(4.f, 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontLeft)
-                || Geometry::getIntersectionOfLines(fieldBorderFront, Geometry::Line(Vector2f((float)(imageWidth - 4), 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontRight))
-            && fieldBorderFrontLeft.y() >= 4 && fieldBorderFrontRight.y() <= imageHeight - 4)
+        if ((Geometry::getIntersectionOfLines(scan.fieldBorderFront, Geometry::Line(Vector2f(4.f, 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontLeft)
+                || Geometry::getIntersectionOfLines(scan.fieldBorderFront, Geometry::Line(Vector2f((float)(scan.imageWidth - 4), 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontRight))
+            && fieldBorderFrontLeft.y() >= 4 && fieldBorderFrontRight.y() <= scan.imageHeight - 4)
         {
           LINE("module:CLIPPreprocessor:fieldBorders", fieldBorderFrontLeft.x(), fieldBorderFrontLeft.y(), fieldBorderFrontRight.x(), fieldBorderFrontRight.y(), 3, Drawings::solidPen, ColorRGBA::yellow);
         }
       }
-      if (fieldBorderLeft.base.x() > 1)
+      if (scan.fieldBorderLeft.base.x() > 1)
       {
         Vector2f fieldBorderFrontLeft = Vector2f::Zero();
         Vector2f fieldBorderFrontRight = Vector2f::Zero();
-        if ((Geometry::getIntersectionOfLines(fieldBorderFront, Geometry::Line(Vector2f(4.f, 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontLeft)
-                || Geometry::getIntersectionOfLines(fieldBorderFront, Geometry::Line(Vector2f((float)(imageWidth - 4), 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontRight))
-            && fieldBorderFrontLeft.y() >= 4 && fieldBorderFrontRight.y() <= imageHeight - 4)
+        if ((Geometry::getIntersectionOfLines(scan.fieldBorderFront, Geometry::Line(Vector2f(4.f, 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontLeft)
+                || Geometry::getIntersectionOfLines(scan.fieldBorderFront, Geometry::Line(Vector2f((float)(scan.imageWidth - 4), 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontRight))
+            && fieldBorderFrontLeft.y() >= 4 && fieldBorderFrontRight.y() <= scan.imageHeight - 4)
         {
           LINE("module:CLIPPreprocessor:fieldBorders", fieldBorderFrontLeft.x(), fieldBorderFrontLeft.y(), fieldBorderFrontRight.x(), fieldBorderFrontRight.y(), 3, Drawings::solidPen, ColorRGBA::yellow);
         }
       }
-      if (fieldBorderRight.base.x() > 1)
+      if (scan.fieldBorderRight.base.x() > 1)
       {
         Vector2f fieldBorderFrontLeft = Vector2f::Zero();
         Vector2f fieldBorderFrontRight = Vector2f::Zero();
-        if ((Geometry::getIntersectionOfLines(fieldBorderFront, Geometry::Line(Vector2f(4.f, 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontLeft)
-                || Geometry::getIntersectionOfLines(fieldBorderFront, Geometry::Line(Vector2f((float)(imageWidth - 4), 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontRight))
-            && fieldBorderFrontLeft.y() >= 4 && fieldBorderFrontRight.y() <= imageHeight - 4)
+        if ((Geometry::getIntersectionOfLines(scan.fieldBorderFront, Geometry::Line(Vector2f(4.f, 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontLeft)
+                || Geometry::getIntersectionOfLines(scan.fieldBorderFront, Geometry::Line(Vector2f((float)(scan.imageWidth - 4), 4.f), Vector2f(0.f, 1.f)), fieldBorderFrontRight))
+            && fieldBorderFrontLeft.y() >= 4 && fieldBorderFrontRight.y() <= scan.imageHeight - 4)
         {
           LINE("module:CLIPPreprocessor:fieldBorders", fieldBorderFrontLeft.x(), fieldBorderFrontLeft.y(), fieldBorderFrontRight.x(), fieldBorderFrontRight.y(), 3, Drawings::solidPen, ColorRGBA::yellow);
         }
@@ -1359,17 +1381,17 @@ void CLIPPreprocessor::findFieldBorders()
   }
 }
 
-void CLIPPreprocessor::drawScanLineSegments(const bool& upper)
+void CLIPPreprocessor::drawScanLineSegments(const ImageScan& scan)
 {
-  std::vector<ScanLine>& scanLinesHorizontal = upper ? scanLinesHorizontalUpper : scanLinesHorizontalLower;
-  std::vector<ScanLine>& scanLinesVertical = upper ? scanLinesVerticalUpper : scanLinesVerticalLower;
+  const std::vector<ScanLine>& scanLinesHorizontal = scan.scanLinesHorizontal;
+  const std::vector<ScanLine>& scanLinesVertical = scan.scanLinesVertical;
 
   // vertical scan lines
   for (std::vector<ScanLine>::const_iterator i = scanLinesVertical.begin(); i != scanLinesVertical.end(); ++i)
   {
     for (std::vector<ScanLineSegment>::const_iterator seg = i->scanLineSegments.begin(); seg != i->scanLineSegments.end(); ++seg)
     {
-      drawSegment(seg, upper);
+      drawSegment(seg, scan.upper);
     }
   }
   // horizontal scan lines
@@ -1377,44 +1399,44 @@ void CLIPPreprocessor::drawScanLineSegments(const bool& upper)
   {
     for (std::vector<ScanLineSegment>::const_iterator seg = i->scanLineSegments.begin(); seg != i->scanLineSegments.end(); ++seg)
     {
-      drawSegment(seg, upper);
+      drawSegment(seg, scan.upper);
     }
   }
   //field End Points and connections, if close enough (only used for drawings)
-  for (int i = 0; i < (int)fieldEndPoints.size() - 1; i++)
+  for (int i = 0; i < (int)scan.fieldEndPoints.size() - 1; i++)
   {
-    if ((fieldEndPoints[i].imageCoordinates - fieldEndPoints[i + 1].imageCoordinates).norm() < 40)
+    if ((scan.fieldEndPoints[i].imageCoordinates - scan.fieldEndPoints[i + 1].imageCoordinates).norm() < 40)
     {
-      if (upper)
+      if (scan.upper)
         LINE("module:CLIPPreprocessor:scanLineSegments:Upper",
-            fieldEndPoints[i].imageCoordinates.x(),
-            fieldEndPoints[i].imageCoordinates.y(),
-            fieldEndPoints[i + 1].imageCoordinates.x(),
-            fieldEndPoints[i + 1].imageCoordinates.y(),
+            scan.fieldEndPoints[i].imageCoordinates.x(),
+            scan.fieldEndPoints[i].imageCoordinates.y(),
+            scan.fieldEndPoints[i + 1].imageCoordinates.x(),
+            scan.fieldEndPoints[i + 1].imageCoordinates.y(),
             1,
             Drawings::solidPen,
             ColorRGBA(138, 043, 226));
       else
         LINE("module:CLIPPreprocessor:scanLineSegments:Lower",
-            fieldEndPoints[i].imageCoordinates.x(),
-            fieldEndPoints[i].imageCoordinates.y(),
-            fieldEndPoints[i + 1].imageCoordinates.x(),
-            fieldEndPoints[i + 1].imageCoordinates.y(),
+            scan.fieldEndPoints[i].imageCoordinates.x(),
+            scan.fieldEndPoints[i].imageCoordinates.y(),
+            scan.fieldEndPoints[i + 1].imageCoordinates.x(),
+            scan.fieldEndPoints[i + 1].imageCoordinates.y(),
             1,
             Drawings::solidPen,
             ColorRGBA(138, 043, 226));
     }
     else
     {
-      if (upper)
+      if (scan.upper)
       {
-        DOT("module:CLIPPreprocessor:scanLineSegments:Upper", fieldEndPoints[i].imageCoordinates.x(), fieldEndPoints[i].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
-        DOT("module:CLIPPreprocessor:scanLineSegments:Upper", fieldEndPoints[i + 1].imageCoordinates.x(), fieldEndPoints[i + 1].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
+        DOT("module:CLIPPreprocessor:scanLineSegments:Upper", scan.fieldEndPoints[i].imageCoordinates.x(), scan.fieldEndPoints[i].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
+        DOT("module:CLIPPreprocessor:scanLineSegments:Upper", scan.fieldEndPoints[i + 1].imageCoordinates.x(), scan.fieldEndPoints[i + 1].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
       }
       else
       {
-        DOT("module:CLIPPreprocessor:scanLineSegments:Lower", fieldEndPoints[i].imageCoordinates.x(), fieldEndPoints[i].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
-        DOT("module:CLIPPreprocessor:scanLineSegments:Lower", fieldEndPoints[i + 1].imageCoordinates.x(), fieldEndPoints[i + 1].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
+        DOT("module:CLIPPreprocessor:scanLineSegments:Lower", scan.fieldEndPoints[i].imageCoordinates.x(), scan.fieldEndPoints[i].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
+        DOT("module:CLIPPreprocessor:scanLineSegments:Lower", scan.fieldEndPoints[i + 1].imageCoordinates.x(), scan.fieldEndPoints[i + 1].imageCoordinates.y(), ColorRGBA(138, 043, 226), ColorRGBA(138, 043, 226));
       }
     }
   }
@@ -1483,14 +1505,14 @@ void CLIPPreprocessor::drawSegment(std::vector<ScanLineSegment>::const_iterator
   }
 }
 
-void CLIPPreprocessor::drawFieldHull(const bool& upper)
+void CLIPPreprocessor::drawFieldHull(const ImageScan& scan)
 {
-  for (int i = 0; i < (int)fieldHull.size() - 1; i++)
+  for (int i = 0; i < (int)scan.fieldHull.size() - 1; i++)
   {
-    if (upper)
-      LINE("module:CLIPPreprocessor:fieldHull:Upper", fieldHull[i].x(), fieldHull[i].y(), fieldHull[i + 1].x(), fieldHull[i + 1].y(), 5, Drawings::solidPen, ColorRGBA::yellow);
+    if (scan.upper)
+      LINE("module:CLIPPreprocessor:fieldHull:Upper", scan.fieldHull[i].x(), scan.fieldHull[i].y(), scan.fieldHull[i + 1].x(), scan.fieldHull[i + 1].y(), 5, Drawings::solidPen, ColorRGBA::yellow);
     else
-      LINE("module:CLIPPreprocessor:fieldHull:Lower", fieldHull[i].x(), fieldHull[i].y(), fieldHull[i + 1].x(), fieldHull[i + 1].y(), 5, Drawings::solidPen, ColorRGBA::yellow);
+      LINE("module:CLIPPreprocessor:fieldHull:Lower", scan.fieldHull[i].x(), scan.fieldHull[i].y(), scan.fieldHull[i + 1].x(), scan.fieldHull[i + 1].y(), 5, Drawings::solidPen, ColorRGBA::yellow);
   }
 }
 
@@ -9,6 +9,7 @@
 
 #include "Tools/Module/Module.h"
 #include "Tools/Math/Geometry.h"
+#include "Tools/Math/LineRANSAC.h"
 #include "Representations/Configuration/FieldDimensions.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Infrastructure/Image.h"
@@ -17,7 +18,9 @@
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/FieldColor.h"
 #include "Representations/Perception/GoalPercept.h"
+#include "Representations/Perception/CLIPClassifiedPixels.h"
 #include "Representations/Perception/CLIPPointsPercept.h"
+#include "Representations/Perception/CLIPScanLineSegments.h"
 #include "Representations/Perception/BallSpots.h"
 #include "Representations/Perception/BallPercept.h"
 #include "Representations/Perception/RobotsPercept.h"
@@ -25,6 +28,7 @@
 #include "Tools/Debugging/DebugImages.h"
 #include "Tools/RingBufferWithSum.h"
 #include <algorithm>
+#include <array>
 
 MODULE(CLIPPreprocessor,
   REQUIRES(FallDownState),
@@ -37,10 +41,16 @@ MODULE(CLIPPreprocessor,
   REQUIRES(ImageUpper),
   REQUIRES(CameraMatrix),
   REQUIRES(CameraMatrixUpper),
+  REQUIRES(BodyContour),
+  REQUIRES(BodyContourUpper),
   USES(RobotPose),
   PROVIDES(CLIPPointsPercept),
+  PROVIDES(CLIPScanLineSegments),
+  PROVIDES(CLIPClassifiedPixels),
+  PROVIDES(CLIPClassifiedPixelsUpper),
   PROVIDES(ScanlinesBallSpots),
   PROVIDES(ObstacleBasePoints),
+  HAS_PREEXECUTION,
   LOADS_PARAMETERS(,
     // TODO: initialized has to be changed when changing parameters!!
     (int) hScanLineDistanceLower, // distance of horizontal scan lines in lower image (320 image, will be scaled)
@@ -50,6 +60,7 @@ MODULE(CLIPPreprocessor,
     (int) yellowGoalColorMinDiff, // min cr and cb channel diff for goal->nonGoal transition or v.v.
     (int) fieldBorderMaxDistance, // max distance in pixels of field end point to field end line to be inlier (RANSAC used)
     (int) fieldBorderMinPoints, // min number of inliers for a field end line
+    (unsigned)(0) fieldBorderRandomSeed, // if not 0, the RANSAC is seeded with it and the image time stamp to be reproducible in log replays
     (float)(0.3f) minFieldColorForFieldSegment, // min ratio of field color for segment to be a field segment
     (int) obstacleMaxPointsLow, // max count of scanlines to check
     (unsigned) obstacleMinPointsLow, // min count of scanlines for counting as obstacle segment
@@ -58,7 +69,8 @@ MODULE(CLIPPreprocessor,
     (int) ballBaseCrValue, // min value of cr channel to be expecting ball (to do, only used in old approach (processScanLine(..))
     (bool) useAreaBasedFieldColor, // use are based field color?
     (bool) useObstacleBasePoints,
-    (bool) sortBallSpots
+    (bool) sortBallSpots,
+    (int)(8) scanLinesPerTask // the number of scan lines scanned by a single task
   )
 );
 
@@ -160,28 +172,112 @@ public:
     void clear() { scanLineSegments.clear(); };
   };
 
+  /** The data a single scan line needs while its pixels are scanned. Each task scanning a batch of scan lines has its own. */
+  struct ScanLineBuffer
+  {
+    ScanLineBuffer() : pixelBuffer(Image::maxResolutionWidth * 2), pixels(Image::maxResolutionWidth), fieldColor(Image::maxResolutionWidth) {}
+
+    /** return sum of cb and cr channel differences, used to detect changes in color on scan lines */
+    inline int lastColorDiff() const { return std::abs(pixelBuffer[pixelCount - 1].cb - pixelBuffer[pixelCount].cb + pixelBuffer[pixelCount - 1].cr - pixelBuffer[pixelCount].cr); }
+
+    /** return sum of cb and cr channel differences, used to detect changes in color on scan lines */
+    inline int lastColorDiff2() const { return std::abs(pixelBuffer[pixelCount - 2].cb - pixelBuffer[pixelCount].cb + pixelBuffer[pixelCount - 2].cr - pixelBuffer[pixelCount].cr); }
+
+    std::vector<Image::Pixel> pixelBuffer;
+    unsigned pixelCount = 0;
+    std::vector<Image::Pixel> pixels; // the pixels of the current vertical scan line, indexed by their y coordinate
+    std::vector<unsigned char> fieldColor; // 1 for each pixel of the current scan line that has field color
+    RingBufferWithSum<int, 8> fieldColorBuffer;
+  };
+
+  /** Everything that belongs to scanning one of the images. The upper and the lower image are scanned in parallel. */
+  struct ImageScan
+  {
+    explicit ImageScan(bool upper) : upper(upper) {}
+
+    /*
+    * The same function as provided in FieldColor.h,
+    * but faster since some values are precomputed,
+    * TODO : work around this
+    */
+    inline bool isPixelBallColor(const int& y, const int& cb, const int& cr) const { return cr > minBallCr && cb > minBallCb && cb < maxBallCb; }
+
+    const bool upper;
+    unsigned timeStamp = 0; // used to make sure that images are only processed once
+    bool updated = false; // was a new image processed in this frame?
+    int imageWidth = 0, imageHeight = 0;
+    int yStart = 0; // the first row below the horizon
+    Geometry::Line horizon;
+
+    std::vector<ScanLine> scanLinesVertical; // vertical scan lines - to find field lines, field end, obstacles and ball
+    std::vector<ScanLine> scanLinesHorizontal; // horizontal scan lines - to find goal, field lines, obstacles and ball
+    int scanLineVNo = 0, scanLineHNo = 0; // remember number of current scan lines (needed for line spots)
+    int scanLineNoYStart = 0;
+    std::vector<ScanLineBuffer> buffers; // one for each batch of scan lines
+    std::array<unsigned char, 4> fieldColorLower, fieldColorUpper; // the range of each byte of a pixel with field color (constant for one image)
+    std::vector<float> lineSizes = std::vector<float>(Image::maxResolutionHeight);
+
+    // for field end detection
+    std::vector<FieldEndPoint> fieldEndPoints;
+    std::vector<Vector2f> fieldHull;
+    Geometry::Line fieldBorderFront, fieldBorderLeft, fieldBorderRight;
+    LineRANSAC fieldBorderRansac; // each image has its own, because they are scanned in parallel
+
+    // field color related vars (constant for one image, used to improve speed of ball color check)
+    int minBallCb = 0;
+    int maxBallCb = 0;
+    int minBallCr = 0;
+
+    // for obstacle detection
+    std::vector<Vector2i> obstaclePointsLow;
+    std::vector<Vector2i> obstaclePointsHigh;
+    std::vector<Vector2i> obstaclePointsLeft;
+    std::vector<Vector2i> obstaclePointsRight;
+
+    // the results, merged into the local percepts after both images were scanned
+    std::vector<CLIPPointsPercept::Point> points;
+    std::vector<ScanlinesBallSpot> ballSpots;
+    std::vector<ObstacleBasePoints::ObstacleBasePoint> obstacleBasePoints;
+    CLIPScanLineSegments::Segments segments;
+    float fieldBorderTop = -1.f;
+  };
+
 private:
   void update(CLIPPointsPercept& theCLIPPointsPercept);
+  void update(CLIPScanLineSegments& theCLIPScanLineSegments);
+  void update(CLIPClassifiedPixels& theCLIPClassifiedPixels) { theCLIPClassifiedPixels.setImage(theImage, theFieldColors); }
+  void update(CLIPClassifiedPixelsUpper& theCLIPClassifiedPixelsUpper) { theCLIPClassifiedPixelsUpper.setImage(theImageUpper, theFieldColorsUpper); }
   void update(ScanlinesBallSpots& ballSpots);
   void update(ObstacleBasePoints& obstacleBasePoints);
 
+  /*
+  * Scans both images in parallel if they are new. Each image is scanned in batches of scan lines
+  * that are processed concurrently. Their results are evaluated in the order of the scan lines,
+  * the lower image before the upper one.
+  */
+  void execute(tf::Subflow& subflow);
+
   /*
   * Reset all local percepts, only to be called once a frame!
   */
   void reset();
-  void execute(const bool& upper); // if new image is available, executes scanning process (once per frame and image)
   void createScanLines();
-  void scanField(const bool& upper); // create scan lines
-  void createObstacleBasePoints(const bool& upper); // add possible obstacles from obstacle points
-  void postProcessScanLine(const ScanLine& scanLine, const bool& upper); // get additional info from finished ScanLine
-  void classifyScanLineSegments(ScanLine& scanLine, const bool& upper); // run after processScanLine - classifies segments
+  bool prepareScan(ImageScan& scan); // prepares scanning a new image, returns false if it is not scanned
+  void scanLines(ImageScan& scan, int batch); // runs processScanLine on a batch of scan lines
+  void evaluateScan(ImageScan& scan); // creates all results from the scan lines of an image
+  void mergeScans(); // copies the results of both images into the local percepts
+  void createObstacleBasePoints(ImageScan& scan); // add possible obstacles from obstacle points
+  void addScanLineSegments(const ScanLine& scanLine, bool isVertical, ImageScan& scan); // copies the classified segments into the results
+  void postProcessScanLine(const ScanLine& scanLine, ImageScan& scan); // get additional info from finished ScanLine
+  void classifyScanLineSegments(ScanLine& scanLine, const ImageScan& scan); // run after processScanLine - classifies segments
 
   /*
                                                                         * Run one scanLine over field, generates unclassified scan line segments, no percepts generated here yet.
                                                                         * @param scanLine The Scan Line in question.
-                                                                        * @param upper True if upper image will be scanned.
+                                                                        * @param scan The image scanned.
+                                                                        * @param buffer The data used while scanning.
                                                                         */
-  void processScanLine(ScanLine& scanLine, const bool& upper);
+  void processScanLine(ScanLine& scanLine, const ImageScan& scan, ScanLineBuffer& buffer);
 
   /*
   * Adds a ball spot.
@@ -189,93 +285,40 @@ private:
   * @param y The average y-value on the ball segment.
   * @param cb The average cb-value on the ball segment.
   * @param cr The average cr-value on the ball segment.
-  * @param upper True if from upper image.
+  * @param scan The image scanned.
   */
-  void addBallSpot(const Vector2f& point, const int& y, const int& cb, const int& cr, const bool& upper);
+  void addBallSpot(const Vector2f& point, const int& y, const int& cb, const int& cr, ImageScan& scan);
 
   /*
   * Adds a ball spot.
   * @param linePoint The center point of the line segment.
   * @param lineSize The length of the line segment.
   * @param isVertical True if line segment was on vertical scan line.
-  * @param upper True if from upper image.
+  * @param scan The image scanned.
   */
-  void addLinePoint(const Vector2f& linePoint, const float& lineSize, bool isVertical, const bool& upper);
+  void addLinePoint(const Vector2f& linePoint, const float& lineSize, bool isVertical, ImageScan& scan);
 
   /*
   * Finds field border(s).
   */
-  void findFieldBorders();
-
-  /*
-  * The same function as provided in FieldColor.h,
-  * but faster since some values are precomputed,
-  * TODO : work around this
-  */
-  inline bool isPixelBallColor(const int& y, const int& cb, const int& cr) { return cr > minBallCr && cb > minBallCb && cb < maxBallCb; }
+  void findFieldBorders(ImageScan& scan);
 
-  /** return sum of cb and cr channel differences, used to detect changes in color on scan lines */
-  inline int lastColorDiff()
-  {
-    return std::abs(scanLinePixelBuffer[pixelCount - 1].cb - scanLinePixelBuffer[pixelCount].cb + scanLinePixelBuffer[pixelCount - 1].cr - scanLinePixelBuffer[pixelCount].cr);
-  }
+  bool initialized = false;
+  Vector2i scanLinesImageSize = Vector2i::Zero(); // the lower image size the scan lines were created for
+  Vector2i scanLinesImageSizeUpper = Vector2i::Zero(); // the upper image size the scan lines were created for
 
-  /** return sum of cb and cr channel differences, used to detect changes in color on scan lines */
-  inline int lastColorDiff2()
-  {
-    return std::abs(scanLinePixelBuffer[pixelCount - 2].cb - scanLinePixelBuffer[pixelCount].cb + scanLinePixelBuffer[pixelCount - 2].cr - scanLinePixelBuffer[pixelCount].cr);
-  }
-
-  unsigned timeStamp, timeStampUpper; // used to make sure that images are only processed once
-  bool wasReset;
-  bool initialized;
-
-  int imageWidth, imageHeight;
-
-  Geometry::Line horizon;
-
-  std::vector<ScanLine> scanLinesVerticalLower; // vertical scan lines - to find field lines, field end, obstacles and ball
-  std::vector<ScanLine> scanLinesVerticalUpper; // vertical scan lines - to find field lines, field end, obstacles and ball
-  std::vector<ScanLine> scanLinesHorizontalLower; // horizontal scan lines - to find goal, field lines, obstacles and ball
-  std::vector<ScanLine> scanLinesHorizontalUpper; // horizontal scan lines - to find goal, field lines, obstacles and ball
-  int scanLineVNo, scanLineHNo; // remember number of current scan lines (needed for line spots)
-  std::vector<Image::Pixel> scanLinePixelBuffer;
-  RingBufferWithSum<int, 8> fieldColorBuffer;
-  std::vector<float> lineSizes;
-
-  // for field end detection
-  std::vector<FieldEndPoint> fieldEndPoints;
-  std::vector<Vector2f> fieldHull;
-  Geometry::Line fieldBorderFront, fieldBorderLeft, fieldBorderRight;
-
-  // scan line stuff
-  // all unused
-  //  int noVScanLinesVerticalLower;
-  //  int noVScanLinesVerticalUpper;
-  //  int noHScanLinesVerticalLower;
-  //  int noHScanLinesVerticalUpper;
-  int scanLineNoYStart;
-  unsigned pixelCount;
-
-  // field color related vars (constant for one image, used to improve speed of ball color check)
-  int minBallCb;
-  int maxBallCb;
-  int minBallCr;
-
-  // for obstacle detection
-  std::vector<Vector2i> obstaclePointsLow;
-  std::vector<Vector2i> obstaclePointsHigh;
-  std::vector<Vector2i> obstaclePointsLeft;
-  std::vector<Vector2i> obstaclePointsRight;
+  ImageScan lowerScan{false};
+  ImageScan upperScan{true};
 
   // local percepts
   CLIPPointsPercept localCLIPPointsPercept;
+  CLIPScanLineSegments localCLIPScanLineSegments;
   ScanlinesBallSpots localBallSpots;
   ObstacleBasePoints localObstacleBasePoints;
 
   // debugging stuff
 
-  void drawFieldHull(const bool& upper);
-  void drawScanLineSegments(const bool& upper);
+  void drawFieldHull(const ImageScan& scan);
+  void drawScanLineSegments(const ImageScan& scan);
   void drawSegment(std::vector<ScanLineSegment>::const_iterator seg, const bool& upper);
 };
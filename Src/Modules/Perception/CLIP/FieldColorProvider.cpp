@@ -16,6 +16,12 @@ void FieldColorProvider::update(FieldColors& theFieldColor)
   DECLARE_DEBUG_RESPONSE("module:FieldColorProvider:noFieldColorFromImage:Lower");
   INIT_DEBUG_IMAGE_BLACK(FieldColor, theCameraInfo.width, theCameraInfo.height);
 
+  if (!warmStartedLower)
+  {
+    if (theWarmStart.restored)
+      localFieldColorLower = theWarmStart.fieldColors;
+    warmStartedLower = true;
+  }
 
   execute(false);
   theFieldColor = localFieldColorLower;
@@ -33,6 +39,13 @@ void FieldColorProvider::update(FieldColorsUpper& theFieldColorUpper)
   DECLARE_DEBUG_RESPONSE("module:FieldColorProvider:noFieldColorFromImage:Upper");
   INIT_DEBUG_IMAGE_BLACK(FieldColorUpper, theCameraInfoUpper.width, theCameraInfoUpper.height);
 
+  if (!warmStartedUpper)
+  {
+    if (theWarmStart.restored)
+      static_cast<FieldColors&>(localFieldColorUpper) = theWarmStart.fieldColorsUpper;
+    warmStartedUpper = true;
+  }
+
   execute(true);
   theFieldColorUpper = localFieldColorUpper;
 
@@ -69,9 +82,10 @@ void FieldColorProvider::execute(const bool& upper)
   Vector2i lowerLeft(4, image.height - 4);
   Vector2i upperRight(image.width - 4, minY);
   buildSamples(upper, lowerLeft, upperRight, maxPixelCountImageFull);
-  FieldColors::FieldColor& fieldColor = upper ? localFieldColorUpper.fieldColorArray[0] : localFieldColorLower.fieldColorArray[0];
-  calcFieldColorFromSamples(upper, fieldColor);
   FieldColors& fieldColors = upper ? (FieldColors&)localFieldColorUpper : localFieldColorLower;
+  calcStatisticsFromSamples(fieldColors);
+  FieldColors::FieldColor& fieldColor = fieldColors.fieldColorArray[0];
+  calcFieldColorFromSamples(upper, fieldColor);
   fieldColors.horizonYAvg = minY;
   fieldColors.areaHeight = 4 + (lowerLeft.y() - upperRight.y()) / 3;
   fieldColors.areaWidth = 4 + (upperRight.x() - lowerLeft.x()) / 3;
@@ -100,6 +114,9 @@ void FieldColorProvider::execute(const bool& upper)
 void FieldColorProvider::buildSamples(const bool& upper, const Vector2i& lowerLeft, const Vector2i& upperRight, const int& sampleSize)
 {
   const Image& image = upper ? (Image&)theImageUpper : theImage;
+  const FieldColors::FieldColor& lastMainFieldColor = upper ? localFieldColorUpper.fieldColorArray[0] : localFieldColorLower.fieldColorArray[0];
+  const int optCr = lastMainFieldColor.fieldColorOptCr;
+  const int maxFieldColorY = lastMainFieldColor.maxFieldColorY;
   sampleNo = 0;
   int sampleNoMax = sampleSize - 1;
   int scanWidth = upperRight.x() - lowerLeft.x();
@@ -128,29 +145,45 @@ void FieldColorProvider::buildSamples(const bool& upper, const Vector2i& lowerLe
         samples[sampleNo].y = p.y;
         samples[sampleNo].cb = p.cb;
         samples[sampleNo].cr = p.cr;
+        // the cr histogram only depends on the last field color, so it is built while sampling
+        histCr[p.cr / 4] += fieldColorWeighted(p, optCr, maxFieldColorY);
         sampleNo++;
       }
     }
   }
 }
 
-void FieldColorProvider::calcFieldColorFromSamples(const bool& upper, FieldColors::FieldColor& fieldColor)
+void FieldColorProvider::calcStatisticsFromSamples(FieldColors& fieldColors) const
 {
-  FieldColors::FieldColor& lastMainFieldColor = upper ? localFieldColorUpper.fieldColorArray[0] : localFieldColorLower.fieldColorArray[0];
-  maxY = maxCr = maxCb = oldMax = 0;
-  int optCr = lastMainFieldColor.fieldColorOptCr;
-  int maxFieldColorY = lastMainFieldColor.maxFieldColorY;
-  int optY = lastMainFieldColor.fieldColorOptY;
-
-
-  // find most common cr value and base detection of field color cb/y values on that
+  const int minWhiteY = fieldColors.fieldColorArray[0].maxFieldColorY;
+  int sumY = 0, clipped = 0, whites = 0, sumCb = 0, sumCr = 0;
   for (int i = 0; i < sampleNo; i++)
   {
-    histCr[((int)samples[i].cr) / 4] += fieldColorWeighted(samples[i], optCr, maxFieldColorY);
+    const Image::Pixel& p = samples[i];
+    sumY += p.y;
+    if (p.y >= clippedY)
+      clipped++;
+    if (p.y > minWhiteY && std::abs(p.cb - 128) + std::abs(p.cr - 128) < maxWhiteChroma)
+    {
+      whites++;
+      sumCb += p.cb;
+      sumCr += p.cr;
+    }
   }
+  fieldColors.sampleYAvg = sampleNo > 0 ? sumY / sampleNo : 0;
+  fieldColors.clippedRatio = sampleNo > 0 ? static_cast<float>(clipped) / static_cast<float>(sampleNo) : 0.f;
+  fieldColors.whiteSamples = whites;
+  fieldColors.whiteCbAvg = whites > 0 ? sumCb / whites : 128;
+  fieldColors.whiteCrAvg = whites > 0 ? sumCr / whites : 128;
+}
 
+void FieldColorProvider::calcFieldColorFromSamples(const bool& upper, FieldColors::FieldColor& fieldColor)
+{
+  FieldColors::FieldColor& lastMainFieldColor = upper ? localFieldColorUpper.fieldColorArray[0] : localFieldColorLower.fieldColorArray[0];
+  maxY = maxCr = maxCb = oldMax = 0;
+  int optY = lastMainFieldColor.fieldColorOptY;
 
-  // find max cr sum in histograms
+  // find most common cr value (histCr was built by buildSamples) and base detection of field color cb/y values on that
   for (int i = 0; i < 64; i++)
   {
     oldMax = maxCr;
@@ -12,6 +12,7 @@
 #include "Representations/Perception/FieldColor.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Infrastructure/Image.h"
+#include "Representations/Infrastructure/WarmStart.h"
 #include "Tools/Debugging/DebugImages.h"
 #include <algorithm>
 
@@ -23,6 +24,7 @@ MODULE(FieldColorProvider,
   REQUIRES(CameraMatrixUpper),
   REQUIRES(Image),
   REQUIRES(ImageUpper),
+  REQUIRES(WarmStart),
   PROVIDES(FieldColors),
   PROVIDES(FieldColorsUpper),
   LOADS_PARAMETERS(,
@@ -34,7 +36,9 @@ MODULE(FieldColorProvider,
     (int) maxDiffOptY,
     (int) maxDiffCbCrRatio,
     (int)(30) minLineToFieldColorThresholdUpper,
-    (int)(30) minLineToFieldColorThresholdLower
+    (int)(30) minLineToFieldColorThresholdLower,
+    (int)(250) clippedY, /**< Samples at least this bright count as saturated. */
+    (int)(40) maxWhiteChroma /**< Bright samples whose |cb - 128| + |cr - 128| is below this count as white. */
   )
 );
 
@@ -60,6 +64,10 @@ public:
   FieldColors localFieldColorLower;
   FieldColorsUpper localFieldColorUpper;
 
+  /** Were the field colors of the last run already restored? They are smoothed from there on. */
+  bool warmStartedLower = false;
+  bool warmStartedUpper = false;
+
   DECLARE_DEBUG_IMAGE(FieldColor);
   DECLARE_DEBUG_IMAGE(FieldColorUpper);
 
@@ -68,8 +76,17 @@ private:
   void update(FieldColorsUpper& theFieldColorUpper);
 
   void execute(const bool& upper);
+  /** Samples a grid of pixels of an image area and builds the weighted cr histogram of the samples. */
   void buildSamples(const bool& upper, const Vector2i& lowerLeft, const Vector2i& upperRight, const int& sampleSize);
   void calcFieldColorFromSamples(const bool& upper, FieldColors::FieldColor& fieldColor);
+
+  /**
+   * Determines the brightness and white statistics of the field colors from the
+   * current samples, i.e. without another pass over the image.
+   * @param fieldColors The field colors the statistics are set in. The main field color
+   *                    of the previous frame defines which samples are bright.
+   */
+  void calcStatisticsFromSamples(FieldColors& fieldColors) const;
   void smoothFieldColors(const bool& upper);
 
   void draw(const bool& upper);
@@ -28,34 +28,34 @@ void TfliteInterpreterProvider::execute(tf::Subflow& subflow)
   this->executor = &subflow.executor();
 }
 
+void TfliteInterpreterProvider::update(TfliteInferenceSettings& tfliteInferenceSettings)
+{
+  tfliteInferenceSettings = inferenceSettings;
+}
+
+void TfliteInterpreterProvider::update(TfliteInferenceService& tfliteInferenceService)
+{
+  tfliteInferenceService.setup(*executor, inferenceSettings);
+}
+
 void TfliteInterpreterProvider::update(BallPerceptTfliteInterpreter& ballPerceptTfliteInterpreter)
 {
   ballPerceptTfliteInterpreter.loadModel(ballCNN);
 
   const auto buildInterpreter = [&](const tflite::FlatBufferModel& model, size_t index)
   {
-    // Build the interpreter
-    tflite::ops::builtin::BuiltinOpResolver resolver;
-    tflite::InterpreterBuilder builder(model, resolver);
-    std::unique_ptr<tflite::Interpreter> interpreter;
-    builder(&interpreter);
-    ASSERT(interpreter);
-
-    interpreter->SetNumThreads(1);
-
-    // Resize input tensors
-    int input_tensor = interpreter->inputs()[0];
-    TfLiteIntArray* input_dims = interpreter->tensor(input_tensor)->dims;
-    const int input_batch = 1;
-    const int input_height = input_dims->data[1];
-    const int input_width = input_dims->data[2];
-    const int input_channels = input_dims->data[3];
-    interpreter->ResizeInputTensor(input_tensor, {input_batch, input_height, input_width, input_channels});
-
-    // Allocate memory for the tensors
-    interpreter->AllocateTensors();
-
-    return interpreter;
+    return inferenceSettings.buildInterpreter(model, "ballCNN",
+        [](tflite::Interpreter& interpreter)
+        {
+          // Resize input tensors
+          int input_tensor = interpreter.inputs()[0];
+          TfLiteIntArray* input_dims = interpreter.tensor(input_tensor)->dims;
+          const int input_batch = 1;
+          const int input_height = input_dims->data[1];
+          const int input_width = input_dims->data[2];
+          const int input_channels = input_dims->data[3];
+          interpreter.ResizeInputTensor(input_tensor, {input_batch, input_height, input_width, input_channels});
+        });
   };
 
   ballPerceptTfliteInterpreter.updateInterpreters(*executor, buildInterpreter);
@@ -76,7 +76,7 @@ void TfliteInterpreterProvider::update(BallPerceptTfliteInterpreter& ballPercept
       unsigned char* input = interpreter.typed_tensor<unsigned char>(input_tensor);
       std::memcpy(input, &inferenceModeInput[0], (input_dims->data[0] * input_dims->data[1] * input_dims->data[2] * input_dims->data[3]) * sizeof(unsigned char));
 
-      if (interpreter.Invoke() != kTfLiteOk)
+      if (!TfliteInferenceSettings::invoke(interpreter, "tflite:ballCNN"))
       {
         OUTPUT_ERROR("Failed to invoke tflite!");
       }
@@ -104,37 +104,27 @@ void TfliteInterpreterProvider::update(SplittedTfliteInterpreter& splittedTflite
 
     const auto buildInterpreter = [&](const tflite::FlatBufferModel& model, size_t thread)
     {
-      // Build the interpreter
-      tflite::ops::builtin::BuiltinOpResolver resolver;
-      tflite::InterpreterBuilder builder(model, resolver);
-      std::unique_ptr<tflite::Interpreter> interpreter;
-      builder(&interpreter);
-      ASSERT(interpreter);
-
-      interpreter->SetNumThreads(1);
-
-      // Resize input tensors
-      int input_tensor = interpreter->inputs()[0];
-      TfLiteIntArray* input_dims = interpreter->tensor(input_tensor)->dims;
-      const int input_batch = 1;
-      const int input_height = input_dims->data[1];
-      const int input_width = input_dims->data[2];
-      const int input_channels = input_dims->data[3];
-      interpreter->ResizeInputTensor(input_tensor, {input_batch, input_height, input_width, input_channels});
-
-      if (i > 0)
-      {
-        const TfLiteTensor* prevOutputTensor = splittedTfliteInterpreter.layers[i - 1].getInterpreter(thread).output_tensor(0);
-        if (interpreter->SetCustomAllocationForTensor(input_tensor, {prevOutputTensor->data.raw, prevOutputTensor->bytes}) != kTfLiteOk)
-        {
-          OUTPUT_ERROR("Failed to set custom allocation for tensor!");
-        }
-      }
-
-      // Allocate memory for the tensors
-      interpreter->AllocateTensors();
-
-      return interpreter;
+      return inferenceSettings.buildInterpreter(model, "splittedBallCNN",
+          [&](tflite::Interpreter& interpreter)
+          {
+            // Resize input tensors
+            int input_tensor = interpreter.inputs()[0];
+            TfLiteIntArray* input_dims = interpreter.tensor(input_tensor)->dims;
+            const int input_batch = 1;
+            const int input_height = input_dims->data[1];
+            const int input_width = input_dims->data[2];
+            const int input_channels = input_dims->data[3];
+            interpreter.ResizeInputTensor(input_tensor, {input_batch, input_height, input_width, input_channels});
+
+            if (i > 0)
+            {
+              const TfLiteTensor* prevOutputTensor = splittedTfliteInterpreter.layers[i - 1].getInterpreter(thread).output_tensor(0);
+              if (interpreter.SetCustomAllocationForTensor(input_tensor, {prevOutputTensor->data.raw, prevOutputTensor->bytes}) != kTfLiteOk)
+              {
+                OUTPUT_ERROR("Failed to set custom allocation for tensor!");
+              }
+            }
+          });
     };
 
     auto& layer = splittedTfliteInterpreter.layers.at(i);
@@ -161,7 +151,7 @@ void TfliteInterpreterProvider::update(SplittedTfliteInterpreter& splittedTflite
         unsigned char* input = interpreter.typed_tensor<unsigned char>(input_tensor);
         std::memcpy(input, &inferenceModeInput[0], (input_dims->data[0] * input_dims->data[1] * input_dims->data[2] * input_dims->data[3]) * sizeof(unsigned char));
 
-        if (interpreter.Invoke() != kTfLiteOk)
+        if (!TfliteInferenceSettings::invoke(interpreter, "tflite:splittedBallCNN:earlyExit"))
         {
           OUTPUT_ERROR("Failed to invoke tflite!");
         }
@@ -173,7 +163,7 @@ void TfliteInterpreterProvider::update(SplittedTfliteInterpreter& splittedTflite
       {
         Stopwatch s2(WITH_PLOT("inferenceMode:splittedTfliteInterpreter:remaining"));
         auto& interpreter = splittedTfliteInterpreter.layers.at(1).getInterpreter();
-        if (interpreter.Invoke() != kTfLiteOk)
+        if (!TfliteInferenceSettings::invoke(interpreter, "tflite:splittedBallCNN:remaining"))
         {
           OUTPUT_ERROR("Failed to invoke tflite!");
         }
@@ -190,5 +180,41 @@ void TfliteInterpreterProvider::update(SplittedTfliteInterpreter& splittedTflite
   }
 }
 
+void TfliteInterpreterProvider::update(BatchedTfliteInterpreter& batchedTfliteInterpreter)
+{
+  batchedTfliteInterpreter.ballCNN.loadModel(ballCNN);
+  batchedTfliteInterpreter.ballCNN.updateInterpreters(*executor,
+      [this](const tflite::FlatBufferModel& model, size_t)
+      {
+        return buildInterpreter(model, "ballCNN");
+      });
+
+  if (batchedTfliteInterpreter.splittedBallCNN.size() != splittedBallCNN.size())
+    batchedTfliteInterpreter.splittedBallCNN.resize(splittedBallCNN.size());
+  for (size_t i = 0; i < splittedBallCNN.size(); i++)
+  {
+    ASSERT(!splittedBallCNN[i].empty());
+    auto& layer = batchedTfliteInterpreter.splittedBallCNN[i];
+    layer.loadModel(splittedBallCNN[i]);
+    layer.updateInterpreters(*executor,
+        [this](const tflite::FlatBufferModel& model, size_t)
+        {
+          return buildInterpreter(model, "splittedBallCNN");
+        });
+  }
+}
+
+std::unique_ptr<tflite::Interpreter> TfliteInterpreterProvider::buildInterpreter(const tflite::FlatBufferModel& model, const std::string& modelName) const
+{
+  // the batch size is set by the users of the interpreter
+  return inferenceSettings.buildInterpreter(model, modelName,
+      [](tflite::Interpreter& interpreter)
+      {
+        if (!TfliteInterpreter::setBatchSize(interpreter, 1))
+        {
+          OUTPUT_ERROR("Failed to allocate tflite tensors!");
+        }
+      });
+}
 
 MAKE_MODULE(TfliteInterpreterProvider, perception)
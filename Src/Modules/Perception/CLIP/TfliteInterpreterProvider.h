@@ -10,14 +10,18 @@
 
 #include "Tools/Module/Module.h"
 #include "Tools/Enum.h"
+#include "Representations/Perception/TfliteInferenceService.h"
 #include "Representations/Perception/TfliteInterpreter.h"
 #include <taskflow/taskflow.hpp>
 
 
 MODULE(TfliteInterpreterProvider,
   HAS_PREEXECUTION,
+  PROVIDES(TfliteInferenceSettings),
+  PROVIDES_WITHOUT_MODIFY(TfliteInferenceService),
   PROVIDES_WITHOUT_MODIFY(BallPerceptTfliteInterpreter),
   PROVIDES_WITHOUT_MODIFY(SplittedTfliteInterpreter),
+  PROVIDES_WITHOUT_MODIFY(BatchedTfliteInterpreter),
   LOADS_PARAMETERS(
     ENUM(InferenceMode,
       off,
@@ -26,7 +30,8 @@ MODULE(TfliteInterpreterProvider,
     );,
     (InferenceMode)(InferenceMode::randomNumbers) inferenceMode,
     (std::string)("") ballCNN,
-    (std::vector<std::string>) splittedBallCNN
+    (std::vector<std::string>) splittedBallCNN,
+    (TfliteInferenceSettings) inferenceSettings // The delegate, precision, and threads of all tflite models
   )
 );
 
@@ -37,12 +42,18 @@ public:
 
 private:
   void execute(tf::Subflow& subflow);
+  void update(TfliteInferenceSettings& tfliteInferenceSettings);
+  void update(TfliteInferenceService& tfliteInferenceService);
   void update(BallPerceptTfliteInterpreter& ballPerceptTfliteInterpreter);
   void update(SplittedTfliteInterpreter& splittedTfliteInterpreter);
+  void update(BatchedTfliteInterpreter& batchedTfliteInterpreter);
+
+  /** Builds an interpreter with a batch size of 1 that has its own input tensor. */
+  std::unique_ptr<tflite::Interpreter> buildInterpreter(const tflite::FlatBufferModel& model, const std::string& modelName) const;
 
   void setInferenceModeInput(InferenceMode inferenceMode);
 
-  const tf::Executor* executor;
+  tf::Executor* executor = nullptr;
 
   std::vector<unsigned char> inferenceModeInput;
 
@@ -17,9 +17,21 @@ CMCorrector::CMCorrector()
 
 void CMCorrector::execute(tf::Subflow&)
 {
+  // the optimization reads these in the background
+  if (!optimization.valid())
+  {
+    robotDimensions = theRobotDimensions;
+    cameraInfo = theCameraInfo;
+    cameraInfoUpper = theCameraInfoUpper;
+  }
+
   // register debug responses and drawings
   debug();
 
+  // finish optimizations that were requested by debug responses
+  if (optimization.valid() && cmCorrectorStatus.state != CMCorrectorStatus::CalibrationState::optimizeUpper && cmCorrectorStatus.state != CMCorrectorStatus::CalibrationState::optimizeLower)
+    optimize(optimizationUpper);
+
   if (!lastModuleConfig.has_value() && cmCorrectorStatus.state == CMCorrectorStatus::CalibrationState::inactive && theBehaviorData.behaviorState == BehaviorData::BehaviorState::calibrateCameraMatrix)
   {
     lastModuleConfig = ModuleManager::sendModuleRequest({{"MotionRequest", "CMCorrector"}, {"HeadAngleRequest", "CMCorrector"}});
@@ -105,7 +117,9 @@ void CMCorrector::execute(tf::Subflow&)
     }
     break;
   case CMCorrectorStatus::CalibrationState::optimizeUpper:
-    if (optimizeUpper())
+    if (const std::optional<bool> success = optimize(true); !success.has_value())
+      break;
+    else if (*success)
       if (cmCorrectorStatus.stage == 1)
         gotoState(CMCorrectorStatus::CalibrationState::positioning, 2);
       else
@@ -119,7 +133,9 @@ void CMCorrector::execute(tf::Subflow&)
       gotoState(CMCorrectorStatus::CalibrationState::positioning);
     break;
   case CMCorrectorStatus::CalibrationState::optimizeLower:
-    if (optimizeLower())
+    if (const std::optional<bool> success = optimize(false); !success.has_value())
+      break;
+    else if (*success)
     {
       save();
       gotoState(CMCorrectorStatus::CalibrationState::finished);
@@ -239,10 +255,44 @@ void CMCorrector::update(CMCorrectorStatus& cmCorrectorStatus)
   cmCorrectorStatus = this->cmCorrectorStatus;
 }
 
-bool CMCorrector::optimizeUpper()
+std::optional<bool> CMCorrector::optimize(bool upper)
 {
-  CameraCalibration calibration = localCalibration;
+  if (!optimization.valid())
+  {
+    optimizationUpper = upper;
+    optimization = std::async(std::launch::async,
+        [this, upper, samples = samples, calibration = localCalibration]
+        {
+          return upper ? optimizeUpper(samples, calibration) : optimizeLower(samples, calibration);
+        });
+    return {};
+  }
+  if (optimization.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return {};
+
+  const Optimization result = optimization.get();
+  OUTPUT_TEXT("CMCorrector: " << (optimizationUpper ? "Upper" : "Lower") << " camera optimization finished! (" << result.duration << "ms)");
+
+  printStatistics(samples, result.calibration);
+
+  const auto& errorLimits = cmCorrectorStatus.stage == 1 ? firstStageErrorLimits : secondStageErrorLimits;
+  if (result.bestError < errorLimits[optimizationUpper ? 0 : 1])
+  {
+    // apply new camera calibration if everything was successful
+    localCalibration = result.calibration;
+    annotateCalibration();
+    return true;
+  }
+  else
+  {
+    ANNOTATION("CMCorrector", "Calibration failed! Error=" << static_cast<Angle>(result.bestError));
+    OUTPUT_ERROR("CMCorrector: Calibration failed! Error=" << static_cast<Angle>(result.bestError));
+    return false;
+  }
+}
 
+CMCorrector::Optimization CMCorrector::optimizeUpper(const std::vector<Sample>& samples, CameraCalibration calibration) const
+{
   static constexpr int dim = 4;
   using VectorDa = Eigen::Matrix<Angle, dim, 1>;
 
@@ -253,10 +303,11 @@ bool CMCorrector::optimizeUpper()
   const auto upperCameraMatrixError = [&, &upperSamples = upperSamples](const VectorDa& input)
   {
     // set camera calibration based on input vector
-    calibration.bodyRotationCorrection = input.head<2>();
-    calibration.upperCameraRotationCorrection.head<2>() = input.tail<2>();
+    CameraCalibration cc = calibration;
+    cc.bodyRotationCorrection = input.head<2>();
+    cc.upperCameraRotationCorrection.head<2>() = input.tail<2>();
 
-    return calcError(upperSamples, calibration, true);
+    return calcError(upperSamples, cc, true);
   };
 
   const auto start = std::chrono::steady_clock::now();
@@ -265,34 +316,16 @@ bool CMCorrector::optimizeUpper()
       {VectorDa::Constant(6_deg), VectorDa::Constant(3_deg), VectorDa::Constant(1.5_deg), VectorDa::Constant(0.75_deg), VectorDa::Constant(0.375_deg), VectorDa::Constant(0.1875_deg), VectorDa::Constant(0.09375_deg), VectorDa::Constant(0.046875_deg)},
       upperCameraMatrixError);
   const auto end = std::chrono::steady_clock::now();
-  OUTPUT_TEXT("CMCorrector: Upper camera optimization finished! (" << static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()) << "ms)");
 
   // apply result to camera calibration
   calibration.bodyRotationCorrection = optim.head<2>();
   calibration.upperCameraRotationCorrection.head<2>() = optim.tail<2>();
 
-  printStatistics(samples, calibration);
-
-  const auto& errorLimits = cmCorrectorStatus.stage == 1 ? firstStageErrorLimits : secondStageErrorLimits;
-  if (bestError < errorLimits[0])
-  {
-    // apply new camera calibration if everything was successful
-    localCalibration = calibration;
-    annotateCalibration();
-    return true;
-  }
-  else
-  {
-    ANNOTATION("CMCorrector", "Calibration failed! Error=" << static_cast<Angle>(bestError));
-    OUTPUT_ERROR("CMCorrector: Calibration failed! Error=" << static_cast<Angle>(bestError));
-    return false;
-  }
+  return {calibration, bestError, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count())};
 }
 
-bool CMCorrector::optimizeLower()
+CMCorrector::Optimization CMCorrector::optimizeLower(const std::vector<Sample>& samples, CameraCalibration calibration) const
 {
-  CameraCalibration calibration = localCalibration;
-
   static constexpr int dim = 3;
   using VectorDa = Eigen::Matrix<Angle, dim, 1>;
 
@@ -300,9 +333,10 @@ bool CMCorrector::optimizeLower()
   const auto lowerCameraMatrixError = [&](const VectorDa& input)
   {
     // set camera calibration based on input vector
-    calibration.lowerCameraRotationCorrection = input;
+    CameraCalibration cc = calibration;
+    cc.lowerCameraRotationCorrection = input;
 
-    return calcError(samples, calibration, true);
+    return calcError(samples, cc, true);
   };
 
   const auto start = std::chrono::steady_clock::now();
@@ -311,27 +345,11 @@ bool CMCorrector::optimizeLower()
       {VectorDa::Constant(6_deg), VectorDa::Constant(3_deg), VectorDa::Constant(1.5_deg), VectorDa::Constant(0.75_deg), VectorDa::Constant(0.375_deg), VectorDa::Constant(0.1875_deg), VectorDa::Constant(0.09375_deg), VectorDa::Constant(0.046875_deg)},
       lowerCameraMatrixError);
   const auto end = std::chrono::steady_clock::now();
-  OUTPUT_TEXT("CMCorrector: Lower camera optimization finished! (" << static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()) << "ms)");
 
   // apply result to camera calibration
   calibration.lowerCameraRotationCorrection = optim;
 
-  printStatistics(samples, calibration);
-
-  const auto& errorLimits = cmCorrectorStatus.stage == 1 ? firstStageErrorLimits : secondStageErrorLimits;
-  if (bestError < errorLimits[1])
-  {
-    // apply new camera calibration if everything was successful
-    localCalibration = calibration;
-    annotateCalibration();
-    return true;
-  }
-  else
-  {
-    ANNOTATION("CMCorrector", "Calibration failed! Error=" << static_cast<Angle>(bestError));
-    OUTPUT_ERROR("CMCorrector: Calibration failed! Error=" << static_cast<Angle>(bestError));
-    return false;
-  }
+  return {calibration, bestError, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count())};
 }
 
 void CMCorrector::captureSamples()
@@ -392,7 +410,7 @@ size_t CMCorrector::countLines(const std::vector<Sample>& samples)
 
 CameraMatrix CMCorrector::getCameraMatrix(const CameraCalibration& cc, const TorsoMatrix& tm, const Vector2a& hp, bool upper) const
 {
-  const RobotCameraMatrix rm(theRobotDimensions, hp.x(), hp.y(), cc, upper);
+  const RobotCameraMatrix rm(robotDimensions, hp.x(), hp.y(), cc, upper);
   return {tm, rm, cc};
 }
 
@@ -416,7 +434,7 @@ std::vector<std::optional<Geometry::Line>> CMCorrector::transformSampleToRobot(c
   robotLines.reserve(sample.lines.size());
 
   const CameraMatrix cm = getCameraMatrix(cc, sample.torsoMatrix, sample.headPosition, sample.upper);
-  const CameraInfo& ci = sample.upper ? theCameraInfoUpper : theCameraInfo;
+  const CameraInfo& ci = sample.upper ? cameraInfoUpper : cameraInfo;
 
   std::transform(sample.lines.begin(),
       sample.lines.end(),
@@ -437,7 +455,7 @@ std::vector<std::optional<Geometry::Line>> CMCorrector::transformSampleToRobot(c
 
   CameraMatrix cm;
   cm.computeCameraMatrix(sample.torsoMatrix, torsoNeckMatrix, neckCameraMatrix, sample.headPosition.x(), sample.headPosition.y());
-  const CameraInfo& ci = sample.upper ? theCameraInfoUpper : theCameraInfo;
+  const CameraInfo& ci = sample.upper ? cameraInfoUpper : cameraInfo;
 
   std::transform(sample.lines.begin(),
       sample.lines.end(),
@@ -452,7 +470,7 @@ std::vector<std::optional<Geometry::Line>> CMCorrector::transformSampleToRobot(c
 
 std::vector<std::optional<Geometry::Line>> CMCorrector::transformSamplesToRobot(const std::vector<Sample>& samples, const CameraCalibration& cc) const
 {
-  const Pose3f torsoNeckMatrix = CameraMatrix::getTorsoNeckMatrix(theRobotDimensions, cc);
+  const Pose3f torsoNeckMatrix = CameraMatrix::getTorsoNeckMatrix(robotDimensions, cc);
   std::optional<Pose3f> neckCameraMatrixUpper, neckCameraMatrixLower;
 
   std::vector<std::vector<std::optional<Geometry::Line>>> robotLines;
@@ -462,9 +480,9 @@ std::vector<std::optional<Geometry::Line>> CMCorrector::transformSamplesToRobot(
       [&](const Sample& sample)
       {
         if (sample.upper && !neckCameraMatrixUpper.has_value())
-          neckCameraMatrixUpper = RobotCameraMatrix::getNeckCameraMatrix(theRobotDimensions, cc, true);
+          neckCameraMatrixUpper = RobotCameraMatrix::getNeckCameraMatrix(robotDimensions, cc, true);
         if (!sample.upper && !neckCameraMatrixLower.has_value())
-          neckCameraMatrixLower = RobotCameraMatrix::getNeckCameraMatrix(theRobotDimensions, cc, false);
+          neckCameraMatrixLower = RobotCameraMatrix::getNeckCameraMatrix(robotDimensions, cc, false);
 
         return transformSampleToRobot(sample, torsoNeckMatrix, sample.upper ? *neckCameraMatrixUpper : *neckCameraMatrixLower);
         //return transformSampleToRobot(sample, cc);
@@ -611,7 +629,7 @@ std::pair<Eigen::Matrix<T, dim, 1>, float> CMCorrector::optimizeFunction(
 
   for (const Vector& stepSize : stepSizes)
   {
-    std::tie(bestInput, bestError) = optimizeFunction<T, dim>(stepMin, stepMax, stepSize, func);
+    std::tie(bestInput, bestError) = optimizeFunction<T, dim>(stepMin, stepMax, stepSize, func, true);
 
     stepMin = bestInput - stepSize;
     stepMax = bestInput + stepSize;
@@ -621,18 +639,17 @@ std::pair<Eigen::Matrix<T, dim, 1>, float> CMCorrector::optimizeFunction(
 }
 
 template <typename T, int dim>
-std::pair<Eigen::Matrix<T, dim, 1>, float> CMCorrector::optimizeFunction(
-    const Eigen::Matrix<T, dim, 1>& min, const Eigen::Matrix<T, dim, 1>& max, const Eigen::Matrix<T, dim, 1>& stepSize, std::function<float(const Eigen::Matrix<T, dim, 1>&)> func)
+std::pair<Eigen::Matrix<T, dim, 1>, float> CMCorrector::optimizeFunction(const Eigen::Matrix<T, dim, 1>& min,
+    const Eigen::Matrix<T, dim, 1>& max,
+    const Eigen::Matrix<T, dim, 1>& stepSize,
+    std::function<float(const Eigen::Matrix<T, dim, 1>&)> func,
+    bool parallel)
 {
   using Vector = Eigen::Matrix<T, dim, 1>;
   using NewVector = Eigen::Matrix<T, dim - 1, 1>;
 
-  float bestError = std::numeric_limits<float>::infinity();
-  Vector bestInput = Vector::Constant(std::numeric_limits<T>::signaling_NaN());
-  float retError = bestError;
-  NewVector retInput = NewVector::Constant(std::numeric_limits<T>::signaling_NaN());
-
-  for (Vector input = min; input[0] <= max[0]; input[0] += stepSize[0])
+  // finds the best values of the other dimensions for the value of the first one
+  const auto search = [&](Vector input) -> std::pair<Vector, float>
   {
     if constexpr (dim > 1)
     {
@@ -641,20 +658,36 @@ std::pair<Eigen::Matrix<T, dim, 1>, float> CMCorrector::optimizeFunction(
         input.template tail<dim - 1>() = val;
         return func(input);
       };
-      std::tie(retInput, retError) = optimizeFunction<T, dim - 1>(min.template tail<dim - 1>(), max.template tail<dim - 1>(), stepSize.template tail<dim - 1>(), newFunc);
+      const auto [retInput, retError] = optimizeFunction<T, dim - 1>(min.template tail<dim - 1>(), max.template tail<dim - 1>(), stepSize.template tail<dim - 1>(), newFunc);
+      input.template tail<dim - 1>() = retInput;
+      return {input, retError};
     }
     else
-    {
-      retError = func(input);
-    }
+      return {input, func(input)};
+  };
 
-    if (retError < bestError)
+  std::vector<std::pair<Vector, float>> results;
+  if (parallel)
+  {
+    std::vector<std::future<std::pair<Vector, float>>> futures;
+    for (Vector input = min; input[0] <= max[0]; input[0] += stepSize[0])
+      futures.emplace_back(std::async(std::launch::async, search, input));
+    for (std::future<std::pair<Vector, float>>& future : futures)
+      results.emplace_back(future.get());
+  }
+  else
+    for (Vector input = min; input[0] <= max[0]; input[0] += stepSize[0])
+      results.emplace_back(search(input));
+
+  // the first of several equally good results is used, no matter whether they were searched in parallel
+  float bestError = std::numeric_limits<float>::infinity();
+  Vector bestInput = Vector::Constant(std::numeric_limits<T>::signaling_NaN());
+  for (const auto& [input, error] : results)
+    if (error < bestError)
     {
-      bestInput[0] = input[0];
-      bestInput.template tail<dim - 1>() = retInput;
-      bestError = retError;
+      bestInput = input;
+      bestError = error;
     }
-  }
 
   return {bestInput, bestError};
 }
@@ -664,6 +697,7 @@ std::pair<Eigen::Matrix<T, dim, 1>, float> CMCorrector::optimizeFunction(
  */
 void CMCorrector::start()
 {
+  optimization = {}; // waits for an optimization of the last calibration and drops its result
   startTimestamp = theFrameInfo.time;
   gotoState(CMCorrectorStatus::CalibrationState::wait, 1);
   samples.clear();
@@ -836,9 +870,9 @@ void CMCorrector::debug()
   }
 
   DEBUG_RESPONSE_ONCE("module:CMCorrector:optimizeUpper")
-  optimizeUpper();
+  optimize(true);
   DEBUG_RESPONSE_ONCE("module:CMCorrector:optimizeLower")
-  optimizeLower();
+  optimize(false);
 
   DEBUG_RESPONSE_ONCE("module:CMCorrector:start") start();
   DEBUG_RESPONSE_ONCE("module:CMCorrector:stop") stop();
@@ -22,6 +22,7 @@
 
 #include "Tools/Module/ModuleManager.h"
 
+#include <future>
 #include <optional>
 #include <tuple>
 
@@ -74,14 +75,29 @@ private:
     const bool upper;
   };
 
+  /** The result of optimizing the calibration of a camera. */
+  struct Optimization
+  {
+    CameraCalibration calibration;
+    float bestError;
+    int64_t duration; // in ms
+  };
+
   void execute(tf::Subflow&);
   void update(CameraCalibration& cameraCalibration);
   void update(HeadAngleRequest& headControlRequest);
   void update(MotionRequest& motionRequest);
   void update(CMCorrectorStatus& cmCorrectorStatus);
 
-  bool optimizeUpper();
-  bool optimizeLower();
+  /**
+   * Optimizes the calibration of a camera in the background, so that frames are not delayed.
+   * The first call starts the optimization, the following ones poll for its result.
+   * @param upper Optimize the upper camera and the body rotation instead of the lower camera?
+   * @return Nothing while the optimization is running, afterwards whether it was successful.
+   */
+  std::optional<bool> optimize(bool upper);
+  Optimization optimizeUpper(const std::vector<Sample>& samples, CameraCalibration calibration) const;
+  Optimization optimizeLower(const std::vector<Sample>& samples, CameraCalibration calibration) const;
 
   void captureSamples();
   std::optional<Sample> captureSample(bool upper) const;
@@ -107,8 +123,11 @@ private:
   std::pair<Eigen::Matrix<T, dim, 1>, float> optimizeFunction(
       const Eigen::Matrix<T, dim, 1>& min, const Eigen::Matrix<T, dim, 1>& max, const std::vector<Eigen::Matrix<T, dim, 1>>& stepSizes, std::function<float(const Eigen::Matrix<T, dim, 1>&)> func);
   template <typename T, int dim>
-  std::pair<Eigen::Matrix<T, dim, 1>, float> optimizeFunction(
-      const Eigen::Matrix<T, dim, 1>& min, const Eigen::Matrix<T, dim, 1>& max, const Eigen::Matrix<T, dim, 1>& stepSize, std::function<float(const Eigen::Matrix<T, dim, 1>&)> func);
+  std::pair<Eigen::Matrix<T, dim, 1>, float> optimizeFunction(const Eigen::Matrix<T, dim, 1>& min,
+      const Eigen::Matrix<T, dim, 1>& max,
+      const Eigen::Matrix<T, dim, 1>& stepSize,
+      std::function<float(const Eigen::Matrix<T, dim, 1>&)> func,
+      bool parallel = false); // parallel: search each value of the first dimension in a thread of its own, func must be thread-safe
 
   void start();
   void gotoState(CMCorrectorStatus::CalibrationState state, unsigned char stage = 0);
@@ -135,4 +154,12 @@ private:
   std::optional<ModuleManager::Configuration> lastModuleConfig;
 
   CameraCalibration localCalibration;
+
+  std::future<Optimization> optimization; // the optimization running in the background
+  bool optimizationUpper = false; // is the upper camera optimized?
+
+  // copies of the representations used by the optimization, not updated while it runs
+  RobotDimensions robotDimensions;
+  CameraInfo cameraInfo;
+  CameraInfo cameraInfoUpper;
 };
@@ -0,0 +1,177 @@
+/**
+ * @file CNNKernels.h
+ *
+ * Vectorized kernels for the convolution layers of the generated CNNs in this
+ * directory. They use SSE through Tools/SIMD.h, i.e. NEON via sse2neon on ARM.
+ *
+ * The generated code accumulates every product in memory. The kernels instead keep
+ * the accumulators of up to maxAccumulators vectors of output channels of a pixel in
+ * registers and can add the bias and apply the leaky ReLU of the following layers
+ * before the pixel is stored, which saves two passes over the output. The products
+ * are summed in the same order as in the generated code, so the results are the same.
+ *
+ * All tensors are stored as height x width x channels. The weights of a convolution
+ * are stored as KH x KW x C_IN x C_OUT and those of a depthwise convolution as
+ * KH x KW x C_IN x DEPTH_MULTIPLIER.
+ */
+
+#pragma once
+
+#include "Tools/SIMD.h"
+#include <algorithm>
+
+namespace CNNKernels
+{
+  /** The maximum number of vectors of four output channels accumulated at once. */
+  constexpr int maxAccumulators = 12;
+
+  /** The maximum number of vectors of four output channels of a pixel accumulated at once. */
+  constexpr int maxAccumulatorsPerPixel = 8;
+
+  /**
+   * Adds the bias to the accumulators, applies the leaky ReLU, and stores them.
+   * @param out The first channel stored of the first pixel.
+   * @param C_OUT The number of channels of a pixel of the output.
+   * @param bias The bias of the channels stored or nullptr.
+   * @param leakyReLUAlpha The slope of the leaky ReLU for negative values. 1 skips the activation.
+   */
+  template<int C_OUT, int PIXELS, int COUNT> inline void store(__m128 (&acc)[PIXELS][COUNT], float* out, const float* bias, float leakyReLUAlpha)
+  {
+    if (bias)
+      for (int i = 0; i < COUNT; ++i)
+      {
+        const __m128 b = _mm_loadu_ps(bias + 4 * i);
+        for (int p = 0; p < PIXELS; ++p)
+          acc[p][i] = _mm_add_ps(acc[p][i], b);
+      }
+    if (leakyReLUAlpha != 1.f)
+    {
+      const __m128 alpha = _mm_set1_ps(leakyReLUAlpha);
+      for (int p = 0; p < PIXELS; ++p)
+        for (int i = 0; i < COUNT; ++i)
+          acc[p][i] = _mm_max_ps(acc[p][i], _mm_mul_ps(acc[p][i], alpha));
+    }
+    for (int p = 0; p < PIXELS; ++p)
+      for (int i = 0; i < COUNT; ++i)
+        _mm_storeu_ps(out + p * C_OUT + 4 * i, acc[p][i]);
+  }
+
+  /** Computes the output channels [FIRST, FIRST + 4 * COUNT) of PIXELS neighboring pixels in a row of a convolution. */
+  template<int KH, int KW, int SW, int C_IN, int C_OUT, int PIXELS, int FIRST, int COUNT>
+  inline void convolutionBlock(const float* in, int W, float* out, const float* weights, const float* bias, float leakyReLUAlpha)
+  {
+    __m128 acc[PIXELS][COUNT];
+    for (int p = 0; p < PIXELS; ++p)
+      for (int i = 0; i < COUNT; ++i)
+        acc[p][i] = _mm_setzero_ps();
+    for (int iw = 0; iw < KH; ++iw)
+      for (int jw = 0; jw < KW; ++jw)
+      {
+        const float* x = in + (iw * W + jw) * C_IN;
+        const float* w = weights + (iw * KW + jw) * C_IN * C_OUT + FIRST;
+        for (int c = 0; c < C_IN; ++c, w += C_OUT)
+        {
+          __m128 xc[PIXELS];
+          for (int p = 0; p < PIXELS; ++p)
+            xc[p] = _mm_set1_ps(x[p * SW * C_IN + c]);
+          for (int i = 0; i < COUNT; ++i)
+          {
+            const __m128 wi = _mm_loadu_ps(w + 4 * i);
+            for (int p = 0; p < PIXELS; ++p)
+              acc[p][i] = _mm_add_ps(acc[p][i], _mm_mul_ps(xc[p], wi));
+          }
+        }
+      }
+    store<C_OUT>(acc, out + FIRST, bias ? bias + FIRST : nullptr, leakyReLUAlpha);
+  }
+
+  template<int KH, int KW, int SW, int C_IN, int C_OUT, int PIXELS, int FIRST = 0>
+  inline void convolutionPixels(const float* in, int W, float* out, const float* weights, const float* bias, float leakyReLUAlpha)
+  {
+    constexpr int count = std::min((C_OUT - FIRST) / 4, maxAccumulatorsPerPixel);
+    convolutionBlock<KH, KW, SW, C_IN, C_OUT, PIXELS, FIRST, count>(in, W, out, weights, bias, leakyReLUAlpha);
+    if constexpr (FIRST + 4 * count < C_OUT)
+      convolutionPixels<KH, KW, SW, C_IN, C_OUT, PIXELS, FIRST + 4 * count>(in, W, out, weights, bias, leakyReLUAlpha);
+  }
+
+  /**
+   * A convolution without padding, optionally followed by a bias and a leaky ReLU.
+   * @param in The input of width W. Its height must fit the output.
+   * @param out The output of size H_OUT x W_OUT. It is overwritten.
+   * @param bias The bias of each output channel or nullptr.
+   * @param leakyReLUAlpha The slope of the leaky ReLU for negative values. 1 skips the activation.
+   */
+  template<int KH, int KW, int SH, int SW, int C_IN, int C_OUT>
+  void convolution(const float* in, int W, float* out, int H_OUT, int W_OUT, const float* weights, const float* bias = nullptr, float leakyReLUAlpha = 1.f)
+  {
+    static_assert(C_OUT % 4 == 0, "The number of output channels must be a multiple of 4");
+    // neighboring pixels share the loads of the weights if there are only few output channels
+    constexpr int pixels = std::max(1, maxAccumulators / std::min(C_OUT / 4, maxAccumulatorsPerPixel));
+    for (int h = 0; h < H_OUT; ++h)
+    {
+      const float* row = in + h * SH * W * C_IN;
+      int w = 0;
+      for (; w + pixels <= W_OUT; w += pixels, out += pixels * C_OUT)
+        convolutionPixels<KH, KW, SW, C_IN, C_OUT, pixels>(row + w * SW * C_IN, W, out, weights, bias, leakyReLUAlpha);
+      for (; w < W_OUT; ++w, out += C_OUT)
+        convolutionPixels<KH, KW, SW, C_IN, C_OUT, 1>(row + w * SW * C_IN, W, out, weights, bias, leakyReLUAlpha);
+    }
+  }
+
+  /** Computes the output channels [FIRST, FIRST + 4 * COUNT) of PIXELS neighboring pixels in a row of a depthwise convolution with a depth multiplier of 4. */
+  template<int KH, int KW, int SW, int C_IN, int PIXELS, int FIRST, int COUNT>
+  inline void depthwiseConvolutionBlock(const float* in, int W, float* out, const float* weights, const float* bias, float leakyReLUAlpha)
+  {
+    constexpr int C_OUT = C_IN * 4;
+    __m128 acc[PIXELS][COUNT];
+    for (int p = 0; p < PIXELS; ++p)
+      for (int i = 0; i < COUNT; ++i)
+        acc[p][i] = _mm_setzero_ps();
+    for (int iw = 0; iw < KH; ++iw)
+      for (int jw = 0; jw < KW; ++jw)
+      {
+        const float* x = in + (iw * W + jw) * C_IN + FIRST / 4;
+        const float* w = weights + (iw * KW + jw) * C_OUT + FIRST;
+        for (int i = 0; i < COUNT; ++i)
+        {
+          const __m128 wi = _mm_loadu_ps(w + 4 * i);
+          for (int p = 0; p < PIXELS; ++p)
+            acc[p][i] = _mm_add_ps(acc[p][i], _mm_mul_ps(_mm_set1_ps(x[p * SW * C_IN + i]), wi));
+        }
+      }
+    store<C_OUT>(acc, out + FIRST, bias ? bias + FIRST : nullptr, leakyReLUAlpha);
+  }
+
+  template<int KH, int KW, int SW, int C_IN, int PIXELS, int FIRST = 0>
+  inline void depthwiseConvolutionPixels(const float* in, int W, float* out, const float* weights, const float* bias, float leakyReLUAlpha)
+  {
+    constexpr int count = std::min((C_IN * 4 - FIRST) / 4, maxAccumulatorsPerPixel);
+    depthwiseConvolutionBlock<KH, KW, SW, C_IN, PIXELS, FIRST, count>(in, W, out, weights, bias, leakyReLUAlpha);
+    if constexpr (FIRST + 4 * count < C_IN * 4)
+      depthwiseConvolutionPixels<KH, KW, SW, C_IN, PIXELS, FIRST + 4 * count>(in, W, out, weights, bias, leakyReLUAlpha);
+  }
+
+  /**
+   * A depthwise convolution without padding, optionally followed by a bias and a leaky ReLU.
+   * @param in The input of width W. Its height must fit the output.
+   * @param out The output of size H_OUT x W_OUT with DEPTH_MULTIPLIER * C_IN channels. It is overwritten.
+   * @param bias The bias of each output channel or nullptr.
+   * @param leakyReLUAlpha The slope of the leaky ReLU for negative values. 1 skips the activation.
+   */
+  template<int KH, int KW, int SH, int SW, int C_IN, int DEPTH_MULTIPLIER>
+  void depthwiseConvolution(const float* in, int W, float* out, int H_OUT, int W_OUT, const float* weights, const float* bias = nullptr, float leakyReLUAlpha = 1.f)
+  {
+    static_assert(DEPTH_MULTIPLIER == 4, "Only a depth multiplier of 4 is supported");
+    constexpr int C_OUT = C_IN * DEPTH_MULTIPLIER;
+    constexpr int pixels = std::max(1, maxAccumulators / std::min(C_IN, maxAccumulatorsPerPixel));
+    for (int h = 0; h < H_OUT; ++h)
+    {
+      const float* row = in + h * SH * W * C_IN;
+      int w = 0;
+      for (; w + pixels <= W_OUT; w += pixels, out += pixels * C_OUT)
+        depthwiseConvolutionPixels<KH, KW, SW, C_IN, pixels>(row + w * SW * C_IN, W, out, weights, bias, leakyReLUAlpha);
+      for (; w < W_OUT; ++w, out += C_OUT)
+        depthwiseConvolutionPixels<KH, KW, SW, C_IN, 1>(row + w * SW * C_IN, W, out, weights, bias, leakyReLUAlpha);
+    }
+  }
+} // namespace CNNKernels
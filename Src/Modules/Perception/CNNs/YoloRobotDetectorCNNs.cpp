@@ -1,6 +1,7 @@
 // includes
 #include "Tools/SIMD.h"
 #include "YoloRobotDetectorCNNs.h"
+#include "CNNKernels.h"
 
 #include <emmintrin.h>
 #include <math.h>
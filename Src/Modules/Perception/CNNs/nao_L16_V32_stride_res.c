@@ -1687,232 +1687,34 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpDepthwiseConvolution2D (separable_conv2d_internal_1)")
   {
-    memset(buffer + 0, 0, 14400 * sizeof(float));
     // OpDepthwiseConvolution2D
-    const int H = 61; const int W = 81; const int C_IN = 3; const int C_OUT = 12; const int W_OUT = 40;
+    const int W = 81; const int C_IN = 3; const int H_OUT = 30; const int W_OUT = 40;
     const int SH = 2; const int SW = 2;
     const int KH = 3; const int KW = 3;
     const int DEPTH_MULTIPLIER = 4;
     const float* in_ = (buffer + 14400); float* out_ = (buffer + 0); const float* weights_ = separable_conv2d_internal_1_W;
     
-    for (int ix = 0; ix < H - KH + 1; ix += SH)
-    {
-        int x_out_1 = ix / SH;
-        for (int jx = 0; jx < W - KW + 1; jx += SW)
-        {
-            int x_out_2 = jx / SW;
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    // TODO fix constraints on depth multiplier (loading of x_in)
-                    int c_increment = DEPTH_MULTIPLIER % 4 == 0 ? 1 : 4 / DEPTH_MULTIPLIER;
-                    int m_increment = 4 / c_increment;
-                    for (int c = 0; c < C_IN; c += c_increment)
-                    {
-                        __m128 x_in;
-                        if (c_increment == 1)
-                        {
-                            x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        else if (c_increment == 2)
-                        {
-                            float x0 = in_[LINEAR_3(x_1, x_2, c, W, C_IN)];
-                            float x1 = in_[LINEAR_3(x_1, x_2, c+1, W, C_IN)];
-                            x_in = _mm_setr_ps(x0, x0, x1, x1);
-                        }
-                        else if (c_increment == 4)
-                        {
-                            x_in = _mm_load_ps(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        for (int m = 0; m < DEPTH_MULTIPLIER; m += m_increment)
-                        {
-                            int c_out = c * DEPTH_MULTIPLIER + m;
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, c, m, KW, C_IN, DEPTH_MULTIPLIER)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)], x_out);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    CNNKernels::depthwiseConvolution<KH, KW, SH, SW, C_IN, DEPTH_MULTIPLIER>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
-  INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_internal_2)")
+  INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_internal_2) + OpArithmetic<ADD> (batch_normalization) + OpLeakyReLU (leaky_re_lu)")
   {
-    memset(buffer + 19200, 0, 19200 * sizeof(float));
     // OpConvolution2D
     const int W = 40; const int C_IN = 12; const int C_OUT = 16; const int H_OUT = 30; const int W_OUT = 40;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 0); float* out_ = (buffer + 19200); const float* weights_ = separable_conv2d_internal_2_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization)")
-  {
-    // OpArithmetic<ADD>
-    const int H = 30; const int W = 40; const int C = 16;
-    const float* in_ = (buffer + 19200); float* out_ = (buffer + 0);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    element = _mm_add_ps(element, _mm_load_ps(&batch_normalization_A[c]));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpLeakyReLU (leaky_re_lu)")
-  {
-    // OpLeakyReLU
-    const int H = 30; const int W = 40; const int C = 16;
-    const float* in_ = (buffer + 0); float* out_ = (buffer + 19200);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    __m128 alpha = _mm_set1_ps(0.10000000149011612f);
-                    element = _mm_max_ps(element, _mm_mul_ps(element, alpha));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_, batch_normalization_A, 0.10000000149011612f);
   }
-  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_internal_1)")
+  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_internal_1) + OpArithmetic<ADD> (batch_normalization_1) + OpLeakyReLU (leaky_re_lu_1)")
   {
-    memset(buffer + 0, 0, 4800 * sizeof(float));
     // OpConvolution2D
     const int W = 40; const int C_IN = 16; const int C_OUT = 4; const int H_OUT = 30; const int W_OUT = 40;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 19200); float* out_ = (buffer + 0); const float* weights_ = conv2d_internal_1_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_1)")
-  {
-    // OpArithmetic<ADD>
-    const int H = 30; const int W = 40; const int C = 4;
-    const float* in_ = (buffer + 0); float* out_ = (buffer + 4800);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    element = _mm_add_ps(element, _mm_load_ps(&batch_normalization_1_A[c]));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpLeakyReLU (leaky_re_lu_1)")
-  {
-    // OpLeakyReLU
-    const int H = 30; const int W = 40; const int C = 4;
-    const float* in_ = (buffer + 4800); float* out_ = (buffer + 0);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    __m128 alpha = _mm_set1_ps(0.10000000149011612f);
-                    element = _mm_max_ps(element, _mm_mul_ps(element, alpha));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_, batch_normalization_1_A, 0.10000000149011612f);
   }
   INTERNAL_CNN_STOPWATCH("OpPadding (separable_conv2d_1_internal_0)")
   {
@@ -1939,123 +1741,24 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpDepthwiseConvolution2D (separable_conv2d_1_internal_1)")
   {
-    memset(buffer + 0, 0, 4800 * sizeof(float));
     // OpDepthwiseConvolution2D
-    const int H = 31; const int W = 41; const int C_IN = 4; const int C_OUT = 16; const int W_OUT = 20;
+    const int W = 41; const int C_IN = 4; const int H_OUT = 15; const int W_OUT = 20;
     const int SH = 2; const int SW = 2;
     const int KH = 3; const int KW = 3;
     const int DEPTH_MULTIPLIER = 4;
     const float* in_ = (buffer + 4800); float* out_ = (buffer + 0); const float* weights_ = separable_conv2d_1_internal_1_W;
     
-    for (int ix = 0; ix < H - KH + 1; ix += SH)
-    {
-        int x_out_1 = ix / SH;
-        for (int jx = 0; jx < W - KW + 1; jx += SW)
-        {
-            int x_out_2 = jx / SW;
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    // TODO fix constraints on depth multiplier (loading of x_in)
-                    int c_increment = DEPTH_MULTIPLIER % 4 == 0 ? 1 : 4 / DEPTH_MULTIPLIER;
-                    int m_increment = 4 / c_increment;
-                    for (int c = 0; c < C_IN; c += c_increment)
-                    {
-                        __m128 x_in;
-                        if (c_increment == 1)
-                        {
-                            x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        else if (c_increment == 2)
-                        {
-                            float x0 = in_[LINEAR_3(x_1, x_2, c, W, C_IN)];
-                            float x1 = in_[LINEAR_3(x_1, x_2, c+1, W, C_IN)];
-                            x_in = _mm_setr_ps(x0, x0, x1, x1);
-                        }
-                        else if (c_increment == 4)
-                        {
-                            x_in = _mm_load_ps(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        for (int m = 0; m < DEPTH_MULTIPLIER; m += m_increment)
-                        {
-                            int c_out = c * DEPTH_MULTIPLIER + m;
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, c, m, KW, C_IN, DEPTH_MULTIPLIER)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)], x_out);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    CNNKernels::depthwiseConvolution<KH, KW, SH, SW, C_IN, DEPTH_MULTIPLIER>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
-  INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_1_internal_2)")
+  INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_1_internal_2) + OpArithmetic<ADD> (batch_normalization_2)")
   {
-    memset(buffer + 14416, 0, 7200 * sizeof(float));
     // OpConvolution2D
     const int W = 20; const int C_IN = 16; const int C_OUT = 24; const int H_OUT = 15; const int W_OUT = 20;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
-    const float* in_ = (buffer + 0); float* out_ = (buffer + 14416); const float* weights_ = separable_conv2d_1_internal_2_W;
+    const float* in_ = (buffer + 0); float* out_ = (buffer + 7216); const float* weights_ = separable_conv2d_1_internal_2_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_2)")
-  {
-    // OpArithmetic<ADD>
-    const int H = 15; const int W = 20; const int C = 24;
-    const float* in_ = (buffer + 14416); float* out_ = (buffer + 7216);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    element = _mm_add_ps(element, _mm_load_ps(&batch_normalization_2_A[c]));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_, batch_normalization_2_A);
   }
   INTERNAL_CNN_STOPWATCH("OpLeakyReLU (leaky_re_lu_2)")
   {
@@ -2080,91 +1783,15 @@ void cnn(float *in_0, float *out_0)
         }
     }
   }
-  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_1_internal_1)")
+  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_1_internal_1) + OpArithmetic<ADD> (batch_normalization_3) + OpLeakyReLU (leaky_re_lu_3)")
   {
-    memset(buffer + 7200, 0, 2400 * sizeof(float));
     // OpConvolution2D
     const int W = 20; const int C_IN = 24; const int C_OUT = 8; const int H_OUT = 15; const int W_OUT = 20;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
-    const float* in_ = (buffer + 0); float* out_ = (buffer + 7200); const float* weights_ = conv2d_1_internal_1_W;
-    
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_3)")
-  {
-    // OpArithmetic<ADD>
-    const int H = 15; const int W = 20; const int C = 8;
-    const float* in_ = (buffer + 7200); float* out_ = (buffer + 0);
+    const float* in_ = (buffer + 0); float* out_ = (buffer + 22192); const float* weights_ = conv2d_1_internal_1_W;
     
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    element = _mm_add_ps(element, _mm_load_ps(&batch_normalization_3_A[c]));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpLeakyReLU (leaky_re_lu_3)")
-  {
-    // OpLeakyReLU
-    const int H = 15; const int W = 20; const int C = 8;
-    const float* in_ = (buffer + 0); float* out_ = (buffer + 22192);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    __m128 alpha = _mm_set1_ps(0.10000000149011612f);
-                    element = _mm_max_ps(element, _mm_mul_ps(element, alpha));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_, batch_normalization_3_A, 0.10000000149011612f);
   }
   INTERNAL_CNN_STOPWATCH("OpPadding (separable_conv2d_2_internal_0)")
   {
@@ -2191,101 +1818,24 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpDepthwiseConvolution2D (separable_conv2d_2_internal_1)")
   {
-    memset(buffer + 2992, 0, 9600 * sizeof(float));
     // OpDepthwiseConvolution2D
-    const int H = 17; const int W = 22; const int C_IN = 8; const int C_OUT = 32; const int W_OUT = 20;
+    const int W = 22; const int C_IN = 8; const int H_OUT = 15; const int W_OUT = 20;
     const int SH = 1; const int SW = 1;
     const int KH = 3; const int KW = 3;
     const int DEPTH_MULTIPLIER = 4;
     const float* in_ = (buffer + 0); float* out_ = (buffer + 2992); const float* weights_ = separable_conv2d_2_internal_1_W;
     
-    for (int ix = 0; ix < H - KH + 1; ix += SH)
-    {
-        int x_out_1 = ix / SH;
-        for (int jx = 0; jx < W - KW + 1; jx += SW)
-        {
-            int x_out_2 = jx / SW;
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    // TODO fix constraints on depth multiplier (loading of x_in)
-                    int c_increment = DEPTH_MULTIPLIER % 4 == 0 ? 1 : 4 / DEPTH_MULTIPLIER;
-                    int m_increment = 4 / c_increment;
-                    for (int c = 0; c < C_IN; c += c_increment)
-                    {
-                        __m128 x_in;
-                        if (c_increment == 1)
-                        {
-                            x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        else if (c_increment == 2)
-                        {
-                            float x0 = in_[LINEAR_3(x_1, x_2, c, W, C_IN)];
-                            float x1 = in_[LINEAR_3(x_1, x_2, c+1, W, C_IN)];
-                            x_in = _mm_setr_ps(x0, x0, x1, x1);
-                        }
-                        else if (c_increment == 4)
-                        {
-                            x_in = _mm_load_ps(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        for (int m = 0; m < DEPTH_MULTIPLIER; m += m_increment)
-                        {
-                            int c_out = c * DEPTH_MULTIPLIER + m;
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, c, m, KW, C_IN, DEPTH_MULTIPLIER)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)], x_out);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    CNNKernels::depthwiseConvolution<KH, KW, SH, SW, C_IN, DEPTH_MULTIPLIER>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_2_internal_2)")
   {
-    memset(buffer + 12592, 0, 9600 * sizeof(float));
     // OpConvolution2D
     const int W = 20; const int C_IN = 32; const int C_OUT = 32; const int H_OUT = 15; const int W_OUT = 20;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 2992); float* out_ = (buffer + 12592); const float* weights_ = separable_conv2d_2_internal_2_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_4)")
   {
@@ -2332,68 +1882,15 @@ void cnn(float *in_0, float *out_0)
         }
     }
   }
-  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_2_internal_1)")
+  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_2_internal_1) + OpArithmetic<ADD> (batch_normalization_5)")
   {
-    memset(buffer + 2448, 0, 2400 * sizeof(float));
     // OpConvolution2D
     const int W = 20; const int C_IN = 32; const int C_OUT = 8; const int H_OUT = 15; const int W_OUT = 20;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
-    const float* in_ = (buffer + 9904); float* out_ = (buffer + 2448); const float* weights_ = conv2d_2_internal_1_W;
+    const float* in_ = (buffer + 9904); float* out_ = (buffer + 48); const float* weights_ = conv2d_2_internal_1_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_5)")
-  {
-    // OpArithmetic<ADD>
-    const int H = 15; const int W = 20; const int C = 8;
-    const float* in_ = (buffer + 2448); float* out_ = (buffer + 48);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    element = _mm_add_ps(element, _mm_load_ps(&batch_normalization_5_A[c]));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_, batch_normalization_5_A);
   }
   INTERNAL_CNN_STOPWATCH("OpMerge<ADD> (add)")
   {
@@ -2458,101 +1955,24 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpDepthwiseConvolution2D (separable_conv2d_3_internal_1)")
   {
-    memset(buffer + 0, 0, 2560 * sizeof(float));
     // OpDepthwiseConvolution2D
-    const int H = 17; const int W = 21; const int C_IN = 8; const int C_OUT = 32; const int W_OUT = 10;
+    const int W = 21; const int C_IN = 8; const int H_OUT = 8; const int W_OUT = 10;
     const int SH = 2; const int SW = 2;
     const int KH = 3; const int KW = 3;
     const int DEPTH_MULTIPLIER = 4;
     const float* in_ = (buffer + 2560); float* out_ = (buffer + 0); const float* weights_ = separable_conv2d_3_internal_1_W;
     
-    for (int ix = 0; ix < H - KH + 1; ix += SH)
-    {
-        int x_out_1 = ix / SH;
-        for (int jx = 0; jx < W - KW + 1; jx += SW)
-        {
-            int x_out_2 = jx / SW;
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    // TODO fix constraints on depth multiplier (loading of x_in)
-                    int c_increment = DEPTH_MULTIPLIER % 4 == 0 ? 1 : 4 / DEPTH_MULTIPLIER;
-                    int m_increment = 4 / c_increment;
-                    for (int c = 0; c < C_IN; c += c_increment)
-                    {
-                        __m128 x_in;
-                        if (c_increment == 1)
-                        {
-                            x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        else if (c_increment == 2)
-                        {
-                            float x0 = in_[LINEAR_3(x_1, x_2, c, W, C_IN)];
-                            float x1 = in_[LINEAR_3(x_1, x_2, c+1, W, C_IN)];
-                            x_in = _mm_setr_ps(x0, x0, x1, x1);
-                        }
-                        else if (c_increment == 4)
-                        {
-                            x_in = _mm_load_ps(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        for (int m = 0; m < DEPTH_MULTIPLIER; m += m_increment)
-                        {
-                            int c_out = c * DEPTH_MULTIPLIER + m;
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, c, m, KW, C_IN, DEPTH_MULTIPLIER)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)], x_out);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    CNNKernels::depthwiseConvolution<KH, KW, SH, SW, C_IN, DEPTH_MULTIPLIER>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_3_internal_2)")
   {
-    memset(buffer + 2560, 0, 1920 * sizeof(float));
     // OpConvolution2D
     const int W = 10; const int C_IN = 32; const int C_OUT = 24; const int H_OUT = 8; const int W_OUT = 10;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 0); float* out_ = (buffer + 2560); const float* weights_ = separable_conv2d_3_internal_2_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_6)")
   {
@@ -2599,91 +2019,15 @@ void cnn(float *in_0, float *out_0)
         }
     }
   }
-  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_3_internal_1)")
+  INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_3_internal_1) + OpArithmetic<ADD> (batch_normalization_7) + OpLeakyReLU (leaky_re_lu_7)")
   {
-    memset(buffer + 0, 0, 1280 * sizeof(float));
     // OpConvolution2D
     const int W = 10; const int C_IN = 24; const int C_OUT = 16; const int H_OUT = 8; const int W_OUT = 10;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
-    const float* in_ = (buffer + 1920); float* out_ = (buffer + 0); const float* weights_ = conv2d_3_internal_1_W;
+    const float* in_ = (buffer + 1920); float* out_ = (buffer + 7696); const float* weights_ = conv2d_3_internal_1_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_7)")
-  {
-    // OpArithmetic<ADD>
-    const int H = 8; const int W = 10; const int C = 16;
-    const float* in_ = (buffer + 0); float* out_ = (buffer + 1280);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    element = _mm_add_ps(element, _mm_load_ps(&batch_normalization_7_A[c]));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
-  }
-  INTERNAL_CNN_STOPWATCH("OpLeakyReLU (leaky_re_lu_7)")
-  {
-    // OpLeakyReLU
-    const int H = 8; const int W = 10; const int C = 16;
-    const float* in_ = (buffer + 1280); float* out_ = (buffer + 7696);
-    
-    for (int h = 0; h < H; h++)
-    {
-        for (int w = 0; w < W; w++)
-        {
-            for (int c = 0; c < C; c+= 4)
-            {
-                __m128 element = _mm_load_ps(&in_[LINEAR_3(h, w, c, W, C)]);
-                // inner
-                {
-                    __m128 alpha = _mm_set1_ps(0.10000000149011612f);
-                    element = _mm_max_ps(element, _mm_mul_ps(element, alpha));
-                }
-                _mm_store_ps(&out_[LINEAR_3(h, w, c, W, C)], element);
-            }
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_, batch_normalization_7_A, 0.10000000149011612f);
   }
   INTERNAL_CNN_STOPWATCH("OpPadding (separable_conv2d_4_internal_0)")
   {
@@ -2710,101 +2054,24 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpDepthwiseConvolution2D (separable_conv2d_4_internal_1)")
   {
-    memset(buffer + 2576, 0, 5120 * sizeof(float));
     // OpDepthwiseConvolution2D
-    const int H = 10; const int W = 12; const int C_IN = 16; const int C_OUT = 64; const int W_OUT = 10;
+    const int W = 12; const int C_IN = 16; const int H_OUT = 8; const int W_OUT = 10;
     const int SH = 1; const int SW = 1;
     const int KH = 3; const int KW = 3;
     const int DEPTH_MULTIPLIER = 4;
     const float* in_ = (buffer + 0); float* out_ = (buffer + 2576); const float* weights_ = separable_conv2d_4_internal_1_W;
     
-    for (int ix = 0; ix < H - KH + 1; ix += SH)
-    {
-        int x_out_1 = ix / SH;
-        for (int jx = 0; jx < W - KW + 1; jx += SW)
-        {
-            int x_out_2 = jx / SW;
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    // TODO fix constraints on depth multiplier (loading of x_in)
-                    int c_increment = DEPTH_MULTIPLIER % 4 == 0 ? 1 : 4 / DEPTH_MULTIPLIER;
-                    int m_increment = 4 / c_increment;
-                    for (int c = 0; c < C_IN; c += c_increment)
-                    {
-                        __m128 x_in;
-                        if (c_increment == 1)
-                        {
-                            x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        else if (c_increment == 2)
-                        {
-                            float x0 = in_[LINEAR_3(x_1, x_2, c, W, C_IN)];
-                            float x1 = in_[LINEAR_3(x_1, x_2, c+1, W, C_IN)];
-                            x_in = _mm_setr_ps(x0, x0, x1, x1);
-                        }
-                        else if (c_increment == 4)
-                        {
-                            x_in = _mm_load_ps(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        for (int m = 0; m < DEPTH_MULTIPLIER; m += m_increment)
-                        {
-                            int c_out = c * DEPTH_MULTIPLIER + m;
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, c, m, KW, C_IN, DEPTH_MULTIPLIER)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)], x_out);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    CNNKernels::depthwiseConvolution<KH, KW, SH, SW, C_IN, DEPTH_MULTIPLIER>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_4_internal_2)")
   {
-    memset(buffer + 16, 0, 2560 * sizeof(float));
     // OpConvolution2D
     const int W = 10; const int C_IN = 64; const int C_OUT = 32; const int H_OUT = 8; const int W_OUT = 10;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 2576); float* out_ = (buffer + 16); const float* weights_ = separable_conv2d_4_internal_2_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_8)")
   {
@@ -2853,44 +2120,13 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpConvolution2D (conv2d_4_internal_1)")
   {
-    memset(buffer + 0, 0, 1280 * sizeof(float));
     // OpConvolution2D
     const int W = 10; const int C_IN = 32; const int C_OUT = 16; const int H_OUT = 8; const int W_OUT = 10;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 1328); float* out_ = (buffer + 0); const float* weights_ = conv2d_4_internal_1_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_9)")
   {
@@ -2977,101 +2213,24 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpDepthwiseConvolution2D (separable_conv2d_5_internal_1)")
   {
-    memset(buffer + 1584, 0, 1280 * sizeof(float));
     // OpDepthwiseConvolution2D
-    const int H = 9; const int W = 11; const int C_IN = 16; const int C_OUT = 64; const int W_OUT = 5;
+    const int W = 11; const int C_IN = 16; const int H_OUT = 4; const int W_OUT = 5;
     const int SH = 2; const int SW = 2;
     const int KH = 3; const int KW = 3;
     const int DEPTH_MULTIPLIER = 4;
     const float* in_ = (buffer + 0); float* out_ = (buffer + 1584); const float* weights_ = separable_conv2d_5_internal_1_W;
     
-    for (int ix = 0; ix < H - KH + 1; ix += SH)
-    {
-        int x_out_1 = ix / SH;
-        for (int jx = 0; jx < W - KW + 1; jx += SW)
-        {
-            int x_out_2 = jx / SW;
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    // TODO fix constraints on depth multiplier (loading of x_in)
-                    int c_increment = DEPTH_MULTIPLIER % 4 == 0 ? 1 : 4 / DEPTH_MULTIPLIER;
-                    int m_increment = 4 / c_increment;
-                    for (int c = 0; c < C_IN; c += c_increment)
-                    {
-                        __m128 x_in;
-                        if (c_increment == 1)
-                        {
-                            x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        else if (c_increment == 2)
-                        {
-                            float x0 = in_[LINEAR_3(x_1, x_2, c, W, C_IN)];
-                            float x1 = in_[LINEAR_3(x_1, x_2, c+1, W, C_IN)];
-                            x_in = _mm_setr_ps(x0, x0, x1, x1);
-                        }
-                        else if (c_increment == 4)
-                        {
-                            x_in = _mm_load_ps(&in_[LINEAR_3(x_1, x_2, c, W, C_IN)]);
-                        }
-                        for (int m = 0; m < DEPTH_MULTIPLIER; m += m_increment)
-                        {
-                            int c_out = c * DEPTH_MULTIPLIER + m;
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, c, m, KW, C_IN, DEPTH_MULTIPLIER)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_[LINEAR_3(x_out_1, x_out_2, c_out, W_OUT, C_OUT)], x_out);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    CNNKernels::depthwiseConvolution<KH, KW, SH, SW, C_IN, DEPTH_MULTIPLIER>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpConvolution2D (separable_conv2d_5_internal_2)")
   {
-    memset(buffer + 0, 0, 800 * sizeof(float));
     // OpConvolution2D
     const int W = 5; const int C_IN = 64; const int C_OUT = 40; const int H_OUT = 4; const int W_OUT = 5;
     const int SH = 1; const int SW = 1;
     const int KH = 1; const int KW = 1;
     const float* in_ = (buffer + 1584); float* out_ = (buffer + 0); const float* weights_ = separable_conv2d_5_internal_2_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   INTERNAL_CNN_STOPWATCH("OpArithmetic<ADD> (batch_normalization_10)")
   {
@@ -3143,44 +2302,13 @@ void cnn(float *in_0, float *out_0)
   }
   INTERNAL_CNN_STOPWATCH("OpConvolution2D (DetectionLayer_internal_1)")
   {
-    memset(out_0 + 0, 0, 480 * sizeof(float));
     // OpConvolution2D
     const int W = 7; const int C_IN = 40; const int C_OUT = 24; const int H_OUT = 4; const int W_OUT = 5;
     const int SH = 1; const int SW = 1;
     const int KH = 3; const int KW = 3;
     const float* in_ = (buffer + 0); float* out_ = (out_0 + 0); const float* weights_ = DetectionLayer_internal_1_W;
     
-    for (int x_out_1 = 0; x_out_1 < H_OUT; x_out_1++)
-    {
-        int ix = x_out_1 * SH;
-        for (int x_out_2 = 0; x_out_2 < W_OUT; x_out_2++)
-        {
-            int jx = x_out_2 * SW;
-            alignas(16) float out_tmp[C_OUT];
-            COPY(&out_tmp, &out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], C_OUT * sizeof(float), 0);
-            for (int iw = 0; iw < KH; iw++)
-            {
-                int x_1 = ix + iw;
-                for (int jw = 0; jw < KW; jw++)
-                {
-                    int x_2 = jx + jw;
-                    for (int kw = 0; kw < C_IN; kw++)
-                    {
-                        __m128 x_in = _mm_load_ps1(&in_[LINEAR_3(x_1, x_2, kw, W, C_IN)]);
-                        for (int lw = 0; lw < C_OUT; lw += 4)
-                        {
-                            __m128 w = _mm_load_ps(&weights_[LINEAR_4(iw, jw, kw, lw, KW, C_IN, C_OUT)]);
-                            __m128 y = _mm_mul_ps(x_in, w);
-                            __m128 x_out = _mm_load_ps(&out_tmp[lw]);
-                            x_out = _mm_add_ps(x_out, y);
-                            _mm_store_ps(&out_tmp[lw], x_out);
-                        }
-                    }
-                }
-            }
-            COPY(&out_[LINEAR_3(x_out_1, x_out_2, 0, W_OUT, C_OUT)], &out_tmp, C_OUT * sizeof(float), 0);
-        }
-    }
+    CNNKernels::convolution<KH, KW, SH, SW, C_IN, C_OUT>(in_, W, out_, H_OUT, W_OUT, weights_);
   }
   free(_buffer);
 }
@@ -12,6 +12,7 @@
 #include "Representations/Infrastructure/SensorData/JointSensorData.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/ImageCoordinateSystem.h"
+#include "Representations/Perception/ImageToFieldProjection.h"
 #include "Tools/Debugging/DebugImages.h"
 
 MODULE(CoordinateSystemProvider,
@@ -25,6 +26,8 @@ MODULE(CoordinateSystemProvider,
   REQUIRES(JointSensorData), // for timeStamp only
   PROVIDES(ImageCoordinateSystem),
   PROVIDES(ImageCoordinateSystemUpper),
+  PROVIDES(ImageToFieldProjection),
+  PROVIDES(ImageToFieldProjectionUpper),
   LOADS_PARAMETERS(,
     (float) imageRecordingTime, /**< Time the camera requires to take an image (in s, for motion compensation, may depend on exposure). */
     (float) imageRecordingDelay /**< Delay after the camera took an image (in s for motion compensation). */
@@ -39,6 +42,12 @@ class CoordinateSystemProvider : public CoordinateSystemProviderBase
   void update(ImageCoordinateSystem& imageCoordinateSystem);
   void update(ImageCoordinateSystemUpper& imageCoordinateSystem);
 
+  /**
+   * Updates the projections of image points to the field.
+   */
+  void update(ImageToFieldProjection& imageToFieldProjection) { imageToFieldProjection.compute(theCameraMatrix, theCameraInfo); }
+  void update(ImageToFieldProjectionUpper& imageToFieldProjection) { imageToFieldProjection.compute(theCameraMatrixUpper, theCameraInfoUpper); }
+
   /**
    * The method calculates the scaling factors for the distored image.
    * @param a The constant part of the equation for motion distortion will be returned here.
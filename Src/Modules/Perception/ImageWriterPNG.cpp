@@ -11,6 +11,24 @@
 
 #include <filesystem>
 
+namespace
+{
+  /** Converts a camera image into the RGB pixels of a PNG file. Runs in the background. */
+  void toRGB(const Image& source, unsigned char* target_ptr)
+  {
+    for (int y = 0; y < source.height; y++)
+    {
+      const unsigned char* imagedata = reinterpret_cast<const unsigned char*>(source[y]);
+      for (int x = 0; x < source.width; ++x)
+      {
+        ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], target_ptr[0], target_ptr[1], target_ptr[2]);
+        target_ptr += 3;
+        imagedata += 4;
+      }
+    }
+  }
+}
+
 ImageWriterPNG::ImageWriterPNG()
 {
   theDate = getDate();
@@ -142,6 +160,38 @@ std::string ImageWriterPNG::getPenaltyCrossPatchFilePath(bool upper)
 #endif
 }
 
+std::string ImageWriterPNG::getDatasetFilePath()
+{
+#ifdef TARGET_ROBOT
+  return std::string("/home/nao/pnglogs/dataset/");
+#else
+  return File::getBHDir() + std::string("/Config/Logs/Datasets/") + (datasetName != "" ? datasetName + "/" : "");
+#endif
+}
+
+void ImageWriterPNG::exportPatch(const std::string& label, const std::vector<unsigned char>& pixels, int width, int height, bool upper, const std::vector<float>& boundingBox, float validity, const std::string& source)
+{
+  const std::string directory = getDatasetFilePath();
+  if (!datasetWriter || datasetWriter->getDirectory() != directory)
+    datasetWriter = std::make_unique<TFRecordWriter>(directory, "patches_" + theDate, datasetExportConfig.recordsPerShard);
+
+  const Image& image = upper ? (Image&)theImageUpper : theImage;
+  TFRecordExample example;
+  example.addBytes("patch/raw", pixels.data(), pixels.size());
+  example.addInt64("patch/width", width);
+  example.addInt64("patch/height", height);
+  example.addInt64("patch/channels", 3);
+  example.addBytes("label/class", label);
+  example.addFloats("label/bbox", boundingBox);
+  example.addFloat("label/validity", validity);
+  example.addBytes("label/source", source);
+  example.addInt64("meta/timestamp", image.timeStamp);
+  example.addInt64("meta/upper", upper ? 1 : 0);
+  example.addBytes("meta/dataset", datasetName);
+  if (!datasetWriter->write(example))
+    OUTPUT_ERROR("Error writing the dataset to " << directory);
+}
+
 void ImageWriterPNG::update(PNGImageDummy& dummy)
 {
   counter = 0;
@@ -246,6 +296,14 @@ void ImageWriterPNG::update(PNGImageDummy& dummy)
     }
     dummy.successful = true;
   }
+
+  if (sequenceImageConfig.enabled || imageConfig.enabled || ballPerceptConfig.enabled || processedballPatchesConfig.enabled || robotsPerceptConfig.enabled
+      || penaltyCrossPatchesConfig.enabled)
+    writeQueue->report();
+
+  // the records of a frame are complete in the file even if the robot is switched off afterwards
+  if (datasetWriter)
+    datasetWriter->flush();
 }
 
 std::string ImageWriterPNG::fillLeadingZeros(unsigned number)
@@ -257,32 +315,8 @@ std::string ImageWriterPNG::fillLeadingZeros(unsigned number)
 
 void ImageWriterPNG::logSequenceImage(bool upper)
 {
-  unsigned char* imagedata = upper ? (unsigned char*)theSequenceImageUpper.image.image : (unsigned char*)theSequenceImage.image.image;
+  const Image& image = upper ? theSequenceImageUpper.image : theSequenceImage.image;
   unsigned noInSequence = upper ? theSequenceImageUpper.noInSequence : theSequenceImage.noInSequence;
-  unsigned width = upper ? theSequenceImageUpper.image.width : theSequenceImage.image.width;
-  unsigned height = upper ? theSequenceImageUpper.image.height : theSequenceImage.image.height;
-
-  unsigned char* target_ptr = upper ? targetUpper : targetLower;
-
-  for (unsigned y = 0; y < height; y++)
-  {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      unsigned char r;
-      unsigned char g;
-      unsigned char b;
-
-      ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], r, g, b);
-
-      target_ptr[0] = r;
-      target_ptr[1] = g;
-      target_ptr[2] = b;
-
-      target_ptr += 3;
-      imagedata += 4;
-    }
-    imagedata += width * 4;
-  }
 
   std::string filename;
   std::string filepath;
@@ -322,44 +356,13 @@ void ImageWriterPNG::logSequenceImage(bool upper)
     data = ProtobufTools::serializeProtobufData(ProtobufTools::fillProtobufData(
         upper, datasetName, (int)theBehaviorData.role, 3, (upper ? theSequenceImageUpper.image : theSequenceImage.image), (upper ? theCameraMatrixUpper : theCameraMatrix), (upper ? theCameraIntrinsics : theCameraIntrinsics)));
   }
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
 
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-  if (!stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size))
-  {
-    std::filesystem::create_directories(filepath);
-    if (!stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size))
-      OUTPUT_ERROR("Error writing PNG: " << filename_cstr);
-  }
+  writeQueue->enqueue(filename, image, image.width, image.height, &toRGB, std::move(data));
 }
 
 void ImageWriterPNG::logImage(bool upper)
 {
-  unsigned char* imagedata = upper ? (unsigned char*)theImageUpper.image : (unsigned char*)theImage.image;
-  unsigned width = upper ? theImageUpper.width : theImage.width;
-  unsigned height = upper ? theImageUpper.height : theImage.height;
-
-  unsigned char* target_ptr = upper ? targetUpper : targetLower;
-
-  for (unsigned y = 0; y < height; y++)
-  {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      unsigned char r;
-      unsigned char g;
-      unsigned char b;
-
-      ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], r, g, b);
-
-      target_ptr[0] = r;
-      target_ptr[1] = g;
-      target_ptr[2] = b;
-
-      target_ptr += 3;
-      imagedata += 4;
-    }
-    imagedata += width * 4;
-  }
+  const Image& image = upper ? static_cast<const Image&>(theImageUpper) : theImage;
 
   std::string filename;
   std::string filepath;
@@ -407,15 +410,8 @@ void ImageWriterPNG::logImage(bool upper)
     data = ProtobufTools::serializeProtobufData(ProtobufTools::fillProtobufData(
         upper, datasetName, (int)theBehaviorData.role, 3, (upper ? theImageUpper : theImage), (upper ? theCameraMatrixUpper : theCameraMatrix), (upper ? theCameraIntrinsics : theCameraIntrinsics)));
   }
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
 
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-  if (!stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size))
-  {
-    std::filesystem::create_directories(filepath);
-    if (!stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size))
-      OUTPUT_ERROR("Error writing PNG: " << filename_cstr);
-  }
+  writeQueue->enqueue(filename, image, image.width, image.height, &toRGB, std::move(data));
 }
 
 void ImageWriterPNG::logBallPatch(const BallPatch& bp, ImageWriterConfig& config)
@@ -442,6 +438,13 @@ void ImageWriterPNG::logBallPatch(const BallPatch& bp, ImageWriterConfig& config
     lastDatasetName = datasetName;
   }
 
+  if (datasetExportConfig.enabled)
+  {
+    const std::vector<float> boundingBox = {bp.centerInPatch.x() - bp.radiusInPatch, bp.centerInPatch.y() - bp.radiusInPatch, bp.centerInPatch.x() + bp.radiusInPatch, bp.centerInPatch.y() + bp.radiusInPatch};
+    exportPatch("ball", bp.getPatch(), CNN_POSITION_SIZE, CNN_POSITION_SIZE, bp.fromUpper, boundingBox, bp.validity, std::string(CheckedBallSpot::getName(bp.source)) + "_" + CheckedBallSpot::getName(bp.verifier));
+    return;
+  }
+
   std::string data = "";
   if (config.enableProtobuf)
   {
@@ -487,9 +490,6 @@ void ImageWriterPNG::logBallPatch(const BallPatch& bp, ImageWriterConfig& config
     data = ProtobufTools::serializeProtobufData(imageLabelData);
   }
 
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-
   filepath = getBallPatchFilePath(bp.fromUpper);
   filename = filepath + std::to_string(bp.verifier) + "_" + std::to_string(static_cast<int>(bp.validity * 100.f)) + "%_" + std::to_string(image.timeStamp) + "_"
       + (bp.fromUpper ? "upper" : "lower") + "-" + std::to_string(counter) + ".png";
@@ -502,15 +502,7 @@ void ImageWriterPNG::logBallPatch(const BallPatch& bp, ImageWriterConfig& config
   //std::transform(patch.begin(), patch.end(), patch.begin(), std::bind(std::multiplies<float>(), std::placeholders::_1, 255.f));
   //std::vector<unsigned char> charPatch(patch.begin(), patch.end());
 
-  if (!stbi_write_png(filename.c_str(), CNN_POSITION_SIZE, CNN_POSITION_SIZE, 3, bp.getPatch().data(), CNN_POSITION_SIZE * 3, serializedImageLabelData, serializedImageLabelData_size))
-  {
-
-    std::filesystem::create_directories(filepath);
-    if (!stbi_write_png(filename.c_str(), CNN_POSITION_SIZE, CNN_POSITION_SIZE, 3, bp.getPatch().data(), CNN_POSITION_SIZE * 3, serializedImageLabelData, serializedImageLabelData_size))
-    {
-      OUTPUT_ERROR("Error writing PNG: " << filename.c_str());
-    }
-  }
+  writeQueue->enqueue(filename, CNN_POSITION_SIZE, CNN_POSITION_SIZE, bp.getPatch(), std::move(data));
 }
 
 void ImageWriterPNG::logRobotPatch(const RobotEstimate& re, ImageWriterConfigProjectable& config)
@@ -535,7 +527,7 @@ void ImageWriterPNG::logRobotPatch(const RobotEstimate& re, ImageWriterConfigPro
   }
 
   std::string data = "";
-  if (config.enableProtobuf)
+  if (config.enableProtobuf && !datasetExportConfig.enabled)
   {
     imageLabelData::ImageLabelData imageLabelData = ProtobufTools::fillProtobufData(
         re.fromUpperImage, protobufDatasetName, -1, 3, (re.fromUpperImage ? theImageUpper : theImage), (re.fromUpperImage ? theCameraMatrixUpper : theCameraMatrix), (re.fromUpperImage ? theCameraIntrinsics : theCameraIntrinsics));
@@ -565,9 +557,6 @@ void ImageWriterPNG::logRobotPatch(const RobotEstimate& re, ImageWriterConfigPro
     data = ProtobufTools::serializeProtobufData(imageLabelData);
   }
 
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-
   filepath = getRobotPatchFilePath(re.fromUpperImage);
   filename = filepath + std::to_string(static_cast<int>(re.validity * 100.f)) + "%_" + std::to_string(image.timeStamp) + "_" + (re.fromUpperImage ? "upper" : "lower") + "-"
       + std::to_string(counter) + ".png";
@@ -622,16 +611,15 @@ void ImageWriterPNG::logRobotPatch(const RobotEstimate& re, ImageWriterConfigPro
   {
     this->robotEstimateImage = re.patch;
   }
-  std::vector<unsigned char> charPatch(robotEstimateImage.begin(), robotEstimateImage.end());
-
-  if (!stbi_write_png(filename.c_str(), ROBOT_IMAGE_WIDTH, ROBOT_IMAGE_HEIGHT, 3, &charPatch[0], 0, serializedImageLabelData, serializedImageLabelData_size))
+  if (datasetExportConfig.enabled)
   {
-    std::filesystem::create_directories(filepath);
-    if (!stbi_write_png(filename.c_str(), ROBOT_IMAGE_WIDTH, ROBOT_IMAGE_HEIGHT, 3, &charPatch[0], 0, serializedImageLabelData, serializedImageLabelData_size))
-    {
-      OUTPUT_ERROR("Error writing PNG: " << filename.c_str());
-    }
+    const float scaleX = static_cast<float>(ROBOT_IMAGE_WIDTH) / static_cast<float>(std::max(size.x(), 1));
+    const float scaleY = static_cast<float>(ROBOT_IMAGE_HEIGHT) / static_cast<float>(std::max(size.y(), 1));
+    const std::vector<float> boundingBox = {margin.x() * scaleX, margin.y() * scaleY, (margin.x() + reSize.x()) * scaleX, (margin.y() + reSize.y()) * scaleY};
+    exportPatch("robot", robotEstimateImage, ROBOT_IMAGE_WIDTH, ROBOT_IMAGE_HEIGHT, re.fromUpperImage, boundingBox, re.validity, RobotEstimate::getName(re.source));
   }
+  else
+    writeQueue->enqueue(filename, ROBOT_IMAGE_WIDTH, ROBOT_IMAGE_HEIGHT, robotEstimateImage, std::move(data));
 }
 
 void ImageWriterPNG::getUpperImageCoordinates(const RobotEstimate& re, int& upperLeftX, int& upperLeftY, int& lowerRightX, int& lowerRightY)
@@ -688,7 +676,7 @@ void ImageWriterPNG::logPenaltyCrossPatch(const PenaltyCross& pc, ImageWriterCon
   lowerRight = posInImage.cast<float>() + Vector2f(radius, radius);
 
   std::string data = "";
-  if (config.enableProtobuf)
+  if (config.enableProtobuf && !datasetExportConfig.enabled)
   {
     imageLabelData::ImageLabelData imageLabelData = ProtobufTools::fillProtobufData(pc.fromUpper, protobufDatasetName, -1, 3, image, cameraMatrix, theCameraIntrinsics);
 
@@ -716,9 +704,6 @@ void ImageWriterPNG::logPenaltyCrossPatch(const PenaltyCross& pc, ImageWriterCon
     data = ProtobufTools::serializeProtobufData(imageLabelData);
   }
 
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-
   filepath = getPenaltyCrossPatchFilePath(pc.fromUpper);
   filename = filepath + std::to_string(static_cast<int>(pc.validity * 100.f)) + "%_" + std::to_string(image.timeStamp) + "_" + (pc.fromUpper ? "upper" : "lower") + "-"
       + std::to_string(counter) + ".png";
@@ -733,16 +718,10 @@ void ImageWriterPNG::logPenaltyCrossPatch(const PenaltyCross& pc, ImageWriterCon
 
   image.copyAndResizeArea({xmin, ymin}, {width, height}, {PENALTY_CROSS_PATCH_SIZE, PENALTY_CROSS_PATCH_SIZE}, penaltyCrossPatch.data());
 
-  std::vector<unsigned char> charPatch(penaltyCrossPatch.begin(), penaltyCrossPatch.end());
-
-  if (!stbi_write_png(filename.c_str(), PENALTY_CROSS_PATCH_SIZE, PENALTY_CROSS_PATCH_SIZE, 3, &charPatch[0], 0, serializedImageLabelData, serializedImageLabelData_size))
-  {
-    std::filesystem::create_directories(filepath);
-    if (!stbi_write_png(filename.c_str(), PENALTY_CROSS_PATCH_SIZE, PENALTY_CROSS_PATCH_SIZE, 3, &charPatch[0], 0, serializedImageLabelData, serializedImageLabelData_size))
-    {
-      OUTPUT_ERROR("Error writing PNG: " << filename.c_str());
-    }
-  }
+  if (datasetExportConfig.enabled)
+    exportPatch("penaltyCross", penaltyCrossPatch, PENALTY_CROSS_PATCH_SIZE, PENALTY_CROSS_PATCH_SIZE, pc.fromUpper, {0.f, 0.f, PENALTY_CROSS_PATCH_SIZE, PENALTY_CROSS_PATCH_SIZE}, pc.validity, "");
+  else
+    writeQueue->enqueue(filename, PENALTY_CROSS_PATCH_SIZE, PENALTY_CROSS_PATCH_SIZE, penaltyCrossPatch, std::move(data));
 }
 
 MAKE_MODULE(ImageWriterPNG, cognitionInfrastructure)
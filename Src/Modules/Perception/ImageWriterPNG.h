@@ -10,6 +10,8 @@
 
 #include "Tools/Module/Module.h"
 #include "Tools/ColorModelConversions.h"
+#include "Tools/ImageProcessing/PNGWriteQueue.h"
+#include "Tools/ImageProcessing/TFRecordWriter.h"
 #include "Tools/Protobuf/ProtobufTools.h"
 
 #ifdef __clang__
@@ -61,6 +63,11 @@ STREAMABLE(ImageWriterConfigProjectable,,
   (float)(0.0) margin                                     // the fraction of the width around the patch that will be saved
 );
 
+STREAMABLE(DatasetExportConfig,,
+  (bool)(false) enabled,                                  // write the patches into TFRecord shards instead of PNG files
+  (unsigned)(1000) recordsPerShard                        // the number of patches after which the next shard is started
+);
+
 MODULE(ImageWriterPNG,
   //REQUIRES(GroundTruthWorldState),
   REQUIRES(Image),
@@ -90,6 +97,7 @@ MODULE(ImageWriterPNG,
     (ImageWriterConfig) sequenceImageConfig,
     (ImageWriterConfig) processedballPatchesConfig,
     (ImageWriterConfigProjectable) penaltyCrossPatchesConfig,
+    (DatasetExportConfig) datasetExportConfig,
     (bool) useGroundTruthData,                        // use the data from the GroundTruthWorldState
     (std::string) datasetName,                        // datasetName for Protobuf
     (std::vector<std::string>) datasetNameBlacklist  // datasetsName string which should not be included in the logged name
@@ -114,6 +122,7 @@ private:
   std::string getBallPatchFilePath(bool upper);
   std::string getRobotPatchFilePath(bool upper);
   std::string getPenaltyCrossPatchFilePath(bool upper);
+  std::string getDatasetFilePath();
 
   int imageNumber;
   unsigned lastImageTimeStamp;
@@ -127,13 +136,26 @@ private:
   void logRobotPatch(const RobotEstimate& re, ImageWriterConfigProjectable& config);
   void logPenaltyCrossPatch(const PenaltyCross& pc, ImageWriterConfigProjectable& config);
 
+  /**
+   * Writes a patch with its label into the dataset.
+   * @param label The class of the object, e.g. "ball".
+   * @param pixels The RGB pixels of the patch.
+   * @param width The width of the patch.
+   * @param height The height of the patch.
+   * @param upper Is the patch from the upper image?
+   * @param boundingBox The object in patch coordinates (x0, y0, x1, y1).
+   * @param validity The validity of the detection.
+   * @param source What detected the object.
+   */
+  void exportPatch(const std::string& label, const std::vector<unsigned char>& pixels, int width, int height, bool upper, const std::vector<float>& boundingBox, float validity, const std::string& source);
+
   void getUpperImageCoordinates(const RobotEstimate& re, int& upperLeftX, int& upperLeftY, int& lowerRightX, int& lowerRightY);
   std::string fillLeadingZeros(unsigned number);
   std::string theDate;
   std::string getDate();
 
-  unsigned char targetLower[320 * 240 * 3];
-  unsigned char targetUpper[640 * 480 * 3];
+  std::shared_ptr<PNGWriteQueue> writeQueue = PNGWriteQueue::getShared(); /**< Encodes and writes the images in the background. */
+  std::unique_ptr<TFRecordWriter> datasetWriter; /**< Writes the patches if the dataset export is enabled. */
 
   std::vector<unsigned char> robotEstimateImage;
   std::vector<unsigned char> penaltyCrossPatch;
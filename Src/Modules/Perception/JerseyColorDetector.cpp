@@ -78,16 +78,128 @@ void JerseyColorDetector::update(RobotsPerceptTeam& theRobotsPerceptTeam)
   {
     DECLARE_DEBUG_DRAWING("module:JerseyColorDetector:shirtScanUpper", "drawingOnImage");
     setRobotColorFromGC();
-    theRobotsPerceptTeam.robots.clear();
+
+    // If the estimate comes from the lower image, the robot is very near and its jersey should be seen in the upper image.
+    std::vector<Region> boxes;
+    boxes.reserve(theRobotsPerceptClassified.robots.size());
     for (const auto& estimate : theRobotsPerceptClassified.robots)
     {
-      RobotEstimate e(estimate);
-      updateRobotColor(e);
+      Region& box = boxes.emplace_back(Region{estimate.imageUpperLeft, estimate.imageLowerRight});
+      if (!estimate.fromUpperImage)
+        estimate.getUpperImageCoordinates(box.upperLeft, box.lowerRight);
+    }
+    updateColorTable(boxes);
+
+    theRobotsPerceptTeam.robots.clear();
+    theRobotsPerceptTeam.robots.reserve(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i)
+    {
+      RobotEstimate e(theRobotsPerceptClassified.robots[i]);
+      updateRobotColor(e, boxes[i]);
       theRobotsPerceptTeam.robots.push_back(e);
     }
   }
 }
 
+JerseyColorDetector::ColorTable::Counts JerseyColorDetector::ColorTable::count(const Region& region) const
+{
+  Counts result = {0};
+  const int x0 = cellX(region.upperLeft.x());
+  const int y0 = cellY(region.upperLeft.y());
+  const int x1 = cellX(region.lowerRight.x());
+  const int y1 = cellY(region.lowerRight.y());
+  if (x0 >= x1 || y0 >= y1)
+    return result;
+
+  const Counts& lowerRight = sums[y1 * (width + 1) + x1];
+  const Counts& upperRight = sums[y0 * (width + 1) + x1];
+  const Counts& lowerLeft = sums[y1 * (width + 1) + x0];
+  const Counts& upperLeft = sums[y0 * (width + 1) + x0];
+  for (int i = 0; i < numOfChannels; ++i)
+    result[i] = lowerRight[i] - upperRight[i] - lowerLeft[i] + upperLeft[i];
+  return result;
+}
+
+void JerseyColorDetector::updateColorTable(const std::vector<Region>& boxes)
+{
+  ColorTable& table = colorTable;
+  table.step = std::max(colorTableStep, 1);
+  table.width = table.height = 0;
+  if (boxes.empty())
+    return;
+
+  // the bounding box of all regions that are counted, without the image border
+  Vector2i upperLeft(theImageUpper.width, theImageUpper.height);
+  Vector2i lowerRight(0, 0);
+  auto include = [&](const Region& region)
+  {
+    upperLeft = upperLeft.cwiseMin(region.upperLeft);
+    lowerRight = lowerRight.cwiseMax(region.lowerRight);
+  };
+  for (const Region& box : boxes)
+  {
+    include(getJerseyRegion(box));
+    if (autoWeights)
+      for (const Region& region : getBackgroundRegions(box))
+        include(region);
+  }
+  constexpr int border = 4;
+  upperLeft = upperLeft.cwiseMax(Vector2i(border, border));
+  lowerRight = lowerRight.cwiseMin(Vector2i(theImageUpper.width - border, theImageUpper.height - border));
+  if (upperLeft.x() >= lowerRight.x() || upperLeft.y() >= lowerRight.y())
+    return;
+
+  // the counted pixels lie on a grid that does not depend on the boxes
+  table.origin = (upperLeft.array() + table.step - 1) / table.step * table.step;
+  table.width = std::max(0, (lowerRight.x() - table.origin.x() + table.step - 1) / table.step);
+  table.height = std::max(0, (lowerRight.y() - table.origin.y() + table.step - 1) / table.step);
+  const int rowSize = table.width + 1;
+  table.sums.assign(rowSize * (table.height + 1), ColorTable::Counts{0});
+
+  ColorRGBA debugColors[4];
+  for (int i = 0; i < 4; i++)
+    debugColors[i] = asRGB(jerseyColors[i]);
+
+  std::vector<std::pair<int, int>> robotsInRow; // the x ranges covered by robot estimates
+  for (int row = 0; row < table.height; ++row)
+  {
+    const int y = table.origin.y() + row * table.step;
+    robotsInRow.clear();
+    for (const Region& box : boxes)
+      if (y >= box.upperLeft.y() && y <= box.lowerRight.y())
+        robotsInRow.emplace_back(box.upperLeft.x(), box.lowerRight.x());
+
+    const Image::Pixel* pixel = theImageUpper[y] + table.origin.x();
+    const ColorTable::Counts* above = &table.sums[row * rowSize + 1];
+    ColorTable::Counts* sum = &table.sums[(row + 1) * rowSize + 1];
+    ColorTable::Counts rowSum = {0};
+    for (int column = 0; column < table.width; ++column, pixel += table.step)
+    {
+      const int x = table.origin.x() + column * table.step;
+      const unsigned char colors = classifyPixel(*pixel);
+      bool inRobot = false;
+      for (const std::pair<int, int>& range : robotsInRow)
+        inRobot |= x >= range.first && x <= range.second;
+
+      ColorRGBA debugColor = ColorRGBA::brown;
+      for (int i = 0; i < 4; i++)
+        if (colors & (1 << i))
+        {
+          ++rowSum[i];
+          if (!inRobot)
+            ++rowSum[ColorTable::background + i];
+          debugColor = debugColors[i];
+        }
+      if (!inRobot)
+        ++rowSum[ColorTable::backgroundPixels];
+      printPixelAssignmentDebug(Vector2f(static_cast<float>(x), static_cast<float>(y)), table.step, debugColor);
+
+      for (int i = 0; i < ColorTable::numOfChannels; ++i)
+        sum[column][i] = above[column][i] + rowSum[i];
+    }
+  }
+}
+
 void JerseyColorDetector::setRobotColorFromGC()
 {
   if (theOwnTeamInfo.teamNumber > 0)
@@ -126,30 +238,31 @@ float JerseyColorDetector::hueDistance(float h1, float h2)
   }
 }
 
-// randomized startpoint for the grid
-Vector2f JerseyColorDetector::getInitialCheckpoint(int upperLeftX, int upperLeftY, int lowerRightX, int lowerRightY, int& gridSampleSizeVar, float& xInterval, float& yInterval)
+// the upper part of the estimate where the jersey is expected
+JerseyColorDetector::Region JerseyColorDetector::getJerseyRegion(const Region& box) const
+{
+  const int width = box.lowerRight.x() - box.upperLeft.x();
+  const int height = box.lowerRight.y() - box.upperLeft.y();
+  const int sideMargin = static_cast<int>(round(gridSideMargin * width));
+  const int yOffset = static_cast<int>(round(height * gridTopMargin));
+  const int top = box.upperLeft.y() + yOffset;
+  return {Vector2i(box.upperLeft.x() + sideMargin, top), Vector2i(box.lowerRight.x() - sideMargin, top + static_cast<int>((height - yOffset) / upperFractionOfEstimate))};
+}
+
+// the regions left and right of the estimate in the upper half of its height
+std::array<JerseyColorDetector::Region, 2> JerseyColorDetector::getBackgroundRegions(const Region& box) const
 {
-  int width = lowerRightX - upperLeftX;
-  lowerRightX -= static_cast<int>(round(gridSideMargin * width));
-  upperLeftX += static_cast<int>(round(gridSideMargin * width));
-  int randRadius = static_cast<int>(round(randRadiusPercentage * (lowerRightX - upperLeftX)));
-
-  // bbox
-  int xGridSize = lowerRightX - upperLeftX - 2 * randRadius;
-  int yOffset = static_cast<int>(round((lowerRightY - upperLeftY) * gridTopMargin));
-  int yGridSize = static_cast<int>((lowerRightY - upperLeftY - yOffset) / upperFractionOfEstimate - (2 * randRadius));
-
-  // Do not use more steps than pixels if the estimate is very small
-  gridSampleSizeVar = std::min(gridSampleSize, xGridSize);
-  xInterval = xGridSize / static_cast<float>(gridSampleSizeVar - 1);
-  yInterval = yGridSize / static_cast<float>(gridSampleSizeVar - 1);
-
-  // use random offsets and intervals to calculate starting point
-  float xRandOffset = randRadius == 0 ? 0.f : static_cast<float>(rand() % (2 * randRadius) - randRadius);
-  float yRandOffset = randRadius == 0 ? 0.f : static_cast<float>(rand() % (2 * randRadius) - randRadius);
-  float checkPointY = upperLeftY + randRadius + yRandOffset + yOffset;
-  Vector2f checkPoint(upperLeftX + randRadius + xRandOffset - static_cast<int>(round(xInterval)), checkPointY);
-  return checkPoint;
+  const int heightHalf = (box.lowerRight.y() - box.upperLeft.y()) / 2;
+  const int scanlineLen = static_cast<int>(std::round(relativeBackgroundWidth * (box.lowerRight.x() - box.upperLeft.x())));
+  const int gridSize = std::max(1, static_cast<int>(std::round(std::sqrt(backgroundSampleSize / 2))));
+  const int gridWidth = static_cast<int>(std::round(scanlineLen / static_cast<float>(gridSize)));
+  const int gridHeight = static_cast<int>(std::round(heightHalf / static_cast<float>(gridSize)));
+
+  const int top = box.upperLeft.y() + gridHeight;
+  const int bottom = box.upperLeft.y() + gridSize * gridHeight + 1;
+  const int right = box.lowerRight.x() + 2 * gridWidth;
+  const int left = box.upperLeft.x() - 2 * gridWidth + 1;
+  return {Region{Vector2i(left - scanlineLen, top), Vector2i(left, bottom)}, Region{Vector2i(right, top), Vector2i(right + scanlineLen, bottom)}};
 }
 
 static int inHueRange(float x, float min, float max)
@@ -187,41 +300,16 @@ bool JerseyColorDetector::isFieldColor(const Image::Pixel& p)
   return false;
 }
 
-void JerseyColorDetector::updateRobotColor(RobotEstimate& re)
+void JerseyColorDetector::updateRobotColor(RobotEstimate& re, const Region& box)
 {
   STOPWATCH("JerseyColorDetector-updateRobotColor-single")
   {
-    // counter for how many pixels are estimated to belong to which team and how many were actually scanned
-    int counts[4] = {0};
-    int numScanned = 0;
-
-    // Get the bounding box. If the estimate comes from the lower image, the robot is very near and its jersey should be seen in the upper image.
-    Vector2i ul(re.imageUpperLeft.x(), re.imageUpperLeft.y());
-    Vector2i lr(re.imageLowerRight.x(), re.imageLowerRight.y());
-    if (!re.fromUpperImage)
-    {
-      re.getUpperImageCoordinates(ul, lr);
-    }
-
-    int gridSampleSizeVar;
-    float xInterval, yInterval;
-    Vector2f checkPoint = getInitialCheckpoint(ul.x(), ul.y(), lr.x(), lr.y(), gridSampleSizeVar, xInterval, yInterval);
-    float checkPointY = checkPoint.y();
-    int debugPixelSize = static_cast<int>(ceil(std::max(xInterval, yInterval)));
-
-    // two loops that iterate over a grid in the robot estimate
-    for (int i = 0; i < gridSampleSizeVar; i++)
-    {
-      checkPoint.x() += xInterval;
-      checkPoint.y() = checkPointY;
-      int colMax = gridSampleSizeVar;
-      //int colMax = gridSampleSizeVar - abs(gridSampleSizeVar / 2 - i);
-      for (int j = 0; j < colMax; j++)
-      {
-        assignPixel(checkPoint, counts, numScanned, debugPixelSize);
-        checkPoint += Vector2f(0, yInterval);
-      }
-    }
+    // counter for how many pixels are estimated to belong to which team
+    const Region jersey = getJerseyRegion(box);
+    const ColorTable::Counts jerseyCounts = colorTable.count(jersey);
+    int counts[4];
+    for (int i = 0; i < 4; i++)
+      counts[i] = jerseyCounts[i];
 
     // there are 8 weights, 2 for each OWN, OWN_KEEPER, etc.
     // first 4 are to discern between own/opp, last 4 are to discern between normal and keeper
@@ -235,7 +323,7 @@ void JerseyColorDetector::updateRobotColor(RobotEstimate& re)
       // only calculate auto weights if it has to differentiate between own and opponent
       if (((counts[OWN] + counts[OWN_KEEPER]) > 0) + ((counts[OPP] + counts[OPP_KEEPER]) > 0) > 1)
       {
-        calculateAutoWeights(weights, re);
+        calculateAutoWeights(weights, re, box);
       }
     }
     else
@@ -248,7 +336,10 @@ void JerseyColorDetector::updateRobotColor(RobotEstimate& re)
 
     // leave weightedCount for debugging purposes
     float weightedCount[8] = {0}, ratios[8] = {0};
-    int totalGridSize = gridSampleSizeVar * gridSampleSizeVar;
+    // pixels outside the image count as not assigned
+    const int step = colorTable.step;
+    const int totalGridSize = std::max(1, (jersey.lowerRight.x() - jersey.upperLeft.x() + step - 1) / step)
+                              * std::max(1, (jersey.lowerRight.y() - jersey.upperLeft.y() + step - 1) / step);
     for (int i = 0; i < 8; i++)
     {
       weightedCount[i] = counts[i % 4] * weights[i];
@@ -282,71 +373,37 @@ void JerseyColorDetector::updateRobotColor(RobotEstimate& re)
         }
       }
     }
-    printTeamAssignmentDebug(re, ratios, ul.x(), ul.y(), lr.x(), lr.y());
+    printTeamAssignmentDebug(re, ratios, box.upperLeft.x(), box.upperLeft.y(), box.lowerRight.x(), box.lowerRight.y());
   }
 }
 
-bool JerseyColorDetector::pixelIntersectsRobot(const Vector2f& checkPoint)
-{
-  for (auto& estimate : theRobotsPerceptClassified.robots)
-  {
-    bool intersectsX = checkPoint.x() >= estimate.imageUpperLeft.x() && checkPoint.x() <= estimate.imageLowerRight.x();
-    bool intersectsY = checkPoint.y() >= estimate.imageUpperLeft.y() && checkPoint.y() <= estimate.imageLowerRight.y();
-
-    if (intersectsX && intersectsY)
-    {
-      return true;
-    }
-  }
-  return false;
-}
-
-void JerseyColorDetector::assignPixel(const Vector2f& checkPoint, int* counts, int& numScanned, int debugPixelSize)
+unsigned char JerseyColorDetector::classifyPixel(const Image::Pixel& p)
 {
-  // the debugColor shows information about how pixels are considered. If they are assigned to a team, considered field color etc.
-  ColorRGBA debugColor = ColorRGBA::brown;
-  if (theImageUpper.isOutOfImage(checkPoint.x(), checkPoint.y(), 4))
-  {
-    return;
-  }
-
-  numScanned += 1;
-
-  Image::Pixel p = theImageUpper[static_cast<int>(checkPoint.y())][static_cast<int>(checkPoint.x())];
   // if we dont look at the field, try to estimate the team for this point
   if (isFieldColor(p))
-  {
-    debugColor = ColorRGBA::darkgreen;
-    return;
-  }
+    return 0;
 
   short int pH;
   float pS, pL;
   ColorModelConversions::fromYCbCrToHSL(p.y, p.cb, p.cr, pH, pS, pL);
 
+  unsigned char colors = 0;
   for (int i = 0; i < 4; i++)
   {
     if (fitsInDistribution(pH, pS, pL, colorDistributions.at(jerseyColors[i].color())))
-    {
-      counts[i]++;
-      debugColor = asRGB(jerseyColors[i]);
-    }
+      colors |= 1 << i;
     else if (i >= 2 && acceptBlackOpponent && fitsInDistribution(pH, pS, pL, colorDistributions.at(TeamColor::Black)))
-    {
-      counts[i]++;
-      debugColor = ColorRGBA::black;
-    }
+      colors |= 1 << i;
   }
-
-  printPixelAssignmentDebug(checkPoint, debugPixelSize, debugColor);
+  return colors;
 }
 
-void JerseyColorDetector::calculateAutoWeights(float* weights, RobotEstimate& re)
+void JerseyColorDetector::calculateAutoWeights(float* weights, RobotEstimate& re, const Region& box)
 {
   STOPWATCH("JerseyColorDetector-calculateAutoWeights")
   {
     float backgroundProbs[4] = {0};
-    estimateBackgroundProbabilities(backgroundProbs, re);
+    estimateBackgroundProbabilities(backgroundProbs, re, box);
 
     for (int i = 0; i < 8; i++)
     {
@@ -385,34 +442,28 @@ void JerseyColorDetector::calculateAutoWeights(float* weights, RobotEstimate& re
 }
 
 
-void JerseyColorDetector::estimateBackgroundProbabilities(float* backgroundProbs, RobotEstimate& re)
+void JerseyColorDetector::estimateBackgroundProbabilities(float* backgroundProbs, RobotEstimate& re, const Region& box)
 {
   for (int i = 0; i < 4; i++)
   {
     backgroundProbs[i] = 0.f;
   }
-  // calculate the grids rows, columns, margins
-  int heightHalf = (re.imageLowerRight.y() - re.imageUpperLeft.y()) / 2;
-
-  int scanlineLen = (int)std::round(relativeBackgroundWidth * (re.imageLowerRight.x() - re.imageUpperLeft.x()));
-  int gridSize = (int)std::round(std::sqrt(backgroundSampleSize / 2));
 
-  int gridWidth = (int)std::round(scanlineLen / (float)gridSize);
-  int gridHeight = (int)std::round(heightHalf / (float)gridSize);
-
-  // starting points for scanning
-  Vector2f rCp = Vector2f(re.imageLowerRight.x() + 2 * gridWidth, re.imageUpperLeft.y());
-  Vector2f lCp = Vector2f(re.imageUpperLeft.x() - 2 * gridWidth, re.imageUpperLeft.y());
-
-  // do a few scanlines
+  // count the pixels left and right of the estimate that do not belong to any robot
   int counts[4] = {0}, numScanned = 0;
-  for (int i = 0; i < gridSize; i++)
+  for (const Region& region : getBackgroundRegions(box))
   {
-    rCp += Vector2f(0, gridHeight);
-    lCp += Vector2f(0, gridHeight);
-    countColorsOnHorizontalScanLine(counts, numScanned, rCp, false, scanlineLen, gridSize);
-    countColorsOnHorizontalScanLine(counts, numScanned, lCp, true, scanlineLen, gridSize);
+    const ColorTable::Counts regionCounts = colorTable.count(region);
+    for (int i = 0; i < 4; i++)
+      counts[i] += regionCounts[ColorTable::background + i];
+    numScanned += regionCounts[ColorTable::backgroundPixels];
   }
+  if (!numScanned)
+  {
+    printBackgroundProbabilitiesDebug(re, backgroundProbs);
+    return;
+  }
+
   // a min amount of teamcolor pixels have to be found in the background
   int total = counts[OWN] + counts[OWN_KEEPER] + counts[OPP] + counts[OPP_KEEPER];
   bool minPixelsAssigned = total / (float)numScanned > minBackgroundAssignments;
@@ -431,29 +482,6 @@ void JerseyColorDetector::estimateBackgroundProbabilities(float* backgroundProbs
   printBackgroundProbabilitiesDebug(re, backgroundProbs);
 }
 
-void JerseyColorDetector::countColorsOnHorizontalScanLine(int* counts, int& scanned, Vector2f start, bool toLeft, int len, int amt)
-{
-  int jump = static_cast<int>(round(len / (float)amt + 1));
-  for (int i = 0; i < amt; i++)
-  {
-    int offset = i * jump;
-    Vector2f checkPoint;
-    if (toLeft)
-    {
-      checkPoint = start - Vector2f((float)offset, 0);
-    }
-    else
-    {
-      checkPoint = start + Vector2f((float)offset, 0);
-    }
-    if (pixelIntersectsRobot(checkPoint))
-    {
-      continue;
-    }
-    assignPixel(checkPoint, counts, scanned, jump);
-  }
-}
-
 ColorRGBA JerseyColorDetector::asRGB(TeamColor c)
 {
   switch (c.color())
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <optional>
 #include <functional>
+#include <vector>
 
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/Image.h"
@@ -76,8 +78,7 @@ MODULE(JerseyColorDetector,
     (float) maxAutoWeight,
 
     (float) upperFractionOfEstimate,
-    (int) gridSampleSize,
-    (float) randRadiusPercentage,
+    (int)(2) colorTableStep, /**< The colors of every n-th pixel of every n-th row are counted. */
     (float) gridSideMargin,
     (float) gridTopMargin,
 
@@ -118,15 +119,70 @@ private:
 
   TeamColor jerseyColors[4] = {TeamColor(TEAM_YELLOW), TeamColor(TeamColor::OwnMagenta), TeamColor(TEAM_BLACK), TeamColor(TEAM_BLACK)};
 
+  /** A rectangle in the upper image. The lower right corner is exclusive. */
+  struct Region
+  {
+    Vector2i upperLeft;
+    Vector2i lowerRight;
+  };
+
+  /**
+   * Summed-area tables of the pixels of the upper image that were assigned to
+   * each of the four jersey colors. The number of pixels of a color inside any
+   * rectangle can be determined with four lookups.
+   */
+  struct ColorTable
+  {
+    enum Channel
+    {
+      background = 4, /**< The assignments of pixels that are not inside a robot estimate start here. */
+      backgroundPixels = 8, /**< The number of pixels that are not inside a robot estimate. */
+      numOfChannels
+    };
+    using Counts = std::array<int, numOfChannels>;
+
+    Vector2i origin = Vector2i::Zero(); /**< The pixel counted by the first cell. */
+    int step = 1; /**< The distance between the pixels counted in both directions. */
+    int width = 0; /**< The number of cells per row. */
+    int height = 0; /**< The number of rows. */
+    std::vector<Counts> sums; /**< (width + 1) x (height + 1) sums, the first row and column are zero. */
+
+    /**
+     * Counts the assignments of the counted pixels inside a rectangle.
+     * @param region The rectangle in image coordinates.
+     * @return The counts per channel.
+     */
+    Counts count(const Region& region) const;
+
+  private:
+    int cellX(int x) const { return std::clamp((x - origin.x() + step - 1) / step, 0, width); }
+    int cellY(int y) const { return std::clamp((y - origin.y() + step - 1) / step, 0, height); }
+  };
+
+  ColorTable colorTable; /**< The table of the current upper image. */
+
   void setRobotColorFromGC();
 
-  void updateRobotColor(RobotEstimate& re);
-  void assignPixel(const Vector2f& checkPoint, int* counts, int& numScanned, int debugPixelSize);
-  bool pixelIntersectsRobot(const Vector2f& checkPoint);
-  Vector2f getInitialCheckpoint(int upperLeftX, int upperLeftY, int lowerRightX, int lowerRightY, int& gridSampleSize, float& xInterval, float& yInterval);
-  void estimateBackgroundProbabilities(float* backgroundProbs, RobotEstimate& re);
-  void countColorsOnHorizontalScanLine(int* counts, int& scanned, Vector2f start, bool toLeft, int len, int amt);
-  void calculateAutoWeights(float* weights, RobotEstimate& re);
+  void updateRobotColor(RobotEstimate& re, const Region& box);
+
+  /**
+   * Classifies the pixels of the upper image inside the bounding box of the
+   * regions that are evaluated for all robot estimates and sums them up.
+   * @param boxes The boxes of all robot estimates in the upper image.
+   */
+  void updateColorTable(const std::vector<Region>& boxes);
+
+  /**
+   * Determines the jersey colors a pixel fits.
+   * @param p The pixel.
+   * @return A bit for each entry in jerseyColors.
+   */
+  unsigned char classifyPixel(const Image::Pixel& p);
+
+  Region getJerseyRegion(const Region& box) const;
+  std::array<Region, 2> getBackgroundRegions(const Region& box) const;
+  void estimateBackgroundProbabilities(float* backgroundProbs, RobotEstimate& re, const Region& box);
+  void calculateAutoWeights(float* weights, RobotEstimate& re, const Region& box);
 
   bool isFieldColor(const Image::Pixel& p);
   bool fitsInDistribution(float h, float s, float l, ColorDistribution& colorDistribution);
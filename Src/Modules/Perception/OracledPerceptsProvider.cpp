@@ -109,6 +109,8 @@ void OracledPerceptsProvider::update(BallPercept& ballPercept)
   {
     updateBallPercept(ballPercept, 0);
   }
+  if (ballPercept.status == BallPercept::notSeen && randomFloat() < ballFalsePositiveRate)
+    createFalseBallPercept(ballPercept);
 }
 
 void OracledPerceptsProvider::update(MultipleBallPercept& multipleBallPercept)
@@ -182,6 +184,25 @@ void OracledPerceptsProvider::updateBallPercept(BallPercept& ballPercept, size_t
   }
 }
 
+void OracledPerceptsProvider::createFalseBallPercept(BallPercept& ballPercept) const
+{
+  const Vector2f positionInImage(randomFloat(0.f, static_cast<float>(theCameraInfo.width)), randomFloat(0.f, static_cast<float>(theCameraInfo.height)));
+  Vector2f relativePositionOnField;
+  Geometry::Circle circle;
+  if (!Transformation::imageToRobotHorizontalPlane(positionInImage, theFieldDimensions.ballRadius, theCameraMatrix, theCameraInfo, relativePositionOnField)
+      || relativePositionOnField.norm() > ballMaxVisibleDistance
+      || !Geometry::calculateBallInImage(relativePositionOnField, theCameraMatrix, theCameraInfo, theFieldDimensions.ballRadius, circle))
+    return;
+
+  ballPercept.status = BallPercept::seen;
+  ballPercept.timestamp = theFrameInfo.time;
+  ballPercept.positionInImage = positionInImage;
+  ballPercept.radiusInImage = circle.radius;
+  ballPercept.relativePositionOnField = relativePositionOnField;
+  ballPercept.fromUpper = false;
+  ballPercept.validity = randomFloat(0.5f, 0.9f);
+}
+
 void OracledPerceptsProvider::update(CLIPFieldLinesPercept& linePercept)
 {
   linePercept.lines.clear();
@@ -43,6 +43,7 @@ MODULE(OracledPerceptsProvider,
     (float) ballMaxVisibleDistance,            /**< Maximum distance until which this object can be seen */
     (float) ballRecognitionRateMin,            /**< Likelihood of actually perceiving this object, when it is in the field of view and far away */
     (float) ballRecognitionRateMax,            /**< Likelihood of actually perceiving this object, when it is in the field of view and near */
+    (float) ballFalsePositiveRate,             /**< Likelihood of perceiving a ball at a random position in the lower image, when no ball was seen */
     (bool)  applyCenterCircleNoise,            /**< Activate / Deactivate noise for center circle percepts */
     (float) centerCircleCenterInImageStdDevInPixel,   /**< Standard deviation of error in pixels (x as well as y) */
     (float) centerCircleMaxVisibleDistance,    /**< Maximum distance until which this object can be seen */
@@ -103,6 +104,11 @@ private:
 
   void updateBallPercept(BallPercept& ballPercept, size_t index);
 
+  /** Creates a ball percept at a random position in the lower image, as real ball perceptors sometimes do
+  * @param ballPercept The percept that is filled if the projection of the position onto the field succeeds
+  */
+  void createFalseBallPercept(BallPercept& ballPercept) const;
+
   /** One main function, might be called every cycle
   * @param goalPercept The data struct to be filled
   */
@@ -74,6 +74,9 @@ void PNGLogger::update(PNGImageDummy& dummy)
     if (dummy.successful)
       imageCounter++;
   }
+
+  if (enabled)
+    writeQueue->report();
 }
 
 std::string PNGLogger::fillLeadingZeros(unsigned number)
@@ -94,41 +97,8 @@ std::string PNGLogger::getFilePath(bool upper)
 
 void PNGLogger::logImage(bool upper)
 {
-  unsigned char* imagedata = upper ? (unsigned char*)theImageUpper.image : (unsigned char*)theImage.image;
-  unsigned width = upper ? theImageUpper.width : theImage.width;
-  unsigned height = upper ? theImageUpper.height : theImage.height;
-
-  unsigned char* target_ptr = upper ? targetUpper : targetLower;
-
-  for (unsigned y = 0; y < height; y++)
-  {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      if (streamAsRGB)
-      {
-        unsigned char r;
-        unsigned char g;
-        unsigned char b;
-
-        ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], r, g, b);
-
-        target_ptr[0] = r;
-        target_ptr[1] = g;
-        target_ptr[2] = b;
-      }
-      else
-      {
-        target_ptr[0] = imagedata[0];
-        target_ptr[1] = imagedata[1];
-        target_ptr[2] = imagedata[3];
-      }
-
-
-      target_ptr += 3;
-      imagedata += 4;
-    }
-    imagedata += width * 4;
-  }
+  const Image& image = upper ? static_cast<const Image&>(theImageUpper) : theImage;
+  const bool asRGB = streamAsRGB;
 
   std::string filename;
   if (datasetName != "")
@@ -145,7 +115,6 @@ void PNGLogger::logImage(bool upper)
     filename = (upper ? filepathUpper : filepathLower) + datasetName + "_" + std::to_string(imageNumber) + "_" + (upper ? "upper" : "lower") + ".png";
     imageNumber = imageNumber + 1;
   }
-  const char* filename_cstr = filename.c_str();
 
   std::string data = "";
   if (enableProtobuf)
@@ -153,49 +122,36 @@ void PNGLogger::logImage(bool upper)
     data = ProtobufTools::serializeProtobufData(ProtobufTools::fillProtobufData(
         upper, datasetName, (int)theBehaviorData.role, 3, (upper ? theImageUpper : theImage), (upper ? theCameraMatrixUpper : theCameraMatrix), (upper ? theCameraIntrinsics : theCameraIntrinsics)));
   }
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
 
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-  stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size);
+  writeQueue->enqueue(filename, image, image.width, image.height,
+      [asRGB](const Image& source, unsigned char* target_ptr)
+      {
+        for (int y = 0; y < source.height; y++)
+        {
+          const unsigned char* imagedata = reinterpret_cast<const unsigned char*>(source[y]);
+          for (int x = 0; x < source.width; ++x)
+          {
+            if (asRGB)
+              ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], target_ptr[0], target_ptr[1], target_ptr[2]);
+            else
+            {
+              target_ptr[0] = imagedata[0];
+              target_ptr[1] = imagedata[1];
+              target_ptr[2] = imagedata[3];
+            }
+
+            target_ptr += 3;
+            imagedata += 4;
+          }
+        }
+      },
+      std::move(data));
 }
 
 void PNGLogger::logImageYFull(bool upper)
 {
-  unsigned char* imagedata = upper ? (unsigned char*)theImageUpper.image : (unsigned char*)theImage.image;
-  unsigned width = upper ? theImageUpper.width * 2 : theImage.width * 2;
-  unsigned height = upper ? theImageUpper.height * 2 : theImage.height * 2;
-
-  unsigned char* target_ptr = upper ? targetUpperFull : targetLowerFull;
-
-  for (unsigned y = 0; y < height; y++)
-  {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      if (streamAsRGB)
-      {
-        unsigned char r;
-        unsigned char g;
-        unsigned char b;
-
-        ColorModelConversions::fromYCbCrToRGB(imagedata[0], 127, 127, r, g, b);
-
-        target_ptr[0] = r;
-        target_ptr[1] = g;
-        target_ptr[2] = b;
-      }
-      else
-      {
-        target_ptr[0] = imagedata[0];
-        target_ptr[1] = imagedata[1];
-        target_ptr[2] = imagedata[3];
-      }
-
-
-      target_ptr += 3;
-      imagedata += 2;
-    }
-    //imagedata+=width*4;
-  }
+  const Image& image = upper ? static_cast<const Image&>(theImageUpper) : theImage;
+  const bool asRGB = streamAsRGB;
 
   std::string filename;
 
@@ -210,55 +166,43 @@ void PNGLogger::logImageYFull(bool upper)
         + (upper ? "upper_full_onlyY" : "lower_full_onlyY") + ".png";
   }
 
-
-  const char* filename_cstr = filename.c_str();
   std::string data = "";
   if (enableProtobuf)
   {
     data = ProtobufTools::serializeProtobufData(ProtobufTools::fillProtobufData(
         upper, datasetName, (int)theBehaviorData.role, 1, (upper ? theImageUpper : theImage), (upper ? theCameraMatrixUpper : theCameraMatrix), (upper ? theCameraIntrinsics : theCameraIntrinsics)));
   }
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
-  stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpperFull : targetLowerFull, width * 3, serializedImageLabelData);
+
+  // The full resolution uses both y channels of each pixel and the second half of each row.
+  writeQueue->enqueue(filename, image, image.width * 2, image.height * 2,
+      [asRGB](const Image& source, unsigned char* target_ptr)
+      {
+        const unsigned char* imagedata = reinterpret_cast<const unsigned char*>(source.image);
+        for (int y = 0; y < source.height * 2; y++)
+        {
+          for (int x = 0; x < source.width * 2; ++x)
+          {
+            if (asRGB)
+              ColorModelConversions::fromYCbCrToRGB(imagedata[0], 127, 127, target_ptr[0], target_ptr[1], target_ptr[2]);
+            else
+            {
+              target_ptr[0] = imagedata[0];
+              target_ptr[1] = imagedata[1];
+              target_ptr[2] = imagedata[3];
+            }
+
+            target_ptr += 3;
+            imagedata += 2;
+          }
+        }
+      },
+      std::move(data));
 }
 
 void PNGLogger::logImageY(bool upper)
 {
-  unsigned char* imagedata = upper ? (unsigned char*)theImageUpper.image : (unsigned char*)theImage.image;
-  unsigned width = upper ? theImageUpper.width : theImage.width;
-  unsigned height = upper ? theImageUpper.height : theImage.height;
-
-  unsigned char* target_ptr = upper ? targetUpper : targetLower;
-
-  for (unsigned y = 0; y < height; y++)
-  {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      if (streamAsRGB)
-      {
-        unsigned char r;
-        unsigned char g;
-        unsigned char b;
-
-        ColorModelConversions::fromYCbCrToRGB(imagedata[0], 127, 127, r, g, b);
-
-        target_ptr[0] = r;
-        target_ptr[1] = g;
-        target_ptr[2] = b;
-      }
-      else
-      {
-        target_ptr[0] = imagedata[0];
-        target_ptr[1] = imagedata[1];
-        target_ptr[2] = imagedata[3];
-      }
-
-
-      target_ptr += 3;
-      imagedata += 4;
-    }
-    imagedata += width * 4;
-  }
+  const Image& image = upper ? static_cast<const Image&>(theImageUpper) : theImage;
+  const bool asRGB = streamAsRGB;
 
   std::string filename;
   if (datasetName != "")
@@ -271,15 +215,36 @@ void PNGLogger::logImageY(bool upper)
     filename = (upper ? filepathUpper : filepathLower) + theDate + "_" + std::to_string(std::min(theImageUpper.timeStamp, theImage.timeStamp)) + "_"
         + (upper ? "upper_onlyY" : "lower_onlyY") + ".png";
   }
-  const char* filename_cstr = filename.c_str();
   std::string data = "";
   if (enableProtobuf)
   {
     data = ProtobufTools::serializeProtobufData(ProtobufTools::fillProtobufData(
         upper, datasetName, (int)theBehaviorData.role, 1, (upper ? theImageUpper : theImage), (upper ? theCameraMatrixUpper : theCameraMatrix), (upper ? theCameraIntrinsics : theCameraIntrinsics)));
   }
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
-  stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData);
+
+  writeQueue->enqueue(filename, image, image.width, image.height,
+      [asRGB](const Image& source, unsigned char* target_ptr)
+      {
+        for (int y = 0; y < source.height; y++)
+        {
+          const unsigned char* imagedata = reinterpret_cast<const unsigned char*>(source[y]);
+          for (int x = 0; x < source.width; ++x)
+          {
+            if (asRGB)
+              ColorModelConversions::fromYCbCrToRGB(imagedata[0], 127, 127, target_ptr[0], target_ptr[1], target_ptr[2]);
+            else
+            {
+              target_ptr[0] = imagedata[0];
+              target_ptr[1] = imagedata[1];
+              target_ptr[2] = imagedata[3];
+            }
+
+            target_ptr += 3;
+            imagedata += 4;
+          }
+        }
+      },
+      std::move(data));
 }
 
 std::string PNGLogger::getDate()
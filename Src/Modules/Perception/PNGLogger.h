@@ -29,6 +29,7 @@
 #include "Platform/File.h"
 #include <string>
 #include "Tools/ColorModelConversions.h"
+#include "Tools/ImageProcessing/PNGWriteQueue.h"
 #include <time.h>
 
 
@@ -86,9 +87,5 @@ private:
   std::string theDate;
   std::string getDate();
 
-  unsigned char targetLower[320 * 240 * 3];
-  unsigned char targetUpper[640 * 480 * 3];
-
-  unsigned char targetLowerFull[640 * 480 * 3];
-  unsigned char targetUpperFull[1280 * 960 * 3];
+  std::shared_ptr<PNGWriteQueue> writeQueue = PNGWriteQueue::getShared(); /**< Converts, encodes, and writes the images in the background. */
 };
@@ -119,6 +119,8 @@ void PNGLoggerSequence::update(PNGImageDummy& dummy)
       logImage(false);
       dummy.successful = true;
     }
+
+    writeQueue->report();
   }
 }
 
@@ -140,32 +142,8 @@ std::string PNGLoggerSequence::getFilePath(bool upper)
 
 void PNGLoggerSequence::logImage(bool upper)
 {
-  unsigned char* imagedata = upper ? (unsigned char*)theSequenceImageUpper.image.image : (unsigned char*)theSequenceImage.image.image;
+  const Image& image = upper ? theSequenceImageUpper.image : theSequenceImage.image;
   unsigned noInSequence = upper ? theSequenceImageUpper.noInSequence : theSequenceImage.noInSequence;
-  unsigned width = upper ? theSequenceImageUpper.image.width : theSequenceImage.image.width;
-  unsigned height = upper ? theSequenceImageUpper.image.height : theSequenceImage.image.height;
-
-  unsigned char* target_ptr = upper ? targetUpper : targetLower;
-
-  for (unsigned y = 0; y < height; y++)
-  {
-    for (unsigned x = 0; x < width; ++x)
-    {
-      unsigned char r;
-      unsigned char g;
-      unsigned char b;
-
-      ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], r, g, b);
-
-      target_ptr[0] = r;
-      target_ptr[1] = g;
-      target_ptr[2] = b;
-
-      target_ptr += 3;
-      imagedata += 4;
-    }
-    imagedata += width * 4;
-  }
 
   std::string filename;
   std::string filepath;
@@ -206,16 +184,22 @@ void PNGLoggerSequence::logImage(bool upper)
     data = ProtobufTools::serializeProtobufData(ProtobufTools::fillProtobufData(
         upper, datasetName, (int)theBehaviorData.role, 3, (upper ? theSequenceImageUpper.image : theSequenceImage.image), (upper ? theCameraMatrixUpper : theCameraMatrix), (upper ? theCameraIntrinsics : theCameraIntrinsics)));
   }
-  unsigned char* serializedImageLabelData = (unsigned char*)data.c_str();
 
-  int serializedImageLabelData_size = static_cast<int>(data.size());
-  if (!stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size))
-  {
-    if (std::filesystem::create_directories(filepath))
-      OUTPUT_TEXT("Created directory " + filepath);
-    if (!stbi_write_png(filename_cstr, width, height, 3, upper ? targetUpper : targetLower, width * 3, serializedImageLabelData, serializedImageLabelData_size))
-      OUTPUT_TEXT("Error writing PNG: " << filename_cstr);
-  }
+  writeQueue->enqueue(filename, image, image.width, image.height,
+      [](const Image& source, unsigned char* target_ptr)
+      {
+        for (int y = 0; y < source.height; y++)
+        {
+          const unsigned char* imagedata = reinterpret_cast<const unsigned char*>(source[y]);
+          for (int x = 0; x < source.width; ++x)
+          {
+            ColorModelConversions::fromYCbCrToRGB(imagedata[0], imagedata[1], imagedata[3], target_ptr[0], target_ptr[1], target_ptr[2]);
+            target_ptr += 3;
+            imagedata += 4;
+          }
+        }
+      },
+      std::move(data));
 }
 
 std::string PNGLoggerSequence::getDate()
@@ -31,6 +31,7 @@
 #include "Platform/File.h"
 #include <string>
 #include "Tools/ColorModelConversions.h"
+#include "Tools/ImageProcessing/PNGWriteQueue.h"
 #include <time.h>
 
 
@@ -83,6 +84,5 @@ private:
   std::string theDate;
   std::string getDate();
 
-  unsigned char targetLower[320 * 240 * 3];
-  unsigned char targetUpper[640 * 480 * 3];
+  std::shared_ptr<PNGWriteQueue> writeQueue = PNGWriteQueue::getShared(); /**< Converts, encodes, and writes the images in the background. */
 };
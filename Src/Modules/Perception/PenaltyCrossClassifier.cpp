@@ -2,17 +2,13 @@
 #include "Tools/Debugging/Debugging.h"
 #include "Platform/File.h"
 
-PenaltyCrossClassifier::PenaltyCrossClassifier()
-{
-  initClassifier();
-}
-
 void PenaltyCrossClassifier::update(PenaltyCrossPercept& penaltyCrossPercept)
 {
   DECLARE_DEBUG_DRAWING("module:PenaltyCrossClassifier:Image:Upper", "drawingOnImage");
   DECLARE_DEBUG_DRAWING("module:PenaltyCrossClassifier:Image:Lower", "drawingOnImage");
   DECLARE_PLOT("module:PenaltyCrossClassifier:sumOfPenaltyCrossHypotheses");
   DECLARE_PLOT("module:PenaltyCrossClassifier:processedPenaltyCrossHypotheses");
+  DECLARE_PLOT("module:PenaltyCrossClassifier:gatedPenaltyCrossHypotheses");
   std::swap(penaltyCrossPercept, localPenaltyCrossPercept);
 }
 
@@ -23,111 +19,73 @@ void PenaltyCrossClassifier::update(PenaltyCrossHypotheses& penaltyCrossHypothes
 
 void PenaltyCrossClassifier::execute(tf::Subflow&)
 {
+  // the model is registered here, since the inference service is not available in the constructor
+  if (!classifier)
+    initClassifier();
   DEBUG_RESPONSE_ONCE("module:PenaltyCrossClassifier:initClassifier") initClassifier();
   sumOfPenaltyCrossHypotheses = 0;
   processedPenaltyCrossHypotheses = 0;
+  gatedPenaltyCrossHypotheses = 0;
 
   localPenaltyCrossPercept.reset();
   localPenaltyCrossHypotheses.penaltyCrosses.clear();
   localPenaltyCrossHypotheses.penaltyCrossesUpper.clear();
 
-  bool shouldReturn = false;
-  STOPWATCH("PenaltyCrossPercept-update(Lower)")
+  if (!classifier)
+    return;
+
+  // all hypotheses are submitted before the first one is checked, so that they are classified in batches
+  std::vector<Candidate> candidates;
+  STOPWATCH("PenaltyCrossClassifier-submitPenaltyCrosses")
   {
     sumOfPenaltyCrossHypotheses += thePrePenaltyCrossHypothesesYolo.penaltyCrosses.size();
-    if (!shouldReturn && checkPenaltyCrosses(localPenaltyCrossPercept, thePrePenaltyCrossHypothesesYolo.penaltyCrosses, PenaltyCrossPercept::yolo))
-      if (stopOnFirstDetection)
-        shouldReturn = true;
+    submitPenaltyCrosses(candidates, thePrePenaltyCrossHypothesesYolo.penaltyCrosses, PenaltyCrossPercept::yolo);
     sumOfPenaltyCrossHypotheses += thePrePenaltyCrossHypothesesScanlines.penaltyCrosses.size();
-    if (!shouldReturn && checkPenaltyCrosses(localPenaltyCrossPercept, thePrePenaltyCrossHypothesesScanlines.penaltyCrosses, PenaltyCrossPercept::scanlines))
-      if (stopOnFirstDetection)
-        shouldReturn = true;
-  }
-  STOPWATCH("PenaltyCrossPercept-update(Upper)")
-  {
+    submitPenaltyCrosses(candidates, thePrePenaltyCrossHypothesesScanlines.penaltyCrosses, PenaltyCrossPercept::scanlines);
     sumOfPenaltyCrossHypotheses += thePrePenaltyCrossHypothesesYolo.penaltyCrossesUpper.size();
-    if (!shouldReturn && checkPenaltyCrosses(localPenaltyCrossPercept, thePrePenaltyCrossHypothesesYolo.penaltyCrossesUpper, PenaltyCrossPercept::yolo))
-      if (stopOnFirstDetection)
-        shouldReturn = true;
+    submitPenaltyCrosses(candidates, thePrePenaltyCrossHypothesesYolo.penaltyCrossesUpper, PenaltyCrossPercept::yolo);
     sumOfPenaltyCrossHypotheses += thePrePenaltyCrossHypothesesScanlines.penaltyCrossesUpper.size();
-    if (!shouldReturn && checkPenaltyCrosses(localPenaltyCrossPercept, thePrePenaltyCrossHypothesesScanlines.penaltyCrossesUpper, PenaltyCrossPercept::scanlines))
-      if (stopOnFirstDetection)
-        shouldReturn = true;
+    submitPenaltyCrosses(candidates, thePrePenaltyCrossHypothesesScanlines.penaltyCrossesUpper, PenaltyCrossPercept::scanlines);
+  }
+  STOPWATCH("PenaltyCrossClassifier-checkPenaltyCrosses")
+  {
+    for (Candidate& candidate : candidates)
+      if (checkPenaltyCross(localPenaltyCrossPercept, candidate) && stopOnFirstDetection)
+        break;
   }
   PLOT("module:PenaltyCrossClassifier:sumOfPenaltyCrossHypotheses", sumOfPenaltyCrossHypotheses);
   PLOT("module:PenaltyCrossClassifier:processedPenaltyCrossHypotheses", processedPenaltyCrossHypotheses);
+  PLOT("module:PenaltyCrossClassifier:gatedPenaltyCrossHypotheses", gatedPenaltyCrossHypotheses);
 }
 
 void PenaltyCrossClassifier::initClassifier()
 {
-  std::string filename = std::string(File::getBHDir()) + "/Config/" + std::string(modelName);
-
-  // Load the model
-  model = tflite::FlatBufferModel::BuildFromFile(filename.c_str());
-  TFLITE_MINIMAL_CHECK(model != nullptr);
-
-  // Build the interpreter
-  tflite::InterpreterBuilder builder(*model, resolver);
-  builder(&interpreter);
-  TFLITE_MINIMAL_CHECK(interpreter != nullptr);
-  interpreter->SetNumThreads(1);
-
-  // Allocate memory for the tensors
-  interpreter->AllocateTensors();
-
-  // Check interpreter state
-  //tflite::PrintInterpreterState(class_interpreter.get());
+  classifier = theTfliteInferenceService.loadModel("PenaltyCrossClassifier", modelName, TfliteInferenceService::low, maxNumberOfHypotheses);
 }
 
-bool PenaltyCrossClassifier::checkPenaltyCrosses(PenaltyCrossPercept& thePenaltyCrossPercept, const std::vector<PenaltyCross> penaltyCrosses, PenaltyCrossPercept::DetectionType detectionType)
+void PenaltyCrossClassifier::submitPenaltyCrosses(std::vector<Candidate>& candidates, const std::vector<PenaltyCross>& penaltyCrosses, PenaltyCrossPercept::DetectionType detectionType)
 {
   for (const PenaltyCross& pc : penaltyCrosses)
   {
-    bool pcFound = false;
-    STOPWATCH("PenaltyCrossClassifier-checkPenaltyCross")
-    {
-      PenaltyCross pc_classified(pc);
-      checkPenaltyCross(pc_classified);
-      if (pc.fromUpper)
-        localPenaltyCrossHypotheses.penaltyCrossesUpper.push_back(pc_classified);
-      else
-        localPenaltyCrossHypotheses.penaltyCrosses.push_back(pc_classified);
-
-      if (pc_classified.validity > penaltyCrossThreshold)
-      {
-        const CameraMatrix& cameraMatrix = pc.fromUpper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-        const CameraInfo& cameraInfo = pc.fromUpper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
-        Vector2f pImage(pc.positionInImage);
-        Vector2f pField;
-        if (Transformation::imageToRobot(pImage, cameraMatrix, cameraInfo, pField))
-        {
-          if (pauseLogOnDetection)
-            OUTPUT(idConsole, text, "log pause");
-          thePenaltyCrossPercept.penaltyCrossWasSeen = true;
-          thePenaltyCrossPercept.detectionType = detectionType;
-          thePenaltyCrossPercept.pointInImage = pImage.cast<int>();
-          thePenaltyCrossPercept.pointOnField = pField.cast<int>();
-          thePenaltyCrossPercept.fromUpper = pc.fromUpper;
-          if (stopOnFirstDetection)
-            pcFound = true;
-        }
-      }
-    }
-    if (pcFound)
-      return true;
+    Candidate& candidate = candidates.emplace_back();
+    candidate.penaltyCross = pc;
+    candidate.detectionType = detectionType;
+    submitPenaltyCross(candidate);
   }
-  return false;
 }
 
-void PenaltyCrossClassifier::checkPenaltyCross(PenaltyCross& penaltyCross)
+void PenaltyCrossClassifier::submitPenaltyCross(Candidate& candidate)
 {
+  PenaltyCross& penaltyCross = candidate.penaltyCross;
+  penaltyCross.validity = 0.f;
   if (processedPenaltyCrossHypotheses >= static_cast<size_t>(maxNumberOfHypotheses))
+    return;
+  if (!isNearPenaltyMark(penaltyCross))
   {
-    penaltyCross.validity = 0.f;
+    gatedPenaltyCrossHypotheses++;
     return;
   }
 
-  char buffer[10];
   const Image& image = penaltyCross.fromUpper ? (Image&)theImageUpper : theImage;
   const CameraMatrix& cameraMatrix = penaltyCross.fromUpper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
   const CameraInfo& cameraInfo = penaltyCross.fromUpper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
@@ -136,52 +94,102 @@ void PenaltyCrossClassifier::checkPenaltyCross(PenaltyCross& penaltyCross)
   float diameter = Geometry::calculateLineSizePrecise(centerPosInImage, cameraMatrix, cameraInfo, theFieldDimensions.penaltyMarkSize) * zoomOutFactor;
   bool projected = penaltyCross.fromUpper ? theImageUpper.projectIntoImage(centerPosInImage, diameter / 2.f) : theImage.projectIntoImage(centerPosInImage, diameter / 2.f);
   if (!projected)
-  {
-    penaltyCross.validity = 0.f;
     return;
-  }
 
-  const Vector2f patchSize(diameter, diameter);
-  const Vector2i patchPos = (centerPosInImage.cast<float>() - (patchSize / 2.f) + Vector2f::Constant(0.5f)).cast<int>();
+  candidate.centerPosInImage = centerPosInImage;
+  candidate.patchSize = Vector2f(diameter, diameter);
+  candidate.patchPos = (centerPosInImage.cast<float>() - (candidate.patchSize / 2.f) + Vector2f::Constant(0.5f)).cast<int>();
 
-  float* input = interpreter->typed_tensor<float>(interpreter->inputs()[0]);
+  penaltyCross.patch.resize(PENALTY_CROSS_SIZE * PENALTY_CROSS_SIZE * 3);
   STOPWATCH("PenaltyCrossClassifier-checkPenaltyCrosses-copyAndResize")
   {
-    image.copyAndResizeArea(patchPos, patchSize.cast<int>(), {PENALTY_CROSS_SIZE, PENALTY_CROSS_SIZE}, input);
+    image.copyAndResizeArea(candidate.patchPos, candidate.patchSize.cast<int>(), {PENALTY_CROSS_SIZE, PENALTY_CROSS_SIZE}, penaltyCross.patch.data());
   }
 
-  float* output = interpreter->typed_tensor<float>(interpreter->outputs()[0]);
-  STOPWATCH("PenaltyCrossClassifier-checkPenaltyCrosses-runNet")
+  ASSERT(classifier->inputBytes == penaltyCross.patch.size() * sizeof(float));
+  candidate.result = theTfliteInferenceService.submit(*classifier, penaltyCross.patch.data());
+  candidate.submitted = true;
+  processedPenaltyCrossHypotheses++;
+}
+
+bool PenaltyCrossClassifier::isNearPenaltyMark(const PenaltyCross& penaltyCross) const
+{
+  if (!gateByRobotPose || theRobotPose.validity < minRobotPoseValidityForGating)
+    return true;
+
+  const CameraMatrix& cameraMatrix = penaltyCross.fromUpper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const CameraInfo& cameraInfo = penaltyCross.fromUpper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  Vector2f pRobot;
+  if (!Transformation::imageToRobot(penaltyCross.positionInImage, cameraMatrix, cameraInfo, pRobot))
+    return false;
+
+  // the farther the hypothesis, the larger the error of its projection and of the rotation of the robot pose
+  const float maxDistance = maxDistanceToPenaltyMark + maxDistanceToPenaltyMarkRatio * pRobot.norm();
+  const Vector2f pField = theRobotPose * pRobot;
+  return (pField - Vector2f(theFieldDimensions.xPosOpponentPenaltyMark, 0.f)).squaredNorm() < sqr(maxDistance)
+         || (pField - Vector2f(theFieldDimensions.xPosOwnPenaltyMark, 0.f)).squaredNorm() < sqr(maxDistance);
+}
+
+bool PenaltyCrossClassifier::checkPenaltyCross(PenaltyCrossPercept& thePenaltyCrossPercept, Candidate& candidate)
+{
+  PenaltyCross& penaltyCross = candidate.penaltyCross;
+  if (candidate.submitted)
   {
-    if (interpreter->Invoke() != kTfLiteOk)
+    const TfliteInferenceService::Outputs outputs = theTfliteInferenceService.get(candidate.result);
+    if (outputs.empty())
+      processedPenaltyCrossHypotheses--;
+    else
     {
-      OUTPUT_ERROR("Failed to invoke tflite!");
-      penaltyCross.validity = 0.f;
-      return;
+      const float output = outputs[0][0];
+      const Vector2i& patchPos = candidate.patchPos;
+      const Vector2f& patchSize = candidate.patchSize;
+      char buffer[10];
+      if (penaltyCross.fromUpper)
+      {
+        COMPLEX_DRAWING("module:PenaltyCrossClassifier:Image:Upper")
+        {
+          RECTANGLE("module:PenaltyCrossClassifier:Image:Upper", patchPos.x(), patchPos.y(), patchPos.x() + patchSize.x(), patchPos.y() + patchSize.y(), 3, Drawings::solidPen, ColorRGBA::black);
+          sprintf(buffer, "%.1f", output * 100.f);
+          DRAWTEXT("module:PenaltyCrossClassifier:Image:Upper", patchPos.x(), candidate.centerPosInImage.y() - (patchSize.y() * 0.15f), static_cast<int>(patchSize.x() * 0.25f), ColorRGBA::black, buffer << "%");
+        }
+      }
+      else
+      {
+        COMPLEX_DRAWING("module:PenaltyCrossClassifier:Image:Lower")
+        {
+          RECTANGLE("module:PenaltyCrossClassifier:Image:Lower", patchPos.x(), patchPos.y(), patchPos.x() + patchSize.x(), patchPos.y() + patchSize.y(), 3, Drawings::solidPen, ColorRGBA::black);
+          sprintf(buffer, "%.1f", output * 100.f);
+          DRAWTEXT("module:PenaltyCrossClassifier:Image:Lower", patchPos.x(), candidate.centerPosInImage.y() - (patchSize.y() * 0.15f), static_cast<int>(patchSize.x() * 0.25f), ColorRGBA::black, buffer << "%");
+        }
+      }
+      penaltyCross.validity = output;
     }
   }
 
   if (penaltyCross.fromUpper)
-  {
-    COMPLEX_DRAWING("module:PenaltyCrossClassifier:Image:Upper")
-    {
-      RECTANGLE("module:PenaltyCrossClassifier:Image:Upper", patchPos.x(), patchPos.y(), patchPos.x() + patchSize.x(), patchPos.y() + patchSize.y(), 3, Drawings::solidPen, ColorRGBA::black);
-      sprintf(buffer, "%.1f", *output * 100.f);
-      DRAWTEXT("module:PenaltyCrossClassifier:Image:Upper", patchPos.x(), centerPosInImage.y() - (patchSize.y() * 0.15f), static_cast<int>(patchSize.x() * 0.25f), ColorRGBA::black, buffer << "%");
-    }
-  }
+    localPenaltyCrossHypotheses.penaltyCrossesUpper.push_back(penaltyCross);
   else
+    localPenaltyCrossHypotheses.penaltyCrosses.push_back(penaltyCross);
+
+  if (penaltyCross.validity > penaltyCrossThreshold)
   {
-    COMPLEX_DRAWING("module:PenaltyCrossClassifier:Image:Lower")
+    const CameraMatrix& cameraMatrix = penaltyCross.fromUpper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+    const CameraInfo& cameraInfo = penaltyCross.fromUpper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+    Vector2f pImage(penaltyCross.positionInImage);
+    Vector2f pField;
+    if (Transformation::imageToRobot(pImage, cameraMatrix, cameraInfo, pField))
     {
-      RECTANGLE("module:PenaltyCrossClassifier:Image:Lower", patchPos.x(), patchPos.y(), patchPos.x() + patchSize.x(), patchPos.y() + patchSize.y(), 3, Drawings::solidPen, ColorRGBA::black);
-      sprintf(buffer, "%.1f", *output * 100.f);
-      DRAWTEXT("module:PenaltyCrossClassifier:Image:Lower", patchPos.x(), centerPosInImage.y() - (patchSize.y() * 0.15f), static_cast<int>(patchSize.x() * 0.25f), ColorRGBA::black, buffer << "%");
+      if (pauseLogOnDetection)
+        OUTPUT(idConsole, text, "log pause");
+      thePenaltyCrossPercept.penaltyCrossWasSeen = true;
+      thePenaltyCrossPercept.detectionType = candidate.detectionType;
+      thePenaltyCrossPercept.pointInImage = pImage.cast<int>();
+      thePenaltyCrossPercept.pointOnField = pField.cast<int>();
+      thePenaltyCrossPercept.fromUpper = penaltyCross.fromUpper;
+      return true;
     }
   }
-  penaltyCross.validity = *output;
-  penaltyCross.patch = std::vector<float>{input, input + PENALTY_CROSS_SIZE * PENALTY_CROSS_SIZE * 3};
-  processedPenaltyCrossHypotheses++;
+  return false;
 }
 
 MAKE_MODULE(PenaltyCrossClassifier, perception);
@@ -7,9 +7,11 @@
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Modeling/RobotPose.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/PenaltyCrossHypotheses.h"
 #include "Representations/Perception/PenaltyCrossPercept.h"
+#include "Representations/Perception/TfliteInferenceService.h"
 #include "Tools/Debugging/DebugDrawings.h"
 #include "Tools/Module/Module.h"
 
@@ -18,12 +20,6 @@
 #include <cstdio>
 #include "Modules/Perception/TFlite.h"
 
-#define TFLITE_MINIMAL_CHECK(x)                              \
-  if (!(x))                                                  \
-  {                                                          \
-    OUTPUT_TEXT("Error at " << __FILE__ << ":" << __LINE__); \
-  }
-
 MODULE(PenaltyCrossClassifier,
   REQUIRES(FrameInfo),
   REQUIRES(ImageUpper),
@@ -35,6 +31,8 @@ MODULE(PenaltyCrossClassifier,
   REQUIRES(FieldDimensions),
   REQUIRES(PrePenaltyCrossHypothesesYolo),
   REQUIRES(PrePenaltyCrossHypothesesScanlines),
+  REQUIRES(TfliteInferenceService),
+  USES(RobotPose),
 
   PROVIDES(PenaltyCrossHypotheses),
   PROVIDES(PenaltyCrossPercept),
@@ -46,7 +44,11 @@ MODULE(PenaltyCrossClassifier,
     (bool)(true) stopOnFirstDetection,
     (bool)(true) pauseLogOnDetection,
     (std::string) modelName,
-    (int)(20) maxNumberOfHypotheses
+    (int)(20) maxNumberOfHypotheses,
+    (bool)(true) gateByRobotPose, // Only classify hypotheses close to a penalty mark if the robot pose is valid enough
+    (float)(0.5f) minRobotPoseValidityForGating,
+    (float)(500.f) maxDistanceToPenaltyMark, // The distance of a hypothesis on the field to the closest penalty mark that is always accepted (in mm)
+    (float)(0.2f) maxDistanceToPenaltyMarkRatio // The part of the distance of a hypothesis to the robot that is added to maxDistanceToPenaltyMark
   )
 );
 
@@ -54,24 +56,44 @@ MODULE(PenaltyCrossClassifier,
 class PenaltyCrossClassifier : public PenaltyCrossClassifierBase
 {
 public:
-  PenaltyCrossClassifier();
-
   void update(PenaltyCrossPercept& thePenaltyCrossPercept);
   void update(PenaltyCrossHypotheses& thePenaltyCrossHypotheses);
 
-  std::unique_ptr<tflite::Interpreter> interpreter;
-
 private:
-  std::unique_ptr<tflite::FlatBufferModel> model;
-  tflite::ops::builtin::BuiltinOpResolver resolver;
+  /** A hypothesis whose patch was submitted to the classifier. */
+  struct Candidate
+  {
+    PenaltyCross penaltyCross;
+    PenaltyCrossPercept::DetectionType detectionType;
+    Vector2i centerPosInImage = Vector2i::Zero();
+    Vector2i patchPos = Vector2i::Zero();
+    Vector2f patchSize = Vector2f::Zero();
+    bool submitted = false; /**< Is the result pending? Otherwise, the validity is 0. */
+    std::future<TfliteInferenceService::Outputs> result;
+  };
+
+  const TfliteInferenceService::Model* classifier = nullptr;
   PenaltyCrossHypotheses localPenaltyCrossHypotheses;
   PenaltyCrossPercept localPenaltyCrossPercept;
 
   size_t sumOfPenaltyCrossHypotheses;
   size_t processedPenaltyCrossHypotheses;
+  size_t gatedPenaltyCrossHypotheses;
 
   void execute(tf::Subflow&);
   void initClassifier();
-  bool checkPenaltyCrosses(PenaltyCrossPercept& thePenaltyCrossPercept, const std::vector<PenaltyCross> penaltyCrosses, PenaltyCrossPercept::DetectionType detectionType);
-  void checkPenaltyCross(PenaltyCross& penaltyCross);
+  void submitPenaltyCrosses(std::vector<Candidate>& candidates, const std::vector<PenaltyCross>& penaltyCrosses, PenaltyCrossPercept::DetectionType detectionType);
+  void submitPenaltyCross(Candidate& candidate);
+
+  /**
+   * Checks whether a hypothesis can be a penalty mark given the robot pose.
+   * @return Is it close enough to one of the penalty marks? Always true if the robot pose is not valid enough.
+   */
+  bool isNearPenaltyMark(const PenaltyCross& penaltyCross) const;
+
+  /**
+   * Waits for the classification of a candidate and adds it to the hypotheses.
+   * @return Was the penalty cross detected?
+   */
+  bool checkPenaltyCross(PenaltyCrossPercept& thePenaltyCrossPercept, Candidate& candidate);
 };
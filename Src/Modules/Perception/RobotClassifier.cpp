@@ -2,13 +2,6 @@
 #include "Platform/File.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 
-RobotClassifier::RobotClassifier()
-{
-  std::string basePath = std::string(File::getBHDir()) + "/Config/tflite/robot/";
-  initModel(basePath + "robot_classifier_rec_0.824_thr_0.828.tflite", classificationModelInterpreter, classificationModel);
-  initModel(basePath + "bbox_correctifier_y_rel_0.057.tflite", bboxCorrectionModelInterpreter, bboxCorrectionModel);
-}
-
 void RobotClassifier::update(RobotsPerceptClassified& robotsPerceptClassified)
 {
   std::swap(robotsPerceptClassified, localRobotsPerceptClassified);
@@ -21,6 +14,12 @@ void RobotClassifier::update(ProcessedRobotsHypotheses& processedRobotsHypothese
 
 void RobotClassifier::execute(tf::Subflow&)
 {
+  // the models are registered here, since the inference service is not available in the constructor
+  if (!classificationModel)
+    initModel("tflite/robot/robot_classifier_rec_0.824_thr_0.828.tflite", "RobotClassifier:classification", classificationModel, classificationInput);
+  if (!bboxCorrectionModel)
+    initModel("tflite/robot/bbox_correctifier_y_rel_0.057.tflite", "RobotClassifier:bboxCorrection", bboxCorrectionModel, bboxCorrectionInput);
+
   DECLARE_PLOT("module:RobotClassifier:sumOfRobotsHypotheses");
   DECLARE_PLOT("module:RobotClassifier:processedRobotsHypotheses");
   DECLARE_PLOT("module:RobotClassifier:validatedRobotPercepts");
@@ -52,41 +51,48 @@ void RobotClassifier::execute(tf::Subflow&)
     std::sort(sortedHyptotheses.begin(), sortedHyptotheses.end(), sorting_criteria);
 
     sumOfRobotsHypotheses += sortedHyptotheses.size();
-    for (auto& estimate : sortedHyptotheses)
+    if (useBatchedClassification)
     {
-      Stopwatch s2("RobotClassifier-checkRobotEstimate");
-      RobotEstimate& re = localRobotsHypotheses.robots.emplace_back(estimate);
-      // check if the estimate can be filtered fast
-      if (filterNms(re, false))
-      {
-        re.validity = 0;
-        continue;
-      }
-      // if budget is exceeded, print debug info and continue
-      if (classified >= maxClassficationsLower)
-      {
-        RECTANGLE(
-            "module:RobotClassifier:declinedRobotPercepts:Lower", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(75, 75, 75, 200));
-        std::string str = "lower clf budget exceeded ";
-        str.append(std::to_string(classified));
-        DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Lower", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), str);
-        continue;
-      }
-      // else update with nets
-      updateEstimate(theImage, re);
-      classified++;
-      processedRobotsHypotheses++;
-      if (re.validity >= classifierThresholdLower)
-      {
-        localRobotsPerceptClassified.robots.push_back(re);
-        continue;
-      }
-      else
+      classifyEstimates(theImagePyramid, sortedHyptotheses, maxClassficationsLower, classifierThresholdLower, classified, false);
+    }
+    else
+    {
+      for (auto& estimate : sortedHyptotheses)
       {
-        // if not accepted, print debug info
-        RECTANGLE(
-            "module:RobotClassifier:declinedRobotPercepts:Lower", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(0, 0, 0, 200));
-        DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Lower", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), re.validity);
+        Stopwatch s2("RobotClassifier-checkRobotEstimate");
+        RobotEstimate& re = localRobotsHypotheses.robots.emplace_back(estimate);
+        // check if the estimate can be filtered fast
+        if (filterNms(re, false))
+        {
+          re.validity = 0;
+          continue;
+        }
+        // if budget is exceeded, print debug info and continue
+        if (classified >= maxClassficationsLower)
+        {
+          RECTANGLE(
+              "module:RobotClassifier:declinedRobotPercepts:Lower", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(75, 75, 75, 200));
+          std::string str = "lower clf budget exceeded ";
+          str.append(std::to_string(classified));
+          DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Lower", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), str);
+          continue;
+        }
+        // else update with nets
+        updateEstimate(theImagePyramid, re);
+        classified++;
+        processedRobotsHypotheses++;
+        if (re.validity >= classifierThresholdLower)
+        {
+          localRobotsPerceptClassified.robots.push_back(re);
+          continue;
+        }
+        else
+        {
+          // if not accepted, print debug info
+          RECTANGLE(
+              "module:RobotClassifier:declinedRobotPercepts:Lower", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(0, 0, 0, 200));
+          DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Lower", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), re.validity);
+        }
       }
     }
   }
@@ -99,41 +105,48 @@ void RobotClassifier::execute(tf::Subflow&)
     std::sort(sortedHyptotheses.begin(), sortedHyptotheses.end(), sorting_criteria);
 
     sumOfRobotsHypotheses += sortedHyptotheses.size();
-    for (auto& estimate : sortedHyptotheses)
+    if (useBatchedClassification)
     {
-      Stopwatch s2("RobotClassifier-checkRobotEstimate");
-      RobotEstimate& re = localRobotsHypotheses.robots.emplace_back(estimate);
-      // check if the estimate can be filtered fast
-      if (filterNms(re, false))
-      {
-        re.validity = 0;
-        continue;
-      }
-      // if budget is exceeded, print debug info and continue
-      if (classified >= maxClassficationsTotal)
-      {
-        RECTANGLE(
-            "module:RobotClassifier:declinedRobotPercepts:Upper", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(75, 75, 75, 200));
-        std::string str = "clf budget exceeded ";
-        str.append(std::to_string(classified));
-        DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Upper", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), str);
-        continue;
-      }
-      // else update the estimate
-      updateEstimate(theImageUpper, re);
-      classified++;
-      processedRobotsHypotheses++;
-      if (re.validity >= classifierThreshold)
-      {
-        localRobotsPerceptClassified.robots.push_back(re);
-        continue;
-      }
-      else
+      classifyEstimates(theImagePyramidUpper, sortedHyptotheses, maxClassficationsTotal, classifierThreshold, classified, true);
+    }
+    else
+    {
+      for (auto& estimate : sortedHyptotheses)
       {
-        // if not accepted, print debug info
-        RECTANGLE(
-            "module:RobotClassifier:declinedRobotPercepts:Upper", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(0, 0, 0, 200));
-        DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Upper", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), re.validity);
+        Stopwatch s2("RobotClassifier-checkRobotEstimate");
+        RobotEstimate& re = localRobotsHypotheses.robots.emplace_back(estimate);
+        // check if the estimate can be filtered fast
+        if (filterNms(re, false))
+        {
+          re.validity = 0;
+          continue;
+        }
+        // if budget is exceeded, print debug info and continue
+        if (classified >= maxClassficationsTotal)
+        {
+          RECTANGLE(
+              "module:RobotClassifier:declinedRobotPercepts:Upper", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(75, 75, 75, 200));
+          std::string str = "clf budget exceeded ";
+          str.append(std::to_string(classified));
+          DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Upper", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), str);
+          continue;
+        }
+        // else update the estimate
+        updateEstimate(theImagePyramidUpper, re);
+        classified++;
+        processedRobotsHypotheses++;
+        if (re.validity >= classifierThreshold)
+        {
+          localRobotsPerceptClassified.robots.push_back(re);
+          continue;
+        }
+        else
+        {
+          // if not accepted, print debug info
+          RECTANGLE(
+              "module:RobotClassifier:declinedRobotPercepts:Upper", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, ColorRGBA(0, 0, 0, 200));
+          DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Upper", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), re.validity);
+        }
       }
     }
   }
@@ -144,82 +157,185 @@ void RobotClassifier::execute(tf::Subflow&)
   PLOT("module:RobotClassifier:declinedRobotPercepts", (processedRobotsHypotheses - validatedRobotPercepts));
 }
 
-void RobotClassifier::initModel(std::string path, std::unique_ptr<tflite::Interpreter>& interpreter, std::unique_ptr<tflite::FlatBufferModel>& model)
+void RobotClassifier::initModel(const std::string& filename, const std::string& modelName, const TfliteInferenceService::Model*& model, std::vector<unsigned char>& input)
 {
-  // Load the model
-  model = tflite::FlatBufferModel::BuildFromFile(path.c_str());
-  TFLITE_MINIMAL_CHECK(model != nullptr);
-
-  // Build the interpreter
-  tflite::InterpreterBuilder builder(*model, resolver);
-  builder(&interpreter);
-  TFLITE_MINIMAL_CHECK(interpreter != nullptr);
-  interpreter->SetNumThreads(1);
-
-  // Allocate memory for the tensors
-  interpreter->AllocateTensors();
-
-  // Check interpreter state
-  // tflite::PrintInterpreterState(featureModelInterpreter.get());
+  // all estimates of an image can be run in one batch
+  model = theTfliteInferenceService.loadModel(modelName, filename, TfliteInferenceService::normal, std::max(maxClassficationsLower, maxClassficationsTotal));
+  if (model)
+    input.resize(model->inputBytes);
 }
 
-void RobotClassifier::updateEstimate(const Image& image, RobotEstimate& re)
+void RobotClassifier::updateEstimate(const ImagePyramid& imagePyramid, RobotEstimate& re)
 {
   Stopwatch s("RobotClassifier-updateEstimate");
+  if (!classificationModel || !bboxCorrectionModel)
+    return;
   // skip if not valid to avoid unnecessary bbox correction
-  if (classifyEstimate(image, re))
+  if (classifyEstimate(imagePyramid, re))
   {
-    correctBbox(image, re);
+    correctBbox(imagePyramid, re);
     filterNms(re, true);
   }
 }
 
-bool RobotClassifier::classifyEstimate(const Image& image, RobotEstimate& re)
+bool RobotClassifier::classifyEstimate(const ImagePyramid& imagePyramid, RobotEstimate& re)
 {
   Stopwatch s("RobotClassifier-classifyEstimate");
-  const Vector2i reSize = re.imageLowerRight - re.imageUpperLeft;
-  const Vector2i margin = (reSize.cast<float>() * classifierMargin + Vector2f::Constant(0.5f)).cast<int>();
-
-  const Vector2i upperLeftArea = re.imageUpperLeft - margin;
-  const Vector2i sizeArea = reSize + 2 * margin;
-
   // get features
-  int* inputDims = classificationModelInterpreter->input_tensor(0)->dims->data;
   {
     Stopwatch s2("RobotClassifier-classifyEstimate-copyImageAndRunNet");
     {
       Stopwatch s3("RobotClassifier-classifyEstimate-copyAndResize");
-      // dim shape is (batchSize, height, width, channels)
-      image.copyAndResizeArea(upperLeftArea, sizeArea, {inputDims[2], inputDims[1]}, classificationModelInterpreter->typed_input_tensor<unsigned char>(0));
-      if (!re.fromUpperImage && re.imageUpperLeft.y() < 0)
-      {
-        Vector2i ul = re.imageUpperLeft;
-        Vector2i lr = re.imageLowerRight;
-        getUpperImageCoordinates(re, ul.x(), ul.y(), lr.x(), lr.y());
-        theImageUpper.copyAndResizeArea<true, true, false>(ul, lr - ul, {inputDims[2], inputDims[1]}, classificationModelInterpreter->typed_input_tensor<unsigned char>(0));
-      }
+      copyClassificationPatch(imagePyramid, re, classificationInput.data());
     }
     {
       Stopwatch s3("RobotClassifier-classifyEstimate-runNet");
-      if (classificationModelInterpreter->Invoke() != kTfLiteOk)
-      {
-        OUTPUT_ERROR("Failed to invoke tflite!");
+      std::future<TfliteInferenceService::Outputs> result = theTfliteInferenceService.submit(*classificationModel, classificationInput.data());
+      classificationOutput = theTfliteInferenceService.get(result);
+      if (classificationOutput.empty())
         return true;
-      }
     }
-    float* classificationOutput = classificationModelInterpreter->typed_output_tensor<float>(0);
 
-    re.validity = classificationOutput[0];
+    re.validity = classificationOutput[0][0];
   }
   return re.fromUpperImage ? re.validity >= classifierThreshold : re.validity >= classifierThresholdLower;
 }
 
-void RobotClassifier::correctBbox(const Image& image, RobotEstimate& re)
+void RobotClassifier::classifyEstimates(const ImagePyramid& imagePyramid, const std::vector<RobotEstimate>& sortedHypotheses, int maxClassifications, float threshold, int& classified, bool upper)
+{
+  Stopwatch s("RobotClassifier-classifyEstimates");
+  if (!classificationModel || !bboxCorrectionModel)
+    return;
+
+  // the estimates that are not filtered by the percepts of the other image are classified until the budget is exceeded
+  std::vector<size_t> estimates;
+  for (const RobotEstimate& estimate : sortedHypotheses)
+  {
+    RobotEstimate& re = localRobotsHypotheses.robots.emplace_back(estimate);
+    if (filterNms(re, false))
+    {
+      re.validity = 0;
+      continue;
+    }
+    if (classified >= maxClassifications)
+    {
+      drawDeclined(re, upper, ColorRGBA(75, 75, 75, 200), (upper ? "clf budget exceeded " : "lower clf budget exceeded ") + std::to_string(classified));
+      continue;
+    }
+    estimates.push_back(localRobotsHypotheses.robots.size() - 1);
+    classified++;
+    processedRobotsHypotheses++;
+  }
+
+  // the patches are written directly into the batched input tensor by the worker that runs the net
+  std::vector<std::future<TfliteInferenceService::Outputs>> results;
+  {
+    Stopwatch s2("RobotClassifier-classifyEstimates-classification");
+    for (const size_t index : estimates)
+      results.push_back(theTfliteInferenceService.submit(*classificationModel,
+          [this, &imagePyramid, re = localRobotsHypotheses.robots[index]](void* input)
+          {
+            copyClassificationPatch(imagePyramid, re, static_cast<unsigned char*>(input));
+          }));
+
+    std::vector<size_t> accepted;
+    for (size_t i = 0; i < estimates.size(); ++i)
+    {
+      RobotEstimate& re = localRobotsHypotheses.robots[estimates[i]];
+      const TfliteInferenceService::Outputs outputs = theTfliteInferenceService.get(results[i]);
+      if (!outputs.empty())
+        re.validity = outputs[0][0];
+      if (outputs.empty() || re.validity >= threshold)
+        accepted.push_back(estimates[i]);
+      else
+        drawDeclined(re, upper, ColorRGBA(0, 0, 0, 200), std::to_string(re.validity));
+    }
+    estimates.swap(accepted);
+  }
+
+  // the bboxes of all accepted estimates are predicted in one batch
+  Stopwatch s2("RobotClassifier-classifyEstimates-bboxCorrection");
+  results.clear();
+  if (useBboxPrediction)
+    for (const size_t index : estimates)
+      results.push_back(theTfliteInferenceService.submit(*bboxCorrectionModel,
+          [this, &imagePyramid, re = localRobotsHypotheses.robots[index]](void* input)
+          {
+            copyBboxCorrectionPatch(imagePyramid, re, static_cast<unsigned char*>(input));
+          }));
+
+  for (size_t i = 0; i < estimates.size(); ++i)
+  {
+    RobotEstimate& re = localRobotsHypotheses.robots[estimates[i]];
+    // if the bbox correction failed, the bbox is kept
+    TfliteInferenceService::Outputs outputs;
+    if (useBboxPrediction)
+      outputs = theTfliteInferenceService.get(results[i]);
+    if (!useBboxPrediction || !outputs.empty())
+      correctBbox(imagePyramid, re, useBboxPrediction ? &outputs[0] : nullptr);
+    filterNms(re, true);
+    if (re.validity >= threshold)
+      localRobotsPerceptClassified.robots.push_back(re);
+    else
+      drawDeclined(re, upper, ColorRGBA(0, 0, 0, 200), std::to_string(re.validity));
+  }
+}
+
+void RobotClassifier::getArea(const RobotEstimate& re, float areaMargin, Vector2i& upperLeftArea, Vector2i& sizeArea) const
+{
+  const Vector2i reSize = re.imageLowerRight - re.imageUpperLeft;
+  const Vector2i margin = (reSize.cast<float>() * areaMargin + Vector2f::Constant(0.5f)).cast<int>();
+
+  upperLeftArea = re.imageUpperLeft - margin;
+  sizeArea = reSize + 2 * margin;
+}
+
+void RobotClassifier::copyClassificationPatch(const ImagePyramid& imagePyramid, const RobotEstimate& re, unsigned char* input) const
+{
+  Vector2i upperLeftArea, sizeArea;
+  getArea(re, classifierMargin, upperLeftArea, sizeArea);
+
+  // dim shape is (batchSize, height, width, channels)
+  const int* inputDims = classificationModel->inputDims.data();
+  imagePyramid.copyAndResizeArea(upperLeftArea, sizeArea, {inputDims[2], inputDims[1]}, input);
+  if (!re.fromUpperImage && re.imageUpperLeft.y() < 0)
+  {
+    int ulX, ulY, lrX, lrY;
+    getUpperImageCoordinates(re, ulX, ulY, lrX, lrY);
+    theImagePyramidUpper.copyAndResizeArea<true, true, false>({ulX, ulY}, {lrX - ulX, lrY - ulY}, {inputDims[2], inputDims[1]}, input);
+  }
+}
+
+void RobotClassifier::copyBboxCorrectionPatch(const ImagePyramid& imagePyramid, const RobotEstimate& re, unsigned char* input) const
+{
+  Vector2i upperLeftArea, sizeArea;
+  getArea(re, bboxMargin, upperLeftArea, sizeArea);
+
+  // dim shape is (batchSize, height, width, channels)
+  const int* inputDims = bboxCorrectionModel->inputDims.data();
+  imagePyramid.copyAndResizeArea(upperLeftArea, sizeArea, {inputDims[2], inputDims[1]}, input);
+}
+
+void RobotClassifier::drawDeclined(const RobotEstimate& re, bool upper, const ColorRGBA& color, const std::string& text)
+{
+  if (upper)
+  {
+    RECTANGLE("module:RobotClassifier:declinedRobotPercepts:Upper", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, color);
+    DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Upper", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), text);
+  }
+  else
+  {
+    RECTANGLE("module:RobotClassifier:declinedRobotPercepts:Lower", re.imageUpperLeft.x(), re.imageUpperLeft.y(), re.imageLowerRight.x(), re.imageLowerRight.y(), 2, Drawings::dottedPen, color);
+    DRAWTEXT("module:RobotClassifier:declinedRobotPercepts:Lower", re.imageLowerRight.x(), re.imageLowerRight.y(), 10, ColorRGBA(0, 0, 0, 200), text);
+  }
+}
+
+void RobotClassifier::correctBbox(const ImagePyramid& imagePyramid, RobotEstimate& re, const std::vector<float>* prediction)
 {
   if (useBboxPrediction)
   {
     int xUlPred, yUlPred, xLrPred, yLrPred;
-    predictBbox(image, re, xUlPred, yUlPred, xLrPred, yLrPred);
+    predictBbox(imagePyramid, re, prediction, xUlPred, yUlPred, xLrPred, yLrPred);
     if (interpolatePredictedBbox)
     {
       interpolateBbox(re, xUlPred, yUlPred, xLrPred, yLrPred, interpolatePredictedBboxFactor, false);
@@ -298,41 +414,36 @@ void RobotClassifier::interpolateBbox(RobotEstimate& re, int& xUl, int& yUl, int
     re.imageLowerRight.y() = static_cast<int>(midYInterpolated + heightInterpolated / 2);
 }
 
-void RobotClassifier::predictBbox(const Image& image, RobotEstimate& re, int& xUl, int& yUl, int& xLr, int& yLr)
+void RobotClassifier::predictBbox(const ImagePyramid& imagePyramid, RobotEstimate& re, const std::vector<float>* prediction, int& xUl, int& yUl, int& xLr, int& yLr)
 {
   Stopwatch s("RobotClassifier-correctBbox");
-  const Vector2i reSize = re.imageLowerRight - re.imageUpperLeft;
-  const Vector2i margin = (reSize.cast<float>() * bboxMargin + Vector2f::Constant(0.5f)).cast<int>();
-
-  const Vector2i upperLeftArea = re.imageUpperLeft - margin;
-  const Vector2i sizeArea = reSize + 2 * margin;
-
-  // get features
-  int* inputDims = classificationModelInterpreter->input_tensor(0)->dims->data;
+  Vector2i upperLeftArea, sizeArea;
+  getArea(re, bboxMargin, upperLeftArea, sizeArea);
 
   // get bbox
   {
     Stopwatch s2("RobotClassifier-correctBbox-copyImageAndRunNet");
-    inputDims = bboxCorrectionModelInterpreter->input_tensor(0)->dims->data;
-    {
-      Stopwatch s3("RobotClassifier-correctBbox-copyAndResize");
-      // dim shape is (batchSize, height, width, channels)
-      image.copyAndResizeArea(upperLeftArea, sizeArea, {inputDims[2], inputDims[1]}, bboxCorrectionModelInterpreter->typed_input_tensor<unsigned char>(0));
-    }
+    if (!prediction)
     {
-      Stopwatch s3("RobotClassifier-correctBbox-runNet");
-      if (bboxCorrectionModelInterpreter->Invoke() != kTfLiteOk)
       {
-        OUTPUT_ERROR("Failed to invoke tflite!");
-        return;
+        Stopwatch s3("RobotClassifier-correctBbox-copyAndResize");
+        copyBboxCorrectionPatch(imagePyramid, re, bboxCorrectionInput.data());
+      }
+      {
+        Stopwatch s3("RobotClassifier-correctBbox-runNet");
+        std::future<TfliteInferenceService::Outputs> result = theTfliteInferenceService.submit(*bboxCorrectionModel, bboxCorrectionInput.data());
+        bboxCorrectionOutput = theTfliteInferenceService.get(result);
+        if (bboxCorrectionOutput.empty())
+          return;
       }
+      prediction = &bboxCorrectionOutput[0];
     }
     // old bbox before corrections
     const Vector2i oldUl = re.imageUpperLeft;
     const Vector2i oldLr = re.imageLowerRight;
 
     // outputs
-    float* bboxOutput = bboxCorrectionModelInterpreter->typed_output_tensor<float>(0);
+    const float* bboxOutput = prediction->data();
     const Vector2f midRel(bboxOutput[0], bboxOutput[1]);
     const Vector2f sizeRel(bboxOutput[2], bboxOutput[2]);
 
@@ -438,7 +549,7 @@ float RobotClassifier::iou(const RobotEstimate& re1, const RobotEstimate& re2)
   return intersection / (float)unite;
 }
 
-void RobotClassifier::getUpperImageCoordinates(const RobotEstimate& re, int& upperLeftX, int& upperLeftY, int& lowerRightX, int& lowerRightY)
+void RobotClassifier::getUpperImageCoordinates(const RobotEstimate& re, int& upperLeftX, int& upperLeftY, int& lowerRightX, int& lowerRightY) const
 {
   if (re.fromUpperImage)
   {
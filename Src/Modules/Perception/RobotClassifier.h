@@ -5,6 +5,7 @@
 
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/Image.h"
+#include "Representations/Infrastructure/ImagePyramid.h"
 #include "Representations/Infrastructure/TeamInfo.h"
 #include "Representations/Perception/FieldColor.h"
 #include "Representations/Perception/RobotsPercept.h"
@@ -12,6 +13,7 @@
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Perception/CameraMatrix.h"
+#include "Representations/Perception/TfliteInferenceService.h"
 
 #include "Tools/Debugging/Debugging.h"
 
@@ -23,12 +25,15 @@ MODULE(RobotClassifier,
   REQUIRES(FrameInfo),
   REQUIRES(Image),
   REQUIRES(ImageUpper),
+  REQUIRES(ImagePyramid),
+  REQUIRES(ImagePyramidUpper),
   REQUIRES(CameraInfo),
   REQUIRES(CameraInfoUpper),
   REQUIRES(CameraMatrix),
   REQUIRES(CameraMatrixUpper),
   REQUIRES(RobotsHypothesesYolo),
   REQUIRES(RobotsHypothesesYoloUpper),
+  REQUIRES(TfliteInferenceService),
 
   PROVIDES(RobotsPerceptClassified),
   PROVIDES(ProcessedRobotsHypotheses),
@@ -47,7 +52,8 @@ MODULE(RobotClassifier,
     (float)(1.f) interpolatePredictedBboxFactor,
     (bool)(false) useGeometricHeight,
     (bool)(true) interpolateGeometricBbox,
-    (float)(1.f) interpolateGeometricBboxFactor
+    (float)(1.f) interpolateGeometricBboxFactor,
+    (bool)(true) useBatchedClassification // classify all estimates of an image in one batch and correct the bboxes of the accepted ones in a second
   )
 );
 
@@ -55,21 +61,18 @@ MODULE(RobotClassifier,
 class RobotClassifier : public RobotClassifierBase
 {
 public:
-  RobotClassifier();
-
   void update(RobotsPerceptClassified& theRobotsPerceptClassified);
   void update(ProcessedRobotsHypotheses& theProcessedRobotsHypotheses);
 
-  std::unique_ptr<tflite::Interpreter> classificationModelInterpreter;
-  std::unique_ptr<tflite::Interpreter> bboxCorrectionModelInterpreter;
-
 private:
-  std::unique_ptr<tflite::FlatBufferModel> classificationModel;
-  std::unique_ptr<tflite::FlatBufferModel> bboxCorrectionModel;
-
-  tflite::ops::builtin::BuiltinOpResolver resolver;
+  const TfliteInferenceService::Model* classificationModel = nullptr;
+  const TfliteInferenceService::Model* bboxCorrectionModel = nullptr;
+  std::vector<unsigned char> classificationInput;
+  std::vector<unsigned char> bboxCorrectionInput;
+  TfliteInferenceService::Outputs classificationOutput;
+  TfliteInferenceService::Outputs bboxCorrectionOutput;
 
-  void initModel(std::string path, std::unique_ptr<tflite::Interpreter>& interpreter, std::unique_ptr<tflite::FlatBufferModel>& model);
+  void initModel(const std::string& filename, const std::string& modelName, const TfliteInferenceService::Model*& model, std::vector<unsigned char>& input);
 
   RobotsPerceptClassified localRobotsPerceptClassified;
   ProcessedRobotsHypotheses localRobotsHypotheses;
@@ -82,13 +85,24 @@ private:
   /* Run the classifier net on an estimate and return true, if classified as correct detection.
    * Update the estimates confidence
    */
-  void updateEstimate(const Image&, RobotEstimate&);
-  bool classifyEstimate(const Image&, RobotEstimate&);
-  void correctBbox(const Image&, RobotEstimate&);
-  void predictBbox(const Image& image, RobotEstimate& re, int& xUl, int& yUl, int& xLr, int& yLr);
+  void updateEstimate(const ImagePyramid&, RobotEstimate&);
+  bool classifyEstimate(const ImagePyramid&, RobotEstimate&);
+
+  /* Classify the sorted estimates of an image in one batch, correct the bboxes of the accepted ones in another batch
+   * and add the estimates that are still valid to the percept
+   */
+  void classifyEstimates(const ImagePyramid& imagePyramid, const std::vector<RobotEstimate>& sortedHypotheses, int maxClassifications, float threshold, int& classified, bool upper);
+  void copyClassificationPatch(const ImagePyramid& imagePyramid, const RobotEstimate& re, unsigned char* input) const;
+  void copyBboxCorrectionPatch(const ImagePyramid& imagePyramid, const RobotEstimate& re, unsigned char* input) const;
+  void getArea(const RobotEstimate& re, float areaMargin, Vector2i& upperLeftArea, Vector2i& sizeArea) const;
+  void drawDeclined(const RobotEstimate& re, bool upper, const ColorRGBA& color, const std::string& text);
+
+  /* Correct the bbox of an estimate, the prediction of the bbox correction net is computed if it is not given */
+  void correctBbox(const ImagePyramid&, RobotEstimate&, const std::vector<float>* prediction = nullptr);
+  void predictBbox(const ImagePyramid& imagePyramid, RobotEstimate& re, const std::vector<float>* prediction, int& xUl, int& yUl, int& xLr, int& yLr);
   void getGeometricBbox(RobotEstimate& re, int& xUl, int& yUl, int& xLr, int& yLr);
   void interpolateBbox(RobotEstimate& re, int& xUl, int& yUl, int& xLr, int& yLr, float factor, bool keepLower);
   bool filterNms(RobotEstimate&, bool respectValidity);
   float iou(const RobotEstimate& re1, const RobotEstimate& re2);
-  void getUpperImageCoordinates(const RobotEstimate&, int&, int&, int&, int&);
+  void getUpperImageCoordinates(const RobotEstimate&, int&, int&, int&, int&) const;
 };
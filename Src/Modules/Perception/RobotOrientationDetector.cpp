@@ -3,6 +3,7 @@
 void RobotOrientationDetector::update(RobotsPerceptOrientation& theRobotsPerceptOrientation)
 {
   theRobotsPerceptOrientation.robots.clear();
+  theRobotsPerceptOrientation.robots.reserve(theRobotsPerceptClassified.robots.size());
   for (const auto& e : theRobotsPerceptClassified.robots)
   {
     // TODO
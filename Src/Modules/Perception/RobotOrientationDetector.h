@@ -13,7 +13,7 @@ MODULE(RobotOrientationDetector,
   REQUIRES(ImageUpper),
   REQUIRES(RobotsPerceptClassified),
 
-  PROVIDES(RobotsPerceptOrientation)
+  PROVIDES_CONCURRENT(RobotsPerceptOrientation)
 );
 
 
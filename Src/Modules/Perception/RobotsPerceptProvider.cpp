@@ -4,10 +4,11 @@ void RobotsPerceptProvider::update(RobotsPercept& theRobotsPercept)
 {
   ASSERT(theRobotsPerceptOrientation.robots.size() == theRobotsPerceptTeam.robots.size());
   size_t const size = theRobotsPerceptTeam.robots.size();
-  theRobotsPercept.robots = std::vector<RobotEstimate>(size);
+  theRobotsPercept.robots.clear();
+  theRobotsPercept.robots.reserve(size);
   for (size_t i = 0; i < size; i++)
   {
-    theRobotsPercept.robots.at(i) = mergeRobotEstimates(theRobotsPerceptOrientation.robots.at(i), theRobotsPerceptTeam.robots.at(i));
+    theRobotsPercept.robots.push_back(mergeRobotEstimates(theRobotsPerceptOrientation.robots[i], theRobotsPerceptTeam.robots[i]));
   }
 }
 
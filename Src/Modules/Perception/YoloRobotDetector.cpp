@@ -4,7 +4,7 @@
 #include "Tools/Math/Transformation.h"
 #include "Tools/ColorModelConversions.h"
 
-#include "Tools/Math/sse_mathfun.h"
+#include "Tools/Math/FastMath.h"
 
 #include "Tools/Settings.h"
 #include <taskflow/taskflow.hpp>
@@ -29,6 +29,7 @@ YoloRobotDetector::YoloRobotDetector()
   yoloParameterUpper.anchors = YoloRobotDetectorCNNUpper::anchors;
 
   detectionVectorUpper.reserve(yoloParameterUpper.output_height * yoloParameterUpper.output_width * yoloParameterUpper.num_of_boxes);
+  candidateBoxesUpper.reserve(yoloParameterUpper.output_height * yoloParameterUpper.output_width * yoloParameterUpper.num_of_boxes);
   inputVectorUpper.resize(yoloParameterUpper.input_height * yoloParameterUpper.input_width * yoloParameterUpper.input_channel, 0.f);
   localRobotsPerceptYoloUpper.robots.clear();
 
@@ -43,47 +44,13 @@ YoloRobotDetector::YoloRobotDetector()
   yoloParameter.anchors = YoloRobotDetectorCNNLower::anchors;
 
   detectionVector.reserve(yoloParameter.output_height * yoloParameter.output_width * yoloParameter.num_of_boxes);
+  candidateBoxes.reserve(yoloParameter.output_height * yoloParameter.output_width * yoloParameter.num_of_boxes);
   inputVector.resize(yoloParameter.input_height * yoloParameter.input_width * yoloParameter.input_channel, 0.f);
   localRobotsPerceptYolo.robots.clear();
 
 #ifdef NO_HORIZON
   yIdxs.reserve(yoloParameterUpper.input_height + 1);
 #endif
-
-  std::string filename = std::string(File::getBHDir()) + "/Config/nao_U16_V32_stride_res_no_horizon_bs032_ts001-8406.tflite";
-
-  // Load the model
-  model = tflite::FlatBufferModel::BuildFromFile(filename.c_str());
-  TFLITE_MINIMAL_CHECK(model != nullptr);
-
-  // Build the interpreter
-  tflite::InterpreterBuilder builder(*model, resolver);
-  builder(&interpreter);
-  TFLITE_MINIMAL_CHECK(interpreter != nullptr);
-
-  interpreter->SetNumThreads(1);
-
-  // Resize input tensors
-  input_tensor = interpreter->inputs()[0];
-  output_tensor = interpreter->outputs()[0];
-  TfLiteIntArray* input_dims = interpreter->tensor(input_tensor)->dims;
-  //int input_batch = input_dims->data[0];
-  int input_height = input_dims->data[1];
-  int input_width = input_dims->data[2];
-  int input_channels = input_dims->data[3];
-
-  std::vector<int> new_input;
-  new_input.push_back(1);
-  new_input.push_back(input_height);
-  new_input.push_back(input_width);
-  new_input.push_back(input_channels);
-  interpreter->ResizeInputTensor(input_tensor, new_input);
-
-  // Allocate memory fore the tensors
-  interpreter->AllocateTensors();
-
-  // Check interpreter state
-  //tflite::PrintInterpreterState(interpreter.get());
 }
 
 void YoloRobotDetector::reset(const bool& upper)
@@ -104,6 +71,24 @@ void YoloRobotDetector::reset(const bool& upper)
 
 void YoloRobotDetector::execute(tf::Subflow& subflow)
 {
+  // the model is registered here, since the inference service is not available in the constructor,
+  // and it is loaded in the background, so no robots are detected in the first frames
+  if (useTFlite && !tfliteModel)
+  {
+    tfliteModel = theTfliteInferenceService.loadModel("YoloRobotDetector", "nao_U16_V32_stride_res_no_horizon_bs032_ts001-8406.tflite", TfliteInferenceService::critical);
+    if (tfliteModel)
+    {
+      // quantized models get the channel values in their own scale
+      const TfLiteQuantizationParams& quantization = tfliteModel->inputQuantization;
+      for (int i = 0; i < 256; ++i)
+      {
+        const float q = std::round(static_cast<float>(i) / 255.f / (quantization.scale > 0.f ? quantization.scale : 1.f)) + static_cast<float>(quantization.zero_point);
+        toUInt8[i] = static_cast<unsigned char>(std::clamp(q, 0.f, 255.f));
+        toInt8[i] = static_cast<signed char>(std::clamp(q, -128.f, 127.f));
+      }
+    }
+  }
+
   subflow
       .emplace(
           [=]()
@@ -123,12 +108,37 @@ void YoloRobotDetector::execute(tf::Subflow& subflow)
       .name("YoloLower [YoloRobotDetector]");
 }
 
-void YoloRobotDetector::update(RobotsHypothesesYolo& theRobotsHypothesesYolo)
+size_t YoloRobotDetector::getInputElementSize() const
+{
+  switch (tfliteModel->inputType)
+  {
+    case kTfLiteUInt8:
+    case kTfLiteInt8:
+      return 1;
+    default:
+      return sizeof(float);
+  }
+}
+
+std::vector<int> YoloRobotDetector::fillInputTensor(const Image& image, const YoloParameter& parameter, int minY, void* tensor) const
 {
-  theRobotsHypothesesYolo.robots.clear();
-  addObstacleFromBumpers();
+  const int width = static_cast<int>(parameter.input_width);
+  const int height = static_cast<int>(parameter.input_height);
+  switch (tfliteModel->inputType)
+  {
+    case kTfLiteUInt8:
+      return image.copyAndResizeRGBNoHorizon(width, height, minY, static_cast<unsigned char*>(tensor), toUInt8);
+    case kTfLiteInt8:
+      return image.copyAndResizeRGBNoHorizon(width, height, minY, static_cast<signed char*>(tensor), toInt8);
+    default:
+      return image.copyAndResizeRGBFloatNoHorizon(width, height, minY, static_cast<float*>(tensor));
+  }
+}
 
+void YoloRobotDetector::update(RobotsHypothesesYolo& theRobotsHypothesesYolo)
+{
   theRobotsHypothesesYolo = localRobotsPerceptYolo;
+  addObstacleFromBumpers(theRobotsHypothesesYolo);
 }
 
 void YoloRobotDetector::update(RobotsHypothesesYoloUpper& theRobotsHypothesesYoloUpper)
@@ -172,6 +182,7 @@ void YoloRobotDetector::update(PrePenaltyCrossHypothesesYolo& thePrePenaltyCross
 
 void YoloRobotDetector::update(YoloInputUpper& theYoloInputUpper)
 {
+  inputRequestedUpper = true;
   theYoloInputUpper.image = inputVectorUpper;
   theYoloInputUpper.width = yoloParameterUpper.input_width;
   theYoloInputUpper.height = yoloParameterUpper.input_height;
@@ -193,6 +204,7 @@ void YoloRobotDetector::update(YoloInput& theYoloInput)
 void YoloRobotDetector::execute(const bool& upper)
 {
   const Image& image = upper ? (Image&)theImageUpper : theImage;
+  const ImagePyramid& imagePyramid = upper ? (ImagePyramid&)theImagePyramidUpper : theImagePyramid;
   unsigned actualTimeStamp = upper ? timeStampUpper : timeStamp;
   if (actualTimeStamp != image.timeStamp)
   {
@@ -206,14 +218,29 @@ void YoloRobotDetector::execute(const bool& upper)
       timeStamp = actualTimeStamp;
     }
 
-    reset(upper);
-
-    if (!image.shouldBeProcessed())
+    const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+    LastDetection& last = upper ? lastDetectionUpper : lastDetection;
+    if (!image.shouldBeProcessed() || theFallDownState.state != FallDownState::upright || cameraMatrix.isValid == false)
+    {
+      reset(upper);
+      last.valid = false;
       return;
+    }
 
-    const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
-    if (theFallDownState.state != FallDownState::upright || cameraMatrix.isValid == false)
+    // between the images processed by YOLO, the last hypotheses are moved with the robot and the head
+    const int frameInterval = upper ? upperFrameInterval : lowerFrameInterval;
+    if (last.valid && last.skippedFrames + 1 < frameInterval && (!skipFramesOnlyWhileStanding || theMotionInfo.motion == MotionRequest::stand))
+    {
+      ++last.skippedFrames;
+      STOPWATCH(upper ? "YOLO-PropagationUpper" : "YOLO-PropagationLower")
+      {
+        propagateHypotheses(upper);
+      }
       return;
+    }
+
+    reset(upper);
+    last.valid = false;
 
     RobotsPercept& localPercepts = upper ? (RobotsPercept&)localRobotsPerceptYoloUpper : localRobotsPerceptYolo;
     YoloParameter& localParameter = upper ? (YoloParameter&)yoloParameterUpper : yoloParameter;
@@ -224,50 +251,72 @@ void YoloRobotDetector::execute(const bool& upper)
 
     YoloResult result(localParameter.output_height, localParameter.output_width, localParameter.num_of_boxes, localParameter.num_of_coords, localParameter.num_of_classes);
 
-    STOPWATCH(upper ? "YOLO-CopyUpper" : "YOLO-CopyLower")
+    int minY = 0;
+#ifdef NO_HORIZON
+    if (upper)
+    {
+      const Geometry::Line horizon = Geometry::calculateHorizon(cameraMatrix, cameraInfo);
+      if (!image.isOutOfImage(horizon.base.x(), horizon.base.y(), 4))
+        minY = std::min(std::max(0, static_cast<int>(horizon.base.y()) + 4), static_cast<int>(image.height - localParameter.input_height));
+      if (cropAtFieldBorder)
+        minY = std::max(minY, std::min(getFieldBorderY(cameraMatrix, cameraInfo), static_cast<int>(image.height - localParameter.input_height)));
+    }
+
+    // the inference service converts the upper image directly into the input tensor,
+    // so the float input is only filled if the debug image or YoloInputUpper need it
+    const bool fuseInput = upper && useTFlite && tfliteModel && localParameter.input_channel == 3;
+#else
+    const bool fuseInput = false;
+#endif
+    bool inputNeeded = !fuseInput || inputRequestedUpper;
+    if (upper)
     {
-      if (localParameter.input_channel == 3)
+      COMPLEX_IMAGE(YoloDebugImageUpper)
+        inputNeeded = true;
+    }
+
+    if (inputNeeded)
+    {
+      STOPWATCH(upper ? "YOLO-CopyUpper" : "YOLO-CopyLower")
       {
-        if (!upper)
-        {
-          image.copyAndResizeArea<true, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, input.data());
-        }
-        else
+        if (localParameter.input_channel == 3)
         {
-          if (!useTFlite)
+          if (!upper)
+          {
+            imagePyramid.copyAndResizeArea<true, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, input.data());
+          }
+          else
           {
 #ifdef NO_HORIZON
-            int minY = 0;
-            const Geometry::Line horizon = Geometry::calculateHorizon(cameraMatrix, cameraInfo);
-            if (!image.isOutOfImage(horizon.base.x(), horizon.base.y(), 4))
-              minY = std::min(std::max(0, static_cast<int>(horizon.base.y()) + 4), static_cast<int>(image.height - localParameter.input_height));
             yIdxs = image.copyAndResizeRGBFloatNoHorizon(localParameter.input_width, localParameter.input_height, minY, &input[0]);
 #else
-            image.copyAndResizeArea<true, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, input.data());
+            imagePyramid.copyAndResizeArea<true, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, input.data());
 #endif
           }
         }
-      }
-      else
-      {
-        image.copyAndResizeArea<false, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, input.data());
+        else
+        {
+          imagePyramid.copyAndResizeArea<false, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, input.data());
+        }
       }
     }
 
-    if (upper && useTFlite)
+    // the upper image is processed by the inference service while the debug images are drawn
+    std::future<TfliteInferenceService::Outputs> tfliteResult;
+    std::vector<int> fusedYIdxs;
+    if (fuseInput)
     {
-      STOPWATCH("YOLO-CopyUpper_tflite")
-      {
-#ifdef NO_HORIZON
-        int minY = 0;
-        const Geometry::Line horizon = Geometry::calculateHorizon(cameraMatrix, cameraInfo);
-        if (!image.isOutOfImage(horizon.base.x(), horizon.base.y(), 4))
-          minY = std::min(std::max(0, static_cast<int>(horizon.base.y()) + 4), static_cast<int>(image.height - localParameter.input_height));
-        yIdxs = image.copyAndResizeRGBFloatNoHorizon(localParameter.input_width, localParameter.input_height, minY, interpreter->typed_tensor<float>(input_tensor));
-#else
-        image.copyAndResizeArea<true, false>({0, 0}, {image.width, image.height}, {localParameter.input_width, localParameter.input_height}, interpreter->typed_tensor<float>(input_tensor));
-#endif
-      }
+      ASSERT(tfliteModel->inputBytes == input.size() * getInputElementSize());
+      tfliteResult = theTfliteInferenceService.submit(*tfliteModel,
+          [this, &image, &localParameter, &fusedYIdxs, minY](void* tensor)
+          {
+            fusedYIdxs = fillInputTensor(image, localParameter, minY, tensor);
+          });
+    }
+    else if (upper && useTFlite && tfliteModel)
+    {
+      ASSERT(tfliteModel->inputBytes == input.size() * sizeof(float));
+      tfliteResult = theTfliteInferenceService.submit(*tfliteModel, input.data());
     }
 
     if (upper)
@@ -339,20 +388,20 @@ void YoloRobotDetector::execute(const bool& upper)
           YoloRobotDetectorCNNUpper::cnn(input.data(), result.result.data());
         }
       }
-      else
+      else if (tfliteResult.valid())
       {
         STOPWATCH("YOLO-ExecutionUpper-tflite")
         {
-          float* output = interpreter->typed_tensor<float>(output_tensor);
-
-          if (interpreter->Invoke() != kTfLiteOk)
-          {
-            OUTPUT_ERROR("Failed to invoke tflite!");
-          }
-
-          std::copy(output, output + result.result.size(), result.result.data());
+          const TfliteInferenceService::Outputs outputs = theTfliteInferenceService.get(tfliteResult);
+          if (fuseInput)
+            yIdxs = std::move(fusedYIdxs);
+          if (outputs.empty())
+            return;
+          std::copy(outputs[0].begin(), outputs[0].begin() + result.result.size(), result.result.data());
         }
       }
+      else
+        return;
     }
     else
     {
@@ -362,6 +411,11 @@ void YoloRobotDetector::execute(const bool& upper)
       }
     }
 
+    last.valid = true;
+    last.skippedFrames = 0;
+    last.cameraMatrix = cameraMatrix;
+    last.odometryData = theOdometryData;
+
     STOPWATCH(upper ? "YOLO-PostprocessingUpper" : "YOLO-PostprocessingLower")
     {
       generateNetworkBoxes(1, localDetectionVector, result, upper);
@@ -369,25 +423,7 @@ void YoloRobotDetector::execute(const bool& upper)
 
       float nms = upper ? upperNMSThreshold : lowerNMSThreshold;
       if (nms < 1.0f)
-      {
-        for (size_t i = 0; i < localDetectionVector.size(); i++)
-        {
-          if (localDetectionVector[i].prob == 0.f)
-          {
-            continue;
-          }
-          else
-          {
-            for (size_t j = i + 1; j < localDetectionVector.size(); j++)
-            {
-              if (iou(localDetectionVector[i].bbox, localDetectionVector[j].bbox, image.height, image.width) >= nms)
-              {
-                localDetectionVector[j].prob = 0.f;
-              }
-            }
-          }
-        }
-      }
+        nonMaximumSuppression(localDetectionVector, nms, image.height, image.width);
 
       for (size_t boxNo = 0; boxNo < localDetectionVector.size(); boxNo++)
       {
@@ -532,54 +568,95 @@ void YoloRobotDetector::execute(const bool& upper)
 void YoloRobotDetector::generateNetworkBoxes(int relative, std::vector<YoloDetection>& localDetectionVector, YoloResult& yoloResult, const bool& upper)
 {
   YoloParameter& localParameter = upper ? (YoloParameter&)yoloParameterUpper : yoloParameter;
-
-  for (unsigned int i = 0; i < localParameter.output_width * localParameter.output_height; ++i)
+  std::vector<unsigned>& candidates = upper ? candidateBoxesUpper : candidateBoxes;
+  const float robotThreshold = upper ? upperRobotThreshold : lowerRobotThreshold;
+  const float ballThreshold = upper ? upperBallThreshold : lowerBallThreshold;
+  const float penaltyCrossThreshold = upper ? upperPenaltyCrossThreshold : lowerPenaltyCrossThreshold;
+
+  // the boxes of all cells are stored one after another, so box k starts at k * boxStride
+  const unsigned boxStride = localParameter.num_of_coords + 1 + localParameter.num_of_classes;
+  const unsigned numOfBoxes = localParameter.output_width * localParameter.output_height * localParameter.num_of_boxes;
+  const float* boxes = yoloResult.result.data();
+
+  // the class probabilities are at most 1, so a box can only reach a threshold if its object confidence does
+  // -> compare the raw object confidence with the logit of the lowest threshold to skip the sigmoid of all other boxes
+  const float minThreshold = std::min({robotThreshold, ballThreshold, penaltyCrossThreshold});
+  const float minLogit = minThreshold <= 0.f ? -INFINITY : (minThreshold >= 1.f ? INFINITY : std::log(minThreshold / (1.f - minThreshold)));
+  const float* objectness = boxes + localParameter.num_of_coords;
+  const __m128 minLogit4 = _mm_set1_ps(minLogit);
+  candidates.clear();
+  unsigned k = 0;
+  for (; k + 4 <= numOfBoxes; k += 4)
+  {
+    const __m128 t = _mm_setr_ps(objectness[k * boxStride], objectness[(k + 1) * boxStride], objectness[(k + 2) * boxStride], objectness[(k + 3) * boxStride]);
+    const int mask = _mm_movemask_ps(_mm_cmpge_ps(t, minLogit4));
+    if (mask)
+      for (unsigned i = 0; i < 4; ++i)
+        if (mask & (1 << i))
+          candidates.push_back(k + i);
+  }
+  for (; k < numOfBoxes; ++k)
+    if (objectness[k * boxStride] >= minLogit)
+      candidates.push_back(k);
+
+  // the candidates are decoded in groups of four, the last group is filled up with its last candidate
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.f);
+  for (size_t first = 0; first < candidates.size(); first += 4)
   {
-    int row = i / localParameter.output_width;
-    int col = i % localParameter.output_width;
-    for (unsigned int n = 0; n < localParameter.num_of_boxes; ++n)
+    unsigned idx[4];
+    for (size_t i = 0; i < 4; ++i)
+      idx[i] = candidates[std::min(first + i, candidates.size() - 1)] * boxStride;
+    auto gather = [&](unsigned attr)
     {
-      YoloDetection newDetection;
-      YoloRegionBox newBox;
-      getRegionBox(newBox, yoloResult, n, col, row, localParameter);
-
-      newDetection.bbox = newBox;
-
-      float conf = newBox.conf; // object confidence calculated in getRegionBox(..)
-
-      // calculate soft max over class probability values (they represent a prob. distribution) to find the most probable class
-      float maxScore = -INFINITY;
-      int bestClassIndex = 0;
+      return _mm_setr_ps(boxes[idx[0] + attr], boxes[idx[1] + attr], boxes[idx[2] + attr], boxes[idx[3] + attr]);
+    };
 
-      if (localParameter.num_of_classes > 1)
-      {
-        std::vector<float> classPredictions;
-        int baseIndex = n * (localParameter.num_of_coords + 1 + localParameter.num_of_classes) + localParameter.num_of_coords + 1;
-        for (unsigned int j = 0; j < localParameter.num_of_classes; ++j)
-        {
-          classPredictions.push_back(yoloResult(row, col, baseIndex + j));
-        }
-        softmax<float>(&classPredictions[0], localParameter.num_of_classes);
-        for (unsigned int j = 0; j < localParameter.num_of_classes; ++j)
-        {
-          if (classPredictions[j] > maxScore)
-          {
-            maxScore = classPredictions[j];
-            bestClassIndex = j;
-          }
-        }
-      }
-      else
-      { // Special Conditions - only one class
-        maxScore = 1;
-        bestClassIndex = 0;
-      }
+    alignas(16) float sigmoidX[4], sigmoidY[4], expW[4], expH[4], conf[4], maxScore[4], bestClass[4];
+    _mm_store_ps(sigmoidX, FastMath::sigmoid(gather(0))); // paper: sigmoid t_x
+    _mm_store_ps(sigmoidY, FastMath::sigmoid(gather(1))); // paper: sigmoid t_y
+    _mm_store_ps(expW, FastMath::exp(gather(2))); // paper: e^(t_w)
+    _mm_store_ps(expH, FastMath::exp(gather(3))); // paper: e^(t_h)
+    _mm_store_ps(conf, FastMath::sigmoid(gather(localParameter.num_of_coords))); // paper: sigmoid of t_o
+
+    // the soft max of the most probable class is 1 / sum(e^(l_j - max l_j))
+    const unsigned firstClass = localParameter.num_of_coords + 1;
+    __m128 maxLogit = gather(firstClass);
+    __m128 best = zero;
+    for (unsigned j = 1; j < localParameter.num_of_classes; ++j)
+    {
+      const __m128 logit = gather(firstClass + j);
+      const __m128 greater = _mm_cmpgt_ps(logit, maxLogit);
+      best = _mm_or_ps(_mm_and_ps(greater, _mm_set1_ps(static_cast<float>(j))), _mm_andnot_ps(greater, best));
+      maxLogit = _mm_max_ps(maxLogit, logit);
+    }
+    __m128 sum = zero;
+    for (unsigned j = 0; j < localParameter.num_of_classes; ++j)
+      sum = _mm_add_ps(sum, FastMath::exp(_mm_sub_ps(gather(firstClass + j), maxLogit)));
+    _mm_store_ps(maxScore, _mm_div_ps(one, sum));
+    _mm_store_ps(bestClass, best);
 
-      float max_class_conf = conf * maxScore;
-      if ((bestClassIndex == YoloClasses::Robot && max_class_conf > (upper ? upperRobotThreshold : lowerRobotThreshold))
-          || (bestClassIndex == YoloClasses::Ball && max_class_conf > (upper ? upperBallThreshold : lowerBallThreshold))
-          || (bestClassIndex == YoloClasses::Penaltycross && max_class_conf > (upper ? upperPenaltyCrossThreshold : lowerPenaltyCrossThreshold)))
+    for (size_t i = 0; i < 4 && first + i < candidates.size(); ++i)
+    {
+      const unsigned box = candidates[first + i];
+      const unsigned numOfBox = box % localParameter.num_of_boxes;
+      const unsigned cell = box / localParameter.num_of_boxes;
+      const int row = cell / localParameter.output_width;
+      const int col = cell % localParameter.output_width;
+      const int bestClassIndex = static_cast<int>(bestClass[i]);
+      const float max_class_conf = conf[i] * maxScore[i];
+      if ((bestClassIndex == YoloClasses::Robot && max_class_conf > robotThreshold) || (bestClassIndex == YoloClasses::Ball && max_class_conf > ballThreshold)
+          || (bestClassIndex == YoloClasses::Penaltycross && max_class_conf > penaltyCrossThreshold))
       {
+        YoloDetection newDetection;
+        // all values get absolute by dividing through width (height) -> get image coordinates by multiplying with image width (height) later
+        newDetection.bbox.x = (col + sigmoidX[i]) / localParameter.output_width;
+        newDetection.bbox.y = (row + sigmoidY[i]) / localParameter.output_height;
+        newDetection.bbox.w = expW[i] * localParameter.anchors[2 * numOfBox] / localParameter.output_width; // p_w being anchor w
+        newDetection.bbox.h = expH[i] * localParameter.anchors[2 * numOfBox + 1] / localParameter.output_height; // p_h being anchor h
+        newDetection.bbox.conf = conf[i];
+        newDetection.bbox.grid_x = col;
+        newDetection.bbox.grid_y = row;
         newDetection.prob = max_class_conf;
         newDetection.classes = localParameter.num_of_classes;
         newDetection.sortClass = bestClassIndex;
@@ -591,22 +668,22 @@ void YoloRobotDetector::generateNetworkBoxes(int relative, std::vector<YoloDetec
   correctRegionBoxes(relative, localDetectionVector, upper);
 }
 
-void YoloRobotDetector::getRegionBox(YoloRegionBox& b, YoloResult& yoloResult, int numOfBox, int col, int row, const YoloParameter& localParameter)
+void YoloRobotDetector::nonMaximumSuppression(std::vector<YoloDetection>& localDetectionVector, float threshold, int height, int width)
 {
-  int baseIndex = numOfBox * (localParameter.num_of_coords + 1 + localParameter.num_of_classes);
-  alignas(16) float input[4] = {-yoloResult(row, col, baseIndex), -yoloResult(row, col, baseIndex + 1), yoloResult(row, col, baseIndex + 2), yoloResult(row, col, baseIndex + 3)};
-  alignas(16) float result[4];
-
-  _mm_store_ps(result, exp_ps(_mm_load_ps(&input[0])));
-
-  // all values get absolute by dividing through width (height) -> get image coordinates by multiplying with image width (height) later
-  b.x = (col + 1 / (1 + result[0])) / localParameter.output_width; // paper: c_x + sigmoid t_x
-  b.y = (row + 1 / (1 + result[1])) / localParameter.output_height; // paper: c_y + sigmoid t_y
-  b.w = result[2] * localParameter.anchors[2 * numOfBox] / localParameter.output_width; // paper: p_w * e^(t_w) with p_w being anchor w
-  b.h = result[3] * localParameter.anchors[2 * numOfBox + 1] / localParameter.output_height; // paper: p_h * e^(t_h) with p_h being anchor h
-  b.conf = 1 / (1 + std::exp(-yoloResult(row, col, baseIndex + 4))); // paper: sigmoid of (t_o) with t_o being object confidence
-  b.grid_x = col;
-  b.grid_y = row;
+  // the detections are sorted by probability, so each one only has to be compared with the kept detections of its class
+  std::vector<std::vector<YoloRegionBox*>> keptBoxes;
+  for (YoloDetection& detection : localDetectionVector)
+  {
+    if (detection.prob == 0.f)
+      continue;
+    if (static_cast<size_t>(detection.sortClass) >= keptBoxes.size())
+      keptBoxes.resize(detection.sortClass + 1);
+    std::vector<YoloRegionBox*>& kept = keptBoxes[detection.sortClass];
+    if (std::any_of(kept.begin(), kept.end(), [&](YoloRegionBox* box) { return iou(*box, detection.bbox, height, width) >= threshold; }))
+      detection.prob = 0.f;
+    else
+      kept.push_back(&detection.bbox);
+  }
 }
 
 void YoloRobotDetector::correctRegionBoxes(int relative, std::vector<YoloDetection>& localDetectionVector, const bool& upper)
@@ -662,7 +739,7 @@ float YoloRobotDetector::iou(YoloRegionBox& box1, YoloRegionBox& box2, int heigt
   return intersection / unite;
 }
 
-void YoloRobotDetector::addObstacleFromBumpers()
+void YoloRobotDetector::addObstacleFromBumpers(RobotsPercept& robotsPercept)
 {
   // Security check for broken bumpers and upright
   if (theKeySymbols.obstacle_hit && theFallDownState.state == FallDownState::upright)
@@ -679,8 +756,117 @@ void YoloRobotDetector::addObstacleFromBumpers()
     robot.robotType = RobotEstimate::unknownRobot;
     robot.validity = 0.85f;
     calcImageCoords(robot, false);
-    localRobotsPerceptYolo.robots.push_back(robot);
+    robotsPercept.robots.push_back(robot);
+  }
+}
+
+void YoloRobotDetector::propagateHypotheses(const bool& upper)
+{
+  const Image& image = upper ? (Image&)theImageUpper : theImage;
+  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  RobotsPercept& localPercepts = upper ? (RobotsPercept&)localRobotsPerceptYoloUpper : localRobotsPerceptYolo;
+  std::vector<BallSpot>& ballSpots = upper ? localBallHypotheses.ballSpotsUpper : localBallHypotheses.ballSpots;
+  std::vector<PenaltyCross>& penaltyCrosses = upper ? localPenaltyCrossHypotheses.penaltyCrossesUpper : localPenaltyCrossHypotheses.penaltyCrosses;
+  LastDetection& last = upper ? lastDetectionUpper : lastDetection;
+  const Pose2f odometryOffset = theOdometryData - last.odometryData;
+
+  Vector2f newPoint;
+  float distanceRatio;
+  for (auto robot = localPercepts.robots.begin(); robot != localPercepts.robots.end();)
+  {
+    // the box is moved with its base point and scaled with its distance
+    const Vector2f base((robot->imageUpperLeft.x() + robot->imageLowerRight.x()) / 2.f, static_cast<float>(robot->imageLowerRight.y()));
+    if (propagatePoint(base, 0.f, odometryOffset, last, upper, newPoint, distanceRatio) && !image.isOutOfImage(newPoint.x(), newPoint.y(), 0))
+    {
+      robot->imageUpperLeft = (newPoint + (robot->imageUpperLeft.cast<float>() - base) * distanceRatio).cast<int>();
+      robot->imageLowerRight = (newPoint + (robot->imageLowerRight.cast<float>() - base) * distanceRatio).cast<int>();
+      robot->locationOnField.translation = odometryOffset.inverse() * robot->locationOnField.translation;
+      robot->distance = robot->locationOnField.translation.norm();
+      robot->timestampFromImage = image.timeStamp;
+      ++robot;
+    }
+    else
+      robot = localPercepts.robots.erase(robot);
+  }
+
+  for (auto ballSpot = ballSpots.begin(); ballSpot != ballSpots.end();)
+  {
+    if (propagatePoint(ballSpot->position.cast<float>(), theFieldDimensions.ballRadius, odometryOffset, last, upper, newPoint, distanceRatio)
+        && !image.isOutOfImage(newPoint.x(), newPoint.y(), 0))
+    {
+      ballSpot->position = newPoint.cast<int>();
+      ballSpot->radiusInImage *= distanceRatio;
+      ++ballSpot;
+    }
+    else
+      ballSpot = ballSpots.erase(ballSpot);
+  }
+
+  for (auto penaltyCross = penaltyCrosses.begin(); penaltyCross != penaltyCrosses.end();)
+  {
+    if (propagatePoint(penaltyCross->positionInImage, 0.f, odometryOffset, last, upper, newPoint, distanceRatio) && !image.isOutOfImage(newPoint.x(), newPoint.y(), 0))
+    {
+      penaltyCross->positionInImage = newPoint;
+      ++penaltyCross;
+    }
+    else
+      penaltyCross = penaltyCrosses.erase(penaltyCross);
+  }
+
+  last.cameraMatrix = cameraMatrix;
+  last.odometryData = theOdometryData;
+}
+
+bool YoloRobotDetector::propagatePoint(
+    const Vector2f& pointInImage, float height, const Pose2f& odometryOffset, const LastDetection& last, const bool& upper, Vector2f& newPointInImage, float& distanceRatio) const
+{
+  const CameraMatrix& cameraMatrix = upper ? (CameraMatrix&)theCameraMatrixUpper : theCameraMatrix;
+  const CameraInfo& cameraInfo = upper ? (CameraInfo&)theCameraInfoUpper : theCameraInfo;
+  Vector2f pointOnPlane;
+  if (!Transformation::imageToRobotHorizontalPlane(pointInImage, height, last.cameraMatrix, cameraInfo, pointOnPlane))
+    return false;
+  const Vector3f oldPoint(pointOnPlane.x(), pointOnPlane.y(), height);
+  const Vector2f newPointOnPlane = odometryOffset.inverse() * pointOnPlane;
+  const Vector3f newPoint(newPointOnPlane.x(), newPointOnPlane.y(), height);
+  if (!Transformation::robotToImage(newPoint, cameraMatrix, cameraInfo, newPointInImage))
+    return false;
+  const float oldDistance = (last.cameraMatrix.translation - oldPoint).norm();
+  const float newDistance = (cameraMatrix.translation - newPoint).norm();
+  distanceRatio = newDistance > 0.f ? oldDistance / newDistance : 1.f;
+  return true;
+}
+
+int YoloRobotDetector::getFieldBorderY(const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo) const
+{
+  if (theRobotPose.validity < minRobotPoseValidityForCrop)
+    return 0;
+
+  const Pose2f fieldToRobot = theRobotPose.inverse();
+  const Vector2f corners[4] = {{theFieldDimensions.xPosOpponentFieldBorder, theFieldDimensions.yPosLeftFieldBorder},
+      {theFieldDimensions.xPosOwnFieldBorder, theFieldDimensions.yPosLeftFieldBorder},
+      {theFieldDimensions.xPosOwnFieldBorder, theFieldDimensions.yPosRightFieldBorder},
+      {theFieldDimensions.xPosOpponentFieldBorder, theFieldDimensions.yPosRightFieldBorder}};
+
+  // the highest point of the field border in the image, lifted by the height of a robot standing there
+  float minY = static_cast<float>(cameraInfo.height);
+  bool visible = false;
+  for (int i = 0; i < 4; ++i)
+  {
+    const Vector2f& from = corners[i];
+    const Vector2f& to = corners[(i + 1) % 4];
+    const int steps = std::max(1, static_cast<int>((to - from).norm() / fieldBorderSampleStep));
+    for (int j = 0; j <= steps; ++j)
+    {
+      const Vector2f pointOnField = fieldToRobot * (from + (to - from) * (static_cast<float>(j) / steps));
+      Vector2f pointInImage;
+      if (!Transformation::robotToImage(pointOnField, cameraMatrix, cameraInfo, pointInImage) || pointInImage.x() < 0.f || pointInImage.x() >= cameraInfo.width)
+        continue;
+      visible = true;
+      minY = std::min(minY, pointInImage.y() - Geometry::getSizeByDistance(cameraInfo, 580.f, pointOnField.norm()));
+    }
   }
+  return visible ? std::max(0, static_cast<int>(minY)) : 0;
 }
 
 void YoloRobotDetector::calcImageCoords(RobotEstimate& robot, bool upper)
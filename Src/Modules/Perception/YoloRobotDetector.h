@@ -9,6 +9,7 @@
 #include "Tools/Module/Module.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Infrastructure/Image.h"
+#include "Representations/Infrastructure/ImagePyramid.h"
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Perception/RobotsPercept.h"
 #include "Tools/Debugging/DebugDrawings.h"
@@ -23,6 +24,10 @@
 #include "Representations/Perception/BallSpots.h"
 #include "Representations/Perception/PenaltyCrossHypotheses.h"
 #include "Representations/Configuration/FieldDimensions.h"
+#include "Representations/Perception/TfliteInferenceService.h"
+#include "Representations/Modeling/RobotPose.h"
+#include "Representations/MotionControl/MotionInfo.h"
+#include "Representations/MotionControl/OdometryData.h"
 
 #include <cstdio>
 #include "Modules/Perception/TFlite.h"
@@ -30,12 +35,6 @@
 #define NO_HORIZON
 #define BOTTOM_AS_CENTER
 
-#define TFLITE_MINIMAL_CHECK(x)                              \
-  if (!(x))                                                  \
-  {                                                          \
-    OUTPUT_TEXT("Error at " << __FILE__ << ":" << __LINE__); \
-  }
-
 STREAMABLE(YUVColor,,
   (unsigned char) y, 
   (unsigned char) cb, 
@@ -52,6 +51,8 @@ enum YoloClasses
 MODULE(YoloRobotDetector,
   REQUIRES(Image),
   REQUIRES(ImageUpper),
+  REQUIRES(ImagePyramid),
+  REQUIRES(ImagePyramidUpper),
   REQUIRES(CameraInfo),
   REQUIRES(CameraInfoUpper),
   REQUIRES(CameraMatrix),
@@ -60,7 +61,10 @@ MODULE(YoloRobotDetector,
   REQUIRES(KeySymbols),
   REQUIRES(FrameInfo),
   REQUIRES(FieldDimensions),
-  //USES(RobotPose),
+  REQUIRES(TfliteInferenceService),
+  REQUIRES(MotionInfo),
+  REQUIRES(OdometryData),
+  USES(RobotPose),
 
   PROVIDES_CONCURRENT_WITHOUT_MODIFY(YoloInputUpper),
   PROVIDES_CONCURRENT_WITHOUT_MODIFY(YoloInput),
@@ -87,6 +91,13 @@ MODULE(YoloRobotDetector,
     (float)(0.3f) upperNMSThreshold,
     (bool)(false) useUpperYoloHeight,
 
+    (int)(1) upperFrameInterval, // YOLO runs on every n-th upper image, the hypotheses are propagated in between
+    (int)(1) lowerFrameInterval, // YOLO runs on every n-th lower image, the hypotheses are propagated in between
+    (bool)(true) skipFramesOnlyWhileStanding, // Only skip images if the robot stands
+    (bool)(false) cropAtFieldBorder, // The upper input starts above the field border instead of at the horizon
+    (float)(0.5f) minRobotPoseValidityForCrop, // The field border is only used if the robot pose is at least this valid
+    (float)(200.f) fieldBorderSampleStep, // The distance between the points of the field border projected into the image (in mm)
+
     (bool)(true) useTFlite
   )
 );
@@ -156,14 +167,20 @@ public:
   void execute(const bool& upper);
   void reset(const bool& upper);
 
-  std::unique_ptr<tflite::Interpreter> interpreter;
-
 private:
-  std::unique_ptr<tflite::FlatBufferModel> model;
-  tflite::ops::builtin::BuiltinOpResolver resolver;
-  int input_tensor, output_tensor;
+  /* The state of the last image of a camera that was processed by YOLO */
+  struct LastDetection
+  {
+    bool valid = false;
+    int skippedFrames = 0;
+    CameraMatrix cameraMatrix; // the camera matrix the hypotheses were propagated to last
+    Pose2f odometryData; // the odometry the hypotheses were propagated to last
+  };
+
+  const TfliteInferenceService::Model* tfliteModel = nullptr;
 
   unsigned timeStamp, timeStampUpper; // used to make sure that images are only processed once
+  LastDetection lastDetection, lastDetectionUpper;
 
   YoloParameter yoloParameter;
   YoloParameter yoloParameterUpper;
@@ -176,25 +193,46 @@ private:
 
   std::vector<YoloDetection> detectionVectorUpper;
   std::vector<YoloDetection> detectionVector;
+  std::vector<unsigned> candidateBoxesUpper; // the boxes whose object confidence reaches the lowest threshold
+  std::vector<unsigned> candidateBoxes;
 
   std::vector<float> inputVectorUpper;
   std::vector<float> inputVector;
+  bool inputRequestedUpper = false; // Is YoloInputUpper provided, i.e. must the upper input be filled although it is written directly into the tensor?
+  std::array<unsigned char, 256> toUInt8; // the input values of a uint8 model per channel value
+  std::array<signed char, 256> toInt8; // the input values of an int8 model per channel value
 #ifdef NO_HORIZON
   std::vector<int> yIdxs;
 #endif
 
+  /* The size of an element of the input tensor of the tflite model */
+  size_t getInputElementSize() const;
+
+  /* Converts the upper image into the input tensor of the tflite model in its element type, returns the rows of the image used */
+  std::vector<int> fillInputTensor(const Image& image, const YoloParameter& parameter, int minY, void* tensor) const;
+
   float iou(YoloRegionBox& box1, YoloRegionBox& box2, int heigth, int width);
 
-  /* Fill a single box from network output */
-  void getRegionBox(YoloRegionBox& b, YoloResult& yoloResult, int numOfBox, int col, int row, const YoloParameter& localParameter);
 
   /* If output w/h ration is not equal to image w/h ratio, correct this */
   void correctRegionBoxes(int relative, std::vector<YoloDetection>& localDetectionVector, const bool& upper);
 
-  /* Collect all boxes that have high enough confidence score */
+  /* Collect all boxes that have high enough confidence score, only the boxes above the lowest threshold are decoded */
   void generateNetworkBoxes(int relative, std::vector<YoloDetection>& localDetectionVector, YoloResult& yoloResult, const bool& upper);
 
-  void addObstacleFromBumpers();
+  /* Sets the probability of all detections to 0 that overlap a more probable detection of the same class, the detections must be sorted */
+  void nonMaximumSuppression(std::vector<YoloDetection>& localDetectionVector, float threshold, int height, int width);
+
+  void addObstacleFromBumpers(RobotsPercept& robotsPercept);
+
+  /* Moves the hypotheses of the last processed image of a camera with the odometry and the camera matrix into the current image */
+  void propagateHypotheses(const bool& upper);
+
+  /* Moves a point at a height above the ground from the image of the last camera matrix into the current image */
+  bool propagatePoint(const Vector2f& pointInImage, float height, const Pose2f& odometryOffset, const LastDetection& last, const bool& upper, Vector2f& newPointInImage, float& distanceRatio) const;
+
+  /* The first row of the upper image above which no robot on the carpet can be seen, or 0 if it is unknown */
+  int getFieldBorderY(const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo) const;
 
   void calcImageCoords(RobotEstimate& robot, bool upper);
 };
@@ -14,7 +14,6 @@
 
 BrokenJointDetector::BrokenJointDetector()
 {
-  currents.resize(Joints::numOfJoints);
   flagsBroken.resize(Joints::numOfJoints);
   flagsStuck.resize(Joints::numOfJoints);
   averageCurrents.resize(Joints::numOfJoints);
@@ -29,12 +28,15 @@ void BrokenJointDetector::update(BrokenJointState& brokenJointState)
 {
   robotName = enableName ? Global::getSettings().robotName + "! " : "";
   // get the currents-> power
+  std::array<int, Joints::numOfJoints> values;
   for (int i = 0; i < Joints::numOfJoints; i++)
   {
-    short value = theJointSensorData.currents[i];
-    currents[i].push_front(static_cast<int>(value == SensorData::off ? 1.f : value));
-    averageCurrents[i] = currents[i].average();
+    const short value = theJointSensorData.currents[i];
+    values[i] = value == SensorData::off ? 1 : value;
   }
+  currents.push_front(values);
+  for (int i = 0; i < Joints::numOfJoints; i++)
+    averageCurrents[i] = currents.average(i);
   detectBrokenJoints(brokenJointState);
   detectStuckJoints(brokenJointState);
   // ToDo:If the gyro is stuck, we assume the whole connection to the robot disconnected. In such a case, we can not detect a motor malfunction.
@@ -46,7 +48,7 @@ void BrokenJointDetector::detectBrokenJoints(BrokenJointState& brokenJointState)
   if (theFrameInfo.getTimeSince(timestampLastCheckBroken) > checkWaitTime)
   {
     timestampLastCheckBroken = theFrameInfo.time;
-    for (size_t i = 0; i < currents.size(); i++)
+    for (size_t i = 0; i < averageCurrents.size(); i++)
     {
       // Decide which threshold to use
       Angle jointDiff = theGroundContactState.contact ? minJointDiffNormalJoints : minJointDiffNormalJointsNoGroundConntact;
@@ -87,7 +89,7 @@ void BrokenJointDetector::detectStuckJoints(BrokenJointState& brokenJointState)
   if (theFrameInfo.getTimeSince(timestampLastCheckStuck) > checkWaitTime)
   {
     timestampLastCheckStuck = theFrameInfo.time;
-    for (size_t i = 0; i < currents.size(); i++)
+    for (size_t i = 0; i < averageCurrents.size(); i++)
     {
       // Decide which threshold to use
       Angle jointDiff = theGroundContactState.contact ? minJointDiffNormalJoints : minJointDiffNormalJointsNoGroundConntact;
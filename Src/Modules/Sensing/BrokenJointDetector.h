@@ -9,7 +9,7 @@
 #pragma once
 
 #include "Tools/Module/Module.h"
-#include "Tools/RingBufferWithSum.h"
+#include "Tools/JointHistory.h"
 
 #include "Representations/Infrastructure/SensorData/JointSensorData.h"
 #include "Representations/Infrastructure/SensorData/FsrSensorData.h"
@@ -75,7 +75,7 @@ private:
   std::vector<int> flagsBroken; // counts possible defects per joint
   std::vector<int> flagsStuck; // counts possible defects per joint
   std::vector<int> averageCurrents;
-  std::vector<RingBufferWithSum<int, 20>> currents;
+  JointHistory<int, 20> currents; // the currents of all joints in the last frames
   std::string robotName;
   unsigned int timestampLastCheckBroken;
   unsigned int timestampLastCheckStuck;
@@ -7,6 +7,8 @@
 
 #include "GroundContactDetector.h"
 #include "Tools/Debugging/DebugDrawings.h"
+#include <algorithm>
+#include <array>
 
 MAKE_MODULE(GroundContactDetector, sensing)
 
@@ -143,18 +145,10 @@ void GroundContactDetector::footContact(float& frequencyLeft, float& frequencyRi
     convolutionBufferRight.fill(0.f);
   }
 
-  //calc convolution with lowpass
-  float convLeft = 0.f;
-  for (int i = 0; i < (int)convolutionBufferLeft.size(); i++)
-  {
-    convLeft += std::exp(lowpass_a) * convolutionBufferLeft[i];
-  }
-
-  float convRight = 0.f;
-  for (int i = 0; i < (int)convolutionBufferRight.size(); i++)
-  {
-    convRight += std::exp(lowpass_a) * convolutionBufferRight[i];
-  }
+  //calc convolution with lowpass, the weights of all entries are the same
+  const float lowpassWeight = std::exp(lowpass_a);
+  const float convLeft = lowpassWeight * convolutionBufferLeft.sum();
+  const float convRight = lowpassWeight * convolutionBufferRight.sum();
 
   //get max/min values in buffers
   float maxFsrRight = fsrBufferRight.maximum();
@@ -212,20 +206,21 @@ void GroundContactDetector::footContact(float& frequencyLeft, float& frequencyRi
     }
   }
 
-  //filter frequencies
-  std::vector<float> filterFrequencyListLeft;
-  std::vector<float> filterFrequencyListRight;
-  for (int i = 0; i < (int)frequencyBufferLeft.size(); i++)
+  //filter frequencies with the median of the buffered ones
+  std::array<float, 5> filterFrequencyListLeft;
+  std::array<float, 5> filterFrequencyListRight;
+  const std::size_t numOfFrequencies = std::min(frequencyBufferLeft.size(), frequencyBufferRight.size());
+  for (std::size_t i = 0; i < numOfFrequencies; i++)
   {
-    filterFrequencyListLeft.push_back(frequencyBufferLeft[i]);
-    filterFrequencyListRight.push_back(frequencyBufferRight[i]);
+    filterFrequencyListLeft[i] = frequencyBufferLeft[i];
+    filterFrequencyListRight[i] = frequencyBufferRight[i];
   }
-  std::sort(filterFrequencyListLeft.begin(), filterFrequencyListLeft.end());
-  std::sort(filterFrequencyListRight.begin(), filterFrequencyListRight.end());
+  std::nth_element(filterFrequencyListLeft.begin(), filterFrequencyListLeft.begin() + numOfFrequencies / 2, filterFrequencyListLeft.begin() + numOfFrequencies);
+  std::nth_element(filterFrequencyListRight.begin(), filterFrequencyListRight.begin() + numOfFrequencies / 2, filterFrequencyListRight.begin() + numOfFrequencies);
 
   //set outputs
-  frequencyLeft = filterFrequency && filterFrequencyListLeft.size() > 1 ? filterFrequencyListLeft[(filterFrequencyListLeft.size() / 2)] : frqLeft;
-  frequencyRight = filterFrequency && filterFrequencyListRight.size() > 1 ? filterFrequencyListRight[filterFrequencyListRight.size() / 2] : frqRight;
+  frequencyLeft = filterFrequency && numOfFrequencies > 1 ? filterFrequencyListLeft[numOfFrequencies / 2] : frqLeft;
+  frequencyRight = filterFrequency && numOfFrequencies > 1 ? filterFrequencyListRight[numOfFrequencies / 2] : frqRight;
 
   //push current sensorvals to buffer
   fsrBufferLeft.push_front(convLeft);
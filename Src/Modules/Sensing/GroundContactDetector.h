@@ -15,6 +15,7 @@
 #include "Representations/Sensing/TorsoMatrix.h"
 #include "Representations/Infrastructure/SensorData/FsrSensorData.h"
 #include "Tools/RingBufferWithSum.h"
+#include "Tools/RingBufferWithStatistics.h"
 #include "Tools/Math/Eigen.h"
 #include "Tools/Math/RotationMatrix.h"
 #include "Tools/Module/Module.h"
@@ -69,8 +70,8 @@ private:
   unsigned int lastTimestampLeft = 0; /** timestamp of last first contact of left foot on grount */
   float frqLeft = 0.f; /** current frequency of left foot */
   float frqRight = 0.f; /** current frequency of right foot */
-  RingBufferWithSum<float, 7> fsrBufferLeft; /** buffer of last 10 fsr sensor datas (avg of all 4 sensors) of left foot */
-  RingBufferWithSum<float, 7> fsrBufferRight; /** buffer of last 10 fsr sensor datas (avg of all 4 sensors) of right foot */
+  RingBufferWithStatistics<float, 7> fsrBufferLeft; /** buffer of last 10 fsr sensor datas (avg of all 4 sensors) of left foot */
+  RingBufferWithStatistics<float, 7> fsrBufferRight; /** buffer of last 10 fsr sensor datas (avg of all 4 sensors) of right foot */
   RingBufferWithSum<float, 5> frequencyBufferLeft; /** buffer of last 5 frequencies of left foot */
   RingBufferWithSum<float, 5> frequencyBufferRight; /** buffer of last 5 frequencies of right foot */
   RingBufferWithSum<float, 10> convolutionBufferLeft; /** buffer of last 15 fsr sensor datas (avg of all 4 sensors) of left foot */
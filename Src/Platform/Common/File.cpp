@@ -23,6 +23,24 @@
 #include "Tools/Configuration/RobotConfig.h"
 #include "Tools/Streams/InStreams.h"
 #include <filesystem>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+  /** Caches whether config files exist, because each module checks the whole hierarchy. */
+  struct ExistingFiles
+  {
+    std::mutex mutex;
+    std::unordered_map<std::string, bool> exists; /**< Does a file exist? By full name. */
+  };
+
+  ExistingFiles& getExistingFiles()
+  {
+    static ExistingFiles existingFiles;
+    return existingFiles;
+  }
+}
 
 File::File(const std::string& name, const char* mode, bool tryAlternatives)
     : stream(0)
@@ -31,6 +49,14 @@ File::File(const std::string& name, const char* mode, bool tryAlternatives)
       hFile(INVALID_HANDLE_VALUE)
 #endif
 {
+  if (std::strpbrk(mode, "wa+"))
+  {
+    // Files might be created, so the existence of files must be checked again
+    ExistingFiles& existingFiles = getExistingFiles();
+    std::lock_guard<std::mutex> lock(existingFiles.mutex);
+    existingFiles.exists.clear();
+  }
+
   fullName = name;
   std::list<std::string> names = getFullNames(name);
   if (tryAlternatives)
@@ -137,7 +163,15 @@ std::list<std::string> File::getFullNamesHierarchy(const std::string& name)
     }
   };
 
-  names.remove_if(fileDoesNotExist);
+  ExistingFiles& existingFiles = getExistingFiles();
+  std::lock_guard<std::mutex> lock(existingFiles.mutex);
+  names.remove_if([&](const std::string& name)
+  {
+    auto i = existingFiles.exists.find(name);
+    if (i == existingFiles.exists.end())
+      i = existingFiles.exists.emplace(name, !fileDoesNotExist(name)).first;
+    return !i->second;
+  });
   names.reverse();
   return names;
 }
@@ -304,6 +338,16 @@ size_t File::getPosition()
 #endif
 }
 
+bool File::reserve(size_t size)
+{
+#if defined(WINDOWS) || defined(MACOS)
+  static_cast<void>(size);
+  return false;
+#else
+  return fallocate64(fileno(static_cast<FILE*>(stream)), FALLOC_FL_KEEP_SIZE, getPosition(), size) == 0;
+#endif
+}
+
 #ifdef WINDOWS
 const char* File::getBHDir()
 {
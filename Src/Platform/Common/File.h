@@ -40,7 +40,8 @@ public:
 
   /**
    * The method returns a list of exiting full file names that can be read in
-   * the returned order
+   * the returned order. Whether files exist is cached until a file is opened
+   * for writing.
    * @param name The name of the file to search for.
    * @return The list of exiting config files in hierarchical order.
    */
@@ -126,6 +127,15 @@ public:
    */
   size_t getPosition();
 
+  /**
+   * Reserves space on the device for data that will be appended, so that the file
+   * system does not have to allocate it while writing. The size of the file does
+   * not change. Only supported on Linux.
+   * @param size The number of bytes reserved after the current position.
+   * @return Was the space reserved?
+   */
+  bool reserve(size_t size);
+
   /**
   * The function returns the current Framework directory,
   * e.g. /home/nao or <..>/NDevils
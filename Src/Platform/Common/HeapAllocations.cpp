@@ -0,0 +1,176 @@
+/**
+ * @file Platform/Common/HeapAllocations.cpp
+ * Replaces the global allocation functions to count the heap allocations of each thread.
+ * This is always done on the robot and in Debug builds otherwise. In all other builds,
+ * SystemCall reports no allocations.
+ */
+
+#include "Platform/SystemCall.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined TARGET_ROBOT || defined _DEBUG
+
+namespace
+{
+  thread_local size_t heapAllocations = 0;
+  thread_local size_t heapBytes = 0;
+
+  void* allocate(std::size_t size)
+  {
+    ++heapAllocations;
+    heapBytes += size;
+    return std::malloc(size ? size : 1);
+  }
+
+  void* allocate(std::size_t size, std::align_val_t alignment)
+  {
+    ++heapAllocations;
+    heapBytes += size;
+#ifdef WINDOWS
+    return _aligned_malloc(size ? size : 1, static_cast<std::size_t>(alignment));
+#else
+    void* ptr;
+    const std::size_t minAlignment = sizeof(void*);
+    return posix_memalign(&ptr, std::max(static_cast<std::size_t>(alignment), minAlignment), size ? size : 1) ? nullptr : ptr;
+#endif
+  }
+
+  void deallocate(void* ptr, std::align_val_t)
+  {
+#ifdef WINDOWS
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+  }
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  if (void* ptr = allocate(size))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  if (void* ptr = allocate(size, alignment))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return allocate(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, alignment);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+  deallocate(ptr, alignment);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  deallocate(ptr, alignment);
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  deallocate(ptr, alignment);
+}
+
+size_t SystemCall::getHeapAllocationsOfThread()
+{
+  return heapAllocations;
+}
+
+size_t SystemCall::getHeapBytesOfThread()
+{
+  return heapBytes;
+}
+
+#else
+
+size_t SystemCall::getHeapAllocationsOfThread()
+{
+  return 0;
+}
+
+size_t SystemCall::getHeapBytesOfThread()
+{
+  return 0;
+}
+
+#endif
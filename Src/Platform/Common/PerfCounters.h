@@ -0,0 +1,35 @@
+/**
+* @file Platform/Common/PerfCounters.h
+*
+* Declaration of a class for platforms without hardware performance counters.
+*/
+
+#pragma once
+
+/**
+* Placeholder for hardware performance counters. It never delivers any values.
+*/
+class PerfCounters
+{
+public:
+  /** The values of the counters. */
+  struct Values
+  {
+    unsigned long long cycles = 0;
+    unsigned long long instructions = 0;
+    unsigned long long cacheMisses = 0;
+    unsigned long long branchMisses = 0;
+  };
+
+  /**
+  * Are the counters available?
+  * @return Always false.
+  */
+  bool isAvailable() const { return false; }
+
+  /**
+  * Reads the counters.
+  * @return Always zero.
+  */
+  Values read() const { return Values(); }
+};
@@ -0,0 +1,22 @@
+/**
+* @file Platform/Common/SamplingProfiler.h
+*
+* Declaration of a sampling profiler for platforms that do not support one.
+*/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+/**
+* Placeholder for the sampling profiler. It never records any samples.
+*/
+class SamplingProfiler
+{
+public:
+  static void setCurrentModule(const char*) {}
+  static bool start(unsigned) { return false; }
+  static void stop() {}
+  static void collect(std::unordered_map<std::string, unsigned>&) {}
+};
@@ -8,42 +8,164 @@
 
 #include "DebugHandler.h"
 #include "Platform/BHAssert.h"
-#include "Tools/Streams/OutStreams.h"
+#include "Platform/SystemCall.h"
+#include "Tools/Debugging/DebugConnectionStatus.h"
 #include "Tools/Streams/InStreams.h"
+#include <algorithm>
 
 DebugHandler::DebugHandler(MessageQueue& in, MessageQueue& out, int maxPackageSendSize, int maxPackageReceiveSize)
-    : TcpConnection(0, 51111, TcpConnection::receiver, maxPackageSendSize, maxPackageReceiveSize), in(in), out(out), sendData(0), sendSize(0)
+    : TcpConnection(0, 51111, TcpConnection::receiver, maxPackageSendSize, maxPackageReceiveSize), in(in), out(out)
 {
+  Thread<DebugHandler>::start(this, &DebugHandler::run);
+}
+
+DebugHandler::~DebugHandler()
+{
+  announceStop();
+  packageAvailable.post();
+  Thread<DebugHandler>::stop();
+
+  for (Package* package = receivedPackages.load(); package;)
+  {
+    Package* next = package->next;
+    delete package;
+    package = next;
+  }
 }
 
 void DebugHandler::communicate(bool send)
 {
-  if (send && !sendData && !out.isEmpty())
+  // Take all packages received. They are in reverse order.
+  Package* received = receivedPackages.exchange(nullptr, std::memory_order_acquire);
+  Package* ordered = nullptr;
+  while (received)
+  {
+    Package* next = received->next;
+    received->next = ordered;
+    ordered = received;
+    received = next;
+  }
+  while (ordered)
   {
-    OutBinarySize size;
-    size << out;
-    sendSize = (int)size.getSize();
-    sendData = new unsigned char[sendSize];
-    ASSERT(sendData);
-    OutBinaryMemory memory(sendData);
-    memory << out;
-    out.clear();
+    InBinaryMemory memory(ordered->data);
+    memory >> in;
+    Package* next = ordered->next;
+    delete ordered;
+    ordered = next;
   }
 
-  unsigned char* receivedData;
-  int receivedSize = 0;
+  if (send && !out.isEmpty())
+  {
+    if (sending.load(std::memory_order_acquire))
+    {
+      // Backpressure: the network thread is still busy. Images would be outdated anyway.
+      imagesDropped += out.removeMessages(&DebugHandler::isImage);
+      blocked = true;
+    }
+    else
+    {
+      if (blocked)
+        imageInterval = std::min(imageInterval * 2, maxImageInterval);
+      else if (imageInterval > 1 && lastLatency < maxLatency)
+        --imageInterval;
+      blocked = false;
+
+      if (++packagesWithoutImages < imageInterval)
+        imagesDropped += out.removeMessages(&DebugHandler::isImage);
+      else
+        packagesWithoutImages = 0;
+
+      addStatus();
+
+      if (sendQueue.getSize() != out.getSize())
+        sendQueue.setSize(out.getSize());
+      sendQueue.clear();
+      out.swapMessages(sendQueue);
+
+      sendTimestamp = SystemCall::getCurrentSystemTime();
+      sending.store(true, std::memory_order_release);
+      packageAvailable.post();
+    }
+  }
+}
 
-  if (sendAndReceive(sendData, sendSize, receivedData, receivedSize) && sendSize)
+void DebugHandler::run()
+{
+  setName("DebugHandler");
+  while (isRunning())
   {
-    delete[] sendData;
-    sendData = 0;
-    sendSize = 0;
+    packageAvailable.wait(10);
+
+    // The streamed queue is sent directly from its buffer.
+    const bool send = sending.load(std::memory_order_acquire);
+    const int sendSize = send ? static_cast<int>(sendQueue.getStreamedSize()) : 0;
+    unsigned char* receivedData;
+    int receivedSize = 0;
+    if (sendAndReceive(send ? reinterpret_cast<unsigned char*>(sendQueue.getStreamedData()) : nullptr, sendSize, receivedData, receivedSize) && send)
+    {
+      const unsigned latency = SystemCall::getTimeSince(sendTimestamp);
+      bytesSent += sendSize;
+      ++packagesSent;
+      latencySum += latency;
+      lastLatency = latency;
+      if (latency > peakLatency)
+        peakLatency = latency;
+      sending.store(false, std::memory_order_release);
+    }
+
+    if (receivedSize > 0)
+    {
+      Package* received = new Package(receivedData, receivedSize, SystemCall::getCurrentSystemTime());
+      received->next = receivedPackages.load(std::memory_order_relaxed);
+      while (!receivedPackages.compare_exchange_weak(received->next, received, std::memory_order_release, std::memory_order_relaxed))
+        ;
+    }
   }
+}
+
+void DebugHandler::addStatus()
+{
+  const unsigned now = SystemCall::getCurrentSystemTime();
+  if (now - lastStatusTime < statusInterval)
+    return;
+
+  const unsigned bytes = bytesSent;
+  const unsigned packages = packagesSent;
+  const unsigned latencies = latencySum;
 
-  if (receivedSize > 0)
+  DebugConnectionStatus status;
+  status.bytesPerSecond = lastStatusTime ? static_cast<float>(bytes - lastBytesSent) * 1000.f / static_cast<float>(now - lastStatusTime) : 0.f;
+  status.packagesSent = packages - lastPackagesSent;
+  status.latency = status.packagesSent ? (latencies - lastLatencySum) / status.packagesSent : 0;
+  status.maxLatency = peakLatency.exchange(0);
+  status.imageInterval = imageInterval;
+  status.imagesDropped = imagesDropped;
+  out.out.bin << status;
+  out.out.finishMessage(idDebugConnectionStatus);
+
+  lastStatusTime = now;
+  lastBytesSent = bytes;
+  lastPackagesSent = packages;
+  lastLatencySum = latencies;
+  imagesDropped = 0;
+}
+
+bool DebugHandler::isImage(MessageID id)
+{
+  switch (id)
   {
-    InBinaryMemory memory(receivedData);
-    memory >> in;
-    delete[] receivedData;
+  case idImage:
+  case idImageUpper:
+  case idJPEGImage:
+  case idJPEGImageUpper:
+  case idLowFrameRateImage:
+  case idLowFrameRateImageUpper:
+  case idThumbnail:
+  case idThumbnailUpper:
+  case idDebugImage:
+  case idDebugJPEGImage:
+    return true;
+  default:
+    return false;
   }
 }
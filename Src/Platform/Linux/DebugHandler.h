@@ -8,10 +8,21 @@
 
 #pragma once
 
+#include "Thread.h"
+#include "Semaphore.h"
 #include "Tools/Debugging/TcpConnection.h"
 #include "Tools/MessageQueue/MessageQueue.h"
+#include <atomic>
 
-class DebugHandler : TcpConnection
+/**
+* The communication runs in a separate network thread, so a slow connection
+* does not block the process. Queues are handed over through lock-free slots.
+* The outgoing messages are not copied, because the outgoing queue exchanges
+* its buffer with the one of the queue sent by the network thread.
+* If the network thread cannot keep up, images are sent less often and the
+* images collected in the meantime are dropped.
+*/
+class DebugHandler : TcpConnection, Thread<DebugHandler>
 {
 public:
   /**
@@ -27,13 +38,9 @@ public:
 
   /**
   * Destructor.
-  * Delete buffered package if needed.
+  * Stops the network thread and deletes the packages not handled yet.
   */
-  ~DebugHandler()
-  {
-    if (sendData)
-      delete[] sendData;
-  }
+  ~DebugHandler();
 
   /**
   * The method performs the communication.
@@ -43,9 +50,60 @@ public:
   void communicate(bool send);
 
 private:
+  /** A block of data received from the PC. */
+  struct Package
+  {
+    unsigned char* data;
+    int size;
+    unsigned timestamp; /**< When was the package received? */
+    Package* next = nullptr; /**< The next package in a list of received packages. */
+
+    Package(unsigned char* data, int size, unsigned timestamp) : data(data), size(size), timestamp(timestamp) {}
+    ~Package() { delete[] data; }
+  };
+
+  static constexpr unsigned maxImageInterval = 16; /**< Send images at least in every n-th package. */
+  static constexpr unsigned maxLatency = 200; /**< Reduce the image interval only if packages are sent faster than this (in ms). */
+  static constexpr unsigned statusInterval = 1000; /**< How often is the DebugConnectionStatus sent (in ms)? */
+
   MessageQueue &in, /**< Incoming debug data is stored here. */
       &out; /**< Outgoing debug data is stored here. */
 
-  unsigned char* sendData; /**< The data to send next. */
-  int sendSize; /**< The size of the data to send next. */
+  MessageQueue sendQueue; /**< The messages the network thread sends. */
+  std::atomic<bool> sending{false}; /**< Does sendQueue contain messages not sent yet? Only the network thread resets it after sending. */
+  unsigned sendTimestamp = 0; /**< When was sendQueue handed over to the network thread? */
+  std::atomic<Package*> receivedPackages{nullptr}; /**< The packages received in reverse order. Only the process takes them. */
+  Semaphore packageAvailable; /**< Wakes the network thread if a package is available. */
+
+  // Written by the network thread only.
+  std::atomic<unsigned> bytesSent{0}; /**< The number of bytes sent so far. */
+  std::atomic<unsigned> packagesSent{0}; /**< The number of packages sent so far. */
+  std::atomic<unsigned> latencySum{0}; /**< The sum of the latencies of all packages sent so far (in ms). */
+  std::atomic<unsigned> lastLatency{0}; /**< The latency of the last package sent (in ms). */
+  std::atomic<unsigned> peakLatency{0}; /**< The maximum latency since the last status message (in ms). The process thread resets it. */
+
+  // Used by the process thread only.
+  unsigned imageInterval = 1; /**< Images are only sent in every n-th package. */
+  unsigned packagesWithoutImages = 0; /**< The number of packages sent since images were sent for the last time. */
+  bool blocked = false; /**< Could a package not be handed over since the last one was? */
+  unsigned imagesDropped = 0; /**< The number of image messages dropped since the last status message. */
+  unsigned lastStatusTime = 0; /**< When was the last status message sent? */
+  unsigned lastBytesSent = 0; /**< The value of bytesSent when the last status message was sent. */
+  unsigned lastPackagesSent = 0; /**< The value of packagesSent when the last status message was sent. */
+  unsigned lastLatencySum = 0; /**< The value of latencySum when the last status message was sent. */
+
+  /** The main function of the network thread. */
+  void run();
+
+  /**
+  * Adds the DebugConnectionStatus to the outgoing queue if it is due.
+  */
+  void addStatus();
+
+  /**
+  * Is a message an image?
+  * @param id The id of the message.
+  * @return Should the message be dropped if the bandwidth is insufficient?
+  */
+  static bool isImage(MessageID id);
 };
@@ -15,6 +15,7 @@
 #include <fcntl.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
+#include <malloc.h>
 #include <unistd.h>
 #include <array>
 #include <chrono>
@@ -318,6 +319,11 @@ int main(int argc, char* argv[])
     if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
       perror("mlockall() failed");
 
+    // keep freed memory in the heap, because memory returned to the kernel must be faulted in again
+    // when it is allocated the next time, and serve large blocks from the heap as well
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
     mainTid = pthread_self();
 
     std::cout << "Loading settings" << std::endl;
@@ -15,8 +15,10 @@
 #include <poll.h>
 #include <linux/videodev2.h>
 
+#include <algorithm>
 #include <thread>
 #include <chrono>
+#include <sstream>
 
 #include "NaoCameraV6.h"
 #include "BHAssert.h"
@@ -26,8 +28,19 @@
 #include "linux/uvcvideo.h"
 #include "linux/usb/video.h"
 
-NaoCameraV6::NaoCameraV6(const char* device, bool upper, int width, int height, bool flip)
-    : upper(upper), WIDTH(width * 2), HEIGHT(height * 2)
+/** Sends a message through report(), which also works on the control thread. */
+#define REPORT(type, message) \
+  do \
+  { \
+    std::ostringstream _stream; \
+    _stream << message; \
+    report(type, _stream.str()); \
+  } while (false)
+
+static thread_local bool onControlThread = false; /**< Is the calling thread a control thread? */
+
+NaoCameraV6::NaoCameraV6(const char* device, bool upper, int width, int height, bool flip, unsigned frameBuffers)
+    : upper(upper), frameBufferCount(std::min(frameBuffers, maxFrameBufferCount)), WIDTH(width * 2), HEIGHT(height * 2)
 #ifndef NDEBUG
       ,
       SIZE(WIDTH * HEIGHT * 2)
@@ -49,16 +62,23 @@ NaoCameraV6::NaoCameraV6(const char* device, bool upper, int width, int height,
   setControlSetting(V4L2_CID_FOCUS_AUTO, 0);
 
   startCapturing();
+
+  requestedSettings = publishedSettings = appliedSettings;
+  controlThread.start(this, &NaoCameraV6::controlMain);
 }
 
 NaoCameraV6::~NaoCameraV6()
 {
+  controlThread.announceStop();
+  controlRequested.post();
+  controlThread.stop();
+
   // disable streaming
   int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
   VERIFY(ioctl(fd, VIDIOC_STREAMOFF, &type) != -1);
 
   // unmap buffers
-  for (int i = 0; i < frameBufferCount; ++i)
+  for (unsigned i = 0; i < frameBufferCount; ++i)
     munmap(mem[i], memLength[i]);
 
   // close the device
@@ -72,6 +92,8 @@ bool NaoCameraV6::captureNew(NaoCameraV6& cam1, NaoCameraV6& cam2, int timeout,
 
   ASSERT(cam1.currentBuf == nullptr);
   ASSERT(cam2.currentBuf == nullptr);
+  cam1.queueReleasedBuffers();
+  cam2.queueReleasedBuffers();
 
   errorCam1 = errorCam2 = false;
 
@@ -105,8 +127,7 @@ bool NaoCameraV6::captureNew(NaoCameraV6& cam1, NaoCameraV6& cam2, int timeout,
       {
         //OUTPUT_ERROR("VIDIOC_DQBUF success revents=" << pollfds[i].revents);
         //ASSERT(buf->bytesused == SIZE);
-        cams[i]->currentBuf = cams[i]->buf;
-        cams[i]->timeStamp = static_cast<unsigned long long>(cams[i]->currentBuf->timestamp.tv_sec) * 1000000ll + cams[i]->currentBuf->timestamp.tv_usec;
+        cams[i]->setCurrentBuffer();
 
         if (cams[i]->first)
         {
@@ -140,6 +161,7 @@ bool NaoCameraV6::captureNew(int timeout)
   // requeue the buffer of the last captured image which is obsolete now
   ASSERT(currentBuf == nullptr);
   BH_TRACE;
+  queueReleasedBuffers();
 
   const unsigned startPollingTimestamp = SystemCall::getCurrentSystemTime();
   struct pollfd pollfd = {fd, POLLIN | POLLPRI, 0};
@@ -167,8 +189,7 @@ bool NaoCameraV6::captureNew(int timeout)
   }
   BH_TRACE;
   //ASSERT(buf->bytesused == SIZE);
-  currentBuf = buf;
-  timeStamp = static_cast<unsigned long long>(currentBuf->timestamp.tv_sec) * 1000000ll + currentBuf->timestamp.tv_usec;
+  setCurrentBuffer();
   const unsigned endPollingTimestamp = SystemCall::getCurrentSystemTime();
   timeWaitedForLastImage = endPollingTimestamp - startPollingTimestamp;
 
@@ -185,9 +206,36 @@ void NaoCameraV6::releaseImage()
 {
   if (currentBuf)
   {
-    VERIFY(ioctl(fd, VIDIOC_QBUF, currentBuf) != -1);
     currentBuf = nullptr;
+    currentFrame.reset(); // queues the buffer below, unless the frame is still shared
   }
+  queueReleasedBuffers();
+}
+
+void NaoCameraV6::setCurrentBuffer()
+{
+  const unsigned index = buf->index;
+  ASSERT(index < frameBufferCount);
+  dequeued[index] = true;
+  currentFrame = std::shared_ptr<const void>(mem[index], [released = released, index](const void*) { (*released)[index] = true; });
+  currentBuf = buf;
+  timeStamp = static_cast<unsigned long long>(currentBuf->timestamp.tv_sec) * 1000000ll + currentBuf->timestamp.tv_usec;
+}
+
+void NaoCameraV6::queueReleasedBuffers()
+{
+  for (unsigned i = 0; i < frameBufferCount; ++i)
+    if (dequeued[i] && (*released)[i].exchange(false))
+    {
+      queueBuffer(i);
+      dequeued[i] = false;
+    }
+}
+
+std::shared_ptr<const void> NaoCameraV6::getFrame() const
+{
+  const unsigned queued = frameBufferCount - static_cast<unsigned>(std::count(dequeued.begin(), dequeued.begin() + frameBufferCount, true));
+  return queued >= minQueuedFrameBuffers ? currentFrame : std::shared_ptr<const void>();
 }
 
 const unsigned char* NaoCameraV6::getImage() const
@@ -226,9 +274,21 @@ void NaoCameraV6::setFrameRate(unsigned numerator, unsigned denominator)
   VERIFY(ioctl(fd, VIDIOC_S_PARM, &fps) != -1);
 }
 
+CameraSettingsV6 NaoCameraV6::getSettings()
+{
+  std::lock_guard<std::mutex> lock(requestMutex);
+  return publishedSettings;
+}
+
 void NaoCameraV6::setSettings(const CameraSettingsV6& settings)
 {
-  this->settings = settings;
+  std::lock_guard<std::mutex> lock(requestMutex);
+  if (settings != requestedSettings)
+  {
+    requestedSettings = settings;
+    ++requestNumber;
+    controlRequested.post();
+  }
 }
 
 void NaoCameraV6::assertCameraSettings()
@@ -241,12 +301,12 @@ void NaoCameraV6::assertCameraSettings()
   VERIFY(!ioctl(fd, VIDIOC_G_PARM, &fps));
   if (fps.parm.capture.timeperframe.numerator != 1)
   {
-    OUTPUT_ERROR("fps.parm.capture.timeperframe.numerator is wrong.");
+    REPORT(MessageType::error, "fps.parm.capture.timeperframe.numerator is wrong.");
     allFine = false;
   }
   if (fps.parm.capture.timeperframe.denominator != 30)
   {
-    OUTPUT_ERROR("fps.parm.capture.timeperframe.denominator is wrong.");
+    REPORT(MessageType::error, "fps.parm.capture.timeperframe.denominator is wrong.");
     allFine = false;
   }
 
@@ -259,20 +319,66 @@ void NaoCameraV6::assertCameraSettings()
 
   if (allFine)
   {
-    OUTPUT_TEXT("Camera settings match settings stored in hardware/driver.");
+    REPORT(MessageType::text, "Camera settings match settings stored in hardware/driver.");
   }
 }
 
 bool NaoCameraV6::writeCameraSettings()
 {
+  std::vector<Message> messages;
+  bool applied;
+  {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    messages.swap(this->messages);
+    applied = completedRequest == requestNumber;
+  }
+  for (const Message& message : messages)
+    report(message.type, message.text);
+  return applied;
+}
 
-  bool settingsChanged = false;
-  // HACK: wait before setting next camera setting
-  if (frameCounter > 0)
+void NaoCameraV6::controlMain()
+{
+  Thread<NaoCameraV6>::setName(upper ? "CameraCtrlUpper" : "CameraCtrlLower");
+  onControlThread = true;
+
+  unsigned takenRequest = 0;
+  bool applied = true;
+  while (controlThread.isRunning())
   {
-    --frameCounter;
-    return false;
+    // new requests are taken over while waiting for the camera to adapt
+    const int waitTime = applied ? 1000 : static_cast<int>(nextControlWrite - SystemCall::getCurrentSystemTime());
+    if (waitTime > 0)
+      controlRequested.wait(static_cast<unsigned>(waitTime));
+
+    std::lock_guard<std::mutex> device(deviceMutex);
+    {
+      std::lock_guard<std::mutex> lock(requestMutex);
+      if (takenRequest != requestNumber)
+      {
+        settings = requestedSettings;
+        takenRequest = requestNumber;
+        applied = false;
+      }
+    }
+    const unsigned now = SystemCall::getCurrentSystemTime();
+    if (applied || static_cast<int>(nextControlWrite - now) > 0)
+      continue;
+
+    unsigned delay = 0;
+    applied = writeNextSetting(delay);
+    nextControlWrite = now + delay;
+
+    std::lock_guard<std::mutex> lock(requestMutex);
+    publishedSettings = appliedSettings;
+    if (applied)
+      completedRequest = takenRequest;
   }
+}
+
+bool NaoCameraV6::writeNextSetting(unsigned& delay)
+{
+  bool settingsChanged = false;
 
   for (int i = 0; i < CameraSettingsV6::numOfCameraSettings; ++i)
   {
@@ -302,14 +408,14 @@ bool NaoCameraV6::writeCameraSettings()
     {
       if (!setControlSetting(currentSetting.command, currentSetting.value))
       {
-        OUTPUT_WARNING("NaoCameraV6: Setting camera control " << CameraSettingsV6::getName(setting) << " failed for value: " << currentSetting.value << " is: " << appliedSetting.value);
+        REPORT(MessageType::warning, "NaoCameraV6: Setting camera control " << CameraSettingsV6::getName(setting) << " failed for value: " << currentSetting.value << " is: " << appliedSetting.value);
       }
       else
       {
         settingsChanged = true;
         printf("is upper = %d\n %s = %d (%d)\n", upper, CameraSettingsV6::getName(setting), currentSetting.value, appliedSetting.value);
         appliedSetting.value = currentSetting.value;
-        frameCounter = 30; // HACK: wait for 30 frames to set next setting
+        delay = 1000; // HACK: wait for 30 frames to set next setting
         return false;
       }
     }
@@ -335,7 +441,7 @@ bool NaoCameraV6::writeCameraSettings()
     appliedSettings.windowSize = settings.windowSize;
     appliedSettings.windowWeights = settings.windowWeights;
 
-    frameCounter = 30;
+    delay = 1000;
     return false;
   }
 
@@ -348,7 +454,7 @@ bool NaoCameraV6::writeCameraSettings()
 
   if (!writeCameraRegisters())
   {
-    frameCounter = 5; // wait at least 100ms between registers
+    delay = 170; // wait at least 100ms between registers
     return false;
   }
 
@@ -357,6 +463,7 @@ bool NaoCameraV6::writeCameraSettings()
 
 void NaoCameraV6::readCameraSettings()
 {
+  std::lock_guard<std::mutex> device(deviceMutex);
   for (int i = 0; i < CameraSettingsV6::CameraSetting::numOfCameraSettings; i++)
   {
     CameraSettingsV6::V4L2Setting& appliedSetting = appliedSettings.settings[i];
@@ -376,6 +483,12 @@ void NaoCameraV6::readCameraSettings()
   settings.weights[i] = value;
   }
   */
+
+  // the settings requested are written again, since the hardware might differ
+  std::lock_guard<std::mutex> lock(requestMutex);
+  publishedSettings = appliedSettings;
+  ++requestNumber;
+  controlRequested.post();
 }
 
 
@@ -404,6 +517,7 @@ bool NaoCameraV6::writeCameraRegisters()
 
 void NaoCameraV6::doAutoWhiteBalance()
 {
+  std::lock_guard<std::mutex> device(deviceMutex);
   setControlSetting(V4L2_CID_DO_WHITE_BALANCE, 1);
   int value = getControlSetting(V4L2_CID_WHITE_BALANCE_TEMPERATURE);
   if (value > 0)
@@ -411,9 +525,26 @@ void NaoCameraV6::doAutoWhiteBalance()
     OUTPUT_TEXT("New white balance is " << value);
     settings.settings[CameraSettingsV6::WhiteBalance].value = value;
     appliedSettings.settings[CameraSettingsV6::WhiteBalance].value = value;
+    std::lock_guard<std::mutex> lock(requestMutex);
+    publishedSettings = appliedSettings;
   }
 }
 
+void NaoCameraV6::report(MessageType type, const std::string& text)
+{
+  if (onControlThread)
+  {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    messages.push_back({type, text});
+  }
+  else if (type == MessageType::text)
+    OUTPUT_TEXT(text);
+  else if (type == MessageType::warning)
+    OUTPUT_WARNING(text);
+  else
+    OUTPUT_ERROR(text);
+}
+
 int NaoCameraV6::getControlSetting(unsigned int id)
 {
   struct v4l2_queryctrl queryctrl;
@@ -450,36 +581,36 @@ bool NaoCameraV6::setControlSetting(unsigned int id, int value)
   queryctrl.id = id;
   if (ioctl(fd, VIDIOC_QUERYCTRL, &queryctrl) < 0)
   {
-    OUTPUT_WARNING("NaoCameraV6:  VIDIOC_QUERYCTRL " << id << " call failed (value: " << value << ")!");
+    REPORT(MessageType::warning, "NaoCameraV6:  VIDIOC_QUERYCTRL " << id << " call failed (value: " << value << ")!");
     return false;
   }
   if (queryctrl.flags & V4L2_CTRL_FLAG_DISABLED)
   {
-    OUTPUT_WARNING("NaoCameraV6:  VIDIOC_QUERYCTRL call failed. Command " << id << " disabled!");
+    REPORT(MessageType::warning, "NaoCameraV6:  VIDIOC_QUERYCTRL call failed. Command " << id << " disabled!");
     return false; // not available
   }
   if (queryctrl.type != V4L2_CTRL_TYPE_BOOLEAN && queryctrl.type != V4L2_CTRL_TYPE_INTEGER && queryctrl.type != V4L2_CTRL_TYPE_MENU)
   {
-    OUTPUT_WARNING("NaoCameraV6:  VIDIOC_QUERYCTRL call failed. Command " << id << " not supported!");
+    REPORT(MessageType::warning, "NaoCameraV6:  VIDIOC_QUERYCTRL call failed. Command " << id << " not supported!");
     return false; // not supported
   }
   // clip value
   if (value < queryctrl.minimum)
   {
-    OUTPUT_WARNING("NaoCameraV6: Clipping control value. ID: " << id << " to " << queryctrl.minimum);
+    REPORT(MessageType::warning, "NaoCameraV6: Clipping control value. ID: " << id << " to " << queryctrl.minimum);
     value = queryctrl.minimum;
   }
   if (value > queryctrl.maximum)
   {
     value = queryctrl.maximum;
-    OUTPUT_WARNING("NaoCameraV6: Clipping control value. ID: " << id << " to " << queryctrl.maximum);
+    REPORT(MessageType::warning, "NaoCameraV6: Clipping control value. ID: " << id << " to " << queryctrl.maximum);
   }
   struct v4l2_control control_s;
   control_s.id = id;
   control_s.value = value;
   if (ioctl(fd, VIDIOC_S_CTRL, &control_s) < 0)
   {
-    OUTPUT_WARNING("NaoCameraV6: Setting value ID: " << id << " failed. VIDIOC_S_CTRL return value < 0");
+    REPORT(MessageType::warning, "NaoCameraV6: Setting value ID: " << id << " failed. VIDIOC_S_CTRL return value < 0");
     return false;
   }
 
@@ -581,7 +712,7 @@ void NaoCameraV6::writeRegister(uint16_t addr, uint16_t value)
 
   if (ioctl(fd, UVCIOC_CTRL_QUERY, &xu_query) != 0)
   {
-    OUTPUT_ERROR("UVC_SET_CUR fails: " << std::strerror(errno));
+    REPORT(MessageType::error, "UVC_SET_CUR fails: " << std::strerror(errno));
   }
 }
 
@@ -613,7 +744,7 @@ bool NaoCameraV6::assertCameraSetting(CameraSettingsV6::CameraSetting setting)
     return true;
   else
   {
-    OUTPUT_ERROR("Value for command "
+    REPORT(MessageType::error, "Value for command "
         << settings.settings[setting].command << " (" << CameraSettingsV6::getName(setting) << ") is " << value << " but should be " << settings.settings[setting].value << ".");
     appliedSettings.settings[setting].value = value;
     return false;
@@ -651,11 +782,12 @@ void NaoCameraV6::initRequestAndMapBuffers()
   rb.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
   rb.memory = V4L2_MEMORY_MMAP;
   VERIFY(ioctl(fd, VIDIOC_REQBUFS, &rb) != -1);
-  ASSERT(rb.count == frameBufferCount);
+  ASSERT(rb.count > 0 && rb.count <= maxFrameBufferCount);
+  frameBufferCount = rb.count; // the driver might not provide as many buffers as requested
 
   // map or prepare the buffers
   buf = static_cast<struct v4l2_buffer*>(calloc(1, sizeof(struct v4l2_buffer)));
-  for (int i = 0; i < frameBufferCount; ++i)
+  for (unsigned i = 0; i < frameBufferCount; ++i)
   {
     buf->index = i;
     buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -670,13 +802,18 @@ void NaoCameraV6::initRequestAndMapBuffers()
 void NaoCameraV6::initQueueAllBuffers()
 {
   // queue the buffers
-  for (int i = 0; i < frameBufferCount; ++i)
-  {
-    buf->index = i;
-    buf->type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf->memory = V4L2_MEMORY_MMAP;
-    VERIFY(ioctl(fd, VIDIOC_QBUF, buf) != -1);
-  }
+  for (unsigned i = 0; i < frameBufferCount; ++i)
+    queueBuffer(i);
+}
+
+void NaoCameraV6::queueBuffer(unsigned index)
+{
+  struct v4l2_buffer buffer;
+  memset(&buffer, 0, sizeof(buffer));
+  buffer.index = index;
+  buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buffer.memory = V4L2_MEMORY_MMAP;
+  VERIFY(ioctl(fd, VIDIOC_QBUF, &buffer) != -1);
 }
 
 void NaoCameraV6::initDefaultControlSettings(bool flip)
@@ -9,10 +9,21 @@
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Representations/Infrastructure/CameraSettingsV6.h"
 #include "Representations/Infrastructure/CameraRegisters.h"
+#include "Thread.h"
+#include "Semaphore.h"
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /**
  * @class NaoCameraV6
- * Interface to a camera of the NAO
+ * Interface to a camera of the NAO.
+ * The camera controls and registers are written by a thread of each camera,
+ * because some of the ioctls block for milliseconds. Only the latest settings
+ * requested are applied.
  */
 class NaoCameraV6
 {
@@ -20,17 +31,41 @@ public:
   unsigned int timeWaitedForLastImage = 0; /**< The time (in _milliseconds_) passed while waiting for a new image. */
 
 protected:
+  /** The kinds of messages the control thread can send. */
+  enum class MessageType
+  {
+    text,
+    warning,
+    error
+  };
+
+  /** A message of the control thread. */
+  struct Message
+  {
+    MessageType type;
+    std::string text;
+  };
+
   bool upper; /**< The camera accessed by this driver. */
-  CameraSettingsV6 settings; /**< The camera control settings. */
-  CameraSettingsV6 appliedSettings; /**< The camera settings that are known to be applied. */
+  CameraSettingsV6 settings; /**< The camera control settings. Used by the control thread while deviceMutex is locked. */
+  CameraSettingsV6 appliedSettings; /**< The camera settings that are known to be applied. Used by the control thread while deviceMutex is locked. */
+
+  Thread<NaoCameraV6> controlThread; /**< The thread that writes the camera controls. */
+  Semaphore controlRequested; /**< Wakes the control thread up if new settings were requested. */
+  std::mutex deviceMutex; /**< Serializes the accesses to the camera controls and registers. */
+  std::mutex requestMutex; /**< Guards the members shared with the control thread. Never held during an ioctl. */
+  CameraSettingsV6 requestedSettings; /**< The latest settings requested. */
+  CameraSettingsV6 publishedSettings; /**< A copy of the applied settings for the thread that requests settings. */
+  unsigned requestNumber = 0; /**< Incremented if different settings are requested. */
+  unsigned completedRequest = 0; /**< The number of the latest request that was completely applied. */
+  std::vector<Message> messages; /**< The messages of the control thread that were not sent yet. */
 
   unsigned int updateRegisterIndex = 0;
   uint8_t updateRegisterIndexByte = 0;
 
-  enum
-  {
-    frameBufferCount = 3
-  }; /**< Amount of available frame buffers. */
+  static constexpr unsigned maxFrameBufferCount = 8; /**< The maximum number of frame buffers. */
+  static constexpr unsigned minQueuedFrameBuffers = 2; /**< Frames are only shared if at least this number of buffers remains queued. */
+  unsigned frameBufferCount; /**< Amount of available frame buffers. */
 
   unsigned int WIDTH; /**< The width of the yuv 422 image */
   unsigned int HEIGHT; /**< The height of the yuv 422 image */
@@ -38,13 +73,16 @@ protected:
   unsigned int SIZE; /**< The size of an image in bytes */
 #endif
   int fd; /**< The file descriptor for the video device. */
-  void* mem[frameBufferCount]; /**< Frame buffer addresses. */
-  int memLength[frameBufferCount]; /**< The length of each frame buffer. */
+  void* mem[maxFrameBufferCount]; /**< Frame buffer addresses. */
+  int memLength[maxFrameBufferCount]; /**< The length of each frame buffer. */
   struct v4l2_buffer* buf = nullptr; /**< Reusable parameter struct for some ioctl calls. */
   struct v4l2_buffer* currentBuf = nullptr; /**< The last dequeued frame buffer. */
+  std::shared_ptr<const void> currentFrame; /**< The reference to the last dequeued frame buffer held by this driver. */
+  std::shared_ptr<std::array<std::atomic<bool>, maxFrameBufferCount>> released = std::make_shared<std::array<std::atomic<bool>, maxFrameBufferCount>>(); /**< Buffers whose last reference was released, but that were not queued again yet. Shared with the references. */
+  std::array<bool, maxFrameBufferCount> dequeued{}; /**< Buffers currently not queued in the driver. */
   bool first = true; /**< First image grabbed? */
   unsigned long long timeStamp = 0; /**< Timestamp of the last captured image in microseconds. */
-  unsigned frameCounter = 0; /**< FrameCounter, used to write camera settings only after camera had time to start. */
+  unsigned nextControlWrite = 0; /**< The time when the control thread writes the next camera setting. It waits, so that the camera has time to adapt. */
 public:
   /**
    * Constructor.
@@ -53,8 +91,9 @@ public:
    * @param width The width of the camera image in pixels. V4L only allows certain values (e.g. 320 or 640)
    * @param height The height of the camera image in pixels. V4L only allows certain values (e.g. 240 or 320)
    * @param flip Whether the image should be flipped
+   * @param frameBuffers The number of frame buffers. More than 3 are only needed if images are shared across frames.
    */
-  NaoCameraV6(const char* device, bool upper, int width, int height, bool flip);
+  NaoCameraV6(const char* device, bool upper, int width, int height, bool flip, unsigned frameBuffers = 3);
   virtual ~NaoCameraV6();
 
   /**
@@ -84,6 +123,15 @@ public:
    */
   const unsigned char* getImage() const;
 
+  /**
+   * A reference to the buffer of the last captured image. The buffer is only
+   * queued again after the image was released and all copies of this
+   * reference were destroyed.
+   * @return The reference or an empty pointer if no image is captured or too
+   *         few buffers are left to share one.
+   */
+  std::shared_ptr<const void> getFrame() const;
+
   /**
    * Whether an image has been captured.
    * @return true if there is one
@@ -111,13 +159,11 @@ public:
    * Requests the current camera control settings of the camera.
    * @return The settings.
    */
-  const CameraSettingsV6& getSettings() const
-  {
-    return appliedSettings;
-  };
+  CameraSettingsV6 getSettings();
 
   /**
-   * Sets the camera control settings to the camera.
+   * Requests camera control settings. They are written in the background. If
+   * they are requested again before they were applied, only the latest ones are.
    * @param settings The settings.
    */
   void setSettings(const CameraSettingsV6& settings);
@@ -128,7 +174,9 @@ public:
   void assertCameraSettings();
 
   /**
-   * Unconditional write of the camera settings
+   * Sends the messages of the control thread and returns whether the settings
+   * requested were written. Never blocks.
+   * @return Were the latest settings requested applied completely?
    */
   bool writeCameraSettings();
 
@@ -144,6 +192,24 @@ public:
   void outputCurrentValues();
 
 protected:
+  /** The main function of the control thread. */
+  void controlMain();
+
+  /**
+   * Writes the next change of the camera settings. Must be called while deviceMutex is locked.
+   * @param delay The time in ms to wait before the next step is returned here.
+   * @return Are all settings applied?
+   */
+  bool writeNextSetting(unsigned& delay);
+
+  /**
+   * Sends a message. Messages of the control thread are queued until writeCameraSettings
+   * is called, because it has no debug queue of its own.
+   * @param type The kind of the message.
+   * @param text The message.
+   */
+  void report(MessageType type, const std::string& text);
+
   /**
    * Requests the value of a camera control setting from camera.
    * @param id The setting id.
@@ -167,6 +233,18 @@ protected:
   void initSetImageFormat();
   void initRequestAndMapBuffers();
   void initQueueAllBuffers();
+
+  /**
+   * Queues a frame buffer so that the driver can capture an image into it.
+   * @param index The index of the buffer.
+   */
+  void queueBuffer(unsigned index);
+
+  /** Makes the buffer that was just dequeued into buf the current one. */
+  void setCurrentBuffer();
+
+  /** Queues all buffers whose last reference was released. */
+  void queueReleasedBuffers();
   void initDefaultControlSettings(bool flip);
   void startCapturing();
 };
@@ -0,0 +1,70 @@
+/**
+* @file Platform/Linux/PerfCounters.cpp
+*
+* Implementation of a class that reads hardware performance counters via perf_event.
+*/
+
+#include "PerfCounters.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <cstring>
+#include <unistd.h>
+
+PerfCounters::PerfCounters()
+{
+  static constexpr unsigned long long configs[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+  for (int i = 0; i < 4; ++i)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = configs[i];
+    attr.disabled = i == 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    descriptors[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : descriptors[0], 0));
+    if (descriptors[i] == -1)
+    {
+      // all or nothing
+      while (i-- > 0)
+      {
+        close(descriptors[i]);
+        descriptors[i] = -1;
+      }
+      return;
+    }
+  }
+
+  ioctl(descriptors[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(descriptors[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfCounters::~PerfCounters()
+{
+  for (int descriptor : descriptors)
+    if (descriptor != -1)
+      close(descriptor);
+}
+
+PerfCounters::Values PerfCounters::read() const
+{
+  Values values;
+  if (isAvailable())
+  {
+    // PERF_FORMAT_GROUP: number of counters followed by their values
+    unsigned long long buffer[5];
+    if (::read(descriptors[0], buffer, sizeof(buffer)) == sizeof(buffer) && buffer[0] == 4)
+    {
+      values.cycles = buffer[1];
+      values.instructions = buffer[2];
+      values.cacheMisses = buffer[3];
+      values.branchMisses = buffer[4];
+    }
+  }
+  return values;
+}
@@ -0,0 +1,52 @@
+/**
+* @file Platform/Linux/PerfCounters.h
+*
+* Declaration of a class that reads hardware performance counters via perf_event.
+*/
+
+#pragma once
+
+/**
+* The hardware performance counters of the thread that created the object.
+* All counters are opened as a single group, so they are read with a
+* single system call and always refer to the same time span. Only user
+* space is counted, which is also permitted without root privileges.
+*/
+class PerfCounters
+{
+public:
+  /** The values of the counters. */
+  struct Values
+  {
+    unsigned long long cycles = 0;
+    unsigned long long instructions = 0;
+    unsigned long long cacheMisses = 0;
+    unsigned long long branchMisses = 0;
+  };
+
+  /**
+  * Opens the counters for the calling thread.
+  */
+  PerfCounters();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /**
+  * Are the counters available? They are not if the kernel or the
+  * processor do not support them or if they are not permitted.
+  * @return Can the counters be read?
+  */
+  bool isAvailable() const { return descriptors[0] != -1; }
+
+  /**
+  * Reads the counters. Must be called by the thread that created the object.
+  * @return The values counted since the object was created.
+  */
+  Values read() const;
+
+private:
+  int descriptors[4] = {-1, -1, -1, -1}; /**< The file descriptors of cycles (group leader), instructions, cache misses, and branch misses. */
+};
@@ -0,0 +1,136 @@
+/**
+* @file Platform/Linux/SamplingProfiler.cpp
+*
+* Implementation of a sampling profiler based on SIGPROF.
+*/
+
+#include "SamplingProfiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+thread_local const char* SamplingProfiler::currentModule = nullptr;
+
+namespace
+{
+  struct Sample
+  {
+    const char* module;
+    const void* pc;
+  };
+
+  constexpr unsigned maxNumOfSamples = 1 << 18;
+  Sample samples[maxNumOfSamples];
+  std::atomic<unsigned> numOfSamples(0);
+  std::atomic<bool> running(false);
+
+  const void* getProgramCounter(void* context)
+  {
+#if defined __x86_64__
+    return reinterpret_cast<const void*>(static_cast<const ucontext_t*>(context)->uc_mcontext.gregs[REG_RIP]);
+#elif defined __aarch64__
+    return reinterpret_cast<const void*>(static_cast<const ucontext_t*>(context)->uc_mcontext.pc);
+#else
+    return nullptr;
+#endif
+  }
+
+  /**
+  * Determines the name of the function containing an address.
+  * @param pc The address.
+  * @return The demangled name of the function or the offset in its binary.
+  */
+  std::string getFunctionName(const void* pc)
+  {
+    Dl_info info;
+    if (pc && dladdr(pc, &info))
+    {
+      if (info.dli_sname)
+      {
+        int status;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        const std::string name = status == 0 ? demangled : info.dli_sname;
+        std::free(demangled);
+        return name;
+      }
+      if (info.dli_fname)
+      {
+        char offset[32];
+        std::snprintf(offset, sizeof(offset), "+0x%lx", static_cast<unsigned long>(static_cast<const char*>(pc) - static_cast<const char*>(info.dli_fbase)));
+        const std::string file = info.dli_fname;
+        return file.substr(file.rfind('/') + 1) + offset;
+      }
+    }
+    char address[32];
+    std::snprintf(address, sizeof(address), "%p", pc);
+    return address;
+  }
+} // namespace
+
+void SamplingProfiler::handleSignal(int, siginfo_t*, void* context)
+{
+  const unsigned index = numOfSamples.fetch_add(1, std::memory_order_relaxed);
+  if (index < maxNumOfSamples)
+    samples[index] = {currentModule, getProgramCounter(context)};
+}
+
+bool SamplingProfiler::start(unsigned interval)
+{
+#ifdef TARGET_ROBOT
+  if (!interval || running.exchange(true))
+    return false;
+
+  numOfSamples = 0;
+
+  struct sigaction action = {};
+  action.sa_sigaction = handleSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGPROF, &action, nullptr);
+
+  itimerval timer;
+  timer.it_interval.tv_sec = interval / 1000000;
+  timer.it_interval.tv_usec = interval % 1000000;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  return true;
+#else
+  static_cast<void>(interval);
+  return false;
+#endif
+}
+
+void SamplingProfiler::stop()
+{
+  if (!running)
+    return;
+
+  // The handler stays installed, because signals may still be pending.
+  const itimerval timer = {};
+  setitimer(ITIMER_PROF, &timer, nullptr);
+  running = false;
+}
+
+void SamplingProfiler::collect(std::unordered_map<std::string, unsigned>& counts)
+{
+  const unsigned recorded = numOfSamples.exchange(0);
+  const unsigned n = std::min(recorded, maxNumOfSamples);
+
+  // many samples hit the same addresses
+  std::unordered_map<const void*, std::string> functionNames;
+  for (unsigned i = 0; i < n; ++i)
+  {
+    const Sample& sample = samples[i];
+    auto functionName = functionNames.find(sample.pc);
+    if (functionName == functionNames.end())
+      functionName = functionNames.emplace(sample.pc, getFunctionName(sample.pc)).first;
+    ++counts[std::string(sample.module ? sample.module : "(no module)") + ";" + functionName->second];
+  }
+  if (recorded > n)
+    counts["(dropped)"] += recorded - n;
+}
@@ -0,0 +1,57 @@
+/**
+* @file Platform/Linux/SamplingProfiler.h
+*
+* Declaration of a sampling profiler that attributes the CPU time of the
+* process to the modules and functions currently executing.
+*/
+
+#pragma once
+
+#include <csignal>
+#include <string>
+#include <unordered_map>
+
+/**
+* A process-wide sampling profiler. While it runs, the kernel sends SIGPROF
+* to the thread that is running whenever the process has consumed another
+* interval of CPU time. The signal handler records the module the thread
+* currently executes and the interrupted program counter. Only the robot
+* code is profiled, because the handler accesses thread-local storage,
+* which is not async-signal-safe in a shared library.
+*/
+class SamplingProfiler
+{
+public:
+  /**
+  * Sets the module the calling thread is executing.
+  * @param module The name of the module or nullptr if it does not execute one.
+  */
+  static void setCurrentModule(const char* module) { currentModule = module; }
+
+  /**
+  * Starts sampling. Samples recorded before are discarded.
+  * @param interval The CPU time between two samples in µs.
+  * @return Did this call start the profiler? It did not if it was already running or is not supported.
+  */
+  static bool start(unsigned interval);
+
+  /** Stops sampling. */
+  static void stop();
+
+  /**
+  * Moves the samples recorded since the last start into a histogram. Must only be called
+  * while the profiler is stopped.
+  * @param counts The number of samples per "module;function" are added to this map.
+  *               Samples that did not fit into the buffer are counted as "(dropped)".
+  */
+  static void collect(std::unordered_map<std::string, unsigned>& counts);
+
+private:
+  static thread_local const char* currentModule; /**< The module the thread is executing. */
+
+  /**
+  * Records a sample.
+  * @param context The context of the interrupted thread.
+  */
+  static void handleSignal(int, siginfo_t*, void* context);
+};
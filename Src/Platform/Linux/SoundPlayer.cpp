@@ -5,11 +5,15 @@
 * @author Colin Graf
 */
 
-#include <sys/wait.h>
-
 #include "SoundPlayer.h"
 #include "Platform/File.h"
 #include <Platform/Common/Text2Speech.h>
+#include <portaudio.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 
 SoundPlayer SoundPlayer::soundPlayer;
 
@@ -33,34 +37,122 @@ void SoundPlayer::main()
 {
   setName("SoundPlayer");
 
+  PaError paerr = Pa_Initialize();
+  if (paerr == paNoError)
+    paerr = Pa_OpenDefaultStream(&stream, 0, 1, paInt16, sampleRate, framesPerBlock, nullptr, nullptr);
+  if (paerr != paNoError)
+  {
+    fprintf(stderr, "SoundPlayer: Failed to open the output stream: %s\n", Pa_GetErrorText(paerr));
+    stream = nullptr;
+  }
+  preload();
+
   while (isRunning() && !closing)
   {
-    flush();
-    VERIFY(sem.wait());
+    startQueuedSounds();
+    if (!voices.empty())
+      mixBlock();
+    else
+    {
+      // the stream is stopped after the samples written were played
+      if (streaming)
+      {
+        Pa_StopStream(stream);
+        streaming = false;
+      }
+      VERIFY(sem.wait());
+    }
   }
+
+  if (stream)
+    Pa_CloseStream(stream);
+  Pa_Terminate();
 }
 
-void SoundPlayer::playDirect(const std::string& basename)
+void SoundPlayer::preload()
 {
-  std::string fileName(filePrefix);
-  fileName += basename;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(filePrefix, error))
+    if (entry.is_regular_file() && entry.path().extension() == ".wav")
+      getSamples(entry.path().filename().string());
+}
 
-  int r = vfork();
-  if (r == -1)
-    perror("SoundPlayer: fork() failed");
-  else if (r != 0) //parent
+const std::vector<short>* SoundPlayer::getSamples(const std::string& basename)
+{
+  const auto cached = cache.find(basename);
+  if (cached != cache.end())
+    return &cached->second;
+
+  std::vector<short> samples;
+  if (!decode(filePrefix + basename, samples))
   {
-    int status;
-    waitpid(r, &status, 0);
+    fprintf(stderr, "SoundPlayer: Cannot decode %s\n", basename.c_str());
+    return nullptr;
   }
-  else //child
+  return &cache.emplace(basename, std::move(samples)).first->second;
+}
+
+bool SoundPlayer::decode(const std::string& fileName, std::vector<short>& samples)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  const auto read16 = [&](size_t i) { return static_cast<unsigned>(bytes[i] | bytes[i + 1] << 8); };
+  const auto read32 = [&](size_t i) { return read16(i) | read16(i + 2) << 16; };
+
+  if (bytes.size() < 12 || !std::equal(bytes.begin(), bytes.begin() + 4, "RIFF") || !std::equal(bytes.begin() + 8, bytes.begin() + 12, "WAVE"))
+    return false;
+
+  unsigned format = 0, channels = 0, rate = 0, bits = 0;
+  size_t data = 0, dataSize = 0;
+  for (size_t i = 12; i + 8 <= bytes.size();)
   {
-    if (execlp("aplay", "aplay", "-q", fileName.c_str(), (char*)0) == -1)
-      perror("SoundPlayer: exec failed");
+    const size_t chunkSize = read32(i + 4);
+    if (std::equal(bytes.begin() + i, bytes.begin() + i + 4, "fmt ") && i + 24 <= bytes.size())
+    {
+      format = read16(i + 8);
+      channels = read16(i + 10);
+      rate = read32(i + 12);
+      bits = read16(i + 22);
+    }
+    else if (std::equal(bytes.begin() + i, bytes.begin() + i + 4, "data"))
+    {
+      data = i + 8;
+      dataSize = std::min(chunkSize, bytes.size() - data);
+    }
+    i += 8 + chunkSize + (chunkSize & 1);
+  }
+  if (format != 1 || (bits != 8 && bits != 16) || !channels || !rate || !data)
+    return false;
+
+  // all channels are mixed into one, 8 bit samples are unsigned
+  const size_t frameBytes = channels * bits / 8;
+  const size_t frames = dataSize / frameBytes;
+  std::vector<float> mono(frames + 1, 0.f);
+  for (size_t frame = 0; frame < frames; ++frame)
+  {
+    float sum = 0.f;
+    for (unsigned channel = 0; channel < channels; ++channel)
+    {
+      const size_t i = data + frame * frameBytes + channel * bits / 8;
+      sum += bits == 8 ? (static_cast<float>(bytes[i]) - 128.f) * 256.f : static_cast<float>(static_cast<short>(read16(i)));
+    }
+    mono[frame] = sum / static_cast<float>(channels);
+  }
+
+  // linear interpolation between the samples of the file
+  const double step = static_cast<double>(rate) / sampleRate;
+  samples.resize(static_cast<size_t>(static_cast<double>(frames) / step));
+  for (size_t i = 0; i < samples.size(); ++i)
+  {
+    const double position = static_cast<double>(i) * step;
+    const size_t index = static_cast<size_t>(position);
+    const float ratio = static_cast<float>(position - static_cast<double>(index));
+    samples[i] = static_cast<short>(mono[index] + (mono[index + 1] - mono[index]) * ratio);
   }
+  return true;
 }
 
-void SoundPlayer::flush()
+void SoundPlayer::startQueuedSounds()
 {
   for (;;)
   {
@@ -73,16 +165,37 @@ void SoundPlayer::flush()
       queue.pop_front();
     }
     if (first.substr(0, 4).compare("t2s:") == 0)
-    {
       Text2Speech::getInstance().text2Speech(first.substr(3));
-    }
-    else
+    else if (stream && std::none_of(voices.begin(), voices.end(), [&](const Voice& voice) { return voice.name == first; }))
     {
-      playDirect(first);
+      const std::vector<short>* samples = getSamples(first);
+      if (samples && !samples->empty())
+        voices.push_back({first, samples});
     }
   }
 }
 
+void SoundPlayer::mixBlock()
+{
+  block.resize(framesPerBlock);
+  for (size_t i = 0; i < framesPerBlock; ++i)
+  {
+    int sum = 0;
+    for (Voice& voice : voices)
+      if (voice.position < voice.samples->size())
+        sum += (*voice.samples)[voice.position++];
+    block[i] = static_cast<short>(std::clamp(sum, -32768, 32767));
+  }
+  voices.erase(std::remove_if(voices.begin(), voices.end(), [](const Voice& voice) { return voice.position >= voice.samples->size(); }), voices.end());
+
+  if (!streaming)
+    streaming = Pa_StartStream(stream) == paNoError;
+  if (streaming)
+    Pa_WriteStream(stream, block.data(), framesPerBlock);
+  else
+    voices.clear();
+}
+
 int SoundPlayer::play(const std::string& name)
 {
   int queuelen;
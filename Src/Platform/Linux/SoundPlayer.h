@@ -8,9 +8,17 @@
 
 #include <deque>
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include "Thread.h"
 #include "Semaphore.h"
 
+/**
+ * Plays the sounds in Config/Sounds without starting other processes. The sounds are
+ * decoded once into a cache and mixed by a thread of their own. Different sounds are
+ * played simultaneously, but a sound that is still playing is not started again.
+ * Text to speech ("t2s:" prefix) is passed on to Text2Speech.
+ */
 class SoundPlayer : Thread<SoundPlayer>
 {
 public:
@@ -23,6 +31,17 @@ public:
   static int play(const std::string& name);
 
 private:
+  /** A sound that is currently played. */
+  struct Voice
+  {
+    std::string name;
+    const std::vector<short>* samples;
+    size_t position = 0; /**< The index of the next sample mixed. */
+  };
+
+  static constexpr int sampleRate = 44100; /**< The sample rate of the output and the cache. */
+  static constexpr unsigned long framesPerBlock = 441; /**< The number of samples mixed at once, i.e. the latency of starting a sound. */
+
   static SoundPlayer soundPlayer; /**< The only instance of this class. */
 
   /**
@@ -35,11 +54,6 @@ private:
   */
   ~SoundPlayer();
 
-  /**
-   * play all sounds in queue and block until finished.
-   */
-  void flush();
-
   /**
    * main function of this thread
    */
@@ -50,6 +64,31 @@ private:
    */
   void start();
 
+  /** Decodes all wave files in Config/Sounds into the cache. */
+  void preload();
+
+  /**
+   * Returns the samples of a sound, decoding it if it is not in the cache yet.
+   * @param basename The filename of the sound relative to Config/Sounds.
+   * @return The samples or nullptr if the sound could not be decoded.
+   */
+  const std::vector<short>* getSamples(const std::string& basename);
+
+  /**
+   * Decodes an uncompressed wave file with 8 or 16 bits per sample. All channels are
+   * mixed into one and the samples are resampled to the output rate.
+   * @param fileName The full path of the file.
+   * @param samples The samples are returned here.
+   * @return Could the file be decoded?
+   */
+  static bool decode(const std::string& fileName, std::vector<short>& samples);
+
+  /** Starts the sounds in the queue. Text to speech is run directly. */
+  void startQueuedSounds();
+
+  /** Mixes the next block of all voices and writes it to the device. Blocks while the device is busy. */
+  void mixBlock();
+
   std::deque<std::string> queue;
   std::string filePrefix;
   DECLARE_SYNC;
@@ -57,5 +96,9 @@ private:
   Semaphore sem;
   volatile bool closing;
 
-  void playDirect(const std::string& basename);
+  std::unordered_map<std::string, std::vector<short>> cache; /**< The decoded sounds. Only used by the thread. */
+  std::vector<Voice> voices; /**< The sounds currently played. */
+  std::vector<short> block; /**< The samples currently mixed. */
+  void* stream = nullptr; /**< The portaudio output stream or nullptr if there is no output device. */
+  bool streaming = false; /**< Is the stream started? It is stopped while no sound is played. */
 };
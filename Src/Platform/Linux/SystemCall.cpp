@@ -31,6 +31,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 #include <cstdio> /* defines FILENAME_MAX */
+#include <new>
 
 
 uint64_t SystemCall::base = 0;
@@ -206,15 +207,8 @@ unsigned long long SystemCall::getFreeDiskSpace(const char* path)
 
 void* SystemCall::alignedMalloc(size_t size, size_t alignment)
 {
-  void* ptr;
-  if (!posix_memalign(&ptr, alignment, size))
-  {
-    return ptr;
-  }
-  else
-  {
-    return nullptr;
-  }
+  // allocated through operator new, so that the allocation is counted
+  return ::operator new(size, static_cast<std::align_val_t>(alignment), std::nothrow);
 }
 
 void SystemCall::alignedFree(void* ptr)
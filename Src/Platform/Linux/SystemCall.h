@@ -96,6 +96,16 @@ public:
   /** Free aligned memory.*/
   static void alignedFree(void* ptr);
 
+  /**
+   * Returns the number of heap allocations the calling thread made with operator new
+   * or alignedMalloc since it was started. The difference before and after a block of
+   * code shows whether the block allocated memory.
+   */
+  static size_t getHeapAllocationsOfThread();
+
+  /** Returns the number of bytes the calling thread allocated with operator new or alignedMalloc since it was started. */
+  static size_t getHeapBytesOfThread();
+
   /**
    * If you want to play Config/Sounds/bla.wav use play("bla.wav");
    * @param name The filename of the sound file.
@@ -0,0 +1,138 @@
+/**
+* @file Platform/Linux/SystemMonitor.cpp
+*
+* Implementation of a class that samples the load of the system and of some of
+* its threads in the background.
+*/
+
+#include "SystemMonitor.h"
+#include "Platform/SystemCall.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+SystemMonitor::SystemMonitor(const std::vector<std::string>& threadNames, unsigned interval) : interval(interval)
+{
+  for (const std::string& name : threadNames)
+    tasks.push_back({name.substr(0, 15)}); // names are truncated by the kernel
+  thread.start(this, &SystemMonitor::main);
+}
+
+SystemMonitor::~SystemMonitor()
+{
+  thread.announceStop();
+  terminate.post();
+  thread.stop();
+  for (Task& task : tasks)
+    if (task.fd != -1)
+      close(task.fd);
+}
+
+const SystemMonitor::Snapshot* SystemMonitor::read()
+{
+  return snapshots.beginRead() ? &snapshots.readBuffer() : nullptr;
+}
+
+void SystemMonitor::main()
+{
+  Thread<SystemMonitor>::setName("SystemMonitor");
+  setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+
+  const float ticksPerSecond = static_cast<float>(sysconf(_SC_CLK_TCK));
+  while (thread.isRunning())
+  {
+    const unsigned now = SystemCall::getCurrentSystemTime();
+    if (now - lastSearchTime >= 10000 && std::any_of(tasks.begin(), tasks.end(), [](const Task& task) { return task.fd == -1; }))
+    {
+      lastSearchTime = now;
+      findTasks();
+    }
+
+    Snapshot& snapshot = snapshots.writeBuffer();
+    snapshot.threadUsage.resize(tasks.size());
+    SystemCall::getLoad(snapshot.memoryUsage, snapshot.load);
+    snapshot.wlan = access("/sys/class/net/wlan0", F_OK) == 0;
+    const float seconds = static_cast<float>(now - lastSampleTime) / 1000.f;
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+      Task& task = tasks[i];
+      unsigned long long ticks;
+      if (readTicks(task, ticks))
+      {
+        snapshot.threadUsage[i] = task.sampled && seconds > 0.f ? static_cast<float>(ticks - task.ticks) / ticksPerSecond / seconds : 0.f;
+        task.ticks = ticks;
+        task.sampled = true;
+      }
+      else
+        snapshot.threadUsage[i] = -1.f;
+    }
+    lastSampleTime = now;
+    snapshots.finishWrite();
+
+    terminate.wait(interval);
+  }
+}
+
+void SystemMonitor::findTasks()
+{
+  DIR* dir = opendir("/proc/self/task");
+  if (!dir)
+    return;
+  while (const dirent* entry = readdir(dir))
+  {
+    if (entry->d_name[0] == '.')
+      continue;
+    const std::string path = std::string("/proc/self/task/") + entry->d_name;
+    char name[32];
+    const int fd = open((path + "/comm").c_str(), O_RDONLY);
+    if (fd == -1)
+      continue;
+    const ssize_t length = ::read(fd, name, sizeof(name) - 1);
+    close(fd);
+    if (length <= 0)
+      continue;
+    name[name[length - 1] == '\n' ? length - 1 : length] = 0;
+
+    for (Task& task : tasks)
+      if (task.fd == -1 && task.name == name)
+      {
+        task.fd = open((path + "/stat").c_str(), O_RDONLY);
+        task.sampled = false;
+        break;
+      }
+  }
+  closedir(dir);
+}
+
+bool SystemMonitor::readTicks(Task& task, unsigned long long& ticks)
+{
+  if (task.fd == -1)
+    return false;
+
+  // the name in parentheses can contain spaces, so the fields are counted after it
+  char buffer[512];
+  const ssize_t length = pread(task.fd, buffer, sizeof(buffer) - 1, 0);
+  const char* p = length > 0 ? (buffer[length] = 0, strrchr(buffer, ')')) : nullptr;
+  if (!p)
+  {
+    // the thread has terminated
+    close(task.fd);
+    task.fd = -1;
+    return false;
+  }
+
+  // utime and stime are the 12th and 13th field after the name
+  for (int field = 0; field < 12 && p; ++field)
+    p = strchr(p + 1, ' ');
+  if (!p)
+    return false;
+  char* end;
+  const unsigned long long utime = strtoull(p, &end, 10);
+  ticks = utime + strtoull(end, nullptr, 10);
+  return true;
+}
@@ -0,0 +1,82 @@
+/**
+* @file Platform/Linux/SystemMonitor.h
+*
+* Declaration of a class that samples the load of the system and of some of
+* its threads in the background.
+*/
+
+#pragma once
+
+#include "Thread.h"
+#include "Semaphore.h"
+#include "Tools/TripleBuffer.h"
+#include <string>
+#include <vector>
+
+/**
+* Samples the load averages, the memory usage, the state of the WLAN hardware
+* and the CPU usage of threads of this process in a thread of its own with the
+* normal scheduler and a lower nice level. The stat files of the threads
+* monitored are kept open and are read with pread. The results are published
+* through a triple buffer, so reading them never blocks.
+*/
+class SystemMonitor
+{
+public:
+  /** The results of a sample. */
+  struct Snapshot
+  {
+    float load[3] = {0.f, 0.f, 0.f}; /**< The load averages of 1, 5, and 15 minutes. */
+    float memoryUsage = 0.f; /**< The ratio of the memory used. */
+    bool wlan = true; /**< Does the WLAN device exist? */
+    std::vector<float> threadUsage; /**< The ratio of a core used by each thread monitored since the previous sample, -1 if the thread was not found. */
+  };
+
+  /**
+  * Starts to sample.
+  * @param threadNames The names of the threads whose CPU usage is sampled.
+  * @param interval The time between two samples in ms.
+  */
+  SystemMonitor(const std::vector<std::string>& threadNames, unsigned interval);
+
+  /** Stops sampling and closes the files. */
+  ~SystemMonitor();
+
+  /**
+  * Returns the latest sample if there is a new one.
+  * @return The sample or nullptr if there is no new sample since the previous call.
+  */
+  const Snapshot* read();
+
+private:
+  /** A thread of this process that is monitored. */
+  struct Task
+  {
+    std::string name; /**< The name of the thread. */
+    int fd = -1; /**< The open stat file of the thread or -1 if it was not found. */
+    unsigned long long ticks = 0; /**< The CPU time used by the thread in the previous sample in clock ticks. */
+    bool sampled = false; /**< Was the thread sampled before, i.e. is the previous CPU time valid? */
+  };
+
+  /** The main function of the thread. */
+  void main();
+
+  /** Searches the threads of this process for the ones that are monitored but not open. */
+  void findTasks();
+
+  /**
+  * Reads the CPU time a thread used.
+  * @param task The thread. Its file is closed if it cannot be read anymore.
+  * @param ticks The CPU time in clock ticks is returned here.
+  * @return Could the time be read?
+  */
+  static bool readTicks(Task& task, unsigned long long& ticks);
+
+  std::vector<Task> tasks; /**< The threads monitored. */
+  unsigned interval; /**< The time between two samples in ms. */
+  unsigned lastSampleTime = 0; /**< The time of the previous sample. */
+  unsigned lastSearchTime = 0; /**< The time the threads were searched. */
+  Thread<SystemMonitor> thread; /**< The thread that samples. */
+  Semaphore terminate; /**< Wakes the thread up when it should stop. */
+  TripleBuffer<Snapshot> snapshots; /**< The lock-free channel to the reader. */
+};
@@ -11,11 +11,10 @@
 #pragma once
 
 #include <pthread.h>
-#ifdef MACOS
 #include <sched.h>
-#endif
 #include <unistd.h>
 #include <string>
+#include <vector>
 #include "Platform/BHAssert.h"
 #include "Platform/Semaphore.h"
 
@@ -189,6 +188,41 @@ public:
     return (size_t)pthread_self();
   }
 
+  /**
+   * The function sets the priority of the calling thread.
+   * @param prio Real-time priority or 0 for "normal" priority.
+   */
+  static void setCurrentPriority(int prio)
+  {
+    ASSERT(prio == 0 || (prio > 0 && prio <= sched_get_priority_max(SCHED_FIFO)));
+    sched_param param;
+    param.sched_priority = prio;
+    VERIFY(!pthread_setschedparam(pthread_self(), prio == 0 ? SCHED_OTHER : SCHED_FIFO, &param));
+  }
+
+  /**
+   * The function restricts the calling thread to a set of CPU cores.
+   * @param cores The indices of the cores. If empty, all cores are allowed.
+   */
+  static void setCurrentAffinity(const std::vector<int>& cores)
+  {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cores.empty())
+      for (long core = 0; core < sysconf(_SC_NPROCESSORS_CONF); ++core)
+        CPU_SET(core, &set);
+    else
+      for (int core : cores)
+        CPU_SET(core, &set);
+    VERIFY(!pthread_setaffinity_np(pthread_self(), sizeof(set), &set));
+  }
+
+  /**
+   * The function returns the core the calling thread is currently running on.
+   * @return The index of the core.
+   */
+  static int getCurrentCore() { return sched_getcpu(); }
+
   /**
     * Causes the calling thread to relinquish the CPU.
     */
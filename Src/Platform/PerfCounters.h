@@ -0,0 +1,15 @@
+/**
+* @file Platform/PerfCounters.h
+*
+* Inclusion of platform dependent definitions for hardware performance counters.
+*/
+
+#pragma once
+
+#ifdef LINUX
+#include "Linux/PerfCounters.h"
+#define PERFCOUNTERS_INCLUDED
+#else
+#include "Common/PerfCounters.h"
+#define PERFCOUNTERS_INCLUDED
+#endif
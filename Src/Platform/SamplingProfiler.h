@@ -0,0 +1,13 @@
+/**
+* @file Platform/SamplingProfiler.h
+*
+* Inclusion of platform dependent definitions for the sampling profiler.
+*/
+
+#pragma once
+
+#ifdef LINUX
+#include "Linux/SamplingProfiler.h"
+#else
+#include "Common/SamplingProfiler.h"
+#endif
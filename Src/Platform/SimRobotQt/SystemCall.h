@@ -89,6 +89,15 @@ public:
   /** Free aligned memory.*/
   static void alignedFree(void* ptr);
 
+  /**
+   * Returns the number of heap allocations the calling thread made with operator new
+   * since it was started. They are only counted in Debug builds, otherwise 0 is returned.
+   */
+  static size_t getHeapAllocationsOfThread();
+
+  /** Returns the number of bytes the calling thread allocated with operator new since it was started (only in Debug builds). */
+  static size_t getHeapBytesOfThread();
+
 #ifdef TARGET_SIM
   /**
    * Put a filename into play sound queue.
@@ -166,6 +166,36 @@ public:
    */
   static unsigned getCurrentId() { return GetCurrentThreadId(); }
 
+  /**
+   * The function sets the priority of the calling thread.
+   * @param prio Priority relative to THREAD_PRIORITY_NORMAL.
+   */
+  static void setCurrentPriority(int prio) { SetThreadPriority(GetCurrentThread(), prio + THREAD_PRIORITY_NORMAL); }
+
+  /**
+   * The function restricts the calling thread to a set of CPU cores.
+   * @param cores The indices of the cores. If empty, all cores of the process are allowed.
+   */
+  static void setCurrentAffinity(const std::vector<int>& cores)
+  {
+    DWORD_PTR mask = 0;
+    if (cores.empty())
+    {
+      DWORD_PTR systemMask;
+      GetProcessAffinityMask(GetCurrentProcess(), &mask, &systemMask);
+    }
+    else
+      for (int core : cores)
+        mask |= static_cast<DWORD_PTR>(1) << core;
+    SetThreadAffinityMask(GetCurrentThread(), mask);
+  }
+
+  /**
+   * The function returns the core the calling thread is currently running on.
+   * @return The index of the core.
+   */
+  static int getCurrentCore() { return static_cast<int>(GetCurrentProcessorNumber()); }
+
   /**
    * Causes the calling thread to relinquish the CPU.
    */
@@ -16,6 +16,7 @@
 #endif
 #include <unistd.h>
 #include <string>
+#include <vector>
 #include "Platform/BHAssert.h"
 #include "Platform/Semaphore.h"
 
@@ -176,6 +177,30 @@ public:
     return (size_t)pthread_self();
   }
 
+  /**
+   * The function sets the priority of the calling thread.
+   * @param prio Real-time priority or 0 for "normal" priority.
+   */
+  static void setCurrentPriority(int prio)
+  {
+    ASSERT(prio == 0 || (prio > 0 && prio <= sched_get_priority_max(SCHED_FIFO)));
+    sched_param param;
+    param.sched_priority = prio;
+    VERIFY(!pthread_setschedparam(pthread_self(), prio == 0 ? SCHED_OTHER : SCHED_FIFO, &param));
+  }
+
+  /**
+   * macOS does not support pinning threads to cores.
+   * @param cores Ignored.
+   */
+  static void setCurrentAffinity(const std::vector<int>& cores) {}
+
+  /**
+   * macOS does not report the core a thread is running on.
+   * @return Always -1.
+   */
+  static int getCurrentCore() { return -1; }
+
   /**
     * Causes the calling thread to relinquish the CPU.
     */
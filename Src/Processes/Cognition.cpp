@@ -15,7 +15,7 @@ Cognition::Cognition()
     : INIT_SUPERTHREAD_DEBUGGING("cognition.cfg"), INIT_RECEIVER(MotionToCognition), INIT_SENDER(CognitionToMotion),
       moduleManager({ModuleBase::cognitionInfrastructure, ModuleBase::perception, ModuleBase::pathPlanning, ModuleBase::modeling, ModuleBase::behaviorControl}, this)
 {
-  theDebugSender.setSize(5200000, 100000);
+  initDebugSender(theDebugSender);
   theDebugReceiver.setSize(2800000);
   theCognitionToMotionSender.moduleManager = theMotionToCognitionReceiver.moduleManager = &moduleManager;
 
@@ -102,6 +102,7 @@ bool Cognition::main()
     BH_TRACE_MSG("after logger.execute");
 
     DEBUG_RESPONSE("timing") timingManager.getData().copyAllMessages(theDebugSender);
+    DEBUG_RESPONSE("timing:summary") timingManager.getSummary().copyAllMessages(theDebugSender);
 
     DEBUG_RESPONSE("annotation") annotationManager.getOut().copyAllMessages(theDebugSender);
     annotationManager.clear();
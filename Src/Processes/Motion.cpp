@@ -16,7 +16,7 @@ Motion::Motion()
       moduleManager({ModuleBase::motionInfrastructure, ModuleBase::motionControl, ModuleBase::sensing, ModuleBase::dortmundWalkingEngine}, this)
 {
   theDebugReceiver.setSize(1000000);
-  theDebugSender.setSize(5200000, 100000);
+  initDebugSender(theDebugSender);
 
   theMotionToCognitionSender.moduleManager = theCognitionToMotionReceiver.moduleManager = &moduleManager;
 
@@ -67,6 +67,10 @@ bool Motion::main()
       annotationManager.signalProcessStart();
 
       beforeRun();
+
+      DEBUG_RESPONSE_ONCE("threads:cognitionToMotion")
+        OUTPUT_TEXT("CognitionToMotion package " << theCognitionToMotionReceiver.getSequenceNumber() << (theCognitionToMotionReceiver.hasNewPackage() ? " (new)" : " (old)") << ", "
+                                                  << theCognitionToMotionReceiver.getMissedPackages() << " missed");
     }
 
     {
@@ -110,6 +114,7 @@ bool Motion::main()
     BH_TRACE_MSG("after logger.execute");
 
     DEBUG_RESPONSE("timing") timingManager.getData().copyAllMessages(theDebugSender);
+    DEBUG_RESPONSE("timing:summary") timingManager.getSummary().copyAllMessages(theDebugSender);
 
     DEBUG_RESPONSE("annotation") annotationManager.getOut().copyAllMessages(theDebugSender);
     annotationManager.clear();
@@ -0,0 +1,52 @@
+#include "BallInterceptTable.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+Vector2f BallInterceptTable::getBallPosition(float time) const
+{
+  if (ballPositions.empty())
+    return Vector2f::Zero();
+  const float index = std::max(time, 0.f) / timeStep;
+  const size_t i = static_cast<size_t>(index);
+  if (i + 1 >= ballPositions.size())
+    return ballPositions.back();
+  const float ratio = index - static_cast<float>(i);
+  return ballPositions[i] + (ballPositions[i + 1] - ballPositions[i]) * ratio;
+}
+
+float BallInterceptTable::getTimeToReach(const Pose2f& pose, const Vector2f& velocity, const Vector2f& target) const
+{
+  const Vector2f offset = target - pose.translation;
+  const float distance = std::max(offset.norm() - reachDistance, 0.f);
+  if (distance == 0.f)
+    return 0.f;
+  const Vector2f direction = offset.normalized();
+  const float turnTime = maxRotationSpeed > 0.f ? std::abs(Angle::normalize(offset.angle() - pose.rotation)) / maxRotationSpeed : 0.f;
+  const float speedTowardsTarget = std::clamp(velocity.dot(direction), 0.f, maxSpeed);
+  const float startTime = maxSpeed > 0.f ? accelerationTime * (1.f - speedTowardsTarget / maxSpeed) : 0.f;
+  return maxSpeed > 0.f ? turnTime + startTime + distance / maxSpeed : std::numeric_limits<float>::max();
+}
+
+int BallInterceptTable::getInterceptIndex(const Pose2f& pose, const Vector2f& velocity) const
+{
+  for (size_t i = 0; i < ballPositions.size(); ++i)
+    if (getTimeToReach(pose, velocity, ballPositions[i]) <= static_cast<float>(i) * timeStep)
+      return static_cast<int>(i);
+  return -1;
+}
+
+void BallInterceptTable::draw() const
+{
+  DECLARE_DEBUG_DRAWING("representation:BallInterceptTable", "drawingOnField");
+  if (!valid)
+    return;
+  for (size_t i = 0; i < ballPositions.size(); ++i)
+  {
+    const bool reached = i < robotTimes.size() && robotTimes[i] <= static_cast<float>(i) * timeStep;
+    CROSS("representation:BallInterceptTable", ballPositions[i].x(), ballPositions[i].y(), 20, 5, Drawings::solidPen, reached ? ColorRGBA::green : ColorRGBA::red);
+  }
+  if (interceptIndex >= 0)
+    CIRCLE("representation:BallInterceptTable", interceptPosition.x(), interceptPosition.y(), 60, 10, Drawings::solidPen, ColorRGBA::green, Drawings::noBrush, ColorRGBA::green);
+}
@@ -0,0 +1,60 @@
+/**
+* \file BallInterceptTable.h
+* The file declares a table of the ball positions on a fixed time grid together with
+* the times the robot needs to reach them. It is computed once per frame, so searching
+* for intercept positions does not require to propagate the ball again.
+*/
+
+#pragma once
+#include "Tools/Streams/AutoStreamable.h"
+#include "Tools/Math/Eigen.h"
+#include "Tools/Math/Pose2f.h"
+#include <vector>
+
+/**
+* \class BallInterceptTable
+* Sample i describes the ball i * timeStep seconds in the future.
+*/
+STREAMABLE(BallInterceptTable,
+  /**
+  * Interpolates the ball position between the samples.
+  * \param time The time from now in s. Times after the last sample return the last sample.
+  * \return The ball position in field coordinates (in mm).
+  */
+  Vector2f getBallPosition(float time) const;
+
+  /**
+  * Estimates the time a robot needs to walk to a position. The robot turns towards the
+  * position first and then walks straight. A robot that is already walking towards it
+  * needs less time to accelerate.
+  * \param pose The pose of the robot in field coordinates.
+  * \param velocity The current velocity of the robot in field coordinates (in mm/s).
+  * \param target The position in field coordinates.
+  * \return The time in s.
+  */
+  float getTimeToReach(const Pose2f& pose, const Vector2f& velocity, const Vector2f& target) const;
+
+  /**
+  * Searches for the first sample a robot reaches before the ball. The own robot
+  * is already contained in \c interceptIndex.
+  * \param pose The pose of the robot in field coordinates.
+  * \param velocity The current velocity of the robot in field coordinates (in mm/s).
+  * \return The index of the sample or -1 if the robot does not reach the ball in time.
+  */
+  int getInterceptIndex(const Pose2f& pose, const Vector2f& velocity) const;
+
+  void draw() const,
+
+  (bool)(false) valid, /**< Was the ball seen recently enough to fill the table? */
+  (float)(0.1f) timeStep, /**< The time between two samples (in s). */
+  (std::vector<Vector2f>) ballPositions, /**< The ball positions in field coordinates (in mm). */
+  (std::vector<Vector2f>) ballVelocities, /**< The ball velocities in field coordinates (in mm/s). */
+  (std::vector<float>) robotTimes, /**< The times the own robot needs to reach the ball positions (in s). */
+  (float)(0.f) maxSpeed, /**< The walking speed the reachable set is based on (in mm/s). */
+  (Angle)(0_deg) maxRotationSpeed, /**< The rotation speed the reachable set is based on (in rad/s). */
+  (float)(0.f) accelerationTime, /**< The time needed to accelerate from standing to maxSpeed (in s). */
+  (float)(0.f) reachDistance, /**< The distance to the ball at which it counts as reached (in mm). */
+  (int)(-1) interceptIndex, /**< The first sample the own robot reaches in time, -1 if there is none. */
+  (Vector2f)(Vector2f::Zero()) interceptPosition, /**< The ball position of that sample, the last sample if there is none. */
+  (float)(-1.f) interceptTime /**< The time of that sample (in s), -1 if there is none. */
+);
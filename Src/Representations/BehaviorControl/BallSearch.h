@@ -23,5 +23,13 @@ STREAMABLE(BallSearch,
   (std::vector<BallSearchPositions>) ballSearchPositions, // ordered in the same way as rolesInBallSearch!
 
   (Pose2f)(Pose2f()) nearestMarkPosition, // robot to pressure, if nothing else useful to do
-  (bool)(false) threatNear
+  (bool)(false) threatNear,
+
+  // probability grid of the ball position, row by row starting at gridOrigin
+  (Vector2f)(Vector2f::Zero()) gridOrigin, // center of the first cell in field coordinates
+  (float)(0.f) gridCellSize,
+  (int)(0) gridWidth, // number of cells along the x axis
+  (int)(0) gridHeight, // number of cells along the y axis
+  (std::vector<float>) gridProbabilities, // sum up to 1
+  (Vector2f)(Vector2f::Zero()) mostProbablePosition // center of the cell with the highest probability
 );
\ No newline at end of file
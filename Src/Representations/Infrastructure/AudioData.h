@@ -28,5 +28,6 @@ STREAMABLE(AudioData,,
   (std::string)("") api, /** Selected audio device API */
   (double)(0.0) latency, /** Chosen suggested stream latency */
   (bool)(false) isValid, /** set by AudioProviderDortmund to indicate the record state*/
+  (unsigned)(0) timestamp, /** The time when the first sample was recorded */
   (std::vector<float>) samples /**< Samples are interleaved. */
 );
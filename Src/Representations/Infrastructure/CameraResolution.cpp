@@ -0,0 +1,34 @@
+/**
+ * @file CameraResolution.cpp
+ *
+ * Implementation of the image sizes of the camera resolutions.
+ */
+
+#include "CameraResolution.h"
+#include "Platform/BHAssert.h"
+
+Vector2i CameraResolution::getSize(Resolutions resolution, bool upper)
+{
+  switch (resolution)
+  {
+  case upper640:
+    return upper ? Vector2i(640, 480) : Vector2i(320, 240);
+  case lower640:
+    return upper ? Vector2i(320, 240) : Vector2i(640, 480);
+  case both320:
+    return Vector2i(320, 240);
+  case both640:
+    return Vector2i(640, 480);
+  default:
+    ASSERT(false);
+    return Vector2i(320, 240);
+  }
+}
+
+CameraResolution::Resolutions CameraResolution::getResolution(int upperWidth, int lowerWidth)
+{
+  if (upperWidth == 640)
+    return lowerWidth == 640 ? both640 : upper640;
+  else
+    return lowerWidth == 640 ? lower640 : both320;
+}
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Tools/Enum.h"
+#include "Tools/Math/Eigen.h"
 #include "Tools/Streams/AutoStreamable.h"
 
 STREAMABLE(CameraResolution,
@@ -19,8 +20,36 @@ STREAMABLE(CameraResolution,
     both320,    /**< Both resolutions are set to 320. This is the default case when running on SimRobot. */
     both640,    /**< Both resolutions are set to 640. This option is only valide in the simulator. */
     noRequest  /**< Default Value for CameraResolutionRequest. This should never be used otherwise! */
-  ),
+  );
+
+  /**
+   * Returns the image size of a camera in a resolution.
+   * @param resolution The resolution. Must be neither defaultRes nor noRequest.
+   * @param upper The upper camera?
+   * @return The width and height of the image.
+   */
+  static Vector2i getSize(Resolutions resolution, bool upper);
+
+  /**
+   * Returns the resolution that consists of certain image sizes.
+   * @param upperWidth The width of the upper image, i.e. 320 or 640.
+   * @param lowerWidth The width of the lower image, i.e. 320 or 640.
+   * @return The resolution.
+   */
+  static Resolutions getResolution(int upperWidth, int lowerWidth),
 
   (Resolutions)(defaultRes) resolution, /**< the currently used resolutions */
-  (unsigned)(0) timestamp /** A timestamp for the last procesed CameraResolutionRequest */
+  (unsigned)(0) timestamp, /** A timestamp for the last procesed CameraResolutionRequest */
+  (float)(0.f) upperRegionTop /**< The rows dropped at the top of the upper image as a fraction of its height. */
+);
+
+/**
+ * The resolutions the perception should work on. The images are still captured
+ * in the resolutions of the config file. Only smaller ones can be requested,
+ * because they are computed from the captured images without restarting the cameras.
+ */
+STREAMABLE(CameraResolutionRequest,
+,
+  ((CameraResolution) Resolutions)(CameraResolution::noRequest) resolution, /**< The resolutions requested or noRequest to keep the captured ones. */
+  (float)(0.f) upperRegionTop /**< The rows to drop at the top of the upper image as a fraction of its height. At most half of them are dropped. */
 );
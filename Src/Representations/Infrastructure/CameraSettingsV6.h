@@ -143,3 +143,21 @@ struct CameraSettingsV6 : public Streamable
 };
 
 STREAMABLE_WITH_BASE(CameraSettingsUpperV6, CameraSettingsV6,);
+
+/**
+ * The exposure, gain and white balance the cameras should use instead of the ones
+ * of their own automatic controls. They are determined from the image statistics
+ * of the previous frame.
+ */
+STREAMABLE(CameraControlRequest,
+  STREAMABLE(Controls,,
+    (bool)(false) controlExposure, /**< Set exposure and gain and disable the auto exposure of the camera? */
+    (bool)(false) controlWhiteBalance, /**< Set the white balance and disable the auto white balance of the camera? */
+    (int)(0) exposure, /**< The exposure time (see CameraSettingsV6::Exposure). */
+    (int)(0) gain, /**< The gain (see CameraSettingsV6::Gain). */
+    (int)(0) whiteBalance /**< The white balance in Kelvin. */
+  );
+  ,
+  (Controls) lower, /**< The controls of the lower camera. */
+  (Controls) upper /**< The controls of the upper camera. */
+);
@@ -5,16 +5,86 @@
  */
 #include "Tools/SIMD.h"
 #include <cstring>
+#include <mutex>
 #include <numeric>
+#include <unordered_map>
+#include <vector>
 
 #include "Image.h"
 #include "Tools/ColorModelConversions.h"
+#include "Tools/ImageProcessing/ImageKernels.h"
 #include "Platform/BHAssert.h"
 
-Image::Image(bool initialize, int width, int height) : width(width), height(height), widthStep(width * 2)
+namespace
 {
-  // allocate full size image and keep it that way indepentent of resolution
-  image = new Pixel[maxResolutionWidth * maxResolutionHeight * 2];
+  /**
+   * The buffers of all images that own them. They are grouped into size classes
+   * of 64 KiB. Buffers released are kept for reuse up to a limit, so allocating
+   * the images of each frame does not reach the heap anymore.
+   */
+  class PixelPool
+  {
+    static constexpr size_t classSize = 16384; /**< The pixels per size class. */
+    static constexpr size_t maxFreePixels = 16 * 1024 * 1024; /**< At most 64 MiB are kept unused. */
+
+    std::mutex mutex;
+    std::unordered_map<size_t, std::vector<Image::Pixel*>> freeBuffers; /**< The buffers available per size class. */
+    size_t freePixels = 0;
+
+  public:
+    /** The pool is never destroyed, because images can still be released during static destruction. */
+    static PixelPool& get()
+    {
+      static PixelPool* pool = new PixelPool;
+      return *pool;
+    }
+
+    /**
+     * Takes a buffer from the pool or allocates it.
+     * @param pixels The number of pixels required. It is replaced by the size of the buffer.
+     * @return The buffer.
+     */
+    Image::Pixel* allocate(size_t& pixels)
+    {
+      pixels = std::max<size_t>((pixels + classSize - 1) / classSize, 1) * classSize;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto i = freeBuffers.find(pixels);
+        if (i != freeBuffers.end() && !i->second.empty())
+        {
+          Image::Pixel* buffer = i->second.back();
+          i->second.pop_back();
+          freePixels -= pixels;
+          return buffer;
+        }
+      }
+      return new Image::Pixel[pixels];
+    }
+
+    /**
+     * Returns a buffer to the pool.
+     * @param buffer The buffer.
+     * @param pixels Its size as returned by allocate.
+     */
+    void release(Image::Pixel* buffer, size_t pixels)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (freePixels + pixels <= maxFreePixels)
+        {
+          freeBuffers[pixels].push_back(buffer);
+          freePixels += pixels;
+          return;
+        }
+      }
+      delete[] buffer;
+    }
+  };
+}
+
+Image::Image(bool initialize, int width, int height) : width(width), height(height), widthStep(width * 2), image(nullptr)
+{
+  reserve(static_cast<size_t>(widthStep) * height);
   if (initialize)
     for (int y = 0; y < height; ++y)
       for (Pixel *p = (*this)[y], *pEnd = p + width; p < pEnd; ++p)
@@ -33,8 +103,8 @@ Image::Image(Image&& other) noexcept : isReference(true)
 
 Image::~Image()
 {
-  if (!isReference)
-    delete[] image;
+  if (!isReference && image)
+    PixelPool::get().release(image, allocated);
 }
 
 Image& Image::operator=(const Image& other)
@@ -47,10 +117,13 @@ Image& Image::operator=(const Image& other)
 
   if (isReference)
   {
-    // allocate full size image and keep it that way independent of resolution
-    image = new Pixel[maxResolutionHeight * maxResolutionWidth * 2];
+    image = nullptr;
+    allocated = 0;
     isReference = false;
+    sharedFrame.reset();
+    frame.reset();
   }
+  reserve(static_cast<size_t>(widthStep) * height);
 
   const int size = width * sizeof(Pixel);
   for (int y = 0; y < height; ++y)
@@ -67,13 +140,17 @@ Image& Image::operator=(Image&& other) noexcept
   timeStamp = other.timeStamp;
   imageSource = other.imageSource;
 
-  if (!isReference)
-    delete[] image;
+  if (!isReference && image)
+    PixelPool::get().release(image, allocated);
 
   isReference = other.isReference;
   image = other.image;
+  allocated = other.allocated;
+  sharedFrame = std::move(other.sharedFrame);
+  frame = std::move(other.frame);
   other.isReference = true;
   other.image = nullptr;
+  other.allocated = 0;
 
   return *this;
 }
@@ -145,10 +222,30 @@ void Image::setImage(Pixel* buffer)
 {
   if (!isReference)
   {
-    delete[] image;
+    if (image)
+      PixelPool::get().release(image, allocated);
+    allocated = 0;
     isReference = true;
   }
   image = buffer;
+  sharedFrame.reset();
+  frame.reset();
+}
+
+void Image::shareImage(const Image& other)
+{
+  std::shared_ptr<const void> otherFrame = other.frame ? other.frame : other.sharedFrame.lock();
+  if (!otherFrame)
+  {
+    *this = other;
+    return;
+  }
+
+  setImage(other.image);
+  frame = std::move(otherFrame);
+  setResolution(other.width, other.height);
+  timeStamp = other.timeStamp;
+  imageSource = other.imageSource;
 }
 
 void Image::setImageBySSECopy(const Image& other, bool halfResolution)
@@ -156,40 +253,23 @@ void Image::setImageBySSECopy(const Image& other, bool halfResolution)
   ASSERT(this->height == other.height);
   ASSERT(this->width == other.width);
 
-  Pixel* row = other.image;
-
-  for (int y = 0; y < height * 2; ++y)
-  {
-    for (int x = 0; x < width; x += 4)
-    {
-      __m128i load;
-      if (!halfResolution || y % 2 == 0)
-      {
-        load = _mm_loadu_si128(reinterpret_cast<__m128i*>(row + x));
-      }
-      else
-      {
-        load = _mm_setzero_si128();
-      }
-      _mm_storeu_si128(reinterpret_cast<__m128i*>(image + x + width * y), load);
-    }
-    row += width;
-  }
+  ImageKernels::copyRows(reinterpret_cast<const unsigned char*>(other.image), reinterpret_cast<unsigned char*>(image), width, height * 2, halfResolution);
 }
 
 void Image::convertFromYCbCrToRGB(const Image& ycbcrImage)
 {
   height = ycbcrImage.height;
   width = ycbcrImage.width;
+  reserve(static_cast<size_t>(widthStep) * height);
   for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width; ++x)
-      ColorModelConversions::fromYCbCrToRGB(ycbcrImage[y][x].y, ycbcrImage[y][x].cb, ycbcrImage[y][x].cr, (*this)[y][x].r, (*this)[y][x].g, (*this)[y][x].b);
+    ImageKernels::yCbCrToRGB(reinterpret_cast<const unsigned char*>(ycbcrImage[y]), reinterpret_cast<unsigned char*>((*this)[y]), width);
 }
 
 void Image::convertFromRGBToYCbCr(const Image& rgbImage)
 {
   height = rgbImage.height;
   width = rgbImage.width;
+  reserve(static_cast<size_t>(widthStep) * height);
   for (int y = 0; y < height; ++y)
     for (int x = 0; x < width; ++x)
       ColorModelConversions::fromRGBToYCbCr(rgbImage[y][x].r, rgbImage[y][x].g, rgbImage[y][x].b, (*this)[y][x].y, (*this)[y][x].cb, (*this)[y][x].cr);
@@ -199,15 +279,16 @@ void Image::convertFromYCbCrToHSI(const Image& ycbcrImage)
 {
   height = ycbcrImage.height;
   width = ycbcrImage.width;
+  reserve(static_cast<size_t>(widthStep) * height);
   for (int y = 0; y < height; ++y)
-    for (int x = 0; x < width; ++x)
-      ColorModelConversions::fromYCbCrToHSI(ycbcrImage[y][x].y, ycbcrImage[y][x].cb, ycbcrImage[y][x].cr, (*this)[y][x].h, (*this)[y][x].s, (*this)[y][x].i);
+    ImageKernels::yCbCrToHSI(reinterpret_cast<const unsigned char*>(ycbcrImage[y]), reinterpret_cast<unsigned char*>((*this)[y]), width);
 }
 
 void Image::convertFromHSIToYCbCr(const Image& hsiImage)
 {
   height = hsiImage.height;
   width = hsiImage.width;
+  reserve(static_cast<size_t>(widthStep) * height);
   for (int y = 0; y < height; ++y)
     for (int x = 0; x < width; ++x)
       ColorModelConversions::fromHSIToYCbCr(hsiImage[y][x].h, hsiImage[y][x].s, hsiImage[y][x].i, (*this)[y][x].y, (*this)[y][x].cb, (*this)[y][x].cr);
@@ -218,6 +299,23 @@ void Image::setResolution(int newWidth, int newHeight)
   width = newWidth;
   height = newHeight;
   widthStep = width * 2;
+  reserve(static_cast<size_t>(widthStep) * height);
+}
+
+void Image::reserve(size_t pixels)
+{
+  if (isReference || (image && pixels <= allocated))
+    return;
+
+  size_t size = pixels;
+  Pixel* buffer = PixelPool::get().allocate(size);
+  if (image)
+  {
+    std::memcpy(buffer, image, allocated * sizeof(Pixel));
+    PixelPool::get().release(image, allocated);
+  }
+  image = buffer;
+  allocated = size;
 }
 
 float Image::getColorDistance(const Image::Pixel& a, const Image::Pixel& b)
@@ -232,6 +330,19 @@ float Image::getColorDistance(const Image::Pixel& a, const Image::Pixel& b)
 }
 
 std::vector<int> Image::copyAndResizeRGBFloatNoHorizon(int sizeXNew, int sizeYNew, const int horizon_y, float* result) const
+{
+  static const std::array<float, 256> toFloat = []
+  {
+    std::array<float, 256> table;
+    for (int i = 0; i < 256; ++i)
+      table[i] = static_cast<float>(i) / 255.f;
+    return table;
+  }();
+  return copyAndResizeRGBNoHorizon(sizeXNew, sizeYNew, horizon_y, result, toFloat);
+}
+
+template<typename T>
+std::vector<int> Image::copyAndResizeRGBNoHorizon(int sizeXNew, int sizeYNew, const int horizon_y, T* result, const std::array<T, 256>& toOutput) const
 {
   const int rowStep = widthStep * 4;
   unsigned char* image_ptr = (unsigned char*)image;
@@ -280,9 +391,9 @@ std::vector<int> Image::copyAndResizeRGBFloatNoHorizon(int sizeXNew, int sizeYNe
       u = image_ptr[1];
       v = image_ptr[3];
       ColorModelConversions::fromYCbCrToRGB(y, u, v, r, g, b);
-      result[pixelNo++] = r / 255.f;
-      result[pixelNo++] = g / 255.f;
-      result[pixelNo++] = b / 255.f;
+      result[pixelNo++] = toOutput[r];
+      result[pixelNo++] = toOutput[g];
+      result[pixelNo++] = toOutput[b];
 
       int xInc = xIncs[xIndex];
       image_ptr += xInc * 4;
@@ -295,6 +406,10 @@ std::vector<int> Image::copyAndResizeRGBFloatNoHorizon(int sizeXNew, int sizeYNe
   return yIdxs;
 }
 
+template std::vector<int> Image::copyAndResizeRGBNoHorizon(int, int, int, float*, const std::array<float, 256>&) const;
+template std::vector<int> Image::copyAndResizeRGBNoHorizon(int, int, int, unsigned char*, const std::array<unsigned char, 256>&) const;
+template std::vector<int> Image::copyAndResizeRGBNoHorizon(int, int, int, signed char*, const std::array<signed char, 256>&) const;
+
 std::vector<int> Image::getIndices(const int inputSize, const int outputSize, const int inputPos)
 {
   std::vector<int> ret(outputSize);
@@ -326,7 +441,7 @@ void Image::serialize(In* in, Out* out)
       out->write((*this)[y], size);
   else
   {
-    widthStep = width * 2;
+    setResolution(width, height);
     for (int y = 0; y < height; ++y)
       in->read((*this)[y], size);
   }
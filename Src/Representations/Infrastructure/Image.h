@@ -10,6 +10,9 @@
 #include "Tools/Enum.h"
 #include "Tools/Math/Eigen.h"
 #include "Tools/ColorModelConversions.h"
+#include "Tools/ImageProcessing/ImageKernels.h"
+#include <array>
+#include <memory>
 #include <type_traits>
 
 // TODO: check this warning
@@ -85,8 +88,15 @@ public:
   bool isReference = false; /**< States whether this struct holds the image, or only a reference to an image stored elsewhere. */
   ImageSource imageSource = ImageSource::naoProviderV6;
   Pixel* image; /**< The image. Please note that the second half of each row must be ignored. */
+  size_t allocated = 0; /**< The number of pixels allocated if this image owns its buffer. */
+  std::weak_ptr<const void> sharedFrame; /**< The buffer referenced by this image if other images may share it (see shareImage). */
+  std::shared_ptr<const void> frame; /**< Keeps the buffer referenced by this image from being reused, e.g. by the camera driver. */
 
   /**
+   * Images that own their buffer only allocate what their resolution needs.
+   * The buffers are taken from a pool shared by all images, so images that are
+   * created or resized every frame reuse them. Copying an image copies its
+   * pixels; use shareImage to reference the buffer of another image instead.
    * @param initialize Whether to initialize the image in gray or not
    */
   Image(bool initialize = true, int width = maxResolutionWidth, int height = maxResolutionHeight);
@@ -135,6 +145,15 @@ public:
   void setImage(unsigned char* buffer);
   void setImage(Pixel* image);
 
+  /**
+   * The method references the buffer of another image instead of copying it if
+   * the buffer can be shared, i.e. if the other image has a sharedFrame or a frame.
+   * The buffer is not reused before this image references another one.
+   * Otherwise, the other image is copied.
+   * @param other The image that is shared.
+   */
+  void shareImage(const Image& other);
+
   /**
    * @brief Copies over an Image via SSE.
    * @param [in] other The image to be copied.
@@ -168,9 +187,18 @@ public:
 
   /**
    * Sets the new resolution of the image including the widthStep.
+   * An image that owns its buffer grows it if necessary.
    */
   void setResolution(int newWidth, int newHeight);
 
+  /**
+   * Makes sure that an image that owns its buffer can hold a number of pixels.
+   * If the buffer is replaced, its contents are kept. Images that only reference
+   * a buffer are not changed.
+   * @param pixels The number of pixels required.
+   */
+  void reserve(size_t pixels);
+
   /**
    * Calculates the distance between the first three bytes of two colors
    * @param a The first color
@@ -204,6 +232,20 @@ public:
   std::array<Vector2i, 3> projectIntoImage(const Vector2i& center, const Vector2i& size) const;
 
   std::vector<int> copyAndResizeRGBFloatNoHorizon(int sizeXNew, int sizeYNew, const int horizon_y, float* result) const;
+
+  /**
+   * Resizes the image below a row and converts it to RGB in a single pass. Every channel value
+   * is mapped through a table, so the result can be written directly in the format of a network
+   * input, e.g. as quantized values. It is instantiated for float, unsigned char and signed char.
+   * @param sizeXNew The width of the result.
+   * @param sizeYNew The height of the result.
+   * @param horizon_y The first row of the image that is used.
+   * @param result The result with 3 channels per pixel.
+   * @param toOutput The output value of each channel value.
+   * @return The rows of the image the rows of the result were taken from followed by the height.
+   */
+  template<typename T>
+  std::vector<int> copyAndResizeRGBNoHorizon(int sizeXNew, int sizeYNew, const int horizon_y, T* result, const std::array<T, 256>& toOutput) const;
   bool shouldBeProcessed() const;
 
   template <bool rgb = true, bool checkBounds = true, bool overwrite = checkBounds, typename T>
@@ -214,10 +256,46 @@ public:
     const std::vector<int> xIndices = getIndices(inputSize.x(), outputSize.x(), inputPos.x());
     const std::vector<int> yIndices = getIndices(inputSize.y(), outputSize.y(), inputPos.y());
 
+    // The range [first .. last[ of xIndices inside the image is converted by a vectorized kernel.
+    // The indices increase monotonically.
+    constexpr bool vectorized = rgb && (std::is_same_v<T, unsigned char> || std::is_same_v<T, float>);
+    const int outputWidth = static_cast<int>(xIndices.size());
+    int first = 0;
+    int last = outputWidth;
+    if constexpr (checkBounds)
+    {
+      while (first < last && xIndices[first] < 0)
+        ++first;
+      while (last > first && xIndices[last - 1] >= width)
+        --last;
+    }
+    const bool contiguous = last > first && xIndices[last - 1] - xIndices[first] == last - 1 - first;
+    std::vector<Pixel> gathered(vectorized && !contiguous ? last - first : 0);
+
     for (const int y : yIndices)
     {
-      for (const int x : xIndices)
+      for (int i = 0; i < outputWidth; ++i)
       {
+        if constexpr (vectorized)
+        {
+          if (i == first && first < last && (!checkBounds || (y >= 0 && y < height)))
+          {
+            const Pixel* row = (*this)[y];
+            const Pixel* src = row + xIndices[first];
+            if (!contiguous)
+            {
+              for (int j = first; j < last; ++j)
+                gathered[j - first] = row[xIndices[j]];
+              src = gathered.data();
+            }
+            ImageKernels::yCbCrToRGB24(reinterpret_cast<const unsigned char*>(src), result, last - first);
+            result += 3 * (last - first);
+            i = last - 1;
+            continue;
+          }
+        }
+
+        const int x = xIndices[i];
         if constexpr (checkBounds)
         {
           if (x < 0 || x >= width || y < 0 || y >= height)
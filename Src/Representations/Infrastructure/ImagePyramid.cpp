@@ -0,0 +1,74 @@
+/**
+ * @file ImagePyramid.cpp
+ *
+ * Implementation of struct ImagePyramid.
+ */
+
+#include "ImagePyramid.h"
+#include "Platform/BHAssert.h"
+#include "Tools/ImageProcessing/ImageKernels.h"
+
+void ImagePyramid::setImage(const Image& image)
+{
+  this->image = &image;
+  levels->imageValid.fill(false);
+  levels->grayImageValid.fill(false);
+}
+
+const Image& ImagePyramid::getImage(Level level) const
+{
+  ASSERT(image);
+  if (level == full)
+    return *image;
+
+  std::lock_guard<std::mutex> lock(levels->mutexes[level]);
+  std::unique_ptr<Image>& levelImage = levels->images[level];
+  if (!levels->imageValid[level])
+  {
+    if (!levelImage)
+      levelImage = std::make_unique<Image>(false);
+
+    const int scale = getScale(level);
+    levelImage->setResolution(image->width / scale, image->height / scale);
+    levelImage->timeStamp = image->timeStamp;
+    levelImage->imageSource = image->imageSource;
+    ImageKernels::shrinkYCbCr(reinterpret_cast<const unsigned char*>(image->image), levelImage->width * scale, levelImage->height * scale, image->widthStep,
+                              scale, reinterpret_cast<unsigned char*>(levelImage->image), levelImage->widthStep);
+    levels->imageValid[level] = true;
+  }
+  return *levelImage;
+}
+
+const ImagePyramid::GrayImage& ImagePyramid::getGrayImage(Level level) const
+{
+  ASSERT(image);
+  std::lock_guard<std::mutex> lock(levels->mutexes[level]);
+  GrayImage& grayImage = levels->grayImages[level];
+  if (!levels->grayImageValid[level])
+  {
+    const int scale = getScale(level);
+    grayImage.width = image->width / scale;
+    grayImage.height = image->height / scale;
+    grayImage.pixels.resize(grayImage.width * grayImage.height);
+    ImageKernels::shrinkGrayscale(reinterpret_cast<const unsigned char*>(image->image), grayImage.width * scale, grayImage.height * scale, image->widthStep,
+                                  scale, grayImage.pixels.data());
+    levels->grayImageValid[level] = true;
+  }
+  return grayImage;
+}
+
+ImagePyramid::Level ImagePyramid::getLevel(const Vector2i& inputSize, const Vector2i& outputSize)
+{
+  Level level = full;
+  while (level + 1 < numOfLevels
+         && inputSize.x() / getScale(static_cast<Level>(level + 1)) >= outputSize.x()
+         && inputSize.y() / getScale(static_cast<Level>(level + 1)) >= outputSize.y())
+    level = static_cast<Level>(level + 1);
+  return level;
+}
+
+void ImagePyramid::serialize(In* in, Out* out)
+{
+  STREAM_REGISTER_BEGIN;
+  STREAM_REGISTER_FINISH;
+}
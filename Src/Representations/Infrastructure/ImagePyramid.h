@@ -0,0 +1,110 @@
+/**
+ * @file ImagePyramid.h
+ *
+ * Declaration of struct ImagePyramid, which provides downscaled versions of
+ * the camera image. The levels are only computed when they are requested for
+ * the first time in a frame. Afterwards all modules share them.
+ */
+
+#pragma once
+
+#include "Image.h"
+#include "Tools/Streams/Streamable.h"
+#include "Tools/Enum.h"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct ImagePyramid : public Streamable
+{
+  ENUM(Level,
+    full,
+    half,
+    quarter,
+    eighth,
+    sixteenth
+  );
+
+  /** An image that only contains the y channel. */
+  struct GrayImage
+  {
+    int width = 0;
+    int height = 0;
+    std::vector<unsigned char> pixels; /**< The rows without any gaps. */
+
+    const unsigned char* operator[](const int y) const { return pixels.data() + y * width; }
+  };
+
+  /**
+   * Returns by how much a level is downscaled.
+   * @param level The level.
+   * @return The size of the blocks of pixels averaged in the level.
+   */
+  static int getScale(Level level) { return 1 << level; }
+
+  /**
+   * Sets the image the pyramid is computed from. All levels computed before
+   * become invalid.
+   * @param image The full resolution image. It must exist as long as the pyramid is used.
+   */
+  void setImage(const Image& image);
+
+  /**
+   * Returns a YCbCr level. It is computed if it was not requested before in this frame.
+   * The level images are only valid until the next call to setImage. Their y0 channel is not set.
+   * @param level The level.
+   * @return The image of the level. The full level is the image itself.
+   */
+  const Image& getImage(Level level) const;
+
+  /**
+   * Returns a gray level. It is computed if it was not requested before in this frame.
+   * @param level The level.
+   * @return The y channel of the level.
+   */
+  const GrayImage& getGrayImage(Level level) const;
+
+  /**
+   * Selects the smallest level that still has at least the resolution required
+   * to resample an area of the full image to a certain size.
+   * @param inputSize The size of the area in the full image.
+   * @param outputSize The size the area is resampled to.
+   * @return The level.
+   */
+  static Level getLevel(const Vector2i& inputSize, const Vector2i& outputSize);
+
+  /**
+   * Resamples an area of the full image using the level selected by getLevel.
+   * See Image::copyAndResizeArea for the parameters.
+   */
+  template <bool rgb = true, bool checkBounds = true, bool overwrite = checkBounds, typename T>
+  void copyAndResizeArea(const Vector2i inputPos, const Vector2i inputSize, const Vector2i outputSize, T* result) const
+  {
+    const Level level = getLevel(inputSize, outputSize);
+    const int scale = getScale(level);
+    const Vector2i levelPos(floorDiv(inputPos.x(), scale), floorDiv(inputPos.y(), scale));
+    const Vector2i levelEnd(floorDiv(inputPos.x() + inputSize.x(), scale), floorDiv(inputPos.y() + inputSize.y(), scale));
+    getImage(level).copyAndResizeArea<rgb, checkBounds, overwrite>(levelPos, levelEnd - levelPos, outputSize, result);
+  }
+
+private:
+  /** The data shared by all copies of a pyramid. */
+  struct Levels
+  {
+    std::array<std::mutex, numOfLevels> mutexes; /**< Only one thread computes a level. */
+    std::array<std::unique_ptr<Image>, numOfLevels> images; /**< The YCbCr levels, allocated when needed for the first time. */
+    std::array<GrayImage, numOfLevels> grayImages; /**< The gray levels. */
+    std::array<bool, numOfLevels> imageValid{}; /**< Were the YCbCr levels computed in this frame? */
+    std::array<bool, numOfLevels> grayImageValid{}; /**< Were the gray levels computed in this frame? */
+  };
+
+  const Image* image = nullptr; /**< The full resolution image. */
+  std::shared_ptr<Levels> levels = std::make_shared<Levels>();
+
+  static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+  void serialize(In* in, Out* out) override;
+};
+
+struct ImagePyramidUpper : public ImagePyramid {};
@@ -10,6 +10,36 @@
 #include "Tools/SSE.h"
 #include "Platform/SystemCall.h"
 #include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace
+{
+  /** TurboJPEG handles are expensive to create, so each thread keeps its own ones. */
+  tjhandle getCompressor()
+  {
+    thread_local std::unique_ptr<void, int (*)(tjhandle)> handle(tjInitCompress(), &tjDestroy);
+    return handle.get();
+  }
+
+  tjhandle getDecompressor()
+  {
+    thread_local std::unique_ptr<void, int (*)(tjhandle)> handle(tjInitDecompress(), &tjDestroy);
+    return handle.get();
+  }
+
+  /** The y, cb, and cr planes of the image that is currently converted by this thread. */
+  unsigned char* const* getPlanes(int width, int height)
+  {
+    thread_local std::vector<unsigned char> buffer;
+    thread_local std::array<unsigned char*, 3> planes;
+    const size_t planeSize = static_cast<size_t>(width) * height;
+    buffer.resize(planeSize * 3);
+    for (size_t i = 0; i < planes.size(); ++i)
+      planes[i] = buffer.data() + i * planeSize;
+    return planes.data();
+  }
+}
 
 JPEGImage::JPEGImage(const Image& image)
 {
@@ -26,50 +56,21 @@ void JPEGImage::fromImage(const Image& src, int quality)
 {
   setResolution(src.width, src.height);
   timeStamp = src.timeStamp;
-
-  jpeg_compress_struct cInfo;
-  jpeg_error_mgr jem;
-  cInfo.err = jpeg_std_error(&jem);
-  jpeg_create_compress(&cInfo);
-
-  if (!cInfo.dest)
-    cInfo.dest = (jpeg_destination_mgr*)(*cInfo.mem->alloc_small)((j_common_ptr)&cInfo, JPOOL_PERMANENT, sizeof(jpeg_destination_mgr));
-  cInfo.dest->init_destination = onDestIgnore;
-  cInfo.dest->empty_output_buffer = onDestEmpty;
-  cInfo.dest->term_destination = onDestIgnore;
-  cInfo.dest->next_output_byte = reinterpret_cast<JOCTET*>(image);
   ASSERT(!isReference);
-  cInfo.dest->free_in_buffer = maxResolutionWidth * maxResolutionHeight * 2 * sizeof(Pixel);
-
-  cInfo.image_width = width;
-  cInfo.image_height = height;
-  cInfo.input_components = 3;
-  cInfo.in_color_space = JCS_YCbCr;
-  cInfo.jpeg_color_space = JCS_YCbCr;
-
-  jpeg_set_defaults(&cInfo);
-
-  cInfo.raw_data_in = true;
 
-  // disable chroma subsampling
-  cInfo.comp_info[0].h_samp_factor = 1;
-  cInfo.comp_info[0].v_samp_factor = 1;
+  unsigned char* const* planes = getPlanes(width, height);
+  toPlanes(src, planes);
 
-  cInfo.dct_method = JDCT_FASTEST;
-  jpeg_set_quality(&cInfo, quality, true);
+  const int strides[3] = {width, width, width};
+  // The buffer of the image was only sized for the pixels, which may not be enough for small images.
+  reserve((tjBufSize(width, height, TJSAMP_444) + sizeof(Pixel) - 1) / sizeof(Pixel));
+  unsigned char* dest = reinterpret_cast<unsigned char*>(image);
+  unsigned long destSize = static_cast<unsigned long>(allocated * sizeof(Pixel));
 
-  jpeg_start_compress(&cInfo, true);
-
-  JPEGRawData data;
-  while (cInfo.next_scanline < cInfo.image_height)
-  {
-    toJPEGData(src, data.rows.data(), cInfo.next_scanline, data.y_plane.size());
-    jpeg_write_raw_data(&cInfo, data.rows.data(), static_cast<JDIMENSION>(data.y_plane.size()));
-  }
-
-  jpeg_finish_compress(&cInfo);
-  size = static_cast<unsigned>(cInfo.dest->next_output_byte - reinterpret_cast<JOCTET*>(image));
-  jpeg_destroy_compress(&cInfo);
+  // TJFLAG_NOREALLOC lets TurboJPEG write directly into the image buffer.
+  VERIFY(!tjCompressFromYUVPlanes(getCompressor(), const_cast<const unsigned char**>(planes), width, strides, height, TJSAMP_444, &dest, &destSize, quality,
+                                  TJFLAG_FASTDCT | TJFLAG_NOREALLOC));
+  size = static_cast<unsigned>(destSize);
 }
 
 void JPEGImage::toImage(Image& dest) const
@@ -78,6 +79,24 @@ void JPEGImage::toImage(Image& dest) const
   dest.timeStamp = timeStamp;
   dest.imageSource = ImageSource::jpegImage;
 
+  tjhandle decompressor = getDecompressor();
+  const unsigned char* src = reinterpret_cast<const unsigned char*>((*this)[0]);
+  int jpegWidth, jpegHeight, subsampling, colorspace;
+  if (!tjDecompressHeader3(decompressor, src, size, &jpegWidth, &jpegHeight, &subsampling, &colorspace) && colorspace == TJCS_YCbCr
+      && subsampling == TJSAMP_444) // new JPEG-compression
+  {
+    ASSERT(jpegWidth == width && jpegHeight == height);
+    unsigned char* const* planes = getPlanes(width, height);
+    int strides[3] = {width, width, width};
+    VERIFY(!tjDecompressToYUVPlanes(decompressor, src, size, const_cast<unsigned char**>(planes), width, strides, height, TJFLAG_FASTDCT));
+    fromPlanes(planes, dest);
+  }
+  else // old JPEG-compression
+    fromAiboJPEG(dest);
+}
+
+void JPEGImage::fromAiboJPEG(Image& dest) const
+{
   jpeg_decompress_struct cInfo;
   jpeg_error_mgr jem;
   cInfo.err = jpeg_std_error(&jem);
@@ -95,50 +114,24 @@ void JPEGImage::toImage(Image& dest) const
   cInfo.src->next_input_byte = (const JOCTET*)(*this)[0];
 
   jpeg_read_header(&cInfo, true);
-  if (cInfo.num_components == 3 && cInfo.jpeg_color_space == JCS_YCbCr) // new JPEG-compression
-  {
-    cInfo.raw_data_out = true;
-    jpeg_start_decompress(&cInfo);
-
-    JPEGRawData data;
-    while (cInfo.output_scanline < cInfo.image_height)
-    {
-      jpeg_read_raw_data(&cInfo, data.rows.data(), static_cast<JDIMENSION>(data.y_plane.size()));
-      fromJPEGData(data.rows.data(), dest, cInfo.output_scanline - data.y_plane.size(), data.y_plane.size());
-    }
-  }
-  else if (cInfo.num_components == 1 && cInfo.jpeg_color_space == JCS_GRAYSCALE) // old JPEG-compression
-  {
-    jpeg_start_decompress(&cInfo);
-    std::vector<unsigned char> aiboAlignedImage(width * height * 3);
-
-    // setup rows
-    while (cInfo.output_scanline < cInfo.output_height)
-    {
-      JSAMPROW rowPointer = &aiboAlignedImage[cInfo.output_scanline * cInfo.output_width];
-      jpeg_read_scanlines(&cInfo, &rowPointer, 1);
-    }
+  ASSERT(cInfo.num_components == 1 && cInfo.jpeg_color_space == JCS_GRAYSCALE);
+  jpeg_start_decompress(&cInfo);
+  std::vector<unsigned char> aiboAlignedImage(width * height * 3);
 
-    fromAiboAlignment(aiboAlignedImage.data(), reinterpret_cast<unsigned char*>(dest.image));
-  }
-  else
+  // setup rows
+  while (cInfo.output_scanline < cInfo.output_height)
   {
-    ASSERT(false);
+    JSAMPROW rowPointer = &aiboAlignedImage[cInfo.output_scanline * cInfo.output_width];
+    jpeg_read_scanlines(&cInfo, &rowPointer, 1);
   }
 
+  fromAiboAlignment(aiboAlignedImage.data(), reinterpret_cast<unsigned char*>(dest.image));
+
   // finish decompress
   jpeg_finish_decompress(&cInfo);
   jpeg_destroy_decompress(&cInfo);
 }
 
-boolean JPEGImage::onDestEmpty(j_compress_ptr)
-{
-  ASSERT(false);
-  return false;
-}
-
-void JPEGImage::onDestIgnore(j_compress_ptr) {}
-
 void JPEGImage::onSrcSkip(j_decompress_ptr, long) {}
 
 boolean JPEGImage::onSrcEmpty(j_decompress_ptr)
@@ -149,7 +142,7 @@ boolean JPEGImage::onSrcEmpty(j_decompress_ptr)
 
 void JPEGImage::onSrcIgnore(j_decompress_ptr) {}
 
-void JPEGImage::fromJPEGData(const JSAMPIMAGE src, Image& dst, size_t yOffset, size_t ySize)
+void JPEGImage::fromPlanes(const unsigned char* const* src, Image& dst)
 {
   ASSERT(dst.width % 16 == 0);
   ASSERT(reinterpret_cast<size_t>(dst.image) % 16 == 0);
@@ -161,18 +154,18 @@ void JPEGImage::fromJPEGData(const JSAMPIMAGE src, Image& dst, size_t yOffset, s
   __m128i mLowYCb, mHighYCb, mLowYCr, mHighYCr;
   __m128i p0, p1, p2, p3;
 
-  for (size_t y = 0; y < ySize; ++y)
+  for (int y = 0; y < dst.height; ++y)
   {
-    pDst = reinterpret_cast<__m128i*>(dst.image + (y + yOffset) * dst.widthStep);
-    pDstLineEnd = reinterpret_cast<__m128i*>(dst.image + (y + yOffset) * dst.widthStep + dst.width);
-    pSrcY = reinterpret_cast<__m128i*>(src[0][y]);
-    pSrcCb = reinterpret_cast<__m128i*>(src[1][y]);
-    pSrcCr = reinterpret_cast<__m128i*>(src[2][y]);
+    pDst = reinterpret_cast<__m128i*>(dst.image + y * dst.widthStep);
+    pDstLineEnd = reinterpret_cast<__m128i*>(dst.image + y * dst.widthStep + dst.width);
+    pSrcY = reinterpret_cast<const __m128i*>(src[0] + y * dst.width);
+    pSrcCb = reinterpret_cast<const __m128i*>(src[1] + y * dst.width);
+    pSrcCr = reinterpret_cast<const __m128i*>(src[2] + y * dst.width);
     for (; pDst < pDstLineEnd; pDst += 4, ++pSrcY, ++pSrcCb, ++pSrcCr)
     {
-      mY = _mm_load_si128(pSrcY);
-      mCb = _mm_load_si128(pSrcCb);
-      mCr = _mm_load_si128(pSrcCr);
+      mY = _mm_loadu_si128(pSrcY);
+      mCb = _mm_loadu_si128(pSrcCb);
+      mCr = _mm_loadu_si128(pSrcCr);
 
       mLowYCb = _mm_unpacklo_epi8(mY, mCb); // y1 cb1 y2 cb2 y3 cb3 y4 cb4 y5 cb5 y6 cb6 y7 cb7 y8 cb8
       mHighYCb = _mm_unpackhi_epi8(mY, mCb); // y9 cb9 y10 cb10 y11 cb11 y12 cb12 y13 cb13 y14 cb14 y15 cb15 y16 cb16
@@ -192,7 +185,7 @@ void JPEGImage::fromJPEGData(const JSAMPIMAGE src, Image& dst, size_t yOffset, s
   }
 }
 
-void JPEGImage::toJPEGData(const Image& src, JSAMPIMAGE dst, size_t yOffset, size_t ySize)
+void JPEGImage::toPlanes(const Image& src, unsigned char* const* dst)
 {
   ASSERT(src.width % 16 == 0);
   ASSERT(reinterpret_cast<size_t>(src.image) % 16 == 0);
@@ -223,13 +216,13 @@ void JPEGImage::toJPEGData(const Image& src, JSAMPIMAGE dst, size_t yOffset, siz
   __m128i mLowCbY, mHighCbY, mLowCr, mHighCr;
   __m128i mY, mCb, mCr;
 
-  for (size_t y = 0; y < ySize; ++y)
+  for (int y = 0; y < src.height; ++y)
   {
-    pSrc = reinterpret_cast<__m128i*>(src.image + (y + yOffset) * src.widthStep);
-    pSrcLineEnd = reinterpret_cast<__m128i*>(src.image + (y + yOffset) * src.widthStep + src.width);
-    pDstY = reinterpret_cast<__m128i*>(dst[0][y]);
-    pDstCb = reinterpret_cast<__m128i*>(dst[1][y]);
-    pDstCr = reinterpret_cast<__m128i*>(dst[2][y]);
+    pSrc = reinterpret_cast<__m128i*>(src.image + y * src.widthStep);
+    pSrcLineEnd = reinterpret_cast<__m128i*>(src.image + y * src.widthStep + src.width);
+    pDstY = reinterpret_cast<__m128i*>(dst[0] + y * src.width);
+    pDstCb = reinterpret_cast<__m128i*>(dst[1] + y * src.width);
+    pDstCr = reinterpret_cast<__m128i*>(dst[2] + y * src.width);
     for (; pSrc < pSrcLineEnd; pSrc += 4, ++pDstY, ++pDstCb, ++pDstCr)
     {
       p0 = _mm_load_si128(pSrc); // yPadd1 cb1 y1 cr1 yPadd2 cb2 y2 cr2 yPadd3 cb3 y3 cr3 yPadd4 cb4 y4 cr4
@@ -251,9 +244,9 @@ void JPEGImage::toJPEGData(const Image& src, JSAMPIMAGE dst, size_t yOffset, siz
       mCb = _mm_unpacklo_epi64(mLowCbY, mHighCbY);
       mCr = _mm_unpacklo_epi64(mLowCr, mHighCr);
 
-      _mm_store_si128(pDstY, mY);
-      _mm_store_si128(pDstCb, mCb);
-      _mm_store_si128(pDstCr, mCr);
+      _mm_storeu_si128(pDstY, mY);
+      _mm_storeu_si128(pDstCb, mCb);
+      _mm_storeu_si128(pDstCr, mCr);
     }
   }
 }
@@ -288,6 +281,7 @@ void JPEGImage::serialize(In* in, Out* out)
   if (in)
   {
     widthStep = 2 * width;
+    reserve((size + sizeof(Pixel) - 1) / sizeof(Pixel));
     in->read((*this)[0], size);
   }
   else
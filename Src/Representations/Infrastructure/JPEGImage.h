@@ -33,8 +33,13 @@ extern "C"
 
 #endif
 
+#include <turbojpeg.h>
+
 /**
  * Definition of a struct for JPEG-compressed images.
+ * Images are compressed with TurboJPEG from planar YCbCr without chroma
+ * subsampling, using the y1 channel of each pixel. The TurboJPEG handles are
+ * created once per thread and reused.
  */
 struct JPEGImage : public Image
 {
@@ -71,42 +76,13 @@ public:
   void toImage(Image& dest) const;
 
 private:
-  //!@name Handlers for JPEG-compression
+  //!@name Handlers for decompressing the old grayscale format with libjpeg
   //!@{
-  static boolean onDestEmpty(j_compress_ptr);
-  static void onDestIgnore(j_compress_ptr);
-
   static void onSrcSkip(j_decompress_ptr cInfo, long numBytes);
   static boolean onSrcEmpty(j_decompress_ptr);
   static void onSrcIgnore(j_decompress_ptr);
   //!@}
 
-  struct JPEGRawData
-  {
-    // since we are not using chroma subsampling, we can directly use DCTSIZE here
-    alignas(16) std::array<std::array<JSAMPLE, maxResolutionWidth>, DCTSIZE> y_plane;
-    alignas(16) std::array<std::array<JSAMPLE, maxResolutionWidth>, DCTSIZE> u_plane;
-    alignas(16) std::array<std::array<JSAMPLE, maxResolutionWidth>, DCTSIZE> v_plane;
-
-    std::array<JSAMPROW, DCTSIZE> y_rows;
-    std::array<JSAMPROW, DCTSIZE> u_rows;
-    std::array<JSAMPROW, DCTSIZE> v_rows;
-
-    std::array<JSAMPARRAY, 3> rows;
-
-    JPEGRawData()
-    {
-      for (size_t i = 0; i < y_rows.size(); ++i)
-        y_rows[i] = y_plane[i].data();
-      for (size_t i = 0; i < u_rows.size(); ++i)
-        u_rows[i] = u_plane[i].data();
-      for (size_t i = 0; i < v_rows.size(); ++i)
-        v_rows[i] = v_plane[i].data();
-
-      rows = {y_rows.data(), u_rows.data(), v_rows.data()};
-    }
-  };
-
   /**
    * Convert image from Aibo's alignment (one channel per line) to Nao's alignment (YUV422)
    * destination is asserted to be allocated
@@ -115,8 +91,22 @@ private:
    */
   void fromAiboAlignment(const unsigned char* src, unsigned char* dst) const;
 
-  static void toJPEGData(const Image& src, JSAMPIMAGE dst, size_t yOffset, size_t ySize);
-  static void fromJPEGData(const JSAMPIMAGE src, Image& dst, size_t yOffset, size_t ySize);
+  /**
+   * Splits an image into its y, cb, and cr planes.
+   * @param src The image.
+   * @param dst The planes. Their rows have the width of the image without any gaps.
+   */
+  static void toPlanes(const Image& src, unsigned char* const* dst);
+
+  /**
+   * Interleaves y, cb, and cr planes into an image.
+   * @param src The planes. Their rows have the width of the image without any gaps.
+   * @param dst The image. Its resolution is already set.
+   */
+  static void fromPlanes(const unsigned char* const* src, Image& dst);
+
+  /** Decompresses the old format, which consists of one grayscale plane per channel. */
+  void fromAiboJPEG(Image& dest) const;
 
   void serialize(In* in, Out* out);
 };
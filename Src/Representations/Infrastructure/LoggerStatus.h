@@ -0,0 +1,19 @@
+/**
+ * @file LoggerStatus.h
+ * Declaration of a struct that describes the state of the online logger.
+ * It is not provided by a module, but filled by the Logger after each frame.
+ */
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+
+STREAMABLE(LoggerStatus,,
+  (bool)(false) writing, /**< Is a log file being written? */
+  (unsigned)(0) loggedFrames, /**< The number of frames put into buffers. */
+  (unsigned)(0) droppedFrames, /**< The number of frames discarded, because no buffer was free. */
+  (unsigned)(0) droppedMessages, /**< The number of messages discarded, because a buffer was full. */
+  (unsigned)(0) pendingFrames, /**< The number of frames waiting to be compressed or written. */
+  (unsigned)(0) writtenKB, /**< The number of kilobytes written to the log file. */
+  (float)(1.f) compressionRatio /**< The uncompressed size divided by the compressed size of all blocks written. */
+);
@@ -0,0 +1,34 @@
+/**
+ * @file MotionTiming.h
+ * Declaration of a struct that describes how long the motion thread needs per frame,
+ * measured from waking up for new sensor data until the joint request is sent to LoLA.
+ * All values refer to the previous frame, because the current one is not finished yet.
+ */
+
+#pragma once
+
+#include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Streams/AutoStreamable.h"
+#include <array>
+#include <string>
+
+STREAMABLE(MotionTiming,
+  static constexpr unsigned binWidth = 1000; /**< The width of a bin of the histogram in µs. */
+  static constexpr size_t numOfBins = 16; /**< The last bin also contains all longer cycles. */
+
+  MotionTiming() { cycleTimeHistogram.fill(0); }
+
+  void draw() const
+  {
+    PLOT("representation:MotionTiming:cycleTime", cycleTime);
+  },
+
+  (unsigned)(0) cycleTime, /**< The time from waking up for new sensor data until the joint request was sent in µs. */
+  (unsigned)(0) maxCycleTime, /**< The longest cycle time measured so far in µs. */
+  (std::array<unsigned, numOfBins>) cycleTimeHistogram, /**< The number of frames per cycle time bin. */
+  (unsigned)(0) overruns, /**< The number of frames whose cycle time exceeded the budget. */
+  (unsigned)(0) missedFrames, /**< The number of LoLA frames no joint request was sent for. */
+  (std::string) slowestModule, /**< The module whose update took longest in the last frame that exceeded the budget. */
+  (std::string) slowestRepresentation, /**< The representation this update provided. */
+  (unsigned)(0) slowestModuleTime /**< The duration of this update in µs. */
+);
@@ -37,6 +37,12 @@ STREAMABLE_WITH_BASE(RobotHealth, MotionRobotHealth,
     Release
   );
 
+  /** The CPU usage of a thread. */
+  STREAMABLE(ThreadLoad,,
+    (std::string) name, /**< The name of the thread. */
+    (unsigned char)(0) cpuUsage /**< Percentage of a core used by the thread. */
+  );
+
   RobotHealth()
   {
     load[0] = load[1] = load[2] = 0;
@@ -87,6 +93,7 @@ STREAMABLE_WITH_BASE(RobotHealth, MotionRobotHealth,
   (unsigned)(0) linePercepts, /**< A line percept counter used to determine line percepts per hour */
   (unsigned)(0) goalPercepts, /**< A goal percept counter used to determine goal percepts per hour */
   (bool)(true) wlan, /**< Status of the wlan hardware. true: wlan hardware is ok. false: wlan hardware is (probably physically) broken. */
+  (std::vector<ThreadLoad>) threadLoads, /**< The CPU usage of the threads monitored. Threads that were not found are missing. */
   (Configuration)(Develop) configuration, /**< The configuration that was deployed. */
   (std::vector<std::string>) overlays /**< The activated config overlays. */
 );
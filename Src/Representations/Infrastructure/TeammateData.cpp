@@ -12,46 +12,90 @@
 #include "Representations/Infrastructure/TeamInfo.h"
 #include "Representations/Infrastructure/Time.h"
 
-TeamCommOutput Teammate::toTeamCommData() const
+namespace
 {
+  /**
+   * Calls a function with the member of a teammate that belongs to a field.
+   * @param teammate The teammate, either constant or not.
+   * @param field The field of the message.
+   * @param function The function that is called with the member.
+   */
+  template<typename T, typename F> void withField(T& teammate, Teammate::Field field, F&& function)
+  {
+    switch (field)
+    {
+    case Teammate::timeSynchronizationField:
+      function(teammate.timeSynchronization);
+      break;
+    case Teammate::robotPoseField:
+      function(teammate.robotPose);
+      break;
+    case Teammate::ballModelField:
+      function(teammate.ballModel);
+      break;
+    case Teammate::behaviorDataField:
+      function(teammate.behaviorData);
+      break;
+    case Teammate::teamCommEventsField:
+      function(teammate.teamCommEvents);
+      break;
+    case Teammate::whistleField:
+      function(teammate.whistle);
+      break;
+    case Teammate::speedInfoField:
+      function(teammate.speedInfo);
+      break;
+    case Teammate::localRobotMapField:
+      function(teammate.localRobotMap);
+      break;
+    default:
+      ASSERT(false);
+    }
+  }
+} // namespace
+
+TeamCommOutput Teammate::toTeamCommData(const std::vector<Field>& priorities) const
+{
+  static_assert(numOfFields <= 16, "The fields do not fit into the bit mask anymore.");
+
   TeamCommOutput tc;
 
   tc.data.resize(TeamCommOutput::maximumSize);
   OutCompressedBinaryMemory mem(tc.data.data());
 
-  bool full = false;
-  const auto stream = [&](const auto& data, const char* name)
+  mem << version << playerNumber << teamNumber << sendTimestamp << fallen;
+
+  // Select the fields in the order of their priority. A field that does not fit anymore
+  // does not prevent smaller ones with a lower priority from being sent.
+  unsigned short fields = 0;
+  size_t size = mem.getLength() + sizeof(fields);
+  const auto select = [&](Field field)
   {
-    if (full)
+    if (fields & (1 << field))
       return;
 
     OutCompressedBinarySize sizeStream;
-    sizeStream << data;
-    if (mem.getLength() + sizeStream.getSize() <= tc.data.size())
+    withField(*this, field, [&](const auto& data) { sizeStream << data; });
+    if (size + sizeStream.getSize() <= tc.data.size())
     {
-      mem << data;
+      fields |= static_cast<unsigned short>(1 << field);
+      size += sizeStream.getSize();
     }
     else
-    {
-      OUTPUT_WARNING("TeamCommOutput: Message too big, removed " << name);
-      full = true;
-    }
+      OUTPUT_WARNING("TeamCommOutput: Message too big, removed " << getName(field));
   };
 
-  stream(version, "version");
-  stream(playerNumber, "playerNumber");
-  stream(teamNumber, "teamNumber");
-  stream(sendTimestamp, "sendTimestamp");
-  stream(fallen, "fallen");
-  stream(timeSynchronization, "timeSynchronization");
-  stream(robotPose, "robotPose");
-  stream(ballModel, "ballModel");
-  stream(behaviorData, "behaviorData");
-  stream(teamCommEvents, "teamCommEvents");
-  stream(whistle, "whistle");
-  stream(speedInfo, "speedInfo");
-  stream(localRobotMap, "localRobotMap");
+  for (Field field : priorities)
+    select(field);
+  for (int field = 0; field < numOfFields; ++field)
+    select(static_cast<Field>(field));
 
+  mem << fields;
+  for (int field = 0; field < numOfFields; ++field)
+    if (fields & (1 << field))
+      withField(*this, static_cast<Field>(field), [&](const auto& data) { mem << data; });
+
+  ASSERT(mem.getLength() == size);
   tc.data.resize(mem.getLength());
   tc.sendThisFrame = true;
 
@@ -76,14 +120,13 @@ bool TeammateReceived::fromTeamCommData(const TeamCommDataReceived& teamCommData
   stream(teamNumber);
   stream(sendTimestamp);
   stream(fallen);
-  stream(timeSynchronization);
-  stream(robotPose);
-  stream(ballModel);
-  stream(behaviorData);
-  stream(teamCommEvents);
-  stream(whistle);
-  stream(speedInfo);
-  stream(localRobotMap);
+
+  // Fields missing in the message keep their default values.
+  unsigned short fields = 0;
+  stream(fields);
+  for (int field = 0; field < numOfFields; ++field)
+    if (fields & (1 << field))
+      withField(*this, static_cast<Field>(field), stream);
 
   if (!mem.getEof())
     OUTPUT_WARNING("TeamCommDataReceived: There is more data available than needed");
@@ -25,7 +25,7 @@
 
 STREAMABLE(Teammate,
   // Increase version number whenever something changes!
-  static constexpr unsigned char thisVersion = 0;
+  static constexpr unsigned char thisVersion = 1;
 
   // Sum version numbers of all streamables
   static constexpr unsigned char totalVersion = thisVersion
@@ -38,7 +38,28 @@ STREAMABLE(Teammate,
     + SpeedInfoCompressed::version
     + RobotMapCompressed::version;
 
-  TeamCommOutput toTeamCommData() const;
+  /**
+   * The parts of the message after the header. Each of them is only sent if it still fits
+   * into the message. A bit mask in the message tells the receiver which ones are present.
+   */
+  ENUM(Field,
+    timeSynchronizationField,
+    robotPoseField,
+    ballModelField,
+    behaviorDataField,
+    teamCommEventsField,
+    whistleField,
+    speedInfoField,
+    localRobotMapField
+  );
+
+  /**
+   * Packs this teammate into a message.
+   * @param priorities The fields that are added first if the message cannot contain all of them.
+   *                   The remaining fields follow in the order of their declaration. The fields
+   *                   are always streamed in this order, independent of their priority.
+   */
+  TeamCommOutput toTeamCommData(const std::vector<Field>& priorities = {}) const;
 
   ,
   (unsigned char)(totalVersion) version,
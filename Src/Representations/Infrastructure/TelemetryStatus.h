@@ -0,0 +1,14 @@
+/**
+ * @file TelemetryStatus.h
+ * This representation contains the state of the telemetry stream to monitoring PCs.
+ */
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+
+STREAMABLE(TelemetryStatus,,
+  (bool)(false) active, /**< Is the stream currently sent? */
+  (unsigned)(0) packetsSent, /**< The number of packets sent so far. */
+  (unsigned)(0) lastSendTimestamp /**< The time when the last packet was sent. */
+);
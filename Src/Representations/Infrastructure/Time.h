@@ -17,8 +17,8 @@ STREAMABLE(TimeOffsets,
   }
   void convertRemoteTimeInLocalTime(unsigned& timestamp, int playerNum) const
   ,
-  (std::array<int, MAX_NUM_PLAYERS>)({0}) bestRTT,
-  (std::array<int, MAX_NUM_PLAYERS>)({0}) bestOffset
+  (std::array<int, MAX_NUM_PLAYERS>)({0}) bestRTT, /**< The error of the offset per player in ms, i.e. twice the standard deviation of its estimate. */
+  (std::array<int, MAX_NUM_PLAYERS>)({0}) bestOffset /**< The remote time minus the local time per player in ms. */
 );
 
 STREAMABLE(TimeSynchronization,
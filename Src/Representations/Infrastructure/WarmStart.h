@@ -0,0 +1,23 @@
+/**
+ * @file WarmStart.h
+ *
+ * The state of the filters of the last run of the framework, if it was restarted recently.
+ */
+
+#pragma once
+
+#include "Representations/Modeling/RobotPoseHypotheses.h"
+#include "Representations/Perception/FieldColor.h"
+#include "Tools/Streams/AutoStreamable.h"
+
+/**
+ * The filters initialize their state from this representation in their first frame if it
+ * was restored. It does not change afterwards.
+ */
+STREAMABLE(WarmStart,,
+  (bool)(false) restored, /**< Was a recent snapshot of the last run found? Otherwise, all other fields are meaningless. */
+  (unsigned)(0) age, /**< How old was the snapshot when it was restored in s? */
+  (RobotPoseHypotheses) robotPoseHypotheses, /**< The hypotheses of the self-localization. */
+  (FieldColors) fieldColors, /**< The field color of the lower camera. */
+  (FieldColors) fieldColorsUpper /**< The field color of the upper camera. */
+);
@@ -40,9 +40,16 @@ STREAMABLE(DangerMap,
     {
       danger[i] = other.danger[i];
     }
+    timeWhenChanged = other.timeWhenChanged;
     return *this;
   }
 
+  /** @return Has any cell changed after the given time, i.e. must consumers update what they derived from the map? */
+  bool changedSince(unsigned time) const
+  {
+    return timeWhenChanged > time;
+  }
+
   /** @return Maximum danger in selected zone (square defined by distance parameter) */
   inline float getDangerAt(const Vector2f &posOnField, const FieldDimensions &fieldDimensions, const float &distance) const
   {
@@ -80,5 +87,6 @@ STREAMABLE(DangerMap,
       (float)((cellNo%numOfCellsY)*stepSize - fieldDimensions.yPosLeftSideline + stepSize / 2));
   }
   ,
-  (float[numOfCells]) danger /**< indicating possible pressure of opponent on area [0..1] */
+  (float[numOfCells]) danger, /**< indicating possible pressure of opponent on area [0..1] */
+  (unsigned)(0) timeWhenChanged /**< The frame time of the last update that changed any cell. */
 );
@@ -0,0 +1,63 @@
+/**
+ * @file FieldLinesDistanceMap.h
+ * Declaration of a grid that contains the distance of each cell to the closest field line.
+ * Field lines are all lines of FieldDimensions::fieldLines, i.e. also the center circle and the
+ * penalty marks. The grid covers the field including its border. So the likelihood of a point
+ * observed on a field line can be determined with a single lookup instead of the distances to
+ * all field lines.
+ */
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+#include "Tools/Math/Eigen.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+STREAMABLE(FieldLinesDistanceMap,
+  /** The content of a cell. */
+  struct Cell
+  {
+    float distance; /**< The distance of the center of the cell to the closest field line in mm. */
+    Vector2f gradient; /**< The gradient of the distance, i.e. the unit vector pointing away from the closest field line. */
+  };
+
+  std::vector<Cell> cells; /**< The cells, row after row, i.e. the x index changes fastest. It is not streamed. */
+
+  /** @return Does the grid contain any cells? It does not in representations that were streamed. */
+  bool isValid() const { return !cells.empty(); }
+
+  /**
+   * Returns the cell that contains a point. Points outside the grid are moved to its border.
+   * @param pointOnField The point in field coordinates.
+   * @return The cell. The grid must be valid.
+   */
+  const Cell& getCell(const Vector2f& pointOnField) const
+  {
+    const int x = std::clamp(static_cast<int>((pointOnField.x() - origin.x()) / cellSize), 0, cellsX - 1);
+    const int y = std::clamp(static_cast<int>((pointOnField.y() - origin.y()) / cellSize), 0, cellsY - 1);
+    return cells[y * cellsX + x];
+  }
+
+  /**
+   * Returns the distance of a point to the closest field line with the resolution of the grid.
+   * For points outside the grid, their distance to the grid is added.
+   * @param pointOnField The point in field coordinates.
+   * @return The distance in mm. It is infinite if the grid is not valid.
+   */
+  float getDistance(const Vector2f& pointOnField) const
+  {
+    if (!isValid())
+      return std::numeric_limits<float>::infinity();
+    const Vector2f clipped(std::clamp(pointOnField.x(), origin.x(), origin.x() + cellsX * cellSize),
+                           std::clamp(pointOnField.y(), origin.y(), origin.y() + cellsY * cellSize));
+    return getCell(clipped).distance + (pointOnField - clipped).norm();
+  }
+  ,
+  (float)(0.f) cellSize, /**< The edge length of a cell in mm. */
+  (Vector2f)(Vector2f::Zero()) origin, /**< The corner of the first cell in field coordinates. */
+  (int)(0) cellsX, /**< The number of cells in x direction. */
+  (int)(0) cellsY, /**< The number of cells in y direction. */
+  (unsigned)(0) fieldDimensionsUpdate /**< The time when the field dimensions the grid was built from were loaded. */
+);
@@ -36,5 +36,7 @@ STREAMABLE(HeatMapCollection,
   (HeatMap) teamKickHeatMap,
   (HeatMap) teamGoalKickHeatMap,
   (HeatMap) opponentKickHeatMap,
-  (HeatMap) opponentGoalKickHeatMap
+  (HeatMap) opponentGoalKickHeatMap,
+  (unsigned)(0) version, /**< The number of the computation the heat maps result from. */
+  (unsigned)(0) timestamp /**< The time of the frame the heat maps were computed for. */
 );
@@ -0,0 +1,41 @@
+/**
+ * @file RelocalizationHypotheses.h
+ * Declaration of a representation that contains the poses a global localization
+ * found plausible in the current frame. The SelfLocator2017 adds them as new
+ * hypotheses. So the robot can be found again after it was moved without
+ * waiting for a landmark.
+ */
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+#include "Tools/Math/Pose2f.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include <vector>
+
+STREAMABLE(RelocalizationHypotheses,
+  STREAMABLE(Hypothesis,,
+    (Pose2f) pose, /**< The pose in field coordinates. */
+    (float)(0.f) weight /**< The share of the probability mass that supports the pose [0..1]. */
+  );
+
+  /** Draws the hypotheses. */
+  void draw() const
+  {
+    DEBUG_DRAWING("representation:RelocalizationHypotheses", "drawingOnField")
+    {
+      for (const Hypothesis& hypothesis : hypotheses)
+      {
+        const Vector2f tip = hypothesis.pose * Vector2f(300.f, 0.f);
+        const unsigned char alpha = static_cast<unsigned char>(55.f + 200.f * hypothesis.weight);
+        CIRCLE("representation:RelocalizationHypotheses", hypothesis.pose.translation.x(), hypothesis.pose.translation.y(), 150, 20,
+               Drawings::solidPen, ColorRGBA(255, 128, 0, alpha), Drawings::noBrush, ColorRGBA());
+        ARROW("representation:RelocalizationHypotheses", hypothesis.pose.translation.x(), hypothesis.pose.translation.y(), tip.x(), tip.y(),
+              20, Drawings::solidPen, ColorRGBA(255, 128, 0, alpha));
+      }
+    }
+  }
+  ,
+  (std::vector<Hypothesis>) hypotheses, /**< The hypotheses, the most likely first. */
+  (unsigned)(0) timestamp /**< The time of the frame of the percepts the hypotheses are based on. */
+);
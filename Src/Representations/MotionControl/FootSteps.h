@@ -6,8 +6,8 @@
 #define _FOOTSTEPS_H
 
 #include "Modules/MotionControl/DortmundWalkingEngine/StepData.h"
-#include <vector>
 #include "Platform/BHAssert.h"
+#include "Tools/RingBuffer.h"
 
 #ifndef WALKING_SIMULATOR
 #include "Tools/Streams/AutoStreamable.h"
@@ -52,34 +52,45 @@ STREAMABLE(FootSteps,
     return steps.empty();
   }
 
-	void addStep(Footposition newstep)
+	void addStep(const Footposition& newstep)
 	{
-		steps.push_back(newstep);
+    ASSERT(!steps.full());
+		steps.push_front(newstep);
 	}
 
-	Footposition getStep(unsigned int i) const
+  /** Returns a step. The step 0 is executed next, the step getNumOfSteps() - 1 was added last. */
+	const Footposition& getStep(unsigned int i) const
 	{
-    ASSERT(!steps.empty());
-		return steps[i];
+    ASSERT(i < steps.size());
+		return steps[steps.size() - 1 - i];
 	}
 
+  Footposition& getStep(unsigned int i)
+  {
+    ASSERT(i < steps.size());
+    return steps[steps.size() - 1 - i];
+  }
+
+  /** Removes the step that was added last. */
   void popStep()
   {
-    steps.pop_back();
+    steps.pop_front();
   }
 
+  /** Removes the step that is executed next. */
   void popFront()
   {
-    steps.erase(steps.begin());
+    steps.pop_back();
   }
 
 	/** 
 	 *	Buffer for target foot steps. There might be more than one step
 	 *	per frame to fill the preview buffer needed by the preview controller
-	 *	ZMP/IP-Controller 
+	 *	ZMP/IP-Controller. A new step is pushed to the front of the ring buffer and
+	 *	the executed one is removed from its back, so that neither moves the others.
+	 *	Use getStep() to access them in the order of their execution.
 	 */
-
-	std::vector<Footposition> steps{ MAX_STEPS };
+	RingBuffer<Footposition> steps{MAX_STEPS};
 	,
 
 	/** Is the controller running? */
@@ -10,6 +10,7 @@
 #include "Tools/Debugging/DebugDrawings3D.h"
 #include "Tools/Module/Blackboard.h"
 #include "Representations/Infrastructure/CameraInfo.h"
+#include <algorithm>
 
 BodyContour::Line::Line(const Vector2i& p1, const Vector2i& p2) : p1(p1.x() < p2.x() ? p1 : p2), p2(p1.x() < p2.x() ? p2 : p1) {}
 
@@ -32,6 +33,25 @@ void BodyContour::clipBottom(int x, int& y, int imageHeight) const
     y = imageHeight - 1;
 }
 
+void BodyContour::updateColumnBottoms(int imageWidth, int imageHeight)
+{
+  columnBottoms.assign(imageWidth, imageHeight);
+  columnBottomsHeight = imageHeight;
+
+  // each line only clips the columns it spans (see Line::yAt)
+  for (const Line& line : lines)
+  {
+    const int xMin = std::max(line.p1.x(), 0);
+    const int xMax = std::min(line.p2.x(), imageWidth);
+    for (int x = xMin; x < xMax; ++x)
+    {
+      const int y = line.p1.y() + (line.p2.y() - line.p1.y()) * (x - line.p1.x()) / (line.p2.x() - line.p1.x());
+      if (y < columnBottoms[x])
+        columnBottoms[x] = y;
+    }
+  }
+}
+
 void BodyContour::clipLeft(int& x, int y) const
 {
   int xIntersection;
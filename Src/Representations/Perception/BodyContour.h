@@ -74,6 +74,35 @@ STREAMABLE(BodyContour,
     lines.reserve(50);
   }
 
+  /** A contour read from a stream has no table of column bottoms. */
+  void onRead() { columnBottoms.clear(); }
+
+  /**
+   * The method computes the table of the clipped bottoms of all columns, so
+   * that bottomAt() does not have to intersect all lines. It must be called
+   * again whenever the lines change.
+   * @param imageWidth The width of the image.
+   * @param imageHeight The height of the image, i.e. the bottom of a column that is not clipped.
+   */
+  void updateColumnBottoms(int imageWidth, int imageHeight);
+
+  /**
+   * The method returns the y coordinate at which a vertical line starting at the
+   * bottom of the image is clipped. It uses the table of column bottoms if it
+   * exists and fits the image and clipBottom() otherwise.
+   * @param x The x coordinate of the vertical line.
+   * @param imageHeight The height of the image.
+   * @return The clipped y coordinate. It can be outside the image.
+   */
+  int bottomAt(int x, int imageHeight) const
+  {
+    if(columnBottomsHeight == imageHeight && static_cast<unsigned>(x) < columnBottoms.size())
+      return columnBottoms[x];
+    int y = imageHeight;
+    clipBottom(x, y);
+    return y;
+  }
+
   /**
    * The method clips the bottom y coordinate of a vertical line.
    * @param x The x coordinate of the vertical line.
@@ -126,7 +155,10 @@ STREAMABLE(BodyContour,
   bool isValidPoint(const Vector2i& point) const;
 
   /** Creates drawings of the contour. */
-  void draw() const,
+  void draw() const;
+
+  std::vector<int> columnBottoms; /**< The result of clipBottom() per column, starting at columnBottomsHeight. Not streamed. */
+  int columnBottomsHeight = 0; /**< The image height the table of column bottoms was computed for. */,
 
   (std::vector<Line>) lines /**< The clipping lines. */
 );
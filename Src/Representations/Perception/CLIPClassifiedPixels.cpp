@@ -0,0 +1,99 @@
+/**
+ * @file CLIPClassifiedPixels.cpp
+ *
+ * Implementation of struct CLIPClassifiedPixels.
+ */
+
+#include "CLIPClassifiedPixels.h"
+#include "Platform/BHAssert.h"
+#include "Tools/ImageProcessing/ImageKernels.h"
+#include <algorithm>
+#include <cstddef>
+
+void CLIPClassifiedPixels::getFieldColorRange(const FieldColors::FieldColor& fieldColor, std::array<unsigned char, 4>& lower, std::array<unsigned char, 4>& upper)
+{
+  const auto setRange = [&](size_t channel, int center, int maxDistance)
+  {
+    lower[channel] = static_cast<unsigned char>(std::min(std::max(center - maxDistance + 1, 0), 255));
+    upper[channel] = static_cast<unsigned char>(std::min(std::max(center + maxDistance - 1, 0), 255));
+  };
+  setRange(offsetof(Image::Pixel, yCbCrPadding), 128, 129);
+  setRange(offsetof(Image::Pixel, y), fieldColor.fieldColorOptY, 65);
+  setRange(offsetof(Image::Pixel, cb), fieldColor.fieldColorOptCb, fieldColor.fieldColorMaxDistCb);
+  setRange(offsetof(Image::Pixel, cr), fieldColor.fieldColorOptCr, fieldColor.fieldColorMaxDistCr);
+}
+
+void CLIPClassifiedPixels::setImage(const Image& image, const FieldColors& fieldColors)
+{
+  this->image = &image;
+  getFieldColorRange(fieldColors.fieldColorArray[0], fieldColorLower, fieldColorUpper);
+  minWhiteY = fieldColors.fieldColorArray[0].fieldColorOptY + fieldColors.fieldColorArray[0].lineToFieldColorYThreshold + 1;
+  wordsPerRow = (image.width + 63) / 64;
+
+  std::lock_guard<std::mutex> lock(planes->mutex);
+  planes->field.resize(wordsPerRow * image.height);
+  planes->white.resize(wordsPerRow * image.height);
+  planes->rowValid.assign(image.height, false);
+}
+
+CLIPClassifiedPixels::PixelClass CLIPClassifiedPixels::getClass(int x, int y) const
+{
+  ASSERT(image);
+  ASSERT(x >= 0 && x < image->width && y >= 0 && y < image->height);
+  std::lock_guard<std::mutex> lock(planes->mutex);
+  classifyRow(y);
+  return isSet(planes->field, x, y) ? field : isSet(planes->white, x, y) ? white : unknown;
+}
+
+int CLIPClassifiedPixels::sample(const Vector2f& start, const Vector2f& step, int maxSteps, int border, int& fieldCount, int& whiteCount) const
+{
+  ASSERT(image);
+  fieldCount = 0;
+  whiteCount = 0;
+  int steps = 0;
+  Vector2f checkPoint(start);
+  std::lock_guard<std::mutex> lock(planes->mutex);
+  while (steps < maxSteps && !image->isOutOfImage(checkPoint.x(), checkPoint.y(), border))
+  {
+    const int x = static_cast<int>(checkPoint.x());
+    const int y = static_cast<int>(checkPoint.y());
+    classifyRow(y);
+    if (isSet(planes->field, x, y))
+      fieldCount++;
+    else if (isSet(planes->white, x, y))
+      whiteCount++;
+    steps++;
+    checkPoint += step;
+  }
+  return steps;
+}
+
+void CLIPClassifiedPixels::classifyRow(int y) const
+{
+  if (planes->rowValid[y])
+    return;
+
+  const Image::Pixel* row = (*image)[y];
+  planes->mask.resize(image->width);
+  ImageKernels::classifyRange(reinterpret_cast<const unsigned char*>(row), image->width, fieldColorLower.data(), fieldColorUpper.data(), planes->mask.data());
+
+  uint64_t* fieldWords = planes->field.data() + y * wordsPerRow;
+  uint64_t* whiteWords = planes->white.data() + y * wordsPerRow;
+  std::fill(fieldWords, fieldWords + wordsPerRow, 0);
+  std::fill(whiteWords, whiteWords + wordsPerRow, 0);
+  for (int x = 0; x < image->width; x++)
+  {
+    const uint64_t bit = uint64_t(1) << (x & 63);
+    if (planes->mask[x])
+      fieldWords[x >> 6] |= bit;
+    else if (row[x].y >= minWhiteY)
+      whiteWords[x >> 6] |= bit;
+  }
+  planes->rowValid[y] = true;
+}
+
+void CLIPClassifiedPixels::serialize(In* in, Out* out)
+{
+  STREAM_REGISTER_BEGIN;
+  STREAM_REGISTER_FINISH;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file CLIPClassifiedPixels.h
+ *
+ * Declaration of struct CLIPClassifiedPixels, which classifies the pixels of
+ * the camera image as field color, white, or unknown. The classification is
+ * stored in bitplanes at image resolution and is computed row by row when a
+ * row is queried for the first time in a frame. Afterwards all modules share it.
+ */
+
+#pragma once
+
+#include "Representations/Infrastructure/Image.h"
+#include "Representations/Perception/FieldColor.h"
+#include "Tools/Math/Eigen.h"
+#include "Tools/Streams/Streamable.h"
+#include "Tools/Enum.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct CLIPClassifiedPixels : public Streamable
+{
+  ENUM(PixelClass,
+    field, /**< FieldColors::isPixelFieldColor. */
+    white, /**< No field color, but brighter than the field color by FieldColor::lineToFieldColorYThreshold. */
+    unknown
+  );
+
+  /**
+   * Computes the range of each byte of an Image::Pixel that has field color, i.e. for
+   * which FieldColors::isPixelFieldColor is true, as used by ImageKernels::classifyRange.
+   * @param fieldColor The field color.
+   * @param lower The smallest value of each byte.
+   * @param upper The largest value of each byte.
+   */
+  static void getFieldColorRange(const FieldColors::FieldColor& fieldColor, std::array<unsigned char, 4>& lower, std::array<unsigned char, 4>& upper);
+
+  /**
+   * Sets the image that is classified. All rows classified before become invalid.
+   * @param image The image. It must exist as long as the classification is used.
+   * @param fieldColors The field color of the image. Only fieldColorArray[0] is used.
+   */
+  void setImage(const Image& image, const FieldColors& fieldColors);
+
+  /**
+   * Returns the class of a pixel.
+   * @param x The x coordinate of the pixel. It must be inside the image.
+   * @param y The y coordinate of the pixel. It must be inside the image.
+   * @return The class.
+   */
+  PixelClass getClass(int x, int y) const;
+
+  /**
+   * Samples the pixels along a segment with a constant step, the same way the
+   * verifications of CLIPLineFinder did on the image.
+   * @param start The first pixel sampled.
+   * @param step The offset between two pixels sampled.
+   * @param maxSteps The maximum number of pixels sampled.
+   * @param border The sampling stops before the first pixel this close to the image border (see Image::isOutOfImage).
+   * @param fieldCount Is set to the number of pixels sampled that have field color.
+   * @param whiteCount Is set to the number of pixels sampled that are white.
+   * @return The number of pixels sampled.
+   */
+  int sample(const Vector2f& start, const Vector2f& step, int maxSteps, int border, int& fieldCount, int& whiteCount) const;
+
+private:
+  /** The data shared by all copies of the classification. */
+  struct Planes
+  {
+    std::mutex mutex; /**< Only one thread classifies rows. */
+    std::vector<uint64_t> field; /**< One bit per pixel, the rows are padded to full words. */
+    std::vector<uint64_t> white; /**< One bit per pixel, the rows are padded to full words. */
+    std::vector<unsigned char> rowValid; /**< Were the rows classified in this frame? */
+    std::vector<unsigned char> mask; /**< The field color of the row classified last, one byte per pixel. */
+  };
+
+  const Image* image = nullptr;
+  std::array<unsigned char, 4> fieldColorLower{};
+  std::array<unsigned char, 4> fieldColorUpper{};
+  int minWhiteY = 256;
+  int wordsPerRow = 0;
+  std::shared_ptr<Planes> planes = std::make_shared<Planes>();
+
+  /** Classifies a row if this was not done in this frame. The mutex must be locked. */
+  void classifyRow(int y) const;
+
+  bool isSet(const std::vector<uint64_t>& plane, int x, int y) const { return (plane[y * wordsPerRow + (x >> 6)] >> (x & 63)) & 1; }
+
+  void serialize(In* in, Out* out) override;
+};
+
+struct CLIPClassifiedPixelsUpper : public CLIPClassifiedPixels {};
@@ -29,6 +29,7 @@ STREAMABLE(CLIPPointsPercept,
   {
   points.clear();
   pointsUpper.clear();
+  upperFieldBorderTop = -1.f;
   }
 
   /**
@@ -60,5 +61,6 @@ DEBUG_DRAWING("representation:CLIPPointsPercept:Image:Upper", "drawingOnImage")
 },
 
   (std::vector<Point>) points, /**< The points found in lower image. */
-  (std::vector<Point>) pointsUpper /**< The points found in upper image. */
+  (std::vector<Point>) pointsUpper, /**< The points found in upper image. */
+  (float)(-1.f) upperFieldBorderTop /**< The y coordinate of the highest point of the field border in the upper image or -1 if it was not found. */
 );
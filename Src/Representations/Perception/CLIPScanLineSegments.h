@@ -0,0 +1,87 @@
+/**
+* @file CLIPScanLineSegments.h
+* Declaration of a class that represents the classified scan line segments of the CLIPPreprocessor.
+* The segments are stored as a structure of arrays, so that modules only touch the attributes they need.
+*/
+
+#pragma once
+#include "Tools/Streams/AutoStreamable.h"
+#include "Tools/Math/Eigen.h"
+#include "Tools/Enum.h"
+#include <vector>
+
+/**
+* @class CLIPScanLineSegments
+* The classified segments of all scan lines of both images.
+*/
+STREAMABLE(CLIPScanLineSegments,
+  ENUM(SegmentType,
+    field,
+    line,
+    ball,
+    obstacle, /**< Dynamic obstacles on the field, not covering goalposts. */
+    unknown
+  );
+
+  /**
+  * The segments of one image. Segment i has the attributes types[i], start[i], end[i], and so on.
+  * The segments of scan line n are [lineOffsets[n], lineOffsets[n + 1]). The vertical scan lines
+  * come first, the horizontal ones start at line numOfVerticalLines.
+  */
+  STREAMABLE(Segments,
+    void clear()
+    {
+      types.clear();
+      start.clear();
+      end.clear();
+      avgY.clear();
+      avgCb.clear();
+      avgCr.clear();
+      lineOffsets.assign(1, 0);
+      numOfVerticalLines = 0;
+    }
+
+    /** Starts the next scan line. All segments added until the next call belong to it. */
+    void addLine(bool vertical)
+    {
+      lineOffsets.push_back(static_cast<unsigned>(types.size()));
+      if (vertical)
+        ++numOfVerticalLines;
+    }
+
+    /** Adds a segment to the current scan line. */
+    void addSegment(SegmentType type, const Vector2f& from, const Vector2f& to, int y, int cb, int cr)
+    {
+      types.push_back(static_cast<unsigned char>(type));
+      start.push_back(from);
+      end.push_back(to);
+      avgY.push_back(static_cast<unsigned char>(y));
+      avgCb.push_back(static_cast<unsigned char>(cb));
+      avgCr.push_back(static_cast<unsigned char>(cr));
+      ++lineOffsets.back();
+    }
+
+    unsigned numOfLines() const { return static_cast<unsigned>(lineOffsets.size()) - 1; }
+    unsigned lineBegin(unsigned line) const { return lineOffsets[line]; }
+    unsigned lineEnd(unsigned line) const { return lineOffsets[line + 1]; }
+    SegmentType type(unsigned segment) const { return static_cast<SegmentType>(types[segment]); },
+
+    (std::vector<unsigned char>) types, /**< The SegmentType of each segment. */
+    (std::vector<Vector2f>) start, /**< The first point of each segment in image coordinates. */
+    (std::vector<Vector2f>) end, /**< The last point of each segment in image coordinates. */
+    (std::vector<unsigned char>) avgY, /**< The average y value of each segment. */
+    (std::vector<unsigned char>) avgCb, /**< The average cb value of each segment. */
+    (std::vector<unsigned char>) avgCr, /**< The average cr value of each segment. */
+    (std::vector<unsigned>)({0}) lineOffsets, /**< The index of the first segment of each scan line, followed by the number of segments. */
+    (unsigned)(0) numOfVerticalLines /**< The number of vertical scan lines. */
+  );
+
+  void clear()
+  {
+    lower.clear();
+    upper.clear();
+  },
+
+  (Segments) lower, /**< The segments in the lower image. */
+  (Segments) upper /**< The segments in the upper image. */
+);
@@ -63,6 +63,11 @@ STREAMABLE(FieldColors,
     horizonYAvg = other.horizonYAvg;
     areaHeight = other.areaHeight;
     areaWidth = other.areaWidth;
+    sampleYAvg = other.sampleYAvg;
+    clippedRatio = other.clippedRatio;
+    whiteSamples = other.whiteSamples;
+    whiteCbAvg = other.whiteCbAvg;
+    whiteCrAvg = other.whiteCrAvg;
     return *this;
   }
   inline bool isPixelFieldColorInArea(const int &y, const int &cb, const int &cr, const int &xPos, const int &yPos) const
@@ -83,7 +88,12 @@ STREAMABLE(FieldColors,
   (FieldColor[10]) fieldColorArray, /**< [0] refers to whole image, [1] to [9] to areas on image */
   (int)(4) horizonYAvg,
   (int)(104) areaWidth,
-  (int)(77) areaHeight
+  (int)(77) areaHeight,
+  (int)(0) sampleYAvg, /**< The average brightness of the samples below the horizon, 0 if there were none. */
+  (float)(0.f) clippedRatio, /**< The ratio of these samples that are (almost) saturated. */
+  (int)(0) whiteSamples, /**< The number of bright samples with little color, e.g. on lines. */
+  (int)(128) whiteCbAvg, /**< The average cb of the white samples. */
+  (int)(128) whiteCrAvg /**< The average cr of the white samples. */
 );
 
 struct FieldColorsUpper : public FieldColors
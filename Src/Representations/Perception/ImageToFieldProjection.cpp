@@ -0,0 +1,21 @@
+/**
+ * @file ImageToFieldProjection.cpp
+ * Implementation of a struct that projects image points to the ground or to
+ * another horizontal plane.
+ */
+
+#include "ImageToFieldProjection.h"
+#include "Representations/Infrastructure/CameraInfo.h"
+#include "Representations/Perception/CameraMatrix.h"
+
+void ImageToFieldProjection::compute(const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo)
+{
+  // (1, (cx - x) / f, (cy - y) / f) is the ray through (x, y) in camera coordinates
+  Matrix3f imageToCamera;
+  imageToCamera << 0.f, 0.f, 1.f,
+                   -cameraInfo.focalLengthInv, 0.f, cameraInfo.opticalCenter.x() * cameraInfo.focalLengthInv,
+                   0.f, -cameraInfo.focalLengthInv, cameraInfo.opticalCenter.y() * cameraInfo.focalLengthInv;
+  imageToDirection = static_cast<const Matrix3f&>(cameraMatrix.rotation) * imageToCamera;
+  cameraPosition = cameraMatrix.translation;
+  horizonThreshold = -5.f * cameraInfo.focalLengthInv;
+}
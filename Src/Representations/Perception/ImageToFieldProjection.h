@@ -0,0 +1,79 @@
+/**
+ * @file ImageToFieldProjection.h
+ * Declaration of a struct that projects image points to the ground or to
+ * another horizontal plane.
+ */
+
+#pragma once
+
+#include "Tools/Math/Eigen.h"
+#include "Tools/Streams/AutoStreamable.h"
+
+struct CameraInfo;
+struct CameraMatrix;
+
+/**
+ * The projection of image points to horizontal planes for one camera and
+ * frame. The intrinsic camera parameters and the rotation of the camera
+ * matrix are folded into a single matrix, so projecting a point only costs
+ * a matrix-vector product and a division. The results are the same as the
+ * ones of Transformation::imageToRobot and imageToRobotHorizontalPlane.
+ */
+STREAMABLE(ImageToFieldProjection,
+  /**
+   * Computes the projection.
+   * @param cameraMatrix The extrinsic camera parameters.
+   * @param cameraInfo The intrinsic camera parameters.
+   */
+  void compute(const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo);
+
+  /**
+   * Computes a position relative to the robot on the ground given a point in the image.
+   * @param pointInImage The point in the image.
+   * @param relativePosition The resulting point.
+   * @return Is the point below the horizon and not too far away?
+   */
+  [[nodiscard]] bool imageToRobot(const Vector2f& pointInImage, Vector2f& relativePosition) const
+  {
+    const Vector3f direction = imageToDirection * Vector3f(pointInImage.x(), pointInImage.y(), 1.f);
+    if (direction.z() > horizonThreshold)
+      return false;
+    const float f = cameraPosition.z() / direction.z();
+    relativePosition = cameraPosition.head<2>() - f * direction.head<2>();
+    return std::abs(relativePosition.x()) < maxDistance && std::abs(relativePosition.y()) < maxDistance;
+  }
+
+  [[nodiscard]] bool imageToRobot(const Vector2i& pointInImage, Vector2f& relativePosition) const
+  {
+    return imageToRobot(Vector2f(pointInImage.cast<float>()), relativePosition);
+  }
+
+  /**
+   * Computes a position relative to the robot on a horizontal plane given a point in the image.
+   * @param pointInImage The point in the image.
+   * @param z The height of the horizontal plane above the ground.
+   * @param pointOnPlane The resulting point.
+   * @return Does the ray through the point intersect the plane?
+   */
+  [[nodiscard]] bool imageToRobotHorizontalPlane(const Vector2f& pointInImage, float z, Vector2f& pointOnPlane) const
+  {
+    const Vector3f direction = imageToDirection * Vector3f(pointInImage.x(), pointInImage.y(), 1.f);
+    if (std::abs(direction.z()) <= 0.00001f)
+      return false;
+    pointOnPlane = cameraPosition.head<2>() - (cameraPosition.z() - z) / direction.z() * direction.head<2>();
+    return true;
+  }
+
+private:
+  static constexpr float maxDistance = 142127.f; /**< Points further away are rejected (as in Transformation). */
+public:
+  ,
+
+  (Matrix3f) imageToDirection, /**< Maps homogeneous image coordinates to the direction of their ray relative to the robot. */
+  (Vector3f) cameraPosition, /**< The position of the camera relative to the robot. */
+  (float)(0.f) horizonThreshold /**< Rays with a larger z component do not hit the ground. */
+);
+
+struct ImageToFieldProjectionUpper : public ImageToFieldProjection
+{
+};
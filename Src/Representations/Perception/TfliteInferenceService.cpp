@@ -0,0 +1,256 @@
+#include "TfliteInferenceService.h"
+#include <taskflow/taskflow.hpp>
+#include "Platform/File.h"
+#include "Tools/Debugging/Debugging.h"
+#include <chrono>
+#include <cstring>
+
+void TfliteInferenceService::setup(tf::Executor& executor, const TfliteInferenceSettings& settings)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (this->executor != &executor)
+  {
+    this->executor = &executor;
+    for (Model& model : models)
+      if (model.state.load(std::memory_order_acquire) == Model::ready)
+        model.interpreters.resize(executor.num_workers());
+  }
+  this->settings = settings;
+}
+
+const TfliteInferenceService::Model* TfliteInferenceService::registerModel(const std::string& name, const std::string& filename, Priority priority, int maxBatchSize) const
+{
+  Model& model = findOrLoad(name, filename, priority, maxBatchSize);
+  if (executor->this_worker_id() >= 0)
+    executor->corun_until(
+        [&model]
+        {
+          return model.state.load(std::memory_order_acquire) != Model::loading;
+        });
+  else
+    model.loaded.wait();
+  return checkReady(model);
+}
+
+const TfliteInferenceService::Model* TfliteInferenceService::loadModel(const std::string& name, const std::string& filename, Priority priority, int maxBatchSize) const
+{
+  return checkReady(findOrLoad(name, filename, priority, maxBatchSize));
+}
+
+TfliteInferenceService::Model& TfliteInferenceService::findOrLoad(const std::string& name, const std::string& filename, Priority priority, int maxBatchSize) const
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT(executor);
+  for (Model& model : models)
+    if (model.name == name && model.filename == filename)
+      return model;
+
+  Model& model = models.emplace_back();
+  model.name = name;
+  model.filename = filename;
+  model.priority = priority;
+  model.maxBatchSize = std::max(1, maxBatchSize);
+  model.timingName = "tflite:" + name;
+  model.interpreters.resize(executor->num_workers());
+
+  // the model is not accessible to requests before it is ready, so the loading task is the only one using it
+  const std::shared_ptr<std::promise<void>> done = std::make_shared<std::promise<void>>();
+  model.loaded = done->get_future().share();
+  executor->silent_async([this, &model, done] { load(model, *done); });
+  return model;
+}
+
+void TfliteInferenceService::load(Model& model, std::promise<void>& done) const
+{
+  TfliteInferenceSettings settings;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    settings = this->settings;
+  }
+
+  const std::string path = std::string(File::getBHDir()) + "/Config/" + model.filename;
+  model.model = tflite::FlatBufferModel::BuildFromFile(path.c_str());
+
+  // the allocation of the tensors and the first invocation are much slower than the following ones
+  bool succeeded = model.model != nullptr;
+  for (std::unique_ptr<tflite::Interpreter>& interpreter : model.interpreters)
+  {
+    if (!succeeded)
+      break;
+    interpreter = settings.buildInterpreter(*model.model, model.name,
+        [](tflite::Interpreter& newInterpreter)
+        {
+          TfliteInterpreter::setBatchSize(newInterpreter, 1);
+        });
+    if (interpreter)
+    {
+      TfLiteTensor* input = interpreter->input_tensor(0);
+      std::memset(input->data.raw, 0, input->bytes);
+      succeeded = interpreter->Invoke() == kTfLiteOk;
+    }
+    else
+      succeeded = false;
+  }
+
+  if (succeeded)
+  {
+    const TfLiteTensor* input = model.interpreters[0]->input_tensor(0);
+    model.inputDims.assign(input->dims->data, input->dims->data + input->dims->size);
+    model.inputBytes = input->bytes;
+    model.inputType = input->type;
+    model.inputQuantization = input->params;
+  }
+  else
+  {
+    model.interpreters.clear();
+    model.model.reset();
+  }
+
+  {
+    // the executor might have been replaced in the meantime
+    std::lock_guard<std::mutex> lock(mutex);
+    if (succeeded)
+      model.interpreters.resize(executor->num_workers());
+    model.state.store(succeeded ? Model::ready : Model::failed, std::memory_order_release);
+  }
+  done.set_value();
+}
+
+const TfliteInferenceService::Model* TfliteInferenceService::checkReady(Model& model) const
+{
+  const Model::State state = model.state.load(std::memory_order_acquire);
+  if (state == Model::failed)
+  {
+    bool report;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      report = !model.failureReported;
+      model.failureReported = true;
+    }
+    if (report)
+      OUTPUT_ERROR("Failed to load the tflite model " << model.filename << "!");
+  }
+  return state == Model::ready ? &model : nullptr;
+}
+
+std::future<TfliteInferenceService::Outputs> TfliteInferenceService::submit(const Model& model, Fill fill) const
+{
+  std::future<Outputs> future;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    Request& request = requests[model.priority].emplace_back();
+    request.model = &model;
+    request.fill = std::move(fill);
+    future = request.promise.get_future();
+  }
+
+  // every request gets a task, even if it is run by the task of another request of the same batch
+  executor->silent_async([this] { runNextBatch(); });
+  return future;
+}
+
+std::future<TfliteInferenceService::Outputs> TfliteInferenceService::submit(const Model& model, const void* input) const
+{
+  const unsigned char* data = static_cast<const unsigned char*>(input);
+  return submit(model,
+      [copy = std::vector<unsigned char>(data, data + model.inputBytes)](void* tensor)
+      {
+        std::memcpy(tensor, copy.data(), copy.size());
+      });
+}
+
+TfliteInferenceService::Outputs TfliteInferenceService::get(std::future<Outputs>& future) const
+{
+  if (executor && executor->this_worker_id() >= 0)
+    executor->corun_until(
+        [&future]
+        {
+          return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+  return future.get();
+}
+
+void TfliteInferenceService::runNextBatch() const
+{
+  const Model* model = nullptr;
+  std::vector<Request> batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::deque<Request>& queue : requests)
+      if (!queue.empty())
+      {
+        model = queue.front().model;
+        const size_t maxBatchSize = model->batchable ? model->maxBatchSize : 1;
+        for (auto request = queue.begin(); request != queue.end() && batch.size() < maxBatchSize;)
+          if (request->model == model)
+          {
+            batch.emplace_back(std::move(*request));
+            request = queue.erase(request);
+          }
+          else
+            ++request;
+        break;
+      }
+  }
+
+  if (!batch.empty())
+    run(*model, batch);
+}
+
+void TfliteInferenceService::run(const Model& model, std::vector<Request>& batch) const
+{
+  const int worker = executor->this_worker_id();
+  ASSERT(worker >= 0);
+  std::unique_ptr<tflite::Interpreter>& interpreter = model.interpreters[worker];
+  if (!interpreter)
+  {
+    TfliteInferenceSettings settings;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      settings = this->settings;
+    }
+    interpreter = settings.buildInterpreter(*model.model, model.name);
+  }
+
+  int batchSize = static_cast<int>(batch.size());
+  if (interpreter && batchSize > 1 && !TfliteInterpreter::setBatchSize(*interpreter, batchSize))
+  {
+    OUTPUT_WARNING("The tflite model " << model.name << " has a fixed batch size.");
+    model.batchable = false;
+    batchSize = 1;
+  }
+  if (!interpreter || (batchSize == 1 && !TfliteInterpreter::setBatchSize(*interpreter, 1)))
+  {
+    OUTPUT_ERROR("Failed to allocate the tflite tensors of " << model.name << "!");
+    for (Request& request : batch)
+      request.promise.set_value({});
+    return;
+  }
+
+  // if the model cannot be batched, the requests are run one after another
+  for (size_t first = 0; first < batch.size(); first += batchSize)
+  {
+    const size_t count = std::min(batch.size() - first, static_cast<size_t>(batchSize));
+    char* input = interpreter->input_tensor(0)->data.raw;
+    for (size_t i = 0; i < count; ++i)
+      batch[first + i].fill(input + i * model.inputBytes);
+
+    const bool invoked = TfliteInferenceSettings::invoke(*interpreter, model.timingName.c_str());
+    if (!invoked)
+      OUTPUT_ERROR("Failed to invoke tflite!");
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      Outputs outputs;
+      if (invoked)
+        for (const int index : interpreter->outputs())
+        {
+          const TfLiteTensor* output = interpreter->tensor(index);
+          const size_t size = output->bytes / (sizeof(float) * batchSize);
+          const float* data = output->data.f + i * size;
+          outputs.emplace_back(data, data + size);
+        }
+      batch[first + i].promise.set_value(std::move(outputs));
+    }
+  }
+}
@@ -0,0 +1,165 @@
+/**
+ * @file TfliteInferenceService.h
+ *
+ * This representation runs the tflite models of all modules on the workers of the executor.
+ * Modules submit inputs of a model and get futures of the outputs back. Pending requests of
+ * the same model are batched into one invocation and requests of critical models are run
+ * before the others.
+ */
+
+#pragma once
+
+#include "Representations/Perception/TfliteInterpreter.h"
+#include <array>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
+
+struct TfliteInferenceService : public Streamable
+{
+public:
+  ENUM(Priority,
+    critical, /**< Needed as early as possible, e.g. the ball and the YOLO CNN */
+    normal,
+    low /**< Only run if no other requests are pending, e.g. the penalty cross classification */
+  );
+
+  /** The outputs of one input with one vector per output tensor. It is empty if the invocation failed. */
+  using Outputs = std::vector<std::vector<float>>;
+
+  /** Writes one input to the input tensor, which has the size Model::inputBytes. */
+  using Fill = std::function<void(void* input)>;
+
+  struct Model
+  {
+    std::string name;
+    std::string filename;
+    Priority priority = normal;
+    int maxBatchSize = 1; /**< The maximum number of requests of this model run by one invocation. */
+    std::vector<int> inputDims; /**< The dimensions of the input tensor with a batch size of 1. */
+    size_t inputBytes = 0; /**< The size of one input. */
+    TfLiteType inputType = kTfLiteNoType; /**< The type of the elements of the input. */
+    TfLiteQuantizationParams inputQuantization = {1.f, 0}; /**< The scale and zero point of quantized inputs. */
+
+  private:
+    friend struct TfliteInferenceService;
+
+    enum State
+    {
+      loading,
+      ready,
+      failed
+    };
+
+    std::string timingName;
+    std::unique_ptr<tflite::FlatBufferModel> model;
+    mutable std::vector<std::unique_ptr<tflite::Interpreter>> interpreters; /**< The interpreter of each worker. */
+    mutable std::atomic<bool> batchable = true; /**< Can the input tensor be resized to more than one input? */
+    std::atomic<State> state = loading; /**< The fields above and the sizes of the input are only valid when it is ready. */
+    std::shared_future<void> loaded; /**< Becomes ready when the state is no longer loading. */
+    bool failureReported = false; /**< Was the failure to load the model already reported? */
+  };
+
+  /**
+   * Loads a model and waits until it is ready. Registering the same name and file again returns
+   * the model that already exists.
+   * @param name The name of the model, which also selects its number of threads in TfliteInferenceSettings.
+   * @param filename The file of the model relative to the directory Config.
+   * @param priority The priority of the requests of the model.
+   * @param maxBatchSize The maximum number of requests of the model run by one invocation.
+   * @return The model or nullptr if it could not be loaded.
+   */
+  const Model* registerModel(const std::string& name, const std::string& filename, Priority priority, int maxBatchSize = 1) const;
+
+  /**
+   * Loads a model without waiting for it. The model file is read, the interpreters of all workers
+   * are built and each of them is invoked once by a task of the executor, so that the first real
+   * request of the model is not slower than the others. The parameters are the same as the ones
+   * of registerModel.
+   * @return The model if it is ready. nullptr while it is loading or if it could not be loaded,
+   *         i.e. this method is called again in later frames.
+   */
+  const Model* loadModel(const std::string& name, const std::string& filename, Priority priority, int maxBatchSize = 1) const;
+
+  /**
+   * Submits an input of a model. The input is written by a worker right before the invocation,
+   * so everything fill refers to must stay valid until the future is ready.
+   * @param model The model.
+   * @param fill Writes the input.
+   * @return The future of the outputs.
+   */
+  std::future<Outputs> submit(const Model& model, Fill fill) const;
+
+  /**
+   * Submits an input of a model.
+   * @param model The model.
+   * @param input The input of the size Model::inputBytes. It is copied.
+   * @return The future of the outputs.
+   */
+  std::future<Outputs> submit(const Model& model, const void* input) const;
+
+  /**
+   * Waits for outputs. A worker runs other tasks in the meantime, so that waiting does not block it.
+   * @param future A future returned by submit.
+   * @return The outputs.
+   */
+  Outputs get(std::future<Outputs>& future) const;
+
+  /** Sets the executor whose workers run the models and the settings the interpreters are built with. */
+  void setup(tf::Executor& executor, const TfliteInferenceSettings& settings);
+
+  virtual Streamable& operator=(const Streamable&) noexcept
+  {
+    // this representation is not copyable
+    ASSERT(false);
+    return *this;
+  }
+
+  virtual void serialize(In* in, Out* out)
+  {
+    // this representation is not streamable
+    ASSERT(false);
+  };
+
+private:
+  struct Request
+  {
+    const Model* model;
+    Fill fill;
+    std::promise<Outputs> promise;
+  };
+
+  /**
+   * Returns a model, registering it and starting its loading if it does not exist yet.
+   * @return The model, which might not be ready yet.
+   */
+  Model& findOrLoad(const std::string& name, const std::string& filename, Priority priority, int maxBatchSize) const;
+
+  /**
+   * Loads a model and warms up its interpreters on this worker.
+   * @param model The model, which is still loading.
+   * @param done Is fulfilled when the model is no longer loading.
+   */
+  void load(Model& model, std::promise<void>& done) const;
+
+  /**
+   * Checks whether a model can be used and reports a failure to load it once.
+   * @param model The model.
+   * @return The model or nullptr if it is not ready.
+   */
+  const Model* checkReady(Model& model) const;
+
+  /** Runs the oldest request of the highest priority together with the pending requests of the same model. */
+  void runNextBatch() const;
+
+  /** Invokes a model on a batch of requests on this worker. */
+  void run(const Model& model, std::vector<Request>& batch) const;
+
+  mutable std::mutex mutex;
+  mutable std::list<Model> models;
+  mutable std::array<std::deque<Request>, numOfPrioritys> requests;
+  tf::Executor* executor = nullptr;
+  TfliteInferenceSettings settings;
+};
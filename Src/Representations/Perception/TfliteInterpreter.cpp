@@ -1,6 +1,76 @@
 #include "TfliteInterpreter.h"
 #include <taskflow/taskflow.hpp>
 #include "Platform/File.h"
+#include "Tools/Debugging/Debugging.h"
+#include "Tools/Debugging/Stopwatch.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+
+std::unique_ptr<tflite::Interpreter> TfliteInferenceSettings::buildInterpreter(const tflite::FlatBufferModel& model, const std::string& modelName, const std::function<void(tflite::Interpreter&)>& prepare) const
+{
+  std::unique_ptr<tflite::Interpreter> interpreter;
+  if (delegate == defaultDelegates)
+  {
+    tflite::ops::builtin::BuiltinOpResolver resolver;
+    tflite::InterpreterBuilder(model, resolver)(&interpreter);
+  }
+  else
+  {
+    // XNNPACK is applied explicitly below, so that it gets the configured options
+    tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates resolver;
+    tflite::InterpreterBuilder(model, resolver)(&interpreter);
+  }
+  if (!interpreter)
+  {
+    OUTPUT_ERROR("Failed to build the tflite interpreter of " << modelName << "!");
+    return nullptr;
+  }
+
+  const int threads = getNumOfThreads(modelName);
+  interpreter->SetNumThreads(threads);
+  if (precision == fp16)
+    interpreter->SetAllowFp16PrecisionForFp32(true);
+
+  if (prepare)
+    prepare(*interpreter);
+
+  if (delegate == xnnpack)
+  {
+    TfLiteXNNPackDelegateOptions options = TfLiteXNNPackDelegateOptionsDefault();
+    options.num_threads = threads;
+#ifdef TFLITE_XNNPACK_DELEGATE_FLAG_QS8
+    if (precision == int8)
+      options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_QS8 | TFLITE_XNNPACK_DELEGATE_FLAG_QU8;
+#endif
+#ifdef TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16
+    if (precision == fp16)
+      options.flags |= TFLITE_XNNPACK_DELEGATE_FLAG_FORCE_FP16;
+#endif
+    // the interpreter owns the delegate
+    tflite::Interpreter::TfLiteDelegatePtr xnnpackDelegate(TfLiteXNNPackDelegateCreate(&options), &TfLiteXNNPackDelegateDelete);
+    if (interpreter->ModifyGraphWithDelegate(std::move(xnnpackDelegate)) != kTfLiteOk)
+      OUTPUT_WARNING("Failed to apply XNNPACK to " << modelName << ", using the builtin kernels.");
+  }
+
+  if (interpreter->AllocateTensors() != kTfLiteOk)
+    OUTPUT_ERROR("Failed to allocate the tflite tensors of " << modelName << "!");
+
+  return interpreter;
+}
+
+int TfliteInferenceSettings::getNumOfThreads(const std::string& modelName) const
+{
+  for (const TfliteModelThreads& modelThreads : threadsPerModel)
+    if (modelThreads.model == modelName)
+      return std::max(1, modelThreads.numOfThreads);
+  return std::max(1, numOfThreads);
+}
+
+bool TfliteInferenceSettings::invoke(tflite::Interpreter& interpreter, const char* timingName)
+{
+  // the latency is measured, since the invocation might use other threads
+  Stopwatch s(timingName, false);
+  return interpreter.Invoke() == kTfLiteOk;
+}
 
 void TfliteInterpreter::updateInterpreters(const tf::Executor& executor, const std::function<std::unique_ptr<tflite::Interpreter>(const tflite::FlatBufferModel&, size_t thread)>& func)
 {
@@ -41,3 +111,15 @@ tflite::Interpreter& TfliteInterpreter::getInterpreter() const
 {
   return *interpreters.at(executor->this_worker_id()).get();
 }
+
+bool TfliteInterpreter::setBatchSize(tflite::Interpreter& interpreter, int batchSize)
+{
+  const int inputTensor = interpreter.inputs()[0];
+  const TfLiteIntArray* inputDims = interpreter.tensor(inputTensor)->dims;
+  if (inputDims->data[0] == batchSize)
+    return true;
+
+  std::vector<int> dims(inputDims->data, inputDims->data + inputDims->size);
+  dims[0] = batchSize;
+  return interpreter.ResizeInputTensor(inputTensor, dims) == kTfLiteOk && interpreter.AllocateTensors() == kTfLiteOk;
+}
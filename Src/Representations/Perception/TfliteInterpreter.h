@@ -9,7 +9,8 @@
 #pragma once
 
 #include <memory>
-#include "Tools/Streams/Streamable.h"
+#include "Tools/Streams/AutoStreamable.h"
+#include "Tools/Enum.h"
 #include "Modules/Perception/TFlite.h"
 #include <functional>
 
@@ -18,6 +19,54 @@ namespace tf
   class Executor;
 }
 
+STREAMABLE(TfliteModelThreads,,
+  (std::string) model, /**< The name of the model as passed to TfliteInferenceSettings::buildInterpreter. */
+  (int)(1) numOfThreads /**< The number of threads an invocation of the model uses. */
+);
+
+/**
+ * The central configuration of the inference with tflite. All modules that run tflite
+ * models build their interpreters and invoke them through this representation.
+ */
+STREAMABLE(TfliteInferenceSettings,
+  ENUM(Delegate,
+    builtin, /**< Only the builtin kernels of tflite */
+    defaultDelegates, /**< The delegates tflite applies by itself, i.e. XNNPACK for float models */
+    xnnpack /**< XNNPACK with the configured number of threads and precision, also for quantized models */
+  );
+
+  ENUM(Precision,
+    float32,
+    int8, /**< Run quantized models with XNNPACK instead of the builtin kernels */
+    fp16 /**< Allow computing float models with half precision */
+  );
+
+  /**
+   * Builds an interpreter of a model with the configured delegate and number of threads.
+   * @param model The model.
+   * @param modelName The name of the model. It selects the number of threads.
+   * @param prepare Is called before the delegate is applied and the tensors are allocated, e.g. to resize the input tensors.
+   * @return The interpreter or nullptr if it could not be built.
+   */
+  std::unique_ptr<tflite::Interpreter> buildInterpreter(const tflite::FlatBufferModel& model, const std::string& modelName, const std::function<void(tflite::Interpreter&)>& prepare = nullptr) const;
+
+  /** Returns the number of threads an invocation of a model uses. */
+  int getNumOfThreads(const std::string& modelName) const;
+
+  /**
+   * Invokes an interpreter and measures the latency with the TimingManager.
+   * @param interpreter The interpreter.
+   * @param timingName The name of the stopwatch, e.g. "tflite:ballCNN". It must be a string literal.
+   * @return Did the invocation succeed?
+   */
+  static bool invoke(tflite::Interpreter& interpreter, const char* timingName),
+
+  (Delegate)(xnnpack) delegate,
+  (Precision)(float32) precision,
+  (int)(1) numOfThreads, /**< The number of threads of the models that are not listed in threadsPerModel. */
+  (std::vector<TfliteModelThreads>) threadsPerModel
+);
+
 struct TfliteInterpreter : public Streamable
 {
 public:
@@ -27,6 +76,15 @@ public:
   tflite::Interpreter& getInterpreter() const;
   tflite::Interpreter& getInterpreter(size_t index) const;
 
+  /**
+   * Sets the batch dimension of the first input tensor of an interpreter. The tensors are
+   * only reallocated if it changed.
+   * @param interpreter The interpreter.
+   * @param batchSize The number of inputs processed by one invocation.
+   * @return Could the tensors be allocated?
+   */
+  static bool setBatchSize(tflite::Interpreter& interpreter, int batchSize);
+
   virtual Streamable& operator=(const Streamable&) noexcept
   {
     // this representation is not copyable
@@ -68,3 +126,27 @@ struct SplittedTfliteInterpreter : public Streamable
     ASSERT(false);
   };
 };
+
+/**
+ * The interpreters of the ball CNNs with a variable batch size, so that all patches of a frame
+ * can be processed by a few invocations. In contrast to SplittedTfliteInterpreter, each layer
+ * has its own input tensor, so that only a part of the batch can be passed on to the next one.
+ */
+struct BatchedTfliteInterpreter : public Streamable
+{
+  TfliteInterpreter ballCNN;
+  std::vector<TfliteInterpreter> splittedBallCNN;
+
+  virtual Streamable& operator=(const Streamable&) noexcept
+  {
+    // this representation is not copyable
+    ASSERT(false);
+    return *this;
+  }
+
+  virtual void serialize(In* in, Out* out)
+  {
+    // this representation is not streamable
+    ASSERT(false);
+  };
+};
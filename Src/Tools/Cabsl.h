@@ -171,13 +171,16 @@ protected:
       parameters.emplace_back(buf);
     }
 
+    /** Is the activation graph recorded in this frame? Otherwise, the parameters are not converted to strings. */
+    bool isActivationGraphRecorded() const { return instance->recordActivationGraph; }
+
     /**
     * The method adds information about the current option and state to the activation graph.
     * It suppresses adding it twice in the same frame.
     */
     void addToActivationGraph() const
     {
-      if (!context.messageSent && instance->activationGraph)
+      if (!context.messageSent && instance->recordActivationGraph)
       {
         instance->activationGraph->graph.emplace_back(
             optionName, instance->depth, context.stateName, instance->_currentFrameTime - context.optionStart, instance->_currentFrameTime - context.stateStart, parameters);
@@ -345,6 +348,7 @@ private:
   unsigned lastFrameTime; /**< The time stamp of the last time the behavior was executed. */
   unsigned char depth; /**< The depth level of the current option. Used for sending debug messages. */
   ActivationGraph* activationGraph; /**< The activation graph for debug output. Can be zero if not set. */
+  bool recordActivationGraph = false; /**< Is the activation graph filled in the current frame? */
 
 protected:
   static CycleLocal<Cabsl*> _theInstance; /**< The instance of this behavior used. */
@@ -368,10 +372,13 @@ public:
   /**
   * Must be call at the beginning of each behavior execution cycle.
   * @param frameTime The current time in ms.
+  * @param recordActivationGraph Shall the activation graph be filled in this frame? It stays empty
+  *                              otherwise, which saves converting all option parameters to strings.
   */
-  void beginFrame(unsigned frameTime)
+  void beginFrame(unsigned frameTime, bool recordActivationGraph = true)
   {
     _currentFrameTime = frameTime;
+    this->recordActivationGraph = activationGraph && recordActivationGraph;
     if (activationGraph)
       activationGraph->graph.clear();
   }
@@ -442,8 +449,12 @@ template <typename CabslBehavior> typename Cabsl<CabslBehavior>::OptionInfos Cab
 /** Generate a variable name for the list of actual parameters of a method call. */
 #define _CABSL_VAR(seq) _STREAM_VAR(seq),
 
-/** Generate code for streaming a variable and adding it to the parameters stored in the execution environment. */
+/**
+ * Generate code for streaming a variable and adding it to the parameters stored in the execution environment.
+ * This is skipped if the activation graph is not recorded.
+ */
 #define _CABSL_STREAM(seq)                                                        \
+  if (_o.isActivationGraphRecorded())                                             \
   _STREAM_JOIN(_CABSL_STREAM_, _STREAM_SEQ_SIZE(seq))(seq)                        \
   {                                                                               \
     struct _S : public Streamable                                                 \
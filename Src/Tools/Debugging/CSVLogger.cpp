@@ -1,230 +1,268 @@
 #include "CSVLogger.h"
-#include <stdio.h>
-#include <string>
-#include <iostream>
 #include "Platform/File.h"
 #include "Platform/SystemCall.h"
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/** The background thread that formats the rows of all threads and writes them into the files. */
+class CSVLogger::Writer
+{
+public:
+  static Writer& get()
+  {
+    static Writer writer;
+    return writer;
+  }
+
+  Writer() : thread(&Writer::run, this) {}
+
+  /** Writes all rows still waiting before the thread is stopped. */
+  ~Writer()
+  {
+    running = false;
+    thread.join();
+  }
+
+  void add(const std::shared_ptr<Producer>& producer)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    added.push_back({producer, {}});
+  }
+
+private:
+  struct Source
+  {
+    std::shared_ptr<Producer> producer;
+    std::vector<std::unique_ptr<std::ofstream>> files; /**< The files by their index in the producer, nullptr if they could not be opened. */
+  };
+
+  std::mutex mutex; /**< Protects the producers added. */
+  std::vector<Source> added; /**< Producers not yet seen by the thread. */
+  std::vector<Source> sources; /**< Only accessed by the thread. */
+  std::atomic<bool> running{true};
+  std::thread thread;
 
-using namespace std;
+  void run()
+  {
+    while (running)
+      if (!write())
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    write();
+  }
+
+  /** @return Were any rows written? */
+  bool write()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (Source& source : added)
+        sources.emplace_back(std::move(source));
+      added.clear();
+    }
+
+    bool written = false;
+    for (auto source = sources.begin(); source != sources.end();)
+    {
+      Producer& producer = *source->producer;
+      const SPSCRingBuffer<Row>::Window rows = producer.rows.peek(0, producer.rows.size());
+      for (size_t i = 0; i < rows.size(); ++i)
+        write(*source, rows[i]);
+      producer.rows.consume(rows.size());
+      written |= rows.size() > 0;
+
+      for (const std::unique_ptr<std::ofstream>& file : source->files)
+        if (file && rows.size() > 0)
+          file->flush();
+
+      if (const unsigned dropped = producer.dropped.exchange(0))
+        std::cerr << "CSVLogger: " << dropped << " rows dropped" << std::endl;
+
+      // The thread that logged has ended and everything it logged is written.
+      if (source->producer.use_count() == 1 && producer.rows.size() == 0)
+        source = sources.erase(source);
+      else
+        ++source;
+    }
+    return written;
+  }
+
+  void write(Source& source, const Row& row)
+  {
+    if (!row.name.empty())
+    {
+      std::string path = std::string(File::getBHDir()) + "/Config/Logs/CSVLogger/";
+      std::filesystem::create_directories(path);
+      path += row.name + ".csv";
+      std::unique_ptr<std::ofstream> file = std::make_unique<std::ofstream>(path, std::ios::out);
+      if (file->fail())
+      {
+        std::cerr << "CSVLogger: cannot open " << path << std::endl;
+        file.reset();
+      }
+      else
+        std::cout << "Logfile: " << row.name << std::endl;
+      if (source.files.size() <= row.file)
+        source.files.resize(row.file + 1);
+      source.files[row.file] = std::move(file);
+    }
 
-CSVLogger::CSVLogger(void) {}
+    if (row.file >= source.files.size() || !source.files[row.file])
+      return;
+    std::ofstream& stream = *source.files[row.file];
 
-CSVLogger::~CSVLogger(void) {}
+    for (size_t i = 0; i < row.header.size(); ++i)
+      stream << row.header[i] << (i + 1 < row.header.size() ? ";" : "\n");
 
-CSVLogger::LogfileList CSVLogger::logs;
-bool CSVLogger::disabled = false;
+    for (size_t i = 0; i < row.values.size(); ++i)
+    {
+      std::visit([&stream](const auto& value)
+      {
+        if constexpr(!std::is_same_v<std::decay_t<decltype(value)>, std::monostate>)
+          stream << value;
+      }, row.values[i]);
+      stream << (i + 1 < row.values.size() ? ";" : "\n");
+    }
+  }
+};
 
-void CSVLogger::log(string titel, string name, string data)
+void CSVLogger::log(std::string_view titel, std::string_view name, std::string_view data)
 {
-  if (disabled)
-    return;
-  stringstream s;
-  s << data;
-  add(titel, name, s.str());
+  add(titel, name, std::string(data));
 }
 
-void CSVLogger::log(string titel, string name, unsigned int data)
+void CSVLogger::log(std::string_view titel, std::string_view name, unsigned int data)
 {
-  if (disabled)
-    return;
-  stringstream s;
-  s << data;
-  add(titel, name, s.str());
+  add(titel, name, static_cast<unsigned long long>(data));
 }
 
-void CSVLogger::log(string titel, string name, unsigned long data)
+void CSVLogger::log(std::string_view titel, std::string_view name, unsigned long data)
 {
-  if (disabled)
-    return;
-  stringstream s;
-  s << data;
-  add(titel, name, s.str());
+  add(titel, name, static_cast<unsigned long long>(data));
 }
 
-void CSVLogger::log(string titel, string name, int data)
+void CSVLogger::log(std::string_view titel, std::string_view name, int data)
 {
-  if (disabled)
-    return;
-  stringstream s;
-  s << data;
-  add(titel, name, s.str());
+  add(titel, name, static_cast<long long>(data));
 }
 
-void CSVLogger::log(string titel, string name, long data)
+void CSVLogger::log(std::string_view titel, std::string_view name, long data)
 {
-  if (disabled)
-    return;
-  stringstream s;
-  s << data;
-  add(titel, name, s.str());
+  add(titel, name, static_cast<long long>(data));
 }
 
-void CSVLogger::log(string titel, string name, double data)
+void CSVLogger::log(std::string_view titel, std::string_view name, double data)
 {
-  if (disabled)
-    return;
-  stringstream s;
-  s << data;
-  add(titel, name, s.str());
+  add(titel, name, data);
 }
 
-void CSVLogger::mark(string titel, string name)
+void CSVLogger::mark(std::string_view titel, std::string_view name)
 {
-  if (disabled)
-    return;
-  Logfile* f = getFile(titel);
-  if (f == NULL)
-    f = addFile(titel);
-
-  if (f == NULL)
-    return;
-
-  if (f->headerWritten)
-    return;
-
-  Column* c = getColumn(f, name);
-  if (c == NULL)
-    c = addColumn(f, name);
+  Producer& producer = getProducer();
+  Logfile& f = producer.logs[getFile(producer, titel)];
+  if (!f.headerWritten && !getColumn(f, name))
+    f.columns.push_back({std::string(name)});
 }
 
-
-bool CSVLogger::add(string titel, string name, string data)
+void CSVLogger::add(std::string_view titel, std::string_view name, Value&& data)
 {
-  Logfile* f = getFile(titel);
-  if (f == NULL)
-    f = addFile(titel);
-
-  if (f == NULL)
-    return false;
+  Producer& producer = getProducer();
+  const unsigned file = getFile(producer, titel);
+  Logfile& f = producer.logs[file];
 
   Column* c = getColumn(f, name);
-
-  if (c == NULL)
+  if (!c)
   {
-    if (f->headerWritten)
-      return false;
-    else
-      c = addColumn(f, name);
+    if (f.headerWritten)
+      return;
+    f.columns.push_back({std::string(name)});
+    c = &f.columns.back();
   }
 
   if (c->filled)
-    flush(f);
+    flush(producer, file);
 
-  c->data = data;
+  c->data = std::move(data);
   c->filled = true;
-
-  return true;
 }
 
 void CSVLogger::flush()
 {
-  if (disabled)
-    return;
-  for (LogfileList::iterator log = logs.begin(); log != logs.end(); ++log)
-  {
-    flush(*log);
-  }
+  Producer& producer = getProducer();
+  for (unsigned file = 0; file < producer.logs.size(); ++file)
+    flush(producer, file);
 }
 
-void CSVLogger::flush(Logfile* f)
+void CSVLogger::flush(Producer& producer, unsigned file)
 {
-  if (disabled)
-    return;
-  if (!f->headerWritten)
+  Logfile& f = producer.logs[file];
+  Row& row = producer.row;
+  row.file = file;
+  row.name.clear();
+  row.header.clear();
+  if (!f.headerWritten)
   {
-    for (ColumnList::iterator el = f->columns.begin(); el != f->columns.end(); ++el)
-    {
-      f->s << (*el)->name;
-      if ((*el) != f->columns.back())
-        f->s << ";";
-      else
-        f->s << "\n";
-    }
-    f->headerWritten = true;
+    row.name = f.name;
+    for (const Column& column : f.columns)
+      row.header.push_back(column.name);
   }
 
-  for (ColumnList::iterator el = f->columns.begin(); el != f->columns.end(); ++el)
+  row.values.resize(f.columns.size());
+  for (size_t i = 0; i < f.columns.size(); ++i)
   {
-    f->s << (*el)->data;
-    if ((*el) != f->columns.back())
-      f->s << ";";
-    else
-      f->s << "\n";
-    (*el)->filled = false;
-    (*el)->data = "0";
+    Column& column = f.columns[i];
+    row.values[i] = column.data;
+    column.filled = false;
+    column.data = 0ll;
   }
-  f->s.flush();
 
-  add(f->name, "time", to_string(SystemCall::getCurrentSystemTime()));
+  // If the first row is dropped, the columns can still change until a header reaches the writer.
+  if (producer.rows.push(&row, 1))
+    f.headerWritten = true;
+  else
+    ++producer.dropped;
+
+  f.columns.front().data = static_cast<unsigned long long>(SystemCall::getCurrentSystemTime());
+  f.columns.front().filled = true;
 }
 
-CSVLogger::Logfile* CSVLogger::getFile(string name)
+CSVLogger::Producer& CSVLogger::getProducer()
 {
-  for (LogfileList::iterator log = logs.begin(); log != logs.end(); ++log)
+  thread_local std::shared_ptr<Producer> producer;
+  if (!producer)
   {
-    if ((*log)->name == name)
-      return *log;
+    producer = std::make_shared<Producer>();
+    Writer::get().add(producer);
   }
-  return NULL;
+  return *producer;
 }
 
-CSVLogger::Column* CSVLogger::getColumn(Logfile* f, string name)
+unsigned CSVLogger::getFile(Producer& producer, std::string_view name)
 {
-  if (f->columns.size() == 0)
-    return NULL;
-
-  ColumnList::iterator el = f->lastFound;
-  for (int i = 0; i < (int)f->columns.size(); i++, el++)
-  {
-    if (el == f->columns.end())
-      el = f->columns.begin();
-
-    if ((*el)->name == name)
-    {
-      f->lastFound = el;
-      return *el;
-    }
-  }
-  return NULL;
+  for (unsigned i = 0; i < producer.logs.size(); ++i)
+    if (producer.logs[i].name == name)
+      return i;
+
+  Logfile& f = producer.logs.emplace_back();
+  f.name = name;
+  f.columns.push_back({"time", static_cast<unsigned long long>(SystemCall::getCurrentSystemTime()), true});
+  return static_cast<unsigned>(producer.logs.size() - 1);
 }
 
-CSVLogger::Logfile* CSVLogger::addFile(string name)
+CSVLogger::Column* CSVLogger::getColumn(Logfile& f, std::string_view name)
 {
-  Logfile* neu = new Logfile;
-  string path = File::getBHDir();
-  path += "/Config/Logs/CSVLogger/";
-  std::filesystem::create_directories(path);
-  path += name;
-  path += ".csv";
-  neu->s.open(path.c_str(), ios::out);
-  if (neu->s.fail())
+  for (size_t i = 0; i < f.columns.size(); ++i)
   {
-    disabled = true;
-    delete neu;
-    neu = NULL;
-  }
-  else
-  {
-    disabled = false;
-    std::cout << "Logfile: " << name << std::endl;
-    neu->headerWritten = false;
-    neu->name = name;
-    logs.push_back(neu);
-    addColumn(neu, "time");
-    add(neu->name, "time", to_string(SystemCall::getCurrentSystemTime()));
+    const size_t index = (f.lastFound + i) % f.columns.size();
+    if (f.columns[index].name == name)
+    {
+      f.lastFound = index;
+      return &f.columns[index];
+    }
   }
-  return neu;
-}
-
-CSVLogger::Column* CSVLogger::addColumn(Logfile* f, string name)
-{
-  Column* neu = new Column;
-  neu->filled = false;
-  neu->data = "";
-  neu->name = name;
-  f->columns.push_back(neu);
-  if (f->columns.size() == 1)
-    f->lastFound = f->columns.begin();
-  return neu;
+  return nullptr;
 }
@@ -1,9 +1,20 @@
+/**
+ * @file CSVLogger.h
+ * A logger that writes values into CSV files in Config/Logs/CSVLogger. The
+ * thread that logs only collects the values of a row in binary form and pushes
+ * complete rows into a lock-free ring. A background thread formats them and
+ * writes the files, so logging in Motion does not change its cycle times.
+ * If the writer falls behind, rows are dropped instead of blocking the thread.
+ */
+
 #pragma once
 
+#include "Tools/SPSCRingBuffer.h"
+#include <atomic>
 #include <string>
-#include <sstream>
-#include <fstream>
-#include <list>
+#include <string_view>
+#include <variant>
+#include <vector>
 
 #ifdef RELEASE
 #undef LOGGING
@@ -43,47 +54,67 @@
 class CSVLogger
 {
 public:
-  CSVLogger(void);
-  ~CSVLogger(void);
-
-  static void log(std::string titel, std::string name, std::string data);
-  static void log(std::string titel, std::string name, unsigned int data);
-  static void log(std::string titel, std::string name, double data);
-  static void log(std::string titel, std::string name, unsigned long data);
-  static void log(std::string titel, std::string name, long data);
-  static void log(std::string titel, std::string name, int data);
-  static void mark(std::string titel, std::string name);
+  static void log(std::string_view titel, std::string_view name, std::string_view data);
+  static void log(std::string_view titel, std::string_view name, unsigned int data);
+  static void log(std::string_view titel, std::string_view name, double data);
+  static void log(std::string_view titel, std::string_view name, unsigned long data);
+  static void log(std::string_view titel, std::string_view name, long data);
+  static void log(std::string_view titel, std::string_view name, int data);
+  static void mark(std::string_view titel, std::string_view name);
+
+  /** Completes the current rows of all files of the calling thread. */
   static void flush();
 
 private:
+  /** A value in binary form. It is only converted to text by the writer. Empty values are written as empty cells. */
+  using Value = std::variant<std::monostate, double, long long, unsigned long long, std::string>;
+
+  /** A complete row as it is passed to the writer. */
+  struct Row
+  {
+    unsigned file = 0; /**< The index of the file in the thread that logged it. */
+    std::string name; /**< The name of the file. Only set in its first row. */
+    std::vector<std::string> header; /**< The names of the columns. Only set in the first row of a file. */
+    std::vector<Value> values;
+  };
+
   struct Column
   {
     std::string name;
-    std::string data;
-    bool filled;
+    Value data;
+    bool filled = false;
   };
 
-  typedef std::list<Column*> ColumnList;
-
+  /** The file as seen by the thread that logs into it. */
   struct Logfile
   {
-    std::ofstream s;
     std::string name;
-    ColumnList columns;
-    bool headerWritten;
-    ColumnList::iterator lastFound;
+    std::vector<Column> columns;
+    bool headerWritten = false;
+    size_t lastFound = 0; /**< The column found most recently. Columns are usually filled in the same order. */
+  };
+
+  /** The state of a thread that logs. It is shared with the writer until both are done with it. */
+  struct Producer
+  {
+    static constexpr size_t ringSize = 1024; /**< The number of rows that can wait for the writer. */
+
+    std::vector<Logfile> logs;
+    SPSCRingBuffer<Row> rows{ringSize};
+    Row row; /**< The row currently assembled, kept to reuse its memory. */
+    std::atomic<unsigned> dropped{0}; /**< The number of rows dropped, because the ring was full. */
   };
 
-  typedef std::list<Logfile*> LogfileList;
+  class Writer;
 
-  static LogfileList logs;
+  /** @return The state of the calling thread. It is registered with the writer when it is created. */
+  static Producer& getProducer();
 
-  static bool add(std::string titel, std::string name, std::string data);
+  static void add(std::string_view titel, std::string_view name, Value&& data);
+  /** @return The index of the file of the calling thread with the given name. It is created if necessary. */
+  static unsigned getFile(Producer& producer, std::string_view name);
+  static Column* getColumn(Logfile& f, std::string_view name);
 
-  static Logfile* getFile(std::string name);
-  static Column* getColumn(Logfile* f, std::string name);
-  static Logfile* addFile(std::string name);
-  static Column* addColumn(Logfile* f, std::string name);
-  static void flush(Logfile* f);
-  static bool disabled;
+  /** Passes the current row of a file to the writer and starts the next one. */
+  static void flush(Producer& producer, unsigned file);
 };
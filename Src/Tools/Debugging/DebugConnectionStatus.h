@@ -0,0 +1,23 @@
+/**
+ * @file Tools/Debugging/DebugConnectionStatus.h
+ *
+ * Declaration of a struct that describes the state of the debug connection
+ * from the robot to the PC.
+ */
+
+#pragma once
+
+#include "Tools/Streams/AutoStreamable.h"
+
+/**
+ * Statistics the DebugHandler sends once per second. They are measured on the
+ * robot and cover the second before the message was sent.
+ */
+STREAMABLE(DebugConnectionStatus,,
+  (float)(0.f) bytesPerSecond, /**< The number of bytes sent per second. */
+  (unsigned)(0) packagesSent, /**< The number of packages sent. */
+  (unsigned)(0) latency, /**< The average time between handing a package over to the network thread and it being sent (in ms). */
+  (unsigned)(0) maxLatency, /**< The maximum time between handing a package over to the network thread and it being sent (in ms). */
+  (unsigned)(1) imageInterval, /**< Images are only sent in every n-th package. */
+  (unsigned)(0) imagesDropped /**< The number of image messages dropped due to backpressure. */
+);
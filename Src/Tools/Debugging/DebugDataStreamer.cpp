@@ -17,105 +17,170 @@
 thread_local const std::vector<const char*>* DebugDataStreamer::enumNames(nullptr);
 
 DebugDataStreamer::DebugDataStreamer(StreamHandler& streamHandler, In& stream, const std::string& type, const char* name)
-    : streamHandler(streamHandler), inData(&stream), type(type), name(name)
+    : streamHandler(streamHandler), inData(&stream), type(resolve(streamHandler, type)), name(name)
 {
 }
 
 DebugDataStreamer::DebugDataStreamer(StreamHandler& streamHandler, Out& stream, const std::string& type, const char* name)
-    : streamHandler(streamHandler), outData(&stream), type(type), name(name)
+    : streamHandler(streamHandler), outData(&stream), type(resolve(streamHandler, type)), name(name)
 {
 }
 
-void DebugDataStreamer::serialize(In* in, Out* out)
+const DebugDataType* DebugDataStreamer::resolve(StreamHandler& streamHandler, const std::string& typeString)
 {
-  ASSERT((inData && out) || (outData && in));
+  StreamHandler::ResolvedTypes::const_iterator cached = streamHandler.resolvedTypes.find(typeString);
+  if (cached != streamHandler.resolvedTypes.end())
+    return cached->second.get();
 
+  std::shared_ptr<DebugDataType> resolved = std::make_shared<DebugDataType>();
+  std::string type = typeString;
   if (type.size() > 8 && type.substr(type.size() - 8) == " __ptr64")
     type = type.substr(0, type.size() - 8);
 
   if (type[type.size() - 1] == ']' || type[type.size() - 1] == '*')
   {
-    unsigned size = 0;
     std::string elementType;
-    bool staticSize = type[type.size() - 1] == ']';
-    if (staticSize)
+    if (type[type.size() - 1] == ']')
     {
       size_t i = type.size();
       while (type[i - 1] != '[')
         --i;
       size_t j = type[i - 2] == ' ' ? i - 2 : i - 1;
-      size = atoi(&type[i]);
+      resolved->kind = DebugDataType::staticArray;
+      resolved->size = atoi(&type[i]);
       if (type[j - 1] == ')')
       {
         j -= type[j - 2] == '4' ? 8 : 0; // " __ptr64"
         j -= type[j - 4] == ' ' ? 4 : 3;
       }
-      elementType = std::string(type).substr(0, j);
+      elementType = type.substr(0, j);
     }
     else
     {
-      elementType = std::string(type).substr(0, type.size() - (type.size() > 1 && type[type.size() - 2] == ' ' ? 2 : 1));
-      if (inData)
-        *inData >> size;
+      resolved->kind = DebugDataType::dynamicArray;
+      elementType = type.substr(0, type.size() - (type.size() > 1 && type[type.size() - 2] == ' ' ? 2 : 1));
+    }
+    resolved->element = resolve(streamHandler, elementType);
+  }
+  else
+  {
+    if (type.size() > 6 && type.substr(type.size() - 6) == " const")
+      type = type.substr(0, type.size() - 6);
+    const char* t = streamHandler.getString(type.c_str());
+    StreamHandler::Specification::const_iterator i = streamHandler.specification.find(t);
+    StreamHandler::EnumSpecification::const_iterator e = streamHandler.enumSpecification.find(t);
+    if (i != streamHandler.specification.end())
+    {
+      resolved->kind = DebugDataType::record;
+      resolved->fields.reserve(i->second.size());
+      for (const StreamHandler::TypeNamePair& field : i->second)
+        resolved->fields.emplace_back(field.first.c_str(), resolve(streamHandler, field.second));
     }
+    else if (streamHandler.basicTypeSpecification.find(t) != streamHandler.basicTypeSpecification.end())
+    {
+      if (!strcmp("char", t))
+        resolved->kind = DebugDataType::charValue;
+      else if (!strcmp("signed char", t))
+        resolved->kind = DebugDataType::signedCharValue;
+      else if (!strcmp("unsigned char", t))
+        resolved->kind = DebugDataType::unsignedCharValue;
+      else if (!strcmp("short", t))
+        resolved->kind = DebugDataType::shortValue;
+      else if (!strcmp("unsigned short", t))
+        resolved->kind = DebugDataType::unsignedShortValue;
+      else if (!strcmp("int", t))
+        resolved->kind = DebugDataType::intValue;
+      else if (!strcmp("unsigned", t) || !strcmp("unsigned int", t))
+        resolved->kind = DebugDataType::unsignedValue;
+      else if (!strcmp("float", t))
+        resolved->kind = DebugDataType::floatValue;
+      else if (!strcmp("double", t))
+        resolved->kind = DebugDataType::doubleValue;
+      else if (!strcmp("uint64_t", t) || !strcmp("unsigned __int64", t) || !strcmp("unsigned long", t))
+        resolved->kind = DebugDataType::uint64Value;
+      else if (!strcmp("bool", t))
+        resolved->kind = DebugDataType::boolValue;
+      else if (std::string(t).find("string") != std::string::npos)
+        resolved->kind = DebugDataType::stringValue;
+      else if (std::string(t).find("Angle") != std::string::npos)
+        resolved->kind = DebugDataType::angleValue;
+    }
+    else if (e != streamHandler.enumSpecification.end())
+    {
+      resolved->kind = DebugDataType::enumeration;
+      resolved->enumNames = &e->second;
+    }
+  }
+
+  // resolving the element and field types may have added entries, so the type is inserted last
+  streamHandler.resolvedTypes[typeString] = resolved;
+  return resolved.get();
+}
+
+void DebugDataStreamer::serialize(In* in, Out* out)
+{
+  ASSERT((inData && out) || (outData && in));
 
-    if (in)
+  const DebugDataType* currentType = type;
+  switch (currentType->kind)
+  {
+    case DebugDataType::staticArray:
+    case DebugDataType::dynamicArray:
     {
-      in->select(name, -1);
-      unsigned dynamicSize;
-      *in >> dynamicSize;
-      if (!staticSize)
-      {
-        size = dynamicSize;
-        *outData << size;
-      }
-      else if (size != dynamicSize)
+      unsigned size = currentType->size;
+      bool staticSize = currentType->kind == DebugDataType::staticArray;
+      if (!staticSize && inData)
+        *inData >> size;
+
+      if (in)
       {
-        char buf[100];
-        sprintf(buf, "array has %d elements instead of %d", dynamicSize, size);
-        InMap* inMap = dynamic_cast<InMap*>(in);
-        if (inMap)
-          inMap->printError(buf);
-        else
+        in->select(name, -1);
+        unsigned dynamicSize;
+        *in >> dynamicSize;
+        if (!staticSize)
         {
-          OUTPUT_ERROR(buf);
           size = dynamicSize;
+          *outData << size;
+        }
+        else if (size != dynamicSize)
+        {
+          char buf[100];
+          sprintf(buf, "array has %d elements instead of %d", dynamicSize, size);
+          InMap* inMap = dynamic_cast<InMap*>(in);
+          if (inMap)
+            inMap->printError(buf);
+          else
+          {
+            OUTPUT_ERROR(buf);
+            size = dynamicSize;
+          }
         }
       }
-    }
-    else
-    {
-      out->select(name, -1);
-      *out << size;
-    }
+      else
+      {
+        out->select(name, -1);
+        *out << size;
+      }
+
+      for (unsigned i = 0; i < size; ++i)
+      {
+        // set attributes for recursive call to this method
+        type = currentType->element;
+        name = 0;
+        index = static_cast<int>(i);
+        if (in)
+          *in >> *this;
+        else
+          *out << *this;
+      }
 
-    for (unsigned i = 0; i < size; ++i)
-    {
-      // set attributes for recursive call to this method
-      type = elementType;
-      name = 0;
-      index = static_cast<int>(i);
       if (in)
-        *in >> *this;
+        in->deselect();
       else
-        *out << *this;
+        out->deselect();
+      break;
     }
-
-    if (in)
-      in->deselect();
-    else
-      out->deselect();
-  }
-  else
-  {
-    std::string typeName = type;
-    if (typeName.size() > 6 && typeName.substr(typeName.size() - 6) == " const")
-      typeName = typeName.substr(0, typeName.size() - 6);
-    const char* t = streamHandler.getString(typeName.c_str());
-    StreamHandler::Specification::const_iterator i = streamHandler.specification.find(t);
-    StreamHandler::BasicTypeSpecification::const_iterator b = streamHandler.basicTypeSpecification.find(t);
-    StreamHandler::EnumSpecification::const_iterator e = streamHandler.enumSpecification.find(t);
-    if (i != streamHandler.specification.end())
+    case DebugDataType::record:
     {
       bool select = name != 0 || index >= 0;
       if (select)
@@ -125,11 +190,11 @@ void DebugDataStreamer::serialize(In* in, Out* out)
         else
           out->select(name, index);
       }
-      for (std::vector<StreamHandler::TypeNamePair>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+      for (const std::pair<const char*, const DebugDataType*>& field : currentType->fields)
       {
         // set attributes for recursive call to this method
-        type = j->second;
-        name = j->first.c_str();
+        type = field.second;
+        name = field.first;
         index = -2;
         if (in)
           *in >> *this;
@@ -143,46 +208,55 @@ void DebugDataStreamer::serialize(In* in, Out* out)
         else
           out->deselect();
       }
+      break;
     }
-    else if (b != streamHandler.basicTypeSpecification.end())
-    {
-      if (!strcmp("char", t))
-        streamIt<char>(in, out);
-      else if (!strcmp("signed char", t))
-        streamIt<signed char>(in, out);
-      else if (!strcmp("unsigned char", t))
-        streamIt<unsigned char>(in, out);
-      else if (!strcmp("short", t))
-        streamIt<short>(in, out);
-      else if (!strcmp("unsigned short", t))
-        streamIt<unsigned short>(in, out);
-      else if (!strcmp("int", t))
-        streamIt<int>(in, out);
-      else if (!strcmp("unsigned", t) || !strcmp("unsigned int", t))
-        streamIt<unsigned>(in, out);
-      else if (!strcmp("float", t))
-        streamIt<float>(in, out);
-      else if (!strcmp("double", t))
-        streamIt<double>(in, out);
-      else if (!strcmp("uint64_t", t) || !strcmp("unsigned __int64", t) || !strcmp("unsigned long", t))
-        streamIt<uint64_t>(in, out);
-      else if (!strcmp("bool", t))
-        streamIt<bool>(in, out);
-      else if (std::string(t).find("string") != std::string::npos)
-        streamIt<std::string>(in, out);
-      else if (std::string(t).find("Angle") != std::string::npos)
-        streamIt<Angle>(in, out);
-      else
-        ASSERT(false);
-    }
-    else if (e != streamHandler.enumSpecification.end())
-    {
-      enumNames = &e->second;
+    case DebugDataType::enumeration:
+      enumNames = currentType->enumNames;
       streamIt<unsigned char>(in, out, &DebugDataStreamer::getName);
-    }
-    else
+      break;
+    case DebugDataType::charValue:
+      streamIt<char>(in, out);
+      break;
+    case DebugDataType::signedCharValue:
+      streamIt<signed char>(in, out);
+      break;
+    case DebugDataType::unsignedCharValue:
+      streamIt<unsigned char>(in, out);
+      break;
+    case DebugDataType::shortValue:
+      streamIt<short>(in, out);
+      break;
+    case DebugDataType::unsignedShortValue:
+      streamIt<unsigned short>(in, out);
+      break;
+    case DebugDataType::intValue:
+      streamIt<int>(in, out);
+      break;
+    case DebugDataType::unsignedValue:
+      streamIt<unsigned>(in, out);
+      break;
+    case DebugDataType::floatValue:
+      streamIt<float>(in, out);
+      break;
+    case DebugDataType::doubleValue:
+      streamIt<double>(in, out);
+      break;
+    case DebugDataType::uint64Value:
+      streamIt<uint64_t>(in, out);
+      break;
+    case DebugDataType::boolValue:
+      streamIt<bool>(in, out);
+      break;
+    case DebugDataType::stringValue:
+      streamIt<std::string>(in, out);
+      break;
+    case DebugDataType::angleValue:
+      streamIt<Angle>(in, out);
+      break;
+    default:
       ASSERT(false); // specification missing
   }
+  type = currentType;
 }
 
 const char* DebugDataStreamer::getName(int value)
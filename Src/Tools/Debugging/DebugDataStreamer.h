@@ -13,6 +13,42 @@
 
 class StreamHandler;
 
+/**
+ * The layout of a type as described by the specification in a stream handler.
+ * It is resolved once per type string, so that streaming data does not have to
+ * parse type names and look them up in the specification again.
+ */
+struct DebugDataType
+{
+  enum Kind
+  {
+    unknown, /**< The specification is missing. */
+    record,
+    staticArray,
+    dynamicArray,
+    enumeration,
+    charValue,
+    signedCharValue,
+    unsignedCharValue,
+    shortValue,
+    unsignedShortValue,
+    intValue,
+    unsignedValue,
+    floatValue,
+    doubleValue,
+    uint64Value,
+    boolValue,
+    stringValue,
+    angleValue
+  };
+
+  Kind kind = unknown;
+  std::vector<std::pair<const char*, const DebugDataType*>> fields; /**< The names and types of the fields of a record. */
+  const DebugDataType* element = nullptr; /**< The type of the elements of an array. */
+  unsigned size = 0; /**< The number of elements of a static array. */
+  const std::vector<const char*>* enumNames = nullptr; /**< The names of the constants of an enumeration. */
+};
+
 /**
  * A class that makes the debug data in a stream streamable according to the
  * Streamable interface. There are two different constructors. One creates
@@ -27,7 +63,7 @@ private:
   StreamHandler& streamHandler; /**< The stream handler that provides the specification of the data streamed. */
   In* inData = nullptr; /**< The debug data stream to read from. 0 if we are writing. */
   Out* outData = nullptr; /**< The debug data stream to write to. 0 if we are reading. */
-  std::string type; /**< The string representation of the type of the next data streamed. */
+  const DebugDataType* type; /**< The type of the next data streamed. */
   const char* name; /**< The name of the next entry streamed. 0 if it does not have a name, because it is an array element. */
   int index = -2; /**< The index of the next element streamed or -2 if we are currently not streaming an array. */
   static thread_local const std::vector<const char*>* enumNames; /**< Helper to provide element names for the enum currently streamed. */
@@ -46,6 +82,16 @@ private:
    */
   static const char* getName(int value);
 
+  /**
+   * Returns the layout of a type. It is resolved from the specification when the
+   * type is requested for the first time and is cached in the stream handler
+   * afterwards.
+   * @param streamHandler The stream handler that provides the specification.
+   * @param typeString The string representation of the type.
+   * @return The layout of the type. It is valid until the specification changes.
+   */
+  static const DebugDataType* resolve(StreamHandler& streamHandler, const std::string& typeString);
+
   /**
    * The method streams an entry.
    * @tparam T The type of the entry to be streamed.
@@ -151,13 +151,19 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
   return "unknown";
 }
 
+#ifdef DISABLE_DEBUG_DRAWINGS
+// Debug drawings are compiled out
+#define DEBUG_DRAWING(id, type) if (false)
+#define DECLARE_DEBUG_DRAWING(id, type) ((void)0)
+#define COMPLEX_DRAWING(id) if (false)
+#else
 /**
  * A macro that declares
  * @param id A drawing id
  * @param type A drawing type
  * and executes the following block if the drawing is requested.
  */
-#define DEBUG_DRAWING(id, type) if (Global::getDrawingManager().addDrawingId(id, type), _debugRequestActive("debug drawing:" id))
+#define DEBUG_DRAWING(id, type) if (static const DebugRequestTable::Slot _debugRequestSlot; Global::getDrawingManager().addDrawingId(id, type), _debugRequestActive("debug drawing:" id, _debugRequestSlot))
 
 /**
 * A macro that declares
@@ -176,6 +182,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  * @param id A drawing id
  */
 #define COMPLEX_DRAWING(id) DECLARED_DEBUG_RESPONSE("debug drawing:" id)
+#endif
 
 /**
  * A macro that sends a circle
@@ -191,7 +198,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define CIRCLE(id, center_x, center_y, radius, penWidth, penStyle, penColor, brushStyle, brushColor)                                                              \
   do                                                                                                                                                              \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                  \
+    COMPLEX_DRAWING(id)                                                                                                                                           \
     {                                                                                                                                                             \
       OUTPUT(idDebugDrawing,                                                                                                                                      \
           bin,                                                                                                                                                    \
@@ -216,7 +223,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define ARC(id, center_x, center_y, radius, startAngle, spanAngle, penWidth, penStyle, penColor, brushStyle, brushColor)                                                                 \
   do                                                                                                                                                                                     \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                         \
+    COMPLEX_DRAWING(id)                                                                                                                                                                  \
     {                                                                                                                                                                                    \
       OUTPUT(idDebugDrawing,                                                                                                                                                             \
           bin,                                                                                                                                                                           \
@@ -240,7 +247,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define ELLIPSE(id, center, radiusX, radiusY, rotation, penWidth, penStyle, penColor, brushStyle, brushColor)                                                          \
   do                                                                                                                                                                   \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                       \
+    COMPLEX_DRAWING(id)                                                                                                                                                \
     {                                                                                                                                                                  \
       OUTPUT(idDebugDrawing,                                                                                                                                           \
           bin,                                                                                                                                                         \
@@ -262,7 +269,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define RECTANGLE2(id, topLeft, width, height, rotation, penWidth, penStyle, penColor, brushStyle, brushColor)                                                         \
   do                                                                                                                                                                   \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                       \
+    COMPLEX_DRAWING(id)                                                                                                                                                \
     {                                                                                                                                                                  \
       OUTPUT(idDebugDrawing,                                                                                                                                           \
           bin,                                                                                                                                                         \
@@ -284,7 +291,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define POLYGON(id, numberOfPoints, points, penWidth, penStyle, penColor, brushStyle, brushColor)                                                              \
   do                                                                                                                                                           \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                               \
+    COMPLEX_DRAWING(id)                                                                                                                                        \
     {                                                                                                                                                          \
       OutTextSize _size;                                                                                                                                       \
       for (int _i = 0; _i < numberOfPoints; ++_i)                                                                                                              \
@@ -335,7 +342,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define GRID_RGBA(id, x, y, cellSize, cellsX, cellsY, cells)                                                                                                                                  \
   do                                                                                                                                                                                          \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                              \
+    COMPLEX_DRAWING(id)                                                                                                                                                                       \
     {                                                                                                                                                                                         \
       OutTextSize _size;                                                                                                                                                                      \
       for (int _i = 0; _i < (cellsX * cellsY); ++_i)                                                                                                                                          \
@@ -363,7 +370,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define GRID_MONO(id, x, y, cellSize, cellsX, cellsY, baseColor, cells)                                                                                                                       \
   do                                                                                                                                                                                          \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                              \
+    COMPLEX_DRAWING(id)                                                                                                                                                                       \
     {                                                                                                                                                                                         \
       OutTextSize _size;                                                                                                                                                                      \
       for (int _i = 0; _i < (cellsX * cellsY); ++_i)                                                                                                                                          \
@@ -390,7 +397,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define DOT(id, x, y, penColor, brushColor)                                                                                                                                           \
   do                                                                                                                                                                                  \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                      \
+    COMPLEX_DRAWING(id)                                                                                                                                                               \
     {                                                                                                                                                                                 \
       OUTPUT(idDebugDrawing, bin, (char)Drawings::dot << (char)Global::getDrawingManager().getDrawingId(id) << (int)(x) << (int)(y) << ColorRGBA(penColor) << ColorRGBA(brushColor)); \
     }                                                                                                                                                                                 \
@@ -405,7 +412,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define DOT_AS_VECTOR(id, xy, penColor, brushColor)                                                                                                                                             \
   do                                                                                                                                                                                            \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                                \
+    COMPLEX_DRAWING(id)                                                                                                                                                                         \
     {                                                                                                                                                                                           \
       OUTPUT(idDebugDrawing, bin, (char)Drawings::dot << (char)Global::getDrawingManager().getDrawingId(id) << (int)(xy.x()) << (int)(xy.y()) << ColorRGBA(penColor) << ColorRGBA(brushColor)); \
     }                                                                                                                                                                                           \
@@ -421,7 +428,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define MID_DOT(id, x, y, penColor, brushColor)                                                                                                                                          \
   do                                                                                                                                                                                     \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                         \
+    COMPLEX_DRAWING(id)                                                                                                                                                                  \
     {                                                                                                                                                                                    \
       OUTPUT(idDebugDrawing, bin, (char)Drawings::midDot << (char)Global::getDrawingManager().getDrawingId(id) << (int)(x) << (int)(y) << ColorRGBA(penColor) << ColorRGBA(brushColor)); \
     }                                                                                                                                                                                    \
@@ -437,7 +444,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define LARGE_DOT(id, x, y, penColor, brushColor)                                                                                                                                          \
   do                                                                                                                                                                                       \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                           \
+    COMPLEX_DRAWING(id)                                                                                                                                                                    \
     {                                                                                                                                                                                      \
       OUTPUT(idDebugDrawing, bin, (char)Drawings::largeDot << (char)Global::getDrawingManager().getDrawingId(id) << (int)(x) << (int)(y) << ColorRGBA(penColor) << ColorRGBA(brushColor)); \
     }                                                                                                                                                                                      \
@@ -456,7 +463,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define LINE(id, x1, y1, x2, y2, penWidth, penStyle, penColor)                                                                                                                                            \
   do                                                                                                                                                                                                      \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                                          \
+    COMPLEX_DRAWING(id)                                                                                                                                                                                   \
     {                                                                                                                                                                                                     \
       OUTPUT(idDebugDrawing,                                                                                                                                                                              \
           bin,                                                                                                                                                                                            \
@@ -477,7 +484,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define ARROW(id, x1, y1, x2, y2, penWidth, penStyle, penColor)                                                                                                                                            \
   do                                                                                                                                                                                                       \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                                           \
+    COMPLEX_DRAWING(id)                                                                                                                                                                                    \
     {                                                                                                                                                                                                      \
       OUTPUT(idDebugDrawing,                                                                                                                                                                               \
           bin,                                                                                                                                                                                             \
@@ -620,7 +627,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define DRAWTEXT(id, x, y, fontSize, color, txt)                                                                                                                                          \
   do                                                                                                                                                                                      \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                                          \
+    COMPLEX_DRAWING(id)                                                                                                                                                                   \
     {                                                                                                                                                                                     \
       OutTextRawSize _size;                                                                                                                                                               \
       _size << txt;                                                                                                                                                                       \
@@ -642,7 +649,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define ORIGIN(id, x, y, angle)                                                                                                                            \
   do                                                                                                                                                       \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                           \
+    COMPLEX_DRAWING(id)                                                                                                                                    \
     {                                                                                                                                                      \
       OUTPUT(idDebugDrawing, bin, (char)Drawings::origin << (char)Global::getDrawingManager().getDrawingId(id) << (int)(x) << (int)(y) << (float)(angle)); \
     }                                                                                                                                                      \
@@ -658,7 +665,7 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  */
 #define TIP(id, center_x, center_y, radius, text)                                                                                                                            \
   do                                                                                                                                                                         \
-    DECLARED_DEBUG_RESPONSE("debug drawing:" id)                                                                                                                             \
+    COMPLEX_DRAWING(id)                                                                                                                                                      \
     {                                                                                                                                                                        \
       OutTextRawSize _size;                                                                                                                                                  \
       _size << text;                                                                                                                                                         \
@@ -730,16 +737,28 @@ inline const char* DrawingManager::getTypeName(char id, char processIdentifier)
  * @param id The name of the plot.
  * @param value The value to be plotted.
  */
+#ifdef DISABLE_PLOTS
+#define PLOT(id, value) \
+  do                    \
+    if (false)          \
+      (void)(value);    \
+  while (false)
+#else
 #define PLOT(id, value)                                                   \
   do                                                                      \
     DEBUG_RESPONSE("plot:" id) OUTPUT(idPlot, bin, id << (float)(value)); \
   while (false)
+#endif
 
 /**
  * A macro that declares a pollable plot.
  * @param id The name of the plot.
  */
+#ifdef DISABLE_PLOTS
+#define DECLARE_PLOT(id) ((void)0)
+#else
 #define DECLARE_PLOT(id) DECLARE_DEBUG_RESPONSE("plot:" id)
+#endif
 
 /**
  * A macro that creates three plots for the three axis of a vector3
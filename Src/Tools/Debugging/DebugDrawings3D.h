@@ -44,6 +44,12 @@ class DrawingManager3D : public DrawingManager
 {
 };
 
+#ifdef DISABLE_DEBUG_DRAWINGS
+// Debug drawings are compiled out
+#define DEBUG_DRAWING3D(id, type) if (false)
+#define DECLARE_DEBUG_DRAWING3D(id, type) ((void)0)
+#define COMPLEX_DRAWING3D(id) if (false)
+#else
 /**
  * A macro that declares.
  * @param id A drawing id.
@@ -51,7 +57,7 @@ class DrawingManager3D : public DrawingManager
  *             robot part named in the scene description file).
  * and executes the following block if the drawing is requested.
  */
-#define DEBUG_DRAWING3D(id, type) if (Global::getDrawingManager3D().addDrawingId(id, type), _debugRequestActive("debug drawing 3d:" id))
+#define DEBUG_DRAWING3D(id, type) if (static const DebugRequestTable::Slot _debugRequestSlot; Global::getDrawingManager3D().addDrawingId(id, type), _debugRequestActive("debug drawing 3d:" id, _debugRequestSlot))
 
 /**
  * A macro that declares.
@@ -70,6 +76,7 @@ class DrawingManager3D : public DrawingManager
  * Complex drawings should be encapsuled by this macro.
  */
 #define COMPLEX_DRAWING3D(id) DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)
+#endif
 
 /**
  * A macro that adds a line to a drawing.
@@ -85,7 +92,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define LINE3D(id, fromX, fromY, fromZ, toX, toY, toZ, size, color)                                                                                                            \
   do                                                                                                                                                                           \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                            \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                      \
     {                                                                                                                                                                          \
       OUTPUT(idDebugDrawing3D,                                                                                                                                                 \
           bin,                                                                                                                                                                 \
@@ -144,7 +151,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define QUAD3D(id, corner1, corner2, corner3, corner4, color)                                                                                                                                      \
   do                                                                                                                                                                                               \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                                                \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                                          \
     {                                                                                                                                                                                              \
       OUTPUT(idDebugDrawing3D,                                                                                                                                                                     \
           bin,                                                                                                                                                                                     \
@@ -161,7 +168,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define CUBE3D(id, a, b, c, d, e, f, g, h, size, color)                                                                                                                            \
   do                                                                                                                                                                               \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                                \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                          \
     {                                                                                                                                                                              \
       OUTPUT(idDebugDrawing3D,                                                                                                                                                     \
           bin,                                                                                                                                                                     \
@@ -178,7 +185,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define COORDINATES3D(id, length, width)                                                                                                                         \
   do                                                                                                                                                             \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                              \
+    COMPLEX_DRAWING3D(id)                                                                                                                                        \
     {                                                                                                                                                            \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::coordinates << (char)Global::getDrawingManager3D().getDrawingId(id) << (float)(length) << (float)(width)); \
     }                                                                                                                                                            \
@@ -206,7 +213,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define SCALE3D(id, x, y, z)                                                                                                                                    \
   do                                                                                                                                                            \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                             \
+    COMPLEX_DRAWING3D(id)                                                                                                                                       \
     {                                                                                                                                                           \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::scale << (char)Global::getDrawingManager3D().getDrawingId(id) << (float)(x) << (float)(y) << (float)(z)); \
     }                                                                                                                                                           \
@@ -222,7 +229,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define ROTATE3D(id, x, y, z)                                                                                                                                    \
   do                                                                                                                                                             \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                              \
+    COMPLEX_DRAWING3D(id)                                                                                                                                        \
     {                                                                                                                                                            \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::rotate << (char)Global::getDrawingManager3D().getDrawingId(id) << (float)(x) << (float)(y) << (float)(z)); \
     }                                                                                                                                                            \
@@ -238,7 +245,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define TRANSLATE3D(id, x, y, z)                                                                                                                                    \
   do                                                                                                                                                                \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                 \
+    COMPLEX_DRAWING3D(id)                                                                                                                                           \
     {                                                                                                                                                               \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::translate << (char)Global::getDrawingManager3D().getDrawingId(id) << (float)(x) << (float)(y) << (float)(z)); \
     }                                                                                                                                                               \
@@ -255,7 +262,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define POINT3D(id, x, y, z, size, color)                                                                                                                                                                 \
   do                                                                                                                                                                                                      \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                                                       \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                                                 \
     {                                                                                                                                                                                                     \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::dot << (char)Global::getDrawingManager3D().getDrawingId(id) << (float)(x) << (float)(y) << (float)(z) << (float)size << ColorRGBA(color) << false); \
     }                                                                                                                                                                                                     \
@@ -272,7 +279,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define SPHERE3D(id, x, y, z, radius, color)                                                                                                                                                            \
   do                                                                                                                                                                                                    \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                                                     \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                                               \
     {                                                                                                                                                                                                   \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::sphere << (char)Global::getDrawingManager3D().getDrawingId(id) << (float)(x) << (float)(y) << (float)(z) << (float)(radius) << ColorRGBA(color)); \
     }                                                                                                                                                                                                   \
@@ -287,7 +294,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define ELLIPSOID3D(id, p, r, color)                                                                                                         \
   do                                                                                                                                         \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                          \
+    COMPLEX_DRAWING3D(id)                                                                                                                    \
     {                                                                                                                                        \
       OUTPUT(idDebugDrawing3D, bin, (char)Drawings3D::ellipsoid << (char)Global::getDrawingManager3D().getDrawingId(id) << p << r << color); \
     }                                                                                                                                        \
@@ -308,7 +315,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define CYLINDER3D(id, x, y, z, a, b, c, radius, height, color)                                                                                                                  \
   do                                                                                                                                                                             \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                              \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                        \
     {                                                                                                                                                                            \
       OUTPUT(idDebugDrawing3D,                                                                                                                                                   \
           bin,                                                                                                                                                                   \
@@ -333,7 +340,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define CYLINDER3D2(id, x, y, z, a, b, c, baseRadius, topRadius, height, color)                                                                                                  \
   do                                                                                                                                                                             \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                              \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                        \
     {                                                                                                                                                                            \
       OUTPUT(idDebugDrawing3D,                                                                                                                                                   \
           bin,                                                                                                                                                                   \
@@ -438,7 +445,7 @@ class DrawingManager3D : public DrawingManager
       rx = (forward.y() != 0.f || forward.z() != 0.f) ? -std::atan2(forward.y(), forward.z()) : 0.f;                                                                                        \
       float d = std::sqrt(forward.z() * forward.z() + forward.y() * forward.y());                                                                                                           \
       ry = (forward.x() != 0.f || d != 0.f) ? std::atan2(forward.x(), d) : 0.f;                                                                                                             \
-      DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                                       \
+      COMPLEX_DRAWING3D(id)                                                                                                                                                                 \
       {                                                                                                                                                                                     \
         OUTPUT(idDebugDrawing3D,                                                                                                                                                            \
             bin,                                                                                                                                                                            \
@@ -491,7 +498,7 @@ class DrawingManager3D : public DrawingManager
  */
 #define IMAGE3D(id, x, y, z, a, b, c, width, height, i)                                                                                                                       \
   do                                                                                                                                                                          \
-    DECLARED_DEBUG_RESPONSE("debug drawing 3d:" id)                                                                                                                           \
+    COMPLEX_DRAWING3D(id)                                                                                                                                                     \
     {                                                                                                                                                                         \
       OUTPUT(idDebugDrawing3D,                                                                                                                                                \
           bin,                                                                                                                                                                \
@@ -0,0 +1,80 @@
+/**
+ * @file Tools/Debugging/DebugImageStreamer.cpp
+ *
+ * Implementation of a class that sends debug images in the resolution, region,
+ * format and rate requested by the PC.
+ */
+
+#include "DebugImageStreamer.h"
+#include "Platform/SystemCall.h"
+#include "Representations/Infrastructure/JPEGImage.h"
+#include "Tools/Debugging/Debugging.h"
+#include "Tools/Debugging/Modify.h"
+#include <algorithm>
+
+void DebugImageStreamer::send(const char* id, const Image& image)
+{
+  // the debug queues and the debug data table belong to the thread
+  static thread_local DebugImageStreamer streamer;
+  Parameters& parameters = streamer.parameters;
+  MODIFY("debug images:streaming", parameters);
+  Stream& stream = streamer.streams[id];
+
+  // an encoded image is sent as soon as it is ready
+  if (stream.encoded.valid() && stream.encoded.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+  {
+    const std::unique_ptr<JPEGImage> jpegImage = stream.encoded.get();
+    OUTPUT(idDebugJPEGImage, bin, id << *jpegImage);
+  }
+
+  if (parameters.maxRate > 0.f && stream.lastSent && SystemCall::getTimeSince(stream.lastSent) < static_cast<int>(1000.f / parameters.maxRate))
+    return;
+
+  const bool reduced = parameters.downscale > 1 || parameters.regionMax != Vector2i::Zero();
+  if (parameters.format == Parameters::raw)
+  {
+    stream.lastSent = SystemCall::getCurrentSystemTime();
+    if (reduced)
+      OUTPUT(idDebugImage, bin, id << *reduce(image, parameters, false));
+    else
+      OUTPUT(idDebugImage, bin, id << image);
+  }
+  else if (!stream.encoded.valid())
+  {
+    stream.lastSent = SystemCall::getCurrentSystemTime();
+    std::shared_ptr<Image> source = reduce(image, parameters, parameters.format == Parameters::gray);
+    stream.encoded = std::async(std::launch::async,
+        [source, quality = parameters.quality]
+        {
+          std::unique_ptr<JPEGImage> jpegImage = std::make_unique<JPEGImage>();
+          jpegImage->fromImage(*source, quality);
+          return jpegImage;
+        });
+  }
+}
+
+std::unique_ptr<Image> DebugImageStreamer::reduce(const Image& image, const Parameters& parameters, bool gray)
+{
+  const int step = std::max(parameters.downscale, 1);
+  const int xMin = std::clamp(parameters.regionMin.x(), 0, image.width);
+  const int yMin = std::clamp(parameters.regionMin.y(), 0, image.height);
+  const int xMax = parameters.regionMax == Vector2i::Zero() ? image.width : std::clamp(parameters.regionMax.x(), xMin, image.width);
+  const int yMax = parameters.regionMax == Vector2i::Zero() ? image.height : std::clamp(parameters.regionMax.y(), yMin, image.height);
+
+  std::unique_ptr<Image> result = std::make_unique<Image>(false, (xMax - xMin + step - 1) / step, (yMax - yMin + step - 1) / step);
+  result->timeStamp = image.timeStamp;
+  result->imageSource = image.imageSource;
+  for (int y = 0; y < result->height; ++y)
+  {
+    const Image::Pixel* src = image[yMin + y * step] + xMin;
+    Image::Pixel* dest = (*result)[y];
+    for (int x = 0; x < result->width; ++x, src += step)
+    {
+      *dest = *src;
+      if (gray)
+        dest->cb = dest->cr = 128;
+      ++dest;
+    }
+  }
+  return result;
+}
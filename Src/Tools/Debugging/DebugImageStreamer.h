@@ -0,0 +1,69 @@
+/**
+ * @file Tools/Debugging/DebugImageStreamer.h
+ *
+ * Declaration of a class that sends debug images in the resolution, region,
+ * format and rate requested by the PC.
+ */
+
+#pragma once
+
+#include "Tools/Math/Eigen.h"
+#include "Tools/Streams/AutoStreamable.h"
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+struct Image;
+struct JPEGImage;
+
+/**
+ * Sends the debug images of a thread. The PC negotiates how they are sent by
+ * modifying "debug images:streaming". Compressed formats are encoded in the
+ * background and sent in one of the following frames, so that encoding does
+ * not delay the thread.
+ */
+class DebugImageStreamer
+{
+public:
+  STREAMABLE(Parameters,
+    ENUM(Format,
+      raw, /**< Uncompressed YCbCr. */
+      gray, /**< JPEG-compressed luminance. */
+      jpeg /**< JPEG-compressed YCbCr. */
+    ),
+    (Format)(raw) format,
+    (int)(1) downscale, /**< Only every n-th pixel of every n-th row of the region is sent. */
+    (Vector2i)(Vector2i::Zero()) regionMin, /**< The upper left corner of the region sent (inclusive). */
+    (Vector2i)(Vector2i::Zero()) regionMax, /**< The lower right corner of the region sent (exclusive, zero = whole image). */
+    (float)(0.f) maxRate, /**< The maximum number of images sent per second and id (0 = every frame). */
+    (int)(75) quality /**< The JPEG quality (0...100). */
+  );
+
+  /**
+   * Sends a debug image according to the parameters negotiated.
+   * @param id The id of the debug image.
+   * @param image The debug image.
+   */
+  static void send(const char* id, const Image& image);
+
+private:
+  /** The state of sending the images of one id. */
+  struct Stream
+  {
+    unsigned lastSent = 0; /**< When was the last image of this id sent or its encoding started? */
+    std::future<std::unique_ptr<JPEGImage>> encoded; /**< The image currently encoded in the background. */
+  };
+
+  /**
+   * Copies the region of an image, downscaling it.
+   * @param image The image.
+   * @param parameters The region and the downscaling factor.
+   * @param gray Set the chroma channels to neutral?
+   * @return The reduced image.
+   */
+  static std::unique_ptr<Image> reduce(const Image& image, const Parameters& parameters, bool gray);
+
+  Parameters parameters;
+  std::unordered_map<std::string, Stream> streams; /**< The state per debug image id. */
+};
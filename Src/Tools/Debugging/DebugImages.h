@@ -7,9 +7,22 @@
  */
 
 #pragma once
+#include "Tools/Debugging/DebugImageStreamer.h"
 #include "Tools/Debugging/Debugging.h"
 #include "Tools/Math/Geometry.h"
 
+#ifdef DISABLE_DEBUG_IMAGES
+// Debug images are compiled out
+#define COMPLEX_IMAGE(id) if (false)
+#define DECLARED_COMPLEX_IMAGE(id) if (false)
+#else
+/** Generate debug image debug request, can be used for encapsulating the creation of debug images on request */
+#define COMPLEX_IMAGE(id) DEBUG_RESPONSE("debug images:" #id)
+
+/** Like COMPLEX_IMAGE, but the debug request is not pollable. */
+#define DECLARED_COMPLEX_IMAGE(id) DECLARED_DEBUG_RESPONSE("debug images:" #id)
+#endif
+
 /**
  * Declares a debug image
  * @param id An image id
@@ -47,7 +60,7 @@
  * @param id An image id
  * @param image The Image.
  */
-#define INIT_DEBUG_IMAGE(id, image) DECLARED_DEBUG_RESPONSE("debug images:" #id) id##Image = image
+#define INIT_DEBUG_IMAGE(id, image) DECLARED_COMPLEX_IMAGE(id) id##Image = image
 
 /**
  * Sets the width and height of a debug image
@@ -63,7 +76,7 @@
  */
 #define INIT_DEBUG_IMAGE_BLACK(id, rwidth, rheight) \
   do                                                \
-    DECLARED_DEBUG_RESPONSE("debug images:" #id)    \
+    DECLARED_COMPLEX_IMAGE(id)                      \
     {                                               \
       id##Image.setResolution(rwidth, rheight);     \
       for (int y = 0; y < id##Image.height; y++)    \
@@ -72,16 +85,19 @@
     }                                               \
   while (false)
 
-/**Sends the debug image with the specified id */
-#define SEND_DEBUG_IMAGE(id)                                                         \
-  do                                                                                 \
-    DEBUG_RESPONSE("debug images:" #id) OUTPUT(idDebugImage, bin, #id << id##Image); \
+/**
+ * Sends the debug image with the specified id. The resolution, region, format
+ * and rate are negotiated through "debug images:streaming".
+ */
+#define SEND_DEBUG_IMAGE(id)                                    \
+  do                                                            \
+    COMPLEX_IMAGE(id) DebugImageStreamer::send(#id, id##Image); \
   while (false)
 
 /**Sends the debug image with the specified id as jpeg encoded image */
 #define SEND_DEBUG_IMAGE_AS_JPEG(id)               \
   do                                               \
-    DEBUG_RESPONSE("debug images:" #id)            \
+    COMPLEX_IMAGE(id)                              \
     {                                              \
       JPEGImage* temp = new JPEGImage(id##Image);  \
       OUTPUT(idDebugJPEGImage, bin, #id << *temp); \
@@ -122,10 +138,6 @@
 #define DEBUG_IMAGE_SET_PIXEL_PINK_AS_VECTOR(id, xy) DEBUG_IMAGE_SET_PIXEL_YUV_AS_VECTOR(id, xy, 255, 255, 255)
 #define DEBUG_IMAGE_SET_PIXEL_DARK_BLUE_AS_VECTOR(id, xy) DEBUG_IMAGE_SET_PIXEL_YUV_AS_VECTOR(id, xy, 100, 0, 255)
 
-// all
-/** Generate debug image debug request, can be used for encapsulating the creation of debug images on request */
-#define COMPLEX_IMAGE(id) DEBUG_RESPONSE("debug images:" #id)
-
 /**
  * Fill a triangle inside the specified debug image with the specified color
  * @param x1, y1, x2, y2, x3, y3 the three points of the triangle
@@ -9,12 +9,13 @@
 #include "DebugRequest.h"
 #include "Platform/BHAssert.h"
 
+std::atomic<int> DebugRequestTable::Slot::numOfSlots(0);
+
 DebugRequest::DebugRequest(const std::string& description, bool enable) : description(description), enable(enable) {}
 
 void DebugRequestTable::addRequest(const DebugRequest& debugRequest, bool force)
 {
-  lastName = 0;
-  nameToIndex.clear();
+  ++version;
   if (debugRequest.description == "poll")
   {
     poll = true;
@@ -46,8 +47,7 @@ void DebugRequestTable::addRequest(const DebugRequest& debugRequest, bool force)
 
 void DebugRequestTable::disable(const char* name)
 {
-  lastName = 0;
-  nameToIndex.clear();
+  ++version;
   for (int i = 0; i < currentNumberOfDebugRequests; i++)
     if (debugRequests[i].description == name)
     {
@@ -57,6 +57,31 @@ void DebugRequestTable::disable(const char* name)
     }
 }
 
+bool DebugRequestTable::isActive(const char* name) const
+{
+  for (int i = 0; i < currentNumberOfDebugRequests; ++i)
+    if (debugRequests[i].description == name)
+      return debugRequests[i].enable;
+  return false;
+}
+
+bool DebugRequestTable::resolve(const char* name, const Slot& slot) const
+{
+  if (static_cast<size_t>(slot.id) >= resolvedSlots.size())
+    resolvedSlots.resize(slot.id + 1);
+  ResolvedSlot& resolvedSlot = resolvedSlots[slot.id];
+  resolvedSlot.name = name;
+  resolvedSlot.index = -1;
+  resolvedSlot.version = version;
+  for (int i = 0; i < currentNumberOfDebugRequests; ++i)
+    if (debugRequests[i].description == name)
+    {
+      resolvedSlot.index = i;
+      return debugRequests[i].enable;
+    }
+  return false;
+}
+
 bool DebugRequestTable::notYetPolled(const char* name)
 {
   for (int i = 0; i < alreadyPolledDebugRequestCounter; ++i)
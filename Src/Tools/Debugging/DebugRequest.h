@@ -8,8 +8,9 @@
 #pragma once
 
 #include "Tools/Streams/InOut.h"
-#include <unordered_map>
+#include <atomic>
 #include <unordered_set>
+#include <vector>
 
 class Framework;
 class ModuleManager;
@@ -56,6 +57,21 @@ private:
   };
 
 public:
+  /**
+   * Every call site of the debug request macros owns a static slot. Since all threads and
+   * robots share these call sites, the slot only provides a unique number. Each table
+   * remembers for each number which of its requests it refers to.
+   */
+  struct Slot
+  {
+    const int id; /**< The unique number of this slot. */
+
+    Slot() : id(numOfSlots++) {}
+
+  private:
+    static std::atomic<int> numOfSlots; /**< The number of slots created so far. */
+  };
+
   /** The Debug Key Table */
   DebugRequest debugRequests[maxNumberOfDebugRequests];
   int currentNumberOfDebugRequests = 0;
@@ -67,14 +83,21 @@ public:
 
   const char* alreadyPolledDebugRequests[maxNumberOfDebugRequests];
   int alreadyPolledDebugRequestCounter = 0;
-  mutable const char* lastName = nullptr;
-
-  mutable int lastIndex = 0;
-  mutable std::unordered_map<const char*, int> nameToIndex;
 
   friend class Framework;
 
 private:
+  /** The debug request a slot was resolved to. */
+  struct ResolvedSlot
+  {
+    const char* name = nullptr; /**< The name the slot was resolved for. */
+    int index = -1; /**< The index of the request in the table or -1 if it is not in the table. */
+    unsigned version = 0; /**< The version of the table the slot was resolved for. */
+  };
+
+  unsigned version = 1; /**< Is increased whenever the indices of the requests might have changed. */
+  mutable std::vector<ResolvedSlot> resolvedSlots; /**< The requests the slots were resolved to, indexed by their ids. */
+
   friend class Process;
   friend class SubThread;
   friend class RobotConsole;
@@ -101,33 +124,41 @@ public:
   void propagateDisabledRequests(DebugRequestTable& drt);
   void clearDisabledRequests();
   bool isActive(const char* name) const;
+
+  /**
+   * Checks whether a debug request is active. After the first call, this only costs a
+   * few comparisons as long as the table does not change.
+   * @param name The name of the debug request.
+   * @param slot The slot of the call site.
+   * @return Is it active?
+   */
+  bool isActive(const char* name, const Slot& slot) const;
+
   void disable(const char* name);
   bool notYetPolled(const char* name);
-  void removeAllRequests() { currentNumberOfDebugRequests = 0; }
+  void removeAllRequests()
+  {
+    currentNumberOfDebugRequests = 0;
+    ++version;
+  }
+
+private:
+  /**
+   * Searches the table for a debug request and remembers the result for a slot.
+   * @param name The name of the debug request.
+   * @param slot The slot of the call site.
+   * @return Is it active?
+   */
+  bool resolve(const char* name, const Slot& slot) const;
 };
 
-inline bool DebugRequestTable::isActive(const char* name) const
+inline bool DebugRequestTable::isActive(const char* name, const Slot& slot) const
 {
-  if (name == lastName)
-    return lastIndex < currentNumberOfDebugRequests && debugRequests[lastIndex].enable;
-  else if (currentNumberOfDebugRequests == 0)
-    return false;
-  else
+  if (static_cast<size_t>(slot.id) < resolvedSlots.size())
   {
-    lastName = name;
-    std::unordered_map<const char*, int>::const_iterator iter = nameToIndex.find(name);
-    if (iter != nameToIndex.end())
-    {
-      lastIndex = iter->second;
-      return lastIndex < currentNumberOfDebugRequests && debugRequests[lastIndex].enable;
-    }
-    for (lastIndex = 0; lastIndex < currentNumberOfDebugRequests; ++lastIndex)
-      if (debugRequests[lastIndex].description == name)
-      {
-        nameToIndex[name] = lastIndex;
-        return debugRequests[lastIndex].enable;
-      }
-    nameToIndex[name] = lastIndex;
-    return false;
+    const ResolvedSlot& resolvedSlot = resolvedSlots[slot.id];
+    if (resolvedSlot.version == version && resolvedSlot.name == name)
+      return resolvedSlot.index >= 0 && debugRequests[resolvedSlot.index].enable;
   }
+  return resolve(name, slot);
 }
@@ -118,13 +118,14 @@
 /**
  * Register debug request if required and check whether it is active.
  * @param id The name of the debug request.
+ * @param slot The slot of the call site.
  * @return Is it active?
  */
-inline bool _debugRequestActive(const char* id)
+inline bool _debugRequestActive(const char* id, const DebugRequestTable::Slot& slot)
 {
   if (Global::getDebugRequestTable().poll && Global::getDebugRequestTable().notYetPolled(id))
-    OUTPUT(idDebugResponse, text, id << Global::getDebugRequestTable().isActive(id));
-  return Global::getDebugRequestTable().isActive(id);
+    OUTPUT(idDebugResponse, text, id << Global::getDebugRequestTable().isActive(id, slot));
+  return Global::getDebugRequestTable().isActive(id, slot);
 }
 
 /**
@@ -140,25 +141,27 @@ inline bool _debugRequestActive(const char* id)
 
 /**
  * A debugging switch, allowing the enabling or disabling of the following block.
+ * Each expansion owns a static slot, which the debug request tables use to cache where
+ * they found the request.
  * @param id The id of the debugging switch
  */
-#define DEBUG_RESPONSE(id) if (_debugRequestActive(id))
+#define DEBUG_RESPONSE(id) if (static const DebugRequestTable::Slot _debugRequestSlot; _debugRequestActive(id, _debugRequestSlot))
 
 /**
  * A debugging switch, allowing the non-recurring execution of the following block.
  * @param id The id of the debugging switch
  */
-#define DEBUG_RESPONSE_ONCE(id) if (_debugRequestActive(id) && (Global::getDebugRequestTable().disable(id), true))
+#define DEBUG_RESPONSE_ONCE(id) if (static const DebugRequestTable::Slot _debugRequestSlot; _debugRequestActive(id, _debugRequestSlot) && (Global::getDebugRequestTable().disable(id), true))
 
 /**
  * A debugging switch, allowing the enabling or disabling of the block that follows.
  * @param id The id of the debugging switch
  */
-#define DEBUG_RESPONSE_NOT(id) if (!_debugRequestActive(id))
+#define DEBUG_RESPONSE_NOT(id) if (static const DebugRequestTable::Slot _debugRequestSlot; !_debugRequestActive(id, _debugRequestSlot))
 
 /**
  * Execute following block if debug request is active.
  * The request is not pollable.
  */
-#define DECLARED_DEBUG_RESPONSE(id) if (Global::getDebugRequestTable().isActive(id))
+#define DECLARED_DEBUG_RESPONSE(id) if (static const DebugRequestTable::Slot _debugRequestSlot; Global::getDebugRequestTable().isActive(id, _debugRequestSlot))
 #endif // TARGET_TOOL
@@ -35,7 +35,19 @@ bool TcpConnection::sendAndReceive(const unsigned char* dataToSend, int sendSize
   ASSERT(tcpComm);
   bool connectedBefore = isConnected();
   readSize = receive(dataRead);
+  return sendAfterReceive(dataToSend, sendSize, connectedBefore, readSize);
+}
 
+bool TcpConnection::sendAndReceive(const unsigned char* dataToSend, int sendSize, std::vector<unsigned char>& dataRead, int& readSize)
+{
+  ASSERT(tcpComm);
+  bool connectedBefore = isConnected();
+  readSize = receive(dataRead);
+  return sendAfterReceive(dataToSend, sendSize, connectedBefore, readSize);
+}
+
+bool TcpConnection::sendAfterReceive(const unsigned char* dataToSend, int sendSize, bool connectedBefore, int readSize)
+{
   if (handshake == sender && ((readSize > 0 && !sendSize) || (!connectedBefore && isConnected())))
   {
     // we have received a package, but we don't want to send one now.
@@ -46,8 +58,10 @@ bool TcpConnection::sendAndReceive(const unsigned char* dataToSend, int sendSize
   // Try to send data
   if ((handshake != receiver || ack) && isConnected() && sendSize > 0)
   {
-    if (tcpComm->send((unsigned char*)&sendSize, sizeof(sendSize)) && // sends size of block
-        tcpComm->send(dataToSend, sendSize)) // sends data
+    // sends the size of the block and the data at once
+    const unsigned char* buffers[] = {reinterpret_cast<const unsigned char*>(&sendSize), dataToSend};
+    const int sizes[] = {static_cast<int>(sizeof(sendSize)), sendSize};
+    if (tcpComm->send(buffers, sizes, 2))
     {
       ack = false;
       return true;
@@ -98,3 +112,34 @@ int TcpConnection::receive(unsigned char*& buffer)
   else
     return 0; // nothing read, but ok
 }
+
+int TcpConnection::receive(std::vector<unsigned char>& buffer)
+{
+  int size;
+  if (tcpComm->receive((unsigned char*)&size, sizeof(size), false))
+  {
+    if (size == 0)
+    {
+      ack = true;
+      return 0; // nothing to read (maybe heartbeat)
+    }
+    else
+    {
+      // prevent from allocating to much buffer
+      if (size > MAX_PACKAGE_SIZE)
+        return -1;
+
+      if (buffer.size() < static_cast<size_t>(size))
+        buffer.resize(size);
+      if (!tcpComm->receive(buffer.data(), size, true)) // read complete package (wait and read size bytes)
+        return -1; // error
+      else
+      {
+        ack = true;
+        return size; // package received
+      }
+    }
+  }
+  else
+    return 0; // nothing read, but ok
+}
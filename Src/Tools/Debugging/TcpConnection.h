@@ -9,6 +9,7 @@
 #pragma once
 
 #include "Tools/Network/TcpComm.h"
+#include <vector>
 
 #define MAX_PACKAGE_SIZE 67108864 // max package size that can be received. prevent from allocating too much buffer (max ~64 MB)
 
@@ -87,6 +88,18 @@ public:
   */
   bool sendAndReceive(const unsigned char* dataToSend, int sendSize, unsigned char*& dataRead, int& readSize);
 
+  /**
+  * The function sends and receives data. A package received is written to a
+  * buffer of the caller, which is only enlarged if the package does not fit.
+  * @param dataToSend The data to be send. The function will not free the buffer.
+  * @param sendSize The size of data to send. If 0, no data is sent.
+  * @param dataRead The buffer the data read is written to.
+  * @param readSize The size of the block read. The buffer only contains
+  *                 a package if this parameter is positive after the call.
+  * @return Returns true if the data has been sent.
+  */
+  bool sendAndReceive(const unsigned char* dataToSend, int sendSize, std::vector<unsigned char>& dataRead, int& readSize);
+
   /**
   * The function states whether the connection is still established.
   * @return Does the connection still exist?
@@ -127,4 +140,22 @@ private:
    *         > 0: success, size of data, and buffer points to data.
    */
   int receive(unsigned char*& buffer);
+
+  /**
+   * The function tries to receive a package into a buffer that is reused.
+   * @param buffer The buffer, which is enlarged if necessary.
+   * @return Success of the function: -1: failure, 0: nothing read,
+   *         > 0: success, size of data in the buffer.
+   */
+  int receive(std::vector<unsigned char>& buffer);
+
+  /**
+   * The function sends data after a package was tried to receive.
+   * @param dataToSend The data to be send.
+   * @param sendSize The size of data to send. If 0, no data is sent.
+   * @param connectedBefore Was the connection established before receiving?
+   * @param readSize The result of receiving.
+   * @return Returns true if the data has been sent.
+   */
+  bool sendAfterReceive(const unsigned char* dataToSend, int sendSize, bool connectedBefore, int readSize);
 };
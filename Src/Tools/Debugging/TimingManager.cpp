@@ -6,18 +6,91 @@
  */
 
 #include "TimingManager.h"
+#include <array>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "Platform/BHAssert.h"
+#include "Platform/PerfCounters.h"
 #include "Platform/SystemCall.h"
 #include "Debugging.h"
 #include "Tools/MessageQueue/MessageQueue.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <memory>
 #include <mutex>
 
 using namespace std;
 
+namespace
+{
+  /**
+   * A histogram of stopwatch times with buckets that grow logarithmically, similar
+   * to an HDR histogram. Times below 16 us are counted exactly. Above, each power
+   * of two is split into 16 buckets, so a percentile is never more than 6.25% too high.
+   */
+  class Histogram
+  {
+    static constexpr unsigned subBuckets = 16;
+    array<unsigned, 29 * subBuckets> counts{}; /**< Covers all 32 bit values. */
+
+    static unsigned getIndex(unsigned value)
+    {
+      if (value < subBuckets)
+        return value;
+      unsigned shift = 0;
+      while (value >> shift >= 2 * subBuckets)
+        ++shift;
+      return shift * subBuckets + (value >> shift);
+    }
+
+    /** @return The highest value that is counted in the given bucket. */
+    static unsigned getUpperBound(unsigned index)
+    {
+      if (index < 2 * subBuckets)
+        return index;
+      const unsigned shift = index / subBuckets - 1;
+      return static_cast<unsigned>((static_cast<unsigned long long>(index - shift * subBuckets + 1) << shift) - 1);
+    }
+
+  public:
+    unsigned count = 0;
+    unsigned maximum = 0;
+
+    void add(unsigned value)
+    {
+      ++counts[getIndex(value)];
+      ++count;
+      maximum = std::max(maximum, value);
+    }
+
+    /**
+     * @param ratio The percentile as ratio [0..1].
+     * @return The value below or at which the given ratio of all values is.
+     */
+    unsigned getPercentile(float ratio) const
+    {
+      const unsigned rank = std::max(1u, static_cast<unsigned>(std::ceil(ratio * static_cast<float>(count))));
+      unsigned sum = 0;
+      for (unsigned i = 0; i < counts.size(); ++i)
+      {
+        sum += counts[i];
+        if (sum >= rank)
+          return std::min(getUpperBound(i), maximum);
+      }
+      return maximum;
+    }
+
+    void clear()
+    {
+      counts.fill(0);
+      count = 0;
+      maximum = 0;
+    }
+  };
+}
+
 struct TimingManager::Pimpl
 {
   /**
@@ -41,6 +114,23 @@ struct TimingManager::Pimpl
   bool dataPrepared = false; /**< True if data hs already been prepared this frame */
   int watchNameIndex = 0; /**< Every frame a few watch names are transmitted. This is the index of the watchname that is to be transmitted next */
   bool threadTime = true; /**< Use thread time or monotonic time. */
+  bool perfCounters = false; /**< Measure hardware performance counters? */
+  unique_ptr<PerfCounters> counters; /**< The counters of the thread using this timing manager. Opened on first use. */
+  unordered_map<const char*, PerfCounters::Values> perfValues; /**< The counter values accumulated like the timings. */
+  unordered_map<const char*, Histogram> histograms; /**< The times measured per frame in the current window. */
+  unsigned windowStart = 0; /**< The start time of the first frame of the current window. */
+  unsigned windowFrames = 0; /**< The number of frames in the current window. */
+  MessageQueue summary; /**< Contains the summary of the last window if it ended in this frame. */
+
+  /** @return The id of a stopwatch, which is assigned when it is seen first. */
+  unsigned short getId(const char* identifier)
+  {
+    const auto id = idTable.find(identifier);
+    if (id != idTable.end())
+      return id->second;
+    watchNames.push_back(identifier);
+    return idTable[identifier] = static_cast<unsigned short>(idTable.size()); //NOTE: this assumes that an unsigned short will always be big big enough to count the timers...
+  }
 
   TimingManager* superTimingManager = nullptr;
   unordered_set<TimingManager*> subTimingManagers;
@@ -60,6 +150,7 @@ TimingManager::TimingManager(TimingManager* superTimingManager) : prvt(new Timin
   {
     // super timing manager needs to transfer data
     prvt->data.setSize(500000);
+    prvt->summary.setSize(100000);
   }
 }
 
@@ -83,10 +174,35 @@ void TimingManager::startTiming(const char* identifier, bool threadTime)
       : std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()).time_since_epoch().count();
   prvt->timing[identifier] -= startTime;
   prvt->dataPrepared = false;
+
+  if (prvt->perfCounters)
+  {
+    if (!prvt->counters)
+      prvt->counters = std::make_unique<PerfCounters>();
+    const PerfCounters::Values counters = prvt->counters->read();
+    PerfCounters::Values& values = prvt->perfValues[identifier];
+    values.cycles -= counters.cycles;
+    values.instructions -= counters.instructions;
+    values.cacheMisses -= counters.cacheMisses;
+    values.branchMisses -= counters.branchMisses;
+  }
 }
 
 unsigned TimingManager::stopTiming(const char* identifier, bool threadTime)
 {
+  if (prvt->perfCounters && prvt->counters)
+  {
+    const auto values = prvt->perfValues.find(identifier);
+    if (values != prvt->perfValues.end())
+    {
+      const PerfCounters::Values counters = prvt->counters->read();
+      values->second.cycles += counters.cycles;
+      values->second.instructions += counters.instructions;
+      values->second.cacheMisses += counters.cacheMisses;
+      values->second.branchMisses += counters.branchMisses;
+    }
+  }
+
   const long long stopTime = (prvt->threadTime && threadTime)
       ? static_cast<long long>(SystemCall::getCurrentThreadTime())
       : std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()).time_since_epoch().count();
@@ -101,13 +217,29 @@ void TimingManager::setThreadTime(bool threadTime)
     timingManager->prvt->threadTime = threadTime;
 }
 
+void TimingManager::setPerfCounters(bool perfCounters)
+{
+  prvt->perfCounters = perfCounters;
+  if (!perfCounters)
+    prvt->perfValues.clear();
+  for (TimingManager* timingManager : prvt->subTimingManagers)
+    timingManager->setPerfCounters(perfCounters);
+}
+
 void TimingManager::signalProcessStart()
 {
   prvt->currentProcessStartTime = SystemCall::getCurrentSystemTime();
   prvt->frameNo++;
   prvt->processRunning = true;
   prvt->data.clear();
+  prvt->summary.clear();
   prvt->dataPrepared = false;
+
+  // The times of the previous frame were already added to the histograms.
+  // If they were not streamed, they must not accumulate.
+  for (auto& timing : prvt->timing)
+    if (timing.second > 0)
+      timing.second = 0;
 }
 
 void TimingManager::signalProcessStop()
@@ -116,6 +248,9 @@ void TimingManager::signalProcessStop()
 
   for (TimingManager* timingManager : prvt->subTimingManagers)
     timingManager->moveDataTo(*this);
+
+  if (!prvt->superTimingManager)
+    updateHistograms();
 }
 
 MessageQueue& TimingManager::getData()
@@ -129,16 +264,69 @@ MessageQueue& TimingManager::getData()
   return prvt->data;
 }
 
-void TimingManager::prepareData()
+MessageQueue& TimingManager::getSummary()
 {
-  for (const auto& timing : prvt->timing)
-  {
-    if (prvt->idTable.find(timing.first) == prvt->idTable.end())
+  ASSERT(!prvt->processRunning);
+  return prvt->summary;
+}
+
+void TimingManager::updateHistograms()
+{
+  if (!prvt->windowFrames)
+    prvt->windowStart = prvt->currentProcessStartTime;
+  ++prvt->windowFrames;
+
+  // Stopwatches that did not run in this frame are not counted.
+  for (const auto& [identifier, time] : prvt->timing)
+    if (time > 0)
+      prvt->histograms[identifier].add(static_cast<unsigned>(time));
+
+  if (prvt->currentProcessStartTime - prvt->windowStart >= summaryInterval)
+    prepareSummary();
+}
+
+void TimingManager::prepareSummary()
+{
+  /** Protocol:
+   * unsigned       : timestamp at which the window started
+   * unsigned       : duration of the window in ms
+   * unsigned       : number of frames in the window
+   * unsigned short : number of stopwatches
+   * for each stopwatch:
+   *  unsigned short : id of the stopwatch (the same as in idStopwatch)
+   *  string         : name of the stopwatch
+   *  unsigned       : number of frames the stopwatch ran in
+   *  unsigned       : median time in microseconds
+   *  unsigned       : 95th percentile in microseconds
+   *  unsigned       : 99th percentile in microseconds
+   *  unsigned       : maximum time in microseconds
+   */
+  OutBinaryMessage& out = prvt->summary.out.bin;
+  out << prvt->windowStart << prvt->currentProcessStartTime - prvt->windowStart << prvt->windowFrames;
+
+  unsigned short count = 0;
+  for (const auto& histogram : prvt->histograms)
+    if (histogram.second.count)
+      ++count;
+  out << count;
+
+  for (auto& [identifier, histogram] : prvt->histograms)
+    if (histogram.count)
     {
-      prvt->watchNames.push_back(timing.first);
-      prvt->idTable[timing.first] = static_cast<unsigned short>(prvt->idTable.size()); //NOTE: this assumes that an unsigned short will always be big big enough to count the timers...
+      out << prvt->getId(identifier) << identifier << histogram.count << histogram.getPercentile(0.5f)
+          << histogram.getPercentile(0.95f) << histogram.getPercentile(0.99f) << histogram.maximum;
+      histogram.clear();
     }
-  }
+  if (!prvt->summary.out.finishMessage(idTimingSummary))
+    OUTPUT_WARNING("TimingManager: summary queue is full!!!");
+
+  prvt->windowFrames = 0;
+}
+
+void TimingManager::prepareData()
+{
+  for (const auto& timing : prvt->timing)
+    prvt->getId(timing.first);
 
 
   /** Protocol:
@@ -177,6 +365,27 @@ void TimingManager::prepareData()
   out << prvt->frameNo;
   if (!prvt->data.out.finishMessage(idStopwatch))
     OUTPUT_WARNING("TimingManager: queue is full!!!");
+
+  /** Protocol:
+   * unsigned short : number of stopwatches with counters
+   * for each stopwatch:
+   *  unsigned short : id of the stopwatch
+   *  unsigned       : cycles
+   *  unsigned       : instructions
+   *  unsigned       : cache misses
+   *  unsigned       : branch misses
+   */
+  if (!prvt->perfValues.empty())
+  {
+    out << (unsigned short)prvt->perfValues.size();
+    for (auto& [identifier, values] : prvt->perfValues)
+    {
+      out << prvt->idTable[identifier] << (unsigned)values.cycles << (unsigned)values.instructions << (unsigned)values.cacheMisses << (unsigned)values.branchMisses;
+      values = PerfCounters::Values();
+    }
+    if (!prvt->data.out.finishMessage(idPerfCounters))
+      OUTPUT_WARNING("TimingManager: queue is full!!!");
+  }
 }
 
 void TimingManager::moveDataTo(TimingManager& timingManager)
@@ -189,4 +398,13 @@ void TimingManager::moveDataTo(TimingManager& timingManager)
       timing.second = 0;
     }
   }
+  for (auto& [identifier, values] : prvt->perfValues)
+  {
+    PerfCounters::Values& superValues = timingManager.prvt->perfValues[identifier];
+    superValues.cycles += values.cycles;
+    superValues.instructions += values.instructions;
+    superValues.cacheMisses += values.cacheMisses;
+    superValues.branchMisses += values.branchMisses;
+    values = PerfCounters::Values();
+  }
 }
@@ -36,6 +36,13 @@ public:
 
   void setThreadTime(bool threadTime);
 
+  /**
+   * Also measure hardware performance counters (cycles, instructions, cache and branch misses)
+   * per stopwatch. They are only available on Linux and are sent as idPerfCounters.
+   * @param perfCounters Measure the counters?
+   */
+  void setPerfCounters(bool perfCounters);
+
   /**
    * The TimingManager has a special stopwatch that is used to keep track
    * of the overall process time.
@@ -53,7 +60,24 @@ public:
    */
   MessageQueue& getData();
 
+  /**
+   * Returns a message queue that contains the summary of the timings of the last
+   * window (see summaryInterval) if the window ended in this frame. Otherwise, it is
+   * empty. In contrast to getData(), the summary is always computed.
+   * Call this method in between signalProcessStop() and signalProcessStart.
+   */
+  MessageQueue& getSummary();
+
 private:
+  static constexpr unsigned summaryInterval = 10000; /**< The duration of the windows that are summarized in ms. */
+
+  /** Adds the timings of the current frame to the histograms and sends their summary at the end of a window. */
+  void updateHistograms();
+
+  /** Writes the percentiles of all histograms as idTimingSummary and empties them. */
+  void prepareSummary();
+
+
   /** Prepares timing data for streaming. */
   void prepareData();
 
@@ -113,4 +113,6 @@ public:
   friend class RobotConsole; // The class RobotConsole can set theDebugOut.
   friend class Framework;
   friend class ModuleManager;
+  friend class Logger; // The compression threads of the Logger set theStreamHandler.
+  friend class RemoteRobot; // The decoding thread of RemoteRobot sets theStreamHandler.
 };
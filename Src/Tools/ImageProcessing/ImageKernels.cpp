@@ -0,0 +1,515 @@
+/**
+ * @file ImageKernels.cpp
+ *
+ * Implementation of the vectorized image kernels.
+ */
+
+#include "Tools/SIMD.h"
+#include "ImageKernels.h"
+#include "Platform/BHAssert.h"
+#include "Platform/SystemCall.h"
+#include "Representations/Infrastructure/Image.h"
+#include "Tools/ColorModelConversions.h"
+#include "Tools/Debugging/Stopwatch.h"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+  /**
+   * Converts 8 YCbCr pixels into RGB pixels exactly like ColorModelConversions::fromYCbCrToRGB.
+   * The terms (c * (Cr - 128)) >> 10 are computed with 32 bits using _mm_madd_epi16 on
+   * interleaved Cb and Cr values.
+   * @param src The 8 YCbCr pixels.
+   * @param rgb0 The first 4 RGB pixels. The padding is 0.
+   * @param rgb1 The second 4 RGB pixels. The padding is 0.
+   */
+  inline void yCbCrToRGB8(const unsigned char* src, __m128i& rgb0, __m128i& rgb1)
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i maskY = _mm_setr_epi8(2, -1, 6, -1, 10, -1, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i maskCbCr = _mm_setr_epi8(1, -1, 3, -1, 5, -1, 7, -1, 9, -1, 11, -1, 13, -1, 15, -1);
+    const __m128i factorsR = _mm_setr_epi16(0, 1436, 0, 1436, 0, 1436, 0, 1436);
+    const __m128i factorsG = _mm_setr_epi16(354, 732, 354, 732, 354, 732, 354, 732);
+    const __m128i factorsB = _mm_setr_epi16(1814, 0, 1814, 0, 1814, 0, 1814, 0);
+
+    const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+
+    const __m128i y = _mm_unpacklo_epi64(_mm_shuffle_epi8(p0, maskY), _mm_shuffle_epi8(p1, maskY)); // y0 .. y7
+    const __m128i cbCr0 = _mm_sub_epi16(_mm_shuffle_epi8(p0, maskCbCr), c128); // cb0 cr0 .. cb3 cr3
+    const __m128i cbCr1 = _mm_sub_epi16(_mm_shuffle_epi8(p1, maskCbCr), c128); // cb4 cr4 .. cb7 cr7
+
+    const __m128i r = _mm_packs_epi32(_mm_srai_epi32(_mm_madd_epi16(cbCr0, factorsR), 10), _mm_srai_epi32(_mm_madd_epi16(cbCr1, factorsR), 10));
+    const __m128i g = _mm_packs_epi32(_mm_srai_epi32(_mm_madd_epi16(cbCr0, factorsG), 10), _mm_srai_epi32(_mm_madd_epi16(cbCr1, factorsG), 10));
+    const __m128i b = _mm_packs_epi32(_mm_srai_epi32(_mm_madd_epi16(cbCr0, factorsB), 10), _mm_srai_epi32(_mm_madd_epi16(cbCr1, factorsB), 10));
+
+    const __m128i rg = _mm_packus_epi16(_mm_add_epi16(y, r), _mm_sub_epi16(y, g)); // r0 .. r7 g0 .. g7
+    const __m128i b0 = _mm_packus_epi16(_mm_add_epi16(y, b), zero); // b0 .. b7 0 .. 0
+
+    const __m128i rgInterleaved = _mm_unpacklo_epi8(rg, _mm_unpackhi_epi64(rg, rg)); // r0 g0 .. r7 g7
+    const __m128i b0Interleaved = _mm_unpacklo_epi8(b0, zero); // b0 0 .. b7 0
+    rgb0 = _mm_unpacklo_epi16(rgInterleaved, b0Interleaved);
+    rgb1 = _mm_unpackhi_epi16(rgInterleaved, b0Interleaved);
+  }
+
+  /**
+   * Converts a single YCbCr pixel into an RGB pixel.
+   * @param src The YCbCr pixel.
+   * @param dest The r, g, and b values.
+   */
+  template <typename T> inline void yCbCrToRGB1(const unsigned char* src, T* dest)
+  {
+    ColorModelConversions::fromYCbCrToRGB(src[offsetof(Image::Pixel, y)], src[offsetof(Image::Pixel, cb)], src[offsetof(Image::Pixel, cr)], dest[0], dest[1], dest[2]);
+  }
+
+  void yCbCrToRGBScalar(const unsigned char* src, unsigned char* dest, int pixels)
+  {
+    for (const unsigned char* end = src + pixels * 4; src < end; src += 4, dest += 4)
+    {
+      yCbCrToRGB1(src, dest);
+      dest[3] = 0;
+    }
+  }
+
+  template <typename T> void yCbCrToRGB24Scalar(const unsigned char* src, T* dest, int pixels)
+  {
+    for (const unsigned char* end = src + pixels * 4; src < end; src += 4, dest += 3)
+      yCbCrToRGB1(src, dest);
+  }
+
+  void copyRowsScalar(const unsigned char* src, unsigned char* dest, int rowSize, int rows, bool clearOddRows)
+  {
+    const size_t rowBytes = rowSize * 4;
+    for (int y = 0; y < rows; ++y, src += rowBytes, dest += rowBytes)
+      if (clearOddRows && y & 1)
+        std::memset(dest, 0, rowBytes);
+      else
+        std::memcpy(dest, src, rowBytes);
+  }
+
+  void shrinkYCbCrNxN(const unsigned char* src, int width, int height, int srcStep, int scale, unsigned char* dest, int destStep)
+  {
+    const int averagedPixels = scale * scale;
+    const int destWidth = width / scale;
+    std::vector<int> summs(destWidth * 3);
+
+    for (int y = 0; y < height; ++y)
+    {
+      const Image::Pixel* pSrc = reinterpret_cast<const Image::Pixel*>(src) + y * srcStep;
+      int* pSumms = summs.data();
+      for (int x = 0; x < width; x += scale, pSumms += 3)
+        for (int i = 0; i < scale; ++i, ++pSrc)
+        {
+          pSumms[0] += pSrc->y;
+          pSumms[1] += pSrc->cb;
+          pSumms[2] += pSrc->cr;
+        }
+
+      if (y % scale == scale - 1)
+      {
+        Image::Pixel* pDest = reinterpret_cast<Image::Pixel*>(dest) + (y / scale) * destStep;
+        pSumms = summs.data();
+        for (int i = 0; i < destWidth; ++i, pSumms += 3, ++pDest)
+        {
+          pDest->y = static_cast<unsigned char>(pSumms[0] / averagedPixels);
+          pDest->cb = static_cast<unsigned char>(pSumms[1] / averagedPixels);
+          pDest->cr = static_cast<unsigned char>(pSumms[2] / averagedPixels);
+        }
+        std::fill(summs.begin(), summs.end(), 0);
+      }
+    }
+  }
+
+  /**
+   * Downscales a YCbCr image by 2, 4, 8, or 16. The channels of two neighboring pixels are
+   * summed up in 16 bit lanes and the lanes of the even and odd pixels are added at the end.
+   * With 16, a lane sums up to 128 values, which still fits.
+   */
+  template <int scale> void shrinkYCbCrSSE(const unsigned char* src, int width, int height, int srcStep, unsigned char* dest, int destStep)
+  {
+    static_assert(scale == 2 || scale == 4 || scale == 8 || scale == 16, "Only 2, 4, 8, and 16 are supported.");
+    const int averagedPixels = scale * scale;
+    const int destWidth = width / scale;
+    const __m128i zero = _mm_setzero_si128();
+    const int summsSize = destWidth * 16;
+    __m128i* summs = reinterpret_cast<__m128i*>(SystemCall::alignedMalloc(summsSize, 16));
+    std::memset(summs, 0, summsSize);
+
+    for (int y = 0; y < height; ++y)
+    {
+      const Image::Pixel* pSrc = reinterpret_cast<const Image::Pixel*>(src) + y * srcStep;
+      __m128i* pSumms = summs;
+      for (int x = 0; x < width; x += scale, pSrc += scale, ++pSumms)
+        if constexpr (scale == 2)
+          *pSumms = _mm_add_epi16(*pSumms, _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pSrc)), zero));
+        else
+          for (int i = 0; i < scale; i += 4)
+          {
+            const __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+            *pSumms = _mm_add_epi16(*pSumms, _mm_unpacklo_epi8(tmp, zero));
+            *pSumms = _mm_add_epi16(*pSumms, _mm_unpackhi_epi8(tmp, zero));
+          }
+
+      if (y % scale == scale - 1)
+      {
+        Image::Pixel* pDest = reinterpret_cast<Image::Pixel*>(dest) + (y / scale) * destStep;
+        pSumms = summs;
+        for (int i = 0; i < destWidth; ++i, ++pSumms, ++pDest)
+        {
+          const short* ptr = reinterpret_cast<const short*>(pSumms);
+
+          const int sumY = ptr[offsetof(Image::Pixel, y)] + ptr[offsetof(Image::Pixel, y) + sizeof(Image::Pixel)];
+          const int sumCb = ptr[offsetof(Image::Pixel, cb)] + ptr[offsetof(Image::Pixel, cb) + sizeof(Image::Pixel)];
+          const int sumCr = ptr[offsetof(Image::Pixel, cr)] + ptr[offsetof(Image::Pixel, cr) + sizeof(Image::Pixel)];
+
+          pDest->y = static_cast<unsigned char>(sumY / averagedPixels);
+          pDest->cb = static_cast<unsigned char>(sumCb / averagedPixels);
+          pDest->cr = static_cast<unsigned char>(sumCr / averagedPixels);
+        }
+        std::memset(summs, 0, summsSize);
+      }
+    }
+    SystemCall::alignedFree(summs);
+  }
+
+  void shrinkGrayscaleNxN(const unsigned char* src, int width, int height, int srcStep, int scale, unsigned char* dest)
+  {
+    const int averagedPixels = scale * scale;
+    const int destWidth = width / scale;
+    std::vector<unsigned> summs(destWidth);
+
+    for (int y = 0; y < height; ++y)
+    {
+      const Image::Pixel* pSrc = reinterpret_cast<const Image::Pixel*>(src) + y * srcStep;
+      unsigned* pSumms = summs.data();
+      for (int x = 0; x < width; x += scale, ++pSumms)
+        for (int i = 0; i < scale; ++i, ++pSrc)
+          *pSumms += pSrc->y;
+
+      if (y % scale == scale - 1)
+      {
+        unsigned char* pDest = dest + (y / scale) * destWidth;
+        for (unsigned sum : summs)
+          *pDest++ = static_cast<unsigned char>(sum / averagedPixels);
+        std::fill(summs.begin(), summs.end(), 0);
+      }
+    }
+  }
+
+  /**
+   * Downscales the y channel of a YCbCr image by 2, 4, 8, or 16. The y values of 8 pixels
+   * are summed up in 16 bit lanes and the lanes are added horizontally at the end. The sums
+   * of 256 pixels only fit into unsigned lanes, so they are shifted logically.
+   */
+  template <int scale> void shrinkGrayscaleSSE(const unsigned char* src, int width, int height, int srcStep, unsigned char* dest)
+  {
+    static_assert(scale == 2 || scale == 4 || scale == 8 || scale == 16, "Only 2, 4, 8, and 16 are supported.");
+    const int destWidth = width / scale;
+    const __m128i zero = _mm_setzero_si128();
+    const unsigned char offset = offsetof(Image::Pixel, y);
+    const __m128i mask = _mm_setr_epi8(offset, offset + 4, offset + 8, offset + 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const int summsSize = width * 2; // a 16 bit lane per column
+    __m128i* summs = reinterpret_cast<__m128i*>(SystemCall::alignedMalloc(summsSize, 16));
+    std::memset(summs, 0, summsSize);
+
+    for (int y = 0; y < height; ++y)
+    {
+      const Image::Pixel* pSrc = reinterpret_cast<const Image::Pixel*>(src) + y * srcStep;
+      __m128i* pSumms = summs;
+      for (int x = 0; x < width; x += 8, pSrc += 8, ++pSumms)
+      {
+        __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc)), mask); // y0 y1 y2 y3 0 ...
+        const __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 4)), mask); // y4 y5 y6 y7 0 ...
+        p0 = _mm_unpacklo_epi8(_mm_unpacklo_epi32(p0, p1), zero); // y0 .. y7
+        *pSumms = _mm_add_epi16(*pSumms, p0);
+      }
+
+      if (y % scale == scale - 1)
+      {
+        unsigned char* pDest = dest + (y / scale) * destWidth;
+        pSumms = summs;
+        int i = 0;
+        for (; i + 8 <= destWidth; i += 8, pSumms += scale, pDest += 8)
+        {
+          // sums of 8 consecutive pixels each
+          const auto hadd8 = [](const __m128i* s)
+          {
+            return _mm_hadd_epi16(_mm_hadd_epi16(_mm_hadd_epi16(s[0], s[1]), _mm_hadd_epi16(s[2], s[3])),
+                                  _mm_hadd_epi16(_mm_hadd_epi16(s[4], s[5]), _mm_hadd_epi16(s[6], s[7])));
+          };
+          __m128i p0;
+          if constexpr (scale == 16)
+            p0 = _mm_srli_epi16(_mm_hadd_epi16(hadd8(pSumms), hadd8(pSumms + 8)), 8);
+          else if constexpr (scale == 8)
+            p0 = _mm_srli_epi16(hadd8(pSumms), 6);
+          else
+          {
+            p0 = _mm_hadd_epi16(pSumms[0], pSumms[1]);
+            if constexpr (scale == 2)
+              p0 = _mm_srli_epi16(p0, 2);
+            else
+              p0 = _mm_srli_epi16(_mm_hadd_epi16(p0, _mm_hadd_epi16(pSumms[2], pSumms[3])), 4);
+          }
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(pDest), _mm_packus_epi16(p0, zero));
+        }
+
+        // The lanes contain the sums of consecutive pixels.
+        const short* lanes = reinterpret_cast<const short*>(summs);
+        for (; i < destWidth; ++i, ++pDest)
+        {
+          int sum = 0;
+          for (const short* lane = lanes + i * scale; lane < lanes + (i + 1) * scale; ++lane)
+            sum += *lane;
+          *pDest = static_cast<unsigned char>(sum / (scale * scale));
+        }
+        std::memset(summs, 0, summsSize);
+      }
+    }
+    SystemCall::alignedFree(summs);
+  }
+
+  void classifyRangeScalar(const unsigned char* src, int pixels, const unsigned char* lower, const unsigned char* upper, unsigned char* mask)
+  {
+    for (const unsigned char* end = src + pixels * 4; src < end; src += 4, ++mask)
+      *mask = src[0] >= lower[0] && src[0] <= upper[0] && src[1] >= lower[1] && src[1] <= upper[1]
+              && src[2] >= lower[2] && src[2] <= upper[2] && src[3] >= lower[3] && src[3] <= upper[3];
+  }
+}
+
+void ImageKernels::yCbCrToRGB(const unsigned char* src, unsigned char* dest, int pixels)
+{
+  int i = 0;
+  for (; i + 8 <= pixels; i += 8, src += 32, dest += 32)
+  {
+    __m128i rgb0, rgb1;
+    yCbCrToRGB8(src, rgb0, rgb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), rgb0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 16), rgb1);
+  }
+  yCbCrToRGBScalar(src, dest, pixels - i);
+}
+
+void ImageKernels::yCbCrToRGB24(const unsigned char* src, unsigned char* dest, int pixels)
+{
+  const __m128i removePadding = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  int i = 0;
+  for (; i + 8 <= pixels; i += 8, src += 32, dest += 24)
+  {
+    __m128i rgb0, rgb1;
+    yCbCrToRGB8(src, rgb0, rgb1);
+    rgb0 = _mm_shuffle_epi8(rgb0, removePadding);
+    rgb1 = _mm_shuffle_epi8(rgb1, removePadding);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_or_si128(rgb0, _mm_slli_si128(rgb1, 12)));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + 16), _mm_srli_si128(rgb1, 4));
+  }
+  yCbCrToRGB24Scalar(src, dest, pixels - i);
+}
+
+void ImageKernels::yCbCrToRGB24(const unsigned char* src, float* dest, int pixels)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 c255 = _mm_set1_ps(255.f);
+  int i = 0;
+
+  // Each pixel is stored as 4 floats and the next one overwrites the 4th,
+  // so the last pixel is always left to the scalar version.
+  for (; i + 8 < pixels; i += 8, src += 32)
+  {
+    __m128i rgb[2];
+    yCbCrToRGB8(src, rgb[0], rgb[1]);
+    for (const __m128i& rgb4 : rgb)
+    {
+      const __m128i lower = _mm_unpacklo_epi8(rgb4, zero);
+      const __m128i upper = _mm_unpackhi_epi8(rgb4, zero);
+      _mm_storeu_ps(dest, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lower, zero)), c255));
+      _mm_storeu_ps(dest + 3, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lower, zero)), c255));
+      _mm_storeu_ps(dest + 6, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(upper, zero)), c255));
+      _mm_storeu_ps(dest + 9, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(upper, zero)), c255));
+      dest += 12;
+    }
+  }
+  yCbCrToRGB24Scalar(src, dest, pixels - i);
+}
+
+void ImageKernels::yCbCrToHSI(const unsigned char* src, unsigned char* dest, int pixels)
+{
+  for (const unsigned char* end = src + pixels * 4; src < end; src += 4, dest += 4)
+    ColorModelConversions::fromYCbCrToHSI(src[offsetof(Image::Pixel, y)], src[offsetof(Image::Pixel, cb)], src[offsetof(Image::Pixel, cr)],
+                                          dest[offsetof(Image::Pixel, h)], dest[offsetof(Image::Pixel, s)], dest[offsetof(Image::Pixel, i)]);
+}
+
+void ImageKernels::copyRows(const unsigned char* src, unsigned char* dest, int rowSize, int rows, bool clearOddRows)
+{
+  ASSERT(rowSize % 4 == 0);
+  const int rowBytes = rowSize * 4;
+  const __m128i zero = _mm_setzero_si128();
+  for (int y = 0; y < rows; ++y, src += rowBytes, dest += rowBytes)
+  {
+    if (clearOddRows && y & 1)
+      for (int x = 0; x < rowBytes; x += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), zero);
+    else
+      for (int x = 0; x < rowBytes; x += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + x), _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x)));
+  }
+}
+
+void ImageKernels::copyColumn(const unsigned char* src, int rows, int srcStep, unsigned char* dest)
+{
+  const size_t rowBytes = srcStep * 4;
+  for (const unsigned char* end = dest + rows * 4; dest < end; src += rowBytes, dest += 4)
+    std::memcpy(dest, src, 4);
+}
+
+void ImageKernels::classifyRange(const unsigned char* src, int pixels, const unsigned char* lower, const unsigned char* upper, unsigned char* mask)
+{
+  int lowerBytes, upperBytes;
+  std::memcpy(&lowerBytes, lower, 4);
+  std::memcpy(&upperBytes, upper, 4);
+  const __m128i lowerBound = _mm_set1_epi32(lowerBytes);
+  const __m128i upperBound = _mm_set1_epi32(upperBytes);
+  const __m128i allSet = _mm_set1_epi32(-1);
+  const __m128i one = _mm_set1_epi8(1);
+
+  int i = 0;
+  for (; i + 16 <= pixels; i += 16, src += 64)
+  {
+    // A pixel is inside if all 4 of its bytes are, i.e. its 32 bit lane is all set.
+    __m128i inside[4];
+    for (int j = 0; j < 4; ++j)
+    {
+      const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + j * 16));
+      const __m128i inRange = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(p, lowerBound), p), _mm_cmpeq_epi8(_mm_min_epu8(p, upperBound), p));
+      inside[j] = _mm_cmpeq_epi32(inRange, allSet);
+    }
+    const __m128i packed = _mm_packs_epi16(_mm_packs_epi32(inside[0], inside[1]), _mm_packs_epi32(inside[2], inside[3]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(mask + i), _mm_and_si128(packed, one));
+  }
+  classifyRangeScalar(src, pixels - i, lower, upper, mask + i);
+}
+
+void ImageKernels::shrinkYCbCr(const unsigned char* src, int width, int height, int srcStep, int scale, unsigned char* dest, int destStep)
+{
+  ASSERT(width % scale == 0);
+  ASSERT(height % scale == 0);
+
+  if (scale == 16)
+    shrinkYCbCrSSE<16>(src, width, height, srcStep, dest, destStep);
+  else if (scale == 8)
+    shrinkYCbCrSSE<8>(src, width, height, srcStep, dest, destStep);
+  else if (scale == 4)
+    shrinkYCbCrSSE<4>(src, width, height, srcStep, dest, destStep);
+  else if (scale == 2)
+    shrinkYCbCrSSE<2>(src, width, height, srcStep, dest, destStep);
+  else
+    shrinkYCbCrNxN(src, width, height, srcStep, scale, dest, destStep);
+}
+
+void ImageKernels::shrinkGrayscale(const unsigned char* src, int width, int height, int srcStep, int scale, unsigned char* dest)
+{
+  ASSERT(width % scale == 0);
+  ASSERT(height % scale == 0);
+
+  if (scale == 16 && width % 8 == 0)
+    shrinkGrayscaleSSE<16>(src, width, height, srcStep, dest);
+  else if (scale == 8 && width % 8 == 0)
+    shrinkGrayscaleSSE<8>(src, width, height, srcStep, dest);
+  else if (scale == 4 && width % 8 == 0)
+    shrinkGrayscaleSSE<4>(src, width, height, srcStep, dest);
+  else if (scale == 2 && width % 8 == 0)
+    shrinkGrayscaleSSE<2>(src, width, height, srcStep, dest);
+  else
+    shrinkGrayscaleNxN(src, width, height, srcStep, scale, dest);
+}
+
+void ImageKernels::benchmark(const Image& image)
+{
+  const int width = image.width;
+  const int height = image.height;
+  const unsigned char* src = reinterpret_cast<const unsigned char*>(image.image);
+  const int rowBytes = image.widthStep * 4;
+  std::vector<unsigned char> bytes[2];
+  std::vector<float> floats[2];
+
+  const auto compare = [](const auto& results, const char* kernel)
+  {
+    if (results[0] != results[1])
+      OUTPUT_WARNING("ImageKernels: " << kernel << " differs from its scalar version.");
+  };
+
+  bytes[0].assign(width * height * 4, 0);
+  bytes[1].assign(width * height * 4, 0);
+  STOPWATCH("ImageKernels:yCbCrToRGB")
+    for (int y = 0; y < height; ++y)
+      yCbCrToRGB(src + y * rowBytes, bytes[0].data() + y * width * 4, width);
+  STOPWATCH("ImageKernels:yCbCrToRGBScalar")
+    for (int y = 0; y < height; ++y)
+      yCbCrToRGBScalar(src + y * rowBytes, bytes[1].data() + y * width * 4, width);
+  compare(bytes, "yCbCrToRGB");
+
+  bytes[0].assign(width * height * 3, 0);
+  bytes[1].assign(width * height * 3, 0);
+  STOPWATCH("ImageKernels:yCbCrToRGB24")
+    for (int y = 0; y < height; ++y)
+      yCbCrToRGB24(src + y * rowBytes, bytes[0].data() + y * width * 3, width);
+  STOPWATCH("ImageKernels:yCbCrToRGB24Scalar")
+    for (int y = 0; y < height; ++y)
+      yCbCrToRGB24Scalar(src + y * rowBytes, bytes[1].data() + y * width * 3, width);
+  compare(bytes, "yCbCrToRGB24");
+
+  floats[0].assign(width * height * 3, 0.f);
+  floats[1].assign(width * height * 3, 0.f);
+  STOPWATCH("ImageKernels:yCbCrToRGB24Float")
+    for (int y = 0; y < height; ++y)
+      yCbCrToRGB24(src + y * rowBytes, floats[0].data() + y * width * 3, width);
+  STOPWATCH("ImageKernels:yCbCrToRGB24FloatScalar")
+    for (int y = 0; y < height; ++y)
+      yCbCrToRGB24Scalar(src + y * rowBytes, floats[1].data() + y * width * 3, width);
+  compare(floats, "yCbCrToRGB24Float");
+
+  bytes[0].assign(height * rowBytes, 0);
+  bytes[1].assign(height * rowBytes, 0);
+  STOPWATCH("ImageKernels:copyRows")
+    copyRows(src, bytes[0].data(), width, height * 2, true);
+  STOPWATCH("ImageKernels:copyRowsScalar")
+    copyRowsScalar(src, bytes[1].data(), width, height * 2, true);
+  compare(bytes, "copyRows");
+
+  const unsigned char lower[4] = {0, 60, 40, 90};
+  const unsigned char upper[4] = {255, 100, 160, 130};
+  bytes[0].assign(width * height, 0);
+  bytes[1].assign(width * height, 0);
+  STOPWATCH("ImageKernels:classifyRange")
+    for (int y = 0; y < height; ++y)
+      classifyRange(src + y * rowBytes, width, lower, upper, bytes[0].data() + y * width);
+  STOPWATCH("ImageKernels:classifyRangeScalar")
+    for (int y = 0; y < height; ++y)
+      classifyRangeScalar(src + y * rowBytes, width, lower, upper, bytes[1].data() + y * width);
+  compare(bytes, "classifyRange");
+
+  for (const int scale : {2, 4, 8, 16})
+  {
+    if (width % 8 != 0 || height % scale != 0)
+      continue;
+
+    const size_t destSize = (width / scale) * (height / scale) * 4;
+    bytes[0].assign(destSize, 0);
+    bytes[1].assign(destSize, 0);
+    STOPWATCH(scale == 2 ? "ImageKernels:shrinkYCbCr2" : scale == 4 ? "ImageKernels:shrinkYCbCr4" : scale == 8 ? "ImageKernels:shrinkYCbCr8" : "ImageKernels:shrinkYCbCr16")
+      shrinkYCbCr(src, width, height, image.widthStep, scale, bytes[0].data(), width / scale);
+    STOPWATCH(scale == 2 ? "ImageKernels:shrinkYCbCr2Scalar" : scale == 4 ? "ImageKernels:shrinkYCbCr4Scalar" : scale == 8 ? "ImageKernels:shrinkYCbCr8Scalar" : "ImageKernels:shrinkYCbCr16Scalar")
+      shrinkYCbCrNxN(src, width, height, image.widthStep, scale, bytes[1].data(), width / scale);
+    compare(bytes, "shrinkYCbCr");
+
+    bytes[0].assign(destSize, 0);
+    bytes[1].assign(destSize, 0);
+    STOPWATCH(scale == 2 ? "ImageKernels:shrinkGrayscale2" : scale == 4 ? "ImageKernels:shrinkGrayscale4" : scale == 8 ? "ImageKernels:shrinkGrayscale8" : "ImageKernels:shrinkGrayscale16")
+      shrinkGrayscale(src, width, height, image.widthStep, scale, bytes[0].data());
+    STOPWATCH(scale == 2 ? "ImageKernels:shrinkGrayscale2Scalar" : scale == 4 ? "ImageKernels:shrinkGrayscale4Scalar" : scale == 8 ? "ImageKernels:shrinkGrayscale8Scalar" : "ImageKernels:shrinkGrayscale16Scalar")
+      shrinkGrayscaleNxN(src, width, height, image.widthStep, scale, bytes[1].data());
+    compare(bytes, "shrinkGrayscale");
+  }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file ImageKernels.h
+ *
+ * Declaration of the vectorized kernels used by all image consumers to convert
+ * the color space of and to downscale camera images. They use SSSE3 through
+ * Tools/SIMD.h, i.e. NEON via sse2neon on ARM. The results are the same as the
+ * ones of the scalar conversions in ColorModelConversions.
+ *
+ * The kernels work on raw buffers of 4 byte pixels, so that they can be used
+ * from Image itself. A YCbCr pixel is stored as | y0 | cb | y1 | cr | (see
+ * Image::Pixel), and the conversions use y1. An RGB pixel is stored as
+ * | r | g | b | padding |.
+ */
+
+#pragma once
+
+struct Image;
+
+namespace ImageKernels
+{
+  /**
+   * Converts YCbCr pixels into RGB pixels. The padding of the RGB pixels is set to 0.
+   * @param src The YCbCr pixels.
+   * @param dest The RGB pixels. Can be the same as src.
+   * @param pixels The number of pixels converted.
+   */
+  void yCbCrToRGB(const unsigned char* src, unsigned char* dest, int pixels);
+
+  /**
+   * Converts YCbCr pixels into RGB triples without padding, e.g. for network inputs.
+   * @param src The YCbCr pixels.
+   * @param dest The RGB values, 3 per pixel.
+   * @param pixels The number of pixels converted.
+   */
+  void yCbCrToRGB24(const unsigned char* src, unsigned char* dest, int pixels);
+
+  /**
+   * Converts YCbCr pixels into RGB triples normalized to [0 .. 1].
+   * @param src The YCbCr pixels.
+   * @param dest The RGB values, 3 per pixel.
+   * @param pixels The number of pixels converted.
+   */
+  void yCbCrToRGB24(const unsigned char* src, float* dest, int pixels);
+
+  /**
+   * Converts YCbCr pixels into HSI pixels. This kernel is not vectorized,
+   * because the hue requires a division per pixel.
+   * @param src The YCbCr pixels.
+   * @param dest The HSI pixels. The padding is not changed.
+   * @param pixels The number of pixels converted.
+   */
+  void yCbCrToHSI(const unsigned char* src, unsigned char* dest, int pixels);
+
+  /**
+   * Copies rows of pixels.
+   * @param src The first row copied.
+   * @param dest The first row written.
+   * @param rowSize The size of a row in pixels. Must be a multiple of 4.
+   * @param rows The number of rows copied.
+   * @param clearOddRows Fill every second row with zeros instead of copying it.
+   */
+  void copyRows(const unsigned char* src, unsigned char* dest, int rowSize, int rows, bool clearOddRows);
+
+  /**
+   * Downscales a YCbCr image by averaging blocks of scale x scale pixels.
+   * Scales 2, 4, 8, and 16 are vectorized.
+   * @param src The first row of the image.
+   * @param width The width of the image in pixels. Must be a multiple of scale.
+   * @param height The height of the image in pixels. Must be a multiple of scale.
+   * @param srcStep The distance between two rows of the image in pixels.
+   * @param scale The size of the blocks averaged.
+   * @param dest The downscaled image with a width of width / scale pixels. The y0 channel is not set.
+   * @param destStep The distance between two rows of the downscaled image in pixels.
+   */
+  void shrinkYCbCr(const unsigned char* src, int width, int height, int srcStep, int scale, unsigned char* dest, int destStep);
+
+  /**
+   * Downscales the y channel of a YCbCr image by averaging blocks of scale x scale pixels.
+   * Scales 2, 4, 8, and 16 are vectorized.
+   * @param src The first row of the image.
+   * @param width The width of the image in pixels. Must be a multiple of scale.
+   *              The vectorized versions are only used if it is also a multiple of 8.
+   * @param height The height of the image in pixels. Must be a multiple of scale.
+   * @param srcStep The distance between two rows of the image in pixels.
+   * @param scale The size of the blocks averaged.
+   * @param dest The downscaled gray image with a width of width / scale bytes without any gaps.
+   */
+  void shrinkGrayscale(const unsigned char* src, int width, int height, int srcStep, int scale, unsigned char* dest);
+
+  /**
+   * Gathers the pixels of a column into a contiguous buffer, so that a vertical
+   * scan line can be processed like a row.
+   * @param src The pixel of the column in the first row.
+   * @param rows The number of rows gathered.
+   * @param srcStep The distance between two rows of the image in pixels.
+   * @param dest The pixels of the column without any gaps.
+   */
+  void copyColumn(const unsigned char* src, int rows, int srcStep, unsigned char* dest);
+
+  /**
+   * Classifies pixels by whether each of their bytes lies in a range, 16 pixels at a time.
+   * @param src The pixels.
+   * @param pixels The number of pixels classified.
+   * @param lower The smallest value of each of the 4 bytes of a pixel inside the ranges.
+   * @param upper The largest value of each of the 4 bytes of a pixel inside the ranges.
+   * @param mask 1 for each pixel inside the ranges and 0 for all others.
+   */
+  void classifyRange(const unsigned char* src, int pixels, const unsigned char* lower, const unsigned char* upper, unsigned char* mask);
+
+  /**
+   * Measures all kernels on an image and compares them with their scalar versions.
+   * The times are recorded as stopwatches named "ImageKernels:<kernel>" and
+   * "ImageKernels:<kernel>Scalar". Differing results are reported as warnings.
+   * @param image The YCbCr image used as input.
+   */
+  void benchmark(const Image& image);
+}
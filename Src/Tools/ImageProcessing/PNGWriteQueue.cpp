@@ -0,0 +1,180 @@
+/**
+ * @file PNGWriteQueue.cpp
+ *
+ * Implementation of class PNGWriteQueue.
+ */
+
+#include "PNGWriteQueue.h"
+#include "Platform/Thread.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Debugging/Debugging.h"
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wconversion"
+#endif
+
+#include "Tools/ImageProcessing/stb_image_write.h"
+
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
+
+#include <cstring>
+#include <filesystem>
+
+std::shared_ptr<PNGWriteQueue> PNGWriteQueue::getShared()
+{
+  static std::mutex sharedMutex;
+  static std::weak_ptr<PNGWriteQueue> shared;
+
+  std::lock_guard<std::mutex> lock(sharedMutex);
+  std::shared_ptr<PNGWriteQueue> queue = shared.lock();
+  if (!queue)
+  {
+    queue = std::make_shared<PNGWriteQueue>();
+    shared = queue;
+  }
+  return queue;
+}
+
+PNGWriteQueue::PNGWriteQueue() : thread(&PNGWriteQueue::run, this) {}
+
+PNGWriteQueue::~PNGWriteQueue()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+  }
+  jobAvailable.notify_one();
+  thread.join();
+}
+
+bool PNGWriteQueue::enqueue(const std::string& filename, const Image& image, int width, int height, Converter convert, std::string metadata)
+{
+  Job job;
+  job.image = std::make_unique<Image>(false);
+  if (image.frame || !image.sharedFrame.expired())
+    job.image->shareImage(image);
+  else
+  {
+    // Copy the whole buffer, because converters may also use the second half of each row.
+    job.image->setResolution(image.width, image.height);
+    job.image->timeStamp = image.timeStamp;
+    job.image->imageSource = image.imageSource;
+    std::memcpy(job.image->image, image.image, image.height * image.widthStep * sizeof(Image::Pixel));
+  }
+  job.filename = filename;
+  job.convert = std::move(convert);
+  job.width = width;
+  job.height = height;
+  job.metadata = std::move(metadata);
+  job.bytes = image.height * image.widthStep * sizeof(Image::Pixel) + width * height * 3 + job.metadata.size();
+  return enqueue(std::move(job));
+}
+
+bool PNGWriteQueue::enqueue(const std::string& filename, int width, int height, std::vector<unsigned char> pixels, std::string metadata)
+{
+  ASSERT(pixels.size() == static_cast<size_t>(width * height * 3));
+  Job job;
+  job.filename = filename;
+  job.width = width;
+  job.height = height;
+  job.pixels = std::move(pixels);
+  job.metadata = std::move(metadata);
+  job.bytes = job.pixels.size() + job.metadata.size();
+  return enqueue(std::move(job));
+}
+
+bool PNGWriteQueue::enqueue(Job&& job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (jobs.size() >= maxQueuedJobs || queuedBytes + job.bytes > maxQueuedBytes)
+    {
+      // Dropping the new image keeps the files already queued complete.
+      ++dropped;
+      return false;
+    }
+    queuedBytes += job.bytes;
+    jobs.emplace_back(std::move(job));
+  }
+  jobAvailable.notify_one();
+  return true;
+}
+
+void PNGWriteQueue::report()
+{
+  size_t backlog, bytes;
+  std::string failedFile;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    backlog = jobs.size();
+    bytes = queuedBytes;
+    failedFile = lastFailedFile;
+  }
+
+  DECLARE_PLOT("module:PNGWriteQueue:backlog");
+  DECLARE_PLOT("module:PNGWriteQueue:queuedBytes");
+  DECLARE_PLOT("module:PNGWriteQueue:written");
+  PLOT("module:PNGWriteQueue:backlog", backlog);
+  PLOT("module:PNGWriteQueue:queuedBytes", bytes);
+  PLOT("module:PNGWriteQueue:written", written.exchange(0));
+
+  const unsigned droppedImages = dropped.exchange(0);
+  const unsigned failedImages = failed.exchange(0);
+  if (droppedImages)
+    OUTPUT_WARNING("PNGWriteQueue: dropped " << droppedImages << " images, " << backlog << " still queued");
+  if (failedImages)
+    OUTPUT_ERROR("Error writing " << failedImages << " PNGs, e.g. " << failedFile);
+}
+
+void PNGWriteQueue::run()
+{
+  Thread<PNGWriteQueue>::setName("PNGWriteQueue");
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true)
+  {
+    jobAvailable.wait(lock,
+        [&]
+        {
+          return !jobs.empty() || !running;
+        });
+    if (jobs.empty())
+      break;
+
+    // Write the images queued before stopping as well.
+    Job job = std::move(jobs.front());
+    jobs.pop_front();
+    lock.unlock();
+    const bool success = write(job);
+    lock.lock();
+    queuedBytes -= job.bytes;
+    if (success)
+      ++written;
+    else
+    {
+      ++failed;
+      lastFailedFile = job.filename;
+    }
+  }
+}
+
+bool PNGWriteQueue::write(Job& job)
+{
+  if (job.image)
+  {
+    job.pixels.resize(job.width * job.height * 3);
+    job.convert(*job.image, job.pixels.data());
+    job.image.reset(); // release the camera buffer as early as possible
+  }
+
+  unsigned char* metadata = reinterpret_cast<unsigned char*>(job.metadata.data());
+  const int metadataSize = static_cast<int>(job.metadata.size());
+  if (stbi_write_png(job.filename.c_str(), job.width, job.height, 3, job.pixels.data(), job.width * 3, metadata, metadataSize))
+    return true;
+
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(job.filename).parent_path(), error);
+  return stbi_write_png(job.filename.c_str(), job.width, job.height, 3, job.pixels.data(), job.width * 3, metadata, metadataSize) != 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file PNGWriteQueue.h
+ *
+ * Declaration of a class that converts, encodes, and writes PNG files in a
+ * background thread, so that logging images does not delay the frames of the
+ * thread that collects them. All modules that write PNG files share one queue.
+ * Its memory is bounded: if too many images are waiting, new ones are dropped.
+ */
+
+#pragma once
+
+#include "Representations/Infrastructure/Image.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class PNGWriteQueue
+{
+public:
+  /**
+   * Converts an image into the RGB pixels that are written.
+   * @param image The image enqueued.
+   * @param pixels The RGB pixels of the PNG file without any gaps between the rows.
+   */
+  using Converter = std::function<void(const Image& image, unsigned char* pixels)>;
+
+  static constexpr size_t maxQueuedJobs = 16; /**< More images are dropped. */
+  static constexpr size_t maxQueuedBytes = 32 << 20; /**< More images are dropped. */
+
+  /**
+   * Returns the queue shared by all callers. It exists as long as anyone holds it.
+   * @return The queue.
+   */
+  static std::shared_ptr<PNGWriteQueue> getShared();
+
+  PNGWriteQueue();
+
+  /** Writes all images still queued before the thread is stopped. */
+  ~PNGWriteQueue();
+
+  /**
+   * Enqueues a camera image. Its buffer is only referenced if it can be shared
+   * (see Image::shareImage), otherwise it is copied. The conversion is done in
+   * the background as well.
+   * @param filename The name of the PNG file. Its directory is created if necessary.
+   * @param image The image.
+   * @param width The width of the PNG file.
+   * @param height The height of the PNG file.
+   * @param convert Fills the pixels of the PNG file from the image.
+   * @param metadata Serialized protobuf data added to the PNG file.
+   * @return Was the image enqueued, i.e. not dropped?
+   */
+  bool enqueue(const std::string& filename, const Image& image, int width, int height, Converter convert, std::string metadata = "");
+
+  /**
+   * Enqueues RGB pixels, e.g. a patch.
+   * @param filename The name of the PNG file. Its directory is created if necessary.
+   * @param width The width of the PNG file.
+   * @param height The height of the PNG file.
+   * @param pixels The RGB pixels without any gaps between the rows.
+   * @param metadata Serialized protobuf data added to the PNG file.
+   * @return Was the image enqueued, i.e. not dropped?
+   */
+  bool enqueue(const std::string& filename, int width, int height, std::vector<unsigned char> pixels, std::string metadata = "");
+
+  /**
+   * Plots the backlog and reports images dropped or not written since the last
+   * call. Must be called from a thread that has debugging.
+   */
+  void report();
+
+private:
+  struct Job
+  {
+    std::string filename;
+    std::unique_ptr<Image> image; /**< The image converted or nullptr if the pixels are already set. */
+    Converter convert;
+    int width;
+    int height;
+    std::vector<unsigned char> pixels;
+    std::string metadata;
+    size_t bytes; /**< The memory this job occupies. */
+  };
+
+  std::mutex mutex;
+  std::condition_variable jobAvailable;
+  std::deque<Job> jobs;
+  size_t queuedBytes = 0; /**< The memory occupied by all queued jobs. */
+  bool running = true;
+  std::string lastFailedFile; /**< The file that could not be written most recently. */
+
+  std::atomic<unsigned> dropped{0}; /**< The number of images dropped since the last report. */
+  std::atomic<unsigned> failed{0}; /**< The number of images not written since the last report. */
+  std::atomic<unsigned> written{0}; /**< The number of images written since the last report. */
+
+  std::thread thread;
+
+  bool enqueue(Job&& job);
+
+  /** The main function of the background thread. */
+  void run();
+
+  /**
+   * Converts, encodes, and writes a single image.
+   * @param job The job.
+   * @return Was the file written?
+   */
+  static bool write(Job& job);
+};
@@ -0,0 +1,183 @@
+/**
+ * @file TFRecordWriter.cpp
+ *
+ * Implementation of classes TFRecordExample and TFRecordWriter.
+ */
+
+#include "TFRecordWriter.h"
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+  /** Appends a varint as used by the protobuf wire format. */
+  void appendVarint(std::string& out, uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      out += static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    out += static_cast<char>(value);
+  }
+
+  /** Appends a length-delimited field with the given number. */
+  void appendLengthDelimited(std::string& out, unsigned fieldNumber, const char* data, size_t size)
+  {
+    appendVarint(out, fieldNumber << 3 | 2);
+    appendVarint(out, size);
+    out.append(data, size);
+  }
+
+  void appendLengthDelimited(std::string& out, unsigned fieldNumber, const std::string& data)
+  {
+    appendLengthDelimited(out, fieldNumber, data.data(), data.size());
+  }
+
+  /** Appends a value in little endian byte order. */
+  template<typename T> void appendLittleEndian(std::string& out, T value)
+  {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T)); // all targets are little endian
+  }
+
+  /** The table of the CRC-32C (Castagnoli) polynomial in reversed bit order. */
+  const std::array<uint32_t, 256> crcTable = []
+  {
+    std::array<uint32_t, 256> table;
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j)
+        crc = crc & 1 ? (crc >> 1) ^ 0x82f63b78u : crc >> 1;
+      table[i] = crc;
+    }
+    return table;
+  }();
+}
+
+void TFRecordExample::addBytes(const std::string& key, const void* data, size_t size)
+{
+  std::string list;
+  appendLengthDelimited(list, 1, static_cast<const char*>(data), size);
+  addFeature(key, bytesList, list);
+}
+
+void TFRecordExample::addInt64s(const std::string& key, const std::vector<int64_t>& values)
+{
+  std::string packed;
+  for (int64_t value : values)
+    appendVarint(packed, static_cast<uint64_t>(value));
+  std::string list;
+  appendLengthDelimited(list, 1, packed);
+  addFeature(key, int64List, list);
+}
+
+void TFRecordExample::addFloats(const std::string& key, const std::vector<float>& values)
+{
+  std::string packed;
+  for (float value : values)
+    appendLittleEndian(packed, value);
+  std::string list;
+  appendLengthDelimited(list, 1, packed);
+  addFeature(key, floatList, list);
+}
+
+void TFRecordExample::addFeature(const std::string& key, FeatureKind kind, const std::string& list)
+{
+  // Features.feature is a map<string, Feature>, i.e. a repeated message of key (1) and value (2).
+  std::string feature;
+  appendLengthDelimited(feature, kind, list);
+  std::string entry;
+  appendLengthDelimited(entry, 1, key);
+  appendLengthDelimited(entry, 2, feature);
+  appendLengthDelimited(features, 1, entry);
+}
+
+std::string TFRecordExample::serialize() const
+{
+  std::string example;
+  appendLengthDelimited(example, 1, features);
+  return example;
+}
+
+TFRecordWriter::TFRecordWriter(const std::string& directory, const std::string& prefix, unsigned recordsPerShard) :
+  directory(directory), prefix(prefix), recordsPerShard(recordsPerShard > 0 ? recordsPerShard : 1)
+{
+  if (!this->directory.empty() && this->directory.back() != '/')
+    this->directory += '/';
+}
+
+TFRecordWriter::~TFRecordWriter()
+{
+  if (file)
+    fclose(file);
+}
+
+bool TFRecordWriter::openNextShard()
+{
+  if (file)
+  {
+    fclose(file);
+    file = nullptr;
+  }
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+
+  // shards of earlier runs with the same prefix are not overwritten
+  std::string filename;
+  do
+  {
+    char number[16];
+    snprintf(number, sizeof(number), "%05u", shard++);
+    filename = directory + prefix + "-" + number + ".tfrecord";
+  } while (std::filesystem::exists(filename, error));
+
+  file = fopen(filename.c_str(), "wb");
+  recordsInShard = 0;
+  return file != nullptr;
+}
+
+bool TFRecordWriter::write(const std::string& record)
+{
+  if ((!file || recordsInShard >= recordsPerShard) && !openNextShard())
+    return false;
+
+  // uint64 length, uint32 masked crc of length, data, uint32 masked crc of data
+  std::string header;
+  appendLittleEndian(header, static_cast<uint64_t>(record.size()));
+  appendLittleEndian(header, maskedCRC32C(header.data(), header.size()));
+  std::string footer;
+  appendLittleEndian(footer, maskedCRC32C(record.data(), record.size()));
+
+  if (fwrite(header.data(), 1, header.size(), file) != header.size()
+     || fwrite(record.data(), 1, record.size(), file) != record.size()
+     || fwrite(footer.data(), 1, footer.size(), file) != footer.size())
+  {
+    // the shard is corrupt from here on, so the next record starts a new one
+    fclose(file);
+    file = nullptr;
+    return false;
+  }
+  ++recordsInShard;
+  ++numOfRecords;
+  return true;
+}
+
+void TFRecordWriter::flush()
+{
+  if (file)
+    fflush(file);
+}
+
+uint32_t TFRecordWriter::maskedCRC32C(const void* data, size_t size)
+{
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < size; ++i)
+    crc = crcTable[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  crc ^= 0xffffffffu;
+  return ((crc >> 15) | (crc << 17)) + 0xa282ead8u;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file TFRecordWriter.h
+ *
+ * Declaration of classes that write labeled samples into sharded TFRecord files.
+ * Each record is a tf.train.Example, so the files can be read directly with
+ * tf.data.TFRecordDataset. The examples are encoded by hand, i.e. neither
+ * protobuf nor TensorFlow is required to write them. Writing many samples into
+ * a few large files is much faster than writing a PNG file per sample.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * A tf.train.Example that is built feature by feature. Every key must only be
+ * added once.
+ */
+class TFRecordExample
+{
+public:
+  void addBytes(const std::string& key, const void* data, size_t size);
+  void addBytes(const std::string& key, const std::string& value) { addBytes(key, value.data(), value.size()); }
+  void addInt64s(const std::string& key, const std::vector<int64_t>& values);
+  void addInt64(const std::string& key, int64_t value) { addInt64s(key, {value}); }
+  void addFloats(const std::string& key, const std::vector<float>& values);
+  void addFloat(const std::string& key, float value) { addFloats(key, {value}); }
+
+  /**
+   * Returns the serialized tf.train.Example.
+   * @return The protobuf wire format of the example.
+   */
+  std::string serialize() const;
+
+private:
+  enum FeatureKind
+  {
+    bytesList = 1,
+    floatList = 2,
+    int64List = 3
+  };
+
+  std::string features; /**< The serialized map entries of the features added so far. */
+
+  /**
+   * Adds a feature.
+   * @param key The name of the feature.
+   * @param kind The list type of the feature.
+   * @param list The serialized list message.
+   */
+  void addFeature(const std::string& key, FeatureKind kind, const std::string& list);
+};
+
+/**
+ * Writes records into files "<prefix>-<shard>.tfrecord". A new shard is started
+ * after a number of records, so a dataset stays usable if the robot is switched
+ * off and training can read the shards in parallel.
+ */
+class TFRecordWriter
+{
+public:
+  /**
+   * @param directory The directory of the shards. It is created if necessary.
+   * @param prefix The start of the names of the shards.
+   * @param recordsPerShard The number of records after which the next shard is started.
+   */
+  TFRecordWriter(const std::string& directory, const std::string& prefix, unsigned recordsPerShard);
+
+  /** Closes the current shard. */
+  ~TFRecordWriter();
+
+  TFRecordWriter(const TFRecordWriter&) = delete;
+  TFRecordWriter& operator=(const TFRecordWriter&) = delete;
+
+  /**
+   * Appends a record to the current shard.
+   * @param example The example written.
+   * @return Was the record written?
+   */
+  bool write(const TFRecordExample& example) { return write(example.serialize()); }
+
+  /**
+   * Appends a record to the current shard.
+   * @param record The serialized record.
+   * @return Was the record written?
+   */
+  bool write(const std::string& record);
+
+  /** Writes buffered records to the file. */
+  void flush();
+
+  unsigned getNumOfRecords() const { return numOfRecords; }
+  const std::string& getDirectory() const { return directory; }
+
+  /**
+   * Computes the masked CRC-32C checksum that TFRecord files store for the length
+   * and for the data of each record.
+   * @param data The data.
+   * @param size The number of bytes.
+   * @return The checksum.
+   */
+  static uint32_t maskedCRC32C(const void* data, size_t size);
+
+private:
+  std::string directory;
+  std::string prefix;
+  unsigned recordsPerShard;
+  FILE* file = nullptr; /**< The current shard or nullptr if none is open. */
+  unsigned shard = 0; /**< The number of the next shard. */
+  unsigned recordsInShard = 0; /**< The number of records in the current shard. */
+  unsigned numOfRecords = 0; /**< The number of records written into all shards. */
+
+  /** Closes the current shard and opens the next one. */
+  bool openNextShard();
+};
@@ -0,0 +1,122 @@
+/**
+ * The file declares a ring buffer that stores a value per joint for the last frames.
+ * The entries of one frame are stored together and padded to a multiple of four,
+ * so all joints are updated at once with SSE instructions. The sums of all joints
+ * are maintained on every push, i.e. the sums and averages are available in O(1)
+ * per joint.
+ */
+
+#pragma once
+
+#include "Tools/Joints.h"
+#include "Tools/SIMD.h"
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+template <typename T, std::size_t n, std::size_t channels = Joints::numOfJoints> class JointHistory
+{
+  static_assert(std::is_same<T, float>::value || std::is_same<T, int>::value, "Only float and int values are supported");
+  static_assert(n > 0, "The history must contain at least one entry");
+
+public:
+  static constexpr std::size_t paddedChannels = (channels + 3) & ~std::size_t(3);
+
+  using Entry = std::array<T, paddedChannels>;
+
+  JointHistory() { clear(); }
+
+  /** Empties the history. */
+  void clear()
+  {
+    head = 0;
+    count = 0;
+    sums.fill(T());
+  }
+
+  /**
+   * Adds the values of all joints to the front of the history. If the history was
+   * already full, the values at index n - 1 are lost.
+   * @param values The values, indexable by the joint. They are converted to T.
+   */
+  template <typename Values> void push_front(const Values& values)
+  {
+    head = head == 0 ? n - 1 : head - 1;
+    Entry& entry = entries[head];
+    if (count == n)
+      old = entry; // the oldest entry is replaced by the new one
+    for (std::size_t i = 0; i < channels; ++i)
+      entry[i] = static_cast<T>(values[i]);
+    for (std::size_t i = channels; i < paddedChannels; ++i)
+      entry[i] = T();
+
+    if (count < n)
+    {
+      ++count;
+      add(entry, zero);
+    }
+    else if (head == 0)
+      recalculateSums(); // prevent propagating rounding errors from one round to another
+    else
+      add(entry, old);
+  }
+
+  /** Fills the whole history with the same values. */
+  template <typename Values> void fill(const Values& values)
+  {
+    clear();
+    for (std::size_t i = 0; i < n; ++i)
+      push_front(values);
+  }
+
+  /**
+   * The values of a frame.
+   * @param i The age of the entry, 0 is the newest one.
+   */
+  const Entry& operator[](std::size_t i) const { return entries[(head + i) % n]; }
+
+  /** The sum of the values of a joint in O(1). */
+  T sum(std::size_t channel) const { return sums[channel]; }
+
+  /** The average of the values of a joint in O(1), 0 if the history is empty. */
+  T average(std::size_t channel) const { return count ? static_cast<T>(sums[channel] / static_cast<T>(count)) : T(); }
+
+  /** The sums of all joints. */
+  const Entry& sumsOfAllJoints() const { return sums; }
+
+  std::size_t size() const { return count; }
+  std::size_t capacity() const { return n; }
+  bool empty() const { return count == 0; }
+  bool full() const { return count == n; }
+
+private:
+  /** Adds an entry to the sums and subtracts the one it replaced. */
+  void add(const Entry& entry, const Entry& replaced)
+  {
+    for (std::size_t i = 0; i < paddedChannels; i += 4)
+    {
+      if constexpr (std::is_same<T, float>::value)
+        _mm_storeu_ps(&sums[i], _mm_add_ps(_mm_loadu_ps(&sums[i]), _mm_sub_ps(_mm_loadu_ps(&entry[i]), _mm_loadu_ps(&replaced[i]))));
+      else
+      {
+        const __m128i difference = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&entry[i])), _mm_loadu_si128(reinterpret_cast<const __m128i*>(&replaced[i])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&sums[i]), _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&sums[i])), difference));
+      }
+    }
+  }
+
+  /** Sums up all entries from scratch in O(n * channels). Only called once every n pushes. */
+  void recalculateSums()
+  {
+    sums.fill(T());
+    for (const Entry& entry : entries)
+      add(entry, zero);
+  }
+
+  alignas(16) std::array<Entry, n> entries; /**< The entries, the newest one is at \c head. */
+  alignas(16) Entry sums; /**< The sums of all entries per joint. */
+  alignas(16) Entry old; /**< The entry replaced by the current push. */
+  static constexpr Entry zero = {}; /**< Subtracted while the history is not full yet. */
+  std::size_t head = 0; /**< The index of the newest entry. */
+  std::size_t count = 0; /**< The number of entries. */
+};
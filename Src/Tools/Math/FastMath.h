@@ -0,0 +1,300 @@
+/**
+ * @file Tools/Math/FastMath.h
+ *
+ * Approximations of trigonometric and exponential functions with a precision
+ * that is selected at compile time. Each function exists for a single float
+ * and for four floats in an SSE register. The batch versions for spans process
+ * the bulk of the values four at a time.
+ */
+
+#pragma once
+
+#include "Tools/Math/Constants.h"
+#include "Tools/Math/sse_mathfun.h"
+#include "Tools/SIMD.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace FastMath
+{
+  /** The precision of the results. */
+  enum class Precision
+  {
+    exact, /**< The functions of the standard library, sse_mathfun for the SSE versions. */
+    high, /**< Absolute error < 1e-4, relative error < 1e-4 for exp. */
+    low /**< Absolute error < 1e-2, relative error < 1e-2 for exp. */
+  };
+
+  namespace impl
+  {
+    // Near-minimax polynomials. sin(x) = x * P(x^2) for |x| <= pi/2, atan(x) = x * P(x^2)
+    // for |x| <= 1 and 2^x = P(x) for 0 <= x < 1. Their errors are 6.8e-5, 8.1e-5 and 7.5e-5
+    // (rel.) with high precision and 4.5e-3, 6.1e-4 and 1.7e-3 (rel.) with low precision.
+    template <Precision precision> struct Coefficients;
+
+    template <> struct Coefficients<Precision::high>
+    {
+      static constexpr float sin[] = {0.99969677f, -0.16567307f, 0.0075143751f};
+      static constexpr float atan[] = {0.99921385f, -0.32117501f, 0.14626432f, -0.038986361f};
+      static constexpr float exp2[] = {0.99992517f, 0.69583458f, 0.22606399f, 0.078026804f};
+    };
+
+    template <> struct Coefficients<Precision::low>
+    {
+      static constexpr float sin[] = {0.98552927f, -0.14256658f};
+      static constexpr float atan[] = {0.99535799f, -0.28868995f, 0.079338659f};
+      static constexpr float exp2[] = {1.0017258f, 0.65762493f, 0.33720225f};
+    };
+
+    template <size_t n> inline float polynomial(const float (&c)[n], float x)
+    {
+      float result = c[n - 1];
+      for (size_t i = n - 1; i > 0; --i)
+        result = result * x + c[i - 1];
+      return result;
+    }
+
+    template <size_t n> inline __m128 polynomial(const float (&c)[n], __m128 x)
+    {
+      __m128 result = _mm_set1_ps(c[n - 1]);
+      for (size_t i = n - 1; i > 0; --i)
+        result = _mm_add_ps(_mm_mul_ps(result, x), _mm_set1_ps(c[i - 1]));
+      return result;
+    }
+
+    /** mask ? a : b */
+    inline __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+      return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    /** Rounds to the nearest integer, which is exact for the magnitudes used here. */
+    inline __m128 round(__m128 x)
+    {
+      return _mm_cvtepi32_ps(_mm_cvtps_epi32(x));
+    }
+
+    /**
+     * Applies a function to four values at a time.
+     * @param x The arguments.
+     * @param result The results, must have the same size as the arguments.
+     * @param f The function for four values.
+     */
+    template <typename F> inline void apply(std::span<const float> x, std::span<float> result, F f)
+    {
+      size_t i = 0;
+      for (; i + 4 <= x.size(); i += 4)
+        _mm_storeu_ps(&result[i], f(_mm_loadu_ps(&x[i])));
+      if (i < x.size())
+      {
+        alignas(16) float rest[4] = {0.f};
+        std::copy(x.begin() + i, x.end(), rest);
+        _mm_store_ps(rest, f(_mm_load_ps(rest)));
+        std::copy(rest, rest + (x.size() - i), result.begin() + i);
+      }
+    }
+  } // namespace impl
+
+  /**
+   * The sine.
+   * @tparam precision The precision required.
+   * @param x The angle in radians.
+   * @return The sine of the angle.
+   */
+  template <Precision precision = Precision::high> inline float sin(float x)
+  {
+    if constexpr (precision == Precision::exact)
+      return std::sin(x);
+    else
+    {
+      // reduce to [-pi, pi] and then to [-pi/2, pi/2]
+      x -= pi2 * std::nearbyint(x * (1.f / pi2));
+      if (x > pi_2)
+        x = pi - x;
+      else if (x < -pi_2)
+        x = -pi - x;
+      return x * impl::polynomial(impl::Coefficients<precision>::sin, x * x);
+    }
+  }
+
+  template <Precision precision = Precision::high> inline __m128 sin(__m128 x)
+  {
+    if constexpr (precision == Precision::exact)
+      return sin_ps(x);
+    else
+    {
+      x = _mm_sub_ps(x, _mm_mul_ps(_mm_set1_ps(pi2), impl::round(_mm_mul_ps(x, _mm_set1_ps(1.f / pi2)))));
+      x = impl::select(_mm_cmpgt_ps(x, _mm_set1_ps(pi_2)), _mm_sub_ps(_mm_set1_ps(pi), x), x);
+      x = impl::select(_mm_cmplt_ps(x, _mm_set1_ps(-pi_2)), _mm_sub_ps(_mm_set1_ps(-pi), x), x);
+      return _mm_mul_ps(x, impl::polynomial(impl::Coefficients<precision>::sin, _mm_mul_ps(x, x)));
+    }
+  }
+
+  /**
+   * The cosine.
+   * @tparam precision The precision required.
+   * @param x The angle in radians.
+   * @return The cosine of the angle.
+   */
+  template <Precision precision = Precision::high> inline float cos(float x)
+  {
+    if constexpr (precision == Precision::exact)
+      return std::cos(x);
+    else
+      return sin<precision>(x + pi_2);
+  }
+
+  template <Precision precision = Precision::high> inline __m128 cos(__m128 x)
+  {
+    if constexpr (precision == Precision::exact)
+      return cos_ps(x);
+    else
+      return sin<precision>(_mm_add_ps(x, _mm_set1_ps(pi_2)));
+  }
+
+  /**
+   * The angle of a vector. In contrast to std::atan2, the sign of zeros is ignored.
+   * @tparam precision The precision required.
+   * @param y The y coordinate of the vector.
+   * @param x The x coordinate of the vector.
+   * @return The angle in [-pi, pi], 0 if both coordinates are 0.
+   */
+  template <Precision precision = Precision::high> inline float atan2(float y, float x)
+  {
+    if constexpr (precision == Precision::exact)
+      return std::atan2(y, x);
+    else
+    {
+      const float absX = std::abs(x);
+      const float absY = std::abs(y);
+      const float max = std::max(absX, absY);
+      if (max == 0.f)
+        return 0.f;
+      const float z = std::min(absX, absY) / max;
+      float angle = z * impl::polynomial(impl::Coefficients<precision>::atan, z * z);
+      if (absY > absX)
+        angle = pi_2 - angle;
+      if (x < 0.f)
+        angle = pi - angle;
+      return y < 0.f ? -angle : angle;
+    }
+  }
+
+  template <Precision precision = Precision::high> inline __m128 atan2(__m128 y, __m128 x)
+  {
+    if constexpr (precision == Precision::exact)
+    {
+      alignas(16) float ys[4], xs[4];
+      _mm_store_ps(ys, y);
+      _mm_store_ps(xs, x);
+      for (int i = 0; i < 4; ++i)
+        ys[i] = std::atan2(ys[i], xs[i]);
+      return _mm_load_ps(ys);
+    }
+    else
+    {
+      const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+      const __m128 zero = _mm_setzero_ps();
+      const __m128 absX = _mm_and_ps(x, absMask);
+      const __m128 absY = _mm_and_ps(y, absMask);
+      const __m128 max = _mm_max_ps(absX, absY);
+      // 0 / 0 is replaced by 0 / 1
+      const __m128 z = _mm_div_ps(_mm_min_ps(absX, absY), impl::select(_mm_cmpeq_ps(max, zero), _mm_set1_ps(1.f), max));
+      __m128 angle = _mm_mul_ps(z, impl::polynomial(impl::Coefficients<precision>::atan, _mm_mul_ps(z, z)));
+      angle = impl::select(_mm_cmpgt_ps(absY, absX), _mm_sub_ps(_mm_set1_ps(pi_2), angle), angle);
+      angle = impl::select(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(pi), angle), angle);
+      return impl::select(_mm_cmplt_ps(y, zero), _mm_sub_ps(zero, angle), angle);
+    }
+  }
+
+  /**
+   * The exponential function.
+   * @tparam precision The precision required.
+   * @param x The exponent. Results that are not representable as normalized floats are clamped.
+   * @return e to the power of x.
+   */
+  template <Precision precision = Precision::high> inline float exp(float x)
+  {
+    if constexpr (precision == Precision::exact)
+      return std::exp(x);
+    else
+    {
+      // e^x = 2^i * 2^f with an integer i and 0 <= f < 1
+      const float t = std::clamp(x * 1.44269504f, -126.f, 127.f);
+      const float i = std::floor(t);
+      const std::int32_t bits = (static_cast<std::int32_t>(i) + 127) << 23;
+      float scale;
+      std::memcpy(&scale, &bits, sizeof(scale));
+      return scale * impl::polynomial(impl::Coefficients<precision>::exp2, t - i);
+    }
+  }
+
+  template <Precision precision = Precision::high> inline __m128 exp(__m128 x)
+  {
+    if constexpr (precision == Precision::exact)
+      return exp_ps(x);
+    else
+    {
+      const __m128 t = _mm_min_ps(_mm_max_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504f)), _mm_set1_ps(-126.f)), _mm_set1_ps(127.f));
+      // truncation rounds negative values up, so they are corrected by one
+      __m128 i = _mm_cvtepi32_ps(_mm_cvttps_epi32(t));
+      i = _mm_sub_ps(i, _mm_and_ps(_mm_cmpgt_ps(i, t), _mm_set1_ps(1.f)));
+      const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(i), _mm_set1_epi32(127)), 23));
+      return _mm_mul_ps(scale, impl::polynomial(impl::Coefficients<precision>::exp2, _mm_sub_ps(t, i)));
+    }
+  }
+
+  /**
+   * The logistic function 1 / (1 + e^-x).
+   * @tparam precision The precision of the exponential function.
+   * @param x The argument.
+   * @return The result in [0, 1].
+   */
+  template <Precision precision = Precision::high> inline float sigmoid(float x)
+  {
+    return 1.f / (1.f + exp<precision>(-x));
+  }
+
+  template <Precision precision = Precision::high> inline __m128 sigmoid(__m128 x)
+  {
+    const __m128 one = _mm_set1_ps(1.f);
+    return _mm_div_ps(one, _mm_add_ps(one, exp<precision>(_mm_sub_ps(_mm_setzero_ps(), x))));
+  }
+
+  /**
+   * Batch versions. The results must have the same size as the arguments.
+   * @param x The arguments.
+   * @param result The results.
+   */
+  template <Precision precision = Precision::high> inline void sin(std::span<const float> x, std::span<float> result)
+  {
+    impl::apply(x, result, [](__m128 v) { return sin<precision>(v); });
+  }
+
+  template <Precision precision = Precision::high> inline void cos(std::span<const float> x, std::span<float> result)
+  {
+    impl::apply(x, result, [](__m128 v) { return cos<precision>(v); });
+  }
+
+  template <Precision precision = Precision::high> inline void exp(std::span<const float> x, std::span<float> result)
+  {
+    impl::apply(x, result, [](__m128 v) { return exp<precision>(v); });
+  }
+
+  template <Precision precision = Precision::high> inline void sigmoid(std::span<const float> x, std::span<float> result)
+  {
+    impl::apply(x, result, [](__m128 v) { return sigmoid<precision>(v); });
+  }
+
+  template <Precision precision = Precision::high> inline void atan2(std::span<const float> y, std::span<const float> x, std::span<float> result)
+  {
+    size_t i = 0;
+    for (; i + 4 <= y.size(); i += 4)
+      _mm_storeu_ps(&result[i], atan2<precision>(_mm_loadu_ps(&y[i]), _mm_loadu_ps(&x[i])));
+    for (; i < y.size(); ++i)
+      result[i] = atan2<precision>(y[i], x[i]);
+  }
+} // namespace FastMath
@@ -15,8 +15,10 @@
 #include "Representations/Infrastructure/Image.h"
 #include "Representations/Modeling/RobotPose.h"
 #include "Representations/Perception/CameraMatrix.h"
+#include "Platform/BHAssert.h"
 #include "Tools/Math/BHMath.h"
 #include "Tools/Math/Eigen.h"
+#include "Tools/SIMD.h"
 #include <algorithm>
 #include <cstdlib>
 
@@ -244,6 +246,29 @@ float Geometry::getDistanceToLine(const Line& line, const Vector2f& point)
   return normal.dot(point) - c;
 }
 
+void Geometry::getDistanceToLine(const Line& line, std::span<const Vector2f> points, std::span<float> distances)
+{
+  ASSERT(points.size() == distances.size());
+  Vector2f normal(line.direction.y(), -line.direction.x());
+  normal.normalize();
+  const float c = normal.dot(line.base);
+
+  const __m128 normalX = _mm_set1_ps(normal.x());
+  const __m128 normalY = _mm_set1_ps(normal.y());
+  const __m128 c4 = _mm_set1_ps(c);
+  size_t i = 0;
+  for (; i + 4 <= points.size(); i += 4)
+  {
+    const __m128 p01 = _mm_loadu_ps(points[i].data());
+    const __m128 p23 = _mm_loadu_ps(points[i + 2].data());
+    const __m128 x = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 y = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm_storeu_ps(&distances[i], _mm_sub_ps(_mm_add_ps(_mm_mul_ps(x, normalX), _mm_mul_ps(y, normalY)), c4));
+  }
+  for (; i < points.size(); ++i)
+    distances[i] = normal.dot(points[i]) - c;
+}
+
 bool Geometry::getPerpendicularFootPointToLine(const Line& line, const Vector2f& point, Vector2f& perpendicularFootPoint)
 {
   Vector2f normal = Vector2f::Zero();
@@ -926,7 +951,7 @@ bool Geometry::computeCircleOnFieldLevenbergMarquardt(const std::vector<Vector2f
   return true;
 }
 
-Geometry::Line Geometry::calculateLineByLinearRegression(const std::vector<Vector2f>& pointsForLine, float& avgError, float& biggestError)
+Geometry::Line Geometry::calculateLineByLinearRegression(std::span<const Vector2f> pointsForLine, float& avgError, float& biggestError)
 {
   Geometry::Line result;
 
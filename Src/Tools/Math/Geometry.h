@@ -11,6 +11,7 @@
 #include "Tools/Math/Pose2f.h"
 #include "Tools/Streams/Streamable.h"
 #include "Tools/Math/Eigen.h"
+#include <span>
 #include <vector>
 
 struct CameraMatrix;
@@ -104,6 +105,14 @@ public:
   [[nodiscard]] static bool getIntersectionOfRaysFactor(const Line& ray1, const Line& ray2, float& intersection);
 
   static float getDistanceToLine(const Line& line, const Vector2f& point);
+  /**
+   * Signed distances of several points to a line. The normal of the line is
+   * only computed once.
+   * @param line The line.
+   * @param points The points.
+   * @param distances The distances of the points, must have the same size.
+   */
+  static void getDistanceToLine(const Line& line, std::span<const Vector2f> points, std::span<float> distances);
   static float getDistanceToEdge(const Line& line, const Vector2f& point);
   static bool getPerpendicularFootPointToLine(const Line& line, const Vector2f& point, Vector2f& perpendicularFootPoint);
 
@@ -249,7 +258,7 @@ public:
 
   static bool computeCircleOnFieldLevenbergMarquardt(const std::vector<Vector2f>& circlePoints, Geometry::Circle& circle);
 
-  static Geometry::Line calculateLineByLinearRegression(const std::vector<Vector2f>& pointsForLine, float& avgError, float& biggestError);
+  static Geometry::Line calculateLineByLinearRegression(std::span<const Vector2f> pointsForLine, float& avgError, float& biggestError);
 
   /**
    * Checks whether a point on the field would be visible without obstacles and 
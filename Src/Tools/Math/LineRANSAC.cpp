@@ -0,0 +1,121 @@
+/**
+ * @file Tools/Math/LineRANSAC.cpp
+ *
+ * Implementation of a class that fits a line into a set of points with RANSAC.
+ */
+
+#include "LineRANSAC.h"
+#include "Tools/SIMD.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+LineRANSAC::LineRANSAC() : randomGenerator(Random::generator()()) {}
+
+void LineRANSAC::setPoints(std::span<const Vector2f> points)
+{
+  numOfPoints = static_cast<unsigned>(points.size());
+  const size_t paddedSize = (points.size() + 3) & ~size_t(3);
+  xs.assign(paddedSize, 0.f);
+  ys.assign(paddedSize, 0.f);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    xs[i] = points[i].x();
+    ys[i] = points[i].y();
+  }
+}
+
+unsigned LineRANSAC::score(const Geometry::Line& line, float maxDistance, float& summedDistance) const
+{
+  Vector2f normal(line.direction.y(), -line.direction.x());
+  normal.normalize();
+  const float c = normal.dot(line.base);
+
+  const __m128 normalX = _mm_set1_ps(normal.x());
+  const __m128 normalY = _mm_set1_ps(normal.y());
+  const __m128 c4 = _mm_set1_ps(c);
+  const __m128 maxDistance4 = _mm_set1_ps(maxDistance);
+  const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128 numOfPoints4 = _mm_set1_ps(static_cast<float>(numOfPoints));
+  const __m128 four = _mm_set1_ps(4.f);
+  __m128 lane = _mm_set_ps(3.f, 2.f, 1.f, 0.f);
+  __m128 sum = _mm_setzero_ps();
+  unsigned numOfInliers = 0;
+  for (size_t i = 0; i < xs.size(); i += 4)
+  {
+    const __m128 distance = _mm_and_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&xs[i]), normalX), _mm_mul_ps(_mm_loadu_ps(&ys[i]), normalY)), c4), absMask);
+    // the padding is never an inlier
+    const __m128 inlier = _mm_and_ps(_mm_cmplt_ps(distance, maxDistance4), _mm_cmplt_ps(lane, numOfPoints4));
+    sum = _mm_add_ps(sum, _mm_and_ps(inlier, distance));
+    numOfInliers += std::popcount(static_cast<unsigned>(_mm_movemask_ps(inlier)));
+    lane = _mm_add_ps(lane, four);
+  }
+  alignas(16) float sums[4];
+  _mm_store_ps(sums, sum);
+  summedDistance = sums[0] + sums[1] + sums[2] + sums[3];
+  return numOfInliers;
+}
+
+LineRANSAC::Result LineRANSAC::fit(const Parameters& parameters)
+{
+  Result best;
+  const unsigned numOfSamplePoints = parameters.numOfSamplePoints ? std::min(parameters.numOfSamplePoints, numOfPoints) : numOfPoints;
+  if (numOfSamplePoints < 2)
+    return best;
+
+  unsigned iterations = parameters.maxIterations;
+  for (; best.iterations < iterations; ++best.iterations)
+  {
+    // the size of the set of the best points the line is sampled from
+    const unsigned progressiveSize = parameters.progressive ? 2 + best.iterations : numOfSamplePoints;
+    unsigned first, second;
+    if (progressiveSize < numOfSamplePoints)
+    {
+      second = progressiveSize - 1;
+      first = parameters.fixedBase ? 0 : std::uniform_int_distribution<unsigned>(0, second - 1)(randomGenerator);
+    }
+    else if (parameters.fixedBase)
+    {
+      first = 0;
+      second = std::uniform_int_distribution<unsigned>(1, numOfSamplePoints - 1)(randomGenerator);
+    }
+    else
+    {
+      first = std::uniform_int_distribution<unsigned>(0, numOfSamplePoints - 1)(randomGenerator);
+      second = std::uniform_int_distribution<unsigned>(0, numOfSamplePoints - 2)(randomGenerator);
+      if (second >= first)
+        ++second;
+    }
+
+    Geometry::Line line;
+    line.base = Vector2f(xs[first], ys[first]);
+    line.direction = Vector2f(xs[second], ys[second]) - line.base;
+    if (line.direction.isZero())
+      continue;
+
+    float summedDistance;
+    const unsigned numOfInliers = score(line, parameters.maxDistance, summedDistance);
+    if (numOfInliers > best.numOfInliers || (numOfInliers == best.numOfInliers && summedDistance < best.summedDistanceInliers))
+    {
+      best.line = line;
+      best.numOfInliers = numOfInliers;
+      best.summedDistanceInliers = summedDistance;
+
+      // the probability of drawing only inliers, the base is an inlier anyway if it is fixed
+      const float inlierRatio = static_cast<float>(numOfInliers) / static_cast<float>(numOfPoints);
+      const float allInliers = parameters.fixedBase ? inlierRatio : inlierRatio * inlierRatio;
+      if (allInliers >= 1.f)
+      {
+        ++best.iterations;
+        break;
+      }
+      if (allInliers > 0.f)
+      {
+        const float required = std::ceil(std::log(1.f - parameters.confidence) / std::log(1.f - allInliers));
+        if (required < static_cast<float>(iterations))
+          iterations = std::max(static_cast<unsigned>(required), best.iterations + 1);
+      }
+    }
+  }
+  return best;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file Tools/Math/LineRANSAC.h
+ *
+ * Declaration of a class that fits a line into a set of points with RANSAC.
+ */
+
+#pragma once
+
+#include "Tools/Math/Geometry.h"
+#include "Tools/Math/Random.h"
+#include <random>
+#include <span>
+#include <vector>
+
+/**
+ * Fits a line into 2D points that contain outliers. Lines through pairs of
+ * points are tested until one is found that, with the given confidence, has
+ * the most inliers. The number of lines tested is reduced whenever a better
+ * line is found, depending on its ratio of inliers. The points are stored as
+ * separate arrays of x and y coordinates, so that four of them are scored per
+ * SSE instruction.
+ *
+ * If the points are sorted by descending quality, the sampling can be
+ * progressive (PROSAC): The n-th line tested contains the (n+1)-th best point
+ * and one of the better points. After all points were added this way, the
+ * pairs are drawn uniformly.
+ *
+ * Each instance has its own random generator, which can be seeded to make the
+ * results reproducible, e.g. when replaying a log file.
+ */
+class LineRANSAC
+{
+public:
+  struct Parameters
+  {
+    float maxDistance = 1.f; /**< Points closer to a line than this are its inliers. */
+    unsigned maxIterations = 100; /**< The maximum number of lines tested. */
+    float confidence = 0.99f; /**< The probability that a pair of inliers was tested when stopping early. */
+    unsigned numOfSamplePoints = 0; /**< The lines only go through the first n points (0 = all). All points are scored. */
+    bool fixedBase = false; /**< Do all lines go through the first point? */
+    bool progressive = false; /**< Sample the better points first? The points must be sorted by descending quality. */
+  };
+
+  struct Result
+  {
+    Geometry::Line line; /**< The line through the first point of the pair in the direction of the second one. */
+    unsigned numOfInliers = 0; /**< 0 if no line was found. */
+    float summedDistanceInliers = 0.f; /**< The sum of the absolute distances of the inliers, used to resolve ties. */
+    unsigned iterations = 0; /**< The number of lines tested. */
+  };
+
+  /** Initializes the random generator from the one of the calling thread. */
+  LineRANSAC();
+
+  /**
+   * Restarts the random generator.
+   * @param seed The seed.
+   */
+  void seed(unsigned seed) { randomGenerator.seed(seed); }
+
+  /**
+   * Sets the points the next lines are fitted into.
+   * @param points The points, sorted by descending quality if the sampling is progressive.
+   */
+  void setPoints(std::span<const Vector2f> points);
+
+  /**
+   * Finds the line with the most inliers.
+   * @param parameters The parameters.
+   * @return The best line found.
+   */
+  Result fit(const Parameters& parameters);
+
+  /**
+   * Scores a line.
+   * @param line The line. Its direction must not be zero.
+   * @param maxDistance Points closer than this are inliers.
+   * @param summedDistance The sum of the absolute distances of the inliers is returned here.
+   * @return The number of inliers.
+   */
+  unsigned score(const Geometry::Line& line, float maxDistance, float& summedDistance) const;
+
+private:
+  std::vector<float> xs; /**< The x coordinates of the points, padded to a multiple of 4. */
+  std::vector<float> ys; /**< The y coordinates of the points, padded to a multiple of 4. */
+  unsigned numOfPoints = 0;
+  RandomGenerator randomGenerator;
+};
@@ -1,17 +1,244 @@
 /**
  * @file Math/Random.h
  * This contains some functions for creating random numbers.
+ * All functions use a generator of the calling thread, so they can be called
+ * from multiple threads. The generators are xoshiro128** generators, which are
+ * much faster than the generators of the standard library. The batch functions
+ * generate four numbers at once with SSE instructions.
  * @author <a href="mailto:martin.kallnik@gmx.de">Martin Kallnik</a>
  * @author Max Risler
  */
 
 #pragma once
 
-#include <cstdlib>
-#include <random>
+#include "Tools/Build.h"
+#include "Tools/Math/Constants.h"
+#include "Tools/Math/sse_mathfun.h"
+#include "Tools/SIMD.h"
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+
+/**
+ * The xoshiro128** generator by Blackman and Vigna. It has a state of 128 bits
+ * and satisfies the requirements of a UniformRandomBitGenerator, i.e. it can
+ * be used with the distributions of the standard library.
+ */
+class RandomGenerator
+{
+public:
+  using result_type = uint32_t;
+
+  explicit RandomGenerator(uint64_t seed = 0) { this->seed(seed); }
+
+  /**
+   * Sets the state from a seed. Similar seeds result in unrelated sequences.
+   * @param seed The seed.
+   */
+  void seed(uint64_t seed)
+  {
+    for (int i = 0; i < 4; i += 2)
+    {
+      const uint64_t value = splitMix64(seed);
+      state[i] = static_cast<uint32_t>(value);
+      state[i + 1] = static_cast<uint32_t>(value >> 32);
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()()
+  {
+    const uint32_t result = rotl(state[1] * 5, 7) * 9;
+    const uint32_t t = state[1] << 9;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 11);
+    return result;
+  }
+
+  /**
+   * Returns a random number in the range of [0..1).
+   * @return The random number.
+   */
+  float uniform() { return static_cast<float>((*this)() >> 8) * (1.f / 16777216.f); }
+
+  /**
+   * Hashes a 64 bit value and advances it, which is the SplitMix64 generator.
+   * @param value The value. It is advanced.
+   * @return The hashed value.
+   */
+  static uint64_t splitMix64(uint64_t& value)
+  {
+    uint64_t z = (value += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+private:
+  uint32_t state[4];
+
+  static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+};
 
-static std::default_random_engine randomGenerator(static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count()));
+/**
+ * Four xoshiro128** generators that run in the lanes of an SSE register.
+ */
+class RandomGenerator4
+{
+public:
+  /**
+   * Seeds the lanes from a generator, so they produce different sequences.
+   * @param generator The generator the seeds are taken from.
+   */
+  explicit RandomGenerator4(RandomGenerator& generator)
+  {
+    alignas(16) uint32_t values[4][4];
+    for (int i = 0; i < 4; ++i)
+    {
+      RandomGenerator lane((static_cast<uint64_t>(generator()) << 32) | generator());
+      for (int j = 0; j < 4; ++j)
+        values[j][i] = lane();
+    }
+    for (int j = 0; j < 4; ++j)
+      state[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(values[j]));
+  }
+
+  /** Returns four random numbers of 32 bits. */
+  __m128i operator()()
+  {
+    const __m128i result = times9(rotl<7>(times5(state[1])));
+    const __m128i t = _mm_slli_epi32(state[1], 9);
+    state[2] = _mm_xor_si128(state[2], state[0]);
+    state[3] = _mm_xor_si128(state[3], state[1]);
+    state[1] = _mm_xor_si128(state[1], state[2]);
+    state[0] = _mm_xor_si128(state[0], state[3]);
+    state[2] = _mm_xor_si128(state[2], t);
+    state[3] = rotl<11>(state[3]);
+    return result;
+  }
+
+  /** Returns four random numbers in the range of [0..1). */
+  __m128 uniform() { return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32((*this)(), 8)), _mm_set1_ps(1.f / 16777216.f)); }
+
+private:
+  __m128i state[4];
+
+  template <int k> static __m128i rotl(__m128i x) { return _mm_or_si128(_mm_slli_epi32(x, k), _mm_srli_epi32(x, 32 - k)); }
+  static __m128i times5(__m128i x) { return _mm_add_epi32(_mm_slli_epi32(x, 2), x); }
+  static __m128i times9(__m128i x) { return _mm_add_epi32(_mm_slli_epi32(x, 3), x); }
+};
+
+namespace Random
+{
+  namespace impl
+  {
+    /** The seed all generators are derived from. It is fixed in the simulator, so runs are reproducible. */
+    inline std::atomic<uint64_t> baseSeed{Build::targetSimulator() ? 0 : static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())};
+    inline std::atomic<uint64_t> threadCounter{0}; /**< Gives each thread that is not seeded explicitly its own stream. */
+  }
+
+  /**
+   * Returns the generator of the calling thread. Unless it was seeded with
+   * seed(), each thread gets a different stream.
+   * @return The generator.
+   */
+  inline RandomGenerator& generator()
+  {
+    thread_local RandomGenerator generator
+    {
+      [] {
+        uint64_t value = impl::baseSeed ^ (impl::threadCounter++ << 32);
+        return RandomGenerator::splitMix64(value);
+      }()
+    };
+    return generator;
+  }
+
+  /**
+   * Seeds the generator of the calling thread deterministically from the base
+   * seed and a name, e.g. of the robot and its thread. Threads with the same
+   * name produce the same sequence in each run of the simulator.
+   * @param name The name of the stream.
+   */
+  inline void seed(const std::string& name)
+  {
+    uint64_t value = impl::baseSeed;
+    for (char c : name)
+      value = (value ^ static_cast<unsigned char>(c)) * 0x100000001b3ull; // FNV-1a
+    generator().seed(value);
+  }
+
+  /**
+   * Fills an array with random numbers from a uniform distribution.
+   * @param values The array.
+   * @param n The number of values.
+   * @param min The smallest value.
+   * @param max The value that is never reached.
+   */
+  inline void fillUniform(float* values, size_t n, float min = 0.f, float max = 1.f)
+  {
+    RandomGenerator4 generator4(generator());
+    const __m128 offset = _mm_set1_ps(min);
+    const __m128 scale = _mm_set1_ps(max - min);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm_storeu_ps(values + i, _mm_add_ps(_mm_mul_ps(generator4.uniform(), scale), offset));
+    for (; i < n; ++i)
+      values[i] = generator().uniform() * (max - min) + min;
+  }
+
+  /**
+   * Fills an array with random numbers from a normal distribution.
+   * They are generated with the Box-Muller transform.
+   * @param values The array.
+   * @param n The number of values.
+   * @param mean The mean of the distribution.
+   * @param standardDeviation The standard deviation of the distribution.
+   */
+  inline void fillNormal(float* values, size_t n, float mean = 0.f, float standardDeviation = 1.f)
+  {
+    RandomGenerator4 generator4(generator());
+    const __m128 offset = _mm_set1_ps(mean);
+    const __m128 scale = _mm_set1_ps(standardDeviation);
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 minusTwo = _mm_set1_ps(-2.f);
+    const __m128 twoPi = _mm_set1_ps(Constants::pi2);
+    alignas(16) float buffer[8];
+    for (size_t i = 0; i < n; i += 8)
+    {
+      // 1 - u is in (0..1], so the logarithm is finite.
+      const __m128 radius = _mm_mul_ps(_mm_sqrt_ps(_mm_mul_ps(minusTwo, log_ps(_mm_sub_ps(one, generator4.uniform())))), scale);
+      __m128 sin, cos;
+      sincos_ps(_mm_mul_ps(generator4.uniform(), twoPi), &sin, &cos);
+      __m128 first = _mm_add_ps(_mm_mul_ps(radius, cos), offset);
+      __m128 second = _mm_add_ps(_mm_mul_ps(radius, sin), offset);
+      if (i + 8 <= n)
+      {
+        _mm_storeu_ps(values + i, first);
+        _mm_storeu_ps(values + i + 4, second);
+      }
+      else
+      {
+        _mm_store_ps(buffer, first);
+        _mm_store_ps(buffer + 4, second);
+        for (size_t j = i; j < n; ++j)
+          values[j] = buffer[j - i];
+      }
+    }
+  }
+}
 
 /**
  * The function returns a random number in the range of [0..1].
@@ -19,14 +246,12 @@ static std::default_random_engine randomGenerator(static_cast<unsigned int>(std:
  */
 static inline float randomFloat()
 {
-  std::uniform_real_distribution<float> rnd(0.0, 1.0);
-  return rnd(randomGenerator);
+  return Random::generator().uniform();
 }
 
 static inline float randomFloat(float min, float max)
 {
-  std::uniform_real_distribution<float> rnd(min, max);
-  return rnd(randomGenerator);
+  return Random::generator().uniform() * (max - min) + min;
 }
 
 /**
@@ -37,5 +262,5 @@ static inline float randomFloat(float min, float max)
 template <typename T, typename = std::enable_if<std::is_integral<T>::value>> static inline T random(T n)
 {
   std::uniform_int_distribution<T> rnd(0, n - 1);
-  return rnd(randomGenerator);
+  return rnd(Random::generator());
 }
@@ -11,6 +11,8 @@
 #include "Representations/Perception/CameraMatrix.h"
 #include "Representations/Infrastructure/CameraInfo.h"
 #include "Tools/Math/RotationMatrix.h"
+#include "Platform/BHAssert.h"
+#include "Tools/SIMD.h"
 
 using namespace std;
 
@@ -33,6 +35,52 @@ Vector2f Transformation::fieldToRobot(const Pose2f& rp, const Vector2f& fieldCoo
   return Vector2f(c * (fieldCoord.x() - x) - s * (fieldCoord.y() - y), s * (fieldCoord.x() - x) + c * (fieldCoord.y() - y));
 }
 
+void Transformation::robotToField(const Pose2f& rp, std::span<const Vector2f> relPos, std::span<Vector2f> fieldPos)
+{
+  ASSERT(relPos.size() == fieldPos.size());
+  const float s = std::sin(rp.rotation);
+  const float c = std::cos(rp.rotation);
+
+  // two points per register, i.e. (x0, y0, x1, y1)
+  const __m128 cos4 = _mm_set1_ps(c);
+  const __m128 sin4 = _mm_setr_ps(-s, s, -s, s);
+  const __m128 translation = _mm_setr_ps(rp.translation.x(), rp.translation.y(), rp.translation.x(), rp.translation.y());
+  size_t i = 0;
+  for (; i + 2 <= relPos.size(); i += 2)
+  {
+    const __m128 p = _mm_loadu_ps(relPos[i].data());
+    const __m128 swapped = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_ps(fieldPos[i].data(), _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, cos4), _mm_mul_ps(swapped, sin4)), translation));
+  }
+  for (; i < relPos.size(); ++i)
+    fieldPos[i] = Vector2f(relPos[i].x() * c - relPos[i].y() * s, relPos[i].x() * s + relPos[i].y() * c) + rp.translation;
+}
+
+void Transformation::fieldToRobot(const Pose2f& rp, std::span<const Vector2f> fieldPos, std::span<Vector2f> relPos)
+{
+  ASSERT(fieldPos.size() == relPos.size());
+  const float invRotation = -rp.rotation;
+  const float s = std::sin(invRotation);
+  const float c = std::cos(invRotation);
+
+  const __m128 cos4 = _mm_set1_ps(c);
+  const __m128 sin4 = _mm_setr_ps(-s, s, -s, s);
+  const __m128 translation = _mm_setr_ps(rp.translation.x(), rp.translation.y(), rp.translation.x(), rp.translation.y());
+  size_t i = 0;
+  for (; i + 2 <= fieldPos.size(); i += 2)
+  {
+    const __m128 d = _mm_sub_ps(_mm_loadu_ps(fieldPos[i].data()), translation);
+    const __m128 swapped = _mm_shuffle_ps(d, d, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_ps(relPos[i].data(), _mm_add_ps(_mm_mul_ps(d, cos4), _mm_mul_ps(swapped, sin4)));
+  }
+  for (; i < fieldPos.size(); ++i)
+  {
+    const float x = fieldPos[i].x() - rp.translation.x();
+    const float y = fieldPos[i].y() - rp.translation.y();
+    relPos[i] = Vector2f(c * x - s * y, s * x + c * y);
+  }
+}
+
 Vector2f Transformation::robotToFieldVelocity(const Pose2f& rp, const Vector2f& relVel)
 {
   const float s = std::sin(rp.rotation);
@@ -95,6 +143,44 @@ bool Transformation::imageToRobot(const Vector2i& pointInImage, const CameraMatr
   return imageToRobot(pointInImage.x(), pointInImage.y(), cameraMatrix, cameraInfo, relativePosition);
 }
 
+void Transformation::imageToRobot(std::span<const Vector2f> pointsInImage, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo,
+                                  std::span<Vector2f> relativePositions, std::span<bool> valid)
+{
+  ASSERT(pointsInImage.size() == relativePositions.size() && pointsInImage.size() == valid.size());
+  const Matrix3f& r = cameraMatrix.rotation;
+  const __m128 focalLengthInv = _mm_set1_ps(cameraInfo.focalLengthInv);
+  const __m128 opticalCenterX = _mm_set1_ps(cameraInfo.opticalCenter.x());
+  const __m128 opticalCenterY = _mm_set1_ps(cameraInfo.opticalCenter.y());
+  const __m128 horizon = _mm_set1_ps(-5 * cameraInfo.focalLengthInv);
+  const __m128 maxDist = _mm_set1_ps(MAX_DIST_ON_FIELD);
+  const __m128 signMask = _mm_set1_ps(-0.f);
+
+  // four points per register, i.e. (x0, x1, x2, x3) and (y0, y1, y2, y3)
+  size_t i = 0;
+  for (; i + 4 <= pointsInImage.size(); i += 4)
+  {
+    const __m128 p01 = _mm_loadu_ps(pointsInImage[i].data());
+    const __m128 p23 = _mm_loadu_ps(pointsInImage[i + 2].data());
+    const __m128 vy = _mm_mul_ps(_mm_sub_ps(opticalCenterX, _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0))), focalLengthInv);
+    const __m128 vz = _mm_mul_ps(_mm_sub_ps(opticalCenterY, _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1))), focalLengthInv);
+    const __m128 bx = _mm_add_ps(_mm_add_ps(_mm_set1_ps(r(0, 0)), _mm_mul_ps(_mm_set1_ps(r(0, 1)), vy)), _mm_mul_ps(_mm_set1_ps(r(0, 2)), vz));
+    const __m128 by = _mm_add_ps(_mm_add_ps(_mm_set1_ps(r(1, 0)), _mm_mul_ps(_mm_set1_ps(r(1, 1)), vy)), _mm_mul_ps(_mm_set1_ps(r(1, 2)), vz));
+    const __m128 bz = _mm_add_ps(_mm_add_ps(_mm_set1_ps(r(2, 0)), _mm_mul_ps(_mm_set1_ps(r(2, 1)), vy)), _mm_mul_ps(_mm_set1_ps(r(2, 2)), vz));
+    const __m128 f = _mm_div_ps(_mm_set1_ps(cameraMatrix.translation.z()), bz);
+    const __m128 x = _mm_sub_ps(_mm_set1_ps(cameraMatrix.translation.x()), _mm_mul_ps(f, bx));
+    const __m128 y = _mm_sub_ps(_mm_set1_ps(cameraMatrix.translation.y()), _mm_mul_ps(f, by));
+    const int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(bz, horizon),
+                                                _mm_and_ps(_mm_cmplt_ps(_mm_andnot_ps(signMask, x), maxDist),
+                                                           _mm_cmplt_ps(_mm_andnot_ps(signMask, y), maxDist))));
+    _mm_storeu_ps(relativePositions[i].data(), _mm_unpacklo_ps(x, y));
+    _mm_storeu_ps(relativePositions[i + 2].data(), _mm_unpackhi_ps(x, y));
+    for (size_t j = 0; j < 4; ++j)
+      valid[i + j] = (mask >> j) & 1;
+  }
+  for (; i < pointsInImage.size(); ++i)
+    valid[i] = imageToRobot(pointsInImage[i], cameraMatrix, cameraInfo, relativePositions[i]);
+}
+
 bool Transformation::imageToRobotHorizontalPlane(const Vector2f& pointInImage, float z, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, Vector2f& pointOnPlane)
 {
   const float xFactor = cameraInfo.focalLengthInv;
@@ -136,6 +222,40 @@ bool Transformation::robotToImage(const Vector2f& point, const CameraMatrix& cam
   return robotToImage(point3D, cameraMatrix, cameraInfo, pointInImage);
 }
 
+void Transformation::robotToImage(std::span<const Vector3f> points, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo,
+                                  std::span<Vector2f> pointsInImage, std::span<bool> valid)
+{
+  ASSERT(points.size() == pointsInImage.size() && points.size() == valid.size());
+  const Pose3f inverse = cameraMatrix.inverse();
+  const Matrix3f& r = inverse.rotation;
+  const __m128 focalLength = _mm_set1_ps(cameraInfo.focalLength);
+  const __m128 opticalCenterX = _mm_set1_ps(cameraInfo.opticalCenter.x());
+  const __m128 opticalCenterY = _mm_set1_ps(cameraInfo.opticalCenter.y());
+
+  // four points per register, i.e. (x0, x1, x2, x3), (y0, y1, y2, y3), and (z0, z1, z2, z3)
+  size_t i = 0;
+  for (; i + 4 <= points.size(); i += 4)
+  {
+    const Vector3f* p = &points[i];
+    const __m128 px = _mm_setr_ps(p[0].x(), p[1].x(), p[2].x(), p[3].x());
+    const __m128 py = _mm_setr_ps(p[0].y(), p[1].y(), p[2].y(), p[3].y());
+    const __m128 pz = _mm_setr_ps(p[0].z(), p[1].z(), p[2].z(), p[3].z());
+    const __m128 cx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r(0, 0)), px), _mm_mul_ps(_mm_set1_ps(r(0, 1)), py)), _mm_mul_ps(_mm_set1_ps(r(0, 2)), pz)), _mm_set1_ps(inverse.translation.x()));
+    const __m128 cy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r(1, 0)), px), _mm_mul_ps(_mm_set1_ps(r(1, 1)), py)), _mm_mul_ps(_mm_set1_ps(r(1, 2)), pz)), _mm_set1_ps(inverse.translation.y()));
+    const __m128 cz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r(2, 0)), px), _mm_mul_ps(_mm_set1_ps(r(2, 1)), py)), _mm_mul_ps(_mm_set1_ps(r(2, 2)), pz)), _mm_set1_ps(inverse.translation.z()));
+    const __m128 scale = _mm_div_ps(focalLength, cx);
+    const __m128 x = _mm_sub_ps(opticalCenterX, _mm_mul_ps(cy, scale));
+    const __m128 y = _mm_sub_ps(opticalCenterY, _mm_mul_ps(cz, scale));
+    const int mask = _mm_movemask_ps(_mm_cmpgt_ps(cx, _mm_setzero_ps()));
+    _mm_storeu_ps(pointsInImage[i].data(), _mm_unpacklo_ps(x, y));
+    _mm_storeu_ps(pointsInImage[i + 2].data(), _mm_unpackhi_ps(x, y));
+    for (size_t j = 0; j < 4; ++j)
+      valid[i + j] = (mask >> j) & 1;
+  }
+  for (; i < points.size(); ++i)
+    valid[i] = robotToImage(points[i], cameraMatrix, cameraInfo, pointsInImage[i]);
+}
+
 bool Transformation::robotWithCameraRotationToImage(const Vector2f& point, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, Vector2f& pointInImage)
 {
   Pose3f cameraRotatedMatrix;
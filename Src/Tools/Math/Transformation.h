@@ -11,6 +11,7 @@
 
 #include "Tools/Math/Pose2f.h"
 #include "Tools/Math/Eigen.h"
+#include <span>
 
 struct CameraMatrix;
 struct CameraInfo;
@@ -18,6 +19,15 @@ struct CameraInfo;
 /**
  * The class Transformation defines methods for
  * coordinate system transformations
+ *
+ * The batch versions that take spans compute the terms that only depend on
+ * the pose or the camera once and transform several points per SSE
+ * instruction. robotToField and fieldToRobot return the same results as the
+ * single-point versions bit for bit, as long as the compiler does not
+ * contract the single-point code into fused multiply-adds. The batch versions
+ * of imageToRobot and robotToImage sum the products of the rotation in a
+ * different order. Their results can differ by a few ULP, so that points
+ * exactly at a validity threshold can be classified differently.
  */
 class Transformation
 {
@@ -31,6 +41,14 @@ public:
    */
   static Vector2f robotToField(const Pose2f& rp, const Vector2f& relPos);
 
+  /**
+   * Transforms several positions relative to the robot to absolute field coordinates.
+   * @param rp Current robot pose
+   * @param relPos The positions relative to the robot
+   * @param fieldPos The positions in absolute field coordinates. Must have the same size as relPos, but may be the same span.
+   */
+  static void robotToField(const Pose2f& rp, std::span<const Vector2f> relPos, std::span<Vector2f> fieldPos);
+
   /**
    * Function does the transformation from absolute 2D field coordinates
    * to coordinates relative to the robot.
@@ -40,6 +58,14 @@ public:
    */
   static Vector2f fieldToRobot(const Pose2f& rp, const Vector2f& fieldPos);
 
+  /**
+   * Transforms several positions in absolute field coordinates to coordinates relative to the robot.
+   * @param rp Current robot pose
+   * @param fieldPos The positions in absolute field coordinates
+   * @param relPos The positions relative to the robot. Must have the same size as fieldPos, but may be the same span.
+   */
+  static void fieldToRobot(const Pose2f& rp, std::span<const Vector2f> fieldPos, std::span<Vector2f> relPos);
+
   /**
    * Function does the transformation of velocity from 2D relative robot
    * coordinates to absolute field coordinates.
@@ -93,6 +119,19 @@ public:
   [[nodiscard]] static bool imageToRobot(const Vector2i& pointInImage, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, Vector2f& relativePosition);
   [[nodiscard]] static bool imageToRobot(const Vector2f& pointInImage, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, Vector2f& relativePosition);
 
+  /**
+   * Computes positions relative to the robot given several points in the image.
+   * @param pointsInImage The points in the image
+   * @param cameraMatrix The extrinsic camera parameters
+   * @param cameraInfo The intrinsic camera parameters
+   * @param relativePositions The resulting points. Must have the same size as pointsInImage.
+   * @param valid Whether each point is below the horizon and not too far away, i.e. what
+   *              the single-point version would return. Must have the same size as pointsInImage.
+   *              The positions of invalid points are undefined.
+   */
+  static void imageToRobot(std::span<const Vector2f> pointsInImage, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo,
+                           std::span<Vector2f> relativePositions, std::span<bool> valid);
+
   /**
    * Computes a position relative to the robot on a horizontal plane
    * given a position of a pixel in the image as well as the distance of the plane from the ground.
@@ -115,6 +154,18 @@ public:
    */
   [[nodiscard]] static bool robotToImage(const Vector3f& point, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, Vector2f& pointInImage);
   [[nodiscard]] static bool robotToImage(const Vector2f& point, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo, Vector2f& pointInImage);
+
+  /**
+   * Calculates where several relative points in the world appear in an image.
+   * @param points The coordinates of the points relative to the robot's origin.
+   * @param cameraMatrix The camera matrix of the image.
+   * @param cameraInfo The camera info of the image.
+   * @param pointsInImage The resulting points. Must have the same size as points.
+   * @param valid Whether each point is in front of the camera. Must have the same size as points.
+   *              The positions of invalid points are undefined.
+   */
+  static void robotToImage(std::span<const Vector3f> points, const CameraMatrix& cameraMatrix, const CameraInfo& cameraInfo,
+                           std::span<Vector2f> pointsInImage, std::span<bool> valid);
   /**
    * Calculated where a point relative to the robot and rotated by the z-axis of
    * the camera appears in the image. The point of this method is to easily manipulate relative
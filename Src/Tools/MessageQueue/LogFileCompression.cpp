@@ -0,0 +1,157 @@
+/**
+ * @file LogFileCompression.cpp
+ * Implementation of a class that compresses and decompresses the blocks of log files.
+ */
+
+#include "LogFileCompression.h"
+#include <lz4frame.h>
+#include <memory>
+#include <snappy-c.h>
+#include <zstd.h>
+
+namespace
+{
+  /** The contexts are expensive to create, so each thread keeps its own ones. */
+  ZSTD_CCtx* getZstdCompressionContext()
+  {
+    thread_local std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> context(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    return context.get();
+  }
+
+  ZSTD_DCtx* getZstdDecompressionContext()
+  {
+    thread_local std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+    return context.get();
+  }
+
+  LZ4F_dctx* getLz4DecompressionContext()
+  {
+    const auto create = []
+    {
+      LZ4F_dctx* context = nullptr;
+      return LZ4F_isError(LZ4F_createDecompressionContext(&context, LZ4F_VERSION)) ? nullptr : context;
+    };
+    thread_local std::unique_ptr<LZ4F_dctx, LZ4F_errorCode_t (*)(LZ4F_dctx*)> context(create(), &LZ4F_freeDecompressionContext);
+    return context.get();
+  }
+
+  LZ4F_preferences_t getLz4Preferences(int level, size_t size)
+  {
+    LZ4F_preferences_t preferences = LZ4F_INIT_PREFERENCES;
+    preferences.compressionLevel = level;
+    preferences.frameInfo.contentSize = size; // the reader needs the uncompressed size
+    return preferences;
+  }
+}
+
+size_t LogFileCompression::getMaxCompressedSize(Codec codec, size_t size)
+{
+  switch (codec)
+  {
+  case snappy:
+    return snappy_max_compressed_length(size);
+  case zstd:
+    return ZSTD_compressBound(size);
+  case lz4:
+  {
+    const LZ4F_preferences_t preferences = getLz4Preferences(0, size);
+    return LZ4F_compressFrameBound(size, &preferences);
+  }
+  default:
+    return size;
+  }
+}
+
+bool LogFileCompression::compress(Codec codec, int level, const char* source, size_t sourceSize, char* destination, size_t& destinationSize)
+{
+  switch (codec)
+  {
+  case snappy:
+    return snappy_compress(source, sourceSize, destination, &destinationSize) == SNAPPY_OK;
+  case zstd:
+  {
+    const size_t size = ZSTD_compressCCtx(getZstdCompressionContext(), destination, destinationSize, source, sourceSize, level);
+    if (ZSTD_isError(size))
+      return false;
+    destinationSize = size;
+    return true;
+  }
+  case lz4:
+  {
+    const LZ4F_preferences_t preferences = getLz4Preferences(level, sourceSize);
+    const size_t size = LZ4F_compressFrame(destination, destinationSize, source, sourceSize, &preferences);
+    if (LZ4F_isError(size))
+      return false;
+    destinationSize = size;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+bool LogFileCompression::getUncompressedSize(Codec codec, const char* source, size_t sourceSize, size_t& size)
+{
+  switch (codec)
+  {
+  case snappy:
+    return snappy_uncompressed_length(source, sourceSize, &size) == SNAPPY_OK;
+  case zstd:
+  {
+    const unsigned long long contentSize = ZSTD_getFrameContentSize(source, sourceSize);
+    if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN || contentSize == ZSTD_CONTENTSIZE_ERROR)
+      return false;
+    size = static_cast<size_t>(contentSize);
+    return true;
+  }
+  case lz4:
+  {
+    LZ4F_dctx* context = getLz4DecompressionContext();
+    if (!context)
+      return false;
+    LZ4F_frameInfo_t frameInfo;
+    size_t consumed = sourceSize;
+    const size_t result = LZ4F_getFrameInfo(context, &frameInfo, source, &consumed);
+    LZ4F_resetDecompressionContext(context);
+    if (LZ4F_isError(result) || frameInfo.contentSize == 0)
+      return false;
+    size = static_cast<size_t>(frameInfo.contentSize);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+bool LogFileCompression::uncompress(Codec codec, const char* source, size_t sourceSize, char* destination, size_t& destinationSize)
+{
+  switch (codec)
+  {
+  case snappy:
+    return snappy_uncompress(source, sourceSize, destination, &destinationSize) == SNAPPY_OK;
+  case zstd:
+  {
+    const size_t size = ZSTD_decompressDCtx(getZstdDecompressionContext(), destination, destinationSize, source, sourceSize);
+    if (ZSTD_isError(size))
+      return false;
+    destinationSize = size;
+    return true;
+  }
+  case lz4:
+  {
+    LZ4F_dctx* context = getLz4DecompressionContext();
+    if (!context)
+      return false;
+    size_t consumed = sourceSize;
+    const size_t result = LZ4F_decompress(context, destination, &destinationSize, source, &consumed, nullptr);
+    if (result != 0) // 0 means that the frame was decoded completely
+    {
+      LZ4F_resetDecompressionContext(context);
+      return false;
+    }
+    return true;
+  }
+  default:
+    return false;
+  }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file LogFileCompression.h
+ * Declaration of a class that compresses and decompresses the blocks of log files.
+ * Uncompressed log files are written without any blocks (codec none). Log files
+ * compressed with snappy start with the magic byte logFileCompressed. All other
+ * codecs are marked by the magic byte logFileCompressedWithCodec followed by
+ * the codec. All codecs store the uncompressed size in each compressed block.
+ */
+
+#pragma once
+
+#include "Tools/Enum.h"
+#include <cstddef>
+
+class LogFileCompression
+{
+public:
+  ENUM(Codec,
+    none,
+    snappy,
+    zstd,
+    lz4
+  );
+
+  /**
+   * Returns the maximum size of a compressed block.
+   * @param codec The codec used for compression.
+   * @param size The size of the uncompressed data.
+   * @return The size the destination buffer must have at least.
+   */
+  static size_t getMaxCompressedSize(Codec codec, size_t size);
+
+  /**
+   * Compresses a block.
+   * @param codec The codec used for compression.
+   * @param level The compression level. zstd: 1 (fast) ... 22 (small),
+   *              lz4: 0 (fast) ... 12 (small), ignored by snappy.
+   * @param source The data to compress.
+   * @param sourceSize The size of the data to compress.
+   * @param destination The buffer the compressed data is written to.
+   * @param destinationSize The size of the buffer. Is set to the size of the compressed data.
+   * @return Was the block compressed successfully?
+   */
+  static bool compress(Codec codec, int level, const char* source, size_t sourceSize, char* destination, size_t& destinationSize);
+
+  /**
+   * Determines the size of a block after decompression.
+   * @param codec The codec the block was compressed with.
+   * @param source The compressed block.
+   * @param sourceSize The size of the compressed block.
+   * @param size Is set to the size of the uncompressed data.
+   * @return Could the size be determined?
+   */
+  static bool getUncompressedSize(Codec codec, const char* source, size_t sourceSize, size_t& size);
+
+  /**
+   * Decompresses a block.
+   * @param codec The codec the block was compressed with.
+   * @param source The compressed block.
+   * @param sourceSize The size of the compressed block.
+   * @param destination The buffer the uncompressed data is written to.
+   * @param destinationSize The size of the buffer. Is set to the size of the uncompressed data.
+   * @return Was the block decompressed successfully?
+   */
+  static bool uncompress(Codec codec, const char* source, size_t sourceSize, char* destination, size_t& destinationSize);
+};
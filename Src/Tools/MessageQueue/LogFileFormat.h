@@ -13,5 +13,7 @@ ENUM(LogFileFormat,
   logFileUncompressed,
   logFileCompressed,
   logFileMessageIDs,
-  logFileStreamSpecification
+  logFileStreamSpecification,
+  logFileCompressedWithCodec, /**< Followed by a LogFileCompression::Codec, otherwise like logFileCompressed. */
+  logFileDeltaEncoded /**< Precedes the compression marker if the log contains idDeltaMessage entries. */
 );
@@ -0,0 +1,56 @@
+/**
+ * @file LogFileIndex.cpp
+ * Implementation of a class that describes the blocks of a compressed log file.
+ */
+
+#include "LogFileIndex.h"
+#include "Tools/Streams/InStreams.h"
+#include "Tools/Streams/OutStreams.h"
+#include <cstring>
+
+static constexpr size_t blockSize = sizeof(unsigned long long) + 6 * sizeof(unsigned) + 1 + sizeof(LogFileIndex::Block::messageIDs);
+
+size_t LogFileIndex::getSize() const
+{
+  return 2 * sizeof(unsigned) + blocks.size() * blockSize;
+}
+
+void LogFileIndex::write(Out& stream) const
+{
+  stream << 0u << version << static_cast<unsigned>(blocks.size());
+  for (const Block& block : blocks)
+  {
+    stream << block.offset << block.compressedSize << block.firstFrame << block.numberOfFrames << block.numberOfMessages
+           << block.firstTimestamp << block.lastTimestamp << block.gameState;
+    stream.write(block.messageIDs, sizeof(block.messageIDs));
+  }
+  stream << static_cast<unsigned>(getSize()) << magic;
+}
+
+bool LogFileIndex::read(const char* data, size_t size)
+{
+  blocks.clear();
+
+  unsigned indexSize, indexMagic;
+  if (size < 3 * sizeof(unsigned))
+    return false;
+  std::memcpy(&indexSize, data + size - 2 * sizeof(unsigned), sizeof(unsigned));
+  std::memcpy(&indexMagic, data + size - sizeof(unsigned), sizeof(unsigned));
+  if (indexMagic != magic || indexSize + 3 * sizeof(unsigned) > size)
+    return false;
+
+  InBinaryMemory stream(data + size - 2 * sizeof(unsigned) - indexSize, indexSize);
+  unsigned indexVersion, numOfBlocks;
+  stream >> indexVersion >> numOfBlocks;
+  if (indexVersion != version || 2 * sizeof(unsigned) + numOfBlocks * blockSize != indexSize)
+    return false;
+
+  blocks.resize(numOfBlocks);
+  for (Block& block : blocks)
+  {
+    stream >> block.offset >> block.compressedSize >> block.firstFrame >> block.numberOfFrames >> block.numberOfMessages
+           >> block.firstTimestamp >> block.lastTimestamp >> block.gameState;
+    stream.read(block.messageIDs, sizeof(block.messageIDs));
+  }
+  return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file LogFileIndex.h
+ * Declaration of a class that describes the blocks of a compressed log file.
+ * The Logger appends it to the log file after the last block:
+ *
+ * | ... | size of last block | last compressed block | 0 | index | size of index | magic |
+ *
+ * The 0 marks the end of the blocks for readers that do not know the index.
+ * All offsets are relative to the first block, i.e. to the byte behind the
+ * magic byte logFileCompressed (or behind the codec that follows logFileCompressedWithCodec).
+ */
+
+#pragma once
+
+#include "MessageIDs.h"
+#include <cstddef>
+#include <vector>
+
+class Out;
+
+class LogFileIndex
+{
+public:
+  static constexpr unsigned magic = 0x58444e49; /**< "INDX" at the end of an indexed log file. */
+  static constexpr unsigned version = 1; /**< The version of the index format. */
+
+  /** The description of a single compressed block. */
+  struct Block
+  {
+    unsigned long long offset = 0; /**< The position of the size of the block relative to the first block. */
+    unsigned compressedSize = 0; /**< The size of the compressed data in bytes (without its size). */
+    int firstFrame = 0; /**< The number of the first frame in the block. */
+    int numberOfFrames = 0; /**< The number of complete frames in the block. */
+    int numberOfMessages = 0; /**< The number of messages in the block. */
+    unsigned firstTimestamp = 0; /**< The system time when the first frame of the block was logged. */
+    unsigned lastTimestamp = 0; /**< The system time when the last frame of the block was logged. */
+    unsigned char gameState = 0; /**< The game state at the end of the block (see RoboCupGameControlData.h). */
+    unsigned char messageIDs[(numOfDataMessageIDs + 7) / 8] = {0}; /**< A bit per message id in the block, using the ids of the log file. */
+
+    /**
+     * Marks a message id as present in the block.
+     * @param id The message id as written by the logger.
+     */
+    void add(MessageID id)
+    {
+      if (id < numOfDataMessageIDs)
+        messageIDs[id >> 3] |= static_cast<unsigned char>(1 << (id & 7));
+    }
+
+    /**
+     * Checks whether a message id is present in the block.
+     * @param id The message id as used in the log file.
+     * @return Does the block contain messages with this id?
+     */
+    bool contains(unsigned char id) const { return id < numOfDataMessageIDs && messageIDs[id >> 3] & (1 << (id & 7)); }
+  };
+
+  std::vector<Block> blocks; /**< All blocks of the log file in the order they were written. */
+
+  /**
+   * Returns the size of the index without the end marker, its size and the magic number.
+   * @return The size in bytes.
+   */
+  size_t getSize() const;
+
+  /**
+   * Writes the end marker, the index, its size and the magic number.
+   * @param stream The log file positioned behind the last block.
+   */
+  void write(Out& stream) const;
+
+  /**
+   * Reads the index from the end of a log file.
+   * @param data The address of the first block of the log file, e.g. in a memory-mapped file.
+   * @param size The number of bytes from the first block to the end of the file.
+   * @return Was an index found? If not, the log file has to be scanned.
+   */
+  bool read(const char* data, size_t size);
+};
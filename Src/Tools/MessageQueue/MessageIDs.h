@@ -114,6 +114,9 @@ BIGENUM(MessageID,
     idTeamCommEvents,
     idBallchaser,
     idHeadAngleRequest,
+    idLoggerStatus,
+    idMotionTiming,
+    idDeltaMessage, /**< A delta-encoded message in a log file: | original id | keyframe? | data or XOR with the previous data of that id | */
 
     numOfDataMessageIDs /**< everything below this does not belong into log files */
   ),(
@@ -161,6 +164,9 @@ BIGENUM(MessageID,
     idPathDebugMessage,
     idExecutorObservings,
     idPingpong,
-    idTeamCommSenderOutput
+    idTeamCommSenderOutput,
+    idPerfCounters,
+    idTimingSummary,
+    idDebugConnectionStatus
   )
 );
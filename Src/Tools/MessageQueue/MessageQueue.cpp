@@ -43,7 +43,8 @@ void MessageQueue::copyAllMessages(MessageQueue& other)
 {
   if (queue.usedSize >= MessageQueueBase::headerSize)
   {
-    char* dest = other.queue.reserve(queue.usedSize - MessageQueueBase::headerSize);
+    // Queues with quotas must check each message.
+    char* dest = other.queue.quotas ? nullptr : other.queue.reserve(queue.usedSize - MessageQueueBase::headerSize);
     if (dest && !other.queue.mappedIDs)
     {
       memcpy(dest - MessageQueueBase::headerSize, queue.buf, queue.usedSize);
@@ -63,6 +64,12 @@ void MessageQueue::moveAllMessages(MessageQueue& other)
   clear();
 }
 
+void MessageQueue::swapMessages(MessageQueue& other)
+{
+  ASSERT(!mappedFile && !other.mappedFile);
+  queue.swapBuffers(other.queue);
+}
+
 void MessageQueue::clear()
 {
   queue.clear();
@@ -109,7 +116,7 @@ void MessageQueue::append(In& stream)
   if (numberOfMessages == 0x0fffffff)
     numberOfMessages = static_cast<unsigned>(-1);
   // Trying a direct copy. This is hacked, but fast.
-  char* dest = numberOfMessages == static_cast<unsigned>(-1) ? nullptr : queue.reserve(usedSize - MessageQueueBase::headerSize);
+  char* dest = numberOfMessages == static_cast<unsigned>(-1) || queue.quotas ? nullptr : queue.reserve(usedSize - MessageQueueBase::headerSize);
   if (dest)
   {
     stream.read(dest - MessageQueueBase::headerSize, usedSize);
@@ -186,3 +193,23 @@ char* MessageQueue::getStreamedData()
   ((unsigned*)queue.buf)[-1] = (queue.numberOfMessages & 0x0fffffff) | (static_cast<unsigned>(queue.usedSize >> 4) & 0xf0000000);
   return queue.buf - MessageQueueBase::queueHeaderSize;
 }
+
+void MessageQueue::setStreamedData(char* data)
+{
+  unsigned header[2];
+  memcpy(header, data, sizeof(header));
+  const size_t usedSize = header[0] | static_cast<size_t>(header[1] & 0xf0000000) << 4;
+  const unsigned numberOfMessages = header[1] & 0x0fffffff;
+  if (!queue.usedSize && !queue.writePosition && !queue.quotas && !queue.mappedIDs && !mappedFile && numberOfMessages != 0x0fffffff && usedSize <= queue.maximumSize)
+  {
+    queue.setBuffer(data + MessageQueueBase::queueHeaderSize);
+    queue.usedSize = usedSize;
+    queue.numberOfMessages = static_cast<int>(numberOfMessages);
+    queue.writePosition = 0;
+  }
+  else
+  {
+    InBinaryMemory stream(data);
+    append(stream);
+  }
+}
@@ -61,6 +61,40 @@ public:
    */
   void setSize(size_t size, size_t reserveForInfrastructure = 0) { queue.setSize(size, reserveForInfrastructure); }
 
+  /**
+   * The method limits the number of bytes messages of a certain id can occupy.
+   * This share of the queue is kept free for them.
+   * @param id The message id.
+   * @param size The maximum number of bytes including the message headers.
+   */
+  void setQuota(MessageID id, size_t size) { queue.setQuota(id, size); }
+
+  /**
+   * Returns the quota of a message id in bytes (0 = no quota).
+   */
+  size_t getQuota(MessageID id) const { return queue.getQuota(id); }
+
+  /**
+   * Returns the (maximum) size of the queue in bytes.
+   */
+  size_t getSize() const { return queue.getSize(); }
+
+  /**
+   * Returns the maximum number of bytes the queue used since the last call to resetPeaks().
+   */
+  size_t getPeakSize() const { return queue.getPeakSize(); }
+
+  /**
+   * Returns the maximum number of bytes messages of an id with a quota used since
+   * the last call to resetPeaks().
+   */
+  size_t getPeakUsage(MessageID id) const { return queue.getPeakUsage(id); }
+
+  /**
+   * Resets the statistics returned by getPeakSize() and getPeakUsage().
+   */
+  void resetPeaks() { queue.resetPeaks(); }
+
   /**
    * The method returns the size of memory which is needed to write the queue to a stream.
    * @return The number of bytes required.
@@ -74,6 +108,19 @@ public:
    */
   char* getStreamedData();
 
+  /**
+   * The method adds the messages of a queue in streamed format (see getStreamedData()).
+   * If this queue is empty and has neither quotas nor an id mapping, it references
+   * the messages instead of copying them. In that case, the data must stay valid until
+   * the queue is cleared or release() is called. Writing to the queue copies the
+   * messages first.
+   * @param data The streamed queue.
+   */
+  void setStreamedData(char* data);
+
+  /** The method copies messages referenced by setStreamedData() into the own buffer. */
+  void release() { queue.ownBuffer(true); }
+
   /**
    * The method calls a given message handler for all messages in the queue. Note that the messages
    * still remain in the queue and have to be removed manually with clear().
@@ -100,6 +147,14 @@ public:
    */
   void moveAllMessages(MessageQueue& other);
 
+  /**
+   * The method exchanges the messages of this queue with the ones of another
+   * queue without copying them, i.e. the queues exchange their buffers.
+   * Neither queue may have quotas, a message id mapping, or a mapped file.
+   * @param other The other queue. It must have the same size.
+   */
+  void swapMessages(MessageQueue& other);
+
   /**
    * The method deletes older messages from the queue if newer messages of same type
    * are already in the queue. However, some message types remain untouched.
@@ -130,6 +185,13 @@ public:
    */
   void removeMessage(int message) { queue.removeMessage(message); }
 
+  /**
+   * The method removes all messages from the queue for which a predicate is true.
+   * @param remove The predicate that is called with the id of each message.
+   * @return The number of messages removed.
+   */
+  int removeMessages(const std::function<bool(MessageID)>& remove) { return queue.removeMessages(remove); }
+
   /**
    * The method removes a message from the queue.
    */
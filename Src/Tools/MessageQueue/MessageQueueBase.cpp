@@ -31,11 +31,19 @@ MessageQueueBase::~MessageQueueBase()
   freeIndex();
   if (buf && ownedBuf)
     free(buf - queueHeaderSize);
+  if (spareBuf)
+    free(spareBuf - queueHeaderSize);
   if (mappedIDs)
   {
     delete[] mappedIDs;
     delete[] mappedIDNames;
   }
+  if (quotas)
+  {
+    delete[] quotas;
+    delete[] usedByID;
+    delete[] peakByID;
+  }
 }
 
 void MessageQueueBase::setSize(size_t size, size_t reserveForInfrastructure)
@@ -62,6 +70,51 @@ void MessageQueueBase::setSize(size_t size, size_t reserveForInfrastructure)
   maximumSize = size;
 }
 
+void MessageQueueBase::setQuota(MessageID id, size_t size)
+{
+  ASSERT(id < numOfMessageIDs);
+  if (!quotas)
+  {
+    quotas = new size_t[numOfMessageIDs];
+    usedByID = new size_t[numOfMessageIDs];
+    peakByID = new size_t[numOfMessageIDs];
+    std::fill(quotas, quotas + numOfMessageIDs, 0);
+    std::fill(peakByID, peakByID + numOfMessageIDs, 0);
+  }
+  quotas[id] = size;
+  countQuotaUsage();
+}
+
+void MessageQueueBase::resetPeaks()
+{
+  peakSize = usedSize;
+  if (peakByID)
+    std::copy(usedByID, usedByID + numOfMessageIDs, peakByID);
+}
+
+void MessageQueueBase::countQuotaUsage()
+{
+  peakSize = std::max(peakSize, usedSize);
+  if (!quotas)
+    return;
+
+  std::fill(usedByID, usedByID + numOfMessageIDs, 0);
+  for (size_t pos = 0; pos < usedSize; pos += (*reinterpret_cast<unsigned*>(buf + pos) >> 8) + headerSize)
+  {
+    const MessageID id = MessageID(buf[pos]);
+    if (id < numOfMessageIDs)
+      usedByID[id] += (*reinterpret_cast<unsigned*>(buf + pos) >> 8) + headerSize;
+  }
+
+  unusedQuotas = 0;
+  for (int i = 0; i < numOfMessageIDs; ++i)
+  {
+    if (usedByID[i] < quotas[i])
+      unusedQuotas += quotas[i] - usedByID[i];
+    peakByID[i] = std::max(peakByID[i], usedByID[i]);
+  }
+}
+
 void MessageQueueBase::clear()
 {
   usedSize = 0;
@@ -73,12 +126,15 @@ void MessageQueueBase::clear()
   lastMessage = 0;
   freeIndex();
 
-  if (!ownedBuf)
+  if (quotas)
   {
-    ownedBuf = true;
-    buf = reinterpret_cast<char*>(malloc(reservedSize + queueHeaderSize)) + queueHeaderSize;
-    ASSERT(buf);
+    std::fill(usedByID, usedByID + numOfMessageIDs, 0);
+    unusedQuotas = 0;
+    for (int i = 0; i < numOfMessageIDs; ++i)
+      unusedQuotas += quotas[i];
   }
+
+  ownBuffer(false);
 }
 
 void MessageQueueBase::createIndex()
@@ -106,17 +162,22 @@ void MessageQueueBase::removeMessage(int message)
 {
   freeIndex();
   selectedMessageForReadingPosition = 0;
-  int i;
-  for (i = 0; i < message; ++i)
+  for (int i = 0; i < message; ++i)
     selectedMessageForReadingPosition += getMessageSize() + headerSize;
-  usedSize = selectedMessageForReadingPosition;
-  for (++i; i < numberOfMessages; ++i)
+
+  // move the tail in a single block
+  const size_t begin = selectedMessageForReadingPosition;
+  const size_t end = begin + getMessageSize() + headerSize;
+  const MessageID id = MessageID(buf[begin]);
+  if (quotas && id < numOfMessageIDs)
   {
-    int mlength = getMessageSize() + headerSize;
-    selectedMessageForReadingPosition += mlength;
-    memcpy(buf + usedSize, buf + selectedMessageForReadingPosition, mlength);
-    usedSize = selectedMessageForReadingPosition;
+    const size_t unusedBefore = quotas[id] > usedByID[id] ? quotas[id] - usedByID[id] : 0;
+    usedByID[id] -= end - begin;
+    unusedQuotas += (quotas[id] > usedByID[id] ? quotas[id] - usedByID[id] : 0) - unusedBefore;
   }
+  memmove(buf + begin, buf + end, usedSize - end);
+  usedSize -= end - begin;
+
   readPosition = 0;
   --numberOfMessages;
   selectedMessageForReadingPosition = 0;
@@ -125,6 +186,7 @@ void MessageQueueBase::removeMessage(int message)
 
 char* MessageQueueBase::reserve(size_t size)
 {
+  ownBuffer(true);
   size_t currentSize = usedSize + headerSize + writePosition;
   if (currentSize + size > maximumSize)
     return 0;
@@ -164,12 +226,57 @@ char* MessageQueueBase::reserve(size_t size)
 void MessageQueueBase::setBuffer(char* buffer)
 {
   if (buf && ownedBuf)
-    free(buf - queueHeaderSize);
+    spareBuf = buf;
 
   buf = buffer;
   ownedBuf = false;
 }
 
+void MessageQueueBase::ownBuffer(bool copyMessages)
+{
+  if (ownedBuf)
+    return;
+
+#ifdef TARGET_ROBOT
+  const size_t size = maximumSize;
+  char* newBuf = spareBuf;
+#else
+  const size_t size = std::max(reservedSize, copyMessages ? usedSize : 0);
+  char* newBuf = size == reservedSize ? spareBuf : nullptr;
+  if (spareBuf && !newBuf)
+    free(spareBuf - queueHeaderSize);
+  reservedSize = size;
+#endif
+  if (!newBuf)
+    newBuf = reinterpret_cast<char*>(malloc(size + queueHeaderSize)) + queueHeaderSize;
+  ASSERT(newBuf);
+  if (copyMessages)
+    memcpy(newBuf, buf, usedSize);
+  buf = newBuf;
+  spareBuf = nullptr;
+  ownedBuf = true;
+}
+
+void MessageQueueBase::swapBuffers(MessageQueueBase& other)
+{
+  ASSERT(!quotas && !other.quotas);
+  ASSERT(!mappedIDs && !other.mappedIDs);
+  ASSERT(!messageIndex && !other.messageIndex);
+  ASSERT(!writePosition && !other.writePosition);
+  ASSERT(maximumSize == other.maximumSize);
+  std::swap(buf, other.buf);
+  std::swap(ownedBuf, other.ownedBuf);
+  std::swap(spareBuf, other.spareBuf);
+  std::swap(reservedSize, other.reservedSize);
+  std::swap(usedSize, other.usedSize);
+  std::swap(numberOfMessages, other.numberOfMessages);
+  peakSize = std::max(peakSize, usedSize);
+  other.peakSize = std::max(other.peakSize, other.usedSize);
+  selectedMessageForReadingPosition = other.selectedMessageForReadingPosition = 0;
+  readPosition = other.readPosition = 0;
+  lastMessage = other.lastMessage = 0;
+}
+
 void MessageQueueBase::write(const void* p, size_t size)
 {
   ASSERT(!messageIndex);
@@ -183,6 +290,16 @@ void MessageQueueBase::write(const void* p, size_t size)
   }
 }
 
+unsigned MessageQueueBase::getHashOfCurrentMessage() const
+{
+  // FNV-1a
+  unsigned hash = 2166136261u;
+  if (!writingOfLastMessageFailed)
+    for (const char* p = buf + usedSize + headerSize, *end = p + writePosition; p < end; ++p)
+      hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619u;
+  return hash;
+}
+
 bool MessageQueueBase::finishMessage(MessageID id)
 {
   ASSERT(buf);
@@ -190,7 +307,9 @@ bool MessageQueueBase::finishMessage(MessageID id)
   bool success = !writingOfLastMessageFailed;
   if (success)
   {
-    if (reserveForInfrastructure > maximumSize - usedSize - writePosition - headerSize)
+    if (quotas && quotas[id])
+      success = usedByID[id] + writePosition + headerSize <= quotas[id];
+    else if (reserveForInfrastructure + unusedQuotas > maximumSize - usedSize - writePosition - headerSize)
       switch (id)
       { // When these messages are lost, communication might get stuck
       case idProcessBegin:
@@ -223,6 +342,14 @@ bool MessageQueueBase::finishMessage(MessageID id)
       memcpy(buf + usedSize + 1, &writePosition, 3); // write the size of the message
       ++numberOfMessages;
       usedSize += writePosition + headerSize;
+      peakSize = std::max(peakSize, usedSize);
+      if (quotas)
+      {
+        const size_t unusedBefore = quotas[id] > usedByID[id] ? quotas[id] - usedByID[id] : 0;
+        usedByID[id] += writePosition + headerSize;
+        unusedQuotas -= unusedBefore - (quotas[id] > usedByID[id] ? quotas[id] - usedByID[id] : 0);
+        peakByID[id] = std::max(peakByID[id], usedByID[id]);
+      }
     }
   }
 
@@ -249,6 +376,41 @@ std::tuple<int, int> MessageQueueBase::countFramesAndMessages()
   return {numberOfFrames, numberOfMessagesWithinCompleteFrames};
 }
 
+int MessageQueueBase::removeMessages(const std::function<bool(MessageID)>& remove)
+{
+  freeIndex();
+  size_t pos = 0;
+  size_t newUsedSize = 0;
+  int numOfRemoved = 0;
+  for (int i = 0; i < numberOfMessages; ++i)
+  {
+    const size_t length = (*reinterpret_cast<unsigned*>(buf + pos) >> 8) + headerSize;
+    MessageID id = MessageID(buf[pos]);
+    if (id < numOfMappedIDs)
+      id = mappedIDs[id];
+    if (remove(id))
+      ++numOfRemoved;
+    else
+    {
+      if (newUsedSize != pos)
+        memmove(buf + newUsedSize, buf + pos, length);
+      newUsedSize += length;
+    }
+    pos += length;
+  }
+
+  if (numOfRemoved)
+  {
+    usedSize = newUsedSize;
+    numberOfMessages -= numOfRemoved;
+    countQuotaUsage();
+  }
+  readPosition = 0;
+  selectedMessageForReadingPosition = 0;
+  lastMessage = 0;
+  return numOfRemoved;
+}
+
 void MessageQueueBase::removeRepetitions()
 {
   ASSERT(!messageIndex);
@@ -300,11 +462,13 @@ void MessageQueueBase::removeRepetitions()
     case idLogResponse:
     case idExecutorObservings:
     case idPingpong:
+    case idTimingSummary:
       copy = true;
       break;
 
     // data only from latest frame
     case idStopwatch:
+    case idPerfCounters:
     case idDebugImage:
     case idDebugJPEGImage:
     case idDebugDrawing:
@@ -367,6 +531,7 @@ void MessageQueueBase::removeRepetitions()
   readPosition = 0;
   selectedMessageForReadingPosition = 0;
   lastMessage = 0;
+  countQuotaUsage();
 }
 
 MessageID MessageQueueBase::getMessageID() const
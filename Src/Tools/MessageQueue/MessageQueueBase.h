@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <string>
 #include <tuple>
 
@@ -22,6 +23,8 @@ class Out;
  * The class performs the memory management for the class MessageQueue.
  * On Windows, the queue will grow when needed, on the robot, it will remain constant at
  * the size defined by setSize() and reject further messages.
+ * Message ids can be given a quota of bytes. Their messages are rejected if the quota is
+ * exhausted, but the quota also remains available to them while other messages are written.
  */
 class MessageQueueBase
 {
@@ -30,6 +33,7 @@ private:
   static constexpr int queueHeaderSize = 2 * sizeof(unsigned); /**< The size of the header in a streamed queue. */
   char* buf = nullptr; /**< The buffer on that the queue works. */
   bool ownedBuf = true; /**< If the memory buffer is owned by this instance and the destructor calls free(). */
+  char* spareBuf = nullptr; /**< The own buffer kept while buf references memory of someone else. */
   size_t* messageIndex = 0; /**< An index of the beginnings of all messages. */
   unsigned char numOfMappedIDs = 0; /**< The number of ids in the translation table. If 0, there is no table. */
   MessageID* mappedIDs = nullptr; /**< The mapping of internal ids to external ids. */
@@ -44,6 +48,11 @@ private:
   int readPosition = 0; /**< The position up to where a message is already read. */
   int lastMessage = 0; /**< Cache the current message in the message queue. */
   int numberOfMessages = 0; /**< The number of messages stored. */
+  size_t* quotas = nullptr; /**< The maximum number of bytes per message id (incl. headers). Only allocated if quotas are set. */
+  size_t* usedByID = nullptr; /**< The number of bytes the messages of each id with a quota currently occupy. */
+  size_t* peakByID = nullptr; /**< The maximum of usedByID since the last call to resetPeaks(). */
+  size_t unusedQuotas = 0; /**< The number of bytes of all quotas not used yet. Other messages must leave them free. */
+  size_t peakSize = 0; /**< The maximum of usedSize since the last call to resetPeaks(). */
 
   friend class MessageQueue;
   friend class LogPlayer;
@@ -66,6 +75,41 @@ public:
    */
   size_t getSize() const { return maximumSize; }
 
+  /**
+   * The method limits the number of bytes messages of a certain id can occupy
+   * in the queue. These bytes cannot be used by messages of other ids, except for
+   * infrastructure messages. Queues with quotas copy messages from other queues
+   * one by one, so that each message is checked.
+   * @param id The message id.
+   * @param size The maximum number of bytes including the message headers.
+   */
+  void setQuota(MessageID id, size_t size);
+
+  /**
+   * Returns the maximum number of bytes that were used since the last call to resetPeaks().
+   */
+  size_t getPeakSize() const { return peakSize; }
+
+  /**
+   * Returns the maximum number of bytes that were used by messages of an id with
+   * a quota since the last call to resetPeaks().
+   * @param id The message id.
+   * @return The number of bytes or 0 if there is no quota for this id.
+   */
+  size_t getPeakUsage(MessageID id) const { return peakByID ? peakByID[id] : 0; }
+
+  /**
+   * Returns the quota of a message id.
+   * @param id The message id.
+   * @return The quota in bytes or 0 if the id has no quota.
+   */
+  size_t getQuota(MessageID id) const { return quotas ? quotas[id] : 0; }
+
+  /**
+   * Resets the peak usage statistics.
+   */
+  void resetPeaks();
+
   /**
    * The method removes all messages from the queue.
    */
@@ -77,6 +121,22 @@ public:
    */
   void removeMessage(int message);
 
+  /**
+   * The method removes all messages from the queue for which a predicate is true.
+   * The remaining messages are compacted in a single pass.
+   * @param remove The predicate that is called with the id of each message.
+   * @return The number of messages removed.
+   */
+  int removeMessages(const std::function<bool(MessageID)>& remove);
+
+  /**
+   * The method exchanges the buffers and thereby the messages of two queues.
+   * Neither queue may have quotas, a message id mapping, an index, or an
+   * unfinished message.
+   * @param other The other queue. It must have the same maximum size.
+   */
+  void swapBuffers(MessageQueueBase& other);
+
   /**
    * The method adds a number of bytes to the last message in the queue.
    * @param p The address the data is located at.
@@ -97,6 +157,12 @@ public:
    */
   void cancelMessage() { writePosition = 0; }
 
+  /**
+   * The method computes a hash of the data written to the current message so far.
+   * @return The hash.
+   */
+  unsigned getHashOfCurrentMessage() const;
+
   /**
    * The method counts the number of messages and frames. (E.g., for memory-mapped queues)
    * @return A tuple containing the the number of frames and the number of messages
@@ -204,7 +270,20 @@ private:
   /**
    * Sets the message queue buffer to the given pointer.
    * This can be used, e.g., to read from a memory-mapped file.
+   * The own buffer is kept and used again by ownBuffer().
    * @param buffer The address the data is located at.
   */
   void setBuffer(char* buffer);
+
+  /**
+   * Makes the queue work on its own buffer again after setBuffer() was called.
+   * @param copyMessages Copy the messages that are currently referenced?
+   */
+  void ownBuffer(bool copyMessages);
+
+  /**
+   * Determines the number of bytes used by messages with quotas from the
+   * contents of the queue, e.g. after messages were removed.
+   */
+  void countQuotaUsage();
 };
@@ -48,3 +48,8 @@ void OutMessage::cancelMessage()
 {
   queue.cancelMessage();
 }
+
+unsigned OutMessage::getHashOfCurrentMessage() const
+{
+  return queue.getHashOfCurrentMessage();
+}
@@ -142,6 +142,12 @@ public:
    */
   void cancelMessage();
 
+  /**
+   * Computes a hash of the data written to the current message so far.
+   * @return The hash.
+   */
+  unsigned getHashOfCurrentMessage() const;
+
   /** gives the MessageQueue class access to protected members */
   friend class MessageQueue;
 
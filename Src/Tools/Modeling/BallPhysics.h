@@ -15,7 +15,10 @@
 #include "Platform/BHAssert.h"
 #include "Tools/Math/Eigen.h"
 #include "Tools/Math/Geometry.h"
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include <span>
 
 /**
  * @class BallPhysics
@@ -211,6 +214,29 @@ public:
     }
   }
 
+  /**
+   * Computes the times (in seconds) the ball needs to pass several distances, with the
+   * same results as timeForDistance. The terms that only depend on the velocity are computed
+   * once and the loop over the distances has no branches, so the compiler vectorizes it.
+   * @param v The ball velocity (in mm/s)
+   * @param distances The distances (in mm)
+   * @param times The times are returned here. Must be at least as large as distances.
+   * @param ballFriction The ball friction (negative force)  (in m/s^2)
+   */
+  static void timesForDistances(const Vector2f& v, std::span<const float> distances, std::span<float> times, float ballFriction)
+  {
+    ASSERT(ballFriction < 0.f);
+    ASSERT(times.size() >= distances.size());
+    const float vb = v.norm() / 1000.f / ballFriction; // unit: seconds
+    const float stopDistance = -500.f * vb * vb * ballFriction; // unit: millimeter
+    const float factor = 2.f / (1000.f * ballFriction); // unit: seconds^2 / millimeter
+    for (size_t i = 0; i < distances.size(); ++i)
+    {
+      const float time = -std::sqrt(std::max(vb * vb + distances[i] * factor, 0.f)) - vb; // unit: seconds
+      times[i] = distances[i] > stopDistance ? std::numeric_limits<float>::max() : time;
+    }
+  }
+
   /**
    * Calculates the velocity needed to kick the ball a certain distance
    * @param distance the distance in mm
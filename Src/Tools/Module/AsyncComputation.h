@@ -0,0 +1,147 @@
+/**
+ * @file AsyncComputation.h
+ * The file declares a class template for computations of modules that may take
+ * longer than a frame. The computation runs in a background thread of its own
+ * and works only on a copy of its input, since the representations of the
+ * blackboard change while it runs. The module never waits for it: in each frame,
+ * it provides the most recent result that was completed and starts the next
+ * computation when the previous one is done. If the input changed so much that
+ * the current computation is useless, the module can restart it.
+ *
+ * The computation must not use debugging macros, annotations or the blackboard,
+ * because they are only available in the threads of the framework.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+template <typename Input, typename Result> class AsyncComputation
+{
+public:
+  /**
+   * The computation. It should check the flag from time to time and return early if
+   * it is set. The result of a computation that was cancelled is discarded.
+   */
+  using Function = std::function<Result(const Input& input, const std::atomic<bool>& cancelled)>;
+
+  explicit AsyncComputation(Function function) : function(std::move(function)), thread(&AsyncComputation::run, this) {}
+
+  AsyncComputation(const AsyncComputation&) = delete;
+  AsyncComputation& operator=(const AsyncComputation&) = delete;
+
+  /** Cancels the current computation and waits until the thread stopped. */
+  ~AsyncComputation()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      running = false;
+      pendingInput.reset();
+    }
+    cancelled = true;
+    inputAvailable.notify_one();
+    thread.join();
+  }
+
+  /** @return Does a computation run or wait to be run? */
+  bool isBusy() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return busy || pendingInput;
+  }
+
+  /**
+   * Starts a computation if none is running.
+   * @param input The input of the computation, which is moved into it.
+   * @return Was the computation started?
+   */
+  bool start(Input&& input)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (busy || pendingInput)
+        return false;
+      pendingInput.emplace(std::move(input));
+    }
+    inputAvailable.notify_one();
+    return true;
+  }
+
+  /**
+   * Cancels the current computation if there is one and starts a new one as soon
+   * as it returned.
+   * @param input The input of the new computation, which is moved into it.
+   */
+  void restart(Input&& input)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pendingInput.emplace(std::move(input));
+      if (busy)
+        cancelled = true;
+    }
+    inputAvailable.notify_one();
+  }
+
+  /**
+   * Moves the result of the computation completed most recently into the given
+   * variable if it has not been fetched before.
+   * @param result The variable that receives the result.
+   * @return Was there a new result?
+   */
+  bool fetch(Result& result)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!completedResult)
+      return false;
+    result = std::move(*completedResult);
+    completedResult.reset();
+    return true;
+  }
+
+  /** @return The number of computations completed so far, i.e. the version of the latest result. */
+  unsigned getVersion() const { return version.load(std::memory_order_acquire); }
+
+private:
+  Function function;
+  mutable std::mutex mutex; /**< Protects the pending input, the result and the states. */
+  std::condition_variable inputAvailable;
+  std::optional<Input> pendingInput; /**< The input of the next computation. */
+  std::optional<Result> completedResult; /**< The latest result not fetched yet. */
+  bool busy = false; /**< Does a computation run? */
+  bool running = true; /**< Is the thread supposed to keep running? */
+  std::atomic<bool> cancelled{false}; /**< Should the current computation be cancelled? */
+  std::atomic<unsigned> version{0};
+  std::thread thread;
+
+  /** The main function of the background thread. */
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+      inputAvailable.wait(lock, [this] { return !running || pendingInput; });
+      if (!running)
+        return;
+
+      Input input = std::move(*pendingInput);
+      pendingInput.reset();
+      cancelled = false;
+      busy = true;
+      lock.unlock();
+      Result result = function(input, cancelled);
+      lock.lock();
+      busy = false;
+      if (!cancelled)
+      {
+        completedResult.emplace(std::move(result));
+        version.fetch_add(1, std::memory_order_release);
+      }
+    }
+  }
+};
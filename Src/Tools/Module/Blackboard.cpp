@@ -6,9 +6,13 @@
 
 #include "Blackboard.h"
 #include "Tools/Streams/Streamable.h"
+#include "Tools/Streams/OutStreams.h"
 #include "Platform/BHAssert.h"
 #include "Platform/SystemCall.h"
+#include <algorithm>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #ifndef WINDOWS
 #include <cxxabi.h>
@@ -17,6 +21,11 @@
 /** The instance of the blackboard of the current process. */
 static thread_local Blackboard* theInstance = nullptr;
 
+/** The indices used by the existing blackboards. */
+static std::mutex indexMutex;
+static std::vector<bool> usedIndices;
+static unsigned lastSerialNumber = 0;
+
 /** The actual type of the map for all entries. */
 class Blackboard::Entries : public std::unordered_map<std::string, Blackboard::Entry>
 {
@@ -24,19 +33,36 @@ class Blackboard::Entries : public std::unordered_map<std::string, Blackboard::E
 class Blackboard::CopyEntries : public std::unordered_map<std::string, Blackboard::CopyEntry>
 {
 };
+class Blackboard::DoubleBuffered : public std::unordered_set<std::string>
+{
+};
 
-Blackboard::Blackboard() : entries(*new Entries), copyEntries(*new CopyEntries)
+Blackboard::Blackboard() : entries(*new Entries), copyEntries(*new CopyEntries), doubleBuffered(*new DoubleBuffered)
 {
+  clearSlots();
   theInstance = this;
+
+  std::lock_guard<std::mutex> lock(indexMutex);
+  index = std::find(usedIndices.begin(), usedIndices.end(), false) - usedIndices.begin();
+  if (index == usedIndices.size())
+    usedIndices.push_back(true);
+  else
+    usedIndices[index] = true;
+  serialNumber = ++lastSerialNumber;
 }
 
 Blackboard::~Blackboard()
 {
   ASSERT(theInstance == this);
   theInstance = 0;
+  {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    usedIndices[index] = false;
+  }
   ASSERT(entries.size() == 0);
   delete &entries;
   delete &copyEntries;
+  delete &doubleBuffered;
 }
 
 Blackboard::Entry& Blackboard::get(const char* representation)
@@ -76,6 +102,7 @@ void Blackboard::free(const char* representation)
   {
     entries.erase(representation);
     ++version;
+    clearSlots();
 
     std::string rep(representation);
     const size_t found = rep.rfind("-Copy");
@@ -95,7 +122,7 @@ void Blackboard::setInstance(Blackboard& blackboard)
   theInstance = &blackboard;
 }
 
-void Blackboard::addCopyEntry(const char* representation)
+void Blackboard::addCopyEntry(const char* representation, void (*swap)(Streamable&, Streamable&))
 {
   std::string rep(representation);
   Entry& entry = get(representation);
@@ -110,11 +137,14 @@ void Blackboard::addCopyEntry(const char* representation)
   else
   {
     rep = rep.replace(found, 5, "");
-    copyEntries[rep].copy = &*entry.data;
+    CopyEntry& copyEntry = copyEntries[rep];
+    copyEntry.copy = &*entry.data;
+    copyEntry.swap = swap;
+    copyEntry.doubleBuffered = doubleBuffered.find(rep) != doubleBuffered.end();
 
     auto nonCopy = entries.find(rep);
     if (nonCopy != entries.end())
-      copyEntries[rep].original = &*nonCopy->second.data;
+      copyEntry.original = &*nonCopy->second.data;
   }
 }
 
@@ -124,8 +154,72 @@ void Blackboard::copyUsedRepresentations()
   {
     // if a representation is provided by default, then there is no original
     if (copyEntry.copy && copyEntry.original)
-      *copyEntry.copy = *copyEntry.original;
+    {
+      if (copyEntry.doubleBuffered && copyEntry.swap)
+        copyEntry.swap(*copyEntry.copy, *copyEntry.original);
+      else
+        *copyEntry.copy = *copyEntry.original;
+    }
+  }
+}
+
+void Blackboard::setDoubleBuffered(const std::vector<std::string>& representations)
+{
+  doubleBuffered.clear();
+  doubleBuffered.insert(representations.begin(), representations.end());
+
+  for (auto& [rep, copyEntry] : copyEntries)
+    copyEntry.doubleBuffered = doubleBuffered.find(rep) != doubleBuffered.end();
+}
+
+std::vector<Blackboard::CopyStatistics> Blackboard::getCopyStatistics() const
+{
+  std::vector<CopyStatistics> statistics;
+  for (const auto& [rep, copyEntry] : copyEntries)
+  {
+    if (copyEntry.copy && copyEntry.original)
+    {
+      OutBinarySize size;
+      size << *copyEntry.original;
+      statistics.push_back({rep, size.getSize(), copyEntry.doubleBuffered && copyEntry.swap});
+    }
   }
+
+  std::sort(statistics.begin(),
+      statistics.end(),
+      [](const CopyStatistics& a, const CopyStatistics& b)
+      {
+        return a.bytes > b.bytes;
+      });
+  return statistics;
+}
+
+size_t Blackboard::allocSlot()
+{
+  static std::atomic<size_t> nextSlot{0};
+  return nextSlot.fetch_add(1, std::memory_order_relaxed);
+}
+
+const Streamable& Blackboard::lookup(const char* name, bool copy, size_t slot)
+{
+  const std::string demangledName = demangle(name) + (copy ? "-Copy" : "");
+
+  if (!exists(demangledName.c_str()))
+    throw std::out_of_range("Representation " + demangledName + " does not exist!");
+
+  const Streamable& data = (*this)[demangledName.c_str()];
+
+  // types beyond the number of slots always use the slow path
+  if (slot < slots.size())
+    slots[slot].store(&data, std::memory_order_relaxed);
+
+  return data;
+}
+
+void Blackboard::clearSlots()
+{
+  for (auto& slot : slots)
+    slot.store(nullptr, std::memory_order_relaxed);
 }
 
 std::string Blackboard::demangle(const char* name)
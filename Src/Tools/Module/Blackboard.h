@@ -8,36 +8,64 @@
 
 #pragma once
 #include "Platform/BHAssert.h"
+#include <array>
+#include <atomic>
 #include <memory>
 #include <typeinfo>
+#include <type_traits>
 #include <string>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 class Streamable;
 
 class Blackboard
 {
+public:
+  /** A function that creates an empty representation of a certain type. */
+  using Factory = std::unique_ptr<Streamable> (*)();
+
 private:
   /** A single entry of the blackboard. */
   struct Entry
   {
     std::unique_ptr<Streamable> data = nullptr; /**< The representation. */
     int counter = 0; /**< How many modules requested its existance? */
+    unsigned changes = 0; /**< How often was the representation modified? */
+    Factory factory = nullptr; /**< Creates another instance of the type of data. */
   };
 
   struct CopyEntry
   {
     Streamable* original = nullptr;
     Streamable* copy = nullptr;
+    void (*swap)(Streamable&, Streamable&) = nullptr; /**< Exchanges the contents of original and copy. Null if the type cannot be swapped. */
+    bool doubleBuffered = false; /**< Swap original and copy instead of copying? */
   };
 
   class Entries; /**< Type of the map for all entries. */
   Entries& entries; /**< All entries of the blackboard. */
   int version = 0; /**< A version that is increased with each configuration change. */
+  size_t index; /**< The smallest number not used by another blackboard that exists. */
+  unsigned serialNumber; /**< A number that no other blackboard created before had. */
 
   class CopyEntries;
   CopyEntries& copyEntries;
 
+  class DoubleBuffered;
+  DoubleBuffered& doubleBuffered; /**< The names of all representations that are swapped rather than copied. */
+
+  static constexpr size_t maxNumOfSlots = 1024; /**< The maximum number of representation types accessible through slots. */
+
+  /**
+   * Direct access to representations requested through get<T>(). Each type gets a
+   * slot index when it is accessed for the first time. Even slots cache the
+   * representation itself, odd slots its "-Copy". The cache is filled on the first
+   * access and cleared whenever a representation is removed from the blackboard.
+   */
+  std::array<std::atomic<const Streamable*>, 2 * maxNumOfSlots> slots;
+
   /**
    * Set the blackboard instance of a process.
    * Only Process::setGlobals calls this method.
@@ -57,12 +85,63 @@ private:
   Entry& get(const char* representation);
   const Entry& get(const char* representation) const;
 
-  void addCopyEntry(const char* representation);
+  void addCopyEntry(const char* representation, void (*swap)(Streamable&, Streamable&));
   void copyUsedRepresentations();
 
+  /**
+   * Exchange the contents of two representations of the same type.
+   * For representations that keep their data on the heap, this only
+   * exchanges pointers.
+   * @tparam T The type of both representations.
+   */
+  template <typename T> static void swapRepresentations(Streamable& a, Streamable& b)
+  {
+    std::swap(static_cast<T&>(a), static_cast<T&>(b));
+  }
+
+  template <typename T> static std::unique_ptr<Streamable> createRepresentation() { return std::make_unique<T>(); }
+
   static std::string demangle(const char* name);
 
+  /**
+   * Assign a new slot index. Called once per representation type.
+   * @return The index of the next free slot.
+   */
+  static size_t allocSlot();
+
+  /**
+   * Determine the slot index of a representation type.
+   * @tparam T The type of the representation.
+   * @return The index of the slot that caches the representation.
+   */
+  template <typename T> static size_t getSlot()
+  {
+    static const size_t slot = allocSlot();
+    return slot;
+  }
+
+  /**
+   * Find a representation by its mangled type name and remember it in a slot.
+   * This is the slow path of get<T>().
+   * @param name The mangled name of the type of the representation.
+   * @param copy Search the copied representation for USES() dependencies.
+   * @param slot The slot that will cache the representation.
+   * @return The instance of the representation in the blackboard.
+   */
+  const Streamable& lookup(const char* name, bool copy, size_t slot);
+
+  /** Clear all slots. */
+  void clearSlots();
+
 public:
+  /** Statistics about the representations copied for USES() dependencies. */
+  struct CopyStatistics
+  {
+    std::string representation; /**< The name of the representation. */
+    size_t bytes; /**< The (serialized) size of the representation, i.e. roughly the number of bytes copied each frame. */
+    bool doubleBuffered; /**< Is the representation swapped instead of copied? Then, virtually no bytes are copied. */
+  };
+
   /**
    * The default constructor creates the blackboard and sets it as
    * the instance of this process.
@@ -98,7 +177,11 @@ public:
       entry.data = std::make_unique<T>();
       ++version;
 
-      addCopyEntry(representation);
+      void (*swap)(Streamable&, Streamable&) = nullptr;
+      if constexpr (std::is_swappable_v<T>)
+        swap = &swapRepresentations<T>;
+      addCopyEntry(representation, swap);
+      entry.factory = &createRepresentation<T>;
     }
     return *dynamic_cast<T*>(entry.data.get());
   }
@@ -120,6 +203,24 @@ public:
   Streamable& operator[](const char* representation);
   const Streamable& operator[](const char* representation) const;
 
+  /**
+   * Returns a function that creates instances of the type of a representation,
+   * e.g. to keep copies that are assigned with operator= like the ones for
+   * USES() dependencies. The representation must already exist.
+   * @param representation The name of the representation.
+   * @return The function.
+   */
+  Factory getFactory(const char* representation) const { return get(representation).factory; }
+
+  /**
+   * Access the modification counter of a representation. It is increased after
+   * each update of the representation, unless its provider reported that nothing
+   * changed. Changes made through MODIFY are not counted.
+   * @param representation The name of the representation.
+   * @return The counter. Its address stays valid until the representation is freed.
+   */
+  unsigned& getChangeCounter(const char* representation) { return get(representation).changes; }
+
   /**
    * Access a representation of a certain type in current process's blackboard.
    * The representation must already exist.
@@ -129,17 +230,33 @@ public:
   */
   template <typename T> static const T& get(bool copy = false)
   {
-    const char* const name = typeid(T).name();
-    const std::string demangledName = demangle(name) + (copy ? "-Copy" : "");
-
-    const Blackboard& bb = getInstance();
+    Blackboard& bb = getInstance();
+    const size_t slot = getSlot<T>() * 2 + (copy ? 1 : 0);
 
-    if (!bb.exists(demangledName.c_str()))
-      throw std::out_of_range("Representation " + demangledName + " does not exist!");
+    if (slot < bb.slots.size())
+      if (const Streamable* data = bb.slots[slot].load(std::memory_order_relaxed))
+        return static_cast<const T&>(*data);
 
-    return static_cast<const T&>(bb[demangledName.c_str()]);
+    return static_cast<const T&>(bb.lookup(typeid(T).name(), copy, slot));
   }
 
+  /**
+   * Select the representations that are double buffered. Instead of copying
+   * them for USES() dependencies each frame, the original and the copy are
+   * swapped. Afterwards, the original contains outdated data. Therefore, this
+   * mode must only be used for representations the providers of which
+   * completely overwrite them in each frame.
+   * @param representations The names of the representations that are double buffered.
+   */
+  void setDoubleBuffered(const std::vector<std::string>& representations);
+
+  /**
+   * Determine how many bytes are copied for USES() dependencies per frame.
+   * This is expensive, because all representations involved are serialized.
+   * @return One entry per representation copied, sorted by decreasing size.
+   */
+  std::vector<CopyStatistics> getCopyStatistics() const;
+
   /**
    * Return the current version.
    * It can be used to determine whether the configuration of the
@@ -149,6 +266,21 @@ public:
    */
   int getVersion() const { return version; }
 
+  /**
+   * Return the index of this blackboard. The indices of all existing
+   * blackboards are dense, so they can be used to index arrays, but an
+   * index is reused after its blackboard was destroyed.
+   * @return The index. It starts with 0.
+   */
+  size_t getIndex() const { return index; }
+
+  /**
+   * Return a number that distinguishes this blackboard from all blackboards
+   * created before, even if they had the same index.
+   * @return The serial number. It is never 0.
+   */
+  unsigned getSerialNumber() const { return serialNumber; }
+
   /**
    * Access the blackboard of this process.
    * @return The instance that belongs to this process.
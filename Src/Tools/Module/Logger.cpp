@@ -15,19 +15,23 @@
 #include <algorithm>
 #include <time.h>
 #include <filesystem>
-#include <snappy-c.h>
 #include <thread>
 #include <chrono>
 #include "Representations/Infrastructure/GameInfo.h"
+#include "Representations/Infrastructure/LoggerStatus.h"
 #include "Tools/Settings.h"
 #include "Tools/Debugging/AnnotationManager.h"
 #include "Tools/MessageQueue/LogFileFormat.h"
 #include "Tools/Debugging/Stopwatch.h"
 #include "Tools/MessageQueue/MessageQueue.h"
 #include "Tools/Streams/StreamHandler.h"
+#include "Tools/Global.h"
 #include "Logger.h"
 #include "Representations/Infrastructure/RobotInfo.h"
 #include "Representations/MotionControl/MotionInfo.h"
+#include "Representations/Infrastructure/MotionTiming.h"
+#include "Representations/Modeling/WhistleDortmund.h"
+#include "Representations/Sensing/FallDownState.h"
 #include "Platform/SystemCall.h"
 #include "Tools/Build.h"
 
@@ -46,6 +50,10 @@ Logger::Logger(std::initializer_list<char> cycles)
     parameters.logFilePath = "Logs";
   }
 
+  // The flight recorder keeps compressed blocks
+  if (isFlightRecorder() && parameters.compression == LogFileCompression::none)
+    parameters.compression = LogFileCompression::snappy;
+
   if (parameters.enabled)
   {
     InMapFile stream2("teamList.cfg");
@@ -55,17 +63,33 @@ Logger::Logger(std::initializer_list<char> cycles)
     buffer.resize(parameters.numBuffers);
     for (auto& buf : buffer)
     {
-      buf = std::make_unique<MessageQueue>();
+      buf = std::make_unique<Buffer>();
       buf->setSize(parameters.bufferSize);
       freeBuffers.push_back(buf.get());
     }
     writerThread.setPriority(parameters.writePriority);
+
+    stagedFrames.resize(std::max(0, parameters.stagedFrames));
+    for (auto& staged : stagedFrames)
+    {
+      staged = std::make_unique<StagedFrame>();
+      staged->messages.setSize(parameters.bufferSize);
+      freeStagedFrames.push_back(staged.get());
+    }
+
+    if (parameters.compression != LogFileCompression::none || !stagedFrames.empty())
+      for (int i = 0; i < std::max(1, parameters.compressionThreads); ++i)
+      {
+        compressionThreads.emplace_back(std::make_unique<Thread<Logger>>());
+        compressionThreads.back()->setPriority(parameters.compressionPriority);
+      }
   }
 }
 
 Logger::~Logger()
 {
   writerThread.stop();
+  stopCompression();
 }
 
 void Logger::execute(const char processIdentifier)
@@ -93,7 +117,9 @@ void Logger::execute(const char processIdentifier)
             for (i = 0; i < numOfDataMessageIDs; ++i)
               if (getName(static_cast<MessageID>(i)) == "id" + representation)
               {
-                loggables.push_back(Loggable(&Blackboard::getInstance()[representation.c_str()], static_cast<MessageID>(i)));
+                loggables.push_back(Loggable(&Blackboard::getInstance()[representation.c_str()], static_cast<MessageID>(i),
+                    Blackboard::getInstance().getFactory(representation.c_str()),
+                    isDeltaEncoding() && std::find(parameters.deltaRepresentations.begin(), parameters.deltaRepresentations.end(), representation) != parameters.deltaRepresentations.end()));
                 break;
               }
             if (i == numOfDataMessageIDs)
@@ -115,9 +141,32 @@ void Logger::execute(const char processIdentifier)
     }
 
     runStateMachine(processIdentifier);
+    updateStatus();
   }
 }
 
+void Logger::updateStatus()
+{
+  // The status is not provided by a module, so the logger creates it in the blackboard of each cycle.
+  Blackboard& blackboard = Blackboard::getInstance();
+  LoggerStatus& status = blackboard.exists("LoggerStatus") ? static_cast<LoggerStatus&>(blackboard["LoggerStatus"]) : blackboard.alloc<LoggerStatus>("LoggerStatus");
+
+  status.writing = file != nullptr;
+  status.loggedFrames = loggedFrames.load(std::memory_order_relaxed);
+  status.droppedFrames = droppedFrames.load(std::memory_order_relaxed);
+  status.droppedMessages = droppedMessages.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> l(bufferMutex);
+    status.pendingFrames = static_cast<unsigned>(fullBuffers.size());
+  }
+  const unsigned long long written = writtenBytes.load(std::memory_order_relaxed);
+  status.writtenKB = static_cast<unsigned>(written >> 10);
+  status.compressionRatio = written ? static_cast<float>(uncompressedBytes.load(std::memory_order_relaxed)) / static_cast<float>(written) : 1.f;
+
+  DEBUG_RESPONSE("representation:LoggerStatus")
+    OUTPUT(idLoggerStatus, bin, status);
+}
+
 void Logger::runStateMachine(char processIdentifier)
 {
   Cycle& cycle = cycles.at(processIdentifier);
@@ -179,7 +228,7 @@ void Logger::runStateMachine(char processIdentifier)
       case State::running:
         if (!record)
           go(State::delayStopping);
-        else if (file && SystemCall::getFreeDiskSpace(logFilename.c_str()) >> 20 < parameters.minFreeSpace)
+        else if (lowDiskSpace.load(std::memory_order_relaxed))
           go(State::error);
         break;
       case State::delayStopping:
@@ -220,7 +269,12 @@ void Logger::runStateMachine(char processIdentifier)
         break;
       case State::start:
       {
+        loggedFrames = droppedFrames = droppedMessages = 0;
+        uncompressedBytes = writtenBytes = 0;
+        recordUntil = 0;
+        ++logNumber;
         writerThread.start(this, &Logger::writeThread);
+        startCompression();
 
         if (usbStatus.status == USBStatus::MountStatus::readWrite)
           SystemCall::text2Speech("U S B logging");
@@ -247,6 +301,7 @@ void Logger::runStateMachine(char processIdentifier)
         break;
       case State::forceStop:
         writerThread.forceStop();
+        stopCompression();
         break;
       case State::finished:
         break;
@@ -266,6 +321,8 @@ void Logger::runStateMachine(char processIdentifier)
 
   if (state == State::prepareWriting || state == State::running)
   {
+    if (isFlightRecorder())
+      checkEvents(processIdentifier);
     logFrame(processIdentifier);
 
     if (!cycle.streamSpecificationDone.load(std::memory_order_relaxed))
@@ -353,17 +410,42 @@ void Logger::logFrame(char processIdentifier)
 {
   Cycle& cycle = cycles.at(processIdentifier);
 
-  MessageQueue* currentQueue = nullptr;
+  // The first frame of each cycle is serialized here, so that the types are registered
+  // in its stream specification.
+  const bool stage = !stagedFrames.empty() && cycle.streamSpecificationDone.load(std::memory_order_relaxed);
+
+  Buffer* currentQueue = nullptr;
+  StagedFrame* staged = nullptr;
   {
     std::lock_guard<std::mutex> l(bufferMutex);
 
     if (freeBuffers.empty())
     {
+      ++droppedFrames;
       OUTPUT_WARNING("Logger: Writer thread too slow, discarding frame.");
       return;
     }
     currentQueue = freeBuffers.back();
     freeBuffers.pop_back();
+
+    // If all staged frames are in use, this frame is serialized here.
+    if (stage && !freeStagedFrames.empty())
+    {
+      staged = freeStagedFrames.back();
+      freeStagedFrames.pop_back();
+    }
+  }
+  currentQueue->timestamp = SystemCall::getCurrentSystemTime();
+  currentQueue->staged = staged;
+
+  // The first messages of each log must be keyframes
+  if (cycle.logNumber != logNumber.load(std::memory_order_relaxed))
+  {
+    cycle.logNumber = logNumber.load(std::memory_order_relaxed);
+    for (Loggable& loggable : cycle.loggables)
+      loggable.previous.clear();
+    for (Loggable& loggable : cycle.activeLoggables)
+      loggable.previous.clear();
   }
 
   OutMessage& out = currentQueue->out;
@@ -374,13 +456,44 @@ void Logger::logFrame(char processIdentifier)
   // Stream all representations to the queue
   STOPWATCH("Logger")
   {
-    const auto log = [&](const auto& loggables)
+    if (staged)
     {
-      for (const Loggable& loggable : loggables)
+      staged->processIdentifier = processIdentifier;
+      staged->numOfCopies = 0;
+    }
+
+    const auto log = [&](auto& loggables)
+    {
+      for (Loggable& loggable : loggables)
       {
-        out.bin << *loggable.representation;
-        if (!out.finishMessage(loggable.id))
+        bool success;
+        if (loggable.delta)
+          success = logDelta(cycle, loggable, out);
+        else if (staged && loggable.factory)
+        {
+          // Copying is much cheaper than streaming, the compression thread streams the copy.
+          if (staged->numOfCopies == staged->copies.size())
+            staged->copies.emplace_back();
+          StagedFrame::Copy& copy = staged->copies[staged->numOfCopies++];
+          if (copy.source != loggable.representation || copy.id != loggable.id)
+          {
+            copy.source = loggable.representation;
+            copy.data = loggable.factory();
+          }
+          copy.id = loggable.id;
+          *copy.data = *loggable.representation;
+          success = true;
+        }
+        else
+        {
+          out.bin << *loggable.representation;
+          success = out.finishMessage(loggable.id);
+        }
+        if (!success)
+        {
+          ++droppedMessages;
           OUTPUT_WARNING("Logging of " << ::getName(loggable.id) << " failed. The buffer is full.");
+        }
       }
     };
 
@@ -397,23 +510,237 @@ void Logger::logFrame(char processIdentifier)
       log(cycle.activeLoggables);
 
     // Append annotations
-    Global::getAnnotationManager().getOut().copyAllMessages(*currentQueue);
+    Global::getAnnotationManager().getOut().copyAllMessages(staged ? staged->messages : *currentQueue);
   }
 
   // Append timing data if any
-  MessageQueue& timingData = Global::getTimingManager().getData();
-  if (timingData.getNumberOfMessages() > 0)
-    timingData.copyAllMessages(*currentQueue);
+  if (parameters.logFrameTimings)
+  {
+    MessageQueue& timingData = Global::getTimingManager().getData();
+    if (timingData.getNumberOfMessages() > 0)
+      timingData.copyAllMessages(staged ? staged->messages : *currentQueue);
+  }
+  Global::getTimingManager().getSummary().copyAllMessages(staged ? staged->messages : *currentQueue);
 
-  out.bin << processIdentifier;
-  out.finishMessage(idProcessFinished);
+  if (!staged)
+  {
+    out.bin << processIdentifier;
+    out.finishMessage(idProcessFinished);
+  }
 
+  ++loggedFrames;
+  const bool compress = parameters.compression != LogFileCompression::none;
+  currentQueue->ready.store(!compress && !staged, std::memory_order_relaxed);
   {
     std::lock_guard<std::mutex> l(bufferMutex);
     fullBuffers.push_back(currentQueue);
+    if (compress || staged)
+      uncompressedBuffers.push_back(currentQueue);
+  }
+
+  if (compress || staged)
+    framesToCompress.post(); // Signal to the compression threads that another block is ready
+  else
+    framesToWrite.post(); // Signal to the writer thread that another block is ready
+}
+
+void Logger::serialize(Buffer& queue)
+{
+  StagedFrame& staged = *queue.staged;
+  OutMessage& out = queue.out;
+  for (size_t i = 0; i < staged.numOfCopies; ++i)
+  {
+    out.bin << *staged.copies[i].data;
+    if (!out.finishMessage(staged.copies[i].id))
+      ++droppedMessages; // OUTPUT_WARNING is not available in this thread
+  }
+  staged.messages.copyAllMessages(queue);
+  staged.messages.clear();
+
+  out.bin << staged.processIdentifier;
+  out.finishMessage(idProcessFinished);
+
+  queue.staged = nullptr;
+  std::lock_guard<std::mutex> l(bufferMutex);
+  freeStagedFrames.push_back(&staged);
+}
+
+void Logger::checkEvents(char processIdentifier)
+{
+  Cycle& cycle = cycles.at(processIdentifier);
+  Blackboard& blackboard = Blackboard::getInstance();
+  const auto isEnabled = [&](Parameters::FlightRecorderEvent event)
+  {
+    return std::find(parameters.flightRecorderEvents.begin(), parameters.flightRecorderEvents.end(), event) != parameters.flightRecorderEvents.end();
+  };
+
+  // Only changes are events, so the first frame only initializes the states.
+  const char* event = nullptr;
+  if (isEnabled(Parameters::fall) && blackboard.exists("FallDownState"))
+  {
+    const FallDownState& fallDownState = static_cast<const FallDownState&>(blackboard["FallDownState"]);
+    const bool falling = fallDownState.state == FallDownState::falling || fallDownState.state == FallDownState::onGround;
+    if (falling && !cycle.falling && cycle.eventsInitialized)
+      event = "fall";
+    cycle.falling = falling;
+  }
+  if (isEnabled(Parameters::penalty) && blackboard.exists("RobotInfo"))
+  {
+    const bool penalized = static_cast<const RobotInfo&>(blackboard["RobotInfo"]).penalty != PENALTY_NONE;
+    if (penalized && !cycle.penalized && cycle.eventsInitialized)
+      event = "penalty";
+    cycle.penalized = penalized;
+  }
+  if (isEnabled(Parameters::whistle) && blackboard.exists("WhistleDortmund"))
+  {
+    const WhistleDortmund& whistle = static_cast<const WhistleDortmund&>(blackboard["WhistleDortmund"]);
+    if (whistle.detectionState == WhistleDortmund::isDetected && whistle.lastDetectionTime != cycle.lastWhistle && cycle.eventsInitialized)
+      event = "whistle";
+    cycle.lastWhistle = whistle.lastDetectionTime;
+  }
+  if (isEnabled(Parameters::frameOverrun) && blackboard.exists("MotionTiming"))
+  {
+    const unsigned overruns = static_cast<const MotionTiming&>(blackboard["MotionTiming"]).overruns;
+    if (overruns > cycle.overruns && cycle.eventsInitialized)
+      event = "frame overrun";
+    cycle.overruns = overruns;
   }
+  if (isEnabled(Parameters::annotation) && Global::getAnnotationManager().getOut().getNumberOfMessages() > 0)
+    event = "annotation";
+  cycle.eventsInitialized = true;
 
-  framesToWrite.post(); // Signal to the writer thread that another block is ready
+  if (event)
+  {
+    // Events overlapping in time extend the range written.
+    const unsigned until = SystemCall::getCurrentSystemTime() + parameters.flightRecorderPostEventDuration;
+    unsigned current = recordUntil.load(std::memory_order_relaxed);
+    while (current < until && !recordUntil.compare_exchange_weak(current, until, std::memory_order_release))
+      ;
+    std::cout << "Logger: Recording " << event << "." << std::endl;
+  }
+}
+
+bool Logger::logDelta(Cycle& cycle, Loggable& loggable, OutMessage& out)
+{
+  OutBinarySize size;
+  size << *loggable.representation;
+  std::vector<char>& current = cycle.deltaBuffer;
+  current.resize(size.getSize());
+  OutBinaryMemory stream(current.data());
+  stream << *loggable.representation;
+
+  const bool keyframe = loggable.previous.size() != current.size() || loggable.messagesSinceKeyframe + 1 >= parameters.keyframeInterval;
+  out.bin << static_cast<unsigned char>(loggable.id) << static_cast<unsigned char>(keyframe);
+  if (keyframe)
+    out.bin.write(current.data(), current.size());
+  else
+  {
+    for (size_t i = 0; i < current.size(); ++i)
+      loggable.previous[i] ^= current[i];
+    out.bin.write(loggable.previous.data(), loggable.previous.size());
+  }
+
+  if (!out.finishMessage(idDeltaMessage))
+  {
+    if (!keyframe) // restore the previous message, the reader will not see this one
+      for (size_t i = 0; i < current.size(); ++i)
+        loggable.previous[i] ^= current[i];
+    return false;
+  }
+
+  loggable.previous.swap(current);
+  loggable.messagesSinceKeyframe = keyframe ? 0 : loggable.messagesSinceKeyframe + 1;
+  return true;
+}
+
+void Logger::startCompression()
+{
+  compressing.store(true, std::memory_order_release);
+  for (auto& thread : compressionThreads)
+    thread->start(this, &Logger::compressThread);
+}
+
+void Logger::stopCompression()
+{
+  compressing.store(false, std::memory_order_release);
+  for (auto& thread : compressionThreads)
+    thread->stop();
+}
+
+void Logger::compressThread()
+{
+  Thread<Logger>::setName("LogCompress");
+  BH_TRACE_INIT("LogCompress");
+
+  // The types streamed here are registered in a handler of this thread.
+  StreamHandler streamHandler;
+  Global::theStreamHandler = &streamHandler;
+
+  while (compressing.load(std::memory_order_acquire))
+    if (framesToCompress.wait(100))
+    {
+      Buffer* queue = nullptr;
+      {
+        std::lock_guard<std::mutex> l(bufferMutex);
+        if (!uncompressedBuffers.empty())
+        {
+          queue = uncompressedBuffers.front();
+          uncompressedBuffers.pop_front();
+        }
+      }
+      if (queue)
+      {
+        if (queue->staged)
+          serialize(*queue);
+        if (parameters.compression != LogFileCompression::none)
+          compress(*queue);
+        queue->ready.store(true, std::memory_order_release);
+        framesToWrite.post(); // The writer thread writes the blocks in the order they were filled
+      }
+    }
+
+  BH_TRACE_TERM;
+}
+
+void Logger::compress(Buffer& queue)
+{
+  const size_t maxSize = LogFileCompression::getMaxCompressedSize(parameters.compression, queue.getStreamedSize());
+  queue.compressed.resize(maxSize + sizeof(unsigned)); // Also reserve 4 bytes for header
+  size_t size = maxSize;
+  VERIFY(LogFileCompression::compress(parameters.compression, parameters.compressionLevel, queue.getStreamedData(), queue.getStreamedSize(), queue.compressed.data() + sizeof(unsigned), size));
+  reinterpret_cast<unsigned&>(queue.compressed[0]) = static_cast<unsigned>(size);
+  queue.compressed.resize(size + sizeof(unsigned));
+
+  queue.block = LogFileIndex::Block();
+  queue.block.compressedSize = static_cast<unsigned>(size);
+  queue.block.numberOfMessages = queue.getNumberOfMessages();
+  queue.block.firstTimestamp = queue.block.lastTimestamp = queue.timestamp;
+  queue.gameState = -1;
+  queue.handleAllMessages([&](InMessage& message)
+      {
+        if (message.getMessageID() == idDeltaMessage)
+        {
+          unsigned char id;
+          message.bin >> id;
+          queue.block.add(static_cast<MessageID>(id));
+        }
+        else
+          queue.block.add(message.getMessageID());
+        if (message.getMessageID() == idProcessFinished)
+          ++queue.block.numberOfFrames;
+        else if (message.getMessageID() == idGameInfo)
+        {
+          GameInfo gameInfo;
+          message.bin >> gameInfo;
+          queue.gameState = gameInfo.state;
+        }
+        else if (message.getMessageID() == idRawGameInfo)
+        {
+          RawGameInfo rawGameInfo;
+          message.bin >> rawGameInfo;
+          queue.gameState = rawGameInfo.state;
+        }
+      });
 }
 
 void Logger::writeThread()
@@ -423,72 +750,129 @@ void Logger::writeThread()
 
   std::cout << "Logger started." << std::endl;
 
-  const size_t compressedSize = snappy_max_compressed_length(parameters.bufferSize + 2 * sizeof(unsigned));
-  std::vector<char> compressedBuffer;
-  if (parameters.compression)
-    compressedBuffer.resize(compressedSize + sizeof(unsigned)); // Also reserve 4 bytes for header
+  LogFileIndex index; // Appended to compressed log files
+  unsigned long long blockOffset = 0;
+  int numberOfFrames = 0;
+  unsigned char gameState = STATE_INITIAL;
+  unsigned long long nextSpaceCheck = 0; // The free space is checked again when this many bytes were written
+  std::deque<RecordedBlock> recorder; // The compressed blocks kept by the flight recorder, the oldest first
+  size_t recorderBytes = 0; // The size of all blocks in recorder
+
+  // The file is opened when the first block is written.
+  const auto openFile = [&](const MessageQueue& queue) -> bool
+  {
+    if (!file && !logFilename.empty())
+    {
+      file = new OutBinaryBlockFile(logFilename, static_cast<size_t>(parameters.writeBlockSize) << 10, static_cast<size_t>(parameters.reserveSize) << 20);
+      if (file->exists())
+      {
+        lowDiskSpace = false;
+        nextSpaceCheck = writtenBytes;
+        *file << logFileMessageIDs;
+        queue.writeMessageIDs(*file);
+
+        // wait for all stream specifications
+        const auto isStreamSpecDone = [](const auto& entry)
+        {
+          const auto& [id, cycle] = entry;
+          return cycle.streamSpecificationDone.load(std::memory_order_acquire);
+        };
+        while (!std::all_of(cycles.begin(), cycles.end(), isStreamSpecDone))
+          std::this_thread::yield();
+
+        for (const auto& [id, cycle] : cycles)
+        {
+          *file << logFileStreamSpecification;
+          file->write(cycle.streamSpecification.data(), cycle.streamSpecification.size());
+        }
+
+        if (isDeltaEncoding())
+          *file << logFileDeltaEncoded;
+
+        if (parameters.compression == LogFileCompression::snappy)
+        {
+          *file << logFileCompressed; // Write magic byte that indicates a compressed log file
+        }
+        else if (parameters.compression != LogFileCompression::none)
+        {
+          *file << logFileCompressedWithCodec << static_cast<unsigned char>(parameters.compression);
+        }
+        else
+        {
+          *file << logFileUncompressed;
+          queue.writeAppendableHeader(*file);
+        }
+      }
+      else
+      {
+        std::cerr << "Logger: Cannot open log file!" << std::endl;
+      }
+    }
+    return file && file->exists();
+  };
+
+  const auto writeCompressed = [&](const std::vector<char>& compressed, const LogFileIndex::Block& queueBlock, int queueGameState, size_t uncompressedSize)
+  {
+    file->write(compressed.data(), compressed.size());
+
+    LogFileIndex::Block& block = index.blocks.emplace_back(queueBlock);
+    block.offset = blockOffset;
+    block.firstFrame = numberOfFrames;
+    if (queueGameState >= 0)
+      gameState = static_cast<unsigned char>(queueGameState);
+    block.gameState = gameState;
+    numberOfFrames += block.numberOfFrames;
+    blockOffset += compressed.size();
+    uncompressedBytes += uncompressedSize;
+    writtenBytes += compressed.size();
+  };
+
+  // statfs is not called per frame, but only about once per MB written
+  const auto checkSpace = [&]
+  {
+    if (writtenBytes >= nextSpaceCheck)
+    {
+      nextSpaceCheck = writtenBytes + (1 << 20);
+      if (SystemCall::getFreeDiskSpace(logFilename.c_str()) >> 20 < parameters.minFreeSpace)
+        lowDiskSpace = true;
+    }
+  };
 
   while (writerThread.isRunning()) // Check if we are expecting more data
-    if (framesToWrite.wait(100)) // Wait 100 ms for new data then check again if we should quit
+  {
+    const bool signaled = framesToWrite.wait(100); // Wait 100 ms for new data then check again if we should quit
+
+    // Buffers are compressed in parallel, but must be written in the order they were filled.
+    for (;;)
     {
+      Buffer* next;
+      {
+        std::lock_guard<std::mutex> l(bufferMutex);
+        next = fullBuffers.empty() || !fullBuffers.front()->ready.load(std::memory_order_acquire) ? nullptr : fullBuffers.front();
+      }
+      if (!next)
+        break;
       writerIdle.store(false, std::memory_order_relaxed);
 
-      MessageQueue& queue = *fullBuffers.front();
+      Buffer& queue = *next;
       if (queue.getNumberOfMessages() > 0)
       {
-        if (!file && !logFilename.empty())
+        if (isFlightRecorder())
         {
-          file = new OutBinaryFile(logFilename);
-          if (file->exists())
-          {
-            *file << logFileMessageIDs;
-            queue.writeMessageIDs(*file);
-
-            // wait for all stream specifications
-            const auto isStreamSpecDone = [](const auto& entry)
-            {
-              const auto& [id, cycle] = entry;
-              return cycle.streamSpecificationDone.load(std::memory_order_acquire);
-            };
-            while (!std::all_of(cycles.begin(), cycles.end(), isStreamSpecDone))
-              std::this_thread::yield();
-
-            for (const auto& [id, cycle] : cycles)
-            {
-              *file << logFileStreamSpecification;
-              file->write(cycle.streamSpecification.data(), cycle.streamSpecification.size());
-            }
-
-            if (parameters.compression)
-            {
-              *file << logFileCompressed; // Write magic byte that indicates a compressed log file
-            }
-            else
-            {
-              *file << logFileUncompressed;
-              queue.writeAppendableHeader(*file);
-            }
-          }
-          else
-          {
-            std::cerr << "Logger: Cannot open log file!" << std::endl;
-          }
+          recorderBytes += queue.compressed.size();
+          recorder.push_back({queue.timestamp, std::move(queue.compressed), queue.block, queue.gameState, queue.getStreamedSize()});
         }
-
-        if (file && file->exists())
+        else if (openFile(queue))
         {
-          if (parameters.compression)
-          {
-            size_t size = compressedSize;
-            VERIFY(snappy_compress(queue.getStreamedData(), queue.getStreamedSize(), compressedBuffer.data() + sizeof(unsigned), &size) == SNAPPY_OK);
-            reinterpret_cast<unsigned&>(compressedBuffer[0]) = static_cast<unsigned>(size);
-
-            file->write(compressedBuffer.data(), size + sizeof(unsigned));
-          }
+          if (parameters.compression != LogFileCompression::none)
+            writeCompressed(queue.compressed, queue.block, queue.gameState, queue.getStreamedSize());
           else
           {
             queue.append(*file);
+            uncompressedBytes += queue.getStreamedSize();
+            writtenBytes += queue.getStreamedSize();
           }
+          checkSpace();
         }
         queue.clear();
       }
@@ -498,11 +882,49 @@ void Logger::writeThread()
         freeBuffers.push_back(&queue);
       }
     }
-    else if (!writerIdle.load(std::memory_order_relaxed))
+
+    // The flight recorder writes the blocks up to the end of the last event and
+    // drops the blocks that are too old to be written for the next event.
+    if (isFlightRecorder())
+    {
+      const unsigned now = SystemCall::getCurrentSystemTime();
+      const unsigned until = recordUntil.load(std::memory_order_acquire);
+      while (!recorder.empty())
+      {
+        RecordedBlock& recorded = recorder.front();
+        if (recorded.timestamp <= until)
+        {
+          if (openFile(*buffer.front()))
+          {
+            writeCompressed(recorded.compressed, recorded.block, recorded.gameState, recorded.uncompressedSize);
+            checkSpace();
+          }
+        }
+        else if (now - recorded.timestamp <= parameters.flightRecorderDuration
+                 && recorderBytes <= static_cast<size_t>(parameters.flightRecorderSize) << 20)
+          break;
+        recorderBytes -= recorded.compressed.size();
+        recorder.pop_front();
+      }
+    }
+
+    if (!signaled && !writerIdle.load(std::memory_order_relaxed))
     {
-      writerIdleStart = SystemCall::getCurrentSystemTime();
-      writerIdle.store(true, std::memory_order_release);
+      std::lock_guard<std::mutex> l(bufferMutex);
+      if (fullBuffers.empty()) // compression threads might still be busy
+      {
+        if (file)
+          file->flush();
+        writerIdleStart = SystemCall::getCurrentSystemTime();
+        writerIdle.store(true, std::memory_order_release);
+      }
     }
+  }
+
+  stopCompression();
+
+  if (file && file->exists() && parameters.compression != LogFileCompression::none && !index.blocks.empty())
+    index.write(*file);
 
   dumpSystemLog();
 
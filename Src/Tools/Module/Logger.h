@@ -6,8 +6,13 @@
  * Logfile format:
  * logFileMessageIDs | number of message ids | streamed message id names |
  * logFileStreamSpecification | streamed StreamHandler |
- * idLogFileCompressed | size of next compressed block | compressed block | size | compressed block | etc...
- * Each block is compressed using libsnappy
+ * logFileCompressed | size of next compressed block | compressed block | size | compressed block | etc... | 0 | index
+ * Each block is compressed using libsnappy. If another codec is selected, logFileCompressed
+ * is replaced by | logFileCompressedWithCodec | codec | (see LogFileCompression.h).
+ * The index describes all blocks (see LogFileIndex.h). It is written when the logger stops.
+ * Blocks are compressed by a pool of threads, the writer thread only writes them in order.
+ * If stagedFrames is not 0, the threads logging only copy the representations. The
+ * compression threads serialize the copies, except for delta-encoded representations.
  *
  * Block format (after decompression):
  * | block length | number of messages | Frame | Frame | Frame | ... | Frame |
@@ -17,6 +22,17 @@
  * Log data format:
  * | ID ( 1 byte) | Message size (3 byte) | Message |
  *
+ * Representations listed in deltaRepresentations are logged as idDeltaMessage if the log
+ * file is compressed, marked by logFileDeltaEncoded before the compression marker:
+ * | original ID (1 byte) | keyframe (1 byte) | Message or XOR with the previous message |
+ * The XOR is relative to the previous message of the same ID from the same process.
+ *
+ * If flightRecorderDuration is not 0, the compressed blocks are kept in RAM and
+ * only written around events, i.e. the log file only contains the frames from
+ * flightRecorderDuration before until flightRecorderPostEventDuration after each
+ * event. The file is only created when the first event happens. Delta encoding
+ * is not used in this mode, because the blocks in the log file are not contiguous.
+ *
  * @author Arne Böckmann
  * @author Thomas Röfer
  */
@@ -32,6 +48,8 @@
 #include "Representations/Infrastructure/SensorData/KeyStates.h"
 #include "Representations/Infrastructure/USBStatus.h"
 #include "Representations/BehaviorControl/BehaviorData.h"
+#include "Tools/MessageQueue/LogFileCompression.h"
+#include "Tools/MessageQueue/LogFileIndex.h"
 #include <mutex>
 #include <memory>
 #include <deque>
@@ -45,6 +63,14 @@ private:
       (std::string)("") cycle,
       (std::vector<std::string>) representations
     );
+
+    ENUM(FlightRecorderEvent,
+      fall, /**< The robot started falling. */
+      penalty, /**< The robot was penalized. */
+      whistle, /**< A whistle was detected. */
+      annotation, /**< An annotation was added. */
+      frameOverrun /**< The motion thread exceeded its time budget. */
+    );
     ,
     (bool)(false) enabled, /**< Determines whether the logger is enabled or disabled. */
     (std::string) logFilePath, /**< Where to write the log file. */
@@ -54,7 +80,20 @@ private:
     (std::vector<Cycle>) activeRepresentations, /**< Contains the representations that should be logged only when active. */
     (int) writePriority,
     (unsigned) minFreeSpace, /**< Minimum free space left on the device in MB. */
-    (bool) compression, /**< Enable snappy compression. */
+    (unsigned)(1024) writeBlockSize, /**< The log file is written in blocks of this size in KB. */
+    (unsigned)(0) reserveSize, /**< The space on the device is reserved in steps of this size in MB (0 = never). */
+    ((LogFileCompression) Codec) compression, /**< The codec the log file is compressed with (none, snappy, zstd, lz4). */
+    (int) compressionLevel, /**< The compression level of zstd and lz4 (see LogFileCompression.h). */
+    (int) compressionThreads, /**< The number of threads that compress frames in the background. */
+    (int) compressionPriority, /**< The priority of the compression threads. */
+    (int)(0) stagedFrames, /**< The number of frames whose representations can be copied for the compression threads at the same time (0 = serialize them while logging). */
+    (std::vector<std::string>) deltaRepresentations, /**< Representations logged as differences to their previous message if the log is compressed. */
+    (int) keyframeInterval, /**< Every n-th message of a delta-encoded representation is logged completely. */
+    (unsigned)(0) flightRecorderDuration, /**< The frames of this many ms before an event are written (0 = always write all frames). */
+    (unsigned)(0) flightRecorderPostEventDuration, /**< The frames of this many ms after an event are written. */
+    (unsigned)(0) flightRecorderSize, /**< The maximum size of the compressed frames kept in RAM in MB. */
+    (std::vector<FlightRecorderEvent>) flightRecorderEvents, /**< The events that cause writing the frames kept in RAM. */
+    (bool)(true) logFrameTimings, /**< Log the stopwatches of every frame and not only the summaries of the timing windows. */
     (bool) verboseTTS /**< Enable verbose text-to-speech output. */
   );
 
@@ -73,9 +112,30 @@ private:
   public:
     Streamable* representation;
     MessageID id;
+    Blackboard::Factory factory = nullptr; /**< Creates the copies for the compression threads. */
+    bool delta = false; /**< Is the representation delta-encoded? */
+    std::vector<char> previous; /**< The previous message logged if delta-encoded. */
+    int messagesSinceKeyframe = 0; /**< The number of delta messages since the last keyframe. */
 
     Loggable() = default;
-    Loggable(Streamable* representation, MessageID id) : representation(representation), id(id) {}
+    Loggable(Streamable* representation, MessageID id, Blackboard::Factory factory, bool delta) :
+      representation(representation), id(id), factory(factory), delta(delta) {}
+  };
+
+  /** The copies of the representations of a frame that are serialized by a compression thread. */
+  struct StagedFrame
+  {
+    struct Copy
+    {
+      MessageID id;
+      const Streamable* source = nullptr; /**< The original. The copy is reused as long as the original stays the same. */
+      std::unique_ptr<Streamable> data;
+    };
+
+    char processIdentifier;
+    std::vector<Copy> copies;
+    size_t numOfCopies = 0; /**< The number of entries of copies used in this frame. */
+    MessageQueue messages; /**< The annotations and timing data of the frame. */
   };
 
   struct Cycle
@@ -85,6 +145,15 @@ private:
     std::vector<Loggable> activeLoggables;
     std::vector<char> streamSpecification;
     std::atomic_bool streamSpecificationDone = false;
+    unsigned logNumber = 0; /**< The log the delta encoding of this cycle refers to. */
+    std::vector<char> deltaBuffer; /**< Temporary buffer for streaming delta-encoded representations. */
+
+    // The states the flight recorder events are detected from
+    bool eventsInitialized = false; /**< Were the following states set at least once? */
+    bool falling = false;
+    bool penalized = false;
+    unsigned lastWhistle = 0;
+    unsigned overruns = 0;
   };
 
   Parameters parameters;
@@ -92,9 +161,33 @@ private:
 
   std::unordered_map<char, Cycle> cycles;
 
-  std::vector<std::unique_ptr<MessageQueue>> buffer; /**< Ring buffer of message queues. Shared with the writer thread. */
-  std::deque<MessageQueue*> freeBuffers;
-  std::deque<MessageQueue*> fullBuffers;
+  /** The messages of a single frame. */
+  struct Buffer : public MessageQueue
+  {
+    unsigned timestamp = 0; /**< The system time when the frame was logged. */
+    std::vector<char> compressed; /**< The size of the compressed block followed by the block itself. */
+    LogFileIndex::Block block; /**< The index entry of the block without the fields that depend on previous blocks. */
+    int gameState = -1; /**< The last game state found in the block or -1 if there was none. */
+    StagedFrame* staged = nullptr; /**< The rest of the frame that still must be serialized or nullptr. */
+    std::atomic_bool ready = false; /**< Can the buffer be written, i.e. is it compressed if compression is active? */
+  };
+
+  /** A compressed block kept in RAM by the flight recorder. */
+  struct RecordedBlock
+  {
+    unsigned timestamp; /**< The system time when the frame was logged. */
+    std::vector<char> compressed; /**< The size of the compressed block followed by the block itself. */
+    LogFileIndex::Block block; /**< The index entry of the block without the fields that depend on previous blocks. */
+    int gameState; /**< The last game state found in the block or -1 if there was none. */
+    size_t uncompressedSize; /**< The size of the block before compression. */
+  };
+
+  std::vector<std::unique_ptr<Buffer>> buffer; /**< Ring buffer of message queues. Shared with the writer thread. */
+  std::deque<Buffer*> freeBuffers;
+  std::deque<Buffer*> fullBuffers; /**< All buffers to be written in the order they were filled. */
+  std::deque<Buffer*> uncompressedBuffers; /**< The full buffers that no compression thread took yet. */
+  std::vector<std::unique_ptr<StagedFrame>> stagedFrames;
+  std::deque<StagedFrame*> freeStagedFrames;
   std::mutex bufferMutex;
 
   std::string logFilename; /**< Path and name of the log file. Set in initial state. */
@@ -102,9 +195,21 @@ private:
   bool receivedGameControllerPacket = false; /**< Ever received a packet from the GameController? */
   Thread<Logger> writerThread; /**< Used to write the buffer to disk in the background */
   Semaphore framesToWrite; /**< How many frames the writer thread should write? */
+  std::vector<std::unique_ptr<Thread<Logger>>> compressionThreads; /**< The threads that compress the buffers. */
+  std::atomic_bool compressing = false; /**< Shall the compression threads continue? */
+  Semaphore framesToCompress; /**< How many frames the compression threads should compress? */
   std::atomic_bool writerIdle = true; /**< Is true if the writer thread has nothing to do. */
   unsigned writerIdleStart = 0; /**< The system time at which the writer thread went idle. */
-  OutBinaryFile* file = nullptr; /**< The stream that writes the log file. */
+  OutBinaryBlockFile* file = nullptr; /**< The stream that writes the log file. */
+  std::atomic_bool lowDiskSpace = false; /**< Did the free space on the device fall below the minimum? Checked by the writer thread. */
+
+  std::atomic<unsigned> loggedFrames = 0; /**< The number of frames put into buffers. */
+  std::atomic<unsigned> droppedFrames = 0; /**< The number of frames discarded, because no buffer was free. */
+  std::atomic<unsigned> droppedMessages = 0; /**< The number of messages discarded, because a buffer was full. */
+  std::atomic<unsigned long long> uncompressedBytes = 0; /**< The size of all blocks written before compression. */
+  std::atomic<unsigned long long> writtenBytes = 0; /**< The number of bytes written to the log file. */
+  std::atomic<unsigned> logNumber = 0; /**< Incremented for each log started. Delta encoding restarts with each log. */
+  std::atomic<unsigned> recordUntil = 0; /**< The flight recorder writes all frames logged up to this system time. */
 
   enum class State
   {
@@ -142,9 +247,61 @@ private:
   /** Write all loggable representations to a buffer. */
   void logFrame(char processIdentifier);
 
+  /**
+   * Writes a representation as idDeltaMessage.
+   * @param cycle The cycle the representation belongs to.
+   * @param loggable The representation. Its previous message is updated if writing succeeds.
+   * @param out The message the data is written to.
+   * @return Could the message be written?
+   */
+  bool logDelta(Cycle& cycle, Loggable& loggable, OutMessage& out);
+
+  /**
+   * Is delta encoding active?
+   * @return Is any representation delta-encoded in a compressed log?
+   */
+  bool isDeltaEncoding() const { return parameters.compression != LogFileCompression::none && !parameters.deltaRepresentations.empty() && !isFlightRecorder(); }
+
+  /**
+   * Are frames only written around events?
+   * @return Is the flight recorder mode active?
+   */
+  bool isFlightRecorder() const { return parameters.flightRecorderDuration != 0; }
+
+  /**
+   * Checks whether an event happened in the current frame of a cycle and lets the
+   * flight recorder write the frames around it.
+   * @param processIdentifier The cycle.
+   */
+  void checkEvents(char processIdentifier);
+
   /** Write contents of buffers to disk in the background. */
   void writeThread();
 
+  /** Compress full buffers in the background. */
+  void compressThread();
+
+  /**
+   * Serializes the copies of the representations of a frame into its buffer.
+   * @param queue The buffer. Its staged frame is released.
+   */
+  void serialize(Buffer& queue);
+
+  /**
+   * Compresses a buffer and fills the parts of its index entry that only depend on the buffer itself.
+   * @param queue The buffer.
+   */
+  void compress(Buffer& queue);
+
+  /** Starts the compression threads if compression is active. */
+  void startCompression();
+
+  /** Stops the compression threads. */
+  void stopCompression();
+
+  /** Copies the statistics of the logger to the representation LoggerStatus. */
+  void updateStatus();
+
   void dumpSystemLog();
 
 public:
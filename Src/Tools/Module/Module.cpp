@@ -5,10 +5,42 @@
  */
 
 #include "Module.h"
+#include "Platform/File.h"
+#include "Platform/SystemCall.h"
+#include "Tools/Debugging/Debugging.h"
 #include "Tools/Streams/InStreams.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
 
 ModuleBase* ModuleBase::list = nullptr;
 
+void ModuleBase::RepresentationResponse::output(MessageID id, const Streamable& representation, unsigned changes)
+{
+  const unsigned now = SystemCall::getCurrentSystemTime();
+  const bool keyframe = !active || now - timestamp >= keyframeInterval;
+  if (!keyframe && changes == this->changes)
+    return;
+  this->changes = changes;
+
+  OutMessage& out = Global::getDebugOut();
+  out.bin << representation;
+  const unsigned hash = out.getHashOfCurrentMessage();
+  if (!keyframe && hash == this->hash)
+    out.cancelMessage();
+  else
+  {
+    // If the message was rejected, it is sent again in the next frame.
+    active = out.finishMessage(id);
+    this->hash = hash;
+    timestamp = now;
+  }
+}
+
 void loadModuleParameters(Streamable& parameters, const char* moduleName, const char* fileName)
 {
   std::string name;
@@ -34,6 +66,72 @@ std::string getConfigName(const char* moduleName)
   return name;
 }
 
+namespace
+{
+  std::atomic<unsigned> reloadGeneration(0); /**< Incremented for every list of replaced files read. */
+  std::atomic<long long> nextReloadPoll(0); /**< When to look for the file next in ms since the epoch of the steady clock. */
+  std::mutex reloadMutex;
+  std::vector<std::pair<std::string, unsigned>> replacedFiles; /**< The names of the files replaced and their generations. */
+}
+
+void ParameterReload::poll()
+{
+  const long long now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  long long next = nextReloadPoll;
+  if (now < next || !nextReloadPoll.compare_exchange_strong(next, now + 1000))
+    return; // not yet or another thread is already polling
+
+  const std::string path = std::string(File::getBHDir()) + "/Config/.reload";
+  std::ifstream stream(path);
+  if (!stream.is_open())
+    return;
+  std::vector<std::string> names;
+  for (std::string line; std::getline(stream, line);)
+  {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (!line.empty())
+      names.emplace_back(line.substr(line.find_last_of('/') + 1)); // modules only know the name of their file
+  }
+  stream.close();
+  std::remove(path.c_str());
+
+  std::lock_guard<std::mutex> lock(reloadMutex);
+  const unsigned generation = reloadGeneration + 1;
+  for (const std::string& name : names)
+  {
+    auto i = std::find_if(replacedFiles.begin(), replacedFiles.end(), [&name](const auto& file) { return file.first == name; });
+    if (i == replacedFiles.end())
+      replacedFiles.emplace_back(name, generation);
+    else
+      i->second = generation;
+  }
+  reloadGeneration = generation;
+}
+
+bool ParameterReload::isPending(const std::string& fileName, unsigned& generation)
+{
+  const unsigned current = reloadGeneration;
+  if (generation == current)
+    return false;
+
+  bool pending = false;
+  {
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    for (const auto& [name, replaced] : replacedFiles)
+      if (replaced > generation && fileName.size() >= name.size()
+         && fileName.compare(fileName.size() - name.size(), name.size(), name) == 0
+         && (fileName.size() == name.size() || fileName[fileName.size() - name.size() - 1] == '/'))
+        pending = true;
+  }
+  generation = current;
+  return pending;
+}
+
+unsigned ParameterReload::getGeneration()
+{
+  return reloadGeneration;
+}
 
 const ModuleBase::Info* ModuleBase::getInfoByRepresentation(std::string_view representation) const
 {
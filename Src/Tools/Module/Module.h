@@ -157,6 +157,38 @@ public:
     return ::undefined;
   }
 
+  /**
+   * The state of the debug response "representation:<name>" of a provider. A
+   * representation is only sent if it changed since it was sent the last time.
+   * The PC keeps the last version it received, so unchanged representations cost
+   * neither bandwidth nor the time of the thread. To notice a change, the
+   * modification counter is checked first and then a hash of the serialized data.
+   * Representations are sent at least once per keyframeInterval anyway, as
+   * messages can be lost.
+   */
+  class RepresentationResponse
+  {
+  public:
+    static constexpr unsigned keyframeInterval = 1000; /**< The maximum time between two messages in ms. */
+
+    /**
+     * Sends a representation if it changed or if the last message is too old.
+     * @param id The message id of the representation.
+     * @param representation The representation.
+     * @param changes The modification counter of the representation.
+     */
+    void output(MessageID id, const Streamable& representation, unsigned changes);
+
+    /** Called in frames in which the representation is not requested, so it is sent when it is requested again. */
+    void deactivate() { active = false; }
+
+  private:
+    bool active = false; /**< Was the representation requested in the previous frame? */
+    unsigned changes = 0; /**< The modification counter when the representation was sent. */
+    unsigned hash = 0; /**< The hash of the message sent. */
+    unsigned timestamp = 0; /**< The time when the representation was sent. */
+  };
+
   /**
    * Calls a draw method if a representation has one.
    * @tparam T The type of the representation.
@@ -266,6 +298,34 @@ void loadModuleParameters(Streamable& parameters, const char* moduleName, const
 
 std::string getConfigName(const char* moduleName);
 
+/**
+ * Reloads module parameters while the code is running. The file Config/.reload
+ * lists configuration files that were replaced, one path per line. It is written
+ * by the deploy script after only configuration files changed. Each module that
+ * loads its parameters from one of these files reloads them before its next update.
+ * Values a module derives from its parameters in its constructor are not updated.
+ */
+class ParameterReload
+{
+public:
+  /**
+   * Checks for a new list of replaced files. Called once per frame by every thread,
+   * but the file system is only accessed once a second.
+   */
+  static void poll();
+
+  /**
+   * Was a file replaced since a module checked for the last time?
+   * @param fileName The name of the file the module loads its parameters from.
+   * @param generation The generation the module has seen. It is updated.
+   * @return Must the parameters be reloaded?
+   */
+  static bool isPending(const std::string& fileName, unsigned& generation);
+
+  /** The generation of the files loaded now. */
+  static unsigned getGeneration();
+};
+
 // clang-format off
 
 // Some of the following macros can also be found in AutoStreamable.h with different names.
@@ -462,7 +522,10 @@ std::string getConfigName(const char* moduleName);
 #define _MODULE_LOAD_REQUIRES(type)
 #define _MODULE_LOAD_USES(type) Blackboard::getInstance().alloc<type>(#type);
 #define _MODULE_LOAD__MODULE_DEFINES_PARAMETERS(...)
-#define _MODULE_LOAD__MODULE_LOADS_PARAMETERS(...) loadModuleParameters(*this, moduleName, fileName);
+#define _MODULE_LOAD__MODULE_LOADS_PARAMETERS(...) \
+  _parameterFile = fileName ? fileName : getConfigName(moduleName); \
+  _parameterGeneration = ParameterReload::getGeneration(); \
+  loadModuleParameters(*this, moduleName, fileName);
 
 /**
  * The following macros generate the declarations for all requirements as well as
@@ -529,24 +592,41 @@ std::string getConfigName(const char* moduleName);
  /**
   * The macro defines the code added for each PROVIDES.
   * It declares the abstract update method, a pointer to the representation provided,
-  * and an static handler that calls the update method.
+  * and an static handler that calls the update method. The update method can call
+  * reportUnchanged(representation) if it did not modify the representation. Otherwise,
+  * the handler increases the modification counter of the representation. If the
+  * representation is requested by the PC, it is only sent when it changed.
   * @param type The type of the representation provided.
   * @param mod Additional code that is added to the handler.
   */
 #define _MODULE_PROVIDES(type, mod) \
   protected: virtual void update(type&) = 0; \
   \
+  protected: void reportUnchanged(const type&) { _unchanged##type = true; } \
+  \
   private: type* _the##type = &Blackboard::getInstance().alloc<type>(#type); \
+  unsigned* _changes##type = &Blackboard::getInstance().getChangeCounter(#type); \
+  bool _unchanged##type = false; \
   MessageID _id##type = ::undefined; \
+  ModuleBase::RepresentationResponse _response##type; \
   static void update##type(Streamable& module) \
   { \
     ((BaseType&) module).modifyParameters(); \
     type& r(*((BaseType&) module)._the##type); \
     BH_TRACE_MSG("update " #type); \
     STOPWATCH_WITH_PLOT(#type) ((BaseType&) module).update(r); \
+    if(((BaseType&) module)._unchanged##type) \
+      ((BaseType&) module)._unchanged##type = false; \
+    else \
+      ++*((BaseType&) module)._changes##type; \
     mod \
     if(((BaseType&) module)._id##type != ::undefined) \
-      DEBUG_RESPONSE("representation:" #type) OUTPUT(((BaseType&) module)._id##type, bin, r); \
+    { \
+      DEBUG_RESPONSE("representation:" #type) \
+        ((BaseType&) module)._response##type.output(((BaseType&) module)._id##type, r, *((BaseType&) module)._changes##type); \
+      else \
+        ((BaseType&) module)._response##type.deactivate(); \
+    } \
   }
 
 /**
@@ -583,10 +663,16 @@ std::string getConfigName(const char* moduleName);
   private: \
     static constexpr const char* moduleName = #name; \
     typedef name##Base BaseType; \
+    std::string _parameterFile; /**< The file the parameters are loaded from, empty if they are not loaded. */ \
+    unsigned _parameterGeneration = 0; \
     void modifyParameters() \
     { \
       if constexpr (sizeof(NoParameters) < sizeof(name##Module::Parameters)) \
+      { \
+        if (!_parameterFile.empty() && ParameterReload::isPending(_parameterFile, _parameterGeneration)) \
+          loadModuleParameters(*this, moduleName, _parameterFile.c_str()); \
         MODIFY("parameters:" #name, *this); \
+      } \
     } \
                                                                                    \
   private: \
@@ -9,9 +9,15 @@
 #include "Platform/BHAssert.h"
 #include <algorithm>
 #include "Platform/File.h"
+#include "Platform/SamplingProfiler.h"
+#include <chrono>
+#include <numeric>
 #include <unordered_set>
 
+#include "Tools/ProcessFramework/CycleArena.h"
 #include "Tools/ProcessFramework/SubThread.h"
+#include "Tools/Streams/InStreams.h"
+#include "Tools/Streams/OutStreams.h"
 #include <taskflow/taskflow.hpp>
 
 ModuleManager::Configuration::RepresentationProvider::RepresentationProvider(std::string representation, std::string provider)
@@ -19,9 +25,15 @@ ModuleManager::Configuration::RepresentationProvider::RepresentationProvider(std
 {
 }
 
+/** The actual type of the map for all tasks. */
+class ModuleManager::Tasks : public std::map<ModuleManager::TaskKey, tf::Task>
+{
+};
+
 CycleLocal<ModuleManager*> ModuleManager::theInstance{nullptr};
 
-ModuleManager::ModuleManager(const std::set<ModuleBase::Category>& categories, SuperThread* superthread) : taskflow(std::make_unique<tf::Taskflow>())
+ModuleManager::ModuleManager(const std::set<ModuleBase::Category>& categories, SuperThread* superthread)
+    : taskflow(std::make_unique<tf::Taskflow>()), tasks(std::make_unique<Tasks>())
 {
   this->superthread = superthread;
 
@@ -208,6 +220,14 @@ ModuleManager::Configuration ModuleManager::mergeConfig(ModuleManager::Configura
 
   currentProviders.insert(currentProviders.end(), newProviders.begin(), newProviders.end());
 
+  for (const std::string& module : newConfig.optionalModules)
+    if (std::find(config.optionalModules.begin(), config.optionalModules.end(), module) == config.optionalModules.end())
+      config.optionalModules.push_back(module);
+
+  for (const std::string& module : newConfig.cachedModules)
+    if (std::find(config.cachedModules.begin(), config.cachedModules.end(), module) == config.cachedModules.end())
+      config.cachedModules.push_back(module);
+
   return oldConfig;
 }
 
@@ -236,6 +256,13 @@ bool ModuleManager::updateProviders()
   for (auto& m : modules)
   {
     m.required = false;
+    m.optional = std::find(config.optionalModules.begin(), config.optionalModules.end(), m.module->name) != config.optionalModules.end();
+    m.cached = std::find(config.cachedModules.begin(), config.cachedModules.end(), m.module->name) != config.cachedModules.end();
+    if (m.cached && (!m.module->getInfos(Property::use).empty() || !m.module->getInfos(Property::preexecution).empty()))
+    {
+      OUTPUT_WARNING(m.module->name << " cannot be cached, because it uses representations of the previous frame or has a pre-execution.");
+      m.cached = false;
+    }
   }
 
   // fill providers list
@@ -249,11 +276,21 @@ bool ModuleManager::updateProviders()
     }
   }
 
-  // generate task graph
-  std::unique_ptr<tf::Taskflow> taskflow = generateTaskflow(providers);
+  // keep the durations measured so far
+  for (Provider& provider : providers)
+  {
+    const auto oldProvider = findProvider(this->providers, {provider.moduleState, provider.representation});
+    if (oldProvider != this->providers.end())
+      provider.duration = oldProvider->duration;
+  }
+
+  // use the schedule made in advance if it fits, it was checked for cycles when it was saved
+  std::optional<TaskGraph> scheduledTaskGraph = getScheduledTaskGraph(providers);
+  schedule.reset();
+  TaskGraph taskGraph = scheduledTaskGraph ? std::move(*scheduledTaskGraph) : generateTaskGraph(providers);
 
   // check cycles
-  std::list<std::string> cycle = findCyclicDependencies(*taskflow);
+  std::list<std::string> cycle = scheduledTaskGraph ? std::list<std::string>() : findCyclicDependencies(taskGraph);
   if (cycle.size() > 0)
   {
     const auto join = [](const std::string& a, const std::string& b)
@@ -266,11 +303,30 @@ bool ModuleManager::updateProviders()
     return false;
   }
 
+  // the tasks that are kept refer to the previous providers, so these must be kept as well
+  for (auto provider = providers.begin(); provider != providers.end();)
+  {
+    const auto oldProvider = findProvider(this->providers, {provider->moduleState, provider->representation});
+    if (oldProvider != this->providers.end())
+    {
+      providers.splice(provider, this->providers, oldProvider);
+      provider = providers.erase(provider);
+    }
+    else
+      ++provider;
+  }
+
   // apply new configuration
+  patchTaskflow(std::move(taskGraph), providers);
   this->providers = std::move(providers);
-  this->taskflow = std::move(taskflow);
+  slowestProvider = nullptr;
   this->received = std::move(received);
   this->sent = std::move(sent);
+  framesSinceScheduling = 0;
+  framesSinceConfiguration = 0;
+  resetBenchmark();
+  for (const Provider& provider : this->providers)
+    provider.heapAllocations = provider.heapBytes = 0;
 
   // delete all modules that are not required anymore
   // create new modules that are required
@@ -282,74 +338,100 @@ bool ModuleManager::updateProviders()
     }
     else if (m.required && !m.instance)
     {
+      // the constructors are run one after another, because they allocate their representations in the blackboard
+      const auto begin = std::chrono::steady_clock::now();
       m.instance = m.module->createNew();
+      m.constructionDuration = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - begin).count();
     }
   }
 
+  // the requirements of cached modules exist now, so their modification counters can be collected
+  for (Provider& provider : this->providers)
+  {
+    provider.requirementChanges.clear();
+    if (provider.moduleState->cached)
+      for (const ModuleBase::Info* requirement : provider.moduleState->module->getInfos(Property::require))
+        provider.requirementChanges.push_back(&Blackboard::getInstance().getChangeCounter(requirement->representation));
+    provider.lastRequirementChanges.assign(provider.requirementChanges.size(), 0);
+    provider.updatedSinceConfiguration = false;
+  }
+
   return true;
 }
 
+std::list<ModuleManager::Provider>::iterator ModuleManager::findProvider(std::list<Provider>& providers, const TaskKey& key)
+{
+  return std::find_if(providers.begin(),
+      providers.end(),
+      [&](const Provider& provider)
+      {
+        return provider.moduleState == key.first && provider.representation == key.second;
+      });
+}
+
+/**
+ * Smooth a measured duration.
+ * @param duration The smoothed duration that is updated.
+ * @param begin The time when the measurement started.
+ */
+static float smoothDuration(float& duration, std::chrono::steady_clock::time_point begin)
+{
+  const float measured = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - begin).count();
+  duration = duration == 0.f ? measured : 0.9f * duration + 0.1f * measured;
+  return measured;
+}
 
-std::unique_ptr<tf::Taskflow> ModuleManager::generateTaskflow(const std::list<Provider>& providers)
+ModuleManager::TaskGraph ModuleManager::generateTaskGraph(const std::list<Provider>& providers)
 {
-  std::unique_ptr<tf::Taskflow> taskflow = std::make_unique<tf::Taskflow>();
+  TaskGraph taskGraph;
 
   // remember tasks
-  std::map<const Provider*, tf::Task> updateTasks;
-  std::map<const ModuleBase*, tf::Task> executeTasks;
+  std::map<const Provider*, TaskKey> updateTasks;
+  std::map<const ModuleBase*, TaskKey> executeTasks;
 
-  std::map<const ModuleBase*, std::tuple<std::list<tf::Task*>, std::list<tf::Task*>>> tasksOfModules;
+  std::map<const ModuleBase*, std::tuple<std::list<const TaskKey*>, std::list<const TaskKey*>>> tasksOfModules;
 
-  // create tasks
+  // tasks are emplaced in the order of decreasing critical path lengths,
+  // because the executor schedules tasks that are ready in that order
+  const CriticalPaths criticalPaths = calcCriticalPaths(providers);
+  std::vector<const Provider*> orderedProviders;
   for (const Provider& provider : providers)
+    orderedProviders.push_back(&provider);
+  std::stable_sort(orderedProviders.begin(),
+      orderedProviders.end(),
+      [&](const Provider* p1, const Provider* p2)
+      {
+        return criticalPaths.lengths.at(p1) > criticalPaths.lengths.at(p2);
+      });
+  std::map<TaskKey, float> criticalPathLengths;
+
+  // create tasks
+  for (const Provider* provider : orderedProviders)
   {
     // add update methods
-    updateTasks[&provider] =
-        taskflow
-            ->emplace(
-                [&]() noexcept
-                {
-                  if (provider.moduleState->instance)
-                    provider.update(*provider.moduleState->instance);
-                })
-            .name(std::string(provider.representation) + " [" + provider.moduleState->module->name + "]");
+    const TaskKey& updateTask = updateTasks[provider] = {provider->moduleState, provider->representation};
+    taskGraph.tasks.push_back(updateTask);
+    criticalPathLengths[updateTask] = criticalPaths.lengths.at(provider);
 
     // remember tasks for update methods of modules to add dependencies later
-    auto& [sequentialTasks, concurrentTasks] = tasksOfModules[provider.moduleState->module];
-    if (provider.info->hasProperty(Property::concurrent))
-      concurrentTasks.push_back(&updateTasks[&provider]);
+    auto& [sequentialTasks, concurrentTasks] = tasksOfModules[provider->moduleState->module];
+    if (provider->info->hasProperty(Property::concurrent))
+      concurrentTasks.push_back(&updateTask);
     else
-      sequentialTasks.push_back(&updateTasks[&provider]);
+      sequentialTasks.push_back(&updateTask);
 
     // add pre-execution methods
-    for (const ModuleBase::Info* info : provider.moduleState->module->getInfos(Property::preexecution))
+    if (!provider->moduleState->module->getInfos(Property::preexecution).empty() && executeTasks.find(provider->moduleState->module) == executeTasks.end())
     {
-      if (executeTasks.find(provider.moduleState->module) == executeTasks.end())
-      {
-        executeTasks[provider.moduleState->module] =
-            taskflow
-                ->emplace(
-                    [&, execute = info->execute](tf::Subflow& subflow) noexcept
-                    {
-                      if (provider.moduleState->instance)
-                      {
-                        STOPWATCH(provider.moduleState->module->name)
-                        {
-                          execute(*provider.moduleState->instance, subflow);
-                          if (subflow.joinable())
-                            subflow.join();
-                        }
-                      }
-                    })
-                .name(std::string(provider.moduleState->module->name) + " [" + provider.moduleState->module->name + "]");
-      }
+      executeTasks[provider->moduleState->module] = {provider->moduleState, nullptr};
+      taskGraph.tasks.push_back(executeTasks[provider->moduleState->module]);
     }
   }
 
   // a module is able to provide and require the same representation
   // in this case, the corresponding update method is guaranteed to be executed first
   // remember this first update method here
-  std::map<const ModuleBase*, tf::Task*> firstUpdateOfModules;
+  std::map<const ModuleBase*, const TaskKey*> firstUpdateOfModules;
 
   // add dependencies of update methods
   for (auto& [provider1, task] : updateTasks)
@@ -381,7 +463,7 @@ std::unique_ptr<tf::Taskflow> ModuleManager::generateTaskflow(const std::list<Pr
           continue;
       }
 
-      updateTasks[&*provider2].precede(task);
+      taskGraph.dependencies.emplace(updateTasks[&*provider2], task);
     }
   }
 
@@ -400,35 +482,38 @@ std::unique_ptr<tf::Taskflow> ModuleManager::generateTaskflow(const std::list<Pr
       if (executeModule == provider->moduleState->module)
         continue;
 
-      updateTasks[&*provider].precede(executeTask);
+      taskGraph.dependencies.emplace(updateTasks[&*provider], executeTask);
     }
   }
 
   // precalculate successor counts
-  std::unordered_map<const tf::Task*, size_t> numSuccessors;
+  std::map<TaskKey, std::vector<TaskKey>> successors;
+  for (const auto& [predecessor, successor] : taskGraph.dependencies)
+    successors[predecessor].push_back(successor);
+
+  std::map<TaskKey, size_t> numSuccessors;
   for (const auto& [_, task] : updateTasks)
   {
-    std::unordered_set<size_t> visited;
-    const std::function<void(tf::Task)> addToVisited = [&](tf::Task t)
+    std::set<TaskKey> visited;
+    const std::function<void(const TaskKey&)> addToVisited = [&](const TaskKey& t)
     {
-      if (visited.find(t.hash_value()) == visited.end())
-      {
-        visited.insert(t.hash_value());
-        t.for_each_successor(addToVisited);
-      }
+      if (visited.insert(t).second)
+        for (const TaskKey& successor : successors[t])
+          addToVisited(successor);
     };
-    task.for_each_successor(addToVisited);
+    for (const TaskKey& successor : successors[task])
+      addToVisited(successor);
 
-    numSuccessors[&task] = visited.size();
+    numSuccessors[task] = visited.size();
   }
 
   // add dependencies between update/pre-execution methods of the same module
-  for (auto& [module, tasks] : tasksOfModules)
+  for (auto& [module, tasksOfModule] : tasksOfModules)
   {
-    auto& [sequentialTasks, concurrentTasks] = tasks;
+    auto& [sequentialTasks, concurrentTasks] = tasksOfModule;
 
     const auto firstUpdate = firstUpdateOfModules.find(module);
-    const auto decreasingSuccessors = [&](const tf::Task* t1, const tf::Task* t2)
+    const auto decreasingSuccessors = [&](const TaskKey* t1, const TaskKey* t2)
     {
       // prefer first update method
       if (firstUpdate != firstUpdateOfModules.end())
@@ -439,93 +524,396 @@ std::unique_ptr<tf::Taskflow> ModuleManager::generateTaskflow(const std::list<Pr
           return false;
       }
 
-      return numSuccessors[t1] > numSuccessors[t2];
+      // prefer tasks on longer critical paths, so cheap leaf tasks run last
+      if (criticalPathLengths[*t1] != criticalPathLengths[*t2])
+        return criticalPathLengths[*t1] > criticalPathLengths[*t2];
+
+      return numSuccessors[*t1] > numSuccessors[*t2];
     };
     sequentialTasks.sort(decreasingSuccessors);
 
     // 1. run pre-execution
-    tf::Task* prevTask = executeTasks.find(module) != executeTasks.end() ? &executeTasks[module] : nullptr;
+    const TaskKey* prevTask = executeTasks.find(module) != executeTasks.end() ? &executeTasks[module] : nullptr;
 
     // 2. run concurrent updates
-    for (tf::Task* concurrentTask : concurrentTasks)
+    for (const TaskKey* concurrentTask : concurrentTasks)
     {
       if (prevTask)
-        prevTask->precede(*concurrentTask);
+        taskGraph.dependencies.emplace(*prevTask, *concurrentTask);
 
       if (sequentialTasks.size() > 0)
-        concurrentTask->precede(*sequentialTasks.front());
+        taskGraph.dependencies.emplace(*concurrentTask, *sequentialTasks.front());
 
       if (concurrentTask == concurrentTasks.back())
         prevTask = nullptr;
     }
 
     // 3. run sequential updates
-    for (tf::Task* task : sequentialTasks)
+    for (const TaskKey* task : sequentialTasks)
     {
       if (prevTask)
-        prevTask->precede(*task);
+        taskGraph.dependencies.emplace(*prevTask, *task);
       prevTask = task;
     }
   }
 
-  return taskflow;
+  return taskGraph;
+}
+
+unsigned ModuleManager::getFingerprint(const std::list<Provider>& providers)
+{
+  // FNV-1a, because the schedule is made on a PC and used on the robot, where std::hash may differ
+  unsigned fingerprint = 2166136261u;
+  const auto add = [&fingerprint](std::string_view text)
+  {
+    for (const char c : text)
+      fingerprint = (fingerprint ^ static_cast<unsigned char>(c)) * 16777619u;
+    fingerprint = (fingerprint ^ 0xffu) * 16777619u;
+  };
+
+  for (const Provider& provider : providers)
+  {
+    add(provider.representation);
+    add(provider.moduleState->module->name);
+    for (const ModuleBase::Info& info : *provider.moduleState->module->infos)
+    {
+      std::string properties;
+      for (unsigned property = 0; property < Property::numOfPropertys; ++property)
+        properties += info.hasProperty(static_cast<Property>(property)) ? '1' : '0';
+      add(info.representation ? info.representation : "");
+      add(properties);
+    }
+  }
+  return fingerprint;
+}
+
+std::string ModuleManager::getTaskName(const TaskKey& key)
+{
+  return (key.second ? std::string(key.second) + " " : std::string()) + "[" + key.first->module->name + "]";
+}
+
+std::optional<ModuleManager::TaskGraph> ModuleManager::getScheduledTaskGraph(const std::list<Provider>& providers) const
+{
+  if (!schedule || schedule->fingerprint != getFingerprint(providers) || schedule->dependencies.size() % 2)
+    return {};
+
+  std::unordered_map<std::string, TaskKey> keys;
+  for (const Provider& provider : providers)
+  {
+    keys.emplace(getTaskName({provider.moduleState, provider.representation}), TaskKey(provider.moduleState, provider.representation));
+    if (!provider.moduleState->module->getInfos(Property::preexecution).empty())
+      keys.emplace(getTaskName({provider.moduleState, nullptr}), TaskKey(provider.moduleState, nullptr));
+  }
+  if (keys.size() != schedule->tasks.size())
+    return {};
+
+  TaskGraph taskGraph;
+  for (const std::string& name : schedule->tasks)
+  {
+    const auto key = keys.find(name);
+    if (key == keys.end())
+      return {};
+    taskGraph.tasks.push_back(key->second);
+  }
+  for (size_t i = 0; i < schedule->dependencies.size(); i += 2)
+  {
+    if (schedule->dependencies[i] >= taskGraph.tasks.size() || schedule->dependencies[i + 1] >= taskGraph.tasks.size())
+      return {};
+    taskGraph.dependencies.emplace(taskGraph.tasks[schedule->dependencies[i]], taskGraph.tasks[schedule->dependencies[i + 1]]);
+  }
+  return taskGraph;
+}
+
+void ModuleManager::saveSchedule() const
+{
+  Schedule schedule;
+  schedule.fingerprint = getFingerprint(providers);
+  std::map<TaskKey, unsigned> indices;
+  for (const TaskKey& key : taskGraph.tasks)
+  {
+    indices[key] = static_cast<unsigned>(schedule.tasks.size());
+    schedule.tasks.push_back(getTaskName(key));
+  }
+  for (const auto& [predecessor, successor] : taskGraph.dependencies)
+  {
+    schedule.dependencies.push_back(indices[predecessor]);
+    schedule.dependencies.push_back(indices[successor]);
+  }
+
+  const std::string name = std::string(File::getBHDir()) + "/Config/moduleSchedule" + superthread->getThreadName() + ".cfg";
+  OutMapFile stream(name);
+  stream << schedule;
+  OUTPUT_TEXT(superthread->getThreadName() << " schedule of " << schedule.tasks.size() << " tasks written to " << name);
+}
+
+void ModuleManager::patchTaskflow(TaskGraph taskGraph, std::list<Provider>& providers)
+{
+  // tasks that do not exist anymore and targets of dependencies that do not exist anymore
+  // must be recreated, because dependencies cannot be removed from a taskflow individually
+  std::set<TaskKey> obsolete;
+  for (const auto& [key, task] : *tasks)
+    if (std::find(taskGraph.tasks.begin(), taskGraph.tasks.end(), key) == taskGraph.tasks.end())
+      obsolete.insert(key);
+  for (const auto& dependency : this->taskGraph.dependencies)
+    if (taskGraph.dependencies.find(dependency) == taskGraph.dependencies.end())
+      obsolete.insert(dependency.second);
+
+  for (const TaskKey& key : obsolete)
+  {
+    const auto task = tasks->find(key);
+    if (task != tasks->end())
+    {
+      taskflow->erase(task->second);
+      tasks->erase(task);
+    }
+  }
+
+  // create missing tasks
+  std::set<TaskKey> created;
+  for (const TaskKey& key : taskGraph.tasks)
+  {
+    if (tasks->find(key) != tasks->end())
+      continue;
+
+    ModuleState& moduleState = *key.first;
+    if (key.second)
+    {
+      const Provider& provider = *findProvider(providers, key);
+      (*tasks)[key] = taskflow
+                       ->emplace(
+                           [this, &provider]() noexcept
+                           {
+                             if (provider.moduleState->instance)
+                             {
+                               const auto begin = std::chrono::steady_clock::now();
+                               if (deadlineActive && provider.moduleState->optional && begin + std::chrono::microseconds(static_cast<int>(provider.duration)) > deadline)
+                               {
+                                 ++provider.skipped;
+                                 return;
+                               }
+                               if (provider.moduleState->cached && provider.requirementsUnchanged())
+                               {
+                                 ++provider.unchanged;
+                                 return;
+                               }
+                               const size_t allocated = CycleArena::getAllocatedByThread();
+                               const size_t heapAllocations = SystemCall::getHeapAllocationsOfThread();
+                               const size_t heapBytes = SystemCall::getHeapBytesOfThread();
+                               SamplingProfiler::setCurrentModule(provider.moduleState->module->name);
+                               provider.update(*provider.moduleState->instance);
+                               SamplingProfiler::setCurrentModule(nullptr);
+                               provider.lastDuration = smoothDuration(provider.duration, begin);
+                               provider.arenaBytes = std::max(provider.arenaBytes, CycleArena::getAllocatedByThread() - allocated);
+                               provider.lastHeapAllocations = SystemCall::getHeapAllocationsOfThread() - heapAllocations;
+                               provider.lastHeapBytes = SystemCall::getHeapBytesOfThread() - heapBytes;
+                             }
+                           })
+                       .name(std::string(provider.representation) + " [" + moduleState.module->name + "]");
+    }
+    else
+    {
+      (*tasks)[key] = taskflow
+                       ->emplace(
+                           [&moduleState, execute = (*moduleState.module->getInfos(Property::preexecution).begin())->execute](tf::Subflow& subflow) noexcept
+                           {
+                             if (moduleState.instance)
+                             {
+                               const auto begin = std::chrono::steady_clock::now();
+                               STOPWATCH(moduleState.module->name)
+                               {
+                                 SamplingProfiler::setCurrentModule(moduleState.module->name);
+                                 execute(*moduleState.instance, subflow);
+                                 SamplingProfiler::setCurrentModule(nullptr);
+                                 if (subflow.joinable())
+                                   subflow.join();
+                               }
+                               smoothDuration(moduleState.executeDuration, begin);
+                             }
+                           })
+                       .name(std::string(moduleState.module->name) + " [" + moduleState.module->name + "]");
+    }
+    created.insert(key);
+  }
+
+  // add dependencies that are new or that belonged to recreated tasks
+  for (const auto& dependency : taskGraph.dependencies)
+    if (created.count(dependency.first) || created.count(dependency.second) || this->taskGraph.dependencies.find(dependency) == this->taskGraph.dependencies.end())
+      (*tasks)[dependency.first].precede((*tasks)[dependency.second]);
+
+  this->taskGraph = std::move(taskGraph);
 }
 
-std::list<std::string> ModuleManager::findCyclicDependencies(const tf::Taskflow& tf)
+ModuleManager::CriticalPaths ModuleManager::calcCriticalPaths(const std::list<Provider>& providers)
 {
-  // transform Taskflow to simple graph structure for easy traversal
-  using Vertex = std::string;
-  using Graph = std::unordered_map<Vertex, std::unordered_set<Vertex>>;
-  Graph graph;
+  CriticalPaths criticalPaths;
+
+  for (const Provider& provider : providers)
+  {
+    criticalPaths.successors[&provider];
+    for (const ModuleBase::Info* requirement : provider.moduleState->module->getInfos(Property::require))
+    {
+      const auto predecessor = std::find(providers.begin(), providers.end(), requirement->representation);
+
+      // skip requirements provided by default and by the same module
+      if (predecessor != providers.end() && predecessor->moduleState != provider.moduleState)
+        criticalPaths.successors[&*predecessor].push_back(&provider);
+    }
+  }
+
+  const std::function<float(const Provider*)> length = [&](const Provider* provider) -> float
+  {
+    const auto known = criticalPaths.lengths.find(provider);
+    if (known != criticalPaths.lengths.end())
+      return known->second;
+
+    // the pre-execution delays all updates of a module
+    const float duration = provider->duration + provider->moduleState->executeDuration;
+
+    // preliminary value stops the recursion in case of cyclic dependencies, which are reported elsewhere
+    criticalPaths.lengths[provider] = duration;
+
+    float longest = 0.f;
+    for (const Provider* successor : criticalPaths.successors[provider])
+      longest = std::max(longest, length(successor));
+
+    return criticalPaths.lengths[provider] = duration + longest;
+  };
+
+  for (const Provider& provider : providers)
+    length(&provider);
+
+  return criticalPaths;
+}
 
-  tf.for_each_task(
-      [&](const tf::Task& task)
+void ModuleManager::reschedule()
+{
+  TaskGraph taskGraph = generateTaskGraph(providers);
+
+  // reordering the updates of a module may introduce cycles, keep the old graph then
+  if (!findCyclicDependencies(taskGraph).empty())
+    return;
+
+  // rebuild everything, because the tasks should be emplaced in the new order
+  taskflow = std::make_unique<tf::Taskflow>();
+  tasks->clear();
+  this->taskGraph = TaskGraph();
+  patchTaskflow(std::move(taskGraph), providers);
+}
+
+void ModuleManager::resetBenchmark()
+{
+  benchmarkFrames = 0;
+  benchmarkFrameDurations.clear();
+  for (const Provider& provider : providers)
+  {
+    provider.benchmarkDuration = 0.;
+    provider.benchmarkHeapAllocations = 0;
+    provider.benchmarkExecutions = 0;
+    provider.benchmarkDurations.clear();
+    provider.benchmarkWorstDuration = 0.f;
+    provider.benchmarkWorstFrame = 0;
+  }
+}
+
+void ModuleManager::addBenchmarkSample(std::vector<float>& durations, unsigned count, float duration)
+{
+  if (durations.size() < maxBenchmarkSamples)
+    durations.push_back(duration);
+  else
+    durations[(count - 1) % maxBenchmarkSamples] = duration;
+}
+
+void ModuleManager::reportBenchmark() const
+{
+  std::vector<const Provider*> executed;
+  for (const Provider& provider : providers)
+    if (provider.benchmarkExecutions)
+      executed.push_back(&provider);
+  std::sort(executed.begin(), executed.end(),
+      [](const Provider* p1, const Provider* p2)
+      {
+        return p1->benchmarkDuration > p2->benchmarkDuration;
+      });
+
+  // sorts a copy of the durations and returns the requested percentiles in µs
+  const auto percentiles = [](std::vector<float> durations)
+  {
+    std::sort(durations.begin(), durations.end());
+    const auto at = [&](float q)
+    {
+      return durations.empty() ? 0.f : durations[std::min(durations.size() - 1, static_cast<size_t>(q * static_cast<float>(durations.size())))];
+    };
+    return " p50 " + std::to_string(static_cast<int>(at(0.5f))) + " µs, p99 " + std::to_string(static_cast<int>(at(0.99f))) + " µs";
+  };
+
+  // the frames still in the ring that took longest, the newest sample is stored at index (benchmarkFrames - 1) % maxBenchmarkSamples
+  std::vector<size_t> worstFrames(benchmarkFrameDurations.size());
+  std::iota(worstFrames.begin(), worstFrames.end(), 0);
+  const size_t numOfWorstFrames = std::min<size_t>(worstFrames.size(), 5);
+  std::partial_sort(worstFrames.begin(), worstFrames.begin() + numOfWorstFrames, worstFrames.end(),
+      [&](size_t i1, size_t i2)
       {
-        auto& pre = graph[task.name()];
-        task.for_each_successor(
-            [&](const tf::Task& suc)
-            {
-              pre.insert(suc.name());
-            });
+        return benchmarkFrameDurations[i1] > benchmarkFrameDurations[i2];
       });
 
+  const double frames = std::max(benchmarkFrames, 1u);
+  std::string text = superthread->getThreadName() + " benchmark of the last " + std::to_string(benchmarkFrames) + " frames:" + percentiles(benchmarkFrameDurations)
+      + "\n worst frames:";
+  for (size_t i = 0; i < numOfWorstFrames; ++i)
+    text += " " + std::to_string(benchmarkFrames - (benchmarkFrames - 1 - worstFrames[i]) % maxBenchmarkSamples) + " ("
+        + std::to_string(static_cast<int>(benchmarkFrameDurations[worstFrames[i]])) + " µs)";
+  text += "\n (ns/frame, percentiles, worst frame, executions, heap allocations/frame)";
+  for (const Provider* provider : executed)
+    text += "\n  " + std::string(provider->representation) + " [" + provider->moduleState->module->name + "]: "
+        + std::to_string(static_cast<long long>(provider->benchmarkDuration * 1000. / frames)) + "," + percentiles(provider->benchmarkDurations) + ", "
+        + std::to_string(provider->benchmarkWorstFrame) + " (" + std::to_string(static_cast<int>(provider->benchmarkWorstDuration)) + " µs), "
+        + std::to_string(provider->benchmarkExecutions) + ", " + std::to_string(static_cast<double>(provider->benchmarkHeapAllocations) / frames);
+  OUTPUT_TEXT(text);
+}
+
+std::list<std::string> ModuleManager::findCyclicDependencies(const TaskGraph& taskGraph)
+{
+  std::map<TaskKey, std::vector<TaskKey>> successors;
+  for (const auto& [predecessor, successor] : taskGraph.dependencies)
+    successors[predecessor].push_back(successor);
+
   // using depth first search for cycle detection
   // see: https://de.wikipedia.org/wiki/Zyklus_(Graphentheorie)
-  const auto checkCycle = [](const Graph& graph, const Vertex& v)
+  std::set<TaskKey> visited, finished;
+  std::list<TaskKey> path;
+  const std::function<bool(const TaskKey&)> dfs = [&](const TaskKey& v) -> bool
   {
-    std::unordered_set<Vertex> visited, finished;
-    using DepthFirstSearch = std::function<std::list<Vertex>(const Vertex&)>;
-
-    const DepthFirstSearch dfs = [&](const Vertex& v) -> std::list<Vertex>
+    visited.insert(v);
+    path.push_back(v);
+    for (const TaskKey& suc : successors[v])
     {
-      if (finished.count(v))
-        return {};
-      if (visited.count(v))
-        return {v};
-      visited.insert(v);
-      for (const Vertex& suc : graph.at(v))
+      if (finished.count(suc))
+        continue;
+      if (visited.count(suc))
       {
-        std::list<Vertex> ret = dfs(suc);
-        if (ret.size() > 0)
-        {
-          if (ret.size() < 2 || ret.front() != ret.back())
-            ret.push_front(v);
-          return ret;
-        }
+        // only keep the cycle itself
+        path.erase(path.begin(), std::find(path.begin(), path.end(), suc));
+        path.push_back(suc);
+        return true;
       }
-      finished.insert(v);
-      return {};
-    };
-    return dfs(v);
+      if (dfs(suc))
+        return true;
+    }
+    path.pop_back();
+    finished.insert(v);
+    return false;
   };
 
-  std::list<Vertex> result;
-  tf.for_each_task(
-      [&](const tf::Task& task)
-      {
-        if (result.size() == 0)
-          result = checkCycle(graph, task.name());
-      });
+  std::list<std::string> result;
+  for (const TaskKey& task : taskGraph.tasks)
+  {
+    if (!visited.count(task) && dfs(task))
+    {
+      for (const auto& [moduleState, representation] : path)
+        result.push_back(std::string(representation ? representation : moduleState->module->name) + " [" + moduleState->module->name + "]");
+      break;
+    }
+  }
   return result;
 }
 
@@ -542,6 +930,13 @@ void ModuleManager::load()
     mergeConfig(config, stream);
   }
 
+  InMapFile scheduleStream("moduleSchedule" + superthread->getThreadName() + ".cfg");
+  if (scheduleStream.exists())
+  {
+    schedule.emplace();
+    scheduleStream >> *schedule;
+  }
+
   if (updateProviders())
   {
     // we cannot use system time here because we need the same value in motion and cognition
@@ -552,7 +947,78 @@ void ModuleManager::load()
 
 void ModuleManager::execute()
 {
+  const unsigned frameDeadline = superthread->getConfiguration().frameDeadline;
+  deadlineActive = frameDeadline != 0;
+  deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(frameDeadline);
+  ParameterReload::poll();
+
+  const auto begin = std::chrono::steady_clock::now();
   this->superthread->run(*taskflow);
+  addBenchmarkSample(benchmarkFrameDurations, ++benchmarkFrames,
+      std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - begin).count());
+
+  // remember the slowest update of this frame, the durations of the next one are measured from scratch
+  slowestProvider = nullptr;
+  slowestDuration = 0.f;
+  for (const Provider& provider : providers)
+  {
+    if (provider.lastDuration > slowestDuration)
+    {
+      slowestProvider = &provider;
+      slowestDuration = provider.lastDuration;
+    }
+    if (provider.lastDuration > 0.f)
+    {
+      provider.benchmarkDuration += provider.lastDuration;
+      provider.benchmarkHeapAllocations += provider.lastHeapAllocations;
+      addBenchmarkSample(provider.benchmarkDurations, ++provider.benchmarkExecutions, provider.lastDuration);
+      if (provider.lastDuration > provider.benchmarkWorstDuration)
+      {
+        provider.benchmarkWorstDuration = provider.lastDuration;
+        provider.benchmarkWorstFrame = benchmarkFrames;
+      }
+    }
+    provider.lastDuration = 0.f;
+  }
+
+  // after the warm-up, update handlers should not allocate memory anymore
+  const unsigned heapCheckWarmUpFrames = superthread->getConfiguration().heapCheckWarmUpFrames;
+  ++framesSinceConfiguration;
+  for (const Provider& provider : providers)
+  {
+    if (heapCheckWarmUpFrames && framesSinceConfiguration >= heapCheckWarmUpFrames && provider.lastHeapAllocations && !provider.heapAllocationsReported)
+    {
+      provider.heapAllocationsReported = true;
+      OUTPUT_WARNING(superthread->getThreadName() << ": " << provider.representation << " [" << provider.moduleState->module->name << "] made "
+                                                  << provider.lastHeapAllocations << " heap allocations after the warm-up");
+    }
+    provider.heapAllocations += provider.lastHeapAllocations;
+    provider.heapBytes += provider.lastHeapBytes;
+    provider.lastHeapAllocations = provider.lastHeapBytes = 0;
+  }
+
+  DEBUG_RESPONSE_ONCE("module:heapAllocations")
+  {
+    std::vector<const Provider*> allocating;
+    for (const Provider& provider : providers)
+      if (provider.heapAllocations)
+        allocating.push_back(&provider);
+    std::sort(allocating.begin(), allocating.end(),
+        [](const Provider* p1, const Provider* p2)
+        {
+          return p1->heapAllocations > p2->heapAllocations;
+        });
+
+    std::string text = superthread->getThreadName() + " heap allocations per frame in the last " + std::to_string(framesSinceConfiguration) + " frames:";
+    for (const Provider* provider : allocating)
+      text += "\n  " + std::string(provider->representation) + " [" + provider->moduleState->module->name + "]: "
+          + std::to_string(static_cast<float>(provider->heapAllocations) / static_cast<float>(framesSinceConfiguration)) + " ("
+          + std::to_string(provider->heapBytes / framesSinceConfiguration) + " bytes)";
+    OUTPUT_TEXT(text);
+  }
+
+  DEBUG_RESPONSE_ONCE("module:resetBenchmark") resetBenchmark();
+  DEBUG_RESPONSE_ONCE("module:benchmark") reportBenchmark();
 
   if (!timeStamp) // Configuration changed recently?
   { // all representations must be constructed now, so we can receive data
@@ -561,8 +1027,108 @@ void ModuleManager::execute()
     for (const auto& s : sent)
       toSend.push_back(&Blackboard::getInstance()[s]);
     toReceive.clear();
+    toReceiveChanges.clear();
     for (const auto& r : received)
+    {
       toReceive.push_back(&Blackboard::getInstance()[r]);
+      toReceiveChanges.push_back(&Blackboard::getInstance().getChangeCounter(r));
+    }
+  }
+
+  const unsigned schedulingInterval = superthread->getConfiguration().criticalPathSchedulingInterval;
+  if (schedulingInterval && ++framesSinceScheduling >= schedulingInterval)
+  {
+    framesSinceScheduling = 0;
+    reschedule();
+  }
+
+  DEBUG_RESPONSE_ONCE("module:criticalPath")
+  {
+    const CriticalPaths criticalPaths = calcCriticalPaths(providers);
+    const auto longer = [&](const Provider* p1, const Provider* p2)
+    {
+      return criticalPaths.lengths.at(p1) < criticalPaths.lengths.at(p2);
+    };
+
+    const Provider* provider = nullptr;
+    for (const Provider& p : providers)
+      if (!provider || longer(provider, &p))
+        provider = &p;
+
+    if (provider)
+    {
+      std::string text = superthread->getThreadName() + " critical path (" + std::to_string(static_cast<int>(criticalPaths.lengths.at(provider))) + " µs):";
+      while (provider)
+      {
+        text += "\n  " + std::string(provider->representation) + " [" + provider->moduleState->module->name + "]: " + std::to_string(static_cast<int>(provider->duration)) + " µs";
+        const auto& successors = criticalPaths.successors.at(provider);
+        const auto next = std::max_element(successors.begin(), successors.end(), longer);
+        provider = next != successors.end() ? *next : nullptr;
+      }
+      OUTPUT_TEXT(text);
+    }
+  }
+
+  DEBUG_RESPONSE_ONCE("module:skippedUpdates")
+  {
+    std::map<std::string, unsigned> skipped;
+    for (const Provider& provider : providers)
+      if (provider.moduleState->optional)
+        skipped[provider.moduleState->module->name] += provider.skipped;
+
+    std::string text = superthread->getThreadName() + " skipped updates of optional modules:";
+    for (const auto& [module, count] : skipped)
+      text += "\n  " + module + ": " + std::to_string(count);
+
+    std::map<std::string, unsigned> unchanged;
+    for (const Provider& provider : providers)
+      if (provider.moduleState->cached)
+        unchanged[provider.moduleState->module->name] += provider.unchanged;
+    if (!unchanged.empty())
+    {
+      text += "\n" + superthread->getThreadName() + " skipped updates of cached modules, because their requirements did not change:";
+      for (const auto& [module, count] : unchanged)
+        text += "\n  " + module + ": " + std::to_string(count);
+    }
+    OUTPUT_TEXT(text);
+  }
+
+  DEBUG_RESPONSE_ONCE("module:startup")
+  {
+    std::vector<const ModuleState*> constructed;
+    float total = 0.f;
+    for (const ModuleState& m : modules)
+      if (m.instance)
+      {
+        constructed.push_back(&m);
+        total += m.constructionDuration;
+      }
+    std::sort(constructed.begin(), constructed.end(),
+        [](const ModuleState* m1, const ModuleState* m2)
+        {
+          return m1->constructionDuration > m2->constructionDuration;
+        });
+
+    std::string text = superthread->getThreadName() + " construction of the modules (" + std::to_string(static_cast<int>(total / 1000.f)) + " ms):";
+    for (const ModuleState* m : constructed)
+      text += "\n  " + std::string(m->module->name) + ": " + std::to_string(static_cast<int>(m->constructionDuration)) + " µs";
+    OUTPUT_TEXT(text);
+  }
+
+  DEBUG_RESPONSE_ONCE("module:saveSchedule")
+  saveSchedule();
+
+  DEBUG_RESPONSE_ONCE("module:arenaUsage")
+  {
+    std::map<std::string, size_t> arenaBytes;
+    for (const Provider& provider : providers)
+      if (provider.arenaBytes)
+        arenaBytes[provider.moduleState->module->name] += provider.arenaBytes;
+
+    std::string text = superthread->getThreadName() + " cycle arena high-water mark: " + std::to_string(CycleArena::get().getHighWaterMark()) + " bytes";
+    for (const auto& [module, bytes] : arenaBytes)
+      text += "\n  " + module + ": " + std::to_string(bytes) + " bytes";
+    OUTPUT_TEXT(text);
   }
 
   const ModuleManager::NextConfig* nextModuleConfig = nextConfig.load(std::memory_order_acquire);
@@ -634,6 +1200,8 @@ void ModuleManager::readPackage(In& stream)
     writeModuleConfig = false;
     for (Streamable* s : toReceive)
       stream >> *s;
+    for (unsigned* changes : toReceiveChanges)
+      ++*changes;
   }
   else
   {
@@ -672,6 +1240,19 @@ void ModuleManager::writePackage(Out& stream) const
     stream << *s;
 }
 
+float ModuleManager::getSlowestUpdate(const char*& module, const char*& representation)
+{
+  const ModuleManager* moduleManager = *theInstance;
+  if (!moduleManager || !moduleManager->slowestProvider)
+  {
+    module = representation = nullptr;
+    return 0.f;
+  }
+  module = moduleManager->slowestProvider->moduleState->module->name;
+  representation = moduleManager->slowestProvider->representation;
+  return moduleManager->slowestDuration;
+}
+
 ModuleManager::Configuration ModuleManager::sendModuleRequest(const ModuleManager::Configuration& configRequest)
 {
   // With C++17, smart pointers cannot be used with std::atomic :-(
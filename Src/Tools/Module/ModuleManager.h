@@ -12,6 +12,7 @@
 #include <list>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <vector>
 #include "Tools/ProcessFramework/CycleLocal.h"
 #include <memory>
@@ -20,6 +21,7 @@
 #include <atomic>
 #include <initializer_list>
 #include <optional>
+#include <chrono>
 
 class SuperThread;
 namespace tf
@@ -46,6 +48,10 @@ private:
     ModuleBase* module; /**< A pointer to the module base that is able to create an instance of the module. */
     std::unique_ptr<Streamable> instance = nullptr; /**< A pointer to the instance of the module if it was created. Otherwise the pointer is 0. */
     bool required = false; /**< A flag that is required when determining whether a module is currently required or not. */
+    float executeDuration = 0.f; /**< The smoothed duration of the pre-execution of the module in µs. */
+    bool optional = false; /**< May the updates of this module be skipped if the frame deadline would be exceeded? */
+    bool cached = false; /**< May the updates of this module be skipped if none of the representations it requires changed? */
+    float constructionDuration = 0.f; /**< How long did the construction of the current instance take in µs? */
 
     /**
      * Constructor.
@@ -71,6 +77,25 @@ private:
     ModuleState* moduleState; /**< The moduleState that will give access to the module that provides the information. */
     const ModuleBase::Info* info; /**< The module info that will give access to the properties. */
     void (*update)(Streamable&); /**< The update handler within the module. */
+    mutable float duration = 0.f; /**< The smoothed duration of the update handler in µs. It is measured by the task executing it. */
+    mutable float lastDuration = 0.f; /**< The duration of the update handler in the current frame in µs, 0 if it was not executed. */
+    mutable unsigned skipped = 0; /**< How often was the update handler skipped, because the frame deadline would have been exceeded? */
+    mutable size_t arenaBytes = 0; /**< The maximum number of bytes the update handler allocated from the CycleArena in a single frame. */
+    mutable size_t lastHeapAllocations = 0; /**< The number of heap allocations of the update handler in the current frame. */
+    mutable size_t lastHeapBytes = 0; /**< The number of bytes the update handler allocated from the heap in the current frame. */
+    mutable size_t heapAllocations = 0; /**< The number of heap allocations of the update handler since the providers changed. */
+    mutable size_t heapBytes = 0; /**< The number of bytes the update handler allocated from the heap since the providers changed. */
+    mutable double benchmarkDuration = 0.; /**< The total duration of the update handler since the benchmark was reset in µs. */
+    mutable size_t benchmarkHeapAllocations = 0; /**< The number of heap allocations of the update handler since the benchmark was reset. */
+    mutable unsigned benchmarkExecutions = 0; /**< How often was the update handler executed since the benchmark was reset? */
+    mutable std::vector<float> benchmarkDurations; /**< The durations of the last maxBenchmarkSamples executions in µs. */
+    mutable float benchmarkWorstDuration = 0.f; /**< The longest duration of the update handler since the benchmark was reset in µs. */
+    mutable unsigned benchmarkWorstFrame = 0; /**< The frame since the benchmark was reset, in which the longest duration was measured. */
+    mutable bool heapAllocationsReported = false; /**< Was it already reported that the update handler allocates memory after the warm-up? */
+    std::vector<const unsigned*> requirementChanges; /**< The modification counters of the representations required by a cached module. */
+    mutable std::vector<unsigned> lastRequirementChanges; /**< The values of these counters when the update handler was executed the last time. */
+    mutable bool updatedSinceConfiguration = false; /**< Was the update handler executed since the configuration changed? */
+    mutable unsigned unchanged = 0; /**< How often was the update handler skipped, because nothing it requires changed? */
 
     /**
      * Constructor.
@@ -83,6 +108,25 @@ private:
     {
     }
 
+    /**
+     * Checks whether the update handler of a cached module can be skipped, because
+     * none of the representations required changed since it was executed the last time.
+     * Otherwise, the current state of the requirements is remembered for the next check.
+     * @return Can the update be skipped?
+     */
+    bool requirementsUnchanged() const
+    {
+      bool unchanged = updatedSinceConfiguration;
+      for (size_t i = 0; i < requirementChanges.size(); ++i)
+        if (*requirementChanges[i] != lastRequirementChanges[i])
+        {
+          lastRequirementChanges[i] = *requirementChanges[i];
+          unchanged = false;
+        }
+      updatedSinceConfiguration = true;
+      return unchanged;
+    }
+
     operator std::string() const { return representation; }
 
     bool operator==(const char* name) const { return representation == name; }
@@ -128,7 +172,9 @@ public:
       return result;
     },
 
-    (std::vector<RepresentationProvider>) representationProviders
+    (std::vector<RepresentationProvider>) representationProviders,
+    (std::vector<std::string>) optionalModules, /**< Modules whose updates are skipped if they would exceed the frame deadline. */
+    (std::vector<std::string>) cachedModules /**< Modules whose updates are skipped if none of the representations they require changed. */
   );
 
 private:
@@ -140,11 +186,57 @@ private:
   std::unordered_set<const char*> received; /**< The list of all names of representations received from the other process */
   std::vector<Streamable*> toSend; /**< The list of all representations sent to the other process */
   std::vector<Streamable*> toReceive; /**< The list of all representations received from the other process */
+  std::vector<unsigned*> toReceiveChanges; /**< The modification counters of the representations received from the other process. */
   unsigned timeStamp = 0; /**< The timestamp of the last module request. Communication is only possible if both sides use the same timestamp. */
   unsigned nextTimeStamp = 0; /**< The next timestamp used to verify communication. */
 
+  /** Identifies a task: an update method of a module or its pre-execution (if the representation is nullptr). */
+  using TaskKey = std::pair<ModuleState*, const char*>;
+
+  /**
+   * An abstract description of a task graph. It is compared to the graph
+   * currently compiled into the taskflow to only patch the parts that changed.
+   */
+  struct TaskGraph
+  {
+    std::vector<TaskKey> tasks; /**< All tasks in the order they should be emplaced. */
+    std::set<std::pair<TaskKey, TaskKey>> dependencies; /**< All dependencies as pairs of predecessor and successor. */
+  };
+
+  /**
+   * A task graph that was computed in advance for a fixed configuration. It is
+   * written with the debug response "module:saveSchedule" and loaded at startup,
+   * so on the robot, the providers need not be ordered and checked for cycles.
+   */
+  STREAMABLE(Schedule,,
+    (unsigned)(0) fingerprint, /**< Identifies the providers and the requirements of their modules the schedule was made for. */
+    (std::vector<std::string>) tasks, /**< The names of all tasks in the order they are emplaced. */
+    (std::vector<unsigned>) dependencies /**< Pairs of the indices of a predecessor and a successor in the tasks. */
+  );
+
+  class Tasks; /**< Type of the map from task keys to the tasks of the taskflow. */
+
   SuperThread* superthread;
   std::unique_ptr<tf::Taskflow> taskflow;
+  std::unique_ptr<Tasks> tasks; /**< The tasks in the taskflow. */
+  TaskGraph taskGraph; /**< The description of the graph currently compiled into the taskflow. */
+  std::optional<Schedule> schedule; /**< The schedule loaded for the initial configuration if one exists. */
+  unsigned framesSinceScheduling = 0; /**< The number of frames executed since the task graph was ordered by the critical path the last time. */
+  unsigned framesSinceConfiguration = 0; /**< The number of frames executed since the providers changed. */
+  unsigned benchmarkFrames = 0; /**< The number of frames executed since the benchmark was reset. */
+  std::vector<float> benchmarkFrameDurations; /**< The durations of executing all modules in the last maxBenchmarkSamples frames in µs. */
+  static constexpr unsigned maxBenchmarkSamples = 10000; /**< The number of durations kept for determining percentiles. */
+  std::chrono::steady_clock::time_point deadline; /**< Optional modules are not updated anymore if they would end after this point in time. */
+  bool deadlineActive = false; /**< Is there a deadline in the current frame? */
+  const Provider* slowestProvider = nullptr; /**< The provider whose update handler took longest in the last frame. */
+  float slowestDuration = 0.f; /**< The duration of that update handler in µs. */
+
+  /** The longest paths through the dependency graph of the providers, weighted by their measured durations. */
+  struct CriticalPaths
+  {
+    std::unordered_map<const Provider*, float> lengths; /**< The length of the longest path starting at each provider in µs. */
+    std::unordered_map<const Provider*, std::vector<const Provider*>> successors; /**< The providers that directly depend on each provider. */
+  };
 
   struct NextConfig
   {
@@ -214,6 +306,14 @@ public:
 
   static ModuleManager::Configuration sendModuleRequest(const ModuleManager::Configuration& configRequest);
 
+  /**
+   * Returns the update handler that took longest in the last frame of the calling thread.
+   * @param module The name of the module is returned here, nullptr if nothing was executed.
+   * @param representation The name of the representation updated is returned here.
+   * @return The duration of the update handler in µs.
+   */
+  static float getSlowestUpdate(const char*& module, const char*& representation);
+
 private:
   /**
    * Adds all representations that need to be shared between processes to the
@@ -237,9 +337,91 @@ private:
   static bool calcShared(
       const Configuration& config, std::string_view representation, const ModuleState& module, const std::list<ModuleState>& modules, std::unordered_set<const char*>& received, bool silent);
 
-  static std::list<std::string> findCyclicDependencies(const tf::Taskflow& tf);
+  static std::list<std::string> findCyclicDependencies(const TaskGraph& taskGraph);
+
+  /**
+   * Find the provider that belongs to a task.
+   * @param providers The providers searched.
+   * @param key The key of the update task.
+   * @return The provider or the end of the list if it does not exist.
+   */
+  static std::list<Provider>::iterator findProvider(std::list<Provider>& providers, const TaskKey& key);
+
+  /**
+   * Generate the description of the task graph for a list of providers.
+   * @param providers The providers that are executed.
+   * @return The tasks and their dependencies.
+   */
+  static TaskGraph generateTaskGraph(const std::list<Provider>& providers);
+
+  /**
+   * Computes a fingerprint of everything that determines the task graph except
+   * for the measured durations, i.e. the providers and the properties and
+   * requirements of their modules.
+   * @param providers The providers that are executed.
+   * @return The fingerprint.
+   */
+  static unsigned getFingerprint(const std::list<Provider>& providers);
+
+  /**
+   * Returns the name of a task as used in schedules.
+   * @param key The key of the task.
+   * @return The name.
+   */
+  static std::string getTaskName(const TaskKey& key);
+
+  /**
+   * Returns the task graph of the schedule loaded if it was made for the given providers.
+   * @param providers The providers that are executed.
+   * @return The task graph or nothing if the schedule does not fit.
+   */
+  std::optional<TaskGraph> getScheduledTaskGraph(const std::list<Provider>& providers) const;
+
+  /** Writes the current task graph as schedule for the current thread. */
+  void saveSchedule() const;
+
+  /**
+   * Change the taskflow so that it matches a new task graph. Only tasks that are
+   * new or lost dependencies are (re-)created. All other tasks are kept.
+   * @param taskGraph The new task graph.
+   * @param providers The providers the update tasks will refer to.
+   */
+  void patchTaskflow(TaskGraph taskGraph, std::list<Provider>& providers);
+
+  /**
+   * Determine the critical paths through the dependency graph based on the
+   * durations measured for all providers.
+   * @param providers The providers that are executed.
+   * @return The lengths of the longest paths starting at each provider.
+   */
+  static CriticalPaths calcCriticalPaths(const std::list<Provider>& providers);
+
+  /**
+   * Regenerates the task graph for the current providers, so that it is ordered
+   * by the critical paths measured in the meantime. The modules are not touched.
+   */
+  void reschedule();
 
-  static std::unique_ptr<tf::Taskflow> generateTaskflow(const std::list<Provider>& providers);
+  /** Restarts measuring the durations and heap allocations reported by reportBenchmark(). */
+  void resetBenchmark();
+
+  /**
+   * Adds a duration to the samples of a benchmark, replacing the oldest one if there are enough.
+   * @param durations The samples.
+   * @param count The number of samples added since the benchmark was reset, including this one.
+   * @param duration The duration in µs.
+   */
+  static void addBenchmarkSample(std::vector<float>& durations, unsigned count, float duration);
+
+  /**
+   * Outputs the average duration, the median and the 99th percentile of the durations, and
+   * the heap allocations per frame of all update handlers since the last reset, slowest first.
+   * The first lines contain the durations of executing all modules per frame and the frames
+   * that took longest. Frames are counted from the reset, so when replaying a log from its
+   * start, they can be looked up with "log goto". Replaying a log with "st on" executes the perception
+   * modules on a fixed sequence of images, which makes the numbers comparable between builds.
+   */
+  void reportBenchmark() const;
 
   static ModuleManager::Configuration mergeConfig(ModuleManager::Configuration& config, const ModuleManager::Configuration& newConfig);
   static ModuleManager::Configuration mergeConfig(ModuleManager::Configuration& config, In& stream);
@@ -0,0 +1,88 @@
+/**
+ * @file JointBlending.h
+ * Kernels that combine and smooth the angles of all joints at once. The values
+ * are stored as contiguous arrays of floats with one entry per joint, so the
+ * loops have a fixed length and no branches and can be vectorized by the
+ * compiler. Special values such as JointAngles::ignore and JointAngles::off must
+ * be resolved before.
+ */
+
+#pragma once
+
+#include "Tools/Joints.h"
+#include "Tools/Math/Angle.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace JointBlending
+{
+  using Values = std::array<float, Joints::numOfJoints>;
+
+  /**
+   * Moves the target values towards the difference of two motions, i.e.
+   * target += ratio * (from - to). Joints for which from and to are equal are
+   * not changed, whatever their value is.
+   * @param target The values that are changed.
+   * @param from The values of the motion that is left.
+   * @param to The values of the motion that is entered.
+   * @param ratio The ratio of the motion that is left.
+   */
+  inline void addWeightedDifference(Values& target, const Values& from, const Values& to, float ratio)
+  {
+    for (size_t i = 0; i < target.size(); ++i)
+      target[i] += ratio * (from[i] - to[i]);
+  }
+
+  /**
+   * A moving average over the angles of all joints. In contrast to one filter per
+   * joint, the history is a single ring of arrays.
+   */
+  class MovingAverage
+  {
+  public:
+    /**
+     * Empties the filter.
+     * @param order The number of frames that are averaged.
+     */
+    void reset(size_t order)
+    {
+      history.assign(std::max<size_t>(order, 1), Values());
+      sum.fill(0.f);
+      next = 0;
+      count = 0;
+    }
+
+    /**
+     * Adds the angles of the current frame.
+     * @param angles The angles of all joints.
+     * @param averages The average angles of the last frames, which may be the same array.
+     */
+    void filter(const std::array<Angle, Joints::numOfJoints>& angles, std::array<Angle, Joints::numOfJoints>& averages)
+    {
+      Values& oldest = history[next];
+      if (count == history.size())
+        for (size_t i = 0; i < sum.size(); ++i)
+          sum[i] -= oldest[i];
+      else
+        ++count;
+
+      for (size_t i = 0; i < sum.size(); ++i)
+      {
+        oldest[i] = angles[i];
+        sum[i] += oldest[i];
+      }
+      next = (next + 1) % history.size();
+
+      const float n = static_cast<float>(count);
+      for (size_t i = 0; i < sum.size(); ++i)
+        averages[i] = sum[i] / n;
+    }
+
+  private:
+    std::vector<Values> history = std::vector<Values>(1); /**< The angles of the last frames. */
+    Values sum{}; /**< The sums of the angles in the history. */
+    size_t next = 0; /**< The index of the entry that is written next. */
+    size_t count = 0; /**< The number of valid entries. */
+  };
+}
@@ -9,8 +9,43 @@
 #include "Tools/Math/Constants.h"
 
 #include <iostream>
+#include <vector>
 
 using namespace std;
+
+namespace
+{
+  /** The gains computed for a set of parameters of init. */
+  struct CachedGains
+  {
+    double dt;
+    double comHeight;
+    unsigned numPreviews;
+    double R;
+    double Qx;
+    double Qe;
+    Vector3d QlDiag;
+    Vector2d R0Diag;
+
+    RowVectorXd Gd;
+    RowVector3d Gx;
+    double Gi;
+    Matrix3x2d L;
+
+    bool isFor(const double dt, const double comHeight, const unsigned numPreviews, const double R, const double Qx, const double Qe, const Vector3d& QlDiag, const Vector2d& R0Diag) const
+    {
+      return this->dt == dt && this->comHeight == comHeight && this->numPreviews == numPreviews && this->R == R && this->Qx == Qx && this->Qe == Qe && this->QlDiag == QlDiag
+          && this->R0Diag == R0Diag;
+    }
+  };
+
+  /**
+   * The gains of the last parameter sets, because solving the Riccati equations takes too long to be done in a
+   * motion frame whenever the walk is restarted. Each thread has its own, so no locking is required.
+   */
+  thread_local std::vector<CachedGains> cachedGains;
+  constexpr size_t maxNumOfCachedGains = 16;
+} // namespace
 ZmpPreviewController3::ZmpPreviewController3() : initialized(false) {}
 
 Matrix4d ZmpPreviewController3::dare(const Matrix4d& A, const Vector4d& B, const Matrix4d& Q, double R) const
@@ -78,6 +113,20 @@ void ZmpPreviewController3::init(const double dt, const double comHeight, const
 
   b << 0, 0, dt;
 
+  initialized = true;
+  integrationError = 0.0;
+  state = Vector3d::Zero();
+
+  for (const CachedGains& gains : cachedGains)
+    if (gains.isFor(dt, comHeight, numPreviews, R, Qx, Qe, QlDiag, R0Diag))
+    {
+      Gd = gains.Gd;
+      Gx = gains.Gx;
+      Gi = gains.Gi;
+      L = gains.L;
+      return;
+    }
+
   Vector4d Bt;
   Bt << c0 * b0, b0;
   Vector4d It;
@@ -123,9 +172,9 @@ void ZmpPreviewController3::init(const double dt, const double comHeight, const
   const Matrix2x3d PG = (R0 + Cm * Po * Cmt).inverse() * (Cm * Po * A0t);
   L = PG.transpose();
 
-  initialized = true;
-  integrationError = 0.0;
-  state = Vector3d::Zero();
+  if (cachedGains.size() == maxNumOfCachedGains)
+    cachedGains.erase(cachedGains.begin());
+  cachedGains.push_back({dt, comHeight, numPreviews, R, Qx, Qe, QlDiag, R0Diag, Gd, Gx, Gi, L});
 }
 
 void ZmpPreviewController3::reset(const double com, const double comVel, const double zmp)
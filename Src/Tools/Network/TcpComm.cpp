@@ -11,6 +11,7 @@
 
 #include <cerrno>
 #include <fcntl.h>
+#include <vector>
 
 #ifdef WINDOWS
 #define ERRNO WSAGetLastError()
@@ -37,6 +38,7 @@ struct _WSAFramework
 
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
@@ -261,3 +263,69 @@ bool TcpComm::send(const unsigned char* buffer, int size)
     return false;
   }
 }
+
+bool TcpComm::send(const unsigned char* const* buffers, const int* sizes, int numOfBuffers)
+{
+#ifdef WINDOWS
+  for (int i = 0; i < numOfBuffers; ++i)
+    if (!send(buffers[i], sizes[i]))
+      return false;
+  return true;
+#else
+  if (!checkConnection())
+    return false;
+
+  std::vector<iovec> vectors(numOfBuffers);
+  size_t size = 0;
+  for (int i = 0; i < numOfBuffers; ++i)
+  {
+    vectors[i].iov_base = const_cast<unsigned char*>(buffers[i]);
+    vectors[i].iov_len = static_cast<size_t>(sizes[i]);
+    size += vectors[i].iov_len;
+  }
+  if (!size)
+    return true;
+
+  msghdr message = {};
+  message.msg_iov = vectors.data();
+  message.msg_iovlen = vectors.size();
+  size_t sent = 0;
+  for (;;)
+  {
+    RESET_ERRNO;
+    const ssize_t sent2 = ::sendmsg(transferSocket, &message, MSG_NOSIGNAL);
+    if (sent2 > 0)
+    {
+      sent += static_cast<size_t>(sent2);
+      overallBytesSent += static_cast<int>(sent2);
+      if (sent == size)
+        return true;
+
+      // Skip the blocks sent completely and the part of the block sent partially.
+      size_t skip = static_cast<size_t>(sent2);
+      while (skip >= message.msg_iov->iov_len)
+      {
+        skip -= message.msg_iov->iov_len;
+        ++message.msg_iov;
+        --message.msg_iovlen;
+      }
+      message.msg_iov->iov_base = static_cast<char*>(message.msg_iov->iov_base) + skip;
+      message.msg_iov->iov_len -= skip;
+    }
+    else if (!sent || (ERRNO != EWOULDBLOCK && ERRNO != EINPROGRESS))
+      break;
+
+    timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 100000;
+    fd_set wset;
+    FD_ZERO(&wset);
+    FD_SET(transferSocket, &wset);
+    if (select(static_cast<int>(transferSocket + 1), 0, &wset, 0, &timeout) == -1)
+      break;
+  }
+
+  closeTransferSocket();
+  return false;
+#endif
+}
@@ -80,6 +80,16 @@ public:
    */
   bool send(const unsigned char* buffer, int size);
 
+  /**
+   * The function sends several blocks of bytes as one, without copying them
+   * into a single buffer first.
+   * @param buffers The addresses of the blocks.
+   * @param sizes The numbers of bytes of the blocks.
+   * @param numOfBuffers The number of blocks.
+   * @return Was the data successfully sent?
+   */
+  bool send(const unsigned char* const* buffers, const int* sizes, int numOfBuffers);
+
   /**
    * The function receives a block of bytes.
    * @param buffer This buffer will be filled with the bytes to receive.
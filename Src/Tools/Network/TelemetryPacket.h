@@ -0,0 +1,60 @@
+/**
+ * @file TelemetryPacket.h
+ * Declaration of the datagram robots send to monitoring PCs. All values have
+ * fixed sizes and are stored in little endian byte order, so receivers do not
+ * need the streaming framework of the robot code to decode them.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#pragma pack(push, 1)
+struct TelemetryPacket
+{
+  static constexpr char header[4] = {'N', 'D', 'T', 'M'};
+  static constexpr uint8_t currentVersion = 1;
+
+  char magic[4] = {header[0], header[1], header[2], header[3]};
+  uint8_t version = currentVersion;
+  uint8_t teamNumber = 0;
+  uint8_t playerNumber = 0;
+  uint8_t penalty = 0; /**< The penalty of the robot as sent by the GameController. */
+  uint16_t sequence = 0; /**< Is incremented with every packet, so receivers can count lost packets. */
+  uint32_t timestamp = 0; /**< The time the packet was sent in ms since the robot code started. */
+  char robotName[16] = {0}; /**< Not null-terminated if it has 16 characters. */
+
+  // Timing
+  uint16_t cognitionFrameRate = 0; /**< In 0.1 Hz. */
+  uint16_t motionFrameRate = 0; /**< In 0.1 Hz. */
+  uint16_t motionCycleTime = 0; /**< The cycle time of the last motion frame in µs (saturated). */
+  uint16_t maxMotionCycleTime = 0; /**< The longest motion cycle time so far in µs (saturated). */
+  uint32_t motionOverruns = 0; /**< The number of motion frames that exceeded the budget. */
+  uint32_t missedMotionFrames = 0; /**< The number of LoLA frames no joint request was sent for. */
+
+  // Health
+  uint8_t batteryLevel = 0; /**< In %. */
+  uint8_t maxJointTemperature = 0; /**< In °C. */
+  uint8_t cpuTemperature = 0; /**< In °C. */
+  uint8_t memoryUsage = 0; /**< In %. */
+  uint8_t load[3] = {0}; /**< The load averages in 0.1. */
+  uint8_t gameState = 0; /**< The game state as sent by the GameController. */
+  uint16_t totalCurrent = 0; /**< The sum of all joint currents in mA (saturated). */
+
+  // Localization quality
+  int16_t x = 0; /**< The x coordinate of the robot pose in mm. */
+  int16_t y = 0; /**< The y coordinate of the robot pose in mm. */
+  int16_t rotation = 0; /**< The rotation of the robot pose in 0.001 rad. */
+  uint8_t validity = 0; /**< The validity of the robot pose in 1/255. */
+  uint8_t sideConfidence = 0; /**< The SideConfidence::ConfidenceState. */
+
+  /** @return Is this a packet of the current version? */
+  bool isValid() const
+  {
+    return std::memcmp(magic, header, sizeof(magic)) == 0 && version == currentVersion;
+  }
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TelemetryPacket) == 64, "The layout of the telemetry packet must not depend on the compiler.");
@@ -6,6 +6,7 @@
 
 #include "UdpComm.h"
 
+#include <algorithm>
 #include <iostream>
 #ifdef WINDOWS
 #include <ws2tcpip.h>
@@ -14,6 +15,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/ioctl.h>
 #include <arpa/inet.h>
 #include <cstring>
@@ -246,6 +248,19 @@ bool UdpComm::setRcvBufSize(unsigned int rcvbuf)
   return false;
 }
 
+bool UdpComm::setTimestamps(bool enable)
+{
+#ifdef LINUX
+  int yes = enable ? 1 : 0;
+  if (0 == setsockopt(sock, SOL_SOCKET, SO_TIMESTAMP, (const char*)&yes, sizeof(yes)))
+    return true;
+  std::cerr << "UdpComm::setTimestamps() failed: " << strerror(errno) << std::endl;
+  return false;
+#else
+  return !enable;
+#endif
+}
+
 bool UdpComm::bind(const char* addr_str, int port)
 {
   static const int yes = 1;
@@ -306,6 +321,67 @@ int UdpComm::read(char* data, int len, sockaddr_in& from)
   return static_cast<int>(::recvfrom(sock, data, len, 0, (sockaddr*)&from, &fromLen));
 }
 
+int UdpComm::readBatch(Datagram* datagrams, int count)
+{
+  int received = 0;
+#ifdef LINUX
+  while (received < count)
+  {
+    const int batchSize = std::min(count - received, maxBatchSize);
+    mmsghdr headers[maxBatchSize];
+    iovec vectors[maxBatchSize];
+    sockaddr_in senders[maxBatchSize];
+    char controls[maxBatchSize][CMSG_SPACE(sizeof(timeval))];
+    for (int i = 0; i < batchSize; ++i)
+    {
+      Datagram& datagram = datagrams[received + i];
+      vectors[i].iov_base = datagram.data;
+      vectors[i].iov_len = datagram.len;
+      msghdr& header = headers[i].msg_hdr;
+      header.msg_name = &senders[i];
+      header.msg_namelen = sizeof(senders[i]);
+      header.msg_iov = &vectors[i];
+      header.msg_iovlen = 1;
+      header.msg_control = controls[i];
+      header.msg_controllen = sizeof(controls[i]);
+      header.msg_flags = 0;
+    }
+
+    const int result = recvmmsg(sock, headers, batchSize, MSG_DONTWAIT, nullptr);
+    if (result <= 0)
+      break;
+
+    for (int i = 0; i < result; ++i)
+    {
+      Datagram& datagram = datagrams[received + i];
+      datagram.size = static_cast<int>(headers[i].msg_len);
+      datagram.ip = ntohl(senders[i].sin_addr.s_addr);
+      datagram.timestamp = 0;
+      for (cmsghdr* control = CMSG_FIRSTHDR(&headers[i].msg_hdr); control; control = CMSG_NXTHDR(&headers[i].msg_hdr, control))
+        if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMP)
+        {
+          timeval time;
+          memcpy(&time, CMSG_DATA(control), sizeof(time));
+          datagram.timestamp = static_cast<unsigned long long>(time.tv_sec) * 1000 + time.tv_usec / 1000;
+        }
+    }
+    received += result;
+    if (result < batchSize)
+      break; // socket is empty
+  }
+#else
+  for (; received < count; ++received)
+  {
+    Datagram& datagram = datagrams[received];
+    datagram.size = read(datagram.data, datagram.len, datagram.ip);
+    datagram.timestamp = 0;
+    if (datagram.size <= 0)
+      break;
+  }
+#endif
+  return received;
+}
+
 int UdpComm::readLocal(char* data, int len)
 {
   sockaddr_in senderAddr;
@@ -26,7 +26,20 @@ struct sockaddr_in;
  */
 class UdpComm
 {
+public:
+  /** A package received by readBatch. */
+  struct Datagram
+  {
+    char* data = nullptr; /**< The buffer the package is written to. */
+    int len = 0; /**< The size of the buffer. */
+    int size = 0; /**< The number of bytes received. */
+    unsigned int ip = 0; /**< The address of the sender. */
+    unsigned long long timestamp = 0; /**< When the kernel received the package in ms since the epoch or 0 if unknown. */
+  };
+
 private:
+  static constexpr int maxBatchSize = 32; /**< The maximum number of packages read by a single system call. */
+
   sockaddr* target = nullptr;
   socket_t sock = static_cast<socket_t>(-1);
 
@@ -72,6 +85,12 @@ public:
 
   bool setRcvBufSize(unsigned int);
 
+  /**
+   * Let the kernel record when each package was received (only supported on Linux).
+   * readBatch reports these timestamps.
+   */
+  bool setTimestamps(bool);
+
   /**
    * bind to IN_ADDR_ANY to receive packets
    */
@@ -95,6 +114,15 @@ public:
    */
   int read(char* data, int len, sockaddr_in& from);
 
+  /**
+   * The function tries to read several packages from a socket without blocking.
+   * On Linux, up to maxBatchSize packages are read by a single system call.
+   * @param datagrams The buffers for the packages. Their sizes, senders, and timestamps are set.
+   * @param count The number of buffers.
+   * @return The number of packages received.
+   */
+  int readBatch(Datagram* datagrams, int count);
+
   /**
    * The function tries to read a package from a socket.
    * It only accepts a package from this host.
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <future>
 #include <vector>
 #include "Tools/Debugging/Debugging.h"
 #ifdef __clang__
@@ -47,30 +48,31 @@ public:
    * This method executes one iteration of the Gauss-Newton algorithm.
    * The new parameter vector is computed by a_i+1 = a_i - (D^T * D)^-1 * D^T * r
    * where D is the Jacobian, a is the parameter vector and r is the vector containing the current error values.
+   * @param parallel Compute each column of the Jacobian in a thread of its own? The error
+   *                 function is then called concurrently and must be thread-safe.
    * @return The sum of absolute differences between the old and the new parameter vector.
    */
-  float iterate()
+  float iterate(bool parallel = false)
   {
     // build jacobi matrix
     Matrix jacobiMatrix(numOfMeasurements, currentParameters.size());
-    for (unsigned int j = 0; j < currentParameters.size(); ++j)
+    if (parallel)
     {
-      // the first derivative is approximated using values slightly above and below the current value
-      const float oldParameter = currentParameters[j];
-      const float parameterAbove = oldParameter + delta;
-      const float parameterBelow = oldParameter - delta;
-      for (unsigned int i = 0; i < numOfMeasurements; ++i)
-      {
-        // approximate first derivation numerically
-        currentParameters[j] = parameterAbove;
-        const float valueAbove = (object.*pFunction)(measurements[i], currentParameters);
-        currentParameters[j] = parameterBelow;
-        const float valueBelow = (object.*pFunction)(measurements[i], currentParameters);
-        const float derivation = (valueAbove - valueBelow) / (2.0f * delta);
-        jacobiMatrix(i, j) = derivation;
-      }
-      currentParameters[j] = oldParameter;
+      std::vector<std::future<void>> columns;
+      columns.reserve(currentParameters.size());
+      for (unsigned int j = 0; j < currentParameters.size(); ++j)
+        columns.emplace_back(std::async(std::launch::async,
+            [this, &jacobiMatrix, j]
+            {
+              std::vector<float> parameters = currentParameters;
+              computeDerivatives(j, parameters, jacobiMatrix);
+            }));
+      for (std::future<void>& column : columns)
+        column.get();
     }
+    else
+      for (unsigned int j = 0; j < currentParameters.size(); ++j)
+        computeDerivatives(j, currentParameters, jacobiMatrix);
 
     try
     {
@@ -99,4 +101,31 @@ public:
    * @return The current parameter vector.
    */
   const std::vector<float>& getParameters() const { return currentParameters; }
+
+private:
+  /**
+   * Approximates the partial derivatives of the error function for one parameter numerically.
+   * @param j The index of the parameter, which is the column of the Jacobian computed.
+   * @param parameters The parameters the derivatives are computed at. They are modified
+   *                   temporarily, but restored before this method returns.
+   * @param jacobiMatrix The Jacobian that receives the column.
+   */
+  void computeDerivatives(unsigned int j, std::vector<float>& parameters, Matrix& jacobiMatrix) const
+  {
+    // the first derivative is approximated using values slightly above and below the current value
+    const float oldParameter = parameters[j];
+    const float parameterAbove = oldParameter + delta;
+    const float parameterBelow = oldParameter - delta;
+    for (unsigned int i = 0; i < numOfMeasurements; ++i)
+    {
+      // approximate first derivation numerically
+      parameters[j] = parameterAbove;
+      const float valueAbove = (object.*pFunction)(measurements[i], parameters);
+      parameters[j] = parameterBelow;
+      const float valueBelow = (object.*pFunction)(measurements[i], parameters);
+      const float derivation = (valueAbove - valueBelow) / (2.0f * delta);
+      jacobiMatrix(i, j) = derivation;
+    }
+    parameters[j] = oldParameter;
+  }
 };
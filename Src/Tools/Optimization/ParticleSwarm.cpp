@@ -4,6 +4,7 @@
  * @author Colin Graf
  */
 
+#include <future>
 #include <limits>
 
 #include "ParticleSwarm.h"
@@ -76,6 +77,49 @@ void ParticleSwarm::setRating(float rating)
     bestParticleIndex = currentParticleIndex;
 }
 
+const std::vector<std::vector<float>>& ParticleSwarm::nextGeneration()
+{
+  generation.resize(particles.size());
+  for (size_t i = 0; i < particles.size(); ++i)
+  {
+    updateParticle(particles[i]);
+    generation[i] = particles[i].position;
+  }
+  return generation;
+}
+
+void ParticleSwarm::setRatings(std::span<const float> ratings)
+{
+  ASSERT(ratings.size() == particles.size());
+  for (size_t i = 0; i < particles.size(); ++i)
+  {
+    currentParticleIndex = i;
+    setRating(ratings[i]);
+  }
+  const Particle& bestParticle = particles[bestParticleIndex];
+  for (size_t i = 0, count = dimensions.size(); i < count; ++i)
+    *dimensions[i].variable = bestParticle.bestPosition[i];
+}
+
+void ParticleSwarm::rateGeneration(const std::function<float(const std::vector<float>&)>& rate, bool parallel)
+{
+  const std::vector<std::vector<float>>& positions = nextGeneration();
+  std::vector<float> ratings(positions.size());
+  if (parallel)
+  {
+    std::vector<std::future<float>> futures;
+    futures.reserve(positions.size());
+    for (const std::vector<float>& position : positions)
+      futures.emplace_back(std::async(std::launch::async, [&rate, &position] { return rate(position); }));
+    for (size_t i = 0; i < futures.size(); ++i)
+      ratings[i] = futures[i].get();
+  }
+  else
+    for (size_t i = 0; i < positions.size(); ++i)
+      ratings[i] = rate(positions[i]);
+  setRatings(ratings);
+}
+
 float ParticleSwarm::getBestRating() const
 {
   return particles[bestParticleIndex].bestFitness;
@@ -7,6 +7,8 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
+#include <span>
 #include <vector>
 
 /**
@@ -64,6 +66,28 @@ public:
    */
   void next();
 
+  /**
+   * Moves all rated particles and returns the parameter sets of the whole swarm, so that
+   * they can be rated together. This must not be mixed with \c next and \c setRating.
+   * @return The parameter set of each particle, ordered like the dimensions.
+   */
+  const std::vector<std::vector<float>>& nextGeneration();
+
+  /**
+   * States the evaluations of the parameter sets returned by the last call of \c nextGeneration.
+   * The variables of the dimensions receive the best parameter set found so far.
+   * @param ratings The evaluation of each parameter set
+   */
+  void setRatings(std::span<const float> ratings);
+
+  /**
+   * Creates and rates the next generation of the swarm.
+   * @param rate The function that rates a parameter set. If \c parallel is set, it is called
+   *             concurrently from several threads and must be thread-safe.
+   * @param parallel Rate each particle in a thread of its own?
+   */
+  void rateGeneration(const std::function<float(const std::vector<float>&)>& rate, bool parallel = true);
+
 private:
   class Particle
   {
@@ -102,6 +126,7 @@ private:
   std::vector<Particle> particles;
   size_t bestParticleIndex;
   size_t currentParticleIndex;
+  std::vector<std::vector<float>> generation; /**< The parameter sets returned by nextGeneration. */
 
   void updateParticle(Particle& particle);
 };
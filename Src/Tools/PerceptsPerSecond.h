@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <utility>
 #include <vector>
 
 /**
@@ -27,6 +30,7 @@ private:
   /// Second element: validity of the percept (in range [0,1])
   struct pps_entry : std::pair<unsigned, float>
   {
+    pps_entry() = default;
     pps_entry(unsigned timestamp, float validity)
     {
       first = timestamp;
@@ -38,14 +42,26 @@ private:
   typedef std::vector<pps_entry> pps_deque;
   /**
    * Saves an timestamp of each percept. The newest percept (largest timestamp)
-   * is stored at the front of the double ended queue, the oldest ones at the
-   * back. The deque is always orderd. Timestamps older than \c duration
+   * has the index 0, the oldest one the index <tt>size - 1</tt> (see method
+   * \c at). The buffer is always orderd. Timestamps older than \c duration
    * milliseconds are removed.
+   * The capacity is a power of two and only grows if more percepts are
+   * tracked than ever before, so adding and removing percepts does not
+   * allocate memory in the long run.
    */
   pps_deque ringBuffer;
 
+  /// The position of the newest percept in \c ringBuffer.
+  std::size_t first = 0;
+
+  /// The number of percepts stored in \c ringBuffer.
+  std::size_t size = 0;
+
   unsigned duration;
 
+  /// The initial capacity of \c ringBuffer.
+  static constexpr std::size_t initialCapacity = 16;
+
 public:
   /**
    * \brief Constructor.
@@ -70,14 +86,9 @@ public:
    */
   void addPercepts(const PerceptsPerSecond& source)
   {
-    //typename pps_deque::iterator it = ringBuffer.begin();
-    for (auto it_s = source.ringBuffer.cbegin(); it_s != source.ringBuffer.cend(); ++it_s)
-    {
-      // TODO: Verify: This could be very slow.
-      addPercept(*it_s);
-    }
-
-    //cleanUp(ringBuffer.front());
+    // Add the oldest percepts first, so that each one is inserted near the front.
+    for (std::size_t i = source.size; i-- > 0;)
+      addPercept(source.at(i));
   }
 
   /**
@@ -86,7 +97,7 @@ public:
    * percept.
    * \return Percepts per seconds.
    */
-  float pps() const { return static_cast<float>(ringBuffer.size()) * 1000.f / duration; }
+  float pps() const { return static_cast<float>(size) * 1000.f / duration; }
 
   /**
    * Return the <tt>percepts per second</tt> value tracked over the last
@@ -109,15 +120,15 @@ public:
   float meanPerceptValidity() const
   {
     // Prevent division by 0.
-    if (ringBuffer.size() == 0)
+    if (size == 0)
       return 0.f;
 
     float validitySum = 0.f;
-    for (typename pps_deque::const_iterator it = ringBuffer.begin(); it != ringBuffer.end(); ++it)
+    for (std::size_t i = 0; i < size; ++i)
     {
-      validitySum += it->validity();
+      validitySum += at(i).validity();
     }
-    return validitySum / static_cast<float>(ringBuffer.size());
+    return validitySum / static_cast<float>(size);
   }
 
   /**
@@ -141,21 +152,45 @@ public:
   void updateCurrentTime(unsigned currentTimestamp) { cleanUp(currentTimestamp); }
 
 private:
+  /**
+   * Access a percept entry.
+   * \param [in] index The index of the entry, 0 is the newest one.
+   * \return The entry.
+   */
+  pps_entry& at(std::size_t index) { return ringBuffer[(first + index) & (ringBuffer.size() - 1)]; }
+  const pps_entry& at(std::size_t index) const { return ringBuffer[(first + index) & (ringBuffer.size() - 1)]; }
+
   /**
    * Add a new percept entry.
    * \param [in] entry The \c pps_entry to add.
    */
   void addPercept(const pps_entry& entry)
   {
-    // Search for the first timestamp smaller than the new one. Start at the end
-    typename pps_deque::const_iterator it = ringBuffer.cbegin();
-    while (it != ringBuffer.cend() && it->timestamp() > entry.timestamp())
-      ++it;
-    ringBuffer.insert(it, entry);
-
-    auto first = ringBuffer.cbegin();
-    if (first != ringBuffer.cend())
-      cleanUp(first->timestamp());
+    if (size == ringBuffer.size())
+      grow();
+
+    // Add the entry at the front and move it back behind all newer timestamps.
+    // Percepts usually arrive in order, so it stays at the front.
+    first = (first + ringBuffer.size() - 1) & (ringBuffer.size() - 1);
+    ++size;
+    at(0) = entry;
+    for (std::size_t i = 0; i + 1 < size && at(i + 1).timestamp() > at(i).timestamp(); ++i)
+      std::swap(at(i), at(i + 1));
+
+    cleanUp(at(0).timestamp());
+  }
+
+  /**
+   * Double the capacity of the \c ringBuffer. The newest percept is moved to
+   * the beginning.
+   */
+  void grow()
+  {
+    pps_deque newBuffer(std::max(initialCapacity, ringBuffer.size() * 2));
+    for (std::size_t i = 0; i < size; ++i)
+      newBuffer[i] = at(i);
+    ringBuffer.swap(newBuffer);
+    first = 0;
   }
 
   /**
@@ -169,8 +204,8 @@ private:
     if (currentTimestamp <= duration)
       return;
 
-    while (ringBuffer.size() > 0 && ringBuffer.back().timestamp() <= currentTimestamp - duration)
+    while (size > 0 && at(size - 1).timestamp() <= currentTimestamp - duration)
       // Remove last element until it is not any more older than duration.
-      ringBuffer.pop_back();
+      --size;
   }
 };
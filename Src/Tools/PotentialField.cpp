@@ -35,80 +35,143 @@ void PotentialField::addRectangularPotential(const RPotential& potential)
 
 Vector2f PotentialField::getGradient(const Vector2f& point)
 {
-
   Vector2f gradient(0, 0);
+  for (Potential& potential : linearPotentials)
+    addGradient(potential, point, gradient);
+  for (QPotential& qPotential : quadraticPotentials)
+    addGradient(qPotential, point, gradient);
+  for (EPotential& ePot : ellipticalPotentials)
+    addGradient(ePot, point, gradient);
+  for (RPotential& rPot : rectangularPotentials)
+    addGradient(rPot, point, gradient);
+  return gradient;
+}
 
-  //linear Potentials
-
-  for (unsigned int i = 0; i < linearPotentials.size(); i++)
+void PotentialField::addGradient(Potential& potential, const Vector2f& point, Vector2f& gradient)
+{
+  float distance = potential.distance(point);
+  if (distance != 0)
   {
-    Potential potential = linearPotentials.at(i);
-    float distance = potential.distance(point);
-    if (distance != 0)
-    {
-      gradient.x() += -potential.influence * (point.x() - potential.position.x()) / distance;
-      gradient.y() += -potential.influence * (point.y() - potential.position.y()) / distance;
-    }
+    gradient.x() += -potential.influence * (point.x() - potential.position.x()) / distance;
+    gradient.y() += -potential.influence * (point.y() - potential.position.y()) / distance;
   }
+}
 
-
-  //quadratic potentials
-  for (unsigned int i = 0; i < quadraticPotentials.size(); i++)
+void PotentialField::addGradient(QPotential& qPotential, const Vector2f& point, Vector2f& gradient)
+{
+  float distance = qPotential.distance(point);
+  distance = std::max(distance, 1.f);
+  //point in influenceRadius of potential
+  if (distance < qPotential.influenceRadius)
   {
-    QPotential qPotential = quadraticPotentials.at(i);
-    float distance = qPotential.distance(point);
-    distance = std::max(distance, 1.f);
-    //point in influenceRadius of potential
-    if (distance < qPotential.influenceRadius)
-    {
-      //gradient.x+=qPotential.influence*(1/distance-1/qPotential.influenceRadius)*(1/pow(distance,3.0))*(point.x-qPotential.position.x);
-      //gradient.y+=qPotential.influence*(1/distance-1/qPotential.influenceRadius)*(1/pow(distance,3.0))*(point.y-qPotential.position.y);
-      gradient.x() += qPotential.influence * (qPotential.influenceRadius - distance) * (point.x() - qPotential.position.x()) / (distance);
-      gradient.y() += qPotential.influence * (qPotential.influenceRadius - distance) * (point.y() - qPotential.position.y()) / (distance);
-    }
+    //gradient.x+=qPotential.influence*(1/distance-1/qPotential.influenceRadius)*(1/pow(distance,3.0))*(point.x-qPotential.position.x);
+    //gradient.y+=qPotential.influence*(1/distance-1/qPotential.influenceRadius)*(1/pow(distance,3.0))*(point.y-qPotential.position.y);
+    gradient.x() += qPotential.influence * (qPotential.influenceRadius - distance) * (point.x() - qPotential.position.x()) / (distance);
+    gradient.y() += qPotential.influence * (qPotential.influenceRadius - distance) * (point.y() - qPotential.position.y()) / (distance);
   }
+}
 
-  //ellipticalPotentials
-
-  for (unsigned int i = 0; i < ellipticalPotentials.size(); i++)
-  {
-    EPotential ePot = ellipticalPotentials.at(i);
-    //distance to mass center
-    float distance = ePot.distance(point);
-    distance = std::max(distance, 1.f);
+void PotentialField::addGradient(EPotential& ePot, const Vector2f& point, Vector2f& gradient)
+{
+  //distance to mass center
+  float distance = ePot.distance(point);
+  distance = std::max(distance, 1.f);
 
-    //calculate of the intersection between ellipsis and line from center to point
-    float alpha = ePot.angleTo(point);
-    float influence = ePot.influenceAtAngle(alpha);
-    float influenceRadius = ePot.influenceRadiusAtAngle(alpha);
+  //calculate of the intersection between ellipsis and line from center to point
+  float alpha = ePot.angleTo(point);
+  float influence = ePot.influenceAtAngle(alpha);
+  float influenceRadius = ePot.influenceRadiusAtAngle(alpha);
 
+  if (distance < influenceRadius)
+  {
+    //calculate repulsion: direction is the line from center to point, strength is the distance to central line of the ellipsis
 
-    if (distance < influenceRadius)
-    {
+    //gradient.x+=influence*(1/distance-1/influenceRadius)*(1/pow(distance,3.0))*(point.x-ePot.position.x);
+    //gradient.y+=influence*(1/distance-1/influenceRadius)*(1/pow(distance,3.0))*(point.y-ePot.position.y);
+    gradient.x() += influence * (influenceRadius - distance) * (point.x() - ePot.position.x()) / (distance);
+    gradient.y() += influence * (influenceRadius - distance) * (point.y() - ePot.position.y()) / (distance);
+  }
+}
 
-      //calculate repulsion: direction is the line from center to point, strength is the distance to central line of the ellipsis
+//rectangularPotentials (linear impact)
+void PotentialField::addGradient(RPotential& rPot, const Vector2f& point, Vector2f& gradient)
+{
+  Vector2f direction = point - rPot.position;
+  float distance = direction.norm() + 0.0001f;
+  if (distance < rPot.fitToRectangle(direction).norm())
+  {
+    gradient.x() += rPot.influence * (direction.x()) / distance;
+    gradient.y() += rPot.influence * (direction.y()) / distance;
+  }
+}
 
-      //gradient.x+=influence*(1/distance-1/influenceRadius)*(1/pow(distance,3.0))*(point.x-ePot.position.x);
-      //gradient.y+=influence*(1/distance-1/influenceRadius)*(1/pow(distance,3.0))*(point.y-ePot.position.y);
-      gradient.x() += influence * (influenceRadius - distance) * (point.x() - ePot.position.x()) / (distance);
-      gradient.y() += influence * (influenceRadius - distance) * (point.y() - ePot.position.y()) / (distance);
-    }
+void PotentialField::rasterize(const Vector2f& min, const Vector2f& max, float cellSize)
+{
+  gridOrigin = min;
+  gridCellSize = std::max(cellSize, 1.f);
+  gridSizeX = std::max(2, static_cast<int>(std::ceil((max.x() - min.x()) / gridCellSize)) + 1);
+  gridSizeY = std::max(2, static_cast<int>(std::ceil((max.y() - min.y()) / gridCellSize)) + 1);
+  gradientGrid.assign(static_cast<size_t>(gridSizeX * gridSizeY), Vector2f::Zero());
+
+  //linear potentials are global
+  if (!linearPotentials.empty())
+    for (int x = 0; x < gridSizeX; x++)
+      for (int y = 0; y < gridSizeY; y++)
+      {
+        const Vector2f point = gridOrigin + Vector2f(static_cast<float>(x), static_cast<float>(y)) * gridCellSize;
+        Vector2f& gradient = gradientGrid[x * gridSizeY + y];
+        for (Potential& potential : linearPotentials)
+          addGradient(potential, point, gradient);
+      }
+
+  for (QPotential& qPotential : quadraticPotentials)
+    rasterizeLocalPotential(qPotential, qPotential.influenceRadius);
+
+  //the influence radius of an ellipse is bounded by its half axes
+  for (EPotential& ePot : ellipticalPotentials)
+  {
+    const float sideRadius = std::max(ePot.left.influenceRadius, ePot.right.influenceRadius) + (ePot.left.position - ePot.right.position).norm() / 2;
+    const float leftRadius = (ePot.left.position - ePot.position).norm() + ePot.left.influenceRadius;
+    const float rightRadius = (ePot.right.position - ePot.position).norm() + ePot.right.influenceRadius;
+    rasterizeLocalPotential(ePot, std::max(sideRadius, std::max(leftRadius, rightRadius)));
   }
 
-  //rectangularPotentials (linear impact)
-  for (unsigned int i = 0; i < rectangularPotentials.size(); i++)
+  //a rectangle is bounded by its farthest corner
+  for (RPotential& rPot : rectangularPotentials)
   {
-    RPotential rPot = rectangularPotentials.at(i);
-    Vector2f direction = point - rPot.position;
-    float distance = direction.norm() + 0.0001f;
-    if (distance < rPot.fitToRectangle(direction).norm())
-    {
-      gradient.x() += rPot.influence * (direction.x()) / distance;
-      gradient.y() += rPot.influence * (direction.y()) / distance;
-    }
+    const float radius = std::max(std::max(rPot.diagonalFL().norm(), rPot.diagonalFR().norm()), std::max(rPot.diagonalBL().norm(), rPot.diagonalBR().norm()));
+    rasterizeLocalPotential(rPot, radius);
   }
+}
 
-  return gradient;
+template <typename P> void PotentialField::rasterizeLocalPotential(P& potential, float radius)
+{
+  const Vector2f relative = potential.position - gridOrigin;
+  const int minX = std::max(0, static_cast<int>(std::floor((relative.x() - radius) / gridCellSize)));
+  const int maxX = std::min(gridSizeX - 1, static_cast<int>(std::ceil((relative.x() + radius) / gridCellSize)));
+  const int minY = std::max(0, static_cast<int>(std::floor((relative.y() - radius) / gridCellSize)));
+  const int maxY = std::min(gridSizeY - 1, static_cast<int>(std::ceil((relative.y() + radius) / gridCellSize)));
+  for (int x = minX; x <= maxX; x++)
+    for (int y = minY; y <= maxY; y++)
+      addGradient(potential, gridOrigin + Vector2f(static_cast<float>(x), static_cast<float>(y)) * gridCellSize, gradientGrid[x * gridSizeY + y]);
+}
+
+Vector2f PotentialField::getGridGradient(const Vector2f& point) const
+{
+  if (gradientGrid.empty())
+    return Vector2f::Zero();
+
+  const float fx = std::clamp((point.x() - gridOrigin.x()) / gridCellSize, 0.f, static_cast<float>(gridSizeX - 1));
+  const float fy = std::clamp((point.y() - gridOrigin.y()) / gridCellSize, 0.f, static_cast<float>(gridSizeY - 1));
+  const int x = std::min(static_cast<int>(fx), gridSizeX - 2);
+  const int y = std::min(static_cast<int>(fy), gridSizeY - 2);
+  const float tx = fx - static_cast<float>(x);
+  const float ty = fy - static_cast<float>(y);
+
+  const Vector2f* node = &gradientGrid[x * gridSizeY + y];
+  const Vector2f bottom = node[0] * (1.f - tx) + node[gridSizeY] * tx;
+  const Vector2f top = node[1] * (1.f - tx) + node[gridSizeY + 1] * tx;
+  return bottom * (1.f - ty) + top * ty;
 }
 
 void PotentialField::clear()
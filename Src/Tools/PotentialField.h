@@ -7,6 +7,7 @@
 #include "Tools/Math/Geometry.h"
 #include <math.h>
 #include <algorithm>
+#include <vector>
 
 struct Potential
 {
@@ -269,9 +270,30 @@ public:
   void clear();
   Vector2f getGradient(const Vector2f& point);
 
+  //evaluates the gradient at the nodes of a grid covering the rectangle from min to max, so that it can be looked up by getGridGradient
+  //local potentials only touch the nodes within their influence radius
+  void rasterize(const Vector2f& min, const Vector2f& max, float cellSize);
+  //bilinear interpolation of the gradient between the nodes of the grid computed by rasterize, points outside are clamped to the grid
+  Vector2f getGridGradient(const Vector2f& point) const;
+
   //private:
   std::vector<Potential> linearPotentials;
   std::vector<QPotential> quadraticPotentials;
   std::vector<EPotential> ellipticalPotentials;
   std::vector<RPotential> rectangularPotentials;
+
+private:
+  void addGradient(Potential& potential, const Vector2f& point, Vector2f& gradient);
+  void addGradient(QPotential& potential, const Vector2f& point, Vector2f& gradient);
+  void addGradient(EPotential& potential, const Vector2f& point, Vector2f& gradient);
+  void addGradient(RPotential& potential, const Vector2f& point, Vector2f& gradient);
+
+  //adds the gradient of a local potential to all nodes within the given radius around its position
+  template <typename P> void rasterizeLocalPotential(P& potential, float radius);
+
+  Vector2f gridOrigin = Vector2f::Zero();
+  float gridCellSize = 1.f;
+  int gridSizeX = 0;
+  int gridSizeY = 0;
+  std::vector<Vector2f> gradientGrid; //gradients at the nodes, x * gridSizeY + y
 };
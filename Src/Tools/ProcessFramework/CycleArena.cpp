@@ -0,0 +1,72 @@
+/**
+ * @file CycleArena.cpp
+ *
+ * Implementation of class CycleArena.
+ */
+
+#include "CycleArena.h"
+#include "CycleLocal.h"
+#include <algorithm>
+
+static constexpr size_t bufferAlignment = 64;
+
+static CycleLocal<CycleArena> theInstance;
+
+CycleArena::CycleArena(size_t size) : size(size)
+{
+  buffer = static_cast<char*>(std::pmr::new_delete_resource()->allocate(size, bufferAlignment));
+}
+
+CycleArena::~CycleArena()
+{
+  reset();
+  std::pmr::new_delete_resource()->deallocate(buffer, size, bufferAlignment);
+}
+
+CycleArena& CycleArena::get()
+{
+  return *theInstance;
+}
+
+void CycleArena::reset()
+{
+  const size_t usedInFrame = used.load(std::memory_order_relaxed) + overflowBytes;
+  highWaterMark = std::max(highWaterMark, usedInFrame);
+
+  for (const Overflow& overflow : overflows)
+    std::pmr::new_delete_resource()->deallocate(overflow.memory, overflow.bytes, overflow.alignment);
+  overflows.clear();
+
+  // grow buffer, so that the next frame probably fits in
+  if (overflowBytes)
+  {
+    std::pmr::new_delete_resource()->deallocate(buffer, size, bufferAlignment);
+    size = std::max(size * 2, highWaterMark);
+    buffer = static_cast<char*>(std::pmr::new_delete_resource()->allocate(size, bufferAlignment));
+  }
+
+  overflowBytes = 0;
+  used.store(0, std::memory_order_relaxed);
+}
+
+void* CycleArena::do_allocate(size_t bytes, size_t alignment)
+{
+  allocatedByThread += bytes;
+
+  size_t offset = used.load(std::memory_order_relaxed);
+  size_t aligned;
+  do
+  {
+    aligned = (offset + alignment - 1) & ~(alignment - 1);
+    if (alignment > bufferAlignment || aligned + bytes > size)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      void* memory = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+      overflows.push_back({memory, bytes, alignment});
+      overflowBytes += bytes;
+      return memory;
+    }
+  } while (!used.compare_exchange_weak(offset, aligned + bytes, std::memory_order_relaxed));
+
+  return buffer + aligned;
+}
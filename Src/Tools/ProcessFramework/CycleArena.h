@@ -0,0 +1,89 @@
+/**
+ * @file CycleArena.h
+ *
+ * Contains the definition of class CycleArena, a memory resource for
+ * temporary containers whose memory is only valid until the next frame.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+/**
+ * A bump allocator that is reset at the beginning of each frame. Modules can
+ * use it for containers that are built and thrown away within a single
+ * update(), e.g.
+ *
+ *   std::pmr::vector<Vector2f> points(&CycleArena::get());
+ *
+ * Deallocation does nothing, all memory is reclaimed by reset(). Allocations
+ * work in parallel without locking as long as the memory of the current frame
+ * fits into the buffer. Otherwise, additional memory is requested from the heap
+ * and the buffer grows to the high-water mark at the next reset.
+ * Containers allocated from the arena must never survive the frame, i.e. they
+ * must not be members of modules or representations.
+ */
+class CycleArena : public std::pmr::memory_resource
+{
+public:
+  /**
+   * Constructor.
+   * @param size The initial size of the buffer in bytes.
+   */
+  CycleArena(size_t size = 256 * 1024);
+  ~CycleArena();
+  CycleArena(const CycleArena&) = delete;
+  CycleArena& operator=(const CycleArena&) = delete;
+
+  /**
+   * Returns the arena of the framework cycle (i.e. process of a robot) the calling thread belongs to.
+   * @return The arena.
+   */
+  static CycleArena& get();
+
+  /**
+   * Frees all memory allocated in the current frame. Must only be called while
+   * no module is executed.
+   */
+  void reset();
+
+  /**
+   * Returns the maximum number of bytes allocated in a single frame so far.
+   * @return The high-water mark in bytes.
+   */
+  size_t getHighWaterMark() const { return highWaterMark; }
+
+  /**
+   * Returns the number of bytes allocated from any arena by the calling thread.
+   * The difference before and after an update() is the memory used by a module.
+   * @return The number of bytes allocated since the thread was started.
+   */
+  static size_t getAllocatedByThread() { return allocatedByThread; }
+
+private:
+  /** Memory requested from the heap, because the buffer was too small. */
+  struct Overflow
+  {
+    void* memory;
+    size_t bytes;
+    size_t alignment;
+  };
+
+  char* buffer; /**< The memory that is handed out. */
+  size_t size; /**< The size of the buffer in bytes. */
+  std::atomic<size_t> used{0}; /**< The number of bytes used in the buffer. */
+  std::mutex mutex; /**< Protects the overflow allocations. */
+  std::vector<Overflow> overflows; /**< Allocations that did not fit into the buffer in the current frame. */
+  size_t overflowBytes = 0; /**< The number of bytes in overflows. */
+  size_t highWaterMark = 0; /**< The maximum number of bytes used in a single frame. */
+
+  inline static thread_local size_t allocatedByThread = 0;
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void*, size_t, size_t) override {}
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
@@ -10,8 +10,8 @@
 #include "Platform/BHAssert.h"
 #include "Tools/Build.h"
 #include "Representations/Infrastructure/RoboCupGameControlData.h"
+#include <array>
 #include <functional>
-#include <atomic>
 
 
 template <typename V> class CycleLocal
@@ -21,12 +21,8 @@ private:
 
   static constexpr size_t maxNumberOfRobots = Build::targetRobot() ? 1 : MAX_NUM_PLAYERS * 2;
   static constexpr size_t maxNumberOfCycles = maxNumberOfRobots * 3; // # robots * 2 teams * 3 cycles
-  std::atomic_uchar maxCycleId{0};
-  std::array<std::unique_ptr<V>, maxNumberOfCycles> entries{nullptr};
-  std::array<const Blackboard*, maxNumberOfCycles> cycleIds{nullptr};
-  std::array<std::atomic<bool>, maxNumberOfCycles> freeEntries{false};
-
-  inline static thread_local size_t cache = 0;
+  std::array<std::unique_ptr<V>, maxNumberOfCycles> entries{nullptr}; /**< The entries, indexed by the index of their blackboard. */
+  std::array<unsigned, maxNumberOfCycles> owners{0}; /**< The serial numbers of the blackboards the entries were created for (0 = none). */
 
 public:
   template <typename... Params>
@@ -44,36 +40,16 @@ public:
   {
     const Blackboard* const instance = &Blackboard::getInstance();
     ASSERT(instance);
+    const size_t index = instance->getIndex();
+    ASSERT(index < maxNumberOfCycles);
 
-    if (cycleIds[cache] == instance)
-      return *entries[cache];
-
-    for (unsigned char id = 0; id < maxCycleId.load(std::memory_order_relaxed); ++id)
-    {
-      if (cycleIds[id] == instance)
-      {
-        cache = id;
-        return *entries[cache];
-      }
-    }
-
-    unsigned char newId = maxCycleId.fetch_add(1, std::memory_order_relaxed);
-    if (newId >= maxNumberOfCycles)
+    // An entry left by a destroyed blackboard with the same index is replaced.
+    if (owners[index] != instance->getSerialNumber())
     {
-      maxCycleId.store(maxNumberOfCycles, std::memory_order_relaxed);
-      for (newId = 0; newId < maxNumberOfCycles; ++newId)
-      {
-        if (freeEntries[newId].exchange(false, std::memory_order_relaxed))
-          break;
-      }
+      entries[index] = init();
+      owners[index] = instance->getSerialNumber();
     }
-    ASSERT(newId < maxNumberOfCycles);
-
-    entries[newId] = init();
-    cycleIds[newId] = instance;
-
-    cache = newId;
-    return *entries[cache];
+    return *entries[index];
   }
 
 
@@ -85,17 +61,9 @@ public:
   {
     const Blackboard* const instance = &Blackboard::getInstance();
     ASSERT(instance);
-
-    for (unsigned char id = 0; id < maxCycleId.load(std::memory_order_relaxed); ++id)
-    {
-      if (cycleIds[id] == instance)
-      {
-        entries[id].reset();
-        cycleIds[id] = nullptr;
-        freeEntries[id].store(true, std::memory_order_relaxed);
-        return;
-      }
-    }
-    ASSERT(false);
+    const size_t index = instance->getIndex();
+    ASSERT(index < maxNumberOfCycles && owners[index] == instance->getSerialNumber());
+    entries[index].reset();
+    owners[index] = 0;
   }
 };
@@ -60,7 +60,7 @@ class ExecutorObserver : public tf::ObserverInterface
 
 
 public:
-  ExecutorObserver(std::string name) : _name(std::move(name))
+  ExecutorObserver(std::string name, size_t reserve = 100000) : _name(std::move(name)), _reserve(reserve)
   {
     _thisInstanceId = _instanceId.fetch_add(1, std::memory_order_relaxed) + 1;
     {
@@ -70,8 +70,28 @@ public:
     }
   }
 
+  /** The executions recorded, e.g. in a single frame. */
+  struct Frame
+  {
+    std::vector<std::vector<TaskExecution>> taskExecutions; /**< The task executions per worker. */
+    std::vector<Execution> genericExecutions; /**< The functions observed in the main thread. */
+  };
+
   inline nlohmann::json dumpJson() const;
 
+  /**
+  @brief dump timelines recorded earlier in JSON
+  @param frames the timelines, e.g. of several frames
+  @return the trace events in the Chrome trace format
+  */
+  inline nlohmann::json dumpJson(const std::vector<const Frame*>& frames) const;
+
+  /**
+  @brief exchange the timeline data recorded so far with a previously recorded (and now obsolete) frame
+  @param frame the frame the recorded data is written to. Its former content is discarded.
+  */
+  inline void swapFrame(Frame& frame);
+
   /**
   @brief dump the timelines in JSON to a std::string
   @return a JSON string
@@ -98,9 +118,11 @@ private:
 
   static std::chrono::time_point<std::chrono::steady_clock> _origin;
   static std::mutex _origin_mutex;
-  std::vector<std::vector<TaskExecution>> _taskExecutions;
-  std::vector<Execution> _genericExecutions;
+  Frame _frame;
+  std::vector<std::vector<TaskExecution>>& _taskExecutions = _frame.taskExecutions;
+  std::vector<Execution>& _genericExecutions = _frame.genericExecutions;
   const std::string _name;
+  size_t _reserve; /**< The number of executions reserved per worker. */
 
   static std::atomic_char _instanceId;
   char _thisInstanceId = 0;
@@ -113,10 +135,10 @@ inline void ExecutorObserver::set_up(size_t num_workers)
 
   for (unsigned w = 0; w < _taskExecutions.size(); ++w)
   {
-    _taskExecutions[w].reserve(100000);
+    _taskExecutions[w].reserve(_reserve);
   }
 
-  _genericExecutions.reserve(100000);
+  _genericExecutions.reserve(_reserve);
 }
 
 // Procedure: on_entry
@@ -150,8 +172,26 @@ inline void ExecutorObserver::clear()
   }
 }
 
+// Function: swapFrame
+inline void ExecutorObserver::swapFrame(Frame& frame)
+{
+  frame.taskExecutions.resize(_taskExecutions.size());
+  std::swap(_taskExecutions, frame.taskExecutions);
+  for (auto& executions : _taskExecutions)
+    executions.clear();
+
+  std::swap(_genericExecutions, frame.genericExecutions);
+  _genericExecutions.clear();
+}
+
 // Procedure: dump
 inline nlohmann::json ExecutorObserver::dumpJson() const
+{
+  return dumpJson({&_frame});
+}
+
+// Procedure: dump
+inline nlohmann::json ExecutorObserver::dumpJson(const std::vector<const Frame*>& frames) const
 {
 
   using json = nlohmann::json;
@@ -161,53 +201,56 @@ inline nlohmann::json ExecutorObserver::dumpJson() const
   j += {{"name", "process_name"}, {"ph", "M"}, {"pid", _thisInstanceId}, {"args", {{"name", _name}}}};
 
   const std::regex taskNameRegex("([^ ]+) \\[(.+)\\]");
-  for (size_t worker = 0; worker < _taskExecutions.size(); worker++)
+  for (const Frame* frame : frames)
   {
-    for (const auto& execution : _taskExecutions[worker])
+    for (size_t worker = 0; worker < frame->taskExecutions.size(); worker++)
+    {
+      for (const auto& execution : frame->taskExecutions[worker])
+      {
+        json entry = {
+            {"ph", "X"},
+            {"pid", _thisInstanceId},
+            {"tid", worker + 1},
+            {"ts", std::chrono::duration<double, std::micro>(execution.beg - _origin).count()},
+            {"dur", std::chrono::duration<double, std::micro>(execution.end - execution.beg).count()},
+        };
+
+        std::string name = "", cat = "";
+        if (std::smatch matches; std::regex_match(execution.name, matches, taskNameRegex) && matches.size() == 3)
+        {
+          name = matches[1];
+          cat = matches[2];
+        }
+        else
+        {
+          name = execution.name;
+        }
+
+        entry["cat"] = cat;
+        entry["name"] = name;
+        entry["args"] = {{"dependents", execution.num_dependents}, {"successors", execution.num_successors}};
+
+        j += entry;
+      }
+    }
+
+    for (const auto& execution : frame->genericExecutions)
     {
       json entry = {
           {"ph", "X"},
           {"pid", _thisInstanceId},
-          {"tid", worker + 1},
+          {"tid", 0},
           {"ts", std::chrono::duration<double, std::micro>(execution.beg - _origin).count()},
           {"dur", std::chrono::duration<double, std::micro>(execution.end - execution.beg).count()},
       };
 
-      std::string name = "", cat = "";
-      if (std::smatch matches; std::regex_match(execution.name, matches, taskNameRegex) && matches.size() == 3)
-      {
-        name = matches[1];
-        cat = matches[2];
-      }
-      else
-      {
-        name = execution.name;
-      }
-
-      entry["cat"] = cat;
-      entry["name"] = name;
-      entry["args"] = {{"dependents", execution.num_dependents}, {"successors", execution.num_successors}};
+      entry["cat"] = "GenericExecution";
+      entry["name"] = execution.name;
 
       j += entry;
     }
   }
 
-  for (const auto& execution : _genericExecutions)
-  {
-    json entry = {
-        {"ph", "X"},
-        {"pid", _thisInstanceId},
-        {"tid", 0},
-        {"ts", std::chrono::duration<double, std::micro>(execution.beg - _origin).count()},
-        {"dur", std::chrono::duration<double, std::micro>(execution.end - execution.beg).count()},
-    };
-
-    entry["cat"] = "GenericExecution";
-    entry["name"] = execution.name;
-
-    j += entry;
-  }
-
   return j;
 }
 
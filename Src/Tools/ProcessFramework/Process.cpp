@@ -6,6 +6,7 @@
 
 #include "Process.h"
 #include "Tools/Global.h"
+#include "Tools/Math/Random.h"
 
 bool MultiDebugSenderBase::terminating = false;
 
@@ -19,6 +20,8 @@ bool Process::processMain()
 {
   if (!initialized)
   {
+    // Each thread of each robot gets its own reproducible random numbers.
+    Random::seed(std::to_string(settings.teamNumber) + "." + std::to_string(settings.playerNumber) + "." + threadName);
     init();
     initialized = true;
   }
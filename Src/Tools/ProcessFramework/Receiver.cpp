@@ -26,15 +26,6 @@ ReceiverList::ReceiverList(PlatformProcess* p, const std::string& receiverName)
     else
       getFirst() = this;
   }
-  for (int i = 0; i < 3; ++i)
-    package[i] = 0;
-}
-
-ReceiverList::~ReceiverList()
-{
-  for (int i = 0; i < 3; ++i)
-    if (package[i])
-      delete[](char*) package[i];
 }
 
 ReceiverList*& ReceiverList::getFirst()
@@ -56,19 +47,10 @@ ReceiverList* ReceiverList::lookup(const std::string& processName, const std::st
   return 0;
 }
 
-void ReceiverList::setPackage(void* p)
+void ReceiverList::finishPackage(unsigned sequenceNumber)
 {
-  int writing = 0;
-  if (writing == actual)
-    ++writing;
-  if (writing == reading)
-    if (++writing == actual)
-      ++writing;
-  ASSERT(writing != actual);
-  ASSERT(writing != reading);
-  if (package[writing])
-    delete[](char*) package[writing];
-  package[writing] = p;
-  actual = writing;
+  packages.writeBuffer().sequenceNumber = sequenceNumber;
+  packages.finishWrite();
+  sentSequenceNumber.store(sequenceNumber, std::memory_order_release);
   process->trigger();
 }
@@ -9,6 +9,9 @@
 #pragma once
 
 #include "Tools/Streams/InStreams.h"
+#include "Tools/TripleBuffer.h"
+#include <atomic>
+#include <vector>
 
 class PlatformProcess;
 
@@ -19,15 +22,26 @@ class PlatformProcess;
  */
 class ReceiverList
 {
+public:
+  /** A serialized package together with the number of the frame it was sent in. */
+  struct Package
+  {
+    std::vector<char> data; /**< The serialized package. Its memory is reused for later packages. */
+    unsigned sequenceNumber = 0; /**< The number of the send operation that created this package (starting at 1). */
+  };
+
 private:
   ReceiverList* next = nullptr; /**< The successor of the current receiver. */
   std::string name; /**< The name of a receiver without the module's name. */
 
 protected:
   PlatformProcess* process; /**< The process this receiver is associated with. */
-  void* package[3]; /**< A triple buffer for received packages. */
-  volatile int reading = 0; /**< Index of package reserved for reading. */
-  volatile int actual = 0; /**< Index of package that is the most actual. */
+  TripleBuffer<Package> packages; /**< The lock-free channel between the sending and the receiving thread. */
+  std::atomic<unsigned> sentSequenceNumber{0}; /**< The sequence number of the last package sent. Only written by the sender. */
+  std::atomic<unsigned> receivedSequenceNumber{0}; /**< The sequence number of the last package read. Only written by the receiver. */
+  unsigned sequenceNumber = 0; /**< The sequence number of the package currently read. */
+  unsigned missedPackages = 0; /**< The number of packages that were overwritten before they were read. */
+  bool newPackage = false; /**< Was a new package read in the current frame? */
 
   /**
    * The function checks whether a new package has arrived.
@@ -42,7 +56,7 @@ public:
    */
   ReceiverList(PlatformProcess* process, const std::string& receiverName);
 
-  virtual ~ReceiverList();
+  virtual ~ReceiverList() = default;
 
   /**
    * Returns the begin of the list of all receivers.
@@ -68,16 +82,43 @@ public:
   void checkAllForPackages();
 
   /**
-   * The function sets the package.
-   * @param p The package.
+   * The function returns the buffer the sender writes the next package to.
+   * Must only be called by the sending thread.
+   * @return The package that will be sent by the next call of finishPackage().
    */
-  void setPackage(void* p);
+  Package& beginPackage() { return packages.writeBuffer(); }
+
+  /**
+   * The function publishes the package written to the buffer returned by beginPackage().
+   * Must only be called by the sending thread.
+   * @param sequenceNumber The sequence number of the package.
+   */
+  void finishPackage(unsigned sequenceNumber);
 
   /**
    * The function determines whether the receiver has a pending package.
    * @return Is there still an unprocessed package?
    */
-  bool hasPendingPackage() const { return package[actual] != 0; }
+  bool hasPendingPackage() const { return sentSequenceNumber.load(std::memory_order_acquire) != receivedSequenceNumber.load(std::memory_order_acquire); }
+
+  /**
+   * Returns the sequence number of the package that was read last.
+   * @return The sequence number or 0 if no package was received so far.
+   */
+  unsigned getSequenceNumber() const { return sequenceNumber; }
+
+  /**
+   * Returns whether a new package was read in the current frame. Otherwise, the data
+   * is still the one of an earlier frame.
+   * @return Was the data updated?
+   */
+  bool hasNewPackage() const { return newPackage; }
+
+  /**
+   * Returns how many packages were replaced by newer ones before they could be read.
+   * @return The total number of missed packages.
+   */
+  unsigned getMissedPackages() const { return missedPackages; }
 
   /**
    * The function searches for a receiver with the given name.
@@ -101,14 +142,27 @@ private:
    */
   virtual void checkForPackage()
   {
-    reading = actual;
-    if (package[reading])
+    T& data = *static_cast<T*>(this);
+    constexpr bool isQueue = requires(T & queue, char* streamed) { queue.setStreamedData(streamed); };
+
+    // message queues may still reference the package read before, which the sender can reuse after the next beginRead
+    if constexpr (isQueue)
+      data.release();
+
+    newPackage = packages.beginRead();
+    if (newPackage)
     {
-      T& data = *static_cast<T*>(this);
-      InBinaryMemory memory(package[reading]);
-      memory >> data;
-      delete[](char*) package[reading];
-      package[reading] = 0;
+      const Package& package = packages.readBuffer();
+      missedPackages += package.sequenceNumber - sequenceNumber - 1;
+      sequenceNumber = package.sequenceNumber;
+      if constexpr (isQueue)
+        data.setStreamedData(const_cast<char*>(package.data.data()));
+      else
+      {
+        InBinaryMemory memory(package.data.data());
+        memory >> data;
+      }
+      receivedSequenceNumber.store(sequenceNumber, std::memory_order_release);
     }
   }
 
@@ -92,6 +92,7 @@ protected:
       *alreadyReceived[RECEIVERS_MAX]; /**< A list of all receivers that have already received the current package. */
   int numOfReceivers = 0, /**< The number of entries in the receiver list. */
       numOfAlreadyReceived = -1; /**< The number of entries in the already received list. */
+  unsigned sequenceNumber = 0; /**< The number of calls of send(). It allows receivers to detect missed packages. */
 
   /**
    * The function adds a receiver to this sender.
@@ -120,11 +121,11 @@ protected:
           const T& data = *static_cast<const T*>(this);
           OutBinarySize size;
           size << data;
-          void* r = (void*)new char[size.getSize()];
-          ASSERT(r);
-          OutBinaryMemory memory(r);
+          ReceiverList::Package& package = receiver[i]->beginPackage();
+          package.data.resize(size.getSize());
+          OutBinaryMemory memory(package.data.data());
           memory << data;
-          receiver[i]->setPackage(r);
+          receiver[i]->finishPackage(sequenceNumber);
           // note that receiver[i] has received the current package
           ASSERT(numOfAlreadyReceived < RECEIVERS_MAX);
           alreadyReceived[numOfAlreadyReceived++] = receiver[i];
@@ -160,6 +161,7 @@ public:
   void send()
   {
     numOfAlreadyReceived = 0;
+    ++sequenceNumber;
     sendPackage();
   }
 };
@@ -6,15 +6,22 @@
  */
 
 #include "SubThread.h"
+#include "CycleArena.h"
 #include "Tools/Debugging/Modify.h"
+#include "Platform/File.h"
+#include "Tools/Build.h"
+#include "Platform/SamplingProfiler.h"
+#include "Platform/SystemCall.h"
 #include <taskflow/taskflow.hpp>
 #include <taskflow/algorithm/for_each.hpp>
 #include <mutex>
 #include <condition_variable>
+#include <filesystem>
+#include <fstream>
 
 SubThread::SubThread(SuperThread& superThread) : timingManager(&superThread.timingManager), superThread(&superThread)
 {
-  sender.setSize(5200000, 100000);
+  SuperThread::initDebugSender(sender);
   threadName = superThread.getThreadName() + "Worker";
 
   // copy debug requests from super to sub threads
@@ -74,6 +81,15 @@ void SubThread::moveMessages(MessageQueue& processSender)
   debugRequestTable.clearDisabledRequests();
 }
 
+void SubThread::removeBulkyDebugMessages()
+{
+  sender.removeMessages(
+      [](MessageID id)
+      {
+        return id == idDebugImage || id == idDebugJPEGImage || id == idDebugDrawing || id == idDebugDrawing3D || id == idPlot;
+      });
+}
+
 void SubThread::beforeRun()
 {
   // is set in Process::processMain() usually
@@ -93,10 +109,36 @@ SuperThread::SuperThread(MessageQueue& debugIn, MessageQueue& debugOut, std::str
   stream >> config;
 }
 
+void SuperThread::initDebugSender(MessageQueue& sender)
+{
+  // Images and drawings cannot take the space of other messages and vice versa.
+  static constexpr std::pair<MessageID, size_t> quotas[] = {
+      {idDebugImage, 2600000}, // one upper camera image in YUYV
+      {idDebugJPEGImage, 800000},
+      {idDebugDrawing, 500000},
+      {idDebugDrawing3D, 200000},
+      {idPlot, 50000},
+      {idText, 50000}};
+  constexpr size_t otherMessages = 900000;
+  constexpr size_t infrastructure = 100000;
+
+  size_t size = otherMessages + infrastructure;
+  for (const auto& [id, quota] : quotas)
+  {
+    sender.setQuota(id, quota);
+    size += quota;
+  }
+  sender.setSize(size, infrastructure);
+}
+
 void SuperThread::setNumOfSubthreads(unsigned n)
 {
+  // observers are destroyed with the executor
+  observer.reset();
+  traceObserver.reset();
   executor.reset();
   subthreads.resize(n);
+  workerCores.assign(n, -1);
 
   // Construct and destruct subthreads in their worker instances
   class SubThreadWorkerInterface : public tf::WorkerInterface
@@ -106,6 +148,13 @@ void SuperThread::setNumOfSubthreads(unsigned n)
 
     virtual void scheduler_prologue(tf::Worker& worker) override
     {
+      if (SystemCall::getMode() == SystemCall::physicalRobot)
+      {
+        Thread<ProcessBase>::setCurrentAffinity(superThread->cores);
+        Thread<ProcessBase>::setCurrentPriority(superThread->workerPriority);
+      }
+      superThread->workerCores.at(worker.id()) = Thread<ProcessBase>::getCurrentCore();
+
       ASSERT(!superThread->subthreads.at(worker.id()));
       superThread->subthreads.at(worker.id()) = std::make_unique<SubThread>(*superThread);
 
@@ -149,6 +198,14 @@ void SuperThread::setNumOfSubthreads(unsigned n)
   workerInterface->wait();
 }
 
+void SuperThread::applyAffinity()
+{
+  cores = config.cores;
+  workerPriority = config.workerPriority;
+  if (SystemCall::getMode() == SystemCall::physicalRobot)
+    Thread<ProcessBase>::setCurrentAffinity(cores);
+}
+
 void SuperThread::run(tf::Taskflow& tf)
 {
   if (configFile == "cognition.cfg")
@@ -156,11 +213,35 @@ void SuperThread::run(tf::Taskflow& tf)
   else
     MODIFY_ONCE("threads:motion:config", config);
 
-  if (!executor || config.numWorkers != static_cast<unsigned int>(executor->num_workers()))
+  // workers inherit the affinity of this thread, but apply it explicitly when they are created
+  if (!executor || config.cores != cores || config.workerPriority != workerPriority)
+  {
+    applyAffinity();
+    setNumOfSubthreads(config.numWorkers);
+  }
+  else if (config.numWorkers != static_cast<unsigned int>(executor->num_workers()))
     setNumOfSubthreads(config.numWorkers);
 
+  if (config.doubleBufferedRepresentations != doubleBufferedRepresentations)
+  {
+    doubleBufferedRepresentations = config.doubleBufferedRepresentations;
+    blackboard.setDoubleBuffered(doubleBufferedRepresentations);
+  }
+
   DEBUG_RESPONSE_ONCE("threads:restart") setNumOfSubthreads(threads);
   DEBUG_RESPONSE_ONCE("threads:dumpTaskflowGraph") OUTPUT_TEXT(tf.dump());
+  DEBUG_RESPONSE_ONCE("threads:affinity")
+  {
+    std::string text = getThreadName() + " runs on core " + std::to_string(Thread<ProcessBase>::getCurrentCore()) + ", workers started on cores";
+    for (int core : workerCores)
+      text += " " + std::to_string(core);
+    text += ", pinned to";
+    if (cores.empty())
+      text += " all cores";
+    for (int core : cores)
+      text += " " + std::to_string(core);
+    OUTPUT_TEXT(text);
+  }
 
   DEBUG_RESPONSE("threads:observeTaskflow")
   {
@@ -169,11 +250,30 @@ void SuperThread::run(tf::Taskflow& tf)
   }
   DEBUG_RESPONSE_ONCE("threads::observeTaskflowOnce") observer = executor->make_observer<ExecutorObserver>(getThreadName());
 
+  if (config.traceFrames && !traceObserver)
+  {
+    // a frame has only a few hundred tasks
+    traceObserver = executor->make_observer<ExecutorObserver>(getThreadName(), 1000);
+    traceRing.clear();
+    traceRing.resize(config.traceFrames);
+    traceRingPos = tracedFrames = 0;
+  }
+  else if (!config.traceFrames && traceObserver)
+  {
+    executor->remove_observer(traceObserver);
+    traceObserver.reset();
+    traceRing.clear();
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
   observeFunction("run",
       [&]
       {
         executor->run(tf).wait();
       });
+  if (traceObserver)
+    recordTrace(std::chrono::steady_clock::now() - begin);
+  updateProfiler();
 
   DEBUG_RESPONSE_NOT("threads:observeTaskflow")
   {
@@ -227,6 +327,84 @@ void SuperThread::run(tf::Taskflow& tf)
   }
 }
 
+void SuperThread::recordTrace(std::chrono::steady_clock::duration duration)
+{
+  traceObserver->swapFrame(traceRing[traceRingPos]);
+  traceRingPos = (traceRingPos + 1) % traceRing.size();
+  ++tracedFrames;
+
+  bool requested = false;
+  DEBUG_RESPONSE_ONCE("threads:dumpTrace") requested = true;
+  const bool overrun = config.traceBudget && duration > std::chrono::microseconds(config.traceBudget);
+
+  // overruns are only dumped if the ring contains no frames of the previous dump
+  if (!requested && !(overrun && tracedFrames >= traceRing.size()))
+    return;
+  // only one dump at a time
+  if (traceDumpFuture.valid() && traceDumpFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return;
+  tracedFrames = 0;
+
+  // oldest frame first
+  std::vector<ExecutorObserver::Frame> frames;
+  frames.reserve(traceRing.size());
+  for (size_t i = 0; i < traceRing.size(); ++i)
+    frames.push_back(traceRing[(traceRingPos + i) % traceRing.size()]);
+
+  const std::string dir = std::string(File::getBHDir()) + (Build::targetRobot() ? "/traces/" : "/Config/Traces/");
+  const std::string path = dir + "trace_" + getThreadName() + "_" + std::to_string(SystemCall::getCurrentSystemTime()) + ".json";
+  OUTPUT_TEXT("Writing trace of the last " << frames.size() << " frames to " << path);
+
+  traceDumpFuture = std::async(std::launch::async,
+      [observer = traceObserver, frames = std::move(frames), dir, path]()
+      {
+        std::vector<const ExecutorObserver::Frame*> framePointers;
+        for (const ExecutorObserver::Frame& frame : frames)
+          framePointers.push_back(&frame);
+
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        std::ofstream stream(path);
+        stream << observer->dumpJson(framePointers);
+      });
+}
+
+void SuperThread::updateProfiler()
+{
+  bool requested = false;
+  DEBUG_RESPONSE("threads:profile") requested = true;
+
+  if (requested && !profiling)
+  {
+    // the profiler is process-wide, so it is only started by one thread
+    if (!profileDumpFuture.valid() || profileDumpFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+      profiling = SamplingProfiler::start(config.samplingInterval);
+  }
+  else if (!requested && profiling)
+  {
+    SamplingProfiler::stop();
+    profiling = false;
+
+    const std::string dir = std::string(File::getBHDir()) + (Build::targetRobot() ? "/traces/" : "/Config/Traces/");
+    const std::string path = dir + "profile_" + getThreadName() + "_" + std::to_string(SystemCall::getCurrentSystemTime()) + ".folded";
+    OUTPUT_TEXT("Writing profile to " << path);
+
+    // symbolizing the samples takes a while
+    profileDumpFuture = std::async(std::launch::async,
+        [dir, path]()
+        {
+          std::unordered_map<std::string, unsigned> counts;
+          SamplingProfiler::collect(counts);
+
+          std::error_code error;
+          std::filesystem::create_directories(dir, error);
+          std::ofstream stream(path);
+          for (const auto& [stack, count] : counts)
+            stream << stack << " " << count << "\n";
+        });
+  }
+}
+
 bool SuperThread::handleMessage(InMessage& message)
 {
   for (auto& subthread : subthreads)
@@ -239,14 +417,47 @@ bool SuperThread::handleMessage(InMessage& message)
 
 void SuperThread::moveMessages(MessageQueue& processSender)
 {
+  if (config.debugBandwidth)
+    limitDebugBandwidth();
+
   for (auto& subthread : subthreads)
     subthread->moveMessages(processSender);
 
   debugRequestTable.clearDisabledRequests();
 }
 
+void SuperThread::limitDebugBandwidth()
+{
+  // at most one second of the bandwidth can be saved up
+  const unsigned now = SystemCall::getCurrentSystemTime();
+  debugBudget = std::min(debugBudget + config.debugBandwidth * static_cast<double>(now - lastDebugBudgetUpdate) / 1000., static_cast<double>(config.debugBandwidth));
+  lastDebugBudgetUpdate = now;
+
+  size_t size = 0;
+  for (const auto& subthread : subthreads)
+    size += subthread->getDebugMessageSize();
+  if (static_cast<double>(size) > debugBudget)
+  {
+    size = 0;
+    for (auto& subthread : subthreads)
+    {
+      subthread->removeBulkyDebugMessages();
+      size += subthread->getDebugMessageSize();
+    }
+    if (droppedDebugFrames++ % 100 == 0)
+      OUTPUT_WARNING(getThreadName() << ": Debug messages exceed " << config.debugBandwidth << " bytes/s, images, drawings and plots are dropped");
+  }
+  debugBudget -= static_cast<double>(size);
+}
+
 void SuperThread::beforeRun()
 {
+  CycleArena::get().reset();
+
+  bool perfCounters = false;
+  DEBUG_RESPONSE("timing:perfCounters") perfCounters = true;
+  timingManager.setPerfCounters(perfCounters);
+
   for (auto& subthread : subthreads)
     subthread->beforeRun();
 }
@@ -261,4 +472,27 @@ void SuperThread::afterRun()
       {
         blackboard.copyUsedRepresentations();
       });
+
+  DEBUG_RESPONSE_ONCE("blackboard:copyStatistics")
+  {
+    size_t copied = 0;
+    std::string text;
+    for (const Blackboard::CopyStatistics& statistics : blackboard.getCopyStatistics())
+    {
+      if (!statistics.doubleBuffered)
+        copied += statistics.bytes;
+      text += "\n  " + statistics.representation + ": " + std::to_string(statistics.bytes) + " bytes" + (statistics.doubleBuffered ? " (swapped)" : "");
+    }
+    OUTPUT_TEXT(getThreadName() << " copies " << copied << " bytes per frame:" << text);
+  }
+
+  DEBUG_RESPONSE_ONCE("threads:debugQueueUsage")
+  {
+    std::string text;
+    for (int i = 0; i < numOfMessageIDs; ++i)
+      if (const size_t quota = debugOut.getQuota(static_cast<MessageID>(i)); quota)
+        text += "\n  " + std::string(::getName(static_cast<MessageID>(i))) + ": " + std::to_string(debugOut.getPeakUsage(static_cast<MessageID>(i))) + " of " + std::to_string(quota) + " bytes";
+    OUTPUT_TEXT(getThreadName() << " used up to " << debugOut.getPeakSize() << " of " << debugOut.getSize() << " bytes of its debug queue:" << text);
+    debugOut.resetPeaks();
+  }
 }
@@ -23,7 +23,17 @@ class SuperThread : public Process
 {
 public:
   STREAMABLE(SuperThreadConfiguration,,
-      (unsigned)(0) numWorkers
+      (unsigned)(0) numWorkers,
+      (unsigned)(0) criticalPathSchedulingInterval, /**< Order the task graph by the measured critical path every n frames (0 = never). */
+      (std::vector<std::string>) doubleBufferedRepresentations, /**< Representations swapped instead of copied for USES(). Their providers must overwrite them completely. */
+      (std::vector<int>) cores, /**< The cores the thread and its workers are pinned to on the robot (empty = all cores). */
+      (int)(0) workerPriority, /**< The real-time priority of the workers on the robot (0 = normal priority). */
+      (unsigned)(0) frameDeadline, /**< Time budget for executing the modules in µs. Optional modules are skipped if they would exceed it (0 = no deadline). */
+      (unsigned)(0) traceFrames, /**< The number of frames whose taskflow timelines are kept for a trace dump (0 = none). */
+      (unsigned)(0) traceBudget, /**< Dump the trace if executing the modules takes longer than this in µs (0 = only on request). */
+      (unsigned)(0) heapCheckWarmUpFrames, /**< Report update handlers that allocate heap memory after this many frames (0 = never). Only counted on the robot. */
+      (unsigned)(0) samplingInterval, /**< The CPU time between two samples of the sampling profiler in µs (0 = profiling disabled). Only supported on the robot. */
+      (unsigned)(0) debugBandwidth /**< The bytes per second the workers may send as debug messages. Images, drawings and plots are dropped beyond (0 = unlimited). */
   );
 
   SuperThread(MessageQueue& debugIn, MessageQueue& debugOut, std::string configFile);
@@ -31,16 +41,35 @@ public:
   SuperThread& operator=(const SuperThread&) = delete;
 
   void run(tf::Taskflow&);
+  const SuperThreadConfiguration& getConfiguration() const { return config; }
   void moveMessages(MessageQueue&);
   void beforeRun();
   void afterRun();
 
+  /**
+   * Sets the size and the quotas of bulky message ids of a debug sender.
+   * The size is the sum of the quotas plus the space for all other messages.
+   * @param sender The debug sender of a super thread or one of its sub threads.
+   */
+  static void initDebugSender(MessageQueue& sender);
+
 protected:
   virtual bool handleMessage(InMessage&);
 
   template <typename F> inline auto observeFunction(std::string name, F f)
   {
-    if (observer)
+    if (traceObserver)
+    {
+      if (observer)
+        return traceObserver->observeFunction(name,
+            [&]
+            {
+              return observer->observeFunction(name, f);
+            });
+      else
+        return traceObserver->observeFunction(std::move(name), f);
+    }
+    else if (observer)
       return observer->observeFunction(std::move(name), f);
     else
       return f();
@@ -48,6 +77,28 @@ protected:
 
 private:
   void setNumOfSubthreads(unsigned);
+  void applyAffinity();
+
+  /**
+   * Records the timelines of the frame just executed in the trace ring and
+   * writes all frames in the ring to a file if requested or if the frame
+   * exceeded the trace budget.
+   * @param duration The time it took to execute the modules.
+   */
+  void recordTrace(std::chrono::steady_clock::duration duration);
+
+  /**
+   * Starts the sampling profiler while "threads:profile" is active. When the
+   * request is deactivated, the thread that started the profiler stops it and
+   * writes the samples to a file in the folded stack format.
+   */
+  void updateProfiler();
+
+  /**
+   * Drops the images, drawings and plots the workers sent in this frame if
+   * their debug messages would exceed the configured bandwidth.
+   */
+  void limitDebugBandwidth();
 
   std::vector<std::unique_ptr<SubThread>> subthreads;
   std::unique_ptr<tf::Executor> executor;
@@ -57,10 +108,25 @@ private:
   std::vector<uint8_t> observerMsgpack;
   std::vector<uint8_t>::iterator observerMsgpackIt;
   bool sendMsgpackFinished = true;
+
+  std::shared_ptr<ExecutorObserver> traceObserver; /**< Records every frame if traceFrames is set. */
+  std::vector<ExecutorObserver::Frame> traceRing; /**< The timelines of the last frames. */
+  size_t traceRingPos = 0; /**< The next entry of the ring that is overwritten. */
+  size_t tracedFrames = 0; /**< The number of frames recorded since the last dump. */
+  std::future<void> traceDumpFuture; /**< Writes a trace file in the background. */
+  bool profiling = false; /**< Did this thread start the sampling profiler? */
+  std::future<void> profileDumpFuture; /**< Writes a profile in the background. */
+  double debugBudget = 0.; /**< The number of bytes the workers may still send as debug messages. */
+  unsigned lastDebugBudgetUpdate = 0; /**< When was the budget refilled the last time? */
+  unsigned droppedDebugFrames = 0; /**< The number of frames whose images, drawings and plots were dropped. Every 100th is reported. */
   int threads = std::thread::hardware_concurrency();
 
   const std::string configFile;
   SuperThreadConfiguration config;
+  std::vector<std::string> doubleBufferedRepresentations; /**< The double buffered representations currently set in the blackboard. */
+  std::vector<int> cores; /**< The cores the thread and its workers are currently pinned to. */
+  int workerPriority = 0; /**< The priority the workers currently run with. */
+  std::vector<int> workerCores; /**< The core each worker was running on when it was started. */
 };
 
 class SubThread
@@ -76,6 +142,12 @@ public:
   void beforeRun();
   void afterRun();
 
+  /** Returns the size of the debug messages sent in this frame in bytes. */
+  size_t getDebugMessageSize() const { return sender.getStreamedSize(); }
+
+  /** Removes the images, drawings and plots from the debug messages sent in this frame. */
+  void removeBulkyDebugMessages();
+
 private:
   TimingManager timingManager;
   DebugRequestTable debugRequestTable;
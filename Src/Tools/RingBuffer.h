@@ -195,6 +195,15 @@ public:
     --entries;
   }
 
+  /** Removes the entry front() from the buffer, i.e. the one that was added last. */
+  void pop_front()
+  {
+    ASSERT(!empty());
+    head = (allocated + head - 1) % allocated;
+    buffer[head].~T();
+    --entries;
+  }
+
   /**
    * Access to the individual entries of the buffer.
    * @param index The index of the element. Element 0 is the same as front(), element
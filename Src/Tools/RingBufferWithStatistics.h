@@ -0,0 +1,197 @@
+/**
+ * The file declares a ring buffer that determines the sum, average, variance,
+ * minimum, and maximum of its elements in constant time. The sums are kept by
+ * RingBufferWithSum, for the squares of the elements as well. The minimum and
+ * the maximum are the front of monotonic queues, which only contain the entries
+ * that can still become the extremum before they leave the buffer. The type of
+ * the elements must be a scalar, i.e. an arithmetic type or Angle.
+ * The file also declares an exponentially decaying version of the average and
+ * the variance that does not need a buffer at all.
+ */
+
+#pragma once
+
+#include "RingBufferWithSum.h"
+#include <array>
+#include <functional>
+
+template <typename T, std::size_t n> class RingBufferWithStatistics : public RingBufferWithSum<T, n>
+{
+private:
+  static_assert(n > 0, "The capacity must be known at compile time");
+
+  using Base = RingBufferWithSum<T, n>;
+
+  /**
+   * A queue of entries with monotonic values. The oldest entry is the extremum
+   * of all entries in the buffer.
+   * @tparam Precedes Does a value replace an older one as candidate?
+   */
+  template <typename Precedes> class MonotonicQueue
+  {
+  private:
+    struct Entry
+    {
+      T value;
+      std::size_t index; /**< The number of entries added to the buffer before this one. */
+    };
+
+    std::array<Entry, n> entries;
+    std::size_t first = 0; /**< The index of the oldest entry in the array. */
+    std::size_t count = 0;
+
+  public:
+    void clear() { count = 0; }
+
+    /**
+     * Removes all entries that left the buffer.
+     * @param oldestIndex The index of the oldest entry still in the buffer.
+     */
+    void removeOlderThan(std::size_t oldestIndex)
+    {
+      while (count && entries[first].index < oldestIndex)
+      {
+        first = (first + 1) % n;
+        --count;
+      }
+    }
+
+    /**
+     * Adds a new entry after removing all that cannot become the extremum anymore.
+     * There must be space for it, i.e. the entries that left the buffer must have been removed.
+     */
+    void push(const T& value, std::size_t index)
+    {
+      while (count && !Precedes()(entries[(first + count - 1) % n].value, value))
+        --count;
+      entries[(first + count) % n] = {value, index};
+      ++count;
+    }
+
+    const T& extremum() const { return entries[first].value; }
+  };
+
+  RingBufferWithSum<T, n> squares; /**< The squares of the entries to determine the variance in O(1). */
+  MonotonicQueue<std::greater<T>> maxima;
+  MonotonicQueue<std::less<T>> minima;
+  std::size_t added = 0; /**< The number of entries added so far. */
+
+public:
+  RingBufferWithStatistics() = default;
+
+  /**
+   * Adds a new entry to the front of the buffer. If the buffer was already full,
+   * the entry at back() is lost.
+   * @param value The value that is added to the buffer.
+   */
+  void push_front(const T& value)
+  {
+    Base::push_front(value);
+    squares.push_front(value * value);
+    ++added;
+    maxima.removeOlderThan(added - Base::size());
+    minima.removeOlderThan(added - Base::size());
+    maxima.push(value, added - 1);
+    minima.push(value, added - 1);
+  }
+
+  /** Empties the buffer. */
+  void clear()
+  {
+    Base::clear();
+    squares.clear();
+    maxima.clear();
+    minima.clear();
+  }
+
+  /**
+   * Fills the buffer with a value.
+   * @param value The value the buffer is filled with.
+   */
+  void fill(T value)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+      push_front(value);
+  }
+
+  /**
+   * Entries can only be added and the buffer can only be cleared. Replacing them would
+   * invalidate the extrema, and the sums of RingBufferWithSum do not support removing
+   * single entries before the buffer is full.
+   */
+  void set_front(const T& newValue) = delete;
+  void pop_back() = delete;
+  void reserve(std::size_t capacity) = delete;
+
+  /**
+   * Returns the minimum of all entries in O(1).
+   * If the buffer is empty, zero is returned.
+   */
+  T minimum() const { return Base::empty() ? T() : minima.extremum(); }
+
+  /**
+   * Returns the maximum of all entries in O(1).
+   * If the buffer is empty, zero is returned.
+   */
+  T maximum() const { return Base::empty() ? T() : maxima.extremum(); }
+
+  /**
+   * Returns the sample variance of all entries in O(1).
+   * If the buffer contains less than two entries, zero is returned.
+   */
+  T getVariance() const
+  {
+    const std::size_t size = Base::size();
+    if (size < 2)
+      return T();
+    const T sum = Base::sum();
+    const T variance = (squares.sum() - sum * sum / static_cast<float>(size)) / static_cast<float>(size - 1);
+    return variance > T() ? variance : T(); // rounding errors could make it negative
+  }
+};
+
+/**
+ * The exponentially decaying average and variance of a scalar series. Each new value
+ * gets the weight alpha, i.e. older values are forgotten with the factor 1 - alpha.
+ */
+template <typename T> class ExponentialStatistics
+{
+private:
+  float alpha; /**< The weight of a new value. */
+  T mean = T();
+  T variance = T();
+  bool initialized = false;
+
+public:
+  /** @param alpha The weight of a new value. It must be in (0, 1]. */
+  explicit ExponentialStatistics(float alpha) : alpha(alpha) {}
+
+  /**
+   * Adds a new value to the statistics. The first value initializes the average.
+   * @param value The new value.
+   */
+  void push(const T& value)
+  {
+    if (!initialized)
+    {
+      mean = value;
+      initialized = true;
+    }
+    else
+    {
+      const T difference = value - mean;
+      const T increment = alpha * difference;
+      mean += increment;
+      variance = (1.f - alpha) * (variance + difference * increment);
+    }
+  }
+
+  void clear()
+  {
+    mean = variance = T();
+    initialized = false;
+  }
+
+  T average() const { return mean; }
+  T getVariance() const { return variance; }
+};
@@ -138,6 +138,9 @@ public:
     RingBuffer<T, n>::pop_back();
   }
 
+  /** The sums cannot be corrected for removing the newest entry. */
+  void pop_front() = delete;
+
   /** Returns the sum of all entries in O(1). */
   T sum() const { return prevSum + currentSum; }
 
@@ -0,0 +1,99 @@
+/**
+ * @file SPSCRingBuffer.h
+ * The file declares a lock-free ring buffer for exactly one thread that pushes elements and
+ * one thread that reads them, e.g. an audio callback and a module. The reader accesses the
+ * elements in place: a window of elements is returned as up to two contiguous spans, since
+ * it may wrap around the end of the buffer.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+template <typename T> class SPSCRingBuffer
+{
+public:
+  /** A window of elements, which consists of two parts if it wraps around the end of the buffer. */
+  struct Window
+  {
+    std::span<const T> first;
+    std::span<const T> second;
+
+    std::size_t size() const { return first.size() + second.size(); }
+    const T& operator[](std::size_t index) const { return index < first.size() ? first[index] : second[index - first.size()]; }
+  };
+
+  explicit SPSCRingBuffer(std::size_t capacity = 0) { reserve(capacity); }
+
+  SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+  SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+  /**
+   * Discards all elements and changes the capacity, which is rounded up to a power of two.
+   * Neither the writer nor the reader must access the buffer at the same time.
+   */
+  void reserve(std::size_t capacity)
+  {
+    std::size_t size = 1;
+    while (size < capacity)
+      size <<= 1;
+    buffer.assign(capacity ? size : 0, T());
+    mask = buffer.size() - 1;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+  }
+
+  std::size_t capacity() const { return buffer.size(); }
+
+  /** Called by the writer to get the number of elements that can be appended. */
+  std::size_t space() const { return buffer.size() - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire)); }
+
+  /**
+   * Called by the writer to append elements. Elements that do not fit anymore are dropped.
+   * @return The number of elements appended.
+   */
+  std::size_t push(const T* values, std::size_t count)
+  {
+    const std::size_t currentHead = head.load(std::memory_order_relaxed);
+    count = std::min(count, space());
+    for (std::size_t i = 0; i < count; ++i)
+      buffer[(currentHead + i) & mask] = values[i];
+    head.store(currentHead + count, std::memory_order_release);
+    return count;
+  }
+
+  /** The number of elements the writer has appended so far, i.e. the index of the next element. */
+  std::size_t written() const { return head.load(std::memory_order_acquire); }
+
+  /** Called by the reader to get the number of elements that can be read. */
+  std::size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed); }
+
+  /**
+   * Called by the reader to access elements without copying them.
+   * @param offset The index of the first element relative to the oldest one.
+   * @param count The maximum number of elements.
+   * @return The elements, which stay valid until they are consumed.
+   */
+  Window peek(std::size_t offset, std::size_t count) const
+  {
+    const std::size_t available = size();
+    offset = std::min(offset, available);
+    count = std::min(count, available - offset);
+    const std::size_t start = (tail.load(std::memory_order_relaxed) + offset) & mask;
+    const std::size_t firstSize = std::min(count, buffer.size() - start);
+    return {std::span<const T>(buffer.data() + start, firstSize), std::span<const T>(buffer.data(), count - firstSize)};
+  }
+
+  /** Called by the reader to remove the count oldest elements. */
+  void consume(std::size_t count) { tail.store(tail.load(std::memory_order_relaxed) + std::min(count, size()), std::memory_order_release); }
+
+private:
+  std::vector<T> buffer;
+  std::size_t mask = 0;
+  std::atomic<std::size_t> head = 0; /**< The number of elements pushed so far, only changed by the writer. */
+  std::atomic<std::size_t> tail = 0; /**< The number of elements consumed so far, only changed by the reader. */
+};
@@ -280,6 +280,9 @@
 #define _STREAM_SER_1(...) _STREAM_SER_1_I __VA_ARGS__)
 #define _STREAM_SER_1_I(...) castFunction(_var, __VA_ARGS__::getName) _STREAM_DROP(_STREAM_DROP(
 
+/** Generate streaming code from declaration that writes basic types directly to binary streams if possible. */
+#define _STREAM_RAW(seq) {auto& _var = _STREAM_VAR(seq); Streaming::streamRaw(in, out, _raw, #seq, _var, Streaming:: _STREAM_SER_I seq));}
+
 /** Generate the actual declaration. */
 #define _STREAM_DECL(seq) decltype(Streaming::TypeWrapper<_STREAM_DECL_I seq)_STREAM_DECL_IV seq))>::type) _STREAM_VAR(seq) _STREAM_INIT(seq);
 #define _STREAM_DECL_I(...) _STREAM_JOIN(_STREAM_DECL_II_, _STREAM_SEQ_SIZE(__VA_ARGS__))(__VA_ARGS__)
@@ -318,8 +321,9 @@
     void serialize(In* in, Out* out) \
     { \
       STREAM_REGISTER_BEGIN \
+      [[maybe_unused]] const bool _raw = Streaming::isRaw(in, out); \
       streamBase \
-      _STREAM_ATTR_##n (_STREAM_SER, __VA_ARGS__) \
+      _STREAM_ATTR_##n (_STREAM_RAW, __VA_ARGS__) \
       STREAM_REGISTER_FINISH \
       if(in) \
         Streaming::onRead(*this); \
@@ -10,6 +10,9 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
 
 #include "InStreams.h"
 #include "Platform/BHAssert.h"
@@ -441,6 +444,19 @@ void InMap::parse(In& stream, const std::string& name)
   stack.reserve(20);
 }
 
+void InMap::merge(const SimpleMap& map, const std::string& name)
+{
+  if (this->map == nullptr)
+    this->map = std::make_shared<SimpleMap>();
+  this->map->merge(map);
+
+  if (this->name.size() == 0)
+    this->name = name;
+  else
+    this->name += " + " + name;
+  stack.reserve(20);
+}
+
 void InMap::printError(const std::string& msg)
 {
   if (showErrors)
@@ -675,6 +691,59 @@ InMapFile::InMapFile(const std::list<std::string>& names, bool showErrors) : InM
   open(names);
 }
 
+namespace
+{
+  /** The maps parsed from config files, shared by all threads. */
+  class ParsedMaps
+  {
+    struct Entry
+    {
+      std::filesystem::file_time_type time; /**< The modification time of the file when it was parsed. */
+      std::uintmax_t size; /**< The size of the file when it was parsed. */
+      std::shared_ptr<const SimpleMap> map; /**< The map parsed. */
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries; /**< The maps by full file name. */
+
+  public:
+    /**
+     * Returns the map parsed from a file. It is parsed if it was not parsed
+     * before or was modified since.
+     * @param stream The stream of the file.
+     * @return The map parsed from the file.
+     */
+    std::shared_ptr<const SimpleMap> get(InBinaryFile& stream)
+    {
+      const std::string& name = stream.getFullName();
+      std::error_code error;
+      const std::filesystem::file_time_type time = std::filesystem::last_write_time(name, error);
+      const std::uintmax_t size = error ? 0 : std::filesystem::file_size(name, error);
+      if (error) // cannot be checked for modifications, so it is not cached
+        return std::make_shared<SimpleMap>(stream, name);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto i = entries.find(name);
+        if (i != entries.end() && i->second.time == time && i->second.size == size)
+          return i->second.map;
+      }
+
+      // Parsing is done without the lock. Two threads might parse the same file, which is harmless.
+      std::shared_ptr<const SimpleMap> map = std::make_shared<SimpleMap>(stream, name);
+      std::lock_guard<std::mutex> lock(mutex);
+      entries[name] = {time, size, map};
+      return map;
+    }
+  };
+
+  ParsedMaps& getParsedMaps()
+  {
+    static ParsedMaps parsedMaps;
+    return parsedMaps;
+  }
+}
+
 void InMapFile::open(const std::list<std::string>& names)
 {
   for (const std::string& name : names)
@@ -686,7 +755,7 @@ void InMapFile::open(const std::list<std::string>& names)
 
     if (stream.exists())
     {
-      parse(stream, stream.getFullName());
+      merge(*getParsedMaps().get(stream), stream.getFullName());
       ++it;
     }
     else
@@ -1043,6 +1043,13 @@ protected:
    */
   void parse(In& stream, const std::string& name = "");
 
+  /**
+   * Merges an already parsed map into the map of this stream.
+   * @param map The map. It is not changed.
+   * @param name The name of the file the map was parsed from.
+   */
+  void merge(const SimpleMap& map, const std::string& name);
+
   /**
    * Virtual redirection for operator>>(bool& value).
    */
@@ -1172,6 +1179,8 @@ public:
  * @class InMapFile
  *
  * A stream that reads data from a hierarchy of text files in config map format.
+ * Each file is only parsed once as long as it is not modified. The parsed maps
+ * are shared by all threads, e.g. all robots in the simulator.
  */
 class InMapFile : public InMap
 {
@@ -279,6 +279,62 @@ std::string OutFile::getFullName() const
   return stream->getFullName();
 }
 
+OutBlockFile::~OutBlockFile()
+{
+  if (stream != nullptr)
+  {
+    flush();
+    delete stream;
+  }
+}
+
+bool OutBlockFile::exists() const
+{
+  return stream != nullptr && stream->exists();
+}
+
+void OutBlockFile::open(const std::string& name, size_t blockSize, size_t reserveSize)
+{
+  stream = new File(name, "wb", false);
+  this->blockSize = blockSize;
+  this->reserveSize = reserveSize;
+  buffer.reserve(blockSize);
+}
+
+void OutBlockFile::flush()
+{
+  if (buffer.empty() || !exists())
+    return;
+
+  if (reserveSize && written + buffer.size() > reserved)
+  {
+    // if the file system does not support it, it is not tried again
+    if (stream->reserve(reserveSize))
+      reserved = written + reserveSize;
+    else
+      reserveSize = 0;
+  }
+  stream->write(buffer.data(), buffer.size());
+  written += buffer.size();
+  buffer.clear();
+}
+
+void OutBlockFile::writeToStream(const void* p, size_t size)
+{
+  if (buffer.size() + size > blockSize)
+    flush();
+  if (size >= blockSize)
+  {
+    if (exists())
+    {
+      stream->write(p, size);
+      written += size;
+    }
+  }
+  else
+    buffer.insert(buffer.end(), static_cast<const char*>(p), static_cast<const char*>(p) + size);
+}
+
 void OutMemory::writeToStream(const void* p, size_t size)
 {
   if (memory != nullptr)
@@ -685,6 +685,55 @@ protected:
   virtual void writeToStream(const void* p, size_t size);
 };
 
+/**
+ * @class OutBlockFile
+ *
+ * A PhysicalOutStream that writes the data to a file in large blocks. Space on the
+ * device can be reserved ahead of the data, so that writing does not wait for the
+ * file system to allocate it.
+ */
+class OutBlockFile : public PhysicalOutStream
+{
+private:
+  File* stream = nullptr; /**< Object representing the file. */
+  std::vector<char> buffer; /**< The data not written to the file yet. */
+  size_t blockSize = 0; /**< The data is written when this many bytes are buffered. */
+  size_t reserveSize = 0; /**< The space is reserved in steps of this size (0 = never). */
+  size_t written = 0; /**< The number of bytes written to the file. */
+  size_t reserved = 0; /**< The end of the space reserved. */
+
+public:
+  /** Destructor. Writes the remaining data. */
+  ~OutBlockFile();
+
+  /**
+   * The function states whether the file actually exists.
+   * @return Does the file exist?
+   */
+  bool exists() const;
+
+  /** Writes the data buffered to the file. */
+  void flush();
+
+protected:
+  /**
+   * Opens the stream.
+   * @param name The name of the file to open. It will be interpreted
+   *             as relative to the configuration directory. If it already
+   *             exists, its previous contents will be discared.
+   * @param blockSize The data is written when this many bytes are buffered.
+   * @param reserveSize The space is reserved in steps of this size (0 = never).
+   */
+  void open(const std::string& name, size_t blockSize, size_t reserveSize);
+
+  /**
+   * The function buffers a number of bytes and writes the buffer when it is full.
+   * @param p The address the data is located at.
+   * @param size The number of bytes to be written.
+   */
+  virtual void writeToStream(const void* p, size_t size);
+};
+
 /**
  * @class OutMemory
  *
@@ -798,6 +847,32 @@ public:
   virtual bool isBinary() const { return true; }
 };
 
+/**
+ * @class OutBinaryBlockFile
+ *
+ * A binary stream into a file that is written in large blocks.
+ */
+class OutBinaryBlockFile : public OutStream<OutBlockFile, OutBinary>
+{
+public:
+  /**
+   * Constructor.
+   * @param name The name of the file to open. It will be interpreted
+   *             as relative to the configuration directory. If the file
+   *             does not exist, it will be created. If it already
+   *             exists, its previous contents will be discared.
+   * @param blockSize The data is written when this many bytes are buffered.
+   * @param reserveSize The space on the device is reserved in steps of this size (0 = never).
+   */
+  OutBinaryBlockFile(const std::string& name, size_t blockSize, size_t reserveSize = 0) { open(name, blockSize, reserveSize); }
+
+  /**
+   * The function returns whether this is a binary stream.
+   * @return Does it output data in binary format?
+   */
+  virtual bool isBinary() const { return true; }
+};
+
 /**
  * @class OutBinaryMemory
  *
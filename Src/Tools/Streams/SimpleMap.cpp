@@ -42,6 +42,41 @@ SimpleMap::Array::~Array()
     delete *i;
 }
 
+SimpleMap::Value* SimpleMap::Record::clone() const
+{
+  Record* record = new Record;
+  for (const auto& [key, value] : *this)
+    (*record)[key] = value->clone();
+  return record;
+}
+
+void SimpleMap::Record::merge(const Record& that)
+{
+  for (const auto& [key, value] : that)
+  {
+    Value*& thisValue = (*this)[key];
+    Record* thisRecord = dynamic_cast<Record*>(thisValue);
+    const Record* thatRecord = dynamic_cast<const Record*>(value);
+    if (thisRecord && thatRecord)
+      thisRecord->merge(*thatRecord);
+    else
+    {
+      if (thisValue)
+        delete thisValue;
+      thisValue = value->clone();
+    }
+  }
+}
+
+SimpleMap::Value* SimpleMap::Array::clone() const
+{
+  Array* array = new Array;
+  array->reserve(size());
+  for (const Value* value : *this)
+    array->push_back(value->clone());
+  return array;
+}
+
 void SimpleMap::nextChar()
 {
   if (c || !stream->eof())
@@ -432,6 +467,23 @@ SimpleMap::SimpleMap(In& stream, const std::string& name) : stream(&stream), c(0
   parse(stream, name);
 }
 
+SimpleMap::SimpleMap() : stream(nullptr), c(0), row(1), column(0), root(0) {}
+
+void SimpleMap::merge(const SimpleMap& that)
+{
+  const Record* thatRecord = dynamic_cast<const Record*>(that.root);
+  if (!thatRecord) // parsing that map failed, so parsing it after this one would have failed, too
+  {
+    if (root)
+      delete root;
+    root = nullptr;
+  }
+  else if (!root)
+    root = thatRecord->clone();
+  else
+    static_cast<Record*>(root)->merge(*thatRecord);
+}
+
 SimpleMap::~SimpleMap()
 {
   if (root)
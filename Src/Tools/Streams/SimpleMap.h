@@ -39,6 +39,7 @@ public:
     virtual ~Value() = default;
     virtual bool operator==(const Value&) const = 0;
     inline bool operator!=(const Value& that) const { return !(*this == that); }
+    virtual Value* clone() const = 0; /**< Returns a deep copy. */
   };
 
   /** A class representing a literal. */
@@ -59,6 +60,7 @@ public:
 
     operator In&() const; /**< Returns a stream that can parse the literal. */
     virtual bool operator==(const Value&) const;
+    virtual Value* clone() const { return new Literal(literal); }
   };
 
   /** A class representing a record of attributes, i.e. a mapping of names to values. */
@@ -67,7 +69,15 @@ public:
   public:
     ~Record();
     virtual bool operator==(const Value&) const;
+    virtual Value* clone() const;
     Record& operator-=(const Record&);
+
+    /**
+     * Merges another record into this one the same way parsing it after this
+     * one would, i.e. records are merged and all other values are replaced.
+     * @param that The record merged into this one.
+     */
+    void merge(const Record& that);
   };
 
   /**< A class representing an array of values, i.e. a mapping of indices to values. */
@@ -76,6 +86,7 @@ public:
   public:
     ~Array();
     virtual bool operator==(const Value&) const;
+    virtual Value* clone() const;
   };
 
   /**
@@ -85,6 +96,11 @@ public:
    */
   SimpleMap(In& stream, const std::string& name = "");
 
+  /**
+   * Constructor. Creates a map without content that can be merged with others.
+   */
+  SimpleMap();
+
   /**
    * Destructor.
    */
@@ -103,6 +119,15 @@ public:
 
   SimpleMap& operator-=(const SimpleMap& that);
 
+  /**
+   * Merges another map into this one as if the stream of the other map was
+   * parsed after the streams of this map. This does not change the other map,
+   * so a parsed map can be shared by multiple threads and merged instead of
+   * parsing the same stream again.
+   * @param that The map merged into this one.
+   */
+  void merge(const SimpleMap& that);
+
 private:
   /** Lexicographical symbols. */
   ENUM(Symbol,
@@ -28,6 +28,13 @@ void StreamHandler::clear()
   specification.clear();
   enumSpecification.clear();
   stringTable.clear();
+  specificationChanged();
+}
+
+void StreamHandler::specificationChanged()
+{
+  resolvedTypes.clear();
+  serializedSpecificationValid = false;
 }
 
 void StreamHandler::startRegistration(const char* name, bool registerWithExternalOperator)
@@ -42,6 +49,7 @@ void StreamHandler::startRegistration(const char* name, bool registerWithExterna
     Specification::iterator registeringEntry = specification.find(name);
     if (registeringEntry == specification.end())
     {
+      specificationChanged();
       specification[name];
       RegisteringAttributes attr;
       attr.registering = true;
@@ -79,6 +87,28 @@ void StreamHandler::finishRegistration()
 
 Out& operator<<(Out& out, const StreamHandler& streamHandler)
 {
+  // Binary streams get a copy of the serialized specification, which only changes when types are registered.
+  if (out.isBinary() && !out.isCompressed())
+  {
+    if (!streamHandler.serializedSpecificationValid)
+    {
+      OutBinarySize size;
+      streamHandler.writeSpecification(size);
+      streamHandler.serializedSpecification.resize(size.getSize());
+      OutBinaryMemory memory(streamHandler.serializedSpecification.data());
+      streamHandler.writeSpecification(memory);
+      streamHandler.serializedSpecificationValid = true;
+    }
+    out.write(streamHandler.serializedSpecification.data(), streamHandler.serializedSpecification.size());
+  }
+  else
+    streamHandler.writeSpecification(out);
+  return out;
+}
+
+void StreamHandler::writeSpecification(Out& out) const
+{
+  const StreamHandler& streamHandler = *this;
   if (streamHandler.stringTable.empty())
   {
     // basic types
@@ -129,8 +159,6 @@ Out& operator<<(Out& out, const StreamHandler& streamHandler)
         out << *enumElementsIter;
     }
   }
-
-  return out;
 }
 
 StreamHandler& operator<<(StreamHandler& a, const StreamHandler& b)
@@ -138,6 +166,7 @@ StreamHandler& operator<<(StreamHandler& a, const StreamHandler& b)
   a.basicTypeSpecification.insert(b.basicTypeSpecification.begin(), b.basicTypeSpecification.end());
   a.specification.insert(b.specification.begin(), b.specification.end());
   a.enumSpecification.insert(b.enumSpecification.begin(), b.enumSpecification.end());
+  a.specificationChanged();
   return a;
 }
 
@@ -145,6 +174,7 @@ In& operator>>(In& in, StreamHandler& streamHandler)
 {
   // note: tables are not cleared, so all data read is appended!
   // However, clear() has to be called once before the first use of this operator
+  streamHandler.specificationChanged();
 
   std::string first, second;
 
@@ -227,8 +257,13 @@ void StreamHandler::registerWithSpecification(const char* name, const std::type_
 
 void StreamHandler::registerEnum(const std::type_info& ti, const char* (*fp)(int))
 {
+  // The enums of a type that is already registered were registered together with it.
+  if (!registering && !registeringEntryStack.empty())
+    return;
+
   if (enumSpecification.find(ti.name()) == enumSpecification.end())
   {
+    specificationChanged();
     enumSpecification[ti.name()];
     for (int i = 0; (*fp)(i); ++i)
       enumSpecification[ti.name()].push_back((*fp)(i));
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <stack>
 #include <typeinfo>
@@ -15,6 +16,7 @@ StreamHandler& operator<<(StreamHandler& a, const StreamHandler& b);
 class ConsoleRoboCupCtrl;
 class RobotConsole;
 class DebugDataStreamer;
+struct DebugDataType;
 class Framework;
 struct Settings;
 
@@ -43,6 +45,7 @@ private:
    */
   friend class Process;
   friend class SubThread;
+  friend class Logger; // for the compression threads
 
   struct RegisteringAttributes
   {
@@ -64,6 +67,10 @@ private:
   typedef std::unordered_map<std::string, int> StringTable;
   StringTable stringTable;
 
+  /** The types resolved by the DebugDataStreamer. They are discarded whenever the specification changes. */
+  typedef std::unordered_map<std::string, std::shared_ptr<const DebugDataType>> ResolvedTypes;
+  ResolvedTypes resolvedTypes;
+
   typedef std::pair<Specification::iterator, RegisteringAttributes> RegisteringEntry;
   typedef std::stack<RegisteringEntry> RegisteringEntryStack;
   RegisteringEntryStack registeringEntryStack;
@@ -71,8 +78,17 @@ private:
   bool registering;
   bool registeringBase;
 
+  mutable std::vector<char> serializedSpecification; /**< The specification as written to binary streams. */
+  mutable bool serializedSpecificationValid = false; /**< Does serializedSpecification match the current tables? */
+
   const char* getString(const std::string& string);
 
+  /** Must be called whenever the tables change to discard everything derived from them. */
+  void specificationChanged();
+
+  /** Writes the tables that make up the specification. */
+  void writeSpecification(Out& out) const;
+
 public:
   void clear();
   void startRegistration(const char* name, bool registerWithExternalOperator);
@@ -81,6 +97,12 @@ public:
   void registerWithSpecification(const char* name, const std::type_info& ti);
   void registerEnum(const std::type_info& ti, const char* (*fp)(int));
 
+  /**
+   * Is the type currently streamed registered for the first time?
+   * @return Does streaming its members still extend the specification?
+   */
+  bool isRegistering() const { return registering; }
+
   /**
    * Check whether the specifications of two types are structurally identical,
    * so that the first type could read the data written by the second type.
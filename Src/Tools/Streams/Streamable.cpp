@@ -44,6 +44,12 @@ namespace Streaming
     Global::getStreamHandler().startRegistration(ti.name(), registerWithExternalOperator);
   }
 
+  bool isRaw(const In* in, const Out* out)
+  {
+    const bool binary = in ? in->isBinary() && !in->isCompressed() : out->isBinary() && !out->isCompressed();
+    return binary && !Global::getStreamHandler().isRegistering();
+  }
+
   void registerBase()
   {
     Global::getStreamHandler().registerBase();
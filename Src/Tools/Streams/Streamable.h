@@ -14,6 +14,7 @@
 #include <array>
 #include <limits>
 #include <cmath>
+#include <type_traits>
 #include "InOut.h"
 
 #define STREAM_REGISTER_FINISH Streaming::finishRegistration();
@@ -404,6 +405,66 @@ namespace Streaming
     Streamer<S>::stream(in, out, name, s, enumToString);
   }
 
+  /**
+   * Can members of basic types be read or written directly, i.e. bypassing the
+   * virtual select/operator/deselect chain? This is the case for uncompressed
+   * binary streams, if the type currently streamed is already registered.
+   * Must be called after startRegistration().
+   * @param in The stream to read from or nullptr.
+   * @param out The stream to write to or nullptr.
+   * @return Can basic types be streamed directly?
+   */
+  bool isRaw(const In* in, const Out* out);
+
+  /**
+   * Does a type have the same memory layout as its binary stream representation?
+   * This is true for all arithmetic types except for bool, which is streamed
+   * as a char, and long, which is always streamed with 64 bits.
+   */
+  template <typename S> struct IsRaw
+  {
+    static constexpr bool value = std::is_arithmetic<S>::value && !std::is_same<S, bool>::value &&
+                                  !std::is_same<S, long>::value && !std::is_same<S, unsigned long>::value;
+  };
+
+  /**
+   * A version of streamIt for serialize methods that reads or writes basic types and enums
+   * directly if isRaw() allowed it. All other types are streamed through streamIt.
+   * @param raw The result of isRaw().
+   */
+  template <typename S> void streamRaw(In* in, Out* out, bool raw, const char* name, S& s, const char* (*enumToString)(int))
+  {
+    if constexpr (IsRaw<S>::value)
+    {
+      if (raw)
+      {
+        if (in)
+          in->read(&s, sizeof(s));
+        else
+          out->write(&s, sizeof(s));
+        return;
+      }
+    }
+    else if constexpr (std::is_enum<S>::value)
+    {
+      if (raw)
+      {
+        // Enums are streamed as unsigned char or int (see EnumOrClass).
+        using T = typename std::conditional<sizeof(S) == 1, unsigned char, int>::type;
+        T t = static_cast<T>(s);
+        if (in)
+        {
+          in->read(&t, sizeof(t));
+          s = static_cast<S>(t);
+        }
+        else
+          out->write(&t, sizeof(t));
+        return;
+      }
+    }
+    streamIt(in, out, name, s, enumToString);
+  }
+
   /** This is the version for using inside operator>>. */
   template <typename S> void streamIt(In& in, const char* name, S& s, const char* (*enumToString)(int) = 0)
   {
@@ -48,11 +48,11 @@ template <typename T> class TripleBuffer
 {
 
 public:
-  TripleBuffer<T>();
-  TripleBuffer<T>(const T& init);
+  TripleBuffer();
+  TripleBuffer(const T& init);
 
   // non-copyable behavior
-  TripleBuffer<T>(const TripleBuffer<T>&) = delete;
+  TripleBuffer(const TripleBuffer<T>&) = delete;
   TripleBuffer<T>& operator=(const TripleBuffer<T>&) = delete;
 
   const T& readBuffer() const; // get the current snap to read
@@ -0,0 +1,104 @@
+#include "Tools/Math/FastMath.h"
+#include "Tools/Math/Random.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using FastMath::Precision;
+
+template <Precision precision> static void testSinCos(float maxError)
+{
+  for (int i = 0; i < 10000; ++i)
+  {
+    const float x = randomFloat(-10.f * pi, 10.f * pi);
+    EXPECT_NEAR(FastMath::sin<precision>(x), std::sin(x), maxError);
+    EXPECT_NEAR(FastMath::cos<precision>(x), std::cos(x), maxError);
+
+    alignas(16) float sin[4], cos[4];
+    _mm_store_ps(sin, FastMath::sin<precision>(_mm_set1_ps(x)));
+    _mm_store_ps(cos, FastMath::cos<precision>(_mm_set1_ps(x)));
+    EXPECT_NEAR(sin[0], std::sin(x), maxError);
+    EXPECT_NEAR(cos[0], std::cos(x), maxError);
+  }
+}
+
+template <Precision precision> static void testAtan2(float maxError)
+{
+  for (int i = 0; i < 10000; ++i)
+  {
+    const float y = randomFloat(-1000.f, 1000.f);
+    const float x = randomFloat(-1000.f, 1000.f);
+    EXPECT_NEAR(FastMath::atan2<precision>(y, x), std::atan2(y, x), maxError);
+
+    alignas(16) float angles[4];
+    _mm_store_ps(angles, FastMath::atan2<precision>(_mm_set1_ps(y), _mm_set1_ps(x)));
+    EXPECT_NEAR(angles[0], std::atan2(y, x), maxError);
+  }
+  EXPECT_EQ(FastMath::atan2<precision>(0.f, 0.f), 0.f);
+  EXPECT_NEAR(FastMath::atan2<precision>(0.f, -1.f), pi, maxError);
+  EXPECT_NEAR(FastMath::atan2<precision>(1.f, 0.f), pi_2, maxError);
+  EXPECT_NEAR(FastMath::atan2<precision>(-1.f, 0.f), -pi_2, maxError);
+}
+
+template <Precision precision> static void testExp(float maxRelativeError)
+{
+  for (int i = 0; i < 10000; ++i)
+  {
+    const float x = randomFloat(-80.f, 80.f);
+    const float expected = std::exp(x);
+    EXPECT_NEAR(FastMath::exp<precision>(x), expected, expected * maxRelativeError);
+
+    alignas(16) float result[4];
+    _mm_store_ps(result, FastMath::exp<precision>(_mm_set1_ps(x)));
+    EXPECT_NEAR(result[0], expected, expected * maxRelativeError);
+  }
+}
+
+TEST(FastMath, sinCos)
+{
+  testSinCos<Precision::exact>(1e-6f);
+  testSinCos<Precision::high>(1e-4f);
+  testSinCos<Precision::low>(1e-2f);
+}
+
+TEST(FastMath, atan2)
+{
+  testAtan2<Precision::exact>(1e-6f);
+  testAtan2<Precision::high>(1e-4f);
+  testAtan2<Precision::low>(1e-2f);
+}
+
+TEST(FastMath, exp)
+{
+  testExp<Precision::exact>(1e-6f);
+  testExp<Precision::high>(1e-4f);
+  testExp<Precision::low>(1e-2f);
+}
+
+TEST(FastMath, batch)
+{
+  // sizes that are not multiples of 4 test the handling of the rest
+  std::vector<float> x(4 * 25 + 3), y(x.size()), result(x.size());
+  for (size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = randomFloat(-5.f, 5.f);
+    y[i] = randomFloat(-5.f, 5.f);
+  }
+
+  FastMath::sin(x, result);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_NEAR(result[i], std::sin(x[i]), 1e-4f);
+  FastMath::cos(x, result);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_NEAR(result[i], std::cos(x[i]), 1e-4f);
+  FastMath::exp(x, result);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_NEAR(result[i], std::exp(x[i]), std::exp(x[i]) * 1e-4f);
+  FastMath::sigmoid(x, result);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_NEAR(result[i], 1.f / (1.f + std::exp(-x[i])), 1e-4f);
+  FastMath::atan2(y, x, result);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_NEAR(result[i], std::atan2(y[i], x[i]), 1e-4f);
+}
@@ -0,0 +1,76 @@
+#include "Tools/Math/Random.h"
+
+#include "gtest/gtest.h"
+
+#include <numeric>
+#include <vector>
+
+TEST(Random, xoshiro128)
+{
+  // The reference implementation returns 11520, 0, 5927040 for the state {1, 2, 3, 4}.
+  // The state cannot be set directly, so only the properties of the sequence are checked.
+  RandomGenerator a(42), b(42), c(43);
+  for (int i = 0; i < 100; ++i)
+  {
+    const uint32_t value = a();
+    EXPECT_EQ(value, b());
+    EXPECT_NE(value, c());
+  }
+}
+
+TEST(Random, seed)
+{
+  Random::seed("1.2.Cognition");
+  std::vector<float> first(100);
+  Random::fillUniform(first.data(), first.size());
+  Random::seed("1.2.Cognition");
+  std::vector<float> second(100);
+  Random::fillUniform(second.data(), second.size());
+  EXPECT_EQ(first, second);
+
+  Random::seed("1.3.Cognition");
+  Random::fillUniform(second.data(), second.size());
+  EXPECT_NE(first, second);
+}
+
+TEST(Random, uniform)
+{
+  std::vector<float> values(100003);
+  Random::fillUniform(values.data(), values.size(), -2.f, 3.f);
+  for (float value : values)
+  {
+    EXPECT_GE(value, -2.f);
+    EXPECT_LT(value, 3.f);
+  }
+  const double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+  EXPECT_NEAR(mean, 0.5, 0.05);
+
+  for (int i = 0; i < 10000; ++i)
+  {
+    const float value = randomFloat(-2.f, 3.f);
+    EXPECT_GE(value, -2.f);
+    EXPECT_LT(value, 3.f);
+    EXPECT_LT(random(7), 7);
+  }
+}
+
+TEST(Random, normal)
+{
+  for (size_t size : {5, 8, 100003})
+  {
+    std::vector<float> values(size, std::numeric_limits<float>::quiet_NaN());
+    Random::fillNormal(values.data(), values.size(), 1.f, 2.f);
+    for (float value : values)
+      EXPECT_TRUE(std::isfinite(value));
+    if (size > 1000)
+    {
+      const double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+      double variance = 0.0;
+      for (float value : values)
+        variance += (value - mean) * (value - mean);
+      variance /= values.size();
+      EXPECT_NEAR(mean, 1.0, 0.05);
+      EXPECT_NEAR(std::sqrt(variance), 2.0, 0.05);
+    }
+  }
+}
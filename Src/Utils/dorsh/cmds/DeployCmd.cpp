@@ -2,6 +2,8 @@
 #include "Platform/File.h"
 #include <QString>
 #include <QColor>
+#include <QElapsedTimer>
+#include <QSemaphore>
 #include <QStringList>
 #include "Utils/dorsh/cmdlib/Context.h"
 #include "Utils/dorsh/cmdlib/Commands.h"
@@ -20,6 +22,8 @@
 
 DeployCmd DeployCmd::theDeployCmd;
 
+static QSemaphore deploySlots(DeployCmd::maxConcurrentDeploys);
+
 DeployCmd::DeployTask::DeployTask(Context& context, const QString& buildConfig, Team* team, RobotConfigDorsh* robot)
     : RobotTask(context, robot), buildConfig(buildConfig), team(team)
 {
@@ -68,16 +72,33 @@ bool DeployCmd::DeployTask::execute()
   args.push_back(QString("-nv"));
   args.push_back(QString::fromStdString(RobotConfigDorsh::getName(robot->naoVersion)));
 
+  QElapsedTimer timer;
+  timer.start();
+  if (!deploySlots.tryAcquire())
+  {
+    context().printLine("Waiting for another deploy to finish... (" + robot->name + ")");
+    while (!deploySlots.tryAcquire(1, 100))
+      if (context().isCanceled())
+        return false;
+  }
+  const qint64 waitTime = timer.elapsed();
+
   ProcessRunner r(context(), command, args);
   r.run();
+  deploySlots.release();
+
+  std::stringstream timing;
+  timing << std::fixed << std::setprecision(1) << static_cast<double>(timer.elapsed() - waitTime) / 1000.0 << " s";
+  if (waitTime >= 100)
+    timing << ", waited " << static_cast<double>(waitTime) / 1000.0 << " s";
   if (r.error())
   {
-    context().errorLine("Deploy of \"" + robot->name + "\" failed!");
+    context().errorLine("Deploy of \"" + robot->name + "\" failed! (" + timing.str() + ")");
     return false;
   }
   else
   {
-    context().printLine("Success! (" + robot->name + ")");
+    context().printLine("Success! (" + robot->name + ", " + timing.str() + ")");
     return true;
   }
 }
@@ -32,5 +32,11 @@ class DeployCmd : public RobotCommand
   static QString getCommand();
 
 public:
+  /**
+   * The number of robots that are deployed to at the same time. The others wait
+   * for a free slot, so the WLAN is not shared by too many transfers at once.
+   */
+  static constexpr int maxConcurrentDeploys = 4;
+
   static DeployCmd theDeployCmd;
 };
@@ -17,6 +17,7 @@
 #include "Utils/dorsh/Session.h"
 #include "Utils/dorsh/models/Team.h"
 #include "Utils/dorsh/models/Robot.h"
+#include "Utils/dorsh/tools/LogFileCheck.h"
 
 DownloadLogsCmd DownloadLogsCmd::theDownloadLogsCmd;
 
@@ -74,11 +75,30 @@ bool DownloadLogsCmd::DownloadLogsTask::execute()
   else
   {
     context().printLine("Success! (" + robot->name + ")");
+    checkLogFiles(r.getOutput());
   }
 
   return true;
 }
 
+void DownloadLogsCmd::DownloadLogsTask::checkLogFiles(const QString& output)
+{
+  const std::string directory = std::string(File::getBHDir()) + "/Config/Logs/" + robot->name + "/";
+  for (const QString& line : output.split('\n'))
+  {
+    const QString name = line.trimmed();
+    if (!name.startsWith("Downloaded ") || !name.endsWith(".log"))
+      continue;
+    const std::string filename = name.mid(11).toStdString();
+    std::string message;
+    const LogFileCheck::Result result = LogFileCheck::check(directory + filename, message);
+    if (result == LogFileCheck::broken)
+      context().errorLine(filename + " " + message + "! (" + robot->name + ")");
+    else
+      context().printLine(filename + " " + message + " (" + robot->name + ")");
+  }
+}
+
 DownloadLogsCmd::DownloadLogsTask::DownloadLogsTask(Context& context, RobotConfigDorsh* robot) : RobotTask(context, robot) {}
 
 QString DownloadLogsCmd::DownloadLogsTask::getCommand()
@@ -20,6 +20,13 @@ class DownloadLogsCmd : public RobotCommand
     DownloadLogsTask(Context& context, RobotConfigDorsh* robot);
     bool execute();
     QString getCommand();
+
+  private:
+    /**
+     * Checks the log files the download script reported as downloaded.
+     * @param output The output of the download script.
+     */
+    void checkLogFiles(const QString& output);
   };
 
 public:
@@ -0,0 +1,86 @@
+/**
+ * @file DownloadTracesCmd.cpp
+ *
+ * Implementation of a command that downloads the taskflow traces from the robot.
+ */
+
+#include "DownloadTracesCmd.h"
+#include "Platform/File.h"
+#include <QString>
+#include <QStringList>
+#include "Utils/dorsh/cmdlib/Context.h"
+#include "Utils/dorsh/cmdlib/Commands.h"
+#include "Utils/dorsh/cmdlib/ProcessRunner.h"
+#include "Utils/dorsh/tools/Platform.h"
+#include "Utils/dorsh/models/Robot.h"
+
+DownloadTracesCmd DownloadTracesCmd::theDownloadTracesCmd;
+
+DownloadTracesCmd::DownloadTracesCmd()
+{
+  Commands::getInstance().addCommand(this);
+}
+
+std::string DownloadTracesCmd::getName() const
+{
+  return "downloadTraces";
+}
+
+std::string DownloadTracesCmd::getDescription() const
+{
+  return "Downloads all taskflow traces (Chrome trace / Perfetto format) from the robot to Config/Traces. Afterwards the traces are deleted from the robot.";
+}
+
+bool DownloadTracesCmd::preExecution(Context& context, const std::vector<std::string>& params)
+{
+  if (params.size() > 0)
+  {
+    context.printLine("This command does not have any parameters!");
+    return false;
+  }
+  return true;
+}
+
+Task* DownloadTracesCmd::perRobotExecution(Context& context, RobotConfigDorsh& robot)
+{
+  return new DownloadTracesCmd::DownloadTracesTask(context, &robot);
+}
+
+bool DownloadTracesCmd::postExecution(Context& context, const std::vector<std::string>& params)
+{
+  return true;
+}
+
+bool DownloadTracesCmd::DownloadTracesTask::execute()
+{
+  QString command = getCommand();
+  QStringList args = QStringList();
+
+  args.push_back(QString::fromStdString(robot->name));
+  args.push_back(QString::fromStdString(robot->getBestIP(context())));
+
+  ProcessRunner r(context(), command, args);
+  r.run();
+
+  if (r.error())
+  {
+    context().errorLine("Download failed!");
+  }
+  else
+  {
+    context().printLine("Success! (" + robot->name + ")");
+  }
+
+  return true;
+}
+
+DownloadTracesCmd::DownloadTracesTask::DownloadTracesTask(Context& context, RobotConfigDorsh* robot) : RobotTask(context, robot) {}
+
+QString DownloadTracesCmd::DownloadTracesTask::getCommand()
+{
+#ifdef WINDOWS
+  return QString::fromStdString(std::string(File::getBHDir()) + "/Make/" + platformDirectory() + "/downloadTraces.cmd");
+#else
+  return QString::fromStdString(std::string(File::getBHDir()) + "/Make/" + platformDirectory() + "/downloadTraces");
+#endif
+}
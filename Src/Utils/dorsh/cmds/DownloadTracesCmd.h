@@ -0,0 +1,33 @@
+/**
+ * @file DownloadTracesCmd.h
+ *
+ * Declaration of a command that downloads the taskflow traces from the robot.
+ */
+
+#pragma once
+
+#include "Utils/dorsh/cmdlib/RobotCommand.h"
+/**
+ * Downloads the trace files written by the framework from the robot.
+ */
+class DownloadTracesCmd : public RobotCommand
+{
+  class DownloadTracesTask : public RobotTask
+  {
+  public:
+    DownloadTracesTask(Context& context, RobotConfigDorsh* robot);
+    bool execute();
+    QString getCommand();
+  };
+
+public:
+  DownloadTracesCmd();
+  virtual std::string getName() const;
+  virtual std::string getDescription() const;
+  virtual bool preExecution(Context& context, const std::vector<std::string>& params);
+  virtual Task* perRobotExecution(Context& context, RobotConfigDorsh& robot);
+  virtual bool postExecution(Context& context, const std::vector<std::string>& params);
+
+public:
+  static DownloadTracesCmd theDownloadTracesCmd;
+};
@@ -28,12 +28,11 @@ bool PushConfigCmd::PushConfigTask::execute()
   QString command = PushConfigCmd::getCommand();
 
   QStringList args = QStringList();
-  args.push_back(QString("-d")); //Arne 27.04.17 - delete Logs on every deploy
+  args.push_back(QString("-hr")); // only the changed configuration files are reloaded, the logs are kept
   //args.push_back(QString("-nr")); reachability check on every deploy
   args.push_back(QString("-sn"));
   args.push_back(buildConfig);
   args.push_back(QString::fromStdString(robot->getBestIP(context())));
-  args.push_back(QString("-r"));
   args.push_back(QString("-n"));
   args.push_back(QString::number(team->number));
   args.push_back(QString("-o"));
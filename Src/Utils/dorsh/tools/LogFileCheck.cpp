@@ -0,0 +1,126 @@
+#include "Utils/dorsh/tools/LogFileCheck.h"
+#include "Tools/MessageQueue/LogFileCompression.h"
+#include "Tools/MessageQueue/LogFileFormat.h"
+#include "Tools/MessageQueue/LogFileIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+  /** Checks whether a block starts like the output of the codec. */
+  bool isBlockStart(LogFileCompression::Codec codec, const unsigned char* data, size_t size)
+  {
+    unsigned magic = 0;
+    switch (codec)
+    {
+    case LogFileCompression::snappy:
+      // The uncompressed length as varint of at most 5 bytes
+      for (size_t i = 0; i < size && i < 5; ++i)
+        if (!(data[i] & 0x80))
+          return i > 0 || data[0] > 0;
+      return false;
+    case LogFileCompression::zstd:
+      std::memcpy(&magic, data, std::min(size, sizeof(magic)));
+      return magic == 0xfd2fb528;
+    case LogFileCompression::lz4:
+      std::memcpy(&magic, data, std::min(size, sizeof(magic)));
+      return magic == 0x184d2204;
+    default:
+      return false;
+    }
+  }
+}
+
+LogFileCheck::Result LogFileCheck::check(const std::string& filename, std::string& message)
+{
+  std::ifstream file(filename, std::ios::binary | std::ios::ate);
+  if (!file.is_open())
+  {
+    message = "cannot be opened";
+    return broken;
+  }
+  const auto fileSize = static_cast<unsigned long long>(file.tellg());
+
+  // | ... | size of last block | last block | 0 | index | size of index | magic |
+  unsigned trailer[2] = {0, 0};
+  if (fileSize < sizeof(trailer) || !file.seekg(fileSize - sizeof(trailer)) || !file.read(reinterpret_cast<char*>(trailer), sizeof(trailer)))
+  {
+    message = "is too short";
+    return broken;
+  }
+  if (trailer[1] != LogFileIndex::magic)
+  {
+    message = "has no block index, it is uncompressed or the logging was interrupted";
+    return unindexed;
+  }
+  const unsigned long long tailSize = trailer[0] + 3ull * sizeof(unsigned);
+  if (tailSize > fileSize)
+  {
+    message = "has a broken block index";
+    return broken;
+  }
+  std::vector<char> tail(static_cast<size_t>(tailSize));
+  LogFileIndex index;
+  if (!file.seekg(fileSize - tailSize) || !file.read(tail.data(), tail.size()) || !index.read(tail.data(), tail.size()) || index.blocks.empty())
+  {
+    message = "has a broken block index";
+    return broken;
+  }
+
+  // The blocks end where the end marker of the index begins.
+  const LogFileIndex::Block& lastBlock = index.blocks.back();
+  const unsigned long long blocksSize = lastBlock.offset + sizeof(unsigned) + lastBlock.compressedSize;
+  if (blocksSize + tailSize + 2 > fileSize)
+  {
+    message = "is shorter than its block index states";
+    return broken;
+  }
+  const unsigned long long firstBlock = fileSize - tailSize - blocksSize;
+
+  // The header ends with the marker of the codec.
+  unsigned char marker[2];
+  if (!file.seekg(firstBlock - 2) || !file.read(reinterpret_cast<char*>(marker), 2))
+  {
+    message = "cannot be read";
+    return broken;
+  }
+  LogFileCompression::Codec codec;
+  if (marker[0] == logFileCompressedWithCodec && (marker[1] == LogFileCompression::zstd || marker[1] == LogFileCompression::lz4))
+    codec = static_cast<LogFileCompression::Codec>(marker[1]);
+  else if (marker[1] == logFileCompressed)
+    codec = LogFileCompression::snappy;
+  else
+  {
+    message = "does not start its blocks where its block index states";
+    return broken;
+  }
+
+  unsigned long long expectedOffset = 0;
+  int numOfFrames = 0;
+  for (size_t i = 0; i < index.blocks.size(); ++i)
+  {
+    const LogFileIndex::Block& block = index.blocks[i];
+    unsigned char start[sizeof(unsigned) + 5];
+    unsigned size;
+    if (block.offset != expectedOffset || block.compressedSize < 5
+       || !file.seekg(firstBlock + block.offset) || !file.read(reinterpret_cast<char*>(start), sizeof(start)))
+    {
+      message = "has a gap before block " + std::to_string(i);
+      return broken;
+    }
+    std::memcpy(&size, start, sizeof(size));
+    if (size != block.compressedSize || !isBlockStart(codec, start + sizeof(unsigned), sizeof(start) - sizeof(unsigned)))
+    {
+      message = "has a broken block " + std::to_string(i) + " (frame " + std::to_string(block.firstFrame) + ")";
+      return broken;
+    }
+    expectedOffset = block.offset + sizeof(unsigned) + block.compressedSize;
+    numOfFrames += block.numberOfFrames;
+  }
+
+  message = "is intact (" + std::to_string(index.blocks.size()) + " " + LogFileCompression::getName(codec) + " blocks, "
+            + std::to_string(numOfFrames) + " frames)";
+  return intact;
+}
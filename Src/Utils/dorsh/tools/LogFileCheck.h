@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Checks the structure of downloaded log files without decompressing them, so
+ * broken files are reported right after the download and not when they are
+ * opened in the simulator.
+ */
+class LogFileCheck
+{
+public:
+  enum Result
+  {
+    intact,
+    unindexed, /**< There is no block index, so the file cannot be checked. */
+    broken
+  };
+
+  /**
+   * Checks a compressed log file using the block index the Logger appends.
+   * Each block is looked up at the offset the index states. Its size must match
+   * the index and it must start like a block of the codec used.
+   * @param filename The path of the log file.
+   * @param message Is set to a description of the result.
+   * @return The result of the check.
+   */
+  static Result check(const std::string& filename, std::string& message);
+};
@@ -21,9 +21,316 @@
 
 #include "naodevilsbase.h"
 
+#include <bit>
 #include <chrono>
+#include <string_view>
+#include <type_traits>
 #include <nlohmann/json.hpp>
 
+namespace
+{
+  /**
+   * Reads the msgpack messages of LoLA without building a json object. Only the types LoLA
+   * uses are supported. If anything else is found, the reader fails and the message has to
+   * be decoded by nlohmann::json instead.
+   */
+  class MsgPackReader
+  {
+  public:
+    MsgPackReader(const std::vector<uint8_t>& buffer) : pos(buffer.data()), end(buffer.data() + buffer.size()) {}
+
+    bool failed() const { return fail; }
+
+    size_t readMapSize()
+    {
+      const uint8_t type = readByte();
+      if ((type & 0xf0) == 0x80)
+        return type & 0x0f;
+      else if (type == 0xde)
+        return readBigEndian<uint16_t>();
+      else if (type == 0xdf)
+        return readBigEndian<uint32_t>();
+      fail = true;
+      return 0;
+    }
+
+    size_t readArraySize()
+    {
+      const uint8_t type = readByte();
+      if ((type & 0xf0) == 0x90)
+        return type & 0x0f;
+      else if (type == 0xdc)
+        return readBigEndian<uint16_t>();
+      else if (type == 0xdd)
+        return readBigEndian<uint32_t>();
+      fail = true;
+      return 0;
+    }
+
+    std::string_view readString()
+    {
+      const uint8_t type = readByte();
+      size_t size = 0;
+      if ((type & 0xe0) == 0xa0)
+        size = type & 0x1f;
+      else if (type == 0xd9)
+        size = readByte();
+      else if (type == 0xda)
+        size = readBigEndian<uint16_t>();
+      else if (type == 0xdb)
+        size = readBigEndian<uint32_t>();
+      else
+        fail = true;
+      if (fail || static_cast<size_t>(end - pos) < size)
+      {
+        fail = true;
+        return {};
+      }
+      const std::string_view string(reinterpret_cast<const char*>(pos), size);
+      pos += size;
+      return string;
+    }
+
+    template <typename T> T readNumber()
+    {
+      const uint8_t type = readByte();
+      if (type < 0x80 || type >= 0xe0)
+        return static_cast<T>(static_cast<int8_t>(type));
+      switch (type)
+      {
+      case 0xc2:
+        return T(0);
+      case 0xc3:
+        return T(1);
+      case 0xca:
+        return static_cast<T>(std::bit_cast<float>(readBigEndian<uint32_t>()));
+      case 0xcb:
+        return static_cast<T>(std::bit_cast<double>(readBigEndian<uint64_t>()));
+      case 0xcc:
+        return static_cast<T>(readByte());
+      case 0xcd:
+        return static_cast<T>(readBigEndian<uint16_t>());
+      case 0xce:
+        return static_cast<T>(readBigEndian<uint32_t>());
+      case 0xcf:
+        return static_cast<T>(readBigEndian<uint64_t>());
+      case 0xd0:
+        return static_cast<T>(static_cast<int8_t>(readByte()));
+      case 0xd1:
+        return static_cast<T>(static_cast<int16_t>(readBigEndian<uint16_t>()));
+      case 0xd2:
+        return static_cast<T>(static_cast<int32_t>(readBigEndian<uint32_t>()));
+      case 0xd3:
+        return static_cast<T>(static_cast<int64_t>(readBigEndian<uint64_t>()));
+      default:
+        fail = true;
+        return T(0);
+      }
+    }
+
+    /** Reads an array that must have exactly the size of the target. */
+    template <typename T, size_t n> void readArray(std::array<T, n>& array)
+    {
+      if (readArraySize() != n)
+        fail = true;
+      for (size_t i = 0; i < n && !fail; ++i)
+        array[i] = readNumber<T>();
+    }
+
+    /** Skips an array of numbers and strings, e.g. the RobotConfig. */
+    void skipArray()
+    {
+      for (size_t i = readArraySize(); i > 0 && !fail; --i)
+        if (pos < end && (((*pos & 0xe0) == 0xa0) || (*pos >= 0xd9 && *pos <= 0xdb)))
+          readString();
+        else
+          readNumber<float>();
+    }
+
+  private:
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool fail = false;
+
+    uint8_t readByte()
+    {
+      if (pos == end)
+      {
+        fail = true;
+        return 0;
+      }
+      return *pos++;
+    }
+
+    template <typename T> T readBigEndian()
+    {
+      T value = 0;
+      for (size_t i = 0; i < sizeof(T); ++i)
+        value = static_cast<T>((value << 8) | readByte());
+      return value;
+    }
+  };
+
+  /** Writes the msgpack messages for LoLA directly into a buffer. */
+  class MsgPackWriter
+  {
+  public:
+    MsgPackWriter(std::vector<uint8_t>& buffer) : buffer(buffer) { buffer.clear(); }
+
+    void writeMapSize(size_t size)
+    {
+      if (size < 16)
+        buffer.push_back(static_cast<uint8_t>(0x80 | size));
+      else
+      {
+        buffer.push_back(0xde);
+        writeBigEndian(static_cast<uint16_t>(size));
+      }
+    }
+
+    void writeString(std::string_view string)
+    {
+      buffer.push_back(static_cast<uint8_t>(0xa0 | string.size())); // all keys are shorter than 32 characters
+      buffer.insert(buffer.end(), string.begin(), string.end());
+    }
+
+    /** @return The offset of the first value in the buffer. */
+    template <typename T> size_t writeArray(std::string_view key, const T* values, size_t size)
+    {
+      writeString(key);
+      if (size < 16)
+        buffer.push_back(static_cast<uint8_t>(0x90 | size));
+      else
+      {
+        buffer.push_back(0xdc);
+        writeBigEndian(static_cast<uint16_t>(size));
+      }
+      const size_t offset = buffer.size();
+      for (size_t i = 0; i < size; ++i)
+        if constexpr (std::is_same_v<T, bool>)
+          buffer.push_back(values[i] ? 0xc3 : 0xc2);
+        else
+        {
+          buffer.push_back(0xca);
+          writeBigEndian(std::bit_cast<uint32_t>(static_cast<float>(values[i])));
+        }
+      return offset;
+    }
+
+  private:
+    std::vector<uint8_t>& buffer;
+
+    template <typename T> void writeBigEndian(T value)
+    {
+      for (size_t i = sizeof(T); i > 0; --i)
+        buffer.push_back(static_cast<uint8_t>(value >> (8 * (i - 1))));
+    }
+  };
+
+  /**
+   * The msgpack message of the actuator request for LoLA. Since all arrays have a fixed
+   * size, the layout of the message never changes. It is encoded once and afterwards
+   * only the values are overwritten in place. The LEDs and sonars usually stay the same
+   * for many frames, so they are only overwritten if they changed.
+   */
+  class ActuatorPacket
+  {
+  public:
+    ActuatorPacket()
+    {
+      static constexpr size_t lEyeSize = NDData::ActuatorData().lEyeLEDs.size() * NDData::ActuatorData().lEyeLEDs[0].size();
+      static constexpr size_t rEyeSize = NDData::ActuatorData().rEyeLEDs.size() * NDData::ActuatorData().rEyeLEDs[0].size();
+
+      // same content and order as the former nlohmann::json::to_msgpack, but without building a json object
+      MsgPackWriter writer(buffer);
+      writer.writeMapSize(11);
+      chestOffset = writer.writeArray("Chest", encoded.chestLEDs.data(), encoded.chestLEDs.size());
+      lEarOffset = writer.writeArray("LEar", encoded.lEarLEDs.data(), encoded.lEarLEDs.size());
+      lEyeOffset = writer.writeArray("LEye", encoded.lEyeLEDs[0].data(), lEyeSize); // 1d array needed
+      lFootOffset = writer.writeArray("LFoot", encoded.lFootLEDs.data(), encoded.lFootLEDs.size());
+      positionOffset = writer.writeArray("Position", encoded.positions.data(), encoded.positions.size());
+      rEarOffset = writer.writeArray("REar", encoded.rEarLEDs.data(), encoded.rEarLEDs.size());
+      rEyeOffset = writer.writeArray("REye", encoded.rEyeLEDs[0].data(), rEyeSize); // 1d array needed
+      rFootOffset = writer.writeArray("RFoot", encoded.rFootLEDs.data(), encoded.rFootLEDs.size());
+      skullOffset = writer.writeArray("Skull", encoded.skullLEDs.data(), encoded.skullLEDs.size());
+      sonarOffset = writer.writeArray("Sonar", encoded.sonars.data(), encoded.sonars.size());
+      stiffnessOffset = writer.writeArray("Stiffness", encoded.stiffness.data(), encoded.stiffness.size());
+    }
+
+    /**
+     * Overwrites the values of the message with the given actuator data.
+     * @return The encoded message.
+     */
+    const std::vector<uint8_t>& pack(const NDData::ActuatorData& actuatordata)
+    {
+      patch(positionOffset, actuatordata.positions.data(), actuatordata.positions.size());
+      patch(stiffnessOffset, actuatordata.stiffness.data(), actuatordata.stiffness.size());
+      patchIfChanged(chestOffset, actuatordata.chestLEDs, encoded.chestLEDs);
+      patchIfChanged(lEarOffset, actuatordata.lEarLEDs, encoded.lEarLEDs);
+      patchIfChanged(lEyeOffset, actuatordata.lEyeLEDs, encoded.lEyeLEDs);
+      patchIfChanged(lFootOffset, actuatordata.lFootLEDs, encoded.lFootLEDs);
+      patchIfChanged(rEarOffset, actuatordata.rEarLEDs, encoded.rEarLEDs);
+      patchIfChanged(rEyeOffset, actuatordata.rEyeLEDs, encoded.rEyeLEDs);
+      patchIfChanged(rFootOffset, actuatordata.rFootLEDs, encoded.rFootLEDs);
+      patchIfChanged(skullOffset, actuatordata.skullLEDs, encoded.skullLEDs);
+      patchIfChanged(sonarOffset, actuatordata.sonars, encoded.sonars);
+      return buffer;
+    }
+
+  private:
+    std::vector<uint8_t> buffer;
+    NDData::ActuatorData encoded{}; /**< The LEDs and sonars currently encoded in the buffer. */
+    size_t chestOffset;
+    size_t lEarOffset;
+    size_t lEyeOffset;
+    size_t lFootOffset;
+    size_t positionOffset;
+    size_t rEarOffset;
+    size_t rEyeOffset;
+    size_t rFootOffset;
+    size_t skullOffset;
+    size_t sonarOffset;
+    size_t stiffnessOffset;
+
+    /** Overwrites the values of an array, which the constructor already encoded with their types. */
+    template <typename T> void patch(size_t offset, const T* values, size_t size)
+    {
+      uint8_t* p = buffer.data() + offset;
+      for (size_t i = 0; i < size; ++i)
+        if constexpr (std::is_same_v<T, bool>)
+          *p++ = values[i] ? 0xc3 : 0xc2;
+        else
+        {
+          const uint32_t bits = std::bit_cast<uint32_t>(static_cast<float>(values[i]));
+          p[1] = static_cast<uint8_t>(bits >> 24);
+          p[2] = static_cast<uint8_t>(bits >> 16);
+          p[3] = static_cast<uint8_t>(bits >> 8);
+          p[4] = static_cast<uint8_t>(bits);
+          p += 5; // skip the type 0xca
+        }
+    }
+
+    /**
+     * Overwrites the values of an array if they differ from the ones encoded. The bits
+     * are compared, so -0 and NaN are encoded correctly as well.
+     */
+    template <typename T> void patchIfChanged(size_t offset, const T& values, T& encodedValues)
+    {
+      static_assert(std::is_trivially_copyable_v<T>);
+      if (std::memcmp(&values, &encodedValues, sizeof(T)) != 0)
+      {
+        encodedValues = values;
+        using Value = std::remove_cv_t<std::remove_reference_t<decltype(*flat(values))>>;
+        patch(offset, flat(values), sizeof(T) / sizeof(Value));
+      }
+    }
+
+    /** @return The first value of an array that may have two dimensions. */
+    template <typename T, size_t n> static const T* flat(const std::array<T, n>& values) { return values.data(); }
+    template <typename T, size_t n, size_t m> static const T* flat(const std::array<std::array<T, m>, n>& values) { return values[0].data(); }
+  };
+} // namespace
+
 
 /*
   @class NDevils
@@ -55,9 +362,10 @@ private:
   void unpack_data(const std::vector<uint8_t>& buffer, NDData::SensorData& sensordata);
 
   /**
-   * Packs request data into msgpack encoded buffer.
+   * Decodes the sensor data of the msgpack buffer without nlohmann::json.
+   * @return Did the buffer only contain what LoLA usually sends?
    */
-  void pack_data(const NDData::ActuatorData& actuatordata, std::vector<uint8_t>& buffer);
+  static bool decode_sensor_data(const std::vector<uint8_t>& buffer, NDData::SensorData& sensordata);
 
   void processSensorData(const NDData::SensorData& sensordata);
   void processActuatorData(NDData::ActuatorData& actuatordata);
@@ -95,6 +403,7 @@ private:
 
   const NDData::SensorData* lastSensorData = nullptr;
   const NDData::ActuatorData* lastActuatorData = nullptr;
+  ActuatorPacket actuatorPacket; /**< The message sent to LoLA, which is patched in each frame. */
 
   NDData::SteadyTimePoint ndevilsbaseStartTime;
   float blink = 0.f;
@@ -326,7 +635,7 @@ int NDevils::main()
     }
   }
 
-  std::vector<uint8_t> recvbuffer, sendbuffer;
+  std::vector<uint8_t> recvbuffer;
   recvbuffer.resize(lola_sensor_size);
 
   auto start = std::chrono::steady_clock::now();
@@ -344,6 +653,7 @@ int NDevils::main()
   {
     // this call blocks until LoLA provides new data
     ssize_t size = recv(fd, recvbuffer.data(), recvbuffer.size(), 0);
+    const NDData::SteadyTimePoint receiveTime = std::chrono::steady_clock::now();
     auto nextDeadline = std::chrono::system_clock::now() + cycle_time - time_before_deadline;
     checkTiming("LoLA: receiving sensor data", cycle_time.count());
 
@@ -359,6 +669,7 @@ int NDevils::main()
     lastSensorData = &data->sensors.writeBuffer();
     data->sensors.finishWrite();
     postFramework();
+    data->sensorHistory.push(*lastSensorData, receiveTime);
     processSensorData(*lastSensorData);
     checkTiming("Base: processing sensor data", 0);
 
@@ -371,7 +682,7 @@ int NDevils::main()
     lastActuatorData = &data->actuators.readBuffer();
     NDData::ActuatorData actuatordata = data->actuators.readBuffer(); // make copy for modifications
     processActuatorData(actuatordata);
-    pack_data(actuatordata, sendbuffer);
+    const std::vector<uint8_t>& sendbuffer = actuatorPacket.pack(actuatordata);
     checkTiming("Base: processing actuator data", 0);
 
     send(fd, sendbuffer.data(), sendbuffer.size(), 0);
@@ -403,12 +714,11 @@ void NDevils::unpack_data(const std::vector<uint8_t>& buffer, NDData::SensorData
 {
   sensordata.timestamp = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - ndevilsbaseStartTime).count());
 
-  nlohmann::json json = nlohmann::json::from_msgpack(buffer);
-
   if (lastSensorTimestamp == -1)
   {
     std::cout << "LoLA: received first package!" << std::endl;
 
+    nlohmann::json json = nlohmann::json::from_msgpack(buffer);
     strncpy(data->bodyId, json["RobotConfig"][0].get<std::string>().c_str(), 21);
     strncpy(data->headId, json["RobotConfig"][2].get<std::string>().c_str(), 21);
 
@@ -423,18 +733,23 @@ void NDevils::unpack_data(const std::vector<uint8_t>& buffer, NDData::SensorData
   }
   lastSensorTimestamp = sensordata.timestamp;
 
-  sensordata.acc = json["Accelerometer"];
-  sensordata.angle = json["Angles"];
-  sensordata.battery = json["Battery"];
-  sensordata.current = json["Current"];
-  sensordata.fsr = json["FSR"];
-  sensordata.gyro = json["Gyroscope"];
-  sensordata.position = json["Position"];
-  sensordata.sonar = json["Sonar"];
-  sensordata.status = json["Status"];
-  sensordata.stiffness = json["Stiffness"];
-  sensordata.temperature = json["Temperature"];
-  sensordata.touch = json["Touch"];
+  if (!decode_sensor_data(buffer, sensordata))
+  {
+    nlohmann::json json = nlohmann::json::from_msgpack(buffer);
+
+    sensordata.acc = json["Accelerometer"];
+    sensordata.angle = json["Angles"];
+    sensordata.battery = json["Battery"];
+    sensordata.current = json["Current"];
+    sensordata.fsr = json["FSR"];
+    sensordata.gyro = json["Gyroscope"];
+    sensordata.position = json["Position"];
+    sensordata.sonar = json["Sonar"];
+    sensordata.status = json["Status"];
+    sensordata.stiffness = json["Stiffness"];
+    sensordata.temperature = json["Temperature"];
+    sensordata.touch = json["Touch"];
+  }
 
 
   // If lying on front, ignore chest button data. This prevents presses due to ground contact.
@@ -446,6 +761,47 @@ void NDevils::unpack_data(const std::vector<uint8_t>& buffer, NDData::SensorData
     sensordata.touch[NDData::Touch::chestButton] = 0.f;
 }
 
+bool NDevils::decode_sensor_data(const std::vector<uint8_t>& buffer, NDData::SensorData& sensordata)
+{
+  MsgPackReader reader(buffer);
+  unsigned found = 0;
+  for (size_t i = reader.readMapSize(); i > 0 && !reader.failed(); --i)
+  {
+    const std::string_view key = reader.readString();
+    if (key == "Accelerometer")
+      reader.readArray(sensordata.acc);
+    else if (key == "Angles")
+      reader.readArray(sensordata.angle);
+    else if (key == "Battery")
+      reader.readArray(sensordata.battery);
+    else if (key == "Current")
+      reader.readArray(sensordata.current);
+    else if (key == "FSR")
+      reader.readArray(sensordata.fsr);
+    else if (key == "Gyroscope")
+      reader.readArray(sensordata.gyro);
+    else if (key == "Position")
+      reader.readArray(sensordata.position);
+    else if (key == "Sonar")
+      reader.readArray(sensordata.sonar);
+    else if (key == "Status")
+      reader.readArray(sensordata.status);
+    else if (key == "Stiffness")
+      reader.readArray(sensordata.stiffness);
+    else if (key == "Temperature")
+      reader.readArray(sensordata.temperature);
+    else if (key == "Touch")
+      reader.readArray(sensordata.touch);
+    else
+    {
+      reader.skipArray();
+      continue;
+    }
+    ++found;
+  }
+  return !reader.failed() && found == 12;
+}
+
 void NDevils::processSensorData(const NDData::SensorData& sensordata)
 {
   const bool chestButtonPressed = sensordata.touch[NDData::Touch::chestButton] == 1.f;
@@ -528,28 +884,6 @@ void NDevils::waitFramework(std::chrono::system_clock::time_point deadline)
   }
 }
 
-void NDevils::pack_data(const NDData::ActuatorData& actuatordata, std::vector<uint8_t>& buffer)
-{
-  nlohmann::json json;
-
-  static constexpr size_t lEyeSize = NDData::ActuatorData().lEyeLEDs.size() * NDData::ActuatorData().lEyeLEDs[0].size();
-  static constexpr size_t rEyeSize = NDData::ActuatorData().rEyeLEDs.size() * NDData::ActuatorData().rEyeLEDs[0].size();
-
-  json["Chest"] = actuatordata.chestLEDs;
-  json["LEar"] = actuatordata.lEarLEDs;
-  json["LEye"] = reinterpret_cast<const std::array<float, lEyeSize>&>(actuatordata.lEyeLEDs); // 1d array needed
-  json["LFoot"] = actuatordata.lFootLEDs;
-  json["Position"] = actuatordata.positions;
-  json["REar"] = actuatordata.rEarLEDs;
-  json["REye"] = reinterpret_cast<const std::array<float, rEyeSize>&>(actuatordata.rEyeLEDs); // 1d array needed
-  json["RFoot"] = actuatordata.rFootLEDs;
-  json["Skull"] = actuatordata.skullLEDs;
-  json["Stiffness"] = actuatordata.stiffness;
-  json["Sonar"] = actuatordata.sonars;
-
-  buffer = nlohmann::json::to_msgpack(json);
-}
-
 void NDevils::processActuatorData(NDData::ActuatorData& actuatordata)
 {
   // set blink float for synchronous LED blinking :-)
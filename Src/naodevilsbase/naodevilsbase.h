@@ -8,6 +8,7 @@
 
 #include <chrono>
 #include <array>
+#include <cstdint>
 #include "../Tools/TripleBuffer.h"
 
 struct NDData
@@ -223,6 +224,73 @@ struct NDData
     std::array<bool, numOfSonars> sonars;
   };
 
+  /**
+   * The sensor data of the last frames of LoLA. naodevilsbase is the only writer. Readers
+   * keep track of the frames they already read themselves, so any number of them can read
+   * the history while only having read access to the shared memory. Each slot is protected
+   * by a sequence lock: its sequence number is odd while the frame is written.
+   */
+  class SensorHistory
+  {
+  public:
+    static constexpr uint32_t size = 256; /**< The number of frames kept, i.e. about 3 s. */
+
+    struct Frame
+    {
+      uint32_t number; /**< The number of the frame since naodevilsbase started. */
+      int64_t receiveTime; /**< The steady clock time when the frame was received from LoLA in µs. */
+      SensorData data;
+    };
+
+    /** @return The number of the next frame that will be written. */
+    uint32_t getHead() const { return head.load(std::memory_order_acquire); }
+
+    /**
+     * Adds a frame. Must only be called by naodevilsbase.
+     * @param data The sensor data of the frame.
+     * @param receiveTime When the frame was received from LoLA.
+     */
+    void push(const SensorData& data, SteadyTimePoint receiveTime)
+    {
+      const uint32_t number = head.load(std::memory_order_relaxed);
+      Slot& slot = slots[number % size];
+      slot.sequence.store(2 * number + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      slot.frame.number = number;
+      slot.frame.receiveTime = std::chrono::duration_cast<std::chrono::microseconds>(receiveTime.time_since_epoch()).count();
+      slot.frame.data = data;
+      slot.sequence.store(2 * number + 2, std::memory_order_release);
+      head.store(number + 1, std::memory_order_release);
+    }
+
+    /**
+     * Copies a frame.
+     * @param number The number of the frame.
+     * @param frame The frame that is filled.
+     * @return False if the frame was not written yet or was already overwritten.
+     */
+    bool read(uint32_t number, Frame& frame) const
+    {
+      const Slot& slot = slots[number % size];
+      const uint32_t expected = 2 * number + 2;
+      if (slot.sequence.load(std::memory_order_acquire) != expected)
+        return false;
+      frame = slot.frame;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return slot.sequence.load(std::memory_order_relaxed) == expected;
+    }
+
+  private:
+    struct Slot
+    {
+      std::atomic<uint32_t> sequence;
+      Frame frame;
+    };
+
+    std::atomic<uint32_t> head; /**< The number of the next frame written. */
+    std::array<Slot, size> slots;
+  };
+
   static constexpr const char* sem_name_sensors = "/ndevils_sem_sensors";
   static constexpr const char* sem_name_actuators = "/ndevils_sem_actuators";
   static constexpr const char* mem_name = "/ndevils_mem";
@@ -231,6 +299,7 @@ struct NDData
   char headId[21]; /* RobotConfig/Head/FullHeadId */
   TripleBuffer<SensorData> sensors; /* Triple buffer for sensor data from LoLA. */
   TripleBuffer<ActuatorData> actuators; /* Triple buffer for actuator data to LoLA. */
+  SensorHistory sensorHistory; /* The sensor data of the last frames from LoLA. */
 
   State state;
   SteadyTimePoint ndevilsStartTime;
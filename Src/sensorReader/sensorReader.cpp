@@ -7,7 +7,9 @@
 
 #include "stdlib.h"
 
+#include <algorithm>
 #include <csignal>
+#include <cstring>
 #include <fcntl.h>
 #include <fstream>
 #include <map>
@@ -67,42 +69,37 @@ int SensorReader::main()
 
   while (!shutdown)
   {
-    nlohmann::json j = getJson();
-
-    std::array<char, 1024> name{0};
-    gethostname(name.data(), name.size());
-    j["name"] = std::string(name.data());
-
-    const std::regex regex("State: .+\\((.+)\\)");
-    const std::string output = runCommand("/usr/bin/networkctl status wlan0 -n 0");
-
-    if (std::smatch match; std::regex_search(output, match, regex) && match.size() == 2)
-      j["wifi_state"] = match[1].str();
-
-    const std::vector<uint8_t> data = nlohmann::json::to_msgpack(j);
-
-    // for debug
-    //std::cout << j.dump(4) << std::endl;
-
-    socket.setTarget("10.1.255.255", 55555);
-    if (socket.write(reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size())))
-      std::cout << "LAN package sent" << std::endl;
-
+    using namespace std::chrono_literals;
     const auto now = std::chrono::steady_clock::now();
 
-    // check dorsh package
+    // check dorsh and sensor monitor packages
     {
       static constexpr std::string_view expBuf = "sendData";
-      std::array<char, expBuf.size()> buf;
+      static constexpr std::string_view sensorBuf = "sendSensors";
+      std::array<char, sensorBuf.size()> buf;
       unsigned int ip;
-      while (socket.read(buf.data(), buf.size(), ip) == buf.size())
+      int size;
+      while ((size = socket.read(buf.data(), buf.size(), ip)) > 0)
       {
-        if ((ip & 0xFFFF0000) == 0x0A000000 // ip == 10.0.*.*
-            && strncmp(buf.data(), expBuf.data(), expBuf.size()) == 0)
+        if ((ip & 0xFFFF0000) != 0x0A000000) // ip != 10.0.*.*
+          continue;
+        const std::string_view received(buf.data(), size);
+        if (received == expBuf)
         {
           std::cout << "Dorsh package received" << std::endl;
           wlanRequest = now;
         }
+        else if (received == sensorBuf)
+        {
+          if (now - sensorRequest >= 15s || ip != sensorTarget)
+          {
+            std::cout << "Sensor request received" << std::endl;
+            // start with the frames that are still in the history
+            nextSensorFrame = std::max(dataV6->sensorHistory.getHead(), NDData::SensorHistory::size) - NDData::SensorHistory::size;
+            sensorTarget = ip;
+          }
+          sensorRequest = now;
+        }
       }
     }
 
@@ -120,15 +117,43 @@ int SensorReader::main()
       }
     }
 
-    using namespace std::chrono_literals;
-    if (now - wlanRequest < 15s && now - gcData > 1min)
+    if (now - lastStatus >= 5s)
     {
-      socket.setTarget("10.0.255.255", 55555);
+      lastStatus = now;
+
+      nlohmann::json j = getJson();
+
+      std::array<char, 1024> name{0};
+      gethostname(name.data(), name.size());
+      j["name"] = std::string(name.data());
+
+      const std::regex regex("State: .+\\((.+)\\)");
+      const std::string output = runCommand("/usr/bin/networkctl status wlan0 -n 0");
+
+      if (std::smatch match; std::regex_search(output, match, regex) && match.size() == 2)
+        j["wifi_state"] = match[1].str();
+
+      const std::vector<uint8_t> data = nlohmann::json::to_msgpack(j);
+
+      // for debug
+      //std::cout << j.dump(4) << std::endl;
+
+      socket.setTarget("10.1.255.255", 55555);
       if (socket.write(reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size())))
-        std::cout << "WLAN package sent" << std::endl;
+        std::cout << "LAN package sent" << std::endl;
+
+      if (now - wlanRequest < 15s && now - gcData > 1min)
+      {
+        socket.setTarget("10.0.255.255", 55555);
+        if (socket.write(reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size())))
+          std::cout << "WLAN package sent" << std::endl;
+      }
     }
 
-    sleep(5);
+    if (sensorTarget && now - sensorRequest < 15s)
+      sendSensorFrames();
+
+    usleep(100000);
   }
 
   cleanUp();
@@ -195,6 +220,38 @@ void SensorReader::cleanUp()
     munmap(const_cast<void*>(reinterpret_cast<const void*>(dataV6)), sizeof(NDData));
 }
 
+void SensorReader::sendSensorFrames()
+{
+  const NDData::SensorHistory& history = dataV6->sensorHistory;
+  const uint32_t head = history.getHead();
+
+  // frames that were already overwritten are skipped
+  if (head - nextSensorFrame > NDData::SensorHistory::size)
+    nextSensorFrame = head - NDData::SensorHistory::size;
+
+  in_addr address;
+  address.s_addr = htonl(sensorTarget);
+  socket.setTarget(inet_ntoa(address), sensorPort);
+
+  NDData::SensorHistory::Frame frame;
+  sensorPacket.resize(sizeof(SensorPacketHeader) + maxFramesPerPacket * sizeof(frame));
+  while (nextSensorFrame != head)
+  {
+    SensorPacketHeader header;
+    header.frameSize = sizeof(frame);
+    header.count = 0;
+    for (; nextSensorFrame != head && header.count < maxFramesPerPacket; ++nextSensorFrame)
+      if (history.read(nextSensorFrame, frame))
+        std::memcpy(sensorPacket.data() + sizeof(header) + header.count++ * sizeof(frame), &frame, sizeof(frame));
+
+    if (header.count > 0)
+    {
+      std::memcpy(sensorPacket.data(), &header, sizeof(header));
+      socket.write(sensorPacket.data(), static_cast<int>(sizeof(header) + header.count * sizeof(frame)));
+    }
+  }
+}
+
 nlohmann::json SensorReader::getJson() const
 {
   // We have to read the write buffer here. Otherwise, when the framework is stopped,
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <map>
+#include <vector>
 #include <sys/mman.h>
 #include <nlohmann/json_fwd.hpp>
 #include <chrono>
@@ -20,7 +23,22 @@ public:
   int main();
   void cleanUp();
 
+  /**
+   * The header of a packet of sensor frames. It is followed by count frames of the type
+   * NDData::SensorHistory::Frame in the byte order of the robot. Frames that were lost
+   * can be detected by gaps in their numbers.
+   */
+  struct SensorPacketHeader
+  {
+    std::array<char, 4> magic = {'N', 'D', 'S', 'F'};
+    uint32_t frameSize; /**< The size of a frame in bytes, to detect different versions. */
+    uint32_t count; /**< The number of frames that follow. */
+  };
+
 private:
+  static constexpr int sensorPort = 55556; /**< The port sensor packets are sent to. */
+  static constexpr uint32_t maxFramesPerPacket = 16;
+
   static bool shutdown;
 
   const NDData* dataV6 = reinterpret_cast<const NDData*>(MAP_FAILED); /**< The shared memory. */
@@ -29,9 +47,17 @@ private:
 
   std::chrono::time_point<std::chrono::steady_clock> wlanRequest;
   std::chrono::time_point<std::chrono::steady_clock> gcData;
+  std::chrono::time_point<std::chrono::steady_clock> sensorRequest; /**< When sensor frames were requested the last time. */
+  std::chrono::time_point<std::chrono::steady_clock> lastStatus; /**< When the status was sent the last time. */
+  unsigned int sensorTarget = 0; /**< The address sensor frames are sent to. */
+  uint32_t nextSensorFrame = 0; /**< The number of the next sensor frame sent. */
+  std::vector<char> sensorPacket;
 
   nlohmann::json getJson() const;
 
+  /** Sends the sensor frames that were added to the history since the last call. */
+  void sendSensorFrames();
+
   bool mapSharedMemory();
   std::string runCommand(std::string cmd);
 
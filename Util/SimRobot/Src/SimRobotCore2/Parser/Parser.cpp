@@ -190,6 +190,7 @@ Element* Parser::sceneElement()
   if (scene->contactSoftCFM != -1)
     scene->contactMode |= dContactSoftCFM;
   scene->detectBodyCollisions = getBool("bodyCollisions", false, true);
+  scene->physicsThreads = getIntegerNonZeroPositive("physicsThreads", false, 0);
 
   ASSERT(!Simulation::simulation->scene);
   Simulation::simulation->scene = scene;
@@ -27,24 +27,56 @@
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 
 #include "Reader.h"
 #include "Platform/Assert.h"
 
+std::unordered_map<std::string, Reader::CachedFile> Reader::fileCache;
+
+std::shared_ptr<const std::string> Reader::getFileContents(const std::string& fileName)
+{
+  std::error_code error;
+  const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(fileName, error);
+  if (error)
+    return nullptr;
+  const std::uintmax_t size = std::filesystem::file_size(fileName, error);
+  if (error)
+    return nullptr;
+
+  CachedFile& cachedFile = fileCache[fileName];
+  if (cachedFile.contents && cachedFile.lastWriteTime == lastWriteTime && cachedFile.size == size)
+    return cachedFile.contents;
+
+  std::ifstream stream(fileName, std::ios::binary);
+  if (!stream.is_open())
+  {
+    fileCache.erase(fileName);
+    return nullptr;
+  }
+  cachedFile.contents = std::make_shared<const std::string>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+  cachedFile.lastWriteTime = lastWriteTime;
+  cachedFile.size = size;
+  return cachedFile.contents;
+}
+
 bool Reader::readFile(const std::string& fileName)
 {
-  // open file
-  std::ifstream reader(fileName);
-  if (!reader.is_open())
+  // get the contents of the file (the pointer keeps them alive while they are read)
+  const std::shared_ptr<const std::string> contents = getFileContents(fileName);
+  if (!contents)
     return false;
 
   // backup reader state
   std::string oldFileName = fileName;
   const Location oldLocation = location;
   const Location oldNextLocation = nextLocation;
+  const char* const oldCurrent = current;
+  const char* const oldEnd = end;
 
   // set new reader state
-  this->reader.swap(reader);
+  current = contents->data();
+  end = current + contents->size();
   this->fileName.swap(oldFileName);
   nextLocation = location = Location(1, 1);
   ASSERT(nextToken == invalidToken);
@@ -52,9 +84,6 @@ bool Reader::readFile(const std::string& fileName)
   // read root elements
   bool result = readElements(true, true);
 
-  // close reader
-  this->reader.close();
-
   // restore old reader state
   if (!oldFileName.empty())
   {
@@ -63,14 +92,15 @@ bool Reader::readFile(const std::string& fileName)
     nextLocation = oldNextLocation;
   }
   nextToken = invalidToken;
-  this->reader.swap(reader);
+  current = oldCurrent;
+  end = oldEnd;
 
   return result;
 }
 
 bool Reader::readElements(bool callHandler, bool isRoot)
 {
-  if (!reader.is_open()) // the last element was "empty"
+  if (!current) // the last element was "empty"
     return true;
 
   Token token;
@@ -131,10 +161,10 @@ bool Reader::readElement(bool callHandler)
       if (callHandler)
       {
         // This signals further calls to readElements that there is nothing to read
-        std::ifstream f;
-        reader.swap(f);
+        const char* const oldCurrent = current;
+        current = nullptr;
         handleElement(name, attributes, nameLocation);
-        reader.swap(f);
+        current = oldCurrent;
       }
       return true;
     }
@@ -377,10 +407,9 @@ Reader::Token Reader::readToken()
     nextLocation = nextNextLocation;
     return token;
   }
-  const char c = static_cast<char>(reader.get());
-  if (!reader.good())
+  if (current == end)
     return endOfInput;
-  ASSERT(c != EOF);
+  const char c = *current++;
   if (c == '\n')
   {
     ++nextLocation.line;
@@ -388,53 +417,38 @@ Reader::Token Reader::readToken()
   }
   else if ((c & 0xc0) != 0x80) // This handles UTF-8 continuation characters.
     ++nextLocation.column;
+  const std::ptrdiff_t remaining = end - current;
   if (c == '<')
   {
-    char nextC = static_cast<char>(reader.peek());
-    if (nextC == '/')
+    if (remaining >= 1 && current[0] == '/')
     {
-      reader.get();
+      ++current;
       ++nextLocation.column;
       return endTagStart;
     }
-    else if (nextC == '!')
+    else if (remaining >= 3 && current[0] == '!' && current[1] == '-' && current[2] == '-')
     {
-      reader.get();
-      if (reader.peek() == '-')
-      {
-        reader.get();
-        if (reader.peek() == '-')
-        {
-          reader.get();
-          nextLocation.column += 3;
-          return commentStart;
-        }
-        reader.putback('-');
-      }
-      reader.putback('!');
+      current += 3;
+      nextLocation.column += 3;
+      return commentStart;
     }
   }
   else if (c == '/')
   {
-    if (reader.peek() == '>')
+    if (remaining >= 1 && current[0] == '>')
     {
-      reader.get();
+      ++current;
       ++nextLocation.column;
       return emptyTagEnd;
     }
   }
   else if (c == '-')
   {
-    if (reader.peek() == '-')
+    if (remaining >= 2 && current[0] == '-' && current[1] == '>')
     {
-      reader.get();
-      if (reader.peek() == '>')
-      {
-        reader.get();
-        nextLocation.column += 2;
-        return commentEnd;
-      }
-      reader.putback('-');
+      current += 2;
+      nextLocation.column += 2;
+      return commentEnd;
     }
   }
   return static_cast<Token>(c);
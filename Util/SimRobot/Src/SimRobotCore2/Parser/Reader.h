@@ -26,7 +26,9 @@
 
 #pragma once
 
-#include <fstream>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -208,7 +210,27 @@ private:
    */
   static bool tokenIsSpace(Token token);
 
-  std::ifstream reader; /**< The stream from which to read */
+  /**
+   * Returns the contents of a file. The contents are kept for the lifetime of the process,
+   * so files that are included several times or read again when the scene is reloaded are
+   * read from disk only once as long as they have not been modified.
+   * @param fileName The name of the file
+   * @return The contents or nullptr if the file could not be read
+   */
+  static std::shared_ptr<const std::string> getFileContents(const std::string& fileName);
+
+  /** The contents of a file that was read before. */
+  struct CachedFile
+  {
+    std::filesystem::file_time_type lastWriteTime; /**< The modification time of the file when it was read */
+    std::uintmax_t size; /**< The size of the file when it was read */
+    std::shared_ptr<const std::string> contents;
+  };
+
+  static std::unordered_map<std::string, CachedFile> fileCache; /**< The contents of all files read so far */
+
+  const char* current = nullptr; /**< The next character to read, nullptr if there is nothing to read */
+  const char* end = nullptr; /**< The end of the contents that are read */
   Location location; /**< The location of the last token returned by readToken */
   Location nextLocation; /**< The location where the next token starts */
   Token nextToken = invalidToken; /**< The token that was put back (not saved over reentrant \c readFile calls) */
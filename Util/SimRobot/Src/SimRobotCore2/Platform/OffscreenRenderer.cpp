@@ -123,14 +123,20 @@ void OffscreenRenderer::finishImageRendering(void* image, int w, int h)
 
     if (currentBuffer->format().samples() > 0)
     {
-      QRect rect(QPoint(0, 0), currentBuffer->size());
-      QOpenGLFramebufferObject temp(currentBuffer->size());
-      QOpenGLFramebufferObject::blitFramebuffer(&temp, rect, currentBuffer, rect, GL_COLOR_BUFFER_BIT, GL_NEAREST, 0, 0, QOpenGLFramebufferObject::DontRestoreFramebufferBinding);
+      // Only resolve the part of the buffer that is read back. The buffer for the
+      // resolved image is kept, because creating it each time is expensive.
+      const QSize size = currentBuffer->size();
+      auto& resolveBuffer = resolveBuffers[size.width() << 16 | size.height()];
+      if (!resolveBuffer)
+        resolveBuffer = std::make_unique<QOpenGLFramebufferObject>(size);
+
+      QRect rect(0, 0, w, h);
+      QOpenGLFramebufferObject::blitFramebuffer(resolveBuffer.get(), rect, currentBuffer, rect, GL_COLOR_BUFFER_BIT, GL_NEAREST, 0, 0, QOpenGLFramebufferObject::DontRestoreFramebufferBinding);
       currentBuffer->release();
 
-      temp.bind();
+      resolveBuffer->bind();
       getImage();
-      temp.release();
+      resolveBuffer->release();
     }
     else
     {
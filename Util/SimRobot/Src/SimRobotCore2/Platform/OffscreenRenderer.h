@@ -68,6 +68,7 @@ private:
   std::unique_ptr<QOffscreenSurface> mainSurface;
 
   std::unordered_map<unsigned int, std::unique_ptr<QOpenGLFramebufferObject>> renderBuffers;
+  std::unordered_map<unsigned int, std::unique_ptr<QOpenGLFramebufferObject>> resolveBuffers; /**< Buffers without multi-sampling to read images from, one per size. */
   QOpenGLFramebufferObject* currentBuffer = nullptr;
 
   /**
@@ -114,6 +114,7 @@ void SimObjectRenderer::draw()
     Simulation::simulation->scene->updateTransformations();
 
   // since each object will be drawn relative to its parent we need to shift the coordinate system when we want the object to be in the center
+  Matrix4f modelView = Eigen::Map<const Matrix4f>(cameraTransformation);
   if (&simObject != Simulation::simulation->scene && !(renderFlags & showAsGlobalView))
   {
     const float* transformation = simObject.transformation;
@@ -124,7 +125,9 @@ void SimObjectRenderer::draw()
     float invTrans[16];
     OpenGLTools::convertTransformation(pose.invert(), invTrans);
     glMultMatrixf(invTrans);
+    modelView *= Eigen::Map<const Matrix4f>(invTrans);
   }
+  frustum.set(projection, modelView.data());
 
   // draw origin
   if (renderFlags & showCoordinateSystem)
@@ -167,7 +170,9 @@ void SimObjectRenderer::draw()
       ASSERT(false);
       break;
     }
+    Simulation::simulation->scene->frustum = &frustum;
     graphicalObject->drawAppearances(SurfaceColor(0), false);
+    Simulation::simulation->scene->frustum = nullptr;
 
     // check matrix stack size
 #ifdef _DEBUG
@@ -8,6 +8,7 @@
 
 #include "SimRobotCore2.h"
 #include "Tools/Math/Eigen.h"
+#include "Tools/OpenGLTools.h"
 
 class SimObject;
 class Body;
@@ -38,6 +39,7 @@ private:
   float fovy;
   float projection[16];
   int viewport[4];
+  OpenGLTools::Frustum frustum; /**< The view of the last frame drawn, which is used to skip invisible bodies */
 
   ShadeMode surfaceShadeMode;
   ShadeMode physicsShadeMode;
@@ -156,6 +156,26 @@ void Appearance::assembleAppearances(SurfaceColor color) const
   glPopMatrix();
 }
 
+bool Appearance::addBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  const Matrix4f appearanceTransformation = transformation * Eigen::Map<const Matrix4f>(this->transformation);
+  addShapeBounds(appearanceTransformation, min, max);
+  return addChildBounds(appearanceTransformation, min, max);
+}
+
+void Appearance::addPoint(const Matrix4f& transformation, const Vector3f& point, Vector3f& min, Vector3f& max)
+{
+  const Vector3f transformed = transformation.topLeftCorner<3, 3>() * point + transformation.topRightCorner<3, 1>();
+  min = min.cwiseMin(transformed);
+  max = max.cwiseMax(transformed);
+}
+
+void Appearance::addBox(const Matrix4f& transformation, const Vector3f& halfSize, Vector3f& min, Vector3f& max)
+{
+  for (int i = 0; i < 8; ++i)
+    addPoint(transformation, Vector3f(i & 1 ? halfSize.x() : -halfSize.x(), i & 2 ? halfSize.y() : -halfSize.y(), i & 4 ? halfSize.z() : -halfSize.z()), min, max);
+}
+
 void Appearance::drawAppearances(SurfaceColor color, bool drawControllerDrawings) const
 {
   if (drawControllerDrawings)
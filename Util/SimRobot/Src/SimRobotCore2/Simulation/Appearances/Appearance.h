@@ -93,6 +93,35 @@ protected:
   /** Draws appearance primitives of the object (including children) on the currently selected OpenGL context (as fast as possible) */
   void drawAppearances(SurfaceColor color, bool drawControllerDrawings) const override;
 
+  /** Extends an axis-aligned box by the appearance primitives of the object (including children) */
+  bool addBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const override;
+
+  /**
+  * Extends an axis-aligned box by the primitives of this appearance (without children)
+  * @param transformation The transformation from this appearance to the frame of the box
+  * @param min The minimum corner of the box
+  * @param max The maximum corner of the box
+  */
+  virtual void addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const {}
+
+  /**
+  * Extends an axis-aligned box by a point
+  * @param transformation The transformation from the frame of the point to the frame of the box
+  * @param point The point
+  * @param min The minimum corner of the box
+  * @param max The maximum corner of the box
+  */
+  static void addPoint(const Matrix4f& transformation, const Vector3f& point, Vector3f& min, Vector3f& max);
+
+  /**
+  * Extends an axis-aligned box by the corners of a box centered at the origin
+  * @param transformation The transformation from the frame of the centered box to the frame of the box extended
+  * @param halfSize Half of the size of the centered box in each dimension
+  * @param min The minimum corner of the box
+  * @param max The maximum corner of the box
+  */
+  static void addBox(const Matrix4f& transformation, const Vector3f& halfSize, Vector3f& min, Vector3f& max);
+
 private:
   /**
   * Registers an element as parent
@@ -78,3 +78,8 @@ void BoxAppearance::assembleAppearances(SurfaceColor color) const
   GraphicalObject::assembleAppearances(color);
   glPopMatrix();
 }
+
+void BoxAppearance::addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  addBox(transformation, Vector3f(depth * 0.5f, width * 0.5f, height * 0.5f), min, max);
+}
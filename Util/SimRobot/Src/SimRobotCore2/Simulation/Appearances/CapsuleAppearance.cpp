@@ -29,3 +29,8 @@ void CapsuleAppearance::assembleAppearances(SurfaceColor color) const
   GraphicalObject::assembleAppearances(color);
   glPopMatrix();
 }
+
+void CapsuleAppearance::addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  addBox(transformation, Vector3f(radius, radius, height * 0.5f), min, max);
+}
@@ -158,3 +158,9 @@ void ComplexAppearance::assembleAppearances(SurfaceColor color) const
   GraphicalObject::assembleAppearances(color);
   glPopMatrix();
 }
+
+void ComplexAppearance::addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  for (const Vertex& vertex : vertices->vertices)
+    addPoint(transformation, Vector3f(vertex.x, vertex.y, vertex.z), min, max);
+}
@@ -188,4 +188,7 @@ private:
 
   /** Draws appearance primitives of the object (including children) on the currently selected OpenGL context (in order to create a display list) */
   void assembleAppearances(SurfaceColor color) const override;
+
+  /** Extends an axis-aligned box by the primitives of this appearance */
+  void addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const override;
 };
@@ -31,3 +31,8 @@ void CylinderAppearance::assembleAppearances(SurfaceColor color) const
   GraphicalObject::assembleAppearances(color);
   glPopMatrix();
 }
+
+void CylinderAppearance::addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  addBox(transformation, Vector3f(radius, radius, height * 0.5f), min, max);
+}
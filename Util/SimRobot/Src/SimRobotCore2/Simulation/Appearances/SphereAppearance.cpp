@@ -26,3 +26,8 @@ void SphereAppearance::assembleAppearances(SurfaceColor color) const
   GraphicalObject::assembleAppearances(color);
   glPopMatrix();
 }
+
+void SphereAppearance::addShapeBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  addBox(transformation, Vector3f(radius, radius, radius), min, max);
+}
@@ -14,6 +14,7 @@
 #include "Geometries/Geometry.h"
 #include "Tools/ODETools.h"
 #include "Tools/OpenGLTools.h"
+#include <limits>
 
 void Body::addParent(Element& element)
 {
@@ -188,6 +189,17 @@ void Body::addMass(Mass& mass)
 void Body::createGraphics()
 {
   GraphicalObject::createGraphics();
+  if (initializedContexts == 1)
+  {
+    // the transformations of the appearances were set by the call above
+    Vector3f min = Vector3f::Constant(std::numeric_limits<float>::max());
+    Vector3f max = Vector3f::Constant(-std::numeric_limits<float>::max());
+    if (addChildBounds(Matrix4f::Identity(), min, max) && (min.array() <= max.array()).all())
+    {
+      boundsCenter = (min + max) * 0.5f;
+      boundsRadius = (max - min).norm() * 0.5f;
+    }
+  }
   for (std::list<Body*>::const_iterator iter = bodyChildren.begin(), end = bodyChildren.end(); iter != end; ++iter)
     (*iter)->createGraphics();
 }
@@ -209,10 +221,15 @@ void Body::updateTransformation()
 
 void Body::drawAppearances(SurfaceColor color, bool drawControllerDrawings) const
 {
-  glPushMatrix();
-  glMultMatrixf(transformation);
-  GraphicalObject::drawAppearances(color, drawControllerDrawings);
-  glPopMatrix();
+  // controller drawings can be anywhere, the children are checked on their own
+  const OpenGLTools::Frustum* frustum = Simulation::simulation->scene->frustum;
+  if (drawControllerDrawings || !frustum || boundsRadius < 0.f || frustum->isVisible(pose * boundsCenter, boundsRadius))
+  {
+    glPushMatrix();
+    glMultMatrixf(transformation);
+    GraphicalObject::drawAppearances(color, drawControllerDrawings);
+    glPopMatrix();
+  }
   for (std::list<Body*>::const_iterator iter = bodyChildren.begin(), end = bodyChildren.end(); iter != end; ++iter)
     (*iter)->drawAppearances(color, drawControllerDrawings);
 }
@@ -78,6 +78,8 @@ public:
 private:
   Vector3f centerOfMass; /**< The position of the center of mass relative to the pose of the body */
   float centerOfMassTransformation[16];
+  Vector3f boundsCenter = Vector3f::Zero(); /**< The center of a sphere around the appearances of this body (relative to its pose) */
+  float boundsRadius = -1.f; /**< The radius of that sphere or -1 if it is unknown */
 
   dSpaceID bodySpace; /**< The collision space for a connected group of movable objects */
 
@@ -54,6 +54,14 @@ void GraphicalObject::assembleAppearances(SurfaceColor color) const
     (*iter)->drawAppearances(color, false);
 }
 
+bool GraphicalObject::addChildBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const
+{
+  bool known = true;
+  for (std::list<GraphicalObject*>::const_iterator iter = graphicalDrawings.begin(), end = graphicalDrawings.end(); iter != end; ++iter)
+    known &= (*iter)->addBounds(transformation, min, max);
+  return known;
+}
+
 void GraphicalObject::addParent(Element& element)
 {
   dynamic_cast<GraphicalObject*>(&element)->graphicalDrawings.push_back(this);
@@ -34,6 +34,15 @@ public:
   /** Draws appearance primitives of the object (including children) on the currently selected OpenGL context (as fast as possible) */
   virtual void drawAppearances(SurfaceColor color, bool drawControllerDrawings) const;
 
+  /**
+  * Extends an axis-aligned box by the appearance primitives of the object (including children)
+  * @param transformation The transformation from the object to the frame of the box
+  * @param min The minimum corner of the box
+  * @param max The maximum corner of the box
+  * @return Whether the extent of the object is known
+  */
+  virtual bool addBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const { return false; }
+
 protected:
   unsigned int initializedContexts;
 
@@ -43,6 +52,12 @@ protected:
   */
   virtual void addParent(Element& element);
 
+  /**
+  * Extends an axis-aligned box by the subordinate graphical objects (see \c addBounds)
+  * @return Whether the extent of all of them is known
+  */
+  bool addChildBounds(const Matrix4f& transformation, Vector3f& min, Vector3f& max) const;
+
   // API
   virtual bool registerDrawing(SimRobotCore2::Controller3DDrawing& drawing);
   virtual bool unregisterDrawing(SimRobotCore2::Controller3DDrawing& drawing);
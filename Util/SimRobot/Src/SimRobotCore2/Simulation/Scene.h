@@ -11,6 +11,7 @@
 #include "Simulation/GraphicalObject.h"
 #include "Simulation/Appearances/Appearance.h"
 #include "Simulation/Actuators/Actuator.h"
+#include "Tools/OpenGLTools.h"
 #include "Tools/Texture.h"
 
 class Body;
@@ -63,15 +64,17 @@ public:
   int quickSolverIterations; /**< The iteration count for ODE's quick solver */
   int quickSolverSkip; /**< Controls how often the normal solver will be used instead of the quick solver */
   bool detectBodyCollisions; /**< Whether to detect collision between different bodies */
+  int physicsThreads; /**< The number of threads ODE uses to step the world or 0 to step it in the simulation thread */
 
   Appearance::Surface* defaultSurface; /**< A surface that will be used for drawing physical objects */
 
   std::list<Body*> bodies; /**< List of bodies without a parent body */
   std::list<Actuator::Port*> actuators; /**< List of actuators that need to do something in every simulation step */
   std::list<Light*> lights; /** List of scene lights */
+  const OpenGLTools::Frustum* frustum = nullptr; /**< If set, the appearances of bodies outside of it are not drawn */
 
   /** Default constructor */
-  Scene() : contactMode(0), useQuickSolver(false), quickSolverIterations(-1), lastTransformationUpdateStep(0)
+  Scene() : contactMode(0), useQuickSolver(false), quickSolverIterations(-1), physicsThreads(0), lastTransformationUpdateStep(0)
   {
     color[0] = color[1] = color[2] = color[3] = 0.f;
     defaultSurface = new Appearance::Surface();
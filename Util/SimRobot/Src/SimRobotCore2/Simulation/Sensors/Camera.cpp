@@ -102,9 +102,13 @@ void Camera::CameraSensor::updateValue()
   OpenGLTools::convertTransformation(pose.invert(), transformation);
   glLoadMatrixf(transformation);
 
-  // draw all objects
+  // draw all objects, but skip the bodies that are not in the view
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  OpenGLTools::Frustum frustum;
+  frustum.set(projection, transformation);
+  Simulation::simulation->scene->frustum = &frustum;
   Simulation::simulation->scene->drawAppearances(SurfaceColor::ownColor, false);
+  Simulation::simulation->scene->frustum = nullptr;
 
   // read frame buffer
   renderer.finishImageRendering(imageBuffer, imageWidth, imageHeight);
@@ -177,8 +181,12 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore2::SensorPort** camera
       OpenGLTools::convertTransformation(pose.invert(), transformation);
       glLoadMatrixf(transformation);
 
-      // draw all objects
+      // draw all objects, but skip the bodies that are not in the view
+      OpenGLTools::Frustum frustum;
+      frustum.set(projection, transformation);
+      Simulation::simulation->scene->frustum = &frustum;
       Simulation::simulation->scene->drawAppearances(SurfaceColor::ownColor, false);
+      Simulation::simulation->scene->frustum = nullptr;
 
       sensor->data.byteArray = currentBufferPos;
       sensor->lastSimulationStep = Simulation::simulation->simulationStep;
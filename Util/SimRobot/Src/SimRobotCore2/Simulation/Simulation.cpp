@@ -41,13 +41,14 @@ Simulation::~Simulation()
     dSpaceDestroy(rootSpace);
   if (physicalWorld)
   {
-#ifdef MULTI_THREADING
-    dThreadingImplementationShutdownProcessing(threading);
-    dThreadingThreadPoolWaitIdleState(pool);
-    dThreadingFreeThreadPool(pool);
-    dWorldSetStepThreadingImplementation(physicalWorld, nullptr, nullptr);
-    dThreadingFreeImplementation(threading);
-#endif
+    if (threading)
+    {
+      dThreadingImplementationShutdownProcessing(threading);
+      dThreadingThreadPoolWaitIdleState(pool);
+      dThreadingFreeThreadPool(pool);
+      dWorldSetStepThreadingImplementation(physicalWorld, nullptr, nullptr);
+      dThreadingFreeImplementation(threading);
+    }
     dWorldDestroy(physicalWorld);
     dCloseODE();
   }
@@ -80,12 +81,13 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
     dWorldSetCFM(physicalWorld, scene->cfm);
   if (scene->quickSolverIterations != -1)
     dWorldSetQuickStepNumIterations(physicalWorld, scene->quickSolverIterations);
-#ifdef MULTI_THREADING
-  threading = dThreadingAllocateMultiThreadedImplementation();
-  pool = dThreadingAllocateThreadPool(std::thread::hardware_concurrency(), 0, dAllocateFlagBasicData, nullptr);
-  dThreadingThreadPoolServeMultiThreadedImplementation(pool, threading);
-  dWorldSetStepThreadingImplementation(physicalWorld, dThreadingImplementationGetFunctions(threading), threading);
-#endif
+  if (scene->physicsThreads > 0)
+  {
+    threading = dThreadingAllocateMultiThreadedImplementation();
+    pool = dThreadingAllocateThreadPool(std::min(static_cast<unsigned>(scene->physicsThreads), std::max(1u, std::thread::hardware_concurrency())), 0, dAllocateFlagBasicData, nullptr);
+    dThreadingThreadPoolServeMultiThreadedImplementation(pool, threading);
+    dWorldSetStepThreadingImplementation(physicalWorld, dThreadingImplementationGetFunctions(threading), threading);
+  }
 
   scene->createPhysics();
 
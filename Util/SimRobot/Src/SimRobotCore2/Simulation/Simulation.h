@@ -31,10 +31,8 @@ public:
   dSpaceID rootSpace; /**< The root collision space */
   dSpaceID staticSpace; /**< The collision space for static objects */
   dSpaceID movableSpace; /**< The collision space for movable objects */
-#ifdef MULTI_THREADING
-  dThreadingImplementationID threading; /**< Needed for multithreaded physics. */
-  dThreadingThreadPoolID pool; /**< The thread pool for physics. */
-#endif
+  dThreadingImplementationID threading = nullptr; /**< Needed for multithreaded physics. */
+  dThreadingThreadPoolID pool = nullptr; /**< The thread pool for physics. */
 
   OffscreenRenderer renderer; /**< For rendering OpenGL scenes without a regular window */
 
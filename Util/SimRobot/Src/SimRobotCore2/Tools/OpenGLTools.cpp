@@ -18,3 +18,20 @@ void OpenGLTools::computePerspective(float fovy, float aspect, float near, float
   matrix[14] = 2.f * far * near * nearMFarInv;
   matrix[1] = matrix[2] = matrix[3] = matrix[4] = matrix[6] = matrix[7] = matrix[8] = matrix[9] = matrix[12] = matrix[13] = matrix[15] = 0.f;
 }
+
+void OpenGLTools::Frustum::set(const float projection[16], const float modelView[16])
+{
+  // the planes are sums and differences of the rows of the combined matrix (Gribb/Hartmann)
+  const Matrix4f matrix = Eigen::Map<const Matrix4f>(projection) * Eigen::Map<const Matrix4f>(modelView);
+  for (int i = 0; i < 3; ++i)
+  {
+    planes[i * 2] = (matrix.row(3) + matrix.row(i)).transpose();
+    planes[i * 2 + 1] = (matrix.row(3) - matrix.row(i)).transpose();
+  }
+  for (Vector4f& plane : planes)
+  {
+    const float length = plane.head<3>().norm();
+    if (length > 0.f)
+      plane /= length;
+  }
+}
@@ -13,6 +13,38 @@
 class OpenGLTools
 {
 public:
+  /**
+   * @class Frustum
+   * The clipping planes of a view, which are used to skip objects that cannot be visible
+   */
+  class Frustum
+  {
+  public:
+    /**
+     * Determines the planes from the matrices of a view
+     * @param projection The projection matrix in the OpenGL format
+     * @param modelView The transformation from the scene to the camera in the OpenGL format
+     */
+    void set(const float projection[16], const float modelView[16]);
+
+    /**
+     * Checks whether a sphere might be visible
+     * @param center The center of the sphere in scene coordinates
+     * @param radius The radius of the sphere
+     * @return Whether the sphere is not completely outside of any plane
+     */
+    bool isVisible(const Vector3f& center, float radius) const
+    {
+      for (const Vector4f& plane : planes)
+        if (plane.head<3>().dot(center) + plane.w() < -radius)
+          return false;
+      return true;
+    }
+
+  private:
+    Vector4f planes[6]; /**< The planes with normals pointing inwards, i.e. n * p + d >= 0 inside */
+  };
+
   /** Converts a pose to the OpenGL format
    * @param pose The pose to convert
    * @param transformation The converted pose
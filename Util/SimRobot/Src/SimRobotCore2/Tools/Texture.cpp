@@ -7,6 +7,9 @@
 
 #include <cstring>
 #include <cstdio>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
 #include "Platform/OpenGL.h"
 
 #include "Platform/Assert.h"
@@ -17,6 +20,22 @@
 #define strcasecmp _stricmp
 #endif
 
+namespace
+{
+  /** The pixel data of a file that was decoded before. */
+  struct DecodedImage
+  {
+    std::filesystem::file_time_type lastWriteTime;
+    int width;
+    int height;
+    unsigned int byteOrder;
+    bool hasAlpha;
+    std::vector<unsigned char> imageData;
+  };
+
+  std::unordered_map<std::string, DecodedImage> decodedImages; /**< All textures decoded by this process */
+}
+
 Texture::~Texture()
 {
   glDeleteTextures(1, &textureId);
@@ -63,6 +82,37 @@ bool Texture::load(const std::string& file)
   ASSERT(!imageData);
   glGenTextures(1, &textureId);
 
+  std::error_code error;
+  const std::filesystem::file_time_type lastWriteTime = std::filesystem::last_write_time(file, error);
+  if (error)
+    return false;
+
+  auto cached = decodedImages.find(file);
+  if (cached != decodedImages.end() && cached->second.lastWriteTime == lastWriteTime)
+  {
+    const DecodedImage& image = cached->second;
+    width = image.width;
+    height = image.height;
+    byteOrder = image.byteOrder;
+    hasAlpha = image.hasAlpha;
+    imageSize = static_cast<unsigned int>(image.imageData.size());
+    imageData = new GLubyte[imageSize];
+    memcpy(imageData, image.imageData.data(), imageSize);
+    return true;
+  }
+
+  if (!decode(file))
+  {
+    if (cached != decodedImages.end())
+      decodedImages.erase(cached);
+    return false;
+  }
+  decodedImages[file] = {lastWriteTime, width, height, byteOrder, hasAlpha, std::vector<unsigned char>(imageData, imageData + imageSize)};
+  return true;
+}
+
+bool Texture::decode(const std::string& file)
+{
   if (file.length() >= 4)
   {
     std::string suffix = file.substr(file.length() - 4);
@@ -79,7 +129,8 @@ bool Texture::load(const std::string& file)
     height = image.height();
     byteOrder = image.format() == QImage::Format_RGB888 ? GL_BGR : GL_BGRA;
     hasAlpha = image.hasAlphaChannel();
-    imageData = new GLubyte[image.sizeInBytes()];
+    imageSize = static_cast<unsigned int>(image.sizeInBytes());
+    imageData = new GLubyte[imageSize];
     if (!imageData)
       return false;
 
@@ -102,7 +153,6 @@ bool Texture::loadTGA(const std::string& name)
   GLubyte TGAcompare[12]; // Used to compare TGA header
   GLubyte header[6]; // First 6 useful bytes of the header
   GLuint bytesPerPixel;
-  GLuint imageSize;
   GLuint bpp;
 
   FILE* file = fopen(name.c_str(), "rb"); // Open the TGA file
@@ -155,6 +205,7 @@ bool Texture::loadTGA(const std::string& name)
   if (fread(imageData, 1, imageSize, file) != imageSize) // Does the image size match the memory reserved?
   {
     delete[] imageData; // If so, then release the image data
+    imageData = nullptr;
     fclose(file); // Close the file
     return false;
   }
@@ -30,6 +30,8 @@ public:
 
   /**
   * Loads a texture from a bmp or tga file (detected by file endling)
+  * Files that were decoded before by this process and were not modified since are
+  * copied from a cache instead, which speeds up reloading scenes.
   * @param The path to the file to load
   * @return Whether the texture was successfully loaded or not
   */
@@ -41,6 +43,15 @@ public:
   void createGraphics();
 
 private:
+  unsigned int imageSize = 0; /**< The number of bytes in \c imageData */
+
+  /**
+  * Decodes a texture from a bmp or tga file (detected by file endling)
+  * @param The path to the file to load
+  * @return Whether the texture was successfully loaded or not
+  */
+  bool decode(const std::string& file);
+
   /**
   * Loads a texture from a tga file
   * @param The path to the file to load